@@ -5,6 +5,7 @@
  * file in the root directory of this source tree.
  */
 #include "SynthTrace.h"
+#include "SynthTraceStream.h"
 
 #include "hermes/Parser/JSLexer.h"
 #include "hermes/Parser/JSONParser.h"
@@ -365,13 +366,14 @@ SynthTrace::TraceValue SynthTrace::encodeNumber(double value) {
 }
 
 SynthTrace::TraceValue SynthTrace::encodeString(const std::string &value) {
-  auto it = std::find(stringTable_.begin(), stringTable_.end(), value);
+  auto it = stringIndex_.find(value);
   uint64_t idx = 0;
-  if (it == stringTable_.end()) {
+  if (it == stringIndex_.end()) {
+    idx = stringTable_.size();
     stringTable_.push_back(value);
-    idx = stringTable_.size() - 1;
+    stringIndex_.emplace(value, idx);
   } else {
-    idx = std::distance(stringTable_.begin(), it);
+    idx = it->second;
   }
   // Fake a HermesValue string with a non-pointer. Don't use this value in a
   // GC or it will think the index is a pointer.
@@ -380,7 +382,11 @@ SynthTrace::TraceValue SynthTrace::encodeString(const std::string &value) {
 }
 
 const std::string &SynthTrace::decodeString(TraceValue value) const {
-  return stringTable_.at(reinterpret_cast<uint64_t>(value.getString()));
+  return stringTable_.at(decodeStringIndex(value));
+}
+
+uint64_t SynthTrace::decodeStringIndex(TraceValue value) {
+  return reinterpret_cast<uint64_t>(value.getString());
 }
 
 SynthTrace::TraceValue SynthTrace::encodeObject(ObjectID objID) {
@@ -445,6 +451,9 @@ std::tuple<
     ::hermes::vm::RuntimeConfig,
     ::hermes::vm::MockedEnvironment>
 SynthTrace::parse(std::unique_ptr<llvm::MemoryBuffer> trace) {
+  if (isSynthTraceStream(*trace)) {
+    return parseSynthTraceStream(*trace);
+  }
   JSLexer::Allocator alloc;
   JSONObject *root = llvm::cast<JSONObject>(parseJSON(alloc, std::move(trace)));
   if (!llvm::dyn_cast_or_null<JSONNumber>(root->get("globalObjID"))) {
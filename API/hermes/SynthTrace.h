@@ -16,6 +16,7 @@
 #include <chrono>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace llvm {
@@ -182,6 +183,15 @@ class SynthTrace {
   /// Extracts a string from a trace value.
   /// \pre The value must be a string.
   const std::string &decodeString(TraceValue value) const;
+  /// Extracts the index in the string table of a string trace value.
+  /// \pre The value must be a string.
+  static uint64_t decodeStringIndex(TraceValue value);
+
+  /// \return the strings referenced by the string values of this trace, in
+  /// the order they were first encoded.
+  const std::vector<std::string> &stringTable() const {
+    return stringTable_;
+  }
 
   static bool equal(TraceValue x, TraceValue y) {
     // We are encoding random numbers into strings, and can't use the library
@@ -190,7 +200,8 @@ class SynthTrace {
     return x.getRaw() == y.getRaw();
   }
 
-  /// Parse a trace from a JSON string.
+  /// Parse a trace from a JSON string, or from the binary format written by
+  /// a SynthTraceStreamWriter.
   static std::tuple<
       SynthTrace,
       ::hermes::vm::RuntimeConfig,
@@ -214,6 +225,9 @@ class SynthTrace {
   /// strings forever).
   /// Strings are stored in the trace objects as an index into this table.
   std::vector<std::string> stringTable_;
+  /// The index of each string in stringTable_, so that encoding a string does
+  /// not have to search the table.
+  std::unordered_map<std::string, uint64_t> stringIndex_;
 
   /// The version of the Synth Benchmark
   constexpr static uint32_t synthVersion() {
@@ -0,0 +1,658 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "SynthTraceStream.h"
+
+#include "hermes/Support/Conversions.h"
+#include "hermes/Support/OSCompat.h"
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MathExtras.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace facebook {
+namespace hermes {
+namespace tracing {
+
+namespace {
+
+using RecordType = SynthTrace::RecordType;
+using TraceValue = SynthTrace::TraceValue;
+
+constexpr char kMagic[] = "HSYNTHBT";
+constexpr size_t kMagicSize = sizeof(kMagic) - 1;
+
+/// The version of the binary format, independent of SynthTrace's version.
+constexpr uint32_t kStreamVersion = 1;
+
+/// How long the flush thread sleeps when the ring buffer is empty.
+constexpr std::chrono::milliseconds kFlushInterval{10};
+
+/// \return the size of a ring buffer of at least \p bufferSize bytes.
+size_t ringCapacity(size_t bufferSize) {
+  return llvm::PowerOf2Ceil(std::max<size_t>(bufferSize, 64));
+}
+
+/// The tags of the entries which are not records. Records are tagged with
+/// their RecordType.
+enum EntryTag : uint8_t {
+  StringTag = 0x80,
+  SourceHashTag,
+  EnvTag,
+  EndTag = 0xff,
+};
+
+enum class ValueTag : uint8_t {
+  Undefined,
+  Null,
+  False,
+  True,
+  Number,
+  String,
+  Object,
+};
+
+/// Write \p value as an unsigned LEB128.
+void writeVarUInt(std::string &out, uint64_t value) {
+  do {
+    uint8_t byte = value & 0x7f;
+    value >>= 7;
+    out.push_back(static_cast<char>(value ? byte | 0x80 : byte));
+  } while (value);
+}
+
+void writeString(std::string &out, llvm::StringRef str) {
+  writeVarUInt(out, str.size());
+  out.append(str.data(), str.size());
+}
+
+/// Write the index of \p str in the string table of \p trace, adding it if
+/// needed.
+void writeName(std::string &out, SynthTrace &trace, const std::string &str) {
+  writeVarUInt(out, SynthTrace::decodeStringIndex(trace.encodeString(str)));
+}
+
+void writeValue(std::string &out, TraceValue value) {
+  if (value.isUndefined()) {
+    out.push_back(static_cast<char>(ValueTag::Undefined));
+  } else if (value.isNull()) {
+    out.push_back(static_cast<char>(ValueTag::Null));
+  } else if (value.isBool()) {
+    out.push_back(
+        static_cast<char>(value.getBool() ? ValueTag::True : ValueTag::False));
+  } else if (value.isNumber()) {
+    out.push_back(static_cast<char>(ValueTag::Number));
+    uint64_t bits =
+        ::hermes::safeTypeCast<double, uint64_t>(value.getNumber());
+    for (unsigned i = 0; i < 8; ++i) {
+      out.push_back(static_cast<char>(bits >> (i * 8)));
+    }
+  } else if (value.isString()) {
+    out.push_back(static_cast<char>(ValueTag::String));
+    writeVarUInt(out, SynthTrace::decodeStringIndex(value));
+  } else if (value.isObject()) {
+    out.push_back(static_cast<char>(ValueTag::Object));
+    writeVarUInt(out, SynthTrace::decodeObject(value));
+  } else {
+    llvm_unreachable("No other values allowed in the trace");
+  }
+}
+
+/// Write the fields of \p rec which follow its tag and time.
+void writeRecordFields(
+    std::string &out,
+    const SynthTrace::Record &rec,
+    SynthTrace &trace) {
+  switch (rec.getType()) {
+    case RecordType::BeginExecJS:
+    case RecordType::SetPropertyNativeReturn:
+      break;
+    case RecordType::EndExecJS:
+      writeValue(
+          out, static_cast<const SynthTrace::EndExecJSRecord &>(rec).retVal_);
+      break;
+    case RecordType::Marker:
+      writeName(
+          out, trace, static_cast<const SynthTrace::MarkerRecord &>(rec).tag_);
+      break;
+    case RecordType::CreateObject:
+    case RecordType::CreateHostObject:
+    case RecordType::CreateHostFunction:
+      writeVarUInt(
+          out,
+          static_cast<const SynthTrace::CreateObjectRecord &>(rec).objID_);
+      break;
+    case RecordType::GetProperty:
+    case RecordType::SetProperty: {
+      const auto &prop =
+          static_cast<const SynthTrace::GetOrSetPropertyRecord &>(rec);
+      writeVarUInt(out, prop.objID_);
+      writeName(out, trace, prop.propName_);
+      writeValue(out, prop.value_);
+      break;
+    }
+    case RecordType::HasProperty: {
+      const auto &has = static_cast<const SynthTrace::HasPropertyRecord &>(rec);
+      writeVarUInt(out, has.objID_);
+      writeName(out, trace, has.propName_);
+      break;
+    }
+    case RecordType::GetPropertyNames: {
+      const auto &names =
+          static_cast<const SynthTrace::GetPropertyNamesRecord &>(rec);
+      writeVarUInt(out, names.objID_);
+      writeVarUInt(out, names.propNamesID_);
+      break;
+    }
+    case RecordType::CreateArray: {
+      const auto &arr = static_cast<const SynthTrace::CreateArrayRecord &>(rec);
+      writeVarUInt(out, arr.objID_);
+      writeVarUInt(out, arr.length_);
+      break;
+    }
+    case RecordType::ArrayRead:
+    case RecordType::ArrayWrite: {
+      const auto &elem =
+          static_cast<const SynthTrace::ArrayReadOrWriteRecord &>(rec);
+      writeVarUInt(out, elem.objID_);
+      writeVarUInt(out, elem.index_);
+      writeValue(out, elem.value_);
+      break;
+    }
+    case RecordType::CallFromNative:
+    case RecordType::ConstructFromNative:
+    case RecordType::CallToNative: {
+      const auto &call = static_cast<const SynthTrace::CallRecord &>(rec);
+      writeVarUInt(out, call.functionID_);
+      writeValue(out, call.thisArg_);
+      writeVarUInt(out, call.args_.size());
+      for (TraceValue arg : call.args_) {
+        writeValue(out, arg);
+      }
+      break;
+    }
+    case RecordType::ReturnFromNative:
+      writeValue(
+          out,
+          static_cast<const SynthTrace::ReturnFromNativeRecord &>(rec).retVal_);
+      break;
+    case RecordType::ReturnToNative:
+      writeValue(
+          out,
+          static_cast<const SynthTrace::ReturnToNativeRecord &>(rec).retVal_);
+      break;
+    case RecordType::GetPropertyNativeReturn:
+      writeValue(
+          out,
+          static_cast<const SynthTrace::GetPropertyNativeReturnRecord &>(rec)
+              .retVal_);
+      break;
+    case RecordType::GetPropertyNative: {
+      const auto &get =
+          static_cast<const SynthTrace::GetOrSetPropertyNativeRecord &>(rec);
+      writeVarUInt(out, get.hostObjectID_);
+      writeName(out, trace, get.propName_);
+      break;
+    }
+    case RecordType::SetPropertyNative: {
+      const auto &set =
+          static_cast<const SynthTrace::SetPropertyNativeRecord &>(rec);
+      writeVarUInt(out, set.hostObjectID_);
+      writeName(out, trace, set.propName_);
+      writeValue(out, set.value_);
+      break;
+    }
+  }
+}
+
+/// Thrown when the input ends in the middle of an entry.
+class TruncatedTrace : public std::invalid_argument {
+ public:
+  TruncatedTrace() : std::invalid_argument("Binary trace is truncated") {}
+};
+
+class StreamReader {
+ public:
+  explicit StreamReader(const llvm::MemoryBuffer &buf)
+      : cur_(reinterpret_cast<const uint8_t *>(buf.getBufferStart())),
+        end_(reinterpret_cast<const uint8_t *>(buf.getBufferEnd())) {}
+
+  bool atEnd() const {
+    return cur_ == end_;
+  }
+
+  uint8_t readByte() {
+    if (cur_ == end_) {
+      throw TruncatedTrace();
+    }
+    return *cur_++;
+  }
+
+  uint64_t readVarUInt() {
+    uint64_t value = 0;
+    for (unsigned shift = 0;; shift += 7) {
+      if (shift >= 64) {
+        throw std::invalid_argument("Binary trace has an invalid integer");
+      }
+      uint8_t byte = readByte();
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        return value;
+      }
+    }
+  }
+
+  double readNumber() {
+    uint64_t bits = 0;
+    for (unsigned i = 0; i < 8; ++i) {
+      bits |= static_cast<uint64_t>(readByte()) << (i * 8);
+    }
+    return ::hermes::safeTypeCast<uint64_t, double>(bits);
+  }
+
+  std::string readString() {
+    uint64_t size = readVarUInt();
+    if (size > static_cast<uint64_t>(end_ - cur_)) {
+      throw TruncatedTrace();
+    }
+    std::string str(reinterpret_cast<const char *>(cur_), size);
+    cur_ += size;
+    return str;
+  }
+
+ private:
+  const uint8_t *cur_;
+  const uint8_t *const end_;
+};
+
+} // namespace
+
+SynthTraceStreamWriter::SynthTraceStreamWriter(
+    std::unique_ptr<llvm::raw_ostream> os,
+    SynthTrace::ObjectID globalObjID,
+    const ::hermes::vm::RuntimeConfig &conf,
+    size_t bufferSize)
+    : os_(std::move(os)),
+      ring_(new char[ringCapacity(bufferSize)]),
+      mask_(ringCapacity(bufferSize) - 1) {
+  scratch_.append(kMagic, kMagicSize);
+  writeVarUInt(scratch_, kStreamVersion);
+  writeVarUInt(scratch_, globalObjID);
+  writeVarUInt(scratch_, conf.getGCConfig().getInitHeapSize());
+  writeVarUInt(scratch_, conf.getGCConfig().getMaxHeapSize());
+  push();
+  flushThread_ = std::thread([this]() { flushLoop(); });
+}
+
+SynthTraceStreamWriter::~SynthTraceStreamWriter() {
+  if (!isClosed()) {
+    stop();
+  }
+}
+
+void SynthTraceStreamWriter::write(
+    const SynthTrace::Record &rec,
+    SynthTrace &trace) {
+  assert(!isClosed() && "Writing to a closed trace stream");
+  // Encode the record first, since it can add names to the string table.
+  recordScratch_.clear();
+  recordScratch_.push_back(static_cast<char>(rec.getType()));
+  writeVarUInt(recordScratch_, (rec.time_ - lastTime_).count());
+  lastTime_ = rec.time_;
+  writeRecordFields(recordScratch_, rec, trace);
+
+  scratch_.clear();
+  const std::vector<std::string> &strings = trace.stringTable();
+  for (; stringsWritten_ < strings.size(); ++stringsWritten_) {
+    scratch_.push_back(static_cast<char>(StringTag));
+    writeString(scratch_, strings[stringsWritten_]);
+  }
+  scratch_ += recordScratch_;
+  push();
+}
+
+void SynthTraceStreamWriter::writeSourceHash(const ::hermes::SHA1 &sourceHash) {
+  assert(!isClosed() && "Writing to a closed trace stream");
+  scratch_.clear();
+  scratch_.push_back(static_cast<char>(SourceHashTag));
+  scratch_.append(
+      reinterpret_cast<const char *>(sourceHash.data()), sourceHash.size());
+  push();
+}
+
+void SynthTraceStreamWriter::close(
+    const ::hermes::vm::MockedEnvironment &env) {
+  assert(!isClosed() && "Closing a closed trace stream");
+  scratch_.clear();
+  scratch_.push_back(static_cast<char>(EnvTag));
+  writeVarUInt(scratch_, env.mathRandomSeed);
+  writeVarUInt(scratch_, env.callsToDateNow.size());
+  for (uint64_t dateNow : env.callsToDateNow) {
+    writeVarUInt(scratch_, dateNow);
+  }
+  writeVarUInt(scratch_, env.callsToNewDate.size());
+  for (uint64_t newDate : env.callsToNewDate) {
+    writeVarUInt(scratch_, newDate);
+  }
+  writeVarUInt(scratch_, env.callsToDateAsFunction.size());
+  for (const std::string &dateAsFunc : env.callsToDateAsFunction) {
+    writeString(scratch_, dateAsFunc);
+  }
+  push();
+  stop();
+}
+
+void SynthTraceStreamWriter::stop() {
+  scratch_.assign(1, static_cast<char>(EndTag));
+  push();
+  closing_.store(true, std::memory_order_release);
+  cv_.notify_one();
+  flushThread_.join();
+}
+
+void SynthTraceStreamWriter::push() {
+  const size_t capacity = mask_ + 1;
+  const char *data = scratch_.data();
+  size_t size = scratch_.size();
+  size_t head = head_.load(std::memory_order_relaxed);
+  while (size) {
+    size_t free = capacity - (head - tail_.load(std::memory_order_acquire));
+    if (!free) {
+      // The flush thread is behind; wait for it rather than lose records.
+      cv_.notify_one();
+      std::this_thread::yield();
+      continue;
+    }
+    size_t n = std::min(size, free);
+    size_t offset = head & mask_;
+    size_t first = std::min(n, capacity - offset);
+    std::memcpy(&ring_[offset], data, first);
+    std::memcpy(&ring_[0], data + first, n - first);
+    head += n;
+    data += n;
+    size -= n;
+    head_.store(head, std::memory_order_release);
+  }
+  if (head - tail_.load(std::memory_order_relaxed) > capacity / 2) {
+    cv_.notify_one();
+  }
+}
+
+void SynthTraceStreamWriter::flushLoop() {
+  const size_t capacity = mask_ + 1;
+  size_t tail = tail_.load(std::memory_order_relaxed);
+  while (true) {
+    // Read closing_ before head_, so that everything pushed before stop() set
+    // it is drained before exiting.
+    bool closing = closing_.load(std::memory_order_acquire);
+    size_t head = head_.load(std::memory_order_acquire);
+    if (head == tail) {
+      if (closing) {
+        break;
+      }
+      os_->flush();
+      std::unique_lock<std::mutex> lock{mutex_};
+      cv_.wait_for(lock, kFlushInterval);
+      continue;
+    }
+    size_t n = head - tail;
+    size_t offset = tail & mask_;
+    size_t first = std::min(n, capacity - offset);
+    os_->write(&ring_[offset], first);
+    os_->write(&ring_[0], n - first);
+    tail = head;
+    tail_.store(tail, std::memory_order_release);
+  }
+  os_->flush();
+}
+
+bool isSynthTraceStream(const llvm::MemoryBuffer &buf) {
+  return buf.getBuffer().startswith(llvm::StringRef(kMagic, kMagicSize));
+}
+
+std::tuple<
+    SynthTrace,
+    ::hermes::vm::RuntimeConfig,
+    ::hermes::vm::MockedEnvironment>
+parseSynthTraceStream(const llvm::MemoryBuffer &buf) {
+  assert(isSynthTraceStream(buf) && "Not a binary trace");
+  StreamReader in{buf};
+  for (size_t i = 0; i < kMagicSize; ++i) {
+    in.readByte();
+  }
+  uint64_t version = in.readVarUInt();
+  if (version != kStreamVersion) {
+    throw std::invalid_argument(
+        "Binary trace version mismatch, expected " +
+        ::hermes::oscompat::to_string(kStreamVersion) +
+        ", actual: " + ::hermes::oscompat::to_string(version));
+  }
+  SynthTrace trace(in.readVarUInt());
+  ::hermes::vm::GCConfig::Builder gcconf;
+  if (auto sz = in.readVarUInt()) {
+    gcconf.withInitHeapSize(sz);
+  }
+  if (auto sz = in.readVarUInt()) {
+    gcconf.withMaxHeapSize(sz);
+  }
+  ::hermes::vm::MockedEnvironment env{};
+
+  // The trace values of the strings defined so far, by index.
+  std::vector<TraceValue> strings;
+  auto readStringValue = [&in, &strings]() -> TraceValue {
+    uint64_t idx = in.readVarUInt();
+    if (idx >= strings.size()) {
+      throw std::invalid_argument("Binary trace uses an undefined string");
+    }
+    return strings[idx];
+  };
+  auto readName = [&trace, &readStringValue]() -> std::string {
+    return trace.decodeString(readStringValue());
+  };
+  auto readValue = [&in, &readStringValue]() -> TraceValue {
+    switch (static_cast<ValueTag>(in.readByte())) {
+      case ValueTag::Undefined:
+        return SynthTrace::encodeUndefined();
+      case ValueTag::Null:
+        return SynthTrace::encodeNull();
+      case ValueTag::False:
+        return SynthTrace::encodeBool(false);
+      case ValueTag::True:
+        return SynthTrace::encodeBool(true);
+      case ValueTag::Number:
+        return SynthTrace::encodeNumber(in.readNumber());
+      case ValueTag::String:
+        return readStringValue();
+      case ValueTag::Object:
+        return SynthTrace::encodeObject(in.readVarUInt());
+    }
+    throw std::invalid_argument("Binary trace has an invalid value");
+  };
+  auto readArgs = [&in, &readValue]() {
+    std::vector<TraceValue> args;
+    for (uint64_t n = in.readVarUInt(); n; --n) {
+      args.push_back(readValue());
+    }
+    return args;
+  };
+
+  SynthTrace::TimeSinceStart time{SynthTrace::TimeSinceStart::zero()};
+  try {
+    while (!in.atEnd()) {
+      uint8_t tag = in.readByte();
+      if (tag == EndTag) {
+        break;
+      }
+      if (tag == StringTag) {
+        std::string str = in.readString();
+        strings.push_back(trace.encodeString(str));
+        continue;
+      }
+      if (tag == SourceHashTag) {
+        ::hermes::SHA1 sourceHash;
+        for (auto &byte : sourceHash) {
+          byte = in.readByte();
+        }
+        trace.setSourceHash(sourceHash);
+        continue;
+      }
+      if (tag == EnvTag) {
+        ::hermes::vm::MockedEnvironment newEnv{};
+        newEnv.mathRandomSeed = in.readVarUInt();
+        for (uint64_t n = in.readVarUInt(); n; --n) {
+          newEnv.callsToDateNow.push_back(in.readVarUInt());
+        }
+        for (uint64_t n = in.readVarUInt(); n; --n) {
+          newEnv.callsToNewDate.push_back(in.readVarUInt());
+        }
+        for (uint64_t n = in.readVarUInt(); n; --n) {
+          newEnv.callsToDateAsFunction.push_back(in.readString());
+        }
+        env = std::move(newEnv);
+        continue;
+      }
+      if (tag > static_cast<uint8_t>(RecordType::SetPropertyNativeReturn)) {
+        throw std::invalid_argument("Binary trace has an invalid entry");
+      }
+      time += SynthTrace::TimeSinceStart(in.readVarUInt());
+      // Read every field before adding the record, so that a record cut
+      // short is dropped as a whole.
+      switch (static_cast<RecordType>(tag)) {
+        case RecordType::BeginExecJS:
+          trace.emplace_back<SynthTrace::BeginExecJSRecord>(time);
+          break;
+        case RecordType::EndExecJS:
+          trace.emplace_back<SynthTrace::EndExecJSRecord>(time, readValue());
+          break;
+        case RecordType::Marker:
+          trace.emplace_back<SynthTrace::MarkerRecord>(time, readName());
+          break;
+        case RecordType::CreateObject:
+          trace.emplace_back<SynthTrace::CreateObjectRecord>(
+              time, in.readVarUInt());
+          break;
+        case RecordType::CreateHostObject:
+          trace.emplace_back<SynthTrace::CreateHostObjectRecord>(
+              time, in.readVarUInt());
+          break;
+        case RecordType::CreateHostFunction:
+          trace.emplace_back<SynthTrace::CreateHostFunctionRecord>(
+              time, in.readVarUInt());
+          break;
+        case RecordType::GetProperty:
+        case RecordType::SetProperty: {
+          SynthTrace::ObjectID objID = in.readVarUInt();
+          std::string propName = readName();
+          TraceValue value = readValue();
+          if (tag == static_cast<uint8_t>(RecordType::GetProperty)) {
+            trace.emplace_back<SynthTrace::GetPropertyRecord>(
+                time, objID, propName, value);
+          } else {
+            trace.emplace_back<SynthTrace::SetPropertyRecord>(
+                time, objID, propName, value);
+          }
+          break;
+        }
+        case RecordType::HasProperty: {
+          SynthTrace::ObjectID objID = in.readVarUInt();
+          trace.emplace_back<SynthTrace::HasPropertyRecord>(
+              time, objID, readName());
+          break;
+        }
+        case RecordType::GetPropertyNames: {
+          SynthTrace::ObjectID objID = in.readVarUInt();
+          trace.emplace_back<SynthTrace::GetPropertyNamesRecord>(
+              time, objID, in.readVarUInt());
+          break;
+        }
+        case RecordType::CreateArray: {
+          SynthTrace::ObjectID objID = in.readVarUInt();
+          trace.emplace_back<SynthTrace::CreateArrayRecord>(
+              time, objID, in.readVarUInt());
+          break;
+        }
+        case RecordType::ArrayRead:
+        case RecordType::ArrayWrite: {
+          SynthTrace::ObjectID objID = in.readVarUInt();
+          size_t index = in.readVarUInt();
+          TraceValue value = readValue();
+          if (tag == static_cast<uint8_t>(RecordType::ArrayRead)) {
+            trace.emplace_back<SynthTrace::ArrayReadRecord>(
+                time, objID, index, value);
+          } else {
+            trace.emplace_back<SynthTrace::ArrayWriteRecord>(
+                time, objID, index, value);
+          }
+          break;
+        }
+        case RecordType::CallFromNative:
+        case RecordType::ConstructFromNative:
+        case RecordType::CallToNative: {
+          SynthTrace::ObjectID functionID = in.readVarUInt();
+          TraceValue thisArg = readValue();
+          std::vector<TraceValue> args = readArgs();
+          if (tag == static_cast<uint8_t>(RecordType::CallFromNative)) {
+            trace.emplace_back<SynthTrace::CallFromNativeRecord>(
+                time, functionID, thisArg, args);
+          } else if (
+              tag == static_cast<uint8_t>(RecordType::ConstructFromNative)) {
+            trace.emplace_back<SynthTrace::ConstructFromNativeRecord>(
+                time, functionID, thisArg, args);
+          } else {
+            trace.emplace_back<SynthTrace::CallToNativeRecord>(
+                time, functionID, thisArg, args);
+          }
+          break;
+        }
+        case RecordType::ReturnFromNative:
+          trace.emplace_back<SynthTrace::ReturnFromNativeRecord>(
+              time, readValue());
+          break;
+        case RecordType::ReturnToNative:
+          trace.emplace_back<SynthTrace::ReturnToNativeRecord>(
+              time, readValue());
+          break;
+        case RecordType::GetPropertyNative: {
+          SynthTrace::ObjectID hostObjectID = in.readVarUInt();
+          trace.emplace_back<SynthTrace::GetPropertyNativeRecord>(
+              time, hostObjectID, readName());
+          break;
+        }
+        case RecordType::GetPropertyNativeReturn:
+          trace.emplace_back<SynthTrace::GetPropertyNativeReturnRecord>(
+              time, readValue());
+          break;
+        case RecordType::SetPropertyNative: {
+          SynthTrace::ObjectID hostObjectID = in.readVarUInt();
+          std::string propName = readName();
+          trace.emplace_back<SynthTrace::SetPropertyNativeRecord>(
+              time, hostObjectID, propName, readValue());
+          break;
+        }
+        case RecordType::SetPropertyNativeReturn:
+          trace.emplace_back<SynthTrace::SetPropertyNativeReturnRecord>(time);
+          break;
+      }
+    }
+  } catch (const TruncatedTrace &) {
+    // The writer was not closed. Keep what was written in full.
+  }
+
+  return std::make_tuple(
+      std::move(trace),
+      ::hermes::vm::RuntimeConfig::Builder()
+          .withGCConfig(gcconf.build())
+          .build(),
+      std::move(env));
+}
+
+} // namespace tracing
+} // namespace hermes
+} // namespace facebook
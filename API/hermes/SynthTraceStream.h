@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_SYNTHTRACESTREAM_H
+#define HERMES_SYNTHTRACESTREAM_H
+
+#include "SynthTrace.h"
+
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+namespace facebook {
+namespace hermes {
+namespace tracing {
+
+/// Writes the records of a SynthTrace to a stream as they are made, in a
+/// compact binary format, instead of keeping them in memory until the end of
+/// the session. The thread making the records only encodes them into a
+/// lock-free ring buffer; a background thread drains that buffer into the
+/// output stream. The result is read back by SynthTrace::parse.
+///
+/// The format is a header with the global object id and the GC config,
+/// followed by a list of entries each starting with a tag byte: a record, the
+/// definition of a string referenced by later records, or the source hash.
+/// close() appends the mocked environment and an end tag. Integers are
+/// unsigned LEB128, and record times are deltas from the previous record.
+class SynthTraceStreamWriter {
+ public:
+  static constexpr size_t kDefaultBufferSize = 1 << 20;
+
+  /// Start writing a trace of a runtime whose global object is
+  /// \p globalObjID to \p os, which is only used by the flush thread from now
+  /// on.
+  /// \param bufferSize the size in bytes of the ring buffer, rounded up to a
+  ///   power of two. Recording blocks while the buffer is full.
+  SynthTraceStreamWriter(
+      std::unique_ptr<llvm::raw_ostream> os,
+      SynthTrace::ObjectID globalObjID,
+      const ::hermes::vm::RuntimeConfig &conf,
+      size_t bufferSize = kDefaultBufferSize);
+
+  /// Closes the trace without an environment if close() was not called.
+  ~SynthTraceStreamWriter();
+
+  /// Append \p rec to the trace. String values and property names are written
+  /// as indices into the string table of \p trace, whose new entries are
+  /// written first.
+  void write(const SynthTrace::Record &rec, SynthTrace &trace);
+
+  /// Append the hash of the bytecode being run.
+  void writeSourceHash(const ::hermes::SHA1 &sourceHash);
+
+  /// Append \p env, wait until everything has been flushed to the output
+  /// stream, and stop the flush thread. Nothing can be written afterwards.
+  void close(const ::hermes::vm::MockedEnvironment &env);
+
+  bool isClosed() const {
+    return !flushThread_.joinable();
+  }
+
+ private:
+  /// Copy the bytes encoded in scratch_ into the ring buffer.
+  void push();
+
+  /// Append the end tag and stop the flush thread once it has written
+  /// everything.
+  void stop();
+
+  /// Body of the flush thread.
+  void flushLoop();
+
+  std::unique_ptr<llvm::raw_ostream> os_;
+
+  /// The ring buffer. Its size is a power of two, and head_ and tail_ are
+  /// free-running counts of the bytes written into it and out of it.
+  std::unique_ptr<char[]> ring_;
+  const size_t mask_;
+  /// Only written by the recording thread.
+  std::atomic<size_t> head_{0};
+  /// Only written by the flush thread.
+  std::atomic<size_t> tail_{0};
+  std::atomic<bool> closing_{false};
+
+  /// Used by the flush thread to sleep while the buffer is empty. The
+  /// recording thread only wakes it up early when the buffer gets half full.
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread flushThread_;
+
+  /// The encoding of the entries being written, reused across entries.
+  std::string scratch_;
+  /// The encoding of the record being written, reused across records.
+  std::string recordScratch_;
+  /// The number of strings of the trace's string table written so far.
+  size_t stringsWritten_{0};
+  /// The time of the last record written.
+  SynthTrace::TimeSinceStart lastTime_{SynthTrace::TimeSinceStart::zero()};
+};
+
+/// \return true if \p buf holds a trace written by a SynthTraceStreamWriter.
+bool isSynthTraceStream(const llvm::MemoryBuffer &buf);
+
+/// Parse a trace written by a SynthTraceStreamWriter. A trace cut short, for
+/// instance because the process died, keeps the records it has in full and
+/// gets a default environment.
+/// \throws invalid_argument if the trace is malformed.
+std::tuple<
+    SynthTrace,
+    ::hermes::vm::RuntimeConfig,
+    ::hermes::vm::MockedEnvironment>
+parseSynthTraceStream(const llvm::MemoryBuffer &buf);
+
+} // namespace tracing
+} // namespace hermes
+} // namespace facebook
+
+#endif
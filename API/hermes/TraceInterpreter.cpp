@@ -414,8 +414,71 @@ static std::string mergeGCStats(const std::vector<std::string> &repGCStats) {
   return *valueAndStats[median].second;
 }
 
+/// Adds the time between its construction and its destruction to a list of
+/// durations, if it has one.
+class RecordTimer {
+ public:
+  explicit RecordTimer(
+      std::vector<TraceInterpreter::RecordTimings::Duration> *durations)
+      : durations_(durations),
+        start_(
+            durations ? std::chrono::steady_clock::now()
+                      : std::chrono::steady_clock::time_point()) {}
+
+  ~RecordTimer() {
+    if (durations_) {
+      durations_->push_back(
+          std::chrono::duration_cast<TraceInterpreter::RecordTimings::Duration>(
+              std::chrono::steady_clock::now() - start_));
+    }
+  }
+
+ private:
+  std::vector<TraceInterpreter::RecordTimings::Duration> *durations_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+/// Write the count, total, p50 and p99 of \p durations, in microseconds, as
+/// a JSON object.
+void emitDurationSummary(
+    ::hermes::JSONEmitter &json,
+    std::vector<TraceInterpreter::RecordTimings::Duration> durations) {
+  using Micros = std::chrono::duration<double, std::micro>;
+  std::sort(durations.begin(), durations.end());
+  const auto percentile = [&durations](unsigned p) {
+    return Micros(durations[(durations.size() - 1) * p / 100]).count();
+  };
+  TraceInterpreter::RecordTimings::Duration total{0};
+  for (auto d : durations)
+    total += d;
+  json.openDict();
+  json.emitKeyValue("count", durations.size());
+  json.emitKeyValue("totalUs", Micros(total).count());
+  json.emitKeyValue("p50Us", durations.empty() ? 0.0 : percentile(50));
+  json.emitKeyValue("p99Us", durations.empty() ? 0.0 : percentile(99));
+  json.closeDict();
+}
+
 } // namespace
 
+void TraceInterpreter::RecordTimings::toJSON(
+    ::hermes::JSONEmitter &json) const {
+  json.openDict();
+  json.emitKey("reps");
+  emitDurationSummary(json, repDurations);
+  json.emitKey("records");
+  json.openDict();
+  for (const auto &typeAndDurations : durations) {
+    std::string name;
+    llvm::raw_string_ostream os{name};
+    os << typeAndDurations.first;
+    json.emitKey(os.str());
+    emitDurationSummary(json, typeAndDurations.second);
+  }
+  json.closeDict();
+  json.closeDict();
+}
+
 TraceInterpreter::TraceInterpreter(
     jsi::Runtime &rt,
     const ExecuteOptions &options,
@@ -563,8 +626,19 @@ std::string TraceInterpreter::execFromMemoryBuffer(
     rt->setMockedEnvironment(std::get<2>(traceAndConfigAndEnv));
     std::function<void()> writeTrace = nullptr;
 #endif
-    auto stats =
-        exec(*rt, options, trace, bufView(codeFileBuffer.get()), writeTrace);
+    // Only time the records of the measured reps.
+    ExecuteOptions repOptions = options;
+    if (rep < 0) {
+      repOptions.timings = nullptr;
+    }
+    auto repStart = std::chrono::steady_clock::now();
+    auto stats = exec(
+        *rt, repOptions, trace, bufView(codeFileBuffer.get()), writeTrace);
+    if (repOptions.timings) {
+      repOptions.timings->repDurations.push_back(
+          std::chrono::duration_cast<RecordTimings::Duration>(
+              std::chrono::steady_clock::now() - repStart));
+    }
     // If we're not warming up, save the stats.
     if (rep >= 0) {
       repGCStats[rep] = stats;
@@ -763,6 +837,11 @@ Value TraceInterpreter::execFunction(
       return result;
     };
     for (const SynthTrace::Record *rec : piece.records) {
+      // Covers every way out of the replay of the record, including the
+      // returns from native calls.
+      RecordTimer timer{options.timings
+                            ? &options.timings->durations[rec->getType()]
+                            : nullptr};
       try {
         switch (rec->getType()) {
           case RecordType::BeginExecJS:
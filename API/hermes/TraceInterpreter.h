@@ -17,6 +17,8 @@
 #include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/raw_ostream.h>
 
+#include <chrono>
+#include <map>
 #include <unordered_map>
 #include <vector>
 
@@ -84,6 +86,23 @@ class TraceInterpreter final {
   using HostObjectToCalls =
       std::unordered_map<SynthTrace::ObjectID, PropNameToCalls>;
 
+  /// The time spent replaying the records of a trace, for benchmarking.
+  /// The time of a record includes the JS and the nested host calls that it
+  /// ran, so records which enter JS (like CallFromNative) cover the records
+  /// of the calls they lead to.
+  struct RecordTimings {
+    using Duration = std::chrono::nanoseconds;
+
+    /// The duration of each replayed record, by record type.
+    std::map<SynthTrace::RecordType, std::vector<Duration>> durations;
+    /// The duration of each measured rep.
+    std::vector<Duration> repDurations;
+
+    /// Write the count, total, p50 and p99 of the durations of each record
+    /// type, and the same for the reps, as a JSON object.
+    void toJSON(::hermes::JSONEmitter &json) const;
+  };
+
   /// Options for executing the trace.
   /// \param warmupReps Number of initial executions whose stats are discarded.
   /// \param reps Number of repetitions of execution. Stats returned are those
@@ -96,6 +115,8 @@ class TraceInterpreter final {
   ///   the young generation.
   /// \param revertToYGAtTTI: if true, and if the GC was not allocating in the
   ///   young generation, change back to young-gen allocation at TTI.
+  /// \param timings if non-null, the time spent replaying each record of the
+  ///   reps which aren't warmup reps is added to it.
   struct ExecuteOptions {
     std::string marker;
     int warmupReps{0};
@@ -109,6 +130,7 @@ class TraceInterpreter final {
     uint8_t bytecodeWarmupPercent{0};
     double sanitizeRate{0.0};
     int64_t sanitizeRandomSeed{-1};
+    RecordTimings *timings{nullptr};
   };
 
  private:
@@ -22,17 +22,15 @@ TracingRuntime::TracingRuntime(
 jsi::Value TracingRuntime::evaluateJavaScript(
     const std::shared_ptr<const jsi::Buffer> &buffer,
     const std::string &sourceURL) {
-  trace_.emplace_back<SynthTrace::BeginExecJSRecord>(getTimeSinceStart());
+  record<SynthTrace::BeginExecJSRecord>(getTimeSinceStart());
   auto res = RD::evaluateJavaScript(buffer, sourceURL);
-  trace_.emplace_back<SynthTrace::EndExecJSRecord>(
-      getTimeSinceStart(), toTraceValue(res));
+  record<SynthTrace::EndExecJSRecord>(getTimeSinceStart(), toTraceValue(res));
   return res;
 }
 
 jsi::Object TracingRuntime::createObject() {
   auto obj = RD::createObject();
-  trace_.emplace_back<SynthTrace::CreateObjectRecord>(
-      getTimeSinceStart(), getUniqueID(obj));
+  record<SynthTrace::CreateObjectRecord>(getTimeSinceStart(), getUniqueID(obj));
   return obj;
 }
 
@@ -44,13 +42,13 @@ jsi::Object TracingRuntime::createObject(std::shared_ptr<jsi::HostObject> ho) {
     jsi::Value get(jsi::Runtime &rt, const jsi::PropNameID &name) override {
       TracingRuntime &trt = static_cast<TracingRuntime &>(rt);
 
-      trt.trace_.emplace_back<SynthTrace::GetPropertyNativeRecord>(
+      trt.record<SynthTrace::GetPropertyNativeRecord>(
           trt.getTimeSinceStart(), objID_, name.utf8(rt));
 
       try {
         auto ret = DecoratedHostObject::get(rt, name);
 
-        trt.trace_.emplace_back<SynthTrace::GetPropertyNativeReturnRecord>(
+        trt.record<SynthTrace::GetPropertyNativeReturnRecord>(
             trt.getTimeSinceStart(), trt.toTraceValue(ret));
 
         return ret;
@@ -68,7 +66,7 @@ jsi::Object TracingRuntime::createObject(std::shared_ptr<jsi::HostObject> ho) {
         const jsi::Value &value) override {
       TracingRuntime &trt = static_cast<TracingRuntime &>(rt);
 
-      trt.trace_.emplace_back<SynthTrace::SetPropertyNativeRecord>(
+      trt.record<SynthTrace::SetPropertyNativeRecord>(
           trt.getTimeSinceStart(),
           objID_,
           name.utf8(rt),
@@ -83,7 +81,7 @@ jsi::Object TracingRuntime::createObject(std::shared_ptr<jsi::HostObject> ho) {
             "Exception happened in native code during trace");
       }
 
-      trt.trace_.emplace_back<SynthTrace::SetPropertyNativeReturnRecord>(
+      trt.record<SynthTrace::SetPropertyNativeReturnRecord>(
           trt.getTimeSinceStart());
     }
 
@@ -101,7 +99,7 @@ jsi::Object TracingRuntime::createObject(std::shared_ptr<jsi::HostObject> ho) {
   auto tracer = std::make_shared<TracingHostObject>(*this, ho);
   auto obj = RD::createObject(tracer);
   tracer->setObjectID(getUniqueID(obj));
-  trace_.emplace_back<SynthTrace::CreateHostObjectRecord>(
+  record<SynthTrace::CreateHostObjectRecord>(
       getTimeSinceStart(), getUniqueID(obj));
   return obj;
 }
@@ -110,7 +108,7 @@ jsi::Value TracingRuntime::getProperty(
     const jsi::Object &obj,
     const jsi::String &name) {
   auto value = RD::getProperty(obj, name);
-  trace_.emplace_back<SynthTrace::GetPropertyRecord>(
+  record<SynthTrace::GetPropertyRecord>(
       getTimeSinceStart(), getUniqueID(obj), utf8(name), toTraceValue(value));
   return value;
 }
@@ -119,7 +117,7 @@ jsi::Value TracingRuntime::getProperty(
     const jsi::Object &obj,
     const jsi::PropNameID &name) {
   auto value = RD::getProperty(obj, name);
-  trace_.emplace_back<SynthTrace::GetPropertyRecord>(
+  record<SynthTrace::GetPropertyRecord>(
       getTimeSinceStart(), getUniqueID(obj), utf8(name), toTraceValue(value));
   return value;
 }
@@ -127,7 +125,7 @@ jsi::Value TracingRuntime::getProperty(
 bool TracingRuntime::hasProperty(
     const jsi::Object &obj,
     const jsi::String &name) {
-  trace_.emplace_back<SynthTrace::HasPropertyRecord>(
+  record<SynthTrace::HasPropertyRecord>(
       getTimeSinceStart(), getUniqueID(obj), utf8(name));
   return RD::hasProperty(obj, name);
 }
@@ -135,7 +133,7 @@ bool TracingRuntime::hasProperty(
 bool TracingRuntime::hasProperty(
     const jsi::Object &obj,
     const jsi::PropNameID &name) {
-  trace_.emplace_back<SynthTrace::HasPropertyRecord>(
+  record<SynthTrace::HasPropertyRecord>(
       getTimeSinceStart(), getUniqueID(obj), utf8(name));
   return RD::hasProperty(obj, name);
 }
@@ -144,7 +142,7 @@ void TracingRuntime::setPropertyValue(
     jsi::Object &obj,
     const jsi::String &name,
     const jsi::Value &value) {
-  trace_.emplace_back<SynthTrace::SetPropertyRecord>(
+  record<SynthTrace::SetPropertyRecord>(
       getTimeSinceStart(), getUniqueID(obj), utf8(name), toTraceValue(value));
   RD::setPropertyValue(obj, name, value);
 }
@@ -153,14 +151,14 @@ void TracingRuntime::setPropertyValue(
     jsi::Object &obj,
     const jsi::PropNameID &name,
     const jsi::Value &value) {
-  trace_.emplace_back<SynthTrace::SetPropertyRecord>(
+  record<SynthTrace::SetPropertyRecord>(
       getTimeSinceStart(), getUniqueID(obj), utf8(name), toTraceValue(value));
   RD::setPropertyValue(obj, name, value);
 }
 
 jsi::Array TracingRuntime::getPropertyNames(const jsi::Object &o) {
   jsi::Array arr = RD::getPropertyNames(o);
-  trace_.emplace_back<SynthTrace::GetPropertyNamesRecord>(
+  record<SynthTrace::GetPropertyNamesRecord>(
       getTimeSinceStart(), getUniqueID(o), getUniqueID(arr));
   return arr;
 }
@@ -179,7 +177,7 @@ jsi::Value TracingRuntime::lockWeakObject(const jsi::WeakObject &wo) {
 
 jsi::Array TracingRuntime::createArray(size_t length) {
   auto arr = RD::createArray(length);
-  trace_.emplace_back<SynthTrace::CreateArrayRecord>(
+  record<SynthTrace::CreateArrayRecord>(
       getTimeSinceStart(), getUniqueID(arr), length);
   return arr;
 }
@@ -203,7 +201,7 @@ uint8_t *TracingRuntime::data(const jsi::ArrayBuffer &buf) {
 
 jsi::Value TracingRuntime::getValueAtIndex(const jsi::Array &arr, size_t i) {
   auto value = RD::getValueAtIndex(arr, i);
-  trace_.emplace_back<SynthTrace::ArrayReadRecord>(
+  record<SynthTrace::ArrayReadRecord>(
       getTimeSinceStart(), getUniqueID(arr), i, toTraceValue(value));
   return value;
 }
@@ -212,7 +210,7 @@ void TracingRuntime::setValueAtIndexImpl(
     jsi::Array &arr,
     size_t i,
     const jsi::Value &value) {
-  trace_.emplace_back<SynthTrace::ArrayWriteRecord>(
+  record<SynthTrace::ArrayWriteRecord>(
       getTimeSinceStart(), getUniqueID(arr), i, toTraceValue(value));
   return RD::setValueAtIndexImpl(arr, i, value);
 }
@@ -232,7 +230,7 @@ jsi::Function TracingRuntime::createFunctionFromHostFunction(
         size_t count) {
       TracingRuntime &trt = static_cast<TracingRuntime &>(rt);
 
-      trt.trace_.emplace_back<SynthTrace::CallToNativeRecord>(
+      trt.record<SynthTrace::CallToNativeRecord>(
           trt.getTimeSinceStart(),
           functionID_,
           // A host function does not have a this.
@@ -243,7 +241,7 @@ jsi::Function TracingRuntime::createFunctionFromHostFunction(
         auto ret =
             jsi::DecoratedHostFunction::operator()(rt, thisVal, args, count);
 
-        trt.trace_.emplace_back<SynthTrace::ReturnFromNativeRecord>(
+        trt.record<SynthTrace::ReturnFromNativeRecord>(
             trt.getTimeSinceStart(), trt.toTraceValue(ret));
         return ret;
       } catch (...) {
@@ -267,7 +265,7 @@ jsi::Function TracingRuntime::createFunctionFromHostFunction(
       RD::createFunctionFromHostFunction(name, paramCount, std::move(tracer));
   RD::getHostFunction(tfunc).target<TracingHostFunction>()->setFunctionID(
       getUniqueID(tfunc));
-  trace_.emplace_back<SynthTrace::CreateHostFunctionRecord>(
+  record<SynthTrace::CreateHostFunctionRecord>(
       getTimeSinceStart(), getUniqueID(tfunc));
   return tfunc;
 }
@@ -277,13 +275,13 @@ jsi::Value TracingRuntime::call(
     const jsi::Value &jsThis,
     const jsi::Value *args,
     size_t count) {
-  trace_.emplace_back<SynthTrace::CallFromNativeRecord>(
+  record<SynthTrace::CallFromNativeRecord>(
       getTimeSinceStart(),
       getUniqueID(func),
       toTraceValue(jsThis),
       argStringifyer(args, count));
   auto retval = RD::call(func, jsThis, args, count);
-  trace_.emplace_back<SynthTrace::ReturnToNativeRecord>(
+  record<SynthTrace::ReturnToNativeRecord>(
       getTimeSinceStart(), toTraceValue(retval));
   return retval;
 }
@@ -292,7 +290,7 @@ jsi::Value TracingRuntime::callAsConstructor(
     const jsi::Function &func,
     const jsi::Value *args,
     size_t count) {
-  trace_.emplace_back<SynthTrace::ConstructFromNativeRecord>(
+  record<SynthTrace::ConstructFromNativeRecord>(
       getTimeSinceStart(),
       getUniqueID(func),
       // A construct call always has an undefined this.
@@ -302,13 +300,13 @@ jsi::Value TracingRuntime::callAsConstructor(
       SynthTrace::encodeUndefined(),
       argStringifyer(args, count));
   auto retval = RD::callAsConstructor(func, args, count);
-  trace_.emplace_back<SynthTrace::ReturnToNativeRecord>(
+  record<SynthTrace::ReturnToNativeRecord>(
       getTimeSinceStart(), toTraceValue(retval));
   return retval;
 }
 
 void TracingRuntime::addMarker(const std::string &marker) {
-  trace_.emplace_back<SynthTrace::MarkerRecord>(getTimeSinceStart(), marker);
+  record<SynthTrace::MarkerRecord>(getTimeSinceStart(), marker);
 }
 
 std::vector<SynthTrace::TraceValue> TracingRuntime::argStringifyer(
@@ -361,6 +359,12 @@ TracingHermesRuntime::TracingHermesRuntime(
     const ::hermes::vm::RuntimeConfig &runtimeConfig)
     : TracingRuntime(std::move(runtime), globalID), conf_(runtimeConfig) {}
 
+TracingHermesRuntime::~TracingHermesRuntime() {
+  if (streamWriter() && !streamWriter()->isClosed()) {
+    streamWriter()->close(hermesRuntime().getMockedEnvironment());
+  }
+}
+
 void TracingHermesRuntime::writeTrace(llvm::raw_ostream &os) const {
   os << SynthTrace::Printable(
       trace(), hermesRuntime().getMockedEnvironment(), conf_);
@@ -384,6 +388,9 @@ jsi::Value TracingHermesRuntime::evaluateJavaScript(
     trace().setSourceHash(
         ::hermes::hbc::BCProviderFromBuffer::getSourceHashFromBytecode(
             llvm::makeArrayRef(buffer->data(), buffer->size())));
+    if (streamWriter()) {
+      streamWriter()->writeSourceHash(trace().sourceHash());
+    }
   }
   return TracingRuntime::evaluateJavaScript(buffer, sourceURL);
 }
@@ -431,6 +438,18 @@ std::unique_ptr<TracingHermesRuntime> makeTracingHermesRuntime(
   return ret;
 }
 
+std::unique_ptr<TracingHermesRuntime> makeStreamingTracingHermesRuntime(
+    std::unique_ptr<HermesRuntime> hermesRuntime,
+    const ::hermes::vm::RuntimeConfig &runtimeConfig,
+    std::unique_ptr<llvm::raw_ostream> traceStream) {
+  auto ret = std::make_unique<TracingHermesRuntime>(
+      std::move(hermesRuntime), runtimeConfig);
+  ret->setStreamWriter(std::make_unique<SynthTraceStreamWriter>(
+      std::move(traceStream), ret->trace().globalObjID(), runtimeConfig));
+  addRecordMarker(*ret);
+  return ret;
+}
+
 } // namespace tracing
 } // namespace hermes
 } // namespace facebook
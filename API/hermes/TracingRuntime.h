@@ -8,6 +8,7 @@
 #define HERMES_TRACINGRUNTIME_H
 
 #include "SynthTrace.h"
+#include "SynthTraceStream.h"
 
 #include <hermes/hermes.h>
 #include <jsi/decorator.h>
@@ -100,7 +101,28 @@ class TracingRuntime : public jsi::RuntimeDecorator<jsi::Runtime> {
     return trace_;
   }
 
+  /// Write the records made from now on to \p writer as they are made,
+  /// instead of keeping them in trace().
+  void setStreamWriter(std::unique_ptr<SynthTraceStreamWriter> writer) {
+    streamWriter_ = std::move(writer);
+  }
+
+  /// \return the writer set by setStreamWriter(), if any.
+  SynthTraceStreamWriter *streamWriter() {
+    return streamWriter_.get();
+  }
+
  private:
+  /// Record an event of type \p T, made from \p args.
+  template <typename T, typename... Args>
+  void record(Args &&... args) {
+    if (streamWriter_) {
+      streamWriter_->write(T(std::forward<Args>(args)...), trace_);
+    } else {
+      trace_.emplace_back<T>(std::forward<Args>(args)...);
+    }
+  }
+
   SynthTrace::TraceValue toTraceValue(const jsi::Value &value);
 
   std::vector<SynthTrace::TraceValue> argStringifyer(
@@ -111,6 +133,7 @@ class TracingRuntime : public jsi::RuntimeDecorator<jsi::Runtime> {
 
   std::unique_ptr<jsi::Runtime> runtime_;
   SynthTrace trace_;
+  std::unique_ptr<SynthTraceStreamWriter> streamWriter_;
   const SynthTrace::TimePoint startTime_{std::chrono::steady_clock::now()};
 };
 
@@ -122,10 +145,15 @@ class TracingHermesRuntime final : public TracingRuntime {
       std::unique_ptr<HermesRuntime> runtime,
       const ::hermes::vm::RuntimeConfig &runtimeConfig);
 
+  /// Closes the stream writer, if any, with the mocked environment.
+  ~TracingHermesRuntime();
+
   SynthTrace::ObjectID getUniqueID(const jsi::Object &o) override {
     return static_cast<SynthTrace::ObjectID>(hermesRuntime().getUniqueID(o));
   }
 
+  /// Write the trace as JSON. If it was streamed to a SynthTraceStreamWriter,
+  /// this has no records.
   void writeTrace(llvm::raw_ostream &os) const override;
 
   void writeBridgeTrafficTraceToFile(
@@ -163,6 +191,15 @@ std::unique_ptr<TracingHermesRuntime> makeTracingHermesRuntime(
     std::unique_ptr<HermesRuntime> hermesRuntime,
     const ::hermes::vm::RuntimeConfig &runtimeConfig);
 
+/// Like makeTracingHermesRuntime, but streams the trace in binary to
+/// \p traceStream as it is recorded, which keeps the overhead low enough to
+/// trace sampled sessions in production. The trace is complete once the
+/// returned runtime is destroyed, and can be replayed like a JSON trace.
+std::unique_ptr<TracingHermesRuntime> makeStreamingTracingHermesRuntime(
+    std::unique_ptr<HermesRuntime> hermesRuntime,
+    const ::hermes::vm::RuntimeConfig &runtimeConfig,
+    std::unique_ptr<llvm::raw_ostream> traceStream);
+
 } // namespace tracing
 } // namespace hermes
 } // namespace facebook
@@ -19,11 +19,14 @@
 
 #include "hermes/BCGen/HBC/BytecodeDataProvider.h"
 #include "hermes/BCGen/HBC/BytecodeProviderFromSrc.h"
+#include "hermes/BCGen/HBC/BytecodeStream.h"
 #include "hermes/DebuggerAPI.h"
 #include "hermes/Instrumentation/PerfMarkers.h"
 #include "hermes/Platform/Logging.h"
 #include "hermes/Public/RuntimeConfig.h"
 #include "hermes/Support/Algorithms.h"
+#include "hermes/Support/MemoryBuffer.h"
+#include "hermes/Support/SHA1.h"
 #include "hermes/Support/UTF8.h"
 #include "hermes/VM/CallResult.h"
 #include "hermes/VM/Debugger/Debugger.h"
@@ -34,18 +37,23 @@
 #include "hermes/VM/JSError.h"
 #include "hermes/VM/JSLib.h"
 #include "hermes/VM/JSLib/RuntimeCommonStorage.h"
+#include "hermes/VM/JSLib/RuntimeJSONUtils.h"
 #include "hermes/VM/Operations.h"
 #include "hermes/VM/Profiler/SamplingProfiler.h"
 #include "hermes/VM/Runtime.h"
 #include "hermes/VM/StringPrimitive.h"
 #include "hermes/VM/StringView.h"
+#include "hermes/VM/StructuredClone.h"
 
 #include "llvm/Support/ConvertUTF.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/SHA1.h"
 #include "llvm/Support/raw_os_ostream.h"
 
+#include <algorithm>
 #include <atomic>
 #include <limits>
 #include <list>
@@ -279,7 +287,8 @@ class HermesRuntimeImpl final : public HermesRuntime,
                 .build())),
         runtime_(*rt_),
 #endif
-        crashMgr_(runtimeConfig.getCrashMgr()) {
+        crashMgr_(runtimeConfig.getCrashMgr()),
+        bytecodeCacheDir_(runtimeConfig.getBytecodeCacheDir()) {
 #ifndef HERMESJSI_ON_STACK
     // Register the memory for the runtime if it isn't stored on the stack.
     crashMgr_->registerMemory(&runtime_, sizeof(vm::Runtime));
@@ -456,6 +465,13 @@ class HermesRuntimeImpl final : public HermesRuntime,
 
 #undef BRIDGE_INFO
 
+    // The executable memory of the JIT is not part of the GC heap.
+    auto &jit = runtime_.getJITContext();
+    jsInfo.setProperty(
+        *this, "hermes_jitCodeSize", static_cast<int>(jit.getCodeSize()));
+    jsInfo.setProperty(
+        *this, "hermes_jitMappedSize", static_cast<int>(jit.getMappedSize()));
+
 #define BRIDGE_GEN_INFO(NAME, STAT_EXPR, FACTOR)                      \
   jsInfo.setProperty(                                                 \
       *this, "hermes_full_" #NAME, info.fullStats.STAT_EXPR *FACTOR); \
@@ -853,6 +869,31 @@ class HermesRuntimeImpl final : public HermesRuntime,
     HFContextBase(jsi::HostFunctionType hf, HermesRuntimeImpl &hri)
         : hostFunction(std::move(hf)), hermesRuntimeImpl(hri) {}
 
+    /// Call \p f, which calls the host function, and turn any C++ exception
+    /// that it throws into a JS exception.
+    template <typename F>
+    static vm::CallResult<vm::HermesValue> callCatchingExceptions(
+        HermesRuntimeImpl &rt,
+        const F &f) {
+      try {
+        return f();
+      } catch (const jsi::JSError &error) {
+        return rt.runtime_.setThrownValue(hvFromValue(error.value()));
+      } catch (const std::exception &ex) {
+        return rt.runtime_.setThrownValue(hvFromValue(
+            rt.global()
+                .getPropertyAsFunction(rt, "Error")
+                .call(
+                    rt,
+                    std::string("Exception in HostFunction: ") + ex.what())));
+      } catch (...) {
+        return rt.runtime_.setThrownValue(
+            hvFromValue(rt.global()
+                            .getPropertyAsFunction(rt, "Error")
+                            .call(rt, "Exception in HostFunction: <unknown>")));
+      }
+    }
+
     jsi::HostFunctionType hostFunction;
     HermesRuntimeImpl &hermesRuntimeImpl;
   };
@@ -874,41 +915,170 @@ class HermesRuntimeImpl final : public HermesRuntime,
         apiArgs.push_back(rt.valueFromHermesValue(hv));
       }
 
-      jsi::Value ret;
       const jsi::Value *args = apiArgs.empty() ? nullptr : &apiArgs.front();
 
-      try {
-        ret = (hfc->hostFunction)(
+      return callCatchingExceptions(rt, [&] {
+        return hvFromValue((hfc->hostFunction)(
             rt,
             rt.valueFromHermesValue(hvArgs.getThisArg()),
             args,
-            apiArgs.size());
-      } catch (const jsi::JSError &error) {
-        return runtime->setThrownValue(hvFromValue(error.value()));
-      } catch (const std::exception &ex) {
-        return rt.runtime_.setThrownValue(hvFromValue(
-            rt.global()
-                .getPropertyAsFunction(rt, "Error")
-                .call(
-                    rt,
-                    std::string("Exception in HostFunction: ") + ex.what())));
-      } catch (...) {
-        return rt.runtime_.setThrownValue(
-            hvFromValue(rt.global()
-                            .getPropertyAsFunction(rt, "Error")
-                            .call(rt, "Exception in HostFunction: <unknown>")));
+            apiArgs.size()));
+      });
+    }
+
+    static void finalize(void *context) {
+      delete reinterpret_cast<HFContext *>(context);
+    }
+  };
+
+  /// The context of a function created by createNumberFunction(). The host
+  /// function is called with the arguments read straight from the frame, with
+  /// no jsi::Value conversion and no handle for \c this.
+  struct NumberHFContext final : public HFContextBase {
+    NumberHFContext(
+        NumberHostFunctionType nf,
+        unsigned paramCount,
+        HermesRuntimeImpl &hri)
+        : HFContextBase(makeHostFunction(nf, paramCount), hri),
+          numberFunction(std::move(nf)),
+          paramCount(paramCount) {}
+
+    static vm::CallResult<vm::HermesValue>
+    func(void *context, vm::Runtime *runtime, vm::NativeArgs hvArgs) {
+      NumberHFContext *hfc = reinterpret_cast<NumberHFContext *>(context);
+      HermesRuntimeImpl &rt = hfc->hermesRuntimeImpl;
+      assert(runtime == &rt.runtime_);
+      auto &stats = rt.runtime_.getRuntimeStats();
+      const vm::instrumentation::RAIITimer timer{
+          "Host Function", stats, stats.hostFunction};
+
+      llvm::SmallVector<double, 8> args(
+          hfc->paramCount, std::numeric_limits<double>::quiet_NaN());
+      unsigned count = std::min(hfc->paramCount, hvArgs.getArgCount());
+      for (unsigned i = 0; i < count; ++i) {
+        vm::HermesValue hv = hvArgs.getArg(i);
+        if (LLVM_LIKELY(hv.isNumber())) {
+          args[i] = hv.getNumber();
+          continue;
+        }
+        auto res = vm::toNumber_RJS(runtime, hvArgs.getArgHandle(runtime, i));
+        if (LLVM_UNLIKELY(res == vm::ExecutionStatus::EXCEPTION))
+          return vm::ExecutionStatus::EXCEPTION;
+        args[i] = res->getNumber();
       }
 
-      return hvFromValue(ret);
+      return callCatchingExceptions(rt, [&] {
+        return vm::HermesValue::encodeNumberValue(
+            hfc->numberFunction(args.data(), args.size()));
+      });
     }
 
     static void finalize(void *context) {
-      delete reinterpret_cast<HFContext *>(context);
+      delete reinterpret_cast<NumberHFContext *>(context);
+    }
+
+    /// \return a jsi::HostFunctionType which calls \p nf like func() does,
+    /// for callers of getHostFunction().
+    static jsi::HostFunctionType makeHostFunction(
+        NumberHostFunctionType nf,
+        unsigned paramCount) {
+      return [nf, paramCount](
+                 jsi::Runtime &rt,
+                 const jsi::Value &,
+                 const jsi::Value *args,
+                 size_t count) -> jsi::Value {
+        std::vector<double> numbers(
+            paramCount, std::numeric_limits<double>::quiet_NaN());
+        for (size_t i = 0, e = std::min<size_t>(count, paramCount); i < e;
+             ++i) {
+          numbers[i] = args[i].isNumber() ? args[i].getNumber()
+                                          : rt.global()
+                                                .getPropertyAsFunction(
+                                                    rt, "Number")
+                                                .call(rt, args[i])
+                                                .getNumber();
+        }
+        return nf(numbers.data(), numbers.size());
+      };
+    }
+
+    NumberHostFunctionType numberFunction;
+    unsigned paramCount;
+  };
+
+  /// Hands out the fixed size nodes of a list from chunks, and recycles the
+  /// freed ones, so that the handles given to native code don't each cost a
+  /// malloc and a free. Chunks are only freed with the pool.
+  class NodePool {
+   public:
+    void *allocate(size_t size) {
+      assert(
+          (!nodeSize_ || size == nodeSize_) && "pool nodes have a fixed size");
+      if (LLVM_UNLIKELY(!freeList_)) {
+        nodeSize_ = std::max(size, sizeof(FreeNode));
+        chunks_.emplace_back(new char[nodeSize_ * kNodesPerChunk]);
+        char *chunk = chunks_.back().get();
+        for (size_t i = 0; i < kNodesPerChunk; ++i)
+          release(chunk + i * nodeSize_);
+      }
+      FreeNode *node = freeList_;
+      freeList_ = node->next;
+      return node;
+    }
+
+    void release(void *node) {
+      freeList_ = new (node) FreeNode{freeList_};
+    }
+
+   private:
+    struct FreeNode {
+      FreeNode *next;
+    };
+    static constexpr size_t kNodesPerChunk = 256;
+
+    size_t nodeSize_{0};
+    FreeNode *freeList_{nullptr};
+    std::vector<std::unique_ptr<char[]>> chunks_{};
+  };
+
+  /// A std::list allocator which takes its nodes from a shared NodePool.
+  template <typename T>
+  struct PoolAllocator {
+    using value_type = T;
+
+    explicit PoolAllocator(std::shared_ptr<NodePool> pool)
+        : pool(std::move(pool)) {}
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U> &other) : pool(other.pool) {}
+
+    T *allocate(size_t n) {
+      if (n != 1)
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+      return static_cast<T *>(pool->allocate(sizeof(T)));
+    }
+    void deallocate(T *p, size_t n) {
+      if (n != 1)
+        ::operator delete(p);
+      else
+        pool->release(p);
     }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U> &other) const {
+      return pool == other.pool;
+    }
+    template <typename U>
+    bool operator!=(const PoolAllocator<U> &other) const {
+      return pool != other.pool;
+    }
+
+    std::shared_ptr<NodePool> pool;
   };
 
   template <typename T>
   struct ManagedValues {
+    using List = std::list<T, PoolAllocator<T>>;
+
 #ifdef ASSERT_ON_DANGLING_VM_REFS
     // If we have active HermesValuePointers whhen deconstructing, these will
     // now be dangling. We deliberately allocate and immediately leak heap
@@ -929,24 +1099,24 @@ class HermesRuntimeImpl final : public HermesRuntime,
         }
       }
       if (anyDangling) {
-        // This is the deliberate memory leak described above.
-        new std::list<T>(std::move(values));
+        // This is the deliberate memory leak described above. The list keeps
+        // its node pool alive.
+        new List(std::move(values));
       }
     }
 #endif
 
-    std::list<T> *operator->() {
+    List *operator->() {
       return &values;
     }
 
-    const std::list<T> *operator->() const {
+    const List *operator->() const {
       return &values;
     }
 
-    std::list<T> values;
+    List values{PoolAllocator<T>(std::make_shared<NodePool>())};
   };
 
- protected:
   /// Helper function that is parameterized over the type of context being
   /// created.
   template <typename ContextType>
@@ -955,7 +1125,6 @@ class HermesRuntimeImpl final : public HermesRuntime,
       const jsi::PropNameID &name,
       unsigned int paramCount);
 
- public:
   ManagedValues<HermesPointerValue> hermesValues_;
   ManagedValues<WeakRefPointerValue> weakHermesValues_;
 #ifdef HERMESJSI_ON_STACK
@@ -969,6 +1138,9 @@ class HermesRuntimeImpl final : public HermesRuntime,
   std::unique_ptr<debugger::Debugger> debugger_;
 #endif
   std::shared_ptr<vm::CrashManager> crashMgr_;
+  /// The directory caching the bytecode compiled from source, or empty if
+  /// source is compiled every time it is prepared.
+  std::string bytecodeCacheDir_;
 };
 
 namespace {
@@ -1019,6 +1191,13 @@ void HermesRuntime::enableSamplingProfiler() {
   ::hermes::vm::SamplingProfiler::getInstance()->enable();
 }
 
+void HermesRuntime::enableSamplingProfiler(
+    std::chrono::microseconds interval) {
+  const auto &profiler = ::hermes::vm::SamplingProfiler::getInstance();
+  profiler->setSamplingInterval(interval);
+  profiler->enable();
+}
+
 void HermesRuntime::disableSamplingProfiler() {
   ::hermes::vm::SamplingProfiler::getInstance()->disable();
 }
@@ -1032,6 +1211,35 @@ void HermesRuntime::dumpSampledTraceToFile(const std::string &fileName) {
   ::hermes::vm::SamplingProfiler::getInstance()->dumpChromeTrace(os);
 }
 
+void HermesRuntime::dumpSampledProfileToPprofFile(
+    const std::string &fileName) {
+  std::error_code ec;
+  llvm::raw_fd_ostream os(fileName.c_str(), ec, llvm::sys::fs::F_None);
+  if (ec) {
+    throw std::system_error(ec);
+  }
+  ::hermes::vm::SamplingProfiler::getInstance()->dumpPprof(os);
+}
+
+bool HermesRuntime::enableSamplingProfilerHardwareCounters() {
+  return ::hermes::vm::SamplingProfiler::getInstance()
+      ->enableHardwareCounters();
+}
+
+void HermesRuntime::disableSamplingProfilerHardwareCounters() {
+  ::hermes::vm::SamplingProfiler::getInstance()->disableHardwareCounters();
+}
+
+void HermesRuntime::dumpSampledHardwareCountersToFile(
+    const std::string &fileName) {
+  std::error_code ec;
+  llvm::raw_fd_ostream os(fileName.c_str(), ec, llvm::sys::fs::F_Text);
+  if (ec) {
+    throw std::system_error(ec);
+  }
+  ::hermes::vm::SamplingProfiler::getInstance()->dumpHardwareCounters(os);
+}
+
 void HermesRuntime::setFatalHandler(void (*handler)(const std::string &)) {
   detail::sApiFatalHandler = handler;
 }
@@ -1076,6 +1284,374 @@ uint64_t HermesRuntime::getUniqueID(const jsi::Object &o) const {
       ->getDebugAllocationId();
 }
 
+void HermesRuntime::createSnapshotToFileDescriptor(
+    int fd,
+    uint32_t maxEdgesPerObject,
+    uint32_t maxStringLength) {
+  vm::GC &gc = impl(this)->runtime_.getHeap();
+  gc.collect();
+  vm::HeapSnapshotOptions options;
+  options.maxEdgesPerNode = maxEdgesPerObject;
+  options.maxStringLength = maxStringLength;
+  gc.createSnapshotToFD(fd, options);
+}
+
+void HermesRuntime::startAllocationSampling(uint32_t samplingInterval) {
+  impl(this)->runtime_.startAllocationProfiler(samplingInterval);
+}
+
+void HermesRuntime::stopAllocationSampling() {
+  impl(this)->runtime_.stopAllocationProfiler();
+}
+
+void HermesRuntime::dumpAllocationProfileToFile(const std::string &fileName) {
+  std::error_code ec;
+  llvm::raw_fd_ostream os(fileName.c_str(), ec, llvm::sys::fs::F_Text);
+  if (ec) {
+    throw std::system_error(ec);
+  }
+  impl(this)->runtime_.dumpAllocationProfile(os);
+}
+
+void HermesRuntime::startExecutionTrace() {
+  impl(this)->runtime_.startExecutionTrace();
+}
+
+void HermesRuntime::stopExecutionTrace() {
+  impl(this)->runtime_.stopExecutionTrace();
+}
+
+void HermesRuntime::dumpExecutionTraceToFile(const std::string &fileName) {
+  std::error_code ec;
+  llvm::raw_fd_ostream os(fileName.c_str(), ec, llvm::sys::fs::F_Text);
+  if (ec) {
+    throw std::system_error(ec);
+  }
+  impl(this)->runtime_.dumpExecutionTrace(os);
+}
+
+void HermesRuntime::dumpTypeFeedbackToFile(const std::string &fileName) {
+  std::error_code ec;
+  llvm::raw_fd_ostream os(fileName.c_str(), ec, llvm::sys::fs::F_Text);
+  if (ec) {
+    throw std::system_error(ec);
+  }
+  impl(this)->runtime_.dumpTypeFeedback(os);
+}
+
+void HermesRuntime::enableNativeCallStats(uint32_t samplingInterval) {
+  impl(this)->runtime_.getRuntimeStats().enableNativeCallStats(
+      samplingInterval);
+}
+
+void HermesRuntime::disableNativeCallStats() {
+  impl(this)->runtime_.getRuntimeStats().disableNativeCallStats();
+}
+
+::hermes::vm::GCTelemetrySummary HermesRuntime::getGCTelemetry(
+    std::chrono::milliseconds window) const {
+  return impl(this)->runtime_.getHeap().getTelemetry().summarize(window);
+}
+
+bool HermesRuntime::setExternalMemorySize(
+    const jsi::Object &o,
+    size_t size) {
+  auto *hostObj = vm::dyn_vmcast<vm::HostObject>(impl(this)->phv(o));
+  if (!hostObj || size > std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
+  return hostObj->setExternalMemorySize(
+      &impl(this)->runtime_.getHeap(), static_cast<uint32_t>(size));
+}
+
+namespace {
+
+/// Keeps the jsi::Buffer borrowed by a vm::BorrowedStringPrimitive alive.
+class BorrowedJSIBuffer final : public vm::BorrowedStringBuffer {
+ public:
+  explicit BorrowedJSIBuffer(std::shared_ptr<const jsi::Buffer> buffer)
+      : buffer_(std::move(buffer)) {}
+
+ private:
+  std::shared_ptr<const jsi::Buffer> buffer_;
+};
+
+/// Keeps the jsi::MutableBuffer used by a vm::JSArrayBuffer alive.
+class ExternalJSIBuffer final : public vm::ExternalArrayBufferOwner {
+ public:
+  explicit ExternalJSIBuffer(std::shared_ptr<jsi::MutableBuffer> buffer)
+      : buffer_(std::move(buffer)) {}
+
+ private:
+  std::shared_ptr<jsi::MutableBuffer> buffer_;
+};
+
+} // namespace
+
+jsi::String HermesRuntime::createStringFromExternalUtf8(
+    std::shared_ptr<const jsi::Buffer> buffer) {
+  auto *rt = impl(this);
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&rt->runtime_);
+    const uint8_t *data = buffer->data();
+    size_t size = buffer->size();
+    // Short strings are cheaper to copy than to borrow.
+    if (size < vm::StringPrimitive::EXTERNAL_STRING_MIN_SIZE ||
+        !::hermes::isAllASCII(data, data + size)) {
+      return rt->add<jsi::String>(rt->stringHVFromUtf8(data, size));
+    }
+    vm::ASCIIRef str{reinterpret_cast<const char *>(data), size};
+    auto strRes = vm::BorrowedASCIIStringPrimitive::create(
+        &rt->runtime_,
+        str,
+        llvm::make_unique<BorrowedJSIBuffer>(std::move(buffer)));
+    rt->checkStatus(strRes.getStatus());
+    return rt->add<jsi::String>(*strRes);
+  });
+}
+
+jsi::ArrayBuffer HermesRuntime::createArrayBufferFromExternal(
+    std::shared_ptr<jsi::MutableBuffer> buffer) {
+  auto *rt = impl(this);
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&rt->runtime_);
+    auto res = vm::JSArrayBuffer::create(
+        &rt->runtime_,
+        vm::Handle<vm::JSObject>::vmcast(&rt->runtime_.arrayBufferPrototype));
+    rt->checkStatus(res.getStatus());
+    auto arrayBuffer = rt->runtime_.makeHandle<vm::JSArrayBuffer>(*res);
+    char *data = reinterpret_cast<char *>(buffer->data());
+    size_t size = buffer->size();
+    rt->checkStatus(arrayBuffer->setExternalDataBlock(
+        &rt->runtime_,
+        data,
+        size,
+        llvm::make_unique<ExternalJSIBuffer>(std::move(buffer))));
+    return rt->add<jsi::Object>(arrayBuffer.getHermesValue())
+        .getArrayBuffer(*rt);
+  });
+}
+
+jsi::Value HermesRuntime::parseJSONFromUtf8(const jsi::Buffer &buffer) {
+  auto *rt = impl(this);
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&rt->runtime_);
+    auto res = vm::runtimeJSONParseUTF8(
+        &rt->runtime_,
+        llvm::makeArrayRef(buffer.data(), buffer.size()),
+        rt->runtime_.makeNullHandle<vm::Callable>());
+    rt->checkStatus(res.getStatus());
+    return rt->valueFromHermesValue(*res);
+  });
+}
+
+std::shared_ptr<vm::StructuredCloneData> HermesRuntime::serialize(
+    const jsi::Value &value,
+    const std::vector<jsi::Object> &transfer) {
+  auto *rt = impl(this);
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&rt->runtime_);
+    auto transferList = rt->runtime_.makeNullHandle<vm::JSArray>();
+    if (!transfer.empty()) {
+      auto arrRes =
+          vm::JSArray::create(&rt->runtime_, transfer.size(), transfer.size());
+      rt->checkStatus(arrRes.getStatus());
+      transferList = vm::toHandle(&rt->runtime_, std::move(*arrRes));
+      for (size_t i = 0; i < transfer.size(); ++i) {
+        vm::JSArray::setElementAt(
+            transferList,
+            &rt->runtime_,
+            i,
+            rt->runtime_.makeHandle(rt->phv(transfer[i])));
+      }
+    }
+    auto data = std::make_shared<vm::StructuredCloneData>();
+    rt->checkStatus(vm::structuredSerialize(
+        &rt->runtime_, rt->vmHandleFromValue(value), transferList, *data));
+    return data;
+  });
+}
+
+jsi::Value HermesRuntime::deserialize(
+    const std::shared_ptr<vm::StructuredCloneData> &data) {
+  auto *rt = impl(this);
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&rt->runtime_);
+    auto res = vm::structuredDeserialize(&rt->runtime_, *data);
+    rt->checkStatus(res.getStatus());
+    return rt->valueFromHermesValue(*res);
+  });
+}
+
+bool HermesRuntime::setHostObjectPropertyStable(
+    const jsi::Object &o,
+    const jsi::PropNameID &name) {
+  auto *rt = impl(this);
+  if (!vm::vmisa<vm::HostObject>(rt->phv(o)))
+    return false;
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&rt->runtime_);
+    rt->checkStatus(vm::HostObject::cacheStableProperty(
+        vm::Handle<vm::HostObject>::vmcast(&rt->phv(o)),
+        &rt->runtime_,
+        rt->phv(name).getSymbol()));
+    return true;
+  });
+}
+
+std::vector<jsi::Value> HermesRuntime::getProperties(
+    const jsi::Object &obj,
+    const jsi::PropNameID *names,
+    size_t count) {
+  auto *rt = impl(this);
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&rt->runtime_);
+    auto h = rt->handle(obj);
+    std::vector<jsi::Value> values;
+    values.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      vm::GCScopeMarkerRAII marker{gcScope};
+      auto res =
+          h->getNamedOrIndexed(h, &rt->runtime_, rt->phv(names[i]).getSymbol());
+      rt->checkStatus(res.getStatus());
+      values.push_back(rt->valueFromHermesValue(*res));
+    }
+    return values;
+  });
+}
+
+void HermesRuntime::setProperties(
+    jsi::Object &obj,
+    const jsi::PropNameID *names,
+    const jsi::Value *values,
+    size_t count) {
+  auto *rt = impl(this);
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&rt->runtime_);
+    auto h = rt->handle(obj);
+    for (size_t i = 0; i < count; ++i) {
+      vm::GCScopeMarkerRAII marker{gcScope};
+      rt->checkStatus(h->putNamedOrIndexed(
+                           h,
+                           &rt->runtime_,
+                           rt->phv(names[i]).getSymbol(),
+                           rt->vmHandleFromValue(values[i]),
+                           vm::PropOpFlags().plusThrowOnError())
+                          .getStatus());
+    }
+  });
+}
+
+std::vector<jsi::Value> HermesRuntime::getValuesAtIndices(
+    const jsi::Array &arr,
+    size_t start,
+    size_t count) {
+  auto *rt = impl(this);
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&rt->runtime_);
+    size_t length = rt->size(arr);
+    if (LLVM_UNLIKELY(start > length || count > length - start)) {
+      throw makeJSError(
+          *rt,
+          "getValuesAtIndices: range [",
+          start,
+          ", ",
+          start + count,
+          ") is out of bounds [0, ",
+          length,
+          ")");
+    }
+
+    auto h = rt->arrayHandle(arr);
+    std::vector<jsi::Value> values;
+    values.reserve(count);
+    for (size_t i = start, e = start + count; i < e; ++i) {
+      // Converting the values doesn't allocate in the JS heap, so packed
+      // elements can be copied straight out of the storage until a lookup
+      // (which may run a getter that changes the array) is needed.
+      if (LLVM_LIKELY(h->hasFastPackedElements() && i < h->getEndIndex())) {
+        values.push_back(rt->valueFromHermesValue(h->at(&rt->runtime_, i)));
+        continue;
+      }
+      vm::GCScopeMarkerRAII marker{gcScope};
+      auto res = vm::JSObject::getComputed_RJS(
+          h,
+          &rt->runtime_,
+          rt->runtime_.makeHandle(vm::HermesValue::encodeNumberValue(i)));
+      rt->checkStatus(res.getStatus());
+      values.push_back(rt->valueFromHermesValue(*res));
+    }
+    return values;
+  });
+}
+
+void HermesRuntime::setValuesAtIndices(
+    jsi::Array &arr,
+    size_t start,
+    const jsi::Value *values,
+    size_t count) {
+  auto *rt = impl(this);
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&rt->runtime_);
+    size_t length = rt->size(arr);
+    if (LLVM_UNLIKELY(start > length || count > length - start)) {
+      throw makeJSError(
+          *rt,
+          "setValuesAtIndices: range [",
+          start,
+          ", ",
+          start + count,
+          ") is out of bounds [0, ",
+          length,
+          ")");
+    }
+
+    auto h = rt->arrayHandle(arr);
+    for (size_t i = 0; i < count; ++i) {
+      vm::GCScopeMarkerRAII marker{gcScope};
+      vm::JSArray::setElementAt(
+          h, &rt->runtime_, start + i, rt->vmHandleFromValue(values[i]));
+    }
+  });
+}
+
+bool HermesRuntime::drainMicrotasks(
+    std::chrono::steady_clock::duration maxTime) {
+  auto *rt = impl(this);
+  return maybeRethrow([&] {
+    auto now = std::chrono::steady_clock::now();
+    auto deadline = maxTime < std::chrono::steady_clock::time_point::max() - now
+        ? now + maxTime
+        : std::chrono::steady_clock::time_point::max();
+    auto res = rt->runtime_.drainJobs(deadline);
+    rt->checkStatus(res.getStatus());
+    return *res;
+  });
+}
+
+void HermesRuntime::saveCleanState() {
+  impl(this)->runtime_.saveGlobalObjectTemplate();
+}
+
+void HermesRuntime::resetToCleanState() {
+  auto *rt = impl(this);
+  maybeRethrow([&] {
+    rt->runtime_.clearJobs();
+    rt->checkStatus(rt->runtime_.resetGlobalObject());
+    rt->runtime_.collect();
+  });
+}
+
+bool HermesRuntime::collectDuringIdle(
+    std::chrono::steady_clock::time_point deadline) {
+  return impl(this)->runtime_.getHeap().collectDuringIdle(deadline);
+}
+
+::hermes::vm::MemoryPressureReport HermesRuntime::handleMemoryPressure(
+    ::hermes::vm::MemoryPressureLevel level) {
+  return impl(this)->runtime_.handleMemoryPressure(level);
+}
+
 #ifdef HERMESVM_API_TRACE
 /// Get a structure representing the enviroment-dependent behavior, so
 /// it can be written into the trace for later replay.
@@ -1137,6 +1713,16 @@ void HermesRuntime::unregisterForProfiling() {
       &(impl(this)->runtime_));
 }
 
+void HermesRuntime::detachFromThread() {
+  ::hermes::vm::SamplingProfiler::getInstance()->suspendRuntime(
+      &(impl(this)->runtime_));
+}
+
+void HermesRuntime::attachToCurrentThread() {
+  ::hermes::vm::SamplingProfiler::getInstance()->registerRuntime(
+      &(impl(this)->runtime_));
+}
+
 size_t HermesRuntime::rootsListLength() const {
   return impl(this)->hermesValues_->size();
 }
@@ -1173,6 +1759,128 @@ class HermesPreparedJavaScript final : public jsi::PreparedJavaScript {
 
 } // namespace
 
+/// Map the bytecode file at \p path, whose pages are then only read when they
+/// are touched and stay clean, so the kernel can drop them under pressure.
+/// \return the bytecode provider and an empty error, or a null provider and
+///   an error message.
+static std::pair<std::unique_ptr<hbc::BCProvider>, std::string>
+mapBytecodeFile(const std::string &path) {
+  auto fileOrErr = llvm::MemoryBuffer::getFile(
+      path,
+      /* FileSize */ -1,
+      /* RequiresNullTerminator */ false,
+      /* IsVolatile */ false);
+  if (!fileOrErr) {
+    return {nullptr,
+            "Error mapping " + path + ": " + fileOrErr.getError().message()};
+  }
+  auto buffer =
+      std::make_unique<::hermes::OwnedMemoryBuffer>(std::move(*fileOrErr));
+
+  // The sections of a bytecode file are aligned relative to its start, so
+  // the file must be loaded at an aligned address.
+  if (reinterpret_cast<uintptr_t>(buffer->data()) % alignof(uint32_t) != 0) {
+    return {nullptr, "Error mapping " + path + ": misaligned"};
+  }
+  if (!HermesRuntime::isHermesBytecode(buffer->data(), buffer->size())) {
+    return {nullptr, path + " is not a bytecode file"};
+  }
+  auto ret =
+      hbc::BCProviderFromBuffer::createBCProviderFromBuffer(std::move(buffer));
+  if (!ret.first) {
+    return {nullptr, "Error evaluating bytecode: " + ret.second};
+  }
+  return {std::move(ret.first), std::string{}};
+}
+
+#ifndef HERMESVM_LEAN
+/// \return the path of the file in \p cacheDir caching the bytecode compiled
+/// from the source \p buffer with \p sourceURL and \p compileFlags. Its name
+/// hashes everything the bytecode depends on, including the bytecode version,
+/// so a file compiled differently is never found.
+static std::string bytecodeCachePath(
+    const std::string &cacheDir,
+    const ::hermes::Buffer &buffer,
+    const std::string &sourceURL,
+    const hbc::CompileFlags &compileFlags) {
+  llvm::SHA1 hasher;
+  hasher.update(llvm::makeArrayRef(buffer.data(), buffer.size()));
+  // The URL is stored in the debug info.
+  const uint8_t separator = 0;
+  hasher.update(llvm::makeArrayRef(separator));
+  hasher.update(sourceURL);
+  const uint8_t flags[] = {
+      compileFlags.optimize,
+      compileFlags.debug,
+      compileFlags.strict,
+      compileFlags.staticBuiltins.hasValue(),
+      compileFlags.staticBuiltins.getValueOr(false),
+  };
+  hasher.update(flags);
+  const uint32_t version = hbc::BYTECODE_VERSION;
+  hasher.update(llvm::makeArrayRef(
+      reinterpret_cast<const uint8_t *>(&version), sizeof(version)));
+  auto rawHash = hasher.final();
+  ::hermes::SHA1 hash{};
+  std::copy(rawHash.begin(), rawHash.end(), hash.begin());
+  llvm::SmallString<128> path{cacheDir};
+  llvm::sys::path::append(path, ::hermes::hashAsString(hash) + ".hbc");
+  return std::string(path.begin(), path.end());
+}
+
+/// Compile the source \p buffer with \p compileFlags, reusing the bytecode
+/// cached in \p cacheDir by an earlier compilation. The cached file is mapped
+/// and validated like any bytecode file, and replaced if it is unusable. The
+/// cache is best effort: failing to write it doesn't fail the compilation.
+/// \return the bytecode provider and an empty error, or a null provider and
+///   the compilation error.
+static std::pair<std::unique_ptr<hbc::BCProvider>, std::string>
+compileWithBytecodeCache(
+    const std::string &cacheDir,
+    std::unique_ptr<::hermes::Buffer> buffer,
+    const std::string &sourceURL,
+    hbc::CompileFlags compileFlags) {
+  std::string path =
+      bytecodeCachePath(cacheDir, *buffer, sourceURL, compileFlags);
+  auto mapped = mapBytecodeFile(path);
+  if (mapped.first) {
+    return mapped;
+  }
+
+  // Lazily compiled functions can't be serialized, so compile all of them.
+  compileFlags.lazy = false;
+  const ::hermes::SHA1 sourceHash = llvm::SHA1::hash(
+      llvm::makeArrayRef(buffer->data(), buffer->size()));
+  auto compiled = hbc::BCProviderFromSrc::createBCProviderFromSrc(
+      std::move(buffer), sourceURL, compileFlags);
+  if (!compiled.first) {
+    return {nullptr, std::move(compiled.second)};
+  }
+
+  // Write a temporary file first, so that a concurrent or interrupted write
+  // never leaves a partial file under the final name.
+  int fd;
+  llvm::SmallString<128> tmpPath;
+  if (!llvm::sys::fs::createUniqueFile(path + "-%%%%%%.tmp", fd, tmpPath)) {
+    bool written;
+    {
+      llvm::raw_fd_ostream os(fd, /* shouldClose */ true);
+      ::hermes::BytecodeGenerationOptions opts(::hermes::EmitBundle);
+      opts.optimizationEnabled = compileFlags.optimize;
+      hbc::BytecodeSerializer BS{os, opts};
+      BS.serialize(*compiled.first->getBytecodeModule(), sourceHash);
+      os.close();
+      written = !os.has_error();
+      os.clear_error();
+    }
+    if (!written || llvm::sys::fs::rename(tmpPath, path)) {
+      llvm::sys::fs::remove(tmpPath);
+    }
+  }
+  return {std::move(compiled.first), std::string{}};
+}
+#endif
+
 std::shared_ptr<const jsi::PreparedJavaScript>
 HermesRuntimeImpl::prepareJavaScript(
     const std::shared_ptr<const jsi::Buffer> &jsiBuffer,
@@ -1202,8 +1910,13 @@ HermesRuntimeImpl::prepareJavaScript(
 #if defined(HERMESVM_LEAN)
     bcErr.second = "prepareJavaScript source compilation not supported";
 #else
-    bcErr = hbc::BCProviderFromSrc::createBCProviderFromSrc(
-        std::move(buffer), sourceURL, compileFlags);
+    if (!bytecodeCacheDir_.empty()) {
+      bcErr = compileWithBytecodeCache(
+          bytecodeCacheDir_, std::move(buffer), sourceURL, compileFlags);
+    } else {
+      bcErr = hbc::BCProviderFromSrc::createBCProviderFromSrc(
+          std::move(buffer), sourceURL, compileFlags);
+    }
 #endif
   }
   if (!bcErr.first) {
@@ -1242,6 +1955,23 @@ jsi::Value HermesRuntimeImpl::evaluateJavaScript(
   return evaluatePreparedJavaScript(prepareJavaScript(buffer, sourceURL));
 }
 
+jsi::Value HermesRuntime::evaluateMappedBytecode(
+    const std::string &path,
+    const std::string &sourceURL) {
+  auto ret = mapBytecodeFile(path);
+  if (!ret.first) {
+    throw jsi::JSINativeException(std::move(ret.second));
+  }
+
+  vm::RuntimeModuleFlags runtimeFlags{};
+  runtimeFlags.persistent = true;
+  return impl(this)->evaluatePreparedJavaScript(
+      std::make_shared<const HermesPreparedJavaScript>(
+          std::move(ret.first),
+          runtimeFlags,
+          sourceURL.empty() ? path : sourceURL));
+}
+
 jsi::Object HermesRuntimeImpl::global() {
   return add<jsi::Object>(runtime_.getGlobal().getHermesValue());
 }
@@ -1295,10 +2025,10 @@ jsi::PropNameID HermesRuntimeImpl::createPropNameIDFromAscii(
 #endif
 
     vm::GCScope gcScope(&runtime_);
-    auto cr = vm::stringToSymbolID(
-        &runtime_,
-        vm::StringPrimitive::createNoThrow(
-            &runtime_, llvm::StringRef(str, length)));
+    // Look the name up in the identifier table directly, which only allocates
+    // a string for names that are not interned yet.
+    auto cr = runtime_.getIdentifierTable().getSymbolHandle(
+        &runtime_, vm::ASCIIRef(str, length));
     checkStatus(cr.getStatus());
     return add<jsi::PropNameID>(cr->getHermesValue());
   });
@@ -1351,6 +2081,10 @@ std::string toStdString(
     vm::Runtime *runtime,
     vm::Handle<vm::StringPrimitive> handle) {
   auto view = vm::StringPrimitive::createStringView(runtime, handle);
+  if (view.isASCII()) {
+    // ASCII is already valid UTF-8.
+    return std::string(view.castToCharPtr(), view.length());
+  }
   vm::SmallU16String<32> allocator;
   std::string ret;
   ::hermes::convertUTF16ToUTF8WithReplacements(
@@ -1662,6 +2396,21 @@ jsi::Function HermesRuntimeImpl::createFunctionFromHostFunction(
   });
 }
 
+jsi::Function HermesRuntime::createNumberFunction(
+    const jsi::PropNameID &name,
+    unsigned int paramCount,
+    NumberHostFunctionType func) {
+  auto *rt = impl(this);
+  return maybeRethrow([&] {
+    auto context = ::hermes::make_unique<HermesRuntimeImpl::NumberHFContext>(
+        std::move(func), paramCount, *rt);
+    auto hostfunc =
+        rt->createFunctionFromHostFunction(context.get(), name, paramCount);
+    context.release();
+    return hostfunc;
+  });
+}
+
 template <typename ContextType>
 jsi::Function HermesRuntimeImpl::createFunctionFromHostFunction(
     ContextType *context,
@@ -1894,14 +2643,19 @@ vm::HermesValue HermesRuntimeImpl::stringHVFromAscii(
 vm::HermesValue HermesRuntimeImpl::stringHVFromUtf8(
     const uint8_t *utf8,
     size_t length) {
-  if (::hermes::isAllASCII(utf8, utf8 + length)) {
+  const uint8_t *firstNonASCII =
+      ::hermes::findFirstNonASCII(utf8, utf8 + length);
+  if (firstNonASCII == utf8 + length) {
     return stringHVFromAscii((const char *)utf8, length);
   }
   std::u16string out;
   out.resize(length);
-  const llvm::UTF8 *sourceStart = (const llvm::UTF8 *)utf8;
-  const llvm::UTF8 *sourceEnd = sourceStart + length;
-  llvm::UTF16 *targetStart = (llvm::UTF16 *)&out[0];
+  // Widen the ASCII prefix directly, and only decode the rest.
+  size_t prefixLength = firstNonASCII - utf8;
+  ::hermes::widenASCII((const char *)utf8, prefixLength, &out[0]);
+  const llvm::UTF8 *sourceStart = (const llvm::UTF8 *)firstNonASCII;
+  const llvm::UTF8 *sourceEnd = (const llvm::UTF8 *)utf8 + length;
+  llvm::UTF16 *targetStart = (llvm::UTF16 *)&out[prefixLength];
   llvm::UTF16 *targetEnd = targetStart + out.capacity();
   llvm::ConversionResult cRes;
   cRes = ConvertUTF8toUTF16(
@@ -1989,6 +2743,45 @@ std::unique_ptr<HermesRuntime> makeHermesRuntime(
   return std::move(ret);
 }
 
+HermesRuntimePool::HermesRuntimePool(
+    const vm::RuntimeConfig &runtimeConfig,
+    size_t maxIdle,
+    std::function<void(HermesRuntime &)> init)
+    : runtimeConfig_(runtimeConfig), maxIdle_(maxIdle), init_(std::move(init)) {}
+
+std::unique_ptr<HermesRuntime> HermesRuntimePool::acquire() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!idle_.empty()) {
+      auto runtime = std::move(idle_.back());
+      idle_.pop_back();
+      return runtime;
+    }
+  }
+  auto runtime = makeHermesRuntime(runtimeConfig_);
+  if (init_)
+    init_(*runtime);
+  runtime->saveCleanState();
+  return runtime;
+}
+
+void HermesRuntimePool::release(std::unique_ptr<HermesRuntime> runtime) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (idle_.size() >= maxIdle_)
+      return;
+  }
+  try {
+    runtime->resetToCleanState();
+  } catch (const jsi::JSIException &) {
+    // A runtime which can't be reset is destroyed instead.
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (idle_.size() < maxIdle_)
+    idle_.push_back(std::move(runtime));
+}
+
 std::unique_ptr<jsi::ThreadSafeRuntime> makeThreadSafeHermesRuntime(
     const vm::RuntimeConfig &runtimeConfig) {
 #if defined(HERMESVM_PLATFORM_LOGGING)
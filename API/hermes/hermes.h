@@ -7,11 +7,17 @@
 #ifndef HERMES_HERMES_H
 #define HERMES_HERMES_H
 
+#include <chrono>
 #include <exception>
+#include <functional>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
+#include <hermes/Public/GCTelemetry.h>
+#include <hermes/Public/MemoryPressure.h>
 #include <hermes/Public/RuntimeConfig.h>
 #include <jsi/jsi.h>
 
@@ -24,6 +30,7 @@ class raw_ostream;
 namespace hermes {
 namespace vm {
 struct MockedEnvironment;
+struct StructuredCloneData;
 } // namespace vm
 } // namespace hermes
 
@@ -71,12 +78,33 @@ class HermesRuntime : public jsi::Runtime {
   /// Enable sampling profiler.
   static void enableSamplingProfiler();
 
+  /// Enable sampling profiler, taking a sample every \p interval. Intervals
+  /// down to a millisecond or less are cheap enough for production use.
+  static void enableSamplingProfiler(std::chrono::microseconds interval);
+
   /// Disable the sampling profiler
   static void disableSamplingProfiler();
 
   /// Dump sampled stack trace to the given file name.
   static void dumpSampledTraceToFile(const std::string &fileName);
 
+  /// Dump sampled stack traces to the given file name in pprof format,
+  /// including the native frames of the VM and host functions.
+  static void dumpSampledProfileToPprofFile(const std::string &fileName);
+
+  /// Also sample the cycles, instructions and cache misses of the threads of
+  /// the runtimes with the sampling profiler, by the function they are spent
+  /// in. Only supported on Linux.
+  /// \return false if the counters can't be opened.
+  static bool enableSamplingProfilerHardwareCounters();
+
+  /// Stop sampling the hardware counters.
+  static void disableSamplingProfilerHardwareCounters();
+
+  /// Dump the sampled hardware counts of each JS function to the given file
+  /// name, as a JSON array.
+  static void dumpSampledHardwareCountersToFile(const std::string &fileName);
+
   // The base class declares most of the interesting methods.  This
   // just declares new methods which are specific to HermesRuntime.
   // The actual implementations of the pure virtual methods are
@@ -90,6 +118,16 @@ class HermesRuntime : public jsi::Runtime {
       std::unique_ptr<const jsi::Buffer> buffer,
       const jsi::Value &context);
 
+  /// Evaluate the bytecode file at \p path. The file is mapped read-only and
+  /// used in place rather than copied into memory, so the parts of it that
+  /// are never used are never loaded and cost no private memory. Errors are
+  /// reported in the exception thrown if the file can't be mapped or isn't
+  /// valid bytecode.
+  /// \param sourceURL the URL of the bytecode, which defaults to \p path.
+  jsi::Value evaluateMappedBytecode(
+      const std::string &path,
+      const std::string &sourceURL = "");
+
   /// Gets a guaranteed unique id for an object, which is assigned at
   /// allocation time and is static throughout that object's lifetime.
   /// This is mainly useful for tracing and debugging use cases, so in
@@ -97,6 +135,184 @@ class HermesRuntime : public jsi::Runtime {
   /// values.
   uint64_t getUniqueID(const jsi::Object &o) const;
 
+  /// Collect garbage, then write a heap snapshot in the format of the Chrome
+  /// DevTools to the file descriptor \p fd, which is left open. The snapshot
+  /// is written in chunks as the heap is walked, so that little memory is
+  /// needed besides its strings, even for large heaps. Strings longer than
+  /// \p maxStringLength characters are truncated. If \p maxEdgesPerObject is
+  /// non-zero, objects with more references than that, such as large arrays,
+  /// only have an evenly spaced sample of them in the snapshot.
+  void createSnapshotToFileDescriptor(
+      int fd,
+      uint32_t maxEdgesPerObject = 0,
+      uint32_t maxStringLength = 1024);
+
+  /// Start sampling about one allocation every \p samplingInterval bytes of
+  /// this runtime, recording the JS stack of each. Samples of a previous run
+  /// are discarded.
+  void startAllocationSampling(uint32_t samplingInterval = 32 * 1024);
+
+  /// Stop sampling allocations. The objects sampled so far are still tracked.
+  void stopAllocationSampling();
+
+  /// Dump the sampled allocations that were not collected yet to the given
+  /// file name, in the .heapprofile format of the Chrome DevTools, which
+  /// shows how many bytes are alive for each allocating stack.
+  void dumpAllocationProfileToFile(const std::string &fileName);
+
+  /// Start recording the state transitions of the property caches, the
+  /// quickening of instructions and its reversal, the conversions of hidden
+  /// classes to dictionary mode, the JIT bailouts, and the entries and exits
+  /// of interpreted functions, each with its function and bytecode offset.
+  /// Events of a previous trace are discarded.
+  void startExecutionTrace();
+
+  /// Stop recording execution events. The events so far are kept.
+  void stopExecutionTrace();
+
+  /// Dump the recorded execution events to the given file name as JSON.
+  void dumpExecutionTraceToFile(const std::string &fileName);
+
+  /// Dump the instructions which are quickened at this point to the given
+  /// file name, in the type feedback format read by the compiler.
+  void dumpTypeFeedbackToFile(const std::string &fileName);
+
+  /// Start counting the calls to each native and host function, and timing
+  /// one call in \p samplingInterval. The results are reported by
+  /// HermesInternal.getInstrumentedStats(), and are reset by each call.
+  void enableNativeCallStats(uint32_t samplingInterval = 16);
+
+  /// Stop counting the calls to native and host functions. The results so
+  /// far are still reported.
+  void disableNativeCallStats();
+
+  /// Summarize the garbage collections that ended within \p window of now:
+  /// pause time percentiles per generation, bytes promoted, allocation rate
+  /// and heap size.  Recording collections is cheap and always on, and only
+  /// the most recent few hundred are remembered.  Unlike the rest of the
+  /// runtime, this may be called from any thread, e.g. by a metrics scraper.
+  ::hermes::vm::GCTelemetrySummary getGCTelemetry(
+      std::chrono::milliseconds window) const;
+
+  /// Tell the GC that no JavaScript will run until \p deadline, so that it can
+  /// do the collections that would otherwise soon interrupt execution.  Only
+  /// collections that are expected to finish before the deadline are started.
+  /// \return true if any collection was done.
+  bool collectDuringIdle(std::chrono::steady_clock::time_point deadline);
+
+  /// Free memory when the OS reports that it is running low, doing more the
+  /// higher \p level is: from dropping caches of compiled code, up to
+  /// compacting the heap and freeing the native code of the functions that
+  /// are not running. Everything dropped is rebuilt when needed, at the cost
+  /// of some speed until it is.
+  /// \return the number of bytes freed by each step.
+  ::hermes::vm::MemoryPressureReport handleMemoryPressure(
+      ::hermes::vm::MemoryPressureLevel level);
+
+  /// Charge \p size bytes of native memory kept alive by the host object \p o
+  /// to the JS heap, replacing its previous charge.  Collections are then
+  /// scheduled as if the heap held that much more data until \p o is
+  /// collected, so that objects owning large native resources are not kept
+  /// alive for long just because they look small.
+  /// \return false if \p o is not a host object, or if the heap cannot
+  ///   account for that much memory.
+  bool setExternalMemorySize(const jsi::Object &o, size_t size);
+
+  /// Declare that the property \p name of the host object \p o never changes
+  /// and cannot be set. Its value is read from the HostObject once, and from
+  /// then on reads of it, from JS or JSI, are served by the VM and its inline
+  /// caches without calling HostObject::get().
+  /// \return false if \p o is not a host object.
+  bool setHostObjectPropertyStable(
+      const jsi::Object &o,
+      const jsi::PropNameID &name);
+
+  /// Create a JS string from the UTF-8 contents of \p buffer. If they are
+  /// ASCII, which is the common case for large payloads such as JSON, the
+  /// string borrows them instead of copying them into the JS heap. \p buffer
+  /// is then released when the string is collected, and its size is charged
+  /// to the JS heap until then. The contents must not change while the
+  /// runtime holds on to \p buffer.
+  jsi::String createStringFromExternalUtf8(
+      std::shared_ptr<const jsi::Buffer> buffer);
+
+  /// A host function of numbers, see createNumberFunction().
+  using NumberHostFunctionType =
+      std::function<double(const double *args, size_t count)>;
+
+  /// Create a function which calls \p func with exactly \p paramCount
+  /// numbers and returns the number it returns. Missing arguments are NaN,
+  /// extra ones are ignored, and others are converted like Number() would.
+  /// Calls from JS skip the conversion of the arguments and of \c this into
+  /// jsi::Values that a jsi::HostFunctionType needs, so this is much cheaper
+  /// for small, frequently called functions.
+  jsi::Function createNumberFunction(
+      const jsi::PropNameID &name,
+      unsigned int paramCount,
+      NumberHostFunctionType func);
+
+  /// Create an ArrayBuffer whose contents are the memory of \p buffer, used in
+  /// place rather than copied. \p buffer is released when the ArrayBuffer is
+  /// collected, and its size is charged to the JS heap until then. Native
+  /// code can keep reading and writing the memory through \p buffer, or
+  /// through jsi::ArrayBuffer::data() of the result.
+  jsi::ArrayBuffer createArrayBufferFromExternal(
+      std::shared_ptr<jsi::MutableBuffer> buffer);
+
+  /// Parse the UTF-8 encoded JSON text in \p buffer, like JSON.parse() would
+  /// parse it after decoding it into a string, but without creating that
+  /// string. The text is decoded straight into the parser's buffer, so
+  /// \p buffer is only read during the call.
+  jsi::Value parseJSONFromUtf8(const jsi::Buffer &buffer);
+
+  /// Serialize \p value with the structured clone algorithm, so that a copy
+  /// of it can be created by deserialize() in another HermesRuntime, possibly
+  /// on another thread. This handles objects, arrays, Maps, Sets, Dates,
+  /// ArrayBuffers and typed arrays without going through JSON. The data of
+  /// each ArrayBuffer in \p transfer is moved instead of copied, and the
+  /// buffer is detached in this runtime. Throws a JSError if \p value holds
+  /// something which can't be cloned, such as a function.
+  std::shared_ptr<::hermes::vm::StructuredCloneData> serialize(
+      const jsi::Value &value,
+      const std::vector<jsi::Object> &transfer = {});
+
+  /// Create in this runtime a copy of the value serialized in \p data. If it
+  /// has transferred ArrayBuffers, \p data can only be deserialized once.
+  jsi::Value deserialize(
+      const std::shared_ptr<::hermes::vm::StructuredCloneData> &data);
+
+  /// Read the properties \p names[0, count) of \p obj, like \c getProperty()
+  /// would one at a time, but paying for the transition into the VM once.
+  /// \return the values of the properties, in the order of \p names.
+  std::vector<jsi::Value> getProperties(
+      const jsi::Object &obj,
+      const jsi::PropNameID *names,
+      size_t count);
+
+  /// Set each property \p names[i] of \p obj to \p values[i], for i in
+  /// [0, count), like \c setProperty() would one at a time.
+  void setProperties(
+      jsi::Object &obj,
+      const jsi::PropNameID *names,
+      const jsi::Value *values,
+      size_t count);
+
+  /// Read the elements [start, start + count) of \p arr. Elements stored in
+  /// a packed array are copied out directly, others are looked up like
+  /// \c getValueAtIndex() would.
+  /// \return the elements, or throw a JSError if the range is out of bounds.
+  std::vector<jsi::Value>
+  getValuesAtIndices(const jsi::Array &arr, size_t start, size_t count);
+
+  /// Set the elements [start, start + count) of \p arr to \p values, like
+  /// \c setValueAtIndex() would one at a time. Throw a JSError if the range
+  /// is out of bounds.
+  void setValuesAtIndices(
+      jsi::Array &arr,
+      size_t start,
+      const jsi::Value *values,
+      size_t count);
+
 #ifdef HERMESVM_API_TRACE
   /// Get a structure representing the enviroment-dependent behavior, so
   /// it can be written into the trace for later replay.
@@ -140,11 +356,42 @@ class HermesRuntime : public jsi::Runtime {
       const DebugFlags &debugFlags);
 #endif
 
+  /// Call the jobs enqueued with HermesInternal.enqueueJob(), such as promise
+  /// reactions, in order and including the jobs that they enqueue, until
+  /// none is left or \p maxTime has elapsed. All of them run within this one
+  /// call instead of a host round-trip each. If a job throws, the exception
+  /// is rethrown as a JSError and the remaining jobs stay queued.
+  /// \return true if no jobs are left.
+  bool drainMicrotasks(
+      std::chrono::steady_clock::duration maxTime =
+          std::chrono::steady_clock::duration::max());
+
+  /// Save the current global object as the clean state of this runtime, for
+  /// resetToCleanState().
+  void saveCleanState();
+
+  /// Go back to the global object saved by saveCleanState(): the global
+  /// variables and functions defined since and the pending microtasks are
+  /// dropped, and the garbage is collected, keeping the heap segments for
+  /// reuse. Changes made to objects shared with the clean state, such as
+  /// builtin prototypes, are kept.
+  void resetToCleanState();
+
   /// Register this runtime for sampling profiler.
   void registerForProfiling();
   /// Unregister this runtime for sampling profiler.
   void unregisterForProfiling();
 
+  /// A runtime holds no state tied to the thread running it, except for its
+  /// registration with the sampling profiler, which records that thread. To
+  /// move an idle runtime, with no JS or host function on its stack, to
+  /// another thread, call detachFromThread() on the thread which ran it and
+  /// attachToCurrentThread() on the thread which runs it next. A thread can
+  /// then run many runtimes one after the other, e.g. in a thread pool. As
+  /// always, a runtime must only be used by one thread at a time.
+  void detachFromThread();
+  void attachToCurrentThread();
+
  private:
   // Only HermesRuntimeImpl can subclass this.
   HermesRuntime() = default;
@@ -164,6 +411,35 @@ std::unique_ptr<HermesRuntime> makeHermesRuntime(
 std::unique_ptr<jsi::ThreadSafeRuntime> makeThreadSafeHermesRuntime(
     const ::hermes::vm::RuntimeConfig &runtimeConfig =
         ::hermes::vm::RuntimeConfig());
+
+/// A pool of runtimes which are reset to their clean state when they are
+/// released, instead of being destroyed, so that acquiring one usually skips
+/// the construction of a runtime. The pool may be used from any thread, and
+/// each runtime by one thread at a time.
+class HermesRuntimePool {
+ public:
+  /// \param maxIdle the number of released runtimes kept for reuse.
+  /// \param init is called on each new runtime before its clean state is
+  ///   saved, e.g. to install host functions or evaluate a prelude.
+  HermesRuntimePool(
+      const ::hermes::vm::RuntimeConfig &runtimeConfig,
+      size_t maxIdle,
+      std::function<void(HermesRuntime &)> init = nullptr);
+
+  /// \return a runtime in its clean state.
+  std::unique_ptr<HermesRuntime> acquire();
+
+  /// Give \p runtime, which came from acquire(), back to the pool.
+  void release(std::unique_ptr<HermesRuntime> runtime);
+
+ private:
+  const ::hermes::vm::RuntimeConfig runtimeConfig_;
+  const size_t maxIdle_;
+  const std::function<void(HermesRuntime &)> init_;
+
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<HermesRuntime>> idle_;
+};
 } // namespace hermes
 } // namespace facebook
 
@@ -8,6 +8,8 @@
 
 #ifdef HERMESVM_API_TRACE
 #include <hermes/TracingRuntime.h>
+
+#include "llvm/Support/FileSystem.h"
 #endif
 
 namespace facebook {
@@ -24,5 +26,23 @@ std::unique_ptr<jsi::Runtime> makeTracingHermesRuntime(
 #endif
 }
 
+std::unique_ptr<jsi::Runtime> makeStreamingTracingHermesRuntime(
+    std::unique_ptr<HermesRuntime> hermesRuntime,
+    const ::hermes::vm::RuntimeConfig &runtimeConfig,
+    const std::string &traceFile) {
+#ifdef HERMESVM_API_TRACE
+  std::error_code ec;
+  auto os = std::make_unique<llvm::raw_fd_ostream>(
+      traceFile.c_str(), ec, llvm::sys::fs::F_None);
+  if (ec) {
+    throw std::system_error(ec);
+  }
+  return tracing::makeStreamingTracingHermesRuntime(
+      std::move(hermesRuntime), runtimeConfig, std::move(os));
+#else
+  return hermesRuntime;
+#endif
+}
+
 } // namespace hermes
 } // namespace facebook
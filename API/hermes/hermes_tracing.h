@@ -15,6 +15,15 @@ namespace hermes {
 std::unique_ptr<jsi::Runtime> makeTracingHermesRuntime(
     std::unique_ptr<HermesRuntime> hermesRuntime,
     const ::hermes::vm::RuntimeConfig &runtimeConfig);
+
+/// Like makeTracingHermesRuntime, but streams the trace in a compact binary
+/// format to \p traceFile while the runtime is used, instead of keeping it in
+/// memory. The file is complete once the runtime is destroyed.
+/// \throws std::system_error if the file can't be opened.
+std::unique_ptr<jsi::Runtime> makeStreamingTracingHermesRuntime(
+    std::unique_ptr<HermesRuntime> hermesRuntime,
+    const ::hermes::vm::RuntimeConfig &runtimeConfig,
+    const std::string &traceFile);
 }
 } // namespace facebook
 
@@ -8,6 +8,9 @@
 
 #include <glog/logging.h>
 
+#include <string>
+#include <unordered_map>
+
 #include <folly/dynamic.h>
 #include <jsi/jsi.h>
 
@@ -16,14 +19,36 @@ using namespace facebook::jsi;
 namespace facebook {
 namespace jsi {
 
-Value valueFromDynamic(Runtime& runtime, const folly::dynamic& dyn) {
+namespace {
+
+// Property names of the objects built by one conversion.  Payloads are
+// usually arrays of objects with the same keys, so each key is only
+// converted to a PropNameID once instead of for every object.
+using PropNameCache = std::unordered_map<std::string, PropNameID>;
+
+const PropNameID& propNameFor(
+    Runtime& runtime,
+    PropNameCache& cache,
+    const std::string& name) {
+  auto it = cache.find(name);
+  if (it == cache.end()) {
+    it = cache.emplace(name, PropNameID::forUtf8(runtime, name)).first;
+  }
+  return it->second;
+}
+
+Value valueFromDynamicImpl(
+    Runtime& runtime,
+    PropNameCache& cache,
+    const folly::dynamic& dyn) {
   switch (dyn.type()) {
   case folly::dynamic::NULLT:
     return Value::null();
   case folly::dynamic::ARRAY: {
     Array ret = Array(runtime, dyn.size());
     for (size_t i = 0; i < dyn.size(); ++i) {
-      ret.setValueAtIndex(runtime, i, valueFromDynamic(runtime, dyn[i]));
+      ret.setValueAtIndex(
+          runtime, i, valueFromDynamicImpl(runtime, cache, dyn[i]));
     }
     return std::move(ret);
   }
@@ -39,9 +64,17 @@ Value valueFromDynamic(Runtime& runtime, const folly::dynamic& dyn) {
   case folly::dynamic::OBJECT: {
     Object ret(runtime);
     for (const auto& element : dyn.items()) {
-      Value value = valueFromDynamic(runtime, element.second);
-      if (element.first.isNumber() || element.first.isString()) {
-        ret.setProperty(runtime, element.first.asString().c_str(), value);
+      Value value = valueFromDynamicImpl(runtime, cache, element.second);
+      if (element.first.isString()) {
+        ret.setProperty(
+            runtime,
+            propNameFor(runtime, cache, element.first.getString()),
+            value);
+      } else if (element.first.isNumber()) {
+        ret.setProperty(
+            runtime,
+            propNameFor(runtime, cache, element.first.asString()),
+            value);
       }
     }
     return std::move(ret);
@@ -52,6 +85,13 @@ Value valueFromDynamic(Runtime& runtime, const folly::dynamic& dyn) {
   CHECK(false);
 }
 
+} // namespace
+
+Value valueFromDynamic(Runtime& runtime, const folly::dynamic& dyn) {
+  PropNameCache cache;
+  return valueFromDynamicImpl(runtime, cache, dyn);
+}
+
 folly::dynamic dynamicFromValue(Runtime& runtime, const Value& value) {
   if (value.isUndefined() || value.isNull()) {
     return nullptr;
@@ -66,7 +106,8 @@ folly::dynamic dynamicFromValue(Runtime& runtime, const Value& value) {
     if (obj.isArray(runtime)) {
       Array array = obj.getArray(runtime);
       folly::dynamic ret = folly::dynamic::array();
-      for (size_t i = 0; i < array.size(runtime); ++i) {
+      size_t size = array.size(runtime);
+      for (size_t i = 0; i < size; ++i) {
         ret.push_back(dynamicFromValue(runtime, array.getValueAtIndex(runtime, i)));
       }
       return ret;
@@ -75,7 +116,8 @@ folly::dynamic dynamicFromValue(Runtime& runtime, const Value& value) {
     } else {
       folly::dynamic ret = folly::dynamic::object();
       Array names = obj.getPropertyNames(runtime);
-      for (size_t i = 0; i < names.size(runtime); ++i) {
+      size_t size = names.size(runtime);
+      for (size_t i = 0; i < size; ++i) {
         String name = names.getValueAtIndex(runtime, i).getString(runtime);
         Value prop = obj.getProperty(runtime, name);
         if (prop.isUndefined()) {
@@ -37,6 +37,16 @@ class Buffer {
   virtual const uint8_t* data() const = 0;
 };
 
+/// Memory owned by the host which a runtime may use in place, e.g. as the
+/// storage of an ArrayBuffer. Unlike a Buffer, its contents may be changed
+/// while the runtime holds on to it, by either side.
+class MutableBuffer {
+ public:
+  virtual ~MutableBuffer();
+  virtual size_t size() const = 0;
+  virtual uint8_t* data() = 0;
+};
+
 class StringBuffer : public Buffer {
  public:
   StringBuffer(std::string s) : s_(std::move(s)) {}
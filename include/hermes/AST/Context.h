@@ -12,6 +12,8 @@
 #include "hermes/Support/SourceErrorManager.h"
 #include "hermes/Support/StringTable.h"
 
+#include "llvm/ADT/StringMap.h"
+
 namespace hermes {
 
 namespace hbc {
@@ -57,6 +59,17 @@ struct OutliningSettings {
   unsigned maxParameters{5};
 };
 
+struct InliningSettings {
+  /// Number of calls of each function in a profiled run, by function name.
+  /// Empty unless a profile was given.
+  llvm::StringMap<uint64_t> callCounts;
+  /// Number of profiled calls from which a function is hot.
+  uint64_t hotCallCount{1000};
+  /// Maximum number of instructions of a hot function which is inlined into
+  /// all of its direct call sites, and not only into a single one.
+  unsigned maxHotInstructions{40};
+};
+
 struct OptimizationSettings {
   /// Enable constant property optimization
   bool constantPropertyOptimizations{false};
@@ -79,6 +92,13 @@ struct OptimizationSettings {
   /// Enable IR outlining.
   bool outlining{false};
 
+  /// Replace the objects which do not escape by the values of their
+  /// properties.
+  bool scalarReplacement{true};
+
+  /// Specific settings for the inliner.
+  InliningSettings inliningSettings;
+
   /// Specific settings for the outliner.
   OutliningSettings outliningSettings;
 
@@ -294,6 +314,10 @@ class Context {
     optimizationSettings_.staticBuiltins = staticBuiltins;
   }
 
+  void setInliningCallCounts(llvm::StringMap<uint64_t> &&callCounts) {
+    optimizationSettings_.inliningSettings.callCounts = std::move(callCounts);
+  }
+
   bool getStaticBuiltinOptimization() const {
     return optimizationSettings_.staticBuiltins;
   }
@@ -228,6 +228,15 @@ class BytecodeModule {
   /// Element i contains the function index for module i + cjsModuleOffset.
   std::vector<uint32_t> cjsModuleTableStatic_{};
 
+  /// Element i is the start in cjsModuleDependencies_ of the dependencies of
+  /// module i + cjsModuleOffset, and element i + 1 is their end. Empty if no
+  /// module has dependencies.
+  std::vector<uint32_t> cjsModuleDependencyOffsets_{};
+
+  /// IDs of the modules statically required by each CJS module, which are
+  /// initialized along with it.
+  std::vector<uint32_t> cjsModuleDependencies_{};
+
   /// Storing information about the bytecode, needed when it is loaded by the
   /// runtime.
   BytecodeOptions options_{};
@@ -249,6 +258,8 @@ class BytecodeModule {
       uint32_t cjsModuleOffset,
       std::vector<std::pair<uint32_t, uint32_t>> &&cjsModuleTable,
       std::vector<uint32_t> &&cjsModuleTableStatic,
+      std::vector<uint32_t> &&cjsModuleDependencyOffsets,
+      std::vector<uint32_t> &&cjsModuleDependencies,
       BytecodeOptions options)
       : globalFunctionIndex_(globalFunctionIndex),
         stringKinds_(std::move(stringKinds)),
@@ -263,6 +274,8 @@ class BytecodeModule {
         cjsModuleOffset_(cjsModuleOffset),
         cjsModuleTable_(std::move(cjsModuleTable)),
         cjsModuleTableStatic_(std::move(cjsModuleTableStatic)),
+        cjsModuleDependencyOffsets_(std::move(cjsModuleDependencyOffsets)),
+        cjsModuleDependencies_(std::move(cjsModuleDependencies)),
         options_(options) {
     functions_.resize(functionCount);
   }
@@ -341,6 +354,14 @@ class BytecodeModule {
     return cjsModuleTableStatic_;
   }
 
+  llvm::ArrayRef<uint32_t> getCJSModuleDependencyOffsets() const {
+    return cjsModuleDependencyOffsets_;
+  }
+
+  llvm::ArrayRef<uint32_t> getCJSModuleDependencies() const {
+    return cjsModuleDependencies_;
+  }
+
   DebugInfo &getDebugInfo() {
     return debugInfo_;
   }
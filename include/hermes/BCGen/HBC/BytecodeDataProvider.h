@@ -8,6 +8,7 @@
 #define HERMES_BCGEN_HBC_BYTECODEDATAPROVIDER_H
 
 #include "hermes/BCGen/HBC/BytecodeFileFormat.h"
+#include "hermes/BCGen/HBC/CompressedBytecode.h"
 #include "hermes/BCGen/HBC/DebugInfo.h"
 #include "hermes/Public/Buffer.h"
 #include "hermes/SourceMap/SourceMapGenerator.h"
@@ -19,6 +20,7 @@
 #include "llvm/ADT/ArrayRef.h"
 
 #include <atomic>
+#include <mutex>
 #include <thread>
 
 namespace hermes {
@@ -91,6 +93,13 @@ static_assert(
 /// to abstract different ways of constructing bytecode from different
 /// code paths: eval vs bytecode file. The design goal is to make the
 /// code path of loading from bytecode file more efficient.
+///
+/// A provider is immutable once created, apart from the lazily created state
+/// below, which is guarded so that one provider can be shared by runtimes on
+/// different threads. Sharing a provider shares the string storage, the
+/// precomputed identifier hashes, the function headers and the bytecode.
+/// Each runtime still has its own RuntimeModule with the SymbolIDs of the
+/// strings and the CodeBlocks with their property caches.
 class BCProviderBase {
  protected:
   /// Storing information about the bytecode, needed when it is loaded by the
@@ -120,13 +129,20 @@ class BCProviderBase {
   uint32_t cjsModuleOffset_;
 
   /// Table which indicates where to find the different CommonJS modules.
-  /// List of unsorted pairs from {filename ID => function index}.
+  /// List of pairs from {filename ID => function index}, in module ID order.
   llvm::ArrayRef<std::pair<uint32_t, uint32_t>> cjsModuleTable_{};
 
   /// Table which indicates where to find the different CommonJS modules.
   /// Vector of function indexes.
   llvm::ArrayRef<uint32_t> cjsModuleTableStatic_{};
 
+  /// Start of the dependencies of each CJS module in cjsModuleDependencies_,
+  /// followed by their end. Empty if no module has dependencies.
+  llvm::ArrayRef<uint32_t> cjsModuleDependencyOffsets_{};
+
+  /// IDs of the modules statically required by each CJS module.
+  llvm::ArrayRef<uint32_t> cjsModuleDependencies_{};
+
   /// Pointer to the global debug info. This will not be eagerly initialized
   /// when loading bytecode from a buffer. Instead it will be constructed
   /// when first needed. Most likely we should never need to use it.
@@ -139,6 +155,9 @@ class BCProviderBase {
   /// Create the global debug info data, called only when first time needed.
   virtual void createDebugInfo() = 0;
 
+  /// Set once createDebugInfo() has been called.
+  mutable std::once_flag debugInfoCreated_;
+
  public:
   /// Getters for every private data member.
   BytecodeOptions getBytecodeOptions() const {
@@ -186,6 +205,19 @@ class BCProviderBase {
   llvm::ArrayRef<uint32_t> getCJSModuleTableStatic() const {
     return cjsModuleTableStatic_;
   }
+  /// \return whether any CJS module in this provider has dependencies.
+  bool hasCJSModuleDependencies() const {
+    return !cjsModuleDependencies_.empty();
+  }
+  /// \return the IDs of the modules which are statically required when the
+  /// CJS module at \p index in this provider's module table is initialized.
+  llvm::ArrayRef<uint32_t> getCJSModuleDependencies(uint32_t index) const {
+    if (cjsModuleDependencyOffsets_.empty())
+      return {};
+    uint32_t start = cjsModuleDependencyOffsets_[index];
+    return cjsModuleDependencies_.slice(
+        start, cjsModuleDependencyOffsets_[index + 1] - start);
+  }
   const std::string getErrorStr() const {
     return errstr_;
   }
@@ -198,11 +230,13 @@ class BCProviderBase {
         getStringStorage().begin() + entry.getOffset(), entry.getLength());
   }
 
-  /// Get the global debug info, lazily create it.
+  /// Get the global debug info, lazily create it. Thread safe.
   const hbc::DebugInfo *getDebugInfo() const {
-    if (!debugInfo_) {
-      const_cast<BCProviderBase *>(this)->createDebugInfo();
-    }
+    std::call_once(debugInfoCreated_, [this]() {
+      if (!debugInfo_) {
+        const_cast<BCProviderBase *>(this)->createDebugInfo();
+      }
+    });
     return debugInfo_;
   }
 
@@ -263,6 +297,11 @@ class BCProviderBase {
   /// soon.  Only forwards this information to the OS for buffers.
   virtual void willNeedStringTable() {}
 
+  /// Advise the provider that the bytecode of the function \p functionID is
+  /// going to be executed soon. Only forwards this information to the OS for
+  /// buffers.
+  virtual void willNeedFunction(uint32_t functionID) {}
+
   /// Start tracking I/O (only implemented for buffers). Any access before this
   /// call (e.g. reading header to construct the provider) will not be recorded.
   virtual void startPageAccessTracker() {}
@@ -302,6 +341,9 @@ class BCProviderFromBuffer final : public BCProviderBase {
   /// Pointer to buffer_->data(), to avoid calling it every time.
   const uint8_t *bufferPtr_;
 
+  /// buffer_, if it was read from a compressed container, otherwise null.
+  const DecompressedBytecodeBuffer *decompressed_{};
+
   /// List of function headers.
   const hbc::SmallFuncHeader *functionHeaders_{};
 
@@ -319,6 +361,10 @@ class BCProviderFromBuffer final : public BCProviderBase {
   /// If \p startWarmup has been called, this is the thread doing the warmup.
   llvm::Optional<std::thread> warmupThread_;
 
+  /// Guards warmupThread_, since every runtime sharing this provider may
+  /// start the warmup.
+  std::mutex warmupMutex_;
+
   /// Set by \p stopWarmup to tell any warmup thread to abort.
   std::atomic<bool> warmupAbortFlag_;
 
@@ -342,19 +388,30 @@ class BCProviderFromBuffer final : public BCProviderBase {
  public:
   static std::pair<std::unique_ptr<BCProviderFromBuffer>, std::string>
   createBCProviderFromBuffer(std::unique_ptr<const Buffer> buffer) {
+    const DecompressedBytecodeBuffer *decompressed = nullptr;
+    if (isCompressedBytecodeStream({buffer->data(), buffer->size()})) {
+      auto ret = DecompressedBytecodeBuffer::create(std::move(buffer));
+      if (!ret.first)
+        return {nullptr, ret.second};
+      decompressed = ret.first.get();
+      buffer = std::move(ret.first);
+    }
     auto ret = std::unique_ptr<BCProviderFromBuffer>(
         new BCProviderFromBuffer(std::move(buffer)));
+    ret->decompressed_ = decompressed;
     auto errstr = ret->getErrorStr();
     return {errstr.empty() ? std::move(ret) : nullptr, errstr};
   }
 
-  /// Checks whether the data is actually bytecode.
+  /// Checks whether the data is actually bytecode, possibly in a compressed
+  /// container.
   static bool isBytecodeStream(llvm::ArrayRef<uint8_t> aref) {
     const auto *header =
         reinterpret_cast<const hbc::BytecodeFileHeader *>(aref.data());
     return (
-        aref.size() >= sizeof(hbc::BytecodeFileHeader) &&
-        header->magic == hbc::MAGIC);
+        (aref.size() >= sizeof(hbc::BytecodeFileHeader) &&
+         header->magic == hbc::MAGIC) ||
+        isCompressedBytecodeStream(aref));
   }
 
   /// Checks whether the buffer is actually bytecode.
@@ -426,7 +483,10 @@ class BCProviderFromBuffer final : public BCProviderBase {
   }
 
   const uint8_t *getBytecode(uint32_t functionID) const {
-    return bufferPtr_ + getFunctionHeader(functionID).offset();
+    uint32_t offset = getFunctionHeader(functionID).offset();
+    if (decompressed_)
+      decompressed_->ensureDecompressed(offset);
+    return bufferPtr_ + offset;
   }
 
   llvm::ArrayRef<hbc::HBCExceptionHandlerInfo> getExceptionTable(
@@ -447,6 +507,7 @@ class BCProviderFromBuffer final : public BCProviderBase {
   virtual void adviseStringTableSequential();
   virtual void adviseStringTableRandom();
   virtual void willNeedStringTable();
+  virtual void willNeedFunction(uint32_t functionID);
 
   virtual void startPageAccessTracker();
 
@@ -27,13 +27,19 @@ const static uint64_t MAGIC = 0x1F1903C103BC1FC6;
 // bytecode file is in a form suitable for delta diffing, not execution.
 const static uint64_t DELTA_MAGIC = ~MAGIC;
 
+// A container of a bytecode file whose cold function bodies are compressed.
+const static uint64_t COMPRESSED_MAGIC = MAGIC + 1;
+
 // Bytecode version generated by this version of the compiler.
-// Updated: Jun 22, 2019
-const static uint32_t BYTECODE_VERSION = 59;
+// Updated: Oct 15, 2026
+const static uint32_t BYTECODE_VERSION = 74;
 
 /// Property cache index which indicates no caching.
 static constexpr uint8_t PROPERTY_CACHING_DISABLED = 0;
 
+/// String ID of the unused entries of the hash table of a SwitchStr.
+static constexpr uint32_t SWITCH_STR_EMPTY_ENTRY = UINT32_MAX;
+
 /// Bytecode forms
 enum class BytecodeForm {
   /// Execution form (the default) is the bytecode prepared for execution.
@@ -83,12 +89,13 @@ struct BytecodeFileHeader {
   uint32_t objValueBufferSize;
   uint32_t cjsModuleOffset; // The starting module ID in this segment.
   uint32_t cjsModuleCount; // Number of modules.
+  uint32_t cjsModuleDependencyCount; // Number of module dependencies.
   uint32_t debugInfoOffset;
   BytecodeOptions options;
 
   // Insert any padding to make function headers that follow this file header
   // less likely to cross cache lines.
-  uint8_t padding[31];
+  uint8_t padding[27];
 
   BytecodeFileHeader(
       uint64_t magic,
@@ -109,6 +116,7 @@ struct BytecodeFileHeader {
       uint32_t objValueBufferSize,
       uint32_t cjsModuleOffset,
       uint32_t cjsModuleCount,
+      uint32_t cjsModuleDependencyCount,
       uint32_t debugInfoOffset,
       BytecodeOptions options)
       : magic(magic),
@@ -129,6 +137,7 @@ struct BytecodeFileHeader {
         objValueBufferSize(objValueBufferSize),
         cjsModuleOffset(cjsModuleOffset),
         cjsModuleCount(cjsModuleCount),
+        cjsModuleDependencyCount(cjsModuleDependencyCount),
         debugInfoOffset(debugInfoOffset),
         options(options) {
     std::copy(sourceHash.begin(), sourceHash.end(), this->sourceHash);
@@ -136,6 +145,27 @@ struct BytecodeFileHeader {
   }
 };
 
+/// Header of a compressed container, followed by the parts of the bytecode
+/// file before and after the compressed region, the chunk table and the data
+/// of the chunks. See CompressedBytecode.h.
+struct CompressedBytecodeHeader {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t containerLength; // Bytes in the container, without any epilogue.
+  uint32_t fileLength; // Bytes in the bytecode file.
+  uint32_t coldStart; // Start of the compressed region of the file.
+  uint32_t coldEnd; // End of the compressed region of the file.
+  uint32_t chunkCount; // Number of entries in the chunk table.
+};
+
+/// A part of the compressed region of the file, compressed on its own. It
+/// extends up to the start of the next chunk, or the end of the region.
+struct CompressedChunk {
+  uint32_t start; // Offset of the chunk in the bytecode file.
+  uint32_t dataOffset; // Offset of the compressed data in the container.
+  uint32_t dataSize; // Bytes of compressed data.
+};
+
 /// The string table is an array of these entries, followed by an array of
 /// OverflowStringTableEntry for the entries whose length or offset doesn't fit
 /// into the bitfields.
@@ -446,6 +476,13 @@ struct BytecodeFileFields {
   /// List of resolved CJS modules.
   Array<uint32_t> cjsModuleTableStatic;
 
+  /// Start of the dependencies of each CJS module in cjsModuleDependencies,
+  /// followed by their end. Empty if no module has dependencies.
+  Array<uint32_t> cjsModuleDependencyOffsets;
+
+  /// IDs of the modules statically required by each CJS module.
+  Array<uint32_t> cjsModuleDependencies;
+
   /// Populate bytecode file fields from a buffer. The fields will point
   /// directly into the buffer and it is the caller's responsibility to ensure
   /// the result does not outlive the buffer.
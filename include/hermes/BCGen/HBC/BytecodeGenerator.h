@@ -73,7 +73,11 @@ class BytecodeFunctionGenerator : public BytecodeInstructionGenerator {
   uint32_t frameSize_{0};
 
   DebugSourceLocation sourceLocation_;
+  /// The locations of the opcodes, until bytecode generation is complete.
   std::vector<DebugSourceLocation> debugLocations_{};
+  /// The locations of the opcodes, encoded once bytecode generation is
+  /// complete so that they stay compact until the module is generated.
+  EncodedSourceLocations encodedDebugLocations_{};
 
   /// Table mapping variable names to frame locations.
   std::vector<Identifier> debugVariableNames_;
@@ -154,11 +158,20 @@ class BytecodeFunctionGenerator : public BytecodeInstructionGenerator {
 
   /// Add the location of an opcode.
   void addDebugSourceLocation(const DebugSourceLocation &info);
-  const std::vector<DebugSourceLocation> &getDebugLocations() const {
-    return debugLocations_;
+
+  /// Encode the locations of the opcodes, which must all have been added,
+  /// relative to the source location of the function.
+  void encodeDebugLocations();
+
+  /// \return the locations of the opcodes, encoding them first if needed.
+  const EncodedSourceLocations &getDebugLocations() {
+    encodeDebugLocations();
+    return encodedDebugLocations_;
   }
+
   bool hasDebugInfo() const {
-    return !debugLocations_.empty() || !debugVariableNames_.empty();
+    return !debugLocations_.empty() || !encodedDebugLocations_.empty() ||
+        !debugVariableNames_.empty();
   }
 
   /// Add a debug variable named \name.
@@ -213,6 +226,11 @@ class BytecodeFunctionGenerator : public BytecodeInstructionGenerator {
     }
   }
 
+  /// Rewrite the instructions at the bytecode offsets \p offsets to their
+  /// quickened variants. Offsets which are not at the start of an instruction
+  /// with a quickened variant are ignored.
+  void quickenInstructions(llvm::ArrayRef<uint32_t> offsets);
+
   /// \return the size of the frame.
   uint32_t getFrameSize() const {
     return frameSize_;
@@ -231,6 +249,7 @@ class BytecodeFunctionGenerator : public BytecodeInstructionGenerator {
   /// Signal that bytecode generation is finalized.
   void bytecodeGenerationComplete() {
     bytecodeSize_ = opcodes_.size();
+    encodeDebugLocations();
   }
 
   friend class HBCISel;
@@ -265,13 +284,20 @@ class BytecodeModuleGenerator {
   uint32_t cjsModuleOffset_{0};
 
   /// A record of all the CJS modules registered in this run of generation.
-  /// List of pairs: (filename ID, function index).
+  /// List of pairs: (filename ID, function index), in module ID order.
   std::vector<std::pair<uint32_t, uint32_t>> cjsModules_;
 
   /// A record of all the CJS modules resolved in this run of generation.
   /// List of function indices.
   std::vector<uint32_t> cjsModulesStatic_;
 
+  /// Start of the dependencies of each CJS module registered so far in
+  /// cjsModuleDependencies_, followed by their end.
+  std::vector<uint32_t> cjsModuleDependencyOffsets_{0};
+
+  /// IDs of the modules statically required by each CJS module.
+  std::vector<uint32_t> cjsModuleDependencies_;
+
   /// Table of constants used to initialize constant arrays.
   /// They are stored as chars in order to shorten bytecode size.
   std::vector<unsigned char> arrayBuffer_{};
@@ -299,6 +325,9 @@ class BytecodeModuleGenerator {
   /// The entry point of the function (usually the global function).
   int entryPointIndex_{-1};
 
+  /// Record \p dependencies as those of the CJS module added last.
+  void addCJSModuleDependencies(llvm::ArrayRef<uint32_t> dependencies);
+
  public:
   /// Constructor which enables optimizations if \p optimizationEnabled is set.
   BytecodeModuleGenerator(
@@ -355,11 +384,21 @@ class BytecodeModuleGenerator {
   }
 
   /// Adds a CJS module entry to the table.
-  void addCJSModule(uint32_t functionID, uint32_t nameID);
+  /// \param moduleID the index of the CJS module (incremented each call).
+  /// \param dependencies the IDs of the modules it statically requires.
+  void addCJSModule(
+      uint32_t moduleID,
+      uint32_t functionID,
+      uint32_t nameID,
+      llvm::ArrayRef<uint32_t> dependencies);
 
   /// Adds a statically-resolved CJS module entry to the table.
   /// \param moduleID the index of the CJS module (incremented each call).
-  void addCJSModuleStatic(uint32_t moduleID, uint32_t functionID);
+  /// \param dependencies the IDs of the modules it statically requires.
+  void addCJSModuleStatic(
+      uint32_t moduleID,
+      uint32_t functionID,
+      llvm::ArrayRef<uint32_t> dependencies);
 
   /// Returns the starting offset of the elements.
   uint32_t addArrayBuffer(ArrayRef<Literal *> elements);
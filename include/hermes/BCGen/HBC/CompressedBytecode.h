@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+//===----------------------------------------------------------------------===//
+/// \file
+/// A container for bytecode files whose cold function bodies are compressed.
+///
+/// The container starts with a CompressedBytecodeHeader. The parts of the
+/// bytecode file before and after the compressed region follow as they are,
+/// then the chunk table and the deflated data of each chunk. A chunk is made
+/// of whole function bodies, so that a function can be run once its chunk is
+/// decompressed, without decompressing the rest of the file.
+//===----------------------------------------------------------------------===//
+#ifndef HERMES_BCGEN_HBC_COMPRESSEDBYTECODE_H
+#define HERMES_BCGEN_HBC_COMPRESSEDBYTECODE_H
+
+#include "hermes/BCGen/HBC/BytecodeFileFormat.h"
+#include "hermes/Public/Buffer.h"
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/Compiler.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace hermes {
+namespace hbc {
+
+/// Uncompressed size above which a chunk is ended at the next function body.
+static constexpr uint32_t kCompressedChunkSize = 16 * 1024;
+
+/// \return whether \p aref starts with the header of a compressed container.
+bool isCompressedBytecodeStream(llvm::ArrayRef<uint8_t> aref);
+
+/// Write the bytecode file \p bytecode to \p OS as a compressed container.
+/// The region [\p coldStart, \p coldEnd) is compressed. It is split into
+/// chunks of about kCompressedChunkSize bytes, at offsets from the sorted
+/// \p bodyStarts, which are the offsets of the function bodies.
+void writeCompressedBytecode(
+    llvm::raw_ostream &OS,
+    llvm::ArrayRef<uint8_t> bytecode,
+    uint32_t coldStart,
+    uint32_t coldEnd,
+    llvm::ArrayRef<uint32_t> bodyStarts);
+
+/// The bytecode file stored in a compressed container. The parts stored as
+/// they are, and any epilogue, are copied when it is created. Each chunk is
+/// decompressed the first time ensureDecompressed() is called with an offset
+/// in it. The memory of the chunks which are never used is not touched.
+class DecompressedBytecodeBuffer final : public Buffer {
+ public:
+  /// Read the compressed container \p container.
+  /// \return the buffer, or null and an error message if the container is
+  ///   malformed.
+  static std::pair<std::unique_ptr<DecompressedBytecodeBuffer>, std::string>
+  create(std::unique_ptr<const Buffer> container);
+
+  /// Decompress the chunk containing \p offset, if it is in the compressed
+  /// region and has not been decompressed yet. Thread safe.
+  void ensureDecompressed(uint32_t offset) const {
+    if (LLVM_UNLIKELY(offset >= coldStart_ && offset < coldEnd_))
+      decompressChunk(offset);
+  }
+
+ private:
+  DecompressedBytecodeBuffer(std::unique_ptr<const Buffer> container)
+      : container_(std::move(container)) {}
+
+  void decompressChunk(uint32_t offset) const;
+
+  /// The compressed container.
+  std::unique_ptr<const Buffer> container_;
+
+  /// Storage of the bytecode file, followed by the epilogue.
+  std::unique_ptr<uint8_t[]> storage_;
+
+  /// The chunk table, ordered by start.
+  std::vector<CompressedChunk> chunks_;
+
+  /// Set once each chunk is decompressed.
+  std::unique_ptr<std::once_flag[]> decompressed_;
+
+  /// The compressed region of the file.
+  uint32_t coldStart_{0};
+  uint32_t coldEnd_{0};
+};
+
+} // namespace hbc
+} // namespace hermes
+
+#endif // HERMES_BCGEN_HBC_COMPRESSEDBYTECODE_H
@@ -251,6 +251,29 @@ class DebugInfo {
       uint32_t cjsModuleOffset) const;
 };
 
+/// The source locations of one function, encoded the way DebugInfoGenerator
+/// stores them. This takes a few bytes per location instead of a
+/// DebugSourceLocation, while the rest of the module is generated.
+class EncodedSourceLocations {
+  friend class DebugInfoGenerator;
+
+  /// The location of the function itself.
+  DebugSourceLocation start_{};
+
+  /// The encoded locations, without the function index which precedes them.
+  std::vector<uint8_t> data_{};
+
+  /// The offsets in data_ where the filename changes, and the new filename
+  /// IDs.
+  std::vector<std::pair<uint32_t, uint32_t>> fileChanges_{};
+
+ public:
+  /// \return true if the function has no source locations.
+  bool empty() const {
+    return data_.empty();
+  }
+};
+
 class DebugInfoGenerator {
  private:
   /// A lexical data offset indicating empty lexical data (distinct from missing
@@ -273,7 +296,7 @@ class DebugInfoGenerator {
   /// associated with each code block.
   std::vector<uint8_t> lexicalData_;
 
-  int32_t delta(uint32_t to, uint32_t from) {
+  static int32_t delta(uint32_t to, uint32_t from) {
     int64_t diff = (int64_t)to - from;
     // It's unlikely that lines or columns will ever jump from 0 to 3 billion,
     // but if it ever happens we can extend to 64bit types.
@@ -306,6 +329,19 @@ class DebugInfoGenerator {
       uint32_t functionIndex,
       llvm::ArrayRef<DebugSourceLocation> offsets);
 
+  /// Append the source locations \p locations of the function with index
+  /// \p functionIndex, encoded by encodeSourceLocations().
+  /// \return the offset of the locations in the debug data.
+  uint32_t appendSourceLocations(
+      const EncodedSourceLocations &locations,
+      uint32_t functionIndex);
+
+  /// Encode the locations \p offsets of a function starting at \p start, to
+  /// be appended later without keeping every DebugSourceLocation.
+  static EncodedSourceLocations encodeSourceLocations(
+      const DebugSourceLocation &start,
+      llvm::ArrayRef<DebugSourceLocation> offsets);
+
   /// Append lexical data including parent function \p parentFunctionIndex and
   /// list of variable names \p names to the debug data. \return the offset in
   /// the lexical section of the debug data.
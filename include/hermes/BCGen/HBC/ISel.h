@@ -60,6 +60,13 @@ class HBCISel {
     /// The i'th index indicates which basic block should be jumped to for value
     /// i
     std::vector<BasicBlock *> table;
+
+    /// For SwitchStr, the string ID of the case of each entry of the table,
+    /// which is emitted before the jump offset of the entry.
+    std::vector<uint32_t> keys{};
+
+    /// For SwitchStr, the block to jump to for strings which aren't interned.
+    BasicBlock *fallbackTarget{nullptr};
   };
 
   /// The function that we are compiling.
@@ -75,6 +82,10 @@ class HBCISel {
   /// and scope depth of each function.
   FunctionScopeAnalysis &scopeAnalysis_;
 
+  /// Whether jumps are threaded through empty blocks, and jumps to blocks
+  /// which only return are replaced by the return.
+  bool peephole_;
+
   /// For each Basic Block, we map to its beginning instruction location
   /// and the next basic block. We need this information to resolve jump
   /// targets and exception handler table.
@@ -93,10 +104,16 @@ class HBCISel {
   /// Mapping from CatchInst to the catch coverage information.
   CatchInfoMap catchInfoMap_{};
 
-  /// Map from SwitchImm -> (inst offset, default block, jump table).
-  llvm::DenseMap<SwitchImmInst *, SwitchImmInfo> switchImmInfo_{};
+  /// Map from SwitchImm or SwitchStr -> (inst offset, default block, jump
+  /// table).
+  llvm::DenseMap<TerminatorInst *, SwitchImmInfo> switchImmInfo_{};
   using switchInfoEntry =
-      llvm::DenseMap<SwitchImmInst *, SwitchImmInfo>::iterator::value_type;
+      llvm::DenseMap<TerminatorInst *, SwitchImmInfo>::iterator::value_type;
+
+  /// For each block at which a generator resumes after a SaveGenerator, the
+  /// number of registers, starting from register 0, which are live on entry to
+  /// it and must be saved across the suspension.
+  llvm::DenseMap<BasicBlock *, unsigned> liveRegistersAtResume_{};
 
   /// Saved identifier of "__proto__" for fast comparisons.
   Identifier protoIdent_{};
@@ -110,8 +127,8 @@ class HBCISel {
   /// Add long jump instruction to the relocation list.
   void registerLongJump(offset_t loc, BasicBlock *target);
 
-  /// Add a jump table switch to relocation list.
-  void registerSwitchImm(offset_t loc, SwitchImmInst *target);
+  /// Add a jump table switch (SwitchImm or SwitchStr) to relocation list.
+  void registerSwitchImm(offset_t loc, TerminatorInst *target);
 
   /// Resolve all exception handlers.
   void resolveExceptionHandlers();
@@ -136,6 +153,26 @@ class HBCISel {
   /// Emit instructions at the entry block to handle several special cases.
   void initialize();
 
+  /// \return whether no bytecode is emitted for \p I.
+  bool emitsNothing(Instruction *I);
+
+  /// \return whether \p BB emits nothing but an unconditional jump, so that
+  /// jumps to it can go directly to its destination.
+  bool isJumpOnlyBlock(BasicBlock *BB);
+
+  /// \return the block that a jump to \p target can go to instead, by
+  /// threading it through the blocks which only jump. A \p target which is
+  /// the fall-through block \p next is kept.
+  BasicBlock *getJumpTarget(BasicBlock *target, BasicBlock *next);
+
+  /// If the jump to \p target can be replaced by the return that it leads
+  /// to, emit that return and \return true.
+  bool emitReturnInsteadOfJump(BasicBlock *target, BasicBlock *next);
+
+  /// Populate liveRegistersAtResume_ by computing the registers live on entry
+  /// to each block of \p order, based on the final register allocation.
+  void computeLiveRegistersAtResume(ArrayRef<BasicBlock *> order);
+
   /// Emit a mov, or none if it would be a no-op.
   void emitMovIfNeeded(param_t dest, param_t src);
 
@@ -145,6 +182,17 @@ class HBCISel {
   /// In debug mode, assert that parameters have been correctly allocated.
   void verifyCall(CallInst *Inst);
 
+  /// \return true if \p I is a constant load that is folded into the
+  /// superinstruction emitted for its only user, so it must not be emitted.
+  bool isFusedIntoCompareBranch(Instruction *I);
+
+  /// Emit a JStrictEqualZero or JStrictNotEqualZero superinstruction for
+  /// \p Inst, which compares against the folded constant load \p zero.
+  void generateCompareZeroBranch(
+      CompareBranchInst *Inst,
+      HBCLoadConstInst *zero,
+      BasicBlock *next);
+
   /// The last emitted property cache index.
   uint8_t lastPropertyReadCacheIndex_{0};
   uint8_t lastPropertyWriteCacheIndex_{0};
@@ -158,6 +206,11 @@ class HBCISel {
   uint8_t acquirePropertyReadCacheIndex(unsigned id);
   uint8_t acquirePropertyWriteCacheIndex(unsigned id);
 
+  /// \return a new read cache index for the "prototype" property of the
+  /// constructor of an InstanceOf. It is not shared with other instructions,
+  /// since the name may not be in the string table.
+  uint8_t acquireInstanceOfCacheIndex();
+
   // Looking up filename/sourcemap id for each instruction is pretty slow,
   // and it's almost always from the same bufId every time. Cache the previous
   // result here, to reuse it when possible.
@@ -171,12 +224,18 @@ class HBCISel {
   /// C'tor.
   /// \p F is the function that we are constructing.
   /// \p OS is the output stream.
+  /// \p peephole enables the jump peepholes done while emitting branches.
   HBCISel(
       Function *F,
       BytecodeFunctionGenerator *BCFGen,
       HVMRegisterAllocator &RA,
-      FunctionScopeAnalysis &scopeAnalysis)
-      : F_(F), BCFGen_(BCFGen), RA_(RA), scopeAnalysis_(scopeAnalysis) {
+      FunctionScopeAnalysis &scopeAnalysis,
+      bool peephole = false)
+      : F_(F),
+        BCFGen_(BCFGen),
+        RA_(RA),
+        scopeAnalysis_(scopeAnalysis),
+        peephole_(peephole) {
     protoIdent_ = F->getContext().getIdentifier("__proto__");
   }
 
@@ -47,16 +47,27 @@ class LoadParameters : public FunctionPass {
 };
 
 /// Lower LoadFrameInst, StoreFrameInst and CreateFunctionInst.
+/// If \p elideEmptyEnvironments is set, functions whose scope has no
+/// variables left don't create an environment: the closures they create share
+/// the environment of the function itself, which shortens the environment
+/// chains walked by GetEnvironment.
 class LowerLoadStoreFrameInst : public FunctionPass {
+  /// Whether functions without variables may skip creating an environment.
+  bool elideEmptyEnvironments_;
+
   /// Decide the correct scope to use when dealing with given variable.
   Instruction *getScope(
       IRBuilder &builder,
       Variable *var,
       HBCCreateEnvironmentInst *captureScope);
 
+  /// \return whether \p F can run without creating its own environment.
+  bool canElideEnvironment(Function *F) const;
+
  public:
-  explicit LowerLoadStoreFrameInst()
-      : FunctionPass("LowerLoadStoreFrameInst") {}
+  explicit LowerLoadStoreFrameInst(bool elideEmptyEnvironments = false)
+      : FunctionPass("LowerLoadStoreFrameInst"),
+        elideEmptyEnvironments_(elideEmptyEnvironments) {}
   ~LowerLoadStoreFrameInst() override = default;
   bool runOnFunction(Function *F) override;
 };
@@ -88,6 +99,16 @@ class LowerConstruction : public FunctionPass {
   bool runOnFunction(Function *F) override;
 };
 
+/// Lower comparisons of the result of typeof with a literal string, such as
+/// `typeof x === "string"`, into HBCTypeOfIsInst, which doesn't create or
+/// compare strings.
+class LowerTypeOfCompare : public FunctionPass {
+ public:
+  explicit LowerTypeOfCompare() : FunctionPass("LowerTypeOfCompare") {}
+  ~LowerTypeOfCompare() override = default;
+  bool runOnFunction(Function *F) override;
+};
+
 /// Lower calls into a series of parameter moves followed by a call with
 /// those moved values. Should only run once, right before MovElimination.
 class LowerCalls : public FunctionPass {
@@ -141,6 +162,12 @@ class SpillRegisters : public FunctionPass {
   ~SpillRegisters() override = default;
   bool runOnFunction(Function *F) override;
 
+  /// \return the number of registers which can be allocated to instructions
+  /// and still fit in a Reg8 once the temp space is reserved.
+  static unsigned getShortRegisterLimit() {
+    return boundary_ - reserved_;
+  }
+
  protected:
   HVMRegisterAllocator &RA_;
   /// The first "high" register.
@@ -177,7 +204,8 @@ class SpillRegisters : public FunctionPass {
 /// Attempt to lower a switch statement into a jump table.
 /// Must be run prior to the pass lowering switches into linear search.
 /// Currently this only affects switches that are suffciently dense and with
-/// positive cases.
+/// positive cases, and switches with enough string cases, which become a
+/// SwitchStr whose fallback block holds the original switch.
 class LowerSwitchIntoJumpTables : public FunctionPass {
  public:
   explicit LowerSwitchIntoJumpTables()
@@ -187,8 +215,13 @@ class LowerSwitchIntoJumpTables : public FunctionPass {
 
  private:
   bool lowerIntoJumpTable(SwitchInst *switchInst);
+  bool lowerIntoStringTable(SwitchInst *switchInst);
 };
 
+/// \return the hash of the string literal \p str, which is the identifier
+/// hash that the VM computes for the string at runtime.
+uint32_t hashStringLiteral(llvm::StringRef str);
+
 } // namespace hbc
 } // namespace hermes
 #endif
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_BCGEN_HBC_PASSES_LOWERSTRINGCONCATCHAINS_H
+#define HERMES_BCGEN_HBC_PASSES_LOWERSTRINGCONCATCHAINS_H
+
+#include "hermes/Optimizer/PassManager/Pass.h"
+
+namespace hermes {
+namespace hbc {
+
+/// Replace chains of string additions like `"a" + b + "c" + d` with a single
+/// call to the HermesInternal.concatStrings() builtin, which allocates the
+/// result once instead of creating every intermediate string.
+class LowerStringConcatChains : public FunctionPass {
+ public:
+  explicit LowerStringConcatChains()
+      : FunctionPass("LowerStringConcatChains") {}
+
+  bool runOnFunction(Function *F) override;
+};
+
+} // namespace hbc
+} // namespace hermes
+
+#endif // HERMES_BCGEN_HBC_PASSES_LOWERSTRINGCONCATCHAINS_H
@@ -37,8 +37,9 @@ class SwitchLowering : public FunctionPass {
   void erasePhiTarget(BasicBlock *block, BasicBlock *toDelete);
 };
 
-/// Lowers AllocObjects and any PutNewOwnByIds which use literals
-/// to a single HBCAllocObjectFromBufferInst.
+/// Lowers AllocObjects and the PutNewOwnByIds which initialize them to a
+/// single HBCAllocObjectFromBufferInst, which creates the object with its
+/// final class, followed by HBCStoreOwnBySlotIdxInsts for non-literals.
 class LowerAllocObject : public FunctionPass {
  public:
   explicit LowerAllocObject(uint32_t maxSizeInclusive)
@@ -49,11 +50,9 @@ class LowerAllocObject : public FunctionPass {
 
  private:
   /// Serialize AllocObjects with literal and non-literals into object buffer;
-  /// non-literals will be placeholders and later overwritten by PutByIds.
+  /// non-literals will be placeholders and later overwritten by storing to
+  /// their slot.
   bool lowerAlloc(AllocObjectInst *allocInst);
-  /// Estimate best number of elements to serialize into the buffer.
-  /// Try optimizing for max bytecode size saving.
-  uint32_t estimateBestNumElemsToSerialize(AllocObjectInst *allocInst);
 
   uint32_t maxSize_;
 };
@@ -314,6 +314,11 @@ class RegisterAllocator {
       DenseMap<Instruction *, Instruction *> &map,
       ArrayRef<BasicBlock *> order);
 
+  /// If more than shortRegisterLimit registers were allocated, renumber the
+  /// registers so that the ones with the most uses, weighted by the loop
+  /// depth of the blocks in \p order, get the lowest numbers.
+  void prioritizeRegisters(ArrayRef<BasicBlock *> order);
+
  protected:
   /// Keeps track of the already allocated values.
   llvm::DenseMap<Value *, Register> allocated{};
@@ -330,6 +335,10 @@ class RegisterAllocator {
   /// degenerate cases.
   uint64_t memoryLimit = -1;
 
+  /// The number of registers which can be encoded in the short forms of the
+  /// instructions, or 0 if there is no limit.
+  unsigned shortRegisterLimit = 0;
+
   /// Allocate the registers for the instructions in the function in a trivial,
   /// suboptimal, but very fast way.
   void allocateFastPass(ArrayRef<BasicBlock *> order);
@@ -359,6 +368,10 @@ class RegisterAllocator {
     memoryLimit = memoryLimitInBytes;
   }
 
+  void setShortRegisterLimit(unsigned count) {
+    shortRegisterLimit = count;
+  }
+
   /// \returns the index of instruction \p I.
   unsigned getInstructionNumber(Instruction *I);
 
@@ -56,11 +56,24 @@ struct ExecuteOptions {
   std::string profilerSymbolsFile;
 #endif
 
+#ifdef HERMESVM_PROFILER_JSFUNCTION
+  /// Write the call counts of the functions for hermesc -inlining-profile
+  /// in this file, if not empty.
+  std::string inliningProfileFile;
+#endif
+
+  /// Write the type feedback of the quickened functions for hermesc
+  /// -type-feedback in this file, if not empty.
+  std::string typeFeedbackFile;
+
   /// Dump JIT'ed code.
   bool dumpJITCode{false};
 
   /// Fatally crash on any JIT compilation error.
   bool jitCrashOnError{false};
+
+  /// Report why functions couldn't be JIT compiled.
+  bool jitReportBailouts{false};
 };
 
 /// Executes the HBC bytecode provided in HermesVM.
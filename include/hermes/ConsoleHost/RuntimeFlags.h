@@ -107,6 +107,14 @@ static opt<std::string> ProfilerSymbolsFile(
     init("symbol_dump.map"));
 #endif
 
+#ifdef HERMESVM_PROFILER_JSFUNCTION
+static opt<std::string> InliningProfileFile(
+    "inlining-profile-file",
+    desc("Write the call counts of the functions in specified file at exit, "
+         "for use with hermesc -inlining-profile."),
+    init(""));
+#endif
+
 static opt<bool>
     ES6Symbol("Xes6-symbol", desc("Enable support for ES6 Symbol"), init(true));
 
@@ -120,6 +128,33 @@ static opt<bool> TrackBytecodeIO(
     desc(
         "Track bytecode I/O when executing bytecode. Only works with bytecode mode"));
 
+static opt<uint32_t> QuickeningThreshold(
+    "Xquickening-threshold",
+    desc("Number of invocations after which a function is quickened. "
+         "0 disables quickening."),
+    init(0),
+    Hidden);
+
+static opt<bool> EvictColdLazyFunctions(
+    "Xevict-cold-lazy-functions",
+    desc("Drop the bytecode of the lazily compiled functions which are not "
+         "called between two full collections."),
+    init(false),
+    Hidden);
+
+static opt<bool> ReleaseSharedPropertyMaps(
+    "Xrelease-shared-property-maps",
+    desc("Drop the property maps that hidden classes keep for their children "
+         "to share after each full collection."),
+    init(false),
+    Hidden);
+
+static opt<std::string> TypeFeedbackFile(
+    "type-feedback-file",
+    desc("Write the type feedback gathered by quickening in specified file at "
+         "exit, for use with hermesc -type-feedback."),
+    init(""));
+
 static opt<uint32_t> VMExperimentFlags(
     "Xvm-experiment-flags",
     llvm::cl::desc("VM experiment flags."),
@@ -137,8 +137,9 @@ class FunctionScopeAnalysis {
     Function *parent;
 
     /// The depth in the scope chain. The global scope has depth 0, each
-    /// function nesting level increases this by 1. Placeholder functions (which
-    /// represent the lexical environment in local eval) have negative depths.
+    /// function nesting level which creates an environment increases this by
+    /// 1. Placeholder functions (which represent the lexical environment in
+    /// local eval) have negative depths.
     int32_t depth;
 
     /// Indicates that the function has no scope data, because while the
@@ -146,11 +147,20 @@ class FunctionScopeAnalysis {
     /// to create it.
     bool orphaned;
 
+    /// Whether the function creates its own environment. If it doesn't, it
+    /// shares the environment of its lexical parent, and its scope has the
+    /// same depth as the scope of the parent.
+    bool ownEnvironment;
+
     ScopeData(
         Function *parent = nullptr,
         int32_t depth = 0,
-        bool orphaned = false)
-        : parent(parent), depth(depth), orphaned(orphaned) {}
+        bool orphaned = false,
+        bool ownEnvironment = true)
+        : parent(parent),
+          depth(depth),
+          orphaned(orphaned),
+          ownEnvironment(ownEnvironment) {}
 
     /// Convenience function. \return an orphaned ScopeData.
     static ScopeData orphan() {
@@ -174,6 +184,17 @@ class FunctionScopeAnalysis {
 
   /// Lazily get the lexical parent of \p F, or nullptr if none.
   Function *getLexicalParent(Function *F);
+
+  /// Lazily get whether the lowered function \p F creates its own
+  /// environment.
+  bool hasOwnEnvironment(Function *F);
+
+  /// Compute the scope data of \p F now rather than when it is first
+  /// requested. It is found from the instruction creating \p F in the body
+  /// of its parent, so this must be done before that body is erased.
+  void precompute(Function *F) {
+    (void)calculateFunctionScopeData(F);
+  }
 };
 
 /// A namespace encapsulating utilities for implementing optimization passes
@@ -1431,6 +1431,11 @@ class Function : public ilist_node_with_parent<Function, Module>, public Value {
   /// However this does not deallocate (destroy) the memory of this function.
   void eraseFromParentNoDestroy();
 
+  /// Erase all the basic blocks and instructions in this function, keeping
+  /// the function itself, its parameters and its scopes. This frees the body
+  /// once nothing needs it anymore, e.g. after bytecode was emitted for it.
+  void eraseBody();
+
   /// \returns the original function name specified by the user,
   /// or if not specified, the inferred name.
   Identifier getOriginalOrInferredName() const {
@@ -1673,6 +1678,9 @@ class Module : public Value {
     Identifier filename;
     /// Pointer to the wrapper function for the module.
     Function *function;
+    /// IDs of the modules which are statically required by the wrapper
+    /// function itself, and so are initialized along with this module.
+    std::vector<uint32_t> dependencies{};
   };
 
  private:
@@ -1843,7 +1851,7 @@ class Module : public Value {
   /// Add a new CJS module entry, given the function representing the module.
   void addCJSModule(Identifier name, Function *function) {
     uint32_t id = cjsModules_.size();
-    cjsModules_.push_back(CJSModule{id, name, function});
+    cjsModules_.push_back(CJSModule{id, name, function, {}});
     auto &module = cjsModules_.back();
     {
       auto result = cjsModuleFilenameMap_.try_emplace(name, &module);
@@ -1864,6 +1872,11 @@ class Module : public Value {
     return it == cjsModuleFunctionMap_.end() ? nullptr : it->second;
   }
 
+  CJSModule *findCJSModule(Function *function) {
+    auto it = cjsModuleFunctionMap_.find(function);
+    return it == cjsModuleFunctionMap_.end() ? nullptr : it->second;
+  }
+
   /// \return the CommonJS module given the filename if it is a module,
   /// else nullptr.
   const CJSModule *findCJSModule(Identifier filename) const {
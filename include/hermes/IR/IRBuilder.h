@@ -448,6 +448,16 @@ class IRBuilder {
 
   ResumeGeneratorInst *createResumeGeneratorInst(Value *isReturn);
 
+  IteratorBeginInst *createIteratorBeginInst(AllocStackInst *sourceOrNext);
+
+  IteratorNextInst *createIteratorNextInst(
+      AllocStackInst *iterator,
+      AllocStackInst *sourceOrNext);
+
+  IteratorCloseInst *createIteratorCloseInst(
+      Value *iterator,
+      bool ignoreInnerException);
+
   //--------------------------------------------------------------------------//
   //                  Target specific insertions                              //
   //--------------------------------------------------------------------------//
@@ -467,6 +477,14 @@ class IRBuilder {
       const SwitchImmInst::ValueListType &values,
       const SwitchImmInst::BasicBlockListType &blocks);
 
+  SwitchStrInst *createSwitchStrInst(
+      Value *input,
+      BasicBlock *defaultBlock,
+      BasicBlock *fallbackBlock,
+      LiteralNumber *tableSize,
+      const SwitchStrInst::ValueListType &values,
+      const SwitchStrInst::BasicBlockListType &blocks);
+
   HBCLoadConstInst *createHBCLoadConstInst(Literal *value);
 
   HBCLoadParamInst *createHBCLoadParamInst(LiteralNumber *value);
@@ -484,6 +502,12 @@ class IRBuilder {
 
   HBCReifyArgumentsInst *createHBCReifyArgumentsInst(AllocStackInst *lazyReg);
 
+  HBCApplyArgumentsInst *createHBCApplyArgumentsInst(
+      Value *callee,
+      Value *function,
+      Value *thisArg,
+      AllocStackInst *lazyReg);
+
   HBCCreateThisInst *createHBCCreateThisInst(Value *prototype, Value *closure);
 
   HBCConstructInst *createHBCConstructInst(
@@ -516,6 +540,18 @@ class IRBuilder {
       HBCAllocObjectFromBufferInst::ObjectPropertyMap prop_map,
       uint32_t size);
 
+  HBCStoreOwnBySlotIdxInst *createHBCStoreOwnBySlotIdxInst(
+      Value *storedValue,
+      Value *object,
+      uint32_t slot);
+
+  HBCTypeOfIsInst *createHBCTypeOfIsInst(Value *value, uint8_t type);
+
+  HBCGetTemplateObjectInst *createHBCGetTemplateObjectInst(
+      uint32_t templateObjID,
+      bool dup,
+      ArrayRef<LiteralString *> strings);
+
   CompareBranchInst *createCompareBranchInst(
       Value *left,
       Value *right,
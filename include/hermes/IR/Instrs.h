@@ -1361,6 +1361,183 @@ class HBCAllocObjectFromBufferInst : public Instruction {
   }
 };
 
+/// Store a value into the property at a known slot of an object allocated by
+/// HBCAllocObjectFromBufferInst, whose properties are laid out in the order
+/// of its key buffer. The slot of the n-th key is n.
+class HBCStoreOwnBySlotIdxInst : public Instruction {
+  HBCStoreOwnBySlotIdxInst(const HBCStoreOwnBySlotIdxInst &) = delete;
+  void operator=(const HBCStoreOwnBySlotIdxInst &) = delete;
+
+ public:
+  enum { StoredValueIdx, ObjectIdx, SlotIdx };
+
+  explicit HBCStoreOwnBySlotIdxInst(
+      Value *storedValue,
+      Value *object,
+      LiteralNumber *slot)
+      : Instruction(ValueKind::HBCStoreOwnBySlotIdxInstKind) {
+    pushOperand(storedValue);
+    pushOperand(object);
+    pushOperand(slot);
+  }
+  explicit HBCStoreOwnBySlotIdxInst(
+      const HBCStoreOwnBySlotIdxInst *src,
+      llvm::ArrayRef<Value *> operands)
+      : Instruction(src, operands) {}
+
+  Value *getStoredValue() const {
+    return getOperand(StoredValueIdx);
+  }
+  Value *getObject() const {
+    return getOperand(ObjectIdx);
+  }
+  LiteralNumber *getSlot() const {
+    return cast<LiteralNumber>(getOperand(SlotIdx));
+  }
+
+  SideEffectKind getSideEffect() {
+    return SideEffectKind::MayWrite;
+  }
+
+  WordBitSet<> getChangedOperandsImpl() {
+    return {};
+  }
+
+  bool canSetOperandImpl(ValueKind kind, unsigned index) const {
+    switch (index) {
+      case StoredValueIdx:
+      case ObjectIdx:
+        return true;
+      case SlotIdx:
+        return kindIsA(kind, ValueKind::LiteralNumberKind);
+      default:
+        return false;
+    }
+  }
+
+  static bool classof(const Value *V) {
+    return kindIsA(V->getKind(), ValueKind::HBCStoreOwnBySlotIdxInstKind);
+  }
+};
+
+/// Get the template object of a tagged template, which is created the first
+/// time and then cached by its ID. The operands are the ones of
+/// HermesInternal.getTemplateObject(): the ID, whether the cooked strings are
+/// the same as the raw strings, the raw strings and, unless they are the same,
+/// the cooked strings. All of them are literals.
+class HBCGetTemplateObjectInst : public Instruction {
+  HBCGetTemplateObjectInst(const HBCGetTemplateObjectInst &) = delete;
+  void operator=(const HBCGetTemplateObjectInst &) = delete;
+
+ public:
+  enum { TemplateObjIDIdx, DupIdx, FirstStringIdx };
+
+  explicit HBCGetTemplateObjectInst(
+      LiteralNumber *templateObjID,
+      LiteralBool *dup,
+      llvm::ArrayRef<LiteralString *> strings)
+      : Instruction(ValueKind::HBCGetTemplateObjectInstKind) {
+    setType(Type::createObject());
+    pushOperand(templateObjID);
+    pushOperand(dup);
+    for (LiteralString *str : strings)
+      pushOperand(str);
+  }
+  explicit HBCGetTemplateObjectInst(
+      const HBCGetTemplateObjectInst *src,
+      llvm::ArrayRef<Value *> operands)
+      : Instruction(src, operands) {}
+
+  LiteralNumber *getTemplateObjID() const {
+    return cast<LiteralNumber>(getOperand(TemplateObjIDIdx));
+  }
+  LiteralBool *getDup() const {
+    return cast<LiteralBool>(getOperand(DupIdx));
+  }
+
+  /// \return the number of raw and cooked strings.
+  unsigned getNumStrings() const {
+    return getNumOperands() - FirstStringIdx;
+  }
+  LiteralString *getString(unsigned index) const {
+    return cast<LiteralString>(getOperand(FirstStringIdx + index));
+  }
+
+  SideEffectKind getSideEffect() {
+    return SideEffectKind::None;
+  }
+
+  WordBitSet<> getChangedOperandsImpl() {
+    return {};
+  }
+
+  bool canSetOperandImpl(ValueKind kind, unsigned index) const {
+    switch (index) {
+      case TemplateObjIDIdx:
+        return kindIsA(kind, ValueKind::LiteralNumberKind);
+      case DupIdx:
+        return kindIsA(kind, ValueKind::LiteralBoolKind);
+      default:
+        return kindIsA(kind, ValueKind::LiteralStringKind);
+    }
+  }
+
+  static bool classof(const Value *V) {
+    return kindIsA(V->getKind(), ValueKind::HBCGetTemplateObjectInstKind);
+  }
+};
+
+/// Compare the typeof result of a value with a literal string without
+/// creating the string. The type is an inst::TypeOfIsType.
+class HBCTypeOfIsInst : public Instruction {
+  HBCTypeOfIsInst(const HBCTypeOfIsInst &) = delete;
+  void operator=(const HBCTypeOfIsInst &) = delete;
+
+ public:
+  enum { ValueIdx, TypeIdx };
+
+  explicit HBCTypeOfIsInst(Value *value, LiteralNumber *type)
+      : Instruction(ValueKind::HBCTypeOfIsInstKind) {
+    setType(Type::createBoolean());
+    pushOperand(value);
+    pushOperand(type);
+  }
+  explicit HBCTypeOfIsInst(
+      const HBCTypeOfIsInst *src,
+      llvm::ArrayRef<Value *> operands)
+      : Instruction(src, operands) {}
+
+  Value *getValue() const {
+    return getOperand(ValueIdx);
+  }
+  LiteralNumber *getTypeOfIsType() const {
+    return cast<LiteralNumber>(getOperand(TypeIdx));
+  }
+
+  SideEffectKind getSideEffect() {
+    return SideEffectKind::None;
+  }
+
+  WordBitSet<> getChangedOperandsImpl() {
+    return {};
+  }
+
+  bool canSetOperandImpl(ValueKind kind, unsigned index) const {
+    switch (index) {
+      case ValueIdx:
+        return true;
+      case TypeIdx:
+        return kindIsA(kind, ValueKind::LiteralNumberKind);
+      default:
+        return false;
+    }
+  }
+
+  static bool classof(const Value *V) {
+    return kindIsA(V->getKind(), ValueKind::HBCTypeOfIsInstKind);
+  }
+};
+
 class AllocArrayInst : public Instruction {
   AllocArrayInst(const AllocArrayInst &) = delete;
   void operator=(const AllocArrayInst &) = delete;
@@ -2658,6 +2835,111 @@ class SwitchImmInst : public TerminatorInst {
   void setSuccessor(unsigned idx, BasicBlock *B);
 };
 
+/// Switch on string cases through a hash table of the cases. Only inputs that
+/// are interned strings can be looked up in the table; other strings jump to
+/// the fallback block, which compares the input with each case in turn.
+class SwitchStrInst : public TerminatorInst {
+  SwitchStrInst(const SwitchStrInst &) = delete;
+  void operator=(const SwitchStrInst &) = delete;
+
+ public:
+  enum {
+    InputIdx,
+    DefaultBlockIdx,
+    FallbackBlockIdx,
+    TableSizeIdx,
+    FirstCaseIdx
+  };
+
+  using ValueListType = llvm::SmallVector<LiteralString *, 8>;
+  using BasicBlockListType = llvm::SmallVector<BasicBlock *, 8>;
+
+  /// \returns the number of switch case values.
+  unsigned getNumCasePair() const {
+    return (getNumOperands() - FirstCaseIdx) / 2;
+  }
+
+  /// Returns the n'th pair of value-basicblock that represent a case
+  /// destination.
+  std::pair<LiteralString *, BasicBlock *> getCasePair(unsigned i) const {
+    unsigned base = i * 2 + FirstCaseIdx;
+    return std::make_pair(
+        cast<LiteralString>(getOperand(base)),
+        cast<BasicBlock>(getOperand(base + 1)));
+  }
+
+  /// \returns the destination of the default target.
+  BasicBlock *getDefaultDestination() const {
+    return cast<BasicBlock>(getOperand(DefaultBlockIdx));
+  }
+
+  /// \returns the destination of strings which are not interned.
+  BasicBlock *getFallbackDestination() const {
+    return cast<BasicBlock>(getOperand(FallbackBlockIdx));
+  }
+
+  /// \returns the input value. This is the value we switch on.
+  Value *getInputValue() const {
+    return getOperand(InputIdx);
+  }
+
+  /// \returns the number of entries of the hash table, a power of two.
+  uint32_t getTableSize() const {
+    return cast<LiteralNumber>(getOperand(TableSizeIdx))->asUInt32();
+  }
+
+  /// \p input is the discriminator value.
+  /// \p defaultBlock is the block to jump to if nothing matches.
+  /// \p fallbackBlock is the block to jump to if \p input is a string which
+  ///   is not interned.
+  /// \p tableSize is the number of entries of the hash table, in which no two
+  ///   cases have the same entry.
+  explicit SwitchStrInst(
+      Value *input,
+      BasicBlock *defaultBlock,
+      BasicBlock *fallbackBlock,
+      LiteralNumber *tableSize,
+      const ValueListType &values,
+      const BasicBlockListType &blocks);
+  explicit SwitchStrInst(
+      const SwitchStrInst *src,
+      llvm::ArrayRef<Value *> operands)
+      : TerminatorInst(src, operands) {}
+
+  SideEffectKind getSideEffect() {
+    return SideEffectKind::None;
+  }
+
+  WordBitSet<> getChangedOperandsImpl() {
+    return {};
+  }
+
+  bool canSetOperandImpl(ValueKind kind, unsigned index) const {
+    switch (index) {
+      case InputIdx:
+        return true;
+      case DefaultBlockIdx:
+      case FallbackBlockIdx:
+        return kindIsA(kind, ValueKind::BasicBlockKind);
+      case TableSizeIdx:
+        return kindIsA(kind, ValueKind::LiteralNumberKind);
+      default:
+        return !(index & 1) ? kindIsA(kind, ValueKind::LiteralStringKind)
+                            : kindIsA(kind, ValueKind::BasicBlockKind);
+    }
+  }
+
+  static bool classof(const Value *V) {
+    return kindIsA(V->getKind(), ValueKind::SwitchStrInstKind);
+  }
+
+  unsigned getNumSuccessors() const {
+    return getNumCasePair() + 2;
+  }
+  BasicBlock *getSuccessor(unsigned idx) const;
+  void setSuccessor(unsigned idx, BasicBlock *B);
+};
+
 class SaveAndYieldInst : public TerminatorInst {
   SaveAndYieldInst(const SaveAndYieldInst &) = delete;
   void operator=(const SaveAndYieldInst &) = delete;
@@ -3030,6 +3312,63 @@ class HBCReifyArgumentsInst : public SingleOperandInst {
   }
 };
 
+// Call `callee(function, thisArg, arguments)`, which is usually
+// `function.apply(thisArg, arguments)`. If callee is Function.prototype.apply
+// and `arguments` hasn't been reified, the arguments of the current frame are
+// passed to the function directly.
+class HBCApplyArgumentsInst : public Instruction {
+  HBCApplyArgumentsInst(const HBCApplyArgumentsInst &) = delete;
+  void operator=(const HBCApplyArgumentsInst &) = delete;
+
+ public:
+  enum { CalleeIdx, FunctionIdx, ThisArgIdx, LazyRegisterIdx };
+
+  explicit HBCApplyArgumentsInst(
+      Value *callee,
+      Value *function,
+      Value *thisArg,
+      AllocStackInst *reg)
+      : Instruction(ValueKind::HBCApplyArgumentsInstKind) {
+    pushOperand(callee);
+    pushOperand(function);
+    pushOperand(thisArg);
+    pushOperand(reg);
+  }
+  explicit HBCApplyArgumentsInst(
+      const HBCApplyArgumentsInst *src,
+      llvm::ArrayRef<Value *> operands)
+      : Instruction(src, operands) {}
+
+  Value *getCallee() const {
+    return getOperand(CalleeIdx);
+  }
+  Value *getFunction() const {
+    return getOperand(FunctionIdx);
+  }
+  Value *getThisArg() const {
+    return getOperand(ThisArgIdx);
+  }
+  Value *getLazyRegister() const {
+    return getOperand(LazyRegisterIdx);
+  }
+
+  SideEffectKind getSideEffect() {
+    return SideEffectKind::Unknown;
+  }
+
+  WordBitSet<> getChangedOperandsImpl() {
+    return WordBitSet<>{}.set(LazyRegisterIdx);
+  }
+
+  bool canSetOperandImpl(ValueKind kind, unsigned index) const {
+    return index <= LazyRegisterIdx;
+  }
+
+  static bool classof(const Value *V) {
+    return kindIsA(V->getKind(), ValueKind::HBCApplyArgumentsInstKind);
+  }
+};
+
 /// Create a 'this' object to be filled in by a constructor.
 class HBCCreateThisInst : public Instruction {
   HBCCreateThisInst(const HBCCreateThisInst &) = delete;
@@ -3518,6 +3857,150 @@ class ResumeGeneratorInst : public Instruction {
   }
 };
 
+/// Begin iterating the value stored in \p sourceOrNext, which is replaced by
+/// the \c next method of its iterator. Arrays whose iteration hasn't been
+/// changed are instead iterated by index without creating an iterator: the
+/// result is then the index of the next element, and the array stays in
+/// \p sourceOrNext.
+/// \return the iterator, or the starting index.
+class IteratorBeginInst : public Instruction {
+  IteratorBeginInst(const IteratorBeginInst &) = delete;
+  void operator=(const IteratorBeginInst &) = delete;
+
+ public:
+  enum { SourceOrNextIdx };
+
+  explicit IteratorBeginInst(AllocStackInst *sourceOrNext)
+      : Instruction(ValueKind::IteratorBeginInstKind) {
+    pushOperand(sourceOrNext);
+  }
+  explicit IteratorBeginInst(
+      const IteratorBeginInst *src,
+      llvm::ArrayRef<Value *> operands)
+      : Instruction(src, operands) {}
+
+  Value *getSourceOrNext() const {
+    return getOperand(SourceOrNextIdx);
+  }
+
+  SideEffectKind getSideEffect() {
+    return SideEffectKind::Unknown;
+  }
+
+  WordBitSet<> getChangedOperandsImpl() {
+    return WordBitSet<>{}.set(SourceOrNextIdx);
+  }
+
+  bool canSetOperandImpl(ValueKind kind, unsigned index) const {
+    return index == SourceOrNextIdx;
+  }
+
+  static bool classof(const Value *V) {
+    return kindIsA(V->getKind(), ValueKind::IteratorBeginInstKind);
+  }
+};
+
+/// Advance an iteration started by IteratorBeginInst. When the iteration is
+/// done, \p iterator is set to undefined.
+/// \return the next value, or undefined when the iteration is done.
+class IteratorNextInst : public Instruction {
+  IteratorNextInst(const IteratorNextInst &) = delete;
+  void operator=(const IteratorNextInst &) = delete;
+
+ public:
+  enum { IteratorIdx, SourceOrNextIdx };
+
+  explicit IteratorNextInst(
+      AllocStackInst *iterator,
+      AllocStackInst *sourceOrNext)
+      : Instruction(ValueKind::IteratorNextInstKind) {
+    pushOperand(iterator);
+    pushOperand(sourceOrNext);
+  }
+  explicit IteratorNextInst(
+      const IteratorNextInst *src,
+      llvm::ArrayRef<Value *> operands)
+      : Instruction(src, operands) {}
+
+  Value *getIterator() const {
+    return getOperand(IteratorIdx);
+  }
+  Value *getSourceOrNext() const {
+    return getOperand(SourceOrNextIdx);
+  }
+
+  SideEffectKind getSideEffect() {
+    return SideEffectKind::Unknown;
+  }
+
+  WordBitSet<> getChangedOperandsImpl() {
+    return WordBitSet<>{}.set(IteratorIdx);
+  }
+
+  bool canSetOperandImpl(ValueKind kind, unsigned index) const {
+    return index <= SourceOrNextIdx;
+  }
+
+  static bool classof(const Value *V) {
+    return kindIsA(V->getKind(), ValueKind::IteratorNextInstKind);
+  }
+};
+
+/// Close an iteration started by IteratorBeginInst before it is done, by
+/// calling the \c return method of the iterator if it has one. Iterations by
+/// index have nothing to close.
+class IteratorCloseInst : public Instruction {
+  IteratorCloseInst(const IteratorCloseInst &) = delete;
+  void operator=(const IteratorCloseInst &) = delete;
+
+ public:
+  enum { IteratorIdx, IgnoreInnerExceptionIdx };
+
+  explicit IteratorCloseInst(
+      Value *iterator,
+      LiteralBool *ignoreInnerException)
+      : Instruction(ValueKind::IteratorCloseInstKind) {
+    pushOperand(iterator);
+    pushOperand(ignoreInnerException);
+  }
+  explicit IteratorCloseInst(
+      const IteratorCloseInst *src,
+      llvm::ArrayRef<Value *> operands)
+      : Instruction(src, operands) {}
+
+  Value *getIterator() const {
+    return getOperand(IteratorIdx);
+  }
+  /// If set, exceptions thrown by the \c return method are ignored and its
+  /// result isn't checked to be an object.
+  bool getIgnoreInnerException() const {
+    return cast<LiteralBool>(getOperand(IgnoreInnerExceptionIdx))->getValue();
+  }
+
+  SideEffectKind getSideEffect() {
+    return SideEffectKind::Unknown;
+  }
+
+  WordBitSet<> getChangedOperandsImpl() {
+    return {};
+  }
+
+  bool canSetOperandImpl(ValueKind kind, unsigned index) const {
+    switch (index) {
+      case IteratorIdx:
+        return true;
+      case IgnoreInnerExceptionIdx:
+        return kindIsA(kind, ValueKind::LiteralBoolKind);
+      default:
+        return false;
+    }
+  }
+
+  static bool classof(const Value *V) {
+    return kindIsA(V->getKind(), ValueKind::IteratorCloseInstKind);
+  }
+};
+
 /// A bytecode version of llvm_unreachable, for use in stubs and similar.
 class UnreachableInst : public Instruction {
   UnreachableInst(const UnreachableInst &) = delete;
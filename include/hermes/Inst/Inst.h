@@ -8,6 +8,7 @@
 #define HERMES_INST_INST_H
 
 #include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/StringSwitch.h"
 
 namespace hermes {
 namespace inst {
@@ -77,6 +78,33 @@ enum class OpCode : uint8_t {
 
 #include "hermes/BCGen/HBC/BytecodeList.def"
 
+/// The types tested by TypeOfIs, one for each result of the typeof operator.
+enum class TypeOfIsType : uint8_t {
+  Undefined,
+  /// null and objects that are not callable.
+  Object,
+  String,
+  Symbol,
+  Boolean,
+  Number,
+  Function,
+  _last
+};
+
+/// \return the type whose typeof result is \p name, or TypeOfIsType::_last if
+/// typeof never returns \p name.
+inline TypeOfIsType typeOfIsTypeFromName(llvm::StringRef name) {
+  return llvm::StringSwitch<TypeOfIsType>(name)
+      .Case("undefined", TypeOfIsType::Undefined)
+      .Case("object", TypeOfIsType::Object)
+      .Case("string", TypeOfIsType::String)
+      .Case("symbol", TypeOfIsType::Symbol)
+      .Case("boolean", TypeOfIsType::Boolean)
+      .Case("number", TypeOfIsType::Number)
+      .Case("function", TypeOfIsType::Function)
+      .Default(TypeOfIsType::_last);
+}
+
 /// A union of all instructions.
 LLVM_PACKED_START
 struct Inst {
@@ -88,6 +116,32 @@ struct Inst {
 };
 LLVM_PACKED_END
 
+/// \return the opcode that \p opCode is a quickened variant of, or \p opCode
+/// itself if it is not a quickened opcode.
+inline OpCode getUnquickenedOpCode(OpCode opCode) {
+  switch (opCode) {
+#define DEFINE_QUICKENED_VARIANT(name, quickName) \
+  case OpCode::quickName:                         \
+    return OpCode::name;
+#include "hermes/BCGen/HBC/BytecodeList.def"
+    default:
+      return opCode;
+  }
+}
+
+/// \return the quickened variant of \p opCode, or \p opCode itself if it has
+/// none.
+inline OpCode getQuickenedOpCode(OpCode opCode) {
+  switch (opCode) {
+#define DEFINE_QUICKENED_VARIANT(name, quickName) \
+  case OpCode::name:                              \
+    return OpCode::quickName;
+#include "hermes/BCGen/HBC/BytecodeList.def"
+    default:
+      return opCode;
+  }
+}
+
 } // namespace inst
 } // namespace hermes
 
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_OPTIMIZER_SCALAR_CJSCONSTANTEXPORTS_H
+#define HERMES_OPTIMIZER_SCALAR_CJSCONSTANTEXPORTS_H
+
+#include "hermes/IR/IR.h"
+#include "hermes/Optimizer/PassManager/Pass.h"
+
+namespace hermes {
+
+/// Replace the loads of the properties of the exports object of CJS modules,
+/// in the module and in the modules requiring it, with the literal stored to
+/// the property when the module starts. This runs once the require() calls
+/// are resolved statically, so that all the users of the exports are known.
+class CJSConstantExports : public ModulePass {
+ public:
+  explicit CJSConstantExports() : ModulePass("CJSConstantExports") {}
+  ~CJSConstantExports() override = default;
+
+  bool runOnModule(Module *M) override;
+};
+
+} // namespace hermes
+
+#endif // HERMES_OPTIMIZER_SCALAR_CJSCONSTANTEXPORTS_H
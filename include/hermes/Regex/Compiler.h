@@ -298,6 +298,47 @@ class Node {
     return false;
   }
 
+  /// If this node always matches a fixed string, append it to \p prefix and
+  /// \return true, so that a literal prefix may continue with the next node.
+  /// Nodes that match the empty string without looking at the input append
+  /// nothing and return true.
+  virtual bool appendLiteralPrefix(std::vector<char16_t> &prefix) const {
+    return false;
+  }
+
+  /// \return whether the node can be run without backtracking, by tracking
+  /// every way that a match may proceed at once. That cannot evaluate
+  /// backreferences or lookaheads, nor loops whose iterations would have to be
+  /// counted.
+  virtual bool canMatchInLinearTime() const {
+    return true;
+  }
+
+  /// \return whether every node in \p nodes can be run without backtracking.
+  static bool canMatchListInLinearTime(const NodeList &nodes) {
+    for (const auto &node : nodes) {
+      if (!node->canMatchInLinearTime())
+        return false;
+    }
+    return true;
+  }
+
+  /// \return whether the node contains a loop over more than a single
+  /// character. Backtracking through those can take time exponential in the
+  /// length of the input, e.g. for /(a|a)*b/.
+  virtual bool containsComplexLoop() const {
+    return false;
+  }
+
+  /// \return whether any node in \p nodes contains a complex loop.
+  static bool listContainsComplexLoop(const NodeList &nodes) {
+    for (const auto &node : nodes) {
+      if (node->containsComplexLoop())
+        return true;
+    }
+    return false;
+  }
+
  protected:
   /// \return the match constraints for this node.
   /// This should be overridden by subclasses to report the constraints for that
@@ -349,6 +390,10 @@ class LoopNode final : public Node {
   /// The constraints on what the loopee can match.
   MatchConstraintSet loopeeConstraints_;
 
+  /// Largest number of iterations of a width 1 loop that is tracked when
+  /// running without backtracking; see canMatchInLinearTime().
+  static constexpr uint32_t kMaxLinearTimeIterations = 32;
+
  public:
   /// Construct a LoopNode with the given \p loopId.
   /// A successful loop executes at least \p min times but not more than \p max
@@ -384,6 +429,29 @@ class LoopNode final : public Node {
     return result | Super::matchConstraints();
   }
 
+  virtual bool canMatchInLinearTime() const override {
+    if (!canMatchListInLinearTime(loopee_))
+      return false;
+    if (isWidth1Loop()) {
+      // Each number of iterations that can still make a difference is tracked
+      // separately.
+      uint32_t bound =
+          max_ == std::numeric_limits<uint32_t>::max() ? min_ : max_;
+      return bound <= kMaxLinearTimeIterations;
+    }
+    if (isSimpleLoop())
+      return true;
+    // Other loops are supported if they need no iteration count, and no check
+    // for iterations that match the empty string.
+    return min_ <= 1 &&
+        (max_ == 1 || max_ == std::numeric_limits<uint32_t>::max()) &&
+        (loopeeConstraints_ & MatchConstraintNonEmpty);
+  }
+
+  virtual bool containsComplexLoop() const override {
+    return !isWidth1Loop();
+  }
+
  private:
   /// Override of emit() to compile our looped expression and add a jump
   /// back to the loop.
@@ -481,6 +549,15 @@ class AlternationNode final : public Node {
     return result | Super::matchConstraints();
   }
 
+  virtual bool canMatchInLinearTime() const override {
+    return canMatchListInLinearTime(first_) &&
+        canMatchListInLinearTime(second_);
+  }
+
+  virtual bool containsComplexLoop() const override {
+    return listContainsComplexLoop(first_) || listContainsComplexLoop(second_);
+  }
+
   void emit(RegexBytecodeStream &bcs) const override {
     // Instruction stream looks like:
     //   [Alternation][PrimaryBranch][Jump][SecondaryBranch][...]
@@ -508,6 +585,11 @@ class BeginMarkedSubexpressionNode final : public Node {
  public:
   explicit BeginMarkedSubexpressionNode(unsigned mexp) : mexp_(mexp) {}
 
+  virtual bool appendLiteralPrefix(
+      std::vector<char16_t> &prefix) const override {
+    return true;
+  }
+
   virtual void emit(RegexBytecodeStream &bcs) const override {
     assert(static_cast<uint16_t>(mexp_) == mexp_ && "Subexpression too large");
     bcs.emit<BeginMarkedSubexpressionInsn>()->mexp =
@@ -526,6 +608,11 @@ class EndMarkedSubexpressionNode final : public Node {
  public:
   explicit EndMarkedSubexpressionNode(unsigned mexp) : mexp_(mexp) {}
 
+  virtual bool appendLiteralPrefix(
+      std::vector<char16_t> &prefix) const override {
+    return true;
+  }
+
   virtual void emit(RegexBytecodeStream &bcs) const override {
     assert(static_cast<uint16_t>(mexp_) == mexp_ && "Subexpression too large");
     bcs.emit<EndMarkedSubexpressionInsn>()->mexp = static_cast<uint16_t>(mexp_);
@@ -540,6 +627,10 @@ class BackRefNode final : public Node {
  public:
   explicit BackRefNode(unsigned mexp) : mexp_(mexp) {}
 
+  virtual bool canMatchInLinearTime() const override {
+    return false;
+  }
+
   virtual void emit(RegexBytecodeStream &bcs) const override {
     assert(mexp_ > 0 && "Subexpression cannot be zero");
     assert(static_cast<uint16_t>(mexp_) == mexp_ && "Subexpression too large");
@@ -646,6 +737,12 @@ class MatchCharNode final : public Node {
   virtual bool matchesExactlyOneCharacter() const override {
     return true;
   }
+
+  virtual bool appendLiteralPrefix(
+      std::vector<char16_t> &prefix) const override {
+    prefix.push_back(c_);
+    return true;
+  }
 };
 
 /// MatchCharICase matches a single character, ignoring case.
@@ -893,6 +990,23 @@ class Regex {
                                   static_cast<uint16_t>(loopCount_),
                                   flags_,
                                   matchConstraints_};
+    // Record the literal characters that every match starts with. The first
+    // node is the no-op node that starts every list.
+    std::vector<char16_t> prefix;
+    for (auto it = nodes_.begin() + 1, e = nodes_.end(); it != e; ++it) {
+      if (prefix.size() >= RegexBytecodeHeader::kMaxPrefixLength ||
+          !(*it)->appendLiteralPrefix(prefix))
+        break;
+    }
+    header.prefixLength = prefix.size() < RegexBytecodeHeader::kMaxPrefixLength
+        ? prefix.size()
+        : RegexBytecodeHeader::kMaxPrefixLength;
+    std::copy(
+        prefix.begin(), prefix.begin() + header.prefixLength, header.prefix);
+    // Regexes without complex loops are left to the backtracker, which is
+    // faster for them.
+    header.linearTime = Node::listContainsComplexLoop(nodes_) &&
+        Node::canMatchListInLinearTime(nodes_);
     RegexBytecodeStream bcs(header);
     Node::compile(nodes_, bcs);
     return bcs.acquireBytecode();
@@ -1020,6 +1134,10 @@ class LookaheadNode : public Node {
     return result | Super::matchConstraints();
   }
 
+  virtual bool canMatchInLinearTime() const override {
+    return false;
+  }
+
   // Override emit() to compile our lookahead expression.
   virtual void emit(RegexBytecodeStream &bcs) const override {
     auto lookahead = bcs.emit<LookaheadInsn>();
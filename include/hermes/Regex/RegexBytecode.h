@@ -222,6 +222,21 @@ struct RegexBytecodeHeader {
 
   /// Constraints on what strings can match this regex.
   MatchConstraintSet constraints;
+
+  /// Whether searches track every way a match may proceed at once instead of
+  /// backtracking, which takes time linear in the length of the input. Only
+  /// set for programs where this gives the same result.
+  uint8_t linearTime;
+
+  /// Maximum number of characters of the literal prefix kept in the header.
+  static constexpr uint8_t kMaxPrefixLength = 8;
+
+  /// Number of characters in \c prefix.
+  uint8_t prefixLength;
+
+  /// Characters that every match starts with. A search only tries to match at
+  /// the positions where they occur.
+  char16_t prefix[kMaxPrefixLength];
 };
 
 LLVM_PACKED_END;
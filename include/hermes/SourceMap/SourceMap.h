@@ -9,8 +9,10 @@
 
 #include "hermes/Support/OptValue.h"
 
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <memory>
 #include <vector>
 
 namespace hermes {
@@ -87,13 +89,33 @@ class SourceMap {
   };
   using SegmentList = std::vector<Segment>;
 
+  /// The delta encoding state of the "mappings" at the start of a generated
+  /// line. The generated column is reset on every line, the other fields
+  /// carry over from the last segment of the previous lines.
+  struct LineStart {
+    /// Offset of the first segment of the line in the mappings.
+    uint32_t offset;
+    int32_t sourceIndex;
+    int32_t lineIndex;
+    int32_t columnIndex;
+  };
+
+  /// Construct a source map whose \p mappings are decoded a line at a time,
+  /// the first time a location on the line is looked up. \p lineStarts holds
+  /// the state at the start of each line, and the mappings must have been
+  /// validated when it was computed.
   SourceMap(
       const std::string &sourceRoot,
       std::vector<std::string> &&sources,
-      std::vector<SegmentList> &&lines)
+      std::string &&mappings,
+      std::vector<LineStart> &&lineStarts)
       : sourceRoot_(sourceRoot),
         sources_(std::move(sources)),
-        lines_(std::move(lines)) {}
+        mappings_(std::move(mappings)),
+        lineStarts_(std::move(lineStarts)),
+        decodedLines_(
+            lineStarts_.size(),
+            std::make_pair(kNotDecoded, uint32_t(0))) {}
 
   /// Query source map text location for \p line and \p column.
   /// In both the input and output of this function, Line and column numbers
@@ -112,7 +134,70 @@ class SourceMap {
     return sourceFullPath;
   }
 
+  /// \return the number of generated lines.
+  uint32_t getNumLines() const {
+    return index_ ? index_->numLines : lineStarts_.size();
+  }
+
+  /// Write the sources and the decoded segments of every line to \p OS in
+  /// the binary index format, which SourceMapParser::parseIndex() reads back
+  /// without decoding anything. The index can only be read by hosts of the
+  /// byte order of the one that wrote it.
+  void writeIndex(llvm::raw_ostream &OS);
+
  private:
+  friend class SourceMapParser;
+
+  /// The header of the binary index. It is followed by \c numLines + 1
+  /// uint32_t, the index of the first segment of each line and the total
+  /// number of segments, then by four int32_t columns of \c numSegments
+  /// values: the generated column, the source index (-1 if unmapped), the
+  /// represented line and the represented column of every segment. The
+  /// source root and the sources come last, each as a uint32_t length
+  /// followed by its characters, padded to a multiple of 4 bytes.
+  struct IndexHeader {
+    /// kIndexMagic.
+    char magic[8];
+    /// kIndexByteOrder, as written by the host that made the index.
+    uint32_t byteOrder;
+    uint32_t numSources;
+    uint32_t numLines;
+    uint32_t numSegments;
+  };
+  static constexpr char kIndexMagic[8] =
+      {'H', 'S', 'M', 'I', 'N', 'D', 'E', 'X'};
+  static constexpr uint32_t kIndexByteOrder = 0x01020304;
+
+  /// Construct a source map that reads its segments from the binary index
+  /// \p index in \p buffer, which has been validated, with the sources that
+  /// were read from it.
+  SourceMap(
+      std::string &&sourceRoot,
+      std::vector<std::string> &&sources,
+      std::unique_ptr<llvm::MemoryBuffer> buffer,
+      const IndexHeader *index)
+      : sourceRoot_(std::move(sourceRoot)),
+        sources_(std::move(sources)),
+        indexBuffer_(std::move(buffer)),
+        index_(index) {}
+
+  /// The decoded segments of a line, in columns.
+  struct LineView {
+    const int32_t *generatedColumn;
+    const int32_t *sourceIndex;
+    const int32_t *lineIndex;
+    const int32_t *columnIndex;
+    uint32_t size;
+  };
+
+  /// \return the segments of the 0-based \p lineIndex, decoding them if
+  /// needed. The view is invalidated by the decoding of another line.
+  LineView getLine(uint32_t lineIndex);
+
+  /// Decode the segments of the 0-based \p lineIndex and append them to the
+  /// columns.
+  void decodeLine(uint32_t lineIndex);
+
   /// \return source file path with root combined for source \p index.
   std::string getSourceFullPath(uint32_t index) const {
     assert(index < sources_.size() && "index out-of-range for sources_");
@@ -130,8 +215,27 @@ class SourceMap {
   /// appended.
   std::vector<std::string> sources_;
 
-  /// The list of segments in VLQ scheme.
-  std::vector<SegmentList> lines_;
+  /// The "mappings" in VLQ scheme, which are decoded lazily.
+  std::string mappings_{};
+
+  /// The decoding state at the start of each line of mappings_.
+  std::vector<LineStart> lineStarts_{};
+
+  /// For each line, the index of its first segment in the columns and the
+  /// number of its segments. The index is kNotDecoded until it is decoded.
+  std::vector<std::pair<uint32_t, uint32_t>> decodedLines_{};
+  static constexpr uint32_t kNotDecoded = UINT32_MAX;
+
+  /// The segments of the decoded lines, in the order they were decoded.
+  std::vector<int32_t> generatedColumns_{};
+  std::vector<int32_t> sourceIndices_{};
+  std::vector<int32_t> lineIndices_{};
+  std::vector<int32_t> columnIndices_{};
+
+  /// The binary index, if this source map was read from one. The mappings
+  /// and the columns above are empty then.
+  std::unique_ptr<llvm::MemoryBuffer> indexBuffer_{};
+  const IndexHeader *index_{nullptr};
 };
 
 } // namespace hermes
@@ -20,6 +20,13 @@ class SourceMapParser {
   /// Return nullptr on failure if malformed.
   static std::unique_ptr<SourceMap> parse(llvm::StringRef sourceMapContent);
 
+  /// Read the binary index that SourceMap::writeIndex() wrote to \p buffer,
+  /// which is typically a file mapped in memory. The segments are looked up
+  /// in place, so the source map keeps the buffer.
+  /// Return nullptr on failure if malformed.
+  static std::unique_ptr<SourceMap> parseIndex(
+      std::unique_ptr<llvm::MemoryBuffer> buffer);
+
  private:
   /// Delta encoding state.
   struct State {
@@ -30,11 +37,13 @@ class SourceMapParser {
     int32_t nameIndex = 0;
   };
 
-  /// Parse "mappings" section from \p sourceMappings. The parsed line mappings
-  /// are returned in \p lines.
+  /// Validate the "mappings" section \p sourceMappings, whose segments must
+  /// refer to fewer than \p numSources sources. The decoding state at the
+  /// start of each line is returned in \p lineStarts.
   static bool parseMappings(
       llvm::StringRef sourceMappings,
-      std::vector<SourceMap::SegmentList> &lines);
+      size_t numSources,
+      std::vector<SourceMap::LineStart> &lineStarts);
 
   /// Parse single segment in mapping.
   static llvm::Optional<SourceMap::Segment>
@@ -153,6 +153,22 @@ const size_t NUMBER_TO_STRING_BUF_SIZE = 32;
 /// \return the length of the generated string (excluding the terminating zero).
 size_t numberToString(double m, char *dest, size_t destSize);
 
+/// Parse the decimal number at the start of [\p begin, \p end): an optional
+/// sign, digits with an optional fraction, and an optional exponent, in the
+/// syntax accepted by strtod(). Only numbers whose value can be computed
+/// exactly with a single floating point operation are handled: at most 19
+/// significant digits whose value fits in 53 bits, scaled by an exactly
+/// representable power of ten.
+/// \param[out] parsedEnd set to the end of the number on success.
+/// \return the correctly rounded value, or None if there is no number or it
+/// needs the general conversion in g_strtod().
+OptValue<double>
+parseDecimalFast(const char *begin, const char *end, const char **parsedEnd);
+OptValue<double> parseDecimalFast(
+    const char16_t *begin,
+    const char16_t *end,
+    const char16_t **parsedEnd);
+
 /// Takes a letter (a-z or A-Z) and makes it lowercase.
 inline char charLetterToLower(char ch) {
   return ch | 32;
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_SUPPORT_FASTDTOA_H
+#define HERMES_SUPPORT_FASTDTOA_H
+
+namespace hermes {
+
+/// Size of the buffer that must be passed to fastShortestDtoa(). The shortest
+/// representation of a double has at most 17 digits.
+constexpr unsigned FAST_DTOA_BUF_SIZE = 18;
+
+/// Find the shortest string of decimal digits which converts back to \p v,
+/// choosing the one closest to \p v if there are several, like g_dtoa() in
+/// mode 0. This uses the Grisu3 algorithm by Florian Loitsch ("Printing
+/// Floating-Point Numbers Quickly and Accurately with Integers"), which only
+/// needs 64-bit integer arithmetic but gives up on about 0.5% of the inputs,
+/// when it can't prove that its result is the correct one.
+/// \param v the number to convert. It must be finite and positive.
+/// \param digits the buffer receiving the digits, which is not
+///   zero-terminated. It must hold at least FAST_DTOA_BUF_SIZE characters.
+/// \param[out] length the number of digits.
+/// \param[out] decimalPoint the position of the decimal point relative to the
+///   start of the digits, so that v is 0.digits * 10^decimalPoint.
+/// \return true on success, false if the caller must use another algorithm.
+bool fastShortestDtoa(double v, char *digits, int *length, int *decimalPoint);
+
+} // namespace hermes
+
+#endif // HERMES_SUPPORT_FASTDTOA_H
@@ -7,45 +7,120 @@
 #ifndef HERMES_SUPPORT_HASHSTRING_H
 #define HERMES_SUPPORT_HASHSTRING_H
 
-#include "hermes/Support/JenkinsHash.h"
-
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/Endian.h"
+
+#include <cstdint>
+#include <type_traits>
 
 namespace hermes {
 
+namespace hash_details {
+/// The odd multiplier used to mix every block, from the golden ratio.
+constexpr uint64_t kHashMultiplier = 0x9e3779b97f4a7c15ull;
+
+/// Number of characters hashed together in a block.
+constexpr size_t kCharsPerBlock = 4;
+
+/// Incorporates a block of up to four UTF-16 code units, the first one in the
+/// low bits, into \p hash.
+constexpr uint64_t mixBlock(uint64_t hash, uint64_t block) {
+  return (((hash << 5) | (hash >> 59)) ^ block) * kHashMultiplier;
+}
+
+/// \return the final 32-bit hash of \p length characters from \p hash.
+constexpr uint32_t finishHash(uint64_t hash, size_t length) {
+  // The multiplication only mixes upwards, so keep the high bits.
+  return static_cast<uint32_t>(mixBlock(hash, length) >> 32);
+}
+
+/// \return the block of four UTF-16 code units at \p str.
+inline uint64_t loadBlock(const char16_t *str) {
+  return static_cast<uint64_t>(str[0]) |
+      (static_cast<uint64_t>(str[1]) << 16) |
+      (static_cast<uint64_t>(str[2]) << 32) |
+      (static_cast<uint64_t>(str[3]) << 48);
+}
+
+/// \return the block of four ASCII characters at \p str, widened to UTF-16
+/// code units in a register.
+inline uint64_t loadBlock(const char *str) {
+  uint64_t block = llvm::support::endian::read32le(str);
+  block = (block | (block << 16)) & 0x0000ffff0000ffffull;
+  return (block | (block << 8)) & 0x00ff00ff00ff00ffull;
+}
+
+/// \return the block of the last \p count (less than four) characters of
+/// \p str, padded with zeros.
+template <typename T>
+inline uint64_t loadPartialBlock(const T *str, size_t count) {
+  uint64_t block = 0;
+  for (size_t i = 0; i < count; ++i) {
+    block |= static_cast<uint64_t>(
+                 static_cast<typename std::make_unsigned<T>::type>(str[i]))
+        << (16 * i);
+  }
+  return block;
+}
+} // namespace hash_details
+
 /// Computes a hash of \p str that must be stable between compilation and
 /// execution of the compiled bytecode.
-/// Use the Jenkins hash for now, but that may be changed internally later.
 ///
-/// We cannot directly call llvm::hash_value(str) because each element of
-/// str can be either char or char16_t. The default iterator of
-/// llvm::ArrayRef will return different types for each element, leading to
-/// different hash values even when an ASCII string has the same content as
-/// an UTF16 string. hashString() takes advantage of the abstraction of
-/// StringView::const_iterator to always return char16_t in the iterator.
+/// An ASCII string and a UTF-16 string with the same contents have the same
+/// hash. The characters are hashed four at a time as UTF-16 code units packed
+/// into 64 bits, with ASCII characters widened in a register. A classic
+/// character-at-a-time hash such as Jenkins' can't be computed any faster than
+/// one dependent step per character.
 ///
 /// NOTE: If hashString is changed, the bytecode version must be bumped.
 template <typename T>
 uint32_t hashString(llvm::ArrayRef<T> str) {
   static_assert(
-      sizeof(JenkinsHash) == sizeof(uint32_t), "Jenkins Hash must be 32-bit");
-  hermes::JenkinsHash hash = 0;
-  for (const T c : str) {
-    hash = hermes::updateJenkinsHash(hash, c);
+      sizeof(T) <= sizeof(char16_t), "hashString only hashes characters");
+  using namespace hash_details;
+  const T *ptr = str.data();
+  size_t numBlocks = str.size() / kCharsPerBlock;
+  uint64_t hash = 0;
+  for (size_t i = 0; i < numBlocks; ++i, ptr += kCharsPerBlock) {
+    hash = mixBlock(hash, loadBlock(ptr));
   }
-  return hash;
+  size_t rest = str.size() % kCharsPerBlock;
+  if (rest)
+    hash = mixBlock(hash, loadPartialBlock(ptr, rest));
+  return finishHash(hash, str.size());
 }
 
 namespace hash_details {
-template <std::size_t Count>
-constexpr uint32_t constexprHashStringHelper(const char *str) {
-  return hermes::updateJenkinsHash(
-      constexprHashStringHelper<Count - 1>(str), str[Count - 1]);
+/// \return the code unit at \p index of the \p length characters at \p str,
+/// or 0 past the end.
+constexpr uint64_t constexprCharAt(
+    const char *str,
+    size_t index,
+    size_t length) {
+  return index < length ? static_cast<unsigned char>(str[index]) : 0;
+}
+
+constexpr uint64_t
+constexprBlockAt(const char *str, size_t index, size_t length) {
+  return constexprCharAt(str, index, length) |
+      (constexprCharAt(str, index + 1, length) << 16) |
+      (constexprCharAt(str, index + 2, length) << 32) |
+      (constexprCharAt(str, index + 3, length) << 48);
 }
 
-template <>
-constexpr uint32_t constexprHashStringHelper<0>(const char *str) {
-  return 0;
+constexpr uint64_t constexprHashBlocks(
+    const char *str,
+    size_t index,
+    size_t length,
+    uint64_t hash) {
+  return index >= length
+      ? hash
+      : constexprHashBlocks(
+            str,
+            index + kCharsPerBlock,
+            length,
+            mixBlock(hash, constexprBlockAt(str, index, length)));
 }
 } // namespace hash_details
 
@@ -53,7 +128,8 @@ constexpr uint32_t constexprHashStringHelper<0>(const char *str) {
 template <std::size_t Count>
 constexpr uint32_t constexprHashString(const char (&str)[Count]) {
   // Count-1 accounts for terminating NUL.
-  return hash_details::constexprHashStringHelper<Count - 1>(str);
+  return hash_details::finishHash(
+      hash_details::constexprHashBlocks(str, 0, Count - 1, 0), Count - 1);
 }
 
 } // namespace hermes
@@ -91,7 +91,9 @@ void vm_prefetch(void *p, size_t sz);
 /// for a process (e.g. by /proc/<pid>/maps).
 void vm_name(void *p, size_t sz, const char *name);
 
-enum class ProtectMode { ReadWrite };
+/// ReadWrite makes the memory accessible, None makes every access to it
+/// fault, as for a guard page.
+enum class ProtectMode { ReadWrite, None };
 
 /// Set the \p sz byte region of memory starting at \p p to the specified
 /// \p mode. \p p must be page-aligned. \return true if successful,
@@ -100,9 +102,15 @@ bool vm_protect(void *p, size_t sz, ProtectMode mode);
 
 /// Issue an madvise() call.
 /// \return true on success, false on error.
-enum class MAdvice { Random, Sequential };
+enum class MAdvice { Random, Sequential, HugePage };
 bool vm_madvise(void *p, size_t sz, MAdvice advice);
 
+/// Ask the OS to allocate the pages of the \p sz byte region of memory
+/// starting at \p p on the NUMA node of the thread that first touches them.
+/// \p p must be page-aligned.
+/// \return true on success, false on error (including not supported).
+bool vm_bind_local(void *p, size_t sz);
+
 /// Return the number of pages in the given region that are currently in RAM.
 /// If \p runs is provided, then populate it with the lengths of runs of
 /// consecutive pages with the same resident/non-resident status, alternating
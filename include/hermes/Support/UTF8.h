@@ -50,13 +50,55 @@ inline bool isAllASCII(Iter begin, Iter end) {
   return true;
 }
 
+/// \return a pointer to the first byte in [start, end) that is not ASCII, or
+/// \p end if there is none. Uses vector instructions when they are available.
+const uint8_t *findFirstNonASCII(const uint8_t *start, const uint8_t *end);
+
+/// \return a pointer to the first character in [start, end) that is not
+/// ASCII, or \p end if there is none.
+const char16_t *findFirstNonASCII(const char16_t *start, const char16_t *end);
+
 /// Overload for char* and uint8_t*.
-bool isAllASCII(const uint8_t *start, const uint8_t *end);
+inline bool isAllASCII(const uint8_t *start, const uint8_t *end) {
+  return findFirstNonASCII(start, end) == end;
+}
 
 inline bool isAllASCII(const char *start, const char *end) {
   return isAllASCII((const uint8_t *)start, (const uint8_t *)end);
 }
 
+/// Overload for char16_t*.
+inline bool isAllASCII(const char16_t *start, const char16_t *end) {
+  return findFirstNonASCII(start, end) == end;
+}
+
+/// Copy the \p length ASCII characters at \p src to the UTF-16 buffer \p dst.
+void widenASCII(const char *src, size_t length, char16_t *dst);
+
+/// Copy the \p length UTF-16 characters at \p src, which must all be ASCII,
+/// to \p dst.
+void narrowASCII(const char16_t *src, size_t length, char *dst);
+
+/// \return a pointer to the first character in [start, end) that is an ASCII
+/// letter changed by converting it to upper case if \p toUpper, or to lower
+/// case otherwise, or \p end if there is none.
+const char *
+findFirstASCIICaseChange(const char *start, const char *end, bool toUpper);
+const char16_t *findFirstASCIICaseChange(
+    const char16_t *start,
+    const char16_t *end,
+    bool toUpper);
+
+/// Copy the \p length characters at \p src to \p dst, converting ASCII
+/// letters to upper case if \p toUpper, or to lower case otherwise. All other
+/// characters are copied unchanged. \p src and \p dst may be equal.
+void convertASCIICase(const char *src, size_t length, char *dst, bool toUpper);
+void convertASCIICase(
+    const char16_t *src,
+    size_t length,
+    char16_t *dst,
+    bool toUpper);
+
 /// Decode a sequence of UTF8 encoded bytes when it is known that the first byte
 /// is a start of an UTF8 sequence.
 /// \param allowSurrogates when false, values in the surrogate range are
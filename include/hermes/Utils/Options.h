@@ -7,6 +7,10 @@
 #ifndef HERMES_UTILS_OPTIONS_H
 #define HERMES_UTILS_OPTIONS_H
 
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
 namespace hermes {
 
 enum OutputFormatKind {
@@ -53,6 +57,20 @@ struct BytecodeGenerationOptions {
   /// Add this much garbage after each function body (relative to its size).
   unsigned padFunctionBodiesPercent = 0;
 
+  /// Functions which get the first function IDs, in this order, so that they
+  /// are placed first in the bytecode file. Typically the functions run during
+  /// startup. Functions are identified by the IDs they get when this is empty.
+  std::vector<uint32_t> functionLayoutOrder{};
+
+  /// Whether to emit a compressed container, in which the bodies of the
+  /// functions which are not in functionLayoutOrder are compressed.
+  bool compressColdFunctions = false;
+
+  /// The bytecode offsets of the instructions, by function ID, which only saw
+  /// number operands in a profiled run. They are emitted as their quickened
+  /// variants, which check for numbers and otherwise take the generic path.
+  std::unordered_map<uint32_t, std::vector<uint32_t>> numberSites{};
+
   /* implicit */ BytecodeGenerationOptions(OutputFormatKind format)
       : format(format) {}
 
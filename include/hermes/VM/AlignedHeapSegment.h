@@ -22,6 +22,7 @@
 
 #include "llvm/Support/MathExtras.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <vector>
 
@@ -56,6 +57,7 @@ class GCGeneration;
 class AlignedHeapSegment final {
   friend CompactionResult::Allocator;
   friend CompactionResult::Chunk;
+  friend struct RuntimeOffsets;
 
  public:
   /// Construct a null AlignedHeapSegment (one that does not own memory).
@@ -220,6 +222,24 @@ class AlignedHeapSegment final {
   template <AdviseUnused MU = AdviseUnused::No>
   void resetLevel();
 
+  /// Return the pages of the storage above the level to the OS, whether or
+  /// not this segment's allocation region extends that far. Debug builds keep
+  /// the pages, to detect writes into them.
+  /// \return the number of bytes returned.
+  size_t adviseUnused();
+
+  /// Note the current level as reached. Levels only rise between
+  /// collections, so noting them as each collection starts tracks the peak.
+  void notePeakLevel() {
+    peakLevel_ = std::max(peakLevel_, level_);
+  }
+
+  /// Return the pages of the storage above the highest level noted since the
+  /// previous call to the OS, since they stayed unused all along, and start
+  /// tracking the peak again from the current level.
+  /// \return the number of bytes returned.
+  size_t adviseUnreached();
+
   /// Increase the size of the allocation region in this segment by the minimum
   /// amount such that this.size() >= desired.
   ///
@@ -265,7 +285,16 @@ class AlignedHeapSegment final {
   /// Sequences of dead objects have a DeadRegion containing a pointer to the
   /// next live object inserted, allowing them to be skipped efficiently n
   /// subsequent heap traversals.
-  void sweepAndInstallForwardingPointers(GC *gc, SweepResult *sweepResult);
+  ///
+  /// If \p inPlaceLivePercent is non-zero, nothing has been compacted into
+  /// this segment yet, and at least that percentage of its used bytes is
+  /// live, the live objects are not moved at all.  Instead, the gaps between
+  /// them are filled with FillerCells, which are marked, so that the rest of
+  /// the collection treats them as live objects that stay where they are.
+  void sweepAndInstallForwardingPointers(
+      GC *gc,
+      SweepResult *sweepResult,
+      unsigned inPlaceLivePercent = 0);
 
   /// Assumes sweeping is complete.  Traverses the live objects, scanning their
   /// pointers.  For each pointer to another heap object, update the pointer by
@@ -333,10 +362,24 @@ class AlignedHeapSegment final {
   /// segment.
   inline Contents *contents() const;
 
+  /// \return true if at least \p livePercent of the used bytes of this
+  /// segment are in marked cells, and every gap between marked cells is large
+  /// enough for a FillerCell.
+  bool canSweepInPlace(unsigned livePercent) const;
+
+  /// Return the pages of the storage from \p from, rounded up to a page
+  /// boundary, to the OS.
+  /// \return the number of bytes returned.
+  size_t adviseUnusedFrom(char *from);
+
   AlignedStorage storage_;
 
   char *level_{start()};
 
+  /// The highest level noted by notePeakLevel() since the previous call of
+  /// adviseUnreached().
+  char *peakLevel_{start()};
+
   /// The upper limit of the space that we can currently allocated into;
   /// this may be decreased when externally allocated memory is credited to
   /// the generation owning this space.
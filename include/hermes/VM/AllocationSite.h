@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_VM_ALLOCATIONSITE_H
+#define HERMES_VM_ALLOCATIONSITE_H
+
+#include <cstdint>
+
+namespace hermes {
+namespace vm {
+
+/// Survival feedback for a site that allocates objects, such as an array or
+/// object literal. The collector samples the objects allocated by the site and
+/// reports whether they survived their first young generation collection. Once
+/// enough of them did, objects from the site are allocated directly in the old
+/// generation ("pretenured"), which avoids copying them out of the young
+/// generation.
+struct AllocationSiteInfo {
+  /// Number of outcomes needed before a decision is made.
+  static constexpr uint32_t kMinSamples = 16;
+
+  /// Percentage of the sampled objects that must have survived for the site
+  /// to be pretenured.
+  static constexpr uint32_t kPretenureSurvivalPercent = 90;
+
+  /// Number of sampled objects whose outcome is known, in the current window.
+  uint32_t numSampled{0};
+
+  /// Number of sampled objects that survived, in the current window.
+  uint32_t numSurvived{0};
+
+  /// Whether objects from this site should be allocated in the old generation.
+  /// Once set, the site is no longer sampled and the decision is permanent.
+  bool pretenure{false};
+
+  /// Record whether a sampled object survived its first collection.
+  void recordOutcome(bool survived) {
+    ++numSampled;
+    numSurvived += survived;
+    if (numSampled < kMinSamples)
+      return;
+    if (numSurvived * 100 >= numSampled * kPretenureSurvivalPercent) {
+      pretenure = true;
+    } else {
+      // Start a new window, so that a site whose objects start surviving later
+      // (e.g. once startup is over) is still noticed.
+      numSampled = 0;
+      numSurvived = 0;
+    }
+  }
+};
+
+/// Size feedback for the objects created as `this` by a constructor
+/// ("slack tracking"). The final number of properties of the first few
+/// instances is recorded when the constructor returns. After that, the
+/// property storage of new instances is allocated up front with room for the
+/// largest of them, instead of being grown as the constructor adds properties.
+struct ConstructorSlackInfo {
+  /// Number of instances observed before the size is fixed.
+  static constexpr uint32_t kNumSamples = 8;
+
+  /// Number of instances observed so far.
+  uint32_t numSampled{0};
+
+  /// Largest number of properties of an observed instance.
+  uint32_t maxProperties{0};
+
+  /// \return true while instances are still being observed.
+  bool isTracking() const {
+    return numSampled < kNumSamples;
+  }
+
+  /// Record that an instance finished construction with \p numProperties.
+  void recordInstance(uint32_t numProperties) {
+    ++numSampled;
+    if (numProperties > maxProperties)
+      maxProperties = numProperties;
+  }
+
+  /// \return the number of properties new instances should have room for, or
+  /// 0 while there is no decision yet.
+  uint32_t expectedProperties() const {
+    return isTracking() ? 0 : maxProperties;
+  }
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_ALLOCATIONSITE_H
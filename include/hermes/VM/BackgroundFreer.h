@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_VM_BACKGROUNDFREER_H
+#define HERMES_VM_BACKGROUNDFREER_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+/// Frees malloc'ed memory on a background thread.  Finalizers of cells that
+/// own large native buffers hand them over during a collection, so that the
+/// pause does not include returning them to the allocator (and possibly the
+/// OS).  Only memory that nothing else refers to may be handed over: freeing
+/// it must have no effect visible to JS.
+///
+/// The memory handed over by enqueue is batched, and passed to the thread by
+/// flush, which collectors call at the end of every collection.  The thread
+/// is started on the first flush.
+class BackgroundFreer {
+ public:
+  BackgroundFreer() = default;
+
+  /// Stops the thread, and frees everything that has not been freed yet.
+  ~BackgroundFreer();
+
+  BackgroundFreer(const BackgroundFreer &) = delete;
+  BackgroundFreer &operator=(const BackgroundFreer &) = delete;
+
+  /// Free \p mem on the background thread, after the next flush.  Must only be
+  /// called from the thread that owns the heap.
+  void enqueue(void *mem) {
+    pending_.push_back(mem);
+  }
+
+  /// Pass everything enqueued so far to the background thread.
+  void flush();
+
+ private:
+  /// Body of the background thread.
+  void run();
+
+  /// Enqueued, but not yet flushed.  Only accessed by the heap's thread.
+  std::vector<void *> pending_;
+
+  /// Guards queue_ and stop_.
+  std::mutex mutex_;
+  std::condition_variable cond_;
+
+  /// Flushed, but not yet freed.
+  std::vector<void *> queue_;
+
+  /// Whether the thread should exit once queue_ is empty.
+  bool stop_{false};
+
+  std::thread thread_;
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_BACKGROUNDFREER_H
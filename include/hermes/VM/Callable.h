@@ -15,6 +15,8 @@
 namespace hermes {
 namespace vm {
 
+class JSFunction;
+
 /// Environment storing all escaping variables for a function.
 class Environment final
     : public VariableSizeRuntimeCell,
@@ -62,6 +64,15 @@ class Environment final
     return getSlots()[index];
   }
 
+  /// \return the offset in bytes of the first slot from the start of the
+  ///   object, for JIT compiled code which accesses the slots directly.
+  static constexpr uint32_t getSlotsOffset() {
+    static_assert(
+        alignof(Environment) >= alignof(GCHermesValue),
+        "slots must immediately follow the object");
+    return sizeof(Environment);
+  }
+
  private:
   /// \param parentEnvironment the parent lexical environment, or nullptr if the
   ///   parent is the global scope.
@@ -264,6 +275,19 @@ class Callable : public JSObject {
   /// creation has been delayed by lazy objects.
   static void defineLazyProperties(Handle<Callable> fn, Runtime *runtime);
 
+ private:
+  /// Define the lazy properties of \p jsFun by switching it to \p clazz, the
+  /// class that defineNameLengthAndPrototype() produced for an earlier
+  /// function of the same kind, and storing the values into its slots.
+  static void initializeFromFunctionClass(
+      Handle<JSFunction> jsFun,
+      Runtime *runtime,
+      Handle<HiddenClass> clazz,
+      SymbolID name,
+      unsigned paramCount,
+      Handle<JSObject> prototypeObjectHandle,
+      bool strictMode);
+
  protected:
   Callable(
       Runtime *runtime,
@@ -470,7 +494,9 @@ class NativeFunction : public Callable {
 #endif
 
     auto res =
-        self->functionPtr_(self->context_, runtime, newFrame.getNativeArgs());
+        LLVM_UNLIKELY(runtime->getRuntimeStats().nativeCallSamplingInterval)
+        ? _nativeCallWithStats(self, runtime, newFrame)
+        : self->functionPtr_(self->context_, runtime, newFrame.getNativeArgs());
 
 #ifdef HERMESVM_PROFILER_NATIVECALL
     self->callDuration_ = HERMESVM_RDTSC() - t1;
@@ -482,6 +508,14 @@ class NativeFunction : public Callable {
     return res;
   }
 
+  /// The slow path of _nativeCall() while native calls are counted: call the
+  /// function of \p self in \p newFrame, recording the call in the
+  /// RuntimeStats of \p runtime.
+  static CallResult<HermesValue> _nativeCallWithStats(
+      NativeFunction *self,
+      Runtime *runtime,
+      StackFramePtr newFrame);
+
   /// Create an instance of NativeFunction.
   /// \param parentHandle object to use as [[Prototype]].
   /// \param context the context to be passed to the function
@@ -628,6 +662,21 @@ class NativeConstructor final : public NativeFunction {
         targetKind));
   }
 
+  /// Create a lazy instance of NativeConstructor without any properties. It
+  /// must be registered with Runtime::registerLazyConstructor(), which will
+  /// define its properties the first time it is used.
+  static PseudoHandle<NativeConstructor> createLazy(
+      Runtime *runtime,
+      Handle<JSObject> parentHandle,
+      NativeFunctionPtr functionPtr,
+      CreatorFunction *creator,
+      CellKind targetKind) {
+    auto self = create(
+        runtime, parentHandle, nullptr, functionPtr, 0, creator, targetKind);
+    self.get()->flags_.lazyObject = 1;
+    return self;
+  }
+
   /// Create an instance of NativeConstructor.
   /// \param parentHandle object to use as [[Prototype]].
   /// \param parentEnvHandle the parent environment
@@ -833,6 +882,15 @@ class JSFunction : public Callable {
   static CallResult<HermesValue> _callImpl(
       Handle<Callable> selfHandle,
       Runtime *runtime);
+
+  /// Create the `this` object for a constructor call. Once the constructor's
+  /// slack tracking has settled, the property storage of the object is
+  /// allocated with room for the properties the constructor is expected to
+  /// add.
+  static CallResult<HermesValue> _newObjectImpl(
+      Handle<Callable> selfHandle,
+      Runtime *runtime,
+      Handle<JSObject> parentHandle);
 };
 
 /// A function which interprets code and returns a Generator when called.
@@ -1000,12 +1058,14 @@ class GeneratorInnerFunction final : public JSFunction {
   }
 
   /// Restores the stack variables needed to resume execution from a
-  /// SuspendedYield state.
+  /// SuspendedYield state, which are the ones stored by the last saveStack.
   void restoreStack(Runtime *runtime);
 
   /// Saves the stack variables needed to resume execution from a SuspendedYield
   /// state, and places them in an internal property.
-  void saveStack(Runtime *runtime);
+  /// \param numRegs the number of registers, starting from register 0, which
+  ///   are live at the resume point. The remaining registers are not saved.
+  void saveStack(Runtime *runtime, uint32_t numRegs);
 
   void setNextIP(const Inst *ip) {
     nextIPOffset_ = getCodeBlock()->getOffsetOf(ip);
@@ -1061,6 +1121,10 @@ class GeneratorInnerFunction final : public JSFunction {
   /// Saved as uint32_t instead of Inst * in order to save memory.
   uint32_t nextIPOffset_{0};
 
+  /// The number of frame slots stored in the context by the last saveStack,
+  /// counting from the top of the frame.
+  uint32_t savedFrameSize_{0};
+
   /// The action requested by the user by the way the generator is invoked.
   Action action_;
 
@@ -27,7 +27,13 @@ namespace vm {
 /// object whose extent [obj-start, end) contains the start of the card.  This
 /// allows us to scan dirty cards: finding the crossing object allows us to then
 /// do object-to-object traversal to the end of the card.
+///
+/// Every kCardsPerSummary consecutive cards also share an entry in a summary
+/// table, which is dirty if any of those cards may be dirty.  Searches for
+/// dirty cards consult it to skip wide clean ranges without reading them.
 class CardTable {
+  friend struct RuntimeOffsets;
+
  public:
   /// Points at the start of a card.
   class Boundary {
@@ -61,6 +67,18 @@ class CardTable {
   static constexpr size_t kValidIndices =
       AlignedStorage::size() >> kLogCardSize;
 
+  /// The number (and base-two log of the number) of cards summarized by one
+  /// entry of the summary table.
+  static constexpr size_t kLogCardsPerSummary = 6;
+  static constexpr size_t kCardsPerSummary = 1 << kLogCardsPerSummary;
+
+  /// The number of entries in the summary table.
+  static constexpr size_t kSummaryIndices =
+      kValidIndices >> kLogCardsPerSummary;
+  static_assert(
+      kSummaryIndices << kLogCardsPerSummary == kValidIndices,
+      "Summary entries must cover whole cards");
+
   CardTable() = default;
 
   /// CardTable is not copyable or movable: It must be constructed in-place.
@@ -112,8 +130,11 @@ class CardTable {
 
   /// If there is a dirty card at or after \p fromIndex, at an index less than
   /// \p endIndex, returns the index of the dirty card, else returns none.
-  inline OptValue<size_t> findNextDirtyCard(size_t fromIndex, size_t endIndex)
-      const;
+  OptValue<size_t> findNextDirtyCard(size_t fromIndex, size_t endIndex) const;
+
+  /// \return the number of cards in [fromIndex, endIndex) whose summary entry
+  /// is clean, which findNextDirtyCard skips without reading.
+  size_t numCardsInCleanSummaries(size_t fromIndex, size_t endIndex) const;
 
   /// If there is a card card at or after \p fromIndex, at an index less than
   /// \p endIndex, returns the index of the clean card, else returns none.
@@ -206,6 +227,11 @@ class CardTable {
 
   CardStatus cards_[kValidIndices]{};
 
+  /// One entry per kCardsPerSummary cards.  An entry is dirty if any of its
+  /// cards was dirtied since the entry was last cleaned, and is only cleaned
+  /// when all of its cards are.
+  CardStatus summary_[kSummaryIndices]{};
+
   /// Each card has a corresponding signed byte in the boundaries_ table.  A
   /// non-negative entry, K, indicates that the crossing object starts K *
   /// HeapAlign bytes before the start of the card. A negative entry, L,
@@ -254,7 +280,9 @@ inline const char *CardTable::indexToAddress(size_t index) const {
 }
 
 inline void CardTable::dirtyCardForAddress(const void *addr) {
-  cards_[addressToIndex(addr)] = CardStatus::Dirty;
+  const size_t index = addressToIndex(addr);
+  cards_[index] = CardStatus::Dirty;
+  summary_[index >> kLogCardsPerSummary] = CardStatus::Dirty;
 }
 
 inline bool CardTable::isCardForAddressDirty(const void *addr) const {
@@ -266,12 +294,6 @@ inline bool CardTable::isCardForIndexDirty(size_t index) const {
   return cards_[index] == CardStatus::Dirty;
 }
 
-inline OptValue<size_t> CardTable::findNextDirtyCard(
-    size_t fromIndex,
-    size_t endIndex) const {
-  return findNextCardWithStatus(CardStatus::Dirty, fromIndex, endIndex);
-}
-
 inline OptValue<size_t> CardTable::findNextCleanCard(
     size_t fromIndex,
     size_t endIndex) const {
@@ -12,6 +12,7 @@
 #include "hermes/BCGen/HBC/BytecodeProviderFromSrc.h"
 #include "hermes/Inst/Inst.h"
 #include "hermes/Support/SourceErrorManager.h"
+#include "hermes/VM/AllocationSite.h"
 #include "hermes/VM/Debugger/Debugger.h"
 #include "hermes/VM/HermesValue.h"
 #include "hermes/VM/IdentifierTable.h"
@@ -22,7 +23,9 @@
 #include "llvm/ADT/Optional.h"
 #include "llvm/Support/TrailingObjects.h"
 
+#include <algorithm>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace hermes {
@@ -34,6 +37,16 @@ class CodeBlock;
 /// A pointer to JIT-compiled function.
 typedef CallResult<HermesValue> (*JITCompiledFunctionPtr)(Runtime *runtime);
 
+/// A pointer to a native function which interprets \p codeBlock.
+typedef CallResult<HermesValue> (
+    *InterpreterTrampolinePtr)(Runtime *runtime, CodeBlock *codeBlock);
+
+/// A pointer to the on-stack replacement entry of a JIT-compiled function. It
+/// continues the execution of the current interpreter frame at the native code
+/// address \p target, which must be the start of a compiled basic block.
+typedef CallResult<HermesValue> (
+    *JITOSREntryPtr)(Runtime *runtime, const void *target);
+
 /// A sequence of instructions representing the body of a function.
 class CodeBlock final
     : private llvm::TrailingObjects<CodeBlock, PropertyCacheEntry> {
@@ -59,12 +72,68 @@ class CodeBlock final
   /// If this CodeBlock was compiled, a pointer to the body.
   JITCompiledFunctionPtr JITCompiled_ = nullptr;
 
+  /// If this CodeBlock was compiled, the block of executable memory holding
+  /// the slow paths, which was allocated along with the body.
+  uint8_t *JITSlowPaths_ = nullptr;
+
+  /// Size in bytes of the native code, body and slow paths.
+  uint32_t JITCodeSize_ = 0;
+
   /// Function execution count.
-  /// Ideally, a function's hotness should also include if it has a loop and how
-  /// hot that loop is.
   uint32_t executionCount_ = 0;
+
+  /// Number of backward jumps taken while interpreting this function, which
+  /// approximates the number of loop iterations.
+  uint32_t backEdgeCount_ = 0;
+
+  /// If this CodeBlock was compiled, the entry used to transfer a running
+  /// interpreter frame into the native code.
+  JITOSREntryPtr JITOSREntry_ = nullptr;
+
+  /// Pairs of bytecode offset and native address of every compiled basic
+  /// block, sorted by offset.
+  std::vector<std::pair<uint32_t, const void *>> osrTargets_{};
 #endif
 
+  /// If this CodeBlock executes a private copy of its bytecode, the bytecode
+  /// it was loaded with. Suspended generators may continue executing it.
+  const uint8_t *originalBytecode_{nullptr};
+
+  /// Writable copy of the bytecode, in which breakpoints are patched and
+  /// instructions are rewritten to their quickened variants. When set,
+  /// \c bytecode_ points to it.
+  std::unique_ptr<uint8_t[]> privateBytecode_{};
+
+  /// Whether the instructions of the private copy may be quickened.
+  bool quickened_{false};
+
+  /// Number of invocations of this function before it was quickened.
+  uint32_t quickenCount_{0};
+
+  /// Number of quickened instructions that reverted to the generic form.
+  uint32_t numDeopts_{0};
+
+  /// Survival feedback of the allocation sites in this function, keyed by
+  /// bytecode offset. Entries are created when a site is first sampled.
+  std::unordered_map<uint32_t, AllocationSiteInfo> allocationSites_{};
+
+  /// Size feedback for the instances created when this function is invoked as
+  /// a constructor.
+  ConstructorSlackInfo constructorSlack_{};
+
+  /// The ranges of the exception table, made disjoint and sorted by start
+  /// offset so that they can be binary searched. Each range has the target of
+  /// the first table entry covering it. Built the first time an exception
+  /// unwinds through this function.
+  std::vector<hbc::HBCExceptionHandlerInfo> catchRanges_{};
+
+  /// Whether catchRanges_ has been built.
+  bool catchRangesBuilt_{false};
+
+  /// Whether this function was called since the previous eviction of the cold
+  /// lazily compiled functions, see Runtime::evictColdFunctions().
+  bool calledSinceEviction_{false};
+
   /// Total size of the property cache.
   const uint32_t propertyCacheSize_;
 
@@ -72,6 +141,9 @@ class CodeBlock final
   /// cache.
   const uint32_t writePropCacheOffset_;
 
+  /// Build catchRanges_ from the exception table.
+  void buildCatchRanges();
+
 #ifndef HERMESVM_LEAN
   /// Compiles a lazy CodeBlock. Intended to be called from lazyCompile.
   void lazyCompileImpl(Runtime *runtime);
@@ -86,6 +158,9 @@ class CodeBlock final
   PropertyCacheEntry *propertyCache() {
     return getTrailingObjects<PropertyCacheEntry>();
   }
+  const PropertyCacheEntry *propertyCache() const {
+    return getTrailingObjects<PropertyCacheEntry>();
+  }
 
   PropertyCacheEntry *writePropertyCache() {
     return getTrailingObjects<PropertyCacheEntry>() + writePropCacheOffset_;
@@ -136,6 +211,9 @@ class CodeBlock final
         writePropCacheOffset);
   }
 
+  /// Free the out of line records of the property cache.
+  ~CodeBlock();
+
   /// Override of delete that balances the memory allocated in our create()
   /// function. Note the destructor has run already.
   static void operator delete(void *cb) {
@@ -216,14 +294,102 @@ class CodeBlock final
   }
 
   uint32_t getOffsetOf(const inst::Inst *inst) const {
+    const uint8_t *base = begin();
+    const uint8_t *ptr = reinterpret_cast<const uint8_t *>(inst);
+    // Generators that were suspended when the private copy was made may
+    // still point into the original bytecode.
+    if (LLVM_UNLIKELY(originalBytecode_) && ptr >= originalBytecode_ &&
+        ptr < originalBytecode_ + functionHeader_.bytecodeSizeInBytes()) {
+      base = originalBytecode_;
+    }
+    assert(ptr >= base && "inst not in this codeBlock");
+    uint32_t offset = ptr - base;
     assert(
-        reinterpret_cast<const uint8_t *>(inst) >= begin() &&
+        offset < functionHeader_.bytecodeSizeInBytes() &&
         "inst not in this codeBlock");
-    uint32_t offset = reinterpret_cast<const uint8_t *>(inst) - begin();
-    assert(begin() + offset < end() && "inst not in this codeBlock");
     return offset;
   }
 
+  /// \return the allocation site feedback of the instruction at \p ip.
+  AllocationSiteInfo *getAllocationSiteInfo(const inst::Inst *ip) {
+    return &allocationSites_[getOffsetOf(ip)];
+  }
+
+  /// \return the size feedback for instances constructed by this function.
+  ConstructorSlackInfo &getConstructorSlackInfo() {
+    return constructorSlack_;
+  }
+
+  /// Number of instructions that may revert to their generic form before
+  /// quickening stops for the whole function.
+  static constexpr uint32_t kMaxQuickenDeopts = 64;
+
+  /// \return true if the instructions of this CodeBlock may be quickened.
+  bool isQuickened() const {
+    return quickened_;
+  }
+
+  /// \return true if this CodeBlock executes a writable copy of its bytecode.
+  bool hasPrivateBytecode() const {
+    return privateBytecode_ != nullptr;
+  }
+
+  /// Make this CodeBlock execute a writable copy of its bytecode, if it
+  /// doesn't already, so that it can be patched without touching the loaded
+  /// bytecode, which may be mapped read-only and shared with other runtimes.
+  /// The frames of \p runtime that return into this function are moved to
+  /// the copy. Since instructions don't move after this, their addresses
+  /// may be used as keys.
+  void makeBytecodePrivate(Runtime *runtime);
+
+  /// Count an invocation of this function, and quicken it once it has been
+  /// invoked \p threshold times.
+  void countInvocationForQuickening(Runtime *runtime, uint32_t threshold) {
+    if (!isQuickened() && ++quickenCount_ >= threshold) {
+      quicken(runtime);
+    }
+  }
+
+  /// Start rewriting the instructions of the private copy of the bytecode to
+  /// their quickened variants, making the copy if there isn't one yet.
+  void quicken(Runtime *runtime);
+
+  /// \return true if the instruction at \p ip is in the writable copy of a
+  /// quickened CodeBlock.
+  bool isInQuickenedCopy(const inst::Inst *ip) const {
+    const uint8_t *ptr = reinterpret_cast<const uint8_t *>(ip);
+    return isQuickened() && ptr >= begin() && ptr < end();
+  }
+
+  /// \return true if the instruction at \p ip may be rewritten to a quickened
+  /// variant.
+  bool canQuicken(const inst::Inst *ip) const {
+    return numDeopts_ < kMaxQuickenDeopts && isInQuickenedCopy(ip);
+  }
+
+  /// Append to \p offsets the bytecode offsets of the instructions which were
+  /// rewritten to their quickened variant and have not reverted since.
+  void getQuickenedOffsets(std::vector<uint32_t> &offsets) const;
+
+  /// Rewrite the opcode of the instruction at \p ip, which must be in the
+  /// quickened copy, to \p opCode.
+  void setQuickenedOpCode(const inst::Inst *ip, inst::OpCode opCode) {
+    assert(canQuicken(ip) && "instruction cannot be quickened");
+    *const_cast<inst::OpCode *>(&ip->opCode) = opCode;
+  }
+
+  /// Revert the quickened instruction at \p ip to its generic \p opCode.
+  void deoptimize(const inst::Inst *ip, inst::OpCode opCode) {
+    assert(
+        isInQuickenedCopy(ip) &&
+        "quickened instruction outside of the quickened copy");
+    assert(
+        inst::getUnquickenedOpCode(ip->opCode) == opCode &&
+        "deoptimizing to an unrelated opcode");
+    ++numDeopts_;
+    *const_cast<inst::OpCode *>(&ip->opCode) = opCode;
+  }
+
 #ifndef HERMESVM_LEAN
   /// Checks whether this function is lazily compiled.
   bool isLazy() const {
@@ -237,6 +403,11 @@ class CodeBlock final
       lazyCompileImpl(runtime);
     }
   }
+
+  /// Make this lazily compiled CodeBlock lazy again, with the \p header and
+  /// \p functionID it was created with, and forget the feedback gathered by
+  /// its bytecode. Its module must have been returned to its lazy state.
+  void resetToLazy(hbc::RuntimeFunctionHeader header, uint32_t functionID);
 #else
   /// Checks whether this function is lazily compiled.
   bool isLazy() const {
@@ -245,6 +416,20 @@ class CodeBlock final
   void lazyCompile(Runtime *) {}
 #endif
 
+  /// Record that this function is called, so that it is not evicted by the
+  /// next eviction of the cold lazily compiled functions.
+  void setCalledSinceEviction() {
+    calledSinceEviction_ = true;
+  }
+
+  /// \return whether this function was called since the previous eviction of
+  /// the cold lazily compiled functions, and start counting again.
+  bool takeCalledSinceEviction() {
+    bool called = calledSinceEviction_;
+    calledSinceEviction_ = false;
+    return called;
+  }
+
   /// Get the start location of this function, if it's lazy.
   SourceErrorManager::SourceCoords getLazyFunctionStartLoc() const {
     return getLazyFunctionLoc(true);
@@ -277,6 +462,37 @@ class CodeBlock final
     JITCompiled_ = JITCompiled;
   }
 
+  /// \return the block holding the slow paths of the native code.
+  uint8_t *getJITSlowPaths() const {
+    return JITSlowPaths_;
+  }
+
+  /// \return the size in bytes of the native code.
+  uint32_t getJITCodeSize() const {
+    return JITCodeSize_;
+  }
+
+  /// Record that the native code occupies the body and the block
+  /// \p slowPaths, \p size bytes in total.
+  void setJITCodeBlocks(uint8_t *slowPaths, uint32_t size) {
+    JITSlowPaths_ = slowPaths;
+    JITCodeSize_ = size;
+  }
+
+  /// Forget the native code, which the caller frees, and start counting
+  /// invocations again, so that the function is compiled again only once it
+  /// becomes hot again.
+  void clearJITCompiled() {
+    JITCompiled_ = nullptr;
+    JITSlowPaths_ = nullptr;
+    JITCodeSize_ = 0;
+    JITOSREntry_ = nullptr;
+    osrTargets_.clear();
+    osrTargets_.shrink_to_fit();
+    executionCount_ = 0;
+    backEdgeCount_ = 0;
+  }
+
   /// Increment the function execution count.
   void incrementExecutionCount() {
     executionCount_++;
@@ -291,6 +507,53 @@ class CodeBlock final
   void clearExecutionCount() {
     executionCount_ = 0;
   }
+
+  /// Increment the count of backward jumps taken in this function.
+  void incrementBackEdgeCount() {
+    backEdgeCount_++;
+  }
+
+  /// \return the count of backward jumps taken in this function.
+  uint32_t getBackEdgeCount() const {
+    return backEdgeCount_;
+  }
+
+  /// \return how hot this function is, combining the number of invocations
+  /// and of loop iterations.
+  uint64_t getHotness() const {
+    return (uint64_t)executionCount_ + backEdgeCount_;
+  }
+
+  /// \return the on-stack replacement entry of the native code, or null if
+  ///   this function hasn't been compiled to native.
+  JITOSREntryPtr getJITOSREntry() const {
+    return JITOSREntry_;
+  }
+
+  /// Set the on-stack replacement entry of the native code, along with the
+  /// native addresses of the basic blocks it can enter, sorted by bytecode
+  /// offset.
+  void setJITOSREntry(
+      JITOSREntryPtr entry,
+      std::vector<std::pair<uint32_t, const void *>> &&targets) {
+    JITOSREntry_ = entry;
+    osrTargets_ = std::move(targets);
+  }
+
+  /// \return the native address of the compiled basic block starting at
+  ///   bytecode offset \p offset, or null if there is none.
+  const void *getOSRTarget(uint32_t offset) const {
+    auto it = std::lower_bound(
+        osrTargets_.begin(),
+        osrTargets_.end(),
+        offset,
+        [](const std::pair<uint32_t, const void *> &target, uint32_t offset) {
+          return target.first < offset;
+        });
+    if (it == osrTargets_.end() || it->first != offset)
+      return nullptr;
+    return it->second;
+  }
 #else
   /// \return true if JIT is disabled for this function.
   bool getDontJIT() const {
@@ -319,6 +582,29 @@ class CodeBlock final
 
   /// Reset the function executionCount_ count to 0
   void clearExecutionCount() {}
+
+  /// Increment the count of backward jumps taken in this function.
+  void incrementBackEdgeCount() {}
+
+  /// \return the count of backward jumps as 0 if the JIT is not enabled
+  uint32_t getBackEdgeCount() const {
+    return 0;
+  }
+
+  /// \return the hotness of this function as 0 if the JIT is not enabled
+  uint64_t getHotness() const {
+    return 0;
+  }
+
+  /// \return null since the JIT is not enabled.
+  JITOSREntryPtr getJITOSREntry() const {
+    return nullptr;
+  }
+
+  /// \return null since the JIT is not enabled.
+  const void *getOSRTarget(uint32_t offset) const {
+    return nullptr;
+  }
 #endif
 
   inline PropertyCacheEntry *getReadCacheEntry(uint8_t idx) {
@@ -343,10 +629,8 @@ class CodeBlock final
       uint32_t functionID);
 
   /// \return an estimate of the size of additional memory used by this
-  /// CodeBlock.
-  size_t additionalMemorySize() const {
-    return propertyCacheSize_ * sizeof(PropertyCacheEntry);
-  }
+  /// CodeBlock, including the out of line records of its property cache.
+  size_t additionalMemorySize() const;
 
 #ifdef HERMES_ENABLE_DEBUGGER
   inst::OpCode getOpCode(uint32_t offset) const {
@@ -358,6 +642,7 @@ class CodeBlock final
 
   /// Installs in the debugger instruction into the opcode stream
   /// at location \p offset.
+  /// Requires that the bytecode was made private by makeBytecodePrivate().
   /// Requires that there's a breakpoint registered at \p offset.
   /// Increments the user count of the associated runtime module.
   void installBreakpointAtOffset(uint32_t offset);
@@ -49,6 +49,11 @@ inline GCGeneration *CompactionResult::Chunk::generation() const {
   return generation_;
 }
 
+inline bool CompactionResult::Chunk::isEmptyChunkOf(
+    const AlignedHeapSegment *segment) const {
+  return level_ == segment->start();
+}
+
 #ifndef NDEBUG
 inline void CompactionResult::Chunk::recordNumAllocated() const {
   generation_->incNumAllocatedObjects(numAllocated_);
@@ -87,6 +87,10 @@ class CompactionResult {
     /// \return A pointer to the generation this chunk was created from.
     GCGeneration *generation() const;
 
+    /// \return true if this chunk is the allocation region of \p segment,
+    ///     and nothing has been compacted into it yet.
+    bool isEmptyChunkOf(const AlignedHeapSegment *segment) const;
+
 #ifndef NDEBUG
     /// Write back the number of objects that now reside in the segment, after
     /// compaction.
@@ -25,7 +25,11 @@ namespace vm {
 /// - a descriptor array containing pairs of SymbolID and PropertyDescriptor.
 ///
 /// Fast property lookup is supported by the hash table - it maps from a
-/// SymbolID to an index in the descriptor array.
+/// SymbolID to an index in the descriptor array. Next to the table there is
+/// one control byte per entry, holding either 7 bits of the hash of the entry's
+/// SymbolID or a marker for empty and deleted entries. Lookups scan the control
+/// bytes a group at a time and only read the entries whose hash bits match, so
+/// a miss usually stops after a single group.
 ///
 /// New properties are inserted in the hash table and appended sequentially to
 /// the end of the descriptor array, thus encoding the original insertion order.
@@ -62,7 +66,8 @@ class DictPropertyMap final : public VariableSizeRuntimeCell,
                               private llvm::TrailingObjects<
                                   DictPropertyMap,
                                   std::pair<SymbolID, NamedPropertyDescriptor>,
-                                  std::pair<SymbolID, uint32_t>> {
+                                  std::pair<SymbolID, uint32_t>,
+                                  uint8_t> {
   friend TrailingObjects;
   friend void DictPropertyMapBuildMeta(
       const GCCell *cell,
@@ -70,6 +75,18 @@ class DictPropertyMap final : public VariableSizeRuntimeCell,
 
   using HashPair = std::pair<SymbolID, uint32_t>;
 
+  /// The control byte of a hash table entry. Full entries store the low 7
+  /// bits of the hash of their SymbolID, so the top bit is only set for the
+  /// markers below.
+  using CtrlByte = uint8_t;
+  static constexpr CtrlByte kCtrlEmpty = 0x80;
+  static constexpr CtrlByte kCtrlDeleted = 0xfe;
+
+  /// Number of control bytes examined at once. The control byte array has
+  /// this many extra bytes after the last entry, mirroring the start of the
+  /// table, so that a group can be loaded at any index without wrapping.
+  static constexpr uint32_t kGroupWidth = 8;
+
  public:
   using DescriptorPair = std::pair<SymbolID, NamedPropertyDescriptor>;
 
@@ -102,6 +119,13 @@ class DictPropertyMap final : public VariableSizeRuntimeCell,
       Runtime *runtime,
       size_type capacity = DEFAULT_CAPACITY);
 
+  /// Create a copy of the map in \p selfHandle with room for at least
+  /// \p capacity properties.
+  static CallResult<PseudoHandle<DictPropertyMap>> clone(
+      Handle<DictPropertyMap> selfHandle,
+      Runtime *runtime,
+      size_type capacity);
+
   /// Return the number of non-deleted properties in the map.
   size_type size() const {
     return numProperties_;
@@ -231,9 +255,16 @@ class DictPropertyMap final : public VariableSizeRuntimeCell,
     return ceil >= A ? ceil : constPowerOf2Ceil(A, ceil << 1);
   }
 
-  /// Hash a symbol ID. For now it is the identity hash.
-  static unsigned hash(SymbolID symbolID) {
-    return symbolID.unsafeGetRaw();
+  /// Hash a symbol ID. SymbolIDs are allocated sequentially, so they are
+  /// mixed (Fibonacci hashing) to spread them over both the table index, taken
+  /// from the high bits, and the control byte, taken from the low 7 bits.
+  static uint32_t hash(SymbolID symbolID) {
+    return symbolID.unsafeGetRaw() * 0x9e3779b1u;
+  }
+
+  /// \return the control byte of a full entry with hash \p h.
+  static CtrlByte ctrlFromHash(uint32_t h) {
+    return h & 0x7f;
   }
 
   DictPropertyMap(
@@ -248,6 +279,7 @@ class DictPropertyMap final : public VariableSizeRuntimeCell,
         hashCapacity_(hashCapacity) {
     // Clear the hash table.
     std::fill_n(getHashPairs(), hashCapacity_, HashPair{SymbolID::empty(), 0});
+    std::fill_n(getCtrlBytes(), hashCapacity_ + kGroupWidth, kCtrlEmpty);
   }
 
   DescriptorPair *getDescriptorPairs() {
@@ -259,6 +291,25 @@ class DictPropertyMap final : public VariableSizeRuntimeCell,
   HashPair *getHashPairs() {
     return getTrailingObjects<HashPair>();
   }
+  CtrlByte *getCtrlBytes() {
+    return getTrailingObjects<CtrlByte>();
+  }
+
+  /// Set the control byte of the hash table entry at \p index, and of its
+  /// mirrors past the end of the table.
+  void setCtrl(size_type index, CtrlByte ctrl) {
+    CtrlByte *ctrlBytes = getCtrlBytes();
+    ctrlBytes[index] = ctrl;
+    for (size_type i = index; i < kGroupWidth; i += hashCapacity_)
+      ctrlBytes[hashCapacity_ + i] = ctrl;
+  }
+
+  /// Store \p symbolID and \p descIndex in the hash table entry \p entry.
+  void setHashPair(HashPair *entry, SymbolID symbolID, uint32_t descIndex) {
+    entry->first = symbolID;
+    entry->second = descIndex;
+    setCtrl(entry - getHashPairs(), ctrlFromHash(hash(symbolID)));
+  }
 
   /// Store the next deleted index in a deleted descriptor pair. The index
   /// is stored in the PropertyFlags field.
@@ -309,8 +360,8 @@ class DictPropertyMap final : public VariableSizeRuntimeCell,
   static uint32_t allocationSize(
       size_type descriptorCapacity,
       size_type hashCapacity) {
-    return totalSizeToAlloc<DescriptorPair, HashPair>(
-        descriptorCapacity, hashCapacity);
+    return totalSizeToAlloc<DescriptorPair, HashPair, CtrlByte>(
+        descriptorCapacity, hashCapacity, hashCapacity + kGroupWidth);
   }
 
   /// Calculate the maximum capacity of DictPropertyMap at compile time using
@@ -345,6 +396,7 @@ class DictPropertyMap final : public VariableSizeRuntimeCell,
         sizeof(DictPropertyMap::DescriptorPair) * (uint64_t)cap +
         kAlignPadding +
         sizeof(DictPropertyMap::HashPair) * constCalcHashCapacity64(cap) +
+        kAlignPadding + constCalcHashCapacity64(cap) + kGroupWidth +
         kAlignPadding;
   }
 
@@ -378,6 +430,9 @@ class DictPropertyMap final : public VariableSizeRuntimeCell,
   size_t numTrailingObjects(OverloadToken<DescriptorPair>) const {
     return descriptorCapacity_;
   }
+  size_t numTrailingObjects(OverloadToken<HashPair>) const {
+    return hashCapacity_;
+  }
 };
 
 //===----------------------------------------------------------------------===//
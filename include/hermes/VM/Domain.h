@@ -14,6 +14,8 @@
 #include "hermes/VM/Runtime.h"
 #include "hermes/VM/StringPrimitive.h"
 
+#include "llvm/ADT/BitVector.h"
+
 namespace hermes {
 namespace vm {
 
@@ -87,6 +89,10 @@ class Domain final : public GCCell {
   /// The index is used to look up the actual CJSModule in cjsModules_.
   llvm::DenseMap<SymbolID, uint32_t> cjsModuleTable_{};
 
+  /// Bit i is set once the bytecode of CJS module i has been prefetched by
+  /// prefetchCJSModuleDependencies().
+  llvm::BitVector prefetchedCJSModules_{};
+
   /// RuntimeModules owned by this Domain.
   /// These will be freed from the Domain destructor.
   CopyableVector<RuntimeModule *> runtimeModules_{};
@@ -199,6 +205,20 @@ class Domain final : public GCCell {
         .set(module.getHermesValue(), &runtime->getHeap());
   }
 
+  /// \return the filename of the CJS module at \p cjsModuleOffset, None if it
+  /// was loaded from a statically resolved module table, which has none.
+  OptValue<SymbolID> getCJSModuleFilenameMayAllocate(
+      Runtime *runtime,
+      uint32_t cjsModuleOffset) const;
+
+  /// Ask the OS to read ahead the bytecode of the modules that the CJS module
+  /// at \p cjsModuleOffset statically requires, transitively, so that their
+  /// initialization doesn't stall on page faults one function at a time.
+  /// Each module is prefetched at most once.
+  void prefetchCJSModuleDependencies(
+      Runtime *runtime,
+      uint32_t cjsModuleOffset);
+
   /// \return the throwing require function with require.context bound to a
   /// context for this domain.
   PseudoHandle<NativeFunction> getThrowingRequire(Runtime *runtime) const {
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_VM_EVALCACHE_H
+#define HERMES_VM_EVALCACHE_H
+
+#include "hermes/BCGen/HBC/BytecodeDataProvider.h"
+
+#include "llvm/ADT/StringRef.h"
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace hermes {
+namespace vm {
+
+/// A cache of the bytecode compiled at runtime by eval() and the Function
+/// constructor, keyed by the source and the way it was compiled. Evaluating
+/// the same source again then runs the cached bytecode in a new
+/// RuntimeModule instead of parsing and compiling it. Only code compiled
+/// without an enclosing scope chain can be cached, since the scope chain
+/// changes the generated code. When the cache is full, the least recently
+/// used entry is evicted.
+class EvalCache {
+ public:
+  /// Number of entries kept by default.
+  static constexpr size_t kDefaultCapacity = 32;
+
+  /// Sources longer than this are not cached, to bound the memory used by the
+  /// keys.
+  static constexpr size_t kMaxSourceLength = 64 * 1024;
+
+  explicit EvalCache(size_t capacity = kDefaultCapacity)
+      : capacity_(capacity) {}
+
+  EvalCache(const EvalCache &) = delete;
+  EvalCache &operator=(const EvalCache &) = delete;
+
+  /// Look up the bytecode compiled from \p source with the flags \p flags,
+  /// and make it the most recently used entry.
+  /// \return the bytecode, or null if it is not cached.
+  std::shared_ptr<hbc::BCProvider> lookup(
+      llvm::StringRef source,
+      uint8_t flags);
+
+  /// Add the \p bytecode compiled from \p source with the flags \p flags,
+  /// evicting the least recently used entry if the cache is full. Does
+  /// nothing if \p source is longer than kMaxSourceLength.
+  /// \pre the source is not cached.
+  void insert(
+      llvm::StringRef source,
+      uint8_t flags,
+      std::shared_ptr<hbc::BCProvider> bytecode);
+
+  /// Remove every entry. The bytecode is freed once no RuntimeModule runs it.
+  /// \return the number of bytes freed by the keys.
+  size_t clear();
+
+  /// \return the number of entries.
+  size_t size() const {
+    return entries_.size();
+  }
+
+  /// \return the number of lookups that found their bytecode.
+  uint64_t getHits() const {
+    return hits_;
+  }
+
+  /// \return the number of lookups that did not find their bytecode.
+  uint64_t getMisses() const {
+    return misses_;
+  }
+
+ private:
+  /// \return the key for \p source with \p flags: the flags, followed by the
+  /// source.
+  static std::string makeKey(llvm::StringRef source, uint8_t flags);
+
+  struct Entry {
+    std::string key;
+    std::shared_ptr<hbc::BCProvider> bytecode;
+  };
+
+  /// Maximum number of entries.
+  const size_t capacity_;
+
+  /// The entries, from the most to the least recently used.
+  std::list<Entry> entries_;
+
+  /// Maps each key to its entry.
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_EVALCACHE_H
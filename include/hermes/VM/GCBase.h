@@ -14,11 +14,15 @@
 #include "hermes/Public/MemoryEventTracker.h"
 #include "hermes/Support/CheckedMalloc.h"
 #include "hermes/Support/OSCompat.h"
+#include "hermes/Support/OptValue.h"
 #include "hermes/Support/StatsAccumulator.h"
+#include "hermes/VM/AllocationSite.h"
+#include "hermes/VM/BackgroundFreer.h"
 #include "hermes/VM/BuildMetadata.h"
 #include "hermes/VM/CellKind.h"
 #include "hermes/VM/GCDecl.h"
 #include "hermes/VM/GCPointer.h"
+#include "hermes/VM/GCTelemetry.h"
 #include "hermes/VM/HasFinalizer.h"
 #include "hermes/VM/HeapAlign.h"
 #include "hermes/VM/HeapSnapshot.h"
@@ -37,6 +41,7 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
 #include <random>
 #include <system_error>
 #include <vector>
@@ -165,6 +170,8 @@ class GCCell;
 ///     gcheapsize_t storageFootprint() const;
 ///
 class GCBase {
+  friend struct RuntimeOffsets;
+
  public:
   /// An interface enabling the garbage collector to mark roots and free
   /// symbols.
@@ -332,6 +339,22 @@ class GCBase {
   /// nothing.)
   void ttiReached() {}
 
+  /// Inform the GC that the mutator is idle until \p deadline, so that it can
+  /// do collection work that would otherwise interrupt it later.  Default
+  /// behavior is to do nothing.
+  /// \return true if any collection work was done.
+  bool collectDuringIdle(std::chrono::steady_clock::time_point deadline) {
+    return false;
+  }
+
+  /// Return the memory that the heap holds without using it to the OS. If
+  /// \p minimize, first shrink the heap as much as its live data allows.
+  /// Default behavior is to do nothing.
+  /// \return the number of bytes returned.
+  size_t releaseUnusedMemory(bool minimize) {
+    return 0;
+  }
+
   /// Do anything necessary to record the current number of allocated
   /// objects in numAllocatedObjects_.  Default is to do nothing.
   virtual void recordNumAllocatedObjects() {}
@@ -354,6 +377,23 @@ class GCBase {
     return cumStats_.gcCPUTime.sum();
   }
 
+  /// \return the record of recent collections, which can summarize their
+  /// pause times over a sliding window.
+  const GCTelemetry &getTelemetry() const {
+    return telemetry_;
+  }
+
+  /// Free \p mem, a malloc'ed buffer owned by a cell that is being finalized,
+  /// to which nothing else refers.  If the GC was configured to, the buffer is
+  /// freed on a background thread once the collection is over.
+  void freeFinalizedMemory(void *mem) {
+    if (backgroundFreer_) {
+      backgroundFreer_->enqueue(mem);
+    } else {
+      free(mem);
+    }
+  }
+
   /// Populate \p info with information about the heap.
   virtual void getHeapInfo(HeapInfo &info);
   /// Same as \c getHeapInfo, and it adds the amount of malloc memory in use.
@@ -377,9 +417,27 @@ class GCBase {
   ///   version.
   /// \return true on success, false on failure.
   bool createSnapshotToFile(const std::string &fileName, bool compact);
+  /// Creates a snapshot of the heap and writes it to the file descriptor
+  /// \p fd, which is left open, in chunks of kSnapshotChunkSize bytes as it
+  /// is produced.
+  void createSnapshotToFD(int fd, const HeapSnapshotOptions &options);
   /// Creates a snapshot of the heap, which includes information about what
   /// objects exist, their sizes, and what they point to.
-  virtual void createSnapshot(llvm::raw_ostream &os, bool compact) = 0;
+  void createSnapshot(llvm::raw_ostream &os, bool compact) {
+    HeapSnapshotOptions options;
+    options.compact = compact;
+    createSnapshot(os, options);
+  }
+  /// Same as above, with the size of the snapshot bounded by \p options.
+  /// Nodes and edges are written to \p os as the heap is walked, so apart
+  /// from the strings, the memory needed does not depend on the number of
+  /// objects.
+  virtual void createSnapshot(
+      llvm::raw_ostream &os,
+      const HeapSnapshotOptions &options) = 0;
+
+  /// The size of the writes of a snapshot to a file.
+  static constexpr size_t kSnapshotChunkSize = 1 << 16;
 
   /// Default implementations for the external memory credit/debit APIs: do
   /// nothing.
@@ -450,6 +508,50 @@ class GCBase {
     return inGC_;
   }
 
+  /// @name Allocation site feedback
+  /// Objects allocated by sites whose objects tend to survive are allocated
+  /// directly in the old generation. Only collectors with a young generation
+  /// enable the feedback; the others ignore samples and pretenuring requests.
+  /// @{
+
+  /// \return true if allocation sites should be sampled, and their pretenuring
+  /// decisions honored.
+  bool allocationSiteFeedbackEnabled() const {
+    return allocSiteFeedback_;
+  }
+
+  /// Record that \p cell was just allocated by \p site, so that whether it
+  /// survives its first collection is credited to the site.
+  void recordAllocationSite(GCCell *cell, AllocationSiteInfo *site) {
+    if (allocSiteSamples_.size() < kMaxAllocSiteSamples)
+      allocSiteSamples_.emplace_back(cell, site);
+  }
+
+  /// Forget the allocation site samples without reporting an outcome. Must be
+  /// called before the AllocationSiteInfo of a CodeBlock is freed, when it is
+  /// deleted or reset to lazy, since the samples point into it.
+  void clearAllocationSiteSamples() {
+    allocSiteSamples_.clear();
+  }
+
+  /// An RAII object during whose lifetime allocations go to the old
+  /// generation, if the collector has one.
+  class PretenureScope {
+   public:
+    PretenureScope(GCBase *gc, bool enable) : gc_(gc), prev_(gc->pretenure_) {
+      gc_->pretenure_ = prev_ || enable;
+    }
+    ~PretenureScope() {
+      gc_->pretenure_ = prev_;
+    }
+
+   private:
+    GCBase *const gc_;
+    const bool prev_;
+  };
+
+  /// @}
+
   /// Get the next unique object ID for a newly created object.
   uint64_t nextObjectID();
 
@@ -512,6 +614,21 @@ class GCBase {
     return 0;
   }
 
+  /// Report the outcome of every allocation site sample to its site, and
+  /// forget the samples. \p survived is called with each sampled cell and
+  /// returns None if the outcome is unknown (for example because the cell was
+  /// not allocated in the young generation), and otherwise whether the cell
+  /// survived the collection in progress.
+  template <typename F>
+  void processAllocationSiteSamples(F survived) {
+    for (auto &sample : allocSiteSamples_) {
+      OptValue<bool> outcome = survived(sample.first);
+      if (outcome.hasValue())
+        sample.second->recordOutcome(outcome.getValue());
+    }
+    allocSiteSamples_.clear();
+  }
+
   /// Convenience method to invoke the mark weak roots function provided at
   /// initialization, using the context provided then (on this heap).
   void markWeakRoots(SlotAcceptorWithNames &acceptor) {
@@ -539,6 +656,26 @@ class GCBase {
   void
   recordGCStats(double wallTime, double cpuTime, gcheapsize_t finalHeapSize);
 
+  /// Record a collection of the given \p kind in the telemetry window.  It
+  /// paused the mutator for \p pauseSecs seconds, promoted \p promotedBytes
+  /// to the old generation, and left the heap size at \p heapSize.
+  void recordGCTelemetry(
+      GCTelemetry::Kind kind,
+      double pauseSecs,
+      uint64_t promotedBytes,
+      gcheapsize_t heapSize) {
+    telemetry_.recordCollection(
+        kind, pauseSecs, promotedBytes, totalAllocatedBytes_, heapSize);
+  }
+
+  /// Let the buffers given to freeFinalizedMemory during the collection that
+  /// just ended be freed.
+  void flushFinalizedMemory() {
+    if (backgroundFreer_) {
+      backgroundFreer_->flush();
+    }
+  }
+
   /// Do any additional GC-specific logging that is useful before dying with
   /// out-of-memory.
   virtual void oomDetail(std::error_code reason);
@@ -615,9 +752,31 @@ class GCBase {
   // The cumulative GC stats.
   CumulativeHeapStats cumStats_;
 
+  /// The recent collections, see getTelemetry.
+  GCTelemetry telemetry_;
+
+  /// Frees the buffers given to freeFinalizedMemory, if BackgroundFreeing was
+  /// enabled.
+  std::unique_ptr<BackgroundFreer> backgroundFreer_;
+
   /// Name to indentify this heap in logs.
   std::string name_;
 
+  /// Maximum number of allocation site samples taken between collections.
+  static constexpr size_t kMaxAllocSiteSamples = 1024;
+
+  /// Whether allocation site feedback is enabled, see
+  /// allocationSiteFeedbackEnabled.
+  bool allocSiteFeedback_{false};
+
+  /// Whether allocations should currently go to the old generation, see
+  /// PretenureScope.
+  bool pretenure_{false};
+
+  /// Cells allocated since the last collection by sampled allocation sites,
+  /// along with their sites.
+  std::vector<std::pair<GCCell *, AllocationSiteInfo *>> allocSiteSamples_{};
+
  private:
 #ifdef HERMESVM_MEMORY_PROFILER
   /// Memory event tracker for the memory profiler
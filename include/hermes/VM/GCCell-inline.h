@@ -6,6 +6,7 @@
  */
 #include "hermes/VM/GCCell.h"
 
+#include "hermes/VM/HostModel.h"
 #include "hermes/VM/JSArrayBuffer.h"
 #include "hermes/VM/StringPrimitive.h"
 #ifdef UNIT_TEST
@@ -19,7 +20,8 @@ inline uint32_t GCCell::externalMemorySize() const {
   // TODO (T27363944): a more general way of doing this, if we ever have more
   // gc kinds with external memory charges.
   return StringPrimitive::externalMemorySize(this) +
-      JSArrayBuffer::externalMemorySize(this);
+      JSArrayBuffer::externalMemorySize(this) +
+      HostObject::externalMemorySize(this);
 }
 
 } // namespace vm
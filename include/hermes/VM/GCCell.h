@@ -22,6 +22,8 @@ namespace vm {
 /// traversal in a contiguous space: given a pointer to the head, you
 /// can get the size, and thus get to the head of the next cell.
 class GCCell {
+  friend struct RuntimeOffsets;
+
   /// Pointer to the virtual table which also serves as a forwarding pointer.
   const VTable *vtp_;
 
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_VM_GCCOSTSIZINGPOLICY_H
+#define HERMES_VM_GCCOSTSIZINGPOLICY_H
+
+#include <chrono>
+
+namespace hermes {
+namespace vm {
+
+/// Decides how to resize the heap so that the fraction of wall time spent in
+/// collections (the GC cost ratio) stays close to a target.  A heap that is
+/// collected too often for its allocation rate is grown, and one that is
+/// collected rarely enough is shrunk, independently of how occupied it is.
+///
+/// The cost of a collection is its pause divided by the time since the end of
+/// the previous collection, and the policy acts on an exponentially weighted
+/// average of it.  After asking for a resize, the policy waits for a few more
+/// collections before judging the effect of the new size.
+class GCCostSizingPolicy {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /// \param targetRatio the fraction of wall time that should be spent in
+  ///   collections, in (0, 1).  Any other value disables the policy.
+  explicit GCCostSizingPolicy(double targetRatio);
+
+  /// \return whether the policy was given a valid target.
+  bool enabled() const {
+    return targetRatio_ > 0.0;
+  }
+
+  /// Record a collection that paused the mutator for \p pauseSecs, and ended
+  /// at \p end.
+  void recordCollection(double pauseSecs, Clock::time_point end);
+
+  /// \return the factor the heap size should be multiplied by: more than 1 to
+  ///   grow, less than 1 to shrink, exactly 1 to leave it alone.  A factor
+  ///   other than 1 is assumed to have been applied, and restarts sampling.
+  double takeSizeFactor();
+
+  /// \return the current weighted average of the GC cost ratio.
+  double costRatio() const {
+    return costRatio_;
+  }
+
+ private:
+  /// Number of collections recorded before a decision is made.
+  static constexpr unsigned kMinSamples = 4;
+
+  /// Weight of the latest collection in the average cost ratio.
+  static constexpr double kAlpha = 0.3;
+
+  /// The heap is never grown by more than this factor at once.
+  static constexpr double kMaxGrowFactor = 2.0;
+
+  /// The heap is shrunk once the cost ratio falls below this fraction of the
+  /// target, by kShrinkFactor at a time.
+  static constexpr double kShrinkBelow = 0.25;
+  static constexpr double kShrinkFactor = 0.9;
+
+  const double targetRatio_;
+
+  double costRatio_{0.0};
+
+  /// Number of collections recorded since the last decision to resize.
+  unsigned numSamples_{0};
+
+  /// Whether lastEnd_ is valid.
+  bool hasLastEnd_{false};
+  Clock::time_point lastEnd_;
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_GCCOSTSIZINGPOLICY_H
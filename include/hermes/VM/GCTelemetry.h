@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_VM_GCTELEMETRY_H
+#define HERMES_VM_GCTELEMETRY_H
+
+#include "hermes/Public/GCTelemetry.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace hermes {
+namespace vm {
+
+/// Keeps a record of the most recent collections, from which summaries of
+/// their pause times, promotion and allocation rates can be computed at any
+/// time.  Recording a collection is constant time; the cost of computing the
+/// percentiles is paid by whoever asks for a summary.  The record is guarded
+/// by a lock, so summaries may be requested from any thread.
+class GCTelemetry {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  enum class Kind { YoungGen, Full };
+
+  /// Maximum number of collections remembered.  A window that contains more
+  /// collections is summarized from the most recent ones only.
+  static constexpr size_t kCapacity = 512;
+
+  /// Record a collection of the given \p kind that just ended.
+  /// \param pauseSecs how long the collection paused the mutator.
+  /// \param promotedBytes bytes moved to the old generation.
+  /// \param totalAllocatedBytes bytes allocated since the start of execution.
+  /// \param heapSize the size of the heap after the collection.
+  void recordCollection(
+      Kind kind,
+      double pauseSecs,
+      uint64_t promotedBytes,
+      uint64_t totalAllocatedBytes,
+      uint64_t heapSize);
+
+  /// Summarize the collections that ended within \p window of now.
+  GCTelemetrySummary summarize(Clock::duration window) const;
+
+ private:
+  struct Collection {
+    Clock::time_point end;
+    Kind kind;
+    double pauseSecs;
+    uint64_t promotedBytes;
+    uint64_t totalAllocatedBytes;
+  };
+
+  mutable std::mutex mutex_;
+
+  /// Ring buffer of the last collections.  The oldest one is at index next_
+  /// once the buffer is full.
+  std::array<Collection, kCapacity> collections_;
+  size_t next_{0};
+  size_t size_{0};
+
+  uint64_t heapSize_{0};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_GCTELEMETRY_H
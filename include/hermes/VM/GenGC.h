@@ -252,7 +252,10 @@ class GenGC final : public GCBase {
 
   /// Creates a snapshot of the heap, which includes information about what
   /// objects exist, their sizes, and what they point to.
-  virtual void createSnapshot(llvm::raw_ostream &os, bool compact) override;
+  using GCBase::createSnapshot;
+  virtual void createSnapshot(
+      llvm::raw_ostream &os,
+      const HeapSnapshotOptions &options) override;
 
   /// Returns the number of bytes allocated allocated since the last GC.
   gcheapsize_t bytesAllocatedSinceLastGC() const override;
@@ -18,6 +18,7 @@
 #include "hermes/VM/CellKind.h"
 #include "hermes/VM/CompleteMarkState.h"
 #include "hermes/VM/DependentMemoryRegion.h"
+#include "hermes/VM/GCCostSizingPolicy.h"
 #include "hermes/VM/GCBase.h"
 #include "hermes/VM/GCCell.h"
 #include "hermes/VM/GCPointer.h"
@@ -167,6 +168,12 @@ class GenGC final : public GCBase {
   void debitExternalMemory(GCCell *alloc, uint32_t size);
 
   /// Write barriers.
+  ///
+  /// These are generational barriers: they run after the store and only see
+  /// the new value, and stores of non-pointers (GCHermesValue::setNonPtr, and
+  /// the inline stores emitted by the JIT) skip them entirely. They therefore
+  /// cannot serve as snapshot-at-the-beginning barriers for a concurrent
+  /// marker, which would need the overwritten value of every store.
 
   /// The given value is being written at the given loc (required to
   /// be in the heap).  If value is a pointer, execute a write barrier.
@@ -236,6 +243,30 @@ class GenGC final : public GCBase {
   /// Inform the GC that TTI has been reached.
   void ttiReached();
 
+  /// Do the collections that are likely to be needed soon, and are expected
+  /// to finish before \p deadline, judging by the average pause of earlier
+  /// collections of the same kind.  A young generation collection is done
+  /// once the young generation is at least kIdleYoungGenOccupancy full, and a
+  /// full collection once the old generation could not absorb another young
+  /// generation collection without growing.
+  /// \return true if any collection was done.
+  bool collectDuringIdle(std::chrono::steady_clock::time_point deadline);
+
+  /// Return the segments cached for the growth of the old generation and the
+  /// pages above the level of every segment to the OS. If the young
+  /// generation is empty, as after a full collection, first shrink the heap
+  /// to the size its occupancy target asks for, or to its minimum size if
+  /// \p minimize.
+  /// \return the number of bytes returned.
+  size_t releaseUnusedMemory(bool minimize);
+
+  /// If memory is released after a decay interval, and the interval elapsed
+  /// since the previous release, return to the OS the segments cached for the
+  /// growth of the old generation and the pages above the level of each
+  /// segment that stayed unused all along.
+  /// \return the number of bytes returned.
+  size_t releaseDecayedMemory();
+
   /// Force a garbage collection cycle.
   /// (Part of general GC API defined in GC.h).
   /// Does a mark/sweep/compact collection of both generations.
@@ -317,7 +348,10 @@ class GenGC final : public GCBase {
 
   /// Creates a snapshot of the heap, which includes information about what
   /// objects exist, their sizes, and what they point to.
-  virtual void createSnapshot(llvm::raw_ostream &os, bool compact) override;
+  using GCBase::createSnapshot;
+  virtual void createSnapshot(
+      llvm::raw_ostream &os,
+      const HeapSnapshotOptions &options) override;
 
   /// Returns the number of bytes allocated allocated since the last GC.
   gcheapsize_t bytesAllocatedSinceLastGC() const override;
@@ -451,6 +485,8 @@ class GenGC final : public GCBase {
   friend class GCGeneration;
   friend class YoungGen;
   friend class OldGen;
+  // The JIT allocates inline from the active segment of allocContext_.
+  friend struct RuntimeOffsets;
 
   /// The slow path for allocation.  Same specification as alloc(),
   /// albeit with the template arguments passed as explicit dynamic
@@ -552,6 +588,12 @@ class GenGC final : public GCBase {
     ///     region.
     void recordGCStats(size_t regionSize, CumulativeHeapStats *regionStats);
 
+    /// \return the wall time the collection took, in seconds.
+    /// \pre recordGCStats has been called.
+    double wallElapsedSecs() const {
+      return wallElapsedSecs_;
+    }
+
    private:
     GenGC *gc_;
     GCCycle cycle_;
@@ -631,6 +673,10 @@ class GenGC final : public GCBase {
   /// the chunks used during compaction.
   void compact(const SweepResult &sweepResult);
 
+  /// \return the segments that sweepAndInstallForwardingPointers sweeps, in
+  /// the order it sweeps them.
+  std::vector<AlignedHeapSegment *> sweptSegments();
+
   /// Helper routines used by marking:
 
   /// Complete the marking phase: after marking from roots has set mark
@@ -738,6 +784,17 @@ class GenGC final : public GCBase {
   /// indicate.
   void updateHeapSize();
 
+  /// \return whether a collection with the pauses summarized by \p stats is
+  ///   expected to end before \p deadline.  False if there were no such
+  ///   collections yet.
+  static bool expectedToEndBefore(
+      const CumulativeHeapStats &stats,
+      TimePoint deadline);
+
+  /// Record that a collection just paused the mutator for \p pauseSecs, and
+  /// resize the heap if costSizing_ asks for it.
+  void recordGCCost(double pauseSecs);
+
   /// The generation from which the alloc context is claimed, as a
   /// GCGeneration*.
   inline GCGeneration *targetGeneration();
@@ -794,12 +851,39 @@ class GenGC final : public GCBase {
   ///    V[n]
   static constexpr double kWeightedUsedAlpha = 0.2;
 
+  /// The fraction of the young generation that must be used before
+  /// collectDuringIdle collects it.
+  static constexpr double kIdleYoungGenOccupancy = 0.5;
+
+  /// How long unused memory must stay unused before releaseDecayedMemory
+  /// returns it to the OS. Zero if it is returned by the collections that
+  /// free it, or not at all.
+  const std::chrono::milliseconds releaseDecay_;
+
+  /// When releaseDecayedMemory last returned memory, or the heap was created.
+  TimePoint lastDecayedRelease_;
+
   /// Full heap marking infrastructure.
 
   /// Contains the markStack, overflow boolean, and pointer to the
   /// parent object of the object currently being marked.
   CompleteMarkState markState_;
 
+  /// Number of threads used by completeMarking. If more than one, marking is
+  /// completed by a ParallelMarker instead of using markState_.
+  const unsigned numMarkingThreads_;
+
+  /// Number of threads used by updateReferences and compact. If more than
+  /// one, the segments are processed by a ParallelCompactor.
+  const unsigned numCompactionThreads_;
+
+  /// Old generation segments at the start of the heap that are at least this
+  /// percent live are not compacted by full collections.  0 compacts them all.
+  const unsigned inPlaceLivePercent_;
+
+  /// Resizes the heap to meet the GC cost ratio target, if one was given.
+  GCCostSizingPolicy costSizing_;
+
   /// Every bit corresponds to a symbol id. It is set to true if the symbol is
   /// in use (was marked).
   std::vector<bool> markedSymbols_{};
@@ -865,6 +949,9 @@ inline void *GenGC::alloc(uint32_t sz) {
     // is almost as good.
     collect();
   }
+  if (LLVM_UNLIKELY(pretenure_)) {
+    return allocLongLived<hasFinalizer>(sz);
+  }
 
 #ifdef HERMESVM_GC_GENERATIONAL_MARKSWEEPCOMPACT
   AllocResult res = oldGen_.alloc(sz, hasFinalizer);
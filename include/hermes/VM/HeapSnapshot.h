@@ -10,6 +10,7 @@
 #include "hermes/Public/GCConfig.h"
 #include "hermes/Support/JSONEmitter.h"
 #include "hermes/VM/CellKind.h"
+#include "hermes/VM/HeapAlign.h"
 #include "hermes/VM/HermesValue.h"
 #include "hermes/VM/StringRefUtils.h"
 #include "llvm/ADT/DenseMap.h"
@@ -19,6 +20,7 @@
 
 #include <bitset>
 #include <string>
+#include <vector>
 
 namespace hermes {
 namespace vm {
@@ -36,8 +38,25 @@ std::string converter(unsigned index);
 std::string converter(int index);
 std::string converter(const StringPrimitive *str);
 std::string converter(UTF16Ref ref);
+/// Convert at most the first \p maxLength characters of \p str, or all of
+/// them if \p maxLength is zero.
+std::string converter(const StringPrimitive *str, uint32_t maxLength);
 /// @}
 
+/// Options bounding the size of a heap snapshot, and the memory needed to
+/// write it.
+struct HeapSnapshotOptions {
+  /// Whether the JSON should be compact or pretty.
+  bool compact{true};
+  /// If non-zero, objects with more references than this, such as large
+  /// arrays, only have an evenly spaced sample of at most this many of them
+  /// in the snapshot.
+  uint32_t maxEdgesPerNode{0};
+  /// If non-zero, the values of strings are truncated to this many
+  /// characters.
+  uint32_t maxStringLength{0};
+};
+
 /// A serialization formatter for a heap snapshot that outputs a
 /// Facebook-specific data format. This format is JSON, and the full format is
 /// documented at TODO insert link here.
@@ -222,10 +241,27 @@ class V8HeapSnapshot {
 
   explicit V8HeapSnapshot(JSONEmitter &json);
 
+  /// \return the stride at which to sample the \p edgeCount edges of a node,
+  /// so that at most \p maxEdges are kept, or 1 to keep all of them if
+  /// \p maxEdges is zero.
+  static uint32_t edgeSamplingStride(uint32_t edgeCount, uint32_t maxEdges) {
+    return maxEdges == 0 || edgeCount <= maxEdges
+        ? 1
+        : (edgeCount + maxEdges - 1) / maxEdges;
+  }
+
+  /// \return the number of edges kept out of \p edgeCount when sampling
+  /// with \p stride.
+  static uint32_t sampledEdgeCount(uint32_t edgeCount, uint32_t stride) {
+    return (edgeCount + stride - 1) / stride;
+  }
+
   /// NOTE: this destructor writes to \p json.
   ~V8HeapSnapshot();
 
   void beginNodes();
+  /// Add \p node. Nodes must be added in increasing order of their IDs, which
+  /// must be multiples of HeapAlign, such as offsets in the heap.
   void addNode(Node &&node);
   void endNodes();
 
@@ -262,11 +298,27 @@ class V8HeapSnapshot {
     Strings
   };
 
+  /// Maps the IDs of the nodes to their index. Since IDs are added in
+  /// increasing order, the index of a node is the number of IDs below its own,
+  /// which is counted in a bitmap of the IDs with a running count per word.
+  /// This takes 12 bytes per 64 possible IDs, i.e. per 512 bytes of heap,
+  /// however many objects there are.
+  class NodeIndexMap {
+   public:
+    void add(Node::ID id);
+    Node::Index lookup(Node::ID id) const;
+
+   private:
+    std::vector<uint64_t> bits_;
+    /// The number of bits set in the words of bits_ before each one.
+    std::vector<Node::Index> wordRanks_;
+    Node::Index count_{0};
+  };
+
   JSONEmitter &json_;
   std::bitset<8> sectionsWritten_;
   llvm::Optional<Section> currentSection_;
-  llvm::DenseMap<Node::ID, Node::Index> nodeToIndex_;
-  Node::Index nodeCount_{0};
+  NodeIndexMap nodeIndex_;
 #ifndef NDEBUG
   /// How many edges have currently been added.
   Edge::Index edgeCount_{0};
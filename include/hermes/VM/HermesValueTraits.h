@@ -59,7 +59,6 @@ HERMES_VM_GCOBJECT(JSError);
 HERMES_VM_GCOBJECT(JSGenerator);
 HERMES_VM_GCOBJECT(Domain);
 HERMES_VM_GCOBJECT(RequireContext);
-HERMES_VM_GCOBJECT(HashMapEntry);
 HERMES_VM_GCOBJECT(OrderedHashMap);
 HERMES_VM_GCOBJECT(JSWeakMapImplBase);
 HERMES_VM_GCOBJECT(JSArrayIterator);
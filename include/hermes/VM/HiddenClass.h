@@ -16,6 +16,7 @@
 #include "hermes/VM/WeakValueMap.h"
 
 #include <functional>
+#include <memory>
 #include "llvm/ADT/ArrayRef.h"
 
 namespace hermes {
@@ -54,6 +55,11 @@ struct ClassFlags {
   /// properties are "read-only".
   uint32_t allReadOnly : 1;
 
+  /// Some property in this class is internal, or is not an enumerable,
+  /// writable and configurable data property. This flag is set
+  /// conservatively: any change of property flags sets it.
+  uint32_t hasNonDefaultProperties : 1;
+
   ClassFlags() {
     ::memset(this, 0, sizeof(*this));
   }
@@ -98,6 +104,17 @@ struct ClassFlags {
 /// is not shared - it belongs to exactly one object - and updates are done "in
 /// place" instead of creating new child classes.
 ///
+/// Classes with more than \c kLargeClassThreshold properties are "large". A
+/// large chain costs a class per property, so the first object that grows
+/// past a class with exactly \c kLargeClassThreshold properties goes to
+/// dictionary mode, as it would if it were the only object of its shape. If
+/// another object later reaches the same class, the shape is evidently shared
+/// (wide records, e.g. parsed from JSON), and the chain continues with normal
+/// cacheable transitions up to \c kDictionaryThreshold properties.
+///
+/// A dictionary mode class can be replaced with an equivalent shared class
+/// once its object has stopped changing, see \c JSObject::leaveDictionaryMode.
+///
 /// Property Maps
 /// =============
 /// Conceptually every hidden class has a property map - a table mapping from
@@ -117,9 +134,13 @@ class HiddenClass final : public GCCell {
   friend void HiddenClassBuildMeta(const GCCell *cell, Metadata::Builder &mb);
 
  public:
+  /// Growing past a class with this number of properties only continues the
+  /// transition chain once a second object has reached the class.
+  static constexpr unsigned kLargeClassThreshold = 64;
+
   /// Adding more than this number of properties will switch to "dictionary
   /// mode".
-  static constexpr unsigned kDictionaryThreshold = 64;
+  static constexpr unsigned kDictionaryThreshold = 256;
 
   static VTable vt;
 
@@ -138,6 +159,13 @@ class HiddenClass final : public GCCell {
     return transitionMap_.isKnownEmpty();
   }
 
+  /// Drop the property map this class keeps for its children to start from,
+  /// if it has several and the map can be rebuilt from its ancestors. Must
+  /// not be called while a lookup into the map may still be used, since the
+  /// positions in a rebuilt map can differ.
+  /// \return the size of the dropped map, or 0 if it was kept.
+  uint32_t releaseSharedPropertyMap(Runtime *runtime);
+
   /// \return the number of own properties described by this hidden class.
   /// This corresponds to the size of the property map, if it is initialized.
   unsigned getNumProperties() const {
@@ -150,10 +178,25 @@ class HiddenClass final : public GCCell {
     return flags_.dictionaryMode;
   }
 
+  /// \return the version of the property set of a dictionary mode class. It
+  /// changes whenever a property is deleted or its flags are updated in place,
+  /// which are the only in-place mutations that can invalidate a property slot
+  /// cached for this class.
+  uint32_t getDictionaryVersion() const {
+    return dictionaryVersion_;
+  }
+
   bool getHasIndexLikeProperties() const {
     return flags_.hasIndexLikeProperties;
   }
 
+  /// \return true if all the properties of this class are known to be
+  /// enumerable, writable and configurable data properties which are not
+  /// internal, i.e. the properties that an ordinary put would create.
+  bool hasOnlyDefaultProperties() const {
+    return !flags_.hasNonDefaultProperties;
+  }
+
   /// \return a hidden class that we originated from entirely by using "flag
   /// transitions", in other words, one that has exactly the same fields in the
   /// same order as this class, but possibly different property flags.
@@ -174,6 +217,19 @@ class HiddenClass final : public GCCell {
     forInCache_ = nullptr;
   }
 
+  /// \return the storage of the enumerable own property names of objects of
+  /// this class as strings, as returned by Object.keys(), if it has been set,
+  /// otherwise nullptr.
+  BigStorage *getKeysCache(Runtime *runtime) const {
+    return keysCache_.get(runtime);
+  }
+
+  /// Set the storage returned by getKeysCache(). It must have been shared with
+  /// \c ArrayImpl::unsafeShareStorage(), so that it is never modified.
+  void setKeysCache(BigStorage *keys, Runtime *runtime) {
+    keysCache_.set(runtime, keys, &runtime->getHeap());
+  }
+
   /// An opaque class representing a reference to a valid property in the
   /// property map.
   using PropertyPos = DictPropertyMap::PropertyPos;
@@ -315,6 +371,54 @@ class HiddenClass final : public GCCell {
   };
 
  private:
+  /// The transitions from a hidden class to its children. Most classes have
+  /// at most one child, so the first transition is stored inline and a hash
+  /// table is only allocated for the ones added after it.
+  class TransitionMap {
+   public:
+    TransitionMap() = default;
+    TransitionMap(const TransitionMap &) = delete;
+    TransitionMap &operator=(const TransitionMap &) = delete;
+
+    /// \return true if the map is known to be empty. Like
+    /// WeakValueMap::isKnownEmpty(), this can report false negatives.
+    bool isKnownEmpty() const {
+      return !firstSlot_ && (!rest_ || rest_->isKnownEmpty());
+    }
+
+    /// \return true if more than one transition may be present.
+    bool mayHaveMultiple() const {
+      return rest_ && !rest_->isKnownEmpty();
+    }
+
+    /// \return true if there is a live transition for \p key.
+    bool contains(const Transition &key);
+
+    /// Look for the child reached through \p key.
+    llvm::Optional<Handle<HiddenClass>> lookup(
+        HandleRootOwner *runtime,
+        const Transition &key);
+
+    /// Add a transition to \p value if there is none for \p key yet.
+    /// \return true if the transition was inserted.
+    bool insertNew(GC *gc, const Transition &key, Handle<HiddenClass> value);
+
+    /// Mark the valid weak references, and drop the invalid ones. Must be
+    /// invoked during garbage collection.
+    void markWeakRefs(GC *gc);
+
+    size_t getMemorySize() const;
+
+   private:
+    /// The first transition that was added. firstSlot_ is null if there is
+    /// none, or once its target has been collected.
+    Transition firstKey_{SymbolID::empty()};
+    WeakRefSlot *firstSlot_{nullptr};
+
+    /// All other transitions, allocated on the first fan-out.
+    std::unique_ptr<WeakValueMap<Transition, HiddenClass>> rest_{};
+  };
+
   HiddenClass(
       Runtime *runtime,
       ClassFlags flags,
@@ -365,13 +469,22 @@ class HiddenClass final : public GCCell {
       Handle<HiddenClass> selfHandle,
       Runtime *runtime);
 
-  /// Initialize the property map by transferring the parent's map to ourselves
-  /// and adding a our property to it. It must only be called if we don't have a
+  /// Initialize the property map by transferring the parent's map (or a copy
+  /// of it) to ourselves and adding a our property to it. It must only be called if we don't have a
   /// property map of our own but have a valid parent with a property map.
   static void stealPropertyMapFromParent(
       Handle<HiddenClass> selfHandle,
       Runtime *runtime);
 
+  /// Give the property map of \p selfHandle to its child \p childHandle,
+  /// which has none. The map is moved, unless \p selfHandle may have other
+  /// children, in which case the child gets a copy and \p selfHandle keeps
+  /// its map for them.
+  static void transferPropertyMapToChild(
+      Handle<HiddenClass> selfHandle,
+      Handle<HiddenClass> childHandle,
+      Runtime *runtime);
+
   /// Free all non-GC managed resources associated with the object.
   static void _finalizeImpl(GCCell *cell, GC *gc);
 
@@ -410,6 +523,15 @@ class HiddenClass final : public GCCell {
   /// property.
   unsigned numProperties_;
 
+  /// Incremented every time a property is deleted or its flags are changed
+  /// while in dictionary mode. See \c getDictionaryVersion().
+  uint32_t dictionaryVersion_{0};
+
+  /// Set once an object has tried to add a property to this class when it
+  /// had \c kLargeClassThreshold properties and no transition for it. The
+  /// next such object gets a shared child instead of a dictionary.
+  bool largeGrowthSeen_{false};
+
   /// Optional property map of all properties defined by this hidden class.
   /// This includes \c symbolID_, \c parent_->symbolID_, \c
   /// parent_->parent_->symbolID_ and so on (in reverse order).
@@ -417,13 +539,17 @@ class HiddenClass final : public GCCell {
   /// when a transition is performed from the parent class to this one.
   GCPointer<DictPropertyMap> propertyMap_{};
 
-  /// This hash table encodes the transitions from this class to child classes
+  /// This table encodes the transitions from this class to child classes
   /// keyed on the property being added (or updated) and its flags.
-  WeakValueMap<Transition, HiddenClass> transitionMap_;
+  TransitionMap transitionMap_;
 
   /// Cache that contains for-in property names for objects of this class.
   /// Never used in dictionary mode.
   GCPointer<BigStorage> forInCache_{};
+
+  /// Shared storage of the Object.keys() names of objects of this class.
+  /// Never used in dictionary mode.
+  GCPointer<BigStorage> keysCache_{};
 };
 
 //===----------------------------------------------------------------------===//
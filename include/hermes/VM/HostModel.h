@@ -121,10 +121,32 @@ class HostObject final : public JSObject {
     return proxy_->getHostPropertyNames();
   }
 
+  /// Read the host property \p name once and store its value in an own
+  /// read-only, non-configurable and non-enumerable property. Own properties
+  /// win over host properties, so later reads find it in ordinary storage,
+  /// where the property caches of the interpreter can find it, instead of
+  /// calling the proxy. Writes to it fail instead of reaching the proxy.
+  /// Nothing is done if \p name is already an own property.
+  static ExecutionStatus cacheStableProperty(
+      Handle<HostObject> selfHandle,
+      Runtime *runtime,
+      SymbolID name);
+
   const std::shared_ptr<HostObjectProxy> &getProxy() const {
     return proxy_;
   }
 
+  /// Charge \p size bytes of native memory kept alive by this object to the
+  /// heap, replacing the previous charge, so that collections are scheduled
+  /// as if the heap held that much more data while the object is alive.
+  /// \return false, leaving the charge unchanged, if the heap cannot account
+  ///   for that much memory.
+  bool setExternalMemorySize(GC *gc, uint32_t size);
+
+  /// \return the native memory charged to \p cell if it is a HostObject,
+  ///   otherwise 0.
+  inline static uint32_t externalMemorySize(const GCCell *cell);
+
  private:
   HostObject(
       Runtime *runtime,
@@ -136,8 +158,20 @@ class HostObject final : public JSObject {
   static void _finalizeImpl(GCCell *cell, GC *gc);
 
   std::shared_ptr<HostObjectProxy> proxy_;
+
+  /// The native memory charged to the heap for this object.
+  uint32_t externalMemorySize_{0};
 };
 
+/*static*/
+inline uint32_t HostObject::externalMemorySize(const GCCell *cell) {
+  if (const auto asHostObject = dyn_vmcast<HostObject>(cell)) {
+    return asHostObject->externalMemorySize_;
+  } else {
+    return 0;
+  }
+}
+
 } // namespace vm
 } // namespace hermes
 
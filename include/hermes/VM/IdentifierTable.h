@@ -92,7 +92,9 @@ class IdentifierTable {
 
   /// Register a lazy ASCII identifier from a bytecode module or as predefined
   /// identifier.
-  /// This function should only be called during initialization of a module.
+  /// This function should only be called for the strings of the bytecode of a
+  /// persistent module, or for predefined identifiers. It does not allocate in
+  /// the GC heap.
   SymbolID registerLazyIdentifier(ASCIIRef str);
   SymbolID registerLazyIdentifier(ASCIIRef str, uint32_t hash);
 
@@ -114,6 +116,16 @@ class IdentifierTable {
   /// that getIdentifier(str) == id.
   StringView getStringView(Runtime *runtime, SymbolID id) const;
 
+  /// \return the hash of the string of \p id, as computed by
+  /// hermes::hashString().
+  uint32_t getHash(SymbolID id) const {
+    return getLookupTableEntry(id).getHash();
+  }
+
+  /// \return the SymbolID of \p str if it is interned, or an invalid SymbolID
+  /// otherwise. This doesn't intern the string.
+  static SymbolID getSymbolIDIfUniqued(const StringPrimitive *str);
+
   /// Extract a symbol's name into an ASCII character buffer without performing
   /// any GC operations. This is used for debugging and logging only.
   void debugGetSymbolName(
@@ -73,6 +73,22 @@ class Interpreter {
       Handle<Callable> curFunction,
       bool strictMode);
 
+  /// Implement OpCode::ApplyArguments, the call
+  /// \p callee(\p function, \p thisArg, arguments), where \p lazyReg is the
+  /// lazy 'arguments' register of the current frame. If \p callee is
+  /// Function.prototype.apply and \p lazyReg is still uninitialized,
+  /// \p function is called with the arguments of the current frame, which are
+  /// copied directly into the new frame. Otherwise 'arguments' is reified into
+  /// \p lazyReg and the call is made as written.
+  static CallResult<HermesValue> applyArguments_RJS(
+      Runtime *runtime,
+      PinnedHermesValue *lazyReg,
+      Handle<> callee,
+      Handle<> function,
+      Handle<> thisArg,
+      Handle<Callable> curFunction,
+      bool strictMode);
+
   static ExecutionStatus handleGetPNameList(
       Runtime *runtime,
       PinnedHermesValue *frameRegs,
@@ -89,6 +105,13 @@ class Interpreter {
       Runtime *runtime,
       PinnedHermesValue *callTarget);
 
+  /// Implement a call to Function.prototype.call, whose callee frame is at the
+  /// top of the stack and whose 'this' is a \c Callable. Instead of copying
+  /// the arguments into a new frame, the frame is moved up by one register so
+  /// that the first argument becomes 'this', and the target is called in it.
+  /// The original frame is restored before returning.
+  static CallResult<HermesValue> callFunctionPrototypeCall(Runtime *runtime);
+
   /// Fast path to get primitive value \p base's own properties by name \p id
   /// without boxing.
   /// Primitive own properties are properties fetching values from primitive
@@ -135,23 +158,41 @@ class Interpreter {
   /// \param numLiterals the amount of literals to read from the buffer.
   /// \param keyBufferIndex the first element of the key buffer to read.
   /// \param valBufferIndex the first element of the val buffer to read.
+  /// \param ip the allocating instruction, whose allocation site feedback is
+  ///   used if the GC supports it. May be null.
   /// \return ExecutionStatus::EXCEPTION if the property definitions throw.
   static CallResult<HermesValue> createObjectFromBuffer(
       Runtime *runtime,
       CodeBlock *curCodeBlock,
       unsigned numLiterals,
       unsigned keyBufferIndex,
-      unsigned valBufferIndex);
+      unsigned valBufferIndex,
+      const inst::Inst *ip);
 
   /// Populates an array with literal values from the array buffer.
   /// \param numLiterals the amount of literals to read from the buffer.
   /// \param bufferIndex the first element of the buffer to read.
+  /// \param ip the allocating instruction, whose allocation site feedback is
+  ///   used if the GC supports it. May be null.
   /// \return ExecutionStatus::EXCEPTION if the property definitions throw.
   static CallResult<HermesValue> createArrayFromBuffer(
       Runtime *runtime,
       CodeBlock *curCodeBlock,
       unsigned numElements,
       unsigned numLiterals,
+      unsigned bufferIndex,
+      const inst::Inst *ip);
+
+  /// Creates and caches the template object \p templateObjID of the module
+  /// of \p curCodeBlock, from the arguments of getTemplateObject() stored in
+  /// the array buffer after the ID.
+  /// \param numLiterals the amount of literals to read from the buffer.
+  /// \param bufferIndex the first element of the buffer to read.
+  static CallResult<HermesValue> createTemplateObjectFromBuffer(
+      Runtime *runtime,
+      CodeBlock *curCodeBlock,
+      uint32_t templateObjID,
+      unsigned numLiterals,
       unsigned bufferIndex);
 
 #ifdef HERMES_ENABLE_DEBUGGER
@@ -203,6 +244,25 @@ class Interpreter {
       Runtime *runtime,
       PinnedHermesValue *frameRegs,
       const inst::Inst *ip);
+
+  /// Begin a for..of iteration, by index for arrays that can be iterated
+  /// without an iterator object.
+  static ExecutionStatus caseIteratorBegin(
+      Runtime *runtime,
+      PinnedHermesValue *frameRegs,
+      const inst::Inst *ip);
+
+  /// Slow path of OpCode::IteratorNext: the iterator protocol, or an element
+  /// that is not in the storage of an array iterated by index.
+  static ExecutionStatus caseIteratorNext(
+      Runtime *runtime,
+      PinnedHermesValue *frameRegs,
+      const inst::Inst *ip);
+
+  static ExecutionStatus caseIteratorClose(
+      Runtime *runtime,
+      PinnedHermesValue *frameRegs,
+      const inst::Inst *ip);
 };
 
 } // namespace vm
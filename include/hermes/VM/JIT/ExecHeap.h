@@ -46,9 +46,42 @@ class ExecHeap {
   /// Construct an empty execitable heap. New individual pools will be allocated
   /// with the specified heap sizes up to the total of the specified \p
   /// maxMemory.
-  ExecHeap(size_t firstHeapSize, size_t secondHeapSize, size_t maxMemory);
+  /// \param writeXorExecute whether the memory must never be writable and
+  ///   executable at the same time. Pools are then only executable, except
+  ///   within a WriteAccess, where they are only writable.
+  ExecHeap(
+      size_t firstHeapSize,
+      size_t secondHeapSize,
+      size_t maxMemory,
+      bool writeXorExecute = false);
   ~ExecHeap();
 
+  /// Allows writing the memory of the heap while it exists. With W^X, none of
+  /// the code in the heap may run until it is destroyed, which makes the
+  /// memory executable again and invalidates the instruction cache.
+  /// Instances can be nested.
+  class WriteAccess {
+   public:
+    explicit WriteAccess(ExecHeap &heap) : heap_(heap) {
+      heap_.beginWrite();
+    }
+    ~WriteAccess() {
+      heap_.endWrite();
+    }
+
+    WriteAccess(const WriteAccess &) = delete;
+    void operator=(const WriteAccess &) = delete;
+
+   private:
+    ExecHeap &heap_;
+  };
+
+  /// \return true if the memory is never writable and executable at the same
+  ///   time.
+  bool isWriteXorExecute() const {
+    return writeXorExecute_;
+  }
+
   /// Allocate a new pool with the pre-configured size and add it to the list
   /// of available pools. The new pool is owned by the class, but is returned in
   /// case the caller wants to pre-allocate stuff in it.
@@ -81,6 +114,15 @@ class ExecHeap {
     // Possibly use  __builtin___clear_cache() for better performance?
   }
 
+  /// \return the total size of the blocks allocated in both heaps of every
+  ///   pool.
+  size_t getAllocatedSize() const;
+
+  /// \return the size of the executable memory mapped by the pools.
+  size_t getMappedSize() const {
+    return pools_.size() * (firstHeapSize_ + secondHeapSize_);
+  }
+
   /// Dump the heap metadata to the specified output stream.
   /// \param OS the output stream to dump to.
   /// \param relativePointers if true all pointers are printed relative to the
@@ -108,6 +150,14 @@ class ExecHeap {
       return secondHeap_;
     }
 
+    const PoolHeap &getFirstHeap() const {
+      return firstHeap_;
+    }
+
+    const PoolHeap &getSecondHeap() const {
+      return secondHeap_;
+    }
+
     /// \return true if the specified pointer is contained inside one of the
     ///   two heaps.
     bool contains(uint8_t *p) const {
@@ -134,8 +184,27 @@ class ExecHeap {
     bool isEntirelyFree() const {
       return firstHeap_.isEntirelyFree() && secondHeap_.isEntirelyFree();
     }
+
+    /// Change the protection of the whole pool to \p flags, a combination of
+    /// llvm::sys::Memory::ProtectionFlags. Invalidate the instruction cache
+    /// when the pool becomes executable.
+    void protect(unsigned flags);
   };
 
+ private:
+  /// Make every pool writable if it is the first WriteAccess.
+  void beginWrite();
+  /// Make every pool executable again if it is the last WriteAccess.
+  void endWrite();
+
+  /// \return the protection of new pools in the current state.
+  unsigned currentProtection() const;
+
+  /// Whether the memory is never writable and executable at the same time.
+  bool const writeXorExecute_;
+  /// The number of live WriteAccess instances.
+  unsigned writers_{0};
+
  public:
   /// The size of the first heap in every new DualPool.
   size_t const firstHeapSize_;
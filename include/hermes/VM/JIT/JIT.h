@@ -9,12 +9,20 @@
 
 #ifdef HERMESVM_JIT
 
+#if defined(__aarch64__)
+#include "hermes/VM/JIT/aarch64/JIT.h"
+#else
 #include "hermes/VM/JIT/x86-64/JIT.h"
+#endif
 
 namespace hermes {
 namespace vm {
 
+#if defined(__aarch64__)
+using aarch64::JITContext;
+#else
 using x86_64::JITContext;
+#endif
 
 } // namespace vm
 } // namespace hermes
@@ -36,7 +44,13 @@ class JITContext {
   ///     allocated.
   /// \param maximum amount of executable memory that can be allocated by the
   ///     JIT.
-  JITContext(bool enable, size_t blockSize, size_t maxMemory) {}
+  /// \param threshold the hotness a function must reach before it is
+  ///     compiled.
+  JITContext(
+      bool enable,
+      size_t blockSize,
+      size_t maxMemory,
+      uint32_t threshold = 0) {}
   ~JITContext() = default;
 
   JITContext(const JITContext &) = delete;
@@ -51,6 +65,11 @@ class JITContext {
     return codeBlock->getJITCompiled();
   }
 
+  /// \return false since there is no native code to continue in.
+  bool shouldAttemptOSR(const CodeBlock *codeBlock) const {
+    return false;
+  }
+
   /// \return true if JIT compilation is enabled.
   bool isEnabled() const {
     return false;
@@ -59,6 +78,11 @@ class JITContext {
   /// Enable or disable JIT compilation.
   void setEnabled(bool enabled) {}
 
+  /// \return the hotness a function must reach before it is compiled.
+  uint32_t getThreshold() const {
+    return 0;
+  }
+
   /// Enable or disable dumping JIT'ed Code.
   void setDumpJITCode(bool dump) {}
 
@@ -74,6 +98,54 @@ class JITContext {
   bool getCrashOnError() {
     return false;
   }
+
+  /// Describe the compiled code to Linux perf. There is none without the JIT.
+  void enablePerfMap(bool jitdump) {}
+
+  /// Make the interpreter call every JS function through its own trampoline.
+  /// Trampolines are generated code, so this does nothing without the JIT.
+  void enableInterpreterTrampolines(bool jitdump) {}
+
+  /// \return false since there are no trampolines.
+  bool hasInterpreterTrampolines() const {
+    return false;
+  }
+
+  /// \return null since there are no trampolines.
+  InterpreterTrampolinePtr getInterpreterTrampoline(
+      Runtime *runtime,
+      CodeBlock *codeBlock,
+      InterpreterTrampolinePtr target) {
+    return nullptr;
+  }
+
+  /// \return 0 since there is no native code to free.
+  size_t evictInactive(Runtime *runtime) {
+    return 0;
+  }
+
+  /// There is no native code to free without the JIT.
+  void freeCode(CodeBlock *codeBlock) {}
+
+  /// \return 0 since there is no native code.
+  size_t getCodeSize() const {
+    return 0;
+  }
+
+  /// \return 0 since no executable memory is mapped.
+  size_t getMappedSize() const {
+    return 0;
+  }
+
+  /// Enable or disable reporting the reason why functions couldn't be
+  /// compiled.
+  void setReportBailouts(bool report) {}
+
+  /// \return true if the reason why functions couldn't be compiled is
+  ///   reported.
+  bool getReportBailouts() {
+    return false;
+  }
 };
 
 } // namespace vm
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_VM_JIT_PERFMAP_H
+#define HERMES_VM_JIT_PERFMAP_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+namespace hermes {
+namespace vm {
+
+class CodeBlock;
+class Runtime;
+
+/// Describes code generated at runtime to the Linux perf tool, which can
+/// otherwise only attribute the samples taken in it to anonymous memory.
+/// - /tmp/perf-<pid>.map lists the address, size and name of every piece of
+///   code, and is read by `perf report` as is.
+/// - jit-<pid>.dump, in the current directory, also has the bytes of the code
+///   and its source lines, in the jitdump format of the Linux tools.
+///   `perf inject --jit` turns it into ELF files, provided that the samples
+///   were recorded with `perf record -k 1`.
+/// The files are per process, so all the runtimes share a single PerfMap.
+class PerfMap {
+ public:
+  /// The source line of the code starting at an address.
+  struct LineEntry {
+    const void *address;
+    uint32_t line;
+  };
+
+  /// \return the PerfMap of the process, which opens its files on the first
+  /// call. The jitdump file is only written if \p jitdump is true on that
+  /// call.
+  static PerfMap &get(bool jitdump);
+
+  /// Describe the \p size bytes of code at \p code as \p name. In the jitdump
+  /// file, also describe the ranges of the code starting at each entry of
+  /// \p lines, sorted by address, as lines of \p filename.
+  void addCode(
+      const void *code,
+      size_t size,
+      llvm::StringRef name,
+      llvm::StringRef filename = "",
+      llvm::ArrayRef<LineEntry> lines = {});
+
+ private:
+  explicit PerfMap(bool jitdump);
+
+  /// Open the jitdump file, write its header and map it into the process, so
+  /// that perf records where it is.
+  void openJITDump();
+
+  /// Append \p size bytes at \p data to the jitdump file.
+  void writeJITDump(const void *data, size_t size);
+
+  /// Serializes the writes of all threads.
+  std::mutex mutex_;
+  FILE *map_{nullptr};
+  int jitDump_{-1};
+  /// Number of code load records written to the jitdump file.
+  uint64_t codeIndex_{0};
+};
+
+/// \return the name of \p codeBlock in a PerfMap: the function name, followed
+/// by where the function starts if there is debug info. In that case, also set
+/// \p filename to the file of the function.
+std::string getPerfName(
+    Runtime *runtime,
+    CodeBlock *codeBlock,
+    std::string &filename);
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_JIT_PERFMAP_H
@@ -34,6 +34,11 @@ class PoolHeap {
     return allocList_.empty();
   }
 
+  /// \return the total size of the allocated blocks.
+  size_t getAllocatedSize() const {
+    return allocatedSize_;
+  }
+
   /// Allocate a block of size \p size.
   /// \return the address of the block or nullptr if no memory.
   void *alloc(size_t size);
@@ -73,6 +78,9 @@ class PoolHeap {
   /// the value is block size.
   BlockMap allocList_;
 
+  /// The sum of the sizes in \c allocList_.
+  size_t allocatedSize_{0};
+
   /// Free a tail section or the entirety of the referenced allocated block. It
   /// splits the allocated block into an optional allocated block and a freed
   /// block.
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_VM_JIT_REGEXPJIT_H
+#define HERMES_VM_JIT_REGEXPJIT_H
+
+// Regexps are only compiled on x86-64 so far.
+#if defined(HERMESVM_JIT) && !defined(__aarch64__)
+
+#include "hermes/VM/JIT/x86-64/RegExpJIT.h"
+
+namespace hermes {
+namespace vm {
+
+using x86_64::JITCompiledRegExp;
+
+} // namespace vm
+} // namespace hermes
+
+#else
+
+#include "hermes/Regex/Executor.h"
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/ErrorHandling.h"
+
+#include <memory>
+
+namespace hermes {
+namespace vm {
+
+#ifdef HERMESVM_JIT
+namespace aarch64 {
+class JITContext;
+} // namespace aarch64
+using aarch64::JITContext;
+#else
+class JITContext;
+#endif
+
+/// The native code of a regexp. Without a JIT for the target, regexps are never
+/// compiled.
+class JITCompiledRegExp {
+ public:
+  /// Number of interpreted searches after which a regexp is compiled.
+  static constexpr uint32_t kSearchThreshold = 0;
+
+  /// \return null since there is no JIT.
+  static std::unique_ptr<JITCompiledRegExp> compile(
+      JITContext &context,
+      llvm::ArrayRef<uint8_t> bytecode) {
+    return nullptr;
+  }
+
+  regex::MatchRuntimeResult search(
+      const char16_t *first,
+      const char16_t *last,
+      regex::MatchResults<const char16_t *> &m,
+      regex::constants::MatchFlagType matchFlags) const {
+    llvm_unreachable("regexps are never compiled without a JIT");
+  }
+
+  regex::MatchRuntimeResult search(
+      const char *first,
+      const char *last,
+      regex::MatchResults<const char *> &m,
+      regex::constants::MatchFlagType matchFlags) const {
+    llvm_unreachable("regexps are never compiled without a JIT");
+  }
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMESVM_JIT && !__aarch64__
+#endif // HERMES_VM_JIT_REGEXPJIT_H
@@ -0,0 +1,465 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+//===----------------------------------------------------------------------===//
+/// \file
+/// The AArch64 binary instruction emitter. Every instruction is a single
+/// little-endian 32-bit word, so unlike on x86-64 the encodings are simply
+/// built by or-ing the operands into a fixed opcode.
+//===----------------------------------------------------------------------===//
+
+#ifndef HERMES_VM_JIT_AARCH64_EMITTER_H
+#define HERMES_VM_JIT_AARCH64_EMITTER_H
+
+#include "hermes/Support/Compiler.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+namespace hermes {
+namespace vm {
+namespace aarch64 {
+
+/// A general purpose 64-bit register. Register 31 is either the stack pointer
+/// or the zero register, depending on the instruction.
+enum class Reg : uint8_t {
+  x0 = 0,
+  x1,
+  x2,
+  x3,
+  x4,
+  x5,
+  x6,
+  x7,
+  x8,
+  x9,
+  x10,
+  x11,
+  x12,
+  x13,
+  x14,
+  x15,
+  /// The intra-procedure-call scratch registers. x16 holds the target of
+  /// calls, and x17 is clobbered by the emitter to materialize offsets.
+  x16,
+  x17,
+  x18,
+  x19,
+  x20,
+  x21,
+  x22,
+  x23,
+  x24,
+  x25,
+  x26,
+  x27,
+  x28,
+  /// The frame pointer.
+  x29,
+  /// The link register.
+  x30,
+  sp = 31,
+  xzr = 31,
+};
+
+/// A 64-bit floating point register.
+enum class FReg : uint8_t {
+  d0 = 0,
+  d1,
+  d2,
+  d3,
+  d4,
+  d5,
+  d6,
+  d7,
+};
+
+/// The condition of a conditional branch, as tested on the flags.
+enum class CCode : uint8_t {
+  EQ = 0,
+  NE = 1,
+  /// Unsigned higher or same.
+  HS = 2,
+  /// Unsigned lower.
+  LO = 3,
+  MI = 4,
+  PL = 5,
+  VS = 6,
+  VC = 7,
+  /// Unsigned higher.
+  HI = 8,
+  /// Unsigned lower or same.
+  LS = 9,
+  GE = 10,
+  LT = 11,
+  GT = 12,
+  LE = 13,
+  AL = 14,
+};
+
+/// \return the condition that holds exactly when \p cc doesn't.
+constexpr CCode invert(CCode cc) {
+  return static_cast<CCode>(static_cast<uint8_t>(cc) ^ 1);
+}
+
+/// The register clobbered by the emitter when an offset doesn't fit in the
+/// instruction.
+constexpr Reg kScratchReg = Reg::x17;
+
+/// Encodes AArch64 instructions into a buffer. The emitter is a single pointer
+/// and is passed and returned by value.
+class Emitter {
+ public:
+  static constexpr unsigned kInstructionSize = 4;
+
+  explicit Emitter(uint8_t *buf) : out(buf) {}
+
+  Emitter(const Emitter &) = default;
+  Emitter &operator=(const Emitter &) = default;
+  ~Emitter() = default;
+
+  /// \return the current output pointer.
+  uint8_t *current() const {
+    return out;
+  }
+
+  /// Set the current output pointer.
+  void setCurrent(uint8_t *buf) {
+    out = buf;
+  }
+
+  /// Emit the raw instruction \p insn.
+  void emit(uint32_t insn) {
+    memcpy(out, &insn, sizeof(insn));
+    out += sizeof(insn);
+  }
+
+  /// mov dst, src. Either may be sp.
+  void movRegToReg(Reg src, Reg dst) {
+    if (src == Reg::sp || dst == Reg::sp)
+      addImm(src, 0, dst);
+    else
+      emit(0xAA0003E0 | ord(src) << 16 | ord(dst));
+  }
+
+  /// Load the 64-bit immediate \p imm into \p dst with a movz, or a movn if
+  /// more halfwords are 0xffff than zero, followed by a movk for every
+  /// halfword that differs from the initial fill.
+  void movImmToReg(uint64_t imm, Reg dst) {
+    int ones = 0;
+    for (unsigned hw = 0; hw != 4; ++hw) {
+      uint32_t chunk = (imm >> (16 * hw)) & 0xFFFF;
+      ones += chunk == 0xFFFF ? 1 : chunk == 0 ? -1 : 0;
+    }
+    const bool inverted = ones > 0;
+    const uint32_t fill = inverted ? 0xFFFF : 0;
+    bool first = true;
+    for (unsigned hw = 0; hw != 4; ++hw) {
+      uint32_t chunk = (imm >> (16 * hw)) & 0xFFFF;
+      if (chunk == fill)
+        continue;
+      if (!first)
+        emit(0xF2800000 | hw << 21 | chunk << 5 | ord(dst));
+      else if (inverted)
+        emit(0x92800000 | hw << 21 | (~chunk & 0xFFFF) << 5 | ord(dst));
+      else
+        emit(0xD2800000 | hw << 21 | chunk << 5 | ord(dst));
+      first = false;
+    }
+    if (first)
+      emit((inverted ? 0x92800000 : 0xD2800000) | ord(dst));
+  }
+
+  /// add dst, src, #imm, with \p imm in [0, 4096).
+  void addImm(Reg src, uint32_t imm, Reg dst) {
+    assert(imm < 4096 && "add immediate out of range");
+    emit(0x91000000 | imm << 10 | ord(src) << 5 | ord(dst));
+  }
+
+  /// sub dst, src, #imm, with \p imm in [0, 4096).
+  void subImm(Reg src, uint32_t imm, Reg dst) {
+    assert(imm < 4096 && "sub immediate out of range");
+    emit(0xD1000000 | imm << 10 | ord(src) << 5 | ord(dst));
+  }
+
+  /// add dst, src1, src2.
+  void addReg(Reg src1, Reg src2, Reg dst) {
+    emit(0x8B000000 | ord(src2) << 16 | ord(src1) << 5 | ord(dst));
+  }
+
+  /// sub dst, src1, src2.
+  void subReg(Reg src1, Reg src2, Reg dst) {
+    emit(0xCB000000 | ord(src2) << 16 | ord(src1) << 5 | ord(dst));
+  }
+
+  /// add dst, base, #offset, for any \p offset. Clobbers kScratchReg if it
+  /// doesn't fit in an immediate.
+  void addOffset(Reg base, int32_t offset, Reg dst) {
+    if (offset >= 0 && offset < 4096) {
+      addImm(base, offset, dst);
+    } else if (offset < 0 && offset > -4096) {
+      subImm(base, -offset, dst);
+    } else {
+      movImmToReg((uint64_t)(int64_t)offset, kScratchReg);
+      addReg(base, kScratchReg, dst);
+    }
+  }
+
+  /// cmp src1, src2 on 64 bits.
+  void cmpRegToReg(Reg src1, Reg src2) {
+    emit(0xEB00001F | ord(src2) << 16 | ord(src1) << 5);
+  }
+
+  /// cmp src, #imm on 32 bits, with \p imm in [0, 4096).
+  void cmpImmToWReg(uint32_t imm, Reg src) {
+    assert(imm < 4096 && "cmp immediate out of range");
+    emit(0x7100001F | imm << 10 | ord(src) << 5);
+  }
+
+  /// cmp src1, src2 on 32 bits.
+  void cmpWRegToWReg(Reg src1, Reg src2) {
+    emit(0x6B00001F | ord(src2) << 16 | ord(src1) << 5);
+  }
+
+  /// tst src, #0xff: set Z if the low byte of \p src is zero.
+  void testLowByte(Reg src) {
+    emit(0x72001C1F | ord(src) << 5);
+  }
+
+  /// lsr dst, src, #shift.
+  void lsrImm(Reg src, unsigned shift, Reg dst) {
+    assert(shift < 64 && "shift out of range");
+    emit(0xD340FC00 | shift << 16 | ord(src) << 5 | ord(dst));
+  }
+
+  /// @name Loads and stores
+  /// The offsets can be anything: they are encoded as a scaled unsigned
+  /// immediate or an unscaled signed one when possible, and are otherwise
+  /// added to the base in kScratchReg, which must not be the base.
+  /// @{
+
+  /// ldr dst, [base, #offset] on 64 bits.
+  void ldrRMToReg(Reg base, int32_t offset, Reg dst) {
+    loadStore(0xF9400000, 0xF8400000, 0xF8606800, 3, base, offset, ord(dst));
+  }
+  /// str src, [base, #offset] on 64 bits.
+  void strRegToRM(Reg src, Reg base, int32_t offset) {
+    loadStore(0xF9000000, 0xF8000000, 0xF8206800, 3, base, offset, ord(src));
+  }
+  /// ldr dst, [base, #offset] on 32 bits, zero-extended.
+  void ldrRMToWReg(Reg base, int32_t offset, Reg dst) {
+    loadStore(0xB9400000, 0xB8400000, 0xB8606800, 2, base, offset, ord(dst));
+  }
+  /// ldr dst, [base, #offset] into a floating point register.
+  void ldrRMToFReg(Reg base, int32_t offset, FReg dst) {
+    loadStore(0xFD400000, 0xFC400000, 0xFC606800, 3, base, offset, ord(dst));
+  }
+  /// str src, [base, #offset] from a floating point register.
+  void strFRegToRM(FReg src, Reg base, int32_t offset) {
+    loadStore(0xFD000000, 0xFC000000, 0xFC206800, 3, base, offset, ord(src));
+  }
+
+  /// str src, [base, #offset]! on 64 bits, with \p offset in [-256, 256).
+  void strRegToRMPreIndex(Reg src, Reg base, int32_t offset) {
+    assert(offset >= -256 && offset < 256 && "pre-index offset out of range");
+    emit(0xF8000C00 | ((uint32_t)offset & 0x1FF) << 12 | ord(base) << 5 |
+         ord(src));
+  }
+
+  /// stp src1, src2, [sp, #offset]!
+  void stpPreIndex(Reg src1, Reg src2, int32_t offset) {
+    emit(0xA9800000 | pairOffset(offset) | ord(src2) << 10 | 31 << 5 |
+         ord(src1));
+  }
+  /// ldp dst1, dst2, [sp], #offset
+  void ldpPostIndex(Reg dst1, Reg dst2, int32_t offset) {
+    emit(0xA8C00000 | pairOffset(offset) | ord(dst2) << 10 | 31 << 5 |
+         ord(dst1));
+  }
+  /// stp src1, src2, [sp, #offset]
+  void stp(Reg src1, Reg src2, int32_t offset) {
+    emit(0xA9000000 | pairOffset(offset) | ord(src2) << 10 | 31 << 5 |
+         ord(src1));
+  }
+  /// ldp dst1, dst2, [sp, #offset]
+  void ldp(Reg dst1, Reg dst2, int32_t offset) {
+    emit(0xA9400000 | pairOffset(offset) | ord(dst2) << 10 | 31 << 5 |
+         ord(dst1));
+  }
+
+  /// @}
+
+  /// @name Floating point
+  /// @{
+
+  /// fadd dst, src1, src2.
+  void faddRegs(FReg src1, FReg src2, FReg dst) {
+    emit(0x1E602800 | ord(src2) << 16 | ord(src1) << 5 | ord(dst));
+  }
+  /// fsub dst, src1, src2.
+  void fsubRegs(FReg src1, FReg src2, FReg dst) {
+    emit(0x1E603800 | ord(src2) << 16 | ord(src1) << 5 | ord(dst));
+  }
+  /// fmul dst, src1, src2.
+  void fmulRegs(FReg src1, FReg src2, FReg dst) {
+    emit(0x1E600800 | ord(src2) << 16 | ord(src1) << 5 | ord(dst));
+  }
+  /// fdiv dst, src1, src2.
+  void fdivRegs(FReg src1, FReg src2, FReg dst) {
+    emit(0x1E601800 | ord(src2) << 16 | ord(src1) << 5 | ord(dst));
+  }
+  /// fcmp src1, src2. An unordered result sets C and V.
+  void fcmpRegs(FReg src1, FReg src2) {
+    emit(0x1E602000 | ord(src2) << 16 | ord(src1) << 5);
+  }
+
+  /// @}
+
+  /// @name Branches
+  /// The targets of the direct branches must be in range, see
+  /// canBranch26() and canBranch19(), except for bcondFar().
+  /// @{
+
+  /// b target
+  void b(const uint8_t *target) {
+    assert(canBranch26(out, target) && "branch out of range");
+    emit(0x14000000 | branchOffset(out, target, 26));
+  }
+
+  /// b.cc target
+  void bcond(CCode cc, const uint8_t *target) {
+    assert(canBranch19(out, target) && "conditional branch out of range");
+    emit(0x54000000 | branchOffset(out, target, 19) << 5 | (uint32_t)cc);
+  }
+
+  /// b.cc target, or a b over an unconditional branch to \p target if it is
+  /// too far.
+  void bcondFar(CCode cc, const uint8_t *target) {
+    if (canBranch19(out, target)) {
+      bcond(cc, target);
+    } else {
+      emit(0x54000000 | 2 << 5 | (uint32_t)invert(cc));
+      b(target);
+    }
+  }
+
+  /// blr target
+  void blr(Reg target) {
+    emit(0xD63F0000 | ord(target) << 5);
+  }
+
+  /// br target
+  void br(Reg target) {
+    emit(0xD61F0000 | ord(target) << 5);
+  }
+
+  /// ret
+  void ret() {
+    emit(0xD65F03C0);
+  }
+
+  /// brk #imm
+  void brk(uint16_t imm) {
+    emit(0xD4200000 | (uint32_t)imm << 5);
+  }
+
+  /// \return true if an unconditional branch at \p from can reach \p to.
+  static bool canBranch26(const uint8_t *from, const uint8_t *to) {
+    return fitsBranch(to - from, 26);
+  }
+
+  /// \return true if a conditional branch at \p from can reach \p to.
+  static bool canBranch19(const uint8_t *from, const uint8_t *to) {
+    return fitsBranch(to - from, 19);
+  }
+
+  /// Retarget the branch emitted at \p insn, unconditional if \p bits is 26
+  /// and conditional if it is 19, to \p target, which must be in range.
+  static void
+  patchBranch(uint8_t *insn, const uint8_t *target, unsigned bits) {
+    uint32_t word;
+    memcpy(&word, insn, sizeof(word));
+    uint32_t mask = (1u << bits) - 1;
+    unsigned shift = bits == 26 ? 0 : 5;
+    word &= ~(mask << shift);
+    word |= branchOffset(insn, target, bits) << shift;
+    memcpy(insn, &word, sizeof(word));
+  }
+
+  /// @}
+
+ private:
+  static constexpr uint32_t ord(Reg reg) {
+    return static_cast<uint32_t>(reg);
+  }
+  static constexpr uint32_t ord(FReg reg) {
+    return static_cast<uint32_t>(reg);
+  }
+
+  /// \return true if a byte distance \p dist can be encoded in a branch with
+  /// a \p bits wide signed instruction count.
+  static bool fitsBranch(ptrdiff_t dist, unsigned bits) {
+    ptrdiff_t limit = (ptrdiff_t)1 << (bits + 1);
+    return (dist & 3) == 0 && dist >= -limit && dist < limit;
+  }
+
+  /// \return the instruction count from \p from to \p to, truncated to
+  /// \p bits.
+  static uint32_t
+  branchOffset(const uint8_t *from, const uint8_t *to, unsigned bits) {
+    return (uint32_t)((to - from) >> 2) & ((1u << bits) - 1);
+  }
+
+  /// \return the encoded offset of a load or store pair of 64-bit registers.
+  static uint32_t pairOffset(int32_t offset) {
+    assert(
+        offset % 8 == 0 && offset >= -512 && offset < 512 &&
+        "pair offset out of range");
+    return ((uint32_t)(offset / 8) & 0x7F) << 15;
+  }
+
+  /// Emit a load or store of \p reg at \p base + \p offset.
+  /// \param scaledOp the opcode with a scaled unsigned 12-bit offset.
+  /// \param unscaledOp the opcode with a signed 9-bit offset.
+  /// \param regOp the opcode with an offset in a register.
+  /// \param sizeLog2 the log2 of the size of the access, by which the
+  ///   offset of \p scaledOp is scaled.
+  void loadStore(
+      uint32_t scaledOp,
+      uint32_t unscaledOp,
+      uint32_t regOp,
+      unsigned sizeLog2,
+      Reg base,
+      int32_t offset,
+      uint32_t reg) {
+    if (offset >= 0 && (offset & ((1 << sizeLog2) - 1)) == 0 &&
+        (offset >> sizeLog2) < 4096) {
+      emit(scaledOp | (uint32_t)(offset >> sizeLog2) << 10 | ord(base) << 5 |
+           reg);
+    } else if (offset >= -256 && offset < 256) {
+      emit(unscaledOp | ((uint32_t)offset & 0x1FF) << 12 | ord(base) << 5 |
+           reg);
+    } else if (offset < 0 && offset > -4096) {
+      assert(base != kScratchReg && "the scratch register can't be the base");
+      subImm(base, -offset, kScratchReg);
+      emit(scaledOp | ord(kScratchReg) << 5 | reg);
+    } else {
+      assert(base != kScratchReg && "the scratch register can't be the base");
+      movImmToReg((uint64_t)(int64_t)offset, kScratchReg);
+      emit(regOp | ord(kScratchReg) << 16 | ord(base) << 5 | reg);
+    }
+  }
+
+  /// The current output pointer.
+  uint8_t *out;
+};
+
+} // namespace aarch64
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_JIT_AARCH64_EMITTER_H
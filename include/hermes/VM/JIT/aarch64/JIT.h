@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_VM_JIT_AARCH64_JIT_H
+#define HERMES_VM_JIT_AARCH64_JIT_H
+
+#include "hermes/VM/CodeBlock.h"
+#include "hermes/VM/JIT/ExecHeap.h"
+#include "hermes/VM/JIT/NativeDisassembler.h"
+#include "hermes/VM/JIT/PerfMap.h"
+
+#include "llvm/ADT/DenseMap.h"
+
+namespace hermes {
+namespace vm {
+namespace aarch64 {
+
+/// All state related to JIT compilation. The executable memory is W^X: it is
+/// only made writable, and then not executable, while code is emitted into it.
+class JITContext {
+ public:
+  /// Construct a JIT context. No executable memory is allocated before it is
+  /// needed.
+  /// \param enable whether JIT is enabled.
+  /// \param blockSize the size of individual blocks of executable memory to be
+  ///     allocated.
+  /// \param maximum amount of executable memory that can be allocated by the
+  ///     JIT.
+  /// \param threshold the hotness a function must reach before it is
+  ///     compiled. See CodeBlock::getHotness().
+  JITContext(
+      bool enable,
+      size_t blockSize,
+      size_t maxMemory,
+      uint32_t threshold = 0);
+  ~JITContext();
+
+  JITContext(const JITContext &) = delete;
+  void operator=(const JITContext &) = delete;
+
+  /// Compile a function to native code and return the native pointer. If the
+  /// function was previously compiled, return the existing body. If it cannot
+  /// be compiled, return nullptr.
+  inline JITCompiledFunctionPtr compile(Runtime *runtime, CodeBlock *codeBlock);
+
+  /// \return true if the interpreter should try to continue the execution of
+  /// a running frame of \p codeBlock in native code. That is the case when
+  /// the function has already been compiled, or has become hot enough while
+  /// interpreted, for example because of a long running loop.
+  bool shouldAttemptOSR(const CodeBlock *codeBlock) const {
+    if (codeBlock->getJITOSREntry())
+      return true;
+    return enabled_ && !codeBlock->getDontJIT() &&
+        codeBlock->getHotness() >= threshold_;
+  }
+
+  /// \return true if JIT compilation is enabled.
+  bool isEnabled() const {
+    return enabled_;
+  }
+
+  /// Enable or disable JIT compilation.
+  void setEnabled(bool enabled) {
+    enabled_ = enabled;
+  }
+
+  /// \return the hotness a function must reach before it is compiled.
+  uint32_t getThreshold() const {
+    return threshold_;
+  }
+
+  /// Enable or disable dumping JIT'ed Code.
+  void setDumpJITCode(bool dump) {
+    dumpJITCode_ = dump;
+  }
+
+  /// \return true if dumping JIT'ed Code is enabled.
+  bool getDumpJITCode() {
+    return dumpJITCode_;
+  }
+
+  /// Set the flag to fatally crash on JIT compilation errors.
+  void setCrashOnError(bool crash) {
+    crashOnError_ = crash;
+  }
+
+  /// \return true if we should fatally crash on JIT compilation errors.
+  bool getCrashOnError() {
+    return crashOnError_;
+  }
+
+  /// Enable or disable reporting the reason why functions couldn't be
+  /// compiled.
+  void setReportBailouts(bool report) {
+    reportBailouts_ = report;
+  }
+
+  /// \return true if the reason why functions couldn't be compiled is
+  ///   reported.
+  bool getReportBailouts() {
+    return reportBailouts_;
+  }
+
+  /// \return the executable memory heap.
+  ExecHeap &getHeap() {
+    return heap_;
+  }
+
+  /// \return the native disassembler for our target.
+  NativeDisassembler &getDisassembler() {
+    return *dis_;
+  }
+
+  /// Describe the code compiled from now on to Linux perf in
+  /// /tmp/perf-<pid>.map, and also in a jitdump file if \p jitdump. See
+  /// PerfMap.
+  void enablePerfMap(bool jitdump) {
+    perfMap_ = &PerfMap::get(jitdump);
+  }
+
+  /// \return the PerfMap describing the compiled code, or null.
+  PerfMap *getPerfMap() {
+    return perfMap_;
+  }
+
+  /// Make the interpreter call every JS function through its own trampoline,
+  /// described in the PerfMap, so that perf can tell interpreted functions
+  /// apart. Calls then recurse on the native stack. This must be set before
+  /// any JS runs, and can't be unset.
+  void enableInterpreterTrampolines(bool jitdump) {
+    enablePerfMap(jitdump);
+    interpreterTrampolines_ = true;
+  }
+
+  /// \return true if every JS function is interpreted through a trampoline.
+  bool hasInterpreterTrampolines() const {
+    return interpreterTrampolines_;
+  }
+
+  /// \return the trampoline of \p codeBlock, which calls \p target with its
+  /// arguments, creating it if needed, or null if there is no executable
+  /// memory left.
+  InterpreterTrampolinePtr getInterpreterTrampoline(
+      Runtime *runtime,
+      CodeBlock *codeBlock,
+      InterpreterTrampolinePtr target);
+
+  /// Free the native code of every function of \p runtime that has no frame
+  /// on the stack, and so can't be running or be returned into. The
+  /// functions are interpreted until they become hot again. Trampolines are
+  /// kept.
+  /// \return the number of bytes of native code freed.
+  size_t evictInactive(Runtime *runtime);
+
+  /// Free the native code and the trampoline of \p codeBlock, which is about
+  /// to be destroyed. It can't be running, since its RuntimeModule is only
+  /// destroyed once the GC found it unreachable, or with the runtime.
+  void freeCode(CodeBlock *codeBlock);
+
+  /// \return the size of the native code and trampolines, in bytes.
+  size_t getCodeSize() const {
+    return heap_.getAllocatedSize();
+  }
+
+  /// \return the size of the executable memory mapped for the code.
+  size_t getMappedSize() const {
+    return heap_.getMappedSize();
+  }
+
+ private:
+  /// Slow path that actually performs the compilation of the specified
+  /// CodeBlock.
+  JITCompiledFunctionPtr compileImpl(Runtime *runtime, CodeBlock *codeBlock);
+
+  /// Free the native code of \p codeBlock, if any, and make it interpreted.
+  /// \return the number of bytes freed.
+  size_t freeCompiledCode(CodeBlock *codeBlock);
+
+ private:
+  /// Whether JIT compilation is enabled.
+  bool enabled_{false};
+  /// Executable heap where all executable code is allocated.
+  ExecHeap heap_;
+  /// whether to dump JIT'ed code
+  bool dumpJITCode_{false};
+  /// whether to fatally crash on JIT compilation errors
+  bool crashOnError_{false};
+  /// whether to report to stderr the reason why functions couldn't be compiled
+  bool reportBailouts_{false};
+
+  /// The disassembler for our target.
+  std::unique_ptr<NativeDisassembler> dis_ = NativeDisassembler::create(
+      NativeDisassembler::aarch64_unknown_linux_gnu);
+
+  /// The hotness a function must reach before it is compiled. Colder
+  /// functions stay interpreted and use no executable memory.
+  const uint32_t threshold_;
+
+  /// Where to describe the compiled code, if anywhere.
+  PerfMap *perfMap_{nullptr};
+
+  /// Whether every JS function is interpreted through a trampoline.
+  bool interpreterTrampolines_{false};
+  /// The trampoline of each CodeBlock called so far.
+  llvm::DenseMap<CodeBlock *, InterpreterTrampolinePtr> trampolines_{};
+  /// The free part of the executable block where trampolines are allocated.
+  uint8_t *trampolineCur_{nullptr};
+  uint8_t *trampolineEnd_{nullptr};
+  /// Trampolines of destroyed CodeBlocks, reused before allocating new ones.
+  std::vector<uint8_t *> freeTrampolines_{};
+};
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+inline JITCompiledFunctionPtr JITContext::compile(
+    Runtime *runtime,
+    CodeBlock *codeBlock) {
+  auto ptr = codeBlock->getJITCompiled();
+  if (LLVM_LIKELY(ptr))
+    return ptr;
+  if (LLVM_LIKELY(!enabled_))
+    return nullptr;
+  if (LLVM_LIKELY(codeBlock->getDontJIT()))
+    return nullptr;
+  if (LLVM_LIKELY(codeBlock->getHotness() < threshold_))
+    return nullptr;
+  return compileImpl(runtime, codeBlock);
+}
+
+} // namespace aarch64
+} // namespace vm
+} // namespace hermes
+#endif // HERMES_VM_JIT_AARCH64_JIT_H
@@ -576,6 +576,16 @@ class Emitter {
   void movRMToReg(Reg srcBase, Reg srcIndex, int32_t srcOffset, Reg dst) {
     _opRMToReg<s, scale, 0x8A>(srcBase, srcIndex, srcOffset, dst);
   }
+  /// Load a byte or a word and zero extend it to the 32-bit \p dst.
+  template <S s, unsigned scale = 0>
+  void movzxRMToReg(Reg srcBase, Reg srcIndex, int32_t srcOffset, Reg dst) {
+    static_assert(s == S::B || s == S::W, "only B and W can be extended");
+    emitREX<S::L>(out, srcBase, srcIndex, ord(dst));
+    *out++ = 0x0F;
+    *out++ = s == S::B ? 0xB6 : 0xB7;
+    EmitModRM<S::L, 0, scale>::emitModRM(
+        out, srcBase, srcIndex, srcOffset, ord(dst));
+  }
 
   template <S s>
   void movImmToReg(typename OperandType<s>::type imm, Reg reg) {
@@ -660,6 +670,15 @@ class Emitter {
     _opImmToRm<s, scale, 0x80, 7>(imm, dstBase, dstIndex, dstOffset);
   }
 
+  template <S s, unsigned scale = 0>
+  void cmpRegToRM(Reg src, Reg dstBase, Reg dstIndex, int32_t dstOffset) {
+    _opRegToRM<s, scale, 0x38>(src, dstBase, dstIndex, dstOffset);
+  }
+  template <S s>
+  void cmpRegToReg(Reg src, Reg dst) {
+    cmpRegToRM<s, ScaleRegAccess>(src, dst, Reg::NoIndex, 0);
+  }
+
   template <S s, unsigned scale = 0>
   void testImmToRM(
       typename OperandType<s>::type imm,
@@ -767,6 +786,10 @@ class Emitter {
   void orRegToReg(Reg src, Reg dst) {
     _opRegToRM<s, ScaleRegAccess, 0x08>(src, dst, Reg::NoIndex, 0);
   }
+  template <S s>
+  void andRegToReg(Reg src, Reg dst) {
+    _opRegToRM<s, ScaleRegAccess, 0x20>(src, dst, Reg::NoIndex, 0);
+  }
   // r/m64 AND imm32 sign extended to 64-bits if s = S::L and reg is 64 bits
   template <S s>
   void andImmToReg(typename OperandType<s>::type imm, Reg reg) {
@@ -786,6 +809,27 @@ class Emitter {
         out, dst, Reg::NoIndex, 0, 2);
   }
 
+  /// Shift \p dst to the left by cl bits.
+  template <S s>
+  void shlRegByCL(Reg dst) {
+    EmitModRM<s, s == S::B ? 0xD2 : 0xD3, ScaleRegAccess>::emitFull(
+        out, dst, Reg::NoIndex, 0, 4);
+  }
+
+  /// Unsigned shift \p dst to the right by cl bits.
+  template <S s>
+  void shrRegByCL(Reg dst) {
+    EmitModRM<s, s == S::B ? 0xD2 : 0xD3, ScaleRegAccess>::emitFull(
+        out, dst, Reg::NoIndex, 0, 5);
+  }
+
+  /// Signed shift \p dst to the right by cl bits.
+  template <S s>
+  void sarRegByCL(Reg dst) {
+    EmitModRM<s, s == S::B ? 0xD2 : 0xD3, ScaleRegAccess>::emitFull(
+        out, dst, Reg::NoIndex, 0, 7);
+  }
+
   /// unsigned shift \p reg to the right by \p imm bits
   void shrImm8ToReg(typename OperandType<S::B>::type imm, Reg reg) {
     emitREX<S::Q>(out, reg, Reg::none, 5);
@@ -842,6 +886,10 @@ class Emitter {
   void jmpRM(Reg base, Reg index, int32_t offset) {
     EmitModRM<S::L, 0xFF, scale>::emitFull(out, base, index, offset, 4);
   }
+  void jmpReg(Reg dst) {
+    EmitModRM<S::L, 0xFF, ScaleRegAccess>::emitFull(
+        out, dst, Reg::NoIndex, 0, 4);
+  }
 
   /// Emit a conditional jmp instruction.
   /// \return the offset type: either Int8 or Int32.
@@ -1009,6 +1057,17 @@ class Emitter {
     _fpRegToReg<fp, 0x2A>(src, dst);
   }
 
+  /// Convert Quadword Integer to Scalar Double-Precision Floating-Point Value.
+  /// \p src must be one of the first 8 general purpose registers.
+  void cvtsi2sdQRegToReg(Reg src, Reg dst) {
+    _fptype<FP::Double>();
+    // REX.W
+    *out++ = 0x48;
+    *out++ = 0x0F;
+    *out++ = 0x2A;
+    *out++ = ModeSel<AddrMode::Reg>::modRM(src, ord(dst));
+  }
+
  private:
   uint8_t *out;
 
@@ -10,6 +10,9 @@
 #include "hermes/VM/CodeBlock.h"
 #include "hermes/VM/JIT/ExecHeap.h"
 #include "hermes/VM/JIT/NativeDisassembler.h"
+#include "hermes/VM/JIT/PerfMap.h"
+
+#include "llvm/ADT/DenseMap.h"
 
 namespace hermes {
 namespace vm {
@@ -25,7 +28,13 @@ class JITContext {
   ///     allocated.
   /// \param maximum amount of executable memory that can be allocated by the
   ///     JIT.
-  JITContext(bool enable, size_t blockSize, size_t maxMemory);
+  /// \param threshold the hotness a function must reach before it is
+  ///     compiled. See CodeBlock::getHotness().
+  JITContext(
+      bool enable,
+      size_t blockSize,
+      size_t maxMemory,
+      uint32_t threshold = 0);
   ~JITContext();
 
   JITContext(const JITContext &) = delete;
@@ -36,6 +45,17 @@ class JITContext {
   /// be compiled, return nullptr.
   inline JITCompiledFunctionPtr compile(Runtime *runtime, CodeBlock *codeBlock);
 
+  /// \return true if the interpreter should try to continue the execution of
+  /// a running frame of \p codeBlock in native code. That is the case when
+  /// the function has already been compiled, or has become hot enough while
+  /// interpreted, for example because of a long running loop.
+  bool shouldAttemptOSR(const CodeBlock *codeBlock) const {
+    if (codeBlock->getJITOSREntry())
+      return true;
+    return enabled_ && !codeBlock->getDontJIT() &&
+        codeBlock->getHotness() >= threshold_;
+  }
+
   /// \return true if JIT compilation is enabled.
   bool isEnabled() const {
     return enabled_;
@@ -46,6 +66,11 @@ class JITContext {
     enabled_ = enabled;
   }
 
+  /// \return the hotness a function must reach before it is compiled.
+  uint32_t getThreshold() const {
+    return threshold_;
+  }
+
   /// Enable or disable dumping JIT'ed Code.
   void setDumpJITCode(bool dump) {
     dumpJITCode_ = dump;
@@ -66,6 +91,18 @@ class JITContext {
     return crashOnError_;
   }
 
+  /// Enable or disable reporting the reason why functions couldn't be
+  /// compiled.
+  void setReportBailouts(bool report) {
+    reportBailouts_ = report;
+  }
+
+  /// \return true if the reason why functions couldn't be compiled is
+  ///   reported.
+  bool getReportBailouts() {
+    return reportBailouts_;
+  }
+
   /// \return the executable memory heap.
   ExecHeap &getHeap() {
     return heap_;
@@ -76,11 +113,71 @@ class JITContext {
     return *dis_;
   }
 
+  /// Describe the code compiled from now on to Linux perf in
+  /// /tmp/perf-<pid>.map, and also in a jitdump file if \p jitdump. See
+  /// PerfMap.
+  void enablePerfMap(bool jitdump) {
+    perfMap_ = &PerfMap::get(jitdump);
+  }
+
+  /// \return the PerfMap describing the compiled code, or null.
+  PerfMap *getPerfMap() {
+    return perfMap_;
+  }
+
+  /// Make the interpreter call every JS function through its own trampoline,
+  /// described in the PerfMap, so that perf can tell interpreted functions
+  /// apart. Calls then recurse on the native stack. This must be set before
+  /// any JS runs, and can't be unset.
+  void enableInterpreterTrampolines(bool jitdump) {
+    enablePerfMap(jitdump);
+    interpreterTrampolines_ = true;
+  }
+
+  /// \return true if every JS function is interpreted through a trampoline.
+  bool hasInterpreterTrampolines() const {
+    return interpreterTrampolines_;
+  }
+
+  /// \return the trampoline of \p codeBlock, which calls \p target with its
+  /// arguments, creating it if needed, or null if there is no executable
+  /// memory left.
+  InterpreterTrampolinePtr getInterpreterTrampoline(
+      Runtime *runtime,
+      CodeBlock *codeBlock,
+      InterpreterTrampolinePtr target);
+
+  /// Free the native code of every function of \p runtime that has no frame
+  /// on the stack, and so can't be running or be returned into. The
+  /// functions are interpreted until they become hot again. Trampolines are
+  /// kept.
+  /// \return the number of bytes of native code freed.
+  size_t evictInactive(Runtime *runtime);
+
+  /// Free the native code and the trampoline of \p codeBlock, which is about
+  /// to be destroyed. It can't be running, since its RuntimeModule is only
+  /// destroyed once the GC found it unreachable, or with the runtime.
+  void freeCode(CodeBlock *codeBlock);
+
+  /// \return the size of the native code and trampolines, in bytes.
+  size_t getCodeSize() const {
+    return heap_.getAllocatedSize();
+  }
+
+  /// \return the size of the executable memory mapped for the code.
+  size_t getMappedSize() const {
+    return heap_.getMappedSize();
+  }
+
  private:
   /// Slow path that actually performs the compilation of the specified
   /// CodeBlock.
   JITCompiledFunctionPtr compileImpl(Runtime *runtime, CodeBlock *codeBlock);
 
+  /// Free the native code of \p codeBlock, if any, and make it interpreted.
+  /// \return the number of bytes freed.
+  size_t freeCompiledCode(CodeBlock *codeBlock);
+
  private:
   /// Whether JIT compilation is enabled.
   bool enabled_{false};
@@ -90,13 +187,29 @@ class JITContext {
   bool dumpJITCode_{false};
   /// whether to fatally crash on JIT compilation errors
   bool crashOnError_{false};
+  /// whether to report to stderr the reason why functions couldn't be compiled
+  bool reportBailouts_{false};
 
   /// The disassembler for our target.
   std::unique_ptr<NativeDisassembler> dis_ =
       NativeDisassembler::create(NativeDisassembler::x86_64_unknown_linux_gnu);
 
-  /// The JIT compile threshold for function execution count
-  static constexpr uint32_t COMPILE_THRESHOLD = 0;
+  /// The hotness a function must reach before it is compiled. Colder
+  /// functions stay interpreted and use no executable memory.
+  const uint32_t threshold_;
+
+  /// Where to describe the compiled code, if anywhere.
+  PerfMap *perfMap_{nullptr};
+
+  /// Whether every JS function is interpreted through a trampoline.
+  bool interpreterTrampolines_{false};
+  /// The trampoline of each CodeBlock called so far.
+  llvm::DenseMap<CodeBlock *, InterpreterTrampolinePtr> trampolines_{};
+  /// The free part of the executable block where trampolines are allocated.
+  uint8_t *trampolineCur_{nullptr};
+  uint8_t *trampolineEnd_{nullptr};
+  /// Trampolines of destroyed CodeBlocks, reused before allocating new ones.
+  std::vector<uint8_t *> freeTrampolines_{};
 };
 
 LLVM_ATTRIBUTE_ALWAYS_INLINE
@@ -110,7 +223,7 @@ inline JITCompiledFunctionPtr JITContext::compile(
     return nullptr;
   if (LLVM_LIKELY(codeBlock->getDontJIT()))
     return nullptr;
-  if (LLVM_LIKELY(codeBlock->getExecutionCount() < COMPILE_THRESHOLD))
+  if (LLVM_LIKELY(codeBlock->getHotness() < threshold_))
     return nullptr;
   return compileImpl(runtime, codeBlock);
 }
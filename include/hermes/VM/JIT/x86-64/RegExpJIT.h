@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+//===----------------------------------------------------------------------===//
+/// \file
+/// Compilation of regexp bytecode to x86-64 native code.
+///
+/// Only programs made of a straight sequence of instructions are compiled:
+/// characters, brackets, anchors, capture groups and loops whose body matches
+/// exactly one character (Width1Loop). There are no alternations, so a
+/// backtracking search only ever has to revisit the loops, and every capture
+/// group is part of a successful match. Each loop keeps its backtracking state
+/// in two slots after the captures, and the code resumes the search after the
+/// most recent loop which can still give up (or take) one more character.
+//===----------------------------------------------------------------------===//
+#ifndef HERMES_VM_JIT_X86_64_REGEXPJIT_H
+#define HERMES_VM_JIT_X86_64_REGEXPJIT_H
+
+#include "hermes/Regex/Executor.h"
+#include "hermes/VM/JIT/ExecHeap.h"
+
+#include "llvm/ADT/ArrayRef.h"
+
+#include <memory>
+
+namespace hermes {
+namespace vm {
+namespace x86_64 {
+
+class JITContext;
+
+/// The native code of a regexp, for both ASCII and UTF-16 input.
+class JITCompiledRegExp {
+ public:
+  /// Number of interpreted searches after which a regexp is compiled.
+  static constexpr uint32_t kSearchThreshold = 32;
+
+  JITCompiledRegExp(const JITCompiledRegExp &) = delete;
+  void operator=(const JITCompiledRegExp &) = delete;
+  ~JITCompiledRegExp();
+
+  /// Compile the regexp \p bytecode to native code allocated in the heap of
+  /// \p context.
+  /// \return the native code, or null if the program cannot be compiled.
+  static std::unique_ptr<JITCompiledRegExp> compile(
+      JITContext &context,
+      llvm::ArrayRef<uint8_t> bytecode);
+
+  /// Search the range starting at \p first up to (not including) \p last,
+  /// like regex::searchWithBytecode() with the same arguments. The flags
+  /// matchNotBeginningOfLine and matchNotEndOfLine are not supported.
+  regex::MatchRuntimeResult search(
+      const char16_t *first,
+      const char16_t *last,
+      regex::MatchResults<const char16_t *> &m,
+      regex::constants::MatchFlagType matchFlags) const;
+
+  /// ASCII overload.
+  regex::MatchRuntimeResult search(
+      const char *first,
+      const char *last,
+      regex::MatchResults<const char *> &m,
+      regex::constants::MatchFlagType matchFlags) const;
+
+  /// The signature of the compiled code. Search [first, last) for a match,
+  /// starting only at \p first if \p onlyAtStart is set.
+  /// \p anchorStart is the position where ^ matches, or null. On success, the
+  /// bounds of the match and of each capture group are stored in \p slots,
+  /// which also holds the state of the loops.
+  /// \return whether a match was found.
+  using SearchFunction = bool (*)(
+      const void *first,
+      const void *last,
+      const void **slots,
+      const void *anchorStart,
+      uint32_t onlyAtStart);
+
+ private:
+  JITCompiledRegExp(
+      ExecHeap &heap,
+      ExecHeap::BlockPair blocks,
+      SearchFunction search8,
+      SearchFunction search16,
+      uint16_t markedCount,
+      uint32_t slotCount,
+      regex::MatchConstraintSet constraints)
+      : heap_(heap),
+        blocks_(blocks),
+        search8_(search8),
+        search16_(search16),
+        markedCount_(markedCount),
+        slotCount_(slotCount),
+        constraints_(constraints) {}
+
+  template <typename CharT>
+  regex::MatchRuntimeResult searchImpl(
+      SearchFunction fn,
+      const CharT *first,
+      const CharT *last,
+      regex::MatchResults<const CharT *> &m,
+      regex::constants::MatchFlagType matchFlags) const;
+
+  /// The heap owning the code.
+  ExecHeap &heap_;
+
+  /// The code of both functions, allocated together.
+  ExecHeap::BlockPair blocks_;
+
+  /// The functions searching ASCII and UTF-16 input respectively.
+  SearchFunction search8_;
+  SearchFunction search16_;
+
+  /// Number of capture groups.
+  uint16_t markedCount_;
+
+  /// Number of slots needed by the functions.
+  uint32_t slotCount_;
+
+  /// Constraints on what strings can match the regexp.
+  regex::MatchConstraintSet constraints_;
+};
+
+} // namespace x86_64
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_JIT_X86_64_REGEXPJIT_H
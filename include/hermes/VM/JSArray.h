@@ -34,6 +34,20 @@ class ArrayImpl : public JSObject {
   /// into.
   using StorageType = BigStorage;
 
+  /// What is known about the elements in the storage, from most to least
+  /// specific. Storage writes only ever move an array towards \c Holey, so the
+  /// kind is conservative: a \c Holey array may well have no holes left.
+  enum class ElementsKind : uint8_t {
+    /// Every index in [0, getEndIndex()) has an element, and all of them are
+    /// numbers (which, unlike other values, are not boxed in a HermesValue).
+    PackedNumber,
+    /// Every index in [0, getEndIndex()) has an element.
+    PackedAny,
+    /// Some indexes in [0, getEndIndex()) may be missing, including all of
+    /// those below getBeginIndex().
+    Holey,
+  };
+
   /// Resize the internal storage. The ".length" property is not affected. It
   /// does \b NOT check for read-only properties.
   static ExecutionStatus setStorageEndIndex(
@@ -70,15 +84,86 @@ class ArrayImpl : public JSObject {
     // The array must be extendable (and by implication is not frozen or sealed)
     // because we don't know whether the element being set is empty or not.
     assert(!self->flags_.noExtend && "this array cannot be extended");
+    assert(!self->storageShared_ && "cannot write to shared storage");
 
     assert(
         index >= self->beginIndex_ && index < self->endIndex_ &&
         "array index out of range");
+    self->noteElementValue(value);
     self->indexedStorage_.getNonNull(runtime)
-        ->at(index - self->beginIndex_)
+        ->at(self->storageSlot(index))
         .set(value, &runtime->getHeap());
   }
 
+  /// Declare that the caller has stored an element to every index in the
+  /// storage using \c unsafeSetExistingElementAt(), after growing it with
+  /// \c setStorageEndIndex(), so the array has no holes even though growing it
+  /// made it \c Holey. The same restrictions as for
+  /// \c unsafeSetExistingElementAt() apply.
+  static void unsafeMarkFilled(ArrayImpl *self, Runtime *runtime) {
+#ifndef NDEBUG
+    for (size_type i = self->beginIndex_; i != self->endIndex_; ++i)
+      assert(!self->unsafeAt(runtime, i).isEmpty() && "array has holes");
+#endif
+    if (self->beginIndex_ == 0)
+      self->mayHaveHoles_ = false;
+  }
+
+  /// Allow other arrays to use the storage of \p self, see
+  /// \c JSArray::createWithSharedStorage(). From now on the storage is copied
+  /// before \p self is modified. The array must be packed, and the same
+  /// restrictions as for \c unsafeSetExistingElementAt() apply.
+  /// \return the storage.
+  static StorageType *unsafeShareStorage(ArrayImpl *self, Runtime *runtime) {
+    assert(
+        self->getElementsKind() != ElementsKind::Holey &&
+        "only packed storage can be shared");
+    // The other arrays expect their elements at the start of the storage.
+    self->compactStorage(runtime);
+    self->storageShared_ = true;
+    return self->indexedStorage_.get(runtime);
+  }
+
+  /// Remove the element at index 0 of \p selfHandle and move the others down by
+  /// one index, without copying them: the slot of the element is left unused
+  /// at the start of the storage, and the unused slots are only dropped once
+  /// they outnumber the elements, which makes repeated shifts amortized
+  /// constant time. The array must have fast packed elements starting at
+  /// index 0 and at least one element, and be extensible. Shared storage is
+  /// copied first. The ".length" property is not affected.
+  /// \return the removed element.
+  static CallResult<HermesValue> unsafeShift(
+      Handle<ArrayImpl> selfHandle,
+      Runtime *runtime);
+
+  /// Move the elements of \p selfHandle up by \p count indexes, leaving
+  /// empty elements at [0, count). The unused slots at the start of the
+  /// storage are reused when there are enough of them; otherwise the storage
+  /// grows on the left by as many slots as it has elements, so that repeated
+  /// unshifts move each element a constant number of times on average. The
+  /// array must start at index 0 and be extensible. Shared storage is copied
+  /// first. The caller is expected to fill the new elements with
+  /// \c unsafeSetExistingElementAt() and then call \c unsafeMarkFilled().
+  /// The ".length" property is not affected.
+  static ExecutionStatus unsafeGrowStorageLeft(
+      Handle<ArrayImpl> selfHandle,
+      Runtime *runtime,
+      size_type count);
+
+  /// Copy the \p count elements starting at index \p from of \p srcHandle to
+  /// the elements starting at index \p to of \p selfHandle, in bulk rather
+  /// than one element at a time. Both ranges must be within the storage of
+  /// their arrays, and they may overlap if the arrays are the same. The same
+  /// restrictions as for \c unsafeSetExistingElementAt() apply to
+  /// \p selfHandle, except that shared storage is copied first.
+  static ExecutionStatus unsafeCopyElements(
+      Handle<ArrayImpl> selfHandle,
+      Runtime *runtime,
+      size_type to,
+      Handle<ArrayImpl> srcHandle,
+      size_type from,
+      size_type count);
+
   /// Set the element at index \p index to empty. This does not affect the
   /// storage size or array length.
   /// \return true if the operation succeeded (which is always in this class).
@@ -99,11 +184,25 @@ class ArrayImpl : public JSObject {
     return endIndex_;
   }
 
+  ElementsKind getElementsKind() const {
+    if (mayHaveHoles_)
+      return ElementsKind::Holey;
+    return mayHaveNonNumbers_ ? ElementsKind::PackedAny
+                              : ElementsKind::PackedNumber;
+  }
+
+  /// \return true if reading any index in [0, getEndIndex()) can be done
+  /// straight from the storage: it holds an element for each of them, and
+  /// there are no "index-like" named properties that could shadow them.
+  bool hasFastPackedElements() const {
+    return flags_.fastIndexProperties && !mayHaveHoles_;
+  }
+
   /// Return the value at index \p index, or \c empty if the index is not
   /// contained in the storage.
   const HermesValue at(Runtime *runtime, size_type index) const {
     return index >= beginIndex_ && index < endIndex_
-        ? indexedStorage_.getNonNull(runtime)->at(index - beginIndex_)
+        ? indexedStorage_.getNonNull(runtime)->at(storageSlot(index))
         : HermesValue::encodeEmptyValue();
   }
 
@@ -111,6 +210,66 @@ class ArrayImpl : public JSObject {
   Handle<> handleAt(Runtime *runtime, size_type index) const {
     return runtime->makeHandle(at(runtime, index));
   }
+
+  /// Read an element without going through the object's virtual interface.
+  /// \return the element at \p index if it is present in the storage and the
+  ///   array doesn't have "index-like" named properties, or \c empty if the
+  ///   full lookup must be performed.
+  HermesValue tryGetFastIndexed(Runtime *runtime, size_type index) const {
+    if (LLVM_UNLIKELY(!flags_.fastIndexProperties))
+      return HermesValue::encodeEmptyValue();
+    return at(runtime, index);
+  }
+
+  /// Search the elements in [\p from, \p to), which must be in the storage,
+  /// for one whose encoding is the same as that of \p value, front to back,
+  /// or back to front if \p reverse is set. This is a strict equality test
+  /// unless \p value is a string, or a number with several encodings (0) or
+  /// none (NaN).
+  /// \return the index of the element found, or \p to if there is none.
+  size_type findRawElement(
+      Runtime *runtime,
+      HermesValue value,
+      size_type from,
+      size_type to,
+      bool reverse) const {
+    assert(
+        from <= to && from >= beginIndex_ && to <= endIndex_ &&
+        "searching out of range");
+    if (from == to)
+      return to;
+    size_type found = indexedStorage_.getNonNull(runtime)->findRaw(
+        value, storageSlot(from), storageSlot(to), reverse);
+    return found - storageSlot(from) + from;
+  }
+
+  /// Overwrite an element without going through the object's virtual
+  /// interface. This only succeeds if the element is already present in the
+  /// storage (so no setter on the prototype chain can be involved), the array
+  /// doesn't have "index-like" named properties and isn't frozen.
+  /// \return true if the element was updated.
+  static bool trySetFastIndexed(
+      ArrayImpl *self,
+      Runtime *runtime,
+      size_type index,
+      HermesValue value) {
+    if (LLVM_UNLIKELY(
+            !self->flags_.fastIndexProperties || self->flags_.frozen ||
+            self->storageShared_))
+      return false;
+    if (LLVM_LIKELY(!self->mayHaveHoles_)) {
+      // Packed: every index in range has an element.
+      if (index >= self->endIndex_)
+        return false;
+    } else if (self->at(runtime, index).isEmpty()) {
+      return false;
+    }
+    self->noteElementValue(value);
+    self->indexedStorage_.getNonNull(runtime)
+        ->at(self->storageSlot(index))
+        .set(value, &runtime->getHeap());
+    return true;
+  }
   /// @}
 
  protected:
@@ -211,7 +370,58 @@ class ArrayImpl : public JSObject {
 
   /// Return the value at index \p index, which must be valid.
   const HermesValue unsafeAt(Runtime *runtime, size_type index) const {
-    return indexedStorage_.getNonNull(runtime)->at(index - beginIndex_);
+    return indexedStorage_.getNonNull(runtime)->at(storageSlot(index));
+  }
+
+  /// Make \p self, which must have no storage yet, use \p storage obtained
+  /// from \c unsafeShareStorage() as its elements, until it is first modified.
+  /// \param allNumbers whether all the elements are numbers.
+  static void unsafeUseSharedStorage(
+      ArrayImpl *self,
+      Runtime *runtime,
+      StorageType *storage,
+      bool allNumbers) {
+    assert(!self->indexedStorage_ && "array already has storage");
+    self->indexedStorage_.set(runtime, storage, &runtime->getHeap());
+    self->beginIndex_ = 0;
+    self->endIndex_ = storage->size();
+    self->storageBegin_ = 0;
+    self->mayHaveHoles_ = false;
+    self->mayHaveNonNumbers_ = !allNumbers;
+    self->storageShared_ = true;
+  }
+
+  /// If the storage of \p selfHandle is shared with other arrays, replace it
+  /// with a copy that \p selfHandle owns, so that it can be modified.
+  static ExecutionStatus unshareStorage(
+      Handle<ArrayImpl> selfHandle,
+      Runtime *runtime) {
+    if (LLVM_LIKELY(!selfHandle->storageShared_))
+      return ExecutionStatus::RETURNED;
+    return copySharedStorage(selfHandle, runtime);
+  }
+
+  /// The slow path of \c unshareStorage().
+  static ExecutionStatus copySharedStorage(
+      Handle<ArrayImpl> selfHandle,
+      Runtime *runtime);
+
+  /// \return the slot of the storage holding the element at \p index.
+  size_type storageSlot(size_type index) const {
+    return index - beginIndex_ + storageBegin_;
+  }
+
+  /// Drop the unused slots at the start of the storage, moving the elements
+  /// down to its start. This doesn't allocate.
+  void compactStorage(Runtime *runtime);
+
+  /// Update the elements kind for \p value being stored in the storage.
+  void noteElementValue(HermesValue value) {
+    if (LLVM_UNLIKELY(!value.isNumber())) {
+      mayHaveNonNumbers_ = true;
+      if (value.isEmpty())
+        mayHaveHoles_ = true;
+    }
   }
 
  private:
@@ -219,6 +429,18 @@ class ArrayImpl : public JSObject {
   uint32_t beginIndex_{0};
   /// One past the last index contained in the storage.
   uint32_t endIndex_{0};
+  /// The number of unused slots at the start of the storage, which are left
+  /// by \c unsafeShift() and reserved by \c unsafeGrowStorageLeft(). They
+  /// are always empty, and the element at \c beginIndex_ is in the slot
+  /// after them.
+  uint32_t storageBegin_{0};
+  /// The elements kind, see \c getElementsKind(). An array starts out with
+  /// no elements, which is trivially packed.
+  bool mayHaveHoles_{false};
+  bool mayHaveNonNumbers_{false};
+  /// Whether \c indexedStorage_ may be used by other arrays too, and must be
+  /// copied before it is modified ("copy-on-write").
+  bool storageShared_{false};
   /// The indexed property storage. It can be nullptr, if both its capacity and
   /// size are 0.
   GCPointer<StorageType> indexedStorage_;
@@ -314,6 +536,15 @@ class JSArray final : public ArrayImpl {
   static CallResult<PseudoHandle<JSArray>>
   create(Runtime *runtime, size_type capacity, size_type length);
 
+  /// Create an instance of Array, using the standard array prototype, whose
+  /// elements are \p storage, which was obtained from \c unsafeShareStorage().
+  /// The storage is copied before the new array is first modified.
+  /// \param allNumbers whether all the elements are numbers.
+  static CallResult<PseudoHandle<JSArray>> createWithSharedStorage(
+      Runtime *runtime,
+      Handle<StorageType> storage,
+      bool allNumbers);
+
   /// A convenience method for setting the \c .length property of the array.
   /// It performs the necessary checks and updates the property. It could fail
   /// if the property is not writable or if there are read-only index-like
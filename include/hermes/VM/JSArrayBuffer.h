@@ -13,6 +13,14 @@
 namespace hermes {
 namespace vm {
 
+/// Owns memory which a JSArrayBuffer uses in place as its data block, see
+/// JSArrayBuffer::setExternalDataBlock(). It is destroyed when the buffer is
+/// detached or finalized, which releases the memory.
+class ExternalArrayBufferOwner {
+ public:
+  virtual ~ExternalArrayBufferOwner() = default;
+};
+
 /// A JSArrayBuffer is a light container over an array of bytes.
 ///
 /// This should be used in combination with a typed array view over the buffer
@@ -55,11 +63,26 @@ class JSArrayBuffer final : public JSObject {
   /// Creates a data block of size \p size for this JSArrayBuffer to hold.
   /// Replaces the currently used data block.
   /// \p zero if true, zero out the data in the block, else leave it
-  ///   uninitialized.
+  ///   uninitialized. Large zeroed blocks are mapped directly from the OS, so
+  ///   that their pages are only committed once they are touched.
   /// \return ExecutionStatus::RETURNED iff the allocation was successful.
   ExecutionStatus
   createDataBlock(Runtime *runtime, size_type size, bool zero = true);
 
+  /// Make this buffer use the \p size bytes at \p data, owned by \p owner,
+  /// in place as its data block instead of allocating its own. The memory is
+  /// charged to the GC as external memory until \p owner is destroyed, and
+  /// must stay valid until then.
+  /// Replaces the currently used data block.
+  /// \return ExecutionStatus::RETURNED iff the GC can account for \p size
+  ///   more bytes. Otherwise a RangeError is raised and \p owner is
+  ///   destroyed.
+  ExecutionStatus setExternalDataBlock(
+      Runtime *runtime,
+      char *data,
+      size_type size,
+      std::unique_ptr<ExternalArrayBufferOwner> owner);
+
   /// Retrieves a pointer to the held buffer.
   /// \return A pointer to the buffer owned by this object. This can be null
   ///   if the ArrayBuffer is empty.
@@ -86,6 +109,20 @@ class JSArrayBuffer final : public JSObject {
   /// the GC to be informed of this external memory deletion.
   void detach(GC *gc);
 
+  /// Detach this buffer from its data block like detach(), but hand the block
+  /// to the returned owner instead of freeing it, so that another buffer,
+  /// possibly of another Runtime, can adopt it with setExternalDataBlock().
+  /// The block and its size are stored in \p data and \p size.
+  /// \return the owner of the block, or null if the buffer holds no data.
+  std::unique_ptr<ExternalArrayBufferOwner>
+  releaseDataBlock(GC *gc, char **data, size_type *size);
+
+  /// \return whether the data block is owned by an external owner instead of
+  ///   this buffer.
+  bool isExternal() const {
+    return externalOwner_ != nullptr;
+  }
+
   /// If the given cell is a JSArrayBuffer, returns the size of its
   /// associated external memory (in bytes), else zero.
   inline static uint32_t externalMemorySize(const GCCell *cell);
@@ -98,6 +135,11 @@ class JSArrayBuffer final : public JSObject {
   char *data_;
   size_type size_;
   bool attached_;
+  /// Whether data_ was mapped from the OS instead of allocated with malloc.
+  bool mapped_{false};
+  /// The owner of data_ if it was not allocated by this buffer, in which case
+  /// it is destroyed instead of freeing data_.
+  ExternalArrayBufferOwner *externalOwner_{nullptr};
 
   JSArrayBuffer(Runtime *runtime, JSObject *parent, HiddenClass *clazz);
 
@@ -132,9 +132,10 @@ class JSError final : public JSObject {
   /// A list of Domains which are referenced by the stacktrace_.
   GCPointer<ArrayStorage> domains_;
 
-  /// If not null, an array of function names as the 'name' property of the
-  /// Callables. This is parallel to the stack trace array.
-  GCPointer<PropStorage> funcNames_;
+  /// If not null, the callees of the frames, whose names are looked up when
+  /// the stack trace string is built. This is parallel to the stack trace
+  /// array.
+  GCPointer<PropStorage> callees_;
 
   /// If true, JS catch and finally blocks will be run after this error is
   /// thrown. Else, there will be no more JS executed after this error is
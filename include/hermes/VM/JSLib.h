@@ -26,6 +26,12 @@ namespace vm {
 class Runtime;
 struct RuntimeCommonStorage;
 
+/// Create the global object and all the builtins of \p runtime.
+/// The resulting heap is rebuilt on every launch rather than restored from a
+/// snapshot: it holds raw pointers to native functions and their contexts,
+/// to bytecode buffers and CodeBlocks, and SymbolIDs which are only valid for
+/// this Runtime's IdentifierTable. Persisting it would need a serializer for
+/// every cell kind that records all of them as relocations.
 void initGlobalObject(Runtime *runtime);
 
 std::shared_ptr<RuntimeCommonStorage> createRuntimeCommonStorage();
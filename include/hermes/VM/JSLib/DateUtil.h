@@ -14,6 +14,7 @@
 #include <cstdint>
 #include <cstdlib>
 #include <limits>
+#include <string>
 
 #include "llvm/ADT/SmallString.h"
 
@@ -99,7 +100,7 @@ double weekDay(double t);
 // ES5.1 15.9.1.7
 
 /// Local time zone offset, explicitly not including DST offset.
-/// TODO: Cache this value to avoid recomputing every time.
+/// This is recomputed on every call; LocalTimeOffsetCache caches it.
 double localTZA();
 
 //===----------------------------------------------------------------------===//
@@ -123,6 +124,63 @@ double localTime(double t);
 /// Spec refers to this as the UTC() function.
 double utcTime(double t);
 
+/// Caches the local time zone adjustment, and the daylight saving time
+/// adjustment over the interval of times queried last, so that converting
+/// nearby times doesn't have to call into the C library every time. Runtime
+/// owns an instance in RuntimeCommonStorage.
+/// Everything is recomputed when the TZ environment variable changes, and at
+/// least once per kMaxAge, so that changes of the system time zone are
+/// eventually picked up too.
+class LocalTimeOffsetCache {
+ public:
+  /// \return localTZA().
+  double getLocalTZA();
+
+  /// \return daylightSavingTA(\p t).
+  double getDaylightSavingTA(double t);
+
+ private:
+  /// Drop the cached values if they may be out of date.
+  void validate();
+
+  /// The longest time the cached values are used for.
+  static constexpr std::chrono::milliseconds kMaxAge{1000};
+
+  /// DST is assumed not to change twice in this many seconds, so a new time
+  /// with the same adjustment as the cached interval and at most this far from
+  /// it extends the interval.
+  static constexpr int32_t kMaxIntervalExtensionSecs = 7 * 24 * 60 * 60;
+
+  /// Whether any value is cached.
+  bool valid_{false};
+
+  /// The value of the TZ environment variable when the cache was filled, and
+  /// whether it was set at all.
+  std::string tz_{};
+  bool tzSet_{false};
+
+  /// When the cache was filled.
+  std::chrono::steady_clock::time_point filledAt_{};
+
+  /// The cached result of localTZA().
+  double localTZA_{0};
+
+  /// Whether an interval of DST is cached.
+  bool hasDSTInterval_{false};
+
+  /// The bounds of the interval, inclusive, in the seconds returned by
+  /// detail::equivalentTime(), and its DST adjustment in milliseconds.
+  int32_t dstStart_{0};
+  int32_t dstEnd_{0};
+  double dst_{0};
+};
+
+/// Conversion from UTC to local time, using the offsets in \p cache.
+double localTime(double t, LocalTimeOffsetCache &cache);
+
+/// Conversion from local time to UTC, using the offsets in \p cache.
+double utcTime(double t, LocalTimeOffsetCache &cache);
+
 //===----------------------------------------------------------------------===//
 // ES5.1 15.9.1.10
 
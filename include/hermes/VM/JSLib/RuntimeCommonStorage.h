@@ -7,6 +7,8 @@
 #ifndef HERMES_VM_JSLIB_RUNTIMECOMMONSTORAGE_H
 #define HERMES_VM_JSLIB_RUNTIMECOMMONSTORAGE_H
 
+#include "hermes/VM/JSLib/DateUtil.h"
+
 #include <random>
 #if __APPLE__
 #include <CoreFoundation/CoreFoundation.h>
@@ -40,6 +42,9 @@ struct RuntimeCommonStorage {
   MockedEnvironment tracedEnv;
 #endif
 
+  /// Time zone offsets used by Date.
+  LocalTimeOffsetCache localTimeOffsetCache;
+
   /// PRNG used by Math.random()
   std::minstd_rand randomEngine_;
   bool randomEngineSeeded_ = false;
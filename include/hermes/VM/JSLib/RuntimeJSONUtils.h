@@ -18,6 +18,14 @@ CallResult<HermesValue> runtimeJSONParse(
     Handle<StringPrimitive> jsonString,
     Handle<Callable> reviver);
 
+/// Parse the UTF-8 encoded JSON text \p utf8 like runtimeJSONParse(), but
+/// without creating a string for it first. Invalid UTF-8 sequences are
+/// decoded as U+FFFD.
+CallResult<HermesValue> runtimeJSONParseUTF8(
+    Runtime *runtime,
+    llvm::ArrayRef<uint8_t> utf8,
+    Handle<Callable> reviver);
+
 /// Returns a String in JSON format representing an ECMAScript value,
 /// according to 15.12.3.
 CallResult<HermesValue> runtimeJSONStringify(
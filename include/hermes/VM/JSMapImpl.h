@@ -54,19 +54,19 @@ class JSMapImpl final : public JSObject {
     return static_cast<bool>(storage_);
   }
 
-  /// Advance iterator and return the next.
-  HashMapEntry *iteratorNext(Runtime *runtime, HashMapEntry *entry) {
-    return storage_.get(runtime)->iteratorNext(runtime, entry);
+  /// \return the underlying storage.
+  OrderedHashMap *getStorage(Runtime *runtime) const {
+    return storage_.get(runtime);
   }
 
   /// Add a value.
-  static void addValue(
+  static ExecutionStatus addValue(
       Handle<JSMapImpl> self,
       Runtime *runtime,
       Handle<> key,
       Handle<> value) {
     self->assertInitialized();
-    OrderedHashMap::insert(
+    return OrderedHashMap::insert(
         runtime->makeHandle<OrderedHashMap>(self->storage_),
         runtime,
         key,
@@ -102,9 +102,10 @@ class JSMapImpl final : public JSObject {
   }
 
   /// Clear all elements from the storage.
-  static void clear(Handle<JSMapImpl> self, Runtime *runtime) {
+  static ExecutionStatus clear(Handle<JSMapImpl> self, Runtime *runtime) {
     self->assertInitialized();
-    self->storage_.get(runtime)->clear(runtime);
+    return OrderedHashMap::clear(
+        runtime->makeHandle<OrderedHashMap>(self->storage_), runtime);
   }
 
   /// Call \p callbackfn for each entry, with \p thisArg as this.
@@ -114,12 +115,18 @@ class JSMapImpl final : public JSObject {
       Handle<Callable> callbackfn,
       Handle<> thisArg) {
     self->assertInitialized();
-    MutableHandle<HashMapEntry> entry{runtime};
-    for (entry = self->storage_.get(runtime)->iteratorNext(runtime); entry;
-         entry =
-             self->storage_.get(runtime)->iteratorNext(runtime, entry.get())) {
-      HermesValue key = entry->key;
-      HermesValue value = entry->value;
+    MutableHandle<SegmentedArray> table{runtime};
+    uint32_t index = 0;
+    while (true) {
+      OrderedHashMap *storage = self->storage_.get(runtime);
+      SegmentedArray *tablePtr = table.get();
+      index = storage->iteratorNext(runtime, tablePtr, index);
+      if (index == OrderedHashMap::kIterationEnd)
+        break;
+      table = tablePtr;
+      HermesValue key = storage->getKeyAt(runtime, index);
+      HermesValue value = storage->getValueAt(runtime, index);
+      ++index;
       assert(!key.isEmpty() && "Invalid key encountered");
       assert(!value.isEmpty() && "Invalid value encountered");
       if (LLVM_UNLIKELY(
@@ -208,31 +215,32 @@ class JSMapIteratorImpl final : public JSObject {
       // Iteration has not yet reached the end previously.
       assert(self->data_ && "Storage uninitialized");
       // Advance the iterator.
-      self->itr_.set(
-          runtime,
-          self->data_.get(runtime)->iteratorNext(
-              runtime, self->itr_.get(runtime)),
-          &runtime->getHeap());
-      if (self->itr_) {
+      OrderedHashMap *storage = self->data_.get(runtime)->getStorage(runtime);
+      SegmentedArray *table = self->itrTable_.get(runtime);
+      uint32_t index = storage->iteratorNext(runtime, table, self->itrIndex_);
+      if (index != OrderedHashMap::kIterationEnd) {
+        self->itrTable_.set(runtime, table, &runtime->getHeap());
+        self->itrIndex_ = index + 1;
         switch (self->iterationKind_) {
           case IterationKind::Key:
-            value = self->itr_.get(runtime)->key;
+            value = storage->getKeyAt(runtime, index);
             break;
           case IterationKind::Value:
-            value = self->itr_.get(runtime)->value;
+            value = storage->getValueAt(runtime, index);
             break;
           case IterationKind::Entry: {
             // If we are iterating both key and value, we need to create an
-            // array.
+            // array. Read them first, since the allocation may move them.
+            value = storage->getKeyAt(runtime, index);
+            auto entryValue =
+                runtime->makeHandle(storage->getValueAt(runtime, index));
             auto arrRes = JSArray::create(runtime, 2, 2);
             if (arrRes == ExecutionStatus::EXCEPTION) {
               return ExecutionStatus::EXCEPTION;
             }
             auto arrHandle = toHandle(runtime, std::move(*arrRes));
-            value = self->itr_.get(runtime)->key;
             JSArray::setElementAt(arrHandle, runtime, 0, value);
-            value = self->itr_.get(runtime)->value;
-            JSArray::setElementAt(arrHandle, runtime, 1, value);
+            JSArray::setElementAt(arrHandle, runtime, 1, entryValue);
             value = arrHandle.getHermesValue();
             break;
           };
@@ -242,6 +250,7 @@ class JSMapIteratorImpl final : public JSObject {
         // reached the end.
         self->iterationFinished_ = true;
         self->data_ = nullptr;
+        self->itrTable_ = nullptr;
       }
     }
     return createIterResultObject(runtime, value, self->iterationFinished_)
@@ -262,8 +271,12 @@ class JSMapIteratorImpl final : public JSObject {
   /// initialized or the iteration has ended.
   GCPointer<JSMapImpl<JSMapTypeTraits<C>::ContainerKind>> data_{nullptr};
 
-  /// Iteration pointer to the element storage in the Map.
-  GCPointer<HashMapEntry> itr_{nullptr};
+  /// The table of the Map's storage that the iterator is positioned in, or
+  /// nullptr before the first element. See OrderedHashMap::iteratorNext.
+  GCPointer<SegmentedArray> itrTable_{nullptr};
+
+  /// Index in itrTable_ of the next entry to visit.
+  uint32_t itrIndex_{0};
 
   IterationKind iterationKind_;
 
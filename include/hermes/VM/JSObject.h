@@ -278,6 +278,7 @@ struct ObjectVTable {
 /// available.
 class JSObject : public GCCell {
   friend void ObjectBuildMeta(const GCCell *cell, Metadata::Builder &mb);
+  friend struct RuntimeOffsets;
 
  protected:
   /// A light-weight constructor which performs no GC allocations. Its purpose
@@ -394,6 +395,13 @@ class JSObject : public GCCell {
     return flags_.hostObject;
   }
 
+  /// \return true if every index-like property of this object lives in its
+  /// indexed storage, so that an index missing from the indexed storage is not
+  /// an own property.
+  bool hasFastIndexProperties() const {
+    return flags_.fastIndexProperties;
+  }
+
   /// \return the `__proto__` internal property, which may be nullptr.
   JSObject *getParent(Runtime *runtime) const {
     return parent_.get(runtime);
@@ -454,6 +462,19 @@ class JSObject : public GCCell {
       unsigned count,
       Handle<> valueHandle);
 
+  /// If \p target is an extensible ordinary object without properties, and
+  /// \p source an ordinary object whose class is not a dictionary and only
+  /// has enumerable, writable and configurable data properties, make
+  /// \p target share the class of \p source and copy the values of its
+  /// slots. The result is the same as defining the properties of \p source on
+  /// \p target one at a time, without the class transitions and lookups.
+  /// \return true if the properties were copied, false if the objects don't
+  ///   qualify, in which case nothing was done.
+  static bool tryCloneOwnProperties(
+      Handle<JSObject> target,
+      Runtime *runtime,
+      Handle<JSObject> source);
+
   /// Return a reference to an internal property slot.
   static GCHermesValue &
   internalPropertyRef(JSObject *self, Runtime *runtime, SlotIndex index) {
@@ -694,6 +715,27 @@ class JSObject : public GCCell {
       PropOpFlags opFlags = PropOpFlags(),
       PropertyCacheEntry *cacheEntry = nullptr);
 
+  /// Check whether the prototype chain cache \p proto applies to \p self.
+  /// \return the object holding the cached property, or nullptr if the cache
+  ///   is empty or does not apply.
+  static inline JSObject *getCachedPrototypeHolder(
+      JSObject *self,
+      Runtime *runtime,
+      const PrototypeCacheEntry &proto);
+
+  /// Record in \p cacheEntry the prototype chain of \p self leading to
+  /// \p holder, which owns the property in \p slot. Nothing is cached if the
+  /// chain is too long or contains objects whose class cannot guard it.
+  /// \p accessor is whether the property is an accessor, in which case
+  /// \p holder may be \p self.
+  static void cachePrototypeHolder(
+      JSObject *self,
+      Runtime *runtime,
+      JSObject *holder,
+      SlotIndex slot,
+      PropertyCacheEntry *cacheEntry,
+      bool accessor = false);
+
   // getNamedOrIndexed accesses a property with a SymbolIDs which may be
   // index-like.
   static CallResult<HermesValue> getNamedOrIndexed(
@@ -732,12 +774,15 @@ class JSObject : public GCCell {
   /// The following three methods implement ES5.1 8.12.5.
   /// putNamed is an optimized path for setting a property with a SymbolID when
   /// it is statically known that the SymbolID is not index-like.
+  /// If \p cacheEntry is not null and the property is an accessor with a
+  /// setter, cache its holder in the entry.
   static CallResult<bool> putNamed_RJS(
       Handle<JSObject> selfHandle,
       Runtime *runtime,
       SymbolID name,
       Handle<> valueHandle,
-      PropOpFlags opFlags = PropOpFlags());
+      PropOpFlags opFlags = PropOpFlags(),
+      PropertyCacheEntry *cacheEntry = nullptr);
 
   /// putNamedOrIndexed sets a property with a SymbolID which may be index-like.
   static CallResult<bool> putNamedOrIndexed(
@@ -892,6 +937,15 @@ class JSObject : public GCCell {
   /// Set [[Extensible]] to false, preventing adding more properties.
   static void preventExtensions(JSObject *self);
 
+  /// If \p selfHandle is in dictionary mode, switch it back to a shared hidden
+  /// class with the same properties in the same order, so that accesses to it
+  /// can be cached again. This should be used when the object is expected to
+  /// stop changing, e.g. once it is used as a prototype. The object stays in
+  /// dictionary mode if its shape can't be shared.
+  static ExecutionStatus leaveDictionaryMode(
+      Handle<JSObject> selfHandle,
+      Runtime *runtime);
+
   /// ES5.1 15.2.3.11.
   /// No properties are configurable.
   /// [[Extensible]] is false.
@@ -1156,6 +1210,15 @@ CallResult<Handle<BigStorage>> getForInPropertyNames(
     uint32_t &beginIndex,
     uint32_t &endIndex);
 
+/// \return true if \p arr, returned by getForInPropertyNames() for \p obj,
+/// is still the for-in cache of the class of \p obj and the classes of its
+/// prototypes haven't changed since. Every name in it is then still a
+/// property of \p obj or of one of its prototypes.
+bool isForInCacheValid(
+    Runtime *runtime,
+    Handle<JSObject> obj,
+    Handle<BigStorage> arr);
+
 /// This object is the value of a property which has a getter and/or setter.
 class PropertyAccessor final : public GCCell {
  protected:
@@ -1323,6 +1386,25 @@ inline OptValue<bool> JSObject::tryGetOwnNamedDescriptorFast(
       self->clazz_.getNonNull(runtime), runtime, name, desc);
 }
 
+inline JSObject *JSObject::getCachedPrototypeHolder(
+    JSObject *self,
+    Runtime *runtime,
+    const PrototypeCacheEntry &proto) {
+  if (proto.receiverClazz != self->getClass(runtime) ||
+      LLVM_UNLIKELY(self->flags_.lazyObject || self->flags_.hostObject)) {
+    return nullptr;
+  }
+  JSObject *obj = self;
+  for (unsigned i = 0; i < proto.depth; ++i) {
+    obj = obj->getParent(runtime);
+    if (!obj || obj->getClass(runtime) != proto.chainClazz[i] ||
+        LLVM_UNLIKELY(obj->flags_.lazyObject || obj->flags_.hostObject)) {
+      return nullptr;
+    }
+  }
+  return obj;
+}
+
 inline JSObject *JSObject::getNamedDescriptor(
     Handle<JSObject> selfHandle,
     Runtime *runtime,
@@ -8,6 +8,7 @@
 #define HERMES_VM_JSREGEXP_H
 
 #include "hermes/VM/CopyableVector.h"
+#include "hermes/VM/JIT/RegExpJIT.h"
 #include "hermes/VM/JSObject.h"
 #include "hermes/VM/RegExpMatch.h"
 #include "hermes/VM/SmallXString.h"
@@ -109,10 +110,24 @@ class JSRegExp final : public JSObject {
   JSRegExp(Runtime *runtime, JSObject *parent, HiddenClass *clazz)
       : JSObject(runtime, &vt.base, parent, clazz) {}
 
+  /// \return the native code to search with, compiling the bytecode once the
+  /// regexp has been searched often enough, or null if the bytecode should be
+  /// interpreted.
+  static const JITCompiledRegExp *getJITCode(JSRegExp *self, Runtime *runtime);
+
   CopyableVector<uint8_t> bytecode_;
 
   FlagBits flagBits_ = {};
 
+#ifdef HERMESVM_JIT
+  /// Number of searches which interpreted the bytecode, up to
+  /// JITCompiledRegExp::kSearchThreshold + 1.
+  uint32_t searchCount_ = 0;
+
+  /// The native code compiled from the bytecode, if any.
+  std::unique_ptr<JITCompiledRegExp> jitCode_;
+#endif
+
   // Finalizer to clean up stored native regex
   static void _finalizeImpl(GCCell *cell, GC *gc);
 
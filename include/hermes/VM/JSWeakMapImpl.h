@@ -179,7 +179,8 @@ class JSWeakMapImplBase : public JSObject {
   void markWeakRefs(GC *gc);
 
   /// Iterate the slots in map_ and call deleteInternal on any invalid
-  /// references, adding all available slots to the free list.
+  /// references, adding all available slots to the free list. Shrink map_ if
+  /// most of it is empty afterwards.
   void findAndDeleteFreeSlots(PointerBase *base);
 
   /// Erase the map entry and corresponding valueStorage entry
@@ -209,6 +210,11 @@ class JSWeakMapImplBase : public JSObject {
   /// Number indicating the end of the free list.
   static constexpr uint32_t kFreeListInvalid{UINT32_MAX};
 
+  /// map_ is shrunk when it uses more than kMinShrinkSize bytes and more than
+  /// kShrinkRatio times the size of its entries.
+  static constexpr size_t kMinShrinkSize{4096};
+  static constexpr size_t kShrinkRatio{8};
+
   /// Index of the first free spot in the valueStorage_ free list.
   /// If kFreeListInvalid, then the free list is completely empty,
   /// and the nextIndex_ should be used.
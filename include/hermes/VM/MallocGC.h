@@ -209,7 +209,10 @@ class MallocGC final : public GCBase {
 #endif
 
   /// Same as in superclass GCBase.
-  virtual void createSnapshot(llvm::raw_ostream &os, bool compact) override;
+  using GCBase::createSnapshot;
+  virtual void createSnapshot(
+      llvm::raw_ostream &os,
+      const HeapSnapshotOptions &options) override;
 
   void getHeapInfo(HeapInfo &info) override;
   void getHeapInfoWithMallocSize(HeapInfo &info) override;
@@ -10,6 +10,8 @@
 #include "hermes/VM/AlignedStorage.h"
 #include "hermes/VM/HeapAlign.h"
 
+#include <atomic>
+
 namespace hermes {
 namespace vm {
 
@@ -51,6 +53,12 @@ class MarkBitArrayNC {
   /// range of the array.
   inline void mark(size_t ind);
 
+  /// Atomically marks the bit for the given index, which is required to be
+  /// within the range of the array. Safe to call concurrently with other calls
+  /// to markAtomic on the same array.
+  /// \return true if the bit was not set before this call.
+  inline bool markAtomic(size_t ind);
+
   /// Clears the bit array.
   inline void clear();
 
@@ -139,6 +147,23 @@ void MarkBitArrayNC::mark(size_t ind) {
   bitArray_[ind / kBitsPerVal] |= (size_t)1 << (ind % kBitsPerVal);
 }
 
+bool MarkBitArrayNC::markAtomic(size_t ind) {
+  assert(
+      ind < kValidIndices &&
+      "precondition: ind must be within the index range");
+  static_assert(
+      sizeof(std::atomic<size_t>) == sizeof(size_t),
+      "atomic words must have the same layout as plain ones");
+  const size_t bit = (size_t)1 << (ind % kBitsPerVal);
+  auto *word =
+      reinterpret_cast<std::atomic<size_t> *>(&bitArray_[ind / kBitsPerVal]);
+  // Avoid the read-modify-write if the bit is already set, which is the common
+  // case for heavily shared objects.
+  if (word->load(std::memory_order_relaxed) & bit)
+    return false;
+  return !(word->fetch_or(bit, std::memory_order_relaxed) & bit);
+}
+
 void MarkBitArrayNC::clear() {
   ::memset(bitArray_, 0, sizeof(bitArray_));
 }
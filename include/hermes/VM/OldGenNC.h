@@ -150,6 +150,18 @@ class OldGen : public GCGeneration {
   void growTo(size_t desired);
   void shrinkTo(size_t desired);
   bool growToFit(size_t amount);
+
+  /// Free the segments cached for future growth, and return the pages above
+  /// the level of the segments in use to the OS.
+  /// \return the number of bytes returned.
+  size_t releaseUnusedMemory();
+
+  /// Free the cached segments, and return the pages above the peak level of
+  /// the segments in use to the OS, that stayed unused since the previous
+  /// call, see AlignedHeapSegment::adviseUnreached.
+  /// \return the number of bytes returned.
+  size_t releaseDecayedMemory();
+
   inline GCSegmentRange::Ptr allSegments();
   gcheapsize_t bytesAllocatedSinceLastGC() const;
   template <typename F>
@@ -224,9 +236,17 @@ class OldGen : public GCGeneration {
   ///     quota could be met, immediately following this call.
   bool ensureFits(size_t amount);
 
+  /// The number of cards considered when scanning for pointers into the young
+  /// generation, and the number of those that were skipped because their card
+  /// table summary entry was clean.
+  struct CardScanCounts {
+    size_t numCards{0};
+    size_t numSkipped{0};
+  };
+
   /// Find all pointers in the current generation that point into
   /// youngGen, and apply the current mark function to them.
-  void markYoungGenPointers(Location originalLevel);
+  CardScanCounts markYoungGenPointers(Location originalLevel);
 
   /// Complete an in-progress young-gen collection.  Some number of
   /// young-gen objects have been found reachable and promoted into
@@ -266,8 +286,13 @@ class OldGen : public GCGeneration {
   void verifyCardTableBoundaries() const;
 #endif
 
-  /// See GCGeneration.h for more information.
-  void sweepAndInstallForwardingPointers(GC *gc, SweepResult *sweepResult);
+  /// See GCGeneration.h for more information.  Segments are swept in place if
+  /// at least \p inPlaceLivePercent of their used bytes are live, see
+  /// AlignedHeapSegment::sweepAndInstallForwardingPointers.
+  void sweepAndInstallForwardingPointers(
+      GC *gc,
+      SweepResult *sweepResult,
+      unsigned inPlaceLivePercent);
 
   /// See GCGeneration.h for more information.
   void updateReferences(GC *gc, SweepResult::VTablesRemaining &vTables);
@@ -384,6 +409,11 @@ class OldGen : public GCGeneration {
   /// retained to serve requests to materialize segments in the future.
   std::vector<AlignedHeapSegment> segmentCache_;
 
+  /// The lowest size of segmentCache_ since the previous call of
+  /// releaseDecayedMemory(). Segments are taken from the back of the cache,
+  /// so the ones below were not used since then.
+  size_t segmentCacheLowWater_{0};
+
   /// We allocate in segments in "logical" order, and compact to low "logical"
   /// addresses.  This member holds the sum of the used portions of all but the
   /// last "used segment".
@@ -7,11 +7,13 @@
 #ifndef HERMES_VM_OPERATIONS_H
 #define HERMES_VM_OPERATIONS_H
 
+#include "hermes/Inst/Inst.h"
 #include "hermes/VM/CallResult.h"
 #include "hermes/VM/InternalProperty.h"
 #include "hermes/VM/Runtime.h"
 #include "hermes/VM/SymbolID.h"
 
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
 
 namespace hermes {
@@ -182,6 +184,9 @@ CallResult<Handle<SymbolID>> valueToSymbolID(
 /// `typeof` operator.
 HermesValue typeOf(Runtime *runtime, Handle<> valueHandle);
 
+/// \return whether `typeof value` is the string of \p type.
+bool typeOfIs(HermesValue value, inst::TypeOfIsType type);
+
 /// Convert a string to an array index following ES5.1 15.4.
 /// A property name P (in the form of a String value) is an array index if and
 /// only if ToString(ToUint32(P)) is equal to P and ToUint32(P) is not equal to
@@ -193,6 +198,11 @@ OptValue<uint32_t> toArrayIndex(
 /// Fast path for toArrayIndex where we already have the view of the string.
 OptValue<uint32_t> toArrayIndex(StringView str);
 
+/// Convert the short, flat string \p str to an array index, without
+/// allocating. Longer strings and unflattened ropes, which can't be array
+/// indices or would be expensive to check, return None.
+OptValue<uint32_t> toArrayIndexFastPath(const StringPrimitive *str);
+
 /// If it is possible to cheaply verify that \p value is an array index
 /// according to the rules in ES5.1 15.4, do so and return the index. Note that
 /// it this fails, the value may still be a valid index.
@@ -202,6 +212,9 @@ inline OptValue<uint32_t> toArrayIndexFastPath(HermesValue value) {
   if (value.isNumber()) {
     return hermes::doubleToArrayIndex(value.getNumber());
   }
+  if (value.isString()) {
+    return toArrayIndexFastPath(value.getString());
+  }
   return llvm::None;
 }
 
@@ -236,6 +249,15 @@ inline char16_t letterToLower(char16_t c) {
 /// \returns the double that results, and NaN on failure.
 double parseIntWithRadix(const StringView str, int radix);
 
+/// Parse the decimal number at the start of \p str with
+/// hermes::parseDecimalFast().
+/// \param[out] parsedLength set to the number of characters parsed on
+/// success.
+/// \return the value, or None if the general conversion must be used.
+OptValue<double> parseDecimalFast(
+    const StringView str,
+    uint32_t *parsedLength);
+
 /// Takes a finite double \p number and a base \p radix (between 2 and 36
 /// inclusive), and returns the string that results from converting \p number
 /// into a string in base \p radix.
@@ -370,6 +392,20 @@ CallResult<Handle<StringPrimitive>> symbolDescriptiveString(
 /// ES6.0 22.1.3.1.1
 CallResult<bool> isConcatSpreadable(Runtime *runtime, Handle<> value);
 
+/// ES6.0 12.2.9.3 Runtime Semantics: GetTemplateObject ( templateLiteral )
+/// Create the frozen template object of a template literal with \p count
+/// elements and cache it in \p runtimeModule as \p templateObjID.
+/// \p getString(i) returns the i-th raw string. Unless \p dup is true, in
+/// which case the cooked strings are the same as the raw strings, it
+/// returns the i-th cooked string at index count + i.
+CallResult<HermesValue> createTemplateObject(
+    Runtime *runtime,
+    RuntimeModule *runtimeModule,
+    uint32_t templateObjID,
+    uint32_t count,
+    bool dup,
+    llvm::function_ref<HermesValue(uint32_t)> getString);
+
 /// \return true if and only if \p id is a primitive SymbolID backing a JS
 /// Symbol instance.
 constexpr bool isSymbolPrimitive(SymbolID id) {
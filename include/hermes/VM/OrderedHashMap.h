@@ -8,74 +8,39 @@
 #define HERMES_VM_ORDERED_HASHMAP_H
 
 #include "hermes/Support/ErrorHandling.h"
-#include "hermes/VM/ArrayStorage.h"
 #include "hermes/VM/Runtime.h"
-
-#include <vector>
+#include "hermes/VM/SegmentedArray.h"
 
 namespace hermes {
 namespace vm {
 
-/// HashMapEntry is a gc-managed entry in the OrderedHashMap.
-/// We use HashMapEntry to form two separate linked lists,
-/// one that tracks the insertion order for iteration purpose, one
-/// tracks the list of entries in a hash table bucket for hash operations.
-class HashMapEntry final : public GCCell {
- public:
-  static VTable vt;
-
-  /// The key.
-  GCHermesValue key;
-
-  /// The value.
-  GCHermesValue value;
-
-  /// Previous entry in insertion order.
-  GCPointer<HashMapEntry> prevIterationEntry{nullptr};
-
-  /// Next entry in insertion order.
-  GCPointer<HashMapEntry> nextIterationEntry{nullptr};
-
-  /// Next entry in the hash table bucket.
-  GCPointer<HashMapEntry> nextEntryInBucket{nullptr};
-
-  static bool classof(const GCCell *cell) {
-    return cell->getKind() == CellKind::HashMapEntryKind;
-  }
-
-  static CallResult<HermesValue> create(Runtime *runtime);
-
-  /// Indicates whether this entry has been deleted.
-  bool isDeleted() const {
-    assert(key.isEmpty() == value.isEmpty() && "Inconsistent deleted status");
-    return value.isEmpty();
-  }
-
-  /// Mark this entry as deleted.
-  void markDeleted() {
-    key.setNonPtr(HermesValue::encodeEmptyValue());
-    value.setNonPtr(HermesValue::encodeEmptyValue());
-  }
-
- protected:
-  HashMapEntry(Runtime *runtime) : GCCell(&runtime->getHeap(), &vt) {}
-}; // HashMapEntry
-
 /// OrderedHashMap is a gc-managed hash map that maintains insertion order.
-/// The map contains two conceptual parts: a standard chained hash table,
-/// to store and lookup HermesValue; a linked list to maintain the insertion
-/// order.
-/// When an element is added, it's always appended to the end of the linked
-/// list. When an element is deleted, we mark it as deleted and remove it
-/// from the linked list, unless it's the last element.
-/// Iterators are pointers to the entries, which are always linked according
-/// to insertion order.
-/// When the size of the hash table becomes unreasonably large or small
-/// comparing to the number of alive elements, we will rehash the table.
-/// We always make sure that any entry at any moment can successfully find
-/// the next entry according to insertion order, and rely on GC to manage
-/// the "deleted" entries", free them when no more iterators are before
-/// that entry.
+/// Like a compact dictionary, the whole map lives in a single table: a dense
+/// array of entries in insertion order, preceded by the heads of the hash
+/// buckets. Buckets are chained through the entries themselves, using entry
+/// indices, so inserting an element never allocates anything but a larger
+/// table once the current one is full.
+///
+/// The table is a SegmentedArray with the layout:
+/// \pre
+///   [0]                             the table that replaced this one, if any
+///   [1, 1 + B)                      index of the newest entry in each bucket
+///   [1 + B + 3i]                    key of entry i
+///   [1 + B + 3i + 1]                value of entry i
+///   [1 + B + 3i + 2]                index of the next entry in the same bucket
+/// \endpre
+/// where B is half the number of entries, and indices are native values. An
+/// empty slot stands for "none".
+///
+/// Erasing an element leaves a hole in the entries, marked by an empty key and
+/// value. When the table fills up, or becomes mostly holes, the live entries
+/// are copied in order into a new table, and the old table records the new one
+/// in its first slot. Iterators are (table, index) pairs: an iterator that
+/// finds its table has been replaced follows the chain of replacements,
+/// subtracting the holes that were dropped before its position each time, so
+/// that it continues with the next entry regardless of how the map was
+/// modified. Clearing the map makes every entry a hole and replaces the table
+/// in the same way.
 class OrderedHashMap final : public GCCell {
   friend void OrderedHashMapBuildMeta(
       const GCCell *cell,
@@ -90,6 +55,9 @@ class OrderedHashMap final : public GCCell {
 
   static CallResult<HermesValue> create(Runtime *runtime);
 
+  /// Returned by iteratorNext when there are no entries left.
+  static constexpr uint32_t kIterationEnd = UINT32_MAX;
+
   /// \return true if the map contains a given HermesValue.
   static bool has(Handle<OrderedHashMap> self, Runtime *runtime, Handle<> key);
 
@@ -98,11 +66,6 @@ class OrderedHashMap final : public GCCell {
   static HermesValue
   get(Handle<OrderedHashMap> self, Runtime *runtime, Handle<> key);
 
-  /// Lookup \p key in the table and \return the value if exists.
-  /// Otherwise \return nullptr.
-  static HashMapEntry *
-  find(Handle<OrderedHashMap> self, Runtime *runtime, Handle<> key);
-
   /// Insert a key/value pair into the map, if not already existing.
   static ExecutionStatus insert(
       Handle<OrderedHashMap> self,
@@ -114,77 +77,95 @@ class OrderedHashMap final : public GCCell {
   static bool
   erase(Handle<OrderedHashMap> self, Runtime *runtime, Handle<> key);
 
-  /// Clear the map.  The \p gc parameter is necessary for write barriers.
-  void clear(Runtime *runtime);
+  /// Clear the map.
+  static ExecutionStatus clear(Handle<OrderedHashMap> self, Runtime *runtime);
 
   /// \return the size of the map.
   uint32_t size() const {
     return size_;
   }
 
-  /// \return the next element in insertion order.
-  /// If \p entry is nullptr, we are starting the iteration from the first
-  /// entry that is not deleted.
-  /// Otherwise, we look for the next element after \p entry that is not
-  /// deleted.
-  HashMapEntry *iteratorNext(Runtime *runtime, HashMapEntry *entry = nullptr)
-      const;
+  /// Find the next element in insertion order for the iterator at entry
+  /// \p index of \p table. A null \p table starts the iteration from the first
+  /// entry. \p table is updated to the current table of the map.
+  /// \return the index of the element in the current table, which is at or
+  /// after the position of the iterator, or kIterationEnd if there are no
+  /// elements left. The iterator continues from the returned index plus one.
+  uint32_t
+  iteratorNext(Runtime *runtime, SegmentedArray *&table, uint32_t index);
+
+  /// \return the key of the entry at \p index in the current table.
+  HermesValue getKeyAt(Runtime *runtime, uint32_t index) const {
+    return table_.get(runtime)->at(keySlot(index));
+  }
+
+  /// \return the value of the entry at \p index in the current table.
+  HermesValue getValueAt(Runtime *runtime, uint32_t index) const {
+    return table_.get(runtime)->at(keySlot(index) + 1);
+  }
 
  protected:
-  OrderedHashMap(Runtime *runtime, Handle<ArrayStorage> hashTableStorage);
+  OrderedHashMap(Runtime *runtime, Handle<SegmentedArray> table);
 
  private:
-  /// The hashtable, with size always equal to capacity_. The number of
-  /// reachable entries from hashTable_ should be equal to size_.
-  GCPointer<ArrayStorage> hashTable_{nullptr};
+  /// The current table, see the class comment for its layout.
+  GCPointer<SegmentedArray> table_{nullptr};
 
-  /// The first entry ever inserted. We need this entry to begin an iteration.
-  GCPointer<HashMapEntry> firstIterationEntry_{nullptr};
+  /// Number of entries in a new table.
+  static constexpr uint32_t INITIAL_CAPACITY = 8;
 
-  /// The last entry inserted. We need it to add new elements afterwards.
-  GCPointer<HashMapEntry> lastIterationEntry_{nullptr};
+  /// Slots in a table before the buckets.
+  static constexpr uint32_t kHeaderSize = 1;
 
-  /// Initial capacity of the hash table.
-  static constexpr uint32_t INITIAL_CAPACITY = 16;
+  /// Slots taken by each entry.
+  static constexpr uint32_t kEntrySize = 3;
 
-  /// Maximum capacity cannot exceed the maximum capacity of the underlying
-  /// ArrayStorage.
-  // It needs to be less than 1/4th the max 32-bit integer in order to use an
-  // integer-based load factor check of 0.75.
-  /// TODO(T31421960): Use constexpr std::min.
+  /// Maximum capacity, such that the table of a map fits in a SegmentedArray.
   static constexpr uint32_t MAX_CAPACITY =
-      ArrayStorage::maxElements() < UINT32_MAX / 4 ? ArrayStorage::maxElements()
-                                                   : UINT32_MAX / 4;
+      (SegmentedArray::maxElements() - kHeaderSize) / (kEntrySize + 1);
 
-  /// Capacity of the hash table.
+  /// Number of entries the current table has room for. Always a power of 2.
   uint32_t capacity_{INITIAL_CAPACITY};
 
+  /// Number of entries used in the current table, including holes.
+  uint32_t numEntries_{0};
+
   /// Number of alive entries in the storage.
   uint32_t size_{0};
 
-  /// Hash a HermesValue to an index to our hash table.
+  /// \return the number of slots of a table with room for \p capacity entries.
+  static uint32_t tableSize(uint32_t capacity) {
+    return kHeaderSize + capacity / 2 + capacity * kEntrySize;
+  }
+
+  /// \return the number of entries a table of \p size slots has room for.
+  static uint32_t tableCapacity(uint32_t size) {
+    return (size - kHeaderSize) * 2 / (kEntrySize * 2 + 1);
+  }
+
+  /// \return the slot of the key of entry \p index in the current table.
+  uint32_t keySlot(uint32_t index) const {
+    return kHeaderSize + capacity_ / 2 + index * kEntrySize;
+  }
+
+  /// Hash a HermesValue to the slot of its bucket in the current table.
   static uint32_t
   hashToBucket(Handle<OrderedHashMap> self, Runtime *runtime, Handle<> key) {
     auto hash = runtime->gcStableHashHermesValue(key);
     assert(
         (self->capacity_ & (self->capacity_ - 1)) == 0 &&
         "capacity_ must be power of 2");
-    return hash & (self->capacity_ - 1);
+    return kHeaderSize + (hash & (self->capacity_ / 2 - 1));
   }
 
-  /// Remove a node from the linked list.
-  void removeLinkedListNode(Runtime *runtime, HashMapEntry *entry, GC *gc);
+  /// Lookup an entry with key as \p key in the bucket at \p bucketSlot.
+  /// \return its index, or kIterationEnd if there is none.
+  uint32_t lookupInBucket(Runtime *runtime, uint32_t bucketSlot, HermesValue key);
 
-  /// Lookup an entry with key as \p key in a given \p bucket.
-  HashMapEntry *
-  lookupInBucket(Runtime *runtime, uint32_t bucket, HermesValue key);
-
-  /// Adjust the capacity of the hashtable and rehash if necessary.
-  /// We make decisions based on the Load Factor (size / capacity).
-  /// Rehash if load factor is outside of the range of [0.25, 0.75].
-  static ExecutionStatus rehashIfNecessary(
-      Handle<OrderedHashMap> self,
-      Runtime *runtime);
+  /// Copy the live entries into a new table with room for \p newCapacity
+  /// entries, and make the old table point to it.
+  static ExecutionStatus
+  rehash(Handle<OrderedHashMap> self, Runtime *runtime, uint32_t newCapacity);
 }; // OrderedHashMap
 } // namespace vm
 } // namespace hermes
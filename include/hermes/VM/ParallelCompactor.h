@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_VM_PARALLELCOMPACTOR_H
+#define HERMES_VM_PARALLELCOMPACTOR_H
+
+#include "hermes/VM/GCCell.h"
+#include "hermes/VM/SweepResultNC.h"
+
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+class AlignedHeapSegment;
+
+/// Runs the reference updating and object moving phases of a full collection
+/// on several threads, one segment at a time.
+///
+/// Forwarding addresses are still assigned serially by the sweep, which
+/// records in SweepResult::segments where the cells of each segment start in
+/// displacedVtablePtrs and where they are moved to.  With that, updating the
+/// references of a segment is independent of every other segment.  Moving the
+/// cells of a segment is not: it overwrites the destination segments, so it
+/// may only start once the cells of those segments have been moved out of the
+/// way.  The segments are claimed in sweep order, so the oldest unfinished
+/// segment never has to wait, and the phase always makes progress.
+class ParallelCompactor {
+ public:
+  /// \param gc the collector whose heap is being compacted.
+  /// \param numThreads the total number of threads, including the calling
+  ///   thread. Must be at least 1.
+  /// \param sweepResult the result of sweeping \p segments.
+  /// \param segments the swept segments, in the order they were swept.
+  ParallelCompactor(
+      GC *gc,
+      unsigned numThreads,
+      const SweepResult &sweepResult,
+      std::vector<AlignedHeapSegment *> segments);
+
+  /// Update the references held by the live cells of every segment, as
+  /// AlignedHeapSegment::updateReferences does.
+  void updateReferences();
+
+  /// Move the live cells of every segment to their post-compaction addresses
+  /// and restore their VTables, as AlignedHeapSegment::compact does.
+  void compact();
+
+ private:
+  /// \return the range of displaced VTable pointers of the segment at
+  ///   \p index.
+  SweepResult::VTablesRemaining vTablesOf(size_t index) const;
+
+  /// \return the index of the segment that contains \p ptr, or the number of
+  ///   segments if it is not in any of them.
+  size_t indexOf(const char *ptr) const;
+
+  /// Call \p work on every thread, and return once all calls have returned.
+  template <typename F>
+  void runOnThreads(F work);
+
+  GC *const gc_;
+  const unsigned numThreads_;
+  const SweepResult &sweepResult_;
+  const std::vector<AlignedHeapSegment *> segments_;
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_PARALLELCOMPACTOR_H
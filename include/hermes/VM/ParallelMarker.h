@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_VM_PARALLELMARKER_H
+#define HERMES_VM_PARALLELMARKER_H
+
+#include "hermes/VM/GCCell.h"
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+class AlignedHeapSegment;
+
+/// Completes the marking phase of a full collection using several threads.
+///
+/// Every cell whose mark bit is set when marking starts is treated as gray.
+/// Each worker owns a private mark stack, and periodically publishes part of
+/// it to a shared queue that idle workers steal from. Mark bits are set with
+/// atomic operations, so every reachable cell is scanned by exactly one
+/// worker. Operations on GC state that is not thread safe (marking symbols and
+/// weak references) are recorded by the workers and applied on the calling
+/// thread once all of them have finished.
+class ParallelMarker {
+ public:
+  /// \param gc the collector whose heap is being marked.
+  /// \param numThreads the total number of threads marking, including the
+  ///   calling thread. Must be at least 1.
+  ParallelMarker(GC *gc, unsigned numThreads);
+  ~ParallelMarker();
+
+  /// Transitively mark all cells reachable from the cells that are currently
+  /// marked in \p segments. Returns once the closure is complete.
+  void completeMarking(const std::vector<AlignedHeapSegment *> &segments);
+
+ private:
+  struct Worker;
+  struct MarkAcceptor;
+
+  /// Number of cells a worker must have on its private stack before it
+  /// publishes some of them.
+  static constexpr size_t kShareThreshold = 64;
+
+  /// Scan cells until there is no work left anywhere.
+  void run(Worker &worker);
+
+  /// Move half of the private stack of \p worker to its shared queue if the
+  /// private stack is large and the shared queue is empty.
+  void shareWork(Worker &worker);
+
+  /// Refill the private stack of \p worker, first from its own shared queue
+  /// and then by stealing from the other workers.
+  /// \return true if some work was found.
+  bool acquireWork(Worker &worker);
+
+  /// \return true if any shared queue appears to be non-empty.
+  bool workAvailable() const;
+
+  /// Apply the symbol and weak reference marks recorded by the workers.
+  void mergeResults();
+
+  GC *const gc_;
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  /// Number of workers that found no work to do and are waiting for either
+  /// more work or termination.
+  std::atomic<unsigned> numIdle_{0};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_PARALLELMARKER_H
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_VM_PLACEDSTORAGEPROVIDER_H
+#define HERMES_VM_PLACEDSTORAGEPROVIDER_H
+
+#include "hermes/VM/StorageProvider.h"
+
+#include <memory>
+
+namespace hermes {
+namespace vm {
+
+/// A PlacedStorageProvider is an adapter that asks the OS to back the storage
+/// it hands out with transparent huge pages, and/or to allocate it on the NUMA
+/// node of the thread that first touches it (normally the runtime's thread).
+/// Both are hints: if the OS does not honour them, the storage is still valid
+/// and backed by ordinary pages.
+class PlacedStorageProvider final : public StorageProvider {
+  std::unique_ptr<StorageProvider> delegate_;
+  const bool hugePages_;
+  const bool numaLocal_;
+
+ public:
+  PlacedStorageProvider(
+      std::unique_ptr<StorageProvider> &&provider,
+      bool hugePages,
+      bool numaLocal)
+      : delegate_(std::move(provider)),
+        hugePages_(hugePages),
+        numaLocal_(numaLocal) {}
+
+  llvm::ErrorOr<void *> newStorage(const char *name) override;
+
+  void deleteStorage(void *storage) override;
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif
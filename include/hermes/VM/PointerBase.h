@@ -35,8 +35,10 @@ class BasedPointer final {
 
   // Only PointerBase needs to access this field and the constructor. To every
   // other part of the system this is an opaque type that PointerBase handles
-  // translations for.
+  // translations for. SmallHermesValue packs a tag into the low bits of the
+  // offset.
   friend class PointerBase;
+  friend class SmallHermesValue;
 };
 
 /// PointerBase is an opaque type meant to be used as a base pointer.
@@ -10,13 +10,20 @@
 #ifdef HERMESVM_PROFILER_OPCODE
 #include <x86intrin.h>
 
-#define INIT_OPCODE_PROFILER      \
-  uint64_t startTime = __rdtsc(); \
-  unsigned curOpcode = (unsigned)OpCode::Call;
-
-#define RECORD_OPCODE_START_TIME                \
-  curOpcode = (unsigned)ip->opCode;             \
-  runtime->opcodeExecuteFrequency[curOpcode]++; \
+#define INIT_OPCODE_PROFILER                   \
+  uint64_t startTime = __rdtsc();              \
+  unsigned curOpcode = (unsigned)OpCode::Call; \
+  unsigned prevOpcode = curOpcode;             \
+  unsigned prevPrevOpcode = curOpcode;
+
+#define RECORD_OPCODE_START_TIME                                   \
+  prevPrevOpcode = prevOpcode;                                     \
+  prevOpcode = curOpcode;                                          \
+  curOpcode = (unsigned)ip->opCode;                                \
+  runtime->opcodeExecuteFrequency[curOpcode]++;                    \
+  runtime->opcodePairFrequency[prevOpcode][curOpcode]++;           \
+  runtime->opcodeTripleFrequency[(prevPrevOpcode << 16) |          \
+                                 (prevOpcode << 8) | curOpcode]++; \
   startTime = __rdtsc();
 
 #define UPDATE_OPCODE_TIME_SPENT \
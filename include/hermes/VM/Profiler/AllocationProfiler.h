@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_VM_PROFILER_ALLOCATIONPROFILER_H
+#define HERMES_VM_PROFILER_ALLOCATIONPROFILER_H
+
+#include "hermes/VM/Runtime.h"
+#include "hermes/VM/WeakRef.h"
+
+#include "llvm/Support/raw_ostream.h"
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+class Domain;
+
+/// Samples the allocations of a runtime, about one every samplingInterval
+/// bytes, and records the JS stack of each sample, down to the bytecode
+/// instruction of each frame. Sampled objects are tracked with weak
+/// references, so that the bytes still alive at each allocation site are known
+/// after every collection. Since the interval between samples is drawn from an
+/// exponential distribution, an object of size S is sampled with probability
+/// 1 - exp(-S / samplingInterval) regardless of the allocations around it, and
+/// each sample is scaled accordingly when the profile is written.
+class AllocationProfiler {
+ public:
+  AllocationProfiler(Runtime *runtime, uint32_t samplingInterval);
+
+  /// Record the allocation of the \p size bytes at \p cell, which the caller
+  /// is about to construct.
+  /// \return the number of bytes to allocate before the next sample.
+  int64_t sample(void *cell, uint32_t size);
+
+  /// \return the number of bytes to allocate before the first sample.
+  int64_t nextSampleDistance();
+
+  /// Mark the domains of the sampled frames, and the weak references to the
+  /// sampled objects that are still alive. Forget those that have been
+  /// collected.
+  void markRoots(SlotAcceptorWithNames &acceptor);
+
+  /// Write the live samples to \p OS in the format of the sampling heap
+  /// profiler of Chrome (.heapprofile), which can be loaded in the Memory tab
+  /// of the DevTools.
+  void serialize(llvm::raw_ostream &OS);
+
+ private:
+  /// A frame of a sampled stack. Native functions have no module, and are
+  /// told apart by \c functionId, which is the index of their pointer in
+  /// nativeFunctions_.
+  struct Frame {
+    RuntimeModule *module;
+    uint32_t functionId;
+    uint32_t offset;
+  };
+
+  /// A node of the tree of the sampled stacks, which is the frame at the
+  /// top of the stack of its parent.
+  struct Node {
+    Frame frame;
+    /// Index of the parent, or the node itself for the root.
+    uint32_t parent;
+    std::vector<uint32_t> children{};
+    /// The bytes allocated with this node on the top of the stack that are
+    /// still alive as of the last collection, as estimated from the samples.
+    double liveBytes{0};
+  };
+
+  /// An object that was sampled and has not been collected yet.
+  struct Sample {
+    WeakRef<HermesValue> ref;
+    uint32_t node;
+    uint32_t size;
+    /// The order of the sample among all the samples taken.
+    uint64_t ordinal;
+  };
+
+  /// \return the child of \p parent for \p frame, adding it if it is new.
+  uint32_t getChild(uint32_t parent, const Frame &frame);
+
+  /// Remove the samples whose objects have been collected.
+  void pruneSamples();
+
+  /// \return the size that a sample of \p size bytes stands for.
+  double scaledSize(uint32_t size) const;
+
+  Runtime *const runtime_;
+  const uint32_t samplingInterval_;
+
+  std::minstd_rand rng_{};
+  std::exponential_distribution<double> distribution_;
+
+  /// The nodes of the tree, the root first.
+  std::vector<Node> nodes_;
+  /// Maps (parent, module, functionId, offset) to the child node.
+  std::map<std::tuple<uint32_t, RuntimeModule *, uint32_t, uint32_t>, uint32_t>
+      childIndex_{};
+
+  /// The domains of the modules of the sampled frames, which are kept alive
+  /// so that the frames can be symbolicated.
+  std::vector<Domain *> domains_{};
+  /// The native functions seen in sampled frames.
+  std::vector<uintptr_t> nativeFunctions_{};
+
+  std::vector<Sample> samples_{};
+  uint64_t numSamples_{0};
+
+  /// Scratch space for the frames of the stack being sampled, leaf first.
+  std::vector<Frame> scratch_{};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_PROFILER_ALLOCATIONPROFILER_H
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_VM_PROFILER_EXECUTIONTRACER_H
+#define HERMES_VM_PROFILER_EXECUTIONTRACER_H
+
+#include "hermes/Inst/Inst.h"
+#include "hermes/VM/PropertyCache.h"
+#include "hermes/VM/Runtime.h"
+
+#include "llvm/Support/raw_ostream.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+class CodeBlock;
+class Domain;
+
+/// Records the events that change how fast a function runs: the state
+/// transitions of its property caches, the quickening of its instructions and
+/// their reversal, the conversion of hidden classes to dictionary mode, and
+/// the JIT bailouts. The entries and exits of interpreted functions are
+/// recorded too, to tell which call each event happened in. Each event is
+/// recorded with the function and the bytecode offset where it happened, so
+/// that the trace can be written as JSON and matched against the source.
+/// The runtime only calls into the tracer while it is started, so a runtime
+/// that is not traced pays a single branch at each of these events.
+class ExecutionTracer {
+ public:
+  /// The kind of an event.
+  enum class Kind : uint8_t {
+    /// A property cache changed state. The detail is the new state.
+    PropertyCache,
+    /// An instruction was rewritten to its quickened variant, which is the
+    /// detail.
+    Quicken,
+    /// A quickened instruction reverted to its generic opcode, which is the
+    /// detail.
+    Deoptimize,
+    /// A hidden class was converted to dictionary mode.
+    DictionaryMode,
+    /// The JIT failed to compile a function. The message says why.
+    JITBailout,
+    /// The interpreter entered a function, at offset 0.
+    FunctionEnter,
+    /// The interpreter left a function, by returning or by unwinding an
+    /// exception, at the last instruction it interpreted in it.
+    FunctionExit,
+  };
+
+  /// The maximum number of events that are kept. Later events are only
+  /// counted, so that a long trace doesn't grow without bounds.
+  static constexpr size_t kMaxEvents = 1 << 20;
+
+  explicit ExecutionTracer(Runtime *runtime) : runtime_(runtime) {}
+
+  /// Record that the property cache of the instruction at \p ip of
+  /// \p codeBlock moved to \p state.
+  void recordPropertyCache(
+      CodeBlock *codeBlock,
+      const inst::Inst *ip,
+      PropertyCacheState state) {
+    record(
+        Kind::PropertyCache, codeBlock, ip, static_cast<uint8_t>(state));
+  }
+
+  /// Record that the instruction at \p ip of \p codeBlock was rewritten to
+  /// \p opCode.
+  void recordQuicken(
+      CodeBlock *codeBlock,
+      const inst::Inst *ip,
+      inst::OpCode opCode) {
+    record(Kind::Quicken, codeBlock, ip, static_cast<uint8_t>(opCode));
+  }
+
+  /// Record that the quickened instruction at \p ip of \p codeBlock reverted
+  /// to \p opCode.
+  void recordDeoptimize(
+      CodeBlock *codeBlock,
+      const inst::Inst *ip,
+      inst::OpCode opCode) {
+    record(Kind::Deoptimize, codeBlock, ip, static_cast<uint8_t>(opCode));
+  }
+
+  /// Record that the interpreter entered \p codeBlock.
+  void recordFunctionEnter(CodeBlock *codeBlock) {
+    recordAt(Kind::FunctionEnter, codeBlock, 0, 0, 0);
+  }
+
+  /// Record that the interpreter left \p codeBlock, whose last interpreted
+  /// instruction is at \p ip.
+  void recordFunctionExit(CodeBlock *codeBlock, const inst::Inst *ip) {
+    record(Kind::FunctionExit, codeBlock, ip, 0);
+  }
+
+  /// Record that a hidden class was converted to dictionary mode, at the
+  /// innermost JS frame of the runtime.
+  void recordDictionaryMode();
+
+  /// Record that the JIT gave up compiling \p codeBlock at the bytecode
+  /// \p offset, because of \p message.
+  void recordJITBailout(
+      CodeBlock *codeBlock,
+      uint32_t offset,
+      const std::string &message);
+
+  /// Mark the domains of the traced functions, which are kept alive so that
+  /// the trace can be symbolicated.
+  void markRoots(SlotAcceptorWithNames &acceptor);
+
+  /// Write the trace to \p OS as a JSON object with an "events" array, in the
+  /// order in which they happened.
+  void serialize(llvm::raw_ostream &OS) const;
+
+ private:
+  /// A recorded event. Events outside of any JS function have no module.
+  struct Event {
+    Kind kind;
+    /// The new property cache state, or the opcode.
+    uint8_t detail;
+    uint32_t functionId;
+    uint32_t offset;
+    RuntimeModule *module;
+    /// For JIT bailouts, the index of the message in messages_.
+    uint32_t message;
+  };
+
+  /// Record an event of \p kind at \p ip in \p codeBlock.
+  void record(
+      Kind kind,
+      CodeBlock *codeBlock,
+      const inst::Inst *ip,
+      uint8_t detail);
+
+  /// Record an event of \p kind at the bytecode \p offset of \p codeBlock,
+  /// which may be null.
+  void recordAt(
+      Kind kind,
+      CodeBlock *codeBlock,
+      uint32_t offset,
+      uint8_t detail,
+      uint32_t message);
+
+  Runtime *const runtime_;
+
+  std::vector<Event> events_{};
+  /// The number of events that were not kept because there were too many.
+  uint64_t numDropped_{0};
+
+  /// The domains of the modules of the traced functions.
+  std::vector<Domain *> domains_{};
+  /// The messages of the JIT bailouts.
+  std::vector<std::string> messages_{};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_PROFILER_EXECUTIONTRACER_H
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_VM_PROFILER_PPROFSERIALIZERPOSIX_H
+#define HERMES_VM_PROFILER_PPROFSERIALIZERPOSIX_H
+
+/// This file converts sampled stack frames into the protobuf format of pprof,
+/// which is documented here:
+/// https://github.com/google/pprof/blob/master/proto/profile.proto
+/// The output is not compressed; pprof accepts both.
+
+#include "hermes/VM/Profiler/SamplingProfiler.h"
+
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+/// Serialize samples to pprof. Each sample has one location per frame, leaf
+/// first, and is labeled with its thread and with the state of the VM: "js"
+/// when interpreting JavaScript, "vm" in runtime code called by the
+/// interpreter (slow paths), "native" in a host or builtin function, "gc" when
+/// collecting garbage. The native frames of a sample are only kept up to the
+/// interpreter, whose callers are shown by the JS frames instead. Native code
+/// frames are symbolized with dladdr() and JS frames with the debug info of
+/// their bytecode, if any.
+class PprofSerializer {
+ public:
+  PprofSerializer(
+      const SamplingProfiler::ThreadNamesMap &threadNames,
+      const std::vector<SamplingProfiler::StackTrace> &sampledStacks,
+      std::chrono::microseconds samplingInterval)
+      : threadNames_(threadNames),
+        sampledStacks_(sampledStacks),
+        samplingInterval_(samplingInterval) {}
+
+  /// Serialize the profile to \p OS.
+  void serialize(llvm::raw_ostream &OS) const;
+
+ private:
+  const SamplingProfiler::ThreadNamesMap &threadNames_;
+  const std::vector<SamplingProfiler::StackTrace> &sampledStacks_;
+  const std::chrono::microseconds samplingInterval_;
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_PROFILER_PPROFSERIALIZERPOSIX_H
@@ -7,11 +7,12 @@
 #ifndef HERMES_VM_PROFILER_SAMPLINGPROFILERPOSIX_H
 #define HERMES_VM_PROFILER_SAMPLINGPROFILERPOSIX_H
 
-#include "hermes/Support/Semaphore.h"
 #include "hermes/Support/ThreadLocal.h"
 #include "hermes/VM/Runtime.h"
+#include "hermes/VM/instrumentation/PerfEvents.h"
 
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
 
 #ifndef __APPLE__
 // Prevent "The deprecated ucontext routines require _XOPEN_SOURCE to be
@@ -19,7 +20,10 @@
 #include <ucontext.h>
 #endif
 
+#include <signal.h>
+#include <atomic>
 #include <chrono>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -52,7 +56,8 @@ class SamplingProfiler {
     // IP offset within the function.
     uint32_t offset;
   };
-  /// Captured NativeFunction frame information for symbolication.
+  /// Captured NativeFunction frame information for symbolication: the
+  /// address of the function, or the pc of a NativeCode frame.
   using NativeFunctionFrameInfo = uintptr_t;
 
   // This will break with more than one RuntimeModule(like FB4a, eval() call or
@@ -63,6 +68,12 @@ class SamplingProfiler {
     enum class FrameKind {
       JSFunction,
       NativeFunction,
+      /// The runtime was collecting garbage. No frames of the runtime stack
+      /// follow, since walking it would touch the heap being collected.
+      GC,
+      /// A return address on the native stack of the thread, in nativeFrame.
+      /// These come first in a sample, before the frames of the runtime.
+      NativeCode,
     };
 
     // TODO: figure out how to store BoundFunction.
@@ -76,6 +87,9 @@ class SamplingProfiler {
     FrameKind kind;
   };
 
+  static constexpr unsigned kNumCounters =
+      instrumentation::ThreadPerfCounters::NumCounters;
+
   /// Represent stack trace captured by one sampling.
   struct StackTrace {
     /// Id of the thread that this stack trace is taken from.
@@ -84,19 +98,86 @@ class SamplingProfiler {
     TimeStampType timeStamp;
     /// Captured stack frames.
     std::vector<StackFrame> stack;
+    /// The hardware counts of the thread since its previous sample, indexed
+    /// by ThreadPerfCounters::Counter, or 0 if they are not counted.
+    uint64_t counters[kNumCounters]{};
 
     StackTrace(uint32_t preallocatedSize) : stack(preallocatedSize) {}
-    StackTrace(
-        ThreadId tid,
-        TimeStampType ts,
-        const std::vector<StackFrame>::iterator stackStart,
-        const std::vector<StackFrame>::iterator stackEnd)
-        : tid(tid), timeStamp(ts), stack(stackStart, stackEnd) {}
+    StackTrace(ThreadId tid, TimeStampType ts) : tid(tid), timeStamp(ts) {}
   };
 
+  /// The interval between samples unless setSamplingInterval() is called.
+  static constexpr std::chrono::microseconds kDefaultSamplingInterval{1000};
+
  private:
-  /// Max size of sampleStorage_.
+  /// Max number of frames in a sample.
   static const int kMaxStackDepth = 500;
+  /// Max number of NativeCode frames in a sample.
+  static const int kMaxNativeStackDepth = 64;
+
+  static_assert(
+      ATOMIC_INT_LOCK_FREE == 2,
+      "SampleRing is written from a signal handler and must be lock-free");
+
+  /// Samples taken by the signal handler on the thread of one runtime, until
+  /// the timer thread moves them to sampledStacks_. The signal handler is the
+  /// only one to advance the heads and the timer thread the tails, so neither
+  /// has to lock or allocate. When the ring is full, samples are dropped.
+  struct SampleRing {
+    /// Max number of samples in the ring. A power of 2.
+    static constexpr uint32_t kSampleCapacity = 64;
+    /// Max number of frames of all the samples in the ring. A power of 2.
+    static constexpr uint32_t kFrameCapacity = 1 << 13;
+
+    struct SampleHeader {
+      ThreadId tid;
+      TimeStampType timeStamp;
+      /// Position in frames of the leaf frame, before masking.
+      uint32_t frameStart;
+      uint32_t depth;
+      uint64_t counters[kNumCounters];
+    };
+
+    /// The stack being walked by the signal handler.
+    StackFrame scratch[kMaxStackDepth];
+    SampleHeader samples[kSampleCapacity];
+    StackFrame frames[kFrameCapacity];
+
+    /// Free-running counts of the samples and frames added and removed.
+    std::atomic<uint32_t> sampleHead{0};
+    std::atomic<uint32_t> sampleTail{0};
+    std::atomic<uint32_t> frameHead{0};
+    std::atomic<uint32_t> frameTail{0};
+    /// Number of samples dropped because the ring was full.
+    std::atomic<uint32_t> dropped{0};
+    /// The end of the native stack of the thread running the runtime, which
+    /// bounds the walk of its frame pointers. 0 if unknown.
+    uintptr_t nativeStackHigh{0};
+
+    /// The thread running the runtime.
+    ThreadId tid{0};
+    /// The hardware counters of tid, if they are enabled.
+    instrumentation::ThreadPerfCounters perfCounters;
+    /// Set once perfCounters are open, and cleared before they are closed,
+    /// for the signal handler.
+    std::atomic<bool> perfCountersOpen{false};
+    /// The counts read by the previous sample.
+    uint64_t lastCounts[kNumCounters]{};
+
+    /// Open the hardware counters of the thread tid. Not called from the
+    /// signal handler.
+    void openPerfCounters();
+    /// Close the hardware counters, if they are open.
+    void closePerfCounters();
+
+    /// Add the first \p depth frames of scratch as a sample, with the
+    /// hardware counts since the previous sample. Called from the signal
+    /// handler.
+    void push(uint32_t depth, ThreadId tid, TimeStampType timeStamp);
+
+    /// Move the samples in the ring to the end of \p out.
+    void drain(std::vector<StackTrace> &out);
+  };
 
   /// Pointing to the singleton SamplingProfiler instance.
   /// We need this field because accessing local static variable from
@@ -110,30 +191,56 @@ class SamplingProfiler {
   /// Protected by profilerLock_.
   llvm::DenseMap<Runtime *, pthread_t> activeRuntimeThreads_;
 
+  /// Registered runtimes which are not running on any thread, see
+  /// suspendRuntime(). Protected by profilerLock_.
+  llvm::DenseSet<Runtime *> suspendedRuntimes_;
+
+  /// The sample ring of each registered runtime, active or suspended.
+  /// Protected by profilerLock_.
+  llvm::DenseMap<Runtime *, std::unique_ptr<SampleRing>> sampleRings_;
+
   /// Per-thread runtime instance for loom/local profiling.
   /// Limitations: No recursive runtimes in one thread.
   ThreadLocal<Runtime> threadLocalRuntime_;
 
+  /// The sample ring of threadLocalRuntime_.
+  ThreadLocal<SampleRing> threadLocalRing_;
+
   /// Whether profiler is enabled or not. Protected by profilerLock_.
   bool enabled_{false};
   /// Whether signal handler is registered or not. Protected by profilerLock_.
   bool isSigHandlerRegistered_{false};
-
-  /// Semaphore to indicate all signal handlers have finished the sampling.
-  Semaphore samplingDoneSem_;
+  /// Time between two samples. Protected by profilerLock_.
+  std::chrono::microseconds samplingInterval_{kDefaultSamplingInterval};
 
   /// Sampled stack traces overtime. Protected by profilerLock_.
   std::vector<StackTrace> sampledStacks_;
 
-  /// Threading: load/store of sampledStackDepth_ and sampleStorage_
-  /// are protected by samplingDoneSem_.
-  /// Actual sampled stack depth in sampleStorage_.
-  uint32_t sampledStackDepth_{0};
-  /// Preallocated stack frames storage for signal handler(because
-  /// allocating memory in signal handler is not allowed)
-  /// This storage does not need to be protected by lock because accessing to
-  /// it is serialized by samplingDoneSem_.
+  /// Whether the hardware counters of the runtime threads are sampled.
+  /// Protected by profilerLock_.
+  bool hardwareCountersEnabled_{false};
+
+  /// The hardware counts attributed to a leaf frame.
+  struct LeafCounters {
+    /// The leaf frame, with a 0 offset if it is a JSFunction.
+    StackFrame leaf;
+    uint64_t samples{0};
+    uint64_t counters[kNumCounters]{};
+  };
+  /// The hardware counts of the samples so far, by the function of their leaf
+  /// frame: the RuntimeModule and function id of a JS function, or null and
+  /// the address of a native one. Protected by profilerLock_.
+  llvm::DenseMap<std::pair<const void *, uintptr_t>, LeafCounters>
+      leafCounters_;
+  /// Number of samples dropped because a SampleRing was full. Protected by
+  /// profilerLock_.
+  uint64_t droppedSamples_{0};
+
+#if defined(__ANDROID__) && defined(HERMES_FACEBOOK_BUILD)
+  /// Preallocated stack frames storage for the loom callback (because
+  /// allocating memory in signal handler is not allowed).
   StackTrace sampleStorage_{kMaxStackDepth};
+#endif
 
   /// Prellocated map that contains thread names mapping.
   ThreadNamesMap threadNames_;
@@ -155,6 +262,7 @@ class SamplingProfiler {
   /// invoke sigaction() posix API to register \p handler.
   /// \return what sigaction() returns: 0 to indicate success.
   int invokeSignalAction(void (*handler)(int));
+  int invokeSignalAction(void (*handler)(int, siginfo_t *, void *));
 
   /// Register sampling signal handler if not done yet.
   /// \return true to indicate success.
@@ -166,22 +274,38 @@ class SamplingProfiler {
   /// Hold \p domain so that the RuntimeModule(s) used by profiler are not
   /// released during symbolication.
   /// Refer to Domain.h for relationship between Domain and RuntimeModule.
-  void registerDomain(Domain *domain);
+  /// \return false if another thread is registering a domain. Called from the
+  /// signal handler, so it can't wait for it.
+  bool registerDomain(Domain *domain);
+
+  /// Set while a signal handler registers a domain, since the runtimes of
+  /// different threads are sampled at the same time.
+  std::atomic_flag registeringDomain_ = ATOMIC_FLAG_INIT;
 
-  /// Signal handler to walk the stack frames.
-  static void profilingSignalHandler(int signo);
+  /// Signal handler to walk the stack frames. \p ucontext holds the
+  /// registers of the interrupted code, from which the native stack is walked.
+  static void profilingSignalHandler(int signo, siginfo_t *, void *ucontext);
 
-  /// Main routine to take a sample of runtime stack.
+  /// Main routine to take a sample of the stacks of all active runtimes, and
+  /// collect the samples taken since the previous call.
+  /// \param[out] interval the time to wait until the next call.
   /// \return false for failure which timer loop thread should stop.
-  bool sampleStack();
+  bool sampleStacks(std::chrono::microseconds &interval);
 
   /// Timer loop thread main routine.
   void timerLoop();
 
-  /// Walk runtime stack frames and store in \p sampleStorage.
+  /// Walk runtime stack frames and store up to \p capacity of them in
+  /// \p frames, leaf first. Only the bytecode offsets are captured, they are
+  /// resolved to source locations when the samples are dumped.
   /// This function is called from signal handler so should obey all
   /// rules of signal handler(no lock, no memory allocation etc...)
-  uint32_t walkRuntimeStack(const Runtime *runtime, StackTrace &sampleStorage);
+  /// \return the number of frames stored, or 0 if the sample had to be
+  ///   dropped.
+  uint32_t walkRuntimeStack(
+      const Runtime *runtime,
+      StackFrame *frames,
+      uint32_t capacity);
 
 #if defined(__ANDROID__) && defined(HERMES_FACEBOOK_BUILD)
   /// Registered loom callback for collecting stack frames.
@@ -192,6 +316,11 @@ class SamplingProfiler {
       uint8_t max_depth);
 #endif
 
+  /// Move the samples of all the rings to sampledStacks_, and add their
+  /// hardware counts to leafCounters_.
+  /// Note: caller should take the lock before calling.
+  void collectSamples();
+
   /// Clear previous stored samples.
   /// Note: caller should take the lock before calling.
   void clear();
@@ -207,6 +336,12 @@ class SamplingProfiler {
   /// Unregister an active \p runtime and current thread with profiler.
   void unregisterRuntime(Runtime *runtime);
 
+  /// Stop sampling the registered \p runtime, which is no longer going to
+  /// run on the current thread, so that the thread can run other runtimes.
+  /// Sampling resumes when \p runtime is registered again, from the thread
+  /// which runs it next.
+  void suspendRuntime(Runtime *runtime);
+
   /// Reserve domain slots to avoid memory allocation in signal handler.
   void increaseDomainCount();
   /// Shrink domain storage to fit domains alive.
@@ -223,14 +358,45 @@ class SamplingProfiler {
   /// NOTE: this is for manual testing purpose.
   void dumpSampledStack(llvm::raw_ostream &OS);
 
-  /// Dump sampled stack to \p OS in chrome trace format.
+  /// Dump sampled stack to \p OS in chrome trace format. Only the frames of
+  /// the runtime are included.
   void dumpChromeTrace(llvm::raw_ostream &OS);
 
+  /// Dump sampled stack to \p OS in pprof format, including the native frames
+  /// above the interpreter, and clear the samples.
+  void dumpPprof(llvm::raw_ostream &OS);
+
+  /// Also sample the cycles, instructions and cache misses of the runtime
+  /// threads, and attribute the counts since the previous sample of a thread
+  /// to the leaf function of the sample. This tells the functions bound by
+  /// memory accesses, with a low count of instructions per cycle and many
+  /// cache misses, from those bound by the dispatch of the instructions.
+  /// \return false if the counters can't be opened, e.g. on other platforms
+  ///   than Linux, or if perf_event_paranoid forbids it.
+  bool enableHardwareCounters();
+
+  /// Stop sampling the hardware counters. The counts so far are kept.
+  void disableHardwareCounters();
+
+  /// Dump the hardware counts of each function to \p OS as a JSON array,
+  /// costliest in cycles first. The counts are cleared along with the samples
+  /// by the other dumps.
+  void dumpHardwareCounters(llvm::raw_ostream &OS);
+
+  /// Take a sample every \p interval from now on. Intervals of a
+  /// millisecond or less are supported, since the signal handler only copies
+  /// the stack into a preallocated buffer.
+  void setSamplingInterval(std::chrono::microseconds interval);
+
   /// Enable and start profiling.
   bool enable();
 
   /// Disable and stop profiling.
   bool disable();
+
+  /// \return whether profiling is enabled or samples were taken that have
+  /// not been dumped yet. The samples refer to functions by bytecode offset.
+  bool holdsSamples();
 };
 
 bool operator==(
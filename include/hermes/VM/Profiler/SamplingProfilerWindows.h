@@ -9,6 +9,8 @@
 
 #include "hermes/VM/Runtime.h"
 
+#include <chrono>
+
 namespace hermes {
 namespace vm {
 
@@ -28,6 +30,9 @@ class SamplingProfiler {
   /// Unregister an active \p runtime and current thread with profiler.
   void unregisterRuntime(Runtime *runtime) {}
 
+  /// Stop sampling \p runtime until it is registered again.
+  void suspendRuntime(Runtime *runtime) {}
+
   /// Reserve domain slots to avoid memory allocation in signal handler.
   void increaseDomainCount() {}
 
@@ -44,6 +49,19 @@ class SamplingProfiler {
   /// Dump sampled stack to \p OS in chrome trace format.
   void dumpChromeTrace(llvm::raw_ostream &OS) {}
 
+  /// Dump sampled stack to \p OS in pprof format.
+  void dumpPprof(llvm::raw_ostream &OS) {}
+
+  /// Hardware counters are not supported on Windows.
+  bool enableHardwareCounters() {
+    return false;
+  }
+  void disableHardwareCounters() {}
+  void dumpHardwareCounters(llvm::raw_ostream &OS) {}
+
+  /// Take a sample every \p interval from now on.
+  void setSamplingInterval(std::chrono::microseconds interval) {}
+
   /// Enable and start profiling.
   bool enable() {
     return false;
@@ -53,6 +71,11 @@ class SamplingProfiler {
   bool disable() {
     return true;
   }
+
+  /// No samples are taken on Windows.
+  bool holdsSamples() {
+    return false;
+  }
 };
 
 } // namespace vm
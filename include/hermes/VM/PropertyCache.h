@@ -15,18 +15,235 @@ using SlotIndex = uint32_t;
 
 class HiddenClass;
 
+/// The state of a property cache site.
+enum class PropertyCacheState : uint8_t {
+  /// Nothing has been cached yet.
+  Uninitialized,
+  /// Only the primary class/slot pair is valid.
+  Monomorphic,
+  /// The primary pair and at least one secondary pair are valid.
+  Polymorphic,
+  /// More classes than the cache can hold were observed. The existing pairs
+  /// remain valid and are still checked, but they are never rewritten.
+  Megamorphic,
+};
+
+/// A cache for a property that was found on the prototype chain of the
+/// receiver rather than on the receiver itself, or for an accessor property.
+/// The entry is valid for a receiver whose class is \c receiverClazz and whose
+/// first \c depth prototypes have the classes in \c chainClazz. Since neither
+/// the receiver nor any of these objects may be in dictionary mode, matching
+/// classes guarantee that the receiver and the intermediate prototypes do not
+/// own the property, and that the last prototype (the holder) has it in
+/// \c slot. Only classes are recorded, so the guard holds no references to
+/// objects, which may move.
+/// If \c accessor is set, the slot holds a PropertyAccessor, and the holder
+/// may be the receiver itself, with a \c depth of zero. The getter and setter
+/// are read from the slot on every hit, since redefining them with the same
+/// attributes doesn't change the class of the holder.
+struct PrototypeCacheEntry {
+  /// Maximum length of the prototype chain that can be cached.
+  static constexpr unsigned kMaxDepth = 3;
+
+  /// Class of the receiver.
+  HiddenClass *receiverClazz{nullptr};
+
+  /// Classes of the prototypes of the receiver, from its parent up to and
+  /// including the holder.
+  HiddenClass *chainClazz[kMaxDepth]{};
+
+  /// Property index in the holder.
+  SlotIndex slot{0};
+
+  /// Number of valid entries in \c chainClazz.
+  uint8_t depth{0};
+
+  /// Whether the property is an accessor.
+  bool accessor{false};
+
+  /// \return true if nothing is cached.
+  bool empty() const {
+    return !receiverClazz;
+  }
+};
+
+/// The records of a PropertyCacheEntry beyond a single class: the classes of
+/// a polymorphic site, a dictionary mode class and a prototype chain. Most
+/// sites only ever see one class, so these live out of line and are only
+/// allocated the first time the entry needs one of them.
+struct PropertyCacheExtension {
+  /// Maximum number of distinct classes tracked by a single entry.
+  static constexpr unsigned kMaxPolymorphism = 4;
+
+  /// Cached classes.
+  HiddenClass *clazz[kMaxPolymorphism]{};
+
+  /// Property indices corresponding to \c clazz.
+  SlotIndex slot[kMaxPolymorphism]{};
+
+  /// Number of valid entries in \c clazz and \c slot.
+  uint8_t numClasses{0};
+
+  /// A dictionary mode class (typically that of the global object) along with
+  /// the slot of the property in it. Dictionary classes are mutated in place,
+  /// so the entry is only valid while the class reports \c dictVersion.
+  HiddenClass *dictClazz{nullptr};
+
+  /// Property index in \c dictClazz.
+  SlotIndex dictSlot{0};
+
+  /// Dictionary version of \c dictClazz at the time the entry was recorded.
+  uint32_t dictVersion{0};
+
+  /// Cache for lookups that find the property on the prototype chain, or an
+  /// accessor property. Read caches hold both kinds, while write caches only
+  /// hold accessors with a setter.
+  PrototypeCacheEntry proto{};
+
+  /// Look for \p cls among the cached classes.
+  /// \return true and set \p slotOut to the cached slot if found.
+  bool find(const HiddenClass *cls, SlotIndex &slotOut) const {
+    for (unsigned i = 0; i < numClasses; ++i) {
+      if (clazz[i] == cls) {
+        slotOut = slot[i];
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
 /// A cache entry for a property lookup.
 /// If the class operation that we are performing
 /// matches the values in the cache entry, \c slot is the index of a
 /// non-accessor property.
+/// A monomorphic entry is just a class and a slot, which is all the fast path
+/// looks at. Once a second class, a dictionary class or a prototype chain has
+/// to be recorded, the entry is extended: everything, including the first
+/// class, moves to a PropertyCacheExtension which the entry owns, and \c clazz
+/// holds the pointer to it instead. That pointer never equals the class of an
+/// object, so the monomorphic check simply fails for extended entries.
+/// Entries are trivially copyable so that they can live in the trailing
+/// storage of a CodeBlock; whoever owns them must call \c clear() before
+/// discarding them.
 struct PropertyCacheEntry {
-  /// Cached class.
-  HiddenClass *clazz{nullptr};
+  /// Maximum number of distinct classes tracked by a single entry.
+  static constexpr unsigned kMaxPolymorphism =
+      PropertyCacheExtension::kMaxPolymorphism;
+
+  union {
+    /// Cached class, if the entry is not extended.
+    HiddenClass *clazz{nullptr};
 
-  /// Cached property index.
+    /// The out of line records, if the entry is extended.
+    PropertyCacheExtension *ext_;
+  };
+
+  /// Cached property index, if the entry is not extended.
   SlotIndex slot{0};
+
+  /// The state of this entry.
+  PropertyCacheState state{PropertyCacheState::Uninitialized};
+
+  /// Whether \c ext_ rather than \c clazz is valid.
+  bool extended_{false};
+
+  /// \return the out of line records, or nullptr if there are none.
+  PropertyCacheExtension *getExtension() const {
+    return extended_ ? ext_ : nullptr;
+  }
+
+  /// \return the out of line records, allocating them and moving the cached
+  /// class into them if needed.
+  PropertyCacheExtension &getOrCreateExtension() {
+    if (extended_)
+      return *ext_;
+    auto *ext = new PropertyCacheExtension();
+    if (clazz) {
+      ext->clazz[0] = clazz;
+      ext->slot[0] = slot;
+      ext->numClasses = 1;
+    }
+    ext_ = ext;
+    slot = 0;
+    extended_ = true;
+    return *ext;
+  }
+
+  /// Free the out of line records, if any, and reset the entry.
+  void clear() {
+    if (extended_)
+      delete ext_;
+    *this = PropertyCacheEntry{};
+  }
+
+  /// Look for \p cls among the cached classes.
+  /// \return true and set \p slotOut to the cached slot if found.
+  bool find(const HiddenClass *cls, SlotIndex &slotOut) const {
+    if (!extended_) {
+      if (clazz && clazz == cls) {
+        slotOut = slot;
+        return true;
+      }
+      return false;
+    }
+    return ext_->find(cls, slotOut);
+  }
+
+  /// Record that objects of class \p cls hold the property at \p newSlot.
+  /// Once the entry is megamorphic it is no longer modified.
+  /// \return true if the state of the entry changed.
+  bool update(HiddenClass *cls, SlotIndex newSlot) {
+    if (state == PropertyCacheState::Megamorphic)
+      return false;
+    if (!extended_) {
+      // The class may have been cleared by the GC, in which case it can
+      // simply be overwritten.
+      if (!clazz || clazz == cls) {
+        clazz = cls;
+        slot = newSlot;
+        bool changed = state != PropertyCacheState::Monomorphic;
+        state = PropertyCacheState::Monomorphic;
+        return changed;
+      }
+      getOrCreateExtension();
+    }
+    PropertyCacheExtension &ext = *ext_;
+    // Update the slot if the class is already cached, or else reuse a pair
+    // whose class was collected.
+    unsigned freeIndex = ext.numClasses;
+    for (unsigned i = 0; i < ext.numClasses; ++i) {
+      if (ext.clazz[i] == cls) {
+        ext.slot[i] = newSlot;
+        return false;
+      }
+      if (!ext.clazz[i] && freeIndex == ext.numClasses)
+        freeIndex = i;
+    }
+    if (freeIndex != ext.numClasses) {
+      ext.clazz[freeIndex] = cls;
+      ext.slot[freeIndex] = newSlot;
+      return false;
+    }
+    if (ext.numClasses == kMaxPolymorphism) {
+      state = PropertyCacheState::Megamorphic;
+      return true;
+    }
+    ext.clazz[ext.numClasses] = cls;
+    ext.slot[ext.numClasses] = newSlot;
+    ++ext.numClasses;
+    auto newState = ext.numClasses == 1 ? PropertyCacheState::Monomorphic
+                                        : PropertyCacheState::Polymorphic;
+    bool changed = state != newState;
+    state = newState;
+    return changed;
+  }
 };
 
+static_assert(
+    sizeof(PropertyCacheEntry) == sizeof(void *) + 2 * sizeof(uint32_t),
+    "a monomorphic PropertyCacheEntry must stay a class and a slot");
+
 } // namespace vm
 } // namespace hermes
 #endif // PROJECT_PROPERTYCACHE_H
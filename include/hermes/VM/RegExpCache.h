@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_VM_REGEXPCACHE_H
+#define HERMES_VM_REGEXPCACHE_H
+
+#include "hermes/Support/OptValue.h"
+
+#include "llvm/ADT/ArrayRef.h"
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+/// A cache of the bytecode of regexps compiled at runtime, e.g. by
+/// `new RegExp(str)`, keyed by their pattern and syntax flags. Creating a
+/// regexp from the same pattern again then copies the bytecode instead of
+/// parsing and compiling the pattern. When the cache is full, the least
+/// recently used entry is evicted.
+class RegExpCache {
+ public:
+  /// Number of entries kept by default.
+  static constexpr size_t kDefaultCapacity = 64;
+
+  explicit RegExpCache(size_t capacity = kDefaultCapacity)
+      : capacity_(capacity) {}
+
+  RegExpCache(const RegExpCache &) = delete;
+  RegExpCache &operator=(const RegExpCache &) = delete;
+
+  /// Look up the bytecode compiled from \p pattern with the syntax flags
+  /// \p flags, and make it the most recently used entry.
+  /// \return the bytecode, which is valid until the next call to insert(), or
+  /// None if it is not cached.
+  OptValue<llvm::ArrayRef<uint8_t>> lookup(
+      llvm::ArrayRef<char16_t> pattern,
+      uint8_t flags);
+
+  /// Add the \p bytecode compiled from \p pattern with the syntax flags
+  /// \p flags, evicting the least recently used entry if the cache is full.
+  /// \pre the pattern is not cached.
+  void insert(
+      llvm::ArrayRef<char16_t> pattern,
+      uint8_t flags,
+      std::vector<uint8_t> bytecode);
+
+  /// Remove every entry.
+  /// \return the number of bytes freed.
+  size_t clear();
+
+  /// \return the number of entries.
+  size_t size() const {
+    return entries_.size();
+  }
+
+  /// \return the number of lookups that found their bytecode.
+  uint64_t getHits() const {
+    return hits_;
+  }
+
+  /// \return the number of lookups that did not find their bytecode.
+  uint64_t getMisses() const {
+    return misses_;
+  }
+
+ private:
+  /// \return the key for \p pattern with \p flags: the flags, followed by the
+  /// pattern.
+  static std::u16string makeKey(
+      llvm::ArrayRef<char16_t> pattern,
+      uint8_t flags);
+
+  struct Entry {
+    std::u16string key;
+    std::vector<uint8_t> bytecode;
+  };
+
+  /// Maximum number of entries.
+  const size_t capacity_;
+
+  /// The entries, from the most to the least recently used.
+  std::list<Entry> entries_;
+
+  /// Maps each key to its entry.
+  std::unordered_map<std::u16string, std::list<Entry>::iterator> index_;
+
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_REGEXPCACHE_H
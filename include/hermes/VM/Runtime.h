@@ -7,6 +7,7 @@
 #ifndef HERMES_VM_RUNTIME_H
 #define HERMES_VM_RUNTIME_H
 
+#include "hermes/Public/MemoryPressure.h"
 #include "hermes/Public/RuntimeConfig.h"
 #include "hermes/Support/Compiler.h"
 #include "hermes/Support/ErrorHandling.h"
@@ -16,6 +17,7 @@
 #include "hermes/VM/CallResult.h"
 #include "hermes/VM/Casting.h"
 #include "hermes/VM/Debugger/Debugger.h"
+#include "hermes/VM/EvalCache.h"
 #include "hermes/VM/GC.h"
 #include "hermes/VM/Handle-inline.h"
 #include "hermes/VM/HandleRootOwner-inline.h"
@@ -29,6 +31,7 @@
 #include "hermes/VM/Profiler.h"
 #include "hermes/VM/PropertyCache.h"
 #include "hermes/VM/PropertyDescriptor.h"
+#include "hermes/VM/RegExpCache.h"
 #include "hermes/VM/RegExpMatch.h"
 #include "hermes/VM/RuntimeModule.h"
 #include "hermes/VM/StackFrame.h"
@@ -39,6 +42,7 @@
 
 #include <atomic>
 #include <chrono>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <type_traits>
@@ -60,15 +64,19 @@ namespace vm {
 // External forward declarations.
 class CodeBlock;
 class ArrayStorage;
+class Callable;
 class Environment;
 class Interpreter;
 class JSObject;
+class NativeConstructor;
 class PropertyAccessor;
 struct RuntimeCommonStorage;
 struct RuntimeOffsets;
 class ScopedNativeDepthTracker;
 class ScopedNativeCallFrame;
 class SamplingProfiler;
+class AllocationProfiler;
+class ExecutionTracer;
 
 /// Number of stack words after the top of frame that we always ensure are
 /// available. This is necessary so we can perform native calls with small
@@ -287,6 +295,26 @@ class Runtime : public HandleRootOwner,
   /// 256 characters are pre-allocated. The rest are allocated every time.
   Handle<StringPrimitive> getCharacterString(char16_t ch);
 
+  /// The number of integers, starting from 0, whose string representation is
+  /// cached after its first conversion.
+  static constexpr uint32_t kNumCachedIntStrings = 1024;
+
+  /// \return the cached string representation of \p n, which must be less
+  /// than kNumCachedIntStrings, or nullptr if it hasn't been cached yet.
+  StringPrimitive *getCachedIntString(uint32_t n) {
+    assert(n < kNumCachedIntStrings && "integer is not cacheable");
+    const PinnedHermesValue &hv = intStrings_[n];
+    return hv.isUndefined() ? nullptr : vmcast<StringPrimitive>(hv);
+  }
+
+  /// Cache \p str as the string representation of \p n, which must be less
+  /// than kNumCachedIntStrings. \p str must be long-lived, since the cache is
+  /// only marked in full collections.
+  void setCachedIntString(uint32_t n, StringPrimitive *str) {
+    assert(n < kNumCachedIntStrings && "integer is not cacheable");
+    intStrings_[n] = HermesValue::encodeStringValue(str);
+  }
+
   CodeBlock *getEmptyCodeBlock() const {
     assert(emptyCodeBlock_ && "Invalid empty code block");
     return emptyCodeBlock_;
@@ -429,6 +457,40 @@ class Runtime : public HandleRootOwner,
   /// Return the global object.
   Handle<JSObject> getGlobal();
 
+  /// Add \p job to the end of the job queue, to be called with no arguments
+  /// and an undefined this by drainJobs().
+  void enqueueJob(Handle<Callable> job);
+
+  /// Call the jobs of the job queue in order, including the jobs that they
+  /// enqueue, until the queue is empty or \p deadline has passed, which is
+  /// checked after each job.
+  /// \return whether the queue is empty, or an exception if a job threw, in
+  ///   which case the remaining jobs stay queued.
+  CallResult<bool> drainJobs(
+      std::chrono::steady_clock::time_point deadline =
+          std::chrono::steady_clock::time_point::max());
+
+  /// \return whether there are jobs waiting in the job queue.
+  bool hasPendingJobs() const {
+    return !jobQueue_.empty();
+  }
+
+  /// Drop the jobs waiting in the job queue without calling them.
+  void clearJobs() {
+    jobQueue_.clear();
+  }
+
+  /// Save a copy of the own named properties of the global object, so that
+  /// resetGlobalObject() can go back to them.
+  void saveGlobalObjectTemplate();
+
+  /// Replace the global object with a new copy of the one saved by
+  /// saveGlobalObjectTemplate(), dropping everything defined on it since.
+  /// Changes made to other objects reachable from it, such as the builtin
+  /// prototypes, are not undone.
+  /// \pre saveGlobalObjectTemplate() has been called.
+  ExecutionStatus resetGlobalObject();
+
   /// Return the JIT context.
   JITContext &getJITContext() {
     return jitContext_;
@@ -441,6 +503,34 @@ class Runtime : public HandleRootOwner,
     return runtimeStats_;
   }
 
+  /// \return the cache of the bytecode of regexps compiled at runtime.
+  RegExpCache &getRegExpCache() {
+    return regExpCache_;
+  }
+
+  /// \return the cache of the bytecode compiled at runtime by eval().
+  EvalCache &getEvalCache() {
+    return evalCache_;
+  }
+
+  /// Free as much memory as \p level asks for, see MemoryPressureLevel.
+  /// \return the number of bytes freed by each step.
+  MemoryPressureReport handleMemoryPressure(MemoryPressureLevel level);
+
+  /// Drop the property maps that hidden classes keep for their children to
+  /// share, see HiddenClass::releaseSharedPropertyMap. The maps are freed by
+  /// the next full collection.
+  /// \return the number of bytes of the dropped maps.
+  size_t releasePropertyMaps();
+
+  /// Return the lazily compiled functions which were not called since the
+  /// previous call of this function to their uncompiled state, dropping their
+  /// bytecode and caches. They are compiled again by their next call. The
+  /// functions on the stack and \p running are kept, as are those that cannot
+  /// be compiled again the same way, see RuntimeModule::getEvictableCodeBlock.
+  /// \return an estimate of the number of bytes freed.
+  size_t evictColdFunctions(const CodeBlock *running = nullptr);
+
   /// Print the heap and other misc. stats to the given stream.
   void printHeapStats(llvm::raw_ostream &os);
 
@@ -632,12 +722,28 @@ class Runtime : public HandleRootOwner,
   /// Class to be used for JSArray instances. Pointer to \c HiddenClass.
   PinnedHermesValue arrayClass;
   HiddenClass *arrayClassRawPtr{};
+  /// Classes of JSFunction instances after their lazy properties have been
+  /// defined, indexed by (strictMode * 2 + hasPrototype). Filled in by the
+  /// first function of each kind. Pointers to \c HiddenClass or undefined.
+  PinnedHermesValue lazyFunctionClasses[4];
   /// IteratorPrototype
   PinnedHermesValue iteratorPrototype;
   /// ArrayIteratorPrototype
   PinnedHermesValue arrayIteratorPrototype;
+  /// ArrayIteratorPrototype_next, needs to be stored for iterating arrays by
+  /// index in for-of loops when it hasn't been replaced.
+  PinnedHermesValue arrayIteratorPrototypeNext;
   /// ArrayProto_values, needs to be stored for making new Arguments objects.
   PinnedHermesValue arrayPrototypeValues;
+  /// ArrayProto_toString, shared with %TypedArray%.prototype when that is
+  /// populated lazily.
+  PinnedHermesValue arrayPrototypeToString;
+  /// FunctionProto_apply, needs to be stored for forwarding the 'arguments'
+  /// of a frame without reifying them.
+  PinnedHermesValue functionPrototypeApply;
+  /// FunctionProto_call, needs to be stored for calling its target in the
+  /// frame of the call.
+  PinnedHermesValue functionPrototypeCall;
   /// StringIteratorPrototype
   PinnedHermesValue stringIteratorPrototype;
   /// GeneratorPrototype
@@ -660,6 +766,15 @@ class Runtime : public HandleRootOwner,
   const bool enableEval;
   /// Whether to verify the IR being generated by eval and the Function ctor.
   const bool verifyEvalIR;
+  /// Number of invocations after which a function is quickened, or zero if
+  /// quickening is disabled.
+  const uint32_t quickeningThreshold;
+  /// Whether the lazily compiled functions which are not called between two
+  /// full collections are evicted, see evictColdFunctions().
+  const bool evictColdLazyFunctions;
+  /// Whether the property maps shared by the children of hidden classes are
+  /// dropped after each full collection, see releasePropertyMaps().
+  const bool releaseSharedPropertyMaps;
 
 #ifdef HERMES_ENABLE_DEBUGGER
   /// The debugger internal host object, if created.
@@ -673,6 +788,16 @@ class Runtime : public HandleRootOwner,
   /// Track time spent of each opcode in the interpreter, in CPU cycles.
   uint64_t timeSpent[256] = {0};
 
+  /// Track the frequency of each pair of consecutively executed opcodes,
+  /// indexed by [previous][current]. Frequent pairs are candidates for
+  /// superinstructions.
+  uint32_t opcodePairFrequency[256][256] = {{0}};
+
+  /// Track the frequency of each triple of consecutively executed opcodes.
+  /// The key packs the three opcodes in execution order, the first in the
+  /// highest byte.
+  llvm::DenseMap<uint32_t, uint32_t> opcodeTripleFrequency{};
+
   /// Dump opcode stats to a stream.
   void dumpOpcodeStats(llvm::raw_ostream &os) const;
 #endif
@@ -702,6 +827,10 @@ class Runtime : public HandleRootOwner,
   /// Dump function profiling stats to stdout.
   enum class ProfileType{TIME, OPCODES, ALL};
   void dumpJSFunctionStats(ProfileType type = ProfileType::ALL);
+
+  /// Write to \p OS the number of times each named function was called, as
+  /// a JSON object which hermesc reads with -inlining-profile.
+  void dumpJSFunctionCallCounts(llvm::raw_ostream &OS);
 #endif
 
 #ifdef HERMESVM_PROFILER_BB
@@ -716,6 +845,42 @@ class Runtime : public HandleRootOwner,
   void dumpNativeCallStats(llvm::raw_ostream &OS);
 #endif
 
+  /// Write to \p OS the bytecode offsets of the instructions of each function
+  /// which are in their quickened form, as a JSON object which hermesc reads
+  /// with -type-feedback.
+  void dumpTypeFeedback(llvm::raw_ostream &OS);
+
+  /// Start sampling about one allocation every \p samplingInterval bytes,
+  /// discarding the samples of any previous run.
+  void startAllocationProfiler(uint32_t samplingInterval);
+
+  /// Stop sampling allocations. The objects sampled so far are still tracked,
+  /// so that the profile keeps showing which of them are alive.
+  void stopAllocationProfiler();
+
+  /// Write the sampled allocations that are still alive to \p OS in the
+  /// .heapprofile format of Chrome. Nothing is written if the profiler was
+  /// never started.
+  void dumpAllocationProfile(llvm::raw_ostream &OS);
+
+  /// Start recording the property cache transitions, quickenings,
+  /// dictionary mode conversions, JIT bailouts and interpreted function
+  /// entries and exits of this runtime, discarding the events of any previous
+  /// trace.
+  void startExecutionTrace();
+
+  /// Stop recording execution events. The events so far are kept.
+  void stopExecutionTrace();
+
+  /// Write the recorded execution events to \p OS as JSON. Nothing is written
+  /// if the trace was never started.
+  void dumpExecutionTrace(llvm::raw_ostream &OS);
+
+  /// \return the execution tracer while it is recording, null otherwise.
+  ExecutionTracer *getExecutionTracer() const {
+    return activeExecutionTracer_;
+  }
+
 #ifdef HERMES_ENABLE_DEBUGGER
   Debugger &getDebugger() {
     return debugger_;
@@ -734,6 +899,21 @@ class Runtime : public HandleRootOwner,
     return builtinsFrozen_;
   }
 
+  /// A function populating a lazy builtin constructor, its prototype and
+  /// every object only reachable through them.
+  using LazyConstructorInitializer =
+      void (*)(Runtime *runtime, Handle<NativeConstructor> cons);
+
+  /// Register the lazy constructor \p cons, which has no properties yet, to be
+  /// populated by \p init the first time it is used.
+  void registerLazyConstructor(
+      Handle<NativeConstructor> cons,
+      LazyConstructorInitializer init);
+
+  /// Populate the lazy constructor \p cons with its registered initializer.
+  /// Called when the lazy object is initialized.
+  void initializeLazyConstructor(Handle<NativeConstructor> cons);
+
   experiments::VMExperimentFlags getVMExperimentFlags() const {
     return vmExperimentFlags_;
   }
@@ -763,6 +943,13 @@ class Runtime : public HandleRootOwner,
   /// Only called internally or by the wrappers used for profiling.
   CallResult<HermesValue> interpretFunctionImpl(CodeBlock *newCodeBlock);
 
+ private:
+  /// Called by the interpreter trampolines, see
+  /// JITContext::getInterpreterTrampoline().
+  static CallResult<HermesValue> interpretFunctionFromTrampoline(
+      Runtime *runtime,
+      CodeBlock *newCodeBlock);
+
  private:
   /// Called by the GC at the beginning of a collection. This method informs the
   /// GC of all runtime roots.  The \p markLongLived argument
@@ -932,6 +1119,12 @@ class Runtime : public HandleRootOwner,
   /// Set of runtime statistics.
   instrumentation::RuntimeStats runtimeStats_;
 
+  /// Bytecode of the regexps compiled at runtime, by pattern and flags.
+  RegExpCache regExpCache_;
+
+  /// Bytecode compiled by eval() and the Function constructor, by source.
+  EvalCache evalCache_;
+
   /// Shared location to place native objects required by JSLib
   std::shared_ptr<RuntimeCommonStorage> commonStorage_;
 
@@ -960,11 +1153,17 @@ class Runtime : public HandleRootOwner,
 
   PinnedHermesValue *registerStack_;
   PinnedHermesValue *registerStackEnd_;
+  /// registerStack_ + STACK_RESERVE, so that checking for available stack is
+  /// a single comparison with the stack pointer.
+  PinnedHermesValue *registerStackLimit_;
   PinnedHermesValue *stackPointer_;
   /// True if we need to free the memory for the register stack on destruction.
   /// When set to false, the register stack is not allocated
   /// by the runtime itself.
   bool freeRegisterStack_{true};
+  /// The size in bytes of the register stack allocated by the runtime,
+  /// including the guard page below it.
+  size_t registerStackAllocSize_{0};
   /// Manages data to be used in the case of a crash.
   std::shared_ptr<CrashManager> crashMgr_;
   /// Points to the last register in the callers frame. The current frame (the
@@ -1005,6 +1204,13 @@ class Runtime : public HandleRootOwner,
   /// The global scope object.
   PinnedHermesValue global_;
 
+  /// The copy of the global object saved by saveGlobalObjectTemplate(), or
+  /// undefined.
+  PinnedHermesValue globalTemplate_{};
+
+  /// The callables enqueued by enqueueJob() and not called yet, oldest first.
+  std::deque<PinnedHermesValue> jobQueue_{};
+
   /// Cache for property lookups in non-JS code.
   PropertyCacheEntry fixedPropCache_[(size_t)PropCacheID::_COUNT];
 
@@ -1013,12 +1219,27 @@ class Runtime : public HandleRootOwner,
   /// to be scanned as roots in young-gen collections.
   std::vector<PinnedHermesValue> charStrings_{};
 
+  /// StringPrimitive representation of the integers below
+  /// kNumCachedIntStrings, or undefined if not converted yet. Like
+  /// charStrings_, these are allocated as "long-lived" objects.
+  PinnedHermesValue intStrings_[kNumCachedIntStrings];
+
   /// Pointers to native implementations of builtins.
   std::vector<NativeFunction *> builtins_{};
 
   /// True if the builtins are all frozen (non-writable, non-configurable).
   bool builtinsFrozen_{false};
 
+  /// A builtin constructor which hasn't been populated yet.
+  struct LazyConstructor {
+    PinnedHermesValue constructor;
+    LazyConstructorInitializer init;
+  };
+
+  /// The builtin constructors which haven't been used yet. Entries are removed
+  /// once they are initialized.
+  std::vector<LazyConstructor> lazyConstructors_{};
+
 #ifdef HERMESVM_PROFILER_BB
   BasicBlockExecutionInfo basicBlockExecInfo_;
 #endif
@@ -1031,6 +1252,37 @@ class Runtime : public HandleRootOwner,
   /// we are sure it's safe to unregisterRuntime in destructor.
   std::shared_ptr<SamplingProfiler> samplingProfiler_;
 
+  /// Whether a full collection finished since the previous call of
+  /// evictColdFunctions(). Only set if evictColdLazyFunctions is. The
+  /// interpreter evicts the functions when it next enters one, rather than
+  /// the collection itself, which may happen between the compilation of a
+  /// function and its frame being pushed.
+  bool coldFunctionEvictionPending_{false};
+
+  /// Whether a full collection finished since the previous call of
+  /// releasePropertyMaps(). Only set if releaseSharedPropertyMaps is. Like
+  /// the eviction, the release waits for the interpreter to enter a function,
+  /// since the collection may happen between a lookup into a map and the use
+  /// of its result.
+  bool propertyMapReleasePending_{false};
+
+  /// The allocation profiler, if it was started.
+  std::unique_ptr<AllocationProfiler> allocationProfiler_;
+
+  /// The execution tracer, if it was started.
+  std::unique_ptr<ExecutionTracer> executionTracer_;
+
+  /// The execution tracer while it is recording, so that the events that are
+  /// not traced cost a single check.
+  ExecutionTracer *activeExecutionTracer_{nullptr};
+
+  /// Bytes left to allocate before the next allocation is sampled. This is so
+  /// large when allocations are not being sampled that it never runs out.
+  int64_t bytesUntilAllocationSample_{INT64_MAX};
+
+  /// Sample the allocation of \p size bytes at \p cell.
+  void sampleAllocation(void *cell, uint32_t size);
+
 #ifdef HERMES_ENABLE_DEBUGGER
   Debugger debugger_{this};
 
@@ -1071,6 +1323,12 @@ class Runtime : public HandleRootOwner,
     savedIP_ = ip;
   }
 
+  /// \return the last IP stored by storeCallerIP(), which may be stale in
+  /// builds without assertions.
+  const inst::Inst *getCallerIP() const {
+    return savedIP_;
+  }
+
   /// Clear the caller's return address. This needs to be called after
   /// returning a call.
   void clearCallerIP() {
@@ -1100,6 +1358,10 @@ class Runtime : public HandleRootOwner,
  public:
   void storeCallerIP(const inst::Inst *ip) {}
 
+  const inst::Inst *getCallerIP() const {
+    return nullptr;
+  }
+
   void clearCallerIP() {}
 
   void saveCallerIPInStackFrame() {}
@@ -1276,12 +1538,18 @@ inline void Runtime::addCustomRootsFunction(const F &markRootsFn) {
 
 template <bool fixedSize, HasFinalizer hasFinalizer>
 inline void *Runtime::alloc(uint32_t sz) {
-  return heap_.alloc<fixedSize, hasFinalizer>(sz);
+  void *mem = heap_.alloc<fixedSize, hasFinalizer>(sz);
+  if (LLVM_UNLIKELY((bytesUntilAllocationSample_ -= sz) <= 0))
+    sampleAllocation(mem, sz);
+  return mem;
 }
 
 template <HasFinalizer hasFinalizer>
 inline void *Runtime::allocLongLived(uint32_t size) {
-  return heap_.allocLongLived<hasFinalizer>(size);
+  void *mem = heap_.allocLongLived<hasFinalizer>(size);
+  if (LLVM_UNLIKELY((bytesUntilAllocationSample_ -= size) <= 0))
+    sampleAllocation(mem, size);
+  return mem;
 }
 
 template <typename T>
@@ -1368,9 +1636,9 @@ inline uint32_t Runtime::availableStackSize() const {
 }
 
 inline bool Runtime::checkAvailableStack(uint32_t count) {
-  // Note: use 64-bit arithmetic to avoid overflow. We could also do it with
-  // a couple of comparisons, but that is likely to be slower.
-  return availableStackSize() >= (uint64_t)count + STACK_RESERVE;
+  // Note: the stack pointer can be below the limit, when the reserve is in
+  // use, so the difference must be signed.
+  return stackPointer_ - registerStackLimit_ >= (ptrdiff_t)count;
 }
 
 inline PinnedHermesValue *Runtime::allocUninitializedStack(uint32_t count) {
@@ -21,6 +21,7 @@ namespace vm {
 
 class CodeBlock;
 class Runtime;
+class SegmentedArray;
 
 using StringID = uint32_t;
 
@@ -77,6 +78,27 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// SymbolID.
   std::vector<SymbolID> stringIDMap_;
 
+  /// Number of consecutive strings in a page of the string table.
+  static constexpr uint32_t kStringPageSize = 64;
+
+  /// The position in the bytecode string kinds and identifier translations of
+  /// the first string of a page of the string table. The identifiers of a page
+  /// are registered together, the first time one of them is needed.
+  struct StringPage {
+    /// Index of the string kind entry that contains the first string.
+    uint32_t kindIndex;
+    /// Position of the first string within that string kind entry.
+    uint32_t kindOffset;
+    /// Index of the translation of the first identifier at or after the
+    /// first string.
+    uint32_t translationIndex;
+    /// Whether the identifiers of the page have been registered.
+    bool materialized;
+  };
+
+  /// The pages of the string table, indexed by StringID / kStringPageSize.
+  std::vector<StringPage> stringPages_;
+
   /// Weak pointer to a GC-managed Domain that owns this RuntimeModule.
   /// NOTE: This will not be made invalid through marking, because the domain
   /// updates the WeakRefs on the RuntimeModule when it is marked.
@@ -110,8 +132,26 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// Cacheing will be skipped if keyBufferIndex is >= 2^24.
   llvm::DenseMap<uint32_t, HiddenClass *> objectLiteralHiddenClasses_;
 
-  /// A map from template object ids to template objects.
-  llvm::DenseMap<uint32_t, JSObject *> templateMap_;
+  /// The element storage shared by the arrays created by NewArrayWithBuffer
+  /// instructions that only contain literals, keyed by the <bufferIndex,
+  /// numLiterals> tuple, see \c findCachedLiteralArrayStorage(). The entries
+  /// are weak, and whether all the elements are numbers is kept alongside.
+  llvm::DenseMap<uint64_t, std::pair<SegmentedArray *, bool>>
+      arrayLiteralStorages_;
+
+  /// The template objects indexed by their ids, or null if not created yet.
+  /// Template object ids are allocated densely by the compiler, so this is
+  /// one slot per tagged template of the module.
+  std::vector<JSObject *> templateObjects_;
+
+#ifndef HERMESVM_LEAN
+  /// If this module was created by createLazyModule(), the function of the
+  /// parent's bytecode it compiles, its ID in the parent and its name, which
+  /// are needed to make the module lazy again.
+  hbc::BytecodeFunction *lazyFunction_{nullptr};
+  uint32_t lazyFunctionID_{0};
+  SymbolID lazyName_{};
+#endif
 
   /// Registers the created RuntimeModule with \param domain, resulting in
   /// \param domain owning it. The RuntimeModule will be freed when the
@@ -180,6 +220,19 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// Calls `initialize` and does a bit of extra work.
   /// \param bytecode the bytecode data to initialize it with.
   void initializeLazyMayAllocate(std::unique_ptr<hbc::BCProvider> bytecode);
+
+  /// \return the CodeBlock of this module if it was created by
+  /// createLazyModule(), was compiled, and can be made lazy again: only its
+  /// entry point has a CodeBlock, since the others would refer to the
+  /// bytecode of the module, and it has no template objects, whose identity
+  /// would change. Otherwise \return null.
+  CodeBlock *getEvictableCodeBlock() const;
+
+  /// Return this module to the state createLazyModule() left it in, freeing
+  /// its bytecode, string table and literal caches, and make its
+  /// getEvictableCodeBlock() lazy again.
+  /// \return an estimate of the number of bytes freed.
+  size_t evictLazyCompiled();
 #endif
 
   /// Initialize modules created with \p createUninitialized,
@@ -201,13 +254,16 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
 
   /// For opcodes that use a stringID as identifier explicitly, we know that
   /// the compiler would have marked the stringID as identifier, and hence
-  /// we should have created the symbol during identifier table initialization.
-  /// The symbol must already exist in the map. This is a fast path.
+  /// the symbol was either created during identifier table initialization, or
+  /// is registered as a lazy identifier the first time it is needed. Neither
+  /// allocates in the GC heap. This is a fast path.
   SymbolID getSymbolIDMustExist(StringID stringID) {
-    assert(
-        stringIDMap_[stringID].isValid() &&
-        "Symbol must exist for this string ID");
-    return stringIDMap_[stringID];
+    SymbolID id = stringIDMap_[stringID];
+    if (LLVM_UNLIKELY(!id.isValid())) {
+      id = materializeStringPage(stringID);
+    }
+    assert(id.isValid() && "Symbol must exist for this string ID");
+    return id;
   }
 
   /// \return the \c SymbolID for a string by string index. The symbol may not
@@ -215,6 +271,10 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// on the fly.
   SymbolID getSymbolIDFromStringIDMayAllocate(StringID stringID) {
     SymbolID id = stringIDMap_[stringID];
+    if (LLVM_UNLIKELY(!id.isValid())) {
+      // Identifiers are registered with the rest of their page.
+      id = materializeStringPage(stringID);
+    }
     if (LLVM_UNLIKELY(!id.isValid())) {
       // Materialize this lazily created symbol.
       auto entry = bcProvider_->getStringTableEntry(stringID);
@@ -250,6 +310,12 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
     return getCodeBlockSlowPath(index);
   }
 
+  /// \return the CodeBlock for a function by function index if it was
+  /// created, or null.
+  CodeBlock *getCodeBlockIfCreated(unsigned index) const {
+    return functionMap_[index];
+  }
+
   /// \return whether this RuntimeModule has been initialized.
   bool isInitialized() const {
     return !bcProvider_->isLazy();
@@ -334,10 +400,38 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// \param clazz the hidden class to cache.
   void tryCacheLiteralHiddenClass(unsigned keyBufferIndex, HiddenClass *clazz);
 
+  /// Find the element storage shared by the arrays created from the literal
+  /// buffer at \p bufferIndex with \p numLiterals elements, if one exists.
+  /// \param[out] allNumbers set to whether all the elements are numbers.
+  /// \return the storage, or nullptr if it is not cached.
+  SegmentedArray *findCachedLiteralArrayStorage(
+      unsigned bufferIndex,
+      unsigned numLiterals,
+      bool &allNumbers) const;
+
+  /// Cache \p storage, which contains the \p numLiterals elements from the
+  /// literal buffer at \p bufferIndex, to be shared by later arrays.
+  /// \param allNumbers whether all the elements are numbers.
+  void cacheLiteralArrayStorage(
+      unsigned bufferIndex,
+      unsigned numLiterals,
+      SegmentedArray *storage,
+      bool allNumbers) {
+    arrayLiteralStorages_[getLiteralArrayStorageCacheKey(
+        bufferIndex, numLiterals)] = {storage, allNumbers};
+  }
+
+  /// Forget the hidden classes and element storage shared by literals, which
+  /// are created again by the next literal that needs them.
+  /// \return the number of bytes freed by the tables.
+  size_t clearLiteralCaches();
+
   /// Given \p templateObjectID, retrieve the cached template object.
   /// if it doesn't exist, return a nullptr.
   JSObject *findCachedTemplateObject(uint32_t templateObjID) {
-    return templateMap_.lookup(templateObjID);
+    return templateObjID < templateObjects_.size()
+        ? templateObjects_[templateObjID]
+        : nullptr;
   }
 
   /// Cache a template object in the template map using a template object ID as
@@ -349,15 +443,28 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
       uint32_t templateObjID,
       Handle<JSObject> templateObj) {
     assert(
-        templateMap_.count(templateObjID) == 0 &&
+        !findCachedTemplateObject(templateObjID) &&
         "The template object already exists.");
-    templateMap_[templateObjID] = templateObj.get();
+    if (templateObjID >= templateObjects_.size())
+      templateObjects_.resize(templateObjID + 1, nullptr);
+    templateObjects_[templateObjID] = templateObj.get();
   }
 
  private:
   /// Import the string table from the supplied module.
   void importStringIDMapMayAllocate();
 
+  /// Register the identifiers of the page of the string table that contains
+  /// \p stringID, using the hashes stored in the bytecode, unless that was
+  /// already done. Identifiers are only registered lazily in persistent
+  /// modules, where doing so does not allocate in the GC heap.
+  /// \return the symbol of \p stringID, which is invalid unless it is an
+  /// identifier.
+  SymbolID materializeStringPage(StringID stringID);
+
+  /// Register the identifiers of the page \p pageIndex of the string table.
+  void materializeStringPageAt(uint32_t pageIndex);
+
   /// Initialize functionMap_, without actually creating the code blocks.
   /// They will be created lazily when needed.
   void initializeFunctionMap();
@@ -399,6 +506,12 @@ class RuntimeModule final : public llvm::ilist_node<RuntimeModule> {
   /// less than 2^24).
   /// \param numLiterals number of literals used from key buffer of
   /// NewObjectWithBuffer instruction(must be less than 256).
+  static uint64_t getLiteralArrayStorageCacheKey(
+      unsigned bufferIndex,
+      unsigned numLiterals) {
+    return ((uint64_t)bufferIndex << 32) | numLiterals;
+  }
+
   static uint32_t getLiteralHiddenClassCacheHashKey(
       unsigned keyBufferIndex,
       unsigned numLiterals) {
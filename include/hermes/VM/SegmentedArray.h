@@ -235,9 +235,14 @@ class SegmentedArray final
           "Using the inline storage accessor when the index is larger than the "
           "inline storage");
       return inlineStorage()[index];
-    } else {
-      return *(begin() + index);
     }
+    assert(index < size() && "Trying to read from an index outside the size");
+    // Index the storage directly rather than through an iterator, to keep this
+    // down to a single well-predicted branch.
+    if (LLVM_LIKELY(index < kValueToSegmentThreshold)) {
+      return inlineStorage()[index];
+    }
+    return segmentAt(toSegment(index))->at(toInterior(index));
   }
 
   /// Gets the size of the SegmentedArray. The size is the number of elements
@@ -306,6 +311,27 @@ class SegmentedArray final
       Runtime *runtime,
       size_type newSize);
 
+  /// Copy the \p count elements starting at \p srcIndex of \p src to the
+  /// elements starting at \p dstIndex of \p dst. Both ranges must be within
+  /// the sizes of the arrays, and they may overlap if \p src and \p dst are
+  /// the same. Each contiguous run of elements, in the inline storage or in a
+  /// segment, is moved at once with a single ranged write barrier.
+  static void copyRange(
+      Runtime *runtime,
+      SegmentedArray *src,
+      size_type srcIndex,
+      SegmentedArray *dst,
+      size_type dstIndex,
+      size_type count);
+
+  /// Search the elements in [\p begin, \p end) for one whose encoding is the
+  /// same as that of \p value, front to back, or back to front if \p reverse
+  /// is set. The elements are compared several at a time where vector
+  /// instructions are available.
+  /// \return the index of the element found, or \p end if there is none.
+  size_type
+  findRaw(HermesValue value, size_type begin, size_type end, bool reverse);
+
   /// Decrease the size to zero.
   void clear() {
     shrinkRight(size());
@@ -399,6 +425,21 @@ class SegmentedArray final
     return (index - kValueToSegmentThreshold) % Segment::kMaxLength;
   }
 
+  /// \return the number of contiguous elements starting at \p index, up to
+  /// the end of the inline storage or of the segment holding it.
+  static size_type contiguousAfter(TotalIndex index) {
+    return index < kValueToSegmentThreshold
+        ? kValueToSegmentThreshold - index
+        : Segment::kMaxLength - toInterior(index);
+  }
+
+  /// \return the number of contiguous elements ending just before \p end,
+  /// which must be positive, down to the start of the inline storage or of the
+  /// segment holding the element before it.
+  static size_type contiguousBefore(TotalIndex end) {
+    return end <= kValueToSegmentThreshold ? end : toInterior(end - 1) + 1;
+  }
+
   /// Turns an unallocated segment into an allocated one.
   static void allocateSegment(
       Runtime *runtime,
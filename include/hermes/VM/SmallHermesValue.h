@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+//===----------------------------------------------------------------------===//
+/// \file
+/// This header defines a 32-bit encoding of the subset of HermesValues that do
+/// not need the full 64 bits of a NaN-box.
+///
+/// When compressed pointers are enabled the whole heap lives in a single
+/// reservation of at most 4GB, placed right after the Runtime (see
+/// Runtime::create), so every heap pointer can be represented by its
+/// BasedPointer offset. Heap cells are 8-byte aligned, which leaves the bottom
+/// three bits of such an offset free to hold a tag:
+///
+/// \pre
+/// pppppppp,pppppppp,pppppppp,ppppp000  object (BasedPointer offset)
+/// pppppppp,pppppppp,pppppppp,ppppp001  string (BasedPointer offset)
+/// iiiiiiii,iiiiiiii,iiiiiiii,iiiiu010  symbol (index, u: not uniqued)
+/// nnnnnnnn,nnnnnnnn,nnnnnnnn,nnnnn011  29-bit signed integer
+/// 00000000,00000000,00000000,00kkk100  empty, undefined, null, bool
+/// \endpre
+///
+/// Doubles that are not small integers, native values, and pointers that are
+/// not based on the heap cannot be encoded. Use \c canEncode() to find out
+/// whether a value fits before storing it.
+//===----------------------------------------------------------------------===//
+#ifndef HERMES_VM_SMALLHERMESVALUE_H
+#define HERMES_VM_SMALLHERMESVALUE_H
+
+#include "hermes/VM/HermesValue.h"
+#include "hermes/VM/PointerBase.h"
+
+namespace hermes {
+namespace vm {
+
+/// A 32-bit value that can be converted to and from a HermesValue. Pointers
+/// are stored relative to a PointerBase, which must be supplied for every
+/// conversion.
+class SmallHermesValue final {
+ public:
+  using RawType = uint32_t;
+
+  /// Whether pointers can be stored at all in this build. Pointers only fit in
+  /// 32 bits when they are compressed, or when the host is 32-bit.
+  static constexpr bool kCanEncodePointers =
+#if defined(HERMESVM_COMPRESSED_POINTERS) || LLVM_PTR_SIZE == 4
+      true;
+#else
+      false;
+#endif
+
+  /// Width of the tag stored in the bottom bits.
+  static constexpr unsigned kTagWidth = 3;
+  static constexpr RawType kTagMask = (1u << kTagWidth) - 1;
+
+  /// Range of the integers that can be stored inline.
+  static constexpr int32_t kMaxSmallInt = (1 << (31 - kTagWidth)) - 1;
+  static constexpr int32_t kMinSmallInt = -kMaxSmallInt - 1;
+
+  /// Symbols need one more bit to remember whether they have been uniqued.
+  static constexpr uint32_t kMaxSymbolIndex = (1u << (31 - kTagWidth)) - 1;
+
+  SmallHermesValue() : raw_(encodeSpecial(Special::Undefined)) {}
+
+  /// \return true if \p hv can be stored in a SmallHermesValue.
+  static bool canEncode(HermesValue hv) {
+    if (hv.isPointer())
+      return kCanEncodePointers;
+    if (hv.isNumber())
+      return isSmallInt(hv.getNumber());
+    if (hv.isSymbol())
+      return hv.getSymbol().unsafeGetIndex() <= kMaxSymbolIndex;
+    return hv.isUndefined() || hv.isNull() || hv.isEmpty() || hv.isBool();
+  }
+
+  /// Encode \p hv, whose pointer, if any, must lie within the heap based on
+  /// \p base.
+  /// \pre canEncode(hv).
+  static SmallHermesValue encode(HermesValue hv, PointerBase *base) {
+    assert(canEncode(hv) && "value does not fit in a SmallHermesValue");
+    if (hv.isObject())
+      return fromRaw(encodePointer(hv.getObject(), base, kObjectTag));
+    if (hv.isString())
+      return fromRaw(encodePointer(hv.getString(), base, kStringTag));
+    if (hv.isNumber()) {
+      return fromRaw(
+          (static_cast<RawType>(static_cast<int32_t>(hv.getNumber()))
+           << kTagWidth) |
+          kSmallIntTag);
+    }
+    if (hv.isSymbol()) {
+      SymbolID sym = hv.getSymbol();
+      return fromRaw(
+          (sym.unsafeGetIndex() << (kTagWidth + 1)) |
+          (static_cast<RawType>(sym.isNotUniqued()) << kTagWidth) |
+          kSymbolTag);
+    }
+    if (hv.isBool()) {
+      return fromRaw(
+          encodeSpecial(hv.getBool() ? Special::True : Special::False));
+    }
+    if (hv.isNull())
+      return fromRaw(encodeSpecial(Special::Null));
+    if (hv.isEmpty())
+      return fromRaw(encodeSpecial(Special::Empty));
+    return fromRaw(encodeSpecial(Special::Undefined));
+  }
+
+  /// \return the HermesValue this encodes. Pointers are decoded relative to
+  /// \p base.
+  HermesValue decode(PointerBase *base) const {
+    switch (getTag()) {
+      case kObjectTag:
+        return HermesValue::encodeObjectValue(decodePointer(base));
+      case kStringTag:
+        return HermesValue::encodeStringValue(
+            static_cast<const StringPrimitive *>(decodePointer(base)));
+      case kSymbolTag: {
+        uint32_t index = raw_ >> (kTagWidth + 1);
+        return HermesValue::encodeSymbolValue(
+            (raw_ >> kTagWidth) & 1 ? SymbolID::unsafeCreateNotUniqued(index)
+                                    : SymbolID::unsafeCreate(index));
+      }
+      case kSmallIntTag:
+        return HermesValue::encodeDoubleValue(getSmallInt());
+      default:
+        break;
+    }
+    switch (static_cast<Special>(raw_ >> kTagWidth)) {
+      case Special::Empty:
+        return HermesValue::encodeEmptyValue();
+      case Special::Null:
+        return HermesValue::encodeNullValue();
+      case Special::False:
+        return HermesValue::encodeBoolValue(false);
+      case Special::True:
+        return HermesValue::encodeBoolValue(true);
+      default:
+        return HermesValue::encodeUndefinedValue();
+    }
+  }
+
+  bool isPointer() const {
+    return getTag() <= kStringTag;
+  }
+  bool isObject() const {
+    return getTag() == kObjectTag;
+  }
+  bool isString() const {
+    return getTag() == kStringTag;
+  }
+  bool isSymbol() const {
+    return getTag() == kSymbolTag;
+  }
+  bool isSmallInt() const {
+    return getTag() == kSmallIntTag;
+  }
+  bool isUndefined() const {
+    return raw_ == encodeSpecial(Special::Undefined);
+  }
+
+  /// \pre isSmallInt().
+  int32_t getSmallInt() const {
+    assert(isSmallInt() && "not a small integer");
+    // Arithmetic shift restores the sign.
+    return static_cast<int32_t>(raw_) >> kTagWidth;
+  }
+
+  RawType getRaw() const {
+    return raw_;
+  }
+
+  bool operator==(SmallHermesValue other) const {
+    return raw_ == other.raw_;
+  }
+  bool operator!=(SmallHermesValue other) const {
+    return raw_ != other.raw_;
+  }
+
+ private:
+  /// Tags stored in the bottom bits. The pointer tags come first, so that
+  /// isPointer() is a single comparison.
+  static constexpr RawType kObjectTag = 0;
+  static constexpr RawType kStringTag = 1;
+  static constexpr RawType kSymbolTag = 2;
+  static constexpr RawType kSmallIntTag = 3;
+  static constexpr RawType kSpecialTag = 4;
+
+  /// The payload of a value tagged kSpecialTag.
+  enum class Special : RawType {
+    Empty = 0,
+    Undefined = 1,
+    Null = 2,
+    False = 3,
+    True = 4,
+  };
+
+  explicit SmallHermesValue(RawType raw) : raw_(raw) {}
+
+  static SmallHermesValue fromRaw(RawType raw) {
+    return SmallHermesValue(raw);
+  }
+
+  static constexpr RawType encodeSpecial(Special s) {
+    return (static_cast<RawType>(s) << kTagWidth) | kSpecialTag;
+  }
+
+  /// \return true if \p num is an integer (and not -0) in the inline range.
+  static bool isSmallInt(double num) {
+    if (!(num >= kMinSmallInt && num <= kMaxSmallInt))
+      return false;
+    int32_t i = static_cast<int32_t>(num);
+    return i == num && (i != 0 || !std::signbit(num));
+  }
+
+  static RawType encodePointer(const void *ptr, PointerBase *base, RawType tag) {
+    RawType offset =
+        base->pointerToBasedNonNull(const_cast<void *>(ptr)).offset_;
+    assert((offset & kTagMask) == 0 && "heap pointers must be 8-byte aligned");
+    return offset | tag;
+  }
+
+  void *decodePointer(PointerBase *base) const {
+    return base->basedToPointerNonNull(BasedPointer{raw_ & ~kTagMask});
+  }
+
+  RawType getTag() const {
+    return raw_ & kTagMask;
+  }
+
+  RawType raw_;
+};
+
+static_assert(
+    sizeof(SmallHermesValue) == 4,
+    "SmallHermesValue must be half the size of a HermesValue");
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_SMALLHERMESVALUE_H
@@ -33,10 +33,21 @@ struct SnapshotEdgeAcceptor final : public SlotAcceptorWithNamesDefault {
 
   using SlotAcceptorWithNamesDefault::accept;
 
+  /// Start the edges of a node, keeping only one in \p stride of them.
+  void beginNode(uint32_t stride) {
+    stride_ = stride;
+    index_ = 0;
+  }
+
   void accept(void *&ptr, const char *name) override;
   void accept(HermesValue &hv, const char *name) override;
   void accept(SymbolID sym, const char *name) override;
   void accept(uint64_t value, const char *name);
+
+ private:
+  /// Only edges whose index is a multiple of stride_ are written.
+  uint32_t stride_{1};
+  uint32_t index_{0};
 };
 
 } // namespace vm
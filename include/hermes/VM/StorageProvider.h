@@ -39,6 +39,13 @@ class StorageProvider {
   /// Provide storage from mmap'ed separate regions.
   static std::unique_ptr<StorageProvider> mmapProvider();
 
+  /// Provide storage from mmap'ed separate regions, recycling the storage
+  /// deleted by every pooled provider in the process before asking the OS for
+  /// more.  Each thread keeps a few deleted storages to itself, which it
+  /// reuses without synchronization; the rest go to a pool shared by all
+  /// threads, up to a limit past which they are returned to the OS.
+  static std::unique_ptr<StorageProvider> pooledMmapProvider();
+
   /// Provide storage via malloc.
   static std::unique_ptr<StorageProvider> mallocProvider();
 
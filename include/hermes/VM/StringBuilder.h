@@ -8,6 +8,7 @@
 #define HERMES_VM_STRINGBUILDER_H
 
 #include "hermes/ADT/SafeInt.h"
+#include "hermes/Support/UTF8.h"
 #include "hermes/VM/Casting.h"
 #include "hermes/VM/Runtime.h"
 #include "hermes/VM/StringPrimitive.h"
@@ -88,11 +89,52 @@ class StringBuilder {
           ascii.data() + ascii.size(),
           strPrim_->castToASCIIPointerForWrite() + index_);
     } else {
-      std::copy(
+      widenASCII(
           ascii.data(),
-          ascii.data() + ascii.size(),
+          ascii.size(),
+          strPrim_->castToUTF16PointerForWrite() + index_);
+    }
+    index_ += ascii.size();
+  }
+
+  /// Append an UTF16Ref \p str whose characters are all ASCII. Unlike
+  /// appendUTF16Ref(), this keeps an ASCII string ASCII.
+  void appendASCIIUTF16Ref(UTF16Ref str) {
+    assert(
+        index_ + str.size() <= strPrim_->getStringLength() &&
+        "StringBuilder append out of bound");
+    assert(isAllASCII(str.begin(), str.end()) && "str must be ASCII");
+    if (LLVM_LIKELY(strPrim_->isASCII())) {
+      narrowASCII(
+          str.data(),
+          str.size(),
+          strPrim_->castToASCIIPointerForWrite() + index_);
+    } else {
+      std::copy(
+          str.data(),
+          str.data() + str.size(),
           strPrim_->castToUTF16PointerForWrite() + index_);
     }
+    index_ += str.size();
+  }
+
+  /// Append the ASCII characters \p ascii with their letters converted to
+  /// upper case if \p toUpper, or to lower case otherwise.
+  void appendASCIIRefConvertingCase(ASCIIRef ascii, bool toUpper) {
+    assert(
+        index_ + ascii.size() <= strPrim_->getStringLength() &&
+        "StringBuilder append out of bound");
+    if (LLVM_LIKELY(strPrim_->isASCII())) {
+      convertASCIICase(
+          ascii.data(),
+          ascii.size(),
+          strPrim_->castToASCIIPointerForWrite() + index_,
+          toUpper);
+    } else {
+      char16_t *dst = strPrim_->castToUTF16PointerForWrite() + index_;
+      widenASCII(ascii.data(), ascii.size(), dst);
+      convertASCIICase(dst, ascii.size(), dst, toUpper);
+    }
     index_ += ascii.size();
   }
 
@@ -16,6 +16,7 @@
 
 #include "llvm/Support/TrailingObjects.h"
 
+#include <memory>
 #include <type_traits>
 
 namespace hermes {
@@ -31,6 +32,12 @@ class StringPrimitive : public VariableSizeRuntimeCell {
   friend class IdentifierTable;
   friend class StringBuilder;
   friend class StringView;
+  friend class RopeStringPrimitive;
+  template <typename T>
+  friend class RopeStringPrimitiveImpl;
+  friend class SlicedStringPrimitive;
+  template <typename T>
+  friend class BorrowedStringPrimitive;
 
   friend llvm::raw_ostream &operator<<(
       llvm::raw_ostream &OS,
@@ -217,20 +224,12 @@ class StringPrimitive : public VariableSizeRuntimeCell {
       size_t length);
 
   /// Flatten the string if it's a rope, possibly causing allocation/GC.
-  static Handle<StringPrimitive> ensureFlat(
+  static inline Handle<StringPrimitive> ensureFlat(
       Runtime *runtime,
-      Handle<StringPrimitive> self) {
-    // In the future, ensureFlat may trigger GC as it might allocate for
-    // ropes. Move the heap here.
-    runtime->potentiallyMoveHeap();
-    return self;
-    // TODO: Deal with different subclasses (e.g. rope)
-  }
+      Handle<StringPrimitive> self);
 
   /// \return true if the string is flat.
-  bool isFlat() const {
-    return true;
-  }
+  inline bool isFlat() const;
 
   /// \return a StringView of this string. In the case of a rope, we will need
   /// to resolve the rope, which might involve object allocations.
@@ -253,6 +252,15 @@ class StringPrimitive : public VariableSizeRuntimeCell {
   /// Whether this is an external string.
   inline bool isExternal() const;
 
+  /// Whether this is a rope, which may or may not have been flattened yet.
+  inline bool isRope() const;
+
+  /// Whether this is a slice of another string.
+  inline bool isSliced() const;
+
+  /// Whether the characters are borrowed from the embedder.
+  inline bool isBorrowed() const;
+
   /// Get a StringRef of T. T must be char or char16_t corresponding to whether
   /// this string is ASCII or UTF-16.
   template <typename T>
@@ -263,6 +271,9 @@ class StringPrimitive : public VariableSizeRuntimeCell {
   inline static uint32_t externalMemorySize(const GCCell *cell);
 
  private:
+  /// Whether the characters are stored in the cell itself.
+  inline bool isDynamic() const;
+
   /// Similar to copyUTF16String(SmallVectorImpl), copy the string into
   /// a raw pointer \p ptr. Since there is no size check, this function should
   /// only be called in rare cases carefully.
@@ -571,6 +582,376 @@ class ExternalStringPrimitive final : public SymbolStringPrimitive {
   StdString contents_{};
 };
 
+/// A JavaScript primitive string that is the concatenation of two other
+/// strings ("rope"). Creating a rope does not copy any characters, which makes
+/// building a long string piece by piece linear. The characters are copied
+/// when they are first needed, into a buffer outside the JS heap that the rope
+/// owns, and the two pieces are released. This does not allocate in the JS
+/// heap, so ropes can be flattened wherever the characters are accessed.
+/// Ropes are never uniqued.
+class RopeStringPrimitive : public StringPrimitive {
+  friend void ropeStringPrimitiveBuildMeta(
+      const GCCell *cell,
+      Metadata::Builder &mb);
+
+ public:
+  /// Shorter strings are always concatenated by copying, which is cheap
+  /// enough and needs less memory than a rope.
+  static constexpr uint32_t kMinRopeLength = EXTERNAL_STRING_MIN_SIZE;
+
+  /// Ropes at least this deep are flattened before they are extended, which
+  /// bounds the number of pieces a string can keep alive.
+  static constexpr uint32_t kMaxRopeDepth = 1024;
+
+  static bool classof(const GCCell *cell) {
+    return kindInRange(
+        cell->getKind(),
+        CellKind::RopeUTF16StringPrimitiveKind,
+        CellKind::RopeASCIIStringPrimitiveKind);
+  }
+
+  /// Create a rope for the concatenation of \p left and \p right, neither of
+  /// which may be empty.
+  static CallResult<HermesValue> create(
+      Runtime *runtime,
+      Handle<StringPrimitive> left,
+      Handle<StringPrimitive> right);
+
+  /// \return the depth of the tree of pieces of \p str, which is 0 for a flat
+  /// string.
+  static uint32_t getDepth(const StringPrimitive *str) {
+    const auto *rope = dyn_vmcast<RopeStringPrimitive>(str);
+    return rope && !rope->isFlattened() ? rope->depth_ : 0;
+  }
+
+  /// \return true if the characters have been copied into the rope.
+  bool isFlattened() const {
+    return left_.isUndefined();
+  }
+
+  /// Copy the characters into the rope and release its pieces.
+  void flatten() const;
+
+  /// The pieces of the rope, which must not have been flattened yet.
+  StringPrimitive *getLeft() const {
+    assert(!isFlattened() && "pieces of a flattened rope are released");
+    return left_.getString();
+  }
+  StringPrimitive *getRight() const {
+    assert(!isFlattened() && "pieces of a flattened rope are released");
+    return right_.getString();
+  }
+
+ protected:
+  RopeStringPrimitive(
+      Runtime *runtime,
+      const VTable *vt,
+      uint32_t cellSize,
+      StringPrimitive *left,
+      StringPrimitive *right,
+      uint32_t depth)
+      : StringPrimitive(
+            runtime,
+            vt,
+            cellSize,
+            left->getStringLength() + right->getStringLength(),
+            false /* uniqued */),
+        depth_(depth) {
+    left_.set(HermesValue::encodeStringValue(left), &runtime->getHeap());
+    right_.set(HermesValue::encodeStringValue(right), &runtime->getHeap());
+  }
+
+  /// Release the pieces once the characters have been copied.
+  void releasePieces() const {
+    left_.setNonPtr(HermesValue::encodeUndefinedValue());
+    right_.setNonPtr(HermesValue::encodeUndefinedValue());
+  }
+
+ private:
+  /// The two pieces, or undefined once the rope has been flattened.
+  mutable GCHermesValue left_;
+  mutable GCHermesValue right_;
+
+  /// The depth of the tree of pieces, counting this rope.
+  uint32_t depth_;
+};
+
+/// A rope with characters of type \p T. An ASCII rope only has ASCII pieces;
+/// a UTF-16 rope may have pieces of both types.
+template <typename T>
+class RopeStringPrimitiveImpl final : public RopeStringPrimitive {
+  friend class RopeStringPrimitive;
+  friend class StringPrimitive;
+
+  using Ref = llvm::ArrayRef<T>;
+
+  /// \return the cell kind for this string.
+  static constexpr CellKind getCellKind() {
+    return std::is_same<T, char16_t>::value
+        ? CellKind::RopeUTF16StringPrimitiveKind
+        : CellKind::RopeASCIIStringPrimitiveKind;
+  }
+
+ public:
+  static bool classof(const GCCell *cell) {
+    return cell->getKind() == RopeStringPrimitiveImpl::getCellKind();
+  }
+
+ private:
+  static const VTable vt;
+
+  RopeStringPrimitiveImpl(
+      Runtime *runtime,
+      StringPrimitive *left,
+      StringPrimitive *right,
+      uint32_t depth)
+      : RopeStringPrimitive(
+            runtime,
+            &vt,
+            sizeof(RopeStringPrimitiveImpl<T>),
+            left,
+            right,
+            depth) {}
+
+  /// Allocate a rope for \p left followed by \p right.
+  static CallResult<HermesValue> create(
+      Runtime *runtime,
+      Handle<StringPrimitive> left,
+      Handle<StringPrimitive> right,
+      uint32_t depth);
+
+  /// \return the characters, flattening the rope first if needed.
+  const T *getRawPointer() const {
+    if (LLVM_UNLIKELY(!isFlattened()))
+      flattenImpl();
+    return contents_.get();
+  }
+
+  Ref getStringRef() const {
+    return Ref(getRawPointer(), getStringLength());
+  }
+
+  /// Copy the characters of the pieces into contents_.
+  void flattenImpl() const;
+
+  // Finalizer to clean up the malloc'ed characters.
+  static void _finalizeImpl(GCCell *cell, GC *gc);
+
+  /// \return the size of the characters copied out of the pieces.
+  static size_t _mallocSizeImpl(GCCell *cell);
+
+  /// The characters, once the rope has been flattened. This is not a
+  /// std::basic_string because the GC moves cells with memcpy, which an empty
+  /// string using the small-string optimization would not survive.
+  mutable std::unique_ptr<T[]> contents_{};
+};
+
+/// A JavaScript primitive string made of a range of the characters of another
+/// string, which it keeps alive instead of copying them. The characters are
+/// always owned by a flat string that is not itself a slice, so slices of
+/// slices don't form chains. A slice has the character type of its owner.
+class SlicedStringPrimitive : public StringPrimitive {
+  friend void slicedStringPrimitiveBuildMeta(
+      const GCCell *cell,
+      Metadata::Builder &mb);
+
+ public:
+  /// Shorter slices are always copied, which is no more expensive than
+  /// creating a slice.
+  static constexpr uint32_t kMinSliceLength = 16;
+
+  /// A slice of an owner of at least EXTERNAL_STRING_THRESHOLD characters is
+  /// copied instead when the owner is more than this many times longer, so
+  /// that a small slice can't keep a large string alive.
+  static constexpr uint32_t kMaxOwnerRatio = 16;
+
+  static bool classof(const GCCell *cell) {
+    return kindInRange(
+        cell->getKind(),
+        CellKind::SlicedUTF16StringPrimitiveKind,
+        CellKind::SlicedASCIIStringPrimitiveKind);
+  }
+
+  /// \return the string that owns the characters of \p str, which is \p str
+  /// itself unless it is a slice.
+  static const StringPrimitive *getOwner(const StringPrimitive *str) {
+    if (const auto *sliced = dyn_vmcast<SlicedStringPrimitive>(str))
+      return sliced->getOwner();
+    return str;
+  }
+
+  /// \return whether a slice of \p length characters should share the
+  /// characters of an owner of \p ownerLength characters.
+  static bool shouldShare(uint32_t ownerLength, uint32_t length) {
+    return length >= kMinSliceLength &&
+        (ownerLength < EXTERNAL_STRING_THRESHOLD ||
+         length >= ownerLength / kMaxOwnerRatio);
+  }
+
+  /// Create a string of the \p length characters of \p str starting at
+  /// \p start, pointing into the owner of the characters of \p str.
+  static CallResult<HermesValue> create(
+      Runtime *runtime,
+      Handle<StringPrimitive> str,
+      uint32_t start,
+      uint32_t length);
+
+  /// \return the string that owns the characters.
+  StringPrimitive *getOwner() const {
+    return owner_.getString();
+  }
+
+  /// \return the index of the first character in the owner.
+  uint32_t getOffset() const {
+    return offset_;
+  }
+
+  const char *getASCIIPointer() const {
+    return getOwner()->castToASCIIPointer() + offset_;
+  }
+
+  const char16_t *getUTF16Pointer() const {
+    return getOwner()->castToUTF16Pointer() + offset_;
+  }
+
+ protected:
+  SlicedStringPrimitive(
+      Runtime *runtime,
+      const VTable *vt,
+      StringPrimitive *owner,
+      uint32_t offset,
+      uint32_t length)
+      : StringPrimitive(
+            runtime,
+            vt,
+            sizeof(SlicedStringPrimitive),
+            length,
+            false /* uniqued */),
+        offset_(offset) {
+    owner_.set(HermesValue::encodeStringValue(owner), &runtime->getHeap());
+  }
+
+ private:
+  /// The flat string that owns the characters.
+  GCHermesValue owner_;
+
+  /// The index of the first character in the owner.
+  uint32_t offset_;
+};
+
+/// A slice of an owner with characters of type \p T.
+template <typename T>
+class SlicedStringPrimitiveImpl final : public SlicedStringPrimitive {
+  friend class SlicedStringPrimitive;
+
+  /// \return the cell kind for this string.
+  static constexpr CellKind getCellKind() {
+    return std::is_same<T, char16_t>::value
+        ? CellKind::SlicedUTF16StringPrimitiveKind
+        : CellKind::SlicedASCIIStringPrimitiveKind;
+  }
+
+ public:
+  static bool classof(const GCCell *cell) {
+    return cell->getKind() == SlicedStringPrimitiveImpl::getCellKind();
+  }
+
+ private:
+  static const VTable vt;
+
+  SlicedStringPrimitiveImpl(
+      Runtime *runtime,
+      StringPrimitive *owner,
+      uint32_t offset,
+      uint32_t length)
+      : SlicedStringPrimitive(runtime, &vt, owner, offset, length) {
+    static_assert(
+        sizeof(SlicedStringPrimitiveImpl) == sizeof(SlicedStringPrimitive),
+        "subclasses must not add fields");
+  }
+};
+
+/// The owner of the characters of a BorrowedStringPrimitive, which is
+/// provided by the embedder. Destroying it releases the characters.
+class BorrowedStringBuffer {
+ public:
+  virtual ~BorrowedStringBuffer() = default;
+};
+
+/// A JavaScript primitive string whose characters are borrowed from memory
+/// owned by the embedder instead of being copied into the VM. The owner of the
+/// characters is destroyed when the string is finalized. Like the contents of
+/// an ExternalStringPrimitive, the characters are credited to the GC as
+/// external memory.
+template <typename T>
+class BorrowedStringPrimitive final : public StringPrimitive {
+  friend class StringPrimitive;
+
+  using Ref = llvm::ArrayRef<T>;
+
+  /// \return the cell kind for this string.
+  static constexpr CellKind getCellKind() {
+    return std::is_same<T, char16_t>::value
+        ? CellKind::BorrowedUTF16StringPrimitiveKind
+        : CellKind::BorrowedASCIIStringPrimitiveKind;
+  }
+
+ public:
+  static bool classof(const GCCell *cell) {
+    return cell->getKind() == BorrowedStringPrimitive::getCellKind();
+  }
+
+  /// Create a string of the characters \p str, owned by \p owner, without
+  /// copying them. The characters must not change while the string is alive,
+  /// and must all be ASCII when T is char. Throw \c RangeError if the string
+  /// is longer than \c MAX_STRING_LENGTH characters.
+  static CallResult<HermesValue> create(
+      Runtime *runtime,
+      Ref str,
+      std::unique_ptr<BorrowedStringBuffer> owner);
+
+ private:
+  static const VTable vt;
+
+  BorrowedStringPrimitive(
+      Runtime *runtime,
+      Ref str,
+      std::unique_ptr<BorrowedStringBuffer> owner)
+      : StringPrimitive(
+            runtime,
+            &vt,
+            sizeof(BorrowedStringPrimitive),
+            str.size(),
+            false /* uniqued */),
+        data_(str.data()),
+        owner_(owner.release()) {}
+
+  size_t getStringByteSize() const {
+    return getStringLength() * sizeof(T);
+  }
+
+  const T *getRawPointer() const {
+    return data_;
+  }
+
+  Ref getStringRef() const {
+    return Ref(data_, getStringLength());
+  }
+
+  /// Finalizer to release the characters.
+  static void _finalizeImpl(GCCell *cell, GC *gc);
+
+  /// \return the size of the characters borrowed by \p cell.
+  static size_t _mallocSizeImpl(GCCell *cell);
+
+  /// The characters of the string.
+  const T *data_;
+
+  /// The owner of the characters. This is a raw pointer, deleted by the
+  /// finalizer, because the GC moves cells with memcpy.
+  BorrowedStringBuffer *owner_;
+};
+
 template <typename T, bool Uniqued>
 const VTable DynamicStringPrimitive<T, Uniqued>::vt = VTable(
     DynamicStringPrimitive<T, Uniqued>::getCellKind(),
@@ -598,6 +979,38 @@ const VTable ExternalStringPrimitive<T>::vt = VTable(
 using ExternalUTF16StringPrimitive = ExternalStringPrimitive<char16_t>;
 using ExternalASCIIStringPrimitive = ExternalStringPrimitive<char>;
 
+template <typename T>
+const VTable RopeStringPrimitiveImpl<T>::vt = VTable(
+    RopeStringPrimitiveImpl<T>::getCellKind(),
+    sizeof(RopeStringPrimitiveImpl<T>),
+    RopeStringPrimitiveImpl<T>::_finalizeImpl,
+    nullptr, // markWeak.
+    RopeStringPrimitiveImpl<T>::_mallocSizeImpl);
+
+using RopeUTF16StringPrimitive = RopeStringPrimitiveImpl<char16_t>;
+using RopeASCIIStringPrimitive = RopeStringPrimitiveImpl<char>;
+
+template <typename T>
+const VTable SlicedStringPrimitiveImpl<T>::vt = VTable(
+    SlicedStringPrimitiveImpl<T>::getCellKind(),
+    sizeof(SlicedStringPrimitiveImpl<T>),
+    nullptr,
+    nullptr);
+
+using SlicedUTF16StringPrimitive = SlicedStringPrimitiveImpl<char16_t>;
+using SlicedASCIIStringPrimitive = SlicedStringPrimitiveImpl<char>;
+
+template <typename T>
+const VTable BorrowedStringPrimitive<T>::vt = VTable(
+    BorrowedStringPrimitive<T>::getCellKind(),
+    sizeof(BorrowedStringPrimitive<T>),
+    BorrowedStringPrimitive<T>::_finalizeImpl,
+    nullptr, // markWeak.
+    BorrowedStringPrimitive<T>::_mallocSizeImpl);
+
+using BorrowedUTF16StringPrimitive = BorrowedStringPrimitive<char16_t>;
+using BorrowedASCIIStringPrimitive = BorrowedStringPrimitive<char>;
+
 //===----------------------------------------------------------------------===//
 // StringPrimitive inline methods.
 
@@ -706,8 +1119,14 @@ inline CallResult<HermesValue> StringPrimitive::createLongLived(
 }
 
 inline const char *StringPrimitive::castToASCIIPointer() const {
-  if (LLVM_UNLIKELY(isExternal())) {
-    return vmcast<ExternalASCIIStringPrimitive>(this)->getRawPointer();
+  if (LLVM_UNLIKELY(!isDynamic())) {
+    if (isExternal())
+      return vmcast<ExternalASCIIStringPrimitive>(this)->getRawPointer();
+    if (isRope())
+      return vmcast<RopeASCIIStringPrimitive>(this)->getRawPointer();
+    if (isBorrowed())
+      return vmcast<BorrowedASCIIStringPrimitive>(this)->getRawPointer();
+    return vmcast<SlicedStringPrimitive>(this)->getASCIIPointer();
   } else if (isUniqued()) {
     return vmcast<DynamicUniquedASCIIStringPrimitive>(this)->getRawPointer();
   } else {
@@ -716,8 +1135,14 @@ inline const char *StringPrimitive::castToASCIIPointer() const {
 }
 
 inline const char16_t *StringPrimitive::castToUTF16Pointer() const {
-  if (LLVM_UNLIKELY(isExternal())) {
-    return vmcast<ExternalUTF16StringPrimitive>(this)->getRawPointer();
+  if (LLVM_UNLIKELY(!isDynamic())) {
+    if (isExternal())
+      return vmcast<ExternalUTF16StringPrimitive>(this)->getRawPointer();
+    if (isRope())
+      return vmcast<RopeUTF16StringPrimitive>(this)->getRawPointer();
+    if (isBorrowed())
+      return vmcast<BorrowedUTF16StringPrimitive>(this)->getRawPointer();
+    return vmcast<SlicedStringPrimitive>(this)->getUTF16Pointer();
   } else if (isUniqued()) {
     return vmcast<DynamicUniquedUTF16StringPrimitive>(this)->getRawPointer();
   } else {
@@ -781,7 +1206,13 @@ inline bool StringPrimitive::isASCII() const {
           CellKind::DynamicUniquedUTF16StringPrimitiveKind,
           CellKind::DynamicUniquedASCIIStringPrimitiveKind,
           CellKind::ExternalUTF16StringPrimitiveKind,
-          CellKind::ExternalASCIIStringPrimitiveKind),
+          CellKind::ExternalASCIIStringPrimitiveKind,
+          CellKind::RopeUTF16StringPrimitiveKind,
+          CellKind::RopeASCIIStringPrimitiveKind,
+          CellKind::SlicedUTF16StringPrimitiveKind,
+          CellKind::SlicedASCIIStringPrimitiveKind,
+          CellKind::BorrowedUTF16StringPrimitiveKind,
+          CellKind::BorrowedASCIIStringPrimitiveKind),
       "Cell kinds in unexpected order");
   // Given this assumption, the ASCII versions are either both odd or both
   // even.
@@ -790,23 +1221,80 @@ inline bool StringPrimitive::isASCII() const {
 }
 
 inline bool StringPrimitive::isExternal() const {
-  // We require that external cell kinds be larger than dynamic cell kinds.
+  return kindInRange(
+      getKind(),
+      CellKind::ExternalUTF16StringPrimitiveKind,
+      CellKind::ExternalASCIIStringPrimitiveKind);
+}
+
+inline bool StringPrimitive::isRope() const {
+  // Ropes are the last string kinds.
+  static_assert(
+      cellKindsContiguousAscending(
+          CellKind::ExternalASCIIStringPrimitiveKind,
+          CellKind::RopeUTF16StringPrimitiveKind,
+          CellKind::RopeASCIIStringPrimitiveKind),
+      "Cell kinds in unexpected order");
+  return kindInRange(
+      getKind(),
+      CellKind::RopeUTF16StringPrimitiveKind,
+      CellKind::RopeASCIIStringPrimitiveKind);
+}
+
+inline bool StringPrimitive::isSliced() const {
+  return kindInRange(
+      getKind(),
+      CellKind::SlicedUTF16StringPrimitiveKind,
+      CellKind::SlicedASCIIStringPrimitiveKind);
+}
+
+inline bool StringPrimitive::isBorrowed() const {
+  return kindInRange(
+      getKind(),
+      CellKind::BorrowedUTF16StringPrimitiveKind,
+      CellKind::BorrowedASCIIStringPrimitiveKind);
+}
+
+inline bool StringPrimitive::isDynamic() const {
+  // Dynamic strings are the first string kinds.
   static_assert(
       cellKindsContiguousAscending(
           CellKind::DynamicUTF16StringPrimitiveKind,
           CellKind::DynamicASCIIStringPrimitiveKind,
           CellKind::DynamicUniquedUTF16StringPrimitiveKind,
           CellKind::DynamicUniquedASCIIStringPrimitiveKind,
-          CellKind::ExternalUTF16StringPrimitiveKind,
-          CellKind::ExternalASCIIStringPrimitiveKind),
+          CellKind::ExternalUTF16StringPrimitiveKind),
       "Cell kinds in unexpected order");
-  return getKind() >= CellKind::ExternalUTF16StringPrimitiveKind;
+  return getKind() < CellKind::ExternalUTF16StringPrimitiveKind;
+}
+
+inline bool StringPrimitive::isFlat() const {
+  return !isRope() || vmcast<RopeStringPrimitive>(this)->isFlattened();
+}
+
+/*static*/ inline Handle<StringPrimitive> StringPrimitive::ensureFlat(
+    Runtime *runtime,
+    Handle<StringPrimitive> self) {
+  // Flattening a rope does not allocate in the JS heap, but callers may not
+  // rely on that.
+  runtime->potentiallyMoveHeap();
+  if (LLVM_UNLIKELY(!self->isFlat()))
+    vmcast<RopeStringPrimitive>(*self)->flatten();
+  return self;
 }
 
 template <typename T>
 inline ArrayRef<T> StringPrimitive::getStringRef() const {
   if (isExternal()) {
     return vmcast<ExternalStringPrimitive<T>>(this)->getStringRef();
+  } else if (isRope()) {
+    return vmcast<RopeStringPrimitiveImpl<T>>(this)->getStringRef();
+  } else if (isBorrowed()) {
+    return vmcast<BorrowedStringPrimitive<T>>(this)->getStringRef();
+  } else if (isSliced()) {
+    const auto *sliced = vmcast<SlicedStringPrimitive>(this);
+    return sliced->getOwner()->getStringRef<T>().slice(
+        sliced->getOffset(), getStringLength());
   } else if (isUniqued()) {
     return vmcast<DynamicStringPrimitive<T, true /* Uniqued */>>(this)
         ->getStringRef();
@@ -825,6 +1313,14 @@ inline uint32_t StringPrimitive::externalMemorySize(const GCCell *cell) {
   } else if (
       const auto asExtUTF16 = dyn_vmcast<ExternalUTF16StringPrimitive>(cell)) {
     return asExtUTF16->getStringByteSize();
+  } else if (
+      const auto asBorrowedAscii =
+          dyn_vmcast<BorrowedASCIIStringPrimitive>(cell)) {
+    return asBorrowedAscii->getStringByteSize();
+  } else if (
+      const auto asBorrowedUTF16 =
+          dyn_vmcast<BorrowedUTF16StringPrimitive>(cell)) {
+    return asBorrowedUTF16->getStringByteSize();
   } else {
     return 0;
   }
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_VM_STRUCTUREDCLONE_H
+#define HERMES_VM_STRUCTUREDCLONE_H
+
+#include "hermes/VM/JSArray.h"
+#include "hermes/VM/JSArrayBuffer.h"
+#include "hermes/VM/Runtime.h"
+
+#include <memory>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+/// A value serialized by structuredSerialize(). It holds no reference to the
+/// Runtime it came from, so it can be handed to another Runtime, possibly on
+/// another thread, and deserialized there with structuredDeserialize().
+/// The encoding is specific to this build of the VM and must not be persisted.
+struct StructuredCloneData {
+  /// The data block of a transferred ArrayBuffer.
+  struct TransferredBlock {
+    char *data;
+    JSArrayBuffer::size_type size;
+    /// Null once the block has been adopted by a deserialized ArrayBuffer, or
+    /// if the buffer was empty.
+    std::unique_ptr<ExternalArrayBufferOwner> owner;
+  };
+
+  /// The encoded value.
+  std::vector<uint8_t> bytes;
+  /// The data blocks of the transferred ArrayBuffers, in the order of the
+  /// transfer list. Blocks which were not adopted are released with this
+  /// object.
+  std::vector<TransferredBlock> transferred;
+};
+
+/// Serialize \p value into \p out, following the HTML structured clone
+/// algorithm for the values it applies to in Hermes: primitives other than
+/// symbols, plain objects, arrays, Date, Map, Set, ArrayBuffer and typed
+/// arrays. Plain objects contribute their own enumerable string-keyed
+/// properties and arrays their elements; prototypes are not preserved, but
+/// the identity of objects reachable more than once (including cycles) is.
+/// \param transferList if not null, an array of ArrayBuffers whose data blocks
+///   are moved into \p out instead of being copied. They are detached once
+///   the whole value has been serialized.
+/// \return ExecutionStatus::EXCEPTION with a TypeError if the value contains
+///   anything else, such as functions, symbols or host objects.
+ExecutionStatus structuredSerialize(
+    Runtime *runtime,
+    Handle<> value,
+    Handle<JSArray> transferList,
+    StructuredCloneData &out);
+
+/// Create in \p runtime a copy of the value serialized in \p data. Objects
+/// with the same set of properties share a HiddenClass, which is only built
+/// for the first of them. Transferred data blocks are adopted by the new
+/// ArrayBuffers and removed from \p data, so data which has any can only be
+/// deserialized once.
+CallResult<HermesValue> structuredDeserialize(
+    Runtime *runtime,
+    StructuredCloneData &data);
+
+} // namespace vm
+} // namespace hermes
+
+#endif
@@ -27,6 +27,24 @@ struct SweepResult {
   /// pointers, in the order they were displaced.
   std::vector<const VTable *> displacedVtablePtrs;
 
+  /// Describes where the live cells of one swept segment are compacted to.
+  struct SegmentSummary {
+    /// The index in displacedVtablePtrs of the VTable pointer of the first
+    /// live cell in the segment.
+    size_t firstVtable;
+
+    /// The post-compaction addresses of the first and the last live cell in
+    /// the segment, or null if the segment has no live cells.
+    char *firstDest{nullptr};
+    char *lastDest{nullptr};
+
+    explicit SegmentSummary(size_t firstVtable) : firstVtable(firstVtable) {}
+  };
+
+  /// One summary per swept segment, in the order they were swept.  Allows the
+  /// segments to be updated and compacted independently of each other.
+  std::vector<SegmentSummary> segments;
+
   /// An abstraction over the space available to compact into, as well as how
   /// much to use, and the next address to compact into.
   CompactionResult compactionResult;
@@ -104,6 +104,11 @@ struct VTable {
     finalize_(cell, gc);
   }
 
+  bool hasMarkWeak() const {
+    assert(isValid());
+    return markWeak_ != nullptr;
+  }
+
   void markWeakIfExists(GCCell *cell, GC *gc) const {
     assert(isValid());
     if (markWeak_) {
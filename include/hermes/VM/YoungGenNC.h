@@ -30,6 +30,8 @@ class OldGen;
 /// A generation whose preferred mode of collection is a copying evacuation, to
 /// be used as the young generation in a generational heap.
 class YoungGen : public GCGeneration {
+  friend struct RuntimeOffsets;
+
  public:
   /// See comment in GCGeneration.
   class Size final {
@@ -219,6 +221,11 @@ class YoungGen : public GCGeneration {
 #endif
   /// Do an evacuating collection of the young generation, copying
   /// reachable objects into the nextGen.
+  /// Evacuation is single threaded: forwardPointer installs forwarding
+  /// pointers with plain stores, survivors are bump allocated directly in the
+  /// old generation (which keeps its card object boundaries exact), and the
+  /// transitive closure is a Cheney scan of the old generation from the level
+  /// at which the collection started.
   void collect();
 #ifndef NDEBUG
  private:
@@ -261,6 +268,12 @@ class YoungGen : public GCGeneration {
   /// the former will yield the survival rate.
   gcheapsize_t cumPreBytes_ = 0;
   gcheapsize_t cumPromotedBytes_ = 0;
+
+  /// The number of old generation cards considered while looking for pointers
+  /// into the young generation, and the number of those that were skipped by
+  /// consulting the card table summaries.
+  uint64_t cumCardsScanned_ = 0;
+  uint64_t cumCardsSkipped_ = 0;
 };
 
 size_t YoungGen::size() const {
@@ -25,6 +25,47 @@ struct PerfEvents {
   static bool endAndInsertStats(std::string &jsonStats);
 };
 
+/// A group of hardware counters of a single thread, which are counted while
+/// the thread runs user code, and can be read from a signal handler.
+/// Only supported on Linux.
+class ThreadPerfCounters {
+ public:
+  enum Counter : unsigned {
+    Cycles,
+    Instructions,
+    CacheMisses,
+    NumCounters,
+  };
+
+  ThreadPerfCounters() = default;
+  ThreadPerfCounters(const ThreadPerfCounters &) = delete;
+  ThreadPerfCounters &operator=(const ThreadPerfCounters &) = delete;
+  ~ThreadPerfCounters() {
+    close();
+  }
+
+  /// Start counting for the thread \p tid, which is the id from
+  /// oscompat::thread_id(), closing the counters of any previous one.
+  /// \return false if the counters can't be opened.
+  bool open(uint64_t tid);
+
+  /// Stop counting.
+  void close();
+
+  bool isOpen() const {
+    return groupFd_ != -1;
+  }
+
+  /// Read the counts since open() into \p values. Async-signal-safe.
+  /// \return false if the counters are not open or can't be read.
+  bool read(uint64_t values[NumCounters]) const;
+
+ private:
+  /// The counters are read at once through the first, which leads the group.
+  int groupFd_{-1};
+  int fds_[NumCounters]{-1, -1, -1};
+};
+
 } // namespace instrumentation
 } // namespace vm
 } // namespace hermes
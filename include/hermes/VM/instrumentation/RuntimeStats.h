@@ -9,8 +9,12 @@
 
 #include "hermes/Support/PerfSection.h"
 
+#include "llvm/ADT/DenseMap.h"
+
 #include <stdint.h>
 #include <chrono>
+#include <string>
+#include <utility>
 
 namespace hermes {
 namespace vm {
@@ -39,6 +43,27 @@ struct RuntimeStats {
     uint64_t count{0};
   };
 
+  /// A NativeCallStatistic tracks the calls to a native or host function.
+  /// Every call is counted, but only one in nativeCallSamplingInterval is
+  /// timed, in wall time. All times are in seconds.
+  struct NativeCallStatistic {
+    /// The name property of the function, or empty if it isn't a string.
+    std::string name{};
+    uint64_t count{0};
+    uint64_t timedCount{0};
+    double timedWallDuration{0};
+
+    /// \return the wall time of all the calls, extrapolated from the timed
+    /// ones.
+    double estimatedWallDuration() const {
+      return timedCount ? timedWallDuration * count / timedCount : 0;
+    }
+  };
+
+  /// Native and host functions are told apart by their code and context,
+  /// since all the host functions share the same code.
+  using NativeCallKey = std::pair<const void *, const void *>;
+
   RuntimeStats(bool shouldSample) : shouldSample(shouldSample) {}
 
   /// Measure of host function callouts (outgoing from VM).
@@ -50,6 +75,31 @@ struct RuntimeStats {
   /// Measure of of jsi Function calls (incoming to VM).
   Statistic incomingFunction;
 
+  /// Measure of RuntimeModule initialization from bytecode, which imports its
+  /// string table and CommonJS module table.
+  Statistic runtimeModuleInit;
+
+  /// The calls to each native and host function, since
+  /// enableNativeCallStats() was last called.
+  llvm::DenseMap<NativeCallKey, NativeCallStatistic> nativeCalls{};
+
+  /// One call in this many to native and host functions is timed, or none
+  /// is, and none is counted, if it is 0.
+  uint32_t nativeCallSamplingInterval{0};
+
+  /// The number of native calls left until the next one that is timed.
+  uint32_t nativeCallsUntilTimed{0};
+
+  /// Start counting the calls to each native and host function, and timing
+  /// one in \p samplingInterval of them, forgetting any previous ones.
+  void enableNativeCallStats(uint32_t samplingInterval);
+
+  /// Stop counting calls to native and host functions. Those counted so far
+  /// are kept.
+  void disableNativeCallStats() {
+    nativeCallSamplingInterval = 0;
+  }
+
   /// The topmost RAIITimer in the stack.
   RAIITimer *timerStack{nullptr};
 
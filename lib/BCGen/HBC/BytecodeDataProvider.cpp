@@ -218,6 +218,12 @@ bool BytecodeFileFields<Mutable>::populateFromBuffer(
         f.cjsModuleTable =
             castArrayRef<std::pair<uint32_t, uint32_t>>(buf, h->cjsModuleCount);
       }
+      if (h->cjsModuleDependencyCount) {
+        f.cjsModuleDependencyOffsets =
+            castArrayRef<uint32_t>(buf, h->cjsModuleCount + 1);
+        f.cjsModuleDependencies =
+            castArrayRef<uint32_t>(buf, h->cjsModuleDependencyCount);
+      }
     }
   };
 
@@ -296,6 +302,7 @@ warmup(const uint8_t *data, uint32_t size, std::atomic<bool> *abortFlag) {
 }
 
 void BCProviderFromBuffer::stopWarmup() {
+  std::lock_guard<std::mutex> lock(warmupMutex_);
   if (warmupThread_) {
     warmupAbortFlag_.store(true, std::memory_order_release);
     warmupThread_->join();
@@ -304,6 +311,7 @@ void BCProviderFromBuffer::stopWarmup() {
 }
 
 void BCProviderFromBuffer::startWarmup(uint8_t percent) {
+  std::lock_guard<std::mutex> lock(warmupMutex_);
   if (!warmupThread_) {
     uint32_t warmupSize = buffer_->size();
     assert(percent <= 100);
@@ -480,6 +488,8 @@ BCProviderFromBuffer::BCProviderFromBuffer(std::unique_ptr<const Buffer> buffer)
   cjsModuleOffset_ = fileHeader->cjsModuleOffset;
   cjsModuleTable_ = fields.cjsModuleTable;
   cjsModuleTableStatic_ = fields.cjsModuleTableStatic;
+  cjsModuleDependencyOffsets_ = fields.cjsModuleDependencyOffsets;
+  cjsModuleDependencies_ = fields.cjsModuleDependencies;
 }
 
 llvm::ArrayRef<uint8_t> BCProviderFromBuffer::getEpilogue() const {
@@ -495,6 +505,11 @@ SHA1 BCProviderFromBuffer::getSourceHash() const {
 llvm::ArrayRef<uint8_t> BCProviderFromBuffer::getEpilogueFromBytecode(
     llvm::ArrayRef<uint8_t> buffer) {
   const uint8_t *p = buffer.data();
+  if (isCompressedBytecodeStream(buffer)) {
+    const auto *header = castData<hbc::CompressedBytecodeHeader>(p);
+    return llvm::ArrayRef<uint8_t>(
+        buffer.data() + header->containerLength, buffer.end());
+  }
   const auto *fileHeader = castData<hbc::BytecodeFileHeader>(p);
   const auto *begin = buffer.data() + fileHeader->fileLength;
   const auto *end = buffer.data() + buffer.size();
@@ -505,6 +520,9 @@ SHA1 BCProviderFromBuffer::getSourceHashFromBytecode(
     llvm::ArrayRef<uint8_t> buffer) {
   SHA1 hash;
   const uint8_t *p = buffer.data();
+  // A compressed container starts with the file header, stored as it is.
+  if (isCompressedBytecodeStream(buffer))
+    p += sizeof(hbc::CompressedBytecodeHeader);
   const auto *fileHeader = castData<hbc::BytecodeFileHeader>(p);
   std::copy(
       fileHeader->sourceHash,
@@ -582,12 +600,24 @@ void prefetchRegion(const uint8_t *p, size_t sz) {
 }
 } // namespace
 
+void BCProviderFromBuffer::willNeedFunction(uint32_t functionID) {
+  // Decompressed bytecode is in anonymous memory, there is nothing to read.
+  if (decompressed_)
+    return;
+  RuntimeFunctionHeader header = getFunctionHeader(functionID);
+  prefetchRegion(bufferPtr_ + header.offset(), header.bytecodeSizeInBytes());
+}
+
 void BCProviderFromBuffer::prefetch(llvm::ArrayRef<uint8_t> aref) {
   // We require file start be page-aligned so we can safely round down to page
   // size in prefetchRegion.
   assert(
       reinterpret_cast<uintptr_t>(aref.data()) % oscompat::page_size() == 0 &&
       "Precondition: pointer is page-aligned.");
+  // The file of a compressed container is only available once it has been
+  // read by a BCProviderFromBuffer.
+  if (isCompressedBytecodeStream(aref))
+    return;
   ConstBytecodeFileFields fields;
   std::string errstr;
   if (!fields.populateFromBuffer(aref, &errstr)) {
@@ -276,6 +276,21 @@ void BytecodeDisassembler::disassembleCJSModuleTable(raw_ostream &OS) {
     }
     OS << '\n';
   }
+
+  if (bcProvider_->hasCJSModuleDependencies()) {
+    OS << "CommonJS Module Dependencies:\n";
+    uint32_t count = cjsModules.size() + cjsModulesStatic.size();
+    for (uint32_t i = 0; i < count; ++i) {
+      auto dependencies = bcProvider_->getCJSModuleDependencies(i);
+      if (dependencies.empty())
+        continue;
+      OS << "  Module index " << i << " -> module IDs";
+      for (uint32_t id : dependencies)
+        OS << ' ' << id;
+      OS << '\n';
+    }
+    OS << '\n';
+  }
 }
 
 void BytecodeDisassembler::disassembleExceptionHandlers(
@@ -316,12 +331,31 @@ void BytecodeDisassembler::disassembleExceptionHandlersPretty(
 
 namespace {
 
+/// \return the unaligned offset of the jump table of the SwitchImm or
+/// SwitchStr instruction \p inst.
+uint32_t switchJumpTableOffset(const inst::Inst *inst) {
+  return inst->opCode == inst::OpCode::SwitchStr ? inst->iSwitchStr.op2
+                                                 : inst->iSwitchImm.op2;
+}
+
 /// Given a SwitchImm instruction, loop through each entry of the associated
-/// jump table.
+/// jump table. For a SwitchStr instruction, loop through the used entries of
+/// its hash table, with the string ID of the case instead of the index.
 /// F: (current index into master jump table, jump target offset, destination
 /// instruction) -> void.
 template <typename F>
 void switchJumpTableForEach(const inst::Inst *inst, F f) {
+  if (inst->opCode == inst::OpCode::SwitchStr) {
+    const auto *table = reinterpret_cast<const uint32_t *>(llvm::alignAddr(
+        (const uint8_t *)inst + inst->iSwitchStr.op2, sizeof(uint32_t)));
+    for (uint32_t i = 0; i < inst->iSwitchStr.op5; ++i) {
+      uint32_t stringID = table[2 * i];
+      int32_t jumpTargetOffset = table[2 * i + 1];
+      if (stringID != SWITCH_STR_EMPTY_ENTRY)
+        f(stringID, jumpTargetOffset, (const uint8_t *)inst + jumpTargetOffset);
+    }
+    return;
+  }
   assert(inst->opCode == inst::OpCode::SwitchImm && "expected SwitchImm");
   unsigned start = inst->iSwitchImm.op4;
   unsigned end = inst->iSwitchImm.op5;
@@ -363,8 +397,8 @@ void BytecodeVisitor::visitInstructionsInFunction(unsigned funcId) {
     auto instLength = md.size;
     preVisitInstruction(md.opCode, ip, instLength);
 
-    // Visit branch targets of the SwitchImm instruction.
-    if (op == OpCode::SwitchImm) {
+    // Visit branch targets of the SwitchImm and SwitchStr instructions.
+    if (op == OpCode::SwitchImm || op == OpCode::SwitchStr) {
       switchJumpTableForEach(
           (inst::Inst const *)ip,
           [this](uint32_t jmpIdx, int32_t offset, const uint8_t *dest) {
@@ -489,6 +523,7 @@ void JumpTargetsVisitor::preVisitInstruction(
     int length) {
   switch (opcode) {
     case OpCode::SwitchImm:
+    case OpCode::SwitchStr:
       // Decode jump table of SwitchImm instruction.
       switchInsts_.push_back((inst::Inst const *)ip);
       break;
@@ -694,7 +729,7 @@ class DisassembleVisitor : public BytecodeVisitor {
     int offset = ip - bcProvider_->getBytecode(funcId_);
     assert(offset >= 0);
     os_ << "[@ " << offset << "] " << getOpCodeString(opcode);
-    if (opcode == OpCode::SwitchImm) {
+    if (opcode == OpCode::SwitchImm || opcode == OpCode::SwitchStr) {
       const inst::Inst *inst = (inst::Inst const *)ip;
       switchInsts_.push_back(inst);
     }
@@ -886,7 +921,7 @@ void BytecodeDisassembler::disassembleFunctionPretty(
        << "Jump Tables: \n";
     for (auto *inst : switchInsts) {
       OS << "  "
-         << "offset " << inst->iSwitchImm.op2 << "\n";
+         << "offset " << switchJumpTableOffset(inst) << "\n";
       switchJumpTableForEach(
           inst, [&](uint32_t jmpIdx, int32_t offset, const uint8_t *dest) {
             OS << "   " << jmpIdx << " : "
@@ -912,7 +947,7 @@ void BytecodeDisassembler::disassembleFunctionRaw(
        << "Jump Tables: \n";
     for (auto *inst : switchInsts) {
       OS << "  "
-         << "offset " << inst->iSwitchImm.op2 << "\n";
+         << "offset " << switchJumpTableOffset(inst) << "\n";
       switchJumpTableForEach(
           inst, [&](uint32_t jmpIdx, int32_t offset, const uint8_t *dest) {
             OS << "   " << jmpIdx << " : " << offset << "\n";
@@ -8,6 +8,7 @@
 
 #include "hermes/BCGen/HBC/ConsecutiveStringStorage.h"
 #include "hermes/Inst/Builtins.h"
+#include "hermes/Inst/InstDecode.h"
 #include "hermes/Support/OSCompat.h"
 #include "hermes/Support/UTF8.h"
 
@@ -15,6 +16,7 @@
 #include "llvm/Support/Format.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <algorithm>
 #include <locale>
 #include <unordered_map>
 
@@ -50,6 +52,18 @@ void BytecodeFunctionGenerator::addDebugSourceLocation(
   debugLocations_.push_back(info);
 }
 
+void BytecodeFunctionGenerator::encodeDebugLocations() {
+  if (debugLocations_.empty())
+    return;
+  assert(
+      encodedDebugLocations_.empty() &&
+      "locations added after they were encoded");
+  encodedDebugLocations_ = DebugInfoGenerator::encodeSourceLocations(
+      sourceLocation_, debugLocations_);
+  // Release the memory, which clear() would keep.
+  std::vector<DebugSourceLocation>().swap(debugLocations_);
+}
+
 void BytecodeFunctionGenerator::setJumpTable(
     std::vector<uint32_t> &&jumpTable) {
   assert(!jumpTable.empty() && "invoked with no jump table");
@@ -112,6 +126,24 @@ void BytecodeFunctionGenerator::shrinkJump(offset_t loc) {
   longToShortJump(loc - 1);
 }
 
+void BytecodeFunctionGenerator::quickenInstructions(
+    llvm::ArrayRef<uint32_t> offsets) {
+  llvm::SmallVector<uint32_t, 8> sorted(offsets.begin(), offsets.end());
+  std::sort(sorted.begin(), sorted.end());
+  auto it = sorted.begin();
+  // Walk the instructions, since an offset from an outdated profile may be
+  // in the middle of one.
+  for (offset_t loc = 0, e = opcodes_.size(); loc < e && it != sorted.end();
+       loc += inst::getInstSize(static_cast<inst::OpCode>(opcodes_[loc]))) {
+    while (it != sorted.end() && *it < loc)
+      ++it;
+    if (it != sorted.end() && *it == loc) {
+      opcodes_[loc] = static_cast<opcode_atom_t>(
+          inst::getQuickenedOpCode(static_cast<inst::OpCode>(opcodes_[loc])));
+    }
+  }
+}
+
 void BytecodeFunctionGenerator::updateJumpTarget(
     offset_t loc,
     int newVal,
@@ -175,23 +207,41 @@ uint32_t BytecodeModuleGenerator::addFilename(StringRef filename) {
 }
 
 void BytecodeModuleGenerator::addCJSModule(
+    uint32_t moduleID,
     uint32_t functionID,
-    uint32_t nameID) {
+    uint32_t nameID,
+    llvm::ArrayRef<uint32_t> dependencies) {
   assert(
       cjsModulesStatic_.empty() &&
       "Statically resolved modules must be in cjsModulesStatic_");
+  // requireFast() calls which were resolved while others weren't find their
+  // module by its position in this table.
+  assert(
+      moduleID - cjsModuleOffset_ == cjsModules_.size() &&
+      "Module ID out of order in cjsModules_");
+  (void)moduleID;
   cjsModules_.push_back({nameID, functionID});
+  addCJSModuleDependencies(dependencies);
 }
 
 void BytecodeModuleGenerator::addCJSModuleStatic(
     uint32_t moduleID,
-    uint32_t functionID) {
+    uint32_t functionID,
+    llvm::ArrayRef<uint32_t> dependencies) {
   assert(cjsModules_.empty() && "Unresolved modules must be in cjsModules_");
   assert(
       moduleID - cjsModuleOffset_ == cjsModulesStatic_.size() &&
       "Module ID out of order in cjsModulesStatic_");
   (void)moduleID;
   cjsModulesStatic_.push_back(functionID);
+  addCJSModuleDependencies(dependencies);
+}
+
+void BytecodeModuleGenerator::addCJSModuleDependencies(
+    llvm::ArrayRef<uint32_t> dependencies) {
+  cjsModuleDependencies_.insert(
+      cjsModuleDependencies_.end(), dependencies.begin(), dependencies.end());
+  cjsModuleDependencyOffsets_.push_back(cjsModuleDependencies_.size());
 }
 
 std::unique_ptr<BytecodeModule> BytecodeModuleGenerator::generate() {
@@ -210,6 +260,9 @@ std::unique_ptr<BytecodeModule> BytecodeModuleGenerator::generate() {
   BytecodeOptions bytecodeOptions;
   bytecodeOptions.staticBuiltins = options_.staticBuiltinsEnabled;
   bytecodeOptions.cjsModulesStaticallyResolved = !cjsModulesStatic_.empty();
+  // Only emit the dependency table if there is something in it.
+  if (cjsModuleDependencies_.empty())
+    cjsModuleDependencyOffsets_.clear();
   std::unique_ptr<BytecodeModule> BM{new BytecodeModule(
       functionGenerators_.size(),
       std::move(kinds),
@@ -225,6 +278,8 @@ std::unique_ptr<BytecodeModule> BytecodeModuleGenerator::generate() {
       cjsModuleOffset_,
       std::move(cjsModules_),
       std::move(cjsModulesStatic_),
+      std::move(cjsModuleDependencyOffsets_),
+      std::move(cjsModuleDependencies_),
       bytecodeOptions)};
 
   DebugInfoGenerator debugInfoGen{std::move(filenameTable_)};
@@ -268,13 +323,16 @@ std::unique_ptr<BytecodeModule> BytecodeModuleGenerator::generate() {
     }
 
     if (BFG.hasDebugInfo()) {
-      uint32_t sourceLocOffset = debugInfoGen.appendSourceLocations(
-          BFG.getSourceLocation(), i, BFG.getDebugLocations());
+      uint32_t sourceLocOffset =
+          debugInfoGen.appendSourceLocations(BFG.getDebugLocations(), i);
       uint32_t lexicalDataOffset = debugInfoGen.appendLexicalData(
           BFG.getLexicalParentID(), BFG.getDebugVariableNames());
       func->setDebugOffsets({sourceLocOffset, lexicalDataOffset});
     }
     BM->setFunction(i, std::move(func));
+    // The bytecode was moved to the BytecodeFunction, and the debug info
+    // appended, so release the rest as we go.
+    functionGenerators_.erase(F);
   }
 
   BM->setDebugInfo(debugInfoGen.serializeWithMove());
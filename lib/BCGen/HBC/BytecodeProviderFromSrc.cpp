@@ -46,6 +46,8 @@ BCProviderFromSrc::BCProviderFromSrc(
   cjsModuleOffset_ = module_->getCJSModuleOffset();
   cjsModuleTable_ = module_->getCJSModuleTable();
   cjsModuleTableStatic_ = module_->getCJSModuleTableStatic();
+  cjsModuleDependencyOffsets_ = module_->getCJSModuleDependencyOffsets();
+  cjsModuleDependencies_ = module_->getCJSModuleDependencies();
 
   debugInfo_ = &module_->getDebugInfo();
 
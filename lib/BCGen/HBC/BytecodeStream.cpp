@@ -33,6 +33,8 @@ void BytecodeSerializer::serialize(BytecodeModule &BM, const SHA1 &sourceHash) {
                             BM.getObjectValueBufferSize(),
                             BM.getCJSModuleOffset(),
                             cjsModuleCount,
+                            static_cast<uint32_t>(
+                                BM.getCJSModuleDependencies().size()),
                             debugInfoOffset_,
                             BM.getBytecodeOptions()};
   writeBinary(header);
@@ -115,6 +117,11 @@ void BytecodeSerializer::serializeCJSModuleTable(BytecodeModule &BM) {
   }
 
   writeBinaryArray(BM.getCJSModuleTableStatic());
+
+  if (!BM.getCJSModuleDependencies().empty()) {
+    writeBinaryArray(BM.getCJSModuleDependencyOffsets());
+    writeBinaryArray(BM.getCJSModuleDependencies());
+  }
 }
 
 // ==================== Exception Handler Table =====================
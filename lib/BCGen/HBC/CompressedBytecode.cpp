@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/BCGen/HBC/CompressedBytecode.h"
+
+#include "hermes/Support/ErrorHandling.h"
+
+// The implementation of miniz is compiled as part of the zip library.
+#define MINIZ_HEADER_FILE_ONLY
+#define MINIZ_NO_ZLIB_COMPATIBLE_NAMES
+#include "zip/src/miniz.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace hermes {
+namespace hbc {
+
+bool isCompressedBytecodeStream(llvm::ArrayRef<uint8_t> aref) {
+  uint64_t magic;
+  if (aref.size() < sizeof(CompressedBytecodeHeader))
+    return false;
+  std::memcpy(&magic, aref.data(), sizeof(magic));
+  return magic == COMPRESSED_MAGIC;
+}
+
+void writeCompressedBytecode(
+    llvm::raw_ostream &OS,
+    llvm::ArrayRef<uint8_t> bytecode,
+    uint32_t coldStart,
+    uint32_t coldEnd,
+    llvm::ArrayRef<uint32_t> bodyStarts) {
+  assert(
+      coldStart <= coldEnd && coldEnd <= bytecode.size() &&
+      "Invalid compressed region");
+  uint32_t fileLength = bytecode.size();
+
+  // Start a new chunk at the first function body after each
+  // kCompressedChunkSize bytes.
+  std::vector<uint32_t> starts;
+  if (coldStart < coldEnd) {
+    starts.push_back(coldStart);
+    for (uint32_t start : bodyStarts) {
+      if (start >= coldEnd)
+        break;
+      if (start > starts.back() &&
+          start - starts.back() >= kCompressedChunkSize)
+        starts.push_back(start);
+    }
+  }
+
+  std::vector<CompressedChunk> chunks;
+  std::vector<std::string> data;
+  uint32_t dataOffset = sizeof(CompressedBytecodeHeader) + coldStart +
+      (fileLength - coldEnd) + starts.size() * sizeof(CompressedChunk);
+  for (size_t i = 0, e = starts.size(); i < e; ++i) {
+    uint32_t end = i + 1 < e ? starts[i + 1] : coldEnd;
+    size_t size = 0;
+    void *deflated = tdefl_compress_mem_to_heap(
+        bytecode.data() + starts[i],
+        end - starts[i],
+        &size,
+        TDEFL_DEFAULT_MAX_PROBES);
+    if (!deflated)
+      hermes_fatal("Failed to compress bytecode");
+    data.emplace_back(static_cast<const char *>(deflated), size);
+    mz_free(deflated);
+    chunks.push_back({starts[i], dataOffset, static_cast<uint32_t>(size)});
+    dataOffset += size;
+  }
+
+  CompressedBytecodeHeader header{COMPRESSED_MAGIC,
+                                  BYTECODE_VERSION,
+                                  dataOffset,
+                                  fileLength,
+                                  coldStart,
+                                  coldEnd,
+                                  static_cast<uint32_t>(chunks.size())};
+  OS.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  OS.write(reinterpret_cast<const char *>(bytecode.data()), coldStart);
+  OS.write(
+      reinterpret_cast<const char *>(bytecode.data()) + coldEnd,
+      fileLength - coldEnd);
+  OS.write(
+      reinterpret_cast<const char *>(chunks.data()),
+      chunks.size() * sizeof(CompressedChunk));
+  for (const auto &chunk : data)
+    OS << chunk;
+}
+
+std::pair<std::unique_ptr<DecompressedBytecodeBuffer>, std::string>
+DecompressedBytecodeBuffer::create(std::unique_ptr<const Buffer> container) {
+  auto error = [](const char *msg) {
+    return std::make_pair(
+        std::unique_ptr<DecompressedBytecodeBuffer>(), std::string(msg));
+  };
+  const uint8_t *data = container->data();
+  size_t size = container->size();
+  if (!isCompressedBytecodeStream({data, size}))
+    return error("Incorrect magic number");
+  CompressedBytecodeHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  if (header.version != BYTECODE_VERSION) {
+    return error("Wrong bytecode version");
+  }
+
+  // Check that all the parts are inside the container.
+  uint64_t tableOffset = sizeof(header) + (uint64_t)header.coldStart +
+      header.fileLength - header.coldEnd;
+  uint64_t tableEnd =
+      tableOffset + (uint64_t)header.chunkCount * sizeof(CompressedChunk);
+  if (header.coldStart > header.coldEnd ||
+      header.coldEnd > header.fileLength ||
+      header.containerLength > size || tableEnd > header.containerLength ||
+      (header.chunkCount == 0) != (header.coldStart == header.coldEnd)) {
+    return error("Malformed compressed bytecode");
+  }
+  std::vector<CompressedChunk> chunks(header.chunkCount);
+  std::memcpy(
+      chunks.data(),
+      data + tableOffset,
+      header.chunkCount * sizeof(CompressedChunk));
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    uint32_t end =
+        i + 1 < chunks.size() ? chunks[i + 1].start : header.coldEnd;
+    if (chunks[i].start >= end ||
+        (uint64_t)chunks[i].dataOffset + chunks[i].dataSize >
+            header.containerLength) {
+      return error("Malformed compressed bytecode");
+    }
+  }
+  if (!chunks.empty() && chunks[0].start != header.coldStart)
+    return error("Malformed compressed bytecode");
+
+  size_t epilogueSize = size - header.containerLength;
+  std::unique_ptr<DecompressedBytecodeBuffer> ret(
+      new DecompressedBytecodeBuffer(std::move(container)));
+  ret->storage_.reset(new uint8_t[header.fileLength + epilogueSize]);
+  uint8_t *storage = ret->storage_.get();
+  const uint8_t *src = data + sizeof(header);
+  std::memcpy(storage, src, header.coldStart);
+  src += header.coldStart;
+  std::memcpy(
+      storage + header.coldEnd, src, header.fileLength - header.coldEnd);
+  std::memcpy(
+      storage + header.fileLength,
+      data + header.containerLength,
+      epilogueSize);
+
+  ret->data_ = storage;
+  ret->size_ = header.fileLength + epilogueSize;
+  ret->chunks_ = std::move(chunks);
+  ret->decompressed_.reset(new std::once_flag[header.chunkCount]);
+  ret->coldStart_ = header.coldStart;
+  ret->coldEnd_ = header.coldEnd;
+  return {std::move(ret), ""};
+}
+
+void DecompressedBytecodeBuffer::decompressChunk(uint32_t offset) const {
+  auto it = std::upper_bound(
+      chunks_.begin(),
+      chunks_.end(),
+      offset,
+      [](uint32_t offset, const CompressedChunk &chunk) {
+        return offset < chunk.start;
+      });
+  assert(it != chunks_.begin() && "Offset before the first chunk");
+  --it;
+  std::call_once(decompressed_[it - chunks_.begin()], [this, it]() {
+    uint32_t end = it + 1 == chunks_.end() ? coldEnd_ : (it + 1)->start;
+    size_t size = tinfl_decompress_mem_to_mem(
+        storage_.get() + it->start,
+        end - it->start,
+        container_->data() + it->dataOffset,
+        it->dataSize,
+        0);
+    if (size != end - it->start)
+      hermes_fatal("Corrupt compressed bytecode");
+  });
+}
+
+} // namespace hbc
+} // namespace hermes
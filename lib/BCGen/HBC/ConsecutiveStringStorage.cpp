@@ -76,12 +76,19 @@ class StringPacker {
     /// The amount that our chars_ overlaps with prev_->chars_.
     size_t overlapAmount_ = 0;
 
-    /// Entries that may not be set as our next_, because they would introduce
-    /// a cycle.
-    llvm::DenseSet<const StringEntry *> potentialCycles_;
+    /// If we are the first or the last entry of a chain of next_ links, the
+    /// entry at the other end of the chain, or null if we are alone in it.
+    /// Not maintained for the entries in the middle of a chain.
+    StringEntry *chainEnd_ = nullptr;
 
     StringEntry(uint32_t stringID, ArrayRef<CharT> chars)
         : stringID_(stringID), chars_(chars) {}
+
+    /// \return the entry at the other end of our chain. Only valid for the
+    /// first and the last entries of a chain.
+    StringEntry *otherChainEnd() {
+      return chainEnd_ ? chainEnd_ : this;
+    }
   };
 
   /// A Trigram represents three packed characters.
@@ -154,6 +161,11 @@ class StringPacker {
     /// The list of StringEntries that have this suffix.
     std::vector<StringEntry *> entries_;
 
+    /// Index in entries_ of the first entry that may still be laid out before
+    /// another string. The ones before it already have a next_ or a parent_.
+    /// See planLayout().
+    size_t firstCandidate_ = 0;
+
     /// Convenience move constructor from a std::pair.
     /// This is used to extract SuffixArrayEntries from our uniquing map.
     SuffixArrayEntry(std::pair<HashedSuffix, std::vector<StringEntry *>> &&kv)
@@ -262,11 +274,85 @@ class StringPacker {
   /// don't track the amount of overlap here; that's stored externally.
   /// Also note overlap is directed: there is no overlap from "peasoup" to
   /// "splitpea" because no suffix of "peasoup" is a prefix of "splitpea".
+  /// The srcs are the entries of a suffix, which is shared by every Overlap
+  /// with that suffix.
   struct Overlap {
-    ArrayRef<StringEntry *> srcs_;
+    SuffixArrayEntry *srcs_;
     StringEntry *dst_;
   };
 
+  /// The two StringEntries with the lowest stringIDs that own a suffix in a
+  /// range of the suffix array, so that a string can find its parent even if
+  /// it is one of them.
+  struct ParentCandidates {
+    /// The entries, or null.
+    StringEntry *entries_[2] = {nullptr, nullptr};
+    /// The length of the suffix each entry owns in the range, to compute the
+    /// offset of the child.
+    size_t suffixSizes_[2] = {0, 0};
+
+    /// Add \p entry, which owns a suffix of \p suffixSize characters, if it
+    /// is among the two with the lowest stringIDs.
+    void add(StringEntry *entry, size_t suffixSize) {
+      if (entry == entries_[0] || entry == entries_[1])
+        return;
+      if (!entries_[0] || entry->stringID_ < entries_[0]->stringID_) {
+        entries_[1] = entries_[0];
+        suffixSizes_[1] = suffixSizes_[0];
+        entries_[0] = entry;
+        suffixSizes_[0] = suffixSize;
+      } else if (!entries_[1] || entry->stringID_ < entries_[1]->stringID_) {
+        entries_[1] = entry;
+        suffixSizes_[1] = suffixSize;
+      }
+    }
+
+    /// Add the candidates of \p other.
+    void add(const ParentCandidates &other) {
+      for (unsigned i = 0; i != 2 && other.entries_[i]; ++i)
+        add(other.entries_[i], other.suffixSizes_[i]);
+    }
+  };
+
+  /// A segment tree over the suffix array, answering which strings with the
+  /// lowest stringIDs own a suffix in a range in logarithmic time. Scanning
+  /// the range instead is quadratic, since the ranges of short strings span
+  /// most of the suffixes.
+  class ParentIndex {
+    /// The number of entries in the suffix array.
+    size_t size_;
+    /// The leaves are at [size_, 2 * size_), and every other node i merges
+    /// nodes 2 * i and 2 * i + 1.
+    std::vector<ParentCandidates> nodes_;
+
+   public:
+    explicit ParentIndex(ArrayRef<SuffixArrayEntry> suffixArray)
+        : size_(suffixArray.size()), nodes_(2 * suffixArray.size()) {
+      for (size_t i = 0; i != size_; ++i) {
+        const SuffixArrayEntry &suffix = suffixArray[i];
+        for (StringEntry *entry : suffix.entries_)
+          nodes_[size_ + i].add(entry, suffix.suffix_.size());
+      }
+      for (size_t i = size_; i-- > 1;) {
+        nodes_[i] = nodes_[2 * i];
+        nodes_[i].add(nodes_[2 * i + 1]);
+      }
+    }
+
+    /// \return the candidates of the suffixes in [begin, end).
+    ParentCandidates query(size_t begin, size_t end) const {
+      ParentCandidates result;
+      for (begin += size_, end += size_; begin < end;
+           begin /= 2, end /= 2) {
+        if (begin & 1)
+          result.add(nodes_[begin++]);
+        if (end & 1)
+          result.add(nodes_[--end]);
+      }
+      return result;
+    }
+  };
+
   /// A list of Overlaps, indexed by the amount of overlap.
   /// For example, WeightIndexedOverlaps[3] is the list of Overlaps with
   /// overlap amount 3.
@@ -278,7 +364,8 @@ class StringPacker {
   /// leftString->rightString to \p overlaps
   static void computeOverlapsAndParentForEntry(
       StringEntry *rightString,
-      ArrayRef<SuffixArrayEntry> suffixArray,
+      MutableArrayRef<SuffixArrayEntry> suffixArray,
+      const ParentIndex &parentIndex,
       WeightIndexedOverlaps *overlaps) {
     // This is a subtle function. We want to compute Overlaps, indexed by
     // overlap amount, and simultaneously identify parents. Iterate over
@@ -322,7 +409,7 @@ class StringPacker {
           if (overlaps->size() <= overlapAmount) {
             overlaps->resize(overlapAmount + 1);
           }
-          Overlap ov = {lower->entries_, rightString};
+          Overlap ov = {lower, rightString};
           (*overlaps)[overlapAmount].push_back(ov);
         }
       } else {
@@ -332,32 +419,29 @@ class StringPacker {
         // Of course it is wholly contained within itself; if it's also
         // contained within some OTHER string, we found a parent.
         // For compressibility, choose the parent with the lowest stringID.
-        for (auto cursor = lower; cursor < upper; ++cursor) {
-          for (StringEntry *parent : cursor->entries_) {
-            // Can't parent ourselves.
-            if (parent == rightString)
-              continue;
-
-            // Don't parent if we have an existing parent with a lower ID.
-            // This means that we prefer parents that tend to end up early in
-            // the string table.
-            if (rightString->parent_ &&
-                rightString->parent_->stringID_ < parent->stringID_)
-              continue;
-
-            // We found a parent.
-            // rightEntry is a prefix of one of parent's suffixes.
-            // Therefore rightEntry appears in the parent at the same offset of
-            // the suffix within the parent.
-            // A parent should always be longer than its child; otherwise we
-            // must have duplicate strings.
-            assert(
-                parent->chars_.size() > rightString->chars_.size() &&
-                "non-unique strings passed to StringPacker");
-            rightString->parent_ = parent;
-            rightString->offsetInParent_ =
-                parent->chars_.size() - cursor->suffix_.size();
-          }
+        // This means that we prefer parents that tend to end up early in the
+        // string table.
+        ParentCandidates candidates = parentIndex.query(
+            lower - suffixArray.begin(), upper - suffixArray.begin());
+        for (unsigned i = 0; i != 2 && candidates.entries_[i]; ++i) {
+          StringEntry *parent = candidates.entries_[i];
+          // Can't parent ourselves.
+          if (parent == rightString)
+            continue;
+
+          // We found a parent.
+          // rightEntry is a prefix of one of parent's suffixes.
+          // Therefore rightEntry appears in the parent at the same offset of
+          // the suffix within the parent.
+          // A parent should always be longer than its child; otherwise we
+          // must have duplicate strings.
+          assert(
+              parent->chars_.size() > rightString->chars_.size() &&
+              "non-unique strings passed to StringPacker");
+          rightString->parent_ = parent;
+          rightString->offsetInParent_ =
+              parent->chars_.size() - candidates.suffixSizes_[i];
+          break;
         }
       }
     }
@@ -368,10 +452,12 @@ class StringPacker {
   /// \p return the list of Overlaps indexed by weight (amount of overlap).
   static WeightIndexedOverlaps computeOverlapsAndParents(
       MutableArrayRef<StringEntry> stringEntries,
-      ArrayRef<SuffixArrayEntry> suffixArray) {
+      MutableArrayRef<SuffixArrayEntry> suffixArray) {
     WeightIndexedOverlaps result;
+    ParentIndex parentIndex{suffixArray};
     for (StringEntry &entry : stringEntries) {
-      computeOverlapsAndParentForEntry(&entry, suffixArray, &result);
+      computeOverlapsAndParentForEntry(
+          &entry, suffixArray, parentIndex, &result);
     }
     return result;
   }
@@ -392,8 +478,9 @@ class StringPacker {
     if (src->next_ || dst->prev_)
       return false;
 
-    // Would forming src->dst create a cycle?
-    if (src->potentialCycles_.count(dst))
+    // Would forming src->dst create a cycle? src ends a chain and dst starts
+    // one, so that is only if they are the ends of the same chain.
+    if (src->chainEnd_ == dst)
       return false;
 
     // This edge is OK!
@@ -408,6 +495,9 @@ class StringPacker {
   /// We must be careful to not produce a cycle like `a->b->c->a`.
   /// This is equivalent to computing Hamiltonian path in the graph of strings
   /// while attempting to maximize the weight of its edges.
+  /// Every suffix is shared by many Overlaps, so the srcs that can't come
+  /// before any string anymore are dropped from it as they are found, keeping
+  /// the whole plan linear in the number of suffixes.
   static void planLayout(const WeightIndexedOverlaps &overlapsByWeight) {
     size_t overlapAmount = overlapsByWeight.size();
     while (overlapAmount--) {
@@ -417,27 +507,42 @@ class StringPacker {
           // dst is already spoken for, no need to consider it further.
           continue;
         }
-        for (StringEntry *src : overlap.srcs_) {
+        std::vector<StringEntry *> &srcs = overlap.srcs_->entries_;
+        size_t &first = overlap.srcs_->firstCandidate_;
+        // The srcs rejected only because of this dst: dst itself, and the end
+        // of its chain. There are at most two.
+        StringEntry *kept[2];
+        unsigned numKept = 0;
+        size_t index = first;
+        for (size_t e = srcs.size(); index != e; ++index) {
+          StringEntry *src = srcs[index];
           if (canOverlap(src, dst)) {
             // Apply the Overlap.
             src->next_ = dst;
             dst->prev_ = src;
             dst->overlapAmount_ = overlapAmount;
 
-            // Traverse to the start and end of our new chain, and mark the fact
-            // that end->start is prohibited because it would produce a cycle.
-            StringEntry *end = dst;
-            while (end->next_)
-              end = end->next_;
-            StringEntry *start = src;
-            while (start->prev_)
-              start = start->prev_;
-            end->potentialCycles_.insert(start);
+            // Join the chains ending at src and starting at dst. Linking the
+            // end of the new chain to its start is prohibited, because it
+            // would produce a cycle.
+            StringEntry *start = src->otherChainEnd();
+            StringEntry *end = dst->otherChainEnd();
+            start->chainEnd_ = end;
+            end->chainEnd_ = start;
 
             // We picked an entry to come before dst, so we're done with dst.
+            ++index;
             break;
           }
+          if (!src->next_ && !src->parent_) {
+            assert(numKept < 2 && "too many srcs rejected");
+            kept[numKept++] = src;
+          }
         }
+        // Every src before index can be dropped, except the kept ones.
+        while (numKept)
+          srcs[--index] = kept[--numKept];
+        first = index;
       }
     }
   }
@@ -335,31 +335,57 @@ uint32_t DebugInfoGenerator::appendSourceLocations(
     const DebugSourceLocation &start,
     uint32_t functionIndex,
     llvm::ArrayRef<DebugSourceLocation> offsets) {
-  assert(validData && "DebugInfoGenerator not valid");
+  return appendSourceLocations(
+      encodeSourceLocations(start, offsets), functionIndex);
+}
 
-  // The start of the function isn't part of a statement,
-  // so require that statement = 0 for the start debug value.
-  assert(start.statement == 0 && "function must start at statement 0");
+uint32_t DebugInfoGenerator::appendSourceLocations(
+    const EncodedSourceLocations &locations,
+    uint32_t functionIndex) {
+  assert(validData && "DebugInfoGenerator not valid");
 
   const uint32_t startOffset = sourcesData_.size();
-  if (offsets.empty())
+  if (locations.empty())
     return startOffset;
 
+  const DebugSourceLocation &start = locations.start_;
   if (!files_.size() || files_.back().filenameId != start.filenameId) {
     files_.push_back(DebugFileRegion{
         startOffset, start.filenameId, start.sourceMappingUrlId});
   }
 
   appendSignedLEB128(sourcesData_, functionIndex);
-  appendSignedLEB128(sourcesData_, start.line);
-  appendSignedLEB128(sourcesData_, start.column);
+  const uint32_t dataOffset = sourcesData_.size();
+  for (auto &change : locations.fileChanges_) {
+    files_.push_back(DebugFileRegion{
+        dataOffset + change.first, change.second, start.sourceMappingUrlId});
+  }
+  sourcesData_.insert(
+      sourcesData_.end(), locations.data_.begin(), locations.data_.end());
+
+  return startOffset;
+}
+
+EncodedSourceLocations DebugInfoGenerator::encodeSourceLocations(
+    const DebugSourceLocation &start,
+    llvm::ArrayRef<DebugSourceLocation> offsets) {
+  // The start of the function isn't part of a statement,
+  // so require that statement = 0 for the start debug value.
+  assert(start.statement == 0 && "function must start at statement 0");
+
+  EncodedSourceLocations result{};
+  if (offsets.empty())
+    return result;
+
+  result.start_ = start;
+  std::vector<uint8_t> &data = result.data_;
+  appendSignedLEB128(data, start.line);
+  appendSignedLEB128(data, start.column);
   const DebugSourceLocation *previous = &start;
 
   for (auto &next : offsets) {
     if (next.filenameId != previous->filenameId) {
-      files_.push_back(DebugFileRegion{(unsigned)sourcesData_.size(),
-                                       next.filenameId,
-                                       start.sourceMappingUrlId});
+      result.fileChanges_.emplace_back(data.size(), next.filenameId);
     }
 
     int32_t adelta = delta(next.address, previous->address);
@@ -374,16 +400,17 @@ uint32_t DebugInfoGenerator::appendSourceLocations(
     // presence of statementNo.
     ldelta = (ldelta * 2) + (sdelta != 0);
 
-    appendSignedLEB128(sourcesData_, adelta);
-    appendSignedLEB128(sourcesData_, ldelta);
-    appendSignedLEB128(sourcesData_, cdelta);
+    appendSignedLEB128(data, adelta);
+    appendSignedLEB128(data, ldelta);
+    appendSignedLEB128(data, cdelta);
     if (sdelta)
-      appendSignedLEB128(sourcesData_, sdelta);
+      appendSignedLEB128(data, sdelta);
     previous = &next;
   }
-  appendSignedLEB128(sourcesData_, -1);
+  appendSignedLEB128(data, -1);
+  data.shrink_to_fit();
 
-  return startOffset;
+  return result;
 }
 
 DebugInfoGenerator::DebugInfoGenerator(UniquingFilenameTable &&filenameTable)
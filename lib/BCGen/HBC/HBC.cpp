@@ -9,11 +9,13 @@
 #include "hermes/BCGen/BCOpt.h"
 #include "hermes/BCGen/HBC/BytecodeGenerator.h"
 #include "hermes/BCGen/HBC/BytecodeStream.h"
+#include "hermes/BCGen/HBC/CompressedBytecode.h"
 #include "hermes/BCGen/HBC/ISel.h"
 #include "hermes/BCGen/HBC/Passes.h"
 #include "hermes/BCGen/HBC/Passes/FuncCallNOpts.h"
 #include "hermes/BCGen/HBC/Passes/InsertProfilePoint.h"
 #include "hermes/BCGen/HBC/Passes/LowerBuiltinCalls.h"
+#include "hermes/BCGen/HBC/Passes/LowerStringConcatChains.h"
 #include "hermes/BCGen/HBC/Passes/OptEnvironmentInit.h"
 #include "hermes/BCGen/HBC/TraverseLiteralStrings.h"
 #include "hermes/BCGen/Lowering.h"
@@ -28,6 +30,8 @@
 #include "hermes/Support/PerfSection.h"
 #include "hermes/Support/UTF8.h"
 
+#include "llvm/ADT/STLExtras.h"
+
 #define DEBUG_TYPE "hbc-backend"
 
 using namespace hermes;
@@ -47,18 +51,30 @@ const unsigned kFastRegisterAllocationThreshold = 250;
 const uint64_t kRegisterAllocationMemoryLimit = 10L * 1024 * 1024;
 
 void lowerIR(Module *M, const BytecodeGenerationOptions &options) {
+  // Environments are only elided when the chain of environments at runtime
+  // doesn't need to match the lexical nesting of the functions: the debugger
+  // and lazily compiled functions count one environment per function.
+  bool elideEmptyEnvironments = options.optimizationEnabled &&
+      M->getContext().getDebugInfoSetting() != DebugInfoSetting::ALL &&
+      llvm::none_of(*M, [](const Function &F) { return F.isLazy(); });
+
   PassManager PM;
-  PM.addPass(new LowerLoadStoreFrameInst());
+  PM.addPass(new LowerLoadStoreFrameInst(elideEmptyEnvironments));
   if (options.optimizationEnabled) {
     // OptEnvironmentInit needs to run before LowerConstants.
     PM.addPass(new OptEnvironmentInit());
   }
   /// LowerBuiltinCalls needs to run before the rest of the lowering.
   PM.addPass(new LowerBuiltinCalls());
+  if (options.optimizationEnabled) {
+    // Types are only known to be strings after type inference.
+    PM.addPass(new LowerStringConcatChains());
+  }
   // It is important to run LowerNumericProperties before LoadConstants
   // as LowerNumericProperties could generate new constants.
   PM.addPass(new LowerNumericProperties());
   PM.addPass(new LowerConstruction());
+  PM.addPass(new LowerTypeOfCompare());
   PM.addPass(new LowerArgumentsArray());
   PM.addPass(new LimitAllocArray(UINT16_MAX));
   PM.addPass(new DedupReifyArguments());
@@ -195,22 +211,41 @@ std::unique_ptr<BytecodeModule> hbc::generateBytecodeModule(
   }
 
   // Add each function to BMGen so that each function has a unique ID.
+  // The functions of the layout order get the first IDs, so that their
+  // headers, bodies and info are all next to each other in the file and
+  // untouched functions don't share pages with them. The layout order refers
+  // to the IDs the functions would otherwise have, which is their order in
+  // the module.
+  std::vector<Function *> functions;
   for (auto &F : *M) {
-    if (!shouldGenerate(&F)) {
-      continue;
+    if (shouldGenerate(&F)) {
+      functions.push_back(&F);
     }
-
-    unsigned index = BMGen.addFunction(&F);
-    if (&F == entryPoint) {
+  }
+  for (uint32_t id : options.functionLayoutOrder) {
+    // IDs which don't exist in this module come from an outdated trace and
+    // are ignored.
+    if (id < functions.size()) {
+      BMGen.addFunction(functions[id]);
+    }
+  }
+  for (Function *F : functions) {
+    unsigned index = BMGen.addFunction(F);
+    if (F == entryPoint) {
       BMGen.setEntryPointIndex(index);
     }
 
-    auto *cjsModule = M->findCJSModule(&F);
+    auto *cjsModule = M->findCJSModule(F);
     if (cjsModule) {
       if (M->getCJSModulesResolved()) {
-        BMGen.addCJSModuleStatic(cjsModule->id, index);
+        BMGen.addCJSModuleStatic(
+            cjsModule->id, index, cjsModule->dependencies);
       } else {
-        BMGen.addCJSModule(index, BMGen.getStringID(cjsModule->filename.str()));
+        BMGen.addCJSModule(
+            cjsModule->id,
+            index,
+            BMGen.getStringID(cjsModule->filename.str()),
+            cjsModule->dependencies);
       }
     }
   }
@@ -218,7 +253,18 @@ std::unique_ptr<BytecodeModule> hbc::generateBytecodeModule(
 
   // Construct the relative function scope depth map.
   FunctionScopeAnalysis scopeAnalysis{entryPoint};
-  // Bytecode generation for each function.
+  // The bodies of functions are erased once their bytecode was emitted, but
+  // the scope data of a function comes from the CreateFunctionInst in its
+  // parent, which is generated first. So compute it for all of them upfront.
+  if (!range) {
+    for (Function *F : functions)
+      scopeAnalysis.precompute(F);
+  }
+  // Bytecode generation for each function. This runs on a single thread: the
+  // lowering passes create instructions whose operands are literals shared by
+  // the whole Module, which appends to their user lists, and ISel allocates
+  // array and object buffers and filename IDs in BMGen in function order,
+  // which determines the output.
   for (auto &F : *M) {
     if (!shouldGenerate(&F)) {
       continue;
@@ -233,6 +279,8 @@ std::unique_ptr<BytecodeModule> hbc::generateBytecodeModule(
       if (!options.optimizationEnabled) {
         RA.setFastPassThreshold(kFastRegisterAllocationThreshold);
         RA.setMemoryLimit(kRegisterAllocationMemoryLimit);
+      } else {
+        RA.setShortRegisterLimit(SpillRegisters::getShortRegisterLimit());
       }
       PostOrderAnalysis PO(&F);
       /// The order of the blocks is reverse-post-order, which is a simply
@@ -268,16 +316,78 @@ std::unique_ptr<BytecodeModule> hbc::generateBytecodeModule(
 
       funcGen =
           BytecodeFunctionGenerator::create(BMGen, RA.getMaxRegisterUsage());
-      HBCISel hbciSel(&F, funcGen.get(), RA, scopeAnalysis);
+      // Keep every jump when debugging, so that stepping visits all the
+      // statements.
+      bool peephole = options.optimizationEnabled &&
+          M->getContext().getDebugInfoSetting() != DebugInfoSetting::ALL;
+      HBCISel hbciSel(&F, funcGen.get(), RA, scopeAnalysis, peephole);
       hbciSel.generate(sourceMapGen);
+
+      auto sites = options.numberSites.find(BMGen.addFunction(&F));
+      if (sites != options.numberSites.end()) {
+        funcGen->quickenInstructions(sites->second);
+      }
     }
 
     BMGen.setFunctionGenerator(&F, std::move(funcGen));
+
+    // With the scope data computed above, nothing reads the body of a
+    // function after its bytecode was emitted, so free it to bound the memory
+    // of large bundles by the largest function rather than the whole module.
+    // Segments generate the entry point every time, and lower the whole
+    // module again.
+    if (!range)
+      F.eraseBody();
   }
 
   return BMGen.generate();
 }
 
+/// Write the serialized \p bytecode of \p BM to \p OS as a compressed
+/// container. The functions of the layout order, which have the first IDs,
+/// are hot and placed first; the bodies of the others are compressed.
+static void writeCompressedColdFunctions(
+    raw_ostream &OS,
+    BytecodeModule &BM,
+    const BytecodeGenerationOptions &options,
+    llvm::ArrayRef<uint8_t> bytecode) {
+  uint32_t numFunctions = BM.getNumFunctions();
+  std::vector<bool> hot(numFunctions);
+  uint32_t hotCount = 0;
+  for (uint32_t id : options.functionLayoutOrder) {
+    if (id < numFunctions && !hot[id]) {
+      hot[id] = true;
+      ++hotCount;
+    }
+  }
+
+  // The bodies are in the order of the function IDs, except for the ones
+  // shared with an earlier identical function. The function info follows the
+  // last body, and is not compressed.
+  uint32_t hotEnd = 0;
+  uint32_t coldStart = UINT32_MAX;
+  uint32_t coldEnd = UINT32_MAX;
+  std::vector<uint32_t> bodyStarts;
+  for (uint32_t id = 0; id < numFunctions; ++id) {
+    BytecodeFunction &BF = BM.getFunction(id);
+    bodyStarts.push_back(BF.getOffset());
+    coldEnd = std::min(coldEnd, BF.getHeader().infoOffset);
+    if (id < hotCount)
+      hotEnd = std::max(hotEnd, BF.getOffset());
+  }
+  for (uint32_t id = hotCount; id < numFunctions; ++id) {
+    uint32_t offset = BM.getFunction(id).getOffset();
+    if (offset > hotEnd || hotCount == 0)
+      coldStart = std::min(coldStart, offset);
+  }
+  if (coldStart > coldEnd) {
+    // All the bodies are hot.
+    coldStart = coldEnd;
+  }
+  std::sort(bodyStarts.begin(), bodyStarts.end());
+  writeCompressedBytecode(OS, bytecode, coldStart, coldEnd, bodyStarts);
+}
+
 std::unique_ptr<BytecodeModule> hbc::generateBytecode(
     Module *M,
     raw_ostream &OS,
@@ -295,8 +405,19 @@ std::unique_ptr<BytecodeModule> hbc::generateBytecode(
       std::move(baseBCProvider));
   if (options.format == OutputFormatKind::EmitBundle) {
     assert(BM != nullptr);
-    BytecodeSerializer BS{OS, options};
-    BS.serialize(*BM, sourceHash);
+    if (options.compressColdFunctions) {
+      std::string bytecode;
+      llvm::raw_string_ostream bytecodeOS{bytecode};
+      BytecodeSerializer BS{bytecodeOS, options};
+      BS.serialize(*BM, sourceHash);
+      bytecodeOS.flush();
+      llvm::ArrayRef<uint8_t> bytes(
+          reinterpret_cast<const uint8_t *>(bytecode.data()), bytecode.size());
+      writeCompressedColdFunctions(OS, *BM, options, bytes);
+    } else {
+      BytecodeSerializer BS{OS, options};
+      BS.serialize(*BM, sourceHash);
+    }
   }
   // Now that the BytecodeFunctions know their offsets into the stream, we can
   // populate the source map.
@@ -9,11 +9,15 @@
 #include "hermes/BCGen/BCOpt.h"
 #include "hermes/BCGen/HBC/BytecodeGenerator.h"
 #include "hermes/BCGen/HBC/HBC.h"
+#include "hermes/BCGen/HBC/Passes.h"
 #include "hermes/IR/Analysis.h"
 #include "hermes/SourceMap/SourceMapGenerator.h"
 #include "hermes/Support/Statistic.h"
 
 #include "llvm/ADT/Optional.h"
+#include "llvm/ADT/SmallPtrSet.h"
+
+#include <cmath>
 
 #define DEBUG_TYPE "hbc-backend-isel"
 
@@ -35,6 +39,8 @@ STATISTIC(
 STATISTIC(
     NumCacheSlots,
     "Number of cache slots allocated for all put/get property instructions");
+STATISTIC(NumThreadedJumps, "Number of jumps threaded through empty blocks");
+STATISTIC(NumInlinedReturns, "Number of jumps replaced by a return");
 
 /// Given a list of basic blocks \p blocks linearized into the order they will
 /// be generated, \return the set of those basic blocks containing backwards
@@ -78,12 +84,62 @@ unsigned HBCISel::encodeValue(Value *value) {
   }
 }
 
+bool HBCISel::isJumpOnlyBlock(BasicBlock *BB) {
+  // The entry block and the blocks with a debugger break check emit more than
+  // their instructions.
+  if (BB == &F_->front() || debuggerBreakCheckers_.count(BB))
+    return false;
+  for (auto &I : *BB) {
+    if (!emitsNothing(&I))
+      return isa<BranchInst>(&I);
+  }
+  return false;
+}
+
+bool HBCISel::emitsNothing(Instruction *I) {
+  if (isa<PhiInst>(I) || isa<ImplicitMovInst>(I))
+    return true;
+  auto *mov = dyn_cast<MovInst>(I);
+  return mov && encodeValue(mov) == encodeValue(mov->getSingleOperand());
+}
+
+BasicBlock *HBCISel::getJumpTarget(BasicBlock *target, BasicBlock *next) {
+  if (!peephole_ || target == next)
+    return target;
+  // Bound the number of blocks followed, which also stops at cycles of empty
+  // blocks.
+  for (unsigned hops = 0; hops < 8 && isJumpOnlyBlock(target); ++hops) {
+    auto *dest = cast<BranchInst>(target->getTerminator())->getBranchDest();
+    if (dest == target)
+      break;
+    ++NumThreadedJumps;
+    target = dest;
+  }
+  return target;
+}
+
+bool HBCISel::emitReturnInsteadOfJump(BasicBlock *target, BasicBlock *next) {
+  if (!peephole_ || target == next || debuggerBreakCheckers_.count(target))
+    return false;
+  for (auto &I : *target) {
+    if (emitsNothing(&I))
+      continue;
+    auto *ret = dyn_cast<ReturnInst>(&I);
+    if (!ret)
+      return false;
+    ++NumInlinedReturns;
+    generate(ret, next);
+    return true;
+  }
+  return false;
+}
+
 void HBCISel::registerLongJump(offset_t loc, BasicBlock *target) {
   relocations_.push_back(
       {loc, Relocation::RelocationType::LongJumpType, target});
 }
 
-void HBCISel::registerSwitchImm(offset_t loc, SwitchImmInst *inst) {
+void HBCISel::registerSwitchImm(offset_t loc, TerminatorInst *inst) {
   relocations_.push_back(
       {loc, Relocation::RelocationType::JumpTableDispatch, inst});
 }
@@ -131,12 +187,18 @@ void HBCISel::resolveRelocations() {
           // Nothing, just keep track of the location.
           break;
         case Relocation::JumpTableDispatch:
-          auto &switchImmInfo = switchImmInfo_[cast<SwitchImmInst>(pointer)];
+          auto &switchImmInfo = switchImmInfo_[cast<TerminatorInst>(pointer)];
           // update default target jmp
           BasicBlock *defaultBlock = switchImmInfo.defaultTarget;
           int defaultOffset = basicBlockMap_[defaultBlock].first - loc;
           BCFGen_->updateJumpTarget(loc + 1 + 1 + 4, defaultOffset, 4);
-          switchImmInfo_[cast<SwitchImmInst>(pointer)].offset = loc;
+          // SwitchStr has the fallback target right after the default one.
+          if (BasicBlock *fallbackBlock = switchImmInfo.fallbackTarget) {
+            int fallbackOffset = basicBlockMap_[fallbackBlock].first - loc;
+            BCFGen_->updateJumpTarget(
+                loc + 1 + 1 + 4 + 4, fallbackOffset, 4);
+          }
+          switchImmInfo.offset = loc;
           break;
       }
 
@@ -165,7 +227,7 @@ void HBCISel::resolveExceptionHandlers() {
 
 void HBCISel::generateJumpTable() {
   using SwitchInfoEntry =
-      llvm::DenseMap<SwitchImmInst *, SwitchImmInfo>::iterator::value_type;
+      llvm::DenseMap<TerminatorInst *, SwitchImmInfo>::iterator::value_type;
 
   if (switchImmInfo_.empty())
     return;
@@ -187,6 +249,8 @@ void HBCISel::generateJumpTable() {
     auto entry = tuple.second;
     uint32_t startOfTable = res.size();
     for (uint32_t jmpIdx = 0; jmpIdx < entry.table.size(); jmpIdx++) {
+      if (!entry.keys.empty())
+        res.push_back(entry.keys[jmpIdx]);
       res.push_back(basicBlockMap_[entry.table[jmpIdx]].first - entry.offset);
     }
 
@@ -533,13 +597,69 @@ void HBCISel::generateBinaryOperatorInst(
       BCFGen_->emitIsIn(res, left, right);
       break;
     case OpKind::InstanceOfKind: // instanceof
-      BCFGen_->emitInstanceOf(res, left, right);
+      BCFGen_->emitInstanceOf(
+          res, left, right, acquireInstanceOfCacheIndex());
       break;
 
     default:
       break;
   }
 }
+/// Maximum depth of the search for the proof that a value is a non-negative
+/// integer.
+static constexpr unsigned kMaxIndexProofDepth = 16;
+
+/// \return true if \p V is proven to be a number which is a non-negative
+/// integer whenever it is below 2^32 - 1, so that it can be used as an array
+/// index after a single comparison. Larger values, +Infinity and the NaN of
+/// 0 * Infinity fail that comparison. The phis in \p assumed are assumed to
+/// be such numbers, which proves loop counters: a phi whose entries are
+/// non-negative integers when its own value is one is a non-negative integer.
+static bool isNonNegativeInteger(
+    Value *V,
+    llvm::SmallPtrSetImpl<PhiInst *> &assumed,
+    unsigned depth = 0) {
+  if (depth > kMaxIndexProofDepth)
+    return false;
+  if (auto *LN = dyn_cast<LiteralNumber>(V)) {
+    double d = LN->getValue();
+    return d >= 0 && d == std::trunc(d);
+  }
+  if (isa<HBCLoadConstInst>(V) || isa<MovInst>(V) || isa<AsNumberInst>(V)) {
+    return isNonNegativeInteger(
+        cast<SingleOperandInst>(V)->getSingleOperand(), assumed, depth + 1);
+  }
+  if (auto *phi = dyn_cast<PhiInst>(V)) {
+    if (!assumed.insert(phi).second)
+      return true;
+    for (unsigned i = 0, e = phi->getNumEntries(); i < e; ++i) {
+      if (!isNonNegativeInteger(phi->getEntry(i).first, assumed, depth + 1))
+        return false;
+    }
+    return true;
+  }
+  auto *BOI = dyn_cast<BinaryOperatorInst>(V);
+  if (!BOI)
+    return false;
+  switch (BOI->getOperatorKind()) {
+    case BinaryOperatorInst::OpKind::UnsignedRightShiftKind:
+      return true;
+    case BinaryOperatorInst::OpKind::AddKind:
+    case BinaryOperatorInst::OpKind::MultiplyKind:
+      return isNonNegativeInteger(BOI->getLeftHandSide(), assumed, depth + 1) &&
+          isNonNegativeInteger(BOI->getRightHandSide(), assumed, depth + 1);
+    default:
+      return false;
+  }
+}
+
+/// \return true if the property \p prop of a LoadPropertyInst or a
+/// StorePropertyInst can use the GetByValIndex or PutByValIndex opcode.
+static bool isProvenArrayIndex(Value *prop) {
+  llvm::SmallPtrSet<PhiInst *, 4> assumed;
+  return isNonNegativeInteger(prop, assumed);
+}
+
 void HBCISel::generateStorePropertyInst(
     StorePropertyInst *Inst,
     BasicBlock *next) {
@@ -560,7 +680,10 @@ void HBCISel::generateStorePropertyInst(
   }
 
   auto propReg = encodeValue(prop);
-  BCFGen_->emitPutByVal(objReg, propReg, valueReg);
+  if (isProvenArrayIndex(prop))
+    BCFGen_->emitPutByValIndex(objReg, propReg, valueReg);
+  else
+    BCFGen_->emitPutByVal(objReg, propReg, valueReg);
 }
 
 void HBCISel::generateTryStoreGlobalPropertyInst(
@@ -697,7 +820,10 @@ void HBCISel::generateLoadPropertyInst(
   }
 
   auto propReg = encodeValue(prop);
-  BCFGen_->emitGetByVal(resultReg, objReg, propReg);
+  if (isProvenArrayIndex(prop))
+    BCFGen_->emitGetByValIndex(resultReg, objReg, propReg);
+  else
+    BCFGen_->emitGetByVal(resultReg, objReg, propReg);
 }
 
 void HBCISel::generateTryLoadGlobalPropertyInst(
@@ -824,6 +950,48 @@ void HBCISel::generateHBCAllocObjectFromBufferInst(
   }
 }
 
+void HBCISel::generateHBCStoreOwnBySlotIdxInst(
+    HBCStoreOwnBySlotIdxInst *Inst,
+    BasicBlock *next) {
+  auto valueReg = encodeValue(Inst->getStoredValue());
+  auto objReg = encodeValue(Inst->getObject());
+  uint32_t slot = Inst->getSlot()->asUInt32();
+  if (Inst->getStoredValue()->getType().isNonPtr()) {
+    if (slot <= UINT8_MAX) {
+      BCFGen_->emitPutOwnNPBySlotIdx(objReg, valueReg, slot);
+    } else {
+      BCFGen_->emitPutOwnNPBySlotIdxLong(objReg, valueReg, slot);
+    }
+  } else {
+    if (slot <= UINT8_MAX) {
+      BCFGen_->emitPutOwnBySlotIdx(objReg, valueReg, slot);
+    } else {
+      BCFGen_->emitPutOwnBySlotIdxLong(objReg, valueReg, slot);
+    }
+  }
+}
+
+void HBCISel::generateHBCTypeOfIsInst(HBCTypeOfIsInst *Inst, BasicBlock *next) {
+  BCFGen_->emitTypeOfIs(
+      encodeValue(Inst),
+      encodeValue(Inst->getValue()),
+      Inst->getTypeOfIsType()->asUInt8());
+}
+
+void HBCISel::generateHBCGetTemplateObjectInst(
+    HBCGetTemplateObjectInst *Inst,
+    BasicBlock *next) {
+  SmallVector<Literal *, 8> literals{Inst->getDup()};
+  for (unsigned i = 0, e = Inst->getNumStrings(); i < e; ++i)
+    literals.push_back(Inst->getString(i));
+  auto bufIndex = BCFGen_->BMGen_.addArrayBuffer(ArrayRef<Literal *>{literals});
+  BCFGen_->emitGetTemplateObject(
+      encodeValue(Inst),
+      Inst->getTemplateObjID()->asUInt32(),
+      literals.size(),
+      bufIndex);
+}
+
 void HBCISel::generateCatchInst(CatchInst *Inst, BasicBlock *next) {
   auto loc = BCFGen_->emitCatch(encodeValue(Inst));
   relocations_.push_back({loc, Relocation::CatchType, Inst});
@@ -862,8 +1030,8 @@ void HBCISel::generateTerminatorInst(TerminatorInst *Inst, BasicBlock *next) {
   llvm_unreachable("This is not a concrete instruction");
 }
 void HBCISel::generateBranchInst(BranchInst *Inst, BasicBlock *next) {
-  auto *dst = Inst->getBranchDest();
-  if (dst == next)
+  auto *dst = getJumpTarget(Inst->getBranchDest(), next);
+  if (dst == next || emitReturnInsteadOfJump(dst, next))
     return;
 
   auto loc = BCFGen_->emitJmpLong(0);
@@ -894,7 +1062,8 @@ void HBCISel::generateSaveAndYieldInst(
     SaveAndYieldInst *Inst,
     BasicBlock *next) {
   auto result = encodeValue(Inst->getResult());
-  auto loc = BCFGen_->emitSaveGeneratorLong(0);
+  auto loc = BCFGen_->emitSaveGeneratorLong(
+      0, liveRegistersAtResume_[Inst->getNextBlock()]);
   registerLongJump(loc, Inst->getNextBlock());
   BCFGen_->emitRet(result);
 }
@@ -928,12 +1097,32 @@ void HBCISel::generateResumeGeneratorInst(
   auto isReturn = encodeValue(Inst->getIsReturn());
   BCFGen_->emitResumeGenerator(value, isReturn);
 }
+void HBCISel::generateIteratorBeginInst(
+    IteratorBeginInst *Inst,
+    BasicBlock *next) {
+  BCFGen_->emitIteratorBegin(
+      encodeValue(Inst), encodeValue(Inst->getSourceOrNext()));
+}
+void HBCISel::generateIteratorNextInst(
+    IteratorNextInst *Inst,
+    BasicBlock *next) {
+  BCFGen_->emitIteratorNext(
+      encodeValue(Inst),
+      encodeValue(Inst->getIterator()),
+      encodeValue(Inst->getSourceOrNext()));
+}
+void HBCISel::generateIteratorCloseInst(
+    IteratorCloseInst *Inst,
+    BasicBlock *next) {
+  BCFGen_->emitIteratorClose(
+      encodeValue(Inst->getIterator()), Inst->getIgnoreInnerException());
+}
 
 void HBCISel::generateCondBranchInst(CondBranchInst *Inst, BasicBlock *next) {
   auto condReg = encodeValue(Inst->getCondition());
 
-  BasicBlock *trueBlock = Inst->getTrueDest();
-  BasicBlock *falseBlock = Inst->getFalseDest();
+  BasicBlock *trueBlock = getJumpTarget(Inst->getTrueDest(), next);
+  BasicBlock *falseBlock = getJumpTarget(Inst->getFalseDest(), next);
 
   // Emit a conditional jump to the 'False' destination and a fall-through to
   // the 'True' side.
@@ -959,9 +1148,35 @@ void HBCISel::generateCondBranchInst(CondBranchInst *Inst, BasicBlock *next) {
   registerLongJump(loc, falseBlock);
 }
 
+/// \return the operand of \p Inst that is a load of the number zero which can
+/// be folded into a JStrictEqualZero or JStrictNotEqualZero superinstruction,
+/// or nullptr if there is none. The load must have no other users, since it is
+/// not emitted when folded.
+static HBCLoadConstInst *getFusableZeroOperand(CompareBranchInst *Inst) {
+  using OpKind = BinaryOperatorInst::OpKind;
+  if (Inst->getOperatorKind() != OpKind::StrictlyEqualKind &&
+      Inst->getOperatorKind() != OpKind::StrictlyNotEqualKind) {
+    return nullptr;
+  }
+  for (Value *op : {Inst->getLeftHandSide(), Inst->getRightHandSide()}) {
+    auto *load = dyn_cast<HBCLoadConstInst>(op);
+    if (!load || !load->hasOneUser())
+      continue;
+    auto *num = dyn_cast<LiteralNumber>(load->getConst());
+    if (num && num->getValue() == 0)
+      return load;
+  }
+  return nullptr;
+}
+
 void HBCISel::generateCompareBranchInst(
     CompareBranchInst *Inst,
     BasicBlock *next) {
+  if (auto *zero = getFusableZeroOperand(Inst)) {
+    generateCompareZeroBranch(Inst, zero, next);
+    return;
+  }
+
   auto left = encodeValue(Inst->getLeftHandSide());
   auto right = encodeValue(Inst->getRightHandSide());
   auto res = encodeValue(Inst);
@@ -969,8 +1184,8 @@ void HBCISel::generateCompareBranchInst(
   bool isBothNumber = Inst->getLeftHandSide()->getType().isNumberType() &&
       Inst->getRightHandSide()->getType().isNumberType();
 
-  BasicBlock *trueBlock = Inst->getTrueDest();
-  BasicBlock *falseBlock = Inst->getFalseDest();
+  BasicBlock *trueBlock = getJumpTarget(Inst->getTrueDest(), next);
+  BasicBlock *falseBlock = getJumpTarget(Inst->getFalseDest(), next);
 
   bool invert = false;
 
@@ -1050,6 +1265,40 @@ void HBCISel::generateCompareBranchInst(
   loc = BCFGen_->emitJmpLong(res);
   registerLongJump(loc, falseBlock);
 }
+
+void HBCISel::generateCompareZeroBranch(
+    CompareBranchInst *Inst,
+    HBCLoadConstInst *zero,
+    BasicBlock *next) {
+  Value *other = Inst->getLeftHandSide() == zero ? Inst->getRightHandSide()
+                                                 : Inst->getLeftHandSide();
+  auto val = encodeValue(other);
+  auto res = encodeValue(Inst);
+
+  BasicBlock *trueBlock = getJumpTarget(Inst->getTrueDest(), next);
+  BasicBlock *falseBlock = getJumpTarget(Inst->getFalseDest(), next);
+
+  // Jump to trueBlock when the value is equal to zero, unless we invert the
+  // condition to fall through to the "true" case.
+  bool jumpIfEqual = Inst->getOperatorKind() ==
+      BinaryOperatorInst::OpKind::StrictlyEqualKind;
+  if (next == trueBlock) {
+    jumpIfEqual = !jumpIfEqual;
+    std::swap(trueBlock, falseBlock);
+  }
+
+  offset_t loc = jumpIfEqual ? BCFGen_->emitJStrictEqualZeroLong(res, val)
+                             : BCFGen_->emitJStrictNotEqualZeroLong(res, val);
+  registerLongJump(loc, trueBlock);
+
+  if (next == falseBlock) {
+    return;
+  }
+
+  loc = BCFGen_->emitJmpLong(res);
+  registerLongJump(loc, falseBlock);
+}
+
 void HBCISel::generateGetPNamesInst(GetPNamesInst *Inst, BasicBlock *next) {
   auto itrReg = encodeValue(Inst->getIterator());
   BCFGen_->emitGetPNameList(
@@ -1223,8 +1472,13 @@ void HBCISel::generateHBCResolveEnvironment(
       curScopeDepth && curScopeDepth.getValue() >= instScopeDepth.getValue() &&
       "Cannot access variables in inner scopes");
   int32_t delta = curScopeDepth.getValue() - instScopeDepth.getValue();
-  assert(delta > 0 && "HBCResolveEnvironment for current scope");
-  BCFGen_->emitGetEnvironment(encodeValue(Inst), delta - 1);
+  // The environment of the closure is the parent of the environment created
+  // by the function, or the one the function uses if it creates none.
+  if (scopeAnalysis_.hasOwnEnvironment(F_)) {
+    assert(delta > 0 && "HBCResolveEnvironment for current scope");
+    --delta;
+  }
+  BCFGen_->emitGetEnvironment(encodeValue(Inst), delta);
 }
 void HBCISel::generateHBCStoreToEnvironmentInst(
     HBCStoreToEnvironmentInst *Inst,
@@ -1386,6 +1640,16 @@ void HBCISel::generateHBCReifyArgumentsInst(
   auto reg = encodeValue(Inst->getLazyRegister());
   BCFGen_->emitReifyArguments(reg);
 }
+void HBCISel::generateHBCApplyArgumentsInst(
+    hermes::HBCApplyArgumentsInst *Inst,
+    hermes::BasicBlock *next) {
+  auto output = encodeValue(Inst);
+  auto callee = encodeValue(Inst->getCallee());
+  auto function = encodeValue(Inst->getFunction());
+  auto thisArg = encodeValue(Inst->getThisArg());
+  auto reg = encodeValue(Inst->getLazyRegister());
+  BCFGen_->emitApplyArguments(output, callee, function, thisArg, reg);
+}
 void HBCISel::generateHBCCreateThisInst(
     HBCCreateThisInst *Inst,
     BasicBlock *next) {
@@ -1457,6 +1721,36 @@ void HBCISel::generateSwitchImmInst(
   switchImmInfo_[Inst] = {0, Inst->getDefaultDestination(), jmpTable};
 }
 
+void HBCISel::generateSwitchStrInst(
+    hermes::SwitchStrInst *Inst,
+    hermes::BasicBlock *next) {
+  uint32_t size = Inst->getTableSize();
+
+  SwitchImmInfo info{0, Inst->getDefaultDestination(), {}};
+  info.table.resize(size, Inst->getDefaultDestination());
+  info.keys.resize(size, SWITCH_STR_EMPTY_ENTRY);
+  info.fallbackTarget = Inst->getFallbackDestination();
+
+  // Place every case at the entry of its hash, which the lowering has made
+  // distinct.
+  for (uint32_t caseIdx = 0; caseIdx < Inst->getNumCasePair(); caseIdx++) {
+    auto casePair = Inst->getCasePair(caseIdx);
+    uint32_t idx = hashStringLiteral(casePair.first->getValue().str()) &
+        (size - 1);
+    assert(
+        info.keys[idx] == SWITCH_STR_EMPTY_ENTRY &&
+        "cases must have distinct entries");
+    info.keys[idx] = BCFGen_->getIdentifierID(casePair.first);
+    info.table[idx] = casePair.second;
+  }
+
+  registerSwitchImm(
+      BCFGen_->emitSwitchStr(
+          encodeValue(Inst->getInputValue()), 0, 0, 0, size),
+      Inst);
+  switchImmInfo_[Inst] = std::move(info);
+}
+
 void HBCISel::initialize() {
   IRBuilder builder(F_->getParent());
   if (F_->isGlobalScope()) {
@@ -1471,6 +1765,14 @@ void HBCISel::initialize() {
   }
 }
 
+bool HBCISel::isFusedIntoCompareBranch(Instruction *I) {
+  auto *load = dyn_cast<HBCLoadConstInst>(I);
+  if (!load || !load->hasOneUser())
+    return false;
+  auto *branch = dyn_cast<CompareBranchInst>(load->getUsers()[0]);
+  return branch && getFusableZeroOperand(branch) == load;
+}
+
 void HBCISel::generate(BasicBlock *BB, BasicBlock *next) {
   // Register the address of the current basic block.
   auto begin_loc = BCFGen_->getCurrentLocation();
@@ -1494,6 +1796,9 @@ void HBCISel::generate(BasicBlock *BB, BasicBlock *next) {
     if (&I == debugBreakCheckLoc) {
       BCFGen_->emitDebuggerCheckBreak();
     }
+    if (isFusedIntoCompareBranch(&I)) {
+      continue;
+    }
     generate(&I, next);
   }
   auto end_loc = BCFGen_->getCurrentLocation();
@@ -1541,6 +1846,94 @@ void HBCISel::generate(Instruction *ii, BasicBlock *next) {
   }
 }
 
+void HBCISel::computeLiveRegistersAtResume(ArrayRef<BasicBlock *> order) {
+  llvm::SmallVector<BasicBlock *, 4> resumeBlocks;
+  llvm::SmallVector<BasicBlock *, 4> catchBlocks;
+  for (BasicBlock *BB : order) {
+    if (auto *SAY = dyn_cast<SaveAndYieldInst>(BB->getTerminator()))
+      resumeBlocks.push_back(SAY->getNextBlock());
+    if (isa<CatchInst>(&*BB->begin()))
+      catchBlocks.push_back(BB);
+  }
+  if (resumeBlocks.empty())
+    return;
+
+  /// The registers read before being written in a block, the registers written
+  /// in it, and the registers live on entry to it.
+  struct BlockLiveness {
+    BitVector gen;
+    BitVector kill;
+    BitVector liveIn;
+  };
+  const unsigned numRegs = RA_.getMaxRegisterUsage();
+  DenseMap<BasicBlock *, BlockLiveness> liveness;
+
+  for (BasicBlock *BB : order) {
+    BlockLiveness &L = liveness[BB];
+    L.gen.resize(numRegs);
+    L.kill.resize(numRegs);
+    for (auto it = BB->rbegin(), e = BB->rend(); it != e; ++it) {
+      Instruction *I = &*it;
+      // Phis emit nothing: the incoming values are moved into the register of
+      // the phi at the end of each predecessor.
+      if (isa<PhiInst>(I))
+        continue;
+      if (RA_.isAllocated(I)) {
+        unsigned reg = RA_.getRegister(I).getIndex();
+        L.gen.reset(reg);
+        L.kill.set(reg);
+      }
+      for (unsigned i = 0, e = I->getNumOperands(); i < e; ++i) {
+        Value *op = I->getOperand(i);
+        if (!RA_.isAllocated(op))
+          continue;
+        unsigned reg = RA_.getRegister(op).getIndex();
+        // ResumeGenerator only writes its isReturn operand.
+        if (isa<ResumeGeneratorInst>(I)) {
+          L.gen.reset(reg);
+          L.kill.set(reg);
+        } else {
+          L.gen.set(reg);
+        }
+      }
+    }
+    L.liveIn = L.gen;
+  }
+
+  // Iterate to a fixed point, visiting the blocks in post-order so that most
+  // successors are visited before their predecessors. An exception can reach a
+  // catch handler from the middle of any block, so the registers live on entry
+  // to a handler are conservatively kept live on entry to every block.
+  BitVector catchLive(numRegs);
+  bool changed;
+  do {
+    changed = false;
+    for (BasicBlock *BB : catchBlocks)
+      catchLive |= liveness[BB].liveIn;
+    for (auto it = order.rbegin(), e = order.rend(); it != e; ++it) {
+      BlockLiveness &L = liveness[*it];
+      BitVector live(numRegs);
+      for (BasicBlock *succ : successors(*it))
+        live |= liveness[succ].liveIn;
+      live.reset(L.kill);
+      live |= L.gen;
+      live |= catchLive;
+      if (live != L.liveIn) {
+        L.liveIn = std::move(live);
+        changed = true;
+      }
+    }
+  } while (changed);
+
+  for (BasicBlock *BB : resumeBlocks) {
+    const BitVector &live = liveness[BB].liveIn;
+    unsigned count = 0;
+    for (int reg = live.find_first(); reg != -1; reg = live.find_next(reg))
+      count = reg + 1;
+    liveRegistersAtResume_[BB] = count;
+  }
+}
+
 void HBCISel::generate(SourceMapGenerator *outSourceMap) {
   PostOrderAnalysis PO(F_);
 
@@ -1556,6 +1949,8 @@ void HBCISel::generate(SourceMapGenerator *outSourceMap) {
     debuggerBreakCheckers_.insert(order.front());
   }
 
+  computeLiveRegistersAtResume(order);
+
   for (int i = 0, e = order.size(); i < e; ++i) {
     BasicBlock *BB = order[i];
     BasicBlock *next = ((i + 1) == e) ? nullptr : order[i + 1];
@@ -1594,6 +1989,18 @@ uint8_t HBCISel::acquirePropertyReadCacheIndex(unsigned id) {
   return idx;
 }
 
+uint8_t HBCISel::acquireInstanceOfCacheIndex() {
+  if (LLVM_UNLIKELY(
+          lastPropertyReadCacheIndex_ == std::numeric_limits<uint8_t>::max())) {
+    ++NumUncachedNodes;
+    return PROPERTY_CACHING_DISABLED;
+  }
+
+  ++NumCachedNodes;
+  ++NumCacheSlots;
+  return ++lastPropertyReadCacheIndex_;
+}
+
 uint8_t HBCISel::acquirePropertyWriteCacheIndex(unsigned id) {
   const bool reuse = F_->getContext().getOptimizationSettings().reusePropCache;
   // Zero is reserved for indicating no-cache, so cannot be a value in the map.
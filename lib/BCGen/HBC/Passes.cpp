@@ -13,8 +13,14 @@
 #include "hermes/BCGen/HBC/HBC.h"
 #include "hermes/BCGen/HBC/ISel.h"
 #include "hermes/BCGen/Lowering.h"
+#include "hermes/Inst/Inst.h"
+#include "hermes/Support/HashString.h"
+#include "hermes/Support/UTF8.h"
 
+#include "llvm/ADT/BitVector.h"
 #include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/Support/MathExtras.h"
 
 #define DEBUG_TYPE "hbc-backend"
 
@@ -99,6 +105,18 @@ bool LoadConstants::operandMustBeLiteral(Instruction *Inst, unsigned opIndex) {
   if (isa<HBCAllocObjectFromBufferInst>(Inst))
     return true;
 
+  // The slot of HBCStoreOwnBySlotIdxInst is an immediate.
+  if (isa<HBCStoreOwnBySlotIdxInst>(Inst))
+    return opIndex == HBCStoreOwnBySlotIdxInst::SlotIdx;
+
+  // The type of HBCTypeOfIsInst is an immediate.
+  if (isa<HBCTypeOfIsInst>(Inst))
+    return opIndex == HBCTypeOfIsInst::TypeIdx;
+
+  // All operands of HBCGetTemplateObjectInst are serialized into a buffer.
+  if (isa<HBCGetTemplateObjectInst>(Inst))
+    return true;
+
   // All operands of AllocArrayInst are literals.
   if (isa<AllocArrayInst>(Inst))
     return true;
@@ -175,12 +193,21 @@ bool LoadConstants::operandMustBeLiteral(Instruction *Inst, unsigned opIndex) {
   if (isa<CreateRegExpInst>(Inst))
     return true;
 
+  if (isa<SwitchStrInst>(Inst) &&
+      (opIndex == SwitchStrInst::TableSizeIdx ||
+       opIndex >= SwitchStrInst::FirstCaseIdx))
+    return true;
   if (isa<SwitchImmInst>(Inst) &&
       (opIndex == SwitchImmInst::MinValueIdx ||
        opIndex == SwitchImmInst::SizeIdx ||
        opIndex >= SwitchImmInst::FirstCaseIdx))
     return true;
 
+  // IteratorCloseInst's ignoreInnerException is a boolean constant.
+  if (isa<IteratorCloseInst>(Inst) &&
+      opIndex == IteratorCloseInst::IgnoreInnerExceptionIdx)
+    return true;
+
   /// CallBuiltin's callee and "this" should always be literals.
   if (isa<HBCCallBuiltinInst>(Inst) &&
       (opIndex == HBCCallBuiltinInst::CalleeIdx ||
@@ -286,10 +313,24 @@ Instruction *LowerLoadStoreFrameInst::getScope(
     // This will not cause performance issue as long as optimization
     // is enabled, because every variable will be moved to stack
     // if not being captured.
+    assert(captureScope && "Variable in a function without environment");
     return captureScope;
   }
 }
 
+bool LowerLoadStoreFrameInst::canElideEnvironment(Function *F) const {
+  if (!elideEmptyEnvironments_)
+    return false;
+  // The depth of the top level function and of CommonJS modules is fixed, so
+  // they always create an environment.
+  Module *M = F->getParent();
+  if (F == M->getTopLevelFunction() || M->findCJSModule(F))
+    return false;
+  // Any variable left after optimization is captured by a closure and must
+  // live in an environment.
+  return F->getFunctionScope()->getVariables().empty();
+}
+
 bool LowerLoadStoreFrameInst::runOnFunction(Function *F) {
   IRBuilder builder(F);
   bool changed = false;
@@ -299,13 +340,18 @@ bool LowerLoadStoreFrameInst::runOnFunction(Function *F) {
   // All local captured variables will be stored in this scope (or
   // "environment").
   // It will also be used by all closures created in this function, even if
-  // there are no captured variables in this function.
-  // Closures need a new environment even without captured variables because
-  // we currently use only the lexical nesting level to determine which parent
-  // environment to use - we don't account for the case when an environment may
-  // not be needed somewhere along the chain.
-  HBCCreateEnvironmentInst *captureScope =
-      builder.createHBCCreateEnvironmentInst();
+  // there are no captured variables in this function, unless the environment
+  // can be elided. In that case the closures are created with the environment
+  // of the function itself, and FunctionScopeAnalysis gives the scope of the
+  // function the same depth as the scope of its lexical parent.
+  HBCCreateEnvironmentInst *captureScope = canElideEnvironment(F)
+      ? nullptr
+      : builder.createHBCCreateEnvironmentInst();
+  auto getClosureScope = [&]() -> Value * {
+    if (captureScope)
+      return captureScope;
+    return builder.createHBCResolveEnvironment(F->getFunctionScope());
+  };
 
   for (BasicBlock &BB : F->getBasicBlockList()) {
     for (auto I = BB.begin(), E = BB.end(); I != E; /* nothing */) {
@@ -348,7 +394,7 @@ bool LowerLoadStoreFrameInst::runOnFunction(Function *F) {
 
           builder.setInsertionPoint(Inst);
           auto *newInst = builder.createHBCCreateFunctionInst(
-              CFI->getFunctionCode(), captureScope);
+              CFI->getFunctionCode(), getClosureScope());
 
           Inst->replaceAllUsesWith(newInst);
           Inst->eraseFromParent();
@@ -360,7 +406,7 @@ bool LowerLoadStoreFrameInst::runOnFunction(Function *F) {
 
           builder.setInsertionPoint(Inst);
           auto *newInst = builder.createHBCCreateGeneratorInst(
-              CFI->getFunctionCode(), captureScope);
+              CFI->getFunctionCode(), getClosureScope());
 
           Inst->replaceAllUsesWith(newInst);
           Inst->eraseFromParent();
@@ -385,6 +431,26 @@ CreateArgumentsInst *LowerArgumentsArray::getCreateArgumentsInst(Function *F) {
   return nullptr;
 }
 
+/// \return true if \p call is `f.apply(thisArg, arguments)`, where `arguments`
+/// is \p createArguments, and it isn't passed to the call in any other way.
+static bool isApplyOfArguments(
+    CallInst *call,
+    CreateArgumentsInst *createArguments) {
+  if (call->getKind() != ValueKind::CallInstKind ||
+      call->getNumArguments() != 3 ||
+      call->getArgument(2) != createArguments ||
+      call->getArgument(1) == createArguments ||
+      call->getThis() == createArguments) {
+    return false;
+  }
+  auto *load = dyn_cast<LoadPropertyInst>(call->getCallee());
+  if (!load || load->getObject() != call->getThis()) {
+    return false;
+  }
+  auto *propertyString = dyn_cast<LiteralString>(load->getProperty());
+  return propertyString && propertyString->getValue().str() == "apply";
+}
+
 bool LowerArgumentsArray::runOnFunction(Function *F) {
   IRBuilder builder(F);
   updateToEntryInsertionPoint(builder, F);
@@ -427,6 +493,23 @@ bool LowerArgumentsArray::runOnFunction(Function *F) {
     }
   }
 
+  // Forward `arguments` to `f.apply(thisArg, arguments)`, which only reifies
+  // it at runtime if `apply` turns out not to be Function.prototype.apply.
+  uniqueUsers.clear();
+  uniqueUsers.insert(
+      createArguments->getUsers().begin(), createArguments->getUsers().end());
+  for (Value *user : uniqueUsers) {
+    auto *call = dyn_cast<CallInst>(user);
+    if (call && isApplyOfArguments(call, createArguments)) {
+      builder.setInsertionPoint(call);
+      builder.setLocation(call->getLocation());
+      auto *apply = builder.createHBCApplyArgumentsInst(
+          call->getCallee(), call->getThis(), call->getArgument(1), lazyReg);
+      call->replaceAllUsesWith(apply);
+      call->eraseFromParent();
+    }
+  }
+
   uniqueUsers.clear();
   uniqueUsers.insert(
       createArguments->getUsers().begin(), createArguments->getUsers().end());
@@ -556,6 +639,68 @@ bool LowerConstruction::runOnFunction(Function *F) {
   return true;
 }
 
+bool LowerTypeOfCompare::runOnFunction(Function *F) {
+  IRBuilder builder(F);
+  bool changed = false;
+  using OpKind = BinaryOperatorInst::OpKind;
+
+  for (BasicBlock &BB : F->getBasicBlockList()) {
+    IRBuilder::InstructionDestroyer destroyer;
+    for (Instruction &I : BB) {
+      auto *cmp = dyn_cast<BinaryOperatorInst>(&I);
+      if (!cmp)
+        continue;
+      OpKind kind = cmp->getOperatorKind();
+      // Both operands are strings, so loose and strict equality agree.
+      bool negate = kind == OpKind::StrictlyNotEqualKind ||
+          kind == OpKind::NotEqualKind;
+      if (!negate && kind != OpKind::StrictlyEqualKind &&
+          kind != OpKind::EqualKind)
+        continue;
+
+      auto *typeOf = dyn_cast<UnaryOperatorInst>(cmp->getLeftHandSide());
+      auto *name = dyn_cast<LiteralString>(cmp->getRightHandSide());
+      if (!typeOf) {
+        typeOf = dyn_cast<UnaryOperatorInst>(cmp->getRightHandSide());
+        name = dyn_cast<LiteralString>(cmp->getLeftHandSide());
+      }
+      if (!typeOf || !name ||
+          typeOf->getOperatorKind() != UnaryOperatorInst::OpKind::TypeofKind)
+        continue;
+      inst::TypeOfIsType type =
+          inst::typeOfIsTypeFromName(name->getValue().str());
+      if (type == inst::TypeOfIsType::_last)
+        continue;
+
+      builder.setInsertionPoint(cmp);
+      builder.setLocation(cmp->getLocation());
+      Value *result = builder.createHBCTypeOfIsInst(
+          typeOf->getSingleOperand(), static_cast<uint8_t>(type));
+      auto *branch = cmp->hasOneUser()
+          ? dyn_cast<CondBranchInst>(cmp->getUsers()[0])
+          : nullptr;
+      if (negate && branch) {
+        // Swap the destinations rather than negating the test.
+        builder.setInsertionPoint(branch);
+        builder.setLocation(branch->getLocation());
+        builder.createCondBranchInst(
+            result, branch->getFalseDest(), branch->getTrueDest());
+        destroyer.add(branch);
+      } else if (negate) {
+        result = builder.createUnaryOperatorInst(
+            result, UnaryOperatorInst::OpKind::BangKind);
+      }
+      cmp->replaceAllUsesWith(result);
+      destroyer.add(cmp);
+      // The typeof itself is usually only used by the comparison.
+      if (typeOf->getNumUsers() == 1)
+        destroyer.add(typeOf);
+      changed = true;
+    }
+  }
+  return changed;
+}
+
 bool LowerCalls::runOnFunction(Function *F) {
   IRBuilder builder(F);
   bool changed = false;
@@ -864,6 +1009,10 @@ bool LowerSwitchIntoJumpTables::lowerIntoJumpTable(SwitchInst *switchInst) {
   if (isa<Literal>(switchInst->getInputValue())) {
     return false;
   }
+  if (switchInst->getNumCasePair() &&
+      isa<LiteralString>(switchInst->getCasePair(0).first)) {
+    return lowerIntoStringTable(switchInst);
+  }
   IRBuilder builder(switchInst->getParent()->getParent());
   unsigned numCases = switchInst->getNumCasePair();
   uint32_t minValue = 0;
@@ -924,5 +1073,102 @@ bool LowerSwitchIntoJumpTables::lowerIntoJumpTable(SwitchInst *switchInst) {
   return true;
 }
 
+uint32_t hashStringLiteral(llvm::StringRef str) {
+  // hashString() gives the same hash for ASCII and UTF-16 strings with the same
+  // characters.
+  llvm::SmallVector<char16_t, 32> ustr{};
+  convertUTF8WithSurrogatesToUTF16(
+      std::back_inserter(ustr), str.begin(), str.end());
+  return hermes::hashString(llvm::ArrayRef<char16_t>(ustr));
+}
+
+bool LowerSwitchIntoJumpTables::lowerIntoStringTable(SwitchInst *switchInst) {
+  // A few comparisons are as fast as a lookup.
+  unsigned numCases = switchInst->getNumCasePair();
+  if (numCases < 4)
+    return false;
+
+  SwitchInst::ValueListType literals;
+  SwitchStrInst::ValueListType values;
+  SwitchStrInst::BasicBlockListType blocks;
+  llvm::SmallVector<uint32_t, 8> hashes;
+  for (unsigned i = 0; i != numCases; ++i) {
+    auto casePair = switchInst->getCasePair(i);
+    auto *str = dyn_cast<LiteralString>(casePair.first);
+    if (!str)
+      return false;
+    literals.push_back(str);
+    values.push_back(str);
+    blocks.push_back(casePair.second);
+    hashes.push_back(hashStringLiteral(str->getValue().str()));
+  }
+
+  // Find the smallest table in which every case has its own entry. Give up if
+  // the table would be mostly empty, which includes cases with equal hashes.
+  uint32_t tableSize = llvm::PowerOf2Ceil(numCases);
+  for (;; tableSize *= 2) {
+    if (tableSize > numCases * 8)
+      return false;
+    llvm::BitVector used(tableSize);
+    bool collision = false;
+    for (uint32_t hash : hashes) {
+      uint32_t idx = hash & (tableSize - 1);
+      if (used.test(idx)) {
+        collision = true;
+        break;
+      }
+      used.set(idx);
+    }
+    if (!collision)
+      break;
+  }
+
+  BasicBlock *switchBlock = switchInst->getParent();
+  Function *F = switchBlock->getParent();
+  IRBuilder builder(F);
+  builder.setLocation(switchInst->getLocation());
+
+  // Strings which are not interned go through a copy of the original switch,
+  // which is lowered into comparisons later.
+  BasicBlock *fallback = builder.createBasicBlock(F);
+  builder.setInsertionBlock(fallback);
+  builder.createSwitchInst(
+      switchInst->getInputValue(),
+      switchInst->getDefaultDestination(),
+      literals,
+      blocks);
+
+  // The successors now have the fallback block as another predecessor.
+  llvm::SmallPtrSet<BasicBlock *, 8> successors{blocks.begin(), blocks.end()};
+  successors.insert(switchInst->getDefaultDestination());
+  for (BasicBlock *succ : successors) {
+    for (auto &inst : *succ) {
+      auto *phi = dyn_cast<PhiInst>(&inst);
+      if (!phi)
+        break;
+      for (unsigned i = 0, e = phi->getNumEntries(); i != e; ++i) {
+        auto entry = phi->getEntry(i);
+        if (entry.second == switchBlock) {
+          phi->addEntry(entry.first, fallback);
+          break;
+        }
+      }
+    }
+  }
+
+  builder.setInsertionPoint(switchInst);
+  auto *switchStrInst = builder.createSwitchStrInst(
+      switchInst->getInputValue(),
+      switchInst->getDefaultDestination(),
+      fallback,
+      builder.getLiteralNumber(tableSize),
+      values,
+      blocks);
+
+  switchInst->replaceAllUsesWith(switchStrInst);
+  switchInst->eraseFromParent();
+  return true;
+}
+
 } // namespace hbc
 } // namespace hermes
@@ -86,6 +86,20 @@ hermes::OptValue<int> LowerBuiltinCallsContext::findBuiltinMethod(
   return methIt->second;
 }
 
+/// \return whether a call to HermesInternal.getTemplateObject() with \p args
+/// can be lowered to HBCGetTemplateObjectInst, which needs all of them to be
+/// literals that fit in the instruction.
+static bool canUseGetTemplateObject(llvm::ArrayRef<Value *> args) {
+  if (args.size() < 3 || args.size() - 1 > UINT16_MAX)
+    return false;
+  auto *id = dyn_cast<LiteralNumber>(args[0]);
+  if (!id || !id->isUInt32Representible() || !isa<LiteralBool>(args[1]))
+    return false;
+  return llvm::all_of(args.drop_front(2), [](Value *arg) {
+    return isa<LiteralString>(arg);
+  });
+}
+
 static bool run(Function *F) {
   IRBuilder builder{F};
   bool changed = false;
@@ -159,8 +173,23 @@ static bool run(Function *F) {
       for (unsigned i = 0; i < numArgsExcludingThis; ++i)
         args.push_back(callInst->getArgument(i + 1));
 
-      auto *callBuiltin = builder.createHBCCallBuiltinInst(*builtinIndex, args);
-      callInst->replaceAllUsesWith(callBuiltin);
+      Instruction *lowered;
+      if (*builtinIndex ==
+              inst::BuiltinMethod::HermesInternal_getTemplateObject &&
+          canUseGetTemplateObject(args)) {
+        // Tagged templates get their template object from a per-module
+        // cache, without loading the strings or calling the builtin.
+        llvm::SmallVector<LiteralString *, 8> strings{};
+        for (unsigned i = 2, e = args.size(); i < e; ++i)
+          strings.push_back(cast<LiteralString>(args[i]));
+        lowered = builder.createHBCGetTemplateObjectInst(
+            cast<LiteralNumber>(args[0])->asUInt32(),
+            cast<LiteralBool>(args[1])->getValue(),
+            strings);
+      } else {
+        lowered = builder.createHBCCallBuiltinInst(*builtinIndex, args);
+      }
+      callInst->replaceAllUsesWith(lowered);
       callInst->eraseFromParent();
 
       // The property access instructions are not normally optimizable since
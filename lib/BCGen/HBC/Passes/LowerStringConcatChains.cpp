@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/BCGen/HBC/Passes/LowerStringConcatChains.h"
+
+#include "hermes/IR/IRBuilder.h"
+#include "hermes/Inst/Builtins.h"
+#include "hermes/Support/Statistic.h"
+
+#include "llvm/ADT/SmallVector.h"
+
+#define DEBUG_TYPE "LowerStringConcatChains"
+
+STATISTIC(NumChains, "Number of string concatenation chains lowered");
+STATISTIC(NumAddsRemoved, "Number of string additions removed");
+
+using llvm::dyn_cast;
+
+namespace hermes {
+namespace hbc {
+
+namespace {
+
+/// \return \p V as an addition which is known to concatenate strings, because
+/// one of its operands is a string, or nullptr.
+BinaryOperatorInst *asStringAdd(Value *V) {
+  auto *add = dyn_cast<BinaryOperatorInst>(V);
+  if (!add || add->getOperatorKind() != BinaryOperatorInst::OpKind::AddKind)
+    return nullptr;
+  if (!add->getLeftHandSide()->getType().isStringType() &&
+      !add->getRightHandSide()->getType().isStringType())
+    return nullptr;
+  return add;
+}
+
+/// \return whether the string addition \p inner can be folded into \p user,
+/// i.e. its result is only used as the left operand of \p user.
+bool foldsInto(BinaryOperatorInst *inner, Instruction *user) {
+  auto *outer = asStringAdd(user);
+  return outer && inner->hasOneUser() && outer->getLeftHandSide() == inner &&
+      outer->getRightHandSide() != inner &&
+      outer->getParent() == inner->getParent();
+}
+
+} // namespace
+
+bool LowerStringConcatChains::runOnFunction(Function *F) {
+  IRBuilder builder{F};
+  // Leave room for the "this" argument of the call.
+  constexpr unsigned kMaxParts = HBCCallBuiltinInst::MAX_ARGUMENTS - 1;
+
+  // Find the last addition of each chain of at least two.
+  llvm::SmallVector<BinaryOperatorInst *, 8> chainEnds{};
+  for (auto &BB : *F) {
+    for (auto &I : BB) {
+      auto *add = asStringAdd(&I);
+      if (!add)
+        continue;
+      if (add->hasOneUser() && foldsInto(add, add->getUsers()[0]))
+        continue;
+      auto *inner = asStringAdd(add->getLeftHandSide());
+      if (inner && foldsInto(inner, add))
+        chainEnds.push_back(add);
+    }
+  }
+
+  for (BinaryOperatorInst *end : chainEnds) {
+    // Collect the additions from the end of the chain back to its start.
+    llvm::SmallVector<BinaryOperatorInst *, 8> adds{end};
+    for (;;) {
+      auto *inner = asStringAdd(adds.back()->getLeftHandSide());
+      if (!inner || !foldsInto(inner, adds.back()) ||
+          adds.size() + 2 > kMaxParts)
+        break;
+      adds.push_back(inner);
+    }
+
+    // Operands which may be objects are converted where their addition was,
+    // so that valueOf() and toString() still run in order and interleaved
+    // with the rest of the code. Converting the primitive operands can't be
+    // observed, so only the RangeError for a too long string may move to the
+    // end of the chain.
+    llvm::SmallVector<Value *, 8> parts{};
+    auto addPart = [&builder, &parts](BinaryOperatorInst *add, Value *part) {
+      if (!part->getType().isPrimitive()) {
+        builder.setInsertionPoint(add);
+        builder.setLocation(add->getLocation());
+        auto *str = builder.createAddEmptyStringInst(part);
+        str->setType(Type::createString());
+        part = str;
+      }
+      parts.push_back(part);
+    };
+    BinaryOperatorInst *first = adds.back();
+    addPart(first, first->getLeftHandSide());
+    for (auto it = adds.rbegin(), e = adds.rend(); it != e; ++it)
+      addPart(*it, (*it)->getRightHandSide());
+
+    builder.setInsertionPoint(end);
+    builder.setLocation(end->getLocation());
+    auto *call = builder.createHBCCallBuiltinInst(
+        inst::BuiltinMethod::HermesInternal_concatStrings, parts);
+    call->setType(Type::createString());
+    end->replaceAllUsesWith(call);
+
+    // Erase from the end, so that every addition is unused when erased.
+    for (BinaryOperatorInst *add : adds)
+      add->eraseFromParent();
+
+    ++NumChains;
+    NumAddsRemoved += adds.size();
+  }
+
+  return !chainEnds.empty();
+}
+
+} // namespace hbc
+} // namespace hermes
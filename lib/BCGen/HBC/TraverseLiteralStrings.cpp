@@ -29,6 +29,11 @@ bool isIdOperand(Instruction *I, unsigned idx) {
     CASE_WITH_PROP_IDX(TryLoadGlobalPropertyInst);
     CASE_WITH_PROP_IDX(TryStoreGlobalPropertyInst);
 
+    case ValueKind::SwitchStrInstKind:
+      // The cases of SwitchStr are compared with interned strings.
+      return idx >= SwitchStrInst::FirstCaseIdx &&
+          (idx - SwitchStrInst::FirstCaseIdx) % 2 == 0;
+
     case ValueKind::HBCAllocObjectFromBufferInstKind:
       // AllocObjectFromBuffer stores the keys and values as alternating
       // operands starting from FirstKeyIdx.
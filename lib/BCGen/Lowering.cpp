@@ -13,6 +13,7 @@
 #include "hermes/Inst/Inst.h"
 #include "hermes/Utils/Dumper.h"
 
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -150,142 +151,64 @@ bool LowerAllocObject::runOnFunction(Function *F) {
   return changed;
 }
 
-// Number of bytes saved for serializing a literal into the buffer.
-// Estimated with the example of an integer. Substract the cost of serializing
-// the int and a 1-byte tag.
-static constexpr int32_t kLiteralSavedBytes = static_cast<int32_t>(
-    sizeof(inst::LoadConstIntInst) + sizeof(inst::PutNewOwnByIdInst) -
-    sizeof(int32_t) - 1);
-// Number of bytes cost for serializing a non-literal into the buffer.
-// Cost includes a 1-byte tag and replacing with a longer put instruction.
-static constexpr int32_t kNonLiteralCostBytes = static_cast<int32_t>(
-    1 + sizeof(inst::PutByIdInst) - sizeof(inst::PutNewOwnByIdInst));
-// Max number of non-literals we allow to serialize into the buffer.
-// The number is chosen to be small and can allow most literals to be serialized
-// for most cases.
-static constexpr uint32_t kNonLiteralPlaceholderLimit = 3;
-
-uint32_t LowerAllocObject::estimateBestNumElemsToSerialize(
-    AllocObjectInst *allocInst) {
-  uint32_t elemCount = 0;
-  // We want to track savingSoFar to avoid serializing too many place holders
-  // which ends up causing a big size regression.
-  // We set savingSoFar to be the delta of the size of two instructions to avoid
-  // serializing a literal object with only one entry, which turns out to
-  // significantly increase bytecode size.
-  int32_t savingSoFar = static_cast<int32_t>(sizeof(inst::NewObjectInst)) -
-      static_cast<int32_t>(sizeof(inst::NewObjectWithBufferInst));
-  int32_t maxSaving = 0;
-  uint32_t elemNumForMaxSaving = 0;
-  uint32_t nonLiteralsSoFar = 0;
-  for (Instruction *u : allocInst->getUsers()) {
-    // Stop when we see a getter/setter.
-    if (isa<StoreGetterSetterInst>(u)) {
-      break;
-    } else if (auto *put = dyn_cast<StoreOwnPropertyInst>(u)) {
-      // Skip if the instruction is storing the object itself into another
-      // object.
-      if (put->getStoredValue() == dyn_cast<Value>(allocInst) &&
-          put->getObject() != allocInst) {
-        continue;
-      }
-      elemCount++;
-      if (elemCount > maxSize_) {
+bool LowerAllocObject::lowerAlloc(AllocObjectInst *allocInst) {
+  // Collect the stores that initialize the literal, in program order, up to
+  // the first other use of the object. Nothing can observe the object until
+  // then, so its final class can be created by the allocation.
+  llvm::SmallVector<StoreOwnPropertyInst *, 8> stores;
+  llvm::SmallVector<Literal *, 8> keys;
+  llvm::SmallPtrSet<Literal *, 8> seenKeys;
+  BasicBlock *BB = allocInst->getParent();
+  for (auto it = std::next(allocInst->getIterator()), e = BB->end();
+       it != e && stores.size() < maxSize_;
+       ++it) {
+    Instruction *I = &*it;
+    auto *put = dyn_cast<StoreOwnPropertyInst>(I);
+    if (!put || put->getObject() != allocInst) {
+      // Stop when we reach any other use of the object.
+      bool usesAlloc = false;
+      for (unsigned i = 0, n = I->getNumOperands(); i < n; ++i)
+        usesAlloc |= I->getOperand(i) == allocInst;
+      if (usesAlloc)
         break;
-      }
-      auto *loadInst = dyn_cast<HBCLoadConstInst>(put->getStoredValue());
-      // Not counting undefined as literal since the parser doesn't
-      // support it.
-      if (loadInst &&
-          loadInst->getSingleOperand()->getKind() !=
-              ValueKind::LiteralUndefinedKind) {
-        savingSoFar += kLiteralSavedBytes;
-        if (savingSoFar > maxSaving) {
-          maxSaving = savingSoFar;
-          elemNumForMaxSaving = elemCount;
-        }
-      } else {
-        // If the key is a number, we can't overwrite with PutById, so stop.
-        if (isa<LiteralNumber>(put->getProperty())) {
-          break;
-        }
-        nonLiteralsSoFar++;
-        if (nonLiteralsSoFar > kNonLiteralPlaceholderLimit) {
-          // Stop when we serialize too many placeholders.
-          break;
-        }
-        savingSoFar -= kNonLiteralCostBytes;
-      }
+      continue;
+    }
+    // Stop if the property name isn't a LiteralString or a valid array index.
+    Literal *propLiteral = nullptr;
+    if (auto *LN = dyn_cast<LiteralNumber>(put->getProperty())) {
+      if (LN->convertToArrayIndex())
+        propLiteral = LN;
     } else {
-      // Stop when we reach an unsupported instruction.
+      propLiteral = dyn_cast<LiteralString>(put->getProperty());
+    }
+    if (!propLiteral || !put->getIsEnumerable() ||
+        put->getStoredValue() == allocInst ||
+        !seenKeys.insert(propLiteral).second) {
       break;
     }
+    stores.push_back(put);
+    keys.push_back(propLiteral);
   }
-  return elemNumForMaxSaving;
-}
-
-bool LowerAllocObject::lowerAlloc(AllocObjectInst *allocInst) {
-  // First pass to compute best number of properties to serialize.
-  uint32_t elemNumForMaxSaving = estimateBestNumElemsToSerialize(allocInst);
-  if (elemNumForMaxSaving == 0) {
+  // A literal with a single property is smaller when it is built directly.
+  if (stores.size() < 2)
     return false;
-  }
 
-  IRBuilder builder(allocInst->getParent()->getParent());
+  IRBuilder builder(BB->getParent());
   HBCAllocObjectFromBufferInst::ObjectPropertyMap prop_map;
-  uint32_t elemCountSoFar = 0;
-  // Since instructions are created sequentially, and since Users
-  // are added when an instruction is created, getUsers() preserves
-  // insertion order.
-  std::vector<Instruction *> users(
-      allocInst->getUsers().begin(), allocInst->getUsers().end());
-  for (Instruction *u : users) {
-    if (auto *put = dyn_cast<StoreOwnPropertyInst>(u)) {
-      // Skip if the property name isn't a LiteralString or a valid array index.
-      Literal *propLiteral = nullptr;
-      if (auto *LN = dyn_cast<LiteralNumber>(put->getProperty())) {
-        if (LN->convertToArrayIndex())
-          propLiteral = LN;
-      } else {
-        propLiteral = dyn_cast<LiteralString>(put->getProperty());
-      }
-      if (!propLiteral)
-        continue;
-
-      // Skip if the instruction is storing the object itself into another
-      // object.
-      if (put->getStoredValue() == dyn_cast<Value>(allocInst) &&
-          put->getObject() != allocInst) {
-        continue;
-      }
-      elemCountSoFar++;
-      if (elemCountSoFar > elemNumForMaxSaving) {
-        break;
-      }
-      auto *loadInst = dyn_cast<HBCLoadConstInst>(put->getStoredValue());
-      // Not counting undefined as literal since the parser doesn't
-      // support it.
-      if (loadInst &&
-          loadInst->getSingleOperand()->getKind() !=
-              ValueKind::LiteralUndefinedKind) {
-        prop_map.push_back(
-            std::pair<Literal *, Literal *>(propLiteral, loadInst->getConst()));
-        put->eraseFromParent();
-      } else {
-        // In the case of non-literal, use null as placeholder, and
-        // later a PutById instruction will overwrite it with correct value.
-        prop_map.push_back(std::pair<Literal *, Literal *>(
-            propLiteral, builder.getLiteralNull()));
-        builder.setLocation(put->getLocation());
-        builder.setInsertionPoint(put);
-        auto *newPut = builder.createStorePropertyInst(
-            put->getStoredValue(), put->getObject(), put->getProperty());
-        put->replaceAllUsesWith(newPut);
-        put->eraseFromParent();
-      }
+  for (uint32_t i = 0, e = stores.size(); i < e; ++i) {
+    auto *loadInst = dyn_cast<HBCLoadConstInst>(stores[i]->getStoredValue());
+    // Not counting undefined as literal since the parser doesn't
+    // support it.
+    if (loadInst &&
+        loadInst->getSingleOperand()->getKind() !=
+            ValueKind::LiteralUndefinedKind) {
+      prop_map.push_back(
+          std::pair<Literal *, Literal *>(keys[i], loadInst->getConst()));
     } else {
-      // Stop when we reach an unsupported instruction.
-      break;
+      // In the case of non-literal, use null as placeholder, which is
+      // overwritten in place once the value has been computed.
+      prop_map.push_back(
+          std::pair<Literal *, Literal *>(keys[i], builder.getLiteralNull()));
     }
   }
 
@@ -293,6 +216,17 @@ bool LowerAllocObject::lowerAlloc(AllocObjectInst *allocInst) {
   builder.setInsertionPoint(allocInst);
   auto *alloc = builder.createHBCAllocObjectFromBufferInst(
       prop_map, allocInst->getSize());
+
+  // The properties are stored in the slots of the class in buffer order.
+  for (uint32_t i = 0, e = stores.size(); i < e; ++i) {
+    StoreOwnPropertyInst *put = stores[i];
+    if (isa<LiteralNull>(prop_map[i].second)) {
+      builder.setLocation(put->getLocation());
+      builder.setInsertionPoint(put);
+      builder.createHBCStoreOwnBySlotIdxInst(put->getStoredValue(), alloc, i);
+    }
+    put->eraseFromParent();
+  }
   allocInst->replaceAllUsesWith(alloc);
   allocInst->eraseFromParent();
 
@@ -18,6 +18,8 @@
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <algorithm>
+#include <numeric>
 #include <queue>
 
 #define DEBUG_TYPE "regalloc"
@@ -591,6 +593,7 @@ void RegisterAllocator::allocate(ArrayRef<BasicBlock *> order) {
     if (instructionCount < fastPassThreshold ||
         estimatedMemoryUsage > memoryLimit) {
       allocateFastPass(order);
+      prioritizeRegisters(order);
       return;
     }
   }
@@ -736,6 +739,66 @@ void RegisterAllocator::allocate(ArrayRef<BasicBlock *> order) {
     Instruction *dest = RP.second;
     updateRegister(RP.first, getRegister(dest));
   }
+
+  prioritizeRegisters(order);
+}
+
+void RegisterAllocator::prioritizeRegisters(ArrayRef<BasicBlock *> order) {
+  unsigned numRegs = file.getMaxRegisterUsage();
+  if (!shortRegisterLimit || numRegs <= shortRegisterLimit)
+    return;
+
+  // Estimate the loop depth of each block from the backward branches of the
+  // order: a branch from the block at index i to the one at index j <= i
+  // makes a loop of the blocks in [j, i].
+  DenseMap<BasicBlock *, unsigned> blockIndex;
+  for (unsigned i = 0, e = order.size(); i < e; ++i)
+    blockIndex[order[i]] = i;
+  llvm::SmallVector<int, 32> depthDelta(order.size() + 1, 0);
+  for (unsigned i = 0, e = order.size(); i < e; ++i) {
+    for (BasicBlock *succ : successors(order[i])) {
+      auto it = blockIndex.find(succ);
+      if (it != blockIndex.end() && it->second <= i) {
+        ++depthDelta[it->second];
+        --depthDelta[i + 1];
+      }
+    }
+  }
+
+  // Each definition and use counts 8 times more for each enclosing loop.
+  llvm::SmallVector<uint64_t, 32> weights(numRegs, 0);
+  auto addUse = [&](Value *V, unsigned depth) {
+    if (!isAllocated(V) || !getRegister(V).isValid())
+      return;
+    unsigned idx = getRegister(V).getIndex();
+    assert(idx < numRegs && "Register outside of the register file");
+    weights[idx] += uint64_t(1) << (3 * std::min(depth, 8u));
+  };
+  int depth = 0;
+  for (unsigned i = 0, e = order.size(); i < e; ++i) {
+    depth += depthDelta[i];
+    for (Instruction &I : *order[i]) {
+      addUse(&I, depth);
+      for (unsigned j = 0, ops = I.getNumOperands(); j < ops; ++j)
+        addUse(I.getOperand(j), depth);
+    }
+  }
+
+  // Registers don't have any meaning of their own, so any permutation of them
+  // is a valid allocation.
+  llvm::SmallVector<unsigned, 32> byWeight(numRegs);
+  std::iota(byWeight.begin(), byWeight.end(), 0);
+  std::stable_sort(
+      byWeight.begin(), byWeight.end(), [&weights](unsigned a, unsigned b) {
+        return weights[a] > weights[b];
+      });
+  llvm::SmallVector<unsigned, 32> newIndex(numRegs);
+  for (unsigned i = 0; i < numRegs; ++i)
+    newIndex[byWeight[i]] = i;
+  for (auto &it : allocated) {
+    if (it.second.isValid())
+      it.second = Register(newIndex[it.second.getIndex()]);
+  }
 }
 
 void RegisterAllocator::calculateLiveIntervals(ArrayRef<BasicBlock *> order) {
@@ -382,9 +382,33 @@ static opt<bool> ReusePropCache(
 
 static CLFlag Inline('f', "inline", true, "inlining of functions");
 
+static opt<std::string> InliningProfile(
+    "inlining-profile",
+    desc("Call counts of the functions, as written by the VM with "
+         "-inlining-profile-file, used to inline hot functions"),
+    init(""));
+
+static opt<unsigned> InlineHotCallCount(
+    "inline-hot-call-count",
+    desc("Number of calls in the -inlining-profile from which a function "
+         "is inlined into all of its direct call sites"),
+    init(1000));
+
+static opt<unsigned> InlineHotMaxInstructions(
+    "inline-hot-max-instructions",
+    desc("Maximum number of instructions of a hot function which is "
+         "inlined into all of its direct call sites"),
+    init(40));
+
 static CLFlag
     Outline('f', "outline", false, "IR outlining to reduce code size");
 
+static CLFlag ScalarReplacement(
+    'f',
+    "scalar-replacement",
+    true,
+    "replacement of objects which do not escape by their values");
+
 static CLFlag StripFunctionNames(
     'f',
     "strip-function-names",
@@ -442,6 +466,28 @@ static opt<unsigned> PadFunctionBodiesPercent(
     init(0),
     Hidden);
 
+static opt<std::string> LayoutTraceFile(
+    "layout-trace",
+    desc("Startup trace whose functions are placed first in the bytecode"),
+    init(""));
+
+static opt<std::string> LayoutTraceBytecodeFile(
+    "layout-trace-bytecode",
+    desc("Bytecode file that the pages in the -layout-trace refer to"),
+    init(""));
+
+static opt<std::string> TypeFeedbackFile(
+    "type-feedback",
+    desc("Type feedback, as written by the VM with -type-feedback-file, used "
+         "to speculate that instructions only see numbers"),
+    init(""));
+
+static opt<bool> CompressColdFunctions(
+    "compress-cold-functions",
+    desc("Emit a container in which the bodies of the functions which are "
+         "not in the -layout-trace are compressed"),
+    init(false));
+
 } // namespace cl
 
 namespace {
@@ -781,6 +827,11 @@ std::shared_ptr<Context> createContext(
       cl::BytecodeFormat == cl::BytecodeFormatKind::HBC && cl::Inline;
   optimizationOpts.outlining =
       cl::OptimizationLevel != cl::OptLevel::O0 && cl::Outline;
+  optimizationOpts.scalarReplacement = cl::ScalarReplacement;
+
+  optimizationOpts.inliningSettings.hotCallCount = cl::InlineHotCallCount;
+  optimizationOpts.inliningSettings.maxHotInstructions =
+      cl::InlineHotMaxInstructions;
 
   optimizationOpts.outliningSettings.placeNearCaller =
       cl::OutliningPlaceNearCaller;
@@ -1088,6 +1139,214 @@ bool readBaseBytecodeMap(
   return true;
 }
 
+/// Read the call counts of the profile at \p profilePath into the inlining
+/// settings of \p context. The profile is a JSON object which maps the names
+/// of the functions to the number of times they were called:
+///   {"call_counts": {"render": 12000, "parse": 3}}
+/// \return whether the profile was read successfully.
+bool readInliningProfile(Context &context, llvm::StringRef profilePath) {
+  auto profileBuf = memoryBufferFromFile(profilePath);
+  if (!profileBuf)
+    return false;
+  auto *profileVal = parseJSONFile(profileBuf, context.getAllocator());
+  if (!profileVal) {
+    // parseJSONFile prints any error messages.
+    return false;
+  }
+  auto *profile = dyn_cast<parser::JSONObject>(profileVal);
+  auto *counts = profile
+      ? llvm::dyn_cast_or_null<parser::JSONObject>(profile->get("call_counts"))
+      : nullptr;
+  if (!counts) {
+    llvm::errs() << "Inlining profile must be a JSON object with an object "
+                    "'call_counts'.\n";
+    return false;
+  }
+
+  llvm::StringMap<uint64_t> callCounts;
+  for (auto entry : *counts) {
+    auto *num = dyn_cast<parser::JSONNumber>(entry.second);
+    if (!num || num->getValue() < 0) {
+      llvm::errs() << "'call_counts' must only contain integers.\n";
+      return false;
+    }
+    callCounts[entry.first->str()] = num->getValue();
+  }
+  context.setInliningCallCounts(std::move(callCounts));
+  return true;
+}
+
+/// Read the type feedback at \p feedbackPath into \p numberSites. The
+/// feedback is a JSON object which lists, for each function ID, the bytecode
+/// offsets of the instructions which only saw numbers:
+///   {"functions": [{"function_id": 3, "number_sites": [12, 40]}]}
+/// The profiled bytecode must be compiled from the same sources with the same
+/// options, but without type feedback, for the IDs and offsets to match.
+/// \return whether the feedback was read successfully.
+bool readTypeFeedback(
+    std::unordered_map<uint32_t, std::vector<uint32_t>> &numberSites,
+    llvm::StringRef feedbackPath,
+    ::hermes::parser::JSLexer::Allocator &alloc) {
+  auto feedbackBuf = memoryBufferFromFile(feedbackPath);
+  if (!feedbackBuf)
+    return false;
+  auto *feedbackVal = parseJSONFile(feedbackBuf, alloc);
+  if (!feedbackVal) {
+    // parseJSONFile prints any error messages.
+    return false;
+  }
+  auto *feedback = dyn_cast<parser::JSONObject>(feedbackVal);
+  auto *functions = feedback
+      ? llvm::dyn_cast_or_null<parser::JSONArray>(feedback->get("functions"))
+      : nullptr;
+  if (!functions) {
+    llvm::errs() << "Type feedback must be a JSON object with an array "
+                    "'functions'.\n";
+    return false;
+  }
+
+  for (auto it : *functions) {
+    auto *function = llvm::dyn_cast_or_null<parser::JSONObject>(it);
+    auto *id = function ? llvm::dyn_cast_or_null<parser::JSONNumber>(
+                              function->get("function_id"))
+                        : nullptr;
+    auto *sites = function ? llvm::dyn_cast_or_null<parser::JSONArray>(
+                                 function->get("number_sites"))
+                           : nullptr;
+    if (!id || id->getValue() < 0 || !sites) {
+      llvm::errs() << "Each function of the type feedback must have a "
+                      "'function_id' and an array 'number_sites'.\n";
+      return false;
+    }
+    auto &offsets = numberSites[id->getValue()];
+    for (auto site : *sites) {
+      auto *offset = llvm::dyn_cast_or_null<parser::JSONNumber>(site);
+      if (!offset || offset->getValue() < 0) {
+        llvm::errs() << "'number_sites' must only contain integers.\n";
+        return false;
+      }
+      offsets.push_back(offset->getValue());
+    }
+  }
+  return true;
+}
+
+/// Read the startup trace at \p tracePath into the order in which the bodies
+/// of the functions should be laid out. The trace is a JSON object which
+/// either lists the functions in the order they were first run:
+///   {"function_ids": [0, 5, 3]}
+/// or, as printed by the VM with -track-io, the pages of the bytecode file at
+/// \p bytecodePath in the order they were first accessed:
+///   {"page_size": 4096, "page_ids": [1, 0, 7]}
+/// in which case the functions whose bodies are on each page are placed in
+/// the order of the pages. The traced bytecode must be compiled from the same
+/// sources with the same options, but without a layout trace, for the
+/// function IDs to match.
+/// \return whether the trace was read successfully.
+bool readLayoutTrace(
+    std::vector<uint32_t> &order,
+    llvm::StringRef tracePath,
+    llvm::StringRef bytecodePath,
+    ::hermes::parser::JSLexer::Allocator &alloc) {
+  auto traceBuf = memoryBufferFromFile(tracePath);
+  if (!traceBuf)
+    return false;
+  auto *traceVal = parseJSONFile(traceBuf, alloc);
+  if (!traceVal) {
+    // parseJSONFile prints any error messages.
+    return false;
+  }
+  auto *trace = dyn_cast<parser::JSONObject>(traceVal);
+  if (!trace) {
+    llvm::errs() << "Layout trace must be a JSON object.\n";
+    return false;
+  }
+
+  // Read the array of numbers \p name of the trace into \p ids.
+  auto readIDs = [trace](llvm::StringRef name, std::vector<uint32_t> &ids) {
+    auto *array = llvm::dyn_cast_or_null<parser::JSONArray>(trace->get(name));
+    if (!array) {
+      llvm::errs() << "Layout trace has no array '" << name << "'.\n";
+      return false;
+    }
+    for (auto it : *array) {
+      auto *num = llvm::dyn_cast_or_null<parser::JSONNumber>(it);
+      if (!num || num->getValue() < 0) {
+        llvm::errs() << "'" << name << "' must only contain integers.\n";
+        return false;
+      }
+      ids.push_back(num->getValue());
+    }
+    return true;
+  };
+
+  if (trace->get("function_ids"))
+    return readIDs("function_ids", order);
+
+  std::vector<uint32_t> pageIDs;
+  if (!readIDs("page_ids", pageIDs))
+    return false;
+  auto *pageSizeVal =
+      llvm::dyn_cast_or_null<parser::JSONNumber>(trace->get("page_size"));
+  if (!pageSizeVal || pageSizeVal->getValue() < 1) {
+    llvm::errs() << "Layout trace must have a positive 'page_size'.\n";
+    return false;
+  }
+  uint64_t pageSize = pageSizeVal->getValue();
+  if (bytecodePath.empty()) {
+    llvm::errs() << "A page trace requires -layout-trace-bytecode.\n";
+    return false;
+  }
+  auto fileBuf = memoryBufferFromFile(bytecodePath);
+  if (!fileBuf)
+    return false;
+  auto ret = hbc::BCProviderFromBuffer::createBCProviderFromBuffer(
+      llvm::make_unique<OwnedMemoryBuffer>(std::move(fileBuf)));
+  if (!ret.first) {
+    llvm::errs() << "Error deserializing traced bytecode: " << ret.second;
+    return false;
+  }
+  auto &bcProvider = ret.first;
+
+  // The bodies of the functions, ordered by offset. Identical bodies are
+  // shared by several functions, but bodies never otherwise overlap, so
+  // the ends are ordered too.
+  struct Body {
+    uint32_t start;
+    uint32_t end;
+    uint32_t functionID;
+  };
+  std::vector<Body> bodies;
+  for (uint32_t id = 0, e = bcProvider->getFunctionCount(); id < e; ++id) {
+    auto header = bcProvider->getFunctionHeader(id);
+    bodies.push_back(
+        {header.offset(), header.offset() + header.bytecodeSizeInBytes(), id});
+  }
+  std::sort(bodies.begin(), bodies.end(), [](const Body &a, const Body &b) {
+    return a.start < b.start;
+  });
+
+  // Page IDs are relative to the start of the mmapped file, which is page
+  // aligned.
+  std::vector<bool> placed(bodies.size());
+  for (uint32_t page : pageIDs) {
+    uint64_t pageStart = page * pageSize;
+    uint64_t pageEnd = pageStart + pageSize;
+    auto it = std::upper_bound(
+        bodies.begin(),
+        bodies.end(),
+        pageStart,
+        [](uint64_t offset, const Body &body) { return offset < body.end; });
+    for (; it != bodies.end() && it->start < pageEnd; ++it) {
+      if (!placed[it->functionID]) {
+        placed[it->functionID] = true;
+        order.push_back(it->functionID);
+      }
+    }
+  }
+  return true;
+}
+
 /// Read a resolution table. Given a file name, it maps every require string
 /// to the actual file which must be required.
 /// Prints out error messages to stderr in case of failure.
@@ -1369,6 +1628,11 @@ CompileResult processSourceFiles(
   assert(context && "Need a context to compile using");
   assert(!cl::BytecodeMode && "Input files must not be bytecode");
 
+  // The hash covers all the inputs, because they are always compiled as a
+  // single unit: string, function and literal buffer IDs are assigned across
+  // the whole bytecode module and encoded in the instructions, and the
+  // optimizer works across module boundaries. Reusing the bytecode of
+  // unchanged modules would need a linker renumbering all of them.
   llvm::SHA1 hasher;
   for (const auto &entry : fileBufs) {
     for (const auto &fileAndMap : entry.second) {
@@ -1549,6 +1813,7 @@ CompileResult processSourceFiles(
   genOptions.stripDebugInfoSection = cl::OutputSourceMap;
 
   genOptions.stripFunctionNames = cl::StripFunctionNames;
+  genOptions.compressColdFunctions = cl::CompressColdFunctions;
 
   // If the dump target is None, return bytecode in an executable form.
   if (cl::DumpTarget == None) {
@@ -1571,6 +1836,21 @@ CompileResult processSourceFiles(
   std::unique_ptr<raw_fd_ostream> fileOS{};
   StringRef base = cl::BytecodeOutputFilename;
   if (context->getSegmentRanges().size() < 2) {
+    if (!cl::LayoutTraceFile.empty() &&
+        !readLayoutTrace(
+            genOptions.functionLayoutOrder,
+            cl::LayoutTraceFile,
+            cl::LayoutTraceBytecodeFile,
+            context->getAllocator())) {
+      return InputFileError;
+    }
+    if (!cl::TypeFeedbackFile.empty() &&
+        !readTypeFeedback(
+            genOptions.numberSites,
+            cl::TypeFeedbackFile,
+            context->getAllocator())) {
+      return InputFileError;
+    }
     if (!base.empty()) {
       fileOS = openFileForWrite(base, F_None);
       if (!fileOS)
@@ -1589,6 +1869,14 @@ CompileResult processSourceFiles(
       return result;
     }
   } else {
+    if (!cl::LayoutTraceFile.empty()) {
+      llvm::errs() << "-layout-trace does not support multiple segments.\n";
+      return InvalidFlags;
+    }
+    if (!cl::TypeFeedbackFile.empty()) {
+      llvm::errs() << "-type-feedback does not support multiple segments.\n";
+      return InvalidFlags;
+    }
     std::string manifestStr;
     llvm::raw_string_ostream manifestOS{manifestStr};
     JSONEmitter manifest{manifestOS, /* pretty */ true};
@@ -1773,6 +2061,10 @@ CompileResult compileFromCommandLineOptions() {
   } else {
     std::shared_ptr<Context> context =
         createContext(std::move(resolutionTable), std::move(segmentRanges));
+    if (!cl::InliningProfile.empty() &&
+        !readInliningProfile(*context, cl::InliningProfile)) {
+      return InputFileError;
+    }
     return processSourceFiles(context, std::move(fileBufs));
   }
 }
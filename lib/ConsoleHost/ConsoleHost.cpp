@@ -166,6 +166,7 @@ bool executeHBCBytecode(
   auto runtime = vm::Runtime::create(options.runtimeConfig);
   runtime->getJITContext().setDumpJITCode(options.dumpJITCode);
   runtime->getJITContext().setCrashOnError(options.jitCrashOnError);
+  runtime->getJITContext().setReportBailouts(options.jitReportBailouts);
 
   if (shouldRecordGCStats) {
     statSampler = llvm::make_unique<vm::StatSamplingThread>(
@@ -202,6 +203,11 @@ bool executeHBCBytecode(
       flags,
       sourceURL,
       runtime->makeNullHandle<vm::Environment>());
+  bool threwException = status == vm::ExecutionStatus::EXCEPTION;
+
+  // Run the jobs enqueued by the script, such as promise reactions.
+  if (!threwException)
+    threwException = runtime->drainJobs() == vm::ExecutionStatus::EXCEPTION;
 
   if (options.runtimeConfig.getEnableSampleProfiling()) {
     auto profiler = vm::SamplingProfiler::getInstance();
@@ -210,8 +216,6 @@ bool executeHBCBytecode(
     profiler->disable();
   }
 
-  bool threwException = status == vm::ExecutionStatus::EXCEPTION;
-
   if (threwException) {
     // Make sure stdout catches up to stderr.
     llvm::outs().flush();
@@ -225,8 +229,30 @@ bool executeHBCBytecode(
 
 #ifdef HERMESVM_PROFILER_JSFUNCTION
   runtime->dumpJSFunctionStats();
+  if (!options.inliningProfileFile.empty()) {
+    std::error_code EC;
+    llvm::raw_fd_ostream OS(
+        options.inliningProfileFile, EC, llvm::sys::fs::F_Text);
+    if (EC) {
+      llvm::errs() << "Could not write to " << options.inliningProfileFile
+                   << ": " << EC.message() << "\n";
+    } else {
+      runtime->dumpJSFunctionCallCounts(OS);
+    }
+  }
 #endif
 
+  if (!options.typeFeedbackFile.empty()) {
+    std::error_code EC;
+    llvm::raw_fd_ostream OS(options.typeFeedbackFile, EC, llvm::sys::fs::F_Text);
+    if (EC) {
+      llvm::errs() << "Could not write to " << options.typeFeedbackFile << ": "
+                   << EC.message() << "\n";
+    } else {
+      runtime->dumpTypeFeedback(OS);
+    }
+  }
+
 #ifdef HERMESVM_PROFILER_EXTERN
   if (options.patchProfilerSymbols) {
     patchProfilerSymbols(runtime.get());
@@ -7,6 +7,7 @@
 #include "hermes/IR/Analysis.h"
 #include "hermes/IR/CFG.h"
 #include "hermes/IR/IR.h"
+#include "hermes/IR/Instrs.h"
 #include "hermes/Utils/Dumper.h"
 #include "llvm/ADT/PriorityQueue.h"
 #include "llvm/Support/Debug.h"
@@ -198,6 +199,20 @@ BasicBlock *LoopAnalysis::getLoopPreheader(const BasicBlock *BB) const {
   return nullptr;
 }
 
+/// \return whether the lowered function \p F creates an environment, which
+/// isn't the case when the environment was elided or is unused.
+static bool createsEnvironment(Function *F) {
+  // Lazy functions are lowered when they are compiled, and always create an
+  // environment then.
+  if (F->isLazy() || F->empty())
+    return true;
+  for (auto &I : F->front()) {
+    if (isa<HBCCreateEnvironmentInst>(&I))
+      return true;
+  }
+  return false;
+}
+
 FunctionScopeAnalysis::ScopeData
 FunctionScopeAnalysis::calculateFunctionScopeData(Function *F) {
   if (lexicalScopeMap_.find(F) == lexicalScopeMap_.end()) {
@@ -230,7 +245,12 @@ FunctionScopeAnalysis::calculateFunctionScopeData(Function *F) {
     Function *Parent = Inst->getParent()->getParent();
     ScopeData parentData = calculateFunctionScopeData(Parent);
     if (!parentData.orphaned) {
-      lexicalScopeMap_[F] = ScopeData(Parent, parentData.depth + 1);
+      bool ownEnvironment = createsEnvironment(F);
+      lexicalScopeMap_[F] = ScopeData(
+          Parent,
+          parentData.depth + (ownEnvironment ? 1 : 0),
+          false,
+          ownEnvironment);
     } else {
       lexicalScopeMap_[F] = ScopeData::orphan();
     }
@@ -252,3 +272,7 @@ Optional<int32_t> FunctionScopeAnalysis::getScopeDepth(VariableScope *VS) {
 Function *FunctionScopeAnalysis::getLexicalParent(Function *F) {
   return calculateFunctionScopeData(F).parent;
 }
+
+bool FunctionScopeAnalysis::hasOwnEnvironment(Function *F) {
+  return calculateFunctionScopeData(F).ownEnvironment;
+}
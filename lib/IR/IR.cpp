@@ -368,12 +368,18 @@ void Instruction::eraseFromParent() {
 
 void Function::eraseFromParentNoDestroy() {
   // Erase all of the basic blocks before deleting the function.
+  eraseBody();
+  assert(!hasUsers() && "Use list is not empty");
+  getParent()->getFunctionList().remove(getIterator());
+}
+
+void Function::eraseBody() {
+  // Blocks may branch to each other, so drop the uses of each block before
+  // erasing it.
   while (begin() != end()) {
     begin()->replaceAllUsesWith(nullptr);
     begin()->eraseFromParent();
   }
-  assert(!hasUsers() && "Use list is not empty");
-  getParent()->getFunctionList().remove(getIterator());
 }
 
 StringRef Instruction::getName() {
@@ -728,6 +728,30 @@ ResumeGeneratorInst *IRBuilder::createResumeGeneratorInst(Value *isReturn) {
   return I;
 }
 
+IteratorBeginInst *IRBuilder::createIteratorBeginInst(
+    AllocStackInst *sourceOrNext) {
+  auto *I = new IteratorBeginInst(sourceOrNext);
+  insert(I);
+  return I;
+}
+
+IteratorNextInst *IRBuilder::createIteratorNextInst(
+    AllocStackInst *iterator,
+    AllocStackInst *sourceOrNext) {
+  auto *I = new IteratorNextInst(iterator, sourceOrNext);
+  insert(I);
+  return I;
+}
+
+IteratorCloseInst *IRBuilder::createIteratorCloseInst(
+    Value *iterator,
+    bool ignoreInnerException) {
+  auto *I =
+      new IteratorCloseInst(iterator, getLiteralBool(ignoreInnerException));
+  insert(I);
+  return I;
+}
+
 HBCResolveEnvironment *IRBuilder::createHBCResolveEnvironment(
     VariableScope *scope) {
   auto RSC = new HBCResolveEnvironment(scope);
@@ -765,6 +789,19 @@ SwitchImmInst *IRBuilder::createSwitchImmInst(
   return inst;
 }
 
+SwitchStrInst *IRBuilder::createSwitchStrInst(
+    Value *input,
+    BasicBlock *defaultBlock,
+    BasicBlock *fallbackBlock,
+    LiteralNumber *tableSize,
+    const SwitchStrInst::ValueListType &values,
+    const SwitchStrInst::BasicBlockListType &blocks) {
+  auto inst = new SwitchStrInst(
+      input, defaultBlock, fallbackBlock, tableSize, values, blocks);
+  insert(inst);
+  return inst;
+}
+
 DirectEvalInst *IRBuilder::createDirectEvalInst(Value *operand) {
   auto *inst = new DirectEvalInst(operand);
   insert(inst);
@@ -813,6 +850,15 @@ HBCReifyArgumentsInst *IRBuilder::createHBCReifyArgumentsInst(
   insert(inst);
   return inst;
 }
+HBCApplyArgumentsInst *IRBuilder::createHBCApplyArgumentsInst(
+    Value *callee,
+    Value *function,
+    Value *thisArg,
+    AllocStackInst *lazyReg) {
+  auto inst = new HBCApplyArgumentsInst(callee, function, thisArg, lazyReg);
+  insert(inst);
+  return inst;
+}
 HBCCreateThisInst *IRBuilder::createHBCCreateThisInst(
     Value *prototype,
     Value *closure) {
@@ -892,6 +938,32 @@ HBCAllocObjectFromBufferInst *IRBuilder::createHBCAllocObjectFromBufferInst(
   return inst;
 }
 
+HBCStoreOwnBySlotIdxInst *IRBuilder::createHBCStoreOwnBySlotIdxInst(
+    Value *storedValue,
+    Value *object,
+    uint32_t slot) {
+  auto *inst = new HBCStoreOwnBySlotIdxInst(
+      storedValue, object, M->getLiteralNumber(slot));
+  insert(inst);
+  return inst;
+}
+
+HBCTypeOfIsInst *IRBuilder::createHBCTypeOfIsInst(Value *value, uint8_t type) {
+  auto *inst = new HBCTypeOfIsInst(value, M->getLiteralNumber(type));
+  insert(inst);
+  return inst;
+}
+
+HBCGetTemplateObjectInst *IRBuilder::createHBCGetTemplateObjectInst(
+    uint32_t templateObjID,
+    bool dup,
+    ArrayRef<LiteralString *> strings) {
+  auto *inst = new HBCGetTemplateObjectInst(
+      M->getLiteralNumber(templateObjID), M->getLiteralBool(dup), strings);
+  insert(inst);
+  return inst;
+}
+
 CompareBranchInst *IRBuilder::createCompareBranchInst(
     Value *left,
     Value *right,
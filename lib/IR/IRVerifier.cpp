@@ -268,7 +268,8 @@ void Verifier::beforeVisitInstruction(const Instruction &Inst) {
               isa<ResumeGeneratorInst>(Inst) ||
               isa<HBCGetArgumentsPropByValInst>(Inst) ||
               isa<HBCGetArgumentsLengthInst>(Inst) ||
-              isa<HBCReifyArgumentsInst>(Inst),
+              isa<HBCReifyArgumentsInst>(Inst) ||
+              isa<HBCApplyArgumentsInst>(Inst),
           "Stack variable can only be accessed in certain instructions.");
     }
   }
@@ -692,6 +693,35 @@ void Verifier::visitSwitchImmInst(const hermes::SwitchImmInst &Inst) {
   }
 }
 
+void Verifier::visitSwitchStrInst(const hermes::SwitchStrInst &Inst) {
+  Assert(isTerminator(&Inst), "SwitchStrInst must be a terminator");
+  Assert(Inst.getInputValue(), "Invalid input value");
+  Assert(
+      Inst.getNumCasePair() > 0,
+      "SwitchStrInst must have some case destinations");
+  Assert(
+      Inst.getNumSuccessors() == Inst.getNumCasePair() + 2,
+      "Number of successors of SwitchStrInst does not match.");
+  for (unsigned idx = 0, e = Inst.getNumSuccessors(); idx < e; ++idx) {
+    Assert(
+        succ_contains(Inst.getParent(), Inst.getSuccessor(idx)),
+        "Destination must be a successor of SwitchStrInst block");
+    Assert(
+        pred_contains(Inst.getSuccessor(idx), Inst.getParent()),
+        "SwitchStrInst block must be a predecessor of its destinations");
+  }
+  llvm::SmallPtrSet<Literal *, 8> values;
+  for (unsigned idx = 0, e = Inst.getNumCasePair(); idx < e; ++idx) {
+    Assert(
+        values.insert(Inst.getCasePair(idx).first).second,
+        "switch values must be unique");
+  }
+  Assert(
+      llvm::isPowerOf2_32(Inst.getTableSize()) &&
+          Inst.getTableSize() >= Inst.getNumCasePair(),
+      "table size must be a power of two that fits all cases");
+}
+
 void Verifier::visitCheckHasInstanceInst(const CheckHasInstanceInst &Inst) {
   Assert(isTerminator(&Inst), "CheckHasInstanceInst must be a terminator");
   Assert(
@@ -731,6 +761,33 @@ void Verifier::visitHBCAllocObjectFromBufferInst(
       "Cannot allocate an empty HBCAllocObjectFromBufferInst");
 }
 
+void Verifier::visitHBCStoreOwnBySlotIdxInst(
+    const hermes::HBCStoreOwnBySlotIdxInst &Inst) {
+  Assert(
+      Inst.getSlot()->isUInt32Representible(),
+      "Invalid HBCStoreOwnBySlotIdxInst slot");
+  Assert(
+      isa<HBCAllocObjectFromBufferInst>(Inst.getObject()),
+      "HBCStoreOwnBySlotIdxInst must store into an object from a buffer");
+}
+
+void Verifier::visitHBCTypeOfIsInst(const hermes::HBCTypeOfIsInst &Inst) {
+  Assert(
+      Inst.getTypeOfIsType()->isUInt8Representible(),
+      "Invalid HBCTypeOfIsInst type");
+}
+
+void Verifier::visitHBCGetTemplateObjectInst(
+    const hermes::HBCGetTemplateObjectInst &Inst) {
+  Assert(
+      Inst.getTemplateObjID()->isUInt32Representible(),
+      "Invalid HBCGetTemplateObjectInst template object ID");
+  Assert(
+      Inst.getNumStrings() > 0 &&
+          (Inst.getDup()->getValue() || Inst.getNumStrings() % 2 == 0),
+      "HBCGetTemplateObjectInst must have as many raw as cooked strings");
+}
+
 void Verifier::visitHBCGetGlobalObjectInst(const HBCGetGlobalObjectInst &Inst) {
   // Nothing to verify at this point.
 }
@@ -758,6 +815,10 @@ void Verifier::visitStartGeneratorInst(const StartGeneratorInst &Inst) {
 }
 void Verifier::visitResumeGeneratorInst(const ResumeGeneratorInst &Inst) {}
 
+void Verifier::visitIteratorBeginInst(const IteratorBeginInst &Inst) {}
+void Verifier::visitIteratorNextInst(const IteratorNextInst &Inst) {}
+void Verifier::visitIteratorCloseInst(const IteratorCloseInst &Inst) {}
+
 void Verifier::visitHBCCreateGeneratorInst(const HBCCreateGeneratorInst &Inst) {
   visitCreateGeneratorInst(Inst);
 }
@@ -776,6 +837,11 @@ void Verifier::visitHBCGetArgumentsLengthInst(
 void Verifier::visitHBCReifyArgumentsInst(const HBCReifyArgumentsInst &Inst) {
   // Nothing to verify at this point.
 }
+void Verifier::visitHBCApplyArgumentsInst(const HBCApplyArgumentsInst &Inst) {
+  Assert(
+      isa<AllocStackInst>(Inst.getLazyRegister()),
+      "HBCApplyArgumentsInst must use the lazy arguments register");
+}
 void Verifier::visitHBCConstructInst(const HBCConstructInst &Inst) {}
 void Verifier::visitHBCCreateThisInst(const HBCCreateThisInst &Inst) {}
 void Verifier::visitHBCGetConstructedObjectInst(
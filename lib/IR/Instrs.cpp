@@ -366,6 +366,55 @@ void SwitchImmInst::setSuccessor(unsigned idx, BasicBlock *B) {
   setOperand(B, FirstCaseIdx + (idx - 1) * 2 + 1);
 }
 
+SwitchStrInst::SwitchStrInst(
+    Value *input,
+    BasicBlock *defaultBlock,
+    BasicBlock *fallbackBlock,
+    LiteralNumber *tableSize,
+    const ValueListType &values,
+    const BasicBlockListType &blocks)
+    : TerminatorInst(ValueKind::SwitchStrInstKind) {
+  pushOperand(input);
+  pushOperand(defaultBlock);
+  pushOperand(fallbackBlock);
+  assert(
+      tableSize->isUInt32Representible() &&
+      llvm::isPowerOf2_32(tableSize->asUInt32()) &&
+      "table size must be a power of two");
+  pushOperand(tableSize);
+
+  assert(blocks.size() && "Empty switch statement (no cases?)");
+  assert(values.size() == blocks.size() && "Block-value pairs mismatch");
+
+  // Push the switch targets.
+  for (size_t i = 0, e = values.size(); i < e; ++i) {
+    pushOperand(values[i]);
+    pushOperand(blocks[i]);
+  }
+}
+
+BasicBlock *SwitchStrInst::getSuccessor(unsigned idx) const {
+  assert(idx < getNumSuccessors() && "getSuccessor out of bound!");
+  if (idx == 0)
+    return getDefaultDestination();
+  if (idx == 1)
+    return getFallbackDestination();
+  return getCasePair(idx - 2).second;
+}
+
+void SwitchStrInst::setSuccessor(unsigned idx, BasicBlock *B) {
+  assert(idx < getNumSuccessors() && "setSuccessor out of bound!");
+  if (idx == 0) {
+    setOperand(B, DefaultBlockIdx);
+    return;
+  }
+  if (idx == 1) {
+    setOperand(B, FallbackBlockIdx);
+    return;
+  }
+  setOperand(B, FirstCaseIdx + (idx - 2) * 2 + 1);
+}
+
 Instruction::Variety Instruction::getVariety() const {
   const ValueKind kind = getKind();
 
@@ -1001,10 +1001,10 @@ Value *ESTreeIRGen::genTemplateLiteralExpr(ESTree::TemplateLiteralNode *Expr) {
       Expr->_quasis.size() == Expr->_expressions.size() + 1 &&
       "The string count should always be one more than substitution count.");
 
-  // Construct an argument list for calling HermesInternal.concat():
+  // Construct an argument list for calling HermesInternal.concatStrings():
   // cookedStr0, substitution0, cookedStr1, ..., substitutionN, cookedStrN + 1,
-  // skipping any empty string, except for the first cooked string, which is
-  // going to be the `this` to the concat call.
+  // skipping any empty string. The call compiles to a single CallBuiltin,
+  // which allocates the result once.
 
   // Get the first cooked string.
   auto strItr = Expr->_quasis.begin();
@@ -1016,6 +1016,9 @@ Value *ESTreeIRGen::genTemplateLiteralExpr(ESTree::TemplateLiteralNode *Expr) {
     return firstCookedStr;
   }
   CallInst::ArgumentList argList;
+  if (!firstCookedStr->getValue().str().empty()) {
+    argList.push_back(firstCookedStr);
+  }
   auto exprItr = Expr->_expressions.begin();
   while (strItr != Expr->_quasis.end()) {
     auto *sub = genExpression(&*exprItr);
@@ -1032,8 +1035,10 @@ Value *ESTreeIRGen::genTemplateLiteralExpr(ESTree::TemplateLiteralNode *Expr) {
       exprItr == Expr->_expressions.end() &&
       "All the substitutions must have been collected.");
 
-  // Generate a function call to HermesInternal.concat() with these arguments.
-  return genHermesInternalCall("concat", firstCookedStr, argList);
+  // Generate a function call to HermesInternal.concatStrings() with these
+  // arguments.
+  return genHermesInternalCall(
+      "concatStrings", Builder.getLiteralUndefined(), argList);
 }
 
 Value *ESTreeIRGen::genTaggedTemplateExpr(
@@ -465,31 +465,45 @@ void ESTreeIRGen::genForOfStatement(ESTree::ForOfStatementNode *forOfStmt) {
   curFunction()->initLabel(forOfStmt, exitBlock, getNextBlock);
 
   auto *exprValue = genExpression(forOfStmt->_right);
-  auto iteratorRecord = emitGetIterator(exprValue);
+
+  // The iterated value is replaced by the next method of its iterator, and the
+  // iterator is set to undefined when the iteration is done. Arrays are
+  // iterated by index without creating an iterator (see IteratorBeginInst).
+  auto *sourceOrNext =
+      Builder.createAllocStackInst(genAnonymousLabelName("sourceOrNext"));
+  Builder.createStoreStackInst(exprValue, sourceOrNext);
+  auto *iteratorStorage =
+      Builder.createAllocStackInst(genAnonymousLabelName("iterator"));
+  Builder.createStoreStackInst(
+      Builder.createIteratorBeginInst(sourceOrNext), iteratorStorage);
 
   Builder.createBranchInst(getNextBlock);
 
   Builder.setInsertionBlock(getNextBlock);
-  auto *nextResult = emitIteratorNext(iteratorRecord);
-  auto *done = emitIteratorComplete(nextResult);
-  Builder.createCondBranchInst(done, exitBlock, bodyBlock);
+  auto *nextValue =
+      Builder.createIteratorNextInst(iteratorStorage, sourceOrNext);
+  Builder.createCompareBranchInst(
+      Builder.createLoadStackInst(iteratorStorage),
+      Builder.getLiteralUndefined(),
+      BinaryOperatorInst::OpKind::StrictlyEqualKind,
+      exitBlock,
+      bodyBlock);
 
   Builder.setInsertionBlock(bodyBlock);
 
-  auto *nextValue = emitIteratorValue(nextResult);
-
   emitTryCatchScaffolding(
       getNextBlock,
       // emitBody.
-      [this, forOfStmt, nextValue, &iteratorRecord]() {
+      [this, forOfStmt, nextValue, iteratorStorage]() {
         // Generate IR for the body of Try
         SurroundingTry thisTry{
             curFunction(),
             forOfStmt,
             {},
-            [this, &iteratorRecord](ESTree::Node *, ControlFlowChange cfc) {
+            [this, iteratorStorage](ESTree::Node *, ControlFlowChange cfc) {
               if (cfc == ControlFlowChange::Break)
-                emitIteratorClose(iteratorRecord, false);
+                Builder.createIteratorCloseInst(
+                    Builder.createLoadStackInst(iteratorStorage), false);
             }};
 
         // Note: obtaing the value is not protected, but storing it is.
@@ -502,9 +516,10 @@ void ESTreeIRGen::genForOfStatement(ESTree::ForOfStatementNode *forOfStmt) {
       // emitNormalCleanup.
       []() {},
       // emitHandler.
-      [this, &iteratorRecord](BasicBlock *) {
+      [this, iteratorStorage](BasicBlock *) {
         auto *catchReg = Builder.createCatchInst();
-        emitIteratorClose(iteratorRecord, true);
+        Builder.createIteratorCloseInst(
+            Builder.createLoadStackInst(iteratorStorage), true);
         Builder.createThrowInst(catchReg);
       });
 
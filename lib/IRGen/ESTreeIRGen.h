@@ -517,7 +517,7 @@ class ESTreeIRGen {
   Value *genMetaProperty(ESTree::MetaPropertyNode *MP);
 
   /// Generate IR for a template literal expression, which in most cases is
-  /// translated to a call to HermesInternal.concat().
+  /// translated to a call to HermesInternal.concatStrings().
   Value *genTemplateLiteralExpr(ESTree::TemplateLiteralNode *Expr);
 
   /// Generate IR for a tagged template expression, which involves converting
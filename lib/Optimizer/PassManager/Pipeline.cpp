@@ -62,6 +62,8 @@ void hermes::runFullOptimizationPasses(Module &M) {
   PM.addStackPromotion();
   PM.addInstSimplify();
   PM.addDCE();
+  // Inlining exposes the uses of objects passed to the inlined functions.
+  PM.addScalarReplacement();
 
   // Run type inference before CSE so that we can better reason about binopt.
   PM.addTypeInference();
@@ -72,6 +74,9 @@ void hermes::runFullOptimizationPasses(Module &M) {
   PM.addTypeInferenceWithCLA();
   PM.addConstantPropertyOpts();
   PM.addUncalledMethodOpts();
+  // The constant exports of modules leave dead branches in the modules using
+  // them, which are removed by the passes below.
+  PM.addCJSConstantExports();
 
   PM.addInstSimplify();
   PM.addFuncSigOpts();
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#define DEBUG_TYPE "cjsconstexports"
+#include "hermes/Optimizer/Scalar/CJSConstantExports.h"
+#include "hermes/IR/IRBuilder.h"
+#include "hermes/IR/Instrs.h"
+#include "hermes/Optimizer/Scalar/Utils.h"
+#include "hermes/Support/Statistic.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Debug.h"
+
+using namespace hermes;
+using llvm::dbgs;
+using llvm::isa;
+
+STATISTIC(NumConstantExports, "Number of constant exports found");
+STATISTIC(NumLoadsReplaced, "Number of loads of exports replaced");
+
+namespace {
+
+/// The loads and stores of the properties of an object, through any of the
+/// values which refer to it.
+struct ObjectAccesses {
+  llvm::SmallVector<LoadPropertyInst *, 8> loads{};
+  llvm::SmallVector<StorePropertyInst *, 8> stores{};
+};
+
+/// Add the property accesses of the object \p V, and of its copies loaded from
+/// variables storing only \p V, to \p accesses.
+/// \returns false if \p V is used in any other way, which may let it escape.
+bool collectAccesses(Value *V, ObjectAccesses &accesses) {
+  llvm::SmallVector<Value *, 4> worklist{V};
+  llvm::SmallPtrSet<Variable *, 4> visited{};
+  while (!worklist.empty()) {
+    Value *obj = worklist.pop_back_val();
+    for (auto *U : obj->getUsers()) {
+      if (auto *LPI = dyn_cast<LoadPropertyInst>(U)) {
+        if (LPI->getObject() != obj || LPI->getProperty() == obj)
+          return false;
+        accesses.loads.push_back(LPI);
+      } else if (auto *SPI = dyn_cast<StorePropertyInst>(U)) {
+        if (SPI->getObject() != obj || SPI->getProperty() == obj ||
+            SPI->getStoredValue() == obj)
+          return false;
+        accesses.stores.push_back(SPI);
+      } else if (auto *SFI = dyn_cast<StoreFrameInst>(U)) {
+        Variable *var = SFI->getVariable();
+        if (isStoreOnceVariable(var) != obj)
+          return false;
+        if (!visited.insert(var).second)
+          continue;
+        for (auto *VU : var->getUsers()) {
+          if (auto *LFI = dyn_cast<LoadFrameInst>(VU))
+            worklist.push_back(LFI);
+        }
+      } else {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/// \returns whether \p V is a primitive literal which can replace a load.
+bool isPrimitiveLiteral(Value *V) {
+  return isa<LiteralNumber>(V) || isa<LiteralBool>(V) ||
+      isa<LiteralString>(V) || isa<LiteralNull>(V) || isa<LiteralUndefined>(V);
+}
+
+/// \returns the ID of the module loaded by \p call if it is one of the
+/// HermesInternal.requireFast() calls created by ResolveStaticRequire.
+llvm::Optional<uint32_t> getRequiredModule(CallInst *call) {
+  if (call->getNumArguments() != 2)
+    return llvm::None;
+  auto *loadFn = dyn_cast<LoadPropertyInst>(call->getCallee());
+  auto *id = dyn_cast<LiteralNumber>(call->getArgument(1));
+  if (!loadFn || !id)
+    return llvm::None;
+  auto *loadHI = dyn_cast<LoadPropertyInst>(loadFn->getObject());
+  auto *fnName = dyn_cast<LiteralString>(loadFn->getProperty());
+  if (!loadHI || !fnName || !isa<GlobalObject>(loadHI->getObject()) ||
+      fnName->getValue().str() != "requireFast")
+    return llvm::None;
+  auto *objName = dyn_cast<LiteralString>(loadHI->getProperty());
+  if (!objName || objName->getValue().str() != "HermesInternal")
+    return llvm::None;
+  return id->isIntTypeRepresentible<uint32_t>();
+}
+
+/// Find the exports of the module \p F which are constant, and replace their
+/// loads in \p accesses. \p accesses contains the accesses of the exports
+/// object outside of \p F, through the results of requireFast().
+/// An export is constant if it has a single store, of a primitive literal,
+/// which is in the entry block of \p F before any instruction which may
+/// execute code, except for other stores to the exports. Nothing can read the
+/// exports before that point, even with circular requires. This assumes,
+/// like the rest of the static require resolution, that the prototype of the
+/// exports object has no setters for the exported names.
+/// \returns true if a load was replaced.
+bool propagateModuleExports(Function *F, ObjectAccesses &accesses) {
+  // The exports object is the first parameter and 'this'. The 'module'
+  // parameter must not be used to replace it.
+  if (!collectAccesses(F->getParameters()[0], accesses) ||
+      !collectAccesses(F->getThisParameter(), accesses)) {
+    return false;
+  }
+  ObjectAccesses moduleAccesses{};
+  if (!collectAccesses(F->getParameters()[2], moduleAccesses) ||
+      !moduleAccesses.stores.empty()) {
+    return false;
+  }
+  for (auto *LPI : moduleAccesses.loads) {
+    auto *prop = dyn_cast<LiteralString>(LPI->getProperty());
+    if (!prop || prop->getValue().str() == "exports")
+      return false;
+  }
+
+  // Count the stores of each property. A store with a computed name could
+  // write any of them.
+  llvm::DenseMap<Identifier, unsigned> numStores{};
+  llvm::SmallPtrSet<Instruction *, 8> stores{};
+  for (auto *SPI : accesses.stores) {
+    auto *prop = dyn_cast<LiteralString>(SPI->getProperty());
+    if (!prop)
+      return false;
+    ++numStores[prop->getValue()];
+    stores.insert(SPI);
+  }
+
+  llvm::DenseMap<Identifier, Literal *> constants{};
+  for (auto &I : F->front()) {
+    if (stores.count(&I)) {
+      auto *SPI = cast<StorePropertyInst>(&I);
+      Identifier name = cast<LiteralString>(SPI->getProperty())->getValue();
+      if (numStores[name] == 1 && isPrimitiveLiteral(SPI->getStoredValue())) {
+        constants[name] = cast<Literal>(SPI->getStoredValue());
+        ++NumConstantExports;
+      }
+      continue;
+    }
+    if (I.mayExecute())
+      break;
+  }
+
+  bool changed = false;
+  for (auto *LPI : accesses.loads) {
+    auto *prop = dyn_cast<LiteralString>(LPI->getProperty());
+    if (!prop)
+      continue;
+    auto it = constants.find(prop->getValue());
+    if (it == constants.end())
+      continue;
+    LLVM_DEBUG(
+        dbgs() << "Replacing a load of the export " << prop->getValue().str()
+               << "\n");
+    LPI->replaceAllUsesWith(it->second);
+    LPI->eraseFromParent();
+    ++NumLoadsReplaced;
+    changed = true;
+  }
+  return changed;
+}
+
+} // namespace
+
+bool CJSConstantExports::runOnModule(Module *M) {
+  if (!M->getCJSModulesResolved())
+    return false;
+  // Lazy functions are not in the IR, so their accesses are unknown.
+  for (auto &F : *M) {
+    if (F.isLazy())
+      return false;
+  }
+
+  llvm::DenseMap<uint32_t, Function *> moduleFunctions{};
+  for (const auto &module : M->getCJSModules())
+    moduleFunctions[module.id] = module.function;
+
+  // Collect the accesses of the exports of each module by the modules which
+  // require it. A result which escapes prevents any change to its module.
+  llvm::DenseMap<Function *, ObjectAccesses> accesses{};
+  llvm::SmallPtrSet<Function *, 8> escaped{};
+  for (auto &F : *M) {
+    for (auto &BB : F) {
+      for (auto &I : BB) {
+        auto *call = dyn_cast<CallInst>(&I);
+        if (!call)
+          continue;
+        auto id = getRequiredModule(call);
+        if (!id)
+          continue;
+        auto it = moduleFunctions.find(*id);
+        if (it == moduleFunctions.end())
+          continue;
+        if (!collectAccesses(call, accesses[it->second]))
+          escaped.insert(it->second);
+      }
+    }
+  }
+
+  bool changed = false;
+  for (const auto &module : M->getCJSModules()) {
+    if (escaped.count(module.function))
+      continue;
+    changed |=
+        propagateModuleExports(module.function, accesses[module.function]);
+  }
+  return changed;
+}
+
+Pass *hermes::createCJSConstantExports() {
+  return new CJSConstantExports();
+}
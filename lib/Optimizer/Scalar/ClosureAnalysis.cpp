@@ -269,6 +269,19 @@ static void generateInstructionConstraints(
       break;
     case ValueKind::SwitchImmInstKind:
       break;
+    case ValueKind::SwitchStrInstKind:
+      break;
+    case ValueKind::IteratorBeginInstKind: {
+      auto *IBI = cast<IteratorBeginInst>(&I);
+      ap->addUnknownDst(IBI->getSourceOrNext());
+      ap->addUnknownSrc(IBI);
+      break;
+    }
+    case ValueKind::IteratorNextInstKind:
+      ap->addUnknownSrc(&I);
+      break;
+    case ValueKind::IteratorCloseInstKind:
+      break;
     case ValueKind::CallInstKind: {
       auto CI = cast<CallInst>(&I);
       Value *C = CI->getOperand(0);
@@ -297,6 +310,10 @@ static void generateInstructionConstraints(
     case ValueKind::HBCGetArgumentsPropByValInstKind:
     case ValueKind::HBCGetArgumentsLengthInstKind:
     case ValueKind::HBCReifyArgumentsInstKind:
+    case ValueKind::HBCApplyArgumentsInstKind:
+    case ValueKind::HBCStoreOwnBySlotIdxInstKind:
+    case ValueKind::HBCTypeOfIsInstKind:
+    case ValueKind::HBCGetTemplateObjectInstKind:
     case ValueKind::HBCGetConstructedObjectInstKind:
     case ValueKind::HBCSpillMovInstKind:
       llvm_unreachable("Target specific instructions in Optimizer phase.");
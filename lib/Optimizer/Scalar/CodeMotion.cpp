@@ -106,17 +106,55 @@ static bool hoistCBI(CondBranchInst *CBI) {
   }
 }
 
+/// \returns the frame variable read by \p inst, or null if \p inst is not a
+/// frame load.
+static Variable *getLoadedVariable(Instruction *inst) {
+  if (auto *LFI = dyn_cast<LoadFrameInst>(inst))
+    return LFI->getLoadVariable();
+  if (auto *LEI = dyn_cast<HBCLoadFromEnvironmentInst>(inst))
+    return LEI->getResolvedName();
+  return nullptr;
+}
+
+/// Check whether the variable \p var cannot change once the preheader ending
+/// with \p branchInst has run. That is the case when \p var belongs to the
+/// function of the loop, so that each invocation has its own copy, and all of
+/// its stores are in that function and dominate \p branchInst. Stores in
+/// other functions could run during any call in the loop.
+static bool isVariableInvariantInLoop(
+    Variable *var,
+    Instruction *branchInst,
+    const DominanceInfo &dominance) {
+  Function *F = branchInst->getParent()->getParent();
+  if (var->getParent()->getFunction() != F)
+    return false;
+  for (auto *U : var->getUsers()) {
+    auto *I = cast<Instruction>(U);
+    if (getLoadedVariable(I) == var)
+      continue;
+    if (I->getParent()->getParent() != F ||
+        !dominance.properlyDominates(I, branchInst))
+      return false;
+  }
+  return true;
+}
+
 /// Check whether \p inst, an instruction in a loop, can be hoisted to just
 /// before \p branchInst, the last instruction in the preheader of the loop.
-/// Only certain types of instructions can be hoisted, and their dependencies
-/// must dominate \p branchInst.
+/// Only certain types of instructions, and loads of variables which are not
+/// written in the loop, can be hoisted, and their dependencies must dominate
+/// \p branchInst.
 /// \param dominance the dominance tree for the function
 /// \returns true if \p inst is safe to hoist.
 static bool canHoistFromLoop(
     Instruction *inst,
     Instruction *branchInst,
     const DominanceInfo &dominance) {
-  if (!isSimpleSideEffectFreeInstruction(inst)) {
+  if (Variable *var = getLoadedVariable(inst)) {
+    if (!isVariableInvariantInLoop(var, branchInst, dominance)) {
+      return false;
+    }
+  } else if (!isSimpleSideEffectFreeInstruction(inst)) {
     return false;
   }
   for (int i = 0, e = inst->getNumOperands(); i < e; ++i) {
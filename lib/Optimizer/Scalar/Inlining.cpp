@@ -19,6 +19,9 @@ using llvm::dyn_cast;
 using llvm::isa;
 
 STATISTIC(NumInlinedCalls, "Number of inlined calls");
+STATISTIC(
+    NumHotInlinedCalls,
+    "Number of calls inlined because a profile showed them hot");
 
 namespace hermes {
 
@@ -254,8 +257,86 @@ static Value *inlineFunction(
   return returnValue ? returnValue : cast<Value>(builder.getLiteralUndefined());
 }
 
+/// \return whether the function \p F was called at least as many times as
+///   set in \p settings by the profiled run.
+static bool isHot(Function *F, const InliningSettings &settings) {
+  if (settings.callCounts.empty())
+    return false;
+  auto it = settings.callCounts.find(F->getOriginalOrInferredName().str());
+  return it != settings.callCounts.end() &&
+      it->second >= settings.hotCallCount;
+}
+
+/// \return whether \p F has no more than \p limit instructions.
+static bool isSmallerThan(Function *F, unsigned limit) {
+  unsigned count = 0;
+  for (auto &BB : *F) {
+    count += BB.getInstList().size();
+    if (count > limit)
+      return false;
+  }
+  return true;
+}
+
+/// Find the call sites of the closure created by \p CFI.
+/// \return false if the closure is used by anything but direct calls.
+static bool getDirectCallSites(
+    CreateFunctionInst *CFI,
+    llvm::SmallVectorImpl<CallInst *> &callSites) {
+  // We can't use getCallSites() (yet) because it also considers constructor
+  // calls as well usages through environment variables.
+  for (Instruction *user : CFI->getUsers()) {
+    if (user->getKind() != ValueKind::CallInstKind)
+      return false;
+    auto *CI = cast<CallInst>(user);
+    if (!isDirectCallee(CFI, CI))
+      return false;
+    callSites.push_back(CI);
+  }
+  return !callSites.empty();
+}
+
+/// Replace the call \p CI by a copy of the body of \p FC.
+static void inlineCallSite(Module *M, Function *FC, CallInst *CI) {
+  Function *intoFunction = CI->getParent()->getParent();
+
+  LLVM_DEBUG(llvm::dbgs() << "Inlining function '" << FC->getInternalNameStr()
+                          << "' ";
+             FC->getContext().getSourceErrorManager().dumpCoords(
+                 llvm::dbgs(), FC->getSourceRange().Start);
+             llvm::dbgs() << " into function '"
+                          << intoFunction->getInternalNameStr() << "' ";
+             FC->getContext().getSourceErrorManager().dumpCoords(
+                 llvm::dbgs(), intoFunction->getSourceRange().Start);
+             llvm::dbgs() << "\n";);
+
+  IRBuilder builder(M);
+
+  // Split the block in two and move all instructions following the call
+  // to the new block.
+  BasicBlock *nextBlock = builder.createBasicBlock(intoFunction);
+  builder.setInsertionBlock(nextBlock);
+
+  // Move the rest of the instructions.
+  auto it = CI->getIterator();
+  ++it; // Skip over the call.
+  auto e = CI->getParent()->end();
+  while (it != e)
+    builder.transferInstructionToCurrentBlock(&*it++);
+
+  // Perform the inlining.
+  builder.setInsertionPointAfter(CI);
+
+  auto *returnValue = inlineFunction(builder, FC, CI, nextBlock);
+  CI->replaceAllUsesWith(returnValue);
+  CI->eraseFromParent();
+
+  ++NumInlinedCalls;
+}
+
 bool Inlining::runOnModule(Module *M) {
-  if (!M->getContext().getOptimizationSettings().inlining)
+  const auto &settings = M->getContext().getOptimizationSettings();
+  if (!settings.inlining)
     return false;
 
   bool changed = false;
@@ -266,56 +347,31 @@ bool Inlining::runOnModule(Module *M) {
       if (!CFI)
         continue;
 
-      // Check if the function is used only once directly by a CallInst.
-      // We can't use getCallSites() (yet) because it also considers constructor
-      // calls as well usages through environment variables.
+      // Check if the function is used only by direct calls. A function called
+      // once is always inlined, since its body doesn't get duplicated. A
+      // function called from several sites is only inlined if the profile
+      // shows that it is hot, and it is small.
+      llvm::SmallVector<CallInst *, 2> callSites;
+      if (!getDirectCallSites(CFI, callSites))
+        continue;
 
-      if (!CFI->hasOneUser() ||
-          CFI->getUsers()[0]->getKind() != ValueKind::CallInstKind) {
+      auto *FC = CFI->getFunctionCode();
+      if (callSites.size() > 1 &&
+          (!isHot(FC, settings.inliningSettings) ||
+           !isSmallerThan(FC, settings.inliningSettings.maxHotInstructions))) {
         continue;
       }
-      auto *CI = cast<CallInst>(CFI->getUsers()[0]);
-      if (!isDirectCallee(CFI, CI))
-        continue;
-
-      Function *intoFunction = CI->getParent()->getParent();
 
-      auto *FC = CFI->getFunctionCode();
+      // All the call sites are in the function of CFI.
+      Function *intoFunction = CFI->getParent()->getParent();
       if (!canBeInlined(FC, intoFunction))
         continue;
 
-      LLVM_DEBUG(llvm::dbgs() << "Inlining function '"
-                              << FC->getInternalNameStr() << "' ";
-                 FC->getContext().getSourceErrorManager().dumpCoords(
-                     llvm::dbgs(), FC->getSourceRange().Start);
-                 llvm::dbgs() << " into function '"
-                              << intoFunction->getInternalNameStr() << "' ";
-                 FC->getContext().getSourceErrorManager().dumpCoords(
-                     llvm::dbgs(), intoFunction->getSourceRange().Start);
-                 llvm::dbgs() << "\n";);
-
-      IRBuilder builder(M);
-
-      // Split the block in two and move all instructions following the call
-      // to the new block.
-      BasicBlock *nextBlock = builder.createBasicBlock(intoFunction);
-      builder.setInsertionBlock(nextBlock);
-
-      // Move the rest of the instructions.
-      auto it = CI->getIterator();
-      ++it; // Skip over the call.
-      auto e = CI->getParent()->end();
-      while (it != e)
-        builder.transferInstructionToCurrentBlock(&*it++);
-
-      // Perform the inlining.
-      builder.setInsertionPointAfter(CI);
-
-      auto *returnValue = inlineFunction(builder, FC, CI, nextBlock);
-      CI->replaceAllUsesWith(returnValue);
-      CI->eraseFromParent();
-
-      ++NumInlinedCalls;
+      for (CallInst *CI : callSites) {
+        inlineCallSite(M, FC, CI);
+        if (callSites.size() > 1)
+          ++NumHotInlinedCalls;
+      }
       changed = true;
     }
   }
@@ -224,6 +224,12 @@ static bool promoteLoads(BasicBlock *BB) {
       continue;
     }
 
+    // Forget the stack locations written by instructions other than stores.
+    for (auto index : II->getChangedOperands()) {
+      if (auto *AS = dyn_cast<AllocStackInst>(II->getOperand(index)))
+        knownStackValues.erase(AS);
+    }
+
     if (auto *CF = dyn_cast<CreateFunctionInst>(II)) {
       // Collect the captured variables.
       if (usePreciseCaptureAnalysis) {
@@ -343,6 +349,12 @@ static bool eliminateStores(
       continue;
     }
 
+    // Instructions other than loads may read the stack locations they use.
+    for (unsigned i = 0, e = II->getNumOperands(); i < e; ++i) {
+      if (auto *AS = dyn_cast<AllocStackInst>(II->getOperand(i)))
+        prevStoreStack[AS] = nullptr;
+    }
+
     if (II->mayExecute()) {
       for (auto *A : unsafeAllocas) {
         prevStoreStack[A] = nullptr;
@@ -37,7 +37,8 @@ class ResolveStaticRequireImpl {
   IRBuilder builder_;
 
   /// Set to false if there is at least one case that we couldn't resolve
-  /// statically.
+  /// statically. The calls which were resolved are still replaced, but the
+  /// modules keep their dynamic require().
   bool canResolve_{true};
 
   /// An instance of using the "require" parameter or a value derived
@@ -68,8 +69,8 @@ class ResolveStaticRequireImpl {
         : call(call), resolvedTarget(resolvedTarget) {}
   };
 
-  /// All resolved require calls. If canResolve_ is true, we can replace them
-  /// with HermesInternal.require() calls.
+  /// All resolved require calls, which are replaced with
+  /// HermesInternal.requireFast() calls.
   std::vector<ResolvedRequire> resolvedRequireCalls_{};
 
  public:
@@ -101,7 +102,11 @@ bool ResolveStaticRequireImpl::run() {
     resolveCJSModule(module.function);
   }
 
-  if (!canResolve_)
+  // Only drop the filenames of the modules if nothing needs them to resolve a
+  // require() at runtime.
+  M_->setCJSModulesResolved(canResolve_);
+
+  if (resolvedRequireCalls_.empty())
     return false;
 
   // Find or add the HermesInternal global property.
@@ -138,8 +143,7 @@ bool ResolveStaticRequireImpl::run() {
     RR.call->eraseFromParent();
   }
 
-  M_->setCJSModulesResolved(true);
-  return !resolvedRequireCalls_.empty();
+  return true;
 }
 
 void ResolveStaticRequireImpl::resolveCJSModule(Function *moduleFunction) {
@@ -292,6 +296,15 @@ void ResolveStaticRequireImpl::resolveRequireCall(
 
   resolvedRequireCalls_.emplace_back(call, resolved);
   ++NumRequireCallsResolved;
+
+  // Requires made while the module itself runs let the runtime prefetch the
+  // modules that its initialization is going to need.
+  if (call->getParent()->getParent() == moduleFunction) {
+    auto &deps = M_->findCJSModule(moduleFunction)->dependencies;
+    uint32_t id = cast<LiteralNumber>(resolved)->asUInt32();
+    if (std::find(deps.begin(), deps.end(), id) == deps.end())
+      deps.push_back(id);
+  }
 }
 
 /// Canonicalize \p dirname and \p target together, placing the result in
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#define DEBUG_TYPE "sra"
+#include "hermes/Optimizer/Scalar/ScalarReplacement.h"
+#include "hermes/IR/IRBuilder.h"
+#include "hermes/IR/Instrs.h"
+#include "hermes/Support/Statistic.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Debug.h"
+
+using namespace hermes;
+using llvm::dbgs;
+using llvm::isa;
+
+STATISTIC(NumObjectsReplaced, "Number of objects replaced by their values");
+STATISTIC(NumLoadsReplaced, "Number of property loads replaced");
+
+namespace {
+
+/// \returns the name of the property of \p alloc accessed by \p inst, or null
+/// if \p inst is not a load or store of a named property of \p alloc which
+/// keeps it from escaping.
+LiteralString *getAccessedProperty(Instruction *inst, AllocObjectInst *alloc) {
+  Value *object;
+  Value *property;
+  if (auto *LPI = dyn_cast<LoadPropertyInst>(inst)) {
+    object = LPI->getObject();
+    property = LPI->getProperty();
+  } else if (auto *SPI = dyn_cast<StorePropertyInst>(inst)) {
+    if (SPI->getStoredValue() == alloc)
+      return nullptr;
+    object = SPI->getObject();
+    property = SPI->getProperty();
+  } else if (auto *SNOPI = dyn_cast<StoreNewOwnPropertyInst>(inst)) {
+    if (SNOPI->getStoredValue() == alloc)
+      return nullptr;
+    object = SNOPI->getObject();
+    property = SNOPI->getProperty();
+  } else {
+    return nullptr;
+  }
+  return object == alloc ? dyn_cast<LiteralString>(property) : nullptr;
+}
+
+/// Try to replace the object \p alloc by the values of its properties.
+/// Only objects created with the default prototype are handled, and their
+/// properties must all be defined by the object literal, by
+/// StoreNewOwnPropertyInst, before they are used, so that no access reaches
+/// the prototype. Stores must be in the block of \p alloc, so that loads in
+/// other blocks, which it dominates, see the values at its end.
+/// \returns true if \p alloc was replaced.
+bool replaceObject(AllocObjectInst *alloc) {
+  if (!isa<EmptySentinel>(alloc->getParentObject()))
+    return false;
+  BasicBlock *allocBB = alloc->getParent();
+
+  llvm::SmallVector<Instruction *, 8> users;
+  for (auto *U : alloc->getUsers()) {
+    auto *I = cast<Instruction>(U);
+    if (!getAccessedProperty(I, alloc))
+      return false;
+    if (!isa<LoadPropertyInst>(I) && I->getParent() != allocBB)
+      return false;
+    users.push_back(I);
+  }
+
+  // Check that every property is defined before it is used in the block of
+  // alloc, and find the values of the properties at its end.
+  llvm::SmallDenseMap<LiteralString *, Value *, 8> values;
+  for (auto it = std::next(alloc->getIterator()), e = allocBB->end(); it != e;
+       ++it) {
+    Instruction *I = &*it;
+    LiteralString *prop = getAccessedProperty(I, alloc);
+    if (!prop)
+      continue;
+    if (auto *SNOPI = dyn_cast<StoreNewOwnPropertyInst>(I)) {
+      if (!values.try_emplace(prop, SNOPI->getStoredValue()).second)
+        return false;
+    } else if (!values.count(prop)) {
+      return false;
+    } else if (auto *SPI = dyn_cast<StorePropertyInst>(I)) {
+      values[prop] = SPI->getStoredValue();
+    }
+  }
+  for (Instruction *I : users) {
+    if (I->getParent() != allocBB &&
+        !values.count(getAccessedProperty(I, alloc)))
+      return false;
+  }
+
+  // Replace the loads in the block of alloc with the values at that point,
+  // and the other loads with the values at its end.
+  IRBuilder::InstructionDestroyer destroyer;
+  llvm::SmallDenseMap<LiteralString *, Value *, 8> current;
+  for (auto it = std::next(alloc->getIterator()), e = allocBB->end(); it != e;
+       ++it) {
+    Instruction *I = &*it;
+    LiteralString *prop = getAccessedProperty(I, alloc);
+    if (!prop)
+      continue;
+    if (auto *SNOPI = dyn_cast<StoreNewOwnPropertyInst>(I)) {
+      current[prop] = SNOPI->getStoredValue();
+    } else if (auto *SPI = dyn_cast<StorePropertyInst>(I)) {
+      current[prop] = SPI->getStoredValue();
+    } else {
+      I->replaceAllUsesWith(current[prop]);
+      ++NumLoadsReplaced;
+    }
+    destroyer.add(I);
+  }
+  for (Instruction *I : users) {
+    if (I->getParent() != allocBB) {
+      I->replaceAllUsesWith(current[getAccessedProperty(I, alloc)]);
+      ++NumLoadsReplaced;
+      destroyer.add(I);
+    }
+  }
+  destroyer.add(alloc);
+  ++NumObjectsReplaced;
+  return true;
+}
+
+} // namespace
+
+bool ScalarReplacement::runOnFunction(Function *F) {
+  if (!F->getContext().getOptimizationSettings().scalarReplacement)
+    return false;
+
+  // Replacing an object can turn the objects stored in it into objects which
+  // do not escape, so repeat until nothing changes.
+  bool changed = false;
+  bool localChanged;
+  do {
+    llvm::SmallVector<AllocObjectInst *, 8> allocs;
+    for (auto &BB : *F) {
+      for (auto &I : BB) {
+        if (auto *alloc = dyn_cast<AllocObjectInst>(&I))
+          allocs.push_back(alloc);
+      }
+    }
+
+    localChanged = false;
+    for (auto *alloc : allocs) {
+      if (replaceObject(alloc)) {
+        LLVM_DEBUG(
+            dbgs() << "Replaced an object in " << F->getInternalNameStr()
+                   << "\n");
+        localChanged = true;
+      }
+    }
+    changed |= localChanged;
+  } while (localChanged);
+  return changed;
+}
+
+Pass *hermes::createScalarReplacement() {
+  return new ScalarReplacement();
+}
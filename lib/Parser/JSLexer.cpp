@@ -11,6 +11,8 @@
 
 #include "llvm/ADT/StringSwitch.h"
 
+#include <cstring>
+
 using llvm::Twine;
 
 namespace hermes {
@@ -41,6 +43,42 @@ inline bool matchUnicodeLineTerminatorOffset1(const char *curCharPtr_) {
       ((unsigned char)curCharPtr_[2] == 0xa8 ||
        (unsigned char)curCharPtr_[2] == 0xa9);
 }
+
+/// \return a word with all bytes equal to \p ch.
+constexpr uint64_t broadcastByte(unsigned char ch) {
+  return 0x0101010101010101ull * ch;
+}
+
+/// \return whether any byte of \p word is zero.
+inline bool hasZeroByte(uint64_t word) {
+  return (word - broadcastByte(1)) & ~word & broadcastByte(0x80);
+}
+
+/// \return whether any byte of \p word is equal to \p ch.
+inline bool hasByte(uint64_t word, unsigned char ch) {
+  return hasZeroByte(word ^ broadcastByte(ch));
+}
+
+/// Skip the characters starting at \p ptr which are ASCII and none of 0, '\r',
+/// '\n', \p ch1 or \p ch2, examining 8 bytes at a time and never reading at
+/// or past \p end. This stops at the start of the first 8 bytes containing
+/// any other character, so the caller must go on one character at a time.
+inline const char *skipPlainASCII(
+    const char *ptr,
+    const char *end,
+    unsigned char ch1 = 0,
+    unsigned char ch2 = 0) {
+  while (end - ptr >= (ptrdiff_t)sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, ptr, sizeof(word));
+    if ((word & broadcastByte(0x80)) || hasZeroByte(word) ||
+        hasByte(word, '\n') || hasByte(word, '\r') || hasByte(word, ch1) ||
+        hasByte(word, ch2))
+      break;
+    ptr += sizeof(word);
+  }
+  return ptr;
+}
 } // namespace
 
 const char *tokenKindStr(TokenKind kind) {
@@ -693,6 +731,7 @@ const char *JSLexer::skipLineComment(const char *start) {
   start += 2;
 
   for (;;) {
+    start = skipPlainASCII(start, bufferEnd_);
     switch ((unsigned char)*start) {
       case 0:
         if (start == bufferEnd_)
@@ -737,6 +776,7 @@ const char *JSLexer::skipBlockComment(const char *start) {
   start += 2;
 
   for (;;) {
+    start = skipPlainASCII(start, bufferEnd_, '*');
     switch ((unsigned char)*start) {
       case 0:
         if (start == bufferEnd_) {
@@ -1045,6 +1085,11 @@ void JSLexer::scanString() {
   tmpStorage_.clear();
 
   for (;;) {
+    const char *plainEnd =
+        skipPlainASCII(curCharPtr_, bufferEnd_, quoteCh, '\\');
+    tmpStorage_.append(curCharPtr_, plainEnd);
+    curCharPtr_ = plainEnd;
+
     if (*curCharPtr_ == quoteCh) {
       ++curCharPtr_;
       break;
@@ -3922,6 +3922,11 @@ Optional<ESTree::NodePtr> castNode(Optional<T> node) {
 }
 } // namespace
 
+// The pre-parser shares the grammar code of the other passes, which returns
+// the nodes it parses, so it still creates nodes. They cost little: the body
+// of each function is parsed in its own AllocationScope and freed right away,
+// and only the bounds of the bodies are kept. A separate node-free grammar
+// would have to be kept in sync with every syntax change of the full one.
 bool JSParserImpl::preParseBuffer(
     Context &context,
     uint32_t bufferId,
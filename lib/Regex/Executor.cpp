@@ -10,6 +10,12 @@
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/TrailingObjects.h"
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
 // This file contains the machinery for executing a regexp compiled to bytecode.
 
 namespace hermes {
@@ -203,6 +209,11 @@ struct Context {
   /// overflow error.
   static constexpr size_t kMaxBacktrackDepth = 1u << 24;
 
+  /// Number of characters a Bracket loop body is tested against one at a time
+  /// before switching to a bitmap. Building the bitmap tests all 128 ASCII
+  /// characters, so it only pays off for long runs.
+  static constexpr uint32_t kBracketBitmapThreshold = 64;
+
   /// The stream of bytecode instructions, including the header.
   llvm::ArrayRef<uint8_t> bytecodeStream_;
 
@@ -256,6 +267,16 @@ struct Context {
   /// Note the end of the match can be recovered as state->current_.
   const CharT *match(State<Traits> *state, const CharT *pos, bool onlyAtStart);
 
+  /// Like match(), but without backtracking: every way that the match may
+  /// proceed is tracked at once, and they all advance one input character at
+  /// a time. Of the ways that reach the same point of the program at the same
+  /// position, only the one that match() would have tried first is kept,
+  /// since they all continue alike. This gives the same result as match(), in
+  /// time linear in the length of the input.
+  /// \pre the program has RegexBytecodeHeader::linearTime set.
+  const CharT *
+  matchLinear(State<Traits> *state, const CharT *pos, bool onlyAtStart);
+
   /// Backtrack the given state \p s with the backtrack stack \p bts.
   /// \return true if we backatracked, false if we exhausted the stack.
   bool backtrack(BacktrackStack &bts, State<Traits> *s);
@@ -303,13 +324,26 @@ struct Context {
   template <Width1Opcode w1opcode>
   inline bool matchWidth1(const Insn *insn, CharT c) const;
 
+  /// \return true if the char \p c matches the Width1 instruction \p insn,
+  /// whatever its opcode.
+  bool matchWidth1Insn(const Insn *insn, CharT c) const;
+
   /// Execute the given Width1 instruction \p loopBody on string \p pos up to \p
   /// max times. \return the number of matches made, not to exceed \p max.
   template <Width1Opcode w1opcode>
   inline uint32_t
   matchWidth1LoopBody(const Insn *loopBody, const CharT *pos, uint32_t max);
+
+  /// Like matchWidth1LoopBody<Width1Opcode::Bracket>, but once the loop has
+  /// matched kBracketBitmapThreshold characters, test the remaining ASCII
+  /// characters with a bitmap of the ones that \p loopBody matches.
+  uint32_t
+  matchBracketLoopBody(const Insn *loopBody, const CharT *pos, uint32_t max);
 };
 
+template <class Traits>
+constexpr uint32_t Context<Traits>::kBracketBitmapThreshold;
+
 /// We store loop and captured range data contiguously in a single allocation at
 /// the end of the State. Use this union to simplify the use of
 /// llvm::TrailingObjects.
@@ -400,6 +434,21 @@ bool matchesRightAnchor(Context<Traits> &ctx, State<Traits> &s) {
   return matchesAnchor;
 }
 
+template <class Traits>
+bool matchesWordBoundary(Context<Traits> &ctx, State<Traits> &s) {
+  bool prevIsWordchar = false;
+  if (s.current_ != ctx.first_ ||
+      (ctx.flags_ & constants::matchPreviousCharAvailable))
+    prevIsWordchar =
+        ctx.traits_.characterHasType(s.current_[-1], CharacterClass::Words);
+
+  bool currentIsWordchar = false;
+  if (s.current_ != ctx.last_)
+    currentIsWordchar =
+        ctx.traits_.characterHasType(s.current_[0], CharacterClass::Words);
+  return prevIsWordchar != currentIsWordchar;
+}
+
 /// \return true if the character \p ch matches a bracket instruction \p insn,
 /// containing the bracket ranges \p ranges. Note the count of ranges is given
 /// in \p insn.
@@ -591,6 +640,26 @@ bool Context<Traits>::matchWidth1(const Insn *base, CharT c) const {
   llvm_unreachable("Invalid width 1 opcode");
 }
 
+template <class Traits>
+bool Context<Traits>::matchWidth1Insn(const Insn *insn, CharT c) const {
+  using W1 = Width1Opcode;
+  switch (static_cast<Width1Opcode>(insn->opcode)) {
+    case W1::MatchChar8:
+      return matchWidth1<W1::MatchChar8>(insn, c);
+    case W1::MatchChar16:
+      return matchWidth1<W1::MatchChar16>(insn, c);
+    case W1::MatchCharICase8:
+      return matchWidth1<W1::MatchCharICase8>(insn, c);
+    case W1::MatchCharICase16:
+      return matchWidth1<W1::MatchCharICase16>(insn, c);
+    case W1::MatchAnyButNewline:
+      return matchWidth1<W1::MatchAnyButNewline>(insn, c);
+    case W1::Bracket:
+      return matchWidth1<W1::Bracket>(insn, c);
+  }
+  llvm_unreachable("Invalid width 1 opcode");
+}
+
 template <class Traits>
 template <Width1Opcode w1opcode>
 uint32_t Context<Traits>::matchWidth1LoopBody(
@@ -605,6 +674,33 @@ uint32_t Context<Traits>::matchWidth1LoopBody(
   return iters;
 }
 
+template <class Traits>
+uint32_t Context<Traits>::matchBracketLoopBody(
+    const Insn *insn,
+    const CharT *pos,
+    uint32_t max) {
+  using UCharT = typename std::make_unsigned<CharT>::type;
+  uint32_t direct = std::min(max, kBracketBitmapThreshold);
+  uint32_t iters =
+      matchWidth1LoopBody<Width1Opcode::Bracket>(insn, pos, direct);
+  if (iters < direct || iters == max)
+    return iters;
+
+  uint64_t asciiBitmap[2] = {0, 0};
+  for (UCharT c = 0; c < 128; c++) {
+    if (matchWidth1<Width1Opcode::Bracket>(insn, c))
+      asciiBitmap[c >> 6] |= uint64_t(1) << (c & 63);
+  }
+  for (; iters < max; iters++) {
+    UCharT c = pos[iters];
+    bool matches = c < 128 ? (asciiBitmap[c >> 6] >> (c & 63)) & 1
+                           : matchWidth1<Width1Opcode::Bracket>(insn, c);
+    if (!matches)
+      break;
+  }
+  return iters;
+}
+
 template <class Traits>
 bool Context<Traits>::matchWidth1Loop(
     const Width1LoopInsn *insn,
@@ -644,7 +740,7 @@ bool Context<Traits>::matchWidth1Loop(
           matchWidth1LoopBody<W1::MatchAnyButNewline>(body, pos, maxMatch);
       break;
     case W1::Bracket:
-      matched = matchWidth1LoopBody<W1::Bracket>(body, pos, maxMatch);
+      matched = matchBracketLoopBody(body, pos, maxMatch);
       break;
   }
 
@@ -817,18 +913,7 @@ auto Context<Traits>::match(
 
         case Opcode::WordBoundary: {
           const WordBoundaryInsn *insn = llvm::cast<WordBoundaryInsn>(base);
-          bool prevIsWordchar = false;
-          if (s->current_ != first_ ||
-              (flags_ & constants::matchPreviousCharAvailable))
-            prevIsWordchar = traits_.characterHasType(
-                s->current_[-1], CharacterClass::Words);
-
-          bool currentIsWordchar = false;
-          if (s->current_ != last_)
-            currentIsWordchar =
-                traits_.characterHasType(s->current_[0], CharacterClass::Words);
-          bool isWordBoundary = (prevIsWordchar != currentIsWordchar);
-          if (isWordBoundary ^ insn->invert)
+          if (matchesWordBoundary(*this, *s) ^ insn->invert)
             s->ip_ += sizeof(WordBoundaryInsn);
           else
             BACKTRACK();
@@ -1088,6 +1173,418 @@ auto Context<Traits>::match(
   return nullptr;
 }
 
+/// \return the first position in [\p first, \p last) where the \p length
+/// characters of \p prefix occur, or nullptr if there is none.
+template <typename CharT>
+const CharT *findLiteralPrefix(
+    const CharT *first,
+    const CharT *last,
+    const char16_t *prefix,
+    uint32_t length) {
+  assert(length > 0 && "empty prefix");
+  const char16_t head = prefix[0];
+  // A character that does not fit in CharT never occurs in the input.
+  if (static_cast<CharT>(head) != head)
+    return nullptr;
+  while (static_cast<size_t>(last - first) >= length) {
+    // Find the first character, then check the rest of the prefix there.
+    const CharT *candidate;
+    if (sizeof(CharT) == 1) {
+      candidate = static_cast<const CharT *>(
+          std::memchr(first, head, last - first - length + 1));
+    } else {
+      candidate =
+          std::find(first, last - length + 1, static_cast<CharT>(head));
+      if (candidate == last - length + 1)
+        candidate = nullptr;
+    }
+    if (!candidate)
+      return nullptr;
+    auto sameChar = [](char16_t p, CharT c) {
+      return p == static_cast<char16_t>(c);
+    };
+    if (std::equal(prefix + 1, prefix + length, candidate + 1, sameChar))
+      return candidate;
+    first = candidate + 1;
+  }
+  return nullptr;
+}
+
+template <class Traits>
+auto Context<Traits>::matchLinear(
+    State<Traits> *s,
+    const CharT *startLoc,
+    bool onlyAtStart) -> const CharT * {
+  const auto *header =
+      reinterpret_cast<const RegexBytecodeHeader *>(bytecodeStream_.data());
+  assert(header->linearTime && "Program cannot be run without backtracking");
+  const uint8_t *const bytecode = &bytecodeStream_[sizeof(RegexBytecodeHeader)];
+  const uint32_t startIp = s->ip_;
+  const uint32_t infinite = std::numeric_limits<uint32_t>::max();
+
+  // Each thread (way of matching) records the start and end of every capture
+  // group, followed by the position where its match started.
+  const uint32_t slotCount = 2 * markedCount_ + 1;
+  const uint32_t matchStartSlot = 2 * markedCount_;
+
+  /// A thread waiting to consume the next character. Its ip is that of an
+  /// instruction that matches one character, of Goal, or of a Width1Loop
+  /// whose body it is about to run, with the given iterations so far.
+  struct Thread {
+    uint32_t ip;
+    uint32_t iterations;
+  };
+
+  /// The threads waiting at one input position, in the order match() would
+  /// try them, and their slots.
+  struct ThreadList {
+    std::vector<Thread> threads;
+    std::vector<uint32_t> slots;
+
+    void clear() {
+      threads.clear();
+      slots.clear();
+    }
+  };
+
+  /// Work left to compute the threads that a thread turns into without
+  /// consuming input. It is kept on a stack, so that the ways to proceed
+  /// are considered depth first, just like match() would.
+  struct WorkItem {
+    enum Kind : uint8_t {
+      /// Follow the instruction at ip, having made \c value iterations if it
+      /// is a Width1Loop.
+      Follow,
+      /// Add a thread waiting for another iteration of the Width1Loop at ip.
+      AddWidth1LoopThread,
+      /// Reset the capture groups of the BeginLoop at ip, then follow its
+      /// body.
+      EnterLoopBody,
+      /// Set slot \c ip back to \c value.
+      RestoreSlot,
+    } kind;
+    uint32_t ip;
+    uint32_t value;
+  };
+
+  // Points of the program already reached at the position we follow threads
+  // to, stamped with that position's generation. Instructions are identified
+  // by their ip; the iterations of each Width1Loop get ids past the end of the
+  // bytecode, assigned as the loops are reached.
+  std::vector<uint32_t> visited(bytecodeStream_.size(), 0);
+  std::vector<uint32_t> width1LoopIds(loopCount_, 0);
+  uint32_t generation = 1;
+
+  std::vector<WorkItem> work;
+  std::vector<uint32_t> slots(slotCount);
+
+  // Add to \p list the threads reached from \p ip without consuming input at
+  // \p pos, starting from \p slots.
+  auto follow = [&](ThreadList &list,
+                    uint32_t ip,
+                    uint32_t iterations,
+                    const CharT *pos) {
+    auto addThread = [&](uint32_t threadIp, uint32_t threadIterations) {
+      list.threads.push_back({threadIp, threadIterations});
+      list.slots.insert(list.slots.end(), slots.begin(), slots.end());
+    };
+    auto markVisited = [&](uint32_t id) {
+      if (visited[id] == generation)
+        return false;
+      visited[id] = generation;
+      return true;
+    };
+
+    s->current_ = pos;
+    work.push_back({WorkItem::Follow, ip, iterations});
+    while (!work.empty()) {
+      WorkItem item = work.back();
+      work.pop_back();
+      switch (item.kind) {
+        case WorkItem::RestoreSlot:
+          slots[item.ip] = item.value;
+          continue;
+
+        case WorkItem::AddWidth1LoopThread:
+          addThread(item.ip, item.value);
+          continue;
+
+        case WorkItem::EnterLoopBody: {
+          const BeginLoopInsn *loop =
+              llvm::cast<BeginLoopInsn>(
+              reinterpret_cast<const Insn *>(&bytecode[item.ip]));
+          for (uint32_t mexp = loop->mexpBegin; mexp != loop->mexpEnd;
+               mexp++) {
+            for (uint32_t slot = 2 * mexp; slot != 2 * mexp + 2; slot++) {
+              work.push_back({WorkItem::RestoreSlot, slot, slots[slot]});
+              slots[slot] = kNotMatched;
+            }
+          }
+          work.push_back(
+              {WorkItem::Follow, item.ip + (uint32_t)sizeof(BeginLoopInsn), 0});
+          continue;
+        }
+
+        case WorkItem::Follow:
+          break;
+      }
+
+      const Insn *base = reinterpret_cast<const Insn *>(&bytecode[item.ip]);
+      if (base->opcode != Opcode::Width1Loop && !markVisited(item.ip))
+        continue;
+      switch (base->opcode) {
+        case Opcode::Goal:
+        case Opcode::MatchAnyButNewline:
+        case Opcode::MatchChar8:
+        case Opcode::MatchChar16:
+        case Opcode::MatchCharICase8:
+        case Opcode::MatchCharICase16:
+        case Opcode::Bracket:
+          addThread(item.ip, 0);
+          break;
+
+        case Opcode::LeftAnchor:
+          if (matchesLeftAnchor(*this, *s))
+            work.push_back(
+                {WorkItem::Follow,
+                 item.ip + (uint32_t)sizeof(LeftAnchorInsn),
+                 0});
+          break;
+
+        case Opcode::RightAnchor:
+          if (matchesRightAnchor(*this, *s))
+            work.push_back(
+                {WorkItem::Follow,
+                 item.ip + (uint32_t)sizeof(RightAnchorInsn),
+                 0});
+          break;
+
+        case Opcode::WordBoundary:
+          if (matchesWordBoundary(*this, *s) ^
+              llvm::cast<WordBoundaryInsn>(base)->invert)
+            work.push_back(
+                {WorkItem::Follow,
+                 item.ip + (uint32_t)sizeof(WordBoundaryInsn),
+                 0});
+          break;
+
+        case Opcode::Alternation: {
+          // Push the secondary branch first, so the primary one is followed
+          // first.
+          const AlternationInsn *alt = llvm::cast<AlternationInsn>(base);
+          if (flagsSatisfyConstraints(flags_, alt->secondaryConstraints))
+            work.push_back({WorkItem::Follow, alt->secondaryBranch, 0});
+          if (flagsSatisfyConstraints(flags_, alt->primaryConstraints))
+            work.push_back(
+                {WorkItem::Follow,
+                 item.ip + (uint32_t)sizeof(AlternationInsn),
+                 0});
+          break;
+        }
+
+        case Opcode::Jump32:
+          work.push_back(
+              {WorkItem::Follow, llvm::cast<Jump32Insn>(base)->target, 0});
+          break;
+
+        case Opcode::BeginMarkedSubexpression:
+        case Opcode::EndMarkedSubexpression: {
+          bool isBegin = base->opcode == Opcode::BeginMarkedSubexpression;
+          uint32_t slot = isBegin
+              ? 2 * (llvm::cast<BeginMarkedSubexpressionInsn>(base)->mexp - 1)
+              : 2 * (llvm::cast<EndMarkedSubexpressionInsn>(base)->mexp - 1) +
+                  1;
+          work.push_back({WorkItem::RestoreSlot, slot, slots[slot]});
+          slots[slot] = pos - first_;
+          static_assert(
+              sizeof(BeginMarkedSubexpressionInsn) ==
+                  sizeof(EndMarkedSubexpressionInsn),
+              "Marked subexpression instructions should have the same size");
+          work.push_back(
+              {WorkItem::Follow,
+               item.ip + (uint32_t)sizeof(BeginMarkedSubexpressionInsn),
+               0});
+          break;
+        }
+
+        case Opcode::BeginLoop: {
+          // Entering the loop from outside. Loops run here have a minimum of
+          // at most 1 and a maximum of 1 or infinity, and their body never
+          // matches the empty string, so no iteration count is needed.
+          const BeginLoopInsn *loop = llvm::cast<BeginLoopInsn>(base);
+          bool doLoopBody =
+              flagsSatisfyConstraints(flags_, loop->loopeeConstraints);
+          bool doNotTaken = loop->min == 0;
+          if (doLoopBody && doNotTaken && !loop->greedy)
+            work.push_back({WorkItem::EnterLoopBody, item.ip, 0});
+          if (doNotTaken)
+            work.push_back({WorkItem::Follow, loop->notTakenTarget, 0});
+          if (doLoopBody && (loop->greedy || !doNotTaken))
+            work.push_back({WorkItem::EnterLoopBody, item.ip, 0});
+          break;
+        }
+
+        case Opcode::EndLoop: {
+          // An iteration has finished, so the minimum has been reached.
+          uint32_t loopIp = llvm::cast<EndLoopInsn>(base)->target;
+          const BeginLoopInsn *loop =
+              llvm::cast<BeginLoopInsn>(
+              reinterpret_cast<const Insn *>(&bytecode[loopIp]));
+          bool doLoopBody = loop->max != 1;
+          if (doLoopBody && !loop->greedy)
+            work.push_back({WorkItem::EnterLoopBody, loopIp, 0});
+          work.push_back({WorkItem::Follow, loop->notTakenTarget, 0});
+          if (doLoopBody && loop->greedy)
+            work.push_back({WorkItem::EnterLoopBody, loopIp, 0});
+          break;
+        }
+
+        case Opcode::BeginSimpleLoop: {
+          const BeginSimpleLoopInsn *loop =
+              llvm::cast<BeginSimpleLoopInsn>(base);
+          work.push_back({WorkItem::Follow, loop->notTakenTarget, 0});
+          if (flagsSatisfyConstraints(flags_, loop->loopeeConstraints))
+            work.push_back(
+                {WorkItem::Follow,
+                 item.ip + (uint32_t)sizeof(BeginSimpleLoopInsn),
+                 0});
+          break;
+        }
+
+        case Opcode::EndSimpleLoop:
+          // Going around again behaves just like entering the loop.
+          work.push_back(
+              {WorkItem::Follow,
+               llvm::cast<EndSimpleLoopInsn>(base)->target,
+               0});
+          break;
+
+        case Opcode::Width1Loop: {
+          const Width1LoopInsn *loop = llvm::cast<Width1LoopInsn>(base);
+          // Past the minimum, the count of an unbounded loop no longer makes
+          // a difference.
+          uint32_t bound = loop->max == infinite ? loop->min : loop->max;
+          uint32_t count = std::min(item.value, bound);
+          uint32_t &firstId = width1LoopIds[loop->loopId];
+          if (firstId == 0) {
+            firstId = visited.size();
+            visited.resize(visited.size() + bound + 1, 0);
+          }
+          if (!markVisited(firstId + count))
+            break;
+          bool doLoopBody = count < loop->max;
+          bool doNotTaken = count >= loop->min;
+          if (doLoopBody && doNotTaken && !loop->greedy)
+            work.push_back({WorkItem::AddWidth1LoopThread, item.ip, count});
+          if (doNotTaken)
+            work.push_back({WorkItem::Follow, loop->notTakenTarget, 0});
+          if (doLoopBody && (loop->greedy || !doNotTaken))
+            work.push_back({WorkItem::AddWidth1LoopThread, item.ip, count});
+          break;
+        }
+
+        case Opcode::BackRef:
+        case Opcode::Lookahead:
+          llvm_unreachable("Opcode cannot be run without backtracking");
+      }
+    }
+  };
+
+  auto width1InsnWidth = [](const Insn *insn) -> uint32_t {
+    switch (static_cast<Width1Opcode>(insn->opcode)) {
+      case Width1Opcode::MatchChar8:
+        return sizeof(MatchChar8Insn);
+      case Width1Opcode::MatchChar16:
+        return sizeof(MatchChar16Insn);
+      case Width1Opcode::MatchCharICase8:
+        return sizeof(MatchCharICase8Insn);
+      case Width1Opcode::MatchCharICase16:
+        return sizeof(MatchCharICase16Insn);
+      case Width1Opcode::MatchAnyButNewline:
+        return sizeof(MatchAnyButNewlineInsn);
+      case Width1Opcode::Bracket:
+        return llvm::cast<BracketInsn>(insn)->totalWidth();
+    }
+    llvm_unreachable("Invalid width 1 opcode");
+  };
+
+  ThreadList current, next;
+  bool matched = false;
+  std::vector<uint32_t> matchSlots;
+  const CharT *matchEnd = nullptr;
+
+  for (const CharT *pos = startLoc;; pos++) {
+    // Start a match at this position, after all the ones started earlier.
+    if (!matched && (!onlyAtStart || pos == startLoc)) {
+      if (current.threads.empty() && !onlyAtStart && header->prefixLength) {
+        // Nothing is under way, so skip to where the literal prefix occurs.
+        const CharT *candidate = findLiteralPrefix(
+            pos, last_, header->prefix, header->prefixLength);
+        if (!candidate)
+          break;
+        if (candidate != pos) {
+          pos = candidate;
+          generation++;
+        }
+      }
+      std::fill(slots.begin(), slots.end(), kNotMatched);
+      slots[matchStartSlot] = pos - first_;
+      follow(current, startIp, 0, pos);
+    }
+    if (current.threads.empty()) {
+      if (matched || onlyAtStart || pos == last_)
+        break;
+      generation++;
+      continue;
+    }
+
+    // Advance every thread past the character at pos, in order.
+    generation++;
+    next.clear();
+    for (size_t i = 0, e = current.threads.size(); i < e; i++) {
+      const Thread &thread = current.threads[i];
+      const uint32_t *threadSlots = &current.slots[i * slotCount];
+      const Insn *base = reinterpret_cast<const Insn *>(&bytecode[thread.ip]);
+      if (base->opcode == Opcode::Goal) {
+        // The threads after this one would only be tried if it failed.
+        matched = true;
+        matchSlots.assign(threadSlots, threadSlots + slotCount);
+        matchEnd = pos;
+        break;
+      }
+      if (pos == last_)
+        continue;
+      uint32_t nextIp;
+      uint32_t iterations = 0;
+      if (base->opcode == Opcode::Width1Loop) {
+        if (!matchWidth1Insn(
+                static_cast<const Insn *>(
+                    &llvm::cast<Width1LoopInsn>(base)[1]),
+                *pos))
+          continue;
+        nextIp = thread.ip;
+        iterations = thread.iterations + 1;
+      } else {
+        if (!matchWidth1Insn(base, *pos))
+          continue;
+        nextIp = thread.ip + width1InsnWidth(base);
+      }
+      std::copy(threadSlots, threadSlots + slotCount, slots.begin());
+      follow(next, nextIp, iterations, pos + 1);
+    }
+    std::swap(current, next);
+    if (pos == last_)
+      break;
+  }
+
+  if (!matched)
+    return nullptr;
+  s->current_ = matchEnd;
+  for (uint32_t idx = 0; idx < markedCount_; idx++)
+    s->getCapturedRange(idx) = {matchSlots[2 * idx], matchSlots[2 * idx + 1]};
+  return first_ + matchSlots[matchStartSlot];
+}
+
 /// Entry point for searching a string via regex compiled bytecode.
 /// Given the bytecode \p bytecode, search the range starting at \p first up to
 /// (not including) \p last with the flags \p matchFlags. If the search
@@ -1122,7 +1619,28 @@ MatchRuntimeResult searchWithBytecodeImpl(
   State<Traits> state{markedCount, loopCount};
   bool onlyAtStart = header->constraints & MatchConstraintAnchoredAtStart;
   auto result = MatchRuntimeResult::NoMatch;
-  if (const CharT *matchStartLoc = ctx.match(&state, ctx.first_, onlyAtStart)) {
+  const CharT *matchStartLoc = nullptr;
+  if (header->linearTime) {
+    matchStartLoc = ctx.matchLinear(&state, ctx.first_, onlyAtStart);
+  } else if (onlyAtStart || header->prefixLength == 0) {
+    matchStartLoc = ctx.match(&state, ctx.first_, onlyAtStart);
+  } else {
+    // Every match starts with the literal prefix, so only try to match where
+    // it occurs.
+    const auto startIp = state.ip_;
+    for (const CharT *pos = ctx.first_;
+         (pos = findLiteralPrefix(
+              pos, ctx.last_, header->prefix, header->prefixLength));
+         ++pos) {
+      // Like match() does between positions, restart from the first
+      // instruction.
+      state.ip_ = startIp;
+      matchStartLoc = ctx.match(&state, pos, true /* onlyAtStart */);
+      if (matchStartLoc || ctx.error_ != MatchRuntimeErrorType::None)
+        break;
+    }
+  }
+  if (matchStartLoc) {
     // Match succeeded.
     m.resize(1 + markedCount);
     m[0].first = matchStartLoc;
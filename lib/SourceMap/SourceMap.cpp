@@ -6,21 +6,31 @@
  */
 #include "hermes/SourceMap/SourceMap.h"
 
+#include "hermes/Support/Base64vlq.h"
+
+#include "llvm/Support/MathExtras.h"
+
+#include <algorithm>
+
 using namespace hermes;
 
 namespace hermes {
 
+constexpr char SourceMap::kIndexMagic[8];
+constexpr uint32_t SourceMap::kIndexByteOrder;
+constexpr uint32_t SourceMap::kNotDecoded;
+
 llvm::Optional<SourceMapTextLocation> SourceMap::getLocationForAddress(
     uint32_t line,
     uint32_t column) {
-  if (line == 0 || line > lines_.size()) {
+  if (line == 0 || line > getNumLines()) {
     return llvm::None;
   }
 
   // line is 1-based.
   uint32_t lineIndex = line - 1;
-  auto &segments = lines_[lineIndex];
-  if (segments.empty()) {
+  LineView segments = getLine(lineIndex);
+  if (segments.size == 0) {
     return llvm::None;
   }
   assert(column >= 1 && "the column argument to this function is 1-based");
@@ -29,35 +39,145 @@ llvm::Optional<SourceMapTextLocation> SourceMap::getLocationForAddress(
   // the needle(`column`) -- segment.generatedColumn <= column.
   // We achieve it by binary searching the first sentinel
   // segment strictly greater than needle(`column`) and then move backward
-  // one slot.
-  auto segIter = std::upper_bound(
-      segments.begin(),
-      segments.end(),
+  // one slot. Only the column of generated columns is touched.
+  const int32_t *segIter = std::upper_bound(
+      segments.generatedColumn,
+      segments.generatedColumn + segments.size,
       columnIndex,
-      [](uint32_t column, const Segment &seg) {
-        return column < (uint32_t)seg.generatedColumn;
+      [](uint32_t column, int32_t generatedColumn) {
+        return column < (uint32_t)generatedColumn;
       });
   // The found sentinal segment is the first one. No covering segment.
-  if (segIter == segments.begin()) {
+  if (segIter == segments.generatedColumn) {
     return llvm::None;
   }
   // Move back one slot.
-  const Segment &target =
-      segIter == segments.end() ? segments.back() : *(--segIter);
+  uint32_t target = segIter - segments.generatedColumn - 1;
   // Unmapped location
-  if (!target.representedLocation.hasValue()) {
+  if (segments.sourceIndex[target] < 0) {
     return llvm::None;
   }
-  // parseSegment() should have validated this.
+  // The parser should have validated this.
   assert(
-      (size_t)target.representedLocation->sourceIndex < sources_.size() &&
+      (size_t)segments.sourceIndex[target] < sources_.size() &&
       "SourceIndex is out-of-range.");
-  std::string fileName =
-      getSourceFullPath(target.representedLocation->sourceIndex);
-  return SourceMapTextLocation{
-      std::move(fileName),
-      (uint32_t)target.representedLocation->lineIndex + 1,
-      (uint32_t)target.representedLocation->columnIndex + 1};
+  std::string fileName = getSourceFullPath(segments.sourceIndex[target]);
+  return SourceMapTextLocation{std::move(fileName),
+                               (uint32_t)segments.lineIndex[target] + 1,
+                               (uint32_t)segments.columnIndex[target] + 1};
+}
+
+SourceMap::LineView SourceMap::getLine(uint32_t lineIndex) {
+  assert(lineIndex < getNumLines() && "line out of range");
+  if (index_) {
+    auto *lineBegins = reinterpret_cast<const uint32_t *>(index_ + 1);
+    auto *columns =
+        reinterpret_cast<const int32_t *>(lineBegins + index_->numLines + 1);
+    uint32_t begin = lineBegins[lineIndex];
+    uint32_t numSegments = index_->numSegments;
+    return LineView{columns + begin,
+                    columns + numSegments + begin,
+                    columns + 2 * numSegments + begin,
+                    columns + 3 * numSegments + begin,
+                    lineBegins[lineIndex + 1] - begin};
+  }
+  if (decodedLines_[lineIndex].first == kNotDecoded) {
+    decodeLine(lineIndex);
+  }
+  uint32_t begin = decodedLines_[lineIndex].first;
+  return LineView{generatedColumns_.data() + begin,
+                  sourceIndices_.data() + begin,
+                  lineIndices_.data() + begin,
+                  columnIndices_.data() + begin,
+                  decodedLines_[lineIndex].second};
+}
+
+void SourceMap::decodeLine(uint32_t lineIndex) {
+  const LineStart &start = lineStarts_[lineIndex];
+  const char *pCur = mappings_.data() + start.offset;
+  const char *pLineEnd =
+      std::find(pCur, mappings_.data() + mappings_.size(), ';');
+
+  int32_t generatedColumn = 0;
+  int32_t sourceIndex = start.sourceIndex;
+  int32_t representedLine = start.lineIndex;
+  int32_t representedColumn = start.columnIndex;
+  uint32_t begin = generatedColumns_.size();
+  // The parser has validated the mappings, so every segment has 1, 4 or 5
+  // fields. The name index is not looked up, so it isn't decoded.
+  while (pCur < pLineEnd) {
+    const char *pSegEnd = std::find(pCur, pLineEnd, ',');
+    generatedColumn += base64vlq::decode(pCur, pSegEnd).getValue();
+    generatedColumns_.push_back(generatedColumn);
+    OptValue<int32_t> val = base64vlq::decode(pCur, pSegEnd);
+    if (val.hasValue()) {
+      sourceIndex += val.getValue();
+      representedLine += base64vlq::decode(pCur, pSegEnd).getValue();
+      representedColumn += base64vlq::decode(pCur, pSegEnd).getValue();
+      sourceIndices_.push_back(sourceIndex);
+      lineIndices_.push_back(representedLine);
+      columnIndices_.push_back(representedColumn);
+    } else {
+      sourceIndices_.push_back(-1);
+      lineIndices_.push_back(0);
+      columnIndices_.push_back(0);
+    }
+    pCur = pSegEnd + 1;
+  }
+  decodedLines_[lineIndex] =
+      std::make_pair(begin, uint32_t(generatedColumns_.size() - begin));
+}
+
+/// Write the length of \p str and its characters to \p OS, padded to a
+/// multiple of 4 bytes.
+static void writeIndexString(llvm::raw_ostream &OS, llvm::StringRef str) {
+  uint32_t size = str.size();
+  OS.write(reinterpret_cast<const char *>(&size), sizeof(size));
+  OS << str;
+  OS.write_zeros(llvm::alignTo(size, sizeof(uint32_t)) - size);
+}
+
+void SourceMap::writeIndex(llvm::raw_ostream &OS) {
+  const uint32_t numLines = getNumLines();
+  std::vector<uint32_t> lineBegins;
+  lineBegins.reserve(numLines + 1);
+  // Gather the segments in line order, whatever order they were decoded in.
+  std::vector<int32_t> columns[4];
+  for (uint32_t i = 0; i < numLines; ++i) {
+    lineBegins.push_back(columns[0].size());
+    LineView line = getLine(i);
+    columns[0].insert(
+        columns[0].end(),
+        line.generatedColumn,
+        line.generatedColumn + line.size);
+    columns[1].insert(
+        columns[1].end(), line.sourceIndex, line.sourceIndex + line.size);
+    columns[2].insert(
+        columns[2].end(), line.lineIndex, line.lineIndex + line.size);
+    columns[3].insert(
+        columns[3].end(), line.columnIndex, line.columnIndex + line.size);
+  }
+  lineBegins.push_back(columns[0].size());
+
+  IndexHeader header;
+  std::copy(std::begin(kIndexMagic), std::end(kIndexMagic), header.magic);
+  header.byteOrder = kIndexByteOrder;
+  header.numSources = sources_.size();
+  header.numLines = numLines;
+  header.numSegments = columns[0].size();
+  OS.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  OS.write(
+      reinterpret_cast<const char *>(lineBegins.data()),
+      lineBegins.size() * sizeof(uint32_t));
+  for (const std::vector<int32_t> &column : columns) {
+    OS.write(
+        reinterpret_cast<const char *>(column.data()),
+        column.size() * sizeof(int32_t));
+  }
+  writeIndexString(OS, sourceRoot_);
+  for (const std::string &source : sources_) {
+    writeIndexString(OS, source);
+  }
 }
 
 } // namespace hermes
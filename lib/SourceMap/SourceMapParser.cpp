@@ -9,7 +9,10 @@
 #include "hermes/Parser/JSONParser.h"
 #include "hermes/Support/Base64vlq.h"
 
+#include "llvm/Support/MathExtras.h"
+
 #include <algorithm>
+#include <cstring>
 
 using namespace hermes;
 using namespace hermes::parser;
@@ -75,21 +78,103 @@ std::unique_ptr<SourceMap> SourceMapParser::parse(
     return nullptr;
   }
 
-  std::vector<SourceMap::SegmentList> lines;
-  bool succeed = parseMappings(mappings->str(), lines);
+  // Only validate the mappings and find where each line starts. The segments
+  // of a line are decoded when it is first looked up.
+  std::vector<SourceMap::LineStart> lineStarts;
+  bool succeed = parseMappings(mappings->str(), sources.size(), lineStarts);
   if (!succeed) {
     return nullptr;
   }
   return llvm::make_unique<SourceMap>(
-      sourceRoot, std::move(sources), std::move(lines));
+      sourceRoot,
+      std::move(sources),
+      mappings->str().str(),
+      std::move(lineStarts));
+}
+
+std::unique_ptr<SourceMap> SourceMapParser::parseIndex(
+    std::unique_ptr<llvm::MemoryBuffer> buffer) {
+  using IndexHeader = SourceMap::IndexHeader;
+  const char *begin = buffer->getBufferStart();
+  const char *end = buffer->getBufferEnd();
+  // The columns are read in place, so they must be aligned.
+  if (reinterpret_cast<uintptr_t>(begin) % alignof(uint32_t) != 0 ||
+      (size_t)(end - begin) < sizeof(IndexHeader)) {
+    return nullptr;
+  }
+  auto *header = reinterpret_cast<const IndexHeader *>(begin);
+  if (!std::equal(
+          std::begin(header->magic),
+          std::end(header->magic),
+          std::begin(SourceMap::kIndexMagic)) ||
+      header->byteOrder != SourceMap::kIndexByteOrder) {
+    return nullptr;
+  }
+
+  // Check the sizes in 64 bits, so that they can't overflow.
+  uint64_t tableSize = sizeof(uint32_t) * ((uint64_t)header->numLines + 1) +
+      sizeof(int32_t) * 4 * (uint64_t)header->numSegments;
+  if (tableSize > (uint64_t)(end - begin) - sizeof(IndexHeader)) {
+    return nullptr;
+  }
+  auto *lineBegins = reinterpret_cast<const uint32_t *>(header + 1);
+  if (lineBegins[header->numLines] != header->numSegments) {
+    return nullptr;
+  }
+  for (uint32_t i = 0; i < header->numLines; ++i) {
+    if (lineBegins[i] > lineBegins[i + 1]) {
+      return nullptr;
+    }
+  }
+  auto *sourceIndices = reinterpret_cast<const int32_t *>(
+                            lineBegins + header->numLines + 1) +
+      header->numSegments;
+  for (uint32_t i = 0; i < header->numSegments; ++i) {
+    if (sourceIndices[i] >= (int32_t)header->numSources) {
+      return nullptr;
+    }
+  }
+
+  const char *cur = begin + sizeof(IndexHeader) + tableSize;
+  // Read a string written by writeIndexString() into \p str.
+  auto readString = [&cur, end](std::string &str) {
+    uint32_t size;
+    if ((size_t)(end - cur) < sizeof(size)) {
+      return false;
+    }
+    std::memcpy(&size, cur, sizeof(size));
+    cur += sizeof(size);
+    if ((size_t)(end - cur) < size) {
+      return false;
+    }
+    str.assign(cur, size);
+    cur += std::min<size_t>(llvm::alignTo(size, sizeof(uint32_t)), end - cur);
+    return true;
+  };
+  std::string sourceRoot;
+  if (!readString(sourceRoot)) {
+    return nullptr;
+  }
+  std::vector<std::string> sources(header->numSources);
+  for (std::string &source : sources) {
+    if (!readString(source)) {
+      return nullptr;
+    }
+  }
+
+  return std::unique_ptr<SourceMap>(new SourceMap(
+      std::move(sourceRoot), std::move(sources), std::move(buffer), header));
 }
 
 bool SourceMapParser::parseMappings(
     llvm::StringRef sourceMappings,
-    std::vector<SourceMap::SegmentList> &lines) {
-  assert(lines.empty() && "lines is an out parameter so should be empty");
-  SourceMap::SegmentList segments;
+    size_t numSources,
+    std::vector<SourceMap::LineStart> &lineStarts) {
+  assert(
+      lineStarts.empty() &&
+      "lineStarts is an out parameter so should be empty");
   State state;
+  lineStarts.push_back(SourceMap::LineStart{0, 0, 0, 0});
 
   uint32_t curSegOffset = 0;
   while (curSegOffset < sourceMappings.size()) {
@@ -107,10 +192,9 @@ bool SourceMapParser::parseMappings(
     const char *pCur = sourceMappings.data() + curSegOffset;
     const char *pSegEnd = sourceMappings.data() + endSegOffset;
 
-    if (pCur == pSegEnd && lastSegmentInLine && segments.empty()) {
-      // The line is empty, so avoid doing any extra work.
-      lines.emplace_back(std::move(segments));
-    } else {
+    // An empty line has no segment to check.
+    if (pCur != pSegEnd || !lastSegmentInLine ||
+        curSegOffset != lineStarts.back().offset) {
       llvm::Optional<SourceMap::Segment> segmentOpt =
           parseSegment(state, pCur, pSegEnd);
       if (!segmentOpt.hasValue()) {
@@ -119,6 +203,11 @@ bool SourceMapParser::parseMappings(
 
       state.generatedColumn = segmentOpt->generatedColumn;
       if (segmentOpt->representedLocation.hasValue()) {
+        if (segmentOpt->representedLocation->sourceIndex < 0 ||
+            (size_t)segmentOpt->representedLocation->sourceIndex >=
+                numSources) {
+          return false;
+        }
         state.sourceIndex = segmentOpt->representedLocation->sourceIndex;
         state.representedLine = segmentOpt->representedLocation->lineIndex;
         state.representedColumn = segmentOpt->representedLocation->columnIndex;
@@ -129,19 +218,23 @@ bool SourceMapParser::parseMappings(
         }
       }
 
-      segments.emplace_back(segmentOpt.getValue());
-
       // TODO: assert pCur equals to pSegEnd.
+    }
 
-      if (lastSegmentInLine) {
-        // generated column should be reset for new line.
-        state.generatedColumn = 0;
-
-        lines.emplace_back(std::move(segments));
-      }
+    if (lastSegmentInLine && endSegOffset != sourceMappings.size()) {
+      // generated column should be reset for new line.
+      state.generatedColumn = 0;
+      lineStarts.push_back(SourceMap::LineStart{(uint32_t)endSegOffset + 1,
+                                                state.sourceIndex,
+                                                state.representedLine,
+                                                state.representedColumn});
     }
     curSegOffset = endSegOffset + 1;
   }
+  // A ";" at the very end doesn't start another line.
+  if (lineStarts.back().offset == sourceMappings.size()) {
+    lineStarts.pop_back();
+  }
   return true;
 }
 
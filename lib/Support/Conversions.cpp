@@ -5,9 +5,15 @@
  * file in the root directory of this source tree.
  */
 #include "hermes/Support/Conversions.h"
-#include <cmath>
+#include "hermes/Support/FastDtoa.h"
 #include "hermes/dtoa/dtoa.h"
 
+#include "llvm/Support/Endian.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
 namespace hermes {
 
 /// Convert a double to a 32-bit integer according to ES5.1 section 9.5.
@@ -52,54 +58,18 @@ int32_t truncateToInt32SlowPath(double d) {
   }
 }
 
-/// ES5.1 9.8.1
-size_t numberToString(double m, char *dest, size_t destSize) {
-  assert(destSize >= NUMBER_TO_STRING_BUF_SIZE);
-  (void)destSize;
-
-  if (std::isnan(m)) {
-    strcpy(dest, "NaN");
-    return 3;
-  }
-
-  if (m == 0) {
-    strcpy(dest, "0");
-    return 1;
-  }
-
-  if (m == std::numeric_limits<double>::infinity()) {
-    strcpy(dest, "Infinity");
-    return 8;
-  }
-  if (m == -std::numeric_limits<double>::infinity()) {
-    strcpy(dest, "-Infinity");
-    return 9;
-  }
-
-  // After special cases, run dtoa to convert.
-  // We do this manually because we need all of the output of dtoa.
-  // Note that n, k, s are defined per ES5.1 9.8.1
-
+/// Write the number with the decimal digits \p s of length \p k and the
+/// decimal point at \p n (per ES5.1 9.8.1) to \p dest, which must hold at
+/// least NUMBER_TO_STRING_BUF_SIZE characters.
+/// \return the length of the generated string (excluding the terminating zero).
+static size_t
+formatNumber(char *dest, bool negative, const char *s, int k, int n) {
   // Iterator for easier population.
   char *destPtr = dest;
 
-  // Decimal point index.
-  int n;
-
-  // 1 if negative, 0 else.
-  int sign;
-
-  // Points to the end of the string s after it's populated.
-  char *sEnd;
-
-  char *s = ::g_dtoa(m, 0, 0, &n, &sign, &sEnd);
-
-  if (sign)
+  if (negative)
     *destPtr++ = '-';
 
-  // Length of decimal representation of s.
-  int k = sEnd - s;
-
   if (k <= n && n <= 21) {
     // Step 6 of 9.8.1.
     for (int i = 0; i < k; ++i) {
@@ -158,8 +128,248 @@ size_t numberToString(double m, char *dest, size_t destSize) {
   // Null-terminate
   *destPtr++ = '\0';
   assert(static_cast<size_t>(destPtr - dest) < NUMBER_TO_STRING_BUF_SIZE);
+  return destPtr - dest - 1;
+}
+
+/// ES5.1 9.8.1
+size_t numberToString(double m, char *dest, size_t destSize) {
+  assert(destSize >= NUMBER_TO_STRING_BUF_SIZE);
+  (void)destSize;
+
+  if (std::isnan(m)) {
+    strcpy(dest, "NaN");
+    return 3;
+  }
+
+  if (m == 0) {
+    strcpy(dest, "0");
+    return 1;
+  }
+
+  if (m == std::numeric_limits<double>::infinity()) {
+    strcpy(dest, "Infinity");
+    return 8;
+  }
+  if (m == -std::numeric_limits<double>::infinity()) {
+    strcpy(dest, "-Infinity");
+    return 9;
+  }
+
+  bool negative = m < 0;
+
+  // Integers below 2^53 are exact, so their digits are all there is to print.
+  if (std::fabs(m) < 9007199254740992.0 && m == std::trunc(m)) {
+    char *destPtr = dest;
+    if (negative)
+      *destPtr++ = '-';
+    uint64_t n = static_cast<uint64_t>(std::fabs(m));
+    char digits[NUMBER_TO_STRING_BUF_SIZE];
+    char *p = digits + sizeof(digits);
+    do {
+      *--p = '0' + n % 10;
+      n /= 10;
+    } while (n);
+    size_t len = digits + sizeof(digits) - p;
+    memcpy(destPtr, p, len);
+    destPtr[len] = '\0';
+    return destPtr + len - dest;
+  }
+
+  // Note that n, k, s are defined per ES5.1 9.8.1
+
+  // Number of digits.
+  int k;
+
+  // Decimal point index.
+  int n;
+
+  // Try the fast shortest conversion first, and fall back to dtoa in the rare
+  // cases where it can't tell which digits are correct.
+  char fastDigits[FAST_DTOA_BUF_SIZE];
+  if (fastShortestDtoa(std::fabs(m), fastDigits, &k, &n))
+    return formatNumber(dest, negative, fastDigits, k, n);
 
+  // 1 if negative, 0 else.
+  int sign;
+
+  // Points to the end of the string s after it's populated.
+  char *sEnd;
+
+  char *s = ::g_dtoa(m, 0, 0, &n, &sign, &sEnd);
+  k = sEnd - s;
+  size_t len = formatNumber(dest, negative, s, k, n);
   g_freedtoa(s);
-  return destPtr - dest - 1;
+  return len;
+}
+
+namespace {
+
+/// Maximum number of significant decimal digits which always fit in a
+/// uint64_t.
+constexpr unsigned kMaxFastDigits = 19;
+
+/// Powers of ten which are exactly representable as doubles.
+constexpr double kExactPowersOfTen[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+constexpr int kMaxExactPowerOfTen = 22;
+
+inline bool isDecimalDigit(char16_t c) {
+  return c >= u'0' && c <= u'9';
+}
+
+/// \return whether the 8 bytes of \p chunk, loaded little endian, are all
+/// ASCII digits.
+inline bool isEightDigits(uint64_t chunk) {
+  return (((chunk + 0x4646464646464646u) | (chunk - 0x3030303030303030u)) &
+          0x8080808080808080u) == 0;
 }
+
+/// \return the value of the 8 ASCII digits in \p chunk, loaded little endian,
+/// with three multiplications instead of eight.
+inline uint32_t parseEightDigits(uint64_t chunk) {
+  constexpr uint64_t mask = 0x000000FF000000FFu;
+  constexpr uint64_t mul1 = 100 + (1000000ull << 32);
+  constexpr uint64_t mul2 = 1 + (10000ull << 32);
+  chunk -= 0x3030303030303030u;
+  // Combine adjacent digits into pairs, then pairs into groups of four.
+  chunk = (chunk * 10) + (chunk >> 8);
+  return (uint32_t)(
+      (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32);
+}
+
+/// Accumulate the digits at \p p into \p mantissa, counting them in
+/// \p numDigits. Leading zeros of the mantissa are skipped, and digits past
+/// kMaxFastDigits are counted but not accumulated.
+/// \return the end of the digits.
+template <typename CharT>
+const CharT *accumulateDigits(
+    const CharT *p,
+    const CharT *end,
+    uint64_t &mantissa,
+    unsigned &numDigits) {
+  if (mantissa == 0) {
+    while (p != end && *p == '0')
+      ++p;
+  }
+  // One byte characters can be consumed eight at a time.
+  if (sizeof(CharT) == 1) {
+    while (end - p >= 8 && numDigits + 8 <= kMaxFastDigits) {
+      uint64_t chunk = llvm::support::endian::read64le(p);
+      if (!isEightDigits(chunk))
+        break;
+      mantissa = mantissa * 100000000 + parseEightDigits(chunk);
+      numDigits += 8;
+      p += 8;
+    }
+  }
+  for (; p != end && isDecimalDigit(*p); ++p) {
+    if (numDigits < kMaxFastDigits)
+      mantissa = mantissa * 10 + (*p - '0');
+    ++numDigits;
+  }
+  return p;
+}
+
+template <typename CharT>
+OptValue<double> parseDecimalFastImpl(
+    const CharT *begin,
+    const CharT *end,
+    const CharT **parsedEnd) {
+  const CharT *p = begin;
+  bool negative = false;
+  if (p != end && (*p == '+' || *p == '-')) {
+    negative = *p == '-';
+    ++p;
+  }
+
+  uint64_t mantissa = 0;
+  unsigned numDigits = 0;
+  // The value is mantissa * 10**exp10.
+  int64_t exp10 = 0;
+
+  const CharT *intStart = p;
+  p = accumulateDigits(p, end, mantissa, numDigits);
+  bool anyDigits = p != intStart;
+  if (p != end && *p == '.') {
+    const CharT *fracStart = ++p;
+    p = accumulateDigits(p, end, mantissa, numDigits);
+    exp10 -= p - fracStart;
+    anyDigits |= p != fracStart;
+  }
+  if (!anyDigits)
+    return llvm::None;
+
+  if (p != end && (*p == 'e' || *p == 'E')) {
+    const CharT *expStart = p++;
+    bool expNegative = false;
+    if (p != end && (*p == '+' || *p == '-')) {
+      expNegative = *p == '-';
+      ++p;
+    }
+    if (p == end || !isDecimalDigit(*p)) {
+      // Not an exponent, the number ends before the 'e'.
+      p = expStart;
+    } else {
+      int64_t exp = 0;
+      for (; p != end && isDecimalDigit(*p); ++p) {
+        // Saturate, anything this large is out of range for the fast path.
+        if (exp < 100000)
+          exp = exp * 10 + (*p - '0');
+      }
+      exp10 += expNegative ? -exp : exp;
+    }
+  }
+
+  if (mantissa == 0 && numDigits == 0) {
+    *parsedEnd = p;
+    return negative ? -0.0 : 0.0;
+  }
+  if (numDigits > kMaxFastDigits || mantissa > (uint64_t(1) << 53))
+    return llvm::None;
+
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD > 1
+  // Intermediate results are computed in extended precision and rounding
+  // them again could be off by one ulp. Only exact integers are safe.
+  if (exp10 != 0)
+    return llvm::None;
+#endif
+
+  // The mantissa and the power of ten are both exact, so a single operation
+  // rounds correctly (Clinger's fast path).
+  double value = (double)mantissa;
+  if (exp10 < 0) {
+    if (exp10 < -kMaxExactPowerOfTen)
+      return llvm::None;
+    value /= kExactPowersOfTen[-exp10];
+  } else {
+    if (exp10 > kMaxExactPowerOfTen) {
+      // A short mantissa can absorb part of the scale exactly.
+      if (exp10 > kMaxExactPowerOfTen + 15)
+        return llvm::None;
+      value *= kExactPowersOfTen[exp10 - kMaxExactPowerOfTen];
+      if (value > 9007199254740992.0)
+        return llvm::None;
+      exp10 = kMaxExactPowerOfTen;
+    }
+    value *= kExactPowersOfTen[exp10];
+  }
+  *parsedEnd = p;
+  return negative ? -value : value;
+}
+
+} // namespace
+
+OptValue<double>
+parseDecimalFast(const char *begin, const char *end, const char **parsedEnd) {
+  return parseDecimalFastImpl(begin, end, parsedEnd);
+}
+
+OptValue<double> parseDecimalFast(
+    const char16_t *begin,
+    const char16_t *end,
+    const char16_t **parsedEnd) {
+  return parseDecimalFastImpl(begin, end, parsedEnd);
+}
+
 } // namespace hermes
@@ -0,0 +1,364 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/Support/FastDtoa.h"
+
+#include "hermes/Support/Conversions.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+namespace hermes {
+
+namespace {
+
+/// A floating point number f * 2^e with a 64-bit significand ("do it yourself
+/// floating point").
+struct DiyFp {
+  uint64_t f;
+  int e;
+
+  DiyFp(uint64_t f, int e) : f(f), e(e) {}
+
+  /// \return this - \p other, which must have the same exponent and a smaller
+  /// significand.
+  DiyFp minus(DiyFp other) const {
+    assert(e == other.e && f >= other.f && "invalid DiyFp subtraction");
+    return DiyFp(f - other.f, e);
+  }
+
+  /// \return the product of this and \p other, rounded to 64 bits.
+  DiyFp times(DiyFp other) const {
+    const uint64_t M32 = 0xFFFFFFFFu;
+    uint64_t a = f >> 32, b = f & M32;
+    uint64_t c = other.f >> 32, d = other.f & M32;
+    uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+    // Add 1/2 of the low word to round the result.
+    uint64_t tmp = (bd >> 32) + (ad & M32) + (bc & M32) + (1u << 31);
+    return DiyFp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), e + other.e + 64);
+  }
+
+  /// \return this with the highest bit of the significand set.
+  DiyFp normalize() const {
+    assert(f != 0 && "cannot normalize zero");
+    uint64_t nf = f;
+    int ne = e;
+    while (!(nf & (1ull << 63))) {
+      nf <<= 1;
+      --ne;
+    }
+    return DiyFp(nf, ne);
+  }
+};
+
+constexpr uint64_t kHiddenBit = 1ull << 52;
+constexpr uint64_t kSignificandMask = kHiddenBit - 1;
+constexpr int kExponentBias = 0x3FF + 52;
+constexpr int kDenormalExponent = 1 - kExponentBias;
+
+/// The exact value of a positive finite double.
+DiyFp toDiyFp(double v) {
+  uint64_t bits = safeTypeCast<double, uint64_t>(v);
+  uint64_t significand = bits & kSignificandMask;
+  int biasedExponent = static_cast<int>(bits >> 52);
+  if (biasedExponent == 0)
+    return DiyFp(significand, kDenormalExponent);
+  return DiyFp(significand | kHiddenBit, biasedExponent - kExponentBias);
+}
+
+/// A power of ten, 10^decimalExponent ~= significand * 2^binaryExponent.
+struct CachedPower {
+  uint64_t significand;
+  int16_t binaryExponent;
+  int16_t decimalExponent;
+};
+
+/// Normalized powers of ten from 10^-348 to 10^340, rounded to 64 bits.
+const CachedPower kCachedPowers[] = {
+    {0xfa8fd5a0081c0288, -1220, -348},
+    {0xbaaee17fa23ebf76, -1193, -340},
+    {0x8b16fb203055ac76, -1166, -332},
+    {0xcf42894a5dce35ea, -1140, -324},
+    {0x9a6bb0aa55653b2d, -1113, -316},
+    {0xe61acf033d1a45df, -1087, -308},
+    {0xab70fe17c79ac6ca, -1060, -300},
+    {0xff77b1fcbebcdc4f, -1034, -292},
+    {0xbe5691ef416bd60c, -1007, -284},
+    {0x8dd01fad907ffc3c, -980, -276},
+    {0xd3515c2831559a83, -954, -268},
+    {0x9d71ac8fada6c9b5, -927, -260},
+    {0xea9c227723ee8bcb, -901, -252},
+    {0xaecc49914078536d, -874, -244},
+    {0x823c12795db6ce57, -847, -236},
+    {0xc21094364dfb5637, -821, -228},
+    {0x9096ea6f3848984f, -794, -220},
+    {0xd77485cb25823ac7, -768, -212},
+    {0xa086cfcd97bf97f4, -741, -204},
+    {0xef340a98172aace5, -715, -196},
+    {0xb23867fb2a35b28e, -688, -188},
+    {0x84c8d4dfd2c63f3b, -661, -180},
+    {0xc5dd44271ad3cdba, -635, -172},
+    {0x936b9fcebb25c996, -608, -164},
+    {0xdbac6c247d62a584, -582, -156},
+    {0xa3ab66580d5fdaf6, -555, -148},
+    {0xf3e2f893dec3f126, -529, -140},
+    {0xb5b5ada8aaff80b8, -502, -132},
+    {0x87625f056c7c4a8b, -475, -124},
+    {0xc9bcff6034c13053, -449, -116},
+    {0x964e858c91ba2655, -422, -108},
+    {0xdff9772470297ebd, -396, -100},
+    {0xa6dfbd9fb8e5b88f, -369, -92},
+    {0xf8a95fcf88747d94, -343, -84},
+    {0xb94470938fa89bcf, -316, -76},
+    {0x8a08f0f8bf0f156b, -289, -68},
+    {0xcdb02555653131b6, -263, -60},
+    {0x993fe2c6d07b7fac, -236, -52},
+    {0xe45c10c42a2b3b06, -210, -44},
+    {0xaa242499697392d3, -183, -36},
+    {0xfd87b5f28300ca0e, -157, -28},
+    {0xbce5086492111aeb, -130, -20},
+    {0x8cbccc096f5088cc, -103, -12},
+    {0xd1b71758e219652c, -77, -4},
+    {0x9c40000000000000, -50, 4},
+    {0xe8d4a51000000000, -24, 12},
+    {0xad78ebc5ac620000, 3, 20},
+    {0x813f3978f8940984, 30, 28},
+    {0xc097ce7bc90715b3, 56, 36},
+    {0x8f7e32ce7bea5c70, 83, 44},
+    {0xd5d238a4abe98068, 109, 52},
+    {0x9f4f2726179a2245, 136, 60},
+    {0xed63a231d4c4fb27, 162, 68},
+    {0xb0de65388cc8ada8, 189, 76},
+    {0x83c7088e1aab65db, 216, 84},
+    {0xc45d1df942711d9a, 242, 92},
+    {0x924d692ca61be758, 269, 100},
+    {0xda01ee641a708dea, 295, 108},
+    {0xa26da3999aef774a, 322, 116},
+    {0xf209787bb47d6b85, 348, 124},
+    {0xb454e4a179dd1877, 375, 132},
+    {0x865b86925b9bc5c2, 402, 140},
+    {0xc83553c5c8965d3d, 428, 148},
+    {0x952ab45cfa97a0b3, 455, 156},
+    {0xde469fbd99a05fe3, 481, 164},
+    {0xa59bc234db398c25, 508, 172},
+    {0xf6c69a72a3989f5c, 534, 180},
+    {0xb7dcbf5354e9bece, 561, 188},
+    {0x88fcf317f22241e2, 588, 196},
+    {0xcc20ce9bd35c78a5, 614, 204},
+    {0x98165af37b2153df, 641, 212},
+    {0xe2a0b5dc971f303a, 667, 220},
+    {0xa8d9d1535ce3b396, 694, 228},
+    {0xfb9b7cd9a4a7443c, 720, 236},
+    {0xbb764c4ca7a44410, 747, 244},
+    {0x8bab8eefb6409c1a, 774, 252},
+    {0xd01fef10a657842c, 800, 260},
+    {0x9b10a4e5e9913129, 827, 268},
+    {0xe7109bfba19c0c9d, 853, 276},
+    {0xac2820d9623bf429, 880, 284},
+    {0x80444b5e7aa7cf85, 907, 292},
+    {0xbf21e44003acdd2d, 933, 300},
+    {0x8e679c2f5e44ff8f, 960, 308},
+    {0xd433179d9c8cb841, 986, 316},
+    {0x9e19db92b4e31ba9, 1013, 324},
+    {0xeb96bf6ebadf77d9, 1039, 332},
+    {0xaf87023b9bf0ee6b, 1066, 340},
+};
+
+constexpr int kCachedPowersOffset = 348;
+constexpr int kDecimalExponentDistance = 8;
+
+/// The range of the exponent of the scaled numbers, which lets the digit
+/// generation split them into integral and fractional parts that fit 32 and
+/// 64 bits respectively.
+constexpr int kMinimalTargetExponent = -60;
+constexpr int kMaximalTargetExponent = -32;
+
+/// \return a cached power of ten c such that c.e is in [minExponent,
+/// maxExponent], and its decimal exponent in \p decimalExponent.
+DiyFp cachedPowerForBinaryExponentRange(
+    int minExponent,
+    int maxExponent,
+    int *decimalExponent) {
+  // 1 / log2(10).
+  const double kD1Log2_10 = 0.30102999566398114;
+  int k = static_cast<int>(std::ceil((minExponent + 63) * kD1Log2_10));
+  int index = (kCachedPowersOffset + k - 1) / kDecimalExponentDistance + 1;
+  const CachedPower &cached = kCachedPowers[index];
+  assert(minExponent <= cached.binaryExponent);
+  assert(cached.binaryExponent <= maxExponent);
+  (void)maxExponent;
+  *decimalExponent = cached.decimalExponent;
+  return DiyFp(cached.significand, cached.binaryExponent);
+}
+
+/// Set \p power to the biggest power of ten which is at most \p number, and
+/// \p exponentPlusOne to its exponent plus one. Both are 0 if number is 0.
+void biggestPowerTen(uint32_t number, uint32_t *power, int *exponentPlusOne) {
+  static const uint32_t kPowersOfTen[] = {
+      1,
+      10,
+      100,
+      1000,
+      10000,
+      100000,
+      1000000,
+      10000000,
+      100000000,
+      1000000000};
+  int exp = 0;
+  while (exp < 10 && number >= kPowersOfTen[exp])
+    ++exp;
+  *exponentPlusOne = exp;
+  *power = exp ? kPowersOfTen[exp - 1] : 0;
+}
+
+/// Move the last digit of \p digits closer to the scaled value w, which is
+/// \p distanceTooHighW below the upper end of the unsafe interval, and check
+/// that the result is definitely the closest shortest representation.
+/// \p rest is the distance from the digits to the upper end, \p tenKappa the
+/// weight of the last digit and \p unit the precision of the computation.
+/// \return whether the digits are known to be correct.
+bool roundWeed(
+    char *digits,
+    int length,
+    uint64_t distanceTooHighW,
+    uint64_t unsafeInterval,
+    uint64_t rest,
+    uint64_t tenKappa,
+    uint64_t unit) {
+  uint64_t smallDistance = distanceTooHighW - unit;
+  uint64_t bigDistance = distanceTooHighW + unit;
+  // Decrement the last digit while that brings the digits closer to w, even
+  // in the worst case of the imprecision.
+  while (rest < smallDistance && unsafeInterval - rest >= tenKappa &&
+         (rest + tenKappa < smallDistance ||
+          smallDistance - rest >= rest + tenKappa - smallDistance)) {
+    --digits[length - 1];
+    rest += tenKappa;
+  }
+  // If decrementing once more could bring the digits closer to w in the other
+  // worst case, we can't tell which one is correct.
+  if (rest < bigDistance && unsafeInterval - rest >= tenKappa &&
+      (rest + tenKappa < bigDistance ||
+       bigDistance - rest > rest + tenKappa - bigDistance)) {
+    return false;
+  }
+  // The digits must also be safely inside the rounding interval.
+  return 2 * unit <= rest && rest <= unsafeInterval - 4 * unit;
+}
+
+/// Generate the shortest digits of a number in the interval (low, high)
+/// around w, all of which are scaled so that their exponent is in
+/// [kMinimalTargetExponent, kMaximalTargetExponent].
+/// \p kappa receives the decimal exponent of the last digit.
+/// \return whether the digits are known to be correct.
+bool digitGen(
+    DiyFp low,
+    DiyFp w,
+    DiyFp high,
+    char *digits,
+    int *length,
+    int *kappa) {
+  assert(low.e == w.e && w.e == high.e && "exponents must match");
+  assert(
+      kMinimalTargetExponent <= w.e && w.e <= kMaximalTargetExponent &&
+      "exponent out of range");
+  // The boundaries are imprecise by one unit, so widen the interval to be
+  // sure it contains the exact one, and only accept results which would be
+  // inside it in any case.
+  uint64_t unit = 1;
+  DiyFp tooLow(low.f - unit, low.e);
+  DiyFp tooHigh(high.f + unit, high.e);
+  DiyFp unsafeInterval = tooHigh.minus(tooLow);
+  DiyFp one(1ull << -w.e, w.e);
+  uint32_t integrals = static_cast<uint32_t>(tooHigh.f >> -one.e);
+  uint64_t fractionals = tooHigh.f & (one.f - 1);
+  uint32_t divisor;
+  int divisorExponentPlusOne;
+  biggestPowerTen(integrals, &divisor, &divisorExponentPlusOne);
+  *kappa = divisorExponentPlusOne;
+  *length = 0;
+
+  // Generate the digits of the integral part, stopping as soon as the rest
+  // is inside the interval.
+  while (*kappa > 0) {
+    digits[(*length)++] = '0' + integrals / divisor;
+    integrals %= divisor;
+    --*kappa;
+    uint64_t rest = (static_cast<uint64_t>(integrals) << -one.e) + fractionals;
+    if (rest < unsafeInterval.f) {
+      return roundWeed(
+          digits,
+          *length,
+          tooHigh.minus(w).f,
+          unsafeInterval.f,
+          rest,
+          static_cast<uint64_t>(divisor) << -one.e,
+          unit);
+    }
+    divisor /= 10;
+  }
+
+  // Then the digits of the fractional part, keeping track of the growing
+  // imprecision.
+  for (;;) {
+    fractionals *= 10;
+    unit *= 10;
+    unsafeInterval.f *= 10;
+    digits[(*length)++] = '0' + static_cast<int>(fractionals >> -one.e);
+    fractionals &= one.f - 1;
+    --*kappa;
+    if (fractionals < unsafeInterval.f) {
+      return roundWeed(
+          digits,
+          *length,
+          tooHigh.minus(w).f * unit,
+          unsafeInterval.f,
+          fractionals,
+          one.f,
+          unit);
+    }
+  }
+}
+
+} // namespace
+
+bool fastShortestDtoa(double v, char *digits, int *length, int *decimalPoint) {
+  assert(v > 0 && std::isfinite(v) && "only positive finite numbers");
+  DiyFp exact = toDiyFp(v);
+  DiyFp w = exact.normalize();
+
+  // The boundaries between v and its neighbours. The lower one is closer if
+  // v is a power of two, unless it is denormal.
+  DiyFp boundaryPlus = DiyFp((exact.f << 1) + 1, exact.e - 1).normalize();
+  DiyFp boundaryMinus = exact.f == kHiddenBit && exact.e != kDenormalExponent
+      ? DiyFp((exact.f << 2) - 1, exact.e - 2)
+      : DiyFp((exact.f << 1) - 1, exact.e - 1);
+  boundaryMinus.f <<= boundaryMinus.e - boundaryPlus.e;
+  boundaryMinus.e = boundaryPlus.e;
+  assert(w.e == boundaryPlus.e && "boundaries must be normalized like w");
+
+  // Scale everything by a power of ten so that the exponent is in the target
+  // range.
+  int mk;
+  DiyFp tenMk = cachedPowerForBinaryExponentRange(
+      kMinimalTargetExponent - (w.e + 64),
+      kMaximalTargetExponent - (w.e + 64),
+      &mk);
+  int kappa;
+  bool result = digitGen(
+      boundaryMinus.times(tenMk),
+      w.times(tenMk),
+      boundaryPlus.times(tenMk),
+      digits,
+      length,
+      &kappa);
+  *decimalPoint = *length - mk + kappa;
+  return result;
+}
+
+} // namespace hermes
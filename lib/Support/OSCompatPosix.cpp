@@ -244,8 +244,9 @@ void vm_name(void *p, size_t sz, const char *name) {
 #endif // __ANDROID__
 }
 
-bool vm_protect(void *p, size_t sz, ProtectMode) {
-  int err = mprotect(p, sz, PROT_WRITE | PROT_READ);
+bool vm_protect(void *p, size_t sz, ProtectMode mode) {
+  int err = mprotect(
+      p, sz, mode == ProtectMode::None ? PROT_NONE : PROT_WRITE | PROT_READ);
   return err != -1;
 }
 
@@ -265,10 +266,33 @@ bool vm_madvise(void *p, size_t sz, MAdvice advice) {
     case MAdvice::Sequential:
       param = MADV_SEQUENTIAL;
       break;
+    case MAdvice::HugePage:
+#ifdef MADV_HUGEPAGE
+      param = MADV_HUGEPAGE;
+      break;
+#else
+      return false;
+#endif
   }
   return madvise(p, sz, param) == 0;
 }
 
+bool vm_bind_local(void *p, size_t sz) {
+  assert(
+      reinterpret_cast<intptr_t>(p) % page_size() == 0 &&
+      "Precondition: pointer is page-aligned.");
+#if defined(__linux__) && defined(SYS_mbind)
+  // MPOL_PREFERRED with an empty node mask selects the local node.  The
+  // constant is spelled out to avoid depending on libnuma's headers.
+  constexpr int kMPolPreferred = 1;
+  return syscall(SYS_mbind, p, sz, kMPolPreferred, nullptr, 0, 0) == 0;
+#else
+  (void)p;
+  (void)sz;
+  return false;
+#endif
+}
+
 int pages_in_ram(const void *p, size_t sz, llvm::SmallVectorImpl<int> *runs) {
   const auto PS = page_size();
   {
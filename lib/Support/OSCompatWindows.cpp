@@ -292,9 +292,13 @@ void vm_name(void *p, size_t sz, const char *name) {
   (void)name;
 }
 
-bool vm_protect(void *p, size_t sz, ProtectMode) {
+bool vm_protect(void *p, size_t sz, ProtectMode mode) {
   DWORD oldProtect;
-  BOOL err = VirtualProtect(p, sz, PAGE_READWRITE, &oldProtect);
+  BOOL err = VirtualProtect(
+      p,
+      sz,
+      mode == ProtectMode::None ? PAGE_NOACCESS : PAGE_READWRITE,
+      &oldProtect);
   return err != 0;
 }
 
@@ -303,6 +307,11 @@ bool vm_madvise(void *p, size_t sz, MAdvice advice) {
   return false;
 }
 
+bool vm_bind_local(void *p, size_t sz) {
+  // Not implemented.
+  return false;
+}
+
 int pages_in_ram(const void *p, size_t sz, llvm::SmallVectorImpl<int> *runs) {
   // Not yet supported.
   return -1;
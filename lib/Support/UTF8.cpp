@@ -6,6 +6,17 @@
  */
 #include "hermes/Support/UTF8.h"
 
+#include <cassert>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define HERMES_UTF8_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define HERMES_UTF8_NEON
+#endif
+
 namespace hermes {
 
 void encodeUTF8(char *&dst, uint32_t cp) {
@@ -62,6 +73,21 @@ void encodeUTF8(char *&dst, uint32_t cp) {
   dst = d;
 }
 
+namespace {
+
+/// Append to \p out the run of ASCII characters starting at \p cur.
+/// \return the end of the run.
+const char16_t *
+appendASCIIRun(std::string &out, const char16_t *cur, const char16_t *end) {
+  const char16_t *runEnd = findFirstNonASCII(cur, end);
+  size_t oldSize = out.size();
+  out.resize(oldSize + (runEnd - cur));
+  narrowASCII(cur, runEnd - cur, &out[oldSize]);
+  return runEnd;
+}
+
+} // namespace
+
 void convertUTF16ToUTF8WithReplacements(
     std::string &out,
     llvm::ArrayRef<char16_t> input) {
@@ -77,9 +103,9 @@ void convertUTF16ToUTF8WithReplacements(
   out.reserve(input.size());
   for (auto cur = input.begin(), end = input.end(); cur < end; ++cur) {
     char16_t c = cur[0];
-    // ASCII fast-path.
+    // ASCII fast-path: convert the whole run of ASCII characters at once.
     if (LLVM_LIKELY(c <= 0x7F)) {
-      out.push_back(static_cast<char>(c));
+      cur = appendASCIIRun(out, cur, end) - 1;
       continue;
     }
 
@@ -115,10 +141,11 @@ void convertUTF16ToUTF8WithSingleSurrogates(
     llvm::ArrayRef<char16_t> input) {
   dest.clear();
   dest.reserve(input.size());
-  for (char16_t c : input) {
-    // ASCII fast-path.
+  for (auto cur = input.begin(), end = input.end(); cur < end; ++cur) {
+    char16_t c = cur[0];
+    // ASCII fast-path: convert the whole run of ASCII characters at once.
     if (LLVM_LIKELY(c <= 0x7F)) {
-      dest.push_back(static_cast<char>(c));
+      cur = appendASCIIRun(dest, cur, end) - 1;
       continue;
     }
     char32_t c32 = c;
@@ -129,42 +156,245 @@ void convertUTF16ToUTF8WithSingleSurrogates(
   }
 }
 
-bool isAllASCII(const uint8_t *start, const uint8_t *end) {
+const uint8_t *findFirstNonASCII(const uint8_t *start, const uint8_t *end) {
   const uint8_t *cursor = start;
-  size_t len = end - start;
-  static_assert(
-      sizeof(uint32_t) == 4 && alignof(uint32_t) <= 4,
-      "uint32_t must be 4 bytes and cannot be more than 4 byte aligned");
-
-  if (len >= 4) {
-    // Step by 1s until aligned for uint32_t.
-    uint8_t mask = 0;
-    while ((uintptr_t)cursor % alignof(uint32_t)) {
-      mask |= *cursor++;
-      len -= 1;
-    }
-    if (mask & 0x80u) {
-      return false;
-    }
+#if defined(HERMES_UTF8_SSE2)
+  for (; end - cursor >= 16; cursor += 16) {
+    __m128i chunk = _mm_loadu_si128((const __m128i *)cursor);
+    if (_mm_movemask_epi8(chunk))
+      break;
+  }
+#elif defined(HERMES_UTF8_NEON)
+  for (; end - cursor >= 16; cursor += 16) {
+    if (vmaxvq_u8(vld1q_u8(cursor)) & 0x80u)
+      break;
+  }
+#else
+  for (; end - cursor >= 8; cursor += 8) {
+    uint64_t chunk;
+    std::memcpy(&chunk, cursor, sizeof(chunk));
+    if (chunk & 0x8080808080808080u)
+      break;
+  }
+#endif
+  // Find the exact position within the last, partial or non-ASCII, chunk.
+  while (cursor < end && *cursor < 0x80u)
+    ++cursor;
+  return cursor;
+}
 
-    // Now that we are aligned, step by 4s.
-    while (len >= 4) {
-      uint32_t val = *(const uint32_t *)cursor;
-      if (val & 0x80808080u) {
-        return false;
-      }
-      cursor += 4;
-      len -= 4;
-    }
+const char16_t *findFirstNonASCII(
+    const char16_t *start,
+    const char16_t *end) {
+  const char16_t *cursor = start;
+#if defined(HERMES_UTF8_SSE2)
+  const __m128i nonASCIIMask = _mm_set1_epi16((short)0xFF80);
+  for (; end - cursor >= 8; cursor += 8) {
+    __m128i chunk = _mm_loadu_si128((const __m128i *)cursor);
+    __m128i nonASCII = _mm_and_si128(chunk, nonASCIIMask);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(nonASCII, _mm_setzero_si128())) !=
+        0xFFFF)
+      break;
+  }
+#elif defined(HERMES_UTF8_NEON)
+  for (; end - cursor >= 8; cursor += 8) {
+    if (vmaxvq_u16(vld1q_u16((const uint16_t *)cursor)) > 0x7Fu)
+      break;
+  }
+#else
+  for (; end - cursor >= 4; cursor += 4) {
+    uint64_t chunk;
+    std::memcpy(&chunk, cursor, sizeof(chunk));
+    if (chunk & 0xFF80FF80FF80FF80u)
+      break;
+  }
+#endif
+  while (cursor < end && *cursor < 0x80u)
+    ++cursor;
+  return cursor;
+}
+
+void widenASCII(const char *src, size_t length, char16_t *dst) {
+  const char *end = src + length;
+#if defined(HERMES_UTF8_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  for (; end - src >= 16; src += 16, dst += 16) {
+    __m128i chunk = _mm_loadu_si128((const __m128i *)src);
+    _mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi8(chunk, zero));
+    _mm_storeu_si128((__m128i *)(dst + 8), _mm_unpackhi_epi8(chunk, zero));
+  }
+#elif defined(HERMES_UTF8_NEON)
+  for (; end - src >= 16; src += 16, dst += 16) {
+    uint8x16_t chunk = vld1q_u8((const uint8_t *)src);
+    vst1q_u16((uint16_t *)dst, vmovl_u8(vget_low_u8(chunk)));
+    vst1q_u16((uint16_t *)(dst + 8), vmovl_u8(vget_high_u8(chunk)));
+  }
+#endif
+  while (src < end)
+    *dst++ = (unsigned char)*src++;
+}
+
+void narrowASCII(const char16_t *src, size_t length, char *dst) {
+  assert(
+      findFirstNonASCII(src, src + length) == src + length &&
+      "only ASCII characters can be narrowed");
+  const char16_t *end = src + length;
+#if defined(HERMES_UTF8_SSE2)
+  for (; end - src >= 16; src += 16, dst += 16) {
+    __m128i lo = _mm_loadu_si128((const __m128i *)src);
+    __m128i hi = _mm_loadu_si128((const __m128i *)(src + 8));
+    _mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(lo, hi));
+  }
+#elif defined(HERMES_UTF8_NEON)
+  for (; end - src >= 16; src += 16, dst += 16) {
+    uint16x8_t lo = vld1q_u16((const uint16_t *)src);
+    uint16x8_t hi = vld1q_u16((const uint16_t *)(src + 8));
+    vst1q_u8((uint8_t *)dst, vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+  }
+#endif
+  while (src < end)
+    *dst++ = (char)*src++;
+}
+
+namespace {
+
+/// \return the first letter of the case that converting to upper case if \p
+/// toUpper, or to lower case otherwise, changes.
+inline char caseChangeBase(bool toUpper) {
+  return toUpper ? 'a' : 'A';
+}
+
+/// \return whether \p c is a letter in [base, base + 26).
+template <typename CharT>
+inline bool isCaseChange(CharT c, char base) {
+  return (uint32_t)c - (uint32_t)base < 26u;
+}
+
+} // namespace
+
+const char *
+findFirstASCIICaseChange(const char *start, const char *end, bool toUpper) {
+  const char *cursor = start;
+  const char base = caseChangeBase(toUpper);
+#if defined(HERMES_UTF8_SSE2)
+  // Bias the letters to the bottom of the signed range, so that a single
+  // signed comparison checks both ends of it.
+  const __m128i bias = _mm_set1_epi8((char)(0x80 - base));
+  const __m128i limit = _mm_set1_epi8((char)(0x80 + 26));
+  for (; end - cursor >= 16; cursor += 16) {
+    __m128i chunk = _mm_loadu_si128((const __m128i *)cursor);
+    if (_mm_movemask_epi8(
+            _mm_cmplt_epi8(_mm_add_epi8(chunk, bias), limit)))
+      break;
+  }
+#elif defined(HERMES_UTF8_NEON)
+  const uint8x16_t baseVec = vdupq_n_u8((uint8_t)base);
+  const uint8x16_t limit = vdupq_n_u8(26);
+  for (; end - cursor >= 16; cursor += 16) {
+    uint8x16_t chunk = vld1q_u8((const uint8_t *)cursor);
+    if (vmaxvq_u8(vcltq_u8(vsubq_u8(chunk, baseVec), limit)))
+      break;
+  }
+#endif
+  while (cursor < end && !isCaseChange((uint8_t)*cursor, base))
+    ++cursor;
+  return cursor;
+}
+
+const char16_t *findFirstASCIICaseChange(
+    const char16_t *start,
+    const char16_t *end,
+    bool toUpper) {
+  const char16_t *cursor = start;
+  const char base = caseChangeBase(toUpper);
+#if defined(HERMES_UTF8_SSE2)
+  const __m128i bias = _mm_set1_epi16((short)(0x8000 - base));
+  const __m128i limit = _mm_set1_epi16((short)(0x8000 + 26));
+  for (; end - cursor >= 8; cursor += 8) {
+    __m128i chunk = _mm_loadu_si128((const __m128i *)cursor);
+    if (_mm_movemask_epi8(
+            _mm_cmplt_epi16(_mm_add_epi16(chunk, bias), limit)))
+      break;
+  }
+#elif defined(HERMES_UTF8_NEON)
+  const uint16x8_t baseVec = vdupq_n_u16((uint16_t)base);
+  const uint16x8_t limit = vdupq_n_u16(26);
+  for (; end - cursor >= 8; cursor += 8) {
+    uint16x8_t chunk = vld1q_u16((const uint16_t *)cursor);
+    if (vmaxvq_u16(vcltq_u16(vsubq_u16(chunk, baseVec), limit)))
+      break;
+  }
+#endif
+  while (cursor < end && !isCaseChange(*cursor, base))
+    ++cursor;
+  return cursor;
+}
+
+void convertASCIICase(const char *src, size_t length, char *dst, bool toUpper) {
+  const char *end = src + length;
+  const char base = caseChangeBase(toUpper);
+  // Upper and lower case ASCII letters differ only in this bit.
+  constexpr char kCaseBit = 'a' ^ 'A';
+#if defined(HERMES_UTF8_SSE2)
+  const __m128i bias = _mm_set1_epi8((char)(0x80 - base));
+  const __m128i limit = _mm_set1_epi8((char)(0x80 + 26));
+  const __m128i caseBit = _mm_set1_epi8(kCaseBit);
+  for (; end - src >= 16; src += 16, dst += 16) {
+    __m128i chunk = _mm_loadu_si128((const __m128i *)src);
+    __m128i letters = _mm_cmplt_epi8(_mm_add_epi8(chunk, bias), limit);
+    _mm_storeu_si128(
+        (__m128i *)dst,
+        _mm_xor_si128(chunk, _mm_and_si128(letters, caseBit)));
+  }
+#elif defined(HERMES_UTF8_NEON)
+  const uint8x16_t baseVec = vdupq_n_u8((uint8_t)base);
+  const uint8x16_t limit = vdupq_n_u8(26);
+  const uint8x16_t caseBit = vdupq_n_u8(kCaseBit);
+  for (; end - src >= 16; src += 16, dst += 16) {
+    uint8x16_t chunk = vld1q_u8((const uint8_t *)src);
+    uint8x16_t letters = vcltq_u8(vsubq_u8(chunk, baseVec), limit);
+    vst1q_u8((uint8_t *)dst, veorq_u8(chunk, vandq_u8(letters, caseBit)));
+  }
+#endif
+  for (; src < end; ++src, ++dst) {
+    char c = *src;
+    *dst = isCaseChange((uint8_t)c, base) ? c ^ kCaseBit : c;
+  }
+}
+
+void convertASCIICase(
+    const char16_t *src,
+    size_t length,
+    char16_t *dst,
+    bool toUpper) {
+  const char16_t *end = src + length;
+  const char base = caseChangeBase(toUpper);
+  constexpr char16_t kCaseBit = 'a' ^ 'A';
+#if defined(HERMES_UTF8_SSE2)
+  const __m128i bias = _mm_set1_epi16((short)(0x8000 - base));
+  const __m128i limit = _mm_set1_epi16((short)(0x8000 + 26));
+  const __m128i caseBit = _mm_set1_epi16(kCaseBit);
+  for (; end - src >= 8; src += 8, dst += 8) {
+    __m128i chunk = _mm_loadu_si128((const __m128i *)src);
+    __m128i letters = _mm_cmplt_epi16(_mm_add_epi16(chunk, bias), limit);
+    _mm_storeu_si128(
+        (__m128i *)dst,
+        _mm_xor_si128(chunk, _mm_and_si128(letters, caseBit)));
+  }
+#elif defined(HERMES_UTF8_NEON)
+  const uint16x8_t baseVec = vdupq_n_u16((uint16_t)base);
+  const uint16x8_t limit = vdupq_n_u16(26);
+  const uint16x8_t caseBit = vdupq_n_u16(kCaseBit);
+  for (; end - src >= 8; src += 8, dst += 8) {
+    uint16x8_t chunk = vld1q_u16((const uint16_t *)src);
+    uint16x8_t letters = vcltq_u16(vsubq_u16(chunk, baseVec), limit);
+    vst1q_u16((uint16_t *)dst, veorq_u16(chunk, vandq_u16(letters, caseBit)));
   }
-  assert(len < 4 && "Length should now be less than 4");
-  uint8_t mask = 0;
-  while (len--) {
-    mask |= *cursor++;
+#endif
+  for (; src < end; ++src, ++dst) {
+    char16_t c = *src;
+    *dst = isCaseChange(c, base) ? c ^ kCaseBit : c;
   }
-  if (mask & 0x80u)
-    return false;
-  return true;
 }
 
 }; // namespace hermes
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/BackgroundFreer.h"
+
+#include <cstdlib>
+
+namespace hermes {
+namespace vm {
+
+BackgroundFreer::~BackgroundFreer() {
+  if (thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cond_.notify_one();
+    thread_.join();
+  }
+  // The thread only exits once it has freed the whole queue.
+  for (void *mem : pending_) {
+    free(mem);
+  }
+}
+
+void BackgroundFreer::flush() {
+  if (pending_.empty())
+    return;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.insert(queue_.end(), pending_.begin(), pending_.end());
+  }
+  pending_.clear();
+  if (!thread_.joinable()) {
+    thread_ = std::thread([this]() { run(); });
+  }
+  cond_.notify_one();
+}
+
+void BackgroundFreer::run() {
+  std::vector<void *> batch;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cond_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+    if (queue_.empty())
+      return;
+    batch.swap(queue_);
+    lock.unlock();
+    for (void *mem : batch) {
+      free(mem);
+    }
+    batch.clear();
+    lock.lock();
+  }
+}
+
+} // namespace vm
+} // namespace hermes
@@ -6,6 +6,7 @@
  */
 #include "hermes/VM/Callable.h"
 
+#include "hermes/Support/UTF8.h"
 #include "hermes/VM/BuildMetadata.h"
 #include "hermes/VM/SmallXString.h"
 #include "hermes/VM/StackFrame-inline.h"
@@ -46,27 +47,66 @@ CallResult<HermesValue> Callable::_newObjectImpl(
 }
 
 void Callable::defineLazyProperties(Handle<Callable> fn, Runtime *runtime) {
-  // lazy functions can be Bound or JS Functions.
+  // lazy functions can be Bound or JS Functions, or builtin constructors.
   if (auto jsFun = Handle<JSFunction>::dyn_vmcast(runtime, fn)) {
     const CodeBlock *codeBlock = jsFun->getCodeBlock();
+    const bool isGenerator = vmisa<JSGeneratorFunction>(*jsFun);
+    // Arrow functions and methods are not constructors and have no
+    // 'prototype' property (ES9.0 9.2.10 MakeConstructor is never called for
+    // them), so they don't need a prototype object either. Generators are
+    // not constructors either but do have a prototype.
+    const bool hasPrototype = isGenerator ||
+        codeBlock->getHeaderFlags().prohibitInvoke !=
+            hbc::FunctionHeaderFlag::ProhibitConstruct;
+    const bool strictMode = codeBlock->isStrictMode();
+    const SymbolID name = codeBlock->getNameMayAllocate();
+
     // Create empty object for prototype.
-    auto prototypeParent = vmisa<JSGeneratorFunction>(*jsFun)
-        ? Handle<JSObject>::vmcast(&runtime->generatorPrototype)
-        : Handle<JSObject>::vmcast(&runtime->objectPrototype);
-    auto prototypeObjectHandle =
-        toHandle(runtime, JSObject::create(runtime, prototypeParent));
+    auto prototypeObjectHandle = runtime->makeNullHandle<JSObject>();
+    if (hasPrototype) {
+      auto prototypeParent = isGenerator
+          ? Handle<JSObject>::vmcast(&runtime->generatorPrototype)
+          : Handle<JSObject>::vmcast(&runtime->objectPrototype);
+      prototypeObjectHandle =
+          toHandle(runtime, JSObject::create(runtime, prototypeParent));
+    }
+
+    // Every JSFunction starts with the same class and ends up with the same
+    // properties, which differ only by strictness and by the presence of a
+    // prototype. Once that class is known, reuse it and write the slots
+    // directly instead of walking the transitions for every closure.
+    PinnedHermesValue &cachedClass =
+        runtime->lazyFunctionClasses[strictMode * 2 + hasPrototype];
+    HiddenClass *initialClass =
+        runtime->getHiddenClassForPrototypeRaw(jsFun->getParent(runtime));
+    const bool fromInitialClass =
+        jsFun->clazz_.getNonNull(runtime) == initialClass;
+    if (cachedClass.isObject() && fromInitialClass) {
+      initializeFromFunctionClass(
+          jsFun,
+          runtime,
+          Handle<HiddenClass>::vmcast(&cachedClass),
+          name,
+          codeBlock->getParamCount() - 1,
+          prototypeObjectHandle,
+          strictMode);
+      return;
+    }
 
     auto cr = Callable::defineNameLengthAndPrototype(
         fn,
         runtime,
-        codeBlock->getNameMayAllocate(),
+        name,
         codeBlock->getParamCount() - 1,
         prototypeObjectHandle,
         Callable::WritablePrototype::Yes,
-        codeBlock->isStrictMode());
+        strictMode);
     assert(
         cr != ExecutionStatus::EXCEPTION && "failed to define length and name");
     (void)cr;
+    HiddenClass *finalClass = jsFun->clazz_.getNonNull(runtime);
+    if (fromInitialClass && !finalClass->isDictionary())
+      cachedClass = HermesValue::encodeObjectValue(finalClass);
   } else if (vmisa<BoundFunction>(fn.get())) {
     Handle<BoundFunction> boundfn = Handle<BoundFunction>::vmcast(fn);
     Handle<Callable> target = runtime->makeHandle(boundfn->getTarget(runtime));
@@ -78,12 +118,68 @@ void Callable::defineLazyProperties(Handle<Callable> fn, Runtime *runtime) {
         res != ExecutionStatus::EXCEPTION &&
         "failed to define length and name of bound function");
     (void)res;
+  } else if (vmisa<NativeConstructor>(fn.get())) {
+    runtime->initializeLazyConstructor(Handle<NativeConstructor>::vmcast(fn));
   } else {
     // no other kind of function can be lazy currently
     assert(false && "invalid lazy function");
   }
 }
 
+void Callable::initializeFromFunctionClass(
+    Handle<JSFunction> jsFun,
+    Runtime *runtime,
+    Handle<HiddenClass> clazz,
+    SymbolID name,
+    unsigned paramCount,
+    Handle<JSObject> prototypeObjectHandle,
+    bool strictMode) {
+  // The slots follow the order in which defineNameLengthAndPrototype()
+  // defines the properties, and all of them are direct.
+  assert(
+      clazz->getNumProperties() <= JSObject::DIRECT_PROPERTY_SLOTS &&
+      "function properties must fit in the direct slots");
+  StringPrimitive *nameStr = name.isValid()
+      ? runtime->getStringPrimFromSymbolID(name)
+      : runtime->getPredefinedString(Predefined::emptyString);
+  jsFun->clazz_.set(runtime, *clazz, &runtime->getHeap());
+
+  SlotIndex slot = 0;
+  auto setSlot = [jsFun, runtime, &slot](HermesValue value) {
+    JSObject::setNamedSlotValue<PropStorage::Inline::Yes>(
+        *jsFun, runtime, slot++, value);
+  };
+  setSlot(HermesValue::encodeStringValue(nameStr));
+  setSlot(HermesValue::encodeDoubleValue(paramCount));
+  if (strictMode) {
+    setSlot(runtime->throwTypeErrorAccessor);
+    setSlot(runtime->throwTypeErrorAccessor);
+  }
+  if (!prototypeObjectHandle)
+    return;
+  setSlot(prototypeObjectHandle.getHermesValue());
+
+  if (!vmisa<JSGeneratorFunction>(*jsFun)) {
+    // Set the 'constructor' property in the prototype object, as
+    // defineNameLengthAndPrototype() does.
+    PropertyFlags pf;
+    pf.clear();
+    pf.enumerable = 0;
+    pf.writable = 1;
+    pf.configurable = 1;
+    auto status = JSObject::defineNewOwnProperty(
+        prototypeObjectHandle,
+        runtime,
+        Predefined::getSymbolID(Predefined::constructor),
+        pf,
+        jsFun);
+    assert(
+        status != ExecutionStatus::EXCEPTION &&
+        "failed to define prototype.constructor");
+    (void)status;
+  }
+}
+
 ExecutionStatus Callable::defineNameLengthAndPrototype(
     Handle<Callable> selfHandle,
     Runtime *runtime,
@@ -802,6 +898,67 @@ CallResult<HermesValue> NativeFunction::_callImpl(
   return _nativeCall(vmcast<NativeFunction>(selfHandle.get()), runtime);
 }
 
+/// \return the name property of the callee of \p frame, if it is an own string
+/// data property, or an empty string otherwise.
+static std::string getCalleeName(Runtime *runtime, StackFramePtr frame) {
+  GCScopeMarkerRAII marker{runtime};
+  Handle<JSObject> selfHandle = frame.getCalleeClosureHandleUnsafe();
+  NamedPropertyDescriptor desc;
+  if (!JSObject::getOwnNamedDescriptor(
+          selfHandle,
+          runtime,
+          Predefined::getSymbolID(Predefined::name),
+          desc) ||
+      desc.flags.accessor) {
+    return "";
+  }
+  auto *str = dyn_vmcast<StringPrimitive>(
+      JSObject::getNamedSlotValue(selfHandle.get(), runtime, desc));
+  if (!str) {
+    return "";
+  }
+  llvm::SmallVector<char16_t, 16> buf;
+  str->copyUTF16String(buf);
+  std::string name;
+  convertUTF16ToUTF8WithReplacements(name, UTF16Ref(buf));
+  return name;
+}
+
+CallResult<HermesValue> NativeFunction::_nativeCallWithStats(
+    NativeFunction *self,
+    Runtime *runtime,
+    StackFramePtr newFrame) {
+  auto &stats = runtime->getRuntimeStats();
+  const instrumentation::RuntimeStats::NativeCallKey key{
+      reinterpret_cast<const void *>(self->functionPtr_), self->context_};
+  // The entry can't be held across the call, which may add others.
+  auto &stat = stats.nativeCalls[key];
+  if (LLVM_UNLIKELY(stat.count == 0)) {
+    // Looking up the name may allocate, and move the callee.
+    stat.name = getCalleeName(runtime, newFrame);
+    self = vmcast<NativeFunction>(newFrame.getCalleeClosureUnsafe());
+  }
+  ++stat.count;
+  if (--stats.nativeCallsUntilTimed) {
+    return self->functionPtr_(
+        self->context_, runtime, newFrame.getNativeArgs());
+  }
+
+  stats.nativeCallsUntilTimed = stats.nativeCallSamplingInterval;
+  auto start = std::chrono::steady_clock::now();
+  auto res =
+      self->functionPtr_(self->context_, runtime, newFrame.getNativeArgs());
+  auto end = std::chrono::steady_clock::now();
+  // The stats may have been disabled and reset by the call.
+  auto it = stats.nativeCalls.find(key);
+  if (it != stats.nativeCalls.end()) {
+    ++it->second.timedCount;
+    it->second.timedWallDuration +=
+        std::chrono::duration<double>(end - start).count();
+  }
+  return res;
+}
+
 CallResult<HermesValue> NativeFunction::_newObjectImpl(
     Handle<Callable>,
     Runtime *runtime,
@@ -891,6 +1048,34 @@ CallResult<HermesValue> JSFunction::create(
   return HermesValue::encodeObjectValue(self);
 }
 
+CallResult<HermesValue> JSFunction::_newObjectImpl(
+    Handle<Callable> selfHandle,
+    Runtime *runtime,
+    Handle<JSObject> parentHandle) {
+  uint32_t expected = vmcast<JSFunction>(selfHandle.get())
+                          ->getCodeBlock()
+                          ->getConstructorSlackInfo()
+                          .expectedProperties();
+  // The prototype is fully set up by the time it is used to construct
+  // objects, so give it a cacheable class back if it has lost it.
+  if (LLVM_UNLIKELY(parentHandle->getClass(runtime)->isDictionary()) &&
+      LLVM_UNLIKELY(
+          JSObject::leaveDictionaryMode(parentHandle, runtime) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto obj = JSObject::create(runtime, parentHandle);
+  if (LLVM_LIKELY(expected <= JSObject::DIRECT_PROPERTY_SLOTS))
+    return obj.getHermesValue();
+
+  // Allocate the indirect storage once, instead of growing it while the
+  // constructor adds properties.
+  auto res = JSObject::allocatePropStorage(std::move(obj), runtime, expected);
+  if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  return res->getHermesValue();
+}
+
 CallResult<HermesValue> JSFunction::_callImpl(
     Handle<Callable> selfHandle,
     Runtime *runtime) {
@@ -969,6 +1154,7 @@ void GeneratorInnerFunctionBuildMeta(
   mb.addField("@savedContext", &self->savedContext_);
   mb.addField("@result", &self->result_);
   mb.addNonPointerField("@nextIPOffset", &self->nextIPOffset_);
+  mb.addNonPointerField("@savedFrameSize", &self->savedFrameSize_);
   mb.addNonPointerField("@action", &self->action_);
 }
 
@@ -1052,18 +1238,27 @@ CallResult<HermesValue> GeneratorInnerFunction::callInnerFunction(
 
 void GeneratorInnerFunction::restoreStack(Runtime *runtime) {
   const uint32_t frameOffset = getFrameOffsetInContext();
-  const uint32_t frameSize = getFrameSizeInContext(runtime);
+  const uint32_t frameSize = savedFrameSize_;
   // Start at the lower end of the range to be copied.
   PinnedHermesValue *dst = StackFrameLayout::StackIncrement > 0
       ? runtime->getCurrentFrame().ptr()
       : runtime->getCurrentFrame().ptr() - frameSize;
-  const GCHermesValue *src = &savedContext_.get(runtime)->at(frameOffset);
+  // The saved slots are at the end of the context, after the ones which were
+  // dead at the resume point.
+  const GCHermesValue *src = &savedContext_.get(runtime)->at(
+      frameOffset + getFrameSizeInContext(runtime) - frameSize);
   std::memcpy(dst, src, frameSize * sizeof(PinnedHermesValue));
 }
 
-void GeneratorInnerFunction::saveStack(Runtime *runtime) {
+void GeneratorInnerFunction::saveStack(Runtime *runtime, uint32_t numRegs) {
   const uint32_t frameOffset = getFrameOffsetInContext();
-  const uint32_t frameSize = getFrameSizeInContext(runtime);
+  // The frame size to save goes from the stack pointer to the last live
+  // local, computed the same way as the full frame in create().
+  const uint32_t frameSize =
+      StackFrameLayout::StackIncrement * StackFrameLayout::localOffset(numRegs);
+  assert(
+      frameSize <= getFrameSizeInContext(runtime) &&
+      "saving more registers than the frame contains");
   // Start at the lower end of the range to be copied.
   PinnedHermesValue *first = StackFrameLayout::StackIncrement > 0
       ? runtime->getCurrentFrame().ptr()
@@ -1072,8 +1267,10 @@ void GeneratorInnerFunction::saveStack(Runtime *runtime) {
   GCHermesValue::copy(
       first,
       first + frameSize,
-      &savedContext_.get(runtime)->at(frameOffset),
+      &savedContext_.get(runtime)->at(
+          frameOffset + getFrameSizeInContext(runtime) - frameSize),
       &runtime->getHeap());
+  savedFrameSize_ = frameSize;
 }
 
 } // namespace vm
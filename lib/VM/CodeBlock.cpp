@@ -12,11 +12,11 @@
 #include "hermes/BCGen/HBC/HBC.h"
 #include "hermes/IRGen/IRGen.h"
 #include "hermes/Support/Conversions.h"
-#include "hermes/Support/OSCompat.h"
 #include "hermes/Support/PerfSection.h"
 #include "hermes/VM/Runtime.h"
 #include "hermes/VM/RuntimeModule.h"
 #include "hermes/VM/SerializedLiteralParser.h"
+#include "hermes/VM/StackFrame-inline.h"
 
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
@@ -156,8 +156,64 @@ CodeBlock *CodeBlock::createCodeBlock(
 }
 
 int32_t CodeBlock::findCatchTargetOffset(uint32_t exceptionOffset) {
-  return runtimeModule_->getBytecode()->findCatchTargetOffset(
-      functionID_, exceptionOffset);
+  if (LLVM_UNLIKELY(!catchRangesBuilt_)) {
+    buildCatchRanges();
+  }
+  // Find the last range starting at or before the offset.
+  auto it = std::upper_bound(
+      catchRanges_.begin(),
+      catchRanges_.end(),
+      exceptionOffset,
+      [](uint32_t offset, const hbc::HBCExceptionHandlerInfo &range) {
+        return offset < range.start;
+      });
+  if (it == catchRanges_.begin()) {
+    return -1;
+  }
+  --it;
+  return exceptionOffset < it->end ? (int32_t)it->target : -1;
+}
+
+void CodeBlock::buildCatchRanges() {
+  ArrayRef<hbc::HBCExceptionHandlerInfo> table =
+      runtimeModule_->getBytecode()->getExceptionTable(functionID_);
+  catchRangesBuilt_ = true;
+  if (table.empty()) {
+    return;
+  }
+
+  // Try blocks nest, so the entries of the table may overlap, and the first
+  // entry covering an offset is its handler. Split the table at the bounds of
+  // every entry: the same entries cover all the offsets of each piece.
+  llvm::SmallVector<uint32_t, 16> bounds;
+  for (const hbc::HBCExceptionHandlerInfo &entry : table) {
+    bounds.push_back(entry.start);
+    bounds.push_back(entry.end);
+  }
+  std::sort(bounds.begin(), bounds.end());
+  bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+  for (size_t i = 0, e = bounds.size() - 1; i < e; ++i) {
+    uint32_t start = bounds[i];
+    uint32_t end = bounds[i + 1];
+    auto entry = std::find_if(
+        table.begin(),
+        table.end(),
+        [start](const hbc::HBCExceptionHandlerInfo &entry) {
+          return entry.start <= start && start < entry.end;
+        });
+    if (entry == table.end()) {
+      continue;
+    }
+    // Merge the adjacent pieces that go to the same handler.
+    if (!catchRanges_.empty() && catchRanges_.back().end == start &&
+        catchRanges_.back().target == entry->target) {
+      catchRanges_.back().end = end;
+    } else {
+      catchRanges_.push_back({start, end, entry->target});
+    }
+  }
+  catchRanges_.shrink_to_fit();
 }
 
 SLP CodeBlock::getArrayBufferIter(uint32_t idx, unsigned int numLiterals)
@@ -238,6 +294,12 @@ SourceErrorManager::SourceCoords CodeBlock::getLazyFunctionLoc(
 
 #ifndef HERMESVM_LEAN
 namespace {
+/// Compile the lazy function described by \p lazyData on the JS thread.
+/// This is not done speculatively on background threads: all the lazy
+/// functions of a compilation share its Context, whose string table,
+/// allocator and SourceErrorManager are not thread safe, and the JS thread
+/// itself compiles into that Context when it calls a lazy function or runs
+/// eval(). Compiling ahead of time requires a separate Context per worker.
 std::unique_ptr<hbc::BytecodeModule> compileLazyFunction(
     hbc::LazyCompilationData *lazyData) {
   assert(lazyData);
@@ -269,21 +331,127 @@ void CodeBlock::lazyCompileImpl(Runtime *runtime) {
   functionHeader_ =
       runtimeModule_->getBytecode()->getFunctionHeader(functionID_);
   bytecode_ = runtimeModule_->getBytecode()->getBytecode(functionID_);
+  catchRanges_.clear();
+  catchRangesBuilt_ = false;
 #ifdef HERMES_ENABLE_DEBUGGER
   runtime->getDebugger().resolveBreakpoints(this);
 #endif
 }
+
+void CodeBlock::resetToLazy(
+    hbc::RuntimeFunctionHeader header,
+    uint32_t functionID) {
+  assert(!isLazy() && "CodeBlock is already lazy");
+  assert(!hasPrivateBytecode() && "cannot drop private bytecode");
+  assert(!getJITCompiled() && "cannot drop JIT-compiled code");
+  functionID_ = functionID;
+  functionHeader_ = header;
+  bytecode_ = nullptr;
+  catchRanges_.clear();
+  catchRanges_.shrink_to_fit();
+  catchRangesBuilt_ = false;
+  // The feedback is keyed by bytecode offset. The bytecode compiled again is
+  // the same, but the function may behave differently by then.
+  allocationSites_ = {};
+  for (auto &entry :
+       llvm::makeMutableArrayRef(propertyCache(), propertyCacheSize_)) {
+    entry.clear();
+  }
+}
 #endif // HERMESVM_LEAN
 
+void CodeBlock::makeBytecodePrivate(Runtime *runtime) {
+  assert(!isLazy() && "cannot copy the bytecode of a lazy CodeBlock");
+  if (hasPrivateBytecode())
+    return;
+  const uint32_t size = functionHeader_.bytecodeSizeInBytes();
+  privateBytecode_.reset(new uint8_t[size]);
+  std::memcpy(privateBytecode_.get(), bytecode_, size);
+  originalBytecode_ = bytecode_;
+  bytecode_ = privateBytecode_.get();
+
+  // Callers suspended in this function return into the copy, where they see
+  // the breakpoints patched in it. The interpreter state of the innermost
+  // frame is rebuilt from its offset by whoever made the copy.
+  for (StackFramePtr frame : runtime->getStackFrames()) {
+    if (frame.getSavedCodeBlock() != this)
+      continue;
+    if (const inst::Inst *savedIP = frame.getSavedIP()) {
+      frame.getSavedIPRef() = HermesValue::encodeNativePointer(
+          getOffsetPtr(getOffsetOf(savedIP)));
+    }
+  }
+}
+
+void CodeBlock::quicken(Runtime *runtime) {
+  assert(!isQuickened() && "CodeBlock is already quickened");
+  assert(!isLazy() && "cannot quicken a lazy CodeBlock");
+  // Breakpoints are patched in the same private copy, whose instructions
+  // don't move, so quickening goes on while debugging.
+  makeBytecodePrivate(runtime);
+  quickened_ = true;
+}
+
+void CodeBlock::getQuickenedOffsets(std::vector<uint32_t> &offsets) const {
+  if (!isQuickened())
+    return;
+  // Only opcodes are ever rewritten, so every byte which differs from the
+  // original bytecode is the opcode of an instruction. Breakpoints installed
+  // after quickening differ too, but are not quickened variants.
+  for (uint32_t i = 0, e = functionHeader_.bytecodeSizeInBytes(); i < e; ++i) {
+    auto original = static_cast<inst::OpCode>(originalBytecode_[i]);
+    auto current = static_cast<inst::OpCode>(privateBytecode_[i]);
+    if (current != original && inst::getUnquickenedOpCode(current) == original)
+      offsets.push_back(i);
+  }
+}
+
+CodeBlock::~CodeBlock() {
+  for (auto &entry :
+       llvm::makeMutableArrayRef(propertyCache(), propertyCacheSize_)) {
+    entry.clear();
+  }
+}
+
 void CodeBlock::markCachedHiddenClasses(SlotAcceptor &acceptor) {
   for (auto &prop :
        llvm::makeMutableArrayRef(propertyCache(), propertyCacheSize_)) {
-    if (prop.clazz) {
-      acceptor.accept(reinterpret_cast<void *&>(prop.clazz));
+    PropertyCacheExtension *ext = prop.getExtension();
+    if (!ext) {
+      if (prop.clazz) {
+        acceptor.accept(reinterpret_cast<void *&>(prop.clazz));
+      }
+      continue;
+    }
+    for (unsigned i = 0; i < ext->numClasses; ++i) {
+      if (ext->clazz[i]) {
+        acceptor.accept(reinterpret_cast<void *&>(ext->clazz[i]));
+      }
+    }
+    if (ext->dictClazz) {
+      acceptor.accept(reinterpret_cast<void *&>(ext->dictClazz));
+    }
+    if (!ext->proto.empty()) {
+      acceptor.accept(reinterpret_cast<void *&>(ext->proto.receiverClazz));
+      for (unsigned i = 0; i < ext->proto.depth; ++i) {
+        acceptor.accept(reinterpret_cast<void *&>(ext->proto.chainClazz[i]));
+      }
     }
   }
 }
 
+size_t CodeBlock::additionalMemorySize() const {
+  size_t size = propertyCacheSize_ * sizeof(PropertyCacheEntry);
+  for (const auto &entry :
+       llvm::makeArrayRef(propertyCache(), propertyCacheSize_)) {
+    if (entry.getExtension())
+      size += sizeof(PropertyCacheExtension);
+  }
+  if (hasPrivateBytecode())
+    size += functionHeader_.bytecodeSizeInBytes();
+  return size;
+}
+
 uint32_t CodeBlock::getVirtualOffset() const {
   return getRuntimeModule()->getBytecode()->getVirtualOffsetForFunction(
       functionID_);
@@ -306,26 +474,10 @@ uint32_t CodeBlock::getNextOffset(uint32_t offset) const {
   return offset + sizes[(unsigned)opCode];
 }
 
-/// Makes the page that \p address is in writable.
-/// If it fails, aborts execution.
-static void makeWritable(void *address, size_t length) {
-  void *endAddress = static_cast<void *>(static_cast<char *>(address) + length);
-
-  // Align the address to page size before setting the pagesize.
-  void *alignedAddress = safeTypeCast<size_t, void *>(llvm::alignDown(
-      safeTypeCast<void *, size_t>(address), hermes::oscompat::page_size()));
-
-  size_t totalLength =
-      static_cast<char *>(endAddress) - static_cast<char *>(alignedAddress);
-
-  bool success = oscompat::vm_protect(
-      alignedAddress, totalLength, oscompat::ProtectMode::ReadWrite);
-  if (!success) {
-    hermes_fatal("mprotect failed before modifying breakpoint");
-  }
-}
-
 void CodeBlock::installBreakpointAtOffset(uint32_t offset) {
+  assert(
+      hasPrivateBytecode() &&
+      "breakpoints are only patched in a private copy of the bytecode");
   auto opcodes = getOpcodeArray();
   assert(offset < opcodes.size() && "patch offset out of bounds");
   hbc::opcode_atom_t *address =
@@ -337,7 +489,6 @@ void CodeBlock::installBreakpointAtOffset(uint32_t offset) {
       sizeof(inst::DebuggerInst) == 1,
       "debugger instruction can only be a single opcode atom");
 
-  makeWritable(address, sizeof(inst::DebuggerInst));
   *address = debuggerOpcode;
 }
 
@@ -353,7 +504,7 @@ void CodeBlock::uninstallBreakpointAtOffset(
       "can't uninstall a non-debugger instruction");
 
   // This is valid because we can only uninstall breakpoints that we installed.
-  // Therefore, the page here must be writable.
+  // Therefore, the bytecode here is the private copy.
   *address = opCode;
 }
 
@@ -30,7 +30,8 @@ namespace fhd = ::facebook::hermes::debugger;
 // These instructions won't recursively invoke the interpreter,
 // and we also can't easily determine where they will jump to.
 static inline bool shouldSingleStep(OpCode opCode) {
-  return opCode == OpCode::Throw || opCode == OpCode::SwitchImm;
+  return opCode == OpCode::Throw || opCode == OpCode::SwitchImm ||
+      opCode == OpCode::SwitchStr;
 }
 
 static StringView getFunctionName(
@@ -589,6 +590,10 @@ Debugger::getBreakpointLocation(CodeBlock *codeBlock, uint32_t offset) const {
 
 auto Debugger::installBreakpoint(CodeBlock *codeBlock, uint32_t offset)
     -> BreakpointLocation & {
+  // Patch a private copy of the bytecode rather than the loaded bytecode,
+  // which is never made writable. The copy must be made before the address
+  // of the location is taken, since it is the key of the location.
+  codeBlock->makeBytecodePrivate(runtime_);
   auto opcodes = codeBlock->getOpcodeArray();
   assert(offset < opcodes.size() && "invalid offset to set breakpoint");
   auto &location =
@@ -887,8 +892,12 @@ HermesValue Debugger::getExceptionAsEvalResult(
       const auto stackTraceCopy = *stackTracePtr;
       std::vector<CallFrameInfo> frames;
       frames.reserve(stackTraceCopy.size());
-      for (const StackTraceInfo &sti : stackTraceCopy)
+      for (const StackTraceInfo &sti : stackTraceCopy) {
+        // The function may have been evicted since the trace was captured.
+        if (sti.codeBlock)
+          sti.codeBlock->lazyCompile(runtime_);
         frames.push_back(getCallFrameInfo(sti.codeBlock, sti.bytecodeOffset));
+      }
       outMetadata->exceptionDetails.stackTrace_ = StackTrace{std::move(frames)};
     }
   }
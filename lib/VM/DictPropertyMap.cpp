@@ -8,6 +8,10 @@
 #include "hermes/VM/DictPropertyMap.h"
 #include "hermes/Support/Statistic.h"
 
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MathExtras.h"
+
 HERMES_SLOW_STATISTIC(NumDictLookups, "Number of dictionary lookups");
 HERMES_SLOW_STATISTIC(NumExtraHashProbes, "Number of extra hash probes");
 
@@ -44,6 +48,10 @@ struct DictPropertyMap::detail {
       "kMaxCapacity is unrealistically large");
 };
 
+constexpr DictPropertyMap::CtrlByte DictPropertyMap::kCtrlEmpty;
+constexpr DictPropertyMap::CtrlByte DictPropertyMap::kCtrlDeleted;
+constexpr uint32_t DictPropertyMap::kGroupWidth;
+
 VTable DictPropertyMap::vt{CellKind::DictPropertyMapKind, 0};
 
 void DictPropertyMapBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
@@ -73,43 +81,100 @@ CallResult<PseudoHandle<DictPropertyMap>> DictPropertyMap::create(
       new (mem) DictPropertyMap(runtime, capacity, hashCapacity));
 }
 
+CallResult<PseudoHandle<DictPropertyMap>> DictPropertyMap::clone(
+    Handle<DictPropertyMap> selfHandle,
+    Runtime *runtime,
+    size_type capacity) {
+  // Growing allocates a new map and copies the entries into it, leaving the
+  // original untouched.
+  MutableHandle<DictPropertyMap> copy{runtime, *selfHandle};
+  size_type newCapacity = std::max(capacity, selfHandle->numDescriptors_);
+  if (LLVM_UNLIKELY(
+          grow(copy, runtime, newCapacity) == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return createPseudoHandle(*copy);
+}
+
+namespace {
+
+/// Helpers operating on a group of control bytes loaded into a uint64_t, the
+/// byte at the lowest index in the least significant position. Each returns a
+/// mask with the top bit of every selected byte set.
+constexpr uint64_t kLowBits = 0x0101010101010101ull;
+constexpr uint64_t kHighBits = 0x8080808080808080ull;
+
+/// Select the bytes equal to \p ctrl, which must be a full control byte. Like
+/// all SWAR byte compares this may report a false positive in a byte right
+/// after a true match, so the caller still has to compare the keys.
+inline uint64_t matchByte(uint64_t group, uint8_t ctrl) {
+  uint64_t x = group ^ (kLowBits * ctrl);
+  return (x - kLowBits) & ~x & kHighBits;
+}
+
+/// Select the empty bytes: the only byte with both of its top bits set, and
+/// the bit below them clear.
+inline uint64_t matchEmpty(uint64_t group) {
+  return group & (~group << 6) & kHighBits;
+}
+
+/// Select the empty and deleted bytes, which have the top bit set and the low
+/// bit clear.
+inline uint64_t matchEmptyOrDeleted(uint64_t group) {
+  return group & ~(group << 7) & kHighBits;
+}
+
+/// \return the offset in the group of the first byte selected by \p mask.
+inline uint32_t firstInMask(uint64_t mask) {
+  return llvm::countTrailingZeros(mask) >> 3;
+}
+
+} // anonymous namespace
+
 std::pair<bool, DictPropertyMap::HashPair *> DictPropertyMap::lookupEntryFor(
     DictPropertyMap *self,
     SymbolID symbolID) {
   ++NumDictLookups;
 
   size_type const mask = self->hashCapacity_ - 1;
-  size_type index = hash(symbolID) & mask;
+  uint32_t const h = hash(symbolID);
+  CtrlByte const ctrl = ctrlFromHash(h);
+  size_type index = (h >> 7) & mask;
 
-  // Probing step.
-  size_type step = 1;
-  // Save the address of the start of the table to avoid recalculating it.
+  // Probing step, in whole groups.
+  size_type step = 0;
+  // Save the addresses of the start of the tables to avoid recalculating them.
   HashPair *const tableStart = self->getHashPairs();
-  // The first deleted entry we found.
-  HashPair *deleted = nullptr;
+  const CtrlByte *const ctrlStart = self->getCtrlBytes();
+  // The first empty or deleted entry we found.
+  HashPair *insertPos = nullptr;
 
   assert(symbolID.isValid() && "looking for an invalid SymbolID");
 
   for (;;) {
-    HashPair *curEntry = tableStart + index;
+    uint64_t group = llvm::support::endian::read64le(ctrlStart + index);
 
     // Did we find it?
-    if (curEntry->first == symbolID)
-      return {true, curEntry};
+    for (uint64_t m = matchByte(group, ctrl); m; m &= m - 1) {
+      HashPair *curEntry = tableStart + ((index + firstInMask(m)) & mask);
+      if (curEntry->first == symbolID)
+        return {true, curEntry};
+    }
 
-    // If we encountered an empty pair, the search is over - we failed.
-    // Return either this entry or a deleted one, if we encountered one.
-    if (curEntry->first == SymbolID::empty())
-      return {false, deleted ? deleted : curEntry};
+    // The first time we encounter an empty or deleted entry, record it so we
+    // can potentially use it for insertion.
+    if (!insertPos) {
+      if (uint64_t m = matchEmptyOrDeleted(group))
+        insertPos = tableStart + ((index + firstInMask(m)) & mask);
+    }
 
-    // The first time we encounter a deleted entry, record it so we can
-    // potentially reuse it for insertion.
-    if (curEntry->first == SymbolID::deleted() && !deleted)
-      deleted = curEntry;
+    // If the group contains an empty entry, the search is over - we failed.
+    if (matchEmpty(group))
+      return {false, insertPos};
 
     ++NumExtraHashProbes;
+    step += kGroupWidth;
     index = (index + step) & mask;
-    ++step;
   }
 }
 
@@ -142,8 +207,7 @@ ExecutionStatus DictPropertyMap::grow(
 
     auto result = lookupEntryFor(newSelf, key);
     assert(!result.first && "found duplicate entry while growing");
-    result.second->first = key;
-    result.second->second = count;
+    newSelf->setHashPair(result.second, key, count);
 
     ++dst;
     ++count;
@@ -234,8 +298,7 @@ DictPropertyMap::findOrAdd(
   if (found.second->first == SymbolID::deleted())
     self->decDeletedHashCount();
 
-  found.second->first = id;
-  found.second->second = self->numDescriptors_;
+  self->setHashPair(found.second, id, self->numDescriptors_);
 
   auto *descPair = self->getDescriptorPairs() + self->numDescriptors_;
 
@@ -258,6 +321,7 @@ void DictPropertyMap::erase(DictPropertyMap *self, PropertyPos pos) {
       "accessing deleted descriptor pair");
 
   hashPair->first = SymbolID::deleted();
+  self->setCtrl(pos.hashPairIndex, kCtrlDeleted);
   descPair->first = SymbolID::deleted();
   // Add the descriptor to the deleted list.
   setNextDeletedIndex(descPair, self->deletedListHead_);
@@ -297,7 +361,8 @@ void DictPropertyMap::dump() {
   OS << "  HashPairs[" << hashCapacity_ << "]:\n";
   for (unsigned i = 0; i < hashCapacity_; ++i) {
     auto *pair = getHashPairs() + i;
-    OS << "    (" << pair->first << ", " << pair->second << ")\n";
+    OS << "    (" << pair->first << ", " << pair->second << ", ctrl="
+       << llvm::format_hex(getCtrlBytes()[i], 4) << ")\n";
   }
   OS << "  Descriptors[" << descriptorCapacity_ << "]:\n";
   for (unsigned i = 0; i < descriptorCapacity_; ++i) {
@@ -62,7 +62,8 @@ void Domain::markWeakRefs(GC *gc) {
 size_t Domain::_mallocSizeImpl(GCCell *cell) {
   auto *self = vmcast<Domain>(cell);
   return self->cjsModuleTable_.getMemorySize() +
-      self->runtimeModules_.capacity_in_bytes();
+      self->runtimeModules_.capacity_in_bytes() +
+      self->prefetchedCJSModules_.getMemorySize();
 }
 
 ExecutionStatus Domain::importCJSModuleTable(
@@ -190,6 +191,51 @@ ExecutionStatus Domain::importCJSModuleTable(
   return ExecutionStatus::RETURNED;
 }
 
+OptValue<SymbolID> Domain::getCJSModuleFilenameMayAllocate(
+    Runtime *runtime,
+    uint32_t cjsModuleOffset) const {
+  RuntimeModule *runtimeModule = getRuntimeModule(runtime, cjsModuleOffset);
+  auto *bcProvider = runtimeModule->getBytecode();
+  auto table = bcProvider->getCJSModuleTable();
+  if (table.empty())
+    return llvm::None;
+  // The table is in module ID order, like cjsModules_.
+  uint32_t index =
+      cjsModuleOffset / CJSModuleSize - bcProvider->getCJSModuleOffset();
+  assert(index < table.size() && "CJS module not in its RuntimeModule");
+  return runtimeModule->getSymbolIDFromStringIDMayAllocate(table[index].first);
+}
+
+void Domain::prefetchCJSModuleDependencies(
+    Runtime *runtime,
+    uint32_t cjsModuleOffset) {
+  uint32_t numModules = cjsModules_.get(runtime)->size() / CJSModuleSize;
+  if (prefetchedCJSModules_.size() < numModules)
+    prefetchedCJSModules_.resize(numModules);
+
+  // The module itself is being initialized already, only its dependencies
+  // need to be read ahead.
+  prefetchedCJSModules_.set(cjsModuleOffset / CJSModuleSize);
+  llvm::SmallVector<uint32_t, 8> worklist{cjsModuleOffset};
+  while (!worklist.empty()) {
+    uint32_t offset = worklist.pop_back_val();
+    auto *bcProvider = getRuntimeModule(runtime, offset)->getBytecode();
+    uint32_t index = offset / CJSModuleSize - bcProvider->getCJSModuleOffset();
+    for (uint32_t id : bcProvider->getCJSModuleDependencies(index)) {
+      // Dependencies in segments which haven't been loaded are skipped, they
+      // will be prefetched when one of their dependents is initialized.
+      OptValue<uint32_t> depOffset = getCJSModuleOffset(runtime, id);
+      if (!depOffset || prefetchedCJSModules_.test(id))
+        continue;
+      prefetchedCJSModules_.set(id);
+      getRuntimeModule(runtime, *depOffset)
+          ->getBytecode()
+          ->willNeedFunction(getFunctionIndex(runtime, *depOffset));
+      worklist.push_back(*depOffset);
+    }
+  }
+}
+
 ObjectVTable RequireContext::vt{
     VTable(CellKind::RequireContextKind, sizeof(RequireContext)),
     RequireContext::_getOwnIndexedRangeImpl,
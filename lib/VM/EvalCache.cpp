@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/EvalCache.h"
+
+#include <cassert>
+
+namespace hermes {
+namespace vm {
+
+std::string EvalCache::makeKey(llvm::StringRef source, uint8_t flags) {
+  std::string key;
+  key.reserve(source.size() + 1);
+  key.push_back(flags);
+  key.append(source.begin(), source.end());
+  return key;
+}
+
+std::shared_ptr<hbc::BCProvider> EvalCache::lookup(
+    llvm::StringRef source,
+    uint8_t flags) {
+  if (source.size() > kMaxSourceLength) {
+    ++misses_;
+    return nullptr;
+  }
+  auto it = index_.find(makeKey(source, flags));
+  if (it == index_.end()) {
+    ++misses_;
+    return nullptr;
+  }
+  ++hits_;
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->bytecode;
+}
+
+void EvalCache::insert(
+    llvm::StringRef source,
+    uint8_t flags,
+    std::shared_ptr<hbc::BCProvider> bytecode) {
+  if (capacity_ == 0 || source.size() > kMaxSourceLength)
+    return;
+  std::string key = makeKey(source, flags);
+  assert(!index_.count(key) && "source is already cached");
+  if (entries_.size() == capacity_) {
+    index_.erase(entries_.back().key);
+    entries_.pop_back();
+  }
+  entries_.push_front(Entry{key, std::move(bytecode)});
+  index_.emplace(std::move(key), entries_.begin());
+}
+
+size_t EvalCache::clear() {
+  size_t freed = 0;
+  // Each key is held by its entry and by the index.
+  for (const Entry &entry : entries_)
+    freed += 2 * entry.key.capacity();
+  index_.clear();
+  entries_.clear();
+  return freed;
+}
+
+} // namespace vm
+} // namespace hermes
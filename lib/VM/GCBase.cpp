@@ -63,6 +63,9 @@ GCBase::GCBase(
       randomizeAllocSpace_(gcConfig.getShouldRandomizeAllocSpace())
 #endif
 {
+  if (gcConfig.getBackgroundFreeing()) {
+    backgroundFreer_.reset(new BackgroundFreer());
+  }
 #ifdef HERMESVM_PLATFORM_LOGGING
   hermesLog(
       "HermesGC",
@@ -114,10 +117,17 @@ bool GCBase::createSnapshotToFile(const std::string &fileName, bool compact) {
   if (code) {
     return false;
   }
+  os.SetBufferSize(kSnapshotChunkSize);
   createSnapshot(os, compact);
   return true;
 }
 
+void GCBase::createSnapshotToFD(int fd, const HeapSnapshotOptions &options) {
+  llvm::raw_fd_ostream os(fd, /*shouldClose*/ false);
+  os.SetBufferSize(kSnapshotChunkSize);
+  createSnapshot(os, options);
+}
+
 void GCBase::checkTripwire(
     size_t dataSize,
     std::chrono::time_point<std::chrono::steady_clock> now) {
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/GCCostSizingPolicy.h"
+
+#include <algorithm>
+
+namespace hermes {
+namespace vm {
+
+constexpr double GCCostSizingPolicy::kMaxGrowFactor;
+
+GCCostSizingPolicy::GCCostSizingPolicy(double targetRatio)
+    : targetRatio_(
+          targetRatio > 0.0 && targetRatio < 1.0 ? targetRatio : 0.0) {}
+
+void GCCostSizingPolicy::recordCollection(
+    double pauseSecs,
+    Clock::time_point end) {
+  const bool hadLastEnd = hasLastEnd_;
+  const Clock::time_point lastEnd = lastEnd_;
+  hasLastEnd_ = true;
+  lastEnd_ = end;
+  // The first collection has no interval to be compared with.
+  if (!hadLastEnd)
+    return;
+
+  double intervalSecs = std::chrono::duration<double>(end - lastEnd).count();
+  double ratio = intervalSecs > pauseSecs ? pauseSecs / intervalSecs : 1.0;
+  costRatio_ =
+      numSamples_ == 0 ? ratio : kAlpha * ratio + (1.0 - kAlpha) * costRatio_;
+  ++numSamples_;
+}
+
+double GCCostSizingPolicy::takeSizeFactor() {
+  if (!enabled() || numSamples_ < kMinSamples)
+    return 1.0;
+  double factor = 1.0;
+  if (costRatio_ > targetRatio_) {
+    factor = std::min(kMaxGrowFactor, costRatio_ / targetRatio_);
+  } else if (costRatio_ < targetRatio_ * kShrinkBelow) {
+    factor = kShrinkFactor;
+  }
+  if (factor != 1.0)
+    numSamples_ = 0;
+  return factor;
+}
+
+} // namespace vm
+} // namespace hermes
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/GCTelemetry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+namespace {
+
+/// \return the nearest-rank \p percentile of \p sorted, which is not empty.
+double percentile(const std::vector<double> &sorted, double percentile) {
+  size_t rank = static_cast<size_t>(std::ceil(percentile * sorted.size()));
+  return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+/// Fill in the pause times of \p summary from \p pauses, in milliseconds.
+void summarizePauses(std::vector<double> &pauses, GCPauseSummary &summary) {
+  summary.numCollections = pauses.size();
+  if (pauses.empty())
+    return;
+  std::sort(pauses.begin(), pauses.end());
+  summary.p50 = percentile(pauses, 0.50) * 1000;
+  summary.p90 = percentile(pauses, 0.90) * 1000;
+  summary.p99 = percentile(pauses, 0.99) * 1000;
+  summary.max = pauses.back() * 1000;
+}
+
+} // namespace
+
+void GCTelemetry::recordCollection(
+    Kind kind,
+    double pauseSecs,
+    uint64_t promotedBytes,
+    uint64_t totalAllocatedBytes,
+    uint64_t heapSize) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  collections_[next_] = {
+      Clock::now(), kind, pauseSecs, promotedBytes, totalAllocatedBytes};
+  next_ = (next_ + 1) % kCapacity;
+  size_ = std::min(size_ + 1, kCapacity);
+  heapSize_ = heapSize;
+}
+
+GCTelemetrySummary GCTelemetry::summarize(Clock::duration window) const {
+  const Clock::time_point start = Clock::now() - window;
+  GCTelemetrySummary summary;
+  std::vector<double> youngPauses;
+  std::vector<double> fullPauses;
+  const Collection *first = nullptr;
+  const Collection *last = nullptr;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  summary.heapSize = heapSize_;
+  // Visit the collections from the oldest to the most recent.
+  for (size_t i = 0; i < size_; ++i) {
+    const Collection &collection =
+        collections_[(next_ + kCapacity - size_ + i) % kCapacity];
+    if (collection.end < start)
+      continue;
+    if (!first)
+      first = &collection;
+    last = &collection;
+    if (collection.kind == Kind::YoungGen) {
+      youngPauses.push_back(collection.pauseSecs);
+      summary.youngGen.promotedBytes += collection.promotedBytes;
+    } else {
+      fullPauses.push_back(collection.pauseSecs);
+      summary.full.promotedBytes += collection.promotedBytes;
+    }
+  }
+
+  summarizePauses(youngPauses, summary.youngGen);
+  summarizePauses(fullPauses, summary.full);
+
+  if (first != last) {
+    double secs =
+        std::chrono::duration<double>(last->end - first->end).count();
+    if (secs > 0) {
+      summary.allocationRate =
+          (last->totalAllocatedBytes - first->totalAllocatedBytes) / secs;
+    }
+  }
+  return summary;
+}
+
+} // namespace vm
+} // namespace hermes
@@ -11,6 +11,8 @@
 #include "hermes/Support/UTF8.h"
 #include "hermes/VM/StringPrimitive.h"
 
+#include "llvm/Support/MathExtras.h"
+
 #include <iomanip>
 #include <sstream>
 
@@ -291,9 +293,7 @@ void V8HeapSnapshot::beginNodes() {
 
 void V8HeapSnapshot::addNode(Node &&node) {
   assert(currentSection_ == Section::Nodes);
-  auto res = nodeToIndex_.try_emplace(node.id, nodeCount_++);
-  assert(res.second);
-  (void)res;
+  nodeIndex_.add(node.id);
   json_.emitValue(nodeTypeIndex(node.type));
   json_.emitValue(node.name);
   json_.emitValue(node.id);
@@ -332,10 +332,9 @@ void V8HeapSnapshot::addEdge(Edge &&edge) {
       json_.emitValue(edge.index());
       break;
   }
-  auto nodeIt = nodeToIndex_.find(edge.toNode);
-  assert(nodeIt != nodeToIndex_.end());
   // Point to the beginning of the target node in the `nodes` flat array.
-  json_.emitValue(nodeIt->second * V8_SNAPSHOT_NODE_FIELD_COUNT);
+  json_.emitValue(
+      nodeIndex_.lookup(edge.toNode) * V8_SNAPSHOT_NODE_FIELD_COUNT);
 }
 
 void V8HeapSnapshot::endEdges() {
@@ -512,6 +511,34 @@ size_t V8HeapSnapshot::sectionIndex(Section section) {
   return static_cast<std::underlying_type<Section>::type>(section);
 }
 
+void V8HeapSnapshot::NodeIndexMap::add(Node::ID id) {
+  assert(id % HeapAlign == 0 && "node IDs must be aligned");
+  size_t bit = id >> LogHeapAlign;
+  size_t word = bit / 64;
+  assert(
+      word + 1 >= bits_.size() &&
+      (word >= bits_.size() || (bits_[word] >> (bit % 64)) == 0) &&
+      "node IDs must be added in increasing order");
+  if (word >= bits_.size()) {
+    // All the IDs so far are in the words before this one.
+    bits_.resize(word + 1, 0);
+    wordRanks_.resize(word + 1, count_);
+  }
+  bits_[word] |= uint64_t(1) << (bit % 64);
+  ++count_;
+}
+
+V8HeapSnapshot::Node::Index V8HeapSnapshot::NodeIndexMap::lookup(
+    Node::ID id) const {
+  size_t bit = id >> LogHeapAlign;
+  size_t word = bit / 64;
+  assert(
+      word < bits_.size() && (bits_[word] >> (bit % 64) & 1) &&
+      "edge to a node which was not added");
+  uint64_t below = bits_[word] & ((uint64_t(1) << (bit % 64)) - 1);
+  return wordRanks_[word] + llvm::countPopulation(below);
+}
+
 uint32_t V8HeapSnapshot::nodeTypeIndex(V8HeapSnapshot::Node::Type type) {
   return static_cast<uint32_t>(type);
 }
@@ -573,6 +600,21 @@ std::string converter(const StringPrimitive *str) {
   convertUTF16ToUTF8WithReplacements(out, UTF16Ref(buf));
   return out;
 }
+std::string converter(const StringPrimitive *str, uint32_t maxLength) {
+  uint32_t length = str->getStringLength();
+  if (maxLength == 0 || length <= maxLength) {
+    return converter(str);
+  }
+  // Only copy the characters that are kept, however long the string is.
+  llvm::SmallVector<char16_t, 16> buf;
+  buf.reserve(maxLength);
+  for (uint32_t i = 0; i < maxLength; ++i) {
+    buf.push_back(str->at(i));
+  }
+  std::string out;
+  convertUTF16ToUTF8WithReplacements(out, UTF16Ref(buf));
+  return out;
+}
 std::string converter(const UTF16Ref ref) {
   std::string out;
   convertUTF16ToUTF8WithReplacements(out, ref);
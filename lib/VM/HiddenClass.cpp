@@ -11,6 +11,7 @@
 #include "hermes/VM/JSArray.h"
 #include "hermes/VM/JSObject.h"
 #include "hermes/VM/Operations.h"
+#include "hermes/VM/Profiler/ExecutionTracer.h"
 #include "hermes/VM/StringView.h"
 
 #include "llvm/Support/Debug.h"
@@ -33,6 +34,7 @@ void HiddenClassBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
   mb.addField("@family", &self->family_);
   mb.addField("@propertyMap", &self->propertyMap_);
   mb.addField("@forInCache", &self->forInCache_);
+  mb.addField("@keysCache", &self->keysCache_);
 }
 
 void HiddenClass::_markWeakImpl(GCCell *cell, GC *gc) {
@@ -50,6 +52,88 @@ size_t HiddenClass::_mallocSizeImpl(GCCell *cell) {
   return self->transitionMap_.getMemorySize();
 }
 
+bool HiddenClass::TransitionMap::contains(const Transition &key) {
+  if (firstSlot_ && firstKey_ == key &&
+      WeakRef<HiddenClass>::isSlotValid(firstSlot_))
+    return true;
+  return rest_ && rest_->find(key) != rest_->end();
+}
+
+llvm::Optional<Handle<HiddenClass>> HiddenClass::TransitionMap::lookup(
+    HandleRootOwner *runtime,
+    const Transition &key) {
+  if (firstSlot_ && firstKey_ == key) {
+    WeakRef<HiddenClass> ref{firstSlot_};
+    if (ref.isValid())
+      return ref.get(runtime);
+    // The child was collected, so pretend that we didn't find it.
+    firstSlot_ = nullptr;
+    return llvm::None;
+  }
+  if (!rest_)
+    return llvm::None;
+  return rest_->lookup(runtime, key);
+}
+
+bool HiddenClass::TransitionMap::insertNew(
+    GC *gc,
+    const Transition &key,
+    Handle<HiddenClass> value) {
+  if (contains(key))
+    return false;
+  if (!firstSlot_ || !WeakRef<HiddenClass>::isSlotValid(firstSlot_)) {
+    // The inline entry is free. The key cannot also be in rest_, since
+    // contains() would have found it.
+    firstKey_ = key;
+    firstSlot_ = WeakRef<HiddenClass>(gc, value).unsafeGetSlot();
+    return true;
+  }
+  if (!rest_)
+    rest_.reset(new WeakValueMap<Transition, HiddenClass>());
+  return rest_->insertNew(gc, key, value);
+}
+
+void HiddenClass::TransitionMap::markWeakRefs(GC *gc) {
+  if (firstSlot_) {
+    WeakRef<HiddenClass> ref{firstSlot_};
+    if (ref.isValid())
+      gc->markWeakRef(ref);
+    else
+      firstSlot_ = nullptr;
+  }
+  if (rest_) {
+    rest_->markWeakRefs(gc);
+    // Free the table once the children it held were all collected.
+    if (rest_->isKnownEmpty())
+      rest_.reset();
+  }
+}
+
+size_t HiddenClass::TransitionMap::getMemorySize() const {
+  return rest_ ? sizeof(*rest_) + rest_->getMemorySize() : 0;
+}
+
+uint32_t HiddenClass::releaseSharedPropertyMap(Runtime *runtime) {
+  if (!propertyMap_ || flags_.dictionaryMode ||
+      !transitionMap_.mayHaveMultiple())
+    return 0;
+  // The chain of an orphan class created by
+  // updatePropertyFlagsWithoutTransitions() doesn't lead to a root, so its
+  // map could not be rebuilt.
+  for (const HiddenClass *cur = this; cur->numProperties_ > 0;
+       cur = cur->parent_.get(runtime)) {
+    if (!cur->parent_)
+      return 0;
+  }
+
+  LLVM_DEBUG(
+      dbgs() << "Class:" << getDebugAllocationId()
+             << " releasing shared map\n");
+  uint32_t size = propertyMap_.get(runtime)->getAllocatedSize();
+  propertyMap_ = nullptr;
+  return size;
+}
+
 CallResult<HermesValue> HiddenClass::createRoot(Runtime *runtime) {
   return create(
       runtime,
@@ -102,6 +186,9 @@ Handle<HiddenClass> HiddenClass::convertToDictionary(
       dbgs() << "Converted Class:" << selfHandle->getDebugAllocationId()
              << " to dictionary Class:"
              << newClassHandle->getDebugAllocationId() << "\n");
+  if (LLVM_UNLIKELY(runtime->getExecutionTracer())) {
+    runtime->getExecutionTracer()->recordDictionaryMode();
+  }
 
   return newClassHandle;
 }
@@ -118,18 +205,14 @@ OptValue<HiddenClass::PropertyPos> HiddenClass::findProperty(
     // transition with name and the flags. The presence of such a transition
     // indicates that this is a new property and we don't have to build the map
     // in order to look for it (since we wouldn't find it anyway).
-    if (expectedFlags.isValid()) {
-      auto it = self->transitionMap_.find({name, expectedFlags});
-
-      if (it != self->transitionMap_.end()) {
-        LLVM_DEBUG(
-            dbgs() << "Property " << runtime->formatSymbolID(name)
-                   << " NOT FOUND in Class:" << self->getDebugAllocationId()
-                   << " due to existing transition to Class:"
-                   << it->second.get(runtime)->getDebugAllocationId() << "\n");
+    if (expectedFlags.isValid() &&
+        self->transitionMap_.contains({name, expectedFlags})) {
+      LLVM_DEBUG(
+          dbgs() << "Property " << runtime->formatSymbolID(name)
+                 << " NOT FOUND in Class:" << self->getDebugAllocationId()
+                 << " due to existing transition\n");
 
-        return llvm::None;
-      }
+      return llvm::None;
     }
 
     auto selfHandle = toHandle(runtime, std::move(self));
@@ -174,6 +257,7 @@ Handle<HiddenClass> HiddenClass::deleteProperty(
       : selfHandle;
 
   --newHandle->numProperties_;
+  ++newHandle->dictionaryVersion_;
 
   DictPropertyMap::erase(newHandle->propertyMap_.get(runtime), pos);
 
@@ -234,9 +318,10 @@ CallResult<std::pair<Handle<HiddenClass>, SlotIndex>> HiddenClass::addProperty(
                  << " transitions Map to existing Class:"
                  << optChildHandle.getValue()->getDebugAllocationId() << "\n");
 
+      transferPropertyMapToChild(selfHandle, *optChildHandle, runtime);
       if (LLVM_UNLIKELY(
               addToPropertyMap(
-                  selfHandle,
+                  *optChildHandle,
                   runtime,
                   name,
                   NamedPropertyDescriptor(
@@ -244,8 +329,6 @@ CallResult<std::pair<Handle<HiddenClass>, SlotIndex>> HiddenClass::addProperty(
               ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
       }
-      optChildHandle.getValue()->propertyMap_.set(
-          runtime, selfHandle->propertyMap_.get(runtime), &runtime->getHeap());
     } else {
       LLVM_DEBUG(
           dbgs() << "Adding property " << runtime->formatSymbolID(name)
@@ -254,14 +337,25 @@ CallResult<std::pair<Handle<HiddenClass>, SlotIndex>> HiddenClass::addProperty(
                  << optChildHandle.getValue()->getDebugAllocationId() << "\n");
     }
 
-    // In any case, clear our own map.
-    selfHandle->propertyMap_ = nullptr;
+    // Clear our own map, unless other children may still copy it.
+    if (!selfHandle->transitionMap_.mayHaveMultiple())
+      selfHandle->propertyMap_ = nullptr;
 
     return std::make_pair(*optChildHandle, selfHandle->numProperties_);
   }
 
-  // Do we need to convert to dictionary?
-  if (LLVM_UNLIKELY(selfHandle->numProperties_ == kDictionaryThreshold)) {
+  // Do we need to convert to dictionary? Past kLargeClassThreshold we only
+  // keep the chain shared if this is not the first object to get here.
+  bool toDictionary = false;
+  if (LLVM_UNLIKELY(selfHandle->numProperties_ >= kLargeClassThreshold)) {
+    if (selfHandle->numProperties_ == kDictionaryThreshold) {
+      toDictionary = true;
+    } else if (selfHandle->numProperties_ == kLargeClassThreshold) {
+      toDictionary = !selfHandle->largeGrowthSeen_;
+      selfHandle->largeGrowthSeen_ = true;
+    }
+  }
+  if (LLVM_UNLIKELY(toDictionary)) {
     // Do it.
     auto childHandle = convertToDictionary(selfHandle, runtime);
 
@@ -306,6 +400,10 @@ CallResult<std::pair<Handle<HiddenClass>, SlotIndex>> HiddenClass::addProperty(
           runtime->getIdentifierTable().getStringView(runtime, name))) {
     childHandle->flags_.hasIndexLikeProperties = true;
   }
+  if (propertyFlags != PropertyFlags::defaultNewNamedPropertyFlags() ||
+      InternalProperty::isInternal(name)) {
+    childHandle->flags_.hasNonDefaultProperties = true;
+  }
 
   if (selfHandle->propertyMap_) {
     assert(
@@ -318,10 +416,7 @@ CallResult<std::pair<Handle<HiddenClass>, SlotIndex>> HiddenClass::addProperty(
                << " transitions Map to new Class:"
                << childHandle->getDebugAllocationId() << "\n");
 
-    // Move the map to the child class.
-    childHandle->propertyMap_.set(
-        runtime, selfHandle->propertyMap_.get(runtime), &runtime->getHeap());
-    selfHandle->propertyMap_ = nullptr;
+    transferPropertyMapToChild(selfHandle, childHandle, runtime);
 
     if (LLVM_UNLIKELY(
             addToPropertyMap(
@@ -359,6 +454,7 @@ Handle<HiddenClass> HiddenClass::updateProperty(
     DictPropertyMap::getDescriptorPair(
         selfHandle->propertyMap_.get(runtime), pos)
         ->second.flags = newFlags;
+    ++selfHandle->dictionaryVersion_;
     return selfHandle;
   }
 
@@ -420,6 +516,7 @@ Handle<HiddenClass> HiddenClass::updateProperty(
           name,
           transitionFlags,
           selfHandle->numProperties_)));
+  childHandle->flags_.hasNonDefaultProperties = true;
 
   // The child has the same "shape" as we do, because it has the same fields.
   childHandle->family_.set(
@@ -556,6 +653,7 @@ Handle<HiddenClass> HiddenClass::updatePropertyFlagsWithoutTransitions(
   MutableHandle<HiddenClass> classHandle{runtime};
   if (selfHandle->isDictionary()) {
     classHandle = *selfHandle;
+    ++classHandle->dictionaryVersion_;
   } else {
     // To create an orphan hidden class with updated properties, first clone the
     // old one, and make it a root.
@@ -567,6 +665,7 @@ Handle<HiddenClass> HiddenClass::updatePropertyFlagsWithoutTransitions(
             SymbolID{},
             PropertyFlags{},
             selfHandle->numProperties_)));
+    classHandle->flags_.hasNonDefaultProperties = true;
     // Move the property map to the new hidden class.
     classHandle->propertyMap_.set(
         runtime, selfHandle->propertyMap_.get(runtime), &runtime->getHeap());
@@ -668,11 +767,19 @@ void HiddenClass::initializeMissingPropertyMap(
     Runtime *runtime) {
   assert(!selfHandle->propertyMap_ && "property map is already initialized");
 
-  // Check whether we can steal our parent's map. If we can, we only need
-  // to add or update a single property.
-  if (selfHandle->parent_ &&
-      selfHandle->parent_.get(runtime)->propertyMap_.get(runtime))
-    return stealPropertyMapFromParent(selfHandle, runtime);
+  if (selfHandle->parent_) {
+    // A parent with several children keeps a map that each of them starts
+    // from, so that they don't all walk the chain of classes. Build it if it
+    // isn't there.
+    HiddenClass *parent = selfHandle->parent_.get(runtime);
+    if (!parent->propertyMap_ && parent->transitionMap_.mayHaveMultiple())
+      initializeMissingPropertyMap(runtime->makeHandle(parent), runtime);
+
+    // Check whether we can steal our parent's map. If we can, we only need
+    // to add or update a single property.
+    if (selfHandle->parent_.get(runtime)->propertyMap_)
+      return stealPropertyMapFromParent(selfHandle, runtime);
+  }
 
   LLVM_DEBUG(
       dbgs() << "Class:" << selfHandle->getDebugAllocationId()
@@ -721,26 +828,47 @@ void HiddenClass::initializeMissingPropertyMap(
   selfHandle->propertyMap_.set(runtime, *mapHandle, &runtime->getHeap());
 }
 
+void HiddenClass::transferPropertyMapToChild(
+    Handle<HiddenClass> selfHandle,
+    Handle<HiddenClass> childHandle,
+    Runtime *runtime) {
+  assert(
+      selfHandle->propertyMap_ && !childHandle->propertyMap_ &&
+      "the map must be transferred from a parent with one to a child without");
+  if (LLVM_LIKELY(!selfHandle->transitionMap_.mayHaveMultiple())) {
+    childHandle->propertyMap_.set(
+        runtime, selfHandle->propertyMap_.get(runtime), &runtime->getHeap());
+    selfHandle->propertyMap_ = nullptr;
+    return;
+  }
+
+  // Other children may need the map later, so keep it and give the child a
+  // copy with room for the property it adds.
+  auto mapHandle = runtime->makeHandle(selfHandle->propertyMap_);
+  auto copy = runtime->ignoreAllocationFailure(
+      DictPropertyMap::clone(mapHandle, runtime, mapHandle->size() + 1));
+  childHandle->propertyMap_.set(runtime, copy.get(), &runtime->getHeap());
+}
+
 void HiddenClass::stealPropertyMapFromParent(
     Handle<HiddenClass> selfHandle,
     Runtime *runtime) {
-  auto *self = *selfHandle;
   assert(
-      self->parent_ && self->parent_.get(runtime)->propertyMap_ &&
-      !self->propertyMap_ &&
+      selfHandle->parent_ &&
+      selfHandle->parent_.get(runtime)->propertyMap_ &&
+      !selfHandle->propertyMap_ &&
       "stealPropertyMapFromParent() must be called with a valid parent with a property map");
 
   LLVM_DEBUG(
-      dbgs() << "Class:" << self->getDebugAllocationId()
+      dbgs() << "Class:" << selfHandle->getDebugAllocationId()
              << " stealing map from parent Class:"
-             << self->parent_.get(runtime)->getDebugAllocationId() << "\n");
+             << selfHandle->parent_.get(runtime)->getDebugAllocationId()
+             << "\n");
 
   // Success! Just steal our parent's map and add our own property.
-  self->propertyMap_.set(
-      runtime,
-      self->parent_.get(runtime)->propertyMap_.get(runtime),
-      &runtime->getHeap());
-  self->parent_.get(runtime)->propertyMap_ = nullptr;
+  transferPropertyMapToChild(
+      runtime->makeHandle(selfHandle->parent_), selfHandle, runtime);
+  auto *self = *selfHandle;
 
   // Does our class add a new property?
   if (LLVM_LIKELY(!self->propertyFlags_.flagsTransition)) {
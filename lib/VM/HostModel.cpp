@@ -111,8 +111,45 @@ CallResult<HermesValue> HostObject::createWithoutPrototype(
   return HermesValue::encodeObjectValue(hostObj);
 }
 
-void HostObject::_finalizeImpl(GCCell *cell, GC *) {
+ExecutionStatus HostObject::cacheStableProperty(
+    Handle<HostObject> selfHandle,
+    Runtime *runtime,
+    SymbolID name) {
+  NamedPropertyDescriptor desc;
+  if (JSObject::getOwnNamedDescriptor(selfHandle, runtime, name, desc))
+    return ExecutionStatus::RETURNED;
+
+  auto valueRes = selfHandle->get(name);
+  if (LLVM_UNLIKELY(valueRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  // The host may have defined it while computing the value.
+  if (JSObject::getOwnNamedDescriptor(selfHandle, runtime, name, desc))
+    return ExecutionStatus::RETURNED;
+
+  PropertyFlags flags{};
+  return JSObject::defineNewOwnProperty(
+      selfHandle, runtime, name, flags, runtime->makeHandle(*valueRes));
+}
+
+bool HostObject::setExternalMemorySize(GC *gc, uint32_t size) {
+  if (size > externalMemorySize_ && !gc->canAllocExternalMemory(size)) {
+    return false;
+  }
+  if (externalMemorySize_) {
+    gc->debitExternalMemory(this, externalMemorySize_);
+  }
+  if (size) {
+    gc->creditExternalMemory(this, size);
+  }
+  externalMemorySize_ = size;
+  return true;
+}
+
+void HostObject::_finalizeImpl(GCCell *cell, GC *gc) {
   auto *self = vmcast<HostObject>(cell);
+  if (self->externalMemorySize_) {
+    gc->debitExternalMemory(self, self->externalMemorySize_);
+  }
   // Destruct the object.
   self->~HostObject();
 }
@@ -92,6 +92,10 @@ CallResult<Handle<SymbolID>> IdentifierTable::getSymbolHandleFromPrimitive(
   return runtime->makeHandle(*cr);
 }
 
+SymbolID IdentifierTable::getSymbolIDIfUniqued(const StringPrimitive *str) {
+  return str->isUniqued() ? str->getUniqueID() : SymbolID{};
+}
+
 StringPrimitive *IdentifierTable::getStringPrim(Runtime *runtime, SymbolID id) {
   auto &entry = getLookupTableEntry(id);
   if (entry.isStringPrim()) {
@@ -117,6 +117,64 @@ bool PerfEvents::endAndInsertStats(std::string &jsonStats) {
   return true;
 }
 
+bool ThreadPerfCounters::open(uint64_t tid) {
+  close();
+  static const uint64_t configs[NumCounters] = {
+      PERF_COUNT_HW_CPU_CYCLES,
+      PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_MISSES,
+  };
+  for (unsigned i = 0; i < NumCounters; ++i) {
+    perf_event_attr pe;
+    memset(&pe, 0, sizeof(perf_event_attr));
+    pe.type = PERF_TYPE_HARDWARE;
+    pe.size = sizeof(perf_event_attr);
+    pe.config = configs[i];
+    pe.exclude_kernel = 1;
+    pe.exclude_hv = 1;
+    pe.read_format = PERF_FORMAT_GROUP;
+    fds_[i] = syscall(
+        __NR_perf_event_open,
+        &pe,
+        static_cast<pid_t>(tid),
+        -1, /* any CPU */
+        i == 0 ? -1 : fds_[0],
+        0 /* flags */);
+    if (fds_[i] == -1) {
+      close();
+      return false;
+    }
+  }
+  groupFd_ = fds_[0];
+  return true;
+}
+
+void ThreadPerfCounters::close() {
+  for (int &fd : fds_) {
+    if (fd != -1) {
+      ::close(fd);
+      fd = -1;
+    }
+  }
+  groupFd_ = -1;
+}
+
+bool ThreadPerfCounters::read(uint64_t values[NumCounters]) const {
+  if (groupFd_ == -1) {
+    return false;
+  }
+  // With PERF_FORMAT_GROUP, the number of counters comes first.
+  uint64_t buf[1 + NumCounters];
+  if (::read(groupFd_, buf, sizeof(buf)) != sizeof(buf) ||
+      buf[0] != NumCounters) {
+    return false;
+  }
+  for (unsigned i = 0; i < NumCounters; ++i) {
+    values[i] = buf[1 + i];
+  }
+  return true;
+}
+
 } // namespace instrumentation
 } // namespace vm
 } // namespace hermes
@@ -137,6 +195,16 @@ bool PerfEvents::endAndInsertStats(std::string &jsonStats) {
   return false;
 }
 
+bool ThreadPerfCounters::open(uint64_t) {
+  return false;
+}
+
+void ThreadPerfCounters::close() {}
+
+bool ThreadPerfCounters::read(uint64_t[NumCounters]) const {
+  return false;
+}
+
 } // namespace instrumentation
 } // namespace vm
 } // namespace hermes
@@ -18,6 +18,13 @@ void RuntimeStats::flushPendingTimers() {
   }
 }
 
+void RuntimeStats::enableNativeCallStats(uint32_t samplingInterval) {
+  assert(samplingInterval > 0 && "sampling interval must be positive");
+  nativeCalls.clear();
+  nativeCallSamplingInterval = samplingInterval;
+  nativeCallsUntilTimed = samplingInterval;
+}
+
 RuntimeStats::Sampled RAIITimer::trySampling() const {
   if (!runtimeStats_.shouldSample)
     return {};
@@ -34,8 +34,31 @@
 // Add an arbitrary byte offset to ip.
 #define IPADD(val) ((const Inst *)((const uint8_t *)ip + (val)))
 
+// Set ip to the target of a taken jump, counting backward jumps as loop
+// iterations towards the JIT hotness of the current code block. Once the
+// function is hot enough, a backward jump continues the execution of the frame
+// in native code at the loop header (on-stack replacement).
+#ifdef HERMESVM_JIT
+#define JUMP_TO(dest)                                                 \
+  do {                                                                \
+    const Inst *jumpTarget = (dest);                                  \
+    if (jumpTarget <= ip) {                                           \
+      curCodeBlock->incrementBackEdgeCount();                         \
+      if (!SingleStep &&                                              \
+          LLVM_UNLIKELY(                                              \
+              runtime->jitContext_.shouldAttemptOSR(curCodeBlock))) { \
+        ip = jumpTarget;                                              \
+        goto onStackReplacement;                                      \
+      }                                                               \
+    }                                                                 \
+    ip = jumpTarget;                                                  \
+  } while (0)
+#else
+#define JUMP_TO(dest) (ip = (dest))
+#endif
+
 // Get the current bytecode offset.
-#define CUROFFSET ((const uint8_t *)ip - (const uint8_t *)curCodeBlock->begin())
+#define CUROFFSET (curCodeBlock->getOffsetOf(ip))
 
 // Calculate the address of the next instruction given the name of the current
 // one.
@@ -8,6 +8,8 @@
 #include "JSLib/JSLibInternal.h"
 #include "hermes/VM/Casting.h"
 #include "hermes/VM/Interpreter.h"
+#include "hermes/VM/JSArray.h"
+#include "hermes/VM/Operations.h"
 #include "hermes/VM/StringPrimitive.h"
 
 #include "Interpreter-internal.h"
@@ -128,5 +130,172 @@ ExecutionStatus Interpreter::casePutOwnGetterSetterByVal(
       .getStatus();
 }
 
+/// \return true if \p source can be iterated by index: it is an array whose
+/// @@iterator is \p method, the original Array.prototype.values, and
+/// %ArrayIteratorPrototype%.next is still the original builtin.
+static bool canIterateByIndex(
+    Runtime *runtime,
+    HermesValue source,
+    HermesValue method) {
+  if (!vmisa<JSArray>(source) ||
+      method.getRaw() != runtime->arrayPrototypeValues.getRaw()) {
+    return false;
+  }
+  auto *proto = vmcast<JSObject>(runtime->arrayIteratorPrototype);
+  NamedPropertyDescriptor desc;
+  auto found = JSObject::tryGetOwnNamedDescriptorFast(
+      proto, runtime, Predefined::getSymbolID(Predefined::next), desc);
+  return found.hasValue() && *found && !desc.flags.accessor &&
+      JSObject::getNamedSlotValue(proto, runtime, desc).getRaw() ==
+      runtime->arrayIteratorPrototypeNext.getRaw();
+}
+
+ExecutionStatus Interpreter::caseIteratorBegin(
+    Runtime *runtime,
+    PinnedHermesValue *frameRegs,
+    const inst::Inst *ip) {
+  Handle<> source{&O2REG(IteratorBegin)};
+  auto iterSym = Predefined::getSymbolID(Predefined::SymbolIterator);
+  auto methodRes = LLVM_LIKELY(source->isObject())
+      ? JSObject::getNamed_RJS(
+            Handle<JSObject>::vmcast(source), runtime, iterSym)
+      : getByIdTransient_RJS(runtime, source, iterSym);
+  if (LLVM_UNLIKELY(methodRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+
+  if (LLVM_LIKELY(canIterateByIndex(runtime, *source, *methodRes))) {
+    O1REG(IteratorBegin) = HermesValue::encodeNumberValue(0);
+    return ExecutionStatus::RETURNED;
+  }
+
+  auto method = runtime->makeHandle(*methodRes);
+  if (LLVM_UNLIKELY(!vmisa<Callable>(*method))) {
+    return runtime->raiseTypeErrorForValue(method, " is not a function");
+  }
+  auto iteratorRes = Callable::executeCall0(
+      Handle<Callable>::vmcast(method), runtime, source);
+  if (LLVM_UNLIKELY(iteratorRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  if (LLVM_UNLIKELY(!iteratorRes->isObject())) {
+    return runtime->raiseTypeError("iterator is not an object");
+  }
+  auto iterator = runtime->makeHandle<JSObject>(*iteratorRes);
+  auto nextRes = JSObject::getNamed_RJS(
+      iterator, runtime, Predefined::getSymbolID(Predefined::next));
+  if (LLVM_UNLIKELY(nextRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  O1REG(IteratorBegin) = iterator.getHermesValue();
+  O2REG(IteratorBegin) = *nextRes;
+  return ExecutionStatus::RETURNED;
+}
+
+ExecutionStatus Interpreter::caseIteratorNext(
+    Runtime *runtime,
+    PinnedHermesValue *frameRegs,
+    const inst::Inst *ip) {
+  if (O2REG(IteratorNext).isNumber()) {
+    // An array iterated by index, whose element isn't in its storage: it is
+    // looked up like any other property, which may run getters.
+    auto arr = Handle<JSArray>::vmcast(&O3REG(IteratorNext));
+    uint32_t index = O2REG(IteratorNext).getNumberAs<uint32_t>();
+    if (index >= JSArray::getLength(*arr)) {
+      O1REG(IteratorNext) = HermesValue::encodeUndefinedValue();
+      O2REG(IteratorNext) = HermesValue::encodeUndefinedValue();
+      return ExecutionStatus::RETURNED;
+    }
+    auto valueRes = JSObject::getComputed_RJS(
+        arr,
+        runtime,
+        runtime->makeHandle(HermesValue::encodeNumberValue(index)));
+    if (LLVM_UNLIKELY(valueRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    O1REG(IteratorNext) = *valueRes;
+    O2REG(IteratorNext) = HermesValue::encodeNumberValue(index + 1);
+    return ExecutionStatus::RETURNED;
+  }
+
+  Handle<> next{&O3REG(IteratorNext)};
+  if (LLVM_UNLIKELY(!vmisa<Callable>(*next))) {
+    return runtime->raiseTypeErrorForValue(next, " is not a function");
+  }
+  auto resultRes = Callable::executeCall0(
+      Handle<Callable>::vmcast(next), runtime, Handle<>(&O2REG(IteratorNext)));
+  if (LLVM_UNLIKELY(resultRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  if (LLVM_UNLIKELY(!resultRes->isObject())) {
+    return runtime->raiseTypeError("iterator.next() did not return an object");
+  }
+  auto result = runtime->makeHandle<JSObject>(*resultRes);
+  auto doneRes = JSObject::getNamed_RJS(
+      result, runtime, Predefined::getSymbolID(Predefined::done));
+  if (LLVM_UNLIKELY(doneRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  if (toBoolean(*doneRes)) {
+    O1REG(IteratorNext) = HermesValue::encodeUndefinedValue();
+    O2REG(IteratorNext) = HermesValue::encodeUndefinedValue();
+    return ExecutionStatus::RETURNED;
+  }
+  auto valueRes = JSObject::getNamed_RJS(
+      result, runtime, Predefined::getSymbolID(Predefined::value));
+  if (LLVM_UNLIKELY(valueRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  O1REG(IteratorNext) = *valueRes;
+  return ExecutionStatus::RETURNED;
+}
+
+ExecutionStatus Interpreter::caseIteratorClose(
+    Runtime *runtime,
+    PinnedHermesValue *frameRegs,
+    const inst::Inst *ip) {
+  // Iterations by index have nothing to close.
+  if (!O1REG(IteratorClose).isObject()) {
+    return ExecutionStatus::RETURNED;
+  }
+  bool ignoreInnerException = ip->iIteratorClose.op2;
+  auto iterator = Handle<JSObject>::vmcast(&O1REG(IteratorClose));
+
+  // Exceptions thrown while closing are dropped when requested, unless they
+  // are uncatchable.
+  auto innerException = [runtime, ignoreInnerException]() {
+    if (ignoreInnerException &&
+        !isUncatchableError(runtime->getThrownValue())) {
+      runtime->clearThrownValue();
+      return ExecutionStatus::RETURNED;
+    }
+    return ExecutionStatus::EXCEPTION;
+  };
+
+  auto returnRes = JSObject::getNamed_RJS(
+      iterator, runtime, Predefined::getSymbolID(Predefined::returnStr));
+  if (LLVM_UNLIKELY(returnRes == ExecutionStatus::EXCEPTION)) {
+    return innerException();
+  }
+  if (returnRes->isUndefined() || returnRes->isNull()) {
+    return ExecutionStatus::RETURNED;
+  }
+  auto returnMethod = runtime->makeHandle(*returnRes);
+  if (LLVM_UNLIKELY(!vmisa<Callable>(*returnMethod))) {
+    runtime->raiseTypeErrorForValue(returnMethod, " is not a function");
+    return innerException();
+  }
+  auto innerRes = Callable::executeCall0(
+      Handle<Callable>::vmcast(returnMethod), runtime, iterator);
+  if (LLVM_UNLIKELY(innerRes == ExecutionStatus::EXCEPTION)) {
+    return innerException();
+  }
+  if (!ignoreInnerException && LLVM_UNLIKELY(!innerRes->isObject())) {
+    return runtime->raiseTypeError(
+        "iterator.close() did not return an object");
+  }
+  return ExecutionStatus::RETURNED;
+}
+
 } // namespace vm
 } // namespace hermes
@@ -8,6 +8,7 @@
 #include "hermes/VM/Interpreter.h"
 #include "hermes/VM/Runtime.h"
 
+#include "hermes/Inst/Builtins.h"
 #include "hermes/Inst/InstDecode.h"
 #include "hermes/Support/Conversions.h"
 #include "hermes/Support/SlowAssert.h"
@@ -21,6 +22,7 @@
 #include "hermes/VM/JSRegExp.h"
 #include "hermes/VM/Operations.h"
 #include "hermes/VM/Profiler.h"
+#include "hermes/VM/Profiler/ExecutionTracer.h"
 #include "hermes/VM/Runtime-inline.h"
 #include "hermes/VM/RuntimeModule-inline.h"
 #include "hermes/VM/StackFrame-inline.h"
@@ -45,6 +47,15 @@ HERMES_SLOW_STATISTIC(
 HERMES_SLOW_STATISTIC(
     NumGetByIdProtoHits,
     "NumGetByIdProtoHits: Number of property 'read by id' cache hits for the prototype");
+HERMES_SLOW_STATISTIC(
+    NumGetByIdAccessorHits,
+    "NumGetByIdAccessorHits: Number of property 'read by id' cache hits for accessors");
+HERMES_SLOW_STATISTIC(
+    NumGetByIdPolyHits,
+    "NumGetByIdPolyHits: Number of property 'read by id' polymorphic cache hits");
+HERMES_SLOW_STATISTIC(
+    NumGetByIdDictHits,
+    "NumGetByIdDictHits: Number of property 'read by id' dictionary cache hits");
 HERMES_SLOW_STATISTIC(
     NumGetByIdCacheEvicts,
     "NumGetByIdCacheEvicts: Number of property 'read by id' cache evictions");
@@ -70,6 +81,15 @@ HERMES_SLOW_STATISTIC(
 HERMES_SLOW_STATISTIC(
     NumPutByIdCacheHits,
     "NumPutByIdCacheHits: Number of property 'write by id' cache hits");
+HERMES_SLOW_STATISTIC(
+    NumPutByIdPolyHits,
+    "NumPutByIdPolyHits: Number of property 'write by id' polymorphic cache hits");
+HERMES_SLOW_STATISTIC(
+    NumPutByIdDictHits,
+    "NumPutByIdDictHits: Number of property 'write by id' dictionary cache hits");
+HERMES_SLOW_STATISTIC(
+    NumPutByIdAccessorHits,
+    "NumPutByIdAccessorHits: Number of property 'write by id' cache hits for accessors");
 HERMES_SLOW_STATISTIC(
     NumPutByIdCacheEvicts,
     "NumPutByIdCacheEvicts: Number of property 'write by id' cache evictions");
@@ -80,12 +100,25 @@ HERMES_SLOW_STATISTIC(
     NumPutByIdTransient,
     "NumPutByIdTransient: Number of property 'write by id' to non-objects");
 
+HERMES_SLOW_STATISTIC(
+    NumPropCacheMonomorphic,
+    "NumPropCacheMonomorphic: Number of property cache sites that became monomorphic");
+HERMES_SLOW_STATISTIC(
+    NumPropCachePolymorphic,
+    "NumPropCachePolymorphic: Number of property cache sites that became polymorphic");
+HERMES_SLOW_STATISTIC(
+    NumPropCacheMegamorphic,
+    "NumPropCacheMegamorphic: Number of property cache sites that became megamorphic");
+
 HERMES_SLOW_STATISTIC(
     NumNativeFunctionCalls,
     "NumNativeFunctionCalls: Number of native function calls");
 HERMES_SLOW_STATISTIC(
     NumBoundFunctionCalls,
     "NumBoundCalls: Number of bound function calls");
+HERMES_SLOW_STATISTIC(
+    NumFunctionPrototypeCalls,
+    "NumFunctionPrototypeCalls: Number of Function.prototype.call calls in place");
 
 // Ensure that instructions declared as having matching layouts actually do.
 #include "InstLayout.inc"
@@ -269,6 +302,55 @@ CallResult<HermesValue> Interpreter::getArgumentsPropByValSlowPath_RJS(
       runtime, lazyReg, valueReg, curFunction, strictMode);
 }
 
+CallResult<HermesValue> Interpreter::applyArguments_RJS(
+    Runtime *runtime,
+    PinnedHermesValue *lazyReg,
+    Handle<> callee,
+    Handle<> function,
+    Handle<> thisArg,
+    Handle<Callable> curFunction,
+    bool strictMode) {
+  auto frame = runtime->getCurrentFrame();
+
+  if (lazyReg->isUndefined() &&
+      callee->getRaw() == runtime->functionPrototypeApply.getRaw()) {
+    // Function.prototype.apply would only read the length and the elements of
+    // the arguments object, which are the arguments of the frame.
+    auto func = Handle<Callable>::dyn_vmcast(runtime, function);
+    if (LLVM_UNLIKELY(!func)) {
+      return runtime->raiseTypeError("Can't apply() to non-callable");
+    }
+    uint32_t argCount = frame.getArgCount();
+    ScopedNativeCallFrame newFrame{runtime, argCount, *func, false, *thisArg};
+    if (LLVM_UNLIKELY(newFrame.overflowed()))
+      return runtime->raiseStackOverflow(
+          Runtime::StackOverflowKind::NativeStack);
+    for (uint32_t argIndex = 0; argIndex < argCount; ++argIndex) {
+      newFrame->getArgRef(argIndex) = frame.getArgRef(argIndex);
+    }
+    return Callable::call(func, runtime);
+  }
+
+  if (lazyReg->isUndefined()) {
+    auto argRes = reifyArgumentsSlowPath(runtime, curFunction, strictMode);
+    if (LLVM_UNLIKELY(argRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    *lazyReg = *argRes;
+  }
+
+  auto callable = Handle<Callable>::dyn_vmcast(runtime, callee);
+  if (LLVM_UNLIKELY(!callable)) {
+    return runtime->raiseTypeErrorForValue(callee, " is not a function");
+  }
+  ScopedNativeCallFrame newFrame{runtime, 2, *callable, false, *function};
+  if (LLVM_UNLIKELY(newFrame.overflowed()))
+    return runtime->raiseStackOverflow(Runtime::StackOverflowKind::NativeStack);
+  newFrame->getArgRef(0) = *thisArg;
+  newFrame->getArgRef(1) = *lazyReg;
+  return Callable::call(callable, runtime);
+}
+
 ExecutionStatus Interpreter::handleGetPNameList(
     Runtime *runtime,
     PinnedHermesValue *frameRegs,
@@ -305,6 +387,13 @@ CallResult<HermesValue> Interpreter::handleCallSlowPath(
     PinnedHermesValue *callTarget) {
   if (auto *native = dyn_vmcast<NativeFunction>(*callTarget)) {
     ++NumNativeFunctionCalls;
+    if (callTarget->getRaw() == runtime->functionPrototypeCall.getRaw()) {
+      StackFramePtr calleeFrame{runtime->getStackPointer()};
+      if (calleeFrame.getNewTargetRef().isUndefined() &&
+          vmisa<Callable>(calleeFrame.getThisArgRef())) {
+        return callFunctionPrototypeCall(runtime);
+      }
+    }
     // Call the native function directly
     return NativeFunction::_nativeCall(native, runtime);
   } else if (auto *bound = dyn_vmcast<BoundFunction>(*callTarget)) {
@@ -317,6 +406,55 @@ CallResult<HermesValue> Interpreter::handleCallSlowPath(
   }
 }
 
+CallResult<HermesValue> Interpreter::callFunctionPrototypeCall(
+    Runtime *runtime) {
+  ++NumFunctionPrototypeCalls;
+  StackFramePtr originalCalleeFrame{runtime->getStackPointer()};
+  uint32_t argCount = originalCalleeFrame.getArgCount();
+  // The target is overwritten by the frame metadata, keep it in a handle.
+  Handle<Callable> func = runtime->makeHandle(
+      vmcast<Callable>(originalCalleeFrame.getThisArgRef()));
+
+  // Move the frame up so that its 'this' is the first argument. Without
+  // arguments, 'this' is undefined instead.
+  PinnedHermesValue *newFramePtr = originalCalleeFrame.ptr();
+  if (argCount) {
+    newFramePtr =
+        &originalCalleeFrame.getArgRefUnsafe(0) - StackFrameLayout::ThisArg;
+    runtime->popToSavedStackPointer(newFramePtr);
+  } else {
+    originalCalleeFrame.getThisArgRef() = HermesValue::encodeUndefinedValue();
+  }
+  (void)StackFramePtr::initFrame(
+      newFramePtr,
+      runtime->getCurrentFrame(),
+      nullptr,
+      nullptr,
+      argCount ? argCount - 1 : 0,
+      func.getHermesValue(),
+      HermesValue::encodeUndefinedValue());
+
+  auto res = Callable::call(func, runtime);
+
+  // Restore the original stack level and the registers which are not
+  // supposed to be modified by a call, like _boundCall() does.
+  runtime->popToSavedStackPointer(newFramePtr);
+  runtime->allocUninitializedStack(newFramePtr - originalCalleeFrame.ptr());
+  assert(
+      runtime->getStackPointer() == originalCalleeFrame.ptr() &&
+      "Stack wasn't restored properly");
+  StackFramePtr::initFrame(
+      originalCalleeFrame.ptr(),
+      StackFramePtr{},
+      nullptr,
+      nullptr,
+      0,
+      nullptr,
+      false);
+  originalCalleeFrame.getThisArgRef() = func.getHermesValue();
+  return res;
+}
+
 inline OptValue<HermesValue> Interpreter::tryGetPrimitiveOwnPropertyById(
     Runtime *runtime,
     Handle<> base,
@@ -532,12 +670,26 @@ ExecutionStatus Interpreter::putByValTransient_RJS(
   return putByIdTransient_RJS(runtime, base, **idRes, value, strictMode);
 }
 
+/// \return the allocation site feedback of the literal allocated by \p ip, or
+/// nullptr if the GC doesn't use allocation site feedback or \p ip is null.
+static AllocationSiteInfo *
+getAllocationSite(Runtime *runtime, CodeBlock *curCodeBlock, const Inst *ip) {
+  if (!ip || !runtime->getHeap().allocationSiteFeedbackEnabled())
+    return nullptr;
+  return curCodeBlock->getAllocationSiteInfo(ip);
+}
+
 CallResult<HermesValue> Interpreter::createObjectFromBuffer(
     Runtime *runtime,
     CodeBlock *curCodeBlock,
     unsigned numLiterals,
     unsigned keyBufferIndex,
-    unsigned valBufferIndex) {
+    unsigned valBufferIndex,
+    const Inst *ip) {
+  AllocationSiteInfo *site = getAllocationSite(runtime, curCodeBlock, ip);
+  GCBase::PretenureScope pretenure{
+      &runtime->getHeap(), site && site->pretenure};
+
   // Fetch any cached hidden class first.
   auto *runtimeModule = curCodeBlock->getRuntimeModule();
   const llvm::Optional<Handle<HiddenClass>> optCachedHiddenClassHandle =
@@ -649,12 +801,11 @@ CallResult<HermesValue> Interpreter::createObjectFromBuffer(
     assert(
         numLiterals == clazz->getNumProperties() &&
         "numLiterals should match hidden class property count.");
-    assert(
-        clazz->getNumProperties() < 256 &&
-        "cached hidden class should have property count less than 256");
     runtimeModule->tryCacheLiteralHiddenClass(keyBufferIndex, clazz);
   }
 
+  if (site && !site->pretenure)
+    runtime->getHeap().recordAllocationSite(*obj, site);
   return HermesValue::encodeObjectValue(*obj);
 }
 
@@ -663,16 +814,43 @@ CallResult<HermesValue> Interpreter::createArrayFromBuffer(
     CodeBlock *curCodeBlock,
     unsigned numElements,
     unsigned numLiterals,
-    unsigned bufferIndex) {
+    unsigned bufferIndex,
+    const Inst *ip) {
+  AllocationSiteInfo *site = getAllocationSite(runtime, curCodeBlock, ip);
+  GCBase::PretenureScope pretenure{
+      &runtime->getHeap(), site && site->pretenure};
+
+  // An array made only of literals has the same elements every time it is
+  // created, so all of them share the storage of the first one, which is
+  // copied when an array is first modified.
+  RuntimeModule *runtimeModule = curCodeBlock->getRuntimeModule();
+  bool shareable = numLiterals == numElements && numElements != 0;
+  if (shareable) {
+    bool allNumbers;
+    if (SegmentedArray *storage = runtimeModule->findCachedLiteralArrayStorage(
+            bufferIndex, numLiterals, allNumbers)) {
+      auto arrRes = JSArray::createWithSharedStorage(
+          runtime, runtime->makeHandle(storage), allNumbers);
+      if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      if (site && !site->pretenure)
+        runtime->getHeap().recordAllocationSite(arrRes->get(), site);
+      return HermesValue::encodeObjectValue(arrRes->get());
+    }
+  }
+
   // Create a new array using the built-in constructor, and initialize
   // the elements from a literal array buffer.
   auto arrRes = JSArray::create(runtime, numElements, numElements);
   if (arrRes == ExecutionStatus::EXCEPTION) {
     return ExecutionStatus::EXCEPTION;
   }
-  // Resize the array storage in advance.
+  // Resize the array storage in advance, for the literals only. Any other
+  // elements are stored after this by the caller, which appends them to the
+  // storage without leaving holes.
   auto arr = toHandle(runtime, std::move(*arrRes));
-  JSArray::setStorageEndIndex(arr, runtime, numElements);
+  JSArray::setStorageEndIndex(arr, runtime, numLiterals);
 
   auto iter = curCodeBlock->getArrayBufferIter(bufferIndex, numLiterals);
   JSArray::size_type i = 0;
@@ -681,10 +859,43 @@ CallResult<HermesValue> Interpreter::createArrayFromBuffer(
     auto value = iter.get(runtime);
     JSArray::unsafeSetExistingElementAt(*arr, runtime, i++, value);
   }
+  JSArray::unsafeMarkFilled(*arr, runtime);
+  if (shareable && arr->getElementsKind() != JSArray::ElementsKind::Holey) {
+    runtimeModule->cacheLiteralArrayStorage(
+        bufferIndex,
+        numLiterals,
+        JSArray::unsafeShareStorage(*arr, runtime),
+        arr->getElementsKind() == JSArray::ElementsKind::PackedNumber);
+  }
 
+  if (site && !site->pretenure)
+    runtime->getHeap().recordAllocationSite(*arr, site);
   return HermesValue::encodeObjectValue(*arr);
 }
 
+CallResult<HermesValue> Interpreter::createTemplateObjectFromBuffer(
+    Runtime *runtime,
+    CodeBlock *curCodeBlock,
+    uint32_t templateObjID,
+    unsigned numLiterals,
+    unsigned bufferIndex) {
+  GCScope gcScope{runtime};
+  auto iter = curCodeBlock->getArrayBufferIter(bufferIndex, numLiterals);
+  bool dup = iter.get(runtime).getBool();
+  // Reading the strings allocates them, so keep them in handles.
+  llvm::SmallVector<Handle<>, 8> strings{};
+  while (iter.hasNext())
+    strings.push_back(runtime->makeHandle(iter.get(runtime)));
+  uint32_t count = dup ? strings.size() : strings.size() / 2;
+  return createTemplateObject(
+      runtime,
+      curCodeBlock->getRuntimeModule(),
+      templateObjID,
+      count,
+      dup,
+      [&strings](uint32_t i) { return strings[i].getHermesValue(); });
+}
+
 #ifndef NDEBUG
 namespace {
 /// A tag used to instruct the output stream to dump more details about the
@@ -814,12 +1025,62 @@ static inline const Inst *nextInstCall(const Inst *ip) {
   llvm_unreachable("Not a call type");
 }
 
+/// Record (\p clazz, \p slot) in \p cacheEntry, the cache of the instruction
+/// at \p ip in \p codeBlock, and account for the resulting state transition,
+/// if any.
+static inline void updatePropertyCache(
+    Runtime *runtime,
+    CodeBlock *codeBlock,
+    const Inst *ip,
+    PropertyCacheEntry *cacheEntry,
+    HiddenClass *clazz,
+    SlotIndex slot) {
+  if (!cacheEntry->update(clazz, slot))
+    return;
+  if (LLVM_UNLIKELY(runtime->getExecutionTracer())) {
+    runtime->getExecutionTracer()->recordPropertyCache(
+        codeBlock, ip, cacheEntry->state);
+  }
+  switch (cacheEntry->state) {
+    case PropertyCacheState::Monomorphic:
+      ++NumPropCacheMonomorphic;
+      break;
+    case PropertyCacheState::Polymorphic:
+      ++NumPropCachePolymorphic;
+      break;
+    case PropertyCacheState::Megamorphic:
+      ++NumPropCacheMegamorphic;
+      break;
+    case PropertyCacheState::Uninitialized:
+      break;
+  }
+}
+
+/// Record in \p cacheEntry that objects of the dictionary mode class
+/// \p clazz hold the property at \p slot, for as long as the class is not
+/// mutated in a way that could invalidate the slot.
+static inline void updateDictionaryPropertyCache(
+    PropertyCacheEntry *cacheEntry,
+    HiddenClass *clazz,
+    SlotIndex slot) {
+  PropertyCacheExtension &ext = cacheEntry->getOrCreateExtension();
+  ext.dictClazz = clazz;
+  ext.dictSlot = slot;
+  ext.dictVersion = clazz->getDictionaryVersion();
+}
+
 CallResult<HermesValue> Runtime::interpretFunctionImpl(
     CodeBlock *newCodeBlock) {
   InterpreterState state{newCodeBlock, 0};
   return Interpreter::interpretFunction<false>(this, state);
 }
 
+CallResult<HermesValue> Runtime::interpretFunctionFromTrampoline(
+    Runtime *runtime,
+    CodeBlock *newCodeBlock) {
+  return runtime->interpretFunctionImpl(newCodeBlock);
+}
+
 CallResult<HermesValue> Runtime::interpretFunction(CodeBlock *newCodeBlock) {
 #ifdef HERMESVM_PROFILER_EXTERN
   auto id = getProfilerID(newCodeBlock);
@@ -828,6 +1089,14 @@ CallResult<HermesValue> Runtime::interpretFunction(CodeBlock *newCodeBlock) {
   }
   return interpWrappers[id](this, newCodeBlock);
 #else
+  if (LLVM_UNLIKELY(jitContext_.hasInterpreterTrampolines())) {
+    // Without executable memory left, call the interpreter directly, which
+    // only loses the name of the frame.
+    if (auto trampoline = jitContext_.getInterpreterTrampoline(
+            this, newCodeBlock, interpretFunctionFromTrampoline)) {
+      return trampoline(this, newCodeBlock);
+    }
+  }
   return interpretFunctionImpl(newCodeBlock);
 #endif
 }
@@ -861,6 +1130,63 @@ static inline double doSub(double x, double y) {
   return x - y;
 }
 
+/// Compute the result of the builtin \p method called with the \p argCount
+/// arguments (excluding 'this') of the outgoing frame at \p stackPointer,
+/// when it can be done without calling it: the Math functions with number
+/// arguments, which can't run user code when they are converted, and
+/// Array.isArray.
+/// \return true and store it to \p result if it was computed.
+static inline bool tryInlineBuiltin(
+    unsigned method,
+    const PinnedHermesValue *stackPointer,
+    uint32_t argCount,
+    PinnedHermesValue &result) {
+  auto arg = [stackPointer](uint32_t n) -> const PinnedHermesValue & {
+    return stackPointer[StackFrameLayout::argOffset(n)];
+  };
+  switch (method) {
+    case BuiltinMethod::Math_abs:
+      if (argCount < 1 || !arg(0).isNumber())
+        return false;
+      result = HermesValue::encodeDoubleValue(std::fabs(arg(0).getNumber()));
+      return true;
+    case BuiltinMethod::Math_floor:
+      if (argCount < 1 || !arg(0).isNumber())
+        return false;
+      result = HermesValue::encodeDoubleValue(std::floor(arg(0).getNumber()));
+      return true;
+    case BuiltinMethod::Math_max:
+    case BuiltinMethod::Math_min: {
+      bool isMax = method == BuiltinMethod::Math_max;
+      double res = isMax ? -std::numeric_limits<double>::infinity()
+                         : std::numeric_limits<double>::infinity();
+      for (uint32_t i = 0; i < argCount; ++i) {
+        if (!arg(i).isNumber())
+          return false;
+      }
+      // The same comparisons as mathMax() and mathMin().
+      for (uint32_t i = 0; i < argCount && !std::isnan(res); ++i) {
+        double x = arg(i).getNumber();
+        if (std::isnan(x)) {
+          res = std::numeric_limits<double>::quiet_NaN();
+        } else if (
+            isMax ? x > res || std::signbit(x) < std::signbit(res)
+                  : x < res || std::signbit(x) > std::signbit(res)) {
+          res = x;
+        }
+      }
+      result = HermesValue::encodeDoubleValue(res);
+      return true;
+    }
+    case BuiltinMethod::Array_isArray:
+      result = HermesValue::encodeBoolValue(
+          argCount >= 1 && vmisa<JSArray>(arg(0)));
+      return true;
+    default:
+      return false;
+  }
+}
+
 template <bool SingleStep>
 CallResult<HermesValue> Interpreter::interpretFunction(
     Runtime *runtime,
@@ -914,10 +1240,22 @@ CallResult<HermesValue> Interpreter::interpretFunction(
 
   INIT_OPCODE_PROFILER;
 
-#if !defined(HERMESVM_PROFILER_EXTERN)
-tailCall:
+#ifdef HERMESVM_PROFILER_EXTERN
+  // Every JS function is called through a native wrapper of its own, see
+  // Runtime::interpretFunction(), so each call recurses into this function
+  // and each return leaves it.
+  constexpr bool recursiveCalls = true;
+#else
+  // Likewise with the trampolines described to perf. This never changes for
+  // a runtime, so the frames entered below all agree on it.
+  const bool recursiveCalls = runtime->jitContext_.hasInterpreterTrampolines();
 #endif
+
+tailCall:
   PROFILER_ENTER_FUNCTION(curCodeBlock);
+  if (LLVM_UNLIKELY(runtime->getExecutionTracer())) {
+    runtime->getExecutionTracer()->recordFunctionEnter(curCodeBlock);
+  }
 
 #ifdef HERMES_ENABLE_DEBUGGER
   runtime->getDebugger().willEnterCodeBlock(curCodeBlock);
@@ -926,6 +1264,20 @@ tailCall:
   // Update function executionCount_ count
   curCodeBlock->incrementExecutionCount();
 
+  if (LLVM_UNLIKELY(runtime->quickeningThreshold != 0)) {
+    curCodeBlock->countInvocationForQuickening(
+        runtime, runtime->quickeningThreshold);
+  }
+
+  if (LLVM_UNLIKELY(runtime->evictColdLazyFunctions)) {
+    // The frame of this function is not pushed yet, so keep it explicitly.
+    if (runtime->coldFunctionEvictionPending_)
+      runtime->evictColdFunctions(curCodeBlock);
+    curCodeBlock->setCalledSinceEviction();
+  }
+  if (LLVM_UNLIKELY(runtime->propertyMapReleasePending_))
+    runtime->releasePropertyMaps();
+
   if (!SingleStep) {
     auto newFrame = runtime->setCurrentFrameToTopOfStack();
     runtime->saveCallerIPInStackFrame();
@@ -1038,6 +1390,7 @@ tailCall:
 #endif
     {
       const Inst *nextIP;
+      uint32_t numSavedRegs;
       uint32_t idVal;
       bool tryProp;
       uint32_t callArgCount;
@@ -1064,16 +1417,50 @@ tailCall:
     DISPATCH;                                     \
   }
 
+/// Rewrite the current instruction to its quickened variant \p quickName, if
+/// the current code block is being quickened.
+#define QUICKEN(quickName)                                            \
+  if (LLVM_UNLIKELY(curCodeBlock->canQuicken(ip))) {                  \
+    curCodeBlock->setQuickenedOpCode(ip, OpCode::quickName);          \
+    if (LLVM_UNLIKELY(runtime->getExecutionTracer())) {               \
+      runtime->getExecutionTracer()->recordQuicken(                   \
+          curCodeBlock, ip, OpCode::quickName);                       \
+    }                                                                 \
+  }
+
+/// Revert the current quickened instruction to the generic instruction
+/// \p name, and fall through to the implementation of \p name, which must
+/// immediately follow. Quickened instructions outside of the quickened copy
+/// were emitted by the compiler from type feedback, and are left as they are.
+#define DEOPTIMIZE(name)                                          \
+  if (curCodeBlock->isInQuickenedCopy(ip)) {                      \
+    curCodeBlock->deoptimize(ip, OpCode::name);                   \
+    if (LLVM_UNLIKELY(runtime->getExecutionTracer())) {           \
+      runtime->getExecutionTracer()->recordDeoptimize(            \
+          curCodeBlock, ip, OpCode::name);                        \
+    }                                                             \
+  }
+
 /// Implement a binary arithmetic instruction with a fast path where both
-/// operands are numbers.
+/// operands are numbers, along with its quickened variant.
 /// \param name the name of the instruction. The fast path case will have a
 ///     "n" appended to the name.
 /// \param oper the C++ operator to use to actually perform the arithmetic
 ///     operation.
 #define BINOP(name, oper)                                                \
+  CASE(name##Quick) {                                                    \
+    if (LLVM_LIKELY(O2REG(name).isNumber() && O3REG(name).isNumber())) { \
+      O1REG(name) = HermesValue::encodeDoubleValue(                      \
+          oper(O2REG(name).getNumber(), O3REG(name).getNumber()));       \
+      ip = NEXTINST(name);                                               \
+      DISPATCH;                                                          \
+    }                                                                    \
+    DEOPTIMIZE(name);                                                    \
+  }                                                                      \
   CASE(name) {                                                           \
     if (LLVM_LIKELY(O2REG(name).isNumber() && O3REG(name).isNumber())) { \
       /* Fast-path. */                                                   \
+      QUICKEN(name##Quick);                                              \
       CASE(name##N) {                                                    \
         O1REG(name) = HermesValue::encodeDoubleValue(                    \
             oper(O2REG(name).getNumber(), O3REG(name).getNumber()));     \
@@ -1205,7 +1592,7 @@ tailCall:
   }
 
 /// Implement a comparison conditional jump with a fast path where both
-/// operands are numbers.
+/// operands are numbers, along with its quickened variant.
 /// \param name the name of the instruction. The fast path case will have a
 ///     "N" appended to the name.
 /// \param suffix  Optional suffix to be added to the end (e.g. Long)
@@ -1215,19 +1602,34 @@ tailCall:
 /// \param trueDest  ip value if the conditional evaluates to true
 /// \param falseDest  ip value if the conditional evaluates to false
 #define JCOND_IMPL(name, suffix, oper, operFuncName, trueDest, falseDest) \
+  CASE(name##Quick##suffix) {                                             \
+    if (LLVM_LIKELY(                                                      \
+            O2REG(name##suffix).isNumber() &&                             \
+            O3REG(name##suffix).isNumber())) {                            \
+      if (O2REG(name##suffix).getNumber() oper O3REG(name##suffix)        \
+              .getNumber()) {                                             \
+        JUMP_TO(trueDest);                                                \
+        DISPATCH;                                                         \
+      }                                                                   \
+      JUMP_TO(falseDest);                                                 \
+      DISPATCH;                                                           \
+    }                                                                     \
+    DEOPTIMIZE(name##suffix);                                             \
+  }                                                                       \
   CASE(name##suffix) {                                                    \
     if (LLVM_LIKELY(                                                      \
             O2REG(name##suffix).isNumber() &&                             \
             O3REG(name##suffix).isNumber())) {                            \
       /* Fast-path. */                                                    \
+      QUICKEN(name##Quick##suffix);                                       \
       CASE(name##N##suffix) {                                             \
         if (O2REG(name##N##suffix)                                        \
                 .getNumber() oper O3REG(name##N##suffix)                  \
                 .getNumber()) {                                           \
-          ip = trueDest;                                                  \
+          JUMP_TO(trueDest);                                              \
           DISPATCH;                                                       \
         }                                                                 \
-        ip = falseDest;                                                   \
+        JUMP_TO(falseDest);                                               \
         DISPATCH;                                                         \
       }                                                                   \
     }                                                                     \
@@ -1241,10 +1643,10 @@ tailCall:
       goto exception;                                                     \
     gcScope.flushToSmallCount(KEEP_HANDLES);                              \
     if (boolRes.getValue()) {                                             \
-      ip = trueDest;                                                      \
+      JUMP_TO(trueDest);                                                  \
       DISPATCH;                                                           \
     }                                                                     \
-    ip = falseDest;                                                       \
+    JUMP_TO(falseDest);                                                   \
     DISPATCH;                                                             \
   }
 
@@ -1256,13 +1658,29 @@ tailCall:
 #define JCOND_STRICT_EQ_IMPL(name, suffix, trueDest, falseDest)         \
   CASE(name##suffix) {                                                  \
     if (strictEqualityTest(O2REG(name##suffix), O3REG(name##suffix))) { \
-      ip = trueDest;                                                    \
+      JUMP_TO(trueDest);                                                \
       DISPATCH;                                                         \
     }                                                                   \
-    ip = falseDest;                                                     \
+    JUMP_TO(falseDest);                                                 \
     DISPATCH;                                                           \
   }
 
+/// Implement a conditional jump on strict equality with the number zero.
+/// \param name the name of the instruction.
+/// \param suffix  Optional suffix to be added to the end (e.g. Long)
+/// \param trueDest  ip value if the conditional evaluates to true
+/// \param falseDest  ip value if the conditional evaluates to false
+#define JCOND_STRICT_EQ_ZERO_IMPL(name, suffix, trueDest, falseDest) \
+  CASE(name##suffix) {                                               \
+    if (O2REG(name##suffix).isNumber() &&                            \
+        O2REG(name##suffix).getNumber() == 0) {                      \
+      JUMP_TO(trueDest);                                             \
+      DISPATCH;                                                      \
+    }                                                                \
+    JUMP_TO(falseDest);                                              \
+    DISPATCH;                                                        \
+  }
+
 /// Implement an equality conditional jump
 /// \param name the name of the instruction.
 /// \param suffix  Optional suffix to be added to the end (e.g. Long)
@@ -1281,10 +1699,10 @@ tailCall:
     }                                                    \
     gcScope.flushToSmallCount(KEEP_HANDLES);             \
     if (res->getBool()) {                                \
-      ip = trueDest;                                     \
+      JUMP_TO(trueDest);                                 \
       DISPATCH;                                          \
     }                                                    \
-    ip = falseDest;                                      \
+    JUMP_TO(falseDest);                                  \
     DISPATCH;                                            \
   }
 
@@ -1514,16 +1932,16 @@ tailCall:
 
         CodeBlock *calleeBlock = func->getCodeBlock();
         calleeBlock->lazyCompile(runtime);
-#if defined(HERMESVM_PROFILER_EXTERN)
-        res = runtime->interpretFunction(calleeBlock);
-        if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
-          goto exception;
+        if (LLVM_UNLIKELY(recursiveCalls)) {
+          res = runtime->interpretFunction(calleeBlock);
+          if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+            goto exception;
+          }
+          O1REG(Call) = *res;
+          gcScope.flushToSmallCount(KEEP_HANDLES);
+          ip = nextIP;
+          DISPATCH;
         }
-        O1REG(Call) = *res;
-        gcScope.flushToSmallCount(KEEP_HANDLES);
-        ip = nextIP;
-        DISPATCH;
-#else
         if (auto jitPtr = runtime->jitContext_.compile(runtime, calleeBlock)) {
           res = (*jitPtr)(runtime);
           if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
@@ -1538,7 +1956,6 @@ tailCall:
         }
         curCodeBlock = calleeBlock;
         goto tailCall;
-#endif
       }
       res = Interpreter::handleCallSlowPath(runtime, &O2REG(Call));
       if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
@@ -1592,17 +2009,18 @@ tailCall:
         assert(!SingleStep && "can't single-step a call");
 
         calleeBlock->lazyCompile(runtime);
-#if defined(HERMESVM_PROFILER_EXTERN)
-        res = runtime->interpretFunction(calleeBlock);
-        if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
-          goto exception;
+        if (LLVM_UNLIKELY(recursiveCalls)) {
+          res = runtime->interpretFunction(calleeBlock);
+          if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+            goto exception;
+          }
+          O1REG(CallDirect) = *res;
+          gcScope.flushToSmallCount(KEEP_HANDLES);
+          ip = ip->opCode == OpCode::CallDirect
+              ? NEXTINST(CallDirect)
+              : NEXTINST(CallDirectLongIndex);
+          DISPATCH;
         }
-        O1REG(CallDirect) = *res;
-        gcScope.flushToSmallCount(KEEP_HANDLES);
-        ip = ip->opCode == OpCode::CallDirect ? NEXTINST(CallDirect)
-                                              : NEXTINST(CallDirectLongIndex);
-        DISPATCH;
-#else
         if (auto jitPtr = runtime->jitContext_.compile(runtime, calleeBlock)) {
           res = (*jitPtr)(runtime);
           if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
@@ -1618,10 +2036,18 @@ tailCall:
         }
         curCodeBlock = calleeBlock;
         goto tailCall;
-#endif
       }
 
       CASE(CallBuiltin) {
+        // A few common builtins are computed here, without a native frame.
+        if (tryInlineBuiltin(
+                ip->iCallBuiltin.op2,
+                runtime->stackPointer_,
+                (uint32_t)ip->iCallBuiltin.op3 - 1,
+                O1REG(CallBuiltin))) {
+          ip = NEXTINST(CallBuiltin);
+          DISPATCH;
+        }
         NativeFunction *nf =
             runtime->getBuiltinNativeFunction(ip->iCallBuiltin.op2);
 
@@ -1661,10 +2087,12 @@ tailCall:
 
       CASE(SaveGenerator) {
         nextIP = IPADD(ip->iSaveGenerator.op1);
+        numSavedRegs = ip->iSaveGenerator.op2;
         goto doSaveGen;
       }
       CASE(SaveGeneratorLong) {
         nextIP = IPADD(ip->iSaveGeneratorLong.op1);
+        numSavedRegs = ip->iSaveGeneratorLong.op2;
         goto doSaveGen;
       }
 
@@ -1672,7 +2100,7 @@ tailCall:
       auto *innerFn = vmcast<GeneratorInnerFunction>(
           runtime->getCurrentFrame().getCalleeClosure());
 
-      innerFn->saveStack(runtime);
+      innerFn->saveStack(runtime, numSavedRegs);
       innerFn->setNextIP(nextIP);
       innerFn->setState(GeneratorInnerFunction::State::SuspendedYield);
       ip = NEXTINST(SaveGenerator);
@@ -1686,7 +2114,10 @@ tailCall:
             GeneratorInnerFunction::State::SuspendedStart) {
           nextIP = NEXTINST(StartGenerator);
         } else {
-          nextIP = innerFn->getNextIP();
+          // The generator may have been suspended before its function got a
+          // private copy of the bytecode, which it resumes in.
+          nextIP = curCodeBlock->getOffsetPtr(
+              curCodeBlock->getOffsetOf(innerFn->getNextIP()));
           innerFn->restoreStack(runtime);
         }
         innerFn->setState(GeneratorInnerFunction::State::Executing);
@@ -1724,9 +2155,22 @@ tailCall:
           DISPATCH;
         }
 #endif
+        // Record the final size of the first instances built by a constructor,
+        // see ConstructorSlackInfo.
+        if (LLVM_UNLIKELY(FRAME.isConstructorCall()) &&
+            curCodeBlock->getConstructorSlackInfo().isTracking()) {
+          if (auto *thisObj = dyn_vmcast<JSObject>(FRAME.getThisArgRef())) {
+            curCodeBlock->getConstructorSlackInfo().recordInstance(
+                thisObj->getClass(runtime)->getNumProperties());
+          }
+        }
+
         runtime->restoreCallerIPFromStackFrame();
 
         PROFILER_EXIT_FUNCTION(curCodeBlock);
+        if (LLVM_UNLIKELY(runtime->getExecutionTracer())) {
+          runtime->getExecutionTracer()->recordFunctionExit(curCodeBlock, ip);
+        }
 
         // Store the return value.
         res = O1REG(Ret);
@@ -1747,10 +2191,9 @@ tailCall:
           return res;
         }
 
-// Return because of recursive calling structure
-#if defined(HERMESVM_PROFILER_EXTERN)
-        return res;
-#endif
+        // Return because of recursive calling structure
+        if (recursiveCalls)
+          return res;
 
         INIT_STATE_FOR_CODEBLOCK(curCodeBlock);
         O1REG(Call) = res.getValue();
@@ -2162,6 +2605,57 @@ tailCall:
           ip = nextIP;
           DISPATCH;
         }
+        if (auto *ext = cacheEntry->getExtension()) {
+          SlotIndex polySlot;
+          if (ext->find(clazz, polySlot)) {
+            ++NumGetByIdPolyHits;
+            O1REG(GetById) =
+                JSObject::getNamedSlotValue<PropStorage::Inline::Yes>(
+                    obj, runtime, polySlot);
+            ip = nextIP;
+            DISPATCH;
+          }
+          if (JSObject *holder = JSObject::getCachedPrototypeHolder(
+                  obj, runtime, ext->proto)) {
+            if (LLVM_LIKELY(!ext->proto.accessor)) {
+              ++NumGetByIdProtoHits;
+              O1REG(GetById) =
+                  JSObject::getNamedSlotValue(holder, runtime, ext->proto.slot);
+              ip = nextIP;
+              DISPATCH;
+            }
+            // Call the getter directly, without looking up the property.
+            ++NumGetByIdAccessorHits;
+            auto *accessor = vmcast<PropertyAccessor>(
+                JSObject::getNamedSlotValue(holder, runtime, ext->proto.slot));
+            if (!accessor->getter) {
+              O1REG(GetById) = HermesValue::encodeUndefinedValue();
+              ip = nextIP;
+              DISPATCH;
+            }
+            runtime->storeCallerIP(ip);
+            propRes = Callable::executeCall0(
+                runtime->makeHandle(accessor->getter),
+                runtime,
+                Handle<>(&O2REG(GetById)));
+            runtime->clearCallerIP();
+            if (LLVM_UNLIKELY(propRes == ExecutionStatus::EXCEPTION)) {
+              goto exception;
+            }
+            O1REG(GetById) = *propRes;
+            gcScope.flushToSmallCount(KEEP_HANDLES);
+            ip = nextIP;
+            DISPATCH;
+          }
+          if (ext->dictClazz == clazz &&
+              clazz->getDictionaryVersion() == ext->dictVersion) {
+            ++NumGetByIdDictHits;
+            O1REG(GetById) =
+                JSObject::getNamedSlotValue(obj, runtime, ext->dictSlot);
+            ip = nextIP;
+            DISPATCH;
+          }
+        }
         auto id = ID(idVal);
         NamedPropertyDescriptor desc;
         OptValue<bool> fastPathResult =
@@ -2176,14 +2670,18 @@ tailCall:
           if (LLVM_LIKELY(!clazz->isDictionary()) &&
               LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
 #ifdef HERMES_SLOW_DEBUG
-            if (cacheEntry->clazz && cacheEntry->clazz != clazz)
+            if (cacheEntry->state == PropertyCacheState::Megamorphic)
               ++NumGetByIdCacheEvicts;
 #else
             (void)NumGetByIdCacheEvicts;
 #endif
             // Cache the class, id and property slot.
-            cacheEntry->clazz = clazz;
-            cacheEntry->slot = desc.slot;
+            updatePropertyCache(
+                runtime, curCodeBlock, ip, cacheEntry, clazz, desc.slot);
+          } else if (
+              clazz->isDictionary() &&
+              LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
+            updateDictionaryPropertyCache(cacheEntry, clazz, desc.slot);
           }
 
           O1REG(GetById) = JSObject::getNamedSlotValue(obj, runtime, desc);
@@ -2191,25 +2689,6 @@ tailCall:
           DISPATCH;
         }
 
-        // The cache may also be populated via the prototype of the object.
-        // This value is only reliable if the fast path was a definite
-        // not-found.
-        if (fastPathResult.hasValue() && !fastPathResult.getValue()) {
-          JSObject *parent = obj->getParent(runtime);
-          // TODO: This isLazy check is because a lazy object is reported as
-          // having no properties and therefore cannot contain the property.
-          // This check does not belong here, it should be merged into
-          // tryGetOwnNamedDescriptorFast().
-          if (parent && cacheEntry->clazz == parent->getClass(runtime) &&
-              LLVM_LIKELY(!obj->isLazy())) {
-            ++NumGetByIdProtoHits;
-            O1REG(GetById) =
-                JSObject::getNamedSlotValue(parent, runtime, cacheEntry->slot);
-            ip = nextIP;
-            DISPATCH;
-          }
-        }
-
 #ifdef HERMES_SLOW_DEBUG
         JSObject *propObj = JSObject::getNamedDescriptor(
             Handle<JSObject>::vmcast(&O2REG(GetById)), runtime, id, desc);
@@ -2295,6 +2774,47 @@ tailCall:
           ip = nextIP;
           DISPATCH;
         }
+        if (auto *ext = cacheEntry->getExtension()) {
+          SlotIndex polySlot;
+          if (ext->find(clazz, polySlot)) {
+            ++NumPutByIdPolyHits;
+            JSObject::setNamedSlotValue<PropStorage::Inline::Yes>(
+                obj, runtime, polySlot, O2REG(PutById));
+            ip = nextIP;
+            DISPATCH;
+          }
+          if (ext->dictClazz == clazz &&
+              clazz->getDictionaryVersion() == ext->dictVersion) {
+            ++NumPutByIdDictHits;
+            JSObject::setNamedSlotValue(
+                obj, runtime, ext->dictSlot, O2REG(PutById));
+            ip = nextIP;
+            DISPATCH;
+          }
+          if (JSObject *holder = JSObject::getCachedPrototypeHolder(
+                  obj, runtime, ext->proto)) {
+            assert(ext->proto.accessor && "only setters are cached");
+            auto *accessor = vmcast<PropertyAccessor>(
+                JSObject::getNamedSlotValue(holder, runtime, ext->proto.slot));
+            // The setter may have been removed by redefining the property.
+            if (LLVM_LIKELY(accessor->setter)) {
+              ++NumPutByIdAccessorHits;
+              runtime->storeCallerIP(ip);
+              auto setRes = Callable::executeCall1(
+                  runtime->makeHandle(accessor->setter),
+                  runtime,
+                  Handle<>(&O1REG(PutById)),
+                  O2REG(PutById));
+              runtime->clearCallerIP();
+              if (LLVM_UNLIKELY(setRes == ExecutionStatus::EXCEPTION)) {
+                goto exception;
+              }
+              gcScope.flushToSmallCount(KEEP_HANDLES);
+              ip = nextIP;
+              DISPATCH;
+            }
+          }
+        }
         auto id = ID(idVal);
         NamedPropertyDescriptor desc;
         OptValue<bool> hasOwnProp =
@@ -2309,14 +2829,18 @@ tailCall:
           if (LLVM_LIKELY(!clazz->isDictionary()) &&
               LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
 #ifdef HERMES_SLOW_DEBUG
-            if (cacheEntry->clazz && cacheEntry->clazz != clazz)
+            if (cacheEntry->state == PropertyCacheState::Megamorphic)
               ++NumPutByIdCacheEvicts;
 #else
             (void)NumPutByIdCacheEvicts;
 #endif
             // Cache the class and property slot.
-            cacheEntry->clazz = clazz;
-            cacheEntry->slot = desc.slot;
+            updatePropertyCache(
+                runtime, curCodeBlock, ip, cacheEntry, clazz, desc.slot);
+          } else if (
+              clazz->isDictionary() &&
+              LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
+            updateDictionaryPropertyCache(cacheEntry, clazz, desc.slot);
           }
 
           JSObject::setNamedSlotValue(obj, runtime, desc.slot, O2REG(PutById));
@@ -2330,7 +2854,8 @@ tailCall:
             runtime,
             id,
             Handle<>(&O2REG(PutById)),
-            !tryProp ? defaultPropOpFlags : defaultPropOpFlags.plusMustExist());
+            !tryProp ? defaultPropOpFlags : defaultPropOpFlags.plusMustExist(),
+            cacheIdx != hbc::PROPERTY_CACHING_DISABLED ? cacheEntry : nullptr);
         runtime->clearCallerIP();
         if (LLVM_UNLIKELY(putRes == ExecutionStatus::EXCEPTION)) {
           goto exception;
@@ -2355,9 +2880,46 @@ tailCall:
       DISPATCH;
     }
 
+      CASE(GetByValIndex) {
+        // The compiler proved that the index is a non-negative integer
+        // number, so only its range is checked.
+        if (LLVM_LIKELY(O2REG(GetByValIndex).isObject())) {
+          if (auto *arr = dyn_vmcast<JSArray>(O2REG(GetByValIndex))) {
+            double index = O3REG(GetByValIndex).getNumber();
+            if (LLVM_LIKELY(index < 4294967295.0)) {
+              HermesValue value =
+                  arr->tryGetFastIndexed(runtime, (uint32_t)index);
+              if (LLVM_LIKELY(!value.isEmpty())) {
+                O1REG(GetByValIndex) = value;
+                ip = NEXTINST(GetByValIndex);
+                DISPATCH;
+              }
+            }
+          }
+        }
+        // GetByValIndex has the layout of GetByVal.
+        goto getByVal;
+      }
+
       CASE(GetByVal) {
+      getByVal:
         CallResult<HermesValue> propRes{ExecutionStatus::EXCEPTION};
         if (LLVM_LIKELY(O2REG(GetByVal).isObject())) {
+          // Fast path: an element present in the indexed storage of an object
+          // without index-like named properties. Reading it neither allocates
+          // nor throws.
+          auto *obj = vmcast<JSObject>(O2REG(GetByVal));
+          if (LLVM_LIKELY(obj->hasFastIndexProperties())) {
+            if (auto arrayIndex = toArrayIndexFastPath(O3REG(GetByVal))) {
+              HermesValue value =
+                  JSObject::getOwnIndexed(obj, runtime, *arrayIndex);
+              if (LLVM_LIKELY(!value.isEmpty())) {
+                O1REG(GetByVal) = value;
+                ip = NEXTINST(GetByVal);
+                DISPATCH;
+              }
+            }
+          }
           runtime->storeCallerIP(ip);
           propRes = JSObject::getComputed_RJS(
               Handle<JSObject>::vmcast(&O2REG(GetByVal)),
@@ -2368,6 +2930,22 @@ tailCall:
             goto exception;
           }
         } else {
+          // Fast path: a Latin-1 character of a string at an in-range index,
+          // which is read from the table of single-character strings.
+          if (LLVM_LIKELY(O2REG(GetByVal).isString())) {
+            if (auto arrayIndex = toArrayIndexFastPath(O3REG(GetByVal))) {
+              StringPrimitive *str = O2REG(GetByVal).getString();
+              if (LLVM_LIKELY(*arrayIndex < str->getStringLength())) {
+                char16_t ch = str->at(*arrayIndex);
+                if (LLVM_LIKELY(ch < 256)) {
+                  O1REG(GetByVal) =
+                      runtime->getCharacterString(ch).getHermesValue();
+                  ip = NEXTINST(GetByVal);
+                  DISPATCH;
+                }
+              }
+            }
+          }
           // This is the "slow path".
           runtime->storeCallerIP(ip);
           propRes = Interpreter::getByValTransient_RJS(
@@ -2383,7 +2961,28 @@ tailCall:
         DISPATCH;
       }
 
+      CASE(PutByValIndex) {
+        if (LLVM_LIKELY(O1REG(PutByValIndex).isObject())) {
+          if (auto *arr = dyn_vmcast<JSArray>(O1REG(PutByValIndex))) {
+            double index = O2REG(PutByValIndex).getNumber();
+            if (LLVM_LIKELY(
+                    index < 4294967295.0 &&
+                    ArrayImpl::trySetFastIndexed(
+                        arr,
+                        runtime,
+                        (uint32_t)index,
+                        O3REG(PutByValIndex)))) {
+              ip = NEXTINST(PutByValIndex);
+              DISPATCH;
+            }
+          }
+        }
+        // PutByValIndex has the layout of PutByVal.
+        goto putByVal;
+      }
+
       CASE(PutByVal) {
+      putByVal:
         if (LLVM_LIKELY(O1REG(PutByVal).isObject())) {
           runtime->storeCallerIP(ip);
           auto putRes = JSObject::putComputed_RJS(
@@ -2459,8 +3058,16 @@ tailCall:
           uint32_t idx = O4REG(GetNextPName).getNumber();
           uint32_t size = O5REG(GetNextPName).getNumber();
           MutableHandle<JSObject> propObj{runtime};
-          // Loop until we find a property which is present.
-          while (idx < size) {
+          // If the names came from the for-in cache, which still matches the
+          // classes of the object and its prototypes, none of them can have
+          // been deleted.
+          const bool cacheValid =
+              idx < size && isForInCacheValid(runtime, obj, arr);
+          if (cacheValid) {
+            tmpHandle = arr->at(idx);
+          }
+          // Otherwise loop until we find a property which is present.
+          while (!cacheValid && idx < size) {
             tmpHandle = arr->at(idx);
             ComputedPropertyDescriptor desc;
             JSObject::getComputedPrimitiveDescriptor(
@@ -2492,6 +3099,58 @@ tailCall:
         DISPATCH;
       }
 
+      CASE(IteratorBegin) {
+        runtime->storeCallerIP(ip);
+        auto status = caseIteratorBegin(runtime, frameRegs, ip);
+        runtime->clearCallerIP();
+        if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION)) {
+          goto exception;
+        }
+        gcScope.flushToSmallCount(KEEP_HANDLES);
+        ip = NEXTINST(IteratorBegin);
+        DISPATCH;
+      }
+
+      CASE(IteratorNext) {
+        // Fast path: an element in the storage of an array iterated by index.
+        if (LLVM_LIKELY(O2REG(IteratorNext).isNumber())) {
+          auto *arr = vmcast<JSArray>(O3REG(IteratorNext));
+          uint32_t index = O2REG(IteratorNext).getNumberAs<uint32_t>();
+          if (LLVM_LIKELY(index < JSArray::getLength(arr))) {
+            HermesValue value = arr->tryGetFastIndexed(runtime, index);
+            if (LLVM_LIKELY(!value.isEmpty())) {
+              O1REG(IteratorNext) = value;
+              O2REG(IteratorNext) = HermesValue::encodeNumberValue(index + 1);
+              ip = NEXTINST(IteratorNext);
+              DISPATCH;
+            }
+          }
+        }
+        runtime->storeCallerIP(ip);
+        auto status = caseIteratorNext(runtime, frameRegs, ip);
+        runtime->clearCallerIP();
+        if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION)) {
+          goto exception;
+        }
+        gcScope.flushToSmallCount(KEEP_HANDLES);
+        ip = NEXTINST(IteratorNext);
+        DISPATCH;
+      }
+
+      CASE(IteratorClose) {
+        if (LLVM_UNLIKELY(O1REG(IteratorClose).isObject())) {
+          runtime->storeCallerIP(ip);
+          auto status = caseIteratorClose(runtime, frameRegs, ip);
+          runtime->clearCallerIP();
+          if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION)) {
+            goto exception;
+          }
+          gcScope.flushToSmallCount(KEEP_HANDLES);
+        }
+        ip = NEXTINST(IteratorClose);
+        DISPATCH;
+      }
+
       CASE(ToNumber) {
         if (LLVM_LIKELY(O2REG(ToNumber).isNumber())) {
           O1REG(ToNumber) = O2REG(ToNumber);
@@ -2547,59 +3206,69 @@ tailCall:
       }
 
       CASE(Jmp) {
-        ip = IPADD(ip->iJmp.op1);
+        JUMP_TO(IPADD(ip->iJmp.op1));
         DISPATCH;
       }
       CASE(JmpLong) {
-        ip = IPADD(ip->iJmpLong.op1);
+        JUMP_TO(IPADD(ip->iJmpLong.op1));
         DISPATCH;
       }
       CASE(JmpTrue) {
         if (toBoolean(O2REG(JmpTrue)))
-          ip = IPADD(ip->iJmpTrue.op1);
+          JUMP_TO(IPADD(ip->iJmpTrue.op1));
         else
           ip = NEXTINST(JmpTrue);
         DISPATCH;
       }
       CASE(JmpTrueLong) {
         if (toBoolean(O2REG(JmpTrueLong)))
-          ip = IPADD(ip->iJmpTrueLong.op1);
+          JUMP_TO(IPADD(ip->iJmpTrueLong.op1));
         else
           ip = NEXTINST(JmpTrueLong);
         DISPATCH;
       }
       CASE(JmpFalse) {
         if (!toBoolean(O2REG(JmpFalse)))
-          ip = IPADD(ip->iJmpFalse.op1);
+          JUMP_TO(IPADD(ip->iJmpFalse.op1));
         else
           ip = NEXTINST(JmpFalse);
         DISPATCH;
       }
       CASE(JmpFalseLong) {
         if (!toBoolean(O2REG(JmpFalseLong)))
-          ip = IPADD(ip->iJmpFalseLong.op1);
+          JUMP_TO(IPADD(ip->iJmpFalseLong.op1));
         else
           ip = NEXTINST(JmpFalseLong);
         DISPATCH;
       }
       CASE(JmpUndefined) {
         if (O2REG(JmpUndefined).isUndefined())
-          ip = IPADD(ip->iJmpUndefined.op1);
+          JUMP_TO(IPADD(ip->iJmpUndefined.op1));
         else
           ip = NEXTINST(JmpUndefined);
         DISPATCH;
       }
       CASE(JmpUndefinedLong) {
         if (O2REG(JmpUndefinedLong).isUndefined())
-          ip = IPADD(ip->iJmpUndefinedLong.op1);
+          JUMP_TO(IPADD(ip->iJmpUndefinedLong.op1));
         else
           ip = NEXTINST(JmpUndefinedLong);
         DISPATCH;
       }
+      CASE(AddQuick) {
+        if (LLVM_LIKELY(O2REG(Add).isNumber() && O3REG(Add).isNumber())) {
+          O1REG(Add) = HermesValue::encodeDoubleValue(
+              O2REG(Add).getNumber() + O3REG(Add).getNumber());
+          ip = NEXTINST(Add);
+          DISPATCH;
+        }
+        DEOPTIMIZE(Add);
+      }
       CASE(Add) {
         if (LLVM_LIKELY(
                 O2REG(Add).isNumber() &&
                 O3REG(Add).isNumber())) { /* Fast-path. */
+          QUICKEN(AddQuick);
           CASE(AddN) {
             O1REG(Add) = HermesValue::encodeDoubleValue(
                 O2REG(Add).getNumber() + O3REG(Add).getNumber());
@@ -2719,6 +3388,26 @@ tailCall:
         DISPATCH;
       }
 
+      CASE(ApplyArguments) {
+        runtime->storeCallerIP(ip);
+        res = applyArguments_RJS(
+            runtime,
+            &O5REG(ApplyArguments),
+            Handle<>(&O2REG(ApplyArguments)),
+            Handle<>(&O3REG(ApplyArguments)),
+            Handle<>(&O4REG(ApplyArguments)),
+            FRAME.getCalleeClosureHandleUnsafe(),
+            strictMode);
+        runtime->clearCallerIP();
+        if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+          goto exception;
+        }
+        gcScope.flushToSmallCount(KEEP_HANDLES);
+        O1REG(ApplyArguments) = *res;
+        ip = NEXTINST(ApplyArguments);
+        DISPATCH;
+      }
+
       CASE(NewObject) {
         // Create a new object using the built-in constructor. Note that the
         // built-in constructor is empty, so we don't actually need to call
@@ -2753,7 +3442,8 @@ tailCall:
             curCodeBlock,
             ip->iNewObjectWithBuffer.op3,
             ip->iNewObjectWithBuffer.op4,
-            ip->iNewObjectWithBuffer.op5);
+            ip->iNewObjectWithBuffer.op5,
+            ip);
         if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
           goto exception;
         }
@@ -2769,7 +3459,8 @@ tailCall:
             curCodeBlock,
             ip->iNewObjectWithBufferLong.op3,
             ip->iNewObjectWithBufferLong.op4,
-            ip->iNewObjectWithBufferLong.op5);
+            ip->iNewObjectWithBufferLong.op5,
+            ip);
         if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
           goto exception;
         }
@@ -2800,7 +3491,8 @@ tailCall:
             curCodeBlock,
             ip->iNewArrayWithBuffer.op2,
             ip->iNewArrayWithBuffer.op3,
-            ip->iNewArrayWithBuffer.op4);
+            ip->iNewArrayWithBuffer.op4,
+            ip);
         if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
           goto exception;
         }
@@ -2817,7 +3509,8 @@ tailCall:
             curCodeBlock,
             ip->iNewArrayWithBufferLong.op2,
             ip->iNewArrayWithBufferLong.op3,
-            ip->iNewArrayWithBufferLong.op4);
+            ip->iNewArrayWithBufferLong.op4,
+            ip);
         if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
           goto exception;
         }
@@ -2828,6 +3521,30 @@ tailCall:
         DISPATCH;
       }
 
+      CASE(GetTemplateObject) {
+        if (JSObject *templateObj =
+                curCodeBlock->getRuntimeModule()->findCachedTemplateObject(
+                    ip->iGetTemplateObject.op2)) {
+          O1REG(GetTemplateObject) =
+              HermesValue::encodeObjectValue(templateObj);
+          ip = NEXTINST(GetTemplateObject);
+          DISPATCH;
+        }
+        res = Interpreter::createTemplateObjectFromBuffer(
+            runtime,
+            curCodeBlock,
+            ip->iGetTemplateObject.op2,
+            ip->iGetTemplateObject.op3,
+            ip->iGetTemplateObject.op4);
+        if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+          goto exception;
+        }
+        O1REG(GetTemplateObject) = *res;
+        gcScope.flushToSmallCount(KEEP_HANDLES);
+        ip = NEXTINST(GetTemplateObject);
+        DISPATCH;
+      }
+
       CASE(CreateThis) {
         // Registers: output, prototype, closure.
         if (LLVM_UNLIKELY(!vmisa<Callable>(O3REG(CreateThis)))) {
@@ -2912,6 +3629,12 @@ tailCall:
         ip = NEXTINST(TypeOf);
         DISPATCH;
       }
+      CASE(TypeOfIs) {
+        O1REG(TypeOfIs) = HermesValue::encodeBoolValue(typeOfIs(
+            O2REG(TypeOfIs), static_cast<TypeOfIsType>(ip->iTypeOfIs.op3)));
+        ip = NEXTINST(TypeOfIs);
+        DISPATCH;
+      }
       CASE(Mod) {
         // We use fmod here for simplicity. Theoretically fmod behaves slightly
         // differently than the ECMAScript Spec. fmod applies round-towards-zero
@@ -2946,6 +3669,29 @@ tailCall:
         DISPATCH;
       }
       CASE(InstanceOf) {
+        // instanceOfOperator_RJS() applies the built-in @@hasInstance to
+        // every JSFunction, which then only reads its "prototype" property.
+        // The slot of that property is cached by the class of the function.
+        auto *cacheEntry =
+            curCodeBlock->getReadCacheEntry(ip->iInstanceOf.op4);
+        if (auto *ctor = dyn_vmcast<JSFunction>(O3REG(InstanceOf))) {
+          SlotIndex slot;
+          if (LLVM_LIKELY(cacheEntry->find(ctor->getClass(runtime), slot))) {
+            HermesValue proto =
+                JSObject::getNamedSlotValue(ctor, runtime, slot);
+            if (LLVM_LIKELY(proto.isObject())) {
+              bool found = false;
+              if (O2REG(InstanceOf).isObject()) {
+                JSObject *obj = vmcast<JSObject>(O2REG(InstanceOf));
+                while (!found && (obj = obj->getParent(runtime)))
+                  found = obj == proto.getObject();
+              }
+              O1REG(InstanceOf) = HermesValue::encodeBoolValue(found);
+              ip = NEXTINST(InstanceOf);
+              DISPATCH;
+            }
+          }
+        }
         runtime->storeCallerIP(ip);
         auto result = instanceOfOperator_RJS(
             runtime,
@@ -2955,6 +3701,22 @@ tailCall:
         if (LLVM_UNLIKELY(result == ExecutionStatus::EXCEPTION)) {
           goto exception;
         }
+        if (auto *ctor = dyn_vmcast<JSFunction>(O3REG(InstanceOf))) {
+          // The lookup has initialized the lazy properties of the function.
+          HiddenClass *clazz = ctor->getClass(runtime);
+          NamedPropertyDescriptor desc;
+          OptValue<bool> found = JSObject::tryGetOwnNamedDescriptorFast(
+              ctor,
+              runtime,
+              Predefined::getSymbolID(Predefined::prototype),
+              desc);
+          if (!clazz->isDictionary() && found.hasValue() &&
+              found.getValue() && !desc.flags.accessor &&
+              ip->iInstanceOf.op4 != hbc::PROPERTY_CACHING_DISABLED) {
+            updatePropertyCache(
+                runtime, curCodeBlock, ip, cacheEntry, clazz, desc.slot);
+          }
+        }
         O1REG(InstanceOf) = HermesValue::encodeBoolValue(*result);
         gcScope.flushToSmallCount(KEEP_HANDLES);
         ip = NEXTINST(InstanceOf);
@@ -3021,6 +3783,50 @@ tailCall:
       DISPATCH;
     }
 
+      CASE(PutOwnBySlotIdxLong) {
+        nextIP = NEXTINST(PutOwnBySlotIdxLong);
+        idVal = ip->iPutOwnBySlotIdxLong.op3;
+        goto putOwnBySlotIdx;
+      }
+      CASE(PutOwnBySlotIdx) {
+        nextIP = NEXTINST(PutOwnBySlotIdx);
+        idVal = ip->iPutOwnBySlotIdx.op3;
+      }
+    putOwnBySlotIdx : {
+      // The object was created by NewObjectWithBuffer, whose class has the
+      // property in this slot.
+      assert(
+          O1REG(PutOwnBySlotIdx).isObject() &&
+          "Object argument of PutOwnBySlotIdx must be an object");
+      JSObject::setNamedSlotValue(
+          vmcast<JSObject>(O1REG(PutOwnBySlotIdx)),
+          runtime,
+          idVal,
+          O2REG(PutOwnBySlotIdx));
+      ip = nextIP;
+      DISPATCH;
+    }
+
+      CASE(PutOwnNPBySlotIdxLong) {
+        nextIP = NEXTINST(PutOwnNPBySlotIdxLong);
+        idVal = ip->iPutOwnNPBySlotIdxLong.op3;
+        goto putOwnNPBySlotIdx;
+      }
+      CASE(PutOwnNPBySlotIdx) {
+        nextIP = NEXTINST(PutOwnNPBySlotIdx);
+        idVal = ip->iPutOwnNPBySlotIdx.op3;
+      }
+    putOwnNPBySlotIdx : {
+      assert(
+          O1REG(PutOwnNPBySlotIdx).isObject() &&
+          "Object argument of PutOwnNPBySlotIdx must be an object");
+      JSObject::namedSlotRef(
+          vmcast<JSObject>(O1REG(PutOwnNPBySlotIdx)), runtime, idVal)
+          .setNonPtr(O2REG(PutOwnNPBySlotIdx));
+      ip = nextIP;
+      DISPATCH;
+    }
+
       CASE(DelByIdLong) {
         idVal = ip->iDelByIdLong.op3;
         nextIP = NEXTINST(DelByIdLong);
@@ -3162,6 +3968,37 @@ tailCall:
         ip = IPADD(ip->iSwitchImm.op3);
         DISPATCH;
       }
+
+      CASE(SwitchStr) {
+        if (LLVM_UNLIKELY(!O1REG(SwitchStr).isString())) {
+          // No string case is strictly equal to other values.
+          ip = IPADD(ip->iSwitchStr.op3);
+          DISPATCH;
+        }
+        SymbolID id = IdentifierTable::getSymbolIDIfUniqued(
+            O1REG(SwitchStr).getString());
+        if (LLVM_UNLIKELY(!id.isValid())) {
+          // Compare the string with each case.
+          ip = IPADD(ip->iSwitchStr.op4);
+          DISPATCH;
+        }
+        // Interned strings are equal if and only if they have the same
+        // SymbolID, so a single entry of the table needs to be checked.
+        const uint32_t *table = (const uint32_t *)llvm::alignAddr(
+            (const uint8_t *)ip + ip->iSwitchStr.op2, sizeof(uint32_t));
+        const uint32_t *entry = table +
+            2 *
+                (runtime->getIdentifierTable().getHash(id) &
+                 (ip->iSwitchStr.op5 - 1));
+        if (entry[0] != hbc::SWITCH_STR_EMPTY_ENTRY &&
+            curCodeBlock->getRuntimeModule()->getSymbolIDMustExist(
+                entry[0]) == id) {
+          ip = IPADD(entry[1]);
+          DISPATCH;
+        }
+        ip = IPADD(ip->iSwitchStr.op3);
+        DISPATCH;
+      }
       LOAD_CONST(
           LoadConstUInt8,
           HermesValue::encodeDoubleValue(ip->iLoadConstUInt8.op2));
@@ -3224,6 +4061,26 @@ tailCall:
           Long,
           NEXTINST(JStrictNotEqualLong),
           IPADD(ip->iJStrictNotEqualLong.op1));
+      JCOND_STRICT_EQ_ZERO_IMPL(
+          JStrictEqualZero,
+          ,
+          IPADD(ip->iJStrictEqualZero.op1),
+          NEXTINST(JStrictEqualZero));
+      JCOND_STRICT_EQ_ZERO_IMPL(
+          JStrictEqualZero,
+          Long,
+          IPADD(ip->iJStrictEqualZeroLong.op1),
+          NEXTINST(JStrictEqualZeroLong));
+      JCOND_STRICT_EQ_ZERO_IMPL(
+          JStrictNotEqualZero,
+          ,
+          NEXTINST(JStrictNotEqualZero),
+          IPADD(ip->iJStrictNotEqualZero.op1));
+      JCOND_STRICT_EQ_ZERO_IMPL(
+          JStrictNotEqualZero,
+          Long,
+          NEXTINST(JStrictNotEqualZeroLong),
+          IPADD(ip->iJStrictNotEqualZeroLong.op1));
 
       JCOND_EQ_IMPL(JEqual, , IPADD(ip->iJEqual.op1), NEXTINST(JEqual));
       JCOND_EQ_IMPL(
@@ -3243,10 +4100,63 @@ tailCall:
       CASE(_last) {
         llvm_unreachable("Invalid opcode _last");
       }
+#ifndef HERMESVM_INDIRECT_THREADING
+      // Every opcode has a case, so the compiler doesn't need to check the
+      // range of the opcode before indexing the jump table of the switch.
+      default:
+        LLVM_BUILTIN_UNREACHABLE;
+#endif
     }
 
     llvm_unreachable("unreachable");
 
+#ifdef HERMESVM_JIT
+  // We arrive here when a backward jump to ip was taken in a function that is
+  // hot enough to be compiled. Compile it if necessary and finish executing the
+  // current frame in native code, starting from the loop header.
+  onStackReplacement : {
+    if (!runtime->jitContext_.compile(runtime, curCodeBlock)) {
+      DISPATCH;
+    }
+    const void *target =
+        curCodeBlock->getOSRTarget(curCodeBlock->getOffsetOf(ip));
+    if (!target) {
+      DISPATCH;
+    }
+    SLOW_DEBUG(
+        dbgs() << "OSR into FunctionID " << curCodeBlock->getFunctionID()
+               << " at offset " << CUROFFSET << "\n");
+    res = curCodeBlock->getJITOSREntry()(runtime, target);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
+      goto handleExceptionInParent;
+
+    // The native code ran the frame to completion, so return from it as Ret
+    // does.
+    runtime->restoreCallerIPFromStackFrame();
+    PROFILER_EXIT_FUNCTION(curCodeBlock);
+    if (LLVM_UNLIKELY(runtime->getExecutionTracer())) {
+      runtime->getExecutionTracer()->recordFunctionExit(curCodeBlock, ip);
+    }
+
+    ip = FRAME.getSavedIP();
+    curCodeBlock = FRAME.getSavedCodeBlock();
+    frameRegs =
+        &runtime->restoreStackAndPreviousFrame(FRAME).getFirstLocalRef();
+
+    if (!curCodeBlock)
+      return res;
+
+    if (recursiveCalls)
+      return res;
+
+    INIT_STATE_FOR_CODEBLOCK(curCodeBlock);
+    O1REG(Call) = res.getValue();
+    gcScope.flushToSmallCount(KEEP_HANDLES);
+    ip = nextInstCall(ip);
+    DISPATCH;
+  }
+#endif
+
   // We arrive here if we couldn't allocate the registers for the current frame.
   stackOverflow:
     runtime->raiseStackOverflow(Runtime::StackOverflowKind::JSRegisterStack);
@@ -3266,10 +4176,9 @@ tailCall:
     if (!curCodeBlock)
       return ExecutionStatus::EXCEPTION;
 
-// Return because of recursive calling structure
-#ifdef HERMESVM_PROFILER_EXTERN
-    return ExecutionStatus::EXCEPTION;
-#endif
+    // Return because of recursive calling structure
+    if (recursiveCalls)
+      return ExecutionStatus::EXCEPTION;
   // Handle the exception.
   exception:
     UPDATE_OPCODE_TIME_SPENT;
@@ -3345,6 +4254,9 @@ tailCall:
             -1) ||
            !catchable) {
       PROFILER_EXIT_FUNCTION(curCodeBlock);
+      if (LLVM_UNLIKELY(runtime->getExecutionTracer())) {
+        runtime->getExecutionTracer()->recordFunctionExit(curCodeBlock, ip);
+      }
 
       // Restore the code block and IP.
       curCodeBlock = FRAME.getSavedCodeBlock();
@@ -3370,10 +4282,9 @@ tailCall:
           isCallType(ip->opCode) &&
           "return address is not Call-type instruction");
 
-// Return because of recursive calling structure
-#ifdef HERMESVM_PROFILER_EXTERN
-      return ExecutionStatus::EXCEPTION;
-#endif
+      // Return because of recursive calling structure
+      if (recursiveCalls)
+        return ExecutionStatus::EXCEPTION;
     }
 
     INIT_STATE_FOR_CODEBLOCK(curCodeBlock);
@@ -39,10 +39,11 @@ void discoverBasicBlocks(
   while (ip != end) {
     auto decoded = decodeInstruction((const Inst *)ip);
     bool branch = false;
-    // FIXME: implement SwitchImm.
+    // FIXME: implement SwitchImm and SwitchStr.
     assert(
         decoded.meta.opCode != OpCode::SwitchImm &&
-        "SwitchImm not implemented yet");
+        decoded.meta.opCode != OpCode::SwitchStr &&
+        "SwitchImm and SwitchStr not implemented yet");
     if (decoded.meta.opCode == OpCode::Catch) {
       addLabel(ip);
       ip += decoded.meta.size;
@@ -6,6 +6,8 @@
  */
 #include "hermes/VM/JIT/ExecHeap.h"
 
+#include "hermes/Support/ErrorHandling.h"
+
 #include "llvm/Support/raw_ostream.h"
 
 #include <cassert>
@@ -16,12 +18,40 @@ namespace vm {
 ExecHeap::ExecHeap(
     size_t firstHeapSize,
     size_t secondHeapSize,
-    size_t maxMemory)
+    size_t maxMemory,
+    bool writeXorExecute)
     : firstHeapSize_(firstHeapSize),
       secondHeapSize_(secondHeapSize),
-      maxPools_(maxMemory / (firstHeapSize + secondHeapSize)) {}
+      maxPools_(maxMemory / (firstHeapSize + secondHeapSize)),
+      writeXorExecute_(writeXorExecute) {}
+
+ExecHeap::~ExecHeap() {
+  assert(!writers_ && "heap destroyed during a WriteAccess");
+}
+
+unsigned ExecHeap::currentProtection() const {
+  if (!writeXorExecute_) {
+    return llvm::sys::Memory::MF_READ | llvm::sys::Memory::MF_WRITE |
+        llvm::sys::Memory::MF_EXEC;
+  }
+  return llvm::sys::Memory::MF_READ |
+      (writers_ ? llvm::sys::Memory::MF_WRITE : llvm::sys::Memory::MF_EXEC);
+}
+
+void ExecHeap::beginWrite() {
+  if (writers_++ || !writeXorExecute_)
+    return;
+  for (auto &pool : pools_)
+    pool.protect(currentProtection());
+}
 
-ExecHeap::~ExecHeap() = default;
+void ExecHeap::endWrite() {
+  assert(writers_ && "unbalanced WriteAccess");
+  if (--writers_ || !writeXorExecute_)
+    return;
+  for (auto &pool : pools_)
+    pool.protect(currentProtection());
+}
 
 ExecHeap::DualPool *ExecHeap::addPool() {
   // Have we reached the maximum number of pools?
@@ -30,10 +60,8 @@ ExecHeap::DualPool *ExecHeap::addPool() {
 
   // Allocate a new one.
   std::error_code EC;
-  const unsigned kRWX = llvm::sys::Memory::MF_READ |
-      llvm::sys::Memory::MF_WRITE | llvm::sys::Memory::MF_EXEC;
   llvm::sys::OwningMemoryBlock mb{llvm::sys::Memory::allocateMappedMemory(
-      firstHeapSize_ + secondHeapSize_, nullptr, kRWX, EC)};
+      firstHeapSize_ + secondHeapSize_, nullptr, currentProtection(), EC)};
   if (!mb.base())
     return nullptr;
 
@@ -104,6 +132,15 @@ ExecHeap::PoolList::iterator ExecHeap::findPool(BlockPair blocks) {
   return pools_.end();
 }
 
+size_t ExecHeap::getAllocatedSize() const {
+  size_t size = 0;
+  for (const auto &pool : pools_) {
+    size += pool.getFirstHeap().getAllocatedSize() +
+        pool.getSecondHeap().getAllocatedSize();
+  }
+  return size;
+}
+
 void ExecHeap::dump(llvm::raw_ostream &OS, bool relativePointers) {
   OS << "== ExecHeap " << firstHeapSize_ << "+" << secondHeapSize_ << "\n"
      << "  maxPools:" << maxPools_ << "\n"
@@ -159,6 +196,15 @@ void ExecHeap::DualPool::free(BlockPair blocks) {
   secondHeap_.free(blocks.second);
 }
 
+void ExecHeap::DualPool::protect(unsigned flags) {
+  llvm::sys::MemoryBlock block{memBlock_.base(), memBlock_.size()};
+  std::error_code EC = llvm::sys::Memory::protectMappedMemory(block, flags);
+  if (EC)
+    hermes_fatal("failed to change the protection of executable memory");
+  if (flags & llvm::sys::Memory::MF_EXEC)
+    llvm::sys::Memory::InvalidateInstructionCache(block.base(), block.size());
+}
+
 void ExecHeap::DualPool::freeRemaining(BlockPair blocks, SizePair keepSizes) {
   if (blocks.first)
     firstHeap_.freeRemaining(blocks.first, keepSizes.first);
@@ -115,6 +115,19 @@ ExecutionStatus externPutById(
           obj, runtime, cacheEntry->slot, *prop);
       return ExecutionStatus::RETURNED;
     }
+    if (auto *ext = cacheEntry->getExtension()) {
+      SlotIndex polySlot;
+      if (ext->find(clazz, polySlot)) {
+        JSObject::setNamedSlotValue<PropStorage::Inline::Yes>(
+            obj, runtime, polySlot, *prop);
+        return ExecutionStatus::RETURNED;
+      }
+      if (ext->dictClazz == clazz &&
+          clazz->getDictionaryVersion() == ext->dictVersion) {
+        JSObject::setNamedSlotValue(obj, runtime, ext->dictSlot, *prop);
+        return ExecutionStatus::RETURNED;
+      }
+    }
     auto id = SymbolID::unsafeCreate(sid);
     NamedPropertyDescriptor desc;
     if (LLVM_LIKELY(
@@ -126,8 +139,14 @@ ExecutionStatus externPutById(
       if (LLVM_LIKELY(!clazz->isDictionary()) &&
           LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
         // Cache the class and property slot.
-        cacheEntry->clazz = clazz;
-        cacheEntry->slot = desc.slot;
+        cacheEntry->update(clazz, desc.slot);
+      } else if (
+          clazz->isDictionary() &&
+          LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
+        PropertyCacheExtension &ext = cacheEntry->getOrCreateExtension();
+        ext.dictClazz = clazz;
+        ext.dictSlot = desc.slot;
+        ext.dictVersion = clazz->getDictionaryVersion();
       }
 
       JSObject::setNamedSlotValue(obj, runtime, desc.slot, *prop);
@@ -171,6 +190,23 @@ CallResult<HermesValue> externGetById(
       return JSObject::getNamedSlotValue<PropStorage::Inline::Yes>(
           obj, runtime, cacheEntry->slot);
     }
+    if (auto *ext = cacheEntry->getExtension()) {
+      SlotIndex polySlot;
+      if (ext->find(clazz, polySlot)) {
+        return JSObject::getNamedSlotValue<PropStorage::Inline::Yes>(
+            obj, runtime, polySlot);
+      }
+      if (ext->dictClazz == clazz &&
+          clazz->getDictionaryVersion() == ext->dictVersion) {
+        return JSObject::getNamedSlotValue(obj, runtime, ext->dictSlot);
+      }
+      // Cached accessors are only called by the interpreter.
+      JSObject *holder =
+          JSObject::getCachedPrototypeHolder(obj, runtime, ext->proto);
+      if (holder && !ext->proto.accessor) {
+        return JSObject::getNamedSlotValue(holder, runtime, ext->proto.slot);
+      }
+    }
     auto id = SymbolID::unsafeCreate(sid);
     NamedPropertyDescriptor desc;
     OptValue<bool> fastPathResult =
@@ -182,30 +218,25 @@ CallResult<HermesValue> externGetById(
       if (LLVM_LIKELY(!clazz->isDictionary()) &&
           LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
         // Cache the class, id and property slot.
-        cacheEntry->clazz = clazz;
-        cacheEntry->slot = desc.slot;
+        cacheEntry->update(clazz, desc.slot);
+      } else if (
+          clazz->isDictionary() &&
+          LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
+        PropertyCacheExtension &ext = cacheEntry->getOrCreateExtension();
+        ext.dictClazz = clazz;
+        ext.dictSlot = desc.slot;
+        ext.dictVersion = clazz->getDictionaryVersion();
       }
 
       return JSObject::getNamedSlotValue(obj, runtime, desc);
     }
 
-    // The cache may also be populated via the prototype of the object.
-    // This value is only reliable if the fast path was a definite
-    // not-found.
-    if (fastPathResult.hasValue() && !fastPathResult.getValue()) {
-      JSObject *parent = obj->getParent(runtime);
-      // TODO: This isLazy check is because a lazy object is reported as
-      // having no properties and therefore cannot contain the property.
-      // This check does not belong here, it should be merged into
-      // tryGetOwnNamedDescriptorFast().
-      if (parent && cacheEntry->clazz == parent->getClass(runtime) &&
-          LLVM_LIKELY(!obj->isLazy())) {
-        return JSObject::getNamedSlotValue(parent, runtime, cacheEntry->slot);
-      }
-    }
-
     return JSObject::getNamed_RJS(
-        Handle<JSObject>::vmcast(target), runtime, id, opFlags);
+        Handle<JSObject>::vmcast(target),
+        runtime,
+        id,
+        opFlags,
+        cacheIdx != hbc::PROPERTY_CACHING_DISABLED ? cacheEntry : nullptr);
   } else {
     /* Slow path. */
     return Interpreter::getByIdTransient_RJS(
@@ -213,13 +244,19 @@ CallResult<HermesValue> externGetById(
   }
 }
 
-CallResult<HermesValue> externCall(
+/// Set up the frame of a call to \p callable with \p newTarget and invoke
+/// it. A plain JavaScript function whose body is (or can now be) compiled is
+/// entered directly, rather than through the vtable and the interpreter,
+/// unless it may not be invoked this way, in which case the interpreter
+/// raises the error.
+static CallResult<HermesValue> callInNewFrame(
     Runtime *runtime,
     PinnedHermesValue *callable,
     uint32_t argCount,
     PinnedHermesValue *stackPointer,
     const Inst *ip,
-    PinnedHermesValue *previousFrame) {
+    PinnedHermesValue *previousFrame,
+    HermesValue newTarget) {
   GCScopeMarkerRAII marker{runtime};
 
   if (LLVM_UNLIKELY(!dyn_vmcast<Callable>(*callable)))
@@ -238,43 +275,60 @@ CallResult<HermesValue> externCall(
       nullptr, /* SavedCodeBlock */
       argCount - 1,
       *callable,
-      HermesValue::encodeUndefinedValue());
+      newTarget);
   runtime->storeCallerIP(ip);
-  auto res = Callable::call(Handle<Callable>::vmcast(callable), runtime);
+
+  auto *func = vmcast<Callable>(*callable);
+  if (func->getKind() == CellKind::FunctionKind) {
+    CodeBlock *calleeBlock = vmcast<JSFunction>(func)->getCodeBlock();
+    calleeBlock->lazyCompile(runtime);
+    if (LLVM_LIKELY(!calleeBlock->getHeaderFlags().isCallProhibited(
+            !newTarget.isUndefined()))) {
+      if (auto jitPtr =
+              runtime->getJITContext().compile(runtime, calleeBlock)) {
+        auto res = (*jitPtr)(runtime);
+        runtime->clearCallerIP();
+        return res;
+      }
+    }
+  }
+
+  // Native and bound functions take the same fast paths as in the
+  // interpreter, which call Function.prototype.call in the frame of the call
+  // and copy the bound arguments straight into the callee frame.
+  auto res = vmisa<NativeFunction>(func) || vmisa<BoundFunction>(func)
+      ? Interpreter::handleCallSlowPath(runtime, callable)
+      : Callable::call(Handle<Callable>::vmcast(callable), runtime);
   runtime->clearCallerIP();
   return res;
 }
 
-CallResult<HermesValue> externConstruct(
+CallResult<HermesValue> externCall(
     Runtime *runtime,
     PinnedHermesValue *callable,
     uint32_t argCount,
     PinnedHermesValue *stackPointer,
     const Inst *ip,
     PinnedHermesValue *previousFrame) {
-  GCScopeMarkerRAII marker{runtime};
-
-  if (LLVM_UNLIKELY(!dyn_vmcast<Callable>(*callable)))
-    return runtime->raiseTypeErrorForValue(
-        Handle<>(callable), " is not a function");
-
-  StackFramePtr frame(previousFrame);
-  (void)StackFramePtr::initFrame(
+  return callInNewFrame(
+      runtime,
+      callable,
+      argCount,
       stackPointer,
-      frame,
       ip,
-      // If the call goes to the interpret loop, it gives Ret a signal to
-      // exit that the savedCodeBlock is nullptr.
-      // It's temporarily breaking the stack trace functionality because
-      // otherwise it confuses the interpreter about when to exit.
-      nullptr, /* SavedCodeBlock */
-      argCount - 1,
-      *callable,
-      *callable);
-  runtime->storeCallerIP(ip);
-  auto res = Callable::call(Handle<Callable>::vmcast(callable), runtime);
-  runtime->clearCallerIP();
-  return res;
+      previousFrame,
+      HermesValue::encodeUndefinedValue());
+}
+
+CallResult<HermesValue> externConstruct(
+    Runtime *runtime,
+    PinnedHermesValue *callable,
+    uint32_t argCount,
+    PinnedHermesValue *stackPointer,
+    const Inst *ip,
+    PinnedHermesValue *previousFrame) {
+  return callInNewFrame(
+      runtime, callable, argCount, stackPointer, ip, previousFrame, *callable);
 }
 
 /// Implement a slow path call for a binary operator.
@@ -341,6 +395,14 @@ HermesValue externTypeOf(Runtime *runtime, PinnedHermesValue *src) {
   }
 }
 
+HermesValue externTypeOfIs(
+    Runtime *runtime,
+    PinnedHermesValue *src,
+    uint32_t type) {
+  return HermesValue::encodeBoolValue(
+      typeOfIs(*src, static_cast<inst::TypeOfIsType>(type)));
+}
+
 #define PROXY_EXTERN_CMP(slowPathName, OpName)                            \
   CallResult<HermesValue> slowPathName(                                   \
       Runtime *runtime, PinnedHermesValue *op1, PinnedHermesValue *op2) { \
@@ -414,6 +476,15 @@ ExecutionStatus externPutOwnByIndex(
       .getStatus(); // We don't need the bool value it returns
 }
 
+ExecutionStatus externPutOwnBySlotIdx(
+    Runtime *runtime,
+    PinnedHermesValue *obj,
+    PinnedHermesValue *prop,
+    uint32_t slot) {
+  JSObject::setNamedSlotValue(vmcast<JSObject>(*obj), runtime, slot, *prop);
+  return ExecutionStatus::RETURNED;
+}
+
 ExecutionStatus externPutNewOwnById(
     Runtime *runtime,
     PinnedHermesValue *target,
@@ -466,13 +537,22 @@ CallResult<HermesValue> externGetByVal(
     Runtime *runtime,
     PinnedHermesValue *target,
     PinnedHermesValue *nameVal) {
-  GCScopeMarkerRAII marker{runtime};
-
   if (LLVM_LIKELY(target->isObject())) {
+    // Fast path: an element present in the storage of a dense array.
+    if (auto *arr = dyn_vmcast<JSArray>(*target)) {
+      if (auto arrayIndex = toArrayIndexFastPath(*nameVal)) {
+        HermesValue value = arr->tryGetFastIndexed(runtime, *arrayIndex);
+        if (LLVM_LIKELY(!value.isEmpty()))
+          return value;
+      }
+    }
+
+    GCScopeMarkerRAII marker{runtime};
     return JSObject::getComputed_RJS(
         Handle<JSObject>::vmcast(target), runtime, Handle<>(nameVal));
   } else {
     // This is the "slow path".
+    GCScopeMarkerRAII marker{runtime};
     return Interpreter::getByValTransient_RJS(
         runtime, Handle<>(target), Handle<>(nameVal));
   }
@@ -484,9 +564,17 @@ ExecutionStatus externPutByVal(
     PinnedHermesValue *nameVal,
     PinnedHermesValue *value,
     PropOpFlags flags) {
-  GCScopeMarkerRAII marker{runtime};
-
   if (LLVM_LIKELY(target->isObject())) {
+    // Fast path: overwrite an element present in the storage of a dense array.
+    if (auto *arr = dyn_vmcast<JSArray>(*target)) {
+      if (auto arrayIndex = toArrayIndexFastPath(*nameVal)) {
+        if (LLVM_LIKELY(ArrayImpl::trySetFastIndexed(
+                arr, runtime, *arrayIndex, *value)))
+          return ExecutionStatus::RETURNED;
+      }
+    }
+
+    GCScopeMarkerRAII marker{runtime};
     return JSObject::putComputed_RJS(
                Handle<JSObject>::vmcast(target),
                runtime,
@@ -496,6 +584,7 @@ ExecutionStatus externPutByVal(
         .getStatus();
   } else {
     // This is the "slow path".
+    GCScopeMarkerRAII marker{runtime};
     return Interpreter::putByValTransient_RJS(
         runtime,
         Handle<>(target),
@@ -541,24 +630,10 @@ void externStoreToEnvironment(
     uint32_t idx,
     PinnedHermesValue *val,
     Runtime *runtime) {
-  // TODO: emit a check if \p val is non-pointer in fast path, if yes, set the
-  // value directly inline without emitting an external call
+  // Non-pointer values are stored inline by the JIT compiled code, so this is
+  // only reached for values that need a write barrier.
   vmcast<Environment>(*env)->slot(idx).set(*val, &runtime->getHeap());
 }
-void externStoreNPToEnvironment(
-    PinnedHermesValue *env,
-    uint32_t idx,
-    PinnedHermesValue *val) {
-  // TODO: emit the value setting directly in fast path without emitting an
-  // external call
-  vmcast<Environment>(*env)->slot(idx).setNonPtr(*val);
-}
-
-HermesValue externLoadFromEnvironment(PinnedHermesValue *env, uint32_t idx) {
-  // TODO: emit the instruction directly in fast path instead of emitting an
-  // external call
-  return vmcast<Environment>(*env)->slot(idx);
-}
 
 CallResult<HermesValue>
 externMod(Runtime *runtime, PinnedHermesValue *op1, PinnedHermesValue *op2) {
@@ -676,10 +751,11 @@ CallResult<HermesValue> externNewObjectWithBuffer(
     CodeBlock *curCodeBlock,
     uint32_t numLiterals,
     uint32_t keyBufferIndex,
-    uint32_t valBufferIndex) {
+    uint32_t valBufferIndex,
+    const Inst *ip) {
   GCScopeMarkerRAII marker{runtime};
   return Interpreter::createObjectFromBuffer(
-      runtime, curCodeBlock, numLiterals, keyBufferIndex, valBufferIndex);
+      runtime, curCodeBlock, numLiterals, keyBufferIndex, valBufferIndex, ip);
 }
 
 CallResult<HermesValue> externNewArrayWithBuffer(
@@ -687,10 +763,11 @@ CallResult<HermesValue> externNewArrayWithBuffer(
     CodeBlock *curCodeBlock,
     uint32_t numElements,
     uint32_t numLiterals,
-    uint32_t bufferIndex) {
+    uint32_t bufferIndex,
+    const Inst *ip) {
   GCScopeMarkerRAII marker{runtime};
   return Interpreter::createArrayFromBuffer(
-      runtime, curCodeBlock, numElements, numLiterals, bufferIndex);
+      runtime, curCodeBlock, numElements, numLiterals, bufferIndex, ip);
 }
 
 CallResult<HermesValue> slowPathNegate(
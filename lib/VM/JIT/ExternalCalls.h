@@ -142,6 +142,11 @@ HermesValue externLoadConstStringMayAllocate(
 /// given hermes register \p src.
 HermesValue externTypeOf(Runtime *runtime, PinnedHermesValue *src);
 
+/// An external call invoked by JIT compiled code to \return whether the JS
+/// type of \p src is the inst::TypeOfIsType \p type.
+HermesValue
+externTypeOfIs(Runtime *runtime, PinnedHermesValue *src, uint32_t type);
+
 /// An slow path invoked by JIT compiled code to call Operation::lessOp
 CallResult<HermesValue>
 slowPathLess(Runtime *runtime, PinnedHermesValue *op1, PinnedHermesValue *op2);
@@ -211,6 +216,17 @@ ExecutionStatus externPutNewOwnById(
     PinnedHermesValue *prop,
     uint32_t sid);
 
+/// An external call invoked by JIT compiled code to store a property of an
+/// object created by NewObjectWithBuffer directly in its slot.
+/// \param obj the object to store the property in.
+/// \param prop the value to be stored.
+/// \param slot the slot of the property in the class of the object.
+ExecutionStatus externPutOwnBySlotIdx(
+    Runtime *runtime,
+    PinnedHermesValue *obj,
+    PinnedHermesValue *prop,
+    uint32_t slot);
+
 /// An slow path invoked by JIT compiled code to coerce \p thisVal assumed to
 /// contain 'this' to an object
 CallResult<HermesValue> slowPathCoerceThis(
@@ -243,25 +259,14 @@ CallResult<HermesValue> externDelByVal(
     PinnedHermesValue *nameVal,
     PropOpFlags flags);
 
-/// An external call invoked by JIT compiled code to store a value \p val to an
-/// environment \p env, by the index slot number \p idx
+/// An external call invoked by JIT compiled code to store a pointer value \p
+/// val to an environment \p env, by the index slot number \p idx
 void externStoreToEnvironment(
     PinnedHermesValue *env,
     uint32_t idx,
     PinnedHermesValue *val,
     Runtime *runtime);
 
-/// An external call invoked by JIT compiled code to store a non-pointer value
-/// \p val to an environment \p env, by the index slot number \p idx
-void externStoreNPToEnvironment(
-    PinnedHermesValue *env,
-    uint32_t idx,
-    PinnedHermesValue *val);
-
-/// An external call invoked by JIT compiled code to \return a value from an
-/// environment \p env, by the index slot number \p idx
-HermesValue externLoadFromEnvironment(PinnedHermesValue *env, uint32_t idx);
-
 /// An external call invoked by JIT compiled code to do mod (op1 % op2)
 CallResult<HermesValue>
 externMod(Runtime *runtime, PinnedHermesValue *op1, PinnedHermesValue *op2);
@@ -309,7 +314,8 @@ CallResult<HermesValue> externNewObjectWithBuffer(
     CodeBlock *curCodeBlock,
     uint32_t numLiterals,
     uint32_t keyBufferIndex,
-    uint32_t valBufferIndex);
+    uint32_t valBufferIndex,
+    const Inst *ip);
 
 /// A wrapper to call Interpreter::createArrayFromBuffer, so that we could add
 /// GC scope marker before the call.
@@ -318,7 +324,8 @@ CallResult<HermesValue> externNewArrayWithBuffer(
     CodeBlock *curCodeBlock,
     uint32_t numElements,
     uint32_t numLiterals,
-    uint32_t bufferIndex);
+    uint32_t bufferIndex,
+    const Inst *ip);
 
 /// A slow path invoked by JIT compiled code to do unary minus
 /// \return -op1
@@ -97,6 +97,8 @@ class NativeDisassemblerImpl : public NativeDisassembler {
 
 const char NativeDisassembler::x86_64_unknown_linux_gnu[] =
     "x86_64-unknown-linux-gnu";
+const char NativeDisassembler::aarch64_unknown_linux_gnu[] =
+    "aarch64-unknown-linux-gnu";
 
 NativeDisassembler::~NativeDisassembler() {}
 
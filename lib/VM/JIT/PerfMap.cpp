@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/JIT/PerfMap.h"
+
+#include "hermes/Support/OSCompat.h"
+#include "hermes/VM/CodeBlock.h"
+#include "hermes/VM/RuntimeModule.h"
+
+#include "llvm/Support/raw_ostream.h"
+
+#ifdef __linux__
+#include <elf.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#include <string>
+
+namespace hermes {
+namespace vm {
+
+#ifdef __linux__
+namespace {
+
+/// Record types of the jitdump format, documented in
+/// tools/perf/Documentation/jitdump-specification.txt of the Linux sources.
+enum JITDumpRecord : uint32_t {
+  JIT_CODE_LOAD = 0,
+  JIT_CODE_DEBUG_INFO = 2,
+};
+
+struct JITDumpHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t totalSize;
+  uint32_t elfMach;
+  uint32_t pad1;
+  uint32_t pid;
+  uint64_t timestamp;
+  uint64_t flags;
+};
+
+struct JITDumpRecordHeader {
+  uint32_t id;
+  uint32_t totalSize;
+  uint64_t timestamp;
+};
+
+struct JITDumpCodeLoad {
+  JITDumpRecordHeader header;
+  uint32_t pid;
+  uint32_t tid;
+  uint64_t vma;
+  uint64_t codeAddr;
+  uint64_t codeSize;
+  uint64_t codeIndex;
+  // Followed by the name and the code.
+};
+
+struct JITDumpDebugInfo {
+  JITDumpRecordHeader header;
+  uint64_t codeAddr;
+  uint64_t numEntries;
+  // Followed by the entries.
+};
+
+struct JITDumpDebugEntry {
+  uint64_t codeAddr;
+  uint32_t line;
+  uint32_t discriminator;
+  // Followed by the file name.
+};
+
+/// \return the time in the clock used by `perf record -k 1`.
+uint64_t monotonicNanos() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+template <typename T>
+void appendPod(std::string &buf, const T &value) {
+  buf.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+void appendCString(std::string &buf, llvm::StringRef str) {
+  buf.append(str.data(), str.size());
+  buf.push_back('\0');
+}
+
+} // namespace
+#endif
+
+PerfMap &PerfMap::get(bool jitdump) {
+  // Never destroyed, since JIT compiled code may outlive static destructors.
+  static PerfMap *instance = new PerfMap(jitdump);
+  return *instance;
+}
+
+PerfMap::PerfMap(bool jitdump) {
+#ifdef __linux__
+  std::string path = "/tmp/perf-" + std::to_string(getpid()) + ".map";
+  map_ = fopen(path.c_str(), "w");
+  if (!map_) {
+    llvm::errs() << "Cannot open " << path << "\n";
+  }
+  if (jitdump) {
+    openJITDump();
+  }
+#endif
+}
+
+void PerfMap::openJITDump() {
+#ifdef __linux__
+  std::string path = "jit-" + std::to_string(getpid()) + ".dump";
+  jitDump_ = open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0666);
+  if (jitDump_ < 0) {
+    llvm::errs() << "Cannot open " << path << "\n";
+    return;
+  }
+  // perf finds the file from this mapping, which must be executable. It is
+  // never unmapped.
+  void *marker = mmap(
+      nullptr,
+      oscompat::page_size(),
+      PROT_READ | PROT_EXEC,
+      MAP_PRIVATE,
+      jitDump_,
+      0);
+  if (marker == MAP_FAILED) {
+    close(jitDump_);
+    jitDump_ = -1;
+    return;
+  }
+
+  JITDumpHeader header{};
+  header.magic = 0x4A695444;
+  header.version = 1;
+  header.totalSize = sizeof(header);
+#if defined(__x86_64__)
+  header.elfMach = EM_X86_64;
+#elif defined(__aarch64__)
+  header.elfMach = EM_AARCH64;
+#endif
+  header.pid = getpid();
+  header.timestamp = monotonicNanos();
+  writeJITDump(&header, sizeof(header));
+#endif
+}
+
+void PerfMap::writeJITDump(const void *data, size_t size) {
+#ifdef __linux__
+  const char *bytes = static_cast<const char *>(data);
+  while (size) {
+    ssize_t written = write(jitDump_, bytes, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+    bytes += written;
+    size -= written;
+  }
+#endif
+}
+
+void PerfMap::addCode(
+    const void *code,
+    size_t size,
+    llvm::StringRef name,
+    llvm::StringRef filename,
+    llvm::ArrayRef<LineEntry> lines) {
+#ifdef __linux__
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (map_) {
+    fprintf(
+        map_,
+        "%lx %zx %.*s\n",
+        reinterpret_cast<unsigned long>(code),
+        size,
+        static_cast<int>(name.size()),
+        name.data());
+    fflush(map_);
+  }
+  if (jitDump_ < 0) {
+    return;
+  }
+
+  uint64_t timestamp = monotonicNanos();
+  std::string record;
+  // The debug info must come before the code it describes.
+  if (!lines.empty()) {
+    JITDumpDebugInfo debugInfo{};
+    debugInfo.header.id = JIT_CODE_DEBUG_INFO;
+    debugInfo.header.timestamp = timestamp;
+    debugInfo.codeAddr = reinterpret_cast<uint64_t>(code);
+    debugInfo.numEntries = lines.size();
+    appendPod(record, debugInfo);
+    for (const LineEntry &entry : lines) {
+      JITDumpDebugEntry debugEntry{};
+      debugEntry.codeAddr = reinterpret_cast<uint64_t>(entry.address);
+      debugEntry.line = entry.line;
+      appendPod(record, debugEntry);
+      appendCString(record, filename);
+    }
+    reinterpret_cast<JITDumpRecordHeader *>(&record[0])->totalSize =
+        record.size();
+    writeJITDump(record.data(), record.size());
+    record.clear();
+  }
+
+  JITDumpCodeLoad codeLoad{};
+  codeLoad.header.id = JIT_CODE_LOAD;
+  codeLoad.header.timestamp = timestamp;
+  codeLoad.header.totalSize = sizeof(codeLoad) + name.size() + 1 + size;
+  codeLoad.pid = getpid();
+  codeLoad.tid = static_cast<uint32_t>(oscompat::thread_id());
+  codeLoad.vma = reinterpret_cast<uint64_t>(code);
+  codeLoad.codeAddr = reinterpret_cast<uint64_t>(code);
+  codeLoad.codeSize = size;
+  codeLoad.codeIndex = codeIndex_++;
+  appendPod(record, codeLoad);
+  appendCString(record, name);
+  writeJITDump(record.data(), record.size());
+  writeJITDump(code, size);
+#endif
+}
+
+std::string getPerfName(
+    Runtime *runtime,
+    CodeBlock *codeBlock,
+    std::string &filename) {
+  std::string name;
+  if (!codeBlock->getNameString(runtime, name) || name.empty())
+    name = "(anonymous)";
+  auto debugOffset = codeBlock->getDebugSourceLocationsOffset();
+  if (!debugOffset.hasValue())
+    return name;
+  auto *debugInfo =
+      codeBlock->getRuntimeModule()->getBytecode()->getDebugInfo();
+  auto loc = debugInfo->getLocationForAddress(debugOffset.getValue(), 0);
+  if (!loc.hasValue())
+    return name;
+  filename = debugInfo->getFilenameByID(loc.getValue().filenameId);
+  return name + " (" + filename + ":" + std::to_string(loc.getValue().line) +
+      ")";
+}
+
+} // namespace vm
+} // namespace hermes
@@ -42,6 +42,7 @@ void *PoolHeap::alloc(size_t size) {
     }
 
     allocList_[result] = size;
+    allocatedSize_ += size;
     return result;
   }
 
@@ -93,6 +94,7 @@ void PoolHeap::freeHelper(BlockMap::iterator allocIt, size_t keepSize) {
     // Remove from free list.
     allocList_.erase(allocIt);
   }
+  allocatedSize_ -= size;
 
   // Find the next free block.
   auto nextFreeIt = freeList_.upper_bound(cblock);
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_VM_JIT_RUNTIMEOFFSETS_H
+#define HERMES_VM_JIT_RUNTIMEOFFSETS_H
+
+#include "hermes/VM/GC.h"
+#include "hermes/VM/Runtime.h"
+
+namespace hermes {
+namespace vm {
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+
+struct RuntimeOffsets {
+  static constexpr uint32_t stackPointer = offsetof(Runtime, stackPointer_);
+  static constexpr uint32_t currentFrame = offsetof(Runtime, currentFrame_);
+  static constexpr uint32_t globalObject = offsetof(Runtime, global_);
+  static constexpr uint32_t thrownValue = offsetof(Runtime, thrownValue_);
+  static constexpr uint32_t objectPrototype =
+      offsetof(Runtime, objectPrototypeRawPtr);
+  static constexpr uint32_t rootClazz = offsetof(Runtime, rootClazzRawPtr_);
+  static constexpr uint32_t bytesUntilAllocationSample =
+      offsetof(Runtime, bytesUntilAllocationSample_);
+  static constexpr uint32_t cellVTable = offsetof(GCCell, vtp_);
+  static constexpr uint32_t objectFlags = offsetof(JSObject, flags_);
+  static constexpr uint32_t objectParent = offsetof(JSObject, parent_);
+  static constexpr uint32_t objectClass = offsetof(JSObject, clazz_);
+  static constexpr uint32_t objectPropStorage =
+      offsetof(JSObject, propStorage_);
+  static constexpr uint32_t objectDirectProps =
+      offsetof(JSObject, directProps_);
+
+#ifdef HERMESVM_GC_NONCONTIG_GENERATIONAL
+  /// The bump pointer and limit of the segment the GC currently allocates
+  /// into. The segment is embedded in the heap, which is embedded in the
+  /// runtime, so both are at fixed offsets from the runtime.
+  static constexpr uint32_t allocLevel = offsetof(Runtime, heap_) +
+      offsetof(GenGC, allocContext_.activeSegment.level_);
+  static constexpr uint32_t allocEnd = offsetof(Runtime, heap_) +
+      offsetof(GenGC, allocContext_.activeSegment.effectiveEnd_);
+  static constexpr uint32_t pretenure =
+      offsetof(Runtime, heap_) + offsetof(GenGC, pretenure_);
+
+  /// The start of the young generation segment, and the offsets of the card
+  /// table arrays from the start of a segment, for the write barrier. The
+  /// card table is the first thing in its segment (see CardTable::base()).
+  static constexpr uint32_t youngGenLowLim =
+      offsetof(Runtime, heap_) + offsetof(GenGC, youngGen_.lowLim_);
+  static constexpr uint32_t segmentCards = offsetof(CardTable, cards_);
+  static constexpr uint32_t segmentCardSummary = offsetof(CardTable, summary_);
+#endif
+};
+
+#pragma GCC diagnostic pop
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_JIT_RUNTIMEOFFSETS_H
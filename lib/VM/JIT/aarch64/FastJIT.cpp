@@ -0,0 +1,758 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "FastJIT.h"
+
+#include "../ExternalCalls.h"
+#include "../RuntimeOffsets.h"
+#include "hermes/Inst/InstDecode.h"
+#include "hermes/VM/JIT/DiscoverBB.h"
+
+#define DEBUG_TYPE "jit"
+
+namespace hermes {
+namespace vm {
+namespace aarch64 {
+using hermes::inst::Inst;
+
+/// A HermesValue is a number if it is unsigned lower than this value, which
+/// is FirstTag in the tag bits.
+static constexpr uint64_t FirstTagValue = (uint64_t)FirstTag
+    << HermesValue::kNumDataBits;
+
+/// The size of the native frame of the compiled code: the frame pointer, the
+/// link register, and the callee-saved registers of FastJIT.h.
+static constexpr int32_t kNativeFrameSize = 48;
+
+FastJIT::FastJIT(JITContext *context, CodeBlock *codeBlock)
+    : context_(context), codeBlock_(codeBlock) {}
+
+void FastJIT::compile() {
+  LLVM_DEBUG(
+      llvm::dbgs() << "JIT compilation of FunctionID "
+                   << codeBlock_->getFunctionID() << "\n");
+
+  discoverBasicBlocks(codeBlock_, bcBasicBlocks_, bcLabels_);
+
+  ExecHeap::SizePair sizes;
+  auto blocks = allocBlocks(codeBlock_->getOpcodeArray().size(), sizes);
+  if (!blocks)
+    return;
+
+  fast_ = llvm::makeMutableArrayRef(blocks->first, sizes.first);
+  slow_ = llvm::makeMutableArrayRef(blocks->second, sizes.second);
+
+  Emitters emit{Emitter{fast_.begin()}, Emitter{slow_.begin()}};
+  emit = emitPrologue(emit);
+
+  nativeBBAddress_.resize(bcBasicBlocks_.size());
+
+  // Compile every basic block and record its starting address.
+  unsigned bcBasicBlocksCount = bcBasicBlocks_.size() - 1;
+  for (curBytecodeBBIndex_ = 0;
+       curBytecodeBBIndex_ != bcBasicBlocksCount && !error_;
+       ++curBytecodeBBIndex_) {
+    nativeBBAddress_[curBytecodeBBIndex_] = emit.fast.current();
+    emit = compileBB(emit);
+  }
+
+  if (!error_) {
+    // Emit the function epilogue.
+    nativeBBAddress_[curBytecodeBBIndex_] = emit.fast.current();
+    emit = emitEpilogue(emit);
+  }
+
+  // Emit the on-stack replacement entry in the slow path.
+  const uint8_t *osrEntry = emit.slow.current();
+  if (!error_)
+    emit = emitOSREntry(emit);
+
+  if (!error_)
+    resolveRelocations();
+
+  if (!error_) {
+    LLVM_DEBUG(disassembleResult(emit, llvm::dbgs(), true));
+    if (context_->getDumpJITCode())
+      disassembleResult(emit, llvm::outs(), false);
+
+    context_->getHeap().freeRemaining(
+        *blocks,
+        {emit.fast.current() - fast_.data(),
+         emit.slow.current() - slow_.data()});
+    fast_ = fast_.take_front(emit.fast.current() - fast_.data());
+    slow_ = slow_.take_front(emit.slow.current() - slow_.data());
+    codeBlock_->setJITCompiled((JITCompiledFunctionPtr)fast_.data());
+    codeBlock_->setJITCodeBlocks(slow_.data(), fast_.size() + slow_.size());
+
+    // Every basic block can be entered from the interpreter, since any jump
+    // target starts a block.
+    std::vector<std::pair<uint32_t, const void *>> osrTargets{};
+    osrTargets.reserve(bcBasicBlocksCount);
+    for (unsigned i = 0; i != bcBasicBlocksCount; ++i)
+      osrTargets.emplace_back(bcBasicBlocks_[i], nativeBBAddress_[i]);
+    codeBlock_->setJITOSREntry((JITOSREntryPtr)osrEntry, std::move(osrTargets));
+
+    LLVM_DEBUG(context_->getHeap().dump(llvm::dbgs()));
+  } else {
+    context_->getHeap().free(*blocks);
+    if (context_->getCrashOnError()) {
+      hermes_fatal(errorMsg_.c_str());
+    }
+  }
+}
+
+void FastJIT::addToPerfMap(Runtime *runtime, PerfMap &perfMap) const {
+  std::string filename;
+  std::string name = "JIT:" + getPerfName(runtime, codeBlock_, filename);
+
+  std::vector<PerfMap::LineEntry> lines;
+  auto debugOffset = codeBlock_->getDebugSourceLocationsOffset();
+  if (debugOffset.hasValue()) {
+    auto *debugInfo =
+        codeBlock_->getRuntimeModule()->getBytecode()->getDebugInfo();
+    // The last basic block is the epilogue.
+    for (size_t i = 0, e = bcBasicBlocks_.size() - 1; i != e; ++i) {
+      auto loc = debugInfo->getLocationForAddress(
+          debugOffset.getValue(), bcBasicBlocks_[i]);
+      if (loc.hasValue())
+        lines.push_back({nativeBBAddress_[i], loc.getValue().line});
+    }
+  }
+
+  perfMap.addCode(fast_.data(), fast_.size(), name, filename, lines);
+  if (!slow_.empty())
+    perfMap.addCode(slow_.data(), slow_.size(), name + " [slow]");
+}
+
+void FastJIT::error(const llvm::Twine &msg) {
+  if (!error_)
+    codeBlock_->setDontJIT(true);
+  error_ = true;
+  if (errorMsg_.empty())
+    errorMsg_ = msg.str();
+  LLVM_DEBUG(llvm::dbgs() << "FastJIT error: " << msg << "\n");
+}
+
+llvm::Optional<ExecHeap::BlockPair> FastJIT::allocBlocks(
+    size_t bytecodeLength,
+    ExecHeap::SizePair &sizes) {
+  sizes = ExecHeap::SizePair{bytecodeLength * 50 + kMinInstructionSpace,
+                             bytecodeLength * 50 + kMinInstructionSpace};
+
+  auto blocks = context_->getHeap().alloc(sizes);
+  // If the allocation failed, add a new pool and retry.
+  if (!blocks) {
+    auto newPool = context_->getHeap().addPool();
+    if (!newPool) {
+      error("out of executable memory");
+      return llvm::None;
+    }
+
+    blocks = newPool->alloc(sizes);
+    if (!blocks) {
+      error("bytecode size too large");
+      return llvm::None;
+    }
+  }
+
+  assert(blocks && "allocation should have succeeded");
+  return blocks;
+}
+
+void FastJIT::disassembleRange(
+    const uint8_t *from,
+    const uint8_t *to,
+    llvm::raw_ostream &OS,
+    bool withAddr) const {
+  if (to != from) {
+    context_->getDisassembler().disassembleBuffer(
+        OS, {from, to}, from - fast_.data(), withAddr);
+  }
+}
+
+void FastJIT::disassembleResult(
+    Emitters emit,
+    llvm::raw_ostream &OS,
+    bool withAddr) const {
+  OS << "\n\nCompiled Code of FunctionID: " << codeBlock_->getFunctionID()
+     << "\n";
+  auto *last = fast_.data();
+
+  for (size_t i = 0; i < nativeBBAddress_.size(); ++i) {
+    disassembleRange(last, nativeBBAddress_[i], OS, withAddr);
+    last = nativeBBAddress_[i];
+    OS << "BB" << i << ":\n";
+  }
+  disassembleRange(last, emit.fast.current(), OS, withAddr);
+
+  // Unlike on x86-64, the slow paths contain no data.
+  OS << "\n;SLOW PATHS\n";
+  disassembleRange(slow_.data(), emit.slow.current(), OS, withAddr);
+}
+
+void FastJIT::resolveRelocations() {
+  for (const auto &relo : relocs_) {
+    const uint8_t *target = nativeBBAddress_[relo.targetBCBBIndex];
+    switch (relo.kind) {
+      case ReloKind::Branch26:
+        if (!Emitter::canBranch26(relo.address, target))
+          return error("branch out of range");
+        Emitter::patchBranch(relo.address, target, 26);
+        break;
+      case ReloKind::Branch19:
+        if (!Emitter::canBranch19(relo.address, target))
+          return error("conditional branch out of range");
+        Emitter::patchBranch(relo.address, target, 19);
+        break;
+      case ReloKind::None:
+        llvm_unreachable("ReloKind::None can not be relocated. ");
+    }
+  }
+  relocs_.clear();
+}
+
+Emitter FastJIT::emitFrameSetup(Emitter emit) {
+  emit.stpPreIndex(Reg::x29, Reg::x30, -kNativeFrameSize);
+  emit.movRegToReg(Reg::sp, Reg::x29);
+  emit.stp(RegRuntime, RegFrame, 16);
+  emit.stp(RegFirstTag, RegSavedFrame, 32);
+
+  // Move the first parameter (Runtime *) into its register.
+  emit.movRegToReg(Reg::x0, RegRuntime);
+  emit.movImmToReg(FirstTagValue, RegFirstTag);
+  emit.ldrRMToReg(RegRuntime, RuntimeOffsets::currentFrame, RegSavedFrame);
+  return emit;
+}
+
+Emitters FastJIT::emitPrologue(Emitters emit) {
+  if (!checkSpace(emit))
+    return emit;
+
+  emit.fast = emitFrameSetup(emit.fast);
+
+  // Load runtime->stackPointer_ top into RegFrame, and make it the current
+  // frame.
+  emit.fast.ldrRMToReg(RegRuntime, RuntimeOffsets::stackPointer, RegFrame);
+  emit.fast.strRegToRM(RegFrame, RegRuntime, RuntimeOffsets::currentFrame);
+
+  // Allocate and clear registers for the frame and update the top of the stack.
+  // runtime->stackPointer = RegFrame - 8*numRegsNeeded.
+  const int numRegsNeeded = codeBlock_->getFrameSize() +
+      StackFrameLayout::CalleeExtraRegistersAtStart;
+  emit.fast.movImmToReg(
+      HermesValue::encodeUndefinedValue().getRaw(), Reg::x16);
+  emit.fast.addOffset(
+      RegFrame, -(int32_t)sizeof(HermesValue) * numRegsNeeded, Reg::x1);
+  if (numRegsNeeded <= 8) {
+    for (int i = 1; i <= numRegsNeeded; ++i)
+      emit.fast.strRegToRM(Reg::x16, RegFrame, -i * sizeof(HermesValue));
+  } else {
+    // Clear them in a loop from the top, the same size as a few stores.
+    emit.fast.movRegToReg(RegFrame, Reg::x0);
+    uint8_t *loop = emit.fast.current();
+    emit.fast.strRegToRMPreIndex(Reg::x16, Reg::x0, -(int)sizeof(HermesValue));
+    emit.fast.cmpRegToReg(Reg::x0, Reg::x1);
+    emit.fast.bcond(CCode::NE, loop);
+  }
+  emit.fast.strRegToRM(Reg::x1, RegRuntime, RuntimeOffsets::stackPointer);
+
+  return emit;
+}
+
+Emitters FastJIT::emitEpilogue(Emitters emit) {
+  if (!checkSpace(emit))
+    return emit;
+
+  // Restore the VM stack pointer: runtime->stackPointer = RegFrame.
+  emit.fast.strRegToRM(RegFrame, RegRuntime, RuntimeOffsets::stackPointer);
+  // Restore runtime->currentFrame_.
+  emit.fast.strRegToRM(RegSavedFrame, RegRuntime, RuntimeOffsets::currentFrame);
+
+  // Restore callee saved registers.
+  emit.fast.ldp(RegFirstTag, RegSavedFrame, 32);
+  emit.fast.ldp(RegRuntime, RegFrame, 16);
+  emit.fast.ldpPostIndex(Reg::x29, Reg::x30, kNativeFrameSize);
+  emit.fast.ret();
+
+  return emit;
+}
+
+Emitters FastJIT::emitOSREntry(Emitters emit) {
+  if (!checkSpace(emit))
+    return emit;
+
+  // Build the same native frame as the prologue, so the regular epilogue can
+  // tear it down. The interpreter frame stays the current frame, so the
+  // epilogue restores it rather than the caller's. The interpreter pops it
+  // after we return.
+  emit.slow = emitFrameSetup(emit.slow);
+
+  // The registers of the frame were already allocated and initialized by the
+  // interpreter, so just point RegFrame to them.
+  emit.slow.movRegToReg(RegSavedFrame, RegFrame);
+
+  // Jump to the basic block passed as the second parameter.
+  emit.slow.br(Reg::x1);
+  return emit;
+}
+
+// Calculate the address of the next instruction given the name of the current
+// one.
+#define NEXTINST(name) ((const Inst *)(&ip->i##name + 1))
+
+Emitters FastJIT::compileBB(Emitters emit) {
+  auto *ip = reinterpret_cast<const Inst *>(
+      codeBlock_->begin() + bcBasicBlocks_[curBytecodeBBIndex_]);
+  auto *to = reinterpret_cast<const Inst *>(
+      codeBlock_->begin() + bcBasicBlocks_[curBytecodeBBIndex_ + 1]);
+
+  while (ip != to) {
+    if (!checkSpace(emit))
+      return emit;
+
+    LLVM_DEBUG(llvm::dbgs() << ";   " << decodeInstruction(ip) << "\n");
+
+    // Quickened instructions have the same layout and semantics as the
+    // instructions they were quickened from.
+    switch (getUnquickenedOpCode(ip->opCode)) {
+#define CASE(name)                  \
+  case OpCode::name:                \
+    emit = compile##name(emit, ip); \
+    ip = NEXTINST(name);            \
+    break
+
+/// Implement a comparison jump with a fast path and a slow path, its N
+/// version with only the fast path, and their long versions.
+/// \param cc the condition after comparing the numbers in which to jump.
+#define JCOND_IMPL(name, suffix, cc, slowPathCall) \
+  case OpCode::name##suffix:                       \
+    emit = compileCondJump(                        \
+        emit,                                      \
+        ip,                                        \
+        ip->i##name##suffix.op1,                   \
+        ip->i##name##suffix.op2,                   \
+        ip->i##name##suffix.op3,                   \
+        cc,                                        \
+        (const void *)slowPathCall);               \
+    ip = NEXTINST(name##suffix);                   \
+    break;                                         \
+  case OpCode::name##N##suffix:                    \
+    emit = compileCondJumpN(                       \
+        emit,                                      \
+        ip,                                        \
+        ip->i##name##N##suffix.op1,                \
+        ip->i##name##N##suffix.op2,                \
+        ip->i##name##N##suffix.op3,                \
+        cc);                                       \
+    ip = NEXTINST(name##N##suffix);                \
+    break
+
+#define JCOND(name, cc, slowPathCall)   \
+  JCOND_IMPL(name, , cc, slowPathCall); \
+  JCOND_IMPL(name, Long, cc, slowPathCall)
+
+#define BINOP(name)                                                 \
+  case OpCode::name:                                                \
+    emit = compileBinOp(                                            \
+        emit, ip, (const void *)slowPath##name, NumberBinOp::name); \
+    ip = NEXTINST(name);                                            \
+    break;                                                          \
+  case OpCode::name##N:                                             \
+    emit.fast = emitNumberBinOp(emit.fast, ip, NumberBinOp::name);  \
+    ip = NEXTINST(name##N);                                         \
+    break
+
+#define LOAD_CONST(name, val)                                             \
+  case OpCode::name:                                                      \
+    emit.fast = loadHermesValueConstant(emit.fast, ip->i##name.op1, val); \
+    ip = NEXTINST(name);                                                  \
+    break
+
+      CASE(LoadParam);
+      CASE(LoadConstZero);
+      CASE(Mov);
+      CASE(MovLong);
+      CASE(ToNumber);
+      CASE(GetGlobalObject);
+      CASE(Call);
+      CASE(CallLong);
+      CASE(Construct);
+      CASE(ConstructLong);
+      CASE(Ret);
+      BINOP(Add);
+      BINOP(Sub);
+      BINOP(Mul);
+      BINOP(Div);
+
+      // fcmp sets C and V for NaN, so the conditions of the jumps that are
+      // taken if the comparison is false (JNot*) hold for unordered numbers,
+      // and the others don't.
+      JCOND(JLess, CCode::MI, slowPathLess);
+      JCOND(JLessEqual, CCode::LS, slowPathLessEq);
+      JCOND(JGreater, CCode::GT, slowPathGreater);
+      JCOND(JGreaterEqual, CCode::GE, slowPathGreaterEq);
+      JCOND(JNotLess, CCode::PL, slowPathGreaterEq);
+      JCOND(JNotLessEqual, CCode::HI, slowPathGreater);
+      JCOND(JNotGreater, CCode::LE, slowPathLessEq);
+      JCOND(JNotGreaterEqual, CCode::LT, slowPathLess);
+
+      case OpCode::Jmp:
+        emit = compileJmp(emit, ip, ip->iJmp.op1);
+        ip = NEXTINST(Jmp);
+        break;
+      case OpCode::JmpLong:
+        emit = compileJmp(emit, ip, ip->iJmpLong.op1);
+        ip = NEXTINST(JmpLong);
+        break;
+
+      LOAD_CONST(
+          LoadConstInt, HermesValue::encodeDoubleValue(ip->iLoadConstInt.op2));
+      LOAD_CONST(
+          LoadConstUInt8,
+          HermesValue::encodeDoubleValue(ip->iLoadConstUInt8.op2));
+      LOAD_CONST(
+          LoadConstDouble,
+          HermesValue::encodeDoubleValue(ip->iLoadConstDouble.op2));
+      LOAD_CONST(LoadConstUndefined, HermesValue::encodeUndefinedValue());
+      LOAD_CONST(LoadConstTrue, HermesValue::encodeBoolValue(true));
+      LOAD_CONST(LoadConstFalse, HermesValue::encodeBoolValue(false));
+      LOAD_CONST(LoadConstNull, HermesValue::encodeNullValue());
+
+      default:
+        if (!error_)
+          errorOffset_ = codeBlock_->getOffsetOf(ip);
+        error(
+            llvm::Twine("unsupported opcode ") + llvm::Twine((int)ip->opCode) +
+            " " + getOpCodeString(ip->opCode));
+        return emit;
+    }
+#undef CASE
+#undef JCOND_IMPL
+#undef JCOND
+#undef BINOP
+#undef LOAD_CONST
+  }
+
+  return emit;
+}
+
+Emitter FastJIT::movHermesRegToNativeReg(
+    Emitter emit,
+    uint32_t hermesReg,
+    Reg nativeReg) {
+  emit.ldrRMToReg(RegFrame, localHermesRegByteOffset(hermesReg), nativeReg);
+  return emit;
+}
+
+Emitter FastJIT::movNativeRegToHermesReg(
+    Emitter emit,
+    Reg nativeReg,
+    uint32_t hermesReg) {
+  emit.strRegToRM(nativeReg, RegFrame, localHermesRegByteOffset(hermesReg));
+  return emit;
+}
+
+Emitter FastJIT::movHermesRegToFPReg(
+    Emitter emit,
+    uint32_t hermesReg,
+    FReg nativeReg) {
+  emit.ldrRMToFReg(RegFrame, localHermesRegByteOffset(hermesReg), nativeReg);
+  return emit;
+}
+
+Emitter
+FastJIT::leaHermesReg(Emitter emit, uint32_t hermesReg, Reg nativeReg) {
+  emit.addOffset(RegFrame, localHermesRegByteOffset(hermesReg), nativeReg);
+  return emit;
+}
+
+Emitter FastJIT::loadHermesValueConstant(
+    Emitter emit,
+    uint32_t hermesReg,
+    HermesValue value) {
+  // Constants are at most four instructions, so they are built inline rather
+  // than loaded from a pool.
+  emit.movImmToReg(value.getRaw(), Reg::x16);
+  return movNativeRegToHermesReg(emit, Reg::x16, hermesReg);
+}
+
+Emitter FastJIT::callExternal(
+    Emitter emit,
+    const void *dest,
+    uint32_t resultReg,
+    const Inst *ip) {
+  // Runtime -> arg1.
+  emit.movRegToReg(RegRuntime, Reg::x0);
+  emit.movImmToReg((uint64_t)dest, Reg::x16);
+  emit.blr(Reg::x16);
+
+  // w0: status, only in its low byte.
+  // x1: HermesValue
+
+  // Exception?
+  emit.testLowByte(Reg::x0);
+  emit = cjmpToBytecodeBB(emit, CCode::EQ, getCatchHandlerBBIndex(ip));
+
+  // Move the result value to the destination register.
+  if (resultReg != kNoResultReg)
+    emit = movNativeRegToHermesReg(emit, Reg::x1, resultReg);
+  return emit;
+}
+
+Emitter FastJIT::isNumber(
+    Emitter emit,
+    uint32_t hermesReg,
+    const uint8_t *slowPathAddr) {
+  emit = movHermesRegToNativeReg(emit, hermesReg, Reg::x16);
+  emit.cmpRegToReg(Reg::x16, RegFirstTag);
+  emit.bcondFar(CCode::HS, slowPathAddr);
+  return emit;
+}
+
+Emitter FastJIT::jmpToBytecodeBB(Emitter emit, unsigned bytecodeBB) {
+  // If jumping to the next BB, do nothing.
+  if (bytecodeBB == curBytecodeBBIndex_ + 1 && isFastPath(emit))
+    return emit;
+
+  // Backwards branch doesn't need a relocation and we can determine the offset.
+  if (bytecodeBB <= curBytecodeBBIndex_) {
+    emit.b(nativeBBAddress_[bytecodeBB]);
+  } else {
+    relocs_.emplace_back(ReloKind::Branch26, emit.current(), bytecodeBB);
+    emit.b(emit.current());
+  }
+  return emit;
+}
+
+Emitter FastJIT::cjmpToBytecodeBB(Emitter emit, CCode cc, unsigned bytecodeBB) {
+  if (bytecodeBB <= curBytecodeBBIndex_) {
+    emit.bcondFar(cc, nativeBBAddress_[bytecodeBB]);
+  } else if (isFastPath(emit)) {
+    relocs_.emplace_back(ReloKind::Branch19, emit.current(), bytecodeBB);
+    emit.bcond(cc, emit.current());
+  } else {
+    // The slow path may be too far from the fast path for a conditional
+    // branch, so skip an unconditional one.
+    emit.bcond(invert(cc), emit.current() + 2 * Emitter::kInstructionSize);
+    relocs_.emplace_back(ReloKind::Branch26, emit.current(), bytecodeBB);
+    emit.b(emit.current());
+  }
+  return emit;
+}
+
+unsigned FastJIT::getCatchHandlerBBIndex(const Inst *ip) {
+  // The offset between catch handler ip and codeBlock_->begin()
+  int32_t handlerOffset = codeBlock_->findCatchTargetOffset(
+      (const uint8_t *)ip - (const uint8_t *)codeBlock_->begin());
+  if (handlerOffset == -1)
+    return bcBasicBlocks_.size() - 1; // exit block
+  assert(
+      bcLabels_.find(handlerOffset) != bcLabels_.end() &&
+      "handlerOffset not in bcLabels_");
+  return bcLabels_[handlerOffset];
+}
+
+Emitter
+FastJIT::emitNumberBinOp(Emitter emit, const Inst *ip, NumberBinOp op) {
+  // All the N arithmetic instructions have the layout of AddN.
+  emit = movHermesRegToFPReg(emit, ip->iAddN.op2, FReg::d0);
+  emit = movHermesRegToFPReg(emit, ip->iAddN.op3, FReg::d1);
+  switch (op) {
+    case NumberBinOp::Add:
+      emit.faddRegs(FReg::d0, FReg::d1, FReg::d0);
+      break;
+    case NumberBinOp::Sub:
+      emit.fsubRegs(FReg::d0, FReg::d1, FReg::d0);
+      break;
+    case NumberBinOp::Mul:
+      emit.fmulRegs(FReg::d0, FReg::d1, FReg::d0);
+      break;
+    case NumberBinOp::Div:
+      emit.fdivRegs(FReg::d0, FReg::d1, FReg::d0);
+      break;
+  }
+  emit.strFRegToRM(
+      FReg::d0, RegFrame, localHermesRegByteOffset(ip->iAddN.op1));
+  return emit;
+}
+
+Emitters FastJIT::compileBinOp(
+    Emitters emit,
+    const Inst *ip,
+    const void *slowPathBinOp,
+    NumberBinOp op) {
+  const uint8_t *slowPathAddr = emit.slow.current();
+
+  emit.fast = isNumber(emit.fast, ip->iAdd.op2, slowPathAddr);
+  emit.fast = isNumber(emit.fast, ip->iAdd.op3, slowPathAddr);
+  emit.fast = emitNumberBinOp(emit.fast, ip, op);
+
+  // &op2 -> arg2, &op3 -> arg3
+  emit.slow = leaHermesReg(emit.slow, ip->iAdd.op2, Reg::x1);
+  emit.slow = leaHermesReg(emit.slow, ip->iAdd.op3, Reg::x2);
+  emit.slow = callExternal(emit.slow, slowPathBinOp, ip->iAdd.op1, ip);
+  emit.slow.b(emit.fast.current());
+  return emit;
+}
+
+Emitters FastJIT::compileCondJumpN(
+    Emitters emit,
+    const Inst *ip,
+    uint32_t ipOffset,
+    uint32_t reg1,
+    uint32_t reg2,
+    CCode cc) {
+  emit.fast = movHermesRegToFPReg(emit.fast, reg1, FReg::d0);
+  emit.fast = movHermesRegToFPReg(emit.fast, reg2, FReg::d1);
+  emit.fast.fcmpRegs(FReg::d0, FReg::d1);
+  emit.fast = cjmpToBytecodeBB(emit.fast, cc, getBBIndex(ip, ipOffset));
+  return emit;
+}
+
+Emitters FastJIT::compileCondJump(
+    Emitters emit,
+    const Inst *ip,
+    uint32_t ipOffset,
+    uint32_t reg1,
+    uint32_t reg2,
+    CCode cc,
+    const void *slowPathCall) {
+  const uint8_t *slowPathAddr = emit.slow.current();
+
+  emit.fast = isNumber(emit.fast, reg1, slowPathAddr);
+  emit.fast = isNumber(emit.fast, reg2, slowPathAddr);
+  emit = compileCondJumpN(emit, ip, ipOffset, reg1, reg2, cc);
+
+  // The comparison returns a bool HermesValue, which is tested rather than
+  // stored.
+  emit.slow = leaHermesReg(emit.slow, reg1, Reg::x1);
+  emit.slow = leaHermesReg(emit.slow, reg2, Reg::x2);
+  emit.slow = callExternal(emit.slow, slowPathCall, kNoResultReg, ip);
+
+  // The bool is in the low bits of x1. Jump to the target BB if true, and
+  // back to the next instruction otherwise.
+  emit.slow.testLowByte(Reg::x1);
+  emit.slow =
+      cjmpToBytecodeBB(emit.slow, CCode::NE, getBBIndex(ip, ipOffset));
+  emit.slow.b(emit.fast.current());
+  return emit;
+}
+
+Emitters FastJIT::callHelper(
+    Emitters emit,
+    const Inst *ip,
+    uint32_t argCount,
+    bool isConstruct) {
+  // &callable -> arg2
+  emit.fast = leaHermesReg(emit.fast, ip->iCall.op2, Reg::x1);
+  // argCount -> arg3
+  emit.fast.movImmToReg(argCount, Reg::x2);
+  // stack pointer -> arg4
+  emit.fast.ldrRMToReg(RegRuntime, RuntimeOffsets::stackPointer, Reg::x3);
+  // ip -> arg5
+  emit.fast.movImmToReg((uint64_t)ip, Reg::x4);
+  // currentFrame -> arg6
+  emit.fast.movRegToReg(RegFrame, Reg::x5);
+
+  emit.fast = callExternal(
+      emit.fast,
+      isConstruct ? (const void *)externConstruct : (const void *)externCall,
+      ip->iCall.op1,
+      ip);
+  return emit;
+}
+
+Emitters FastJIT::compileLoadParam(Emitters emit, const Inst *ip) {
+  // x0 = undefined, replaced by the parameter if it was passed.
+  emit.fast.movImmToReg(
+      HermesValue::encodeUndefinedValue().getRaw(), Reg::x0);
+  emit.fast.ldrRMToWReg(
+      RegFrame, sizeof(HermesValue) * StackFrameLayout::ArgCount, Reg::x1);
+  emit.fast.movImmToReg(ip->iLoadParam.op2, Reg::x2);
+  emit.fast.cmpWRegToWReg(Reg::x1, Reg::x2);
+  uint8_t *skip = emit.fast.current();
+  emit.fast.bcond(CCode::LO, skip);
+
+  emit.fast.ldrRMToReg(
+      RegFrame,
+      sizeof(HermesValue) * StackFrameLayout::argOffset(ip->iLoadParam.op2 - 1),
+      Reg::x0);
+  Emitter::patchBranch(skip, emit.fast.current(), 19);
+
+  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::x0, ip->iLoadParam.op1);
+  return emit;
+}
+
+Emitters FastJIT::compileLoadConstZero(Emitters emit, const Inst *ip) {
+  emit.fast =
+      movNativeRegToHermesReg(emit.fast, Reg::xzr, ip->iLoadConstZero.op1);
+  return emit;
+}
+
+Emitters FastJIT::compileMov(Emitters emit, const Inst *ip) {
+  emit.fast = movHermesRegToNativeReg(emit.fast, ip->iMov.op2, Reg::x0);
+  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::x0, ip->iMov.op1);
+  return emit;
+}
+
+Emitters FastJIT::compileMovLong(Emitters emit, const Inst *ip) {
+  emit.fast = movHermesRegToNativeReg(emit.fast, ip->iMovLong.op2, Reg::x0);
+  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::x0, ip->iMovLong.op1);
+  return emit;
+}
+
+Emitters FastJIT::compileToNumber(Emitters emit, const Inst *ip) {
+  const uint8_t *slowPathAddr = emit.slow.current();
+
+  // isNumber leaves the value in x16.
+  emit.fast = isNumber(emit.fast, ip->iToNumber.op2, slowPathAddr);
+  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::x16, ip->iToNumber.op1);
+
+  // &Source -> arg2.
+  emit.slow = leaHermesReg(emit.slow, ip->iToNumber.op2, Reg::x1);
+  emit.slow = callExternal(
+      emit.slow, (const void *)slowPathToNumber, ip->iToNumber.op1, ip);
+  emit.slow.b(emit.fast.current());
+  return emit;
+}
+
+Emitters FastJIT::compileGetGlobalObject(Emitters emit, const Inst *ip) {
+  emit.fast.ldrRMToReg(RegRuntime, RuntimeOffsets::globalObject, Reg::x0);
+  emit.fast =
+      movNativeRegToHermesReg(emit.fast, Reg::x0, ip->iGetGlobalObject.op1);
+  return emit;
+}
+
+Emitters FastJIT::compileCall(Emitters emit, const Inst *ip) {
+  return callHelper(emit, ip, ip->iCall.op3, false);
+}
+Emitters FastJIT::compileCallLong(Emitters emit, const Inst *ip) {
+  return callHelper(emit, ip, ip->iCallLong.op3, false);
+}
+Emitters FastJIT::compileConstruct(Emitters emit, const Inst *ip) {
+  return callHelper(emit, ip, ip->iConstruct.op3, true);
+}
+Emitters FastJIT::compileConstructLong(Emitters emit, const Inst *ip) {
+  return callHelper(emit, ip, ip->iConstructLong.op3, true);
+}
+
+Emitters FastJIT::compileRet(Emitters emit, const Inst *ip) {
+  emit.fast = movHermesRegToNativeReg(emit.fast, ip->iRet.op1, Reg::x1);
+  emit.fast.movImmToReg(1, Reg::x0);
+  emit.fast = jmpToBytecodeBB(emit.fast, bcBasicBlocks_.size() - 1);
+  return emit;
+}
+
+Emitters FastJIT::compileJmp(Emitters emit, const Inst *ip, uint32_t ipOffset) {
+  emit.fast = jmpToBytecodeBB(emit.fast, getBBIndex(ip, ipOffset));
+  return emit;
+}
+
+#undef NEXTINST
+
+} // namespace aarch64
+} // namespace vm
+} // namespace hermes
@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_VM_JIT_AARCH64_FASTJIT_H
+#define HERMES_VM_JIT_AARCH64_FASTJIT_H
+
+#include "hermes/BCGen/HBC/StackFrameLayout.h"
+#include "hermes/VM/JIT/aarch64/Emitter.h"
+#include "hermes/VM/JIT/aarch64/JIT.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/Debug.h"
+
+namespace hermes {
+namespace vm {
+
+using hermes::hbc::StackFrameLayout;
+using namespace hermes::inst;
+
+namespace aarch64 {
+
+/// Encodes the kind of operation the relocation performs.
+enum class ReloKind : uint8_t {
+  None = 0,
+  /// An unconditional branch, with a 26-bit instruction count.
+  Branch26,
+  /// A conditional branch, with a 19-bit instruction count.
+  Branch19,
+};
+
+/// Information about a single relocation in the executable code.
+/// A relocation encodes an operation that is applied to the executable code
+/// after a target address becomes known.
+struct Relo {
+  /// What kind of operation the relocation performs.
+  ReloKind kind;
+  /// The branch instruction which is updated when the relocation is applied.
+  uint8_t *address;
+  /// The relocation target, in other words, the address that wasn't yet known
+  /// when the relocation was created.
+  unsigned targetBCBBIndex;
+
+  Relo(ReloKind kind, uint8_t *address, unsigned int targetBCBBIndex)
+      : kind(kind), address(address), targetBCBBIndex(targetBCBBIndex) {}
+  Relo() = default;
+};
+
+/// A pair of emitters for the fast path and the slow path. This class must be
+/// passed and returned only by value (for performance reasons).
+class Emitters {
+ public:
+  Emitter fast;
+  Emitter slow;
+} HERMES_ATTRIBUTE_WARN_UNUSED_RESULT_TYPE;
+
+/// An instance of this class is constructed to compile a single CodeBlock to
+/// native code. The generated code follows the conventions of the x86-64
+/// FastJIT: Hermes registers live in the frame, and the instructions that are
+/// not compiled inline call the helpers of ExternalCalls.h. Only a subset of
+/// the instructions is supported so far. Functions using any other fail to
+/// compile and stay interpreted.
+/// The caller must hold an ExecHeap::WriteAccess while compiling.
+class FastJIT {
+ public:
+  FastJIT(JITContext *context, CodeBlock *codeBlock);
+
+  /// Attempt to compile the associated CodeBlock. On success, the JIT function
+  /// pointer in the CodeBlock will be set to the compiled body.
+  void compile();
+
+  /// \return true if the compilation failed.
+  bool hasError() const {
+    return error_;
+  }
+
+  /// \return the message describing the first error of the compilation.
+  const std::string &getErrorMessage() const {
+    return errorMsg_;
+  }
+
+  /// \return the bytecode offset of the instruction that caused the first
+  /// error of the compilation, or 0 if it wasn't caused by one.
+  uint32_t getErrorOffset() const {
+    return errorOffset_;
+  }
+
+  /// Describe the compiled code to \p perfMap, with the source line of every
+  /// basic block. Only valid after a successful compilation.
+  void addToPerfMap(Runtime *runtime, PerfMap &perfMap) const;
+
+ private:
+  /// The operations of emitNumberBinOp().
+  enum class NumberBinOp { Add, Sub, Mul, Div };
+
+  /// Raise the error flag and record an error message.
+  void error(const llvm::Twine &msg);
+
+  /// Allocate executable memory using a conservative size estimate based on
+  /// bytecode length. On failure it sets the error message and flag.
+  /// \param bytecodeLength the length of the bytecode we will be compiling.
+  /// \param[out] sizes on successful exit contains the size of the two
+  ///     allocated memory blocks (fast paths and slow paths). Undefined on
+  ///     failure.
+  /// \return pointers to both allocated blocks on success.
+  llvm::Optional<ExecHeap::BlockPair> allocBlocks(
+      size_t bytecodeLength,
+      ExecHeap::SizePair &sizes);
+
+  /// Disassemble a range of executable code.
+  /// \param withAddr whether to dump the addresses and bytes of instructions.
+  void disassembleRange(
+      const uint8_t *from,
+      const uint8_t *to,
+      llvm::raw_ostream &OS,
+      bool withAddr) const;
+
+  /// Disassemble the entire compiled function.
+  /// \param withAddr whether to dump the addresses and bytes of instructions.
+  void disassembleResult(Emitters emit, llvm::raw_ostream &OS, bool withAddr)
+      const;
+
+  /// Resolve all recorded relocations and clear the relocation list \c relocs_.
+  /// Set the error flag if a branch can't reach its target.
+  void resolveRelocations();
+
+  /// \return true if we can safely write at least \c kMinInstructionSpace of
+  ///   bytes in the fast and slow path buffers. Set the error flag and message
+  ///   and return false otherwise.
+  inline bool checkSpace(const Emitters &emit);
+
+  /// \return true if \p emit writes into the fast path.
+  bool isFastPath(Emitter emit) const {
+    return emit.current() >= fast_.begin() && emit.current() <= fast_.end();
+  }
+
+  /// \return the offset in bytes from RegFrame to access the specified local
+  ///   Hermes register.
+  static inline int32_t localHermesRegByteOffset(uint32_t regIndex) {
+    return sizeof(HermesValue) * StackFrameLayout::localOffset(regIndex);
+  }
+
+  /// \return the basic block's index according to the current \p ip and
+  /// the offset \p ipOffset.
+  unsigned getBBIndex(const Inst *ip, uint32_t ipOffset) {
+    uint32_t bcOffset = (const uint8_t *)ip + ipOffset - codeBlock_->begin();
+    return bcLabels_[bcOffset];
+  }
+
+  /// \return the index of the basic block handling the exceptions thrown by
+  /// \p ip, which is the epilogue if there is no handler.
+  unsigned getCatchHandlerBBIndex(const Inst *ip);
+
+  /// @name Emitters
+  /// Every emitter function receives Emitters as a first parameter
+  /// and returns it after updating it internally. Emitter function assume that
+  /// checkSpace() has already been called, except where noted.
+  /// @{
+
+  /// Save the callee-saved registers used by the compiled code and load
+  /// RegRuntime from the first parameter.
+  Emitter emitFrameSetup(Emitter emit);
+
+  /// Emit the function prologue. Calls checkSpace() before emitting.
+  Emitters emitPrologue(Emitters emit);
+  /// Emit the function epilogue. Calls checkSpace() before emitting.
+  Emitters emitEpilogue(Emitters emit);
+  /// Emit the on-stack replacement entry in the slow path. It has the
+  /// signature of JITOSREntryPtr and, unlike the prologue, reuses the
+  /// registers of the interpreter frame that is already on top of the stack.
+  /// Calls checkSpace() before emitting.
+  Emitters emitOSREntry(Emitters emit);
+
+  /// Emit the code for a basic block. Calls checkSpace() before processing
+  /// every bytecode instruction.
+  Emitters compileBB(Emitters emit);
+
+  /// Load the Hermes register \p hermesReg into \p nativeReg.
+  Emitter
+  movHermesRegToNativeReg(Emitter emit, uint32_t hermesReg, Reg nativeReg);
+  /// Store \p nativeReg into the Hermes register \p hermesReg.
+  Emitter
+  movNativeRegToHermesReg(Emitter emit, Reg nativeReg, uint32_t hermesReg);
+  /// Load the number in \p hermesReg into \p nativeReg.
+  Emitter
+  movHermesRegToFPReg(Emitter emit, uint32_t hermesReg, FReg nativeReg);
+  /// Load the address of \p hermesReg into \p nativeReg.
+  Emitter leaHermesReg(Emitter emit, uint32_t hermesReg, Reg nativeReg);
+
+  /// Load the HermesValue \p value into the Hermes register \p hermesReg.
+  Emitter
+  loadHermesValueConstant(Emitter emit, uint32_t hermesReg, HermesValue value);
+
+  /// Call the external function \p dest with RegRuntime as the first
+  /// parameter and the other parameters already in x1-x7. It returns a
+  /// CallResult<HermesValue>: on an exception, jump to the handler of \p ip,
+  /// and otherwise store the value into \p resultReg, unless it is
+  /// kNoResultReg.
+  Emitter callExternal(
+      Emitter emit,
+      const void *dest,
+      uint32_t resultReg,
+      const Inst *ip);
+
+  /// Jump to the slow path at \p slowPathAddr unless the Hermes register
+  /// \p hermesReg contains a number.
+  Emitter
+  isNumber(Emitter emit, uint32_t hermesReg, const uint8_t *slowPathAddr);
+
+  /// Emit a jump to a bytecode block.
+  Emitter jmpToBytecodeBB(Emitter emit, unsigned bytecodeBB);
+
+  /// Emit a conditional jump to a bytecode block.
+  Emitter cjmpToBytecodeBB(Emitter emit, CCode cc, unsigned bytecodeBB);
+
+  /// Emit the operation \p op of the N arithmetic instruction \p ip on the
+  /// numbers in its operands.
+  Emitter emitNumberBinOp(Emitter emit, const Inst *ip, NumberBinOp op);
+
+  /// Compile the arithmetic instruction \p ip, with the layout of Add, inline
+  /// for numbers and by calling \p slowPathBinOp otherwise.
+  Emitters compileBinOp(
+      Emitters emit,
+      const Inst *ip,
+      const void *slowPathBinOp,
+      NumberBinOp op);
+
+  /// Compile a comparison jump of two numbers, jumping if \p cc holds after
+  /// comparing them.
+  Emitters compileCondJumpN(
+      Emitters emit,
+      const Inst *ip,
+      uint32_t ipOffset,
+      uint32_t reg1,
+      uint32_t reg2,
+      CCode cc);
+
+  /// Compile a comparison jump, inline for numbers and by calling
+  /// \p slowPathCall otherwise.
+  Emitters compileCondJump(
+      Emitters emit,
+      const Inst *ip,
+      uint32_t ipOffset,
+      uint32_t reg1,
+      uint32_t reg2,
+      CCode cc,
+      const void *slowPathCall);
+
+  /// Compile a call or a construct of \p argCount arguments, including
+  /// "this".
+  Emitters callHelper(
+      Emitters emit,
+      const Inst *ip,
+      uint32_t argCount,
+      bool isConstruct);
+
+  Emitters compileLoadParam(Emitters emit, const Inst *ip);
+  Emitters compileLoadConstZero(Emitters emit, const Inst *ip);
+  Emitters compileMov(Emitters emit, const Inst *ip);
+  Emitters compileMovLong(Emitters emit, const Inst *ip);
+  Emitters compileToNumber(Emitters emit, const Inst *ip);
+  Emitters compileGetGlobalObject(Emitters emit, const Inst *ip);
+  Emitters compileCall(Emitters emit, const Inst *ip);
+  Emitters compileCallLong(Emitters emit, const Inst *ip);
+  Emitters compileConstruct(Emitters emit, const Inst *ip);
+  Emitters compileConstructLong(Emitters emit, const Inst *ip);
+  Emitters compileRet(Emitters emit, const Inst *ip);
+  Emitters compileJmp(Emitters emit, const Inst *ip, uint32_t ipOffset);
+
+  /// @}
+
+ private:
+  /// The JITContect we are associated with.
+  JITContext *const context_;
+  /// The CodeBlock we are compiling.
+  CodeBlock *const codeBlock_;
+
+  /// Minimum number of instruction buffer space we need available at any
+  /// point.
+  static constexpr unsigned kMinInstructionSpace = 1024;
+
+  /// Passed as the result register of callExternal() when the value returned
+  /// by the call is not stored.
+  static constexpr uint32_t kNoResultReg = ~0u;
+
+  /// The starting offset of every bytecode basic block in order. The last
+  /// entry is the end of the bytecode.
+  std::vector<uint32_t> bcBasicBlocks_{};
+
+  /// Map from a bytecode target label offset to a basic block index.
+  llvm::DenseMap<uint32_t, unsigned> bcLabels_{};
+
+  /// The native code offset of every compiled bc BB.
+  std::vector<uint8_t *> nativeBBAddress_{};
+
+  /// Relocations.
+  std::vector<Relo> relocs_{};
+
+  /// Index of the bytecode basic block (in \c bcBasicBlocks_) that we are
+  /// currently compiling.
+  unsigned curBytecodeBBIndex_ = 0;
+
+  /// Set if an error occurred.
+  bool error_ = false;
+  /// Optional error message, set the first time we record an error.
+  std::string errorMsg_{};
+  /// Bytecode offset of the instruction that caused the first error.
+  uint32_t errorOffset_ = 0;
+
+  // The fast-path execution region.
+  llvm::MutableArrayRef<uint8_t> fast_;
+  // The slow-path execution region.
+  llvm::MutableArrayRef<uint8_t> slow_;
+};
+
+inline bool FastJIT::checkSpace(const Emitters &emit) {
+  if (LLVM_UNLIKELY(fast_.end() - emit.fast.current() < kMinInstructionSpace)) {
+    error("fast-path overflow");
+    return false;
+  }
+  if (LLVM_UNLIKELY(slow_.end() - emit.slow.current() < kMinInstructionSpace)) {
+    error("slow-path overflow");
+    return false;
+  }
+  return true;
+}
+
+/// Callee-save register pointing to "Runtime" throughout the function.
+constexpr auto RegRuntime = Reg::x19;
+/// Callee-save register pointing to the first local Hermes register.
+constexpr auto RegFrame = Reg::x20;
+/// Callee-save register holding the smallest HermesValue which is not a
+/// number, see isNumber().
+constexpr auto RegFirstTag = Reg::x21;
+/// Callee-save register holding the caller's runtime->currentFrame_, restored
+/// by the epilogue.
+constexpr auto RegSavedFrame = Reg::x22;
+
+} // namespace aarch64
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_JIT_AARCH64_FASTJIT_H
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/JIT/aarch64/JIT.h"
+
+#include "FastJIT.h"
+
+#include "hermes/VM/Profiler/ExecutionTracer.h"
+#include "hermes/VM/StackFrame-inline.h"
+
+#include "llvm/ADT/DenseSet.h"
+
+#include "llvm/Support/raw_ostream.h"
+
+namespace hermes {
+namespace vm {
+namespace aarch64 {
+
+JITContext::JITContext(
+    bool enable,
+    size_t blockSize,
+    size_t maxMemory,
+    uint32_t threshold)
+    : enabled_(enable),
+      heap_(blockSize / 2, blockSize / 2, maxMemory, true),
+      threshold_(threshold) {}
+
+JITContext::~JITContext() = default;
+
+JITCompiledFunctionPtr JITContext::compileImpl(
+    Runtime *runtime,
+    CodeBlock *codeBlock) {
+  FastJIT impl{this, codeBlock};
+  {
+    ExecHeap::WriteAccess access{heap_};
+    impl.compile();
+  }
+  if (LLVM_UNLIKELY(perfMap_) && !impl.hasError())
+    impl.addToPerfMap(runtime, *perfMap_);
+  if (LLVM_UNLIKELY(reportBailouts_) && impl.hasError()) {
+    std::string name;
+    codeBlock->getNameString(runtime, name);
+    llvm::errs() << "JIT bailout in FunctionID " << codeBlock->getFunctionID()
+                 << " (" << name << "): " << impl.getErrorMessage() << "\n";
+  }
+  if (LLVM_UNLIKELY(runtime->getExecutionTracer()) && impl.hasError()) {
+    runtime->getExecutionTracer()->recordJITBailout(
+        codeBlock, impl.getErrorOffset(), impl.getErrorMessage());
+  }
+  return codeBlock->getJITCompiled();
+}
+
+InterpreterTrampolinePtr JITContext::getInterpreterTrampoline(
+    Runtime *runtime,
+    CodeBlock *codeBlock,
+    InterpreterTrampolinePtr target) {
+  InterpreterTrampolinePtr &trampoline = trampolines_[codeBlock];
+  if (trampoline)
+    return trampoline;
+
+  // A frame of its own, so that perf walking the frame pointers sees the
+  // trampoline as the caller of the interpreter. The arguments and the result
+  // registers are passed through untouched.
+  static const uint32_t kCode[] = {
+      0xA9BF7BFD, // stp x29, x30, [sp, #-16]!
+      0x910003FD, // mov x29, sp
+      0x58000090, // ldr x16, #16
+      0xD63F0200, // blr x16
+      0xA8C17BFD, // ldp x29, x30, [sp], #16
+      0xD65F03C0, // ret
+      // The address of the target follows.
+  };
+  constexpr size_t kTrampolineSize = 32;
+  static_assert(
+      sizeof(kCode) + sizeof(target) <= kTrampolineSize,
+      "trampoline doesn't fit");
+
+  uint8_t *code;
+  if (!freeTrampolines_.empty()) {
+    code = freeTrampolines_.back();
+    freeTrampolines_.pop_back();
+  } else if (trampolineEnd_ - trampolineCur_ < (ptrdiff_t)kTrampolineSize) {
+    constexpr size_t kChunkSize = 4096;
+    auto blocks = heap_.alloc({kChunkSize, 0});
+    if (!blocks) {
+      auto *pool = heap_.addPool();
+      if (!pool || !(blocks = pool->alloc({kChunkSize, 0})))
+        return nullptr;
+    }
+    code = blocks->first;
+    trampolineCur_ = blocks->first + kTrampolineSize;
+    trampolineEnd_ = blocks->first + kChunkSize;
+  } else {
+    code = trampolineCur_;
+    trampolineCur_ += kTrampolineSize;
+  }
+  {
+    // Ending the access invalidates the instruction cache.
+    ExecHeap::WriteAccess access{heap_};
+    memcpy(code, kCode, sizeof(kCode));
+    memcpy(code + sizeof(kCode), &target, sizeof(target));
+  }
+  trampoline = reinterpret_cast<InterpreterTrampolinePtr>(code);
+
+  if (perfMap_) {
+    std::string filename;
+    perfMap_->addCode(
+        code,
+        kTrampolineSize,
+        "JS:" + getPerfName(runtime, codeBlock, filename));
+  }
+  return trampoline;
+}
+
+size_t JITContext::evictInactive(Runtime *runtime) {
+  // Compiled code calls other functions through their CodeBlock, never
+  // directly, so only the frames on the stack refer to it.
+  llvm::DenseSet<const CodeBlock *> active{};
+  for (StackFramePtr frame : runtime->getStackFrames()) {
+    active.insert(frame.getCalleeCodeBlock());
+    active.insert(frame.getSavedCodeBlock());
+  }
+
+  size_t freed = 0;
+  for (RuntimeModule &rm : runtime->getRuntimeModules()) {
+    for (unsigned i = 0, e = rm.getNumCodeBlocks(); i != e; ++i) {
+      CodeBlock *codeBlock = rm.getCodeBlockIfCreated(i);
+      // Lazy modules also map CodeBlocks owned by other modules.
+      if (!codeBlock || codeBlock->getRuntimeModule() != &rm ||
+          active.count(codeBlock))
+        continue;
+      freed += freeCompiledCode(codeBlock);
+    }
+  }
+  return freed;
+}
+
+void JITContext::freeCode(CodeBlock *codeBlock) {
+  freeCompiledCode(codeBlock);
+  auto it = trampolines_.find(codeBlock);
+  if (it != trampolines_.end()) {
+    freeTrampolines_.push_back(reinterpret_cast<uint8_t *>(it->second));
+    trampolines_.erase(it);
+  }
+}
+
+size_t JITContext::freeCompiledCode(CodeBlock *codeBlock) {
+  if (!codeBlock->getJITCompiled())
+    return 0;
+  size_t size = codeBlock->getJITCodeSize();
+  heap_.free(
+      {reinterpret_cast<uint8_t *>(codeBlock->getJITCompiled()),
+       codeBlock->getJITSlowPaths()});
+  codeBlock->clearJITCompiled();
+  return size;
+}
+
+} // namespace aarch64
+} // namespace vm
+} // namespace hermes
@@ -7,11 +7,13 @@
 #include "FastJIT.h"
 
 #include "../ExternalCalls.h"
-#include "RuntimeOffsets.h"
+#include "../RuntimeOffsets.h"
 #include "hermes/Inst/InstDecode.h"
 #include "hermes/VM/JIT/DiscoverBB.h"
 #include "hermes/VM/Operations.h"
 
+#include <algorithm>
+
 #define DEBUG_TYPE "jit"
 
 namespace hermes {
@@ -37,9 +39,14 @@ static constexpr uint32_t NullTagHW =
     ((uint32_t)NullTag << (HermesValue::kNumDataBits - 32));
 static constexpr uint32_t BoolTagHW =
     ((uint32_t)BoolTag << (HermesValue::kNumDataBits - 32));
+/// A HermesValue is a pointer if its higher 32 bits are at least this value.
+static constexpr uint32_t FirstPointerTagHW =
+    ((uint32_t)FirstPointerTag << (HermesValue::kNumDataBits - 32));
 
 FastJIT::FastJIT(JITContext *context, CodeBlock *codeBlock)
-    : context_(context), codeBlock_(codeBlock) {}
+    : context_(context), codeBlock_(codeBlock) {
+  clearFPRegCache();
+}
 
 void FastJIT::compile() {
   LLVM_DEBUG(
@@ -81,6 +88,10 @@ void FastJIT::compile() {
   nativeBBAddress_[curBytecodeBBIndex_] = emit.fast.current();
   emit = emitEpilogue(emit);
 
+  // Emit the on-stack replacement entry in the slow path.
+  const uint8_t *osrEntry = emit.slow.current();
+  emit = emitOSREntry(emit);
+
   resolveRelocations();
 
   LLVM_DEBUG(disassembleResult(emit, llvm::dbgs(), true));
@@ -92,7 +103,18 @@ void FastJIT::compile() {
         *blocks,
         {emit.fast.current() - fast_.data(),
          emit.slow.current() - slow_.data()});
+    fast_ = fast_.take_front(emit.fast.current() - fast_.data());
+    slow_ = slow_.take_front(emit.slow.current() - slow_.data());
     codeBlock_->setJITCompiled((JITCompiledFunctionPtr)fast_.data());
+    codeBlock_->setJITCodeBlocks(slow_.data(), fast_.size() + slow_.size());
+
+    // Every basic block can be entered from the interpreter, since any jump
+    // target starts a block.
+    std::vector<std::pair<uint32_t, const void *>> osrTargets{};
+    osrTargets.reserve(bcBasicBlocksCount);
+    for (unsigned i = 0; i != bcBasicBlocksCount; ++i)
+      osrTargets.emplace_back(bcBasicBlocks_[i], nativeBBAddress_[i]);
+    codeBlock_->setJITOSREntry((JITOSREntryPtr)osrEntry, std::move(osrTargets));
 
     // Dump the heap at the end.
     LLVM_DEBUG(context_->getHeap().dump(llvm::dbgs()));
@@ -104,6 +126,29 @@ void FastJIT::compile() {
   }
 }
 
+void FastJIT::addToPerfMap(Runtime *runtime, PerfMap &perfMap) const {
+  std::string filename;
+  std::string name = "JIT:" + getPerfName(runtime, codeBlock_, filename);
+
+  std::vector<PerfMap::LineEntry> lines;
+  auto debugOffset = codeBlock_->getDebugSourceLocationsOffset();
+  if (debugOffset.hasValue()) {
+    auto *debugInfo =
+        codeBlock_->getRuntimeModule()->getBytecode()->getDebugInfo();
+    // The last basic block is the epilogue.
+    for (size_t i = 0, e = bcBasicBlocks_.size() - 1; i != e; ++i) {
+      auto loc = debugInfo->getLocationForAddress(
+          debugOffset.getValue(), bcBasicBlocks_[i]);
+      if (loc.hasValue())
+        lines.push_back({nativeBBAddress_[i], loc.getValue().line});
+    }
+  }
+
+  perfMap.addCode(fast_.data(), fast_.size(), name, filename, lines);
+  if (!slow_.empty())
+    perfMap.addCode(slow_.data(), slow_.size(), name + " [slow]");
+}
+
 void FastJIT::error(const llvm::Twine &msg) {
   if (!error_)
     codeBlock_->setDontJIT(true);
@@ -296,6 +341,36 @@ Emitters FastJIT::emitEpilogue(Emitters emit) {
   return emit;
 }
 
+Emitters FastJIT::emitOSREntry(Emitters emit) {
+  if (!checkSpace(emit))
+    return emit;
+
+  // Build the same native frame as the prologue, so the regular epilogue can
+  // tear it down.
+  emit.slow.pushqReg(Reg::rbp);
+  emit.slow.movRegToReg<S::Q>(Reg::rsp, Reg::rbp);
+
+  emit.slow.pushqReg(RegFrame);
+  emit.slow.pushqReg(RegRuntime);
+  emit.slow.movRegToReg<S::Q>(Reg::rdi, RegRuntime);
+
+  // The interpreter frame stays the current frame, so the epilogue restores
+  // it rather than the caller's. The interpreter pops it after we return.
+  emit.slow.pushqRM(RegRuntime, Reg::NoIndex, RuntimeOffsets::currentFrame);
+  emit.slow.pushqReg(Reg::rcx);
+
+  // The registers of the frame were already allocated and initialized by the
+  // interpreter, so just point RegFrame to them.
+  emit.slow.movRMToReg<S::Q>(
+      RegRuntime, Reg::NoIndex, RuntimeOffsets::currentFrame, RegFrame);
+
+  // Jump to the basic block passed as the second parameter.
+  emit.slow.jmpReg(Reg::rsi);
+
+  describeSlowPathSection(emit.slow, false);
+  return emit;
+}
+
 // Calculate the address of the next instruction given the name of the current
 // one.
 #define NEXTINST(name) ((const Inst *)(&ip->i##name + 1))
@@ -306,6 +381,9 @@ Emitters FastJIT::compileBB(Emitters emit) {
   auto *to = reinterpret_cast<const Inst *>(
       codeBlock_->begin() + bcBasicBlocks_[curBytecodeBBIndex_ + 1]);
 
+  // Control may arrive from other blocks.
+  clearFPRegCache();
+
   while (ip != to) {
     if (!checkSpace(emit))
       return emit;
@@ -315,7 +393,10 @@ Emitters FastJIT::compileBB(Emitters emit) {
     auto sav = emit;
 #endif
 
-    switch (ip->opCode) {
+    // Quickened instructions have the same layout and semantics as the
+    // instructions they were quickened from.
+    const OpCode opCode = getUnquickenedOpCode(ip->opCode);
+    switch (opCode) {
 #define CASE(name)                  \
   case OpCode::name:                \
     emit = compile##name(emit, ip); \
@@ -457,6 +538,14 @@ Emitters FastJIT::compileBB(Emitters emit) {
     ip = NEXTINST(name);                                     \
     break
 
+/// Implement a bitwise or shift instruction with an inline int32 fast path.
+#define BITWISE_OP(name, op)                                             \
+  case OpCode::name:                                                     \
+    emit = compileBitwiseOp(                                             \
+        emit, ip, (void *)extern##name, FastJIT::BitwiseOp::op);         \
+    ip = NEXTINST(name);                                                 \
+    break
+
       CASE(DeclareGlobalVar);
       CASE(CreateEnvironment);
       CASE(CreateClosure);
@@ -487,6 +576,7 @@ Emitters FastJIT::compileBB(Emitters emit) {
       BINOP(Div);
       CASE(DivN);
       CASE(TypeOf);
+      CASE(TypeOfIs);
       CASE(Mov);
       CASE(MovLong);
       CASE(ToNumber);
@@ -550,6 +640,10 @@ Emitters FastJIT::compileBB(Emitters emit) {
       CASE_WITH_SUFFIX(PutNewOwnById, , op3);
       CASE_WITH_SUFFIX(PutNewOwnById, Short, op3);
       CASE_WITH_SUFFIX(PutNewOwnById, Long, op3);
+      CASE_WITH_SUFFIX(PutOwnBySlotIdx, , op3);
+      CASE_WITH_SUFFIX(PutOwnBySlotIdx, Long, op3);
+      CASE_WITH_SUFFIX(PutOwnNPBySlotIdx, , op3);
+      CASE_WITH_SUFFIX(PutOwnNPBySlotIdx, Long, op3);
       CASE(LoadThisNS);
       CASE(CoerceThisNS);
       CASE(Throw);
@@ -557,6 +651,17 @@ Emitters FastJIT::compileBB(Emitters emit) {
       CASE(NewObjectWithBufferLong);
       CASE_3REG(GetByVal);
       CASE(PutByVal);
+      // The extern calls check array indices cheaply enough, so the variants
+      // with a proven index are compiled like the generic instructions,
+      // whose layout they share.
+      case OpCode::GetByValIndex:
+        emit = compile3RegsInst(emit, ip, (void *)externGetByVal);
+        ip = NEXTINST(GetByValIndex);
+        break;
+      case OpCode::PutByValIndex:
+        emit = compilePutByVal(emit, ip);
+        ip = NEXTINST(PutByValIndex);
+        break;
       CASE(DelByVal);
       CASE(StoreToEnvironment);
       CASE(StoreToEnvironmentL);
@@ -566,36 +671,43 @@ Emitters FastJIT::compileBB(Emitters emit) {
       CASE_WITH_SUFFIX(LoadFromEnvironment, L, op3);
       CASE_3REG(Mod);
       CASE(Not);
-      CASE_3REG(LShift);
-      CASE_3REG(RShift);
-      CASE_3REG(URshift);
-      CASE_3REG(BitAnd);
-      CASE_3REG(BitOr);
-      CASE_3REG(BitXor);
+      BITWISE_OP(LShift, LShift);
+      BITWISE_OP(RShift, RShift);
+      BITWISE_OP(URshift, URshift);
+      BITWISE_OP(BitAnd, And);
+      BITWISE_OP(BitOr, Or);
+      BITWISE_OP(BitXor, Xor);
       CASE(GetEnvironment);
       CASE(Catch);
       CASE(Negate);
       CASE(GetPNameList);
       CASE(GetNextPName);
+      CASE(IteratorBegin);
+      CASE(IteratorNext);
+      CASE(IteratorClose);
       CASE(ReifyArguments);
       CASE(GetArgumentsPropByVal);
       CASE(BitNot);
       CASE(GetArgumentsLength);
       CASE_3REG(IsIn);
+      // The property cache index of InstanceOf is only used by the
+      // interpreter.
       CASE_3REG(InstanceOf);
       CASE(CreateRegExp);
 
       default:
+        if (!error_)
+          errorOffset_ = codeBlock_->getOffsetOf(ip);
         error(
-            llvm::Twine("unsupported opcode ") + llvm::Twine((int)ip->opCode)
-#ifndef NDEBUG
-            + " " + getOpCodeString(ip->opCode)
-#endif
-        );
+            llvm::Twine("unsupported opcode ") + llvm::Twine((int)ip->opCode) +
+            " " + getOpCodeString(ip->opCode));
         return emit;
     }
 #undef CASE
 
+    if (!preservesFPRegCache(opCode))
+      clearFPRegCache();
+
     LLVM_DEBUG(
         disassembleRange(
             sav.fast.current(), emit.fast.current(), llvm::dbgs(), true);
@@ -610,6 +722,81 @@ Emitters FastJIT::compileBB(Emitters emit) {
   return emit;
 }
 
+bool FastJIT::preservesFPRegCache(OpCode opCode) {
+  switch (opCode) {
+    case OpCode::AddN:
+    case OpCode::SubN:
+    case OpCode::MulN:
+    case OpCode::DivN:
+    case OpCode::Mov:
+    case OpCode::MovLong:
+    case OpCode::LoadConstZero:
+    case OpCode::LoadConstInt:
+    case OpCode::LoadConstUInt8:
+    case OpCode::LoadConstDouble:
+    case OpCode::LoadConstUndefined:
+    case OpCode::LoadConstTrue:
+    case OpCode::LoadConstFalse:
+    case OpCode::LoadConstNull:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void FastJIT::clearFPRegCache() {
+  std::fill(
+      std::begin(cachedFPRegs_), std::end(cachedFPRegs_), kNoCachedHermesReg);
+}
+
+Reg FastJIT::findCachedFPReg(uint32_t hermesReg) const {
+  for (unsigned i = 0; i < kNumCachedFPRegs; ++i) {
+    if (cachedFPRegs_[i] == hermesReg)
+      return static_cast<Reg>(kFirstCachedFPReg + i);
+  }
+  return Reg::none;
+}
+
+void FastJIT::forgetCachedFPReg(uint32_t hermesReg) {
+  for (auto &cached : cachedFPRegs_) {
+    if (cached == hermesReg)
+      cached = kNoCachedHermesReg;
+  }
+}
+
+Reg FastJIT::allocCachedFPReg(uint32_t hermesReg, Reg keep) {
+  Reg reg = findCachedFPReg(hermesReg);
+  if (reg != Reg::none)
+    return reg;
+  unsigned index = kNumCachedFPRegs;
+  for (unsigned i = 0; i < kNumCachedFPRegs; ++i) {
+    if (cachedFPRegs_[i] == kNoCachedHermesReg) {
+      index = i;
+      break;
+    }
+  }
+  if (index == kNumCachedFPRegs) {
+    index = nextFPRegVictim_;
+    if (static_cast<Reg>(kFirstCachedFPReg + index) == keep)
+      index = (index + 1) % kNumCachedFPRegs;
+    nextFPRegVictim_ = (index + 1) % kNumCachedFPRegs;
+  }
+  cachedFPRegs_[index] = hermesReg;
+  return static_cast<Reg>(kFirstCachedFPReg + index);
+}
+
+Emitter FastJIT::loadNumberIntoFPReg(
+    Emitter emit,
+    OperandReg32 hermesReg,
+    Reg nativeReg) {
+  Reg cached = findCachedFPReg(hermesReg);
+  if (cached == Reg::none)
+    return movHermesRegToNativeReg<true>(emit, hermesReg, nativeReg);
+  if (cached != nativeReg)
+    emit.movfpRegToReg(cached, nativeReg);
+  return emit;
+}
+
 Emitter FastJIT::getConstant(Emitter slow, uint64_t cval, uint8_t *&constAddr) {
   // Find or emit the actual constant as a number.
   auto it = doubleConstants_.find(cval);
@@ -666,6 +853,7 @@ Emitters FastJIT::loadDoubleConstant(
   emit = loadConstantIntoNativeReg(
       emit, HermesValue::encodeDoubleValue(value), Reg::rax);
   emit.fast = movNativeRegToHermesReg(emit.fast, Reg::rax, hermesReg);
+  forgetCachedFPReg(hermesReg);
   return emit;
 }
 Emitters FastJIT::loadHermesValueConstant(
@@ -674,6 +862,7 @@ Emitters FastJIT::loadHermesValueConstant(
     HermesValue value) {
   emit = loadConstantIntoNativeReg(emit, value, Reg::rax);
   emit.fast = movNativeRegToHermesReg(emit.fast, Reg::rax, hermesReg);
+  forgetCachedFPReg(hermesReg);
   return emit;
 }
 
@@ -735,6 +924,17 @@ Emitters FastJIT::compileTypeOf(Emitters emit, const Inst *ip) {
   return emit;
 }
 
+Emitters FastJIT::compileTypeOfIs(Emitters emit, const Inst *ip) {
+  emit.fast = leaHermesReg(emit.fast, ip->iTypeOfIs.op2, Reg::rsi);
+  emit.fast.movImmToReg<S::L>(ip->iTypeOfIs.op3, Reg::edx);
+
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, (void *)externTypeOfIs, constAddr);
+  emit.fast =
+      callExternalWithReturnedVal(emit.fast, constAddr, ip->iTypeOfIs.op1);
+  return emit;
+}
+
 inline Emitter FastJIT::callAbsolute(Emitter emit, const void *dest) {
   emit.movqImmToReg((uint64_t)dest, Reg::rax);
   emit.callReg(Reg::rax);
@@ -927,8 +1127,180 @@ FastJIT::compileCondOpN(Emitters emit, const Inst *ip, uint8_t opCode) {
   return emit;
 }
 
-inline Emitters FastJIT::getByIdHelper(
-    Emitters emit,
+Emitter FastJIT::clearObjectTag(Emitter emit, Reg reg, Reg scratch) {
+  emit.movqImmToReg((uint64_t)ObjectTag << HermesValue::kNumDataBits, scratch);
+  emit.xorRegToReg<S::Q>(scratch, reg);
+  return emit;
+}
+
+inline bool FastJIT::canInlinePropertyCache(uint8_t cacheIdx) const {
+#ifdef HERMESVM_COMPRESSED_POINTERS
+  // The class of an object is stored compressed, and would need to be
+  // decompressed before it can be compared with the cache entry.
+  return false;
+#else
+  return cacheIdx != hbc::PROPERTY_CACHING_DISABLED;
+#endif
+}
+
+Emitter FastJIT::emitPropertyCacheCheck(
+    Emitter emit,
+    OperandReg32 objReg,
+    const PropertyCacheEntry *cacheEntry,
+    const uint8_t *missAddr) {
+  // rcx = objReg, rax = its tag.
+  emit = movHermesRegToNativeReg(emit, objReg, Reg::rcx);
+  emit.movRegToReg<S::Q>(Reg::rcx, Reg::rax);
+  emit.shrImm8ToReg(HermesValue::kNumDataBits, Reg::rax);
+  emit.cmpImmToRM<S::L, ScaleRegAccess>(ObjectTag, Reg::eax, Reg::none, 0);
+  emit.cjump<CCode::NE, OffsetType::Int32>(missAddr);
+
+  // Clear the tag to obtain the JSObject pointer in rcx.
+  emit = clearObjectTag(emit, Reg::rcx, Reg::rax);
+
+  // Compare the class of the object with the class of a monomorphic entry.
+  // Extended entries hold a pointer that never matches, and go to missAddr.
+  emit.movqImmToReg((uint64_t)cacheEntry, Reg::rdx);
+  emit.movRMToReg<S::Q>(
+      Reg::rcx, Reg::NoIndex, RuntimeOffsets::objectClass, Reg::rax);
+  emit.xorRmToReg<S::Q>(
+      Reg::rdx, Reg::NoIndex, offsetof(PropertyCacheEntry, clazz), Reg::rax);
+  emit.cjump<CCode::NE, OffsetType::Int32>(missAddr);
+
+  // Only slots stored directly in the object are accessed inline.
+  emit.movRMToReg<S::L>(
+      Reg::rdx, Reg::NoIndex, offsetof(PropertyCacheEntry, slot), Reg::eax);
+  emit.cmpImmToRM<S::L, ScaleRegAccess>(
+      JSObject::DIRECT_PROPERTY_SLOTS, Reg::eax, Reg::none, 0);
+  emit.cjump<CCode::AE, OffsetType::Int32>(missAddr);
+  return emit;
+}
+
+constexpr bool FastJIT::canInlineWriteBarrier() {
+#ifdef HERMESVM_GC_NONCONTIG_GENERATIONAL
+  return true;
+#else
+  return false;
+#endif
+}
+
+Emitter FastJIT::emitWriteBarrier(Emitter emit, Reg locReg, Reg valueReg) {
+#ifdef HERMESVM_GC_NONCONTIG_GENERATIONAL
+  // Sign extended to 64 bits by the instructions that use it.
+  constexpr int32_t kSegmentMask = ~(int32_t)(AlignedStorage::size() - 1);
+
+  // Values which are not pointers need no barrier.
+  emit.movRegToReg<S::Q>(valueReg, Reg::r8);
+  emit.shrImm8ToReg(32, Reg::r8);
+  emit.cmpImmToRM<S::L, ScaleRegAccess>(
+      FirstPointerTagHW, Reg::r8d, Reg::none, 0);
+  emit.cjump<CCode::B, OffsetType::Int8>(emit.current());
+  Relo reloNotPointer{ReloKind::Int8, emit.current() - 1, 0};
+
+  // r8 = the pointer. Nothing to do if it is in the same segment as the
+  // location.
+  emit.movqImmToReg(HermesValue::kDataMask, Reg::r8);
+  emit.andRegToReg<S::Q>(valueReg, Reg::r8);
+  emit.movRegToReg<S::Q>(locReg, Reg::r9);
+  emit.xorRegToReg<S::Q>(Reg::r8, Reg::r9);
+  emit.shrImm8ToReg(AlignedStorage::kLogSize, Reg::r9);
+  emit.cjump<CCode::E, OffsetType::Int8>(emit.current());
+  Relo reloSameSegment{ReloKind::Int8, emit.current() - 1, 0};
+
+  // Nothing to do either if the pointer is not into the young generation.
+  emit.andImmToReg<S::SLQ>(kSegmentMask, Reg::r8);
+  emit.cmpRegToRM<S::Q>(
+      Reg::r8, RegRuntime, Reg::NoIndex, RuntimeOffsets::youngGenLowLim);
+  emit.cjump<CCode::NE, OffsetType::Int8>(emit.current());
+  Relo reloNotYoung{ReloKind::Int8, emit.current() - 1, 0};
+
+  // Dirty the card covering the location, and its summary entry.
+  // r8 = the start of the segment of the location, r9 = the card index.
+  emit.movRegToReg<S::Q>(locReg, Reg::r8);
+  emit.andImmToReg<S::SLQ>(kSegmentMask, Reg::r8);
+  emit.movRegToReg<S::Q>(locReg, Reg::r9);
+  emit.andImmToReg<S::SLQ>(~kSegmentMask, Reg::r9);
+  emit.shrImm8ToReg(CardTable::kLogCardSize, Reg::r9);
+  emit.movImmToRM<S::B, 1>(1, Reg::r8, Reg::r9, RuntimeOffsets::segmentCards);
+  emit.shrImm8ToReg(CardTable::kLogCardsPerSummary, Reg::r9);
+  emit.movImmToRM<S::B, 1>(
+      1, Reg::r8, Reg::r9, RuntimeOffsets::segmentCardSummary);
+
+  applyRelocation(reloNotPointer, emit.current());
+  applyRelocation(reloSameSegment, emit.current());
+  applyRelocation(reloNotYoung, emit.current());
+#else
+  llvm_unreachable("Inline write barriers are not supported by this GC");
+#endif
+  return emit;
+}
+
+constexpr bool FastJIT::canInlineAlloc() {
+#if defined(HERMESVM_GC_NONCONTIG_GENERATIONAL) && defined(NDEBUG) &&  \
+    !defined(HERMESVM_GCCELL_ID) && !defined(HERMESVM_MEMORY_PROFILER) && \
+    !defined(HERMESVM_SANITIZE_HANDLES) &&                               \
+    !defined(HERMESVM_COMPRESSED_POINTERS) &&                            \
+    !defined(HERMESVM_GC_GENERATIONAL_MARKSWEEPCOMPACT)
+  // Only then is allocation a plain bump of the young generation's segment
+  // level, and a cell header nothing but its vtable. With
+  // HERMESVM_GC_GENERATIONAL_MARKSWEEPCOMPACT, GenGC::alloc() allocates
+  // directly in the old generation instead.
+  return true;
+#else
+  return false;
+#endif
+}
+
+Emitter FastJIT::emitInlineAlloc(
+    Emitter emit,
+    uint32_t size,
+    const uint8_t *slowPathAddr) {
+#ifdef HERMESVM_GC_NONCONTIG_GENERATIONAL
+  size = heapAlignSize(size);
+
+  // rax = level, rdx = level + size. Take the slow path if it is past the
+  // effective end of the segment.
+  emit.movRMToReg<S::Q>(
+      RegRuntime, Reg::NoIndex, RuntimeOffsets::allocLevel, Reg::rax);
+  emit.leaRMToReg<S::Q>(Reg::rax, Reg::NoIndex, size, Reg::rdx);
+  emit.cmpRegToRM<S::Q>(
+      Reg::rdx, RegRuntime, Reg::NoIndex, RuntimeOffsets::allocEnd);
+  emit.cjump<CCode::B, OffsetType::Int32>(slowPathAddr);
+
+  // Allocations in a pretenuring scope go to the old generation, and the
+  // allocation that triggers a sample must be recorded by the runtime.
+  emit.cmpImmToRM<S::B>(0, RegRuntime, Reg::NoIndex, RuntimeOffsets::pretenure);
+  emit.cjump<CCode::NE, OffsetType::Int32>(slowPathAddr);
+  emit.cmpImmToRM<S::SLQ>(
+      size,
+      RegRuntime,
+      Reg::NoIndex,
+      RuntimeOffsets::bytesUntilAllocationSample);
+  emit.cjump<CCode::LE, OffsetType::Int32>(slowPathAddr);
+
+  // Commit the allocation.
+  emit.movRegToRM<S::Q>(
+      Reg::rdx, RegRuntime, Reg::NoIndex, RuntimeOffsets::allocLevel);
+  emit.movRMToReg<S::Q>(
+      RegRuntime,
+      Reg::NoIndex,
+      RuntimeOffsets::bytesUntilAllocationSample,
+      Reg::rdx);
+  emit.leaRMToReg<S::Q>(Reg::rdx, Reg::NoIndex, -(int32_t)size, Reg::rdx);
+  emit.movRegToRM<S::Q>(
+      Reg::rdx,
+      RegRuntime,
+      Reg::NoIndex,
+      RuntimeOffsets::bytesUntilAllocationSample);
+#else
+  llvm_unreachable("Inline allocation is not supported by this GC");
+#endif
+  return emit;
+}
+
+Emitter FastJIT::emitGetByIdCall(
+    Emitter emit,
+    const uint8_t *externAddr,
     const Inst *ip,
     bool tryProp,
     uint32_t idVal) {
@@ -938,27 +1310,56 @@ inline Emitters FastJIT::getByIdHelper(
   auto flags =
       !tryProp ? defaultPropOpFlags : defaultPropOpFlags.plusMustExist();
   // PropOpFlags  -> arg2
-  emit.fast.movImmToReg<S::L>(flags.getRaw(), Reg::esi);
+  emit.movImmToReg<S::L>(flags.getRaw(), Reg::esi);
 
   // IdentifierID (uint32_t) -> arg3
   // The symbol must already exist in the string id map, so we could just pass
   // the IdentifierID
-  emit.fast.movImmToReg<S::L>(
+  emit.movImmToReg<S::L>(
       codeBlock_->getRuntimeModule()
           ->getSymbolIDMustExist(idVal)
           .unsafeGetIndex(),
       Reg::edx);
   //&target -> arg4
-  emit.fast = leaHermesReg(emit.fast, ip->iGetById.op2, Reg::rcx);
+  emit = leaHermesReg(emit, ip->iGetById.op2, Reg::rcx);
   // cacheIdx -> arg5
   // cacheIdx is uint8_t, but it's more efficient to just set whole 32 bits
-  emit.fast.movImmToReg<S::L>(ip->iGetById.op3, Reg::r8d);
+  emit.movImmToReg<S::L>(ip->iGetById.op3, Reg::r8d);
   // current code block -> arg6
-  emit = loadConstantAddrIntoNativeReg(emit, codeBlock_, Reg::r9);
+  emit.movqImmToReg((uint64_t)codeBlock_, Reg::r9);
 
+  return callExternal(emit, externAddr, ip->iGetById.op1, ip);
+}
+
+inline Emitters FastJIT::getByIdHelper(
+    Emitters emit,
+    const Inst *ip,
+    bool tryProp,
+    uint32_t idVal) {
   uint8_t *constAddr;
   emit.slow = getConstant(emit.slow, (void *)externGetById, constAddr);
-  emit.fast = callExternal(emit.fast, constAddr, ip->iGetById.op1, ip);
+
+  if (!canInlinePropertyCache(ip->iGetById.op3)) {
+    emit.fast = emitGetByIdCall(emit.fast, constAddr, ip, tryProp, idVal);
+    return emit;
+  }
+
+  // Fast path: on a hit in the primary class of the cache entry, load the
+  // property from its direct slot.
+  const uint8_t *slowPathAddr = emit.slow.current();
+  emit.fast = emitPropertyCacheCheck(
+      emit.fast,
+      ip->iGetById.op2,
+      codeBlock_->getReadCacheEntry(ip->iGetById.op3),
+      slowPathAddr);
+  emit.fast.movRMToReg<S::Q, sizeof(HermesValue)>(
+      Reg::rcx, Reg::rax, RuntimeOffsets::objectDirectProps, Reg::rdx);
+  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::rdx, ip->iGetById.op1);
+
+  // Slow path: perform the full lookup, which also updates the cache.
+  emit.slow = emitGetByIdCall(emit.slow, constAddr, ip, tryProp, idVal);
+  emit.slow.jmp<OffsetType::Int32>(emit.fast.current());
+  describeSlowPathSection(emit.slow, false);
   return emit;
 }
 
@@ -978,8 +1379,9 @@ Emitters FastJIT::compileTryGetByIdLong(Emitters emit, const Inst *ip) {
   return getByIdHelper(emit, ip, true, ip->iTryGetByIdLong.op4);
 }
 
-inline Emitters FastJIT::putByIdHelper(
-    Emitters emit,
+Emitter FastJIT::emitPutByIdCall(
+    Emitter emit,
+    const uint8_t *externAddr,
     const Inst *ip,
     bool tryProp,
     uint32_t idVal) {
@@ -989,26 +1391,71 @@ inline Emitters FastJIT::putByIdHelper(
   auto flags =
       !tryProp ? defaultPropOpFlags : defaultPropOpFlags.plusMustExist();
   // PropOpFlags  -> arg2
-  emit.fast.movImmToReg<S::L>(flags.getRaw(), Reg::esi);
+  emit.movImmToReg<S::L>(flags.getRaw(), Reg::esi);
   // IdentifierID (uint32_t) -> arg3
   // The symbol must already exist in the map, so we could just pass the
   // IdentifierID
-  emit.fast.movImmToReg<S::L>(
+  emit.movImmToReg<S::L>(
       codeBlock_->getRuntimeModule()
           ->getSymbolIDMustExist(idVal)
           .unsafeGetIndex(),
       Reg::edx);
   //&target -> arg4
-  emit.fast = leaHermesReg(emit.fast, ip->iPutById.op1, Reg::rcx);
+  emit = leaHermesReg(emit, ip->iPutById.op1, Reg::rcx);
   //&prop -> arg5
-  emit.fast = leaHermesReg(emit.fast, ip->iPutById.op2, Reg::r8);
+  emit = leaHermesReg(emit, ip->iPutById.op2, Reg::r8);
   // cacheIdx -> arg6
   // cacheIdx is uint8_t, but it's more efficient to just set whole 32 bits
-  emit.fast.movImmToReg<S::L>(ip->iPutById.op3, Reg::r9d);
+  emit.movImmToReg<S::L>(ip->iPutById.op3, Reg::r9d);
+
+  return callExternalNoReturnedVal(emit, externAddr, ip);
+}
 
+inline Emitters FastJIT::putByIdHelper(
+    Emitters emit,
+    const Inst *ip,
+    bool tryProp,
+    uint32_t idVal) {
   uint8_t *constAddr;
   emit.slow = getConstant(emit.slow, (void *)externPutById, constAddr);
-  emit.fast = callExternalNoReturnedVal(emit.fast, constAddr, ip);
+
+  if (!canInlinePropertyCache(ip->iPutById.op3)) {
+    emit.fast = emitPutByIdCall(emit.fast, constAddr, ip, tryProp, idVal);
+    return emit;
+  }
+
+  // Fast path: on a hit in the primary class of the cache entry, store the
+  // property into its direct slot. Unless the write barrier can be emitted
+  // inline, only values which are not pointers are stored inline, since they
+  // don't need one.
+  const uint8_t *slowPathAddr = emit.slow.current();
+  if (!canInlineWriteBarrier()) {
+    emit.fast.cmpImmToRM<S::L>(
+        FirstPointerTagHW,
+        RegFrame,
+        Reg::NoIndex,
+        // Compare the higher 32 bits (tag) of the HermesValue
+        localHermesRegByteOffset(ip->iPutById.op2) + 4);
+    emit.fast.cjump<CCode::AE, OffsetType::Int32>(slowPathAddr);
+  }
+  emit.fast = emitPropertyCacheCheck(
+      emit.fast,
+      ip->iPutById.op1,
+      codeBlock_->getWriteCacheEntry(ip->iPutById.op3),
+      slowPathAddr);
+  emit.fast = movHermesRegToNativeReg(emit.fast, ip->iPutById.op2, Reg::rdx);
+  emit.fast.movRegToRM<S::Q, sizeof(HermesValue)>(
+      Reg::rdx, Reg::rcx, Reg::rax, RuntimeOffsets::objectDirectProps);
+  if (canInlineWriteBarrier()) {
+    emit.fast.leaRMToReg<S::Q, S::Q, sizeof(HermesValue)>(
+        Reg::rcx, Reg::rax, RuntimeOffsets::objectDirectProps, Reg::rsi);
+    emit.fast = emitWriteBarrier(emit.fast, Reg::rsi, Reg::rdx);
+  }
+
+  // Slow path: perform the full store, which also updates the cache.
+  emit.slow = emitPutByIdCall(emit.slow, constAddr, ip, tryProp, idVal);
+  emit.slow.jmp<OffsetType::Int32>(emit.fast.current());
+  describeSlowPathSection(emit.slow, false);
   return emit;
 }
 
@@ -1081,6 +1528,7 @@ Emitters FastJIT::compileLoadConstZero(Emitters emit, const Inst *ip) {
   emit.fast.xorRegToReg<S::Q>(Reg::rax, Reg::rax);
   emit.fast =
       movNativeRegToHermesReg(emit.fast, Reg::rax, ip->iLoadConstZero.op1);
+  forgetCachedFPReg(ip->iLoadConstZero.op1);
   return emit;
 }
 
@@ -1309,46 +1757,70 @@ Emitters FastJIT::compileBinOp(
 }
 
 Emitters FastJIT::compileAddN(Emitters emit, const Inst *ip) {
-  emit.fast = movHermesRegToNativeReg<true>(emit.fast, ip->iAdd.op2, Reg::XMM0);
-  emit.fast.addfpRMToReg(
-      RegFrame,
-      Reg::NoIndex,
-      localHermesRegByteOffset(ip->iAdd.op3),
-      Reg::XMM0);
-  emit.fast = movNativeRegToHermesReg<true>(emit.fast, Reg::XMM0, ip->iAdd.op1);
+  emit.fast = emitNumberBinOp(emit.fast, ip, NumberBinOp::Add);
   return emit;
 }
 
 Emitters FastJIT::compileSubN(Emitters emit, const Inst *ip) {
-  emit.fast = movHermesRegToNativeReg<true>(emit.fast, ip->iAdd.op2, Reg::XMM0);
-  emit.fast.subfpRMFromReg(
-      RegFrame,
-      Reg::NoIndex,
-      localHermesRegByteOffset(ip->iSubN.op3),
-      Reg::XMM0);
-  emit.fast = movNativeRegToHermesReg<true>(emit.fast, Reg::XMM0, ip->iAdd.op1);
+  emit.fast = emitNumberBinOp(emit.fast, ip, NumberBinOp::Sub);
   return emit;
 }
 
 Emitters FastJIT::compileMulN(Emitters emit, const Inst *ip) {
-  emit.fast = movHermesRegToNativeReg<true>(emit.fast, ip->iAdd.op2, Reg::XMM0);
-  emit.fast.mulfpRMToReg(
-      RegFrame,
-      Reg::NoIndex,
-      localHermesRegByteOffset(ip->iMul.op3),
-      Reg::XMM0);
-  emit.fast = movNativeRegToHermesReg<true>(emit.fast, Reg::XMM0, ip->iAdd.op1);
+  emit.fast = emitNumberBinOp(emit.fast, ip, NumberBinOp::Mul);
   return emit;
 }
 
 Emitters FastJIT::compileDivN(Emitters emit, const Inst *ip) {
-  emit.fast = movHermesRegToNativeReg<true>(emit.fast, ip->iDiv.op2, Reg::XMM0);
-  emit.fast.divfpRMFromReg(
-      RegFrame,
-      Reg::NoIndex,
-      localHermesRegByteOffset(ip->iDiv.op3),
-      Reg::XMM0);
-  emit.fast = movNativeRegToHermesReg<true>(emit.fast, Reg::XMM0, ip->iDiv.op1);
+  emit.fast = emitNumberBinOp(emit.fast, ip, NumberBinOp::Div);
+  return emit;
+}
+
+Emitter
+FastJIT::emitNumberBinOp(Emitter emit, const Inst *ip, NumberBinOp op) {
+  // All the N arithmetic instructions have the layout of AddN.
+  const uint32_t dst = ip->iAddN.op1;
+  const uint32_t src1 = ip->iAddN.op2;
+  const uint32_t src2 = ip->iAddN.op3;
+  const Reg src2Reg = findCachedFPReg(src2);
+
+  // Compute the result in the register caching dst, unless loading src1 into
+  // it would overwrite src2 first.
+  const bool inPlace = dst == src1 || dst != src2;
+  const Reg resultReg = inPlace ? allocCachedFPReg(dst, src2Reg) : Reg::XMM0;
+  emit = loadNumberIntoFPReg(emit, src1, resultReg);
+
+  const int32_t src2Offset = localHermesRegByteOffset(src2);
+  switch (op) {
+    case NumberBinOp::Add:
+      if (src2Reg != Reg::none)
+        emit.addfpRegToReg(src2Reg, resultReg);
+      else
+        emit.addfpRMToReg(RegFrame, Reg::NoIndex, src2Offset, resultReg);
+      break;
+    case NumberBinOp::Sub:
+      if (src2Reg != Reg::none)
+        emit.subfpRegFromReg(src2Reg, resultReg);
+      else
+        emit.subfpRMFromReg(RegFrame, Reg::NoIndex, src2Offset, resultReg);
+      break;
+    case NumberBinOp::Mul:
+      if (src2Reg != Reg::none)
+        emit.mulfpRegToReg(src2Reg, resultReg);
+      else
+        emit.mulfpRMToReg(RegFrame, Reg::NoIndex, src2Offset, resultReg);
+      break;
+    case NumberBinOp::Div:
+      if (src2Reg != Reg::none)
+        emit.divfpRegFromReg(src2Reg, resultReg);
+      else
+        emit.divfpRMFromReg(RegFrame, Reg::NoIndex, src2Offset, resultReg);
+      break;
+  }
+
+  emit = movNativeRegToHermesReg<true>(emit, resultReg, dst);
+  if (!inPlace)
+    emit.movfpRegToReg(resultReg, allocCachedFPReg(dst, Reg::none));
   return emit;
 }
 
@@ -1363,6 +1835,23 @@ Emitter FastJIT::isNumber(Emitter emit, uint32_t regIndex, uint8_t *callStub) {
   return emit;
 }
 
+Emitter FastJIT::loadInt32(
+    Emitter emit,
+    uint32_t regIndex,
+    Reg dst,
+    uint8_t *callStub) {
+  emit = isNumber(emit, regIndex, callStub);
+  emit = movHermesRegToNativeReg<true>(emit, regIndex, Reg::XMM0);
+  // Truncate to int32 and convert back: the value is an int32 if the result
+  // is equal to it. NaN compares unordered, which sets the parity flag.
+  emit.cvttsd2siRegToReg(Reg::XMM0, dst);
+  emit.cvtsi2sdRegToReg(dst, Reg::XMM1);
+  emit.ucomisRegToReg(Reg::XMM0, Reg::XMM1);
+  emit.cjump<CCode::NE, OffsetType::Int32>(callStub);
+  emit.cjump<CCode::P, OffsetType::Int32>(callStub);
+  return emit;
+}
+
 Emitter FastJIT::isString(Emitter emit, uint32_t regIndex, uint8_t *callStub) {
   emit = cmpSomePointerTag(emit, regIndex, StrTag);
   emit.cjump<CCode::NE, OffsetType::Int32>(callStub);
@@ -1388,13 +1877,24 @@ Emitters FastJIT::callSlowPathBinOp(
 }
 
 Emitters FastJIT::compileMov(Emitters emit, const Inst *ip) {
-  emit.fast = movHermesRegToNativeReg(emit.fast, ip->iMov.op2, Reg::rax);
-  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::rax, ip->iMov.op1);
-  return emit;
+  return movHelper(emit, ip->iMov.op1, ip->iMov.op2);
 }
 Emitters FastJIT::compileMovLong(Emitters emit, const Inst *ip) {
-  emit.fast = movHermesRegToNativeReg(emit.fast, ip->iMovLong.op2, Reg::rax);
-  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::rax, ip->iMovLong.op1);
+  return movHelper(emit, ip->iMovLong.op1, ip->iMovLong.op2);
+}
+
+Emitters FastJIT::movHelper(Emitters emit, uint32_t dst, uint32_t src) {
+  // A number cached in an XMM register is stored from there, but only src
+  // keeps caching it.
+  Reg cached = findCachedFPReg(src);
+  if (cached != Reg::none) {
+    emit.fast = movNativeRegToHermesReg<true>(emit.fast, cached, dst);
+  } else {
+    emit.fast = movHermesRegToNativeReg(emit.fast, src, Reg::rax);
+    emit.fast = movNativeRegToHermesReg(emit.fast, Reg::rax, dst);
+  }
+  if (dst != src)
+    forgetCachedFPReg(dst);
   return emit;
 }
 
@@ -1469,9 +1969,18 @@ Emitters FastJIT::compileCondJumpN(
     uint32_t reg1,
     uint32_t reg2,
     uint8_t opCode) {
-  emit.fast = movHermesRegToNativeReg<true>(emit.fast, reg1, Reg::XMM0);
-  emit.fast.ucomisRMToReg(
-      RegFrame, Reg::NoIndex, localHermesRegByteOffset(reg2), Reg::XMM0);
+  Reg reg1FP = findCachedFPReg(reg1);
+  if (reg1FP == Reg::none) {
+    reg1FP = Reg::XMM0;
+    emit.fast = movHermesRegToNativeReg<true>(emit.fast, reg1, reg1FP);
+  }
+  Reg reg2FP = findCachedFPReg(reg2);
+  if (reg2FP != Reg::none) {
+    emit.fast.ucomisRegToReg(reg2FP, reg1FP);
+  } else {
+    emit.fast.ucomisRMToReg(
+        RegFrame, Reg::NoIndex, localHermesRegByteOffset(reg2), reg1FP);
+  }
 
   emit.fast = cjmpToBytecodeBB(emit.fast, opCode, getBBIndex(ip, ipOffset));
 
@@ -1525,8 +2034,55 @@ Emitters FastJIT::compileCondJump(
 Emitters FastJIT::compileNewObject(Emitters emit, const Inst *ip) {
   uint8_t *constAddr;
   emit.slow = getConstant(emit.slow, (void *)externNewObject, constAddr);
-  emit.fast =
-      callExternalWithReturnedVal(emit.fast, constAddr, ip->iNewObject.op1);
+  if (!canInlineAlloc()) {
+    emit.fast =
+        callExternalWithReturnedVal(emit.fast, constAddr, ip->iNewObject.op1);
+    return emit;
+  }
+
+  // Fast path: allocate the object inline and initialize it the way
+  // JSObject::create(runtime) does.
+  const uint8_t *slowPathAddr = emit.slow.current();
+  emit.fast = emitInlineAlloc(emit.fast, sizeof(JSObject), slowPathAddr);
+  emit.fast.movqImmToReg((uint64_t)&JSObject::vt.base, Reg::rcx);
+  emit.fast.movRegToRM<S::Q>(
+      Reg::rcx, Reg::rax, Reg::NoIndex, RuntimeOffsets::cellVTable);
+  static_assert(
+      sizeof(ObjectFlags) == sizeof(uint32_t), "ObjectFlags must be 32-bit");
+  emit.fast.movImmToRM<S::L>(
+      0, Reg::rax, Reg::NoIndex, RuntimeOffsets::objectFlags);
+  emit.fast.movRMToReg<S::Q>(
+      RegRuntime, Reg::NoIndex, RuntimeOffsets::objectPrototype, Reg::rcx);
+  emit.fast.movRegToRM<S::Q>(
+      Reg::rcx, Reg::rax, Reg::NoIndex, RuntimeOffsets::objectParent);
+  emit.fast.movRMToReg<S::Q>(
+      RegRuntime, Reg::NoIndex, RuntimeOffsets::rootClazz, Reg::rcx);
+  emit.fast.movRegToRM<S::Q>(
+      Reg::rcx, Reg::rax, Reg::NoIndex, RuntimeOffsets::objectClass);
+  emit.fast.movImmToRM<S::SLQ>(
+      0, Reg::rax, Reg::NoIndex, RuntimeOffsets::objectPropStorage);
+  emit.fast.movqImmToReg(
+      HermesValue::encodeUndefinedValue().getRaw(), Reg::rcx);
+  for (unsigned i = 0; i < JSObject::DIRECT_PROPERTY_SLOTS; ++i) {
+    emit.fast.movRegToRM<S::Q>(
+        Reg::rcx,
+        Reg::rax,
+        Reg::NoIndex,
+        RuntimeOffsets::objectDirectProps + i * sizeof(HermesValue));
+  }
+
+  // As in JSObject::create, the stores into the new object need no write
+  // barriers. Tag the pointer and store it.
+  emit.fast.movqImmToReg(
+      (uint64_t)ObjectTag << HermesValue::kNumDataBits, Reg::rcx);
+  emit.fast.orRegToReg<S::Q>(Reg::rcx, Reg::rax);
+  emit.fast = movNativeRegToHermesReg(emit.fast, Reg::rax, ip->iNewObject.op1);
+
+  // Slow path: the segment is full, let the GC allocate.
+  emit.slow =
+      callExternalWithReturnedVal(emit.slow, constAddr, ip->iNewObject.op1);
+  emit.slow.jmp<OffsetType::Int32>(emit.fast.current());
+  describeSlowPathSection(emit.slow, false);
   return emit;
 }
 
@@ -1616,6 +2172,8 @@ Emitters FastJIT::compileNewArrayWithBuffer(
   emit.fast.movImmToReg<S::L>(ip->iNewArrayWithBuffer.op3, Reg::ecx);
   // the index in the array buffer table (uint16_t/uint32_t) -> arg5
   emit.fast.movImmToReg<S::L>(idx, Reg::r8d);
+  // the instruction, for allocation site feedback -> arg6
+  emit = loadConstantAddrIntoNativeReg(emit, (void *)ip, Reg::r9);
 
   uint8_t *constAddr;
   emit.slow =
@@ -1662,6 +2220,59 @@ FastJIT::compilePutNewOwnById(Emitters emit, const Inst *ip, uint32_t idx) {
   return emit;
 }
 
+Emitters
+FastJIT::compilePutOwnBySlotIdx(Emitters emit, const Inst *ip, uint32_t idx) {
+  if (canInlineWriteBarrier() && idx < JSObject::DIRECT_PROPERTY_SLOTS) {
+    // Store into the direct slot inline, followed by the write barrier.
+    emit.fast = movHermesRegToNativeReg(
+        emit.fast, ip->iPutOwnBySlotIdx.op1, Reg::rcx);
+    emit.fast = clearObjectTag(emit.fast, Reg::rcx, Reg::rax);
+    emit.fast = movHermesRegToNativeReg(
+        emit.fast, ip->iPutOwnBySlotIdx.op2, Reg::rdx);
+    emit.fast.leaRMToReg<S::Q>(
+        Reg::rcx,
+        Reg::NoIndex,
+        RuntimeOffsets::objectDirectProps + idx * sizeof(HermesValue),
+        Reg::rsi);
+    emit.fast.movRegToRM<S::Q>(Reg::rdx, Reg::rsi, Reg::NoIndex, 0);
+    emit.fast = emitWriteBarrier(emit.fast, Reg::rsi, Reg::rdx);
+    return emit;
+  }
+
+  // Object to store in -> arg2
+  emit.fast = leaHermesReg(emit.fast, ip->iPutOwnBySlotIdx.op1, Reg::rsi);
+  // Value to be stored -> arg3
+  emit.fast = leaHermesReg(emit.fast, ip->iPutOwnBySlotIdx.op2, Reg::rdx);
+  // Slot index -> arg4
+  emit.fast.movImmToReg<S::L>(idx, Reg::ecx);
+
+  uint8_t *constAddr;
+  emit.slow = getConstant(emit.slow, (void *)externPutOwnBySlotIdx, constAddr);
+  emit.fast = callExternalNoReturnedVal(emit.fast, constAddr, ip);
+
+  return emit;
+}
+
+Emitters
+FastJIT::compilePutOwnNPBySlotIdx(Emitters emit, const Inst *ip, uint32_t idx) {
+  if (idx >= JSObject::DIRECT_PROPERTY_SLOTS)
+    return compilePutOwnBySlotIdx(emit, ip, idx);
+
+  // The value is not a pointer, so it is stored in the direct slot without a
+  // write barrier.
+  emit.fast = movHermesRegToNativeReg(
+      emit.fast, ip->iPutOwnNPBySlotIdx.op1, Reg::rcx);
+  emit.fast = clearObjectTag(emit.fast, Reg::rcx, Reg::rax);
+  emit.fast = movHermesRegToNativeReg(
+      emit.fast, ip->iPutOwnNPBySlotIdx.op2, Reg::rdx);
+  emit.fast.movRegToRM<S::Q>(
+      Reg::rdx,
+      Reg::rcx,
+      Reg::NoIndex,
+      RuntimeOffsets::objectDirectProps + idx * sizeof(HermesValue));
+  return emit;
+}
+
 Emitters FastJIT::compileLoadThisNS(Emitters emit, const Inst *ip) {
   // StackFrameLayout::ThisArg is not technically a local register, but we could
   // still use the same way to read it.
@@ -1840,6 +2451,8 @@ Emitters FastJIT::newObjectWithBufferHelper(
   emit.fast.movImmToReg<S::L>(keyIdx, Reg::ecx);
   // the index in the object val buffer table (uint16_t/uint32_t) -> arg5
   emit.fast.movImmToReg<S::L>(valIdx, Reg::r8d);
+  // the instruction, for allocation site feedback -> arg6
+  emit = loadConstantAddrIntoNativeReg(emit, (void *)ip, Reg::r9);
 
   uint8_t *constAddr;
   emit.slow =
@@ -1877,33 +2490,84 @@ Emitters FastJIT::compileDelByVal(Emitters emit, const Inst *ip) {
   return compile3RegsInst(emit, ip, (void *)externDelByVal);
 }
 
+Emitter FastJIT::leaEnvironmentSlot(
+    Emitter emit,
+    OperandReg32 envReg,
+    uint32_t idx,
+    Reg reg,
+    Reg scratch,
+    int32_t &slotOffset) {
+  // reg = the Environment pointer.
+  emit = movHermesRegToNativeReg(emit, envReg, reg);
+  emit = clearObjectTag(emit, reg, scratch);
+
+  uint64_t offset =
+      Environment::getSlotsOffset() + (uint64_t)idx * sizeof(HermesValue);
+  if (detail::isInt32(offset)) {
+    slotOffset = offset;
+  } else {
+    // The slot is too far to be addressed with a displacement.
+    emit.movqImmToReg(offset, scratch);
+    emit.leaRMToReg<S::Q, S::Q, 1>(reg, scratch, 0, reg);
+    slotOffset = 0;
+  }
+  return emit;
+}
+
 Emitters FastJIT::storeToEnvironmentHelper(
     Emitters emit,
     uint32_t op1,
     uint32_t idx,
     uint32_t op3,
     bool isNP) {
+  // Values which are not pointers are stored without a write barrier, so
+  // they can be stored directly. Pointers are too if the barrier can be
+  // emitted inline.
+  uint8_t *constAddr = nullptr;
+  const uint8_t *slowPathAddr = nullptr;
+  if (!isNP && !canInlineWriteBarrier()) {
+    emit.slow =
+        getConstant(emit.slow, (void *)externStoreToEnvironment, constAddr);
+    slowPathAddr = emit.slow.current();
+    emit.fast.cmpImmToRM<S::L>(
+        FirstPointerTagHW,
+        RegFrame,
+        Reg::NoIndex,
+        // Compare the higher 32 bits (tag) of the HermesValue
+        localHermesRegByteOffset(op3) + 4);
+    emit.fast.cjump<CCode::AE, OffsetType::Int32>(slowPathAddr);
+  }
+
+  int32_t slotOffset;
+  emit.fast =
+      leaEnvironmentSlot(emit.fast, op1, idx, Reg::rax, Reg::rcx, slotOffset);
+  emit.fast = movHermesRegToNativeReg(emit.fast, op3, Reg::rdx);
+  emit.fast.movRegToRM<S::Q>(Reg::rdx, Reg::rax, Reg::NoIndex, slotOffset);
+
+  if (isNP)
+    return emit;
+  if (canInlineWriteBarrier()) {
+    emit.fast.leaRMToReg<S::Q>(Reg::rax, Reg::NoIndex, slotOffset, Reg::rsi);
+    emit.fast = emitWriteBarrier(emit.fast, Reg::rsi, Reg::rdx);
+    return emit;
+  }
+
+  // Slow path: store the pointer with a write barrier.
   // environment -> arg1
-  emit.fast = leaHermesReg(emit.fast, op1, Reg::rdi);
+  emit.slow = leaHermesReg(emit.slow, op1, Reg::rdi);
   // slot index -> arg2
-  emit.fast.movImmToReg<S::L>(idx, Reg::rsi);
+  emit.slow.movImmToReg<S::L>(idx, Reg::rsi);
   // value -> arg3
-  emit.fast = leaHermesReg(emit.fast, op3, Reg::rdx);
+  emit.slow = leaHermesReg(emit.slow, op3, Reg::rdx);
+  // runtime -> arg4
+  emit.slow.movRegToReg<S::Q>(RegRuntime, Reg::rcx);
 
-  if (!isNP)
-    // runtime -> arg4
-    emit.fast.movRegToReg<S::Q>(RegRuntime, Reg::rcx);
-
-  uint8_t *constAddr;
-  emit.slow = getConstant(
-      emit.slow,
-      isNP ? (void *)externStoreNPToEnvironment
-           : (void *)externStoreToEnvironment,
-      constAddr);
-  emit.fast.callRM<ScaleRIPAddr32>(Reg::none, Reg::NoIndex, 0);
-  applyRIP32Offset(emit.fast.current(), constAddr);
+  emit.slow.callRM<ScaleRIPAddr32>(Reg::none, Reg::NoIndex, 0);
+  applyRIP32Offset(emit.slow.current(), constAddr);
   // the external call returns void
 
+  emit.slow.jmp<OffsetType::Int32>(emit.fast.current());
+  describeSlowPathSection(emit.slow, false);
   return emit;
 }
 Emitters FastJIT::compileStoreToEnvironment(Emitters emit, const Inst *ip) {
@@ -1943,14 +2607,15 @@ Emitters FastJIT::compileLoadFromEnvironment(
     Emitters emit,
     const Inst *ip,
     uint32_t idx) {
-  emit.fast = leaHermesReg(emit.fast, ip->iLoadFromEnvironment.op2, Reg::rdi);
-  emit.fast.movImmToReg<S::L>(idx, Reg::rsi);
-  uint8_t *constAddr;
-  emit.slow =
-      getConstant(emit.slow, (void *)externLoadFromEnvironment, constAddr);
-  emit.fast.callRM<ScaleRIPAddr32>(Reg::none, Reg::NoIndex, 0);
-  applyRIP32Offset(emit.fast.current(), constAddr);
-
+  int32_t slotOffset;
+  emit.fast = leaEnvironmentSlot(
+      emit.fast,
+      ip->iLoadFromEnvironment.op2,
+      idx,
+      Reg::rax,
+      Reg::rcx,
+      slotOffset);
+  emit.fast.movRMToReg<S::Q>(Reg::rax, Reg::NoIndex, slotOffset, Reg::rax);
   emit.fast = movNativeRegToHermesReg(
       emit.fast, Reg::rax, ip->iLoadFromEnvironment.op1);
   return emit;
@@ -2104,6 +2769,39 @@ Emitters FastJIT::compileGetNextPName(Emitters emit, const Inst *ip) {
   return emit;
 }
 
+Emitters FastJIT::compileIteratorBegin(Emitters emit, const Inst *ip) {
+  uint8_t *externAddr;
+  emit.slow = getConstant(
+      emit.slow, (void *)Interpreter::caseIteratorBegin, externAddr);
+  // As for GetPNameList, frameRegs is the address of r0.
+  emit.fast = leaHermesReg(emit.fast, 0, Reg::rsi);
+  emit = loadConstantAddrIntoNativeReg(emit, (void *)ip, Reg::rdx);
+  emit.fast = callExternalNoReturnedVal(emit.fast, externAddr, ip);
+  return emit;
+}
+
+Emitters FastJIT::compileIteratorNext(Emitters emit, const Inst *ip) {
+  // Arrays iterated by index also go through the interpreter's slow path,
+  // which still doesn't allocate an iterator.
+  uint8_t *externAddr;
+  emit.slow = getConstant(
+      emit.slow, (void *)Interpreter::caseIteratorNext, externAddr);
+  emit.fast = leaHermesReg(emit.fast, 0, Reg::rsi);
+  emit = loadConstantAddrIntoNativeReg(emit, (void *)ip, Reg::rdx);
+  emit.fast = callExternalNoReturnedVal(emit.fast, externAddr, ip);
+  return emit;
+}
+
+Emitters FastJIT::compileIteratorClose(Emitters emit, const Inst *ip) {
+  uint8_t *externAddr;
+  emit.slow = getConstant(
+      emit.slow, (void *)Interpreter::caseIteratorClose, externAddr);
+  emit.fast = leaHermesReg(emit.fast, 0, Reg::rsi);
+  emit = loadConstantAddrIntoNativeReg(emit, (void *)ip, Reg::rdx);
+  emit.fast = callExternalNoReturnedVal(emit.fast, externAddr, ip);
+  return emit;
+}
+
 Emitters FastJIT::compileReifyArguments(Emitters emit, const Inst *ip) {
   uint8_t *externConstAddr;
   emit.slow = getConstant(
@@ -2146,17 +2844,8 @@ Emitters FastJIT::compileBitNot(Emitters emit, const Inst *ip) {
       getConstant(emit.slow, (void *)externSlowPathBitNot, slowPathConstAddr);
   uint8_t *slowPathAddr = emit.slow.current();
 
-  emit.fast = isNumber(emit.fast, ip->iBitNot.op2, slowPathAddr);
-  emit.fast =
-      movHermesRegToNativeReg<true>(emit.fast, ip->iBitNot.op2, Reg::XMM0);
-  // Convert with Truncation Scalar Double-Precision Floating-Point Value to
-  // Signed Integer
-  emit.fast.cvttsd2siRegToReg(Reg::XMM0, Reg::eax);
-  // Convert Doubleword Integer to Scalar Double-Precision Floating-Point Value
-  emit.fast.cvtsi2sdRegToReg(Reg::eax, Reg::XMM1);
-  emit.fast.ucomisRegToReg(Reg::XMM0, Reg::XMM1);
   // if op2 is not already a int32, jump to slow path
-  emit.fast.cjump<CCode::NE, OffsetType::Int32>(slowPathAddr);
+  emit.fast = loadInt32(emit.fast, ip->iBitNot.op2, Reg::eax, slowPathAddr);
   emit.fast.notReg<S::L>(Reg::eax);
   emit.fast.cvtsi2sdRegToReg(Reg::eax, Reg::XMM0);
   emit.fast =
@@ -2171,6 +2860,51 @@ Emitters FastJIT::compileBitNot(Emitters emit, const Inst *ip) {
   return emit;
 }
 
+Emitters FastJIT::compileBitwiseOp(
+    Emitters emit,
+    const Inst *ip,
+    void *slowPathCall,
+    BitwiseOp op) {
+  uint8_t *slowPathConstAddr;
+  emit.slow = getConstant(emit.slow, slowPathCall, slowPathConstAddr);
+  uint8_t *slowPathAddr = emit.slow.current();
+
+  // The shift count has to be in cl. Shifts of 32-bit registers only use the
+  // low 5 bits of the count, as JS does.
+  emit.fast = loadInt32(emit.fast, ip->iBitAnd.op2, Reg::eax, slowPathAddr);
+  emit.fast = loadInt32(emit.fast, ip->iBitAnd.op3, Reg::ecx, slowPathAddr);
+  switch (op) {
+    case BitwiseOp::And:
+      emit.fast.andRegToReg<S::L>(Reg::ecx, Reg::eax);
+      break;
+    case BitwiseOp::Or:
+      emit.fast.orRegToReg<S::L>(Reg::ecx, Reg::eax);
+      break;
+    case BitwiseOp::Xor:
+      emit.fast.xorRegToReg<S::L>(Reg::ecx, Reg::eax);
+      break;
+    case BitwiseOp::LShift:
+      emit.fast.shlRegByCL<S::L>(Reg::eax);
+      break;
+    case BitwiseOp::RShift:
+      emit.fast.sarRegByCL<S::L>(Reg::eax);
+      break;
+    case BitwiseOp::URshift:
+      emit.fast.shrRegByCL<S::L>(Reg::eax);
+      break;
+  }
+  // 32-bit operations zero the upper half of rax, so converting all of rax
+  // gives the unsigned result of >>>.
+  if (op == BitwiseOp::URshift)
+    emit.fast.cvtsi2sdQRegToReg(Reg::rax, Reg::XMM0);
+  else
+    emit.fast.cvtsi2sdRegToReg(Reg::eax, Reg::XMM0);
+  emit.fast =
+      movNativeRegToHermesReg<true>(emit.fast, Reg::XMM0, ip->iBitAnd.op1);
+
+  return callSlowPathBinOp(emit, ip, slowPathConstAddr);
+}
+
 Emitters FastJIT::compileGetArgumentsLength(Emitters emit, const Inst *ip) {
   uint8_t *slowPathConstAddr;
   emit.slow = getConstant(
@@ -67,8 +67,33 @@ class FastJIT {
 
   /// Attempt to compile the associated CodeBlock. On success, the JIT function
   /// pointer in the CodeBlock will be set to the compiled body.
+  /// The generated code is specific to the current process: it embeds the
+  /// addresses of the CodeBlock, its property cache entries and bytecode, of
+  /// the runtime module and of the external helpers, as well as SymbolIDs
+  /// allocated by this Runtime. It therefore cannot be persisted and reloaded
+  /// across launches without recording symbolic relocations for all of them.
   void compile();
 
+  /// \return true if the compilation failed.
+  bool hasError() const {
+    return error_;
+  }
+
+  /// \return the message describing the first error of the compilation.
+  const std::string &getErrorMessage() const {
+    return errorMsg_;
+  }
+
+  /// \return the bytecode offset of the instruction that caused the first
+  /// error of the compilation, or 0 if it wasn't caused by one.
+  uint32_t getErrorOffset() const {
+    return errorOffset_;
+  }
+
+  /// Describe the compiled code to \p perfMap, with the source line of every
+  /// basic block. Only valid after a successful compilation.
+  void addToPerfMap(Runtime *runtime, PerfMap &perfMap) const;
+
   /// A pointer to binOpN instruction's compilation function.
   typedef Emitters (FastJIT::*compileBinOpNPtr)(Emitters emit, const Inst *ip);
 
@@ -147,6 +172,11 @@ class FastJIT {
   Emitters emitPrologue(Emitters emit);
   /// Emit the function epilogue. Calls checkSpace() before emitting.
   Emitters emitEpilogue(Emitters emit);
+  /// Emit the on-stack replacement entry in the slow path. It has the
+  /// signature of JITOSREntryPtr and, unlike the prologue, reuses the
+  /// registers of the interpreter frame that is already on top of the stack.
+  /// Calls checkSpace() before emitting.
+  Emitters emitOSREntry(Emitters emit);
 
   /// Emit the code for a basic block. Calls checkSpace() before processing
   /// every bytecode instruction.
@@ -211,6 +241,41 @@ class FastJIT {
   Emitter
   movHermesRegToHermesReg(Emitter emit, OperandReg32 src, OperandReg32 dst);
 
+  /// @name Numbers cached in XMM registers
+  /// Within a basic block, the numbers computed by the N arithmetic
+  /// instructions stay in XMM registers for the instructions that follow.
+  /// Every store still goes to the frame, so the cache only saves loads and
+  /// nothing needs to be spilled. Since external calls clobber the XMM
+  /// registers and slow paths merge back after their instruction, the cache
+  /// is dropped at the start of every basic block and after every
+  /// instruction that does not maintain it, see preservesFPRegCache().
+  /// @{
+
+  /// \return true if the code emitted for \p opCode keeps the cache valid.
+  static bool preservesFPRegCache(OpCode opCode);
+
+  /// Forget all the cached numbers.
+  void clearFPRegCache();
+
+  /// \return the XMM register caching the number in \p hermesReg, or
+  /// Reg::none.
+  Reg findCachedFPReg(uint32_t hermesReg) const;
+
+  /// Forget the number cached for \p hermesReg, whose value is changing.
+  void forgetCachedFPReg(uint32_t hermesReg);
+
+  /// \return the XMM register that will cache the number in \p hermesReg,
+  /// evicting another Hermes register if needed, but not the one cached in
+  /// \p keep.
+  Reg allocCachedFPReg(uint32_t hermesReg, Reg keep);
+
+  /// Load the number in \p hermesReg into \p nativeReg, from the register
+  /// caching it if there is one.
+  Emitter
+  loadNumberIntoFPReg(Emitter emit, OperandReg32 hermesReg, Reg nativeReg);
+
+  /// @}
+
   /// Move a Runtime member variable \p runtimeVar to hermes reg \p dst.
   Emitter
   movRuntimeVarToHermesReg(Emitter emit, uint32_t runtimeVar, OperandReg32 dst);
@@ -289,6 +354,65 @@ class FastJIT {
   /// Receives and \returns the fast path emitter.
   Emitter cjmpToBytecodeBB(Emitter emit, uint8_t opCode, unsigned bytecodeBB);
 
+  /// Clear the object tag of the HermesValue in \p reg, turning it into the
+  /// pointer it encodes. The value must be known to be an object.
+  /// \param scratch a register which is clobbered.
+  Emitter clearObjectTag(Emitter emit, Reg reg, Reg scratch);
+
+  /// \return true if accesses using the property cache entry \p cacheIdx can
+  /// check the cache inline.
+  inline bool canInlinePropertyCache(uint8_t cacheIdx) const;
+
+  /// Emit an inline check of the primary class of \p cacheEntry against the
+  /// object in \p objReg. On a hit, rcx contains the JSObject pointer and rax
+  /// the index of the cached slot, which is a direct property slot. Otherwise
+  /// jump to \p missAddr.
+  Emitter emitPropertyCacheCheck(
+      Emitter emit,
+      OperandReg32 objReg,
+      const PropertyCacheEntry *cacheEntry,
+      const uint8_t *missAddr);
+
+  /// \return true if the write barrier of the GC can be emitted inline.
+  static constexpr bool canInlineWriteBarrier();
+
+  /// Emit the write barrier for the store of the HermesValue in \p valueReg
+  /// at the address in \p locReg: if the value points into the young
+  /// generation and the location is in another segment, dirty the card
+  /// covering the location. Both registers are preserved.
+  /// Clobbers r8 and r9.
+  Emitter emitWriteBarrier(Emitter emit, Reg locReg, Reg valueReg);
+
+  /// \return true if cells can be allocated inline by bumping the allocation
+  /// pointer of the GC.
+  static constexpr bool canInlineAlloc();
+
+  /// Emit an inline allocation of \p size bytes from the segment the GC
+  /// currently allocates into, leaving the uninitialized cell in rax. Jump to
+  /// \p slowPathAddr if the segment is full, or if the allocation must go
+  /// through the GC (pretenuring or allocation sampling).
+  /// Clobbers rdx.
+  Emitter
+  emitInlineAlloc(Emitter emit, uint32_t size, const uint8_t *slowPathAddr);
+
+  /// Emit a call to the external function at \p externAddr implementing
+  /// GetById, storing the result in the destination register.
+  Emitter emitGetByIdCall(
+      Emitter emit,
+      const uint8_t *externAddr,
+      const Inst *ip,
+      bool tryProp,
+      uint32_t idVal);
+
+  /// Emit a call to the external function at \p externAddr implementing
+  /// PutById.
+  Emitter emitPutByIdCall(
+      Emitter emit,
+      const uint8_t *externAddr,
+      const Inst *ip,
+      bool tryProp,
+      uint32_t idVal);
+
   Emitters
   getByIdHelper(Emitters emit, const Inst *ip, bool tryProp, uint32_t idVal);
   Emitters
@@ -338,8 +462,22 @@ class FastJIT {
       uint32_t keyIdx,
       uint32_t valIdx);
 
-  /// Emit an external call to externStoreToEnvironment or
-  /// externStoreNPToEnvironment depending on if the value \p op3 is a pointer.
+  /// Load into \p reg the address of slot \p idx of the Environment in
+  /// Hermes register \p envReg, minus \p slotOffset.
+  /// \param scratch a register which is clobbered.
+  /// \param[out] slotOffset the displacement to add to \p reg to address
+  ///     the slot.
+  Emitter leaEnvironmentSlot(
+      Emitter emit,
+      OperandReg32 envReg,
+      uint32_t idx,
+      Reg reg,
+      Reg scratch,
+      int32_t &slotOffset);
+
+  /// Store the value \p op3 into an environment slot directly. Pointers are
+  /// stored by an external call to externStoreToEnvironment in the slow path,
+  /// since they need a write barrier.
   /// \param op1 the Hermes reg containing the environment
   /// \param idx the environment index slot number
   /// \param op3 the Hermes reg containing the value to be stored
@@ -353,6 +491,7 @@ class FastJIT {
 
   // Individual instruction emitters
   Emitters compileTypeOf(Emitters emit, const Inst *ip);
+  Emitters compileTypeOfIs(Emitters emit, const Inst *ip);
 
   Emitters compileGetById(Emitters emit, const Inst *ip);
   Emitters compileGetByIdLong(Emitters emit, const Inst *ip);
@@ -374,6 +513,13 @@ class FastJIT {
   /// a number; if not, emit a jump to the slow path \p callStub.
   Emitter isNumber(Emitter emit, uint32_t regIndex, uint8_t *callStub);
 
+  /// Emit a load of the number in the Hermes register \p regIndex into the
+  /// 32-bit native register \p dst. If the value is not a number which is
+  /// exactly an int32, emit a jump to the slow path \p callStub instead.
+  /// Clobbers XMM0 and XMM1.
+  Emitter
+  loadInt32(Emitter emit, uint32_t regIndex, Reg dst, uint8_t *callStub);
+
   /// Emit a check that whether the value in the Hermes register \p regIndex is
   /// a string; if not, emit a jump to the slow path \p callStub.
   Emitter isString(Emitter emit, uint32_t regIndex, uint8_t *callStub);
@@ -414,8 +560,17 @@ class FastJIT {
   Emitters compileSubN(Emitters emit, const Inst *ip);
   Emitters compileMulN(Emitters emit, const Inst *ip);
   Emitters compileDivN(Emitters emit, const Inst *ip);
+
+  /// The operations of emitNumberBinOp().
+  enum class NumberBinOp { Add, Sub, Mul, Div };
+
+  /// Emit \p op on the numbers in the operands of the N arithmetic
+  /// instruction \p ip, taking them from the XMM registers caching them when
+  /// there are, and cache the result.
+  Emitter emitNumberBinOp(Emitter emit, const Inst *ip, NumberBinOp op);
   Emitters compileMov(Emitters emit, const Inst *ip);
   Emitters compileMovLong(Emitters emit, const Inst *ip);
+  Emitters movHelper(Emitters emit, uint32_t dst, uint32_t src);
   Emitters compileToNumber(Emitters emit, const Inst *ip);
   Emitters compileAddEmptyString(Emitters emit, const Inst *ip);
   Emitters compileRet(Emitters emit, const Inst *ip);
@@ -486,6 +641,10 @@ class FastJIT {
   compileNewArrayWithBuffer(Emitters emit, const Inst *ip, uint32_t idx);
   Emitters compilePutOwnByIndex(Emitters emit, const Inst *ip, uint32_t idx);
   Emitters compilePutNewOwnById(Emitters emit, const Inst *ip, uint32_t idx);
+  Emitters
+  compilePutOwnBySlotIdx(Emitters emit, const Inst *ip, uint32_t idx);
+  Emitters
+  compilePutOwnNPBySlotIdx(Emitters emit, const Inst *ip, uint32_t idx);
   Emitters compileLoadThisNS(Emitters emit, const Inst *ip);
   Emitters compileCoerceThisNS(Emitters emit, const Inst *ip);
 
@@ -510,9 +669,24 @@ class FastJIT {
   Emitters compileNegate(Emitters emit, const Inst *ip);
   Emitters compileGetPNameList(Emitters emit, const Inst *ip);
   Emitters compileGetNextPName(Emitters emit, const Inst *ip);
+  Emitters compileIteratorBegin(Emitters emit, const Inst *ip);
+  Emitters compileIteratorNext(Emitters emit, const Inst *ip);
+  Emitters compileIteratorClose(Emitters emit, const Inst *ip);
   Emitters compileReifyArguments(Emitters emit, const Inst *ip);
   Emitters compileGetArgumentsPropByVal(Emitters emit, const Inst *ip);
   Emitters compileBitNot(Emitters emit, const Inst *ip);
+
+  /// The operations of compileBitwiseOp().
+  enum class BitwiseOp { And, Or, Xor, LShift, RShift, URshift };
+
+  /// Compile the bitwise or shift instruction \p ip, with the layout (name,
+  /// Reg8, Reg8, Reg8), performing \p op inline when both operands are
+  /// int32 numbers, and calling \p slowPathCall otherwise.
+  Emitters compileBitwiseOp(
+      Emitters emit,
+      const Inst *ip,
+      void *slowPathCall,
+      BitwiseOp op);
   Emitters compileGetArgumentsLength(Emitters emit, const Inst *ip);
   Emitters compileCreateRegExp(Emitters emit, const Inst *ip);
 
@@ -549,6 +723,8 @@ class FastJIT {
   bool error_ = false;
   /// Optional error message, set the first time we record an error.
   std::string errorMsg_{};
+  /// Bytecode offset of the instruction that caused the first error.
+  uint32_t errorOffset_ = 0;
 
   // The fast-path execution region.
   llvm::MutableArrayRef<uint8_t> fast_;
@@ -557,6 +733,18 @@ class FastJIT {
 
   llvm::DenseMap<DenseUInt64, uint8_t *> doubleConstants_{};
 
+  /// The XMM registers available to the cache of numbers start after XMM0
+  /// and XMM1, which the emitters use as scratch registers.
+  static constexpr unsigned kFirstCachedFPReg = 2;
+  static constexpr unsigned kNumCachedFPRegs = 6;
+  /// Marks an XMM register which doesn't cache any Hermes register.
+  static constexpr uint32_t kNoCachedHermesReg = ~0u;
+
+  /// The Hermes register whose number each XMM register caches.
+  uint32_t cachedFPRegs_[kNumCachedFPRegs];
+  /// The next XMM register to evict when they are all in use.
+  unsigned nextFPRegVictim_ = 0;
+
 #ifndef NDEBUG
   /// A section describing a section of code for disassembly.
   struct Section {
@@ -0,0 +1,819 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/JIT/x86-64/RegExpJIT.h"
+
+#include "hermes/Regex/RegexBytecode.h"
+#include "hermes/VM/JIT/x86-64/Emitter.h"
+#include "hermes/VM/JIT/x86-64/JIT.h"
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+namespace x86_64 {
+
+using namespace hermes::regex;
+
+namespace {
+
+/// The registers used by the compiled code. Only registers saved by the
+/// caller are used, so the code needs no stack frame, and the arguments stay
+/// in the registers they are passed in.
+/// Where the current match attempt starts (the first argument).
+constexpr Reg kStartReg = Reg::rdi;
+/// The end of the input.
+constexpr Reg kLastReg = Reg::rsi;
+/// The slots array.
+constexpr Reg kSlotsReg = Reg::rdx;
+/// Where ^ matches, or null.
+constexpr Reg kAnchorReg = Reg::rcx;
+/// Whether to only try to match at the first position.
+constexpr Reg kOnlyAtStartReg = Reg::r8;
+/// The current position.
+constexpr Reg kPosReg = Reg::rax;
+/// The current character.
+constexpr Reg kCharReg = Reg::r9;
+/// Scratch registers.
+constexpr Reg kTempReg = Reg::r10;
+constexpr Reg kLimitReg = Reg::r11;
+
+/// Loops with a bound above this are not compiled, so that the distances
+/// they cover always fit in a displacement.
+constexpr uint32_t kMaxLoopBound = 1 << 24;
+
+/// Brackets with more ranges than this are not compiled.
+constexpr size_t kMaxRanges = 32;
+
+/// Space reserved for the code of an instruction, in addition to the code
+/// testing its characters.
+constexpr size_t kInsnSpace = 256;
+
+/// Space reserved for the code testing one range of characters.
+constexpr size_t kRangeSpace = 32;
+
+/// An inclusive range of characters.
+struct CharRange {
+  uint32_t first;
+  uint32_t last;
+};
+
+/// A set of characters, as sorted disjoint ranges.
+using CharSet = llvm::SmallVector<CharRange, 4>;
+
+constexpr uint32_t kMaxChar = 0xFFFF;
+
+/// Sort the ranges of \p set and merge those which overlap or are adjacent.
+void normalize(CharSet &set) {
+  std::sort(set.begin(), set.end(), [](CharRange a, CharRange b) {
+    return a.first < b.first;
+  });
+  CharSet result;
+  for (CharRange r : set) {
+    if (!result.empty() && r.first <= result.back().last + 1)
+      result.back().last = std::max(result.back().last, r.last);
+    else
+      result.push_back(r);
+  }
+  set = std::move(result);
+}
+
+/// \return the characters which are not in \p set.
+CharSet complement(const CharSet &set) {
+  CharSet result;
+  uint32_t next = 0;
+  for (CharRange r : set) {
+    if (r.first > next)
+      result.push_back({next, r.first - 1});
+    next = r.last + 1;
+  }
+  if (next <= kMaxChar)
+    result.push_back({next, kMaxChar});
+  return result;
+}
+
+/// Add the characters of the class \p type to \p set, following
+/// U16RegexTraits::characterHasType(). For ASCII characters this agrees with
+/// ASCIIRegexTraits.
+void addCharacterClass(CharacterClass::Type type, CharSet &set) {
+  switch (type) {
+    case CharacterClass::Digits:
+      set.push_back({'0', '9'});
+      return;
+    case CharacterClass::Spaces:
+      // WhiteSpace and LineTerminator, ES5.1 7.2 and 7.3.
+      for (CharRange r : {CharRange{0x09, 0x0D},
+                          CharRange{0x20, 0x20},
+                          CharRange{0xA0, 0xA0},
+                          CharRange{0x1680, 0x1680},
+                          CharRange{0x2000, 0x200A},
+                          CharRange{0x2028, 0x2029},
+                          CharRange{0x202F, 0x202F},
+                          CharRange{0x205F, 0x205F},
+                          CharRange{0x3000, 0x3000},
+                          CharRange{0xFEFF, 0xFEFF}})
+        set.push_back(r);
+      return;
+    case CharacterClass::Words:
+      for (CharRange r : {CharRange{'0', '9'},
+                          CharRange{'A', 'Z'},
+                          CharRange{'_', '_'},
+                          CharRange{'a', 'z'}})
+        set.push_back(r);
+      return;
+  }
+  llvm_unreachable("Unknown character type");
+}
+
+/// Compiles the instructions of a regexp program to a SearchFunction for
+/// input of a given character width.
+class RegExpCompiler {
+ public:
+  /// Prepare to compile \p bytecode for input whose characters have
+  /// \p charSize bytes, emitting the code in [\p begin, \p end).
+  RegExpCompiler(
+      llvm::ArrayRef<uint8_t> bytecode,
+      unsigned charSize,
+      uint8_t *begin,
+      uint8_t *end)
+      : bytecode_(bytecode), charSize_(charSize), emit_(begin), end_(end) {}
+
+  /// Emit the code of the program.
+  /// \return false if it cannot be compiled, see getErrorMessage().
+  bool compile();
+
+  /// \return the end of the emitted code.
+  uint8_t *current() const {
+    return emit_.current();
+  }
+
+  /// \return the number of slots used by the code.
+  uint32_t getSlotCount() const {
+    return loopSlotBase_ + 2 * loops_.size();
+  }
+
+  /// \return the reason why the program couldn't be compiled.
+  const std::string &getErrorMessage() const {
+    return errorMsg_;
+  }
+
+ private:
+  /// A position in the code, which may not have been emitted yet.
+  using Label = unsigned;
+
+  /// A loop which can give up (or take) characters when a later instruction
+  /// fails to match.
+  struct BacktrackingLoop {
+    const Width1LoopInsn *insn;
+    /// The characters matched by the loop body.
+    CharSet chars;
+    /// The index of the first of the two slots of the loop. A greedy loop
+    /// keeps the position where it may stop the earliest, a non-greedy one the
+    /// position where it must stop the latest. The second slot holds where it
+    /// currently stops.
+    uint32_t slot;
+    /// Where matching continues after the loop.
+    Label resume;
+    /// Where backtracking into the loop starts.
+    Label backtrack;
+    /// Where to go when the loop cannot backtrack anymore.
+    Label fail;
+  };
+
+  const RegexBytecodeHeader *header() const {
+    return reinterpret_cast<const RegexBytecodeHeader *>(bytecode_.data());
+  }
+
+  /// Record \p msg as the reason why the program can't be compiled.
+  /// \return false.
+  bool error(const char *msg) {
+    errorMsg_ = msg;
+    return false;
+  }
+
+  /// \return whether \p bytes can still be emitted.
+  bool ensureSpace(size_t bytes) {
+    if (static_cast<size_t>(end_ - emit_.current()) >= bytes)
+      return true;
+    return error("program too large");
+  }
+
+  Label newLabel() {
+    labels_.push_back(nullptr);
+    return labels_.size() - 1;
+  }
+
+  void bind(Label label) {
+    assert(!labels_[label] && "label bound twice");
+    labels_[label] = emit_.current();
+  }
+
+  /// Emit a jump to \p label.
+  void jump(Label label) {
+    if (const uint8_t *target = labels_[label]) {
+      emit_.jmp<OffsetType::Auto>(target);
+    } else {
+      emit_.jmp<OffsetType::Int32>(emit_.current());
+      fixups_.emplace_back(emit_.current(), label);
+    }
+  }
+
+  /// Emit a conditional jump to \p label.
+  template <CCode cc>
+  void jumpIf(Label label) {
+    if (const uint8_t *target = labels_[label]) {
+      emit_.cjump<cc, OffsetType::Auto>(target);
+    } else {
+      emit_.cjump<cc, OffsetType::Int32>(emit_.current());
+      fixups_.emplace_back(emit_.current(), label);
+    }
+  }
+
+  /// Point the jumps emitted before their label was bound to it.
+  void resolveFixups();
+
+  /// Compute the characters matched by the width 1 instruction \p insn into
+  /// \p chars. \return false if the instruction cannot be compiled.
+  bool getWidth1Chars(const Insn *insn, CharSet &chars);
+
+  /// Load the character at the current position into kCharReg.
+  void emitLoadChar();
+
+  /// Move the current position to the next character.
+  void emitAdvance();
+
+  /// Emit a jump to \p fail if the current position is at the end of the
+  /// input.
+  void emitCheckNotAtEnd(Label fail);
+
+  /// Emit code jumping to \p fail if kCharReg is not in \p chars.
+  void emitCharTest(const CharSet &chars, Label fail);
+
+  /// Emit a jump to \p target if kCharReg is in the range \p r (or is not in
+  /// it if \p ifIn is false).
+  void emitRangeJump(CharRange r, bool ifIn, Label target);
+
+  /// \return the displacement of the slot \p slot in the slots array.
+  static int32_t slotOffset(uint32_t slot) {
+    return slot * sizeof(void *);
+  }
+
+  /// Emit the code of the loop \p insn, jumping to \p fail if it cannot
+  /// match. \p fail is updated if the loop can backtrack.
+  bool emitWidth1Loop(const Width1LoopInsn *insn, Label &fail);
+
+  /// Emit the code backtracking into \p loop.
+  void emitBacktrack(const BacktrackingLoop &loop);
+
+  llvm::ArrayRef<uint8_t> bytecode_;
+  const unsigned charSize_;
+  Emitter emit_;
+  uint8_t *const end_;
+
+  /// The largest character which may occur in the input.
+  uint32_t maxInputChar() const {
+    return charSize_ == 1 ? 0xFF : kMaxChar;
+  }
+
+  /// The address of each label, or null if it hasn't been bound yet.
+  std::vector<const uint8_t *> labels_{};
+
+  /// The end of each jump to a label that wasn't bound when it was emitted.
+  std::vector<std::pair<uint8_t *, Label>> fixups_{};
+
+  /// The loops which can backtrack, in program order.
+  std::vector<BacktrackingLoop> loops_{};
+
+  /// The index of the first slot used by loops, after the captures.
+  uint32_t loopSlotBase_{0};
+
+  std::string errorMsg_{};
+};
+
+bool RegExpCompiler::getWidth1Chars(const Insn *insn, CharSet &chars) {
+  bool icase = header()->syntaxFlags & constants::icase;
+  switch (insn->opcode) {
+    case Opcode::MatchChar8: {
+      uint32_t c = (uint8_t)llvm::cast<MatchChar8Insn>(insn)->c;
+      chars.push_back({c, c});
+      return true;
+    }
+    case Opcode::MatchChar16: {
+      uint32_t c = llvm::cast<MatchChar16Insn>(insn)->c;
+      chars.push_back({c, c});
+      return true;
+    }
+    case Opcode::MatchCharICase8: {
+      // The character is case folded (upper case). No character outside of
+      // ASCII folds to an ASCII character, so the case variants of an ASCII
+      // letter are the only other matches.
+      uint32_t c = (uint8_t)llvm::cast<MatchCharICase8Insn>(insn)->c;
+      chars.push_back({c, c});
+      if ('A' <= c && c <= 'Z')
+        chars.push_back({c | 0x20, c | 0x20});
+      return true;
+    }
+    case Opcode::MatchAnyButNewline: {
+      CharSet lineTerminators;
+      lineTerminators.push_back({0x0A, 0x0A});
+      lineTerminators.push_back({0x0D, 0x0D});
+      lineTerminators.push_back({0x2028, 0x2029});
+      chars = complement(lineTerminators);
+      return true;
+    }
+    case Opcode::Bracket: {
+      if (icase)
+        return error("case insensitive bracket");
+      const auto *bracket = llvm::cast<BracketInsn>(insn);
+      const auto *ranges =
+          reinterpret_cast<const BracketRange16 *>(bracket + 1);
+      for (uint32_t i = 0; i != bracket->rangeCount; ++i)
+        chars.push_back({ranges[i].start, ranges[i].end});
+      for (auto type : {CharacterClass::Digits,
+                        CharacterClass::Spaces,
+                        CharacterClass::Words}) {
+        if (bracket->positiveCharClasses & type)
+          addCharacterClass(type, chars);
+        if (bracket->negativeCharClasses & type) {
+          CharSet set;
+          addCharacterClass(type, set);
+          normalize(set);
+          for (CharRange r : complement(set))
+            chars.push_back(r);
+        }
+      }
+      normalize(chars);
+      if (bracket->negate)
+        chars = complement(chars);
+      if (chars.size() > kMaxRanges)
+        return error("bracket too large");
+      return true;
+    }
+    default:
+      // MatchCharICase16 needs the Unicode case mapping.
+      return error("unsupported width 1 instruction");
+  }
+}
+
+void RegExpCompiler::emitLoadChar() {
+  if (charSize_ == 1)
+    emit_.movzxRMToReg<S::B>(kPosReg, Reg::NoIndex, 0, kCharReg);
+  else
+    emit_.movzxRMToReg<S::W>(kPosReg, Reg::NoIndex, 0, kCharReg);
+}
+
+void RegExpCompiler::emitAdvance() {
+  emit_.leaRMToReg<S::Q>(kPosReg, Reg::NoIndex, charSize_, kPosReg);
+}
+
+void RegExpCompiler::emitCheckNotAtEnd(Label fail) {
+  emit_.cmpRegToReg<S::Q>(kLastReg, kPosReg);
+  jumpIf<CCode::AE>(fail);
+}
+
+void RegExpCompiler::emitRangeJump(CharRange r, bool ifIn, Label target) {
+  if (r.first == r.last) {
+    emit_.cmpImmToRM<S::L, ScaleRegAccess>(
+        r.first, kCharReg, Reg::NoIndex, 0);
+    if (ifIn)
+      jumpIf<CCode::E>(target);
+    else
+      jumpIf<CCode::NE>(target);
+    return;
+  }
+  // Check both bounds with a single unsigned comparison of the distance to
+  // the start of the range.
+  Reg reg = kCharReg;
+  if (r.first != 0) {
+    emit_.leaRMToReg<S::L, S::Q>(
+        kCharReg, Reg::NoIndex, -(int32_t)r.first, kTempReg);
+    reg = kTempReg;
+  }
+  emit_.cmpImmToRM<S::L, ScaleRegAccess>(
+      r.last - r.first, reg, Reg::NoIndex, 0);
+  if (ifIn)
+    jumpIf<CCode::BE>(target);
+  else
+    jumpIf<CCode::A>(target);
+}
+
+void RegExpCompiler::emitCharTest(const CharSet &chars, Label fail) {
+  // Only the characters which fit in the input matter.
+  CharSet set;
+  for (CharRange r : chars) {
+    if (r.first > maxInputChar())
+      break;
+    set.push_back({r.first, std::min(r.last, maxInputChar())});
+  }
+  if (set.empty()) {
+    jump(fail);
+    return;
+  }
+  if (set.size() == 1 && set[0].first == 0 && set[0].last == maxInputChar())
+    return;
+  Label match = newLabel();
+  for (size_t i = 0, e = set.size() - 1; i != e; ++i)
+    emitRangeJump(set[i], true, match);
+  emitRangeJump(set.back(), false, fail);
+  bind(match);
+}
+
+bool RegExpCompiler::emitWidth1Loop(const Width1LoopInsn *insn, Label &fail) {
+  const Insn *body = reinterpret_cast<const Insn *>(insn + 1);
+  CharSet chars;
+  if (!getWidth1Chars(body, chars))
+    return false;
+  if (insn->min > kMaxLoopBound ||
+      (insn->max != UINT32_MAX && insn->max > kMaxLoopBound))
+    return error("loop bound too large");
+  if (!ensureSpace(kInsnSpace + 2 * kRangeSpace * chars.size()))
+    return false;
+
+  const int32_t minDist = insn->min * charSize_;
+  const bool canBacktrack = insn->min != insn->max;
+  const uint32_t slot = loopSlotBase_ + 2 * loops_.size();
+
+  // Compute where the loop must stop in kLimitReg: the end of the input, or
+  // after the maximum number of iterations if that comes earlier.
+  emit_.movRegToReg<S::Q>(kLastReg, kLimitReg);
+  if (insn->max != UINT32_MAX) {
+    Label limitIsLast = newLabel();
+    emit_.leaRMToReg<S::Q>(
+        kPosReg, Reg::NoIndex, insn->max * charSize_, kTempReg);
+    emit_.cmpRegToReg<S::Q>(kLastReg, kTempReg);
+    jumpIf<CCode::AE>(limitIsLast);
+    emit_.movRegToReg<S::Q>(kTempReg, kLimitReg);
+    bind(limitIsLast);
+  }
+
+  if (insn->greedy && canBacktrack) {
+    // Remember where the loop may stop the earliest, and match as many
+    // characters as possible.
+    emit_.leaRMToReg<S::Q>(kPosReg, Reg::NoIndex, minDist, kTempReg);
+    emit_.movRegToRM<S::Q>(kTempReg, kSlotsReg, Reg::NoIndex, slotOffset(slot));
+    Label scan = newLabel();
+    Label done = newLabel();
+    bind(scan);
+    emit_.cmpRegToReg<S::Q>(kLimitReg, kPosReg);
+    jumpIf<CCode::AE>(done);
+    emitLoadChar();
+    emitCharTest(chars, done);
+    emitAdvance();
+    jump(scan);
+    bind(done);
+    if (insn->min != 0) {
+      emit_.movRMToReg<S::Q>(
+          kSlotsReg, Reg::NoIndex, slotOffset(slot), kTempReg);
+      emit_.cmpRegToReg<S::Q>(kTempReg, kPosReg);
+      jumpIf<CCode::B>(fail);
+    }
+  } else {
+    // Remember where the loop must stop the latest, and match the minimum
+    // number of characters.
+    emit_.leaRMToReg<S::Q>(kPosReg, Reg::NoIndex, minDist, kTempReg);
+    emit_.cmpRegToReg<S::Q>(kLimitReg, kTempReg);
+    jumpIf<CCode::A>(fail);
+    if (canBacktrack) {
+      emit_.movRegToRM<S::Q>(
+          kLimitReg, kSlotsReg, Reg::NoIndex, slotOffset(slot));
+    }
+    if (insn->min != 0) {
+      // The character test clobbers kTempReg.
+      emit_.movRegToReg<S::Q>(kTempReg, kLimitReg);
+      Label scan = newLabel();
+      Label done = newLabel();
+      bind(scan);
+      emit_.cmpRegToReg<S::Q>(kLimitReg, kPosReg);
+      jumpIf<CCode::AE>(done);
+      emitLoadChar();
+      emitCharTest(chars, fail);
+      emitAdvance();
+      jump(scan);
+      bind(done);
+    }
+  }
+
+  if (!canBacktrack)
+    return true;
+
+  emit_.movRegToRM<S::Q>(
+      kPosReg, kSlotsReg, Reg::NoIndex, slotOffset(slot + 1));
+  BacktrackingLoop loop{insn, chars, slot, newLabel(), newLabel(), fail};
+  bind(loop.resume);
+  fail = loop.backtrack;
+  loops_.push_back(std::move(loop));
+  return true;
+}
+
+void RegExpCompiler::emitBacktrack(const BacktrackingLoop &loop) {
+  bind(loop.backtrack);
+  emit_.movRMToReg<S::Q>(
+      kSlotsReg, Reg::NoIndex, slotOffset(loop.slot + 1), kPosReg);
+  emit_.movRMToReg<S::Q>(
+      kSlotsReg, Reg::NoIndex, slotOffset(loop.slot), kTempReg);
+  emit_.cmpRegToReg<S::Q>(kTempReg, kPosReg);
+  if (loop.insn->greedy) {
+    // Give up the last character.
+    jumpIf<CCode::BE>(loop.fail);
+    emit_.leaRMToReg<S::Q>(kPosReg, Reg::NoIndex, -(int32_t)charSize_, kPosReg);
+  } else {
+    // Take one more character.
+    jumpIf<CCode::AE>(loop.fail);
+    emitLoadChar();
+    emitCharTest(loop.chars, loop.fail);
+    emitAdvance();
+  }
+  emit_.movRegToRM<S::Q>(
+      kPosReg, kSlotsReg, Reg::NoIndex, slotOffset(loop.slot + 1));
+  jump(loop.resume);
+}
+
+void RegExpCompiler::resolveFixups() {
+  for (const auto &fixup : fixups_) {
+    const uint8_t *target = labels_[fixup.second];
+    assert(target && "jump to a label which was never bound");
+    int32_t offset = target - fixup.first;
+    std::memcpy(fixup.first - sizeof(int32_t), &offset, sizeof(int32_t));
+  }
+  fixups_.clear();
+}
+
+bool RegExpCompiler::compile() {
+  if (bytecode_.size() < sizeof(RegexBytecodeHeader))
+    return error("bytecode too small");
+  const bool multiline = header()->syntaxFlags & constants::multiline;
+  // The match and every capture group have a slot for their start and end.
+  loopSlotBase_ = 2 * (header()->markedCount + 1);
+
+  const uint8_t *const insns = bytecode_.data() + sizeof(RegexBytecodeHeader);
+  const uint8_t *const insnsEnd = bytecode_.data() + bytecode_.size();
+
+  Label attempt = newLabel();
+  Label nextStart = newLabel();
+  Label noMatch = newLabel();
+
+  if (!ensureSpace(kInsnSpace))
+    return false;
+  bind(attempt);
+  emit_.movRegToReg<S::Q>(kStartReg, kPosReg);
+
+  // Where to go when the current instruction doesn't match: to the most
+  // recent loop which can backtrack, or to the next start position.
+  Label fail = nextStart;
+  const uint8_t *pc = insns;
+  for (;;) {
+    if (pc >= insnsEnd)
+      return error("missing goal");
+    const Insn *insn = reinterpret_cast<const Insn *>(pc);
+    if (!ensureSpace(kInsnSpace))
+      return false;
+    switch (insn->opcode) {
+      case Opcode::Goal:
+        emit_.movRegToRM<S::Q>(
+            kStartReg, kSlotsReg, Reg::NoIndex, slotOffset(0));
+        emit_.movRegToRM<S::Q>(kPosReg, kSlotsReg, Reg::NoIndex, slotOffset(1));
+        emit_.movImmToReg<S::L>(1, Reg::eax);
+        emit_.retq();
+        break;
+
+      case Opcode::LeftAnchor:
+        if (multiline)
+          return error("multiline anchor");
+        emit_.cmpRegToReg<S::Q>(kAnchorReg, kPosReg);
+        jumpIf<CCode::NE>(fail);
+        pc += sizeof(LeftAnchorInsn);
+        continue;
+
+      case Opcode::RightAnchor:
+        if (multiline)
+          return error("multiline anchor");
+        emit_.cmpRegToReg<S::Q>(kLastReg, kPosReg);
+        jumpIf<CCode::NE>(fail);
+        pc += sizeof(RightAnchorInsn);
+        continue;
+
+      case Opcode::BeginMarkedSubexpression:
+        emit_.movRegToRM<S::Q>(
+            kPosReg,
+            kSlotsReg,
+            Reg::NoIndex,
+            slotOffset(
+                2 * llvm::cast<BeginMarkedSubexpressionInsn>(insn)->mexp));
+        pc += sizeof(BeginMarkedSubexpressionInsn);
+        continue;
+
+      case Opcode::EndMarkedSubexpression:
+        emit_.movRegToRM<S::Q>(
+            kPosReg,
+            kSlotsReg,
+            Reg::NoIndex,
+            slotOffset(
+                2 * llvm::cast<EndMarkedSubexpressionInsn>(insn)->mexp + 1));
+        pc += sizeof(EndMarkedSubexpressionInsn);
+        continue;
+
+      case Opcode::Width1Loop: {
+        const auto *loop = llvm::cast<Width1LoopInsn>(insn);
+        if (!emitWidth1Loop(loop, fail))
+          return false;
+        pc = insns + loop->notTakenTarget;
+        continue;
+      }
+
+      case Opcode::MatchChar8:
+      case Opcode::MatchChar16:
+      case Opcode::MatchCharICase8:
+      case Opcode::MatchCharICase16:
+      case Opcode::MatchAnyButNewline:
+      case Opcode::Bracket: {
+        CharSet chars;
+        if (!getWidth1Chars(insn, chars) ||
+            !ensureSpace(kInsnSpace + kRangeSpace * chars.size()))
+          return false;
+        emitCheckNotAtEnd(fail);
+        emitLoadChar();
+        emitCharTest(chars, fail);
+        emitAdvance();
+        switch (insn->opcode) {
+          case Opcode::MatchChar8:
+            pc += sizeof(MatchChar8Insn);
+            break;
+          case Opcode::MatchChar16:
+            pc += sizeof(MatchChar16Insn);
+            break;
+          case Opcode::MatchCharICase8:
+            pc += sizeof(MatchCharICase8Insn);
+            break;
+          case Opcode::MatchAnyButNewline:
+            pc += sizeof(MatchAnyButNewlineInsn);
+            break;
+          default:
+            pc += llvm::cast<BracketInsn>(insn)->totalWidth();
+            break;
+        }
+        continue;
+      }
+
+      default:
+        // Alternations, other loops, lookaheads, backreferences and word
+        // boundaries may require backtracking into arbitrary instructions.
+        return error("unsupported instruction");
+    }
+    break;
+  }
+
+  // Backtracking into the loops.
+  for (const BacktrackingLoop &loop : loops_) {
+    if (!ensureSpace(kInsnSpace + kRangeSpace * loop.chars.size()))
+      return false;
+    emitBacktrack(loop);
+  }
+
+  // Try the next start position, if there is one.
+  if (!ensureSpace(kInsnSpace))
+    return false;
+  bind(nextStart);
+  emit_.testRegToReg<S::L>(kOnlyAtStartReg, kOnlyAtStartReg);
+  jumpIf<CCode::NZ>(noMatch);
+  emit_.cmpRegToReg<S::Q>(kLastReg, kStartReg);
+  jumpIf<CCode::AE>(noMatch);
+  emit_.leaRMToReg<S::Q>(kStartReg, Reg::NoIndex, charSize_, kStartReg);
+  jump(attempt);
+
+  bind(noMatch);
+  emit_.xorRegToReg<S::L>(Reg::eax, Reg::eax);
+  emit_.retq();
+
+  resolveFixups();
+  return true;
+}
+
+} // namespace
+
+std::unique_ptr<JITCompiledRegExp> JITCompiledRegExp::compile(
+    JITContext &context,
+    llvm::ArrayRef<uint8_t> bytecode) {
+  // Emit both functions in a scratch buffer first, since their size is not
+  // known in advance. The code only contains relative jumps within itself,
+  // so it can be copied to executable memory afterwards.
+  constexpr size_t kMaxCodeSize = 1 << 16;
+  std::vector<uint8_t> buffer(kMaxCodeSize);
+  uint8_t *const bufferEnd = buffer.data() + buffer.size();
+
+  RegExpCompiler compiler8{bytecode, 1, buffer.data(), bufferEnd};
+  bool ok = compiler8.compile();
+  uint8_t *const code16 = compiler8.current();
+  RegExpCompiler compiler16{bytecode, 2, code16, bufferEnd};
+  ok = ok && compiler16.compile();
+  if (!ok) {
+    if (context.getReportBailouts()) {
+      const std::string &msg = compiler8.getErrorMessage().empty()
+          ? compiler16.getErrorMessage()
+          : compiler8.getErrorMessage();
+      llvm::errs() << "RegExp JIT bailout: " << msg << "\n";
+    }
+    return nullptr;
+  }
+  size_t codeSize = compiler16.current() - buffer.data();
+
+  ExecHeap &heap = context.getHeap();
+  ExecHeap::SizePair sizes{codeSize, 0};
+  auto blocks = heap.alloc(sizes);
+  if (!blocks) {
+    ExecHeap::DualPool *newPool = heap.addPool();
+    if (!newPool)
+      return nullptr;
+    blocks = newPool->alloc(sizes);
+    if (!blocks)
+      return nullptr;
+  }
+  std::memcpy(blocks->first, buffer.data(), codeSize);
+  heap.invalidateInstructionCache(blocks->first, codeSize);
+
+  if (context.getDumpJITCode()) {
+    context.getDisassembler().disassembleBuffer(
+        llvm::outs(), {blocks->first, blocks->first + codeSize}, 0, false);
+  }
+
+  const auto *header =
+      reinterpret_cast<const RegexBytecodeHeader *>(bytecode.data());
+  return std::unique_ptr<JITCompiledRegExp>(new JITCompiledRegExp(
+      heap,
+      *blocks,
+      reinterpret_cast<SearchFunction>(blocks->first),
+      reinterpret_cast<SearchFunction>(
+          blocks->first + (code16 - buffer.data())),
+      header->markedCount,
+      std::max(compiler8.getSlotCount(), compiler16.getSlotCount()),
+      header->constraints));
+}
+
+JITCompiledRegExp::~JITCompiledRegExp() {
+  heap_.free(blocks_);
+}
+
+template <typename CharT>
+MatchRuntimeResult JITCompiledRegExp::searchImpl(
+    SearchFunction fn,
+    const CharT *first,
+    const CharT *last,
+    MatchResults<const CharT *> &m,
+    constants::MatchFlagType matchFlags) const {
+  assert(
+      !(matchFlags &
+        (constants::matchNotBeginningOfLine | constants::matchNotEndOfLine)) &&
+      "unsupported match flags");
+  if ((constraints_ & MatchConstraintNonASCII) &&
+      (matchFlags & constants::matchInputAllAscii))
+    return MatchRuntimeResult::NoMatch;
+  bool prevCharAvailable = matchFlags & constants::matchPreviousCharAvailable;
+  bool onlyAtStart = constraints_ & MatchConstraintAnchoredAtStart;
+  if (onlyAtStart && prevCharAvailable)
+    return MatchRuntimeResult::NoMatch;
+
+  llvm::SmallVector<const void *, 16> slots(slotCount_);
+  if (!fn(first,
+          last,
+          slots.data(),
+          prevCharAvailable ? nullptr : first,
+          onlyAtStart))
+    return MatchRuntimeResult::NoMatch;
+
+  // The programs have no alternations, so every capture group participates
+  // in a match.
+  m.resize(1 + markedCount_);
+  for (uint32_t idx = 0; idx <= markedCount_; ++idx) {
+    m[idx].first = static_cast<const CharT *>(slots[2 * idx]);
+    m[idx].second = static_cast<const CharT *>(slots[2 * idx + 1]);
+    m[idx].matched = true;
+  }
+  return MatchRuntimeResult::Match;
+}
+
+MatchRuntimeResult JITCompiledRegExp::search(
+    const char16_t *first,
+    const char16_t *last,
+    MatchResults<const char16_t *> &m,
+    constants::MatchFlagType matchFlags) const {
+  return searchImpl(search16_, first, last, m, matchFlags);
+}
+
+MatchRuntimeResult JITCompiledRegExp::search(
+    const char *first,
+    const char *last,
+    MatchResults<const char *> &m,
+    constants::MatchFlagType matchFlags) const {
+  return searchImpl(search8_, first, last, m, matchFlags);
+}
+
+} // namespace x86_64
+} // namespace vm
+} // namespace hermes
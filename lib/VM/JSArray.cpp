@@ -33,7 +33,7 @@ bool ArrayImpl::_haveOwnIndexedImpl(
   // Check whether the index is within the storage.
   if (index >= self->beginIndex_ && index < self->endIndex_)
     return !self->indexedStorage_.getNonNull(runtime)
-                ->at(index - self->beginIndex_)
+                ->at(self->storageSlot(index))
                 .isEmpty();
 
   return false;
@@ -48,7 +48,7 @@ OptValue<PropertyFlags> ArrayImpl::_getOwnIndexedPropertyFlagsImpl(
   // Check whether the index is within the storage.
   if (index >= self->beginIndex_ && index < self->endIndex_ &&
       !self->indexedStorage_.getNonNull(runtime)
-           ->at(index - self->beginIndex_)
+           ->at(self->storageSlot(index))
            .isEmpty()) {
     PropertyFlags indexedElementFlags{};
     indexedElementFlags.enumerable = 1;
@@ -81,14 +81,38 @@ HermesValue ArrayImpl::_getOwnIndexedImpl(
   return vmcast<ArrayImpl>(selfObj)->at(runtime, index);
 }
 
+ExecutionStatus ArrayImpl::copySharedStorage(
+    Handle<ArrayImpl> selfHandle,
+    Runtime *runtime) {
+  assert(selfHandle->storageShared_ && "storage is not shared");
+  assert(
+      selfHandle->storageBegin_ == 0 && "shared storage has unused slots");
+  auto size = selfHandle->endIndex_ - selfHandle->beginIndex_;
+  auto arrRes = StorageType::create(runtime, size, size);
+  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto *copy = vmcast<StorageType>(*arrRes);
+  auto *shared = selfHandle->indexedStorage_.getNonNull(runtime);
+  for (size_type i = 0; i != size; ++i)
+    copy->at(i).set(shared->at(i), &runtime->getHeap());
+
+  selfHandle->indexedStorage_.set(runtime, copy, &runtime->getHeap());
+  selfHandle->storageShared_ = false;
+  return ExecutionStatus::RETURNED;
+}
+
 ExecutionStatus ArrayImpl::setStorageEndIndex(
     Handle<ArrayImpl> selfHandle,
     Runtime *runtime,
     uint32_t newLength) {
-  auto *self = selfHandle.get();
-
   if (LLVM_UNLIKELY(newLength > StorageType::maxElements()))
     return runtime->raiseRangeError("Out of memory for array elements");
+  if (LLVM_UNLIKELY(
+          unshareStorage(selfHandle, runtime) == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+
+  auto *self = selfHandle.get();
 
   // If indexedStorage hasn't even been allocated.
   if (LLVM_UNLIKELY(!self->indexedStorage_)) {
@@ -104,10 +128,15 @@ ExecutionStatus ArrayImpl::setStorageEndIndex(
         runtime, newStorage.get(), &runtime->getHeap());
     selfHandle->beginIndex_ = 0;
     selfHandle->endIndex_ = newLength;
+    selfHandle->mayHaveHoles_ = true;
     return ExecutionStatus::RETURNED;
   }
 
   auto beginIndex = self->beginIndex_;
+  auto storageBegin = self->storageBegin_;
+  // Growing the storage fills it with holes.
+  if (newLength > self->endIndex_)
+    self->mayHaveHoles_ = true;
 
   /// resizeWithinCapacity can allocate, wrap the indexedStorage in a handle.
   auto indexedStorage =
@@ -116,17 +145,23 @@ ExecutionStatus ArrayImpl::setStorageEndIndex(
   if (newLength < beginIndex) {
     // the new length is prior to beginIndex, clearing the storage.
     selfHandle->endIndex_ = beginIndex;
+    selfHandle->storageBegin_ = 0;
     StorageType::resizeWithinCapacity(std::move(indexedStorage), runtime, 0);
     return ExecutionStatus::RETURNED;
   } else if (
-      newLength - beginIndex <=
+      newLength - beginIndex + storageBegin <=
       self->indexedStorage_.getNonNull(runtime)->capacity()) {
     selfHandle->endIndex_ = newLength;
     StorageType::resizeWithinCapacity(
-        std::move(indexedStorage), runtime, newLength - beginIndex);
+        std::move(indexedStorage),
+        runtime,
+        newLength - beginIndex + storageBegin);
     return ExecutionStatus::RETURNED;
   }
 
+  // The storage is reallocated, drop its unused slots.
+  self->compactStorage(runtime);
+
   auto indexedStorageHandle =
       runtime->makeMutableHandle(selfHandle->indexedStorage_);
 
@@ -146,17 +181,28 @@ CallResult<bool> ArrayImpl::_setOwnIndexedImpl(
     Runtime *runtime,
     uint32_t index,
     Handle<> value) {
+  if (LLVM_UNLIKELY(vmcast<ArrayImpl>(selfHandle.get())->flags_.frozen))
+    return false;
+  if (LLVM_UNLIKELY(
+          unshareStorage(Handle<ArrayImpl>::vmcast(selfHandle), runtime) ==
+          ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+
   auto *self = vmcast<ArrayImpl>(selfHandle.get());
   auto beginIndex = self->beginIndex_;
   auto endIndex = self->endIndex_;
 
-  if (LLVM_UNLIKELY(self->flags_.frozen))
-    return false;
+  self->noteElementValue(value.get());
+  // Writing past the end, or before the start (which means there is also a
+  // hole at index 0), leaves holes.
+  if (index > endIndex || (index < beginIndex && index + 1 != beginIndex) ||
+      (index != 0 && beginIndex == endIndex))
+    self->mayHaveHoles_ = true;
 
   // Check whether the index is within the storage.
   if (LLVM_LIKELY(index >= beginIndex && index < endIndex)) {
     self->indexedStorage_.getNonNull(runtime)
-        ->at(index - beginIndex)
+        ->at(self->storageSlot(index))
         .set(value.get(), &runtime->getHeap());
     return true;
   }
@@ -181,20 +227,28 @@ CallResult<bool> ArrayImpl::_setOwnIndexedImpl(
 
   auto indexedStorage =
       createPseudoHandle(self->indexedStorage_.getNonNull(runtime));
+  auto storageBegin = self->storageBegin_;
 
   // Can we do it without reallocation for sure?
-  if (index >= endIndex && index - beginIndex < indexedStorage->capacity()) {
+  if (index >= endIndex &&
+      index - beginIndex + storageBegin < indexedStorage->capacity()) {
     self->endIndex_ = index + 1;
     StorageType::resizeWithinCapacity(
-        std::move(indexedStorage), runtime, index - beginIndex + 1);
+        std::move(indexedStorage),
+        runtime,
+        index - beginIndex + storageBegin + 1);
     // Go from selfHandle because the indexedStorage may have changed.
     self = vmcast<ArrayImpl>(selfHandle.get());
     self->indexedStorage_.getNonNull(runtime)
-        ->at(index - beginIndex)
+        ->at(self->storageSlot(index))
         .set(value.get(), &runtime->getHeap());
     return true;
   }
 
+  // The storage is reallocated or its elements are moved, drop its unused
+  // slots first.
+  self->compactStorage(runtime);
+
   auto indexedStorageHandle = runtime->makeMutableHandle(self->indexedStorage_);
   // We only shift an array if the shift amount is within the limit.
   constexpr uint32_t shiftLimit = (1 << 20);
@@ -275,8 +329,19 @@ bool ArrayImpl::_deleteOwnIndexedImpl(
   auto *self = vmcast<ArrayImpl>(selfHandle.get());
 
   if (index >= self->beginIndex_ && index < self->endIndex_) {
-    auto &elem = self->indexedStorage_.getNonNull(runtime)->at(
-        index - self->beginIndex_);
+    if (LLVM_UNLIKELY(self->storageShared_)) {
+      // Deleting can't report an allocation failure, but the copy is no
+      // larger than the storage it replaces.
+      auto status =
+          unshareStorage(Handle<ArrayImpl>::vmcast(selfHandle), runtime);
+      (void)status;
+      assert(
+          status != ExecutionStatus::EXCEPTION &&
+          "failed to copy the shared storage");
+      self = vmcast<ArrayImpl>(selfHandle.get());
+    }
+    auto &elem =
+        self->indexedStorage_.getNonNull(runtime)->at(self->storageSlot(index));
 
     // Cannot delete indexed elements if we are sealed.
     if (LLVM_UNLIKELY(self->flags_.sealed))
@@ -284,6 +349,17 @@ bool ArrayImpl::_deleteOwnIndexedImpl(
         return false;
 
     elem.setNonPtr(HermesValue::encodeEmptyValue());
+    if (index + 1 == self->endIndex_) {
+      // Deleting the last element (e.g. in Array.prototype.pop()) just
+      // shortens the storage, so it doesn't leave a hole.
+      self->endIndex_ = index;
+      StorageType::resizeWithinCapacity(
+          createPseudoHandle(self->indexedStorage_.getNonNull(runtime)),
+          runtime,
+          self->storageSlot(index));
+    } else {
+      self->mayHaveHoles_ = true;
+    }
   }
 
   return true;
@@ -298,13 +374,141 @@ bool ArrayImpl::_checkAllOwnIndexedImpl(
 
   // If we have any indexed properties at all, they don't satisfy the
   // requirements.
-  for (uint32_t i = 0, e = self->endIndex_ - self->beginIndex_; i != e; ++i) {
-    if (!self->indexedStorage_.getNonNull(runtime)->at(i).isEmpty())
+  for (uint32_t i = self->beginIndex_, e = self->endIndex_; i != e; ++i) {
+    if (!self->indexedStorage_.getNonNull(runtime)
+             ->at(self->storageSlot(i))
+             .isEmpty())
       return false;
   }
   return true;
 }
 
+void ArrayImpl::compactStorage(Runtime *runtime) {
+  if (LLVM_LIKELY(storageBegin_ == 0))
+    return;
+  assert(!storageShared_ && "cannot move the elements of shared storage");
+  auto indexedStorageHandle = runtime->makeMutableHandle(indexedStorage_);
+  // Shrinking doesn't allocate, so the storage stays where it is.
+  auto status = StorageType::resizeLeft(
+      indexedStorageHandle,
+      runtime,
+      indexedStorageHandle->size() - storageBegin_);
+  (void)status;
+  assert(
+      status != ExecutionStatus::EXCEPTION &&
+      indexedStorageHandle.get() == indexedStorage_.get(runtime) &&
+      "shrinking the storage failed");
+  storageBegin_ = 0;
+}
+
+CallResult<HermesValue> ArrayImpl::unsafeShift(
+    Handle<ArrayImpl> selfHandle,
+    Runtime *runtime) {
+  assert(selfHandle->hasFastPackedElements() && "array may have holes");
+  assert(
+      selfHandle->beginIndex_ == 0 && selfHandle->endIndex_ != 0 &&
+      "array must have elements starting at index 0");
+  assert(selfHandle->isExtensible() && "array cannot be modified");
+  if (LLVM_UNLIKELY(
+          unshareStorage(selfHandle, runtime) == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+
+  auto *self = selfHandle.get();
+  auto *storage = self->indexedStorage_.getNonNull(runtime);
+  auto &slot = storage->at(self->storageBegin_);
+  HermesValue first = slot;
+  slot.setNonPtr(HermesValue::encodeEmptyValue());
+  ++self->storageBegin_;
+  --self->endIndex_;
+  // Moving the remaining elements once the unused slots outnumber them costs
+  // at most one move per shifted element.
+  if (self->storageBegin_ > self->endIndex_)
+    self->compactStorage(runtime);
+  return first;
+}
+
+ExecutionStatus ArrayImpl::unsafeGrowStorageLeft(
+    Handle<ArrayImpl> selfHandle,
+    Runtime *runtime,
+    size_type count) {
+  assert(
+      (selfHandle->beginIndex_ == 0 ||
+       selfHandle->beginIndex_ == selfHandle->endIndex_) &&
+      "array must start at index 0");
+  assert(selfHandle->isExtensible() && "array cannot be modified");
+  if (LLVM_UNLIKELY(
+          unshareStorage(selfHandle, runtime) == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+
+  auto *self = selfHandle.get();
+  size_type size = self->endIndex_ - self->beginIndex_;
+  if (LLVM_UNLIKELY(count > StorageType::maxElements() - size))
+    return runtime->raiseRangeError("Out of memory for array elements");
+  if (size == 0) {
+    // There is nothing to move, the array starts over at index 0.
+    self->beginIndex_ = self->endIndex_ = 0;
+    self->storageBegin_ = 0;
+    return setStorageEndIndex(selfHandle, runtime, count);
+  }
+
+  if (self->storageBegin_ < count) {
+    size_type extra = count - self->storageBegin_ +
+        std::min(size, StorageType::maxElements() - size - count);
+    auto indexedStorageHandle =
+        runtime->makeMutableHandle(self->indexedStorage_);
+    if (LLVM_UNLIKELY(
+            StorageType::resizeLeft(
+                indexedStorageHandle,
+                runtime,
+                indexedStorageHandle->size() + extra) ==
+            ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+    self = selfHandle.get();
+    self->indexedStorage_.set(
+        runtime, indexedStorageHandle.get(), &runtime->getHeap());
+    self->storageBegin_ += extra;
+  }
+
+  self->storageBegin_ -= count;
+  self->endIndex_ += count;
+  self->mayHaveHoles_ = true;
+  return ExecutionStatus::RETURNED;
+}
+
+ExecutionStatus ArrayImpl::unsafeCopyElements(
+    Handle<ArrayImpl> selfHandle,
+    Runtime *runtime,
+    size_type to,
+    Handle<ArrayImpl> srcHandle,
+    size_type from,
+    size_type count) {
+  assert(!selfHandle->flags_.frozen && "cannot write to a frozen array");
+  if (LLVM_UNLIKELY(
+          unshareStorage(selfHandle, runtime) == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  if (count == 0)
+    return ExecutionStatus::RETURNED;
+
+  auto *self = selfHandle.get();
+  auto *src = srcHandle.get();
+  assert(
+      to >= self->beginIndex_ && to <= self->endIndex_ &&
+      count <= self->endIndex_ - to && "destination out of range");
+  assert(
+      from >= src->beginIndex_ && from <= src->endIndex_ &&
+      count <= src->endIndex_ - from && "source out of range");
+  self->mayHaveHoles_ |= src->mayHaveHoles_;
+  self->mayHaveNonNumbers_ |= src->mayHaveNonNumbers_;
+  StorageType::copyRange(
+      runtime,
+      src->indexedStorage_.getNonNull(runtime),
+      src->storageSlot(from),
+      self->indexedStorage_.getNonNull(runtime),
+      self->storageSlot(to),
+      count);
+  return ExecutionStatus::RETURNED;
+}
+
 //===----------------------------------------------------------------------===//
 // class Arguments
 
@@ -509,6 +713,18 @@ JSArray::create(Runtime *runtime, size_type capacity, size_type length) {
   return PseudoHandle<JSArray>::create(vmcast<JSArray>(*res));
 }
 
+CallResult<PseudoHandle<JSArray>> JSArray::createWithSharedStorage(
+    Runtime *runtime,
+    Handle<StorageType> storage,
+    bool allNumbers) {
+  auto arrRes = JSArray::create(runtime, 0, 0);
+  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  unsafeUseSharedStorage(arrRes->get(), runtime, *storage, allNumbers);
+  putLength(arrRes->get(), runtime, storage->size());
+  return arrRes;
+}
+
 CallResult<bool> JSArray::setLength(
     Handle<JSArray> selfHandle,
     Runtime *runtime,
@@ -6,11 +6,38 @@
  */
 #include "hermes/VM/JSArrayBuffer.h"
 
+#include "hermes/Support/OSCompat.h"
 #include "hermes/VM/BuildMetadata.h"
 
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/MathExtras.h"
+
 namespace hermes {
 namespace vm {
 
+namespace {
+
+/// Zeroed data blocks of at least this many bytes are mapped from the OS,
+/// which fills their pages with zeros on first touch. calloc() may have to
+/// clear memory it reuses, touching the whole block up front.
+constexpr JSArrayBuffer::size_type kMinMappedDataBlockSize = 1 << 20;
+
+/// \return the size of the mapping holding a data block of \p size bytes.
+size_t mappedDataBlockSize(JSArrayBuffer::size_type size) {
+  return llvm::alignTo(size, oscompat::page_size());
+}
+
+/// Free the \p size bytes of \p data allocated by createDataBlock().
+void freeDataBlock(char *data, JSArrayBuffer::size_type size, bool mapped) {
+  if (mapped) {
+    oscompat::vm_free(data, mappedDataBlockSize(size));
+  } else {
+    free(data);
+  }
+}
+
+} // namespace
+
 //===----------------------------------------------------------------------===//
 // class JSArrayBuffer
 
@@ -116,6 +143,19 @@ JSArrayBuffer::~JSArrayBuffer() {
 
 void JSArrayBuffer::_finalizeImpl(GCCell *cell, GC *gc) {
   auto *self = vmcast<JSArrayBuffer>(cell);
+  if (self->data_ && !self->externalOwner_) {
+    // Nothing else can refer to the data of an unreachable buffer, so it may
+    // be freed outside the collection.
+    gc->debitExternalMemory(self, self->size_);
+    if (self->mapped_) {
+      freeDataBlock(self->data_, self->size_, /* mapped */ true);
+      self->mapped_ = false;
+    } else {
+      gc->freeFinalizedMemory(self->data_);
+    }
+    self->data_ = nullptr;
+    self->size_ = 0;
+  }
   self->detach(gc);
   self->~JSArrayBuffer();
 }
@@ -126,11 +166,18 @@ size_t JSArrayBuffer::_mallocSizeImpl(GCCell *cell) {
 }
 
 void JSArrayBuffer::detach(GC *gc) {
-  if (data_) {
+  if (externalOwner_) {
+    gc->debitExternalMemory(this, size_);
+    delete externalOwner_;
+    externalOwner_ = nullptr;
+    data_ = nullptr;
+    size_ = 0;
+  } else if (data_) {
     gc->debitExternalMemory(this, size_);
-    free(data_);
+    freeDataBlock(data_, size_, mapped_);
     data_ = nullptr;
     size_ = 0;
+    mapped_ = false;
   } else {
     assert(size_ == 0);
   }
@@ -139,6 +186,47 @@ void JSArrayBuffer::detach(GC *gc) {
   attached_ = false;
 }
 
+namespace {
+
+/// Owns a data block allocated by createDataBlock() once it has been released
+/// from its buffer.
+class MallocedDataBlockOwner final : public ExternalArrayBufferOwner {
+ public:
+  MallocedDataBlockOwner(char *data, size_t size, bool mapped)
+      : data_(data), size_(size), mapped_(mapped) {}
+  ~MallocedDataBlockOwner() override {
+    freeDataBlock(data_, size_, mapped_);
+  }
+
+ private:
+  char *data_;
+  size_t size_;
+  bool mapped_;
+};
+
+} // namespace
+
+std::unique_ptr<ExternalArrayBufferOwner>
+JSArrayBuffer::releaseDataBlock(GC *gc, char **data, size_type *size) {
+  std::unique_ptr<ExternalArrayBufferOwner> owner;
+  if (externalOwner_) {
+    owner.reset(externalOwner_);
+  } else if (data_) {
+    owner = llvm::make_unique<MallocedDataBlockOwner>(data_, size_, mapped_);
+  }
+  if (owner) {
+    gc->debitExternalMemory(this, size_);
+  }
+  *data = data_;
+  *size = size_;
+  externalOwner_ = nullptr;
+  data_ = nullptr;
+  size_ = 0;
+  mapped_ = false;
+  attached_ = false;
+  return owner;
+}
+
 ExecutionStatus
 JSArrayBuffer::createDataBlock(Runtime *runtime, size_type size, bool zero) {
   detach(&runtime->getHeap());
@@ -155,10 +243,20 @@ JSArrayBuffer::createDataBlock(Runtime *runtime, size_type size, bool zero) {
         "Cannot allocate a data block for the ArrayBuffer");
   }
 
+  if (zero && size >= kMinMappedDataBlockSize) {
+    auto result = oscompat::vm_allocate(mappedDataBlockSize(size));
+    if (result) {
+      oscompat::vm_name(*result, mappedDataBlockSize(size), "hermes-abuf");
+      data_ = static_cast<char *>(*result);
+      mapped_ = true;
+    }
+  }
   // Note that the result of calloc or malloc is immediately checked below, so
   // we don't use the checked versions.
-  data_ = zero ? static_cast<char *>(calloc(sizeof(char), size))
-               : static_cast<char *>(malloc(sizeof(char) * size));
+  if (!mapped_) {
+    data_ = zero ? static_cast<char *>(calloc(sizeof(char), size))
+                 : static_cast<char *>(malloc(sizeof(char) * size));
+  }
   if (data_ == nullptr) {
     // Failed to allocate.
     return runtime->raiseRangeError(
@@ -171,5 +269,23 @@ JSArrayBuffer::createDataBlock(Runtime *runtime, size_type size, bool zero) {
   }
 }
 
+ExecutionStatus JSArrayBuffer::setExternalDataBlock(
+    Runtime *runtime,
+    char *data,
+    size_type size,
+    std::unique_ptr<ExternalArrayBufferOwner> owner) {
+  detach(&runtime->getHeap());
+  if (LLVM_UNLIKELY(!runtime->getHeap().canAllocExternalMemory(size))) {
+    return runtime->raiseRangeError(
+        "Cannot account for the external data block of the ArrayBuffer");
+  }
+  attached_ = true;
+  data_ = data;
+  size_ = size;
+  externalOwner_ = owner.release();
+  runtime->getHeap().creditExternalMemory(this, size);
+  return ExecutionStatus::RETURNED;
+}
+
 } // namespace vm
 } // namespace hermes
@@ -33,7 +33,7 @@ ObjectVTable JSError::vt{
 void ErrorBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
   ObjectBuildMeta(cell, mb);
   const auto *self = static_cast<const JSError *>(cell);
-  mb.addField("@funcNames", &self->funcNames_);
+  mb.addField("@callees", &self->callees_);
   mb.addField("@domains", &self->domains_);
 }
 
@@ -148,63 +148,38 @@ ExecutionStatus JSError::setMessage(
       .getStatus();
 }
 
-/// \return a list of function names associated with the call stack \p frames.
-/// Function names are read out of the 'name' property of each Callable on the
-/// stack, except that accessors are skipped. If a Callable does not have a
-/// name, or if the name is an accessor, undefined is set. Names are returned in
-/// reverse order (topmost frame is first).
+/// \return the callees of the call stack, in reverse order (topmost frame is
+/// first): the Callable of each frame, or the native CodeBlock pointer of
+/// frames without one. The names of the callees are only looked up if the
+/// stack trace string is built, so that throwing doesn't pay for it.
 /// In case of error returns a nullptr handle.
 /// \param skipTopFrame if true, skip the top frame.
-static Handle<PropStorage> getCallStackFunctionNames(
-    Runtime *runtime,
-    bool skipTopFrame,
-    size_t sizeHint) {
-  auto arrRes = PropStorage::create(runtime, sizeHint);
+/// \param size the number of frames to record.
+static Handle<PropStorage>
+getCallStackCallees(Runtime *runtime, bool skipTopFrame, size_t size) {
+  auto arrRes = PropStorage::create(runtime, size, size);
   if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
     runtime->clearThrownValue();
     return runtime->makeNullHandle<PropStorage>();
   }
-  MutableHandle<PropStorage> names{runtime, vmcast<PropStorage>(*arrRes)};
-
-  GCScope gcScope(runtime);
-  MutableHandle<> name{runtime};
-  auto marker = gcScope.createMarker();
+  auto callees = runtime->makeHandle<PropStorage>(*arrRes);
 
   uint32_t frameIndex = 0;
-  uint32_t namesIndex = 0;
+  uint32_t calleesIndex = 0;
   for (StackFramePtr cf : runtime->getStackFrames()) {
     if (frameIndex++ == 0 && skipTopFrame)
       continue;
-
-    name = HermesValue::encodeUndefinedValue();
-    if (auto callableHandle = Handle<Callable>::dyn_vmcast(
-            runtime, Handle<>(&cf.getCalleeClosureOrCBRef()))) {
-      NamedPropertyDescriptor desc;
-      JSObject *propObj = JSObject::getNamedDescriptor(
-          callableHandle,
-          runtime,
-          Predefined::getSymbolID(Predefined::name),
-          desc);
-      if (propObj && !desc.flags.accessor)
-        name = JSObject::getNamedSlotValue(propObj, runtime, desc);
-    } else if (cf.getCalleeClosureOrCBRef().isNativeValue()) {
-      auto *cb =
-          cf.getCalleeClosureOrCBRef().getNativePointer<const CodeBlock>();
-      if (cb->getNameMayAllocate().isValid())
-        name = HermesValue::encodeStringValue(
-            runtime->getStringPrimFromSymbolID(cb->getNameMayAllocate()));
-    }
-    if (PropStorage::resize(names, runtime, namesIndex + 1) ==
-        ExecutionStatus::EXCEPTION) {
-      runtime->clearThrownValue();
-      return runtime->makeNullHandle<PropStorage>();
-    }
-    names->at(namesIndex).set(name.getHermesValue(), &runtime->getHeap());
-    ++namesIndex;
-    gcScope.flushToMarker(marker);
+    if (calleesIndex == size)
+      break;
+    HermesValue callee = cf.getCalleeClosureOrCBRef();
+    callees->at(calleesIndex++).set(
+        callee.isObject() || callee.isNativeValue()
+            ? callee
+            : HermesValue::encodeUndefinedValue(),
+        &runtime->getHeap());
   }
 
-  return std::move(names);
+  return callees;
 }
 
 ExecutionStatus JSError::recordStackTrace(
@@ -279,16 +254,10 @@ ExecutionStatus JSError::recordStackTrace(
   // Remove the last entry.
   stack->pop_back();
 
-  auto funcNames =
-      getCallStackFunctionNames(runtime, skipTopFrame, stack->size());
-
-  // Either the function names is empty, or they have the same count.
-  assert(
-      (!funcNames || funcNames->size() == stack->size()) &&
-      "Function names and stack trace must have same size.");
+  auto callees = getCallStackCallees(runtime, skipTopFrame, stack->size());
 
   selfHandle->stacktrace_ = std::move(stack);
-  selfHandle->funcNames_.set(runtime, *funcNames, &runtime->getHeap());
+  selfHandle->callees_.set(runtime, *callees, &runtime->getHeap());
   return ExecutionStatus::RETURNED;
 }
 
@@ -316,13 +285,29 @@ bool JSError::appendFunctionNameAtIndex(
   MutableHandle<StringPrimitive> name{
       runtime, runtime->getPredefinedString(Predefined::emptyString)};
 
-  // If funcNames_ is set and contains a string primitive, use that.
-  if (selfHandle->funcNames_) {
+  // If callees_ is set, use the 'name' property of the Callable, unless it is
+  // an accessor, or the name of the native CodeBlock.
+  if (selfHandle->callees_) {
     assert(
-        index < selfHandle->funcNames_.get(runtime)->size() &&
+        index < selfHandle->callees_.get(runtime)->size() &&
         "Index out of bounds");
-    name = dyn_vmcast<StringPrimitive>(
-        selfHandle->funcNames_.get(runtime)->at(index));
+    HermesValue callee = selfHandle->callees_.get(runtime)->at(index);
+    if (auto callableHandle = Handle<Callable>::dyn_vmcast(
+            runtime, runtime->makeHandle(callee))) {
+      NamedPropertyDescriptor desc;
+      JSObject *propObj = JSObject::getNamedDescriptor(
+          callableHandle,
+          runtime,
+          Predefined::getSymbolID(Predefined::name),
+          desc);
+      if (propObj && !desc.flags.accessor)
+        name = dyn_vmcast<StringPrimitive>(
+            JSObject::getNamedSlotValue(propObj, runtime, desc));
+    } else if (callee.isNativeValue()) {
+      auto *cb = callee.getNativePointer<const CodeBlock>();
+      if (cb->getNameMayAllocate().isValid())
+        name = runtime->getStringPrimFromSymbolID(cb->getNameMayAllocate());
+    }
   }
 
   if (!name || name->getStringLength() == 0) {
@@ -411,7 +396,10 @@ ExecutionStatus JSError::constructStackTraceString(
       continue;
     }
 
-    // We are not a native function.
+    // We are not a native function. It may have been evicted since the trace
+    // was captured, see Runtime::evictColdFunctions(). Compiling it again
+    // yields the same bytecode.
+    sti.codeBlock->lazyCompile(runtime);
     int32_t lineNo;
     int32_t columnNo;
     OptValue<SymbolID> fileName;
@@ -368,6 +368,11 @@ Handle<JSObject> createArrayConstructor(Runtime *runtime) {
   auto propValue = runtime->ignoreAllocationFailure(JSObject::getNamed_RJS(
       arrayPrototype, runtime, Predefined::getSymbolID(Predefined::values)));
   runtime->arrayPrototypeValues = propValue;
+  runtime->arrayPrototypeToString =
+      runtime->ignoreAllocationFailure(JSObject::getNamed_RJS(
+          arrayPrototype,
+          runtime,
+          Predefined::getSymbolID(Predefined::toString)));
 
   DefinePropertyFlags dpf{};
   dpf.setEnumerable = 1;
@@ -736,6 +741,41 @@ arrayPrototypeToLocaleString(void *, Runtime *runtime, NativeArgs args) {
   return HermesValue::encodeStringValue(*builder->getStringPrimitive());
 }
 
+/// \return true if the elements of \p arr, whose length is \p len, can be
+/// moved within its storage by ArrayImpl::unsafeShift(),
+/// ArrayImpl::unsafeGrowStorageLeft() and ArrayImpl::unsafeCopyElements()
+/// instead of one property at a time:
+/// they are fast packed elements covering [0, len), the array is extensible
+/// and its ".length" is writable.
+static bool
+canMoveElementsFast(Runtime *runtime, Handle<JSArray> arr, uint64_t len) {
+  if (!arr->hasFastPackedElements() || arr->getBeginIndex() != 0 ||
+      arr->getEndIndex() != len || !arr->isExtensible())
+    return false;
+  NamedPropertyDescriptor desc;
+  return JSObject::getOwnNamedDescriptor(
+             arr, runtime, Predefined::getSymbolID(Predefined::length), desc) &&
+      desc.flags.writable;
+}
+
+/// \return true if the prototype chain of \p obj only has plain objects and
+/// arrays without elements or index-like properties, so that storing an
+/// element that \p obj doesn't have yet can't be intercepted.
+static bool protoChainHasNoElements(Runtime *runtime, JSObject *obj) {
+  for (JSObject *proto = obj->getParent(runtime); proto;
+       proto = proto->getParent(runtime)) {
+    if (proto->getClass(runtime)->getHasIndexLikeProperties())
+      return false;
+    if (auto *arr = dyn_vmcast<JSArray>(proto)) {
+      if (arr->getBeginIndex() != arr->getEndIndex())
+        return false;
+    } else if (proto->getKind() != CellKind::ObjectKind) {
+      return false;
+    }
+  }
+  return true;
+}
+
 static CallResult<HermesValue>
 arrayPrototypeConcat(void *, Runtime *runtime, NativeArgs args) {
   GCScope gcScope(runtime);
@@ -839,6 +879,20 @@ arrayPrototypeConcat(void *, Runtime *runtime, NativeArgs args) {
         }
       }
 
+      // Fast path: the elements of a packed array are copied in bulk.
+      if (LLVM_LIKELY(arrHandle) && arrHandle->hasFastPackedElements() &&
+          arrHandle->getBeginIndex() == 0 &&
+          arrHandle->getEndIndex() == len && n + len <= A->getEndIndex()) {
+        if (LLVM_UNLIKELY(
+                JSArray::unsafeCopyElements(A, runtime, n, arrHandle, 0, len) ==
+                ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        n += len;
+        gcScope.flushToMarker(marker);
+        continue;
+      }
+
       // Note that we must increase n every iteration even if nothing was
       // appended to the result array.
       // 7.d.v. Repeat, while k < len
@@ -1002,6 +1056,19 @@ arrayPrototypeCopyWithin(void *, Runtime *runtime, NativeArgs args) {
   // 14. Let count be min(final-from, len-to).
   double count = std::min(fin - from, len - to);
 
+  // Fast path for arrays whose elements are all in their storage: they are
+  // moved in bulk, which handles overlapping ranges like the loop below.
+  if (auto arr = Handle<JSArray>::dyn_vmcast(runtime, O)) {
+    if (count > 0 && canMoveElementsFast(runtime, arr, len)) {
+      if (LLVM_UNLIKELY(
+              JSArray::unsafeCopyElements(arr, runtime, to, arr, from, count) ==
+              ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      return O.getHermesValue();
+    }
+  }
+
   int direction;
   if (from < to && to < from + count) {
     // 15. If from<to and to<from+count
@@ -1136,8 +1203,12 @@ arrayPrototypeJoin(void *, Runtime *runtime, NativeArgs args) {
   // Track the size of the resultant string. Use a 64-bit value to detect
   // overflow.
   SafeUInt32 size;
+  // Whether every part of the result is ASCII, so it can be built as ASCII.
+  bool allASCII = sep->isASCII();
 
-  // Storage for the strings for each element.
+  // Storage for the strings for each element. Numbers are converted into
+  // \c digits instead of allocating a string for each of them, and their slot
+  // holds the length of their conversion.
   if (LLVM_UNLIKELY(len > JSArray::StorageType::maxElements())) {
     return runtime->raiseRangeError("Out of memory for array elements.");
   }
@@ -1146,26 +1217,47 @@ arrayPrototypeJoin(void *, Runtime *runtime, NativeArgs args) {
     return ExecutionStatus::EXCEPTION;
   }
   auto strings = toHandle(runtime, std::move(*arrRes));
+  llvm::SmallVector<char, 256> digits;
+
+  // The elements of an array can be read directly, without a property lookup
+  // unless they are holes.
+  auto arr = Handle<JSArray>::dyn_vmcast(runtime, O);
+  MutableHandle<> elem{runtime};
 
   // Call toString on all the elements of the array.
   for (MutableHandle<> i{runtime, HermesValue::encodeNumberValue(0)};
        i->getNumber() < len;
        i = HermesValue::encodeNumberValue(i->getNumber() + 1)) {
+    uint32_t index = i->getNumberAs<uint32_t>();
     // Add the size of the separator, except the first time.
-    if (i->getNumberAs<uint32_t>())
+    if (index)
       size.add(sep->getStringLength());
 
     GCScope gcScope2(runtime);
-    if (LLVM_UNLIKELY(
-            (propRes = JSObject::getComputed_RJS(O, runtime, i)) ==
-            ExecutionStatus::EXCEPTION)) {
-      return ExecutionStatus::EXCEPTION;
+    elem = arr ? arr->at(runtime, index) : HermesValue::encodeEmptyValue();
+    if (elem->isEmpty()) {
+      if (LLVM_UNLIKELY(
+              (propRes = JSObject::getComputed_RJS(O, runtime, i)) ==
+              ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      elem = *propRes;
     }
 
-    auto elem = runtime->makeHandle(*propRes);
-
     if (elem->isUndefined() || elem->isNull()) {
-      JSArray::setElementAt(strings, runtime, i->getNumber(), emptyString);
+      JSArray::setElementAt(strings, runtime, index, emptyString);
+    } else if (elem->isNumber()) {
+      size_t start = digits.size();
+      digits.resize(start + NUMBER_TO_STRING_BUF_SIZE);
+      size_t numberLength = hermes::numberToString(
+          elem->getNumber(), digits.data() + start, NUMBER_TO_STRING_BUF_SIZE);
+      digits.resize(start + numberLength);
+      size.add(numberLength);
+      JSArray::setElementAt(
+          strings,
+          runtime,
+          index,
+          runtime->makeHandle(HermesValue::encodeNumberValue(numberLength)));
     } else {
       // Otherwise, call toString_RJS() and push the result, incrementing size.
       auto strRes = toString_RJS(runtime, elem);
@@ -1174,7 +1266,8 @@ arrayPrototypeJoin(void *, Runtime *runtime, NativeArgs args) {
       }
       auto S = toHandle(runtime, std::move(*strRes));
       size.add(S->getStringLength());
-      JSArray::setElementAt(strings, runtime, i->getNumber(), S);
+      allASCII = allASCII && S->isASCII();
+      JSArray::setElementAt(strings, runtime, index, S);
     }
 
     // Check for string overflow on every iteration to create the illusion that
@@ -1185,17 +1278,24 @@ arrayPrototypeJoin(void *, Runtime *runtime, NativeArgs args) {
   }
 
   // Allocate the complete result.
-  auto builder = StringBuilder::createStringBuilder(runtime, size);
+  auto builder = StringBuilder::createStringBuilder(runtime, size, allASCII);
   if (builder == ExecutionStatus::EXCEPTION) {
     return ExecutionStatus::EXCEPTION;
   }
   MutableHandle<StringPrimitive> element{runtime};
-  element = strings->at(runtime, 0).getString();
-  builder->appendStringPrim(element);
-  for (size_t i = 1; i < len; ++i) {
-    builder->appendStringPrim(sep);
-    element = strings->at(runtime, i).getString();
-    builder->appendStringPrim(element);
+  const char *nextDigits = digits.data();
+  for (size_t i = 0; i < len; ++i) {
+    if (i)
+      builder->appendStringPrim(sep);
+    HermesValue part = strings->at(runtime, i);
+    if (part.isNumber()) {
+      size_t numberLength = part.getNumberAs<uint32_t>();
+      builder->appendASCIIRef({nextDigits, numberLength});
+      nextDigits += numberLength;
+    } else {
+      element = part.getString();
+      builder->appendStringPrim(element);
+    }
   }
   return HermesValue::encodeStringValue(*builder->getStringPrimitive());
 }
@@ -1487,6 +1587,24 @@ arrayPrototypeShift(void *, Runtime *runtime, NativeArgs args) {
     return HermesValue::encodeUndefinedValue();
   }
 
+  // Fast path for arrays whose elements are all in their storage: the first
+  // element is dropped without moving the others.
+  if (auto arr = Handle<JSArray>::dyn_vmcast(runtime, O)) {
+    if (canMoveElementsFast(runtime, arr, len)) {
+      auto firstRes = JSArray::unsafeShift(arr, runtime);
+      if (LLVM_UNLIKELY(firstRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      auto first = runtime->makeHandle(*firstRes);
+      if (LLVM_UNLIKELY(
+              JSArray::setLengthProperty(arr, runtime, len - 1) ==
+              ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      return first.get();
+    }
+  }
+
   auto idxVal = runtime->makeHandle(HermesValue::encodeDoubleValue(0));
   if (LLVM_UNLIKELY(
           (propRes = JSObject::getComputed_RJS(O, runtime, idxVal)) ==
@@ -1502,7 +1620,6 @@ arrayPrototypeShift(void *, Runtime *runtime, NativeArgs args) {
   MutableHandle<> fromVal{runtime};
 
   // Move every element to the left one slot.
-  // TODO: Add a fast path for actual arrays.
   while (from->getDouble() < len) {
     GCScopeMarkerRAII marker{gcScope};
 
@@ -1623,6 +1740,28 @@ arrayPrototypeSlice(void *, Runtime *runtime, NativeArgs args) {
   }
   auto A = toHandle(runtime, std::move(*arrRes));
 
+  // Fast path: the elements of a packed array are copied in bulk.
+  if (auto arr = Handle<JSArray>::dyn_vmcast(runtime, O)) {
+    if (arr->hasFastPackedElements() && arr->getBeginIndex() == 0 &&
+        fin <= arr->getEndIndex()) {
+      if (LLVM_UNLIKELY(
+              JSArray::setStorageEndIndex(A, runtime, count) ==
+              ExecutionStatus::EXCEPTION) ||
+          LLVM_UNLIKELY(
+              JSArray::unsafeCopyElements(
+                  A, runtime, 0, arr, k->getNumber(), count) ==
+              ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      JSArray::unsafeMarkFilled(*A, runtime);
+      if (LLVM_UNLIKELY(
+              JSArray::setLengthProperty(A, runtime, count) ==
+              ExecutionStatus::EXCEPTION))
+        return ExecutionStatus::EXCEPTION;
+      return A.getHermesValue();
+    }
+  }
+
   // Next index in A to write to.
   uint32_t n = 0;
 
@@ -1631,7 +1770,6 @@ arrayPrototypeSlice(void *, Runtime *runtime, NativeArgs args) {
   auto marker = gcScope.createMarker();
 
   // Copy the elements between the actual start and end indices into A.
-  // TODO: Implement a fast path for actual arrays.
   while (k->getNumber() < fin) {
     ComputedPropertyDescriptor desc;
     JSObject::getComputedPrimitiveDescriptor(
@@ -1882,6 +2020,183 @@ class StandardSortModel : public SortModel {
 };
 } // anonymous namespace
 
+/// Store \p value at \p index of \p arr while writing back sorted elements.
+/// Elements that already hold the right value are left alone, so that sorting
+/// an array that is already in order doesn't write to it.
+static ExecutionStatus putSortedElement(
+    Runtime *runtime,
+    Handle<JSArray> arr,
+    uint32_t index,
+    HermesValue value) {
+  if (arr->tryGetFastIndexed(runtime, index).getRaw() == value.getRaw())
+    return ExecutionStatus::RETURNED;
+  if (LLVM_LIKELY(ArrayImpl::trySetFastIndexed(*arr, runtime, index, value)))
+    return ExecutionStatus::RETURNED;
+  GCScopeMarkerRAII marker{runtime};
+  return JSObject::putComputed_RJS(
+             arr,
+             runtime,
+             runtime->makeHandle(HermesValue::encodeNumberValue(index)),
+             runtime->makeHandle(value),
+             PropOpFlags().plusThrowOnError())
+      .getStatus();
+}
+
+/// Sort an array with fast packed elements (see
+/// ArrayImpl::hasFastPackedElements()) covering its whole length. Instead of
+/// swapping elements in place through StandardSortModel, the elements are
+/// copied out, sorted with TimSort, which is stable and close to linear on
+/// input that is already mostly in order, and stored back. There are three
+/// cases:
+/// - Without a comparison function, an array of numbers is sorted by their
+///   string conversions, which are computed once per element.
+/// - Without a comparison function, an array of strings is sorted by comparing
+///   the strings directly.
+/// - With a comparison function, any array is sorted by calling it.
+/// In all cases undefined elements go last without being compared, as in
+/// SortCompare. Calling the comparison function can run arbitrary code, so
+/// the elements are stored back through [[Put]] if the array was modified.
+/// \return false if the elements don't fit any of these cases, in which case
+///   the array is unchanged.
+static CallResult<bool> sortPackedArray(
+    Runtime *runtime,
+    Handle<JSArray> arr,
+    Handle<Callable> compareFn) {
+  assert(arr->hasFastPackedElements() && "array may have holes");
+  const uint32_t len = arr->getEndIndex();
+
+  if (!compareFn &&
+      arr->getElementsKind() == ArrayImpl::ElementsKind::PackedNumber) {
+    // The string conversion of each element, stored in a single buffer.
+    struct NumberKey {
+      double value;
+      uint32_t offset;
+      uint32_t length;
+    };
+    std::vector<NumberKey> keys;
+    std::vector<char> chars;
+    keys.reserve(len);
+    char buf[NUMBER_TO_STRING_BUF_SIZE];
+    for (uint32_t i = 0; i != len; ++i) {
+      double value = arr->at(runtime, i).getNumber();
+      size_t length = numberToString(value, buf, sizeof(buf));
+      keys.push_back({value, (uint32_t)chars.size(), (uint32_t)length});
+      chars.insert(chars.end(), buf, buf + length);
+    }
+    const char *base = chars.data();
+    if (timSort(
+            keys.data(),
+            len,
+            [base](const NumberKey &a, const NumberKey &b) -> CallResult<bool> {
+              return llvm::StringRef(base + a.offset, a.length) <
+                  llvm::StringRef(base + b.offset, b.length);
+            }) == ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    // Numbers are not affected by a collection, so they can be stored back
+    // straight from the keys.
+    for (uint32_t i = 0; i != len; ++i) {
+      if (LLVM_UNLIKELY(
+              putSortedElement(
+                  runtime,
+                  arr,
+                  i,
+                  HermesValue::encodeNumberValue(keys[i].value)) ==
+              ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+    }
+    return true;
+  }
+
+  if (!compareFn) {
+    for (uint32_t i = 0; i != len; ++i) {
+      HermesValue value = arr->at(runtime, i);
+      if (!value.isString() && !value.isUndefined())
+        return false;
+    }
+  }
+
+  // Copy the elements aside, where a collection can find them and they can't
+  // be modified by the comparison function. The permutation is sorted
+  // instead of the elements themselves.
+  if (LLVM_UNLIKELY(len > ArrayStorage::maxElements()))
+    return false;
+  auto copyRes = ArrayStorage::create(runtime, len, len);
+  if (LLVM_UNLIKELY(copyRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto copy = runtime->makeHandle<ArrayStorage>(*copyRes);
+  std::vector<uint32_t> order;
+  order.reserve(len);
+  for (uint32_t i = 0; i != len; ++i) {
+    HermesValue value = arr->at(runtime, i);
+    copy->at(i).set(value, &runtime->getHeap());
+    if (!value.isUndefined())
+      order.push_back(i);
+  }
+  const uint32_t numDefined = order.size();
+
+  if (!compareFn) {
+    // Comparing strings doesn't allocate, so the pointers stay valid while
+    // sorting. Flattening a rope doesn't allocate in the JS heap either.
+    struct StringKey {
+      const StringPrimitive *str;
+      uint32_t index;
+    };
+    std::vector<StringKey> keys;
+    keys.reserve(numDefined);
+    for (uint32_t index : order)
+      keys.push_back({copy->at(index).getString(), index});
+    if (timSort(
+            keys.data(),
+            numDefined,
+            [](const StringKey &a, const StringKey &b) -> CallResult<bool> {
+              return a.str->compare(b.str) < 0;
+            }) == ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    for (uint32_t i = 0; i != numDefined; ++i)
+      order[i] = keys[i].index;
+  } else {
+    if (timSort(
+            order.data(),
+            numDefined,
+            [runtime, compareFn, copy](
+                uint32_t a, uint32_t b) -> CallResult<bool> {
+              GCScopeMarkerRAII marker{runtime};
+              auto callRes = Callable::executeCall2(
+                  compareFn,
+                  runtime,
+                  runtime->getUndefinedValue(),
+                  copy->at(a),
+                  copy->at(b));
+              if (LLVM_UNLIKELY(callRes == ExecutionStatus::EXCEPTION)) {
+                return ExecutionStatus::EXCEPTION;
+              }
+              auto intRes =
+                  toNumber_RJS(runtime, runtime->makeHandle(*callRes));
+              if (LLVM_UNLIKELY(intRes == ExecutionStatus::EXCEPTION)) {
+                return ExecutionStatus::EXCEPTION;
+              }
+              return intRes->getNumber() < 0;
+            }) == ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+
+  for (uint32_t i = 0; i != len; ++i) {
+    HermesValue value = i < numDefined ? copy->at(order[i])
+                                       : HermesValue::encodeUndefinedValue();
+    if (LLVM_UNLIKELY(
+            putSortedElement(runtime, arr, i, value) ==
+            ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+  return true;
+}
+
 /// ES5.1 15.4.4.11.
 static CallResult<HermesValue>
 arrayPrototypeSort(void *, Runtime *runtime, NativeArgs args) {
@@ -1909,6 +2224,19 @@ arrayPrototypeSort(void *, Runtime *runtime, NativeArgs args) {
   }
   uint64_t len = *intRes;
 
+  // Reading the length may have run user code, so only check now whether the
+  // fast path applies.
+  if (auto arr = Handle<JSArray>::dyn_vmcast(runtime, O)) {
+    if (arr->hasFastPackedElements() && arr->getEndIndex() == len) {
+      auto sortRes = sortPackedArray(runtime, arr, compareFn);
+      if (LLVM_UNLIKELY(sortRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      if (*sortRes)
+        return O.getHermesValue();
+    }
+  }
+
   StandardSortModel sm(runtime, O, compareFn);
 
   // Use our custom sort routine. We can't use std::sort because it performs
@@ -1996,6 +2324,61 @@ arrayPrototypeSplice(void *, Runtime *runtime, NativeArgs args) {
   }
   auto A = toHandle(runtime, std::move(*arrRes));
 
+  // Fast path for arrays whose elements are all in their storage, when
+  // nothing on the prototype chain can intercept the stores past the end:
+  // the elements are copied and moved in bulk.
+  if (auto arr = Handle<JSArray>::dyn_vmcast(runtime, O)) {
+    uint64_t newLen = lenAfterInsert - actualDeleteCount;
+    if (canMoveElementsFast(runtime, arr, len) &&
+        (insertCount <= actualDeleteCount ||
+         (newLen <= UINT32_MAX && protoChainHasNoElements(runtime, *arr)))) {
+      uint32_t start = actualStart;
+      uint32_t deleteCount = actualDeleteCount;
+      if (LLVM_UNLIKELY(
+              JSArray::setStorageEndIndex(A, runtime, deleteCount) ==
+              ExecutionStatus::EXCEPTION) ||
+          LLVM_UNLIKELY(
+              JSArray::unsafeCopyElements(
+                  A, runtime, 0, arr, start, deleteCount) ==
+              ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      JSArray::unsafeMarkFilled(*A, runtime);
+      if (LLVM_UNLIKELY(
+              JSArray::setLengthProperty(A, runtime, deleteCount) ==
+              ExecutionStatus::EXCEPTION))
+        return ExecutionStatus::EXCEPTION;
+
+      // Move the elements after the deleted ones to their new index, and
+      // store the items in between.
+      if (insertCount > deleteCount &&
+          LLVM_UNLIKELY(
+              JSArray::setStorageEndIndex(arr, runtime, newLen) ==
+              ExecutionStatus::EXCEPTION))
+        return ExecutionStatus::EXCEPTION;
+      if (LLVM_UNLIKELY(
+              JSArray::unsafeCopyElements(
+                  arr,
+                  runtime,
+                  start + insertCount,
+                  arr,
+                  start + deleteCount,
+                  len - start - deleteCount) == ExecutionStatus::EXCEPTION))
+        return ExecutionStatus::EXCEPTION;
+      for (uint32_t j = 0; j < insertCount; ++j) {
+        JSArray::unsafeSetExistingElementAt(
+            *arr, runtime, start + j, args.getArg(j + 2));
+      }
+      if (insertCount > deleteCount)
+        JSArray::unsafeMarkFilled(*arr, runtime);
+      if (LLVM_UNLIKELY(
+              JSArray::setLengthProperty(arr, runtime, newLen) ==
+              ExecutionStatus::EXCEPTION))
+        return ExecutionStatus::EXCEPTION;
+      return A.getHermesValue();
+    }
+  }
+
   // Indices used for various copies in loops below.
   MutableHandle<> from{runtime};
   MutableHandle<> to{runtime};
@@ -2011,7 +2394,6 @@ arrayPrototypeSplice(void *, Runtime *runtime, NativeArgs args) {
 
   {
     // Copy actualDeleteCount elements to A, starting at actualStart.
-    // TODO: Add a fast path for actual arrays.
     for (uint32_t j = 0; j < actualDeleteCount; ++j) {
       from = HermesValue::encodeDoubleValue(actualStart + j);
 
@@ -2059,7 +2441,6 @@ arrayPrototypeSplice(void *, Runtime *runtime, NativeArgs args) {
 
     // Copy items from (k + actualDeleteCount) to (k + itemCount).
     // This leaves itemCount spaces to copy the arguments into.
-    // TODO: Add a fast path for actual arrays.
     for (double j = actualStart; j < len - actualDeleteCount; ++j) {
       from = HermesValue::encodeDoubleValue(j + actualDeleteCount);
       to = HermesValue::encodeDoubleValue(j + itemCount);
@@ -2101,7 +2482,6 @@ arrayPrototypeSplice(void *, Runtime *runtime, NativeArgs args) {
     i = HermesValue::encodeDoubleValue(len - 1);
 
     // Delete the remaining elements from the right that we didn't copy into.
-    // TODO: Add a fast path for actual arrays.
     while (i->getNumber() > len - actualDeleteCount + itemCount - 1) {
       if (LLVM_UNLIKELY(
               JSObject::deleteComputed(
@@ -2117,7 +2497,6 @@ arrayPrototypeSplice(void *, Runtime *runtime, NativeArgs args) {
 
     // Start from the right, and copy elements to the right.
     // This makes space to insert the elements from the arguments.
-    // TODO: Add a fast path for actual arrays.
     for (double j = len - actualDeleteCount; j > actualStart; --j) {
       from = HermesValue::encodeDoubleValue(j + actualDeleteCount - 1);
       to = HermesValue::encodeDoubleValue(j + itemCount - 1);
@@ -2160,7 +2539,6 @@ arrayPrototypeSplice(void *, Runtime *runtime, NativeArgs args) {
 
   {
     // Finally, just copy the elements from the args into the array.
-    // TODO: Add a fast path for actual arrays.
     k = HermesValue::encodeDoubleValue(actualStart);
     for (size_t j = 2; j < argCount; ++j) {
       if (LLVM_UNLIKELY(
@@ -2222,6 +2600,33 @@ arrayPrototypeUnshift(void *, Runtime *runtime, NativeArgs args) {
           "Array.prototype.unshift result out of space");
     }
 
+    // Fast path for arrays whose elements are all in their storage, when
+    // nothing on the prototype chain can intercept the stores past the end:
+    // the elements are moved up in the storage, which usually has room for
+    // them already.
+    if (auto arr = Handle<JSArray>::dyn_vmcast(runtime, O)) {
+      if (len + argCount <= UINT32_MAX &&
+          canMoveElementsFast(runtime, arr, len) &&
+          protoChainHasNoElements(runtime, *arr)) {
+        if (LLVM_UNLIKELY(
+                JSArray::unsafeGrowStorageLeft(arr, runtime, argCount) ==
+                ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        uint32_t i = 0;
+        for (auto arg : args.handles()) {
+          JSArray::unsafeSetExistingElementAt(*arr, runtime, i++, *arg);
+        }
+        JSArray::unsafeMarkFilled(*arr, runtime);
+        if (LLVM_UNLIKELY(
+                JSArray::setLengthProperty(arr, runtime, len + argCount) ==
+                ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        return HermesValue::encodeDoubleValue(len + argCount);
+      }
+    }
+
     // Loop indices.
     MutableHandle<> k{runtime, HermesValue::encodeDoubleValue(len)};
     MutableHandle<> j{runtime, HermesValue::encodeDoubleValue(0)};
@@ -2235,7 +2640,6 @@ arrayPrototypeUnshift(void *, Runtime *runtime, NativeArgs args) {
     MutableHandle<> fromValue{runtime};
 
     // Move elements to the right by argCount to account for the new elements.
-    // TODO: Add a fast path for actual arrays.
     auto marker = gcScope.createMarker();
     while (k->getDouble() > 0) {
       gcScope.flushToMarker(marker);
@@ -2302,6 +2706,86 @@ arrayPrototypeUnshift(void *, Runtime *runtime, NativeArgs args) {
   return newLen;
 }
 
+/// Search an array with fast packed elements (see
+/// ArrayImpl::hasFastPackedElements()) for \p searchElement, without going
+/// through the property lookup for every element. The search starts at index
+/// \p from and moves towards index 0 if \p reverse is set, and towards
+/// getEndIndex() otherwise. Elements are compared using SameValueZero if
+/// \p sameValueZero is set, and strict equality otherwise. Neither comparison
+/// can run user code or allocate.
+/// \return the index of the first match, or -1 if there is none.
+static double searchPackedArray(
+    Runtime *runtime,
+    JSArray *arr,
+    HermesValue searchElement,
+    double from,
+    bool reverse,
+    bool sameValueZero) {
+  assert(arr->hasFastPackedElements() && "array may have holes");
+  const uint32_t len = arr->getEndIndex();
+  if (reverse ? from < 0 : from >= len)
+    return -1;
+  uint32_t start = from;
+
+  // Strict equality with anything but a string, 0 or NaN is the identity of
+  // the encoding, which can be compared for many elements at once.
+  if (!searchElement.isString() &&
+      !(searchElement.isNumber() &&
+        (searchElement.getNumber() == 0 ||
+         std::isnan(searchElement.getNumber())))) {
+    uint32_t begin = reverse ? 0 : start;
+    uint32_t end = reverse ? start + 1 : len;
+    uint32_t found =
+        arr->findRawElement(runtime, searchElement, begin, end, reverse);
+    return found == end ? -1 : found;
+  }
+
+  // All the elements are unboxed doubles, so compare them directly.
+  if (arr->getElementsKind() == ArrayImpl::ElementsKind::PackedNumber &&
+      searchElement.isNumber()) {
+    double x = searchElement.getNumber();
+    if (LLVM_UNLIKELY(std::isnan(x))) {
+      // NaN is only ever found by SameValueZero.
+      if (!sameValueZero)
+        return -1;
+      for (uint32_t i = start; i != len; ++i) {
+        if (std::isnan(arr->at(runtime, i).getNumber()))
+          return i;
+      }
+      return -1;
+    }
+    if (reverse) {
+      for (uint32_t i = start + 1; i-- != 0;) {
+        if (arr->at(runtime, i).getNumber() == x)
+          return i;
+      }
+    } else {
+      for (uint32_t i = start; i != len; ++i) {
+        if (arr->at(runtime, i).getNumber() == x)
+          return i;
+      }
+    }
+    return -1;
+  }
+
+  auto matches = [=](HermesValue elem) {
+    return sameValueZero ? isSameValueZero(searchElement, elem)
+                         : strictEqualityTest(searchElement, elem);
+  };
+  if (reverse) {
+    for (uint32_t i = start + 1; i-- != 0;) {
+      if (matches(arr->at(runtime, i)))
+        return i;
+    }
+  } else {
+    for (uint32_t i = start; i != len; ++i) {
+      if (matches(arr->at(runtime, i)))
+        return i;
+    }
+  }
+  return -1;
+}
+
 /// Used to help with indexOf and lastIndexOf.
 /// \p reverse true if searching in reverse (lastIndexOf), false otherwise.
 static inline CallResult<HermesValue>
@@ -2357,10 +2841,19 @@ indexOfHelper(Runtime *runtime, NativeArgs args, const bool reverse) {
     }
   }
 
-  MutableHandle<JSObject> descObjHandle{runtime};
-
   // Search for the element.
   auto searchElement = args.getArgHandle(runtime, 0);
+
+  // The conversions above may have run user code, so only check now whether
+  // the fast path applies.
+  if (auto *arr = dyn_vmcast<JSArray>(O.get())) {
+    if (arr->hasFastPackedElements() && arr->getEndIndex() == len) {
+      return HermesValue::encodeDoubleValue(searchPackedArray(
+          runtime, arr, searchElement.get(), k->getDouble(), reverse, false));
+    }
+  }
+
+  MutableHandle<JSObject> descObjHandle{runtime};
   auto marker = gcScope.createMarker();
   while (true) {
     gcScope.flushToMarker(marker);
@@ -2407,6 +2900,39 @@ arrayPrototypeLastIndexOf(void *, Runtime *runtime, NativeArgs args) {
   return indexOfHelper(runtime, args, true);
 }
 
+/// Read an element for the loops of the higher-order methods without going
+/// through the generic property lookup, when \p O is an array whose element
+/// \p k is present in its indexed storage.
+/// \return the element, or empty if the generic lookup must be performed.
+static inline HermesValue
+tryGetFastElement(Runtime *runtime, Handle<JSObject> O, double k) {
+  auto *arr = dyn_vmcast<ArrayImpl>(O.get());
+  if (!arr || k >= (double)UINT32_MAX) {
+    return HermesValue::encodeEmptyValue();
+  }
+  return arr->tryGetFastIndexed(runtime, (uint32_t)k);
+}
+
+/// Read the element \p k of \p O for the loops of the higher-order methods,
+/// using \p descObjHandle as scratch.
+/// \return the element, or empty if \p O doesn't have the property \p k.
+static CallResult<HermesValue> getElementIfPresent(
+    Runtime *runtime,
+    Handle<JSObject> O,
+    Handle<> k,
+    MutableHandle<JSObject> &descObjHandle) {
+  HermesValue fast = tryGetFastElement(runtime, O, k->getNumber());
+  if (LLVM_LIKELY(!fast.isEmpty())) {
+    return fast;
+  }
+  ComputedPropertyDescriptor desc;
+  JSObject::getComputedPrimitiveDescriptor(O, runtime, k, descObjHandle, desc);
+  if (!descObjHandle) {
+    return HermesValue::encodeEmptyValue();
+  }
+  return JSObject::getComputedPropertyValue(O, runtime, descObjHandle, desc);
+}
+
 /// Helper function for every/some.
 /// \param every true if calling every(), false if calling some().
 static inline CallResult<HermesValue>
@@ -2447,17 +2973,13 @@ everySomeHelper(Runtime *runtime, NativeArgs args, const bool every) {
   while (k->getDouble() < len) {
     gcScope.flushToMarker(marker);
 
-    ComputedPropertyDescriptor desc;
-    JSObject::getComputedPrimitiveDescriptor(
-        O, runtime, k, descObjHandle, desc);
+    if ((propRes = getElementIfPresent(runtime, O, k, descObjHandle)) ==
+        ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
+    }
 
-    if (descObjHandle) {
+    if (!propRes->isEmpty()) {
       // kPresent is true, call the callback on the kth element.
-      if ((propRes = JSObject::getComputedPropertyValue(
-               O, runtime, descObjHandle, desc)) ==
-          ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
       kValue = propRes.getValue();
       auto callRes = Callable::executeCall3(
           callbackFn,
@@ -2533,22 +3055,17 @@ arrayPrototypeForEach(void *, Runtime *runtime, NativeArgs args) {
   MutableHandle<JSObject> descObjHandle{runtime};
 
   // Loop through and execute the callback on all existing values.
-  // TODO: Implement a fast path for actual arrays.
   auto marker = gcScope.createMarker();
   while (k->getDouble() < len) {
     gcScope.flushToMarker(marker);
 
-    ComputedPropertyDescriptor desc;
-    JSObject::getComputedPrimitiveDescriptor(
-        O, runtime, k, descObjHandle, desc);
+    if ((propRes = getElementIfPresent(runtime, O, k, descObjHandle)) ==
+        ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
+    }
 
-    if (descObjHandle) {
+    if (!propRes->isEmpty()) {
       // kPresent is true, execute callback.
-      if ((propRes = JSObject::getComputedPropertyValue(
-               O, runtime, descObjHandle, desc)) ==
-          ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
       auto kValue = propRes.getValue();
       if (LLVM_UNLIKELY(
               Callable::executeCall3(
@@ -2610,22 +3127,17 @@ arrayPrototypeMap(void *, Runtime *runtime, NativeArgs args) {
   MutableHandle<JSObject> descObjHandle{runtime};
 
   // Main loop to execute callback and store the results in A.
-  // TODO: Implement a fast path for actual arrays.
   auto marker = gcScope.createMarker();
   while (k->getDouble() < len) {
     gcScope.flushToMarker(marker);
 
-    ComputedPropertyDescriptor desc;
-    JSObject::getComputedPrimitiveDescriptor(
-        O, runtime, k, descObjHandle, desc);
+    if ((propRes = getElementIfPresent(runtime, O, k, descObjHandle)) ==
+        ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
+    }
 
-    if (descObjHandle) {
+    if (!propRes->isEmpty()) {
       // kPresent is true, execute callback and store result in A[k].
-      if ((propRes = JSObject::getComputedPropertyValue(
-               O, runtime, descObjHandle, desc)) ==
-          ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
       auto kValue = propRes.getValue();
       auto callRes = Callable::executeCall3(
           callbackFn,
@@ -2695,17 +3207,13 @@ arrayPrototypeFilter(void *, Runtime *runtime, NativeArgs args) {
   while (k->getDouble() < len) {
     gcScope.flushToMarker(marker);
 
-    ComputedPropertyDescriptor desc;
-    JSObject::getComputedPrimitiveDescriptor(
-        O, runtime, k, descObjHandle, desc);
+    if ((propRes = getElementIfPresent(runtime, O, k, descObjHandle)) ==
+        ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
+    }
 
-    if (descObjHandle) {
+    if (!propRes->isEmpty()) {
       // kPresent is true
-      if ((propRes = JSObject::getComputedPropertyValue(
-               O, runtime, descObjHandle, desc)) ==
-          ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
       kValue = propRes.getValue();
       // Call the callback.
       auto callRes = Callable::executeCall3(
@@ -2830,12 +3338,15 @@ arrayPrototypeFind(void *ctx, Runtime *runtime, NativeArgs args) {
   auto marker = gcScope.createMarker();
   while (kHandle->getNumber() < len) {
     gcScope.flushToMarker(marker);
-    if (LLVM_UNLIKELY(
-            (propRes = JSObject::getComputed_RJS(O, runtime, kHandle)) ==
-            ExecutionStatus::EXCEPTION)) {
-      return ExecutionStatus::EXCEPTION;
+    kValue = tryGetFastElement(runtime, O, kHandle->getNumber());
+    if (kValue->isEmpty()) {
+      if (LLVM_UNLIKELY(
+              (propRes = JSObject::getComputed_RJS(O, runtime, kHandle)) ==
+              ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      kValue = *propRes;
     }
-    kValue = *propRes;
     auto callRes = Callable::executeCall3(
         predicate,
         runtime,
@@ -2926,16 +3437,12 @@ reduceHelper(Runtime *runtime, NativeArgs args, const bool reverse) {
           break;
         }
       }
-      ComputedPropertyDescriptor kDesc;
-      JSObject::getComputedPrimitiveDescriptor(
-          O, runtime, k, kDescObjHandle, kDesc);
-      kPresent = !!kDescObjHandle;
+      if ((propRes = getElementIfPresent(runtime, O, k, kDescObjHandle)) ==
+          ExecutionStatus::EXCEPTION) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      kPresent = !propRes->isEmpty();
       if (kPresent) {
-        if ((propRes = JSObject::getComputedPropertyValue(
-                 O, runtime, kDescObjHandle, kDesc)) ==
-            ExecutionStatus::EXCEPTION) {
-          return ExecutionStatus::EXCEPTION;
-        }
         accumulator = propRes.getValue();
       }
       k = HermesValue::encodeDoubleValue(k->getDouble() + increment);
@@ -2959,16 +3466,12 @@ reduceHelper(Runtime *runtime, NativeArgs args, const bool reverse) {
       }
     }
 
-    ComputedPropertyDescriptor kDesc;
-    JSObject::getComputedPrimitiveDescriptor(
-        O, runtime, k, kDescObjHandle, kDesc);
-    if (kDescObjHandle) {
+    if ((propRes = getElementIfPresent(runtime, O, k, kDescObjHandle)) ==
+        ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    if (!propRes->isEmpty()) {
       // kPresent is true, run the accumulation step.
-      if ((propRes = JSObject::getComputedPropertyValue(
-               O, runtime, kDescObjHandle, kDesc)) ==
-          ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
       auto kValue = propRes.getValue();
       auto callRes = Callable::executeCall4(
           callbackFn,
@@ -3051,6 +3554,15 @@ arrayPrototypeIncludes(void *, Runtime *runtime, NativeArgs args) {
     }
   }
 
+  // Fast path: with no holes and no getters, the loop below reduces to a
+  // search of the storage.
+  if (auto *arr = dyn_vmcast<JSArray>(O.get())) {
+    if (arr->hasFastPackedElements() && arr->getEndIndex() == len) {
+      return HermesValue::encodeBoolValue(
+          searchPackedArray(runtime, arr, args.getArg(0), k, false, true) >= 0);
+    }
+  }
+
   MutableHandle<> kHandle{runtime};
 
   // 7. Repeat, while k < len
@@ -31,6 +31,9 @@ void populateArrayIteratorPrototype(Runtime *runtime) {
       nullptr,
       arrayIteratorPrototypeNext,
       0);
+  runtime->arrayIteratorPrototypeNext =
+      runtime->ignoreAllocationFailure(JSObject::getNamed_RJS(
+          proto, runtime, Predefined::getSymbolID(Predefined::next)));
 
   auto dpf = DefinePropertyFlags::getDefaultNewPropertyFlags();
   dpf.writable = 0;
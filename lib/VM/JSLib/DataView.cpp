@@ -175,15 +175,16 @@ dataViewConstructor(void *, Runtime *runtime, NativeArgs args) {
 
 } // namespace
 
-Handle<JSObject> createDataViewConstructor(Runtime *runtime) {
+static void initializeDataViewConstructor(
+    Runtime *runtime,
+    Handle<NativeConstructor> cons) {
   auto proto = Handle<JSObject>::vmcast(&runtime->dataViewPrototype);
-  auto cons = defineSystemConstructor<JSDataView>(
+  initializeSystemConstructor(
       runtime,
+      cons,
       Predefined::getSymbolID(Predefined::DataView),
-      dataViewConstructor,
       proto,
-      3,
-      CellKind::DataViewKind);
+      3);
 
   // DataView.prototype.xxx() methods.
   defineAccessor(
@@ -241,10 +242,15 @@ Handle<JSObject> createDataViewConstructor(Runtime *runtime) {
       Predefined::getSymbolID(Predefined::SymbolToStringTag),
       runtime->getPredefinedStringHandle(Predefined::DataView),
       dpf);
+}
 
-  // DataView.xxx() methods.
-
-  return cons;
+Handle<JSObject> createDataViewConstructor(Runtime *runtime) {
+  return defineLazySystemConstructor<JSDataView>(
+      runtime,
+      Predefined::getSymbolID(Predefined::DataView),
+      dataViewConstructor,
+      CellKind::DataViewKind,
+      initializeDataViewConstructor);
 }
 
 } // namespace vm
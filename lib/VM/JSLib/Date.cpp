@@ -462,6 +462,16 @@ static CallResult<double> makeTimeFromArgs(Runtime *runtime, NativeArgs args) {
       makeTime(fields[h], fields[min], fields[s], fields[milli]));
 }
 
+/// Conversion from UTC to local time, with the offsets cached by \p runtime.
+static double localTime(Runtime *runtime, double t) {
+  return localTime(t, runtime->getCommonStorage()->localTimeOffsetCache);
+}
+
+/// Conversion from local time to UTC, with the offsets cached by \p runtime.
+static double utcTime(Runtime *runtime, double t) {
+  return utcTime(t, runtime->getCommonStorage()->localTimeOffsetCache);
+}
+
 static CallResult<HermesValue>
 dateConstructor(void *, Runtime *runtime, NativeArgs args) {
 #if defined(HERMESVM_SYNTH_REPLAY) || defined(HERMESVM_API_TRACE)
@@ -522,7 +532,7 @@ dateConstructor(void *, Runtime *runtime, NativeArgs args) {
       // makeTimeFromArgs interprets arguments as UTC.
       // We want them as local time, so pretend that they are,
       // and call utcTime to get the final UTC value we want to store.
-      finalDate = timeClip(utcTime(*cr));
+      finalDate = timeClip(utcTime(runtime, *cr));
     }
 
     JSDate::setPrimitiveValue(
@@ -538,7 +548,7 @@ dateConstructor(void *, Runtime *runtime, NativeArgs args) {
   } else {
 #endif
     double t = curTime();
-    double local = localTime(t);
+    double local = localTime(runtime, t);
     datetimeToUTCString(local, local - t, str);
 #ifdef HERMESVM_SYNTH_REPLAY
   }
@@ -620,7 +630,7 @@ datePrototypeToStringHelper(void *ctx, Runtime *runtime, NativeArgs args) {
   }
   llvm::SmallString<32> str{};
   if (!opts->isUTC) {
-    double local = localTime(t);
+    double local = localTime(runtime, t);
     opts->toStringFn(local, local - t, str);
   } else {
     opts->toStringFn(t, 0, str);
@@ -678,7 +688,7 @@ datePrototypeGetterHelper(void *ctx, Runtime *runtime, NativeArgs args) {
   // Store the original value of t to be used in offset calculations.
   double utc = t;
   if (!opts->isUTC) {
-    t = localTime(t);
+    t = localTime(runtime, t);
   }
 
   double result{std::numeric_limits<double>::quiet_NaN()};
@@ -745,7 +755,7 @@ datePrototypeSetMilliseconds(void *ctx, Runtime *runtime, NativeArgs args) {
   }
   double t = JSDate::getPrimitiveValue(self.get(), runtime).getNumber();
   if (!isUTC) {
-    t = localTime(t);
+    t = localTime(runtime, t);
   }
   auto res = toNumber_RJS(runtime, args.getArgHandle(runtime, 0));
   if (res == ExecutionStatus::EXCEPTION) {
@@ -756,7 +766,7 @@ datePrototypeSetMilliseconds(void *ctx, Runtime *runtime, NativeArgs args) {
       day(t), makeTime(hourFromTime(t), minFromTime(t), secFromTime(t), ms));
   PinnedHermesValue v;
   if (!isUTC) {
-    v = HermesValue::encodeDoubleValue(timeClip(utcTime(date)));
+    v = HermesValue::encodeDoubleValue(timeClip(utcTime(runtime, date)));
   } else {
     v = HermesValue::encodeDoubleValue(timeClip(date));
   }
@@ -776,7 +786,7 @@ datePrototypeSetSeconds(void *ctx, Runtime *runtime, NativeArgs args) {
   }
   double t = JSDate::getPrimitiveValue(self.get(), runtime).getNumber();
   if (!isUTC) {
-    t = localTime(t);
+    t = localTime(runtime, t);
   }
   auto res = toNumber_RJS(runtime, args.getArgHandle(runtime, 0));
   if (res == ExecutionStatus::EXCEPTION) {
@@ -798,7 +808,7 @@ datePrototypeSetSeconds(void *ctx, Runtime *runtime, NativeArgs args) {
       makeDate(day(t), makeTime(hourFromTime(t), minFromTime(t), s, milli));
   PinnedHermesValue v;
   if (!isUTC) {
-    v = HermesValue::encodeDoubleValue(timeClip(utcTime(date)));
+    v = HermesValue::encodeDoubleValue(timeClip(utcTime(runtime, date)));
   } else {
     v = HermesValue::encodeDoubleValue(timeClip(date));
   }
@@ -818,7 +828,7 @@ datePrototypeSetMinutes(void *ctx, Runtime *runtime, NativeArgs args) {
   }
   double t = JSDate::getPrimitiveValue(self.get(), runtime).getNumber();
   if (!isUTC) {
-    t = localTime(t);
+    t = localTime(runtime, t);
   }
   auto res = toNumber_RJS(runtime, args.getArgHandle(runtime, 0));
   if (res == ExecutionStatus::EXCEPTION) {
@@ -849,7 +859,7 @@ datePrototypeSetMinutes(void *ctx, Runtime *runtime, NativeArgs args) {
   double date = makeDate(day(t), makeTime(hourFromTime(t), m, s, milli));
   PinnedHermesValue v;
   if (!isUTC) {
-    v = HermesValue::encodeDoubleValue(timeClip(utcTime(date)));
+    v = HermesValue::encodeDoubleValue(timeClip(utcTime(runtime, date)));
   } else {
     v = HermesValue::encodeDoubleValue(timeClip(date));
   }
@@ -869,7 +879,7 @@ datePrototypeSetHours(void *ctx, Runtime *runtime, NativeArgs args) {
   }
   double t = JSDate::getPrimitiveValue(self.get(), runtime).getNumber();
   if (!isUTC) {
-    t = localTime(t);
+    t = localTime(runtime, t);
   }
   auto res = toNumber_RJS(runtime, args.getArgHandle(runtime, 0));
   if (res == ExecutionStatus::EXCEPTION) {
@@ -910,7 +920,7 @@ datePrototypeSetHours(void *ctx, Runtime *runtime, NativeArgs args) {
   double date = makeDate(day(t), makeTime(h, m, s, milli));
   PinnedHermesValue v;
   if (!isUTC) {
-    v = HermesValue::encodeDoubleValue(timeClip(utcTime(date)));
+    v = HermesValue::encodeDoubleValue(timeClip(utcTime(runtime, date)));
   } else {
     v = HermesValue::encodeDoubleValue(timeClip(date));
   }
@@ -929,7 +939,7 @@ datePrototypeSetDate(void *ctx, Runtime *runtime, NativeArgs args) {
   }
   double t = JSDate::getPrimitiveValue(self.get(), runtime).getNumber();
   if (!isUTC) {
-    t = localTime(t);
+    t = localTime(runtime, t);
   }
   auto res = toNumber_RJS(runtime, args.getArgHandle(runtime, 0));
   if (res == ExecutionStatus::EXCEPTION) {
@@ -940,7 +950,7 @@ datePrototypeSetDate(void *ctx, Runtime *runtime, NativeArgs args) {
       makeDay(yearFromTime(t), monthFromTime(t), dt), timeWithinDay(t));
   PinnedHermesValue v;
   if (!isUTC) {
-    v = HermesValue::encodeDoubleValue(timeClip(utcTime(newDate)));
+    v = HermesValue::encodeDoubleValue(timeClip(utcTime(runtime, newDate)));
   } else {
     v = HermesValue::encodeDoubleValue(timeClip(newDate));
   }
@@ -960,7 +970,7 @@ datePrototypeSetMonth(void *ctx, Runtime *runtime, NativeArgs args) {
   }
   double t = JSDate::getPrimitiveValue(self.get(), runtime).getNumber();
   if (!isUTC) {
-    t = localTime(t);
+    t = localTime(runtime, t);
   }
   auto res = toNumber_RJS(runtime, args.getArgHandle(runtime, 0));
   if (res == ExecutionStatus::EXCEPTION) {
@@ -980,7 +990,7 @@ datePrototypeSetMonth(void *ctx, Runtime *runtime, NativeArgs args) {
   double newDate = makeDate(makeDay(yearFromTime(t), m, dt), timeWithinDay(t));
   PinnedHermesValue v;
   if (!isUTC) {
-    v = HermesValue::encodeDoubleValue(timeClip(utcTime(newDate)));
+    v = HermesValue::encodeDoubleValue(timeClip(utcTime(runtime, newDate)));
   } else {
     v = HermesValue::encodeDoubleValue(timeClip(newDate));
   }
@@ -1000,7 +1010,7 @@ datePrototypeSetFullYear(void *ctx, Runtime *runtime, NativeArgs args) {
   }
   double t = JSDate::getPrimitiveValue(self.get(), runtime).getNumber();
   if (!isUTC) {
-    t = localTime(t);
+    t = localTime(runtime, t);
   }
   if (std::isnan(t)) {
     t = 0;
@@ -1033,7 +1043,7 @@ datePrototypeSetFullYear(void *ctx, Runtime *runtime, NativeArgs args) {
   double newDate = makeDate(makeDay(y, m, dt), timeWithinDay(t));
   PinnedHermesValue v;
   if (!isUTC) {
-    v = HermesValue::encodeDoubleValue(timeClip(utcTime(newDate)));
+    v = HermesValue::encodeDoubleValue(timeClip(utcTime(runtime, newDate)));
   } else {
     v = HermesValue::encodeDoubleValue(timeClip(newDate));
   }
@@ -1052,7 +1062,7 @@ datePrototypeSetYear(void *ctx, Runtime *runtime, NativeArgs args) {
         "Date.prototype.setYear() called on non-Date object");
   }
   double t = JSDate::getPrimitiveValue(self.get(), runtime).getNumber();
-  t = localTime(t);
+  t = localTime(runtime, t);
   if (std::isnan(t)) {
     t = 0;
   }
@@ -1068,8 +1078,10 @@ datePrototypeSetYear(void *ctx, Runtime *runtime, NativeArgs args) {
   }
   double yint = oscompat::trunc(y);
   double yr = 0 <= yint && yint <= 99 ? yint + 1900 : y;
-  double date = utcTime(makeDate(
-      makeDay(yr, monthFromTime(t), dateFromTime(t)), timeWithinDay(t)));
+  double date = utcTime(
+      runtime,
+      makeDate(
+          makeDay(yr, monthFromTime(t), dateFromTime(t)), timeWithinDay(t)));
   auto v = HermesValue::encodeDoubleValue(timeClip(date));
   JSDate::setPrimitiveValue(self.get(), runtime, v);
   return v;
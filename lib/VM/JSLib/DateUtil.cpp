@@ -9,6 +9,7 @@
 #include "hermes/Platform/Unicode/PlatformUnicode.h"
 #include "hermes/Support/Compiler.h"
 #include "hermes/Support/OSCompat.h"
+#include "hermes/Support/OptValue.h"
 #include "hermes/VM/CallResult.h"
 #include "hermes/VM/JSLib/RuntimeCommonStorage.h"
 #include "hermes/VM/SmallXString.h"
@@ -369,13 +370,13 @@ int32_t detail::equivalentTime(int64_t epochSecs) {
   return (eqYearAsEpochDays + dayOfYear) * SECS_PER_DAY + secsOfDay;
 }
 
-double daylightSavingTA(double t) {
+/// Convert \p t to the seconds used to determine its DST with
+/// daylightSavingTAForEquivalentTime().
+/// \return the seconds, or None if \p t is outside the time range.
+static OptValue<int32_t> dstEquivalentTime(double t) {
   if (!std::isfinite(t)) {
-    return std::numeric_limits<double>::quiet_NaN();
+    return llvm::None;
   }
-
-  ::tzset();
-
   // Convert t to seconds and get the actual time needed.
   const double seconds = t / MS_PER_SECOND;
   // If the number of seconds is higher or lower than a unix timestamp can
@@ -383,15 +384,18 @@ double daylightSavingTA(double t) {
   // Invalid Date) breaks date construction entirely. Clamping only results in
   // small errors in daylight savings time. This is only a problem in systems
   // with a 32-bit time_t, like some Android systems.
-  time_t local = 0;
   if (seconds > TIME_RANGE_SECS || seconds < -TIME_RANGE_SECS) {
     // Return NaN if input is outside Time Range allowed in ES5.1
-    return std::numeric_limits<double>::quiet_NaN();
+    return llvm::None;
   }
   // This will truncate any fractional seconds, which is ok for daylight
   // savings time calculations.
-  local = detail::equivalentTime(static_cast<int64_t>(seconds));
+  return detail::equivalentTime(static_cast<int64_t>(seconds));
+}
 
+/// \return the DST adjustment at the time \p local returned by
+/// dstEquivalentTime().
+static double daylightSavingTAForEquivalentTime(time_t local) {
   std::tm *brokenTime = std::localtime(&local);
   if (!brokenTime) {
     // Local time is invalid.
@@ -400,6 +404,69 @@ double daylightSavingTA(double t) {
   return brokenTime->tm_isdst ? MS_PER_HOUR : 0;
 }
 
+double daylightSavingTA(double t) {
+  auto local = dstEquivalentTime(t);
+  if (!local) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+
+  ::tzset();
+  return daylightSavingTAForEquivalentTime(*local);
+}
+
+constexpr std::chrono::milliseconds LocalTimeOffsetCache::kMaxAge;
+
+void LocalTimeOffsetCache::validate() {
+  auto now = std::chrono::steady_clock::now();
+  const char *tz = ::getenv("TZ");
+  if (valid_ && now - filledAt_ < kMaxAge &&
+      (tz ? tzSet_ && tz_ == tz : !tzSet_)) {
+    return;
+  }
+  tzSet_ = tz;
+  tz_ = tz ? tz : "";
+  filledAt_ = now;
+  // This calls tzset(), so daylightSavingTAForEquivalentTime() can rely on it
+  // until the cache is refilled.
+  localTZA_ = localTZA();
+  hasDSTInterval_ = false;
+  valid_ = true;
+}
+
+double LocalTimeOffsetCache::getLocalTZA() {
+  validate();
+  return localTZA_;
+}
+
+double LocalTimeOffsetCache::getDaylightSavingTA(double t) {
+  auto local = dstEquivalentTime(t);
+  if (!local) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  validate();
+  if (hasDSTInterval_ && dstStart_ <= *local && *local <= dstEnd_) {
+    return dst_;
+  }
+
+  double dst = daylightSavingTAForEquivalentTime(*local);
+  if (std::isnan(dst)) {
+    return dst;
+  }
+  if (hasDSTInterval_ && dst == dst_ && *local > dstEnd_ &&
+      *local - dstEnd_ <= kMaxIntervalExtensionSecs) {
+    dstEnd_ = *local;
+  } else if (
+      hasDSTInterval_ && dst == dst_ && *local < dstStart_ &&
+      dstStart_ - *local <= kMaxIntervalExtensionSecs) {
+    dstStart_ = *local;
+  } else {
+    hasDSTInterval_ = true;
+    dstStart_ = dstEnd_ = *local;
+    dst_ = dst;
+  }
+  return dst;
+}
+
 //===----------------------------------------------------------------------===//
 // ES5.1 15.9.1.9
 
@@ -414,6 +481,15 @@ double utcTime(double t) {
   return t - ltza - daylightSavingTA(t - ltza);
 }
 
+double localTime(double t, LocalTimeOffsetCache &cache) {
+  return t + cache.getLocalTZA() + cache.getDaylightSavingTA(t);
+}
+
+double utcTime(double t, LocalTimeOffsetCache &cache) {
+  double ltza = cache.getLocalTZA();
+  return t - ltza - cache.getDaylightSavingTA(t - ltza);
+}
+
 //===----------------------------------------------------------------------===//
 // ES5.1 15.9.1.10
 
@@ -597,23 +673,78 @@ static inline bool isDigit(char16_t c) {
 /// \return true if successful, false if failed.
 template <class InputIter>
 static bool scanInt(InputIter &it, const InputIter end, int32_t &x) {
-  llvm::SmallString<16> str{};
-  if (it == end) {
+  if (it == end || !isDigit(*it)) {
     return false;
   }
+  int64_t result = 0;
   for (; it != end && isDigit(*it); ++it) {
-    str += static_cast<char>(*it);
+    result = result * 10 + (*it - u'0');
+    if (result > std::numeric_limits<int32_t>::max()) {
+      return false;
+    }
+  }
+  x = result;
+  return true;
+}
+
+/// \return the value of the \p count digits at \p it, or -1 if they are not
+/// all digits.
+template <class CharT>
+static int32_t fixedDigits(const CharT *it, unsigned count) {
+  int32_t result = 0;
+  for (unsigned i = 0; i < count; ++i) {
+    if (!isDigit(it[i])) {
+      return -1;
+    }
+    result = result * 10 + (it[i] - u'0');
+  }
+  return result;
+}
+
+/// Parse the exact format produced by Date.prototype.toISOString() for years
+/// 0 to 9999, YYYY-MM-DDTHH:mm:ss.sssZ, which is by far the most common input,
+/// reading every field at its fixed position.
+/// \return the time, or None if \p str has a different format.
+template <class CharT>
+static OptValue<double> parseISOString(llvm::ArrayRef<CharT> str) {
+  if (str.size() != 24 || str[4] != u'-' || str[7] != u'-' ||
+      str[10] != u'T' || str[13] != u':' || str[16] != u':' ||
+      str[19] != u'.' || str[23] != u'Z') {
+    return llvm::None;
+  }
+  const CharT *p = str.data();
+  int32_t y = fixedDigits(p, 4), m = fixedDigits(p + 5, 2),
+          d = fixedDigits(p + 8, 2), h = fixedDigits(p + 11, 2),
+          min = fixedDigits(p + 14, 2), s = fixedDigits(p + 17, 2),
+          ms = fixedDigits(p + 20, 3);
+  if (y < 0 || m < 0 || d < 0 || h < 0 || min < 0 || s < 0 || ms < 0) {
+    return llvm::None;
   }
-  llvm::StringRef ref{str};
-  // getAsInteger returns false to signify success.
-  return !ref.getAsInteger(10, x);
+  return makeDate(makeDay(y, m - 1, d), makeTime(h, min, s, ms));
 }
 
+template <class CharT>
+static double parseDateImpl(llvm::ArrayRef<CharT> str);
+
 double parseDate(StringView u16str) {
+  if (u16str.isASCII()) {
+    return parseDateImpl(
+        llvm::ArrayRef<char>(u16str.castToCharPtr(), u16str.length()));
+  }
+  return parseDateImpl(
+      llvm::ArrayRef<char16_t>(u16str.castToChar16Ptr(), u16str.length()));
+}
+
+template <class CharT>
+static double parseDateImpl(llvm::ArrayRef<CharT> str) {
+  if (auto iso = parseISOString(str)) {
+    return *iso;
+  }
+
   const double nan = std::numeric_limits<double>::quiet_NaN();
 
-  auto it = u16str.begin();
-  auto end = u16str.end();
+  const CharT *it = str.begin();
+  const CharT *end = str.end();
 
   // Used to indicate the negation multiplier on an integer.
   // 1 for positive, -1 for negative.
@@ -86,6 +86,11 @@ Handle<JSObject> createFunctionConstructor(Runtime *runtime) {
       nullptr,
       functionPrototypeApply,
       2);
+  runtime->functionPrototypeApply =
+      runtime->ignoreAllocationFailure(JSObject::getNamed_RJS(
+          functionPrototype,
+          runtime,
+          Predefined::getSymbolID(Predefined::apply)));
   defineMethod(
       runtime,
       functionPrototype,
@@ -93,6 +98,11 @@ Handle<JSObject> createFunctionConstructor(Runtime *runtime) {
       nullptr,
       functionPrototypeCall,
       1);
+  runtime->functionPrototypeCall =
+      runtime->ignoreAllocationFailure(JSObject::getNamed_RJS(
+          functionPrototype,
+          runtime,
+          Predefined::getSymbolID(Predefined::call)));
   defineMethod(
       runtime,
       functionPrototype,
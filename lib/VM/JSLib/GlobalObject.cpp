@@ -127,8 +127,18 @@ parseInt(void *, Runtime *runtime, NativeArgs args) {
     return HermesValue::encodeNaNValue();
   }
 
+  StringView digits = strView.slice(begin, realEnd);
+  if (radix == 10) {
+    // Short decimal integers are converted exactly without a double per digit.
+    uint32_t parsedLength;
+    OptValue<double> fastResult = parseDecimalFast(digits, &parsedLength);
+    if (fastResult) {
+      assert(parsedLength == digits.length() && "digits not all parsed");
+      return HermesValue::encodeDoubleValue(sign * *fastResult);
+    }
+  }
   return HermesValue::encodeDoubleValue(
-      sign * parseIntWithRadix(strView.slice(begin, realEnd), radix));
+      sign * parseIntWithRadix(digits, radix));
 }
 
 // Check if str1 is a prefix of str2.
@@ -170,6 +180,14 @@ parseFloat(void *, Runtime *runtime, NativeArgs args) {
   }
   StringView str16 = origStr.slice(begin, end);
 
+  // Most numbers are short decimals, which don't need dtoa. Like g_strtod
+  // below, this parses the longest valid prefix.
+  uint32_t parsedLength;
+  OptValue<double> fastResult = parseDecimalFast(str16, &parsedLength);
+  if (fastResult) {
+    return HermesValue::encodeDoubleValue(*fastResult);
+  }
+
   // Check for special values.
   // parseFloat allows for partial match, hence we have to check for
   // substring.
@@ -562,6 +580,9 @@ void initGlobalObject(Runtime *runtime) {
   // ArrayBuffer constructor.
   createArrayBufferConstructor(runtime);
 
+  // The constructors below, up to WeakSet, only become populated, along with
+  // their prototypes, when they are first used.
+
   // DataView constructor.
   createDataViewConstructor(runtime);
 
@@ -8,10 +8,15 @@
 
 #include "hermes/BCGen/HBC/BytecodeFileFormat.h"
 #include "hermes/Support/Base64vlq.h"
+#include "hermes/Support/JenkinsHash.h"
 #include "hermes/VM/JSArrayBuffer.h"
+#include "hermes/VM/JSLib/RuntimeJSONUtils.h"
 #include "hermes/VM/JSTypedArray.h"
 #include "hermes/VM/JSWeakMapImpl.h"
 
+#include "llvm/ADT/StringMap.h"
+
+#include <algorithm>
 #include <random>
 
 namespace hermes {
@@ -49,7 +54,10 @@ hermesInternalCreateHeapSnapshot(void *, Runtime *runtime, NativeArgs args) {
   if (args.getArgCount() >= 1) {
     compact = toBoolean(args.getArg(0));
   }
-  runtime->getHeap().createSnapshot(llvm::errs(), compact);
+  HeapSnapshotOptions options;
+  options.compact = compact;
+  // llvm::errs() is unbuffered, which would make a write per token.
+  runtime->getHeap().createSnapshotToFD(/* stderr */ 2, options);
   return HermesValue::encodeUndefinedValue();
 }
 
@@ -239,6 +247,57 @@ hermesInternalGetInstrumentedStats(void *, Runtime *runtime, NativeArgs args) {
     SET_PROP_NEW("js_totalAllocatedBytes", info.totalAllocatedBytes);
   }
 
+  {
+    const RegExpCache &regExpCache = runtime->getRegExpCache();
+    SET_PROP_NEW("js_regExpCacheHits", regExpCache.getHits());
+    SET_PROP_NEW("js_regExpCacheMisses", regExpCache.getMisses());
+  }
+
+  {
+    const EvalCache &evalCache = runtime->getEvalCache();
+    SET_PROP_NEW("js_evalCacheHits", evalCache.getHits());
+    SET_PROP_NEW("js_evalCacheMisses", evalCache.getMisses());
+  }
+
+  if (!stats.nativeCalls.empty()) {
+    // Functions with the same name are merged, since the name is the key.
+    llvm::StringMap<instrumentation::RuntimeStats::NativeCallStatistic> byName;
+    for (const auto &entry : stats.nativeCalls) {
+      const auto &stat = entry.second;
+      auto &merged = byName[stat.name.empty() ? "(anonymous)" : stat.name];
+      merged.count += stat.count;
+      merged.timedCount += stat.timedCount;
+      merged.timedWallDuration += stat.timedWallDuration;
+    }
+    std::vector<std::pair<llvm::StringRef, double>> times;
+    for (const auto &entry : byName) {
+      times.emplace_back(
+          entry.getKey(), entry.getValue().estimatedWallDuration());
+    }
+    // Only report the functions that took the most time.
+    static constexpr size_t kMaxNativeCallStats = 32;
+    std::sort(
+        times.begin(),
+        times.end(),
+        [](const std::pair<llvm::StringRef, double> &a,
+           const std::pair<llvm::StringRef, double> &b) {
+          return a.second > b.second;
+        });
+    if (times.size() > kMaxNativeCallStats) {
+      times.resize(kMaxNativeCallStats);
+    }
+    for (const auto &time : times) {
+      // The keys must be ASCII.
+      std::string name = time.first.str();
+      std::replace_if(
+          name.begin(), name.end(), [](char c) { return c & 0x80; }, '?');
+      std::string countKey = "js_nativeCallCount:" + name;
+      std::string timeKey = "js_nativeCallTime:" + name;
+      SET_PROP_NEW(countKey.c_str(), byName[time.first].count);
+      SET_PROP_NEW(timeKey.c_str(), time.second);
+    }
+  }
+
   if (stats.shouldSample) {
     SET_PROP_NEW(
         "js_hermesVolCtxSwitches",
@@ -442,110 +501,13 @@ hermesInternalGetTemplateObject(void *, Runtime *runtime, NativeArgs args) {
   }
   uint32_t count = dup ? args.getArgCount() - 2 : args.getArgCount() / 2 - 1;
 
-  // Create template object and raw object.
-  auto arrRes = JSArray::create(runtime, count, 0);
-  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  auto rawObj = runtime->makeHandle<JSObject>(arrRes->getHermesValue());
-  auto arrRes2 = JSArray::create(runtime, count, 0);
-  if (LLVM_UNLIKELY(arrRes2 == ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  auto templateObj = runtime->makeHandle<JSObject>(arrRes2->getHermesValue());
-
-  // Set cooked and raw strings as elements in template object and raw object,
-  // respectively.
-  DefinePropertyFlags dpf{};
-  dpf.setWritable = 1;
-  dpf.setConfigurable = 1;
-  dpf.setEnumerable = 1;
-  dpf.setValue = 1;
-  dpf.writable = 0;
-  dpf.configurable = 0;
-  dpf.enumerable = 1;
-  MutableHandle<> idx{runtime};
-  MutableHandle<> rawValue{runtime};
-  MutableHandle<> cookedValue{runtime};
-  uint32_t cookedBegin = dup ? 2 : 2 + count;
-  auto marker = gcScope.createMarker();
-  for (uint32_t i = 0; i < count; ++i) {
-    idx = HermesValue::encodeNumberValue(i);
-
-    cookedValue = args.getArg(cookedBegin + i);
-    auto putRes = JSObject::defineOwnComputedPrimitive(
-        templateObj, runtime, idx, dpf, cookedValue);
-    assert(
-        putRes != ExecutionStatus::EXCEPTION && *putRes &&
-        "Failed to set cooked value to template object.");
-
-    rawValue = args.getArg(2 + i);
-    putRes = JSObject::defineOwnComputedPrimitive(
-        rawObj, runtime, idx, dpf, rawValue);
-    assert(
-        putRes != ExecutionStatus::EXCEPTION && *putRes &&
-        "Failed to set raw value to raw object.");
-
-    gcScope.flushToMarker(marker);
-  }
-  // Make 'length' property on the raw object read-only.
-  DefinePropertyFlags readOnlyDPF{};
-  readOnlyDPF.setWritable = 1;
-  readOnlyDPF.setConfigurable = 1;
-  readOnlyDPF.writable = 0;
-  readOnlyDPF.configurable = 0;
-  auto readOnlyRes = JSObject::defineOwnProperty(
-      rawObj,
-      runtime,
-      Predefined::getSymbolID(Predefined::length),
-      readOnlyDPF,
-      runtime->getUndefinedValue(),
-      PropOpFlags().plusThrowOnError());
-  if (LLVM_UNLIKELY(readOnlyRes == ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  if (LLVM_UNLIKELY(!*readOnlyRes)) {
-    return runtime->raiseTypeError(
-        "Failed to set 'length' property on the raw object read-only.");
-  }
-  JSObject::preventExtensions(rawObj.get());
-
-  // Set raw object as a read-only non-enumerable property of the template
-  // object.
-  PropertyFlags constantPF{};
-  constantPF.writable = 0;
-  constantPF.configurable = 0;
-  constantPF.enumerable = 0;
-  auto putNewRes = JSObject::defineNewOwnProperty(
-      templateObj,
-      runtime,
-      Predefined::getSymbolID(Predefined::raw),
-      constantPF,
-      rawObj);
-  if (LLVM_UNLIKELY(putNewRes == ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  // Make 'length' property on the template object read-only.
-  readOnlyRes = JSObject::defineOwnProperty(
-      templateObj,
+  return createTemplateObject(
       runtime,
-      Predefined::getSymbolID(Predefined::length),
-      readOnlyDPF,
-      runtime->getUndefinedValue(),
-      PropOpFlags().plusThrowOnError());
-  if (LLVM_UNLIKELY(readOnlyRes == ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  if (LLVM_UNLIKELY(!*readOnlyRes)) {
-    return runtime->raiseTypeError(
-        "Failed to set 'length' property on the raw object read-only.");
-  }
-  JSObject::preventExtensions(templateObj.get());
-
-  // Cache the template object.
-  runtimeModule->cacheTemplateObject(templateObjID, templateObj);
-
-  return templateObj.getHermesValue();
+      runtimeModule,
+      templateObjID,
+      count,
+      dup,
+      [args](uint32_t i) { return args.getArg(2 + i); });
 }
 
 /// If the first argument is not an object, throw a type error with the second
@@ -590,6 +552,13 @@ hermesInternalCopyDataProperties(void *, Runtime *runtime, NativeArgs args) {
             runtime->makeHandle(*toObject(runtime, untypedSource)));
   Handle<JSObject> excludedItems = args.dyncastArg<JSObject>(runtime, 2);
 
+  // Copying everything into a new object, as in {...source}, can share the
+  // class of the source and copy its slots.
+  if (!excludedItems &&
+      JSObject::tryCloneOwnProperties(target, runtime, source)) {
+    return target.getHermesValue();
+  }
+
   MutableHandle<> nameHandle{runtime};
   MutableHandle<> valueHandle{runtime};
 
@@ -705,6 +674,7 @@ hermesInternalCopyRestArgs(void *, Runtime *runtime, NativeArgs args) {
         array.get(), runtime, i, it->getArgRef(from));
     ++from;
   }
+  JSArray::unsafeMarkFilled(array.get(), runtime);
 
   return array.getHermesValue();
 }
@@ -812,6 +782,69 @@ hermesInternalExportAll(void *, Runtime *runtime, NativeArgs args) {
   return HermesValue::encodeUndefinedValue();
 }
 
+/// \code
+///   HermesInternal.parseJSONFromArrayBuffer(buffer[, reviver])
+/// \endcode
+/// Parse the UTF-8 encoded JSON text in the ArrayBuffer \p buffer, like
+/// JSON.parse() would parse it after decoding it into a string.
+CallResult<HermesValue> hermesInternalParseJSONFromArrayBuffer(
+    void *,
+    Runtime *runtime,
+    NativeArgs args) {
+  auto buffer = args.dyncastArg<JSArrayBuffer>(runtime, 0);
+  if (LLVM_UNLIKELY(!buffer)) {
+    return runtime->raiseTypeError(
+        "parseJSONFromArrayBuffer() argument must be an ArrayBuffer");
+  }
+  if (LLVM_UNLIKELY(!buffer->attached())) {
+    return runtime->raiseTypeError(
+        "parseJSONFromArrayBuffer() argument is a detached ArrayBuffer");
+  }
+  // The lexer copies the text before anything can run, so the buffer can
+  // safely be detached by the reviver.
+  llvm::ArrayRef<uint8_t> utf8{
+      reinterpret_cast<const uint8_t *>(buffer->getDataBlock()),
+      buffer->size()};
+  return runtimeJSONParseUTF8(
+      runtime, utf8, args.dyncastArg<Callable>(runtime, 1));
+}
+
+/// \code
+///   HermesInternal.enqueueJob(job)
+/// \endcode
+/// Add the function \p job to the job queue of the runtime, to be called with
+/// no arguments when the host drains the queue, e.g. as a promise reaction.
+CallResult<HermesValue>
+hermesInternalEnqueueJob(void *, Runtime *runtime, NativeArgs args) {
+  auto job = args.dyncastArg<Callable>(runtime, 0);
+  if (LLVM_UNLIKELY(!job)) {
+    return runtime->raiseTypeError("enqueueJob() argument must be a function");
+  }
+  runtime->enqueueJob(job);
+  return HermesValue::encodeUndefinedValue();
+}
+
+/// \code
+///   HermesInternal.concatStrings(...parts)
+/// \endcode
+/// \return the concatenation of toString() of each argument, allocated at
+/// once. Template literals and chains of string concatenations compile to
+/// this.
+CallResult<HermesValue>
+hermesInternalConcatStrings(void *, Runtime *runtime, NativeArgs args) {
+  GCScopeMarkerRAII marker{runtime};
+  if (args.getArgCount() == 0) {
+    return HermesValue::encodeStringValue(
+        runtime->getPredefinedString(Predefined::emptyString));
+  }
+  auto strRes = toString_RJS(runtime, args.getArgHandle(runtime, 0));
+  if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return concatArgsToString(
+      runtime, toHandle(runtime, std::move(*strRes)), args, 1);
+}
+
 #ifdef HERMESVM_EXCEPTION_ON_OOM
 /// Gets the current call stack as a JS String value.  Intended (only)
 /// to allow testing of Runtime::callStack() from JS code.
@@ -884,6 +917,10 @@ Handle<JSObject> createHermesInternalObject(Runtime *runtime) {
   defineInternMethod(P::ttiReached, hermesInternalTTIReached);
   defineInternMethod(P::ttrcReached, hermesInternalTTRCReached);
   defineInternMethod(P::exportAll, hermesInternalExportAll);
+  defineInternMethod(
+      P::parseJSONFromArrayBuffer, hermesInternalParseJSONFromArrayBuffer, 1);
+  defineInternMethod(P::enqueueJob, hermesInternalEnqueueJob, 1);
+  defineInternMethod(P::concatStrings, hermesInternalConcatStrings);
 #ifdef HERMESVM_EXCEPTION_ON_OOM
   defineInternMethodAndSymbol("getCallStack", hermesInternalGetCallStack, 0);
 #endif // HERMESVM_EXCEPTION_ON_OOM
@@ -16,6 +16,29 @@
 namespace hermes {
 namespace vm {
 
+/// Define the global property \p name, holding the constructor \p cons.
+static void defineGlobalConstructor(
+    Runtime *runtime,
+    SymbolID name,
+    Handle<NativeConstructor> cons) {
+  DefinePropertyFlags dpf{};
+
+  dpf.setEnumerable = 1;
+  dpf.setWritable = 1;
+  dpf.setConfigurable = 1;
+  dpf.setValue = 1;
+  dpf.enumerable = 0;
+  dpf.writable = 1;
+  dpf.configurable = 1;
+
+  auto res = JSObject::defineOwnProperty(
+      runtime->getGlobal(), runtime, name, dpf, cons);
+  assert(
+      res != ExecutionStatus::EXCEPTION && *res &&
+      "defineOwnProperty() failed");
+  (void)res;
+}
+
 Handle<NativeConstructor> defineSystemConstructor(
     Runtime *runtime,
     SymbolID name,
@@ -36,8 +59,47 @@ Handle<NativeConstructor> defineSystemConstructor(
           creator,
           targetKind));
 
+  initializeSystemConstructor(
+      runtime, constructor, name, prototypeObjectHandle, paramCount);
+
+  // Define the global.
+  defineGlobalConstructor(runtime, name, constructor);
+
+  return constructor;
+}
+
+Handle<NativeConstructor> defineLazySystemConstructor(
+    Runtime *runtime,
+    SymbolID name,
+    NativeFunctionPtr nativeFunctionPtr,
+    Handle<JSObject> constructorProtoObjectHandle,
+    NativeConstructor::CreatorFunction *creator,
+    CellKind targetKind,
+    Runtime::LazyConstructorInitializer init) {
+  auto constructor = toHandle(
+      runtime,
+      NativeConstructor::createLazy(
+          runtime,
+          constructorProtoObjectHandle,
+          nativeFunctionPtr,
+          creator,
+          targetKind));
+  runtime->registerLazyConstructor(constructor, init);
+
+  // Define the global.
+  defineGlobalConstructor(runtime, name, constructor);
+
+  return constructor;
+}
+
+void initializeSystemConstructor(
+    Runtime *runtime,
+    Handle<NativeConstructor> cons,
+    SymbolID name,
+    Handle<JSObject> prototypeObjectHandle,
+    unsigned paramCount) {
   auto st = Callable::defineNameLengthAndPrototype(
-      constructor,
+      cons,
       runtime,
       name,
       paramCount,
@@ -47,26 +109,6 @@ Handle<NativeConstructor> defineSystemConstructor(
   (void)st;
   assert(
       st != ExecutionStatus::EXCEPTION && "defineLengthAndPrototype() failed");
-
-  // Define the global.
-  DefinePropertyFlags dpf{};
-
-  dpf.setEnumerable = 1;
-  dpf.setWritable = 1;
-  dpf.setConfigurable = 1;
-  dpf.setValue = 1;
-  dpf.enumerable = 0;
-  dpf.writable = 1;
-  dpf.configurable = 1;
-
-  auto res = JSObject::defineOwnProperty(
-      runtime->getGlobal(), runtime, name, dpf, constructor);
-  assert(
-      res != ExecutionStatus::EXCEPTION && *res &&
-      "defineOwnProperty() failed");
-  (void)res;
-
-  return constructor;
 }
 
 CallResult<HermesValue> defineMethod(
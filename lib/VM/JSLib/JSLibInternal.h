@@ -73,6 +73,47 @@ Handle<NativeConstructor> defineSystemConstructor(
       targetKind);
 }
 
+/// Declare a system constructor like defineSystemConstructor(), but only
+/// create the lazy constructor and the global property \p name now. \p init
+/// populates the prototype and the constructor, which must include calling
+/// initializeSystemConstructor(), the first time the constructor is used.
+/// This is only suitable for constructors whose prototype can't be reached
+/// from JS without going through the constructor first.
+Handle<NativeConstructor> defineLazySystemConstructor(
+    Runtime *runtime,
+    SymbolID name,
+    NativeFunctionPtr nativeFunctionPtr,
+    Handle<JSObject> constructorProtoObjectHandle,
+    NativeConstructor::CreatorFunction *creator,
+    CellKind targetKind,
+    Runtime::LazyConstructorInitializer init);
+
+template <class NativeClass>
+Handle<NativeConstructor> defineLazySystemConstructor(
+    Runtime *runtime,
+    SymbolID name,
+    NativeFunctionPtr nativeFunctionPtr,
+    CellKind targetKind,
+    Runtime::LazyConstructorInitializer init) {
+  return defineLazySystemConstructor(
+      runtime,
+      name,
+      nativeFunctionPtr,
+      Handle<JSObject>::vmcast(&runtime->functionPrototype),
+      NativeClass::create,
+      targetKind,
+      init);
+}
+
+/// Define the 'name', 'length' and 'prototype' properties of the lazy system
+/// constructor \p cons, as defineSystemConstructor() does.
+void initializeSystemConstructor(
+    Runtime *runtime,
+    Handle<NativeConstructor> cons,
+    SymbolID name,
+    Handle<JSObject> prototypeObjectHandle,
+    unsigned paramCount);
+
 /// Define a method in an object instance.
 /// Currently, it's only used to define global %HermesInternal object in
 /// createHermesInternalObject(), with different flags, i.e. writable = 0 and
@@ -236,6 +277,16 @@ CallResult<HermesValue> directObjectPrototypeToString(
 /// \return the global String constructor.
 Handle<JSObject> createStringConstructor(Runtime *runtime);
 
+/// Concatenate \p first with the result of toString() on each of the
+/// arguments in \p args, starting with the one at \p argIndex, allocating the
+/// result only once.
+/// Main logic for String.prototype.concat and HermesInternal.concatStrings.
+CallResult<HermesValue> concatArgsToString(
+    Runtime *runtime,
+    Handle<StringPrimitive> first,
+    NativeArgs args,
+    uint32_t argIndex);
+
 /// Create and initialize the global Function constructor. Populate the methods
 /// of Function and Function.prototype.
 /// \return the global Function constructor.
@@ -6,9 +6,15 @@
  */
 #include "JSONLexer.h"
 
+#include "hermes/Platform/Unicode/CharacterProperties.h"
+#include "hermes/Support/UTF8.h"
 #include "hermes/VM/StringPrimitive.h"
 #include "hermes/dtoa/dtoa.h"
 
+#include "llvm/Support/ConvertUTF.h"
+
+#include <algorithm>
+
 namespace hermes {
 namespace vm {
 
@@ -21,11 +27,51 @@ static bool isJSONWhiteSpace(char16_t ch) {
   return (ch == u'\t' || ch == u'\r' || ch == u'\n' || ch == u' ');
 }
 
-ExecutionStatus JSONLexer::advance() {
-  // Skip whitespaces.
+/// \return whether \p ch can appear in a JSONString without being escaped,
+/// and does not end it.
+static inline bool isPlainStringChar(char16_t ch) {
+  return ch >= 0x20 && ch != u'"' && ch != u'\\';
+}
+
+JSONLexer::JSONLexer(Runtime *runtime, llvm::ArrayRef<uint8_t> utf8)
+    : runtime_(runtime), token_(runtime) {
+  // No UTF-8 sequence decodes to more UTF-16 code units than it has bytes.
+  buffer_.resize(utf8.size());
+  // Widen the ASCII prefix directly, and only decode the rest.
+  const uint8_t *firstNonASCII = findFirstNonASCII(utf8.begin(), utf8.end());
+  widenASCII(
+      reinterpret_cast<const char *>(utf8.begin()),
+      firstNonASCII - utf8.begin(),
+      buffer_.data());
+  auto *src = reinterpret_cast<const llvm::UTF8 *>(firstNonASCII);
+  auto *srcEnd = reinterpret_cast<const llvm::UTF8 *>(utf8.end());
+  auto *dst = reinterpret_cast<llvm::UTF16 *>(
+      buffer_.data() + (firstNonASCII - utf8.begin()));
+  auto *dstEnd = reinterpret_cast<llvm::UTF16 *>(buffer_.end());
+  while (src != srcEnd) {
+    if (llvm::ConvertUTF8toUTF16(
+            &src, srcEnd, &dst, dstEnd, llvm::lenientConversion) ==
+        llvm::conversionOK) {
+      break;
+    }
+    // Replace the invalid or truncated sequence and resume after its first
+    // byte.
+    *dst++ = UNICODE_REPLACEMENT_CHARACTER;
+    ++src;
+  }
+  buffer_.resize(reinterpret_cast<char16_t *>(dst) - buffer_.data());
+  curCharPtr_ = buffer_.data();
+  bufferEnd_ = buffer_.data() + buffer_.size();
+}
+
+void JSONLexer::skipWhitespace() {
   while (curCharPtr_ < bufferEnd_ && isJSONWhiteSpace(*curCharPtr_)) {
     curCharPtr_++;
   }
+}
+
+ExecutionStatus JSONLexer::advance() {
+  skipWhitespace();
 
   // End of buffer.
   if (curCharPtr_ == bufferEnd_) {
@@ -64,13 +110,21 @@ ExecutionStatus JSONLexer::advance() {
       return scanNumber();
 
     case u'"':
-      return scanString();
+      return scanString(false);
 
     default:
       return errorWithChar(u"Unexpected token: ", *curCharPtr_);
   }
 }
 
+ExecutionStatus JSONLexer::advanceStrAsSymbol() {
+  skipWhitespace();
+  if (curCharPtr_ == bufferEnd_ || *curCharPtr_ != u'"')
+    return advance();
+  token_.setLoc(curCharPtr_);
+  return scanString(true);
+}
+
 CallResult<char16_t> JSONLexer::consumeUnicode() {
   uint16_t val = 0;
   for (unsigned i = 0; i < 4; ++i) {
@@ -110,6 +164,25 @@ ExecutionStatus JSONLexer::scanNumber() {
     return errorWithChar(u"Unexpected token in number: ", *(start + 1));
   }
 
+  // Most numbers are small integers, which are computed exactly here without
+  // going through g_strtod.
+  {
+    const char16_t *digits = start + (*start == u'-');
+    size_t numDigits = curCharPtr_ - digits;
+    if (numDigits && numDigits <= 15 &&
+        std::all_of(digits, curCharPtr_, [](char16_t ch) {
+          return ch >= u'0' && ch <= u'9';
+        })) {
+      int64_t value = 0;
+      for (const char16_t *p = digits; p != curCharPtr_; ++p)
+        value = value * 10 + (*p - u'0');
+      // Negate the double, so that "-0" is -0.
+      double number = value;
+      token_.setNumber(digits == start ? number : -number);
+      return ExecutionStatus::RETURNED;
+    }
+  }
+
   // copy 16 bit chars into 8 bit chars and call g_strtod.
   llvm::SmallVector<char, 32> str8;
   str8.insert(str8.begin(), start, start + len);
@@ -125,21 +198,46 @@ ExecutionStatus JSONLexer::scanNumber() {
   return ExecutionStatus::RETURNED;
 }
 
-ExecutionStatus JSONLexer::scanString() {
+ExecutionStatus JSONLexer::setStringToken(UTF16Ref str, bool asSymbol) {
+  if (asSymbol) {
+    auto symRes = runtime_->getIdentifierTable().getSymbolHandle(runtime_, str);
+    if (LLVM_UNLIKELY(symRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    token_.setSymbol(**symRes);
+    return ExecutionStatus::RETURNED;
+  }
+  auto strRes = StringPrimitive::createEfficient(runtime_, str);
+  if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  token_.setString(vmcast<StringPrimitive>(*strRes));
+  return ExecutionStatus::RETURNED;
+}
+
+ExecutionStatus JSONLexer::scanString(bool asSymbol) {
   assert(*curCharPtr_ == '"');
-  ++curCharPtr_;
+  const char16_t *start = ++curCharPtr_;
+
+  // Most strings have no escapes, so look for the end of the string first and
+  // create it directly from the input if there are none.
+  while (curCharPtr_ < bufferEnd_ && isPlainStringChar(*curCharPtr_)) {
+    ++curCharPtr_;
+  }
+  if (curCharPtr_ < bufferEnd_ && *curCharPtr_ == '"') {
+    UTF16Ref str{start, static_cast<size_t>(curCharPtr_ - start)};
+    ++curCharPtr_;
+    return setStringToken(str, asSymbol);
+  }
+
   SmallU16String<32> tmpStorage;
+  tmpStorage.append(start, curCharPtr_);
 
   while (curCharPtr_ < bufferEnd_) {
     if (*curCharPtr_ == '"') {
       // End of string.
-      auto strRes = StringPrimitive::create(runtime_, tmpStorage.arrayRef());
-      if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
-        return ExecutionStatus::EXCEPTION;
-      }
-      token_.setString(runtime_->makeHandle<StringPrimitive>(*strRes));
       ++curCharPtr_;
-      return ExecutionStatus::RETURNED;
+      return setStringToken(tmpStorage.arrayRef(), asSymbol);
     } else if (*curCharPtr_ <= '\u001F') {
       return error(u"U+0000 thru U+001F is not allowed in string");
     }
@@ -190,7 +288,12 @@ ExecutionStatus JSONLexer::scanString() {
           return errorWithChar(u"Invalid escape sequence: ", *curCharPtr_);
       }
     } else {
-      tmpStorage.push_back(*curCharPtr_++);
+      // Copy the whole run of plain characters at once.
+      const char16_t *run = curCharPtr_;
+      while (curCharPtr_ < bufferEnd_ && isPlainStringChar(*curCharPtr_)) {
+        ++curCharPtr_;
+      }
+      tmpStorage.append(run, curCharPtr_);
     }
   }
   return error("Unexpected end of input");
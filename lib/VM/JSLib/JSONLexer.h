@@ -44,6 +44,7 @@ class JSONToken {
   JSONTokenKind kind_{JSONTokenKind::None};
   double numberValue_{};
   MutableHandle<StringPrimitive> stringValue_;
+  MutableHandle<SymbolID> symbolValue_;
 
   /// The starting location of this token.
   const char16_t *loc_{};
@@ -52,7 +53,8 @@ class JSONToken {
   const JSONToken &operator=(const JSONToken &) = delete;
 
  public:
-  explicit JSONToken(Runtime *runtime) : stringValue_(runtime) {}
+  explicit JSONToken(Runtime *runtime)
+      : stringValue_(runtime), symbolValue_(runtime) {}
 
   JSONTokenKind getKind() const {
     return kind_;
@@ -68,6 +70,13 @@ class JSONToken {
     return stringValue_;
   }
 
+  /// \return the string as an identifier, if the token was scanned by
+  /// JSONLexer::advanceStrAsSymbol().
+  Handle<SymbolID> getSymbol() const {
+    assert(getKind() == JSONTokenKind::String);
+    return symbolValue_;
+  }
+
   const char16_t *getLoc() const {
     return loc_;
   }
@@ -90,9 +99,13 @@ class JSONToken {
     kind_ = JSONTokenKind::Number;
     numberValue_ = number;
   }
-  void setString(Handle<StringPrimitive> str) {
+  void setString(StringPrimitive *str) {
+    kind_ = JSONTokenKind::String;
+    stringValue_ = str;
+  }
+  void setSymbol(SymbolID sym) {
     kind_ = JSONTokenKind::String;
-    stringValue_ = str.get();
+    symbolValue_ = sym;
   }
 };
 
@@ -118,6 +131,10 @@ class JSONLexer {
     bufferEnd_ = buffer_.data() + buffer_.size();
   }
 
+  /// Scan the UTF-8 encoded text \p utf8, which is decoded into the buffer
+  /// directly. Invalid UTF-8 sequences are decoded as U+FFFD.
+  JSONLexer(Runtime *runtime, llvm::ArrayRef<uint8_t> utf8);
+
   /// \return the current token.
   const JSONToken *getCurToken() const {
     assert(
@@ -131,6 +148,11 @@ class JSONLexer {
   /// All whitespace is skipped before the new token.
   LLVM_NODISCARD ExecutionStatus advance();
 
+  /// Like advance(), but if the next token is a string, store it in the token
+  /// as an identifier (see JSONToken::getSymbol()) instead of allocating a
+  /// string. Used for the keys of objects, which are identifiers anyway.
+  LLVM_NODISCARD ExecutionStatus advanceStrAsSymbol();
+
   /// Raise a JSON parse exception with message \p msg.
   /// token_ will also be invalidated.
   LLVM_NODISCARD ExecutionStatus error(const TwineChar16 &msg) {
@@ -150,8 +172,15 @@ class JSONLexer {
   /// Parse a JSONNumber.
   LLVM_NODISCARD ExecutionStatus scanNumber();
 
-  /// Parse a JSONString.
-  LLVM_NODISCARD ExecutionStatus scanString();
+  /// Skip whitespace before a token.
+  void skipWhitespace();
+
+  /// Parse a JSONString, as an identifier if \p asSymbol is set.
+  LLVM_NODISCARD ExecutionStatus scanString(bool asSymbol);
+
+  /// Store the contents \p str of a JSONString in the token, as an identifier
+  /// if \p asSymbol is set.
+  LLVM_NODISCARD ExecutionStatus setStringToken(UTF16Ref str, bool asSymbol);
 
   /// Parse a reserved keyword.
   LLVM_NODISCARD ExecutionStatus scanWord(const char *word, JSONTokenKind kind);
@@ -85,7 +85,9 @@ mapIteratorPrototypeNext(void *, Runtime *runtime, NativeArgs args);
 
 /// @}
 
-Handle<JSObject> createMapConstructor(Runtime *runtime) {
+static void initializeMapConstructor(
+    Runtime *runtime,
+    Handle<NativeConstructor> cons) {
   auto mapPrototype = Handle<JSMap>::vmcast(&runtime->mapPrototype);
 
   // Map.prototype.xxx methods.
@@ -199,15 +201,21 @@ Handle<JSObject> createMapConstructor(Runtime *runtime) {
       runtime->getPredefinedStringHandle(Predefined::Map),
       dpf);
 
-  auto cons = defineSystemConstructor<JSMap>(
+  initializeSystemConstructor(
       runtime,
+      cons,
       Predefined::getSymbolID(Predefined::Map),
-      mapConstructor,
       mapPrototype,
-      0,
-      CellKind::MapKind);
+      0);
+}
 
-  return cons;
+Handle<JSObject> createMapConstructor(Runtime *runtime) {
+  return defineLazySystemConstructor<JSMap>(
+      runtime,
+      Predefined::getSymbolID(Predefined::Map),
+      mapConstructor,
+      CellKind::MapKind,
+      initializeMapConstructor);
 }
 
 static CallResult<HermesValue>
@@ -311,7 +319,10 @@ mapPrototypeClear(void *, Runtime *runtime, NativeArgs args) {
     return runtime->raiseTypeError(
         "Method Map.prototype.clear called on incompatible receiver");
   }
-  JSMap::clear(selfHandle, runtime);
+  if (LLVM_UNLIKELY(
+          JSMap::clear(selfHandle, runtime) == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
   return HermesValue::encodeUndefinedValue();
 }
 
@@ -436,11 +447,14 @@ mapPrototypeSet(void *, Runtime *runtime, NativeArgs args) {
     return runtime->raiseTypeError(
         "Method Map.prototype.set called on incompatible receiver");
   }
-  JSMap::addValue(
-      selfHandle,
-      runtime,
-      args.getArgHandle(runtime, 0),
-      args.getArgHandle(runtime, 1));
+  if (LLVM_UNLIKELY(
+          JSMap::addValue(
+              selfHandle,
+              runtime,
+              args.getArgHandle(runtime, 0),
+              args.getArgHandle(runtime, 1)) == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
   return selfHandle.getHermesValue();
 }
 
@@ -1046,6 +1046,110 @@ enum class EnumerableOwnPropertiesKind {
 };
 } // namespace
 
+/// \return true if the own properties of \p obj are exactly the ones described
+/// by its hidden class, so that they are the same for every object of the
+/// class. This is the same condition as for caching for-in names.
+static bool ownPropertiesFollowClass(Runtime *runtime, JSObject *obj) {
+  return obj->shouldCacheForIn(runtime) && !obj->isLazy();
+}
+
+/// \return the enumerable own property names of \p objHandle as strings, as
+/// a new array. When they only depend on the class of \p objHandle, the
+/// storage of the array is cached on the class and shared with the arrays
+/// returned for later objects of the class, until they are modified.
+static CallResult<HermesValue> getEnumerableOwnKeys(
+    Handle<JSObject> objHandle,
+    Runtime *runtime) {
+  if (ownPropertiesFollowClass(runtime, *objHandle)) {
+    if (BigStorage *keys =
+            objHandle->getClass(runtime)->getKeysCache(runtime)) {
+      auto arrRes = JSArray::createWithSharedStorage(
+          runtime, runtime->makeHandle(keys), false /* allNumbers */);
+      if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      return arrRes->getHermesValue();
+    }
+  }
+
+  auto namesRes =
+      getOwnPropertyNamesAsStrings(objHandle, runtime, true /*onlyEnumerable*/);
+  if (LLVM_UNLIKELY(namesRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  // Check again, since getting the names initializes a lazy object.
+  if (ownPropertiesFollowClass(runtime, *objHandle)) {
+    auto *names = vmcast<JSArray>(*namesRes);
+    uint32_t len = JSArray::getLength(names);
+    if (len != 0 && names->getBeginIndex() == 0 &&
+        names->getEndIndex() == len &&
+        names->getElementsKind() != JSArray::ElementsKind::Holey) {
+      BigStorage *keys = JSArray::unsafeShareStorage(names, runtime);
+      if (keys->size() == len)
+        objHandle->getClass(runtime)->setKeysCache(keys, runtime);
+    }
+  }
+  return *namesRes;
+}
+
+/// The case of EnumerableOwnProperties for values and entries of an object
+/// whose properties follow its class and are all ordinary data properties
+/// with names that aren't array indexes. No user code can run while reading
+/// them, and their order is the order of the class, so the values are read
+/// directly from their slots.
+static CallResult<HermesValue> enumerableOwnValuesFromSlots(
+    Handle<JSObject> objHandle,
+    Runtime *runtime,
+    EnumerableOwnPropertiesKind kind) {
+  auto clazz = runtime->makeHandle(objHandle->getClass(runtime));
+  uint32_t capacity = clazz->getNumProperties();
+  auto propertiesRes = JSArray::create(runtime, capacity, 0);
+  if (LLVM_UNLIKELY(propertiesRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto properties = toHandle(runtime, std::move(*propertiesRes));
+
+  MutableHandle<> value{runtime};
+  MutableHandle<> entry{runtime};
+  uint32_t targetIdx = 0;
+  bool completed = HiddenClass::forEachPropertyWhile(
+      clazz,
+      runtime,
+      [&objHandle, &properties, &value, &entry, &targetIdx, kind](
+          Runtime *runtime, SymbolID id, NamedPropertyDescriptor desc) {
+        if (!isPropertyNamePrimitive(id))
+          return true;
+        value = JSObject::getNamedSlotValue(*objHandle, runtime, desc);
+        if (kind == EnumerableOwnPropertiesKind::KeyValue) {
+          auto entryRes = JSArray::create(runtime, 2, 2);
+          if (LLVM_UNLIKELY(entryRes == ExecutionStatus::EXCEPTION)) {
+            return false;
+          }
+          entry = entryRes->getHermesValue();
+          JSArray::setElementAt(
+              Handle<JSArray>::vmcast(entry),
+              runtime,
+              0,
+              runtime->makeHandle(runtime->getStringPrimFromSymbolID(id)));
+          JSArray::setElementAt(
+              Handle<JSArray>::vmcast(entry), runtime, 1, value);
+        } else {
+          entry = value.get();
+        }
+        JSArray::setElementAt(properties, runtime, targetIdx++, entry);
+        return true;
+      });
+  if (LLVM_UNLIKELY(!completed)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  if (LLVM_UNLIKELY(
+          JSArray::setLengthProperty(properties, runtime, targetIdx) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return properties.getHermesValue();
+}
+
 /// ES8.0 7.3.21.
 /// EnumerableOwnProperties gets the requested properties based on \p kind.
 static CallResult<HermesValue> enumerableOwnProperties(
@@ -1060,14 +1164,21 @@ static CallResult<HermesValue> enumerableOwnProperties(
   }
   auto objHandle = runtime->makeHandle<JSObject>(objRes.getValue());
 
-  auto namesRes =
-      getOwnPropertyNamesAsStrings(objHandle, runtime, true /*onlyEnumerable*/);
+  if (kind == EnumerableOwnPropertiesKind::Key) {
+    return getEnumerableOwnKeys(objHandle, runtime);
+  }
+  if (ownPropertiesFollowClass(runtime, *objHandle)) {
+    const HiddenClass *clazz = objHandle->getClass(runtime);
+    if (clazz->hasOnlyDefaultProperties() &&
+        !clazz->getHasIndexLikeProperties()) {
+      return enumerableOwnValuesFromSlots(objHandle, runtime, kind);
+    }
+  }
+
+  auto namesRes = getEnumerableOwnKeys(objHandle, runtime);
   if (namesRes == ExecutionStatus::EXCEPTION) {
     return ExecutionStatus::EXCEPTION;
   }
-  if (kind == EnumerableOwnPropertiesKind::Key) {
-    return *namesRes;
-  }
   auto names = runtime->makeHandle<JSArray>(*namesRes);
   uint32_t len = JSArray::getLength(*names);
 
@@ -1162,6 +1273,42 @@ objectEntries(void *, Runtime *runtime, NativeArgs args) {
       runtime, args, EnumerableOwnPropertiesKind::KeyValue);
 }
 
+/// \return true if \p to is an object without properties and storing the
+/// properties of \p from into it would create them as own data properties,
+/// i.e. no object on its prototype chain has an accessor or read-only
+/// property of the same name, so the properties can be cloned instead.
+static bool storesCreateOwnProperties(
+    Runtime *runtime,
+    Handle<JSObject> to,
+    Handle<JSObject> from) {
+  if (to->getClass(runtime)->getNumProperties() != 0 ||
+      from->getClass(runtime)->isDictionary())
+    return false;
+  for (JSObject *proto = to->getParent(runtime); proto;
+       proto = proto->getParent(runtime)) {
+    if (proto->getKind() != CellKind::ObjectKind || proto->isHostObject() ||
+        proto->isLazy())
+      return false;
+  }
+  MutableHandle<JSObject> protoHandle{runtime};
+  return HiddenClass::forEachPropertyWhile(
+      runtime->makeHandle(from->getClass(runtime)),
+      runtime,
+      [&to, &protoHandle](
+          Runtime *runtime, SymbolID sym, NamedPropertyDescriptor) {
+        for (protoHandle = to->getParent(runtime); protoHandle;
+             protoHandle = protoHandle->getParent(runtime)) {
+          NamedPropertyDescriptor desc;
+          if (JSObject::getOwnNamedDescriptor(
+                  protoHandle, runtime, sym, desc) &&
+              (desc.flags.accessor || !desc.flags.writable ||
+               desc.flags.internalSetter))
+            return false;
+        }
+        return true;
+      });
+}
+
 static CallResult<HermesValue>
 objectAssign(void *, Runtime *runtime, NativeArgs args) {
   vm::GCScope gcScope(runtime);
@@ -1206,6 +1353,13 @@ objectAssign(void *, Runtime *runtime, NativeArgs args) {
     }
     fromHandle = vmcast<JSObject>(objRes.getValue());
 
+    // A new target can share the class of a source with only plain data
+    // properties, which has the same effect as setting them one at a time.
+    if (storesCreateOwnProperties(runtime, toHandle, fromHandle) &&
+        JSObject::tryCloneOwnProperties(toHandle, runtime, fromHandle)) {
+      continue;
+    }
+
     // 5.b.ii. Let keys be from.[[OwnPropertyKeys]]().
     auto cr = JSObject::getOwnPropertyNames(fromHandle, runtime, true);
     if (LLVM_UNLIKELY(cr == ExecutionStatus::EXCEPTION)) {
@@ -664,6 +664,64 @@ regExpExec(Runtime *runtime, Handle<JSObject> R, Handle<StringPrimitive> S) {
   return regExpBuiltinExec(runtime, regExpObj, S);
 }
 
+/// \return \p R as a JSRegExp if it is a global RegExp whose "exec" property
+/// resolves to the builtin RegExp.prototype.exec through plain data
+/// properties, or null otherwise. For such a RegExp the match arrays created
+/// by RegExpExec are not observable by the global loops of @@match and
+/// @@replace, which can run the matching natively instead.
+static Handle<JSRegExp> getBuiltinExecGlobalRegExp(
+    Runtime *runtime,
+    Handle<JSObject> R) {
+  auto regexp = Handle<JSRegExp>::dyn_vmcast(runtime, R);
+  if (!regexp || !JSRegExp::getFlagBits(regexp.get()).global)
+    return runtime->makeNullHandle<JSRegExp>();
+  NamedPropertyDescriptor desc;
+  JSObject *owner = JSObject::getNamedDescriptor(
+      R, runtime, Predefined::getSymbolID(Predefined::exec), desc);
+  if (!owner || desc.flags.accessor || desc.flags.hostObject)
+    return runtime->makeNullHandle<JSRegExp>();
+  auto *exec = dyn_vmcast<NativeFunction>(
+      JSObject::getNamedSlotValue(owner, runtime, desc));
+  if (!exec || exec->getFunctionPtr() != regExpPrototypeExec)
+    return runtime->makeNullHandle<JSRegExp>();
+  return regexp;
+}
+
+/// Run the global matching loop of @@match and @@replace (ES6.0 21.2.5.6 step
+/// 8.g and 21.2.5.8 step 13) natively on a RegExp returned by
+/// getBuiltinExecGlobalRegExp(), after lastIndex has been set to 0. The ranges
+/// of every match are appended to \p ranges, \p stride entries per match: the
+/// full match followed by the capture groups.
+static ExecutionStatus collectGlobalMatches(
+    Runtime *runtime,
+    Handle<JSRegExp> regexp,
+    Handle<StringPrimitive> S,
+    llvm::SmallVectorImpl<OptValue<RegExpMatchRange>> &ranges,
+    size_t &stride) {
+  uint32_t lengthS = S->getStringLength();
+  uint32_t lastIndex = 0;
+  while (lastIndex <= lengthS) {
+    auto matchRes = JSRegExp::search(regexp, runtime, S, lastIndex);
+    if (LLVM_UNLIKELY(matchRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    if (matchRes->empty())
+      break;
+    stride = matchRes->size();
+    ranges.append(matchRes->begin(), matchRes->end());
+    // Continue from the end of the match, advancing past empty matches.
+    const RegExpMatchRange &totalMatch = *matchRes->front();
+    lastIndex = totalMatch.location + totalMatch.length;
+    if (totalMatch.length == 0) {
+      lastIndex = advanceStringIndex(
+          runtime, S, lastIndex, false /* fullUnicode */);
+    }
+  }
+  // The final RegExpExec failed to match and reset lastIndex to 0. Every
+  // intermediate value of lastIndex was overwritten before it could be read.
+  return setLastIndex(regexp, runtime, 0);
+}
+
 /// Implementation of RegExp.prototype.exec
 /// Returns an Array if a match is found, null if no match is found
 static CallResult<HermesValue>
@@ -974,6 +1032,43 @@ regExpLastParenGetter(void *ctx, Runtime *runtime, NativeArgs args) {
       runtime->getPredefinedString(Predefined::emptyString));
 }
 
+/// The global case of RegExp.prototype[@@match] for a RegExp returned by
+/// getBuiltinExecGlobalRegExp(), after lastIndex has been set to 0. Only the
+/// matched substrings are created and stored into the empty array \p A.
+static CallResult<HermesValue> regExpMatchGlobalFast(
+    Runtime *runtime,
+    Handle<JSRegExp> regexp,
+    Handle<StringPrimitive> S,
+    Handle<JSArray> A) {
+  llvm::SmallVector<OptValue<RegExpMatchRange>, 16> ranges;
+  size_t stride = 0;
+  if (LLVM_UNLIKELY(
+          collectGlobalMatches(runtime, regexp, S, ranges, stride) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  if (ranges.empty())
+    return HermesValue::encodeNullValue();
+
+  uint32_t n = 0;
+  GCScopeMarkerRAII marker{runtime};
+  for (size_t i = 0, e = ranges.size(); i < e; i += stride, ++n) {
+    marker.flush();
+    auto strRes = StringPrimitive::slice(
+        runtime, S, ranges[i]->location, ranges[i]->length);
+    if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    JSArray::setElementAt(
+        A, runtime, n, runtime->makeHandle<StringPrimitive>(*strRes));
+  }
+  if (LLVM_UNLIKELY(
+          JSArray::setLengthProperty(A, runtime, n) ==
+          ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  return A.getHermesValue();
+}
+
 // TODO: consider writing this in JS.
 /// ES6.0 21.2.5.6
 static CallResult<HermesValue>
@@ -1024,6 +1119,9 @@ regExpPrototypeSymbolMatch(void *, Runtime *runtime, NativeArgs args) {
     return ExecutionStatus::EXCEPTION;
   }
   auto A = toHandle(runtime, std::move(*arrRes));
+  if (auto regexp = getBuiltinExecGlobalRegExp(runtime, rx)) {
+    return regExpMatchGlobalFast(runtime, regexp, S, A);
+  }
   // e. Let n be 0.
   uint32_t n = 0;
 
@@ -1163,45 +1261,31 @@ regExpPrototypeSymbolSearch(void *, Runtime *runtime, NativeArgs args) {
       resultObj, runtime, Predefined::getSymbolID(Predefined::index));
 }
 
-/// ES6.0 21.1.3.14.1
-/// Transforms a replacement string by substituting $ replacement strings.
-/// \p captures can be a null pointer.
-CallResult<HermesValue> getSubstitution(
-    Runtime *runtime,
-    Handle<StringPrimitive> matched,
-    Handle<StringPrimitive> str,
+/// Append to \p result the replacement text \p replacementView with its $
+/// patterns substituted, as in steps 9-11 of ES6.0 21.1.3.14.1, for the match
+/// \p matchedView found at \p position in \p stringView.
+/// \p m is the number of captures, and \p getCapture(idx) returns a view of
+/// the capture with zero-based index idx, or an empty view if that capture is
+/// undefined.
+template <typename GetCapture>
+static void appendSubstitution(
+    SmallU16String<32> &result,
+    const StringView &matchedView,
+    const StringView &stringView,
     uint32_t position,
-    Handle<ArrayStorage> captures,
-    Handle<StringPrimitive> replacement) {
-  // 1. Assert: Type(matched) is String.
-  // 2. Let matchLength be the number of code units in matched.
-  uint32_t matchLength = matched->getStringLength();
-  // 3. Assert: Type(str) is String.
-  // 4. Let stringLength be the number of code units in str.
-  uint32_t stringLength = str->getStringLength();
-  // 5. Assert: position is a nonnegative integer.
-  // 6. Assert: position ≤ stringLength.
-  assert(
-      position <= stringLength &&
-      "The matched position should be within the string length.");
-  // 7. Assert: captures is a possibly empty List of Strings.
-  // 8. Assert: Type(replacement) is String
+    size_t m,
+    const GetCapture &getCapture,
+    const StringView &replacementView) {
+  uint32_t matchLength = matchedView.length();
+  uint32_t stringLength = stringView.length();
   // 9. Let tailPos be position + matchLength.
   uint32_t tailPos = position + matchLength;
-  // 10. Let m be the number of elements in captures.
-  size_t m = captures ? captures->size() : 0;
 
   // 11. Let result be a String value derived from replacement by copying code
   // unit elements from replacement to result while performing replacements as
   // specified in Table 45. These $ replacements are done left-to- right, and,
   // once such a replacement is performed, the new replacement text is not
   // subject to further replacements.
-  auto replacementView =
-      StringPrimitive::createStringView(runtime, replacement);
-  auto stringView = StringPrimitive::createStringView(runtime, str);
-  auto matchedStrView = StringPrimitive::createStringView(runtime, matched);
-  SmallU16String<32> result{};
-
   // Don't use a StringView iterator, as any calls to createStringView can
   // allocate and move the underlying char storage.
   for (size_t i = 0, e = replacementView.length(); i < e;) {
@@ -1221,7 +1305,7 @@ CallResult<HermesValue> getSubstitution(
       i += 2;
     } else if (c1 == u'&') {
       // The matched substring.
-      matchedStrView.copyUTF16String(result);
+      matchedView.copyUTF16String(result);
       i += 2;
     } else if (c1 == u'`') {
       // Portion of string before the matched substring.
@@ -1238,22 +1322,6 @@ CallResult<HermesValue> getSubstitution(
       // '0' <= c1 <= '9' because $nn case can have 01 to 99.
       // If it ends up being the $n case instead of $nn,
       // then we can check to make sure 1 <= n <= 9.
-
-      // Define a helper to access a submatch substring, or the empty
-      // string if the submatch is undefined.
-      auto submatchOrEmpty = [&](size_t idx) -> StringView {
-        assert(
-            captures && idx < captures->size() &&
-            "Index into captures is out of bound.");
-        if (captures->at(idx).isUndefined()) {
-          // return empty string.
-          return stringView.slice(str->getStringLength());
-        }
-        return StringPrimitive::createStringView(
-            runtime,
-            Handle<StringPrimitive>::vmcast(runtime, captures->at(idx)));
-      };
-
       uint32_t n = c1 - u'0';
       if (i + 2 < e) {
         // Try for the $nn case if there's more characters available.
@@ -1262,13 +1330,11 @@ CallResult<HermesValue> getSubstitution(
         uint32_t nn = (c1 - u'0') * 10 + (c2 - u'0');
         if ((u'0' <= c2 && c2 <= u'9') && (1 <= nn && nn <= m)) {
           // Valid $nn case.
-          auto view = submatchOrEmpty(nn - 1);
-          result.insert(result.end(), view.begin(), view.end());
+          getCapture(nn - 1).copyUTF16String(result);
           i += 3;
         } else if (1 <= n && n <= m) {
           // Try for the $n case first.
-          auto view = submatchOrEmpty(n - 1);
-          result.insert(result.end(), view.begin(), view.end());
+          getCapture(n - 1).copyUTF16String(result);
           i += 2;
         } else {
           // No valid $n or $nn case, just append the characters and
@@ -1277,8 +1343,7 @@ CallResult<HermesValue> getSubstitution(
           i += 2;
         }
       } else if (1 <= n && n <= m) {
-        auto view = submatchOrEmpty(n - 1);
-        result.insert(result.end(), view.begin(), view.end());
+        getCapture(n - 1).copyUTF16String(result);
         i += 2;
       } else {
         // Not a valid $n.
@@ -1291,10 +1356,161 @@ CallResult<HermesValue> getSubstitution(
       i += 2;
     }
   }
+}
+
+/// ES6.0 21.1.3.14.1
+/// Transforms a replacement string by substituting $ replacement strings.
+/// \p captures can be a null pointer.
+CallResult<HermesValue> getSubstitution(
+    Runtime *runtime,
+    Handle<StringPrimitive> matched,
+    Handle<StringPrimitive> str,
+    uint32_t position,
+    Handle<ArrayStorage> captures,
+    Handle<StringPrimitive> replacement) {
+  // 1. Assert: Type(matched) is String.
+  // 2. Let matchLength be the number of code units in matched.
+  // 3. Assert: Type(str) is String.
+  // 4. Let stringLength be the number of code units in str.
+  // 5. Assert: position is a nonnegative integer.
+  // 6. Assert: position ≤ stringLength.
+  assert(
+      position <= str->getStringLength() &&
+      "The matched position should be within the string length.");
+  // 7. Assert: captures is a possibly empty List of Strings.
+  // 8. Assert: Type(replacement) is String
+  // 10. Let m be the number of elements in captures.
+  size_t m = captures ? captures->size() : 0;
+
+  auto replacementView =
+      StringPrimitive::createStringView(runtime, replacement);
+  auto stringView = StringPrimitive::createStringView(runtime, str);
+  auto matchedStrView = StringPrimitive::createStringView(runtime, matched);
+  SmallU16String<32> result{};
+
+  // Define a helper to access a submatch substring, or the empty
+  // string if the submatch is undefined.
+  auto submatchOrEmpty = [&](size_t idx) -> StringView {
+    assert(
+        captures && idx < captures->size() &&
+        "Index into captures is out of bound.");
+    if (captures->at(idx).isUndefined()) {
+      // return empty string.
+      return stringView.slice(str->getStringLength());
+    }
+    return StringPrimitive::createStringView(
+        runtime, Handle<StringPrimitive>::vmcast(runtime, captures->at(idx)));
+  };
+  appendSubstitution(
+      result,
+      matchedStrView,
+      stringView,
+      position,
+      m,
+      submatchOrEmpty,
+      replacementView);
   // 12. Return result.
   return StringPrimitive::create(runtime, result);
 }
 
+/// The global case of RegExp.prototype[@@replace] for a RegExp returned by
+/// getBuiltinExecGlobalRegExp(), after lastIndex has been set to 0. No match
+/// arrays are created: a string \p replaceValueStr is substituted entirely in
+/// native code, and \p replaceFn, if not null, is called with the matched
+/// substrings sliced directly from \p S.
+static CallResult<HermesValue> regExpReplaceGlobalFast(
+    Runtime *runtime,
+    Handle<JSRegExp> regexp,
+    Handle<StringPrimitive> S,
+    Handle<Callable> replaceFn,
+    Handle<StringPrimitive> replaceValueStr) {
+  llvm::SmallVector<OptValue<RegExpMatchRange>, 16> ranges;
+  size_t stride = 0;
+  if (LLVM_UNLIKELY(
+          collectGlobalMatches(runtime, regexp, S, ranges, stride) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  if (ranges.empty())
+    return S.getHermesValue();
+
+  SmallU16String<32> accumulatedResult{};
+  uint32_t nextSourcePosition = 0;
+  auto stringView = StringPrimitive::createStringView(runtime, S);
+  llvm::Optional<StringView> replaceView;
+  if (!replaceFn)
+    replaceView = StringPrimitive::createStringView(runtime, replaceValueStr);
+  for (size_t i = 0, e = ranges.size(); i < e; i += stride) {
+    GCScopeMarkerRAII marker{runtime};
+    llvm::ArrayRef<OptValue<RegExpMatchRange>> match{&ranges[i], stride};
+    uint32_t position = match[0]->location;
+    uint32_t matchLength = match[0]->length;
+    // Matches of the builtin exec never overlap or move backwards.
+    assert(position >= nextSourcePosition && "matches out of order");
+    stringView.slice(nextSourcePosition, position - nextSourcePosition)
+        .copyUTF16String(accumulatedResult);
+    if (replaceFn) {
+      CallResult<HermesValue> callRes{ExecutionStatus::EXCEPTION};
+      {
+        // Arguments: matched, captures, position, S.
+        uint32_t argCount = stride + 2;
+        ScopedNativeCallFrame newFrame{runtime,
+                                       argCount,
+                                       *replaceFn,
+                                       false,
+                                       HermesValue::encodeUndefinedValue()};
+        if (LLVM_UNLIKELY(newFrame.overflowed()))
+          return runtime->raiseStackOverflow(
+              Runtime::StackOverflowKind::NativeStack);
+        // Slicing the substrings may collect, so initialize the arguments
+        // first. Captures that did not participate remain undefined.
+        newFrame.fillArguments(argCount, HermesValue::encodeUndefinedValue());
+        for (uint32_t n = 0; n < stride; ++n) {
+          if (!match[n])
+            continue;
+          auto strRes = StringPrimitive::slice(
+              runtime, S, match[n]->location, match[n]->length);
+          if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
+            return ExecutionStatus::EXCEPTION;
+          }
+          newFrame->getArgRef(n) = *strRes;
+        }
+        newFrame->getArgRef(stride) = HermesValue::encodeNumberValue(position);
+        newFrame->getArgRef(stride + 1) = S.getHermesValue();
+        callRes = Callable::call(replaceFn, runtime);
+        if (LLVM_UNLIKELY(callRes == ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+      }
+      auto strRes =
+          toString_RJS(runtime, runtime->makeHandle(callRes.getValue()));
+      if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      strRes->get()->copyUTF16String(accumulatedResult);
+    } else {
+      auto getCapture = [&](size_t idx) -> StringView {
+        const auto &capture = match[idx + 1];
+        if (!capture)
+          return stringView.slice(stringView.length());
+        return stringView.slice(capture->location, capture->length);
+      };
+      appendSubstitution(
+          accumulatedResult,
+          stringView.slice(position, matchLength),
+          stringView,
+          position,
+          stride - 1,
+          getCapture,
+          *replaceView);
+    }
+    nextSourcePosition = position + matchLength;
+  }
+  if (nextSourcePosition < stringView.length())
+    stringView.slice(nextSourcePosition).copyUTF16String(accumulatedResult);
+  return StringPrimitive::createEfficient(runtime, accumulatedResult);
+}
+
 /// ES6.0 21.2.5.8
 static CallResult<HermesValue>
 regExpPrototypeSymbolReplace(void *, Runtime *runtime, NativeArgs args) {
@@ -1350,6 +1566,10 @@ regExpPrototypeSymbolReplace(void *, Runtime *runtime, NativeArgs args) {
     if (LLVM_UNLIKELY(setStatus == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
+    if (auto regexp = getBuiltinExecGlobalRegExp(runtime, rx)) {
+      return regExpReplaceGlobalFast(
+          runtime, regexp, S, replaceFn, replaceValueStr);
+    }
   }
   // 11. Let results be a new empty List.
   auto arrRes = ArrayStorage::create(runtime, 16 /* capacity */);
@@ -6,10 +6,12 @@
  */
 #include "hermes/VM/JSLib/RuntimeJSONUtils.h"
 
+#include "hermes/Support/Conversions.h"
 #include "hermes/Support/JSON.h"
 #include "hermes/VM/ArrayStorage.h"
 #include "hermes/VM/Callable.h"
 #include "hermes/VM/JSArray.h"
+#include "hermes/VM/Operations.h"
 #include "hermes/VM/PrimitiveBox.h"
 
 #include "JSONLexer.h"
@@ -57,6 +59,15 @@ class RuntimeJSONParser {
         reviver_(reviver),
         tmpHandle_(runtime) {}
 
+  explicit RuntimeJSONParser(
+      Runtime *runtime,
+      llvm::ArrayRef<uint8_t> utf8,
+      Handle<Callable> reviver)
+      : runtime_(runtime),
+        lexer_(runtime, utf8),
+        reviver_(reviver),
+        tmpHandle_(runtime) {}
+
   /// Parse JSON string through lexer_, create objects using runtime_.
   /// If errors occur, this function will return undefined, and the error
   /// should be kept inside SourceErrorManager.
@@ -145,6 +156,36 @@ class JSONStringifyer {
   /// The output buffer. The serialization process will append into it.
   llvm::SmallVector<char16_t, 32> output_{};
 
+  /// Number of hidden classes whose keys can be cached at the same time.
+  static constexpr uint32_t kKeyCacheSize = 8;
+
+  /// The own enumerable keys of the objects of a hidden class, in the order
+  /// operationJO() visits them. All the objects of the class have the same
+  /// keys, so they are listed and quoted once per class, and the values are
+  /// read directly from the slots while the holder still has the class.
+  struct KeyCacheEntry {
+    /// The keys and their descriptors in the class.
+    llvm::SmallVector<std::pair<SymbolID, NamedPropertyDescriptor>, 8> props;
+
+    /// The quoted keys, each followed by ':', one after the other.
+    llvm::SmallVector<char16_t, 64> quoted;
+
+    /// The offset of each key in quoted, and the size of quoted.
+    llvm::SmallVector<uint32_t, 8> offsets;
+
+    /// Number of operationJO() calls iterating the keys. An entry can only be
+    /// reused for another class when it isn't in use.
+    uint32_t useCount{0};
+  };
+
+  /// The classes of the entries of keyCache_, or empty for unused entries.
+  MutableHandle<PropStorage> keyCacheClasses_;
+
+  KeyCacheEntry keyCache_[kKeyCacheSize];
+
+  /// The entry to consider first when a new class is cached.
+  uint32_t nextKeyCacheEntry_{0};
+
  public:
   explicit JSONStringifyer(Runtime *runtime)
       : runtime_(runtime),
@@ -157,7 +198,8 @@ class JSONStringifyer {
         tmpHandle2_(runtime),
         operationStrValue_(runtime),
         operationJOK_(runtime),
-        operationStrHolder_(runtime) {}
+        operationStrHolder_(runtime),
+        keyCacheClasses_(runtime) {}
 
   LLVM_NODISCARD ExecutionStatus init(Handle<> replacer, Handle<> space) {
     auto arrRes = PropStorage::create(runtime_, 4);
@@ -171,6 +213,17 @@ class JSONStringifyer {
       return ExecutionStatus::EXCEPTION;
     }
     stackJO_ = vmcast<PropStorage>(*arrRes);
+    if (LLVM_UNLIKELY(
+            (arrRes = PropStorage::create(runtime_, kKeyCacheSize)) ==
+            ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    keyCacheClasses_ = vmcast<PropStorage>(*arrRes);
+    if (LLVM_UNLIKELY(
+            PropStorage::resize(keyCacheClasses_, runtime_, kKeyCacheSize) ==
+            ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
     auto cr = initializeReplacer(replacer);
     if (LLVM_UNLIKELY(cr == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
@@ -200,6 +253,10 @@ class JSONStringifyer {
   /// \return whether the result is not undefined.
   CallResult<bool> operationStr(HermesValue key);
 
+  /// The rest of operationStr(), after holder[key] was read into
+  /// operationStrValue_. The key is in tmpHandle_.
+  CallResult<bool> operationStrWithValue();
+
   /// Implement the abstract operation Quote(value).
   /// It wraps a String value in double quotes and escapes characters within it.
   void operationQuote(StringView value);
@@ -214,6 +271,15 @@ class JSONStringifyer {
   /// It serializes an object.
   ExecutionStatus operationJO();
 
+  /// Implement JO(value) for an object whose keys are in the entry
+  /// \p entryIndex of the key cache, which is in use for the duration of the
+  /// call.
+  ExecutionStatus operationJOCached(uint32_t entryIndex);
+
+  /// \return the index of the entry of the key cache for the keys of \p obj,
+  /// after adding it if needed, or None if the keys of \p obj can't be cached.
+  OptValue<uint32_t> findKeyCacheEntry(JSObject *obj);
+
   /// Append '\n' and indent to output_.
   /// The indent is constructed according to indentGapCount_.
   void indent();
@@ -330,7 +396,6 @@ CallResult<HermesValue> RuntimeJSONParser::parseArray() {
     return ExecutionStatus::EXCEPTION;
   }
   if (lexer_.getCurToken()->getKind() != JSONTokenKind::RSquare) {
-    MutableHandle<> indexValue{runtime_};
     GCScope gcScope{runtime_};
     auto marker = gcScope.createMarker();
 
@@ -342,13 +407,10 @@ CallResult<HermesValue> RuntimeJSONParser::parseArray() {
         return ExecutionStatus::EXCEPTION;
       }
 
-      indexValue = HermesValue::encodeDoubleValue(index);
-      (void)JSObject::defineOwnComputedPrimitive(
-          array,
-          runtime_,
-          indexValue,
-          DefinePropertyFlags::getDefaultNewPropertyFlags(),
-          runtime_->makeHandle(*parRes));
+      // The array is new, so store the element directly and set the length
+      // once at the end.
+      JSArray::setElementAt(
+          array, runtime_, index, runtime_->makeHandle(*parRes));
 
       if (lexer_.getCurToken()->getKind() == JSONTokenKind::Comma) {
         if (LLVM_UNLIKELY(lexer_.advance() == ExecutionStatus::EXCEPTION)) {
@@ -356,6 +418,11 @@ CallResult<HermesValue> RuntimeJSONParser::parseArray() {
         }
         continue;
       } else if (lexer_.getCurToken()->getKind() == JSONTokenKind::RSquare) {
+        if (LLVM_UNLIKELY(
+                JSArray::setLengthProperty(array, runtime_, index + 1) ==
+                ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
         break;
       } else {
         return lexer_.error("Expect ']'");
@@ -375,11 +442,13 @@ CallResult<HermesValue> RuntimeJSONParser::parseObject() {
       "Wrong entrance to parseObject");
   auto object = toHandle(runtime_, JSObject::create(runtime_));
 
-  if (LLVM_UNLIKELY(lexer_.advance() == ExecutionStatus::EXCEPTION)) {
+  // Keys are scanned directly as identifiers.
+  if (LLVM_UNLIKELY(
+          lexer_.advanceStrAsSymbol() == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
   if (lexer_.getCurToken()->getKind() != JSONTokenKind::RBrace) {
-    MutableHandle<StringPrimitive> key{runtime_};
+    MutableHandle<SymbolID> key{runtime_};
     GCScope gcScope{runtime_};
     auto marker = gcScope.createMarker();
     for (;;) {
@@ -389,7 +458,7 @@ CallResult<HermesValue> RuntimeJSONParser::parseObject() {
               lexer_.getCurToken()->getKind() != JSONTokenKind::String)) {
         return lexer_.error("Expect a string key in JSON object");
       }
-      key = lexer_.getCurToken()->getString().get();
+      key = lexer_.getCurToken()->getSymbol().get();
 
       if (LLVM_UNLIKELY(lexer_.advance() == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
@@ -408,15 +477,19 @@ CallResult<HermesValue> RuntimeJSONParser::parseObject() {
         return ExecutionStatus::EXCEPTION;
       }
 
-      (void)JSObject::defineOwnComputedPrimitive(
+      // Objects with the same keys in the same order follow the same
+      // transitions of the hidden class, which also show that the property is
+      // new without looking it up. Duplicate keys overwrite the value.
+      (void)JSObject::defineOwnProperty(
           object,
           runtime_,
-          key,
+          key.get(),
           DefinePropertyFlags::getDefaultNewPropertyFlags(),
           runtime_->makeHandle(*parRes));
 
       if (lexer_.getCurToken()->getKind() == JSONTokenKind::Comma) {
-        if (LLVM_UNLIKELY(lexer_.advance() == ExecutionStatus::EXCEPTION)) {
+        if (LLVM_UNLIKELY(
+                lexer_.advanceStrAsSymbol() == ExecutionStatus::EXCEPTION)) {
           return ExecutionStatus::EXCEPTION;
         }
         continue;
@@ -541,6 +614,14 @@ CallResult<HermesValue> runtimeJSONParse(
   return parser.parse();
 }
 
+CallResult<HermesValue> runtimeJSONParseUTF8(
+    Runtime *runtime,
+    llvm::ArrayRef<uint8_t> utf8,
+    Handle<Callable> reviver) {
+  RuntimeJSONParser parser{runtime, utf8, reviver};
+  return parser.parse();
+}
+
 ExecutionStatus JSONStringifyer::initializeReplacer(Handle<> replacer) {
   if (!vmisa<JSObject>(*replacer))
     return ExecutionStatus::RETURNED;
@@ -679,17 +760,19 @@ CallResult<bool> JSONStringifyer::operationStr(HermesValue key) {
     return ExecutionStatus::EXCEPTION;
   }
   operationStrValue_.set(*propRes);
+  return operationStrWithValue();
+}
+
+CallResult<bool> JSONStringifyer::operationStrWithValue() {
+  GCScopeMarkerRAII marker{runtime_};
 
   if (auto valueObj =
           Handle<JSObject>::dyn_vmcast(runtime_, operationStrValue_)) {
     // Str.2.
     // Str.2.a: check if toJSON exists in value.
-    if (LLVM_UNLIKELY(
-            (propRes = JSObject::getNamed_RJS(
-                 valueObj,
-                 runtime_,
-                 Predefined::getSymbolID(Predefined::toJSON))) ==
-            ExecutionStatus::EXCEPTION)) {
+    auto propRes = JSObject::getNamed_RJS(
+        valueObj, runtime_, Predefined::getSymbolID(Predefined::toJSON));
+    if (LLVM_UNLIKELY(propRes == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
     // Str.2.b: check if toJSON is a Callable.
@@ -771,11 +854,11 @@ CallResult<bool> JSONStringifyer::operationStr(HermesValue key) {
   // Str.9.
   if (operationStrValue_->isNumber()) {
     if (std::isfinite(operationStrValue_->getNumber())) {
-      auto status = toString_RJS(runtime_, operationStrValue_);
-      assert(
-          status != ExecutionStatus::EXCEPTION &&
-          "toString on a number cannot fail");
-      appendToOutput(status->get());
+      // Format the number directly into the output.
+      char buf[NUMBER_TO_STRING_BUF_SIZE];
+      size_t len = numberToString(
+          operationStrValue_->getNumber(), buf, NUMBER_TO_STRING_BUF_SIZE);
+      output_.append(buf, buf + len);
     } else {
       appendToOutput(Predefined::getSymbolID(Predefined::null));
     }
@@ -875,6 +958,15 @@ static ExecutionStatus propStoragePushBack(
 }
 
 ExecutionStatus JSONStringifyer::operationJO() {
+  // Without a PropertyList, the keys of objects of the same class only need to
+  // be listed and quoted once.
+  if (!propertyList_) {
+    if (auto entry = findKeyCacheEntry(
+            vmcast<JSObject>(stackValue_->at(stackValue_->size() - 1)))) {
+      return operationJOCached(*entry);
+    }
+  }
+
   GCScopeMarkerRAII marker{runtime_};
 
   // JO.3.
@@ -985,6 +1077,143 @@ ExecutionStatus JSONStringifyer::operationJO() {
   return ExecutionStatus::RETURNED;
 }
 
+OptValue<uint32_t> JSONStringifyer::findKeyCacheEntry(JSObject *obj) {
+  // The keys of other objects don't only depend on their class.
+  if (!obj->shouldCacheForIn(runtime_) || obj->isLazy())
+    return llvm::None;
+  HiddenClass *clazz = obj->getClass(runtime_);
+  // Index-like keys are listed in numeric order.
+  if (clazz->getHasIndexLikeProperties())
+    return llvm::None;
+
+  for (uint32_t i = 0; i < kKeyCacheSize; ++i) {
+    HermesValue cached = keyCacheClasses_->at(i);
+    if (cached.isObject() && cached.getObject() == clazz)
+      return i;
+  }
+
+  // Replace the next entry which isn't in use.
+  for (uint32_t n = 0; n < kKeyCacheSize; ++n) {
+    uint32_t i = (nextKeyCacheEntry_ + n) % kKeyCacheSize;
+    KeyCacheEntry &entry = keyCache_[i];
+    if (entry.useCount)
+      continue;
+    nextKeyCacheEntry_ = (i + 1) % kKeyCacheSize;
+    keyCacheClasses_->at(i).set(
+        HermesValue::encodeObjectValue(clazz), &runtime_->getHeap());
+    entry.props.clear();
+    entry.quoted.clear();
+    entry.offsets.clear();
+    // Visit the properties in the order of getOwnPropertyNames().
+    HiddenClass::forEachProperty(
+        runtime_->makeHandle(clazz),
+        runtime_,
+        [this, &entry](SymbolID id, NamedPropertyDescriptor desc) {
+          if (!isPropertyNamePrimitive(id) || !desc.flags.enumerable)
+            return;
+          entry.props.push_back({id, desc});
+          entry.offsets.push_back(entry.quoted.size());
+          quoteStringForJSON(
+              entry.quoted,
+              runtime_->getIdentifierTable().getStringView(runtime_, id));
+          entry.quoted.push_back(u':');
+        });
+    entry.offsets.push_back(entry.quoted.size());
+    return i;
+  }
+  return llvm::None;
+}
+
+ExecutionStatus JSONStringifyer::operationJOCached(uint32_t entryIndex) {
+  GCScopeMarkerRAII marker{runtime_};
+  KeyCacheEntry &entry = keyCache_[entryIndex];
+  // Nested objects must not replace the entry while it is iterated.
+  ++entry.useCount;
+
+  // JO.3.
+  auto stepBack = indentGapCount_;
+  // JO.4.
+  indentGapCount_++;
+  output_.push_back(u'{');
+  auto beginningLoc = output_.size();
+  indent();
+
+  // JO.8.
+  bool hasElement = false;
+  ExecutionStatus status = ExecutionStatus::RETURNED;
+  for (uint32_t index = 0, len = entry.props.size(); index < len; ++index) {
+    // As in operationJO(), roll back to savedLocation if Str returns
+    // undefined.
+    auto savedLocation = output_.size();
+
+    if (hasElement) {
+      // JO.10.
+      output_.push_back(u',');
+      indent();
+    }
+
+    // JO.8.b.i, ii.
+    output_.append(
+        entry.quoted.begin() + entry.offsets[index],
+        entry.quoted.begin() + entry.offsets[index + 1]);
+    // JO.8.b.iii
+    if (gap_.get()) {
+      output_.push_back(u' ');
+    }
+
+    // JO.9.a.
+    operationStrHolder_ =
+        vmcast<JSObject>(stackValue_->at(stackValue_->size() - 1));
+    SymbolID key = entry.props[index].first;
+    NamedPropertyDescriptor desc = entry.props[index].second;
+    tmpHandle_ = HermesValue::encodeStringValue(
+        runtime_->getStringPrimFromSymbolID(key));
+
+    // Read the value directly from its slot, unless a getter or toJSON()
+    // changed the class of the holder since the keys were listed.
+    marker.flush();
+    if (operationStrHolder_->getClass(runtime_) ==
+            vmcast<HiddenClass>(keyCacheClasses_->at(entryIndex)) &&
+        !desc.flags.accessor) {
+      operationStrValue_ = JSObject::getNamedSlotValue(
+          operationStrHolder_.get(), runtime_, desc);
+    } else {
+      auto propRes = JSObject::getNamed_RJS(operationStrHolder_, runtime_, key);
+      if (LLVM_UNLIKELY(propRes == ExecutionStatus::EXCEPTION)) {
+        status = ExecutionStatus::EXCEPTION;
+        break;
+      }
+      operationStrValue_ = *propRes;
+    }
+
+    auto result = operationStrWithValue();
+    if (LLVM_UNLIKELY(result == ExecutionStatus::EXCEPTION)) {
+      status = ExecutionStatus::EXCEPTION;
+      break;
+    }
+    if (LLVM_UNLIKELY(!result.getValue())) {
+      // Str returns undefined, we need to roll back.
+      output_.resize(savedLocation);
+    } else {
+      hasElement = true;
+    }
+  }
+  --entry.useCount;
+  if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+
+  indentGapCount_ = stepBack;
+  if (hasElement) {
+    indent();
+  } else {
+    // If the object is empty, we need to roll back the first indent.
+    output_.resize(beginningLoc);
+  }
+  output_.push_back(u'}');
+  return ExecutionStatus::RETURNED;
+}
+
 void JSONStringifyer::indent() {
   if (gap_.get()) {
     output_.push_back(u'\n');
@@ -1050,7 +1279,9 @@ CallResult<HermesValue> JSONStringifyer::stringify(Handle<> value) {
     return ExecutionStatus::EXCEPTION;
   }
   if (status.getValue()) {
-    return StringPrimitive::create(runtime_, output_);
+    // The output is usually ASCII, which createEfficient() stores in half the
+    // space.
+    return StringPrimitive::createEfficient(runtime_, output_);
   } else {
     return HermesValue::encodeUndefinedValue();
   }
@@ -77,7 +77,9 @@ setIteratorPrototypeNext(void *, Runtime *runtime, NativeArgs args);
 
 /// @}
 
-Handle<JSObject> createSetConstructor(Runtime *runtime) {
+static void initializeSetConstructor(
+    Runtime *runtime,
+    Handle<NativeConstructor> cons) {
   auto setPrototype = Handle<JSSet>::vmcast(&runtime->setPrototype);
 
   // Set.prototype.xxx methods.
@@ -183,15 +185,21 @@ Handle<JSObject> createSetConstructor(Runtime *runtime) {
       runtime->getPredefinedStringHandle(Predefined::Set),
       dpf);
 
-  auto cons = defineSystemConstructor<JSSet>(
+  initializeSystemConstructor(
       runtime,
+      cons,
       Predefined::getSymbolID(Predefined::Set),
-      setConstructor,
       setPrototype,
-      0,
-      CellKind::SetKind);
+      0);
+}
 
-  return cons;
+Handle<JSObject> createSetConstructor(Runtime *runtime) {
+  return defineLazySystemConstructor<JSSet>(
+      runtime,
+      Predefined::getSymbolID(Predefined::Set),
+      setConstructor,
+      CellKind::SetKind,
+      initializeSetConstructor);
 }
 
 static CallResult<HermesValue>
@@ -278,7 +286,11 @@ setPrototypeAdd(void *, Runtime *runtime, NativeArgs args) {
         "Method Set.prototype.add called on incompatible receiver");
   }
   auto valueHandle = args.getArgHandle(runtime, 0);
-  JSSet::addValue(selfHandle, runtime, valueHandle, valueHandle);
+  if (LLVM_UNLIKELY(
+          JSSet::addValue(selfHandle, runtime, valueHandle, valueHandle) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
   return selfHandle.getHermesValue();
 }
 
@@ -293,7 +305,10 @@ setPrototypeClear(void *, Runtime *runtime, NativeArgs args) {
     return runtime->raiseTypeError(
         "Method Set.prototype.clear called on incompatible receiver");
   }
-  JSSet::clear(selfHandle, runtime);
+  if (LLVM_UNLIKELY(
+          JSSet::clear(selfHandle, runtime) == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
   return HermesValue::encodeUndefinedValue();
 }
 
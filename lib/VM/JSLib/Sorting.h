@@ -7,10 +7,18 @@
 #ifndef HERMES_VM_JSLIB_SORTING_H
 #define HERMES_VM_JSLIB_SORTING_H
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
 
 #include "hermes/VM/CallResult.h"
 
+#include "llvm/ADT/SmallVector.h"
+
 /// Defines custom sorting routines used in cases that we can't use std::sort.
 /// std::sort doesn't always use std::swap, performing operations that bypass
 /// the user-defined swap routines. When calling [[Put]] and [[Delete]], we
@@ -37,6 +45,561 @@ class SortModel {
 /// with ExecutionStatus::EXCEPTION if any compare or swap operations fail.
 ExecutionStatus quickSort(SortModel *sm, uint32_t begin, uint32_t end);
 
+/// Stable, adaptive merge sort ("TimSort") of an array of plain values, for
+/// callers that can copy the elements out of the object being sorted.
+/// The input is split into "runs" which are already in order (strictly
+/// descending runs are reversed), short runs are extended with a binary
+/// insertion sort, and runs are merged while keeping their lengths balanced.
+/// When one run keeps winning, a merge switches to "galloping": it looks for
+/// the end of the winning streak with exponential search instead of comparing
+/// one element at a time. Sorted or nearly sorted input therefore takes close
+/// to a linear number of comparisons.
+///
+/// \p Less is called as less(a, b) and returns CallResult<bool>. After it
+/// returns an exception no more comparisons are made and sort() returns the
+/// exception, leaving the elements in an unspecified order. The elements are
+/// always a permutation of the input, even if the comparisons are not
+/// consistent.
+template <typename T, typename Less>
+class TimSort {
+ public:
+  TimSort(T *data, uint32_t len, Less less)
+      : data_(data), len_(len), less_(less) {}
+
+  /// Sort the elements.
+  ExecutionStatus sort() {
+    if (len_ < 2)
+      return ExecutionStatus::RETURNED;
+    const uint32_t minRun = minRunLength(len_);
+    uint32_t lo = 0;
+    do {
+      uint32_t remaining = len_ - lo;
+      uint32_t runLen = countRunAndMakeAscending(lo);
+      if (runLen < minRun) {
+        uint32_t force = std::min(remaining, minRun);
+        binaryInsertionSort(lo, lo + force, lo + runLen);
+        runLen = force;
+      }
+      runs_.push_back({lo, runLen});
+      mergeCollapse();
+      lo += runLen;
+    } while (lo != len_ && !failed_);
+    mergeForceCollapse();
+    return failed_ ? ExecutionStatus::EXCEPTION : ExecutionStatus::RETURNED;
+  }
+
+ private:
+  /// Arrays shorter than this are sorted with binary insertion sort alone.
+  static constexpr uint32_t kMinMerge = 32;
+
+  /// Number of consecutive wins of a run after which a merge starts
+  /// galloping. The threshold actually used adapts to the data, see
+  /// minGallop_.
+  static constexpr uint32_t kMinGallop = 7;
+
+  /// A run of sorted elements, [base, base + len).
+  struct Run {
+    uint32_t base;
+    uint32_t len;
+  };
+
+  /// \return whether \p a is less than \p b, or false once a comparison has
+  /// failed.
+  bool lt(const T &a, const T &b) {
+    if (LLVM_UNLIKELY(failed_))
+      return false;
+    CallResult<bool> res = less_(a, b);
+    if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+      failed_ = true;
+      return false;
+    }
+    return *res;
+  }
+
+  /// \return the minimum length of a run for an array of \p n elements: a
+  /// number close to, but not over, kMinMerge such that n divided by it is
+  /// close to, but not over, a power of two. This keeps the merges balanced.
+  static uint32_t minRunLength(uint32_t n) {
+    uint32_t r = 0;
+    while (n >= kMinMerge) {
+      r |= n & 1;
+      n >>= 1;
+    }
+    return n + r;
+  }
+
+  /// \return the length of the run starting at \p lo, after reversing it if
+  /// it is strictly descending. Descending runs must be strict so that
+  /// reversing them keeps the sort stable.
+  uint32_t countRunAndMakeAscending(uint32_t lo) {
+    uint32_t runHi = lo + 1;
+    if (runHi == len_)
+      return 1;
+    if (lt(data_[runHi++], data_[lo])) {
+      while (runHi < len_ && lt(data_[runHi], data_[runHi - 1]))
+        ++runHi;
+      std::reverse(data_ + lo, data_ + runHi);
+    } else {
+      while (runHi < len_ && !lt(data_[runHi], data_[runHi - 1]))
+        ++runHi;
+    }
+    return runHi - lo;
+  }
+
+  /// Sort [lo, hi), whose prefix [lo, start) is already sorted, by inserting
+  /// each remaining element at the position found by binary search.
+  void binaryInsertionSort(uint32_t lo, uint32_t hi, uint32_t start) {
+    for (; start < hi; ++start) {
+      T pivot = data_[start];
+      uint32_t left = lo;
+      uint32_t right = start;
+      while (left < right) {
+        uint32_t mid = left + (right - left) / 2;
+        if (lt(pivot, data_[mid]))
+          right = mid;
+        else
+          left = mid + 1;
+      }
+      std::copy_backward(data_ + left, data_ + start, data_ + start + 1);
+      data_[left] = pivot;
+    }
+  }
+
+  /// Merge adjacent runs until the lengths of the runs on the stack decrease
+  /// at least as fast as the Fibonacci numbers, which bounds the depth of the
+  /// stack and keeps merges balanced.
+  void mergeCollapse() {
+    while (runs_.size() > 1) {
+      size_t n = runs_.size() - 2;
+      if ((n > 0 && runs_[n - 1].len <= runs_[n].len + runs_[n + 1].len) ||
+          (n > 1 && runs_[n - 2].len <= runs_[n - 1].len + runs_[n].len)) {
+        if (runs_[n - 1].len < runs_[n + 1].len)
+          --n;
+      } else if (runs_[n].len > runs_[n + 1].len) {
+        break;
+      }
+      mergeAt(n);
+    }
+  }
+
+  /// Merge all the remaining runs.
+  void mergeForceCollapse() {
+    while (runs_.size() > 1) {
+      size_t n = runs_.size() - 2;
+      if (n > 0 && runs_[n - 1].len < runs_[n + 1].len)
+        --n;
+      mergeAt(n);
+    }
+  }
+
+  /// Merge the runs at \p i and \p i + 1 on the stack.
+  void mergeAt(size_t i) {
+    uint32_t base1 = runs_[i].base;
+    uint32_t len1 = runs_[i].len;
+    uint32_t base2 = runs_[i + 1].base;
+    uint32_t len2 = runs_[i + 1].len;
+    runs_[i].len = len1 + len2;
+    runs_.erase(runs_.begin() + i + 1);
+
+    // Elements of the first run that are not greater than the first element
+    // of the second run are already in place, and so are elements of the
+    // second run that are not less than the last element of the first run.
+    uint32_t k = gallopRight(data_[base2], data_ + base1, len1, 0);
+    base1 += k;
+    len1 -= k;
+    if (len1 == 0)
+      return;
+    len2 = gallopLeft(data_[base1 + len1 - 1], data_ + base2, len2, len2 - 1);
+    if (len2 == 0)
+      return;
+
+    if (len1 <= len2)
+      mergeLo(base1, len1, base2, len2);
+    else
+      mergeHi(base1, len1, base2, len2);
+  }
+
+  /// Find where \p key goes in the sorted range [a, a + len), starting the
+  /// search at \p hint.
+  /// \return the position of \p key before any element equal to it.
+  uint32_t gallopLeft(T key, const T *a, uint32_t len, uint32_t hint) {
+    int64_t lastOfs = 0;
+    int64_t ofs = 1;
+    if (lt(a[hint], key)) {
+      // Gallop right until a[hint + lastOfs] < key <= a[hint + ofs].
+      int64_t maxOfs = len - hint;
+      while (ofs < maxOfs && lt(a[hint + ofs], key)) {
+        lastOfs = ofs;
+        ofs = ofs * 2 + 1;
+      }
+      ofs = std::min(ofs, maxOfs);
+      lastOfs += hint;
+      ofs += hint;
+    } else {
+      // Gallop left until a[hint - ofs] < key <= a[hint - lastOfs].
+      int64_t maxOfs = hint + 1;
+      while (ofs < maxOfs && !lt(a[hint - ofs], key)) {
+        lastOfs = ofs;
+        ofs = ofs * 2 + 1;
+      }
+      ofs = std::min(ofs, maxOfs);
+      int64_t tmp = lastOfs;
+      lastOfs = hint - ofs;
+      ofs = hint - tmp;
+    }
+    // Now a[lastOfs] < key <= a[ofs], binary search in between.
+    ++lastOfs;
+    while (lastOfs < ofs) {
+      int64_t m = lastOfs + (ofs - lastOfs) / 2;
+      if (lt(a[m], key))
+        lastOfs = m + 1;
+      else
+        ofs = m;
+    }
+    return ofs;
+  }
+
+  /// Like gallopLeft().
+  /// \return the position of \p key after any element equal to it.
+  uint32_t gallopRight(T key, const T *a, uint32_t len, uint32_t hint) {
+    int64_t lastOfs = 0;
+    int64_t ofs = 1;
+    if (lt(key, a[hint])) {
+      // Gallop left until a[hint - ofs] <= key < a[hint - lastOfs].
+      int64_t maxOfs = hint + 1;
+      while (ofs < maxOfs && lt(key, a[hint - ofs])) {
+        lastOfs = ofs;
+        ofs = ofs * 2 + 1;
+      }
+      ofs = std::min(ofs, maxOfs);
+      int64_t tmp = lastOfs;
+      lastOfs = hint - ofs;
+      ofs = hint - tmp;
+    } else {
+      // Gallop right until a[hint + lastOfs] <= key < a[hint + ofs].
+      int64_t maxOfs = len - hint;
+      while (ofs < maxOfs && !lt(key, a[hint + ofs])) {
+        lastOfs = ofs;
+        ofs = ofs * 2 + 1;
+      }
+      ofs = std::min(ofs, maxOfs);
+      lastOfs += hint;
+      ofs += hint;
+    }
+    // Now a[lastOfs] <= key < a[ofs], binary search in between.
+    ++lastOfs;
+    while (lastOfs < ofs) {
+      int64_t m = lastOfs + (ofs - lastOfs) / 2;
+      if (lt(key, a[m]))
+        ofs = m;
+      else
+        lastOfs = m + 1;
+    }
+    return ofs;
+  }
+
+  /// Merge the adjacent runs [base1, base1 + len1) and [base2, base2 + len2),
+  /// where len1 <= len2, by copying the first run aside and filling the
+  /// array from the left.
+  void mergeLo(uint32_t base1, uint32_t len1, uint32_t base2, uint32_t len2) {
+    tmp_.assign(data_ + base1, data_ + base1 + len1);
+    const T *tmp = tmp_.data();
+    // The gap between dest and cursor2 is always len1 elements long.
+    uint32_t cursor1 = 0;
+    uint32_t cursor2 = base2;
+    uint32_t dest = base1;
+
+    // mergeAt() guarantees that the second run starts with the smallest
+    // element, and that the first run ends with the largest. The code below
+    // doesn't rely on it for safety, only when comparisons are consistent.
+    data_[dest++] = data_[cursor2++];
+    if (--len2 != 0 && len1 != 1) {
+      uint32_t minGallop = minGallop_;
+      while (true) {
+        // Number of consecutive wins of each run.
+        uint32_t count1 = 0;
+        uint32_t count2 = 0;
+        do {
+          if (lt(data_[cursor2], tmp[cursor1])) {
+            data_[dest++] = data_[cursor2++];
+            ++count2;
+            count1 = 0;
+            if (--len2 == 0)
+              goto done;
+          } else {
+            data_[dest++] = tmp[cursor1++];
+            ++count1;
+            count2 = 0;
+            if (--len1 == 1)
+              goto done;
+          }
+        } while ((count1 | count2) < minGallop);
+
+        // One run is winning consistently, gallop until neither is.
+        do {
+          count1 = gallopRight(data_[cursor2], tmp + cursor1, len1, 0);
+          if (count1 != 0) {
+            std::copy(tmp + cursor1, tmp + cursor1 + count1, data_ + dest);
+            dest += count1;
+            cursor1 += count1;
+            len1 -= count1;
+            if (len1 <= 1)
+              goto done;
+          }
+          data_[dest++] = data_[cursor2++];
+          if (--len2 == 0)
+            goto done;
+
+          count2 = gallopLeft(tmp[cursor1], data_ + cursor2, len2, 0);
+          if (count2 != 0) {
+            std::copy(data_ + cursor2, data_ + cursor2 + count2, data_ + dest);
+            dest += count2;
+            cursor2 += count2;
+            len2 -= count2;
+            if (len2 == 0)
+              goto done;
+          }
+          data_[dest++] = tmp[cursor1++];
+          if (--len1 == 1)
+            goto done;
+          if (minGallop > 1)
+            --minGallop;
+        } while (count1 >= kMinGallop || count2 >= kMinGallop);
+        // Galloping didn't pay off, make it harder to start again.
+        minGallop += 2;
+      }
+    done:
+      minGallop_ = std::max(minGallop, 1u);
+    }
+
+    if (len2 == 0) {
+      std::copy(tmp + cursor1, tmp + cursor1 + len1, data_ + dest);
+    } else if (len1 != 0) {
+      // The last element of the first run goes after the rest of the second.
+      assert(len1 == 1 && "merge ended early");
+      std::copy(data_ + cursor2, data_ + cursor2 + len2, data_ + dest);
+      data_[dest + len2] = tmp[cursor1];
+    }
+  }
+
+  /// Merge the adjacent runs [base1, base1 + len1) and [base2, base2 + len2),
+  /// where len1 > len2, by copying the second run aside and filling the
+  /// array from the right.
+  void mergeHi(uint32_t base1, uint32_t len1, uint32_t base2, uint32_t len2) {
+    tmp_.assign(data_ + base2, data_ + base2 + len2);
+    const T *tmp = tmp_.data();
+    // The elements left to merge are [base1, base1 + len1) and
+    // [tmp, tmp + len2), and they go to [base1, dest).
+    uint32_t dest = base2 + len2;
+
+    data_[--dest] = data_[base1 + --len1];
+    if (len1 != 0 && len2 != 1) {
+      uint32_t minGallop = minGallop_;
+      while (true) {
+        uint32_t count1 = 0;
+        uint32_t count2 = 0;
+        do {
+          if (lt(tmp[len2 - 1], data_[base1 + len1 - 1])) {
+            data_[--dest] = data_[base1 + --len1];
+            ++count1;
+            count2 = 0;
+            if (len1 == 0)
+              goto done;
+          } else {
+            data_[--dest] = tmp[--len2];
+            ++count2;
+            count1 = 0;
+            if (len2 == 1)
+              goto done;
+          }
+        } while ((count1 | count2) < minGallop);
+
+        do {
+          count1 =
+              len1 - gallopRight(tmp[len2 - 1], data_ + base1, len1, len1 - 1);
+          if (count1 != 0) {
+            len1 -= count1;
+            dest -= count1;
+            std::copy_backward(
+                data_ + base1 + len1,
+                data_ + base1 + len1 + count1,
+                data_ + dest + count1);
+            if (len1 == 0)
+              goto done;
+          }
+          data_[--dest] = tmp[--len2];
+          if (len2 == 1)
+            goto done;
+
+          count2 =
+              len2 - gallopLeft(data_[base1 + len1 - 1], tmp, len2, len2 - 1);
+          if (count2 != 0) {
+            len2 -= count2;
+            dest -= count2;
+            std::copy(tmp + len2, tmp + len2 + count2, data_ + dest);
+            if (len2 <= 1)
+              goto done;
+          }
+          data_[--dest] = data_[base1 + --len1];
+          if (len1 == 0)
+            goto done;
+          if (minGallop > 1)
+            --minGallop;
+        } while (count1 >= kMinGallop || count2 >= kMinGallop);
+        minGallop += 2;
+      }
+    done:
+      minGallop_ = std::max(minGallop, 1u);
+    }
+
+    if (len1 == 0) {
+      std::copy(tmp, tmp + len2, data_ + dest - len2);
+    } else if (len2 != 0) {
+      // The first element of the second run goes before the rest of the first.
+      assert(len2 == 1 && "merge ended early");
+      std::copy_backward(
+          data_ + base1, data_ + base1 + len1, data_ + base1 + len1 + 1);
+      data_[base1] = tmp[0];
+    }
+  }
+
+  /// The elements to sort.
+  T *const data_;
+  const uint32_t len_;
+
+  /// The comparison.
+  Less less_;
+
+  /// Set once a comparison has returned an exception.
+  bool failed_{false};
+
+  /// Number of consecutive wins after which merges start galloping. It goes
+  /// down while galloping pays off, and up when it doesn't.
+  uint32_t minGallop_{kMinGallop};
+
+  /// Pending runs, which are adjacent in the array. Their lengths grow at
+  /// least as fast as the Fibonacci numbers, so the stack stays small.
+  llvm::SmallVector<Run, 40> runs_{};
+
+  /// Space for the shorter of the two runs being merged.
+  std::vector<T> tmp_{};
+};
+
+/// Sort [data, data + len) with TimSort, see the class for \p less.
+template <typename T, typename Less>
+ExecutionStatus timSort(T *data, uint32_t len, Less less) {
+  return TimSort<T, Less>(data, len, less).sort();
+}
+
+namespace detail {
+
+/// The unsigned integer type with the same size as \p T.
+template <typename T>
+using RadixKey = typename std::conditional<
+    sizeof(T) == 1,
+    uint8_t,
+    typename std::conditional<
+        sizeof(T) == 2,
+        uint16_t,
+        typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type>::
+        type>::type;
+
+/// \return an unsigned integer whose order is the numeric order of \p value,
+/// with -0 before +0. \p value must not be NaN.
+template <typename T>
+RadixKey<T> toRadixKey(T value) {
+  using Key = RadixKey<T>;
+  constexpr Key signBit = Key(1) << (sizeof(Key) * 8 - 1);
+  Key bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  if (std::is_floating_point<T>::value) {
+    // Negative numbers are ordered backwards by their magnitude.
+    return (bits & signBit) ? Key(~bits) : Key(bits | signBit);
+  }
+  return std::is_signed<T>::value ? Key(bits ^ signBit) : bits;
+}
+
+/// The inverse of toRadixKey().
+template <typename T>
+T fromRadixKey(RadixKey<T> key) {
+  using Key = RadixKey<T>;
+  constexpr Key signBit = Key(1) << (sizeof(Key) * 8 - 1);
+  Key bits;
+  if (std::is_floating_point<T>::value)
+    bits = (key & signBit) ? Key(key ^ signBit) : Key(~key);
+  else
+    bits = std::is_signed<T>::value ? Key(key ^ signBit) : key;
+  T value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/// Sort \p keys with a least significant digit radix sort, one byte at a
+/// time, using \p scratch as temporary space of the same size. Bytes that
+/// are the same in every key are skipped.
+template <typename Key>
+void radixSort(Key *keys, size_t n, Key *scratch) {
+  constexpr unsigned kNumDigits = sizeof(Key);
+  std::array<std::array<size_t, 256>, kNumDigits> counts{};
+  for (size_t i = 0; i != n; ++i) {
+    for (unsigned d = 0; d != kNumDigits; ++d)
+      ++counts[d][(keys[i] >> (d * 8)) & 0xff];
+  }
+
+  Key *src = keys;
+  Key *dst = scratch;
+  for (unsigned d = 0; d != kNumDigits; ++d) {
+    auto &count = counts[d];
+    const unsigned shift = d * 8;
+    if (count[(src[0] >> shift) & 0xff] == n)
+      continue;
+    size_t offset = 0;
+    for (size_t &c : count) {
+      size_t next = offset + c;
+      c = offset;
+      offset = next;
+    }
+    for (size_t i = 0; i != n; ++i)
+      dst[count[(src[i] >> shift) & 0xff]++] = src[i];
+    std::swap(src, dst);
+  }
+  if (src != keys)
+    std::copy(src, src + n, keys);
+}
+
+} // namespace detail
+
+/// Sort the numbers in [first, last) in ascending numeric order, with -0
+/// before +0 and NaN last (as in TypedArray.prototype.sort() without a
+/// comparison function). The numbers are mapped to unsigned integers with the
+/// same order, which are sorted with a radix sort, so there are no
+/// comparisons and the time is linear in the number of elements.
+template <typename T>
+void sortNumbers(T *first, T *last) {
+  static_assert(std::is_arithmetic<T>::value, "can only sort numbers");
+  // Radix sort doesn't pay off for a handful of elements.
+  constexpr size_t kMinRadixSort = 64;
+  using Key = detail::RadixKey<T>;
+
+  if (std::is_floating_point<T>::value) {
+    // NaN has no place in the order, move every NaN to the end unchanged.
+    last = std::partition(first, last, [](T x) { return !std::isnan(x); });
+  }
+  const size_t n = last - first;
+  if (n < 2)
+    return;
+
+  std::vector<Key> keys(n);
+  std::transform(first, last, keys.begin(), detail::toRadixKey<T>);
+  if (n < kMinRadixSort) {
+    std::sort(keys.begin(), keys.end());
+  } else {
+    std::vector<Key> scratch(n);
+    detail::radixSort(keys.data(), n, scratch.data());
+  }
+  std::transform(keys.begin(), keys.end(), first, detail::fromRadixKey<T>);
+}
+
 } // namespace vm
 } // namespace hermes
 
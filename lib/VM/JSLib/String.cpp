@@ -26,6 +26,7 @@
 #include <CoreFoundation/CFString.h>
 #endif
 
+#include <cstring>
 #include <locale>
 
 namespace hermes {
@@ -687,6 +688,17 @@ stringPrototypeToString(void *, Runtime *runtime, NativeArgs args) {
 
 static CallResult<HermesValue>
 stringPrototypeCharAt(void *, Runtime *runtime, NativeArgs args) {
+  // Fast path: a string receiver and an in-range position, whose character
+  // comes from the table of single-character strings without conversions.
+  if (LLVM_LIKELY(args.getThisArg().isString() && args.getArg(0).isNumber())) {
+    StringPrimitive *str = args.getThisArg().getString();
+    double position = args.getArg(0).getNumber();
+    if (LLVM_LIKELY(position >= 0 && position < str->getStringLength())) {
+      return runtime->getCharacterString(str->at((uint32_t)position))
+          .getHermesValue();
+    }
+  }
+
   Handle<> thisValue{&args.getThisArg()};
   // Call a function that may throw, let the runtime record it.
   if (LLVM_UNLIKELY(
@@ -798,23 +810,33 @@ stringPrototypeCodePointAt(void *, Runtime *runtime, NativeArgs args) {
   return HermesValue::encodeNumberValue(utf16Decode(first, second));
 }
 
-static CallResult<HermesValue>
-stringPrototypeConcat(void *, Runtime *runtime, NativeArgs args) {
+CallResult<HermesValue> concatArgsToString(
+    Runtime *runtime,
+    Handle<StringPrimitive> first,
+    NativeArgs args,
+    uint32_t argIndex) {
   GCScope gcScope(runtime);
 
-  if (LLVM_UNLIKELY(
-          checkObjectCoercible(runtime, args.getThisHandle()) ==
-          ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
+  uint32_t argCount =
+      argIndex < args.getArgCount() ? args.getArgCount() - argIndex : 0;
+  if (argCount == 0) {
+    return first.getHermesValue();
   }
-  auto strRes = toString_RJS(runtime, args.getThisHandle());
-  if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
+
+  // A single argument is concatenated like 'first + arg', which doesn't copy
+  // long strings.
+  if (argCount == 1) {
+    auto argRes = toString_RJS(runtime, args.getArgHandle(runtime, argIndex));
+    if (LLVM_UNLIKELY(argRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    return StringPrimitive::concat(
+        runtime, first, toHandle(runtime, std::move(*argRes)));
   }
-  auto S = toHandle(runtime, std::move(*strRes));
-  // Track the total characters in the result.
-  SafeUInt32 size(S->getStringLength());
-  uint32_t argCount = args.getArgCount();
+
+  // Track the total characters in the result, and whether they are all ASCII.
+  SafeUInt32 size(first->getStringLength());
+  bool allASCII = first->isASCII();
 
   // Store the results of toStrings and concat them at the end.
   auto arrRes = ArrayStorage::create(runtime, argCount, argCount);
@@ -826,7 +848,8 @@ stringPrototypeConcat(void *, Runtime *runtime, NativeArgs args) {
   // Run toString on the arguments to figure out the final size.
   auto marker = gcScope.createMarker();
   for (uint32_t i = 0; i < argCount; ++i) {
-    auto strRes = toString_RJS(runtime, args.getArgHandle(runtime, i));
+    auto strRes =
+        toString_RJS(runtime, args.getArgHandle(runtime, argIndex + i));
     if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
@@ -835,6 +858,7 @@ stringPrototypeConcat(void *, Runtime *runtime, NativeArgs args) {
     // and we know we're in bounds because we preallocated.
     strings->at(i).set(strRes->getHermesValue(), &runtime->getHeap());
     uint32_t strLength = strRes->get()->getStringLength();
+    allASCII = allASCII && strRes->get()->isASCII();
 
     size.add(strLength);
     if (LLVM_UNLIKELY(size.isOverflowed())) {
@@ -845,13 +869,13 @@ stringPrototypeConcat(void *, Runtime *runtime, NativeArgs args) {
   }
 
   // Allocate the complete result.
-  auto builder = StringBuilder::createStringBuilder(runtime, size);
+  auto builder = StringBuilder::createStringBuilder(runtime, size, allASCII);
   if (builder == ExecutionStatus::EXCEPTION) {
     return ExecutionStatus::EXCEPTION;
   }
 
-  // Copy 'this' argument first.
-  builder->appendStringPrim(S);
+  // Copy the first string.
+  builder->appendStringPrim(first);
   MutableHandle<StringPrimitive> element{runtime};
 
   // Copy the rest of the strings.
@@ -862,6 +886,23 @@ stringPrototypeConcat(void *, Runtime *runtime, NativeArgs args) {
   return builder->getStringPrimitive().getHermesValue();
 }
 
+static CallResult<HermesValue>
+stringPrototypeConcat(void *, Runtime *runtime, NativeArgs args) {
+  GCScope gcScope(runtime);
+
+  if (LLVM_UNLIKELY(
+          checkObjectCoercible(runtime, args.getThisHandle()) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto strRes = toString_RJS(runtime, args.getThisHandle());
+  if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return concatArgsToString(
+      runtime, toHandle(runtime, std::move(*strRes)), args, 0);
+}
+
 static CallResult<HermesValue>
 stringPrototypeSlice(void *, Runtime *runtime, NativeArgs args) {
   if (LLVM_UNLIKELY(
@@ -903,6 +944,104 @@ stringPrototypeSlice(void *, Runtime *runtime, NativeArgs args) {
   return StringPrimitive::slice(runtime, S, from, span);
 }
 
+/// \return the first position in [first, last) holding \p ch, or \p last.
+static const char *findChar(const char *first, const char *last, char16_t ch) {
+  // ASCII strings only hold characters below 128.
+  if (ch >= 128)
+    return last;
+  auto *found = static_cast<const char *>(memchr(first, ch, last - first));
+  return found ? found : last;
+}
+
+static const char16_t *
+findChar(const char16_t *first, const char16_t *last, char16_t ch) {
+  return std::find(first, last, ch);
+}
+
+/// Search \p haystack for \p needle, looking for candidates by scanning for
+/// the first character of the needle and only comparing the rest of it there.
+/// \param start the first (or, if \p reverse is set, the last) index where the
+///   match may begin.
+/// \return the index where the match begins, or llvm::None.
+template <typename HaystackT, typename NeedleT>
+static OptValue<uint32_t> findSubstringImpl(
+    llvm::ArrayRef<HaystackT> haystack,
+    llvm::ArrayRef<NeedleT> needle,
+    uint32_t start,
+    bool reverse) {
+  if (needle.size() > haystack.size())
+    return llvm::None;
+  uint32_t lastStart = haystack.size() - needle.size();
+  if (needle.empty())
+    return std::min(start, lastStart);
+
+  const HaystackT *begin = haystack.begin();
+  const NeedleT first = needle[0];
+  if (reverse) {
+    for (uint32_t k = std::min(start, lastStart) + 1; k-- > 0;) {
+      if (begin[k] == first &&
+          std::equal(needle.begin() + 1, needle.end(), begin + k + 1)) {
+        return k;
+      }
+    }
+    return llvm::None;
+  }
+
+  if (start > lastStart)
+    return llvm::None;
+  const HaystackT *end = begin + lastStart + 1;
+  for (const HaystackT *cur = begin + start;
+       (cur = findChar(cur, end, first)) != end;
+       ++cur) {
+    if (std::equal(needle.begin() + 1, needle.end(), cur + 1))
+      return cur - begin;
+  }
+  return llvm::None;
+}
+
+/// Search \p haystack for \p needle, starting at index \p start, which must
+/// not exceed the length of \p haystack. If \p reverse is set, \p start is
+/// the last index where the match may begin and the last match is returned.
+/// \return the index where the match begins, or llvm::None.
+static OptValue<uint32_t> findSubstring(
+    const StringView &haystack,
+    const StringView &needle,
+    uint32_t start,
+    bool reverse = false) {
+  if (haystack.isASCII()) {
+    ASCIIRef str{haystack.castToCharPtr(), haystack.length()};
+    if (needle.isASCII()) {
+      return findSubstringImpl(
+          str,
+          ASCIIRef{needle.castToCharPtr(), needle.length()},
+          start,
+          reverse);
+    }
+    return findSubstringImpl(
+        str,
+        UTF16Ref{needle.castToChar16Ptr(), needle.length()},
+        start,
+        reverse);
+  }
+  UTF16Ref str{haystack.castToChar16Ptr(), haystack.length()};
+  if (needle.isASCII()) {
+    return findSubstringImpl(
+        str, ASCIIRef{needle.castToCharPtr(), needle.length()}, start, reverse);
+  }
+  return findSubstringImpl(
+      str, UTF16Ref{needle.castToChar16Ptr(), needle.length()}, start, reverse);
+}
+
+/// Append the characters of \p view to \p builder, which must not need to be
+/// reallocated to hold them.
+static void appendStringView(StringBuilder &builder, const StringView &view) {
+  if (view.isASCII()) {
+    builder.appendASCIIRef({view.castToCharPtr(), view.length()});
+  } else {
+    builder.appendUTF16Ref({view.castToChar16Ptr(), view.length()});
+  }
+}
+
 /// Works slightly differently from the given implementation in the spec.
 /// Given a string \p S and a starting point \p q, finds the first match of
 /// \p R such that it starts on or after index \p q in \p S.
@@ -933,17 +1072,66 @@ static CallResult<RegExpMatch> splitMatch(
     return match;
   }
 
-  auto sliced = SStr.slice(q);
-  auto searchResult =
-      std::search(sliced.begin(), sliced.end(), RStr.begin(), RStr.end());
-
-  if (searchResult != sliced.end()) {
-    uint32_t i = q + (searchResult - sliced.begin());
-    match.push_back({{i, RHandle->getStringLength()}});
+  if (auto i = findSubstring(SStr, RStr, q)) {
+    match.push_back({{*i, RHandle->getStringLength()}});
   }
   return match;
 }
 
+/// Split \p S on the non-empty string \p separator, appending at most \p lim
+/// elements to the empty array \p A. Unlike the generic loop in
+/// splitInternal(), this scans S once and doesn't create a RegExpMatch for each
+/// piece.
+static CallResult<HermesValue> splitOnString(
+    Runtime *runtime,
+    Handle<StringPrimitive> S,
+    Handle<StringPrimitive> separator,
+    Handle<JSArray> A,
+    uint32_t lim) {
+  auto SView = StringPrimitive::createStringView(runtime, S);
+  auto sepView = StringPrimitive::createStringView(runtime, separator);
+  uint32_t sepLength = separator->getStringLength();
+  uint32_t lengthA = 0;
+  // End of the last match.
+  uint32_t p = 0;
+
+  GCScopeMarkerRAII gcMarker{runtime};
+  while (auto q = findSubstring(SView, sepView, p)) {
+    gcMarker.flush();
+    auto strRes = StringPrimitive::slice(runtime, S, p, *q - p);
+    if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    JSArray::setElementAt(
+        A, runtime, lengthA, runtime->makeHandle<StringPrimitive>(*strRes));
+    if (++lengthA == lim) {
+      // Reached the limit, return early.
+      if (LLVM_UNLIKELY(
+              JSArray::setLengthProperty(A, runtime, lengthA) ==
+              ExecutionStatus::EXCEPTION))
+        return ExecutionStatus::EXCEPTION;
+      return A.getHermesValue();
+    }
+    p = *q + sepLength;
+  }
+
+  // Add the rest of the string (after the last match) to A.
+  auto strRes =
+      StringPrimitive::slice(runtime, S, p, S->getStringLength() - p);
+  if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  JSArray::setElementAt(
+      A, runtime, lengthA, runtime->makeHandle<StringPrimitive>(*strRes));
+  ++lengthA;
+
+  if (LLVM_UNLIKELY(
+          JSArray::setLengthProperty(A, runtime, lengthA) ==
+          ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  return A.getHermesValue();
+}
+
 CallResult<HermesValue> splitInternal(
     Runtime *runtime,
     Handle<> string,
@@ -1022,6 +1210,11 @@ CallResult<HermesValue> splitInternal(
     return A.getHermesValue();
   }
 
+  if (R->isString() && R->getString()->getStringLength() != 0) {
+    return splitOnString(
+        runtime, S, Handle<StringPrimitive>::vmcast(R), A, lim);
+  }
+
   // End of the last match.
   uint32_t p = 0;
   // Place to attempt the start of the next match.
@@ -1217,75 +1410,64 @@ static CallResult<HermesValue> convertCase(
     Handle<StringPrimitive> S,
     const bool upperCase,
     const bool useCurrentLocale) {
-  // Copying is unavoidable in this function, do it early on.
+  if (!useCurrentLocale && S->isASCII()) {
+    // Fast path for ASCII strings, which are converted straight from the
+    // string's own storage. Find the first letter which has to change; if
+    // there is none, we don't have to allocate anything.
+    ASCIIRef str = S->getStringRef<char>();
+    const char *change =
+        findFirstASCIICaseChange(str.begin(), str.end(), upperCase);
+    if (change == str.end())
+      return S.getHermesValue();
+    // Use the Runtime stored representations of single-character strings.
+    if (str.size() == 1)
+      return runtime->getCharacterString(*change ^ ('a' ^ 'A'))
+          .getHermesValue();
+
+    uint32_t unchanged = change - str.begin();
+    auto builder = StringBuilder::createStringBuilder(
+        runtime, SafeUInt32(str.size()), /* isASCII */ true);
+    if (builder == ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    // Creating the builder may have moved S.
+    str = S->getStringRef<char>();
+    builder->appendASCIIRef(str.take_front(unchanged));
+    builder->appendASCIIRefConvertingCase(str.drop_front(unchanged), upperCase);
+    return HermesValue::encodeStringValue(*builder->getStringPrimitive());
+  }
+
+  // Copying is unavoidable in the rest of this function, do it early on.
   SmallU16String<32> buff;
   // Must copy instead of just getting the reference, because later operations
   // may trigger GC and hence invalid pointers inside S.
   S->copyUTF16String(buff);
   UTF16Ref str = buff.arrayRef();
 
-  if (!useCurrentLocale) {
-    // Try a fast path for ASCII strings.
-    // First, bitwise-or all the characters to see if any one isn't ASCII.
-    char16_t mask = 0;
-    // Also, check if we have to do work or we can just return S directly.
-    bool noop = true;
-    if (upperCase) {
-      for (const auto c : str) {
-        mask |= c;
-        // It's still a noop if the character isn't a lowercase ASCII.
-        noop &= !('a' <= c && c <= 'z');
-      }
-    } else {
-      for (const auto c : str) {
-        mask |= c;
-        // It's still a noop if the character isn't an uppercase ASCII.
-        noop &= !('A' <= c && c <= 'Z');
-      }
-    }
-    if (mask <= 127) {
-      if (noop) {
-        // We don't have to allocate anything.
-        return S.getHermesValue();
-      }
-
-      if (str.size() == 1) {
-        // Use the Runtime stored representations of single-character strings.
-        char16_t c = str[0];
-        if (upperCase) {
-          char16_t isLower = 'a' <= c && c <= 'z';
-          return runtime->getCharacterString(c & ~(isLower << 5))
-              .getHermesValue();
-        } else {
-          char16_t isUpper = 'A' <= c && c <= 'Z';
-          return runtime->getCharacterString(c | (isUpper << 5))
-              .getHermesValue();
-        }
-      }
-
-      SafeUInt32 len(S->getStringLength());
-      auto builder = StringBuilder::createStringBuilder(runtime, len);
-      if (builder == ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
-      char16_t ch;
-      if (upperCase) {
-        for (const char16_t c : str) {
-          // If it is lower, then clear the 5th bit, else do nothing.
-          char16_t isLower = 'a' <= c && c <= 'z';
-          ch = c & ~(isLower << 5);
-          builder->appendCharacter(ch);
-        }
-      } else {
-        for (const char16_t c : str) {
-          // If it is upper, then set the 5th bit, else do nothing.
-          char16_t isUpper = 'A' <= c && c <= 'Z';
-          ch = c | (isUpper << 5);
-          builder->appendCharacter(ch);
-        }
-      }
-      return HermesValue::encodeStringValue(*builder->getStringPrimitive());
+  if (!useCurrentLocale && isAllASCII(str.begin(), str.end())) {
+    // The same fast path for UTF-16 strings that happen to be ASCII. The
+    // result is stored as ASCII.
+    const char16_t *change =
+        findFirstASCIICaseChange(str.begin(), str.end(), upperCase);
+    if (change == str.end())
+      return S.getHermesValue();
+    if (str.size() == 1)
+      return runtime->getCharacterString(*change ^ ('a' ^ 'A'))
+          .getHermesValue();
+
+    size_t unchanged = change - str.begin();
+    convertASCIICase(
+        buff.data() + unchanged,
+        buff.size() - unchanged,
+        buff.data() + unchanged,
+        upperCase);
+    auto builder = StringBuilder::createStringBuilder(
+        runtime, SafeUInt32(str.size()), /* isASCII */ true);
+    if (builder == ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
     }
+    builder->appendASCIIUTF16Ref(str);
+    return HermesValue::encodeStringValue(*builder->getStringPrimitive());
   }
   platform_unicode::convertToCase(
       buff,
@@ -1563,33 +1745,10 @@ stringDirectedIndexOf(Runtime *runtime, NativeArgs args, bool reverse) {
   double len = S->getStringLength();
   uint32_t start = static_cast<uint32_t>(std::min(std::max(pos, 0.), len));
 
-  // TODO: good candidate for Boyer-Moore on large needles/haystacks
-  // TODO: good candidate for memchr on length-1 needles
   auto SView = StringPrimitive::createStringView(runtime, S);
   auto searchStrView = StringPrimitive::createStringView(runtime, searchStr);
-  double ret = -1;
-  if (reverse) {
-    uint32_t lastPossibleMatchEnd =
-        std::min(SView.length(), start + searchStrView.length());
-    auto foundIter = std::search(
-        SView.rbegin() + (SView.length() - lastPossibleMatchEnd),
-        SView.rend(),
-        searchStrView.rbegin(),
-        searchStrView.rend());
-    if (foundIter != SView.rend() || searchStrView.empty()) {
-      ret = SView.rend() - foundIter - searchStrView.length();
-    }
-  } else {
-    auto foundIter = std::search(
-        SView.begin() + start,
-        SView.end(),
-        searchStrView.begin(),
-        searchStrView.end());
-    if (foundIter != SView.end() || searchStrView.empty()) {
-      ret = foundIter - SView.begin();
-    }
-  }
-  return HermesValue::encodeDoubleValue(ret);
+  auto found = findSubstring(SView, searchStrView, start, reverse);
+  return HermesValue::encodeDoubleValue(found ? *found : -1.0);
 }
 
 static CallResult<HermesValue>
@@ -1998,11 +2157,10 @@ stringPrototypeReplace(void *, Runtime *runtime, NativeArgs args) {
   auto strView = StringPrimitive::createStringView(runtime, string);
   if (!strView.empty()) {
     auto searchView = StringPrimitive::createStringView(runtime, searchString);
-    auto searchResult = std::search(
-        strView.begin(), strView.end(), searchView.begin(), searchView.end());
+    auto searchResult = findSubstring(strView, searchView, 0);
 
-    if (searchResult != strView.end()) {
-      pos = searchResult - strView.begin();
+    if (searchResult) {
+      pos = *searchResult;
     } else {
       return string.getHermesValue();
     }
@@ -2035,16 +2193,25 @@ stringPrototypeReplace(void *, Runtime *runtime, NativeArgs args) {
     replStr = replStrRes->get();
   } else {
     // 12. Else,
-    // a. Let captures be an empty List.
-    auto nullHandle = runtime->makeNullHandle<ArrayStorage>();
-    // b. Let replStr be GetSubstitution(matched, string, pos, captures,
-    // replaceValue).
-    auto callRes = getSubstitution(
-        runtime, searchString, string, pos, nullHandle, replaceValueStr);
-    if (LLVM_UNLIKELY(callRes == ExecutionStatus::EXCEPTION)) {
-      return ExecutionStatus::EXCEPTION;
+    auto replaceView =
+        StringPrimitive::createStringView(runtime, replaceValueStr);
+    if (std::find(replaceView.begin(), replaceView.end(), u'$') ==
+        replaceView.end()) {
+      // There are no replacement patterns, so GetSubstitution would return
+      // replaceValue unchanged.
+      replStr = replaceValueStr.get();
+    } else {
+      // a. Let captures be an empty List.
+      auto nullHandle = runtime->makeNullHandle<ArrayStorage>();
+      // b. Let replStr be GetSubstitution(matched, string, pos, captures,
+      // replaceValue).
+      auto callRes = getSubstitution(
+          runtime, searchString, string, pos, nullHandle, replaceValueStr);
+      if (LLVM_UNLIKELY(callRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      replStr = vmcast<StringPrimitive>(callRes.getValue());
     }
-    replStr = vmcast<StringPrimitive>(callRes.getValue());
   }
   // 13. Let tailPos be pos + the number of code units in matched.
   uint32_t tailPos = pos + searchString->getStringLength();
@@ -2052,13 +2219,21 @@ stringPrototypeReplace(void *, Runtime *runtime, NativeArgs args) {
   // units of string, replStr, and the trailing substring of string starting at
   // index tailPos. If pos is 0, the first element of the concatenation will be
   // the empty String.
-  SmallU16String<32> newString{};
-  strView.slice(0, pos).copyUTF16String(newString);
-  StringPrimitive::createStringView(runtime, replStr)
-      .copyUTF16String(newString);
-  strView.slice(tailPos).copyUTF16String(newString);
+  // The result is built in place; it is ASCII if both parts are, so the
+  // builder never has to reallocate while reading from the string views.
+  SafeUInt32 newLength{string->getStringLength() - (tailPos - pos)};
+  newLength.add(replStr->getStringLength());
+  auto builderRes = StringBuilder::createStringBuilder(
+      runtime, newLength, string->isASCII() && replStr->isASCII());
+  if (LLVM_UNLIKELY(builderRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  appendStringView(*builderRes, strView.slice(0, pos));
+  appendStringView(
+      *builderRes, StringPrimitive::createStringView(runtime, replStr));
+  appendStringView(*builderRes, strView.slice(tailPos));
   // 15. Return newString.
-  return StringPrimitive::create(runtime, newString);
+  return builderRes->getStringPrimitive().getHermesValue();
 }
 
 static CallResult<HermesValue>
@@ -2271,12 +2446,11 @@ static CallResult<HermesValue> stringPrototypeIncludesOrStartsWith(
   // than searchLen, the code unit at index k+j of S is the same as the code
   // unit at index j of searchStr, return true; but if there is no such integer
   // k, return false.
-  for (double k = start; k + searchLength <= len; ++k) {
-    if (S->sliceEquals(k, searchLength, *searchStr)) {
-      return HermesValue::encodeBoolValue(true);
-    }
-  }
-  return HermesValue::encodeBoolValue(false);
+  auto SView = StringPrimitive::createStringView(runtime, S);
+  auto searchStrView = StringPrimitive::createStringView(runtime, searchStr);
+  return HermesValue::encodeBoolValue(
+      findSubstring(SView, searchStrView, static_cast<uint32_t>(start))
+          .hasValue());
 }
 
 static CallResult<HermesValue>
@@ -500,46 +500,23 @@ typedArrayPrototypeCopyWithin(void *, Runtime *runtime, NativeArgs args) {
   // 14. Let count be min(final-from, len-to).
   double count = std::min(fin - from, len - to);
 
-  int direction;
-  if (from < to && to < from + count) {
-    // 15. If from<to and to<from+count
-    // a. Let direction be -1.
-    direction = -1;
-    // b. Let from be from + count -1.
-    from = from + count - 1;
-    // c. Let to be to + count -1.
-    to = to + count - 1;
-  } else {
-    // 16. Else,
-    // a. Let direction = 1.
-    direction = 1;
-  }
-
-  // Need to case on the TypedArray type to avoid encoding using HermesValues.
-  // We need to preserve the bit-level encoding of values, and HermesValues
-  // destroy information, e.g. which NaN is being used.
-#define TYPED_ARRAY(name, type)                                            \
-  case CellKind::name##ArrayKind: {                                        \
-    auto *arr = vmcast<JSTypedArray<type, CellKind::name##ArrayKind>>(*O); \
-    if (!arr->attached(runtime)) {                                         \
-      return runtime->raiseTypeError(                                      \
-          "Underlying ArrayBuffer detached after calling copyWithin");     \
-    }                                                                      \
-    while (count > 0) {                                                    \
-      arr->at<type>(runtime, to) = arr->at<type>(runtime, from);           \
-      from += direction;                                                   \
-      to += direction;                                                     \
-      --count;                                                             \
-    }                                                                      \
-    break;                                                                 \
-  }
-
-  switch (O->getKind()) {
-#include "hermes/VM/TypedArrays.def"
-    default:
-      llvm_unreachable("Invalid TypedArray after ValidateTypedArray call");
+  if (!O->attached(runtime)) {
+    return runtime->raiseTypeError(
+        "Underlying ArrayBuffer detached after calling copyWithin");
+  }
+  if (count <= 0) {
+    return O.getHermesValue();
   }
 
+  // 15-17. Copy the elements one by one, backwards if the ranges overlap and
+  // the destination comes later. memmove does the same with the raw bytes,
+  // which also preserves the bit-level encoding of the values (e.g. which NaN
+  // is being used), unlike going through HermesValues.
+  const size_t width = O->getByteWidth();
+  std::memmove(
+      O->begin() + static_cast<size_t>(to) * width,
+      O->begin() + static_cast<size_t>(from) * width,
+      static_cast<size_t>(count) * width);
   return O.getHermesValue();
 }
 
@@ -848,6 +825,50 @@ typedArrayPrototypeForEach(void *, Runtime *runtime, NativeArgs args) {
 }
 
 enum class IndexOfMode { includes, indexOf, lastIndexOf };
+
+/// Search the elements of \p arr for \p x, starting at index \p from and
+/// moving towards index 0 if \p reverse is set, and towards the end otherwise.
+/// Elements are compared using SameValueZero if \p sameValueZero is set, and
+/// strict equality otherwise.
+/// \return the index of the first match, or -1 if there is none.
+template <typename TypedArray>
+static double searchTypedArray(
+    TypedArray *arr,
+    double x,
+    uint32_t from,
+    bool reverse,
+    bool sameValueZero) {
+  using T = typename std::remove_pointer<typename TypedArray::iterator>::type;
+  const T *data = arr->begin();
+  const uint32_t len = arr->getLength();
+  if (LLVM_UNLIKELY(std::isnan(x))) {
+    // NaN is only ever found by SameValueZero, which always searches forward,
+    // and only floating point arrays can hold it.
+    if (!sameValueZero || !std::is_floating_point<T>::value)
+      return -1;
+    for (uint32_t i = from; i != len; ++i) {
+      if (std::isnan(data[i]))
+        return i;
+    }
+    return -1;
+  }
+
+  // Only numbers that the element type represents exactly can be found.
+  // Comparing the elements with == then matches both zeros, as both
+  // comparisons do.
+  const T value = TypedArray::toDestType(x);
+  if (static_cast<double>(value) != x)
+    return -1;
+  if (reverse) {
+    for (uint32_t i = from + 1; i-- != 0;) {
+      if (data[i] == value)
+        return i;
+    }
+    return -1;
+  }
+  const T *found = std::find(data + from, data + len, value);
+  return found == data + len ? -1 : found - data;
+}
 CallResult<HermesValue>
 typedArrayPrototypeIndexOf(void *ctxVoid, Runtime *runtime, NativeArgs args) {
   // Whether this call is "includes", "indexOf", or "lastIndexOf".
@@ -897,24 +918,33 @@ typedArrayPrototypeIndexOf(void *ctxVoid, Runtime *runtime, NativeArgs args) {
   } else {
     k = fromIndex >= 0 ? fromIndex : std::max(len + fromIndex, 0.0);
   }
-  auto delta = ctx == IndexOfMode::lastIndexOf ? -1 : 1;
-  auto inRange = [ctx](double k, double len) {
-    if (ctx == IndexOfMode::lastIndexOf) {
-      return k >= 0;
-    } else {
-      return k < len;
-    }
-  };
-  for (; inRange(k, len); k += delta) {
-    auto curr = JSObject::getOwnIndexed(*self, runtime, k);
-    bool comp = ctx == IndexOfMode::includes
-        ? isSameValueZero(curr, searchElement)
-        : strictEqualityTest(curr, searchElement);
-    if (comp) {
-      return ret(true, k);
-    }
+  const bool reverse = ctx == IndexOfMode::lastIndexOf;
+  if (reverse ? k < 0 : k >= len) {
+    return ret();
+  }
+  // The conversions above may have detached the buffer, in which case no
+  // element is present.
+  if (!self->attached(runtime)) {
+    return ret();
   }
-  return ret();
+
+  // Comparing numbers can't run user code, so search the storage directly.
+  double index;
+  switch (self->getKind()) {
+#define TYPED_ARRAY(name, type)        \
+  case CellKind::name##ArrayKind:      \
+    index = searchTypedArray(          \
+        vmcast<name##Array>(*self),    \
+        searchElement.getNumber(),     \
+        k,                             \
+        reverse,                       \
+        ctx == IndexOfMode::includes); \
+    break;
+#include "hermes/VM/TypedArrays.def"
+    default:
+      llvm_unreachable("Invalid TypedArray after ValidateTypedArray call");
+  }
+  return index < 0 ? ret() : ret(true, index);
 }
 
 CallResult<HermesValue>
@@ -1070,29 +1100,39 @@ typedArrayPrototypeReverse(void *, Runtime *runtime, NativeArgs args) {
   }
   auto self = args.vmcastThis<JSTypedArrayBase>();
   const JSTypedArrayBase::size_type len = self->getLength();
-  const JSTypedArrayBase::size_type middle = len / 2;
-  MutableHandle<> lowerHandle(runtime);
-  MutableHandle<> upperHandle(runtime);
-  for (JSTypedArrayBase::size_type lower = 0; lower != middle; ++lower) {
-    auto upper = len - lower - 1;
-    lowerHandle = JSObject::getOwnIndexed(*self, runtime, lower);
-    upperHandle = JSObject::getOwnIndexed(*self, runtime, upper);
-    if (JSObject::setOwnIndexed(self, runtime, lower, upperHandle) ==
-        ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
+  if (len < 2) {
+    return self.getHermesValue();
+  }
+  // Reverse the raw elements, which preserves their bit-level encoding.
+  switch (self->getByteWidth()) {
+    case 1:
+      std::reverse(self->begin(), self->end());
+      break;
+    case 2: {
+      auto *src = reinterpret_cast<uint16_t *>(self->begin());
+      std::reverse(src, src + len);
+      break;
     }
-    if (JSObject::setOwnIndexed(self, runtime, upper, lowerHandle) ==
-        ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
+    case 4: {
+      auto *src = reinterpret_cast<uint32_t *>(self->begin());
+      std::reverse(src, src + len);
+      break;
     }
+    case 8: {
+      auto *src = reinterpret_cast<uint64_t *>(self->begin());
+      std::reverse(src, src + len);
+      break;
+    }
+    default:
+      llvm_unreachable("No element that is that wide");
+      break;
   }
   return self.getHermesValue();
 }
 
-/// This is the sort model for use with TypedArray.prototype.sort.
-/// template param \p WithCompareFn should be true if the compare function is
-/// a valid callback to call, and false if it is null or undefined.
-template <bool WithCompareFn>
+/// This is the sort model for use with TypedArray.prototype.sort with a
+/// compare function. Without one, the elements are sorted directly, see
+/// sortNumbers().
 class TypedArraySortModel : public SortModel {
  protected:
   /// Runtime to sort in.
@@ -1102,7 +1142,6 @@ class TypedArraySortModel : public SortModel {
   GCScope gcScope_;
 
   /// JS comparison function, return -1 for less, 0 for equal, 1 for greater.
-  /// If null, then use the built in < operator.
   Handle<Callable> compareFn_;
 
   /// Object to sort.
@@ -1148,10 +1187,6 @@ class TypedArraySortModel : public SortModel {
     GCScopeMarkerRAII gcMarker{gcScope_, gcMarker_};
     HermesValue aVal = JSObject::getOwnIndexed(*self_, runtime_, a);
     HermesValue bVal = JSObject::getOwnIndexed(*self_, runtime_, b);
-    if (!WithCompareFn) {
-      return aVal.getNumber() < bVal.getNumber();
-    }
-    assert(compareFn_ && "Cannot use this version if the compareFn is null");
     // ES7 22.2.3.26 2a.
     // Let v be toNumber_RJS(Call(comparefn, undefined, x, y)).
     auto callRes = Callable::executeCall2(
@@ -1189,18 +1224,31 @@ typedArrayPrototypeSort(void *, Runtime *runtime, NativeArgs args) {
     return runtime->raiseTypeError("TypedArray sort argument must be callable");
   }
 
+  if (!compareFn) {
+    // The elements all have the same type and sorting them can't run user
+    // code, so sort the storage directly. This also keeps the bit patterns of
+    // the elements, e.g. which NaN is stored.
+#define TYPED_ARRAY(name, type)                                               \
+  case CellKind::name##ArrayKind: {                                           \
+    auto *arr = vmcast<JSTypedArray<type, CellKind::name##ArrayKind>>(*self); \
+    sortNumbers(arr->begin(), arr->end());                                    \
+    break;                                                                    \
+  }
+
+    switch (self->getKind()) {
+#include "hermes/VM/TypedArrays.def"
+      default:
+        llvm_unreachable("Invalid TypedArray after ValidateTypedArray call");
+    }
+    return self.getHermesValue();
+  }
+
   // Use our custom sort routine. We can't use std::sort because it performs
   // optimizations that allow it to bypass calls to std::swap, but our swap
   // function is special, since it needs to use the internal Object functions.
-  if (compareFn) {
-    TypedArraySortModel<true> sm(runtime, self, compareFn);
-    if (LLVM_UNLIKELY(quickSort(&sm, 0, len) == ExecutionStatus::EXCEPTION))
-      return ExecutionStatus::EXCEPTION;
-  } else {
-    TypedArraySortModel<false> sm(runtime, self, compareFn);
-    if (LLVM_UNLIKELY(quickSort(&sm, 0, len) == ExecutionStatus::EXCEPTION))
-      return ExecutionStatus::EXCEPTION;
-  }
+  TypedArraySortModel sm(runtime, self, compareFn);
+  if (LLVM_UNLIKELY(quickSort(&sm, 0, len) == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
   return self.getHermesValue();
 }
 
@@ -1547,23 +1595,11 @@ CallResult<HermesValue> typedArrayPrototypeSymbolToStringTag(
 
 } // namespace
 
-Handle<JSObject> createTypedArrayBaseConstructor(Runtime *runtime) {
+static void initializeTypedArrayBaseConstructor(
+    Runtime *runtime,
+    Handle<NativeConstructor> cons) {
   auto proto = Handle<JSObject>::vmcast(&runtime->typedArrayBasePrototype);
 
-  // Create NativeConstructor manually to avoid global object assignment.
-  // Use NativeConstructor because %TypedArray% is supposed to be
-  // a constructor function object, but must not be called directly with "new".
-  auto cons = toHandle(
-      runtime,
-      NativeConstructor::create(
-          runtime,
-          Handle<JSObject>::vmcast(&runtime->functionPrototype),
-          nullptr,
-          typedArrayBaseConstructor,
-          0,
-          JSObject::createWithException,
-          CellKind::ObjectKind));
-
   // Define %TypedArray%.prototype to be proto.
   auto st = Callable::defineNameLengthAndPrototype(
       cons,
@@ -1821,18 +1857,14 @@ Handle<JSObject> createTypedArrayBaseConstructor(Runtime *runtime) {
         runtime->makeHandle<NativeFunction>(propValue)));
   }
 
-  {
-    auto propValue = runtime->ignoreAllocationFailure(JSObject::getNamed_RJS(
-        Handle<JSArray>::vmcast(&runtime->arrayPrototype),
-        runtime,
-        Predefined::getSymbolID(Predefined::toString)));
-    runtime->ignoreAllocationFailure(JSObject::defineOwnProperty(
-        proto,
-        runtime,
-        Predefined::getSymbolID(Predefined::toString),
-        dpf,
-        runtime->makeHandle<NativeFunction>(propValue)));
-  }
+  // Use the original Array.prototype.toString, which may have been replaced
+  // by the time this is populated.
+  runtime->ignoreAllocationFailure(JSObject::defineOwnProperty(
+      proto,
+      runtime,
+      Predefined::getSymbolID(Predefined::toString),
+      dpf,
+      Handle<>(&runtime->arrayPrototypeToString)));
 
   defineMethod(
       runtime,
@@ -1858,24 +1890,37 @@ Handle<JSObject> createTypedArrayBaseConstructor(Runtime *runtime) {
       nullptr,
       typedArrayOf,
       0);
+}
 
+Handle<JSObject> createTypedArrayBaseConstructor(Runtime *runtime) {
+  // Create NativeConstructor manually to avoid global object assignment.
+  // Use NativeConstructor because %TypedArray% is supposed to be
+  // a constructor function object, but must not be called directly with "new".
+  auto cons = toHandle(
+      runtime,
+      NativeConstructor::createLazy(
+          runtime,
+          Handle<JSObject>::vmcast(&runtime->functionPrototype),
+          typedArrayBaseConstructor,
+          JSObject::createWithException,
+          CellKind::ObjectKind));
+  runtime->registerLazyConstructor(cons, initializeTypedArrayBaseConstructor);
   return cons;
 }
 
 template <typename T, CellKind C>
-Handle<JSObject> createTypedArrayConstructor(Runtime *runtime) {
+static void initializeTypedArrayConstructor(
+    Runtime *runtime,
+    Handle<NativeConstructor> cons) {
   using TA = JSTypedArray<T, C>;
   auto proto = TA::getPrototype(runtime);
 
-  auto cons = defineSystemConstructor(
-      runtime,
-      TA::getName(runtime),
-      typedArrayConstructor<T, C>,
-      proto,
-      Handle<JSObject>::vmcast(&runtime->typedArrayBaseConstructor),
-      3,
-      TA::create,
-      C);
+  // Instances inherit the methods of %TypedArray%.prototype.
+  auto base = Handle<JSObject>::vmcast(&runtime->typedArrayBaseConstructor);
+  if (base->isLazy())
+    JSObject::initializeLazyObject(runtime, base);
+
+  initializeSystemConstructor(runtime, cons, TA::getName(runtime), proto, 3);
 
   DefinePropertyFlags dpf{};
   dpf.setEnumerable = 1;
@@ -1903,7 +1948,19 @@ Handle<JSObject> createTypedArrayConstructor(Runtime *runtime) {
       Predefined::getSymbolID(Predefined::BYTES_PER_ELEMENT),
       bytesPerElement,
       dpf);
-  return cons;
+}
+
+template <typename T, CellKind C>
+Handle<JSObject> createTypedArrayConstructor(Runtime *runtime) {
+  using TA = JSTypedArray<T, C>;
+  return defineLazySystemConstructor(
+      runtime,
+      TA::getName(runtime),
+      typedArrayConstructor<T, C>,
+      Handle<JSObject>::vmcast(&runtime->typedArrayBaseConstructor),
+      TA::create,
+      C,
+      initializeTypedArrayConstructor<T, C>);
 }
 
 /// Forward instantiations
@@ -33,7 +33,9 @@ weakMapPrototypeHas(void *, Runtime *runtime, NativeArgs args);
 static CallResult<HermesValue>
 weakMapPrototypeSet(void *, Runtime *runtime, NativeArgs args);
 
-Handle<JSObject> createWeakMapConstructor(Runtime *runtime) {
+static void initializeWeakMapConstructor(
+    Runtime *runtime,
+    Handle<NativeConstructor> cons) {
   auto weakMapPrototype = Handle<JSObject>::vmcast(&runtime->weakMapPrototype);
 
   defineMethod(
@@ -78,13 +80,12 @@ Handle<JSObject> createWeakMapConstructor(Runtime *runtime) {
       runtime->getPredefinedStringHandle(Predefined::WeakMap),
       dpf);
 
-  auto cons = defineSystemConstructor<JSWeakMap>(
+  initializeSystemConstructor(
       runtime,
+      cons,
       Predefined::getSymbolID(Predefined::WeakMap),
-      weakMapConstructor,
       weakMapPrototype,
-      0,
-      CellKind::WeakMapKind);
+      0);
 
   // ES6.0 23.3.3.1
   defineProperty(
@@ -92,8 +93,15 @@ Handle<JSObject> createWeakMapConstructor(Runtime *runtime) {
       weakMapPrototype,
       Predefined::getSymbolID(Predefined::constructor),
       cons);
+}
 
-  return cons;
+Handle<JSObject> createWeakMapConstructor(Runtime *runtime) {
+  return defineLazySystemConstructor<JSWeakMap>(
+      runtime,
+      Predefined::getSymbolID(Predefined::WeakMap),
+      weakMapConstructor,
+      CellKind::WeakMapKind,
+      initializeWeakMapConstructor);
 }
 
 static CallResult<HermesValue>
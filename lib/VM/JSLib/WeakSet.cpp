@@ -29,7 +29,9 @@ weakSetPrototypeDelete(void *, Runtime *runtime, NativeArgs args);
 static CallResult<HermesValue>
 weakSetPrototypeHas(void *, Runtime *runtime, NativeArgs args);
 
-Handle<JSObject> createWeakSetConstructor(Runtime *runtime) {
+static void initializeWeakSetConstructor(
+    Runtime *runtime,
+    Handle<NativeConstructor> cons) {
   auto weakSetPrototype = Handle<JSObject>::vmcast(&runtime->weakSetPrototype);
 
   defineMethod(
@@ -66,13 +68,12 @@ Handle<JSObject> createWeakSetConstructor(Runtime *runtime) {
       runtime->getPredefinedStringHandle(Predefined::WeakSet),
       dpf);
 
-  auto cons = defineSystemConstructor<JSWeakSet>(
+  initializeSystemConstructor(
       runtime,
+      cons,
       Predefined::getSymbolID(Predefined::WeakSet),
-      weakSetConstructor,
       weakSetPrototype,
-      0,
-      CellKind::WeakSetKind);
+      0);
 
   // ES6.0 23.4.3.1
   defineProperty(
@@ -80,8 +81,15 @@ Handle<JSObject> createWeakSetConstructor(Runtime *runtime) {
       weakSetPrototype,
       Predefined::getSymbolID(Predefined::constructor),
       cons);
+}
 
-  return cons;
+Handle<JSObject> createWeakSetConstructor(Runtime *runtime) {
+  return defineLazySystemConstructor<JSWeakSet>(
+      runtime,
+      Predefined::getSymbolID(Predefined::WeakSet),
+      weakSetConstructor,
+      CellKind::WeakSetKind,
+      initializeWeakSetConstructor);
 }
 
 static CallResult<HermesValue>
@@ -6,13 +6,26 @@
  */
 #include "JSLibInternal.h"
 
+#include "hermes/ADT/SafeInt.h"
 #include "hermes/Support/UTF8.h"
 #include "hermes/VM/Operations.h"
 #include "hermes/VM/SmallXString.h"
+#include "hermes/VM/StringBuilder.h"
 #include "hermes/VM/StringView.h"
 
 #include "llvm/Support/ConvertUTF.h"
 
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define HERMES_ESCAPE_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define HERMES_ESCAPE_NEON
+#endif
+
 namespace hermes {
 namespace vm {
 
@@ -20,21 +33,179 @@ using llvm::ConversionResult;
 using llvm::UTF32;
 using llvm::UTF8;
 
-/// \return true if c is a character that doesn't need to be escaped.
-static inline bool noEscape(char16_t c) {
-  return (u'A' <= c && c <= u'Z') || (u'a' <= c && c <= u'z') ||
-      (u'0' <= c && c <= u'9') || c == u'@' || c == u'*' || c == u'_' ||
-      c == u'+' || c == u'-' || c == u'.' || c == '/';
+namespace {
+
+/// A set of ASCII characters, with one bit per character.
+struct ASCIISet {
+  uint64_t bits[2];
+
+  /// \return true if \p c is in the set.
+  bool contains(uint32_t c) const {
+    return c < 128 && ((bits[c >> 6] >> (c & 63)) & 1);
+  }
+};
+
+/// \return the set of the characters in \p chars, plus the letters and
+/// digits if \p alnum is true.
+constexpr ASCIISet makeASCIISet(const char *chars, bool alnum) {
+  ASCIISet set{{0, 0}};
+  for (unsigned c = 0; alnum && c < 128; ++c) {
+    if ((u'A' <= c && c <= u'Z') || (u'a' <= c && c <= u'z') ||
+        (u'0' <= c && c <= u'9')) {
+      set.bits[c >> 6] |= uint64_t(1) << (c & 63);
+    }
+  }
+  for (; *chars; ++chars)
+    set.bits[*chars >> 6] |= uint64_t(1) << (*chars & 63);
+  return set;
+}
+
+/// The characters that escape() doesn't escape.
+constexpr ASCIISet kNoEscapeSet = makeASCIISet("@*_+-./", true);
+/// uriUnescaped.
+constexpr ASCIISet kURIUnescapedSet = makeASCIISet("-_.!~*'()", true);
+/// uriUnescaped plus '#' and uriReserved.
+constexpr ASCIISet kUnescapedURISet =
+    makeASCIISet("-_.!~*'()#;/?:@&=+$,", true);
+/// uriReserved plus '#'.
+constexpr ASCIISet kReservedURISet = makeASCIISet("#;/?:@&=+$,", false);
+/// No characters at all.
+constexpr ASCIISet kEmptySet = makeASCIISet("", false);
+
+#if defined(HERMES_ESCAPE_SSE2)
+#define HERMES_ESCAPE_SIMD
+/// \return true if the 16 bytes at \p p are all ASCII letters or digits.
+bool allAlnum16Bytes(const char *p) {
+  __m128i v = _mm_loadu_si128((const __m128i *)p);
+  __m128i letter =
+      _mm_sub_epi8(_mm_or_si128(v, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+  __m128i digit = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+  // Unsigned x <= n exactly when the saturated x - n is 0.
+  __m128i zero = _mm_setzero_si128();
+  __m128i ok = _mm_or_si128(
+      _mm_cmpeq_epi8(_mm_subs_epu8(letter, _mm_set1_epi8(25)), zero),
+      _mm_cmpeq_epi8(_mm_subs_epu8(digit, _mm_set1_epi8(9)), zero));
+  return _mm_movemask_epi8(ok) == 0xffff;
+}
+
+bool allAlnum16Bytes(const char16_t *p) {
+  __m128i v = _mm_loadu_si128((const __m128i *)p);
+  __m128i letter = _mm_sub_epi16(
+      _mm_or_si128(v, _mm_set1_epi16(0x20)), _mm_set1_epi16('a'));
+  __m128i digit = _mm_sub_epi16(v, _mm_set1_epi16('0'));
+  __m128i zero = _mm_setzero_si128();
+  __m128i ok = _mm_or_si128(
+      _mm_cmpeq_epi16(_mm_subs_epu16(letter, _mm_set1_epi16(25)), zero),
+      _mm_cmpeq_epi16(_mm_subs_epu16(digit, _mm_set1_epi16(9)), zero));
+  return _mm_movemask_epi8(ok) == 0xffff;
+}
+
+/// \return true if one of the 16 bytes at \p p is '%'.
+bool anyPercent16Bytes(const char16_t *p) {
+  __m128i v = _mm_loadu_si128((const __m128i *)p);
+  return _mm_movemask_epi8(_mm_cmpeq_epi16(v, _mm_set1_epi16('%'))) != 0;
+}
+#elif defined(HERMES_ESCAPE_NEON)
+#define HERMES_ESCAPE_SIMD
+/// \return true if the 16 bytes at \p p are all ASCII letters or digits.
+bool allAlnum16Bytes(const char *p) {
+  uint8x16_t v = vld1q_u8((const uint8_t *)p);
+  uint8x16_t letter = vsubq_u8(vorrq_u8(v, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+  uint8x16_t digit = vsubq_u8(v, vdupq_n_u8('0'));
+  uint8x16_t ok = vorrq_u8(
+      vcleq_u8(letter, vdupq_n_u8(25)), vcleq_u8(digit, vdupq_n_u8(9)));
+  return vminvq_u8(ok) == 0xff;
+}
+
+bool allAlnum16Bytes(const char16_t *p) {
+  uint16x8_t v = vld1q_u16((const uint16_t *)p);
+  uint16x8_t letter =
+      vsubq_u16(vorrq_u16(v, vdupq_n_u16(0x20)), vdupq_n_u16('a'));
+  uint16x8_t digit = vsubq_u16(v, vdupq_n_u16('0'));
+  uint16x8_t ok = vorrq_u16(
+      vcleq_u16(letter, vdupq_n_u16(25)), vcleq_u16(digit, vdupq_n_u16(9)));
+  return vminvq_u16(ok) == 0xffff;
 }
 
+/// \return true if one of the 16 bytes at \p p is '%'.
+bool anyPercent16Bytes(const char16_t *p) {
+  uint16x8_t v = vld1q_u16((const uint16_t *)p);
+  return vmaxvq_u16(vceqq_u16(v, vdupq_n_u16('%'))) != 0;
+}
+#endif
+
+/// \return the first character in [cur, end) that is not in \p set, which
+/// must contain all the letters and digits, or \p end if there is none.
+template <typename CharT>
+const CharT *findFirstNotIn(
+    const CharT *cur,
+    const CharT *end,
+    const ASCIISet &set) {
+  using UCharT = typename std::make_unsigned<CharT>::type;
+#ifdef HERMES_ESCAPE_SIMD
+  // Skip the blocks of letters and digits, which make up most of the text of
+  // URLs, and check the other blocks one character at a time.
+  constexpr ptrdiff_t kBlock = 16 / sizeof(CharT);
+  while (end - cur >= kBlock) {
+    if (allAlnum16Bytes(cur)) {
+      cur += kBlock;
+      continue;
+    }
+    for (const CharT *blockEnd = cur + kBlock; cur != blockEnd; ++cur) {
+      if (!set.contains((UCharT)*cur))
+        return cur;
+    }
+  }
+#endif
+  for (; cur != end; ++cur) {
+    if (!set.contains((UCharT)*cur))
+      break;
+  }
+  return cur;
+}
+
+/// \return the first '%' in [cur, end), or \p end if there is none.
+const char *findPercent(const char *cur, const char *end) {
+  const void *found = memchr(cur, '%', end - cur);
+  return found ? static_cast<const char *>(found) : end;
+}
+
+const char16_t *findPercent(const char16_t *cur, const char16_t *end) {
+#ifdef HERMES_ESCAPE_SIMD
+  constexpr ptrdiff_t kBlock = 16 / sizeof(char16_t);
+  for (; end - cur >= kBlock; cur += kBlock) {
+    if (anyPercent16Bytes(cur))
+      break;
+  }
+#endif
+  return std::find(cur, end, u'%');
+}
+
+/// Append the ASCII characters [start, end) to \p builder.
+void appendASCIIRun(
+    StringBuilder &builder,
+    const char *start,
+    const char *end) {
+  builder.appendASCIIRef(ASCIIRef(start, end - start));
+}
+
+void appendASCIIRun(
+    StringBuilder &builder,
+    const char16_t *start,
+    const char16_t *end) {
+  builder.appendASCIIUTF16Ref(UTF16Ref(start, end - start));
+}
+
+} // namespace
+
 /// \param x must be between 0 and 15 inclusive.
 /// \return the result of converting x to a hex character.
-static inline char16_t toHexChar(int x) {
+static inline char toHexChar(int x) {
   assert(0 <= x && x <= 15 && "toHexChar argument out of bounds");
   if (0 <= x && x <= 9) {
-    return x + u'0';
+    return x + '0';
   }
-  return x - 10 + u'A';
+  return x - 10 + 'A';
 }
 
 /// \return true if c is a valid hex char in the range [0-9a-fA-F].
@@ -56,6 +227,47 @@ static inline int fromHexChar(char16_t c) {
   return c - u'a' + 10;
 }
 
+/// Escape the characters [cur, end) to \p builder, or only count the
+/// characters it takes if \p builder is null.
+/// \return the number of characters of the escaped string.
+template <typename CharT>
+static SafeUInt32
+escapeChars(const CharT *cur, const CharT *end, StringBuilder *builder) {
+  SafeUInt32 length{0};
+  for (;;) {
+    const CharT *runEnd = findFirstNotIn(cur, end, kNoEscapeSet);
+    length.add(runEnd - cur);
+    if (builder)
+      appendASCIIRun(*builder, cur, runEnd);
+    if (runEnd == end)
+      return length;
+
+    char16_t c = *runEnd;
+    cur = runEnd + 1;
+    if (c < 256) {
+      // R += "%xy" where xy is the 2 bytes of c.
+      length.add(3);
+      if (builder) {
+        char buf[] = {'%', toHexChar((c >> 4) & 0xf), toHexChar(c & 0xf)};
+        builder->appendASCIIRef(buf);
+      }
+    } else {
+      // R += "%uwxyz" where wxyz is the 4 bytes of c.
+      length.add(6);
+      if (builder) {
+        char buf[] = {
+            '%',
+            'u',
+            toHexChar((c >> 12) & 0xf),
+            toHexChar((c >> 8) & 0xf),
+            toHexChar((c >> 4) & 0xf),
+            toHexChar(c & 0xf)};
+        builder->appendASCIIRef(buf);
+      }
+    }
+  }
+}
+
 /// Convert the argument to string and escape unicode characters.
 CallResult<HermesValue> escape(void *, Runtime *runtime, NativeArgs args) {
   auto res = toString_RJS(runtime, args.getArgHandle(runtime, 0));
@@ -63,30 +275,68 @@ CallResult<HermesValue> escape(void *, Runtime *runtime, NativeArgs args) {
     return ExecutionStatus::EXCEPTION;
   }
   auto string = toHandle(runtime, std::move(*res));
-  auto len = string->getStringLength();
-  SmallU16String<32> R{};
-  R.reserve(len);
+  auto str = StringPrimitive::createStringView(runtime, string);
+  // Measure the result first, so that it is allocated once, and directly as
+  // an ASCII string.
+  SafeUInt32 length = str.isASCII()
+      ? escapeChars(
+            str.castToCharPtr(), str.castToCharPtr() + str.length(), nullptr)
+      : escapeChars(
+            str.castToChar16Ptr(),
+            str.castToChar16Ptr() + str.length(),
+            nullptr);
+  if (!length.isOverflowed() && *length == str.length()) {
+    // Nothing needs to be escaped.
+    return string.getHermesValue();
+  }
 
-  for (char16_t c : StringPrimitive::createStringView(runtime, string)) {
-    if (noEscape(c)) {
-      // Just append.
-      R.push_back(c);
-    } else if (c < 256) {
-      // R += "%xy" where xy is the 2 bytes of c.
-      R.push_back(u'%');
-      R.push_back(toHexChar((c >> 4) & 0xf));
-      R.push_back(toHexChar(c & 0xf));
-    } else {
-      // R += "%uwxyz" where wxyz is the 4 bytes of c.
-      R.append(u"%u");
-      R.push_back(toHexChar((c >> 12) & 0xf));
-      R.push_back(toHexChar((c >> 8) & 0xf));
-      R.push_back(toHexChar((c >> 4) & 0xf));
-      R.push_back(toHexChar(c & 0xf));
-    }
+  auto builder =
+      StringBuilder::createStringBuilder(runtime, length, /* isASCII */ true);
+  if (LLVM_UNLIKELY(builder == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  // Nothing allocates from here on, so the pointers stay valid.
+  if (str.isASCII()) {
+    escapeChars(
+        str.castToCharPtr(), str.castToCharPtr() + str.length(), &*builder);
+  } else {
+    escapeChars(
+        str.castToChar16Ptr(), str.castToChar16Ptr() + str.length(), &*builder);
   }
+  return builder->getStringPrimitive().getHermesValue();
+}
 
-  return StringPrimitive::create(runtime, R);
+/// Append the unescaped characters [cur, end) to \p R.
+template <typename CharT>
+static void
+unescapeChars(const CharT *cur, const CharT *end, SmallU16String<32> &R) {
+  for (;;) {
+    // Copy the run of characters up to the next escape at once.
+    const CharT *runEnd = findPercent(cur, end);
+    R.append(cur, runEnd);
+    if (runEnd == end)
+      return;
+
+    size_t left = end - runEnd;
+    const CharT *str = runEnd;
+    // Resultant char to append to R.
+    char16_t r = u'%';
+    size_t consumed = 1;
+    // Try to read a hex string instead.
+    if (left >= 6 && str[1] == u'u' &&
+        std::all_of(str + 2, str + 6, [](CharT c) { return isHexChar(c); })) {
+      // Long form %uwxyz
+      r = (fromHexChar(str[2]) << 12) | (fromHexChar(str[3]) << 8) |
+          (fromHexChar(str[4]) << 4) | fromHexChar(str[5]);
+      consumed = 6;
+    } else if (left >= 3 && isHexChar(str[1]) && isHexChar(str[2])) {
+      // Short form %xy
+      r = (fromHexChar(str[1]) << 4) | fromHexChar(str[2]);
+      consumed = 3;
+    }
+    R.push_back(r);
+    cur = runEnd + consumed;
+  }
 }
 
 /// Convert the argument to string and unescape unicode characters.
@@ -96,133 +346,142 @@ CallResult<HermesValue> unescape(void *, Runtime *runtime, NativeArgs args) {
     return ExecutionStatus::EXCEPTION;
   }
   auto strPrim = toHandle(runtime, std::move(*res));
-  auto len = strPrim->getStringLength();
-  SmallU16String<32> R{};
-  R.reserve(len);
-
-  uint32_t k = 0;
   auto str = StringPrimitive::createStringView(runtime, strPrim);
-  while (k < len) {
-    char16_t c = str[k];
-    // Resultant char to append to R.
-    char16_t r = c;
-    if (c == u'%') {
-      // Try to read a hex string instead.
-      if (k + 6 <= len && str[k + 1] == u'u' &&
-          std::all_of(str.begin() + k + 2, str.begin() + k + 6, isHexChar)) {
-        // Long form %uwxyz
-        r = (fromHexChar(str[k + 2]) << 12) | (fromHexChar(str[k + 3]) << 8) |
-            (fromHexChar(str[k + 4]) << 4) | fromHexChar(str[k + 5]);
-        k += 5;
-      } else if (
-          k + 3 <= len && isHexChar(str[k + 1]) && isHexChar(str[k + 2])) {
-        // Short form %xy
-        r = (fromHexChar(str[k + 1]) << 4) | fromHexChar(str[k + 2]);
-        k += 2;
-      }
+  SmallU16String<32> R{};
+  if (str.isASCII()) {
+    const char *begin = str.castToCharPtr();
+    const char *end = begin + str.length();
+    if (findPercent(begin, end) == end) {
+      // Nothing needs to be unescaped.
+      return strPrim.getHermesValue();
     }
-    R.push_back(r);
-    ++k;
+    R.reserve(str.length());
+    unescapeChars(begin, end, R);
+  } else {
+    const char16_t *begin = str.castToChar16Ptr();
+    const char16_t *end = begin + str.length();
+    if (findPercent(begin, end) == end) {
+      return strPrim.getHermesValue();
+    }
+    R.reserve(str.length());
+    unescapeChars(begin, end, R);
   }
 
   return StringPrimitive::create(runtime, R);
 }
 
-/// Removes one character from the end of \p str.
-/// Used to remove the null terminator when UTF16Ref is constructed from
-/// literals.
-static inline UTF16Ref removeNullTerminator(const UTF16Ref str) {
-  return str.slice(0, str.size() - 1);
-}
-
-/// Function used in place of a set to indicate if \p c is in the unescaped set.
-using CharSetFn = bool (*)(char16_t c);
+/// ES 5.1 15.1.3
+/// Encode abstract method, takes the characters [cur, end) and URI encodes
+/// them to \p builder, or only counts the characters it takes if \p builder
+/// is null.
+/// \param unescapedSet the characters to not escape.
+/// \param[out] length the number of characters of the encoded string.
+/// \return false if the input is malformed.
+template <typename CharT>
+static bool encodeChars(
+    const CharT *cur,
+    const CharT *end,
+    const ASCIISet &unescapedSet,
+    SafeUInt32 &length,
+    StringBuilder *builder) {
+  for (;;) {
+    const CharT *runEnd = findFirstNotIn(cur, end, unescapedSet);
+    length.add(runEnd - cur);
+    if (builder)
+      appendASCIIRun(*builder, cur, runEnd);
+    if (runEnd == end)
+      return true;
 
-/// Is a member of uriUnescaped.
-static bool uriUnescaped(char16_t c) {
-  const UTF16Ref marks = removeNullTerminator(u"-_.!~*'()");
-  if (std::find(marks.begin(), marks.end(), c) != marks.end()) {
-    return true;
-  }
-  if (u'0' <= c && c <= u'9') {
-    return true;
+    cur = runEnd;
+    // Use int32_t to allow for arithmetic past 16 bits.
+    uint32_t C = *cur++;
+    if (C >= 0xdc00 && C <= 0xdfff) {
+      return false;
+    }
+    // Code point to convert to UTF8.
+    uint32_t V;
+    if (C < 0xd800 || C > 0xdbff) {
+      V = C;
+    } else {
+      if (cur == end) {
+        return false;
+      }
+      uint32_t kChar = *cur++;
+      if (kChar < 0xdc00 || kChar > 0xdfff) {
+        return false;
+      }
+      V = (C - 0xd800) * 0x400 + (kChar - 0xdc00) + 0x10000;
+    }
+    char octets[UNI_MAX_UTF8_BYTES_PER_CODE_POINT];
+    char *targetStart = octets;
+    hermes::encodeUTF8(targetStart, V);
+    // Length of the octets array.
+    uint32_t L = targetStart - octets;
+    length.add(3 * L);
+    if (!builder)
+      continue;
+    for (uint32_t j = 0; j < L; ++j) {
+      auto jOctet = octets[j];
+      char buf[] = {
+          '%', toHexChar((jOctet >> 4) & 0xf), toHexChar(jOctet & 0xf)};
+      builder->appendASCIIRef(buf);
+    }
   }
-  // Convert to lowercase and see if it's alphabetic.
-  c |= 32;
-  return u'a' <= c && c <= u'z';
-}
-
-/// Is a member of uriReserved.
-static bool uriReserved(char16_t c) {
-  const UTF16Ref reserved = removeNullTerminator(u";/?:@&=+$,");
-  return std::find(reserved.begin(), reserved.end(), c) != reserved.end();
-}
-
-/// Is a member of uriUnescaped plus '#', or is a member of uriReserved.
-static bool unescapedURISet(char16_t c) {
-  return uriReserved(c) || uriUnescaped(c) || c == '#';
 }
 
-/// Is a member of uriReserved plus '#'.
-static bool reservedURISet(char16_t c) {
-  return uriReserved(c) || c == '#';
-}
-
-/// ES 5.1 15.1.3
-/// Encode abstract method, takes a string and URI encodes it.
-/// \param unescapedSet a function indicating which characters to not escape.
-static CallResult<Handle<StringPrimitive>> encode(
+/// Encode \p strHandle, escaping the characters not in \p unescapedSet.
+static CallResult<HermesValue> encode(
     Runtime *runtime,
     Handle<StringPrimitive> strHandle,
-    CharSetFn unescapedSet) {
+    const ASCIISet &unescapedSet) {
   auto str = StringPrimitive::createStringView(runtime, strHandle);
-  auto strLen = str.length();
-  SmallU16String<32> R{};
-  R.reserve(strLen);
-  for (auto itr = str.begin(), e = str.end(); itr != e;) {
-    // Use int32_t to allow for arithmetic past 16 bits.
-    uint32_t C = *itr;
-    if (unescapedSet(C)) {
-      R.push_back(C);
-    } else {
-      if (C >= 0xdc00 && C <= 0xdfff) {
-        return runtime->raiseURIError("Malformed encodeURI input");
-      }
-      // Code point to convert to UTF8.
-      uint32_t V;
-      if (C < 0xd800 || C > 0xdbff) {
-        V = C;
-      } else {
-        ++itr;
-        if (itr == e) {
-          return runtime->raiseURIError("Malformed encodeURI input");
-        }
-        uint32_t kChar = *itr;
-        if (kChar < 0xdc00 || kChar > 0xdfff) {
-          return runtime->raiseURIError("Malformed encodeURI input");
-        }
-        V = (C - 0xd800) * 0x400 + (kChar - 0xdc00) + 0x10000;
-      }
-      char octets[UNI_MAX_UTF8_BYTES_PER_CODE_POINT];
-      char *targetStart = octets;
-      hermes::encodeUTF8(targetStart, V);
-      // Length of the octets array.
-      uint32_t L = targetStart - octets;
-      for (uint32_t j = 0; j < L; ++j) {
-        auto jOctet = octets[j];
-        R.push_back(u'%');
-        R.push_back(toHexChar((jOctet >> 4) & 0xf));
-        R.push_back(toHexChar(jOctet & 0xf));
-      }
-    }
-    ++itr;
+  // Measure the result first, so that it is allocated once, and directly as
+  // an ASCII string.
+  SafeUInt32 length{0};
+  bool valid = str.isASCII()
+      ? encodeChars(
+            str.castToCharPtr(),
+            str.castToCharPtr() + str.length(),
+            unescapedSet,
+            length,
+            nullptr)
+      : encodeChars(
+            str.castToChar16Ptr(),
+            str.castToChar16Ptr() + str.length(),
+            unescapedSet,
+            length,
+            nullptr);
+  if (!valid) {
+    return runtime->raiseURIError("Malformed encodeURI input");
+  }
+  if (!length.isOverflowed() && *length == str.length()) {
+    // Nothing needs to be encoded.
+    return strHandle.getHermesValue();
   }
 
-  auto finalStr = StringPrimitive::create(runtime, R);
-  if (LLVM_UNLIKELY(finalStr == ExecutionStatus::EXCEPTION)) {
+  auto builder =
+      StringBuilder::createStringBuilder(runtime, length, /* isASCII */ true);
+  if (LLVM_UNLIKELY(builder == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  return runtime->makeHandle<StringPrimitive>(*finalStr);
+  // Nothing allocates from here on, so the pointers stay valid.
+  SafeUInt32 written{0};
+  if (str.isASCII()) {
+    encodeChars(
+        str.castToCharPtr(),
+        str.castToCharPtr() + str.length(),
+        unescapedSet,
+        written,
+        &*builder);
+  } else {
+    encodeChars(
+        str.castToChar16Ptr(),
+        str.castToChar16Ptr() + str.length(),
+        unescapedSet,
+        written,
+        &*builder);
+  }
+  return builder->getStringPrimitive().getHermesValue();
 }
 
 CallResult<HermesValue> encodeURI(void *, Runtime *runtime, NativeArgs args) {
@@ -230,11 +489,8 @@ CallResult<HermesValue> encodeURI(void *, Runtime *runtime, NativeArgs args) {
   if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto res =
-      encode(runtime, toHandle(runtime, std::move(*strRes)), unescapedURISet);
-  if (res == ExecutionStatus::EXCEPTION)
-    return ExecutionStatus::EXCEPTION;
-  return res->getHermesValue();
+  return encode(
+      runtime, toHandle(runtime, std::move(*strRes)), kUnescapedURISet);
 }
 
 CallResult<HermesValue>
@@ -243,114 +499,144 @@ encodeURIComponent(void *, Runtime *runtime, NativeArgs args) {
   if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto res =
-      encode(runtime, toHandle(runtime, std::move(*strRes)), uriUnescaped);
-  if (res == ExecutionStatus::EXCEPTION)
-    return ExecutionStatus::EXCEPTION;
-  return res->getHermesValue();
+  return encode(
+      runtime, toHandle(runtime, std::move(*strRes)), kURIUnescapedSet);
 }
 
 /// ES 5.1 15.1.3
-/// Decode abstract method, takes a string and URI decodes it.
-/// \param reservedSet a function indicating which characters to not escape.
-static CallResult<Handle<StringPrimitive>> decode(
-    Runtime *runtime,
-    Handle<StringPrimitive> strHandle,
-    CharSetFn reservedSet) {
-  auto str = StringPrimitive::createStringView(runtime, strHandle);
-  auto strLen = str.length();
-  SmallU16String<32> R{};
-  R.reserve(strLen);
-  for (auto itr = str.begin(), e = str.end(); itr != e;) {
-    char16_t C = *itr;
-    if (C != u'%') {
-      // Regular character, continue.
-      R.push_back(C);
+/// Decode abstract method, takes the characters [begin, end) and URI decodes
+/// them, appending the result to \p R.
+/// \param reservedSet the characters to leave escaped.
+/// \return false if the input is malformed.
+template <typename CharT>
+static bool decodeChars(
+    const CharT *begin,
+    const CharT *end,
+    const ASCIISet &reservedSet,
+    SmallU16String<32> &R) {
+  for (auto itr = begin;;) {
+    // Copy the run of characters up to the next escape at once.
+    auto runEnd = findPercent(itr, end);
+    R.append(itr, runEnd);
+    if (runEnd == end)
+      return true;
+
+    itr = runEnd;
+    char16_t C;
+    auto start = itr;
+    if (itr + 2 >= end || !(isHexChar(*(itr + 1)) && isHexChar(*(itr + 2)))) {
+      return false;
+    }
+    uint8_t B = (fromHexChar(*(itr + 1)) << 4) | fromHexChar(*(itr + 2));
+    itr += 2;
+    if ((B & 0x80) == 0) {
+      // Most significant bit of B is 0.
+      C = B;
+      if (!reservedSet.contains(C)) {
+        R.push_back(C);
+      } else {
+        R.append(start, itr + 1);
+      }
     } else {
-      auto start = itr;
-      if (itr + 2 >= e || !(isHexChar(*(itr + 1)) && isHexChar(*(itr + 2)))) {
-        return runtime->raiseURIError("Malformed decodeURI input");
+      // Most significant bit of B is 1.
+      uint32_t n = 0;
+      // Set n to be smallest such that (B << n) & 0x80 is 0.
+      // n is set to the number of leading 1s in B.
+      for (; n <= 8 && (((B << n) & 0x80) != 0); ++n) {
       }
-      uint8_t B = (fromHexChar(*(itr + 1)) << 4) | fromHexChar(*(itr + 2));
-      itr += 2;
-      if ((B & 0x80) == 0) {
-        // Most significant bit of B is 0.
-        C = B;
-        if (!reservedSet(C)) {
-          R.push_back(C);
-        } else {
-          R.insert(R.end(), start, itr + 1);
-        }
-      } else {
-        // Most significant bit of B is 1.
-        uint32_t n = 0;
-        // Set n to be smallest such that (B << n) & 0x80 is 0.
-        // n is set to the number of leading 1s in B.
-        for (; n <= 8 && (((B << n) & 0x80) != 0); ++n) {
-        }
-        if (n == 1 || n > 4) {
-          return runtime->raiseURIError("Malformed decodeURI input");
-        }
-        // Safe because we ensure that n <= 4.
-        UTF8 octets[4]{B};
-        // Not enough bytes to fill all n octets.
-        if ((itr + (3 * (n - 1))) >= e) {
-          return runtime->raiseURIError("Malformed decodeURI input");
-        }
-        // Populate octets.
-        for (uint32_t j = 1; j < n; ++j) {
-          ++itr;
-          if (*itr != u'%' ||
-              !(isHexChar(*(itr + 1)) && isHexChar(*(itr + 2)))) {
-            return runtime->raiseURIError("Malformed decodeURI input");
-          }
-          B = (fromHexChar(*(itr + 1)) << 4) | fromHexChar(*(itr + 2));
-          if (((B >> 6) & 0x3) != 0x2) {
-            // The highest two bits aren't 10.
-            return runtime->raiseURIError("Malformed decodeURI input");
-          }
-          itr += 2;
-          octets[j] = B;
+      if (n == 1 || n > 4) {
+        return false;
+      }
+      // Safe because we ensure that n <= 4.
+      UTF8 octets[4]{B};
+      // Not enough bytes to fill all n octets.
+      if ((itr + (3 * (n - 1))) >= end) {
+        return false;
+      }
+      // Populate octets.
+      for (uint32_t j = 1; j < n; ++j) {
+        ++itr;
+        if (*itr != u'%' ||
+            !(isHexChar(*(itr + 1)) && isHexChar(*(itr + 2)))) {
+          return false;
         }
-        // Code point encoded by the n octets.
-        uint32_t V;
-        const UTF8 *sourceStart = octets;
-        const UTF8 *sourceEnd = octets + n;
-        UTF32 *targetStart = &V;
-        UTF32 *targetEnd = &V + 1;
-        ConversionResult cRes = ConvertUTF8toUTF32(
-            &sourceStart,
-            sourceEnd,
-            &targetStart,
-            targetEnd,
-            llvm::strictConversion);
-        if (cRes != ConversionResult::conversionOK) {
-          return runtime->raiseURIError("Malformed decodeURI input");
+        B = (fromHexChar(*(itr + 1)) << 4) | fromHexChar(*(itr + 2));
+        if (((B >> 6) & 0x3) != 0x2) {
+          // The highest two bits aren't 10.
+          return false;
         }
-        if (V < 0x10000) {
-          // Safe to cast.
-          C = static_cast<char16_t>(V);
-          if (!reservedSet(C)) {
-            R.push_back(C);
-          } else {
-            R.insert(R.end(), start, itr + 1);
-          }
+        itr += 2;
+        octets[j] = B;
+      }
+      // Code point encoded by the n octets.
+      uint32_t V;
+      const UTF8 *sourceStart = octets;
+      const UTF8 *sourceEnd = octets + n;
+      UTF32 *targetStart = &V;
+      UTF32 *targetEnd = &V + 1;
+      ConversionResult cRes = ConvertUTF8toUTF32(
+          &sourceStart,
+          sourceEnd,
+          &targetStart,
+          targetEnd,
+          llvm::strictConversion);
+      if (cRes != ConversionResult::conversionOK) {
+        return false;
+      }
+      if (V < 0x10000) {
+        // Safe to cast.
+        C = static_cast<char16_t>(V);
+        if (!reservedSet.contains(C)) {
+          R.push_back(C);
         } else {
-          // V >= 0x10000
-          // Notice that L and H are both only 2 byte values,
-          // because of they way that they're computed.
-          char16_t L = ((V - 0x10000) & 0x3ff) + 0xdc00;
-          char16_t H = (((V - 0x10000) >> 10) & 0x3ff) + 0xd800;
-          R.push_back(H);
-          R.push_back(L);
+          R.append(start, itr + 1);
         }
+      } else {
+        // V >= 0x10000
+        // Notice that L and H are both only 2 byte values,
+        // because of they way that they're computed.
+        char16_t L = ((V - 0x10000) & 0x3ff) + 0xdc00;
+        char16_t H = (((V - 0x10000) >> 10) & 0x3ff) + 0xd800;
+        R.push_back(H);
+        R.push_back(L);
       }
     }
     ++itr;
   }
+}
 
-  return runtime->makeHandle<StringPrimitive>(
-      *StringPrimitive::create(runtime, R));
+/// Decode \p strHandle, leaving the escapes of the characters in
+/// \p reservedSet.
+static CallResult<HermesValue> decode(
+    Runtime *runtime,
+    Handle<StringPrimitive> strHandle,
+    const ASCIISet &reservedSet) {
+  auto str = StringPrimitive::createStringView(runtime, strHandle);
+  SmallU16String<32> R{};
+  bool valid;
+  if (str.isASCII()) {
+    const char *begin = str.castToCharPtr();
+    const char *end = begin + str.length();
+    if (findPercent(begin, end) == end) {
+      // Nothing needs to be decoded.
+      return strHandle.getHermesValue();
+    }
+    R.reserve(str.length());
+    valid = decodeChars(begin, end, reservedSet, R);
+  } else {
+    const char16_t *begin = str.castToChar16Ptr();
+    const char16_t *end = begin + str.length();
+    if (findPercent(begin, end) == end) {
+      return strHandle.getHermesValue();
+    }
+    R.reserve(str.length());
+    valid = decodeChars(begin, end, reservedSet, R);
+  }
+  if (!valid) {
+    return runtime->raiseURIError("Malformed decodeURI input");
+  }
+
+  return StringPrimitive::create(runtime, R);
 }
 
 CallResult<HermesValue> decodeURI(void *, Runtime *runtime, NativeArgs args) {
@@ -358,11 +644,8 @@ CallResult<HermesValue> decodeURI(void *, Runtime *runtime, NativeArgs args) {
   if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto res =
-      decode(runtime, toHandle(runtime, std::move(*strRes)), reservedURISet);
-  if (res == ExecutionStatus::EXCEPTION)
-    return ExecutionStatus::EXCEPTION;
-  return res->getHermesValue();
+  return decode(
+      runtime, toHandle(runtime, std::move(*strRes)), kReservedURISet);
 }
 
 CallResult<HermesValue>
@@ -371,11 +654,7 @@ decodeURIComponent(void *, Runtime *runtime, NativeArgs args) {
   if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto emptySet = [](char16_t) { return false; };
-  auto res = decode(runtime, toHandle(runtime, std::move(*strRes)), emptySet);
-  if (res == ExecutionStatus::EXCEPTION)
-    return ExecutionStatus::EXCEPTION;
-  return res->getHermesValue();
+  return decode(runtime, toHandle(runtime, std::move(*strRes)), kEmptySet);
 }
 
 } // namespace vm
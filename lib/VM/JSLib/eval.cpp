@@ -61,47 +61,69 @@ CallResult<HermesValue> evalInEnvironment(
   if (!runtime->enableEval) {
     return runtime->raiseEvalUnsupported(utf8code);
   }
-  CodeGenerationSettings codeGenOpts;
-  codeGenOpts.unlimitedRegisters = false;
-  auto context = std::make_shared<Context>(codeGenOpts);
-
-  SimpleDiagHandlerRAII evalOutputManager{context->getSourceErrorManager()};
-  // The spec requires that global eval always start in non-strict mode.
-  context->setStrictMode(false);
-  context->setEnableEval(true);
-
-// Generate full debug info if the debugger is present, otherwise generate
-// enough for backtraces.
+  // Code compiled without a scope chain only depends on its source, so its
+  // bytecode can be reused. Not when the debugger is compiled in: it installs
+  // breakpoints by patching the bytecode of each CodeBlock, which must then
+  // not be shared with other RuntimeModules.
 #ifdef HERMES_ENABLE_DEBUGGER
-  context->setDebugInfoSetting(DebugInfoSetting::ALL);
+  const bool cacheable = false;
 #else
-  context->setDebugInfoSetting(DebugInfoSetting::THROWING);
+  const bool cacheable = scopeChain.functions.empty();
 #endif
-  sem::SemContext semCtx{};
-  hermes::parser::JSParser jsParser(*context, utf8code);
-  auto parsed = jsParser.parse();
-  if (!parsed || !validateAST(*context, semCtx, *parsed)) {
-    auto msg = evalOutputManager.getFirstMessage();
-    return runtime->raiseSyntaxError(
-        TwineChar16(msg.getLineNo()) + ":" + (msg.getColumnNo() + 1) + ":" +
-        msg.getMessage());
-  }
-  auto *ast = parsed.getValue();
-  // Check to see if we're only allowed to have a single function.
-  if (singleFunction && !isSingleFunctionExpression(ast)) {
-    return runtime->raiseSyntaxError("Invalid function expression");
+  std::shared_ptr<hbc::BCProvider> bytecode;
+  if (cacheable) {
+    bytecode = runtime->getEvalCache().lookup(utf8code, singleFunction);
   }
 
-  Module M(context);
-
-  DeclarationFileListTy declFileList;
-  hermes::generateIRFromESTree(ast, &M, declFileList, scopeChain);
-
-  auto bytecodeOptions = BytecodeGenerationOptions::defaults();
-  bytecodeOptions.verifyIR = runtime->verifyEvalIR;
-  auto bytecode = hbc::BCProviderFromSrc::createBCProviderFromSrc(
-      hbc::generateBytecodeModule(
-          &M, M.getTopLevelFunction(), bytecodeOptions));
+  // The AST, the IR and the Context which owns them are only needed until
+  // the bytecode is generated. Free them before running it, so that the code
+  // it runs, including nested calls to eval(), does not keep them alive.
+  if (!bytecode) {
+    CodeGenerationSettings codeGenOpts;
+    codeGenOpts.unlimitedRegisters = false;
+    auto context = std::make_shared<Context>(codeGenOpts);
+
+    SimpleDiagHandlerRAII evalOutputManager{context->getSourceErrorManager()};
+    // The spec requires that global eval always start in non-strict mode.
+    context->setStrictMode(false);
+    context->setEnableEval(true);
+
+    // Generate full debug info if the debugger is present, otherwise generate
+    // enough for backtraces.
+#ifdef HERMES_ENABLE_DEBUGGER
+    context->setDebugInfoSetting(DebugInfoSetting::ALL);
+#else
+    context->setDebugInfoSetting(DebugInfoSetting::THROWING);
+#endif
+    sem::SemContext semCtx{};
+    hermes::parser::JSParser jsParser(*context, utf8code);
+    auto parsed = jsParser.parse();
+    if (!parsed || !validateAST(*context, semCtx, *parsed)) {
+      auto msg = evalOutputManager.getFirstMessage();
+      return runtime->raiseSyntaxError(
+          TwineChar16(msg.getLineNo()) + ":" + (msg.getColumnNo() + 1) + ":" +
+          msg.getMessage());
+    }
+    auto *ast = parsed.getValue();
+    // Check to see if we're only allowed to have a single function.
+    if (singleFunction && !isSingleFunctionExpression(ast)) {
+      return runtime->raiseSyntaxError("Invalid function expression");
+    }
+
+    Module M(context);
+
+    DeclarationFileListTy declFileList;
+    hermes::generateIRFromESTree(ast, &M, declFileList, scopeChain);
+
+    auto bytecodeOptions = BytecodeGenerationOptions::defaults();
+    bytecodeOptions.verifyIR = runtime->verifyEvalIR;
+    bytecode = hbc::BCProviderFromSrc::createBCProviderFromSrc(
+        hbc::generateBytecodeModule(
+            &M, M.getTopLevelFunction(), bytecodeOptions));
+    if (cacheable) {
+      runtime->getEvalCache().insert(utf8code, singleFunction, bytecode);
+    }
+  }
 
   // TODO: pass a sourceURL derived from a '//# sourceURL' comment.
   llvm::StringRef sourceURL{};
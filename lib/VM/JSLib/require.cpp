@@ -42,6 +42,9 @@ CallResult<HermesValue> runRequireCall(
 
   GCScope gcScope{runtime};
   // If not initialized yet, start initializing and set the module object.
+  // The modules it requires are about to be initialized too, so get their
+  // bytecode read in while this one runs.
+  domain->prefetchCJSModuleDependencies(runtime, cjsModuleOffset);
   Handle<JSObject> module = toHandle(runtime, JSObject::create(runtime));
   Handle<JSObject> exports = toHandle(runtime, JSObject::create(runtime));
   if (LLVM_UNLIKELY(
@@ -151,11 +154,41 @@ CallResult<HermesValue> requireFast(void *, Runtime *runtime, NativeArgs args) {
     return runtime->raiseTypeError(
         TwineChar16("Unable to find module with ID: ") + index);
   }
-  return runRequireCall(
-      runtime,
-      runtime->makeNullHandle<RequireContext>(),
-      domain,
-      *cjsModuleOffset);
+  {
+    auto cachedExports = domain->getCachedExports(runtime, *cjsModuleOffset);
+    if (LLVM_LIKELY(!cachedExports->isEmpty())) {
+      // Fast path: require() completed, so just return exports immediately.
+      return cachedExports.getHermesValue();
+    }
+  }
+
+  // If only some of the requires could be resolved, the modules still need a
+  // working require() for the others.
+  OptValue<SymbolID> filename =
+      domain->getCJSModuleFilenameMayAllocate(runtime, *cjsModuleOffset);
+  if (!filename) {
+    return runRequireCall(
+        runtime,
+        runtime->makeNullHandle<RequireContext>(),
+        domain,
+        *cjsModuleOffset);
+  }
+  GCScope gcScope{runtime};
+  auto filenameStr = runtime->makeHandle(
+      runtime->getIdentifierTable().getStringPrim(runtime, *filename));
+  SmallU16String<32> u16String{};
+  filenameStr->copyUTF16String(u16String);
+  std::string dirname{};
+  hermes::convertUTF16ToUTF8WithReplacements(dirname, u16String);
+  llvm::SmallString<32> dirnamePath{dirname};
+  llvm::sys::path::remove_filename(dirnamePath, llvm::sys::path::Style::posix);
+  auto dirnameRes = StringPrimitive::create(runtime, dirnamePath);
+  if (LLVM_UNLIKELY(dirnameRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto context = RequireContext::create(
+      runtime, domain, runtime->makeHandle<StringPrimitive>(*dirnameRes));
+  return runRequireCall(runtime, context, domain, *cjsModuleOffset);
 }
 
 static llvm::SmallString<32> canonicalizePath(
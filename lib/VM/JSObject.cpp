@@ -283,6 +283,55 @@ void JSObject::addInternalProperties(
   }
 }
 
+bool JSObject::tryCloneOwnProperties(
+    Handle<JSObject> target,
+    Runtime *runtime,
+    Handle<JSObject> source) {
+  // Only ordinary objects are guaranteed to have no indexed storage and no
+  // properties managed outside of their class.
+  if (target->getKind() != CellKind::ObjectKind ||
+      source->getKind() != CellKind::ObjectKind || !target->isExtensible() ||
+      target->flags_.lazyObject || target->flags_.hostObject ||
+      source->flags_.lazyObject || source->flags_.hostObject) {
+    return false;
+  }
+  HiddenClass *targetClazz = target->clazz_.getNonNull(runtime);
+  HiddenClass *sourceClazz = source->clazz_.getNonNull(runtime);
+  if (targetClazz->getNumProperties() != 0 || targetClazz->isDictionary() ||
+      sourceClazz->isDictionary() || !sourceClazz->hasOnlyDefaultProperties()) {
+    return false;
+  }
+
+  // Slots are allocated in order in a class that is not a dictionary, so the
+  // first numProps of them are exactly the properties of the class.
+  const unsigned numProps = sourceClazz->getNumProperties();
+  if (numProps > DIRECT_PROPERTY_SLOTS) {
+    runtime->ignoreAllocationFailure(
+        allocatePropStorage(target, runtime, numProps));
+  }
+  const unsigned numDirect = std::min<unsigned>(numProps, DIRECT_PROPERTY_SLOTS);
+  GC *gc = &runtime->getHeap();
+  GCHermesValue::copy(
+      source->directProps_,
+      source->directProps_ + numDirect,
+      target->directProps_,
+      gc);
+  if (numProps > DIRECT_PROPERTY_SLOTS) {
+    PropStorage *from = source->propStorage_.getNonNull(runtime);
+    GCHermesValue::copy(
+        from->data(),
+        from->data() + (numProps - DIRECT_PROPERTY_SLOTS),
+        target->propStorage_.getNonNull(runtime)->data(),
+        gc);
+  }
+
+  target->clazz_.set(runtime, source->clazz_.getNonNull(runtime), gc);
+  if (LLVM_UNLIKELY(
+          target->clazz_.getNonNull(runtime)->getHasIndexLikeProperties()))
+    target->flags_.fastIndexProperties = false;
+  return true;
+}
+
 CallResult<HermesValue> JSObject::getNamedPropertyValue(
     Handle<JSObject> selfHandle,
     Runtime *runtime,
@@ -829,6 +878,38 @@ ExecutionStatus JSObject::getComputedDescriptor(
   return ExecutionStatus::RETURNED;
 }
 
+void JSObject::cachePrototypeHolder(
+    JSObject *self,
+    Runtime *runtime,
+    JSObject *holder,
+    SlotIndex slot,
+    PropertyCacheEntry *cacheEntry,
+    bool accessor) {
+  assert((accessor || holder != self) && "own data properties aren't cached");
+  HiddenClass *receiverClazz = self->getClass(runtime);
+  if (receiverClazz->isDictionary() || self->flags_.lazyObject ||
+      self->flags_.hostObject) {
+    return;
+  }
+  PrototypeCacheEntry newEntry;
+  JSObject *obj = self;
+  while (obj != holder) {
+    obj = obj->getParent(runtime);
+    if (!obj || newEntry.depth == PrototypeCacheEntry::kMaxDepth)
+      return;
+    HiddenClass *clazz = obj->getClass(runtime);
+    if (clazz->isDictionary() || obj->flags_.lazyObject ||
+        obj->flags_.hostObject) {
+      return;
+    }
+    newEntry.chainClazz[newEntry.depth++] = clazz;
+  }
+  newEntry.receiverClazz = receiverClazz;
+  newEntry.slot = slot;
+  newEntry.accessor = accessor;
+  cacheEntry->getOrCreateExtension().proto = newEntry;
+}
+
 CallResult<HermesValue> JSObject::getNamed_RJS(
     Handle<JSObject> selfHandle,
     Runtime *runtime,
@@ -853,13 +934,25 @@ CallResult<HermesValue> JSObject::getNamed_RJS(
   if (LLVM_LIKELY(!desc.flags.accessor && !desc.flags.hostObject)) {
     // Populate the cache if requested.
     if (cacheEntry && !propObj->getClass(runtime)->isDictionary()) {
-      cacheEntry->clazz = propObj->getClass(runtime);
-      cacheEntry->slot = desc.slot;
+      if (propObj == *selfHandle)
+        cacheEntry->update(propObj->getClass(runtime), desc.slot);
+      else
+        cachePrototypeHolder(
+            *selfHandle, runtime, propObj, desc.slot, cacheEntry);
     }
     return getNamedSlotValue(propObj, runtime, desc);
   }
 
   if (desc.flags.accessor) {
+    if (cacheEntry && !propObj->getClass(runtime)->isDictionary()) {
+      cachePrototypeHolder(
+          *selfHandle,
+          runtime,
+          propObj,
+          desc.slot,
+          cacheEntry,
+          /* accessor */ true);
+    }
     auto *accessor =
         vmcast<PropertyAccessor>(getNamedSlotValue(propObj, runtime, desc));
     if (!accessor->getter)
@@ -1048,7 +1141,8 @@ CallResult<bool> JSObject::putNamed_RJS(
     Runtime *runtime,
     SymbolID name,
     Handle<> valueHandle,
-    PropOpFlags opFlags) {
+    PropOpFlags opFlags,
+    PropertyCacheEntry *cacheEntry) {
   NamedPropertyDescriptor desc;
 
   // Look for the property in this object or along the prototype chain.
@@ -1075,6 +1169,16 @@ CallResult<bool> JSObject::putNamed_RJS(
         return false;
       }
 
+      if (cacheEntry && !propObj->getClass(runtime)->isDictionary()) {
+        cachePrototypeHolder(
+            *selfHandle,
+            runtime,
+            propObj,
+            desc.slot,
+            cacheEntry,
+            /* accessor */ true);
+      }
+
       // Execute the accessor on this object.
       if (accessor->setter.get(runtime)->executeCall1(
               runtime->makeHandle(accessor->setter),
@@ -1507,6 +1611,28 @@ CallResult<bool> JSObject::deleteComputed(
   return true;
 }
 
+/// \return the flags of a property added by \c addOwnProperty() with \p
+/// dpFlags.
+static PropertyFlags newPropertyFlags(DefinePropertyFlags dpFlags) {
+  PropertyFlags flags{};
+
+  // Accessors don't set writeable.
+  if (dpFlags.isAccessor()) {
+    dpFlags.setWritable = 0;
+    flags.accessor = 1;
+  }
+
+  // Override the default flags if specified.
+  if (dpFlags.setEnumerable)
+    flags.enumerable = dpFlags.enumerable;
+  if (dpFlags.setWritable)
+    flags.writable = dpFlags.writable;
+  if (dpFlags.setConfigurable)
+    flags.configurable = dpFlags.configurable;
+  flags.internalSetter = dpFlags.enableInternalSetter;
+  return flags;
+}
+
 CallResult<bool> JSObject::defineOwnProperty(
     Handle<JSObject> selfHandle,
     Runtime *runtime,
@@ -1533,9 +1659,13 @@ CallResult<bool> JSObject::defineOwnProperty(
   }
 #endif
 
-  // Is it an existing property.
+  // Is it an existing property. Pass the flags it would be added with: if the
+  // class already has a transition adding it, the property is known to be new
+  // without building the property map, which is what happens when many objects
+  // are created with the same properties (e.g. by JSON.parse()).
   NamedPropertyDescriptor desc;
-  auto pos = findProperty(selfHandle, runtime, name, desc);
+  auto pos =
+      findProperty(selfHandle, runtime, name, newPropertyFlags(dpFlags), desc);
   if (pos) {
     return updateOwnProperty(
         selfHandle,
@@ -1904,6 +2034,56 @@ void JSObject::updatePropertyFlagsWithoutTransitions(
   selfHandle->clazz_.set(runtime, *newClazz, &runtime->getHeap());
 }
 
+ExecutionStatus JSObject::leaveDictionaryMode(
+    Handle<JSObject> selfHandle,
+    Runtime *runtime) {
+  auto clazz = runtime->makeHandle(selfHandle->clazz_);
+  if (!clazz->isDictionary() || selfHandle->flags_.lazyObject ||
+      selfHandle->flags_.hostObject ||
+      clazz->getNumProperties() > HiddenClass::kDictionaryThreshold)
+    return ExecutionStatus::RETURNED;
+
+  GCScope gcScope{runtime};
+
+  // Collect the properties in enumeration order. Their SymbolIDs are kept
+  // alive by the dictionary class, which stays reachable through \c clazz.
+  llvm::SmallVector<std::pair<SymbolID, NamedPropertyDescriptor>, 16> props;
+  HiddenClass::forEachProperty(
+      clazz, runtime, [&props](SymbolID id, NamedPropertyDescriptor desc) {
+        props.emplace_back(id, desc);
+      });
+
+  // Replay the additions from the root class. Properties get consecutive
+  // slots in the new class, so the values have to be moved afterwards.
+  MutableHandle<HiddenClass> newClazz{
+      runtime,
+      runtime->getHiddenClassForPrototypeRaw(selfHandle->getParent(runtime))};
+  auto marker = gcScope.createMarker();
+  for (const auto &prop : props) {
+    auto addResult = HiddenClass::addProperty(
+        newClazz, runtime, prop.first, prop.second.flags);
+    if (LLVM_UNLIKELY(addResult == ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+    if (addResult->first->isDictionary())
+      return ExecutionStatus::RETURNED;
+    newClazz = *addResult->first;
+    gcScope.flushToMarker(marker);
+  }
+
+  // Nothing below allocates, so the values can be held unrooted. The new class
+  // uses the first props.size() slots, and the old one used at least as many,
+  // so the storage is already large enough.
+  llvm::SmallVector<HermesValue, 16> values;
+  for (const auto &prop : props)
+    values.push_back(getNamedSlotValue(*selfHandle, runtime, prop.second));
+
+  selfHandle->clazz_.set(runtime, *newClazz, &runtime->getHeap());
+  for (SlotIndex i = 0, e = values.size(); i != e; ++i)
+    setNamedSlotValue(*selfHandle, runtime, i, values[i]);
+
+  return ExecutionStatus::RETURNED;
+}
+
 bool JSObject::isSealed(PseudoHandle<JSObject> self, Runtime *runtime) {
   if (self->flags_.sealed)
     return true;
@@ -1972,26 +2152,13 @@ CallResult<bool> JSObject::addOwnProperty(
     return false;
   }
 
-  PropertyFlags flags{};
-
-  // Accessors don't set writeable.
-  if (dpFlags.isAccessor()) {
-    dpFlags.setWritable = 0;
-    flags.accessor = 1;
-  }
-
-  // Override the default flags if specified.
-  if (dpFlags.setEnumerable)
-    flags.enumerable = dpFlags.enumerable;
-  if (dpFlags.setWritable)
-    flags.writable = dpFlags.writable;
-  if (dpFlags.setConfigurable)
-    flags.configurable = dpFlags.configurable;
-  flags.internalSetter = dpFlags.enableInternalSetter;
-
   if (LLVM_UNLIKELY(
           addOwnPropertyImpl(
-              selfHandle, runtime, name, flags, valueOrAccessor) ==
+              selfHandle,
+              runtime,
+              name,
+              newPropertyFlags(dpFlags),
+              valueOrAccessor) ==
           ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
@@ -2476,6 +2643,14 @@ CallResult<Handle<BigStorage>> getForInPropertyNames(
   return arr;
 }
 
+bool isForInCacheValid(
+    Runtime *runtime,
+    Handle<JSObject> obj,
+    Handle<BigStorage> arr) {
+  return obj->getClass(runtime)->getForInCache(runtime) == *arr &&
+      matchesProtoClasses(runtime, obj, arr);
+}
+
 //===----------------------------------------------------------------------===//
 // class PropertyAccessor
 
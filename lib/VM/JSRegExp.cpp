@@ -75,6 +75,10 @@ ExecutionStatus JSRegExp::initialize(
     return ExecutionStatus::EXCEPTION;
   }
   selfHandle->flagBits_ = *fbits;
+#ifdef HERMESVM_JIT
+  selfHandle->searchCount_ = 0;
+  selfHandle->jitCode_.reset();
+#endif
 
   JSObject::setInternalProperty(
       selfHandle.get(),
@@ -115,6 +119,13 @@ ExecutionStatus JSRegExp::initialize(
     llvm::SmallVector<char16_t, 16> patternText16;
     patternText.copyUTF16String(patternText16);
 
+    // Reuse the bytecode if the same pattern was compiled before.
+    RegExpCache &cache = runtime->getRegExpCache();
+    if (auto cached = cache.lookup(patternText16, nativeFlags)) {
+      selfHandle->bytecode_ = *cached;
+      return ExecutionStatus::RETURNED;
+    }
+
     // Build the regex.
     regex::Regex<regex::U16RegexTraits> regex(
         patternText16.begin(), patternText16.end(), nativeFlags);
@@ -126,7 +137,9 @@ ExecutionStatus JSRegExp::initialize(
       return ExecutionStatus::EXCEPTION;
     }
     // The regex is valid. Compile and store its bytecode.
-    selfHandle->bytecode_ = llvm::makeArrayRef(regex.compile());
+    std::vector<uint8_t> compiled = regex.compile();
+    selfHandle->bytecode_ = llvm::makeArrayRef(compiled);
+    cache.insert(patternText16, nativeFlags, std::move(compiled));
   }
 
   return ExecutionStatus::RETURNED;
@@ -169,21 +182,50 @@ Handle<StringPrimitive> JSRegExp::getPattern(
           .getString());
 }
 
+const JITCompiledRegExp *JSRegExp::getJITCode(
+    JSRegExp *self,
+    Runtime *runtime) {
+#ifdef HERMESVM_JIT
+  if (self->jitCode_)
+    return self->jitCode_.get();
+  JITContext &jitContext = runtime->getJITContext();
+  if (!jitContext.isEnabled() ||
+      self->searchCount_ > JITCompiledRegExp::kSearchThreshold)
+    return nullptr;
+  if (++self->searchCount_ <= JITCompiledRegExp::kSearchThreshold)
+    return nullptr;
+  // Compile only once: if the program can't be compiled, the count stays
+  // above the threshold and the bytecode is interpreted from now on.
+  self->jitCode_ = JITCompiledRegExp::compile(jitContext, self->bytecode_);
+  return self->jitCode_.get();
+#else
+  return nullptr;
+#endif
+}
+
+/// Search with \p jitCode if it is not null, and by interpreting \p bytecode
+/// otherwise.
 template <typename CharT, typename Traits>
 CallResult<RegExpMatch> performSearch(
     Runtime *runtime,
     llvm::ArrayRef<uint8_t> bytecode,
+    const JITCompiledRegExp *jitCode,
     const CharT *start,
     uint32_t stringLength,
     uint32_t searchStartOffset,
     regex::constants::MatchFlagType matchFlags) {
   regex::MatchResults<const CharT *> nativeMatchRanges;
-  auto matchResult = regex::searchWithBytecode(
-      bytecode,
-      start + searchStartOffset,
-      start + stringLength,
-      nativeMatchRanges,
-      matchFlags);
+  auto matchResult = jitCode ? jitCode->search(
+                                   start + searchStartOffset,
+                                   start + stringLength,
+                                   nativeMatchRanges,
+                                   matchFlags)
+                             : regex::searchWithBytecode(
+                                   bytecode,
+                                   start + searchStartOffset,
+                                   start + stringLength,
+                                   nativeMatchRanges,
+                                   matchFlags);
   if (matchResult == regex::MatchRuntimeResult::StackOverflow) {
     runtime->raiseRangeError("Maximum regex stack depth reached");
     return ExecutionStatus::EXCEPTION;
@@ -231,12 +273,14 @@ CallResult<RegExpMatch> JSRegExp::search(
     matchFlags |= regex::constants::matchPreviousCharAvailable;
   }
 
+  const JITCompiledRegExp *jitCode = getJITCode(*selfHandle, runtime);
   CallResult<RegExpMatch> matchResult = RegExpMatch{};
   if (input.isASCII()) {
     matchFlags |= regex::constants::matchInputAllAscii;
     matchResult = performSearch<char, regex::ASCIIRegexTraits>(
         runtime,
         selfHandle->bytecode_,
+        jitCode,
         input.castToCharPtr(),
         input.length(),
         searchStartOffset,
@@ -245,6 +289,7 @@ CallResult<RegExpMatch> JSRegExp::search(
     matchResult = performSearch<char16_t, regex::U16RegexTraits>(
         runtime,
         selfHandle->bytecode_,
+        jitCode,
         input.castToChar16Ptr(),
         input.length(),
         searchStartOffset,
@@ -166,6 +166,43 @@ ExecutionStatus JSTypedArrayBase::setToCopyOfBuffer(
   return ExecutionStatus::RETURNED;
 }
 
+namespace {
+
+/// Store \p count elements of \p src, starting at \p srcIndex, to \p dst,
+/// converting them to the element type of \p DstArray like storing the number
+/// read from each of them would, but without going through HermesValues.
+template <typename DstArray, typename SrcArray>
+void convertElements(
+    typename DstArray::iterator dst,
+    SrcArray *src,
+    JSTypedArrayBase::size_type srcIndex,
+    JSTypedArrayBase::size_type count) {
+  auto *from = src->begin() + srcIndex;
+  for (JSTypedArrayBase::size_type i = 0; i != count; ++i)
+    dst[i] = DstArray::toDestType(from[i]);
+}
+
+/// Dispatch convertElements() on the kind of \p src.
+template <typename DstArray>
+void convertElementsFrom(
+    typename DstArray::iterator dst,
+    JSTypedArrayBase *src,
+    JSTypedArrayBase::size_type srcIndex,
+    JSTypedArrayBase::size_type count) {
+  switch (src->getKind()) {
+#define TYPED_ARRAY(name, type)                          \
+  case CellKind::name##ArrayKind:                        \
+    convertElements<DstArray>(                           \
+        dst, vmcast<name##Array>(src), srcIndex, count); \
+    break;
+#include "hermes/VM/TypedArrays.def"
+    default:
+      llvm_unreachable("Invalid TypedArray kind");
+  }
+}
+
+} // namespace
+
 ExecutionStatus JSTypedArrayBase::setToCopyOfTypedArray(
     Runtime *runtime,
     Handle<JSTypedArrayBase> dst,
@@ -188,13 +225,22 @@ ExecutionStatus JSTypedArrayBase::setToCopyOfTypedArray(
         runtime, dst, dstIndex, src, srcIndex, count);
   } else {
     // Else must do type conversions.
-    MutableHandle<> storage(runtime);
-    for (auto k = srcIndex; k < srcIndex + count; ++k) {
-      storage = JSObject::getOwnIndexed(*src, runtime, k);
-      if (JSObject::setOwnIndexed(dst, runtime, dstIndex++, storage) ==
-          ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
+    if (LLVM_UNLIKELY(!dst->attached(runtime) || !src->attached(runtime))) {
+      return runtime->raiseTypeError(
+          "Cannot set a value into a detached ArrayBuffer");
+    }
+    switch (dst->getKind()) {
+#define TYPED_ARRAY(name, type)                        \
+  case CellKind::name##ArrayKind:                      \
+    convertElementsFrom<name##Array>(                  \
+        vmcast<name##Array>(*dst)->begin() + dstIndex, \
+        *src,                                          \
+        srcIndex,                                      \
+        count);                                        \
+    break;
+#include "hermes/VM/TypedArrays.def"
+      default:
+        llvm_unreachable("Invalid TypedArray kind");
     }
   }
   return ExecutionStatus::RETURNED;
@@ -275,6 +321,10 @@ template <typename T, CellKind C>
 CallResult<Handle<JSTypedArrayBase>> JSTypedArray<T, C>::allocate(
     Runtime *runtime,
     size_type length) {
+  // The prototype is only populated once the constructor is used.
+  auto cons = JSTypedArray<T, C>::getConstructor(runtime);
+  if (LLVM_UNLIKELY(cons->isLazy()))
+    JSObject::initializeLazyObject(runtime, cons);
   auto arrRes = JSTypedArray<T, C>::create(
       runtime, JSTypedArray<T, C>::getPrototype(runtime));
   if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
@@ -124,6 +124,19 @@ void JSWeakMapImplBase::findAndDeleteFreeSlots(PointerBase *base) {
     }
   }
   hasFreeableSlots_ = false;
+
+  // Every GC iterates over all the buckets of map_, and DenseMap never
+  // shrinks by itself. Rebuild it when it is mostly empty, so that a map
+  // that was used as a large cache doesn't slow down every later GC.
+  const size_t liveSize = map_.size() * sizeof(DenseMapT::value_type);
+  if (map_.getMemorySize() > kMinShrinkSize &&
+      map_.getMemorySize() / kShrinkRatio > liveSize) {
+    DenseMapT map(map_.size());
+    for (const auto &entry : map_) {
+      map.insert(entry);
+    }
+    map_.swap(map);
+  }
 }
 
 void JSWeakMapImplBase::deleteInternal(
@@ -140,9 +153,9 @@ void JSWeakMapImplBase::deleteInternal(
 CallResult<uint32_t> JSWeakMapImplBase::getFreeValueStorageIndex(
     Handle<JSWeakMapImplBase> self,
     Runtime *runtime) {
-  if (self->freeListHead_ == kFreeListInvalid && self->hasFreeableSlots_) {
-    // No elements in the free list and there are freeable slots.
-    // Try to find some.
+  if (self->hasFreeableSlots_) {
+    // The last GC found dead keys. Delete them now rather than when the free
+    // list runs out, so that the map can shrink soon after its keys die.
     self->findAndDeleteFreeSlots(runtime);
   }
 
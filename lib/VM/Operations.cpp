@@ -44,6 +44,24 @@ CallResult<Handle<SymbolID>> valueToSymbolID(
   if (nameValHnd->isSymbol()) {
     return Handle<SymbolID>::vmcast(nameValHnd);
   }
+  // Array indices are common keys of objects used as maps. Look up their
+  // identifier directly, without allocating a string for them first.
+  if (nameValHnd->isNumber()) {
+    if (auto arrayIndex = doubleToArrayIndex(nameValHnd->getNumber())) {
+      // The largest array index, 2**32-2, has 10 digits.
+      char buf[10];
+      char *end = buf + sizeof(buf);
+      char *start = end;
+      uint32_t index = *arrayIndex;
+      do {
+        *--start = '0' + index % 10;
+        index /= 10;
+      } while (index);
+      return runtime->getIdentifierTable().getSymbolHandle(
+          runtime, ASCIIRef(start, end - start));
+    }
+  }
+
   // Convert the value to a string.
   auto res = toString_RJS(runtime, nameValHnd);
   if (res == ExecutionStatus::EXCEPTION)
@@ -92,6 +110,29 @@ HermesValue typeOf(Runtime *runtime, Handle<> valueHandle) {
   }
 }
 
+bool typeOfIs(HermesValue value, inst::TypeOfIsType type) {
+  using inst::TypeOfIsType;
+  switch (value.getTag()) {
+    case UndefinedTag:
+      return type == TypeOfIsType::Undefined;
+    case NullTag:
+      return type == TypeOfIsType::Object;
+    case StrTag:
+      return type == TypeOfIsType::String;
+    case BoolTag:
+      return type == TypeOfIsType::Boolean;
+    case SymbolTag:
+      return type == TypeOfIsType::Symbol;
+    case ObjectTag:
+      return type ==
+          (vmisa<Callable>(value) ? TypeOfIsType::Function
+                                  : TypeOfIsType::Object);
+    default:
+      assert(value.isNumber() && "Invalid type.");
+      return type == TypeOfIsType::Number;
+  }
+}
+
 OptValue<uint32_t> toArrayIndex(
     Runtime *runtime,
     Handle<StringPrimitive> strPrim) {
@@ -99,6 +140,19 @@ OptValue<uint32_t> toArrayIndex(
   return toArrayIndex(view);
 }
 
+OptValue<uint32_t> toArrayIndexFastPath(const StringPrimitive *str) {
+  uint32_t len = str->getStringLength();
+  // The largest array index, 2**32-2, has 10 digits.
+  if (len == 0 || len > 10 || !str->isFlat())
+    return llvm::None;
+  if (str->isASCII()) {
+    ASCIIRef ref = str->getStringRef<char>();
+    return hermes::toArrayIndex(ref.begin(), ref.end());
+  }
+  UTF16Ref ref = str->getStringRef<char16_t>();
+  return hermes::toArrayIndex(ref.begin(), ref.end());
+}
+
 OptValue<uint32_t> toArrayIndex(StringView str) {
   auto len = str.length();
   if (str.isASCII()) {
@@ -308,6 +362,15 @@ static CallResult<PseudoHandle<StringPrimitive>> numberToString(
   // Optimization: Fast-case for positive integers < 2^31
   int32_t n = static_cast<int32_t>(m);
   if (m == static_cast<double>(n) && n > 0) {
+    // Small integers are often converted again and again, as property keys
+    // or by String(i), so their strings are cached.
+    const bool cacheable = (uint32_t)n < Runtime::kNumCachedIntStrings;
+    if (cacheable) {
+      if (StringPrimitive *cached = runtime->getCachedIntString(n)) {
+        return createPseudoHandle(cached);
+      }
+    }
+    const uint32_t origN = n;
     // Write base 10 digits in reverse from end of buf8.
     char *p = buf8 + sizeof(buf8);
     do {
@@ -316,11 +379,17 @@ static CallResult<PseudoHandle<StringPrimitive>> numberToString(
     } while (n);
     size_t len = buf8 + sizeof(buf8) - p;
     // Temporarily stop the propagation of removing.
-    auto result = StringPrimitive::create(runtime, ASCIIRef(p, len));
+    auto result = cacheable
+        ? StringPrimitive::createLongLived(runtime, ASCIIRef(p, len))
+        : StringPrimitive::create(runtime, ASCIIRef(p, len));
     if (LLVM_UNLIKELY(result == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
-    return createPseudoHandle(vmcast<StringPrimitive>(*result));
+    auto *str = vmcast<StringPrimitive>(*result);
+    if (cacheable) {
+      runtime->setCachedIntString(origN, str);
+    }
+    return createPseudoHandle(str);
   }
 
   auto getPredefined = [runtime](Predefined::Str predefinedID) {
@@ -391,6 +460,24 @@ double parseIntWithRadix(const StringView str, int radix) {
   return res ? res.getValue() : std::numeric_limits<double>::quiet_NaN();
 }
 
+OptValue<double> parseDecimalFast(
+    const StringView str,
+    uint32_t *parsedLength) {
+  OptValue<double> res;
+  if (str.isASCII()) {
+    const char *begin = str.castToCharPtr();
+    const char *end;
+    res = hermes::parseDecimalFast(begin, begin + str.length(), &end);
+    *parsedLength = end - begin;
+  } else {
+    const char16_t *begin = str.castToChar16Ptr();
+    const char16_t *end;
+    res = hermes::parseDecimalFast(begin, begin + str.length(), &end);
+    *parsedLength = end - begin;
+  }
+  return res;
+}
+
 /// ES5.1 9.3.1
 static inline double stringToNumber(
     Runtime *runtime,
@@ -436,6 +523,13 @@ static inline double stringToNumber(
   // Trim the string.
   StringView str16 = orig.slice(begin, end);
 
+  // Most numeric strings are short decimals, which don't need dtoa.
+  uint32_t parsedLength;
+  OptValue<double> fastResult = parseDecimalFast(str16, &parsedLength);
+  if (fastResult && parsedLength == str16.length()) {
+    return *fastResult;
+  }
+
   // Slow check for special values.
   // This should only run if user created a string with extra whitespace,
   // since normal uses would get caught by the initial check.
@@ -1569,5 +1663,120 @@ CallResult<bool> isConcatSpreadable(Runtime *runtime, Handle<> value) {
   return vmisa<JSArray>(*O);
 }
 
+CallResult<HermesValue> createTemplateObject(
+    Runtime *runtime,
+    RuntimeModule *runtimeModule,
+    uint32_t templateObjID,
+    uint32_t count,
+    bool dup,
+    llvm::function_ref<HermesValue(uint32_t)> getString) {
+  GCScope gcScope{runtime};
+
+  // Create template object and raw object.
+  auto arrRes = JSArray::create(runtime, count, 0);
+  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto rawObj = runtime->makeHandle<JSObject>(arrRes->getHermesValue());
+  auto arrRes2 = JSArray::create(runtime, count, 0);
+  if (LLVM_UNLIKELY(arrRes2 == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto templateObj = runtime->makeHandle<JSObject>(arrRes2->getHermesValue());
+
+  // Set cooked and raw strings as elements in template object and raw object,
+  // respectively.
+  DefinePropertyFlags dpf{};
+  dpf.setWritable = 1;
+  dpf.setConfigurable = 1;
+  dpf.setEnumerable = 1;
+  dpf.setValue = 1;
+  dpf.writable = 0;
+  dpf.configurable = 0;
+  dpf.enumerable = 1;
+  MutableHandle<> idx{runtime};
+  MutableHandle<> rawValue{runtime};
+  MutableHandle<> cookedValue{runtime};
+  uint32_t cookedBegin = dup ? 0 : count;
+  auto marker = gcScope.createMarker();
+  for (uint32_t i = 0; i < count; ++i) {
+    idx = HermesValue::encodeNumberValue(i);
+
+    cookedValue = getString(cookedBegin + i);
+    auto putRes = JSObject::defineOwnComputedPrimitive(
+        templateObj, runtime, idx, dpf, cookedValue);
+    assert(
+        putRes != ExecutionStatus::EXCEPTION && *putRes &&
+        "Failed to set cooked value to template object.");
+
+    rawValue = getString(i);
+    putRes = JSObject::defineOwnComputedPrimitive(
+        rawObj, runtime, idx, dpf, rawValue);
+    assert(
+        putRes != ExecutionStatus::EXCEPTION && *putRes &&
+        "Failed to set raw value to raw object.");
+
+    gcScope.flushToMarker(marker);
+  }
+  // Make 'length' property on the raw object read-only.
+  DefinePropertyFlags readOnlyDPF{};
+  readOnlyDPF.setWritable = 1;
+  readOnlyDPF.setConfigurable = 1;
+  readOnlyDPF.writable = 0;
+  readOnlyDPF.configurable = 0;
+  auto readOnlyRes = JSObject::defineOwnProperty(
+      rawObj,
+      runtime,
+      Predefined::getSymbolID(Predefined::length),
+      readOnlyDPF,
+      runtime->getUndefinedValue(),
+      PropOpFlags().plusThrowOnError());
+  if (LLVM_UNLIKELY(readOnlyRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  if (LLVM_UNLIKELY(!*readOnlyRes)) {
+    return runtime->raiseTypeError(
+        "Failed to set 'length' property on the raw object read-only.");
+  }
+  JSObject::preventExtensions(rawObj.get());
+
+  // Set raw object as a read-only non-enumerable property of the template
+  // object.
+  PropertyFlags constantPF{};
+  constantPF.writable = 0;
+  constantPF.configurable = 0;
+  constantPF.enumerable = 0;
+  auto putNewRes = JSObject::defineNewOwnProperty(
+      templateObj,
+      runtime,
+      Predefined::getSymbolID(Predefined::raw),
+      constantPF,
+      rawObj);
+  if (LLVM_UNLIKELY(putNewRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  // Make 'length' property on the template object read-only.
+  readOnlyRes = JSObject::defineOwnProperty(
+      templateObj,
+      runtime,
+      Predefined::getSymbolID(Predefined::length),
+      readOnlyDPF,
+      runtime->getUndefinedValue(),
+      PropOpFlags().plusThrowOnError());
+  if (LLVM_UNLIKELY(readOnlyRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  if (LLVM_UNLIKELY(!*readOnlyRes)) {
+    return runtime->raiseTypeError(
+        "Failed to set 'length' property on the raw object read-only.");
+  }
+  JSObject::preventExtensions(templateObj.get());
+
+  // Cache the template object.
+  runtimeModule->cacheTemplateObject(templateObjID, templateObj);
+
+  return templateObj.getHermesValue();
+}
+
 } // namespace vm
 } // namespace hermes
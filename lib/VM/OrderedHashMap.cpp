@@ -13,171 +13,105 @@
 
 namespace hermes {
 namespace vm {
-//===----------------------------------------------------------------------===//
-// class HashMapEntry
-
-VTable HashMapEntry::vt{CellKind::HashMapEntryKind, sizeof(HashMapEntry)};
-
-void HashMapEntryBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
-  const auto *self = static_cast<const HashMapEntry *>(cell);
-  mb.addField("@key", &self->key);
-  mb.addField("@value", &self->value);
-  mb.addField("@prevIterationEntry", &self->prevIterationEntry);
-  mb.addField("@nextIterationEntry", &self->nextIterationEntry);
-  mb.addField("@nextEntryInBucket", &self->nextEntryInBucket);
-}
-
-CallResult<HermesValue> HashMapEntry::create(Runtime *runtime) {
-  void *mem = runtime->alloc(sizeof(HashMapEntry));
-  return HermesValue::encodeObjectValue(new (mem) HashMapEntry(runtime));
-}
 
 //===----------------------------------------------------------------------===//
 // class OrderedHashMap
 
 VTable OrderedHashMap::vt{CellKind::OrderedHashMapKind, sizeof(OrderedHashMap)};
 
+constexpr uint32_t OrderedHashMap::kIterationEnd;
+
 void OrderedHashMapBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
   const auto *self = static_cast<const OrderedHashMap *>(cell);
-  mb.addField("@hashTable", &self->hashTable_);
-  mb.addField("@firstIterationEntry", &self->firstIterationEntry_);
-  mb.addField("@lastIterationEntry", &self->lastIterationEntry_);
+  mb.addField("@table", &self->table_);
 }
 
-OrderedHashMap::OrderedHashMap(
-    Runtime *runtime,
-    Handle<ArrayStorage> hashTableStorage)
+OrderedHashMap::OrderedHashMap(Runtime *runtime, Handle<SegmentedArray> table)
     : GCCell(&runtime->getHeap(), &vt),
-      hashTable_(runtime, hashTableStorage.get(), &runtime->getHeap()) {
-  ArrayStorage::resizeWithinCapacity(
-      hashTableStorage, runtime, INITIAL_CAPACITY);
-}
+      table_(runtime, table.get(), &runtime->getHeap()) {}
 
 CallResult<HermesValue> OrderedHashMap::create(Runtime *runtime) {
-  auto arrRes = ArrayStorage::create(runtime, INITIAL_CAPACITY);
+  uint32_t size = tableSize(INITIAL_CAPACITY);
+  auto arrRes = SegmentedArray::create(runtime, size, size);
   if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto hashTableStorage = runtime->makeHandle<ArrayStorage>(*arrRes);
+  auto table = runtime->makeHandle<SegmentedArray>(*arrRes);
 
   void *mem = runtime->alloc(sizeof(OrderedHashMap));
   return HermesValue::encodeObjectValue(
-      new (mem) OrderedHashMap(runtime, hashTableStorage));
+      new (mem) OrderedHashMap(runtime, table));
 }
 
-void OrderedHashMap::removeLinkedListNode(
+uint32_t OrderedHashMap::lookupInBucket(
     Runtime *runtime,
-    HashMapEntry *entry,
-    GC *gc) {
-  assert(
-      entry != lastIterationEntry_.get(runtime) &&
-      "Cannot remove the last entry");
-  if (entry->prevIterationEntry) {
-    entry->prevIterationEntry.get(runtime)->nextIterationEntry.set(
-        runtime, entry->nextIterationEntry, gc);
-  }
-  if (entry->nextIterationEntry) {
-    entry->nextIterationEntry.get(runtime)->prevIterationEntry.set(
-        runtime, entry->prevIterationEntry, gc);
-  }
-  if (entry == firstIterationEntry_.get(runtime)) {
-    firstIterationEntry_.set(runtime, entry->nextIterationEntry, gc);
-  }
-  entry->prevIterationEntry = nullptr;
-}
-
-HashMapEntry *OrderedHashMap::lookupInBucket(
-    Runtime *runtime,
-    uint32_t bucket,
+    uint32_t bucketSlot,
     HermesValue key) {
+  SegmentedArray *table = table_.get(runtime);
   assert(
-      hashTable_.get(runtime)->size() == capacity_ && "Inconsistent capacity");
-  auto *entry = dyn_vmcast<HashMapEntry>(hashTable_.get(runtime)->at(bucket));
-  while (entry && !isSameValueZero(entry->key, key)) {
-    entry = entry->nextEntryInBucket.get(runtime);
+      table->size() == tableSize(capacity_) && "Inconsistent capacity");
+  for (const GCHermesValue *next = &table->at(bucketSlot); !next->isEmpty();) {
+    uint32_t index = next->getNativeUInt32();
+    uint32_t slot = keySlot(index);
+    HermesValue entryKey = table->at(slot);
+    // Holes have an empty key, which is never the same as the key.
+    if (!entryKey.isEmpty() && isSameValueZero(entryKey, key))
+      return index;
+    next = &table->at(slot + 2);
   }
-  return entry;
+  return kIterationEnd;
 }
 
-ExecutionStatus OrderedHashMap::rehashIfNecessary(
+ExecutionStatus OrderedHashMap::rehash(
     Handle<OrderedHashMap> self,
-    Runtime *runtime) {
-  uint32_t newCapacity = self->capacity_;
-  // NOTE: we have ensured that self->capacity_ * 4 never overflows uint32_t by
-  // setting MAX_CAPACITY to the apropriate value. self->size_ is always <=
-  // self->capacity_, so this applies to self->size_ as well.
-  static_assert(
-      MAX_CAPACITY < UINT32_MAX / 4,
-      "Avoid overflow checks on multiplying capacity by 4");
-  if (self->size_ * 4 > self->capacity_ * 3) {
-    // Load factor is more than 0.75, need to increase the capacity.
-    newCapacity = self->capacity_ * 2;
-    if (LLVM_UNLIKELY(newCapacity > MAX_CAPACITY)) {
-      // We maintain the invariant that the capacity_ is a power of two.
-      // Therefore, if doubling would exceed the max, we revert to the
-      // previous value.  (Assert the invariant to make it clear.)
-      assert(
-          (self->capacity_ & (self->capacity_ - 1)) == 0 &&
-          "capacity_ must be power of 2");
-      newCapacity = self->capacity_;
-    }
-  } else if (
-      self->size_ * 4 < self->capacity_ && self->capacity_ > INITIAL_CAPACITY) {
-    // Load factor is less than 0.25, and we are not at initial cap.
-    newCapacity = self->capacity_ / 2;
-  }
-  if (newCapacity == self->capacity_) {
-    // No need to rehash.
-    return ExecutionStatus::RETURNED;
-  }
+    Runtime *runtime,
+    uint32_t newCapacity) {
   assert(
-      self->size_ && self->firstIterationEntry_ && self->lastIterationEntry_ &&
-      "We should never be rehashing when there are no elements");
-
-  // Set new capacity first to update the hash function.
-  self->capacity_ = newCapacity;
+      (newCapacity & (newCapacity - 1)) == 0 &&
+      "capacity_ must be power of 2");
+  assert(newCapacity >= self->size_ && "new table is too small");
+  if (LLVM_UNLIKELY(newCapacity > MAX_CAPACITY)) {
+    return runtime->raiseRangeError("Too many elements in the collection");
+  }
 
-  // Create a new hash table.
-  auto arrRes = ArrayStorage::create(runtime, newCapacity, newCapacity);
+  uint32_t newSize = tableSize(newCapacity);
+  auto arrRes = SegmentedArray::create(runtime, newSize, newSize);
   if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto newHashTable = runtime->makeHandle<ArrayStorage>(*arrRes);
+  auto newTable = runtime->makeHandle<SegmentedArray>(*arrRes);
+  auto oldTable = runtime->makeHandle<SegmentedArray>(self->table_);
+  uint32_t oldCapacity = self->capacity_;
+  uint32_t oldNumEntries = self->numEntries_;
+
+  // Switch to the new table first, so that hashToBucket and keySlot describe
+  // it, then append the live entries in order.
+  self->table_.set(runtime, newTable.get(), &runtime->getHeap());
+  self->capacity_ = newCapacity;
+  self->numEntries_ = 0;
 
-  // Now re-add all entries to the hash table.
-  MutableHandle<HashMapEntry> entry{runtime};
-  MutableHandle<HashMapEntry> oldNextInBucket{runtime};
   MutableHandle<> keyHandle{runtime};
   GCScopeMarkerRAII marker{runtime};
-  for (unsigned i = 0, len = self->hashTable_.get(runtime)->size(); i < len;
-       ++i) {
-    entry = dyn_vmcast<HashMapEntry>(self->hashTable_.get(runtime)->at(i));
-    while (entry) {
-      marker.flush();
-      keyHandle = entry->key;
-      uint32_t bucket = hashToBucket(self, runtime, keyHandle);
-      oldNextInBucket = entry->nextEntryInBucket.get(runtime);
-      if (newHashTable->at(bucket).isEmpty()) {
-        // Empty bucket.
-        entry->nextEntryInBucket = nullptr;
-      } else {
-        // There are already a bucket head.
-        entry->nextEntryInBucket.set(
-            runtime,
-            vmcast<HashMapEntry>(newHashTable->at(bucket)),
-            &runtime->getHeap());
-      }
-      // Update bucket head to the new entry.
-      newHashTable->at(bucket).set(entry.getHermesValue(), &runtime->getHeap());
-
-      entry = *oldNextInBucket;
-    }
+  uint32_t oldEntries = kHeaderSize + oldCapacity / 2;
+  for (uint32_t i = 0; i < oldNumEntries; ++i) {
+    uint32_t oldSlot = oldEntries + i * kEntrySize;
+    if (oldTable->at(oldSlot).isEmpty())
+      continue;
+    marker.flush();
+    keyHandle = oldTable->at(oldSlot);
+    uint32_t bucketSlot = hashToBucket(self, runtime, keyHandle);
+    uint32_t index = self->numEntries_++;
+    uint32_t slot = self->keySlot(index);
+    newTable->at(slot).set(keyHandle.get(), &runtime->getHeap());
+    newTable->at(slot + 1).set(
+        oldTable->at(oldSlot + 1), &runtime->getHeap());
+    newTable->at(slot + 2).setNonPtr(newTable->at(bucketSlot));
+    newTable->at(bucketSlot).setNonPtr(HermesValue::encodeNativeUInt32(index));
   }
+  assert(self->numEntries_ == self->size_ && "lost entries while rehashing");
 
-  self->hashTable_.set(runtime, newHashTable.get(), &runtime->getHeap());
-  assert(
-      self->hashTable_.get(runtime)->size() == self->capacity_ &&
-      "Inconsistent capacity");
+  // Iterators still positioned in the old table move on to the new one.
+  oldTable->at(0).set(newTable.getHermesValue(), &runtime->getHeap());
   return ExecutionStatus::RETURNED;
 }
 
@@ -185,27 +119,22 @@ bool OrderedHashMap::has(
     Handle<OrderedHashMap> self,
     Runtime *runtime,
     Handle<> key) {
-  auto bucket = hashToBucket(self, runtime, key);
-  return self->lookupInBucket(runtime, bucket, key.getHermesValue());
-}
-
-HashMapEntry *OrderedHashMap::find(
-    Handle<OrderedHashMap> self,
-    Runtime *runtime,
-    Handle<> key) {
-  auto bucket = hashToBucket(self, runtime, key);
-  return self->lookupInBucket(runtime, bucket, key.getHermesValue());
+  auto bucketSlot = hashToBucket(self, runtime, key);
+  return self->lookupInBucket(runtime, bucketSlot, key.getHermesValue()) !=
+      kIterationEnd;
 }
 
 HermesValue OrderedHashMap::get(
     Handle<OrderedHashMap> self,
     Runtime *runtime,
     Handle<> key) {
-  auto *entry = find(self, runtime, key);
-  if (!entry) {
+  auto bucketSlot = hashToBucket(self, runtime, key);
+  uint32_t index =
+      self->lookupInBucket(runtime, bucketSlot, key.getHermesValue());
+  if (index == kIterationEnd) {
     return HermesValue::encodeUndefinedValue();
   }
-  return entry->value;
+  return self->getValueAt(runtime, index);
 }
 
 ExecutionStatus OrderedHashMap::insert(
@@ -213,158 +142,121 @@ ExecutionStatus OrderedHashMap::insert(
     Runtime *runtime,
     Handle<> key,
     Handle<> value) {
-  uint32_t bucket = hashToBucket(self, runtime, key);
-  if (auto *entry =
-          self->lookupInBucket(runtime, bucket, key.getHermesValue())) {
+  uint32_t bucketSlot = hashToBucket(self, runtime, key);
+  uint32_t index =
+      self->lookupInBucket(runtime, bucketSlot, key.getHermesValue());
+  if (index != kIterationEnd) {
     // Element already exists, update value and return.
-    entry->value.set(value.get(), &runtime->getHeap());
+    self->table_.get(runtime)->at(self->keySlot(index) + 1).set(
+        value.get(), &runtime->getHeap());
     return ExecutionStatus::RETURNED;
   }
-  // Create a new entry, set the key and value.
-  auto crtRes = HashMapEntry::create(runtime);
-  if (LLVM_UNLIKELY(crtRes == ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  auto newMapEntry = runtime->makeHandle<HashMapEntry>(*crtRes);
-  newMapEntry->key.set(key.get(), &runtime->getHeap());
-  newMapEntry->value.set(value.get(), &runtime->getHeap());
-  auto *curBucketFront =
-      dyn_vmcast<HashMapEntry>(self->hashTable_.get(runtime)->at(bucket));
-  if (curBucketFront) {
-    // If the bucket we are inserting to is not empty, we maintain the
-    // linked list properly.
-    newMapEntry->nextEntryInBucket.set(
-        runtime, curBucketFront, &runtime->getHeap());
-  }
-  // Set the newly inserted entry as the front of this bucket chain.
-  self->hashTable_.get(runtime)->at(bucket).set(
-      newMapEntry.getHermesValue(), &runtime->getHeap());
 
-  if (!self->firstIterationEntry_) {
-    // If we are inserting the first ever element, update
-    // first iteration entry pointer.
-    self->firstIterationEntry_.set(
-        runtime, newMapEntry.get(), &runtime->getHeap());
-    self->lastIterationEntry_.set(
-        runtime, newMapEntry.get(), &runtime->getHeap());
-  } else {
-    // Connect the new entry with the last entry.
-    self->lastIterationEntry_.get(runtime)->nextIterationEntry.set(
-        runtime, newMapEntry.get(), &runtime->getHeap());
-    newMapEntry->prevIterationEntry.set(
-        runtime, self->lastIterationEntry_, &runtime->getHeap());
-
-    HashMapEntry *previousLastEntry = self->lastIterationEntry_.get(runtime);
-    self->lastIterationEntry_.set(
-        runtime, newMapEntry.get(), &runtime->getHeap());
-
-    if (previousLastEntry && previousLastEntry->isDeleted()) {
-      // If the last entry was a deleted entry, we no longer need to keep it.
-      self->removeLinkedListNode(
-          runtime, previousLastEntry, &runtime->getHeap());
+  if (self->numEntries_ == self->capacity_) {
+    // The table is full. Grow it if at least half of the entries are alive,
+    // otherwise just drop the holes.
+    uint32_t newCapacity = self->size_ >= self->capacity_ / 2
+        ? self->capacity_ * 2
+        : self->capacity_;
+    if (LLVM_UNLIKELY(
+            rehash(self, runtime, newCapacity) == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
     }
+    bucketSlot = hashToBucket(self, runtime, key);
   }
 
+  // Append the new entry and make it the front of its bucket chain.
+  SegmentedArray *table = self->table_.get(runtime);
+  index = self->numEntries_++;
+  uint32_t slot = self->keySlot(index);
+  table->at(slot).set(key.get(), &runtime->getHeap());
+  table->at(slot + 1).set(value.get(), &runtime->getHeap());
+  table->at(slot + 2).setNonPtr(table->at(bucketSlot));
+  table->at(bucketSlot).setNonPtr(HermesValue::encodeNativeUInt32(index));
   self->size_++;
-  return self->rehashIfNecessary(self, runtime);
+  return ExecutionStatus::RETURNED;
 }
 
 bool OrderedHashMap::erase(
     Handle<OrderedHashMap> self,
     Runtime *runtime,
     Handle<> key) {
-  uint32_t bucket = hashToBucket(self, runtime, key);
-  HashMapEntry *prevEntry = nullptr;
-  auto *entry =
-      dyn_vmcast<HashMapEntry>(self->hashTable_.get(runtime)->at(bucket));
-  while (entry && !isSameValueZero(entry->key, key.getHermesValue())) {
-    prevEntry = entry;
-    entry = entry->nextEntryInBucket.get(runtime);
-  }
-  if (!entry) {
+  uint32_t bucketSlot = hashToBucket(self, runtime, key);
+  uint32_t index =
+      self->lookupInBucket(runtime, bucketSlot, key.getHermesValue());
+  if (index == kIterationEnd) {
     // Element does not exist.
     return false;
   }
 
-  if (prevEntry) {
-    // The entry we are deleting has a previous entry, update the link.
-    prevEntry->nextEntryInBucket.set(
-        runtime, entry->nextEntryInBucket, &runtime->getHeap());
-  } else {
-    // The entry we are erasing is the front entry in the bucket, we need
-    // to update the bucket head to the next entry in the bucket, if not
-    // any, set to empty value.
-    self->hashTable_.get(runtime)->at(bucket).set(
-        entry->nextEntryInBucket ? HermesValue::encodeObjectValue(
-                                       entry->nextEntryInBucket.get(runtime))
-                                 : HermesValue::encodeEmptyValue(),
-        &runtime->getHeap());
-  }
-
-  entry->markDeleted();
+  // Leave a hole. It stays in its bucket chain until the next rehash, and
+  // lets iterators in older tables count the entries that were dropped.
+  SegmentedArray *table = self->table_.get(runtime);
+  uint32_t slot = self->keySlot(index);
+  table->at(slot).setNonPtr(HermesValue::encodeEmptyValue());
+  table->at(slot + 1).setNonPtr(HermesValue::encodeEmptyValue());
   self->size_--;
 
-  // Now delete the entry from the iteration linked list.
-  // If we are deleting the last entry, don't remove it from the list yet.
-  // This will ensure that if any iterator out there is currently pointing to
-  // this entry, it will be able to follow on if we add new entries in the
-  // future.
-  if (entry != self->lastIterationEntry_.get(runtime)) {
-    self->removeLinkedListNode(runtime, entry, &runtime->getHeap());
+  if (self->size_ * 4 < self->capacity_ &&
+      self->capacity_ > INITIAL_CAPACITY) {
+    // Fewer than a quarter of the entries are alive, so shrink the table.
+    // Shrinking can't exceed the maximum size, so it can only fail by running
+    // out of memory, which is fatal.
+    (void)rehash(self, runtime, self->capacity_ / 2);
   }
-
-  self->rehashIfNecessary(self, runtime);
-
   return true;
 }
 
-HashMapEntry *OrderedHashMap::iteratorNext(
+uint32_t OrderedHashMap::iteratorNext(
     Runtime *runtime,
-    HashMapEntry *entry) const {
-  if (entry == nullptr) {
+    SegmentedArray *&table,
+    uint32_t index) {
+  if (!table) {
     // Starting a new iteration from the first entry.
-    entry = firstIterationEntry_.get(runtime);
-  } else {
-    // Advance to the next entry.
-    entry = entry->nextIterationEntry.get(runtime);
+    table = table_.get(runtime);
+    index = 0;
   }
 
-  // Make sure the entry we returned (if not nullptr) must not be deleted.
-  while (entry && entry->isDeleted()) {
-    entry = entry->nextIterationEntry.get(runtime);
+  // Follow the tables that replaced the iterator's own. Each replacement kept
+  // the live entries in order, so the position moves back by the number of
+  // holes before it.
+  while (!table->at(0).isEmpty()) {
+    uint32_t oldEntries = kHeaderSize + tableCapacity(table->size()) / 2;
+    uint32_t holes = 0;
+    for (uint32_t i = 0; i < index; ++i) {
+      holes += table->at(oldEntries + i * kEntrySize).isEmpty();
+    }
+    index -= holes;
+    table = vmcast<SegmentedArray>(table->at(0));
   }
-  return entry;
-}
+  assert(table == table_.get(runtime) && "iterator is not in the current table");
 
-void OrderedHashMap::clear(Runtime *runtime) {
-  if (!firstIterationEntry_) {
-    // Empty set.
-    return;
+  // Skip the holes.
+  for (; index < numEntries_; ++index) {
+    if (!table->at(keySlot(index)).isEmpty())
+      return index;
   }
+  return kIterationEnd;
+}
 
-  // Clear the hash table.
-  for (unsigned i = 0; i < capacity_; ++i) {
-    auto entry = dyn_vmcast<HashMapEntry>(hashTable_.get(runtime)->at(i));
-    // Delete every element reachable from the hash table.
-    while (entry) {
-      entry->markDeleted();
-      entry = entry->nextEntryInBucket.get(runtime);
-    }
-    // Clear every element in the hash table.
-    hashTable_.get(runtime)->at(i).setNonPtr(HermesValue::encodeEmptyValue());
+ExecutionStatus OrderedHashMap::clear(
+    Handle<OrderedHashMap> self,
+    Runtime *runtime) {
+  if (self->numEntries_ == 0) {
+    // Nothing was ever inserted into the current table.
+    return ExecutionStatus::RETURNED;
   }
-  // Resize the hash table to the initial size.
-  ArrayStorage::resizeWithinCapacity(
-      createPseudoHandle(hashTable_.get(runtime)), runtime, INITIAL_CAPACITY);
-  capacity_ = INITIAL_CAPACITY;
 
-  // After clearing, we will still keep the last deleted entry
-  // in case there is an iterator out there
-  // pointing to the middle of the iteration chain. We need it to be
-  // able to merge back eventually.
-  firstIterationEntry_.set(runtime, lastIterationEntry_, &runtime->getHeap());
-  firstIterationEntry_.get(runtime)->prevIterationEntry = nullptr;
-  size_ = 0;
+  // Turn every entry into a hole, so that iterators in this table start from
+  // the beginning of the new one.
+  SegmentedArray *table = self->table_.get(runtime);
+  for (uint32_t i = 0; i < self->numEntries_; ++i) {
+    uint32_t slot = self->keySlot(i);
+    table->at(slot).setNonPtr(HermesValue::encodeEmptyValue());
+    table->at(slot + 1).setNonPtr(HermesValue::encodeEmptyValue());
+  }
+  self->size_ = 0;
+  return rehash(self, runtime, INITIAL_CAPACITY);
 }
 
 } // namespace vm
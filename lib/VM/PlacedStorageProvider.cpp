@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/PlacedStorageProvider.h"
+
+#include "hermes/Support/OSCompat.h"
+#include "hermes/VM/AlignedStorage.h"
+
+namespace hermes {
+namespace vm {
+
+llvm::ErrorOr<void *> PlacedStorageProvider::newStorage(const char *name) {
+  auto result = delegate_->newStorage(name);
+  if (!result) {
+    return result;
+  }
+  void *storage = *result;
+  // Storages are aligned on their size, which is a multiple of the huge page
+  // size, so they never share a huge page with memory outside the heap.
+  if (hugePages_) {
+    oscompat::vm_madvise(
+        storage, AlignedStorage::size(), oscompat::MAdvice::HugePage);
+  }
+  if (numaLocal_) {
+    oscompat::vm_bind_local(storage, AlignedStorage::size());
+  }
+  return storage;
+}
+
+void PlacedStorageProvider::deleteStorage(void *storage) {
+  delegate_->deleteStorage(storage);
+}
+
+} // namespace vm
+} // namespace hermes
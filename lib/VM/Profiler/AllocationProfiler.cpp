@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/Profiler/AllocationProfiler.h"
+
+#include "hermes/BCGen/HBC/BytecodeDataProvider.h"
+#include "hermes/Support/JSONEmitter.h"
+#include "hermes/Support/OSCompat.h"
+#include "hermes/VM/Callable.h"
+#include "hermes/VM/CodeBlock.h"
+#include "hermes/VM/Domain.h"
+#include "hermes/VM/Runtime.h"
+#include "hermes/VM/StackFrame-inline.h"
+
+#include "llvm/ADT/StringMap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace hermes {
+namespace vm {
+
+AllocationProfiler::AllocationProfiler(
+    Runtime *runtime,
+    uint32_t samplingInterval)
+    : runtime_(runtime),
+      samplingInterval_(samplingInterval),
+      distribution_(1.0 / samplingInterval) {
+  assert(samplingInterval > 0 && "sampling interval must be positive");
+  nodes_.push_back(Node{Frame{nullptr, 0, 0}, 0});
+}
+
+int64_t AllocationProfiler::nextSampleDistance() {
+  // Round up, so that there is at least a byte between samples.
+  return static_cast<int64_t>(std::ceil(distribution_(rng_)));
+}
+
+int64_t AllocationProfiler::sample(void *cell, uint32_t size) {
+  // Collect the frames leaf first, as the stack is walked.
+  scratch_.clear();
+  const inst::Inst *ip = runtime_->getCallerIP();
+  for (StackFramePtr frame : runtime_->getStackFrames()) {
+    if (CodeBlock *codeBlock = frame.getCalleeCodeBlock()) {
+      // The last IP stored by the interpreter may be stale, or belong to
+      // another function. Only trust it if it is in this one.
+      auto *ptr = reinterpret_cast<const uint8_t *>(ip);
+      uint32_t offset = ptr && ptr >= codeBlock->begin() &&
+              ptr < codeBlock->end()
+          ? codeBlock->getOffsetOf(ip)
+          : 0;
+      RuntimeModule *module = codeBlock->getRuntimeModule();
+      Domain *domain = module->getDomainUnsafe();
+      if (std::find(domains_.begin(), domains_.end(), domain) ==
+          domains_.end()) {
+        domains_.push_back(domain);
+      }
+      scratch_.push_back(Frame{module, codeBlock->getFunctionID(), offset});
+    } else if (
+        auto *nativeFunction =
+            dyn_vmcast_or_null<NativeFunction>(frame.getCalleeClosure())) {
+      auto fn = reinterpret_cast<uintptr_t>(nativeFunction->getFunctionPtr());
+      auto it =
+          std::find(nativeFunctions_.begin(), nativeFunctions_.end(), fn);
+      uint32_t index = it - nativeFunctions_.begin();
+      if (it == nativeFunctions_.end()) {
+        nativeFunctions_.push_back(fn);
+      }
+      scratch_.push_back(Frame{nullptr, index, 0});
+    }
+    ip = frame.getSavedIP();
+  }
+
+  uint32_t node = 0;
+  for (auto it = scratch_.rbegin(), e = scratch_.rend(); it != e; ++it) {
+    node = getChild(node, *it);
+  }
+  nodes_[node].liveBytes += scaledSize(size);
+  // The object is not constructed yet, so it can't be checked as one. The
+  // weak reference is only read during collections, by then it is.
+  samples_.push_back(Sample{
+      WeakRef<HermesValue>(
+          &runtime_->getHeap(), HermesValue::encodeObjectValue(cell)),
+      node,
+      size,
+      numSamples_++});
+  return nextSampleDistance();
+}
+
+uint32_t AllocationProfiler::getChild(uint32_t parent, const Frame &frame) {
+  auto key =
+      std::make_tuple(parent, frame.module, frame.functionId, frame.offset);
+  auto it = childIndex_.find(key);
+  if (it != childIndex_.end()) {
+    return it->second;
+  }
+  uint32_t child = nodes_.size();
+  nodes_.push_back(Node{frame, parent});
+  nodes_[parent].children.push_back(child);
+  childIndex_.emplace(key, child);
+  return child;
+}
+
+void AllocationProfiler::markRoots(SlotAcceptorWithNames &acceptor) {
+  // The weak references are updated at the end of every collection, so this
+  // sees the objects that the previous one freed.
+  pruneSamples();
+  for (Domain *&domain : domains_) {
+    acceptor.acceptPtr(domain);
+  }
+  for (Sample &sample : samples_) {
+    acceptor.accept(sample.ref);
+  }
+}
+
+void AllocationProfiler::pruneSamples() {
+  auto dead = std::remove_if(
+      samples_.begin(), samples_.end(), [this](const Sample &sample) {
+        if (sample.ref.isValid()) {
+          return false;
+        }
+        nodes_[sample.node].liveBytes -= scaledSize(sample.size);
+        return true;
+      });
+  // The slots of the dropped references are freed by the next full
+  // collection, since nothing marks them anymore.
+  samples_.erase(dead, samples_.end());
+}
+
+double AllocationProfiler::scaledSize(uint32_t size) const {
+  // An object is sampled with probability 1 - exp(-size / interval).
+  return size / -std::expm1(-static_cast<double>(size) / samplingInterval_);
+}
+
+void AllocationProfiler::serialize(llvm::raw_ostream &OS) {
+  pruneSamples();
+
+  llvm::StringMap<uint32_t> scriptIds;
+  JSONEmitter json(OS);
+
+  // Emit the call frame of \p frame, which is the node of the tree.
+  auto emitCallFrame = [&](const Frame &frame, bool isRoot) {
+    std::string name;
+    std::string url;
+    // Lines and columns are 0-based, -1 if unknown.
+    int line = -1;
+    int column = -1;
+    if (isRoot) {
+      name = "(root)";
+    } else if (!frame.module) {
+      name = "[Native]";
+      name += oscompat::to_string(nativeFunctions_[frame.functionId]);
+    } else {
+      hbc::BCProvider *bcProvider = frame.module->getBytecode();
+      name = bcProvider
+                 ->getStringRefFromID(
+                     bcProvider->getFunctionHeader(frame.functionId)
+                         .functionName())
+                 .str();
+      url = frame.module->getSourceURL().str();
+      const hbc::DebugOffsets *debugOffsets =
+          bcProvider->getDebugOffsets(frame.functionId);
+      if (debugOffsets &&
+          debugOffsets->sourceLocations != hbc::DebugOffsets::NO_OFFSET) {
+        const hbc::DebugInfo *debugInfo = bcProvider->getDebugInfo();
+        if (auto loc = debugInfo->getLocationForAddress(
+                debugOffsets->sourceLocations, frame.offset)) {
+          url = debugInfo->getFilenameByID(loc->filenameId);
+          line = static_cast<int>(loc->line) - 1;
+          column = static_cast<int>(loc->column) - 1;
+        }
+      }
+    }
+    uint32_t scriptId = 0;
+    if (!url.empty()) {
+      scriptId = scriptIds.insert({url, scriptIds.size() + 1}).first->second;
+    }
+
+    json.emitKey("callFrame");
+    json.openDict();
+    json.emitKeyValue("functionName", name);
+    json.emitKeyValue("scriptId", oscompat::to_string(scriptId));
+    json.emitKeyValue("url", url);
+    json.emitKeyValue("lineNumber", line);
+    json.emitKeyValue("columnNumber", column);
+    json.closeDict();
+  };
+
+  // Node ids start at 1, the root's.
+  std::function<void(uint32_t)> emitNode = [&](uint32_t index) {
+    const Node &node = nodes_[index];
+    json.openDict();
+    emitCallFrame(node.frame, index == 0);
+    // Deallocations may leave a tiny negative rounding error.
+    json.emitKeyValue(
+        "selfSize", static_cast<double>(std::llround(
+                        std::max(node.liveBytes, 0.0))));
+    json.emitKeyValue("id", index + 1);
+    json.emitKey("children");
+    json.openArray();
+    for (uint32_t child : node.children) {
+      emitNode(child);
+    }
+    json.closeArray();
+    json.closeDict();
+  };
+
+  json.openDict();
+  json.emitKey("head");
+  emitNode(0);
+  json.emitKey("samples");
+  json.openArray();
+  for (const Sample &sample : samples_) {
+    json.openDict();
+    json.emitKeyValue(
+        "size", static_cast<double>(std::llround(scaledSize(sample.size))));
+    json.emitKeyValue("nodeId", sample.node + 1);
+    json.emitKeyValue("ordinal", static_cast<double>(sample.ordinal));
+    json.closeDict();
+  }
+  json.closeArray();
+  json.closeDict();
+  OS.flush();
+}
+
+} // namespace vm
+} // namespace hermes
@@ -51,6 +51,11 @@ std::shared_ptr<ChromeStackFrameNode> ChromeStackFrameNode::findOrAddNewChild(
     for (auto iter = sample.stack.rbegin(); iter != sample.stack.rend();
          ++iter) {
       const SamplingProfiler::StackFrame &frame = *iter;
+      if (frame.kind ==
+          SamplingProfiler::StackFrame::FrameKind::NativeCode) {
+        // The trace only shows the frames of the runtime.
+        continue;
+      }
       if (isRootFrame) {
         leafNode = findOrAddNewHelper(frameIdGen, trace.callTrees_, frame);
         isRootFrame = false;
@@ -259,6 +264,9 @@ void ChromeTraceSerializer::serializeStackFrames(JSONEmitter &json) const {
         frameName = "[Native]";
         frameName += oscompat::to_string(frame.nativeFrame);
         categoryName = "Native";
+      } else if (frame.kind == SamplingProfiler::StackFrame::FrameKind::GC) {
+        frameName = "[GC]";
+        categoryName = "GC";
       } else {
         llvm_unreachable("Unknown frame kind");
       }
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/Profiler/ExecutionTracer.h"
+
+#include "hermes/BCGen/HBC/BytecodeDataProvider.h"
+#include "hermes/Inst/InstDecode.h"
+#include "hermes/Support/JSONEmitter.h"
+#include "hermes/VM/Callable.h"
+#include "hermes/VM/CodeBlock.h"
+#include "hermes/VM/Domain.h"
+#include "hermes/VM/StackFrame-inline.h"
+
+#include <algorithm>
+
+namespace hermes {
+namespace vm {
+
+void ExecutionTracer::record(
+    Kind kind,
+    CodeBlock *codeBlock,
+    const inst::Inst *ip,
+    uint8_t detail) {
+  recordAt(kind, codeBlock, codeBlock->getOffsetOf(ip), detail, 0);
+}
+
+void ExecutionTracer::recordDictionaryMode() {
+  const inst::Inst *ip = runtime_->getCallerIP();
+  for (StackFramePtr frame : runtime_->getStackFrames()) {
+    if (CodeBlock *codeBlock = frame.getCalleeCodeBlock()) {
+      // The last IP stored by the interpreter may be stale, or belong to
+      // another function. Only trust it if it is in this one.
+      auto *ptr = reinterpret_cast<const uint8_t *>(ip);
+      uint32_t offset = ptr && ptr >= codeBlock->begin() &&
+              ptr < codeBlock->end()
+          ? codeBlock->getOffsetOf(ip)
+          : 0;
+      recordAt(Kind::DictionaryMode, codeBlock, offset, 0, 0);
+      return;
+    }
+    ip = frame.getSavedIP();
+  }
+  recordAt(Kind::DictionaryMode, nullptr, 0, 0, 0);
+}
+
+void ExecutionTracer::recordJITBailout(
+    CodeBlock *codeBlock,
+    uint32_t offset,
+    const std::string &message) {
+  if (events_.size() >= kMaxEvents) {
+    ++numDropped_;
+    return;
+  }
+  messages_.push_back(message);
+  recordAt(Kind::JITBailout, codeBlock, offset, 0, messages_.size() - 1);
+}
+
+void ExecutionTracer::recordAt(
+    Kind kind,
+    CodeBlock *codeBlock,
+    uint32_t offset,
+    uint8_t detail,
+    uint32_t message) {
+  if (events_.size() >= kMaxEvents) {
+    ++numDropped_;
+    return;
+  }
+  RuntimeModule *module = nullptr;
+  uint32_t functionId = 0;
+  if (codeBlock) {
+    module = codeBlock->getRuntimeModule();
+    functionId = codeBlock->getFunctionID();
+    Domain *domain = module->getDomainUnsafe();
+    // Events tend to come from the few domains of the app, most recent last.
+    if (std::find(domains_.rbegin(), domains_.rend(), domain) ==
+        domains_.rend()) {
+      domains_.push_back(domain);
+    }
+  }
+  events_.push_back(Event{kind, detail, functionId, offset, module, message});
+}
+
+void ExecutionTracer::markRoots(SlotAcceptorWithNames &acceptor) {
+  for (Domain *&domain : domains_) {
+    acceptor.acceptPtr(domain);
+  }
+}
+
+/// \return the name of \p kind in the trace.
+static const char *kindName(ExecutionTracer::Kind kind) {
+  switch (kind) {
+    case ExecutionTracer::Kind::PropertyCache:
+      return "propertyCache";
+    case ExecutionTracer::Kind::Quicken:
+      return "quicken";
+    case ExecutionTracer::Kind::Deoptimize:
+      return "deoptimize";
+    case ExecutionTracer::Kind::DictionaryMode:
+      return "dictionaryMode";
+    case ExecutionTracer::Kind::JITBailout:
+      return "jitBailout";
+    case ExecutionTracer::Kind::FunctionEnter:
+      return "functionEnter";
+    case ExecutionTracer::Kind::FunctionExit:
+      return "functionExit";
+  }
+  llvm_unreachable("invalid event kind");
+}
+
+/// \return the name of the property cache \p state in the trace.
+static const char *stateName(PropertyCacheState state) {
+  switch (state) {
+    case PropertyCacheState::Uninitialized:
+      return "uninitialized";
+    case PropertyCacheState::Monomorphic:
+      return "monomorphic";
+    case PropertyCacheState::Polymorphic:
+      return "polymorphic";
+    case PropertyCacheState::Megamorphic:
+      return "megamorphic";
+  }
+  llvm_unreachable("invalid property cache state");
+}
+
+void ExecutionTracer::serialize(llvm::raw_ostream &OS) const {
+  JSONEmitter json(OS);
+  json.openDict();
+  json.emitKey("events");
+  json.openArray();
+  for (const Event &event : events_) {
+    json.openDict();
+    json.emitKeyValue("kind", kindName(event.kind));
+    if (event.module) {
+      hbc::BCProvider *bcProvider = event.module->getBytecode();
+      json.emitKeyValue(
+          "function",
+          bcProvider->getStringRefFromID(
+              bcProvider->getFunctionHeader(event.functionId).functionName()));
+      json.emitKeyValue("functionId", event.functionId);
+      json.emitKeyValue("url", event.module->getSourceURL());
+      json.emitKeyValue("offset", event.offset);
+      // Lines and columns are 1-based, and only known with debug info.
+      const hbc::DebugOffsets *debugOffsets =
+          bcProvider->getDebugOffsets(event.functionId);
+      if (debugOffsets &&
+          debugOffsets->sourceLocations != hbc::DebugOffsets::NO_OFFSET) {
+        if (auto loc = bcProvider->getDebugInfo()->getLocationForAddress(
+                debugOffsets->sourceLocations, event.offset)) {
+          json.emitKeyValue("line", loc->line);
+          json.emitKeyValue("column", loc->column);
+        }
+      }
+    }
+    switch (event.kind) {
+      case Kind::PropertyCache:
+        json.emitKeyValue(
+            "state", stateName(static_cast<PropertyCacheState>(event.detail)));
+        break;
+      case Kind::Quicken:
+      case Kind::Deoptimize:
+        json.emitKeyValue(
+            "opcode",
+            inst::getOpCodeString(static_cast<inst::OpCode>(event.detail)));
+        break;
+      case Kind::JITBailout:
+        json.emitKeyValue("message", messages_[event.message]);
+        break;
+      case Kind::DictionaryMode:
+      case Kind::FunctionEnter:
+      case Kind::FunctionExit:
+        break;
+    }
+    json.closeDict();
+  }
+  json.closeArray();
+  json.emitKeyValue("dropped", numDropped_);
+  json.closeDict();
+  OS.flush();
+}
+
+} // namespace vm
+} // namespace hermes
@@ -0,0 +1,448 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef _WINDOWS
+#include "hermes/VM/Profiler/PprofSerializerPosix.h"
+
+#include "hermes/Support/OSCompat.h"
+#include "hermes/VM/RuntimeModule-inline.h"
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+namespace hermes {
+namespace vm {
+
+namespace {
+
+using StackFrame = SamplingProfiler::StackFrame;
+using FrameKind = StackFrame::FrameKind;
+
+/// Appends the fields of a protobuf message to a string.
+class ProtoWriter {
+ public:
+  void writeVarint(uint32_t field, uint64_t value) {
+    writeKey(field, kVarint);
+    appendVarint(buf_, value);
+  }
+
+  void writeBytes(uint32_t field, llvm::StringRef value) {
+    writeKey(field, kLengthDelimited);
+    appendVarint(buf_, value.size());
+    buf_.append(value.data(), value.size());
+  }
+
+  void writePacked(uint32_t field, const std::vector<uint64_t> &values) {
+    std::string packed;
+    for (uint64_t value : values) {
+      appendVarint(packed, value);
+    }
+    writeBytes(field, packed);
+  }
+
+  void writeMessage(uint32_t field, const ProtoWriter &message) {
+    writeBytes(field, message.buf_);
+  }
+
+  /// Append the fields written to \p other.
+  void append(const ProtoWriter &other) {
+    buf_ += other.buf_;
+  }
+
+  const std::string &str() const {
+    return buf_;
+  }
+
+ private:
+  enum WireType { kVarint = 0, kLengthDelimited = 2 };
+
+  static void appendVarint(std::string &out, uint64_t value) {
+    while (value >= 0x80) {
+      out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+      value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+  }
+
+  void writeKey(uint32_t field, WireType type) {
+    appendVarint(buf_, (static_cast<uint64_t>(field) << 3) | type);
+  }
+
+  std::string buf_;
+};
+
+/// Field numbers from profile.proto, prefixed with their message.
+constexpr uint32_t kProfileSampleType = 1;
+constexpr uint32_t kProfileSample = 2;
+constexpr uint32_t kProfileLocation = 4;
+constexpr uint32_t kProfileFunction = 5;
+constexpr uint32_t kProfileStringTable = 6;
+constexpr uint32_t kProfileTimeNanos = 9;
+constexpr uint32_t kProfileDurationNanos = 10;
+constexpr uint32_t kProfilePeriodType = 11;
+constexpr uint32_t kProfilePeriod = 12;
+constexpr uint32_t kValueTypeType = 1;
+constexpr uint32_t kValueTypeUnit = 2;
+constexpr uint32_t kSampleLocationId = 1;
+constexpr uint32_t kSampleValue = 2;
+constexpr uint32_t kSampleLabel = 3;
+constexpr uint32_t kLabelKey = 1;
+constexpr uint32_t kLabelStr = 2;
+constexpr uint32_t kLocationId = 1;
+constexpr uint32_t kLocationAddress = 3;
+constexpr uint32_t kLocationLine = 4;
+constexpr uint32_t kLineFunctionId = 1;
+constexpr uint32_t kLineLine = 2;
+constexpr uint32_t kFunctionId = 1;
+constexpr uint32_t kFunctionName = 2;
+constexpr uint32_t kFunctionSystemName = 3;
+constexpr uint32_t kFunctionFilename = 4;
+constexpr uint32_t kFunctionStartLine = 5;
+
+/// The symbol of a native code address, found with dladdr().
+struct NativeSymbol {
+  /// The mangled name, or empty if unknown.
+  std::string systemName;
+  /// The demangled name, or the address if the symbol is unknown.
+  std::string name;
+  /// The path of the shared object containing the address.
+  std::string filename;
+};
+
+/// Builds the tables of a profile: strings, functions and locations, each
+/// deduplicated, and the samples referring to them.
+class ProfileBuilder {
+ public:
+  ProfileBuilder() {
+    // By convention, the first string of the table is empty.
+    intern("");
+  }
+
+  /// Add \p sample to the profile, labeled with \p threadName.
+  void addSample(
+      const SamplingProfiler::StackTrace &sample,
+      llvm::StringRef threadName,
+      uint64_t periodNanos);
+
+  /// Write the tables and samples to \p profile.
+  void write(ProtoWriter &profile) const;
+
+  uint64_t intern(llvm::StringRef str) {
+    auto result = strings_.emplace(str.str(), stringTable_.size());
+    if (result.second) {
+      stringTable_.push_back(str.str());
+    }
+    return result.first->second;
+  }
+
+ private:
+  /// Identifies a location: the kind of frame and up to three values
+  /// depending on it.
+  using LocationKey = std::tuple<int, uintptr_t, uint32_t, uint32_t>;
+
+  /// \return the symbol of the NativeFunction or NativeCode \p frame.
+  const NativeSymbol &symbolize(const StackFrame &frame);
+
+  /// \return the id of the location of \p frame, adding it if it is new.
+  uint64_t getLocation(const StackFrame &frame);
+
+  /// \return the id of the function identified by \p key, adding it with
+  /// the other arguments if it is new.
+  uint64_t getFunction(
+      const std::string &key,
+      llvm::StringRef name,
+      llvm::StringRef systemName,
+      llvm::StringRef filename,
+      uint64_t startLine);
+
+  std::unordered_map<std::string, uint64_t> strings_;
+  std::vector<std::string> stringTable_;
+  std::unordered_map<std::string, uint64_t> functionIds_;
+  std::map<LocationKey, uint64_t> locationIds_;
+  std::unordered_map<uintptr_t, NativeSymbol> symbols_;
+  ProtoWriter functions_;
+  ProtoWriter locations_;
+  ProtoWriter samples_;
+};
+
+const NativeSymbol &ProfileBuilder::symbolize(const StackFrame &frame) {
+  uintptr_t address = frame.nativeFrame;
+  auto it = symbols_.find(address);
+  if (it != symbols_.end()) {
+    return it->second;
+  }
+  NativeSymbol &symbol = symbols_[address];
+  // Return addresses point after the call, which may be the start of the
+  // next function.
+  uintptr_t lookup =
+      frame.kind == FrameKind::NativeCode ? address - 1 : address;
+  Dl_info info;
+  if (dladdr(reinterpret_cast<void *>(lookup), &info) && info.dli_sname) {
+    symbol.systemName = info.dli_sname;
+    int status = 0;
+    char *demangled =
+        abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    symbol.name = status == 0 && demangled ? demangled : info.dli_sname;
+    free(demangled);
+    symbol.filename = info.dli_fname ? info.dli_fname : "";
+  } else {
+    llvm::raw_string_ostream os(symbol.name);
+    os << "[NativeCode]0x";
+    os.write_hex(address);
+  }
+  return symbol;
+}
+
+uint64_t ProfileBuilder::getFunction(
+    const std::string &key,
+    llvm::StringRef name,
+    llvm::StringRef systemName,
+    llvm::StringRef filename,
+    uint64_t startLine) {
+  auto result = functionIds_.emplace(key, functionIds_.size() + 1);
+  if (!result.second) {
+    return result.first->second;
+  }
+  ProtoWriter function;
+  function.writeVarint(kFunctionId, result.first->second);
+  function.writeVarint(kFunctionName, intern(name));
+  function.writeVarint(kFunctionSystemName, intern(systemName));
+  function.writeVarint(kFunctionFilename, intern(filename));
+  function.writeVarint(kFunctionStartLine, startLine);
+  functions_.writeMessage(kProfileFunction, function);
+  return result.first->second;
+}
+
+uint64_t ProfileBuilder::getLocation(const StackFrame &frame) {
+  LocationKey key{static_cast<int>(frame.kind), 0, 0, 0};
+  switch (frame.kind) {
+    case FrameKind::JSFunction:
+      key = LocationKey{static_cast<int>(frame.kind),
+                        reinterpret_cast<uintptr_t>(frame.jsFrame.module),
+                        frame.jsFrame.functionId,
+                        frame.jsFrame.offset};
+      break;
+    case FrameKind::NativeFunction:
+    case FrameKind::NativeCode:
+      std::get<1>(key) = frame.nativeFrame;
+      break;
+    case FrameKind::GC:
+      break;
+  }
+  auto result = locationIds_.emplace(key, locationIds_.size() + 1);
+  if (!result.second) {
+    return result.first->second;
+  }
+
+  uint64_t address = 0;
+  uint64_t functionId;
+  uint64_t line = 0;
+  switch (frame.kind) {
+    case FrameKind::JSFunction: {
+      hbc::BCProvider *bcProvider = frame.jsFrame.module->getBytecode();
+      uint32_t funcId = frame.jsFrame.functionId;
+      std::string name =
+          bcProvider
+              ->getStringRefFromID(
+                  bcProvider->getFunctionHeader(funcId).functionName())
+              .str();
+      if (name.empty()) {
+        name = "(anonymous)";
+      }
+      std::string filename;
+      uint64_t startLine = 0;
+      const hbc::DebugOffsets *debugOffsets =
+          bcProvider->getDebugOffsets(funcId);
+      if (debugOffsets != nullptr &&
+          debugOffsets->sourceLocations != hbc::DebugOffsets::NO_OFFSET) {
+        const hbc::DebugInfo *debugInfo = bcProvider->getDebugInfo();
+        if (auto loc = debugInfo->getLocationForAddress(
+                debugOffsets->sourceLocations, frame.jsFrame.offset)) {
+          filename = debugInfo->getFilenameByID(loc->filenameId);
+          line = loc->line;
+        }
+        if (auto start = debugInfo->getLocationForAddress(
+                debugOffsets->sourceLocations, 0)) {
+          startLine = start->line;
+        }
+      } else {
+        // Without debug info, the virtual offset can be symbolicated with a
+        // source map.
+        address = bcProvider->getVirtualOffsetForFunction(funcId) +
+            frame.jsFrame.offset;
+      }
+      std::string functionKey;
+      llvm::raw_string_ostream(functionKey)
+          << "js:" << frame.jsFrame.module << ":" << funcId;
+      functionId =
+          getFunction(functionKey, name, name, filename, startLine);
+      break;
+    }
+    case FrameKind::NativeFunction:
+    case FrameKind::NativeCode: {
+      address = frame.nativeFrame;
+      const NativeSymbol &symbol = symbolize(frame);
+      // Return addresses in the same function share it.
+      functionId = getFunction(
+          "native:" +
+              (symbol.systemName.empty() ? symbol.name : symbol.systemName),
+          symbol.name,
+          symbol.systemName,
+          symbol.filename,
+          0);
+      break;
+    }
+    case FrameKind::GC:
+      functionId = getFunction("gc", "[GC]", "[GC]", "", 0);
+      break;
+  }
+
+  ProtoWriter location;
+  location.writeVarint(kLocationId, result.first->second);
+  if (address) {
+    location.writeVarint(kLocationAddress, address);
+  }
+  ProtoWriter lineInfo;
+  lineInfo.writeVarint(kLineFunctionId, functionId);
+  lineInfo.writeVarint(kLineLine, line);
+  location.writeMessage(kLocationLine, lineInfo);
+  locations_.writeMessage(kProfileLocation, location);
+  return result.first->second;
+}
+
+void ProfileBuilder::addSample(
+    const SamplingProfiler::StackTrace &sample,
+    llvm::StringRef threadName,
+    uint64_t periodNanos) {
+  // The native frames come first. Only keep the ones called from the
+  // interpreter, which stand for the work of the leaf runtime frame; the
+  // interpreter and its callers are already shown by the runtime frames.
+  size_t nativeEnd = 0;
+  while (nativeEnd < sample.stack.size() &&
+         sample.stack[nativeEnd].kind == FrameKind::NativeCode) {
+    ++nativeEnd;
+  }
+  if (nativeEnd == sample.stack.size()) {
+    return;
+  }
+  const StackFrame &vmFrame = sample.stack[nativeEnd];
+  size_t nativeKept = nativeEnd;
+  if (vmFrame.kind != FrameKind::GC) {
+    for (size_t i = 0; i < nativeEnd; ++i) {
+      if (llvm::StringRef(symbolize(sample.stack[i]).systemName)
+              .contains("interpretFunction")) {
+        nativeKept = i;
+        break;
+      }
+    }
+  }
+
+  const char *vmState;
+  switch (vmFrame.kind) {
+    case FrameKind::GC:
+      vmState = "gc";
+      break;
+    case FrameKind::NativeFunction:
+      vmState = "native";
+      break;
+    default:
+      // Native frames above the interpreter are slow paths of the VM.
+      vmState = nativeKept ? "vm" : "js";
+      break;
+  }
+
+  std::vector<uint64_t> locationIds;
+  locationIds.reserve(nativeKept + sample.stack.size() - nativeEnd);
+  for (size_t i = 0; i < nativeKept; ++i) {
+    locationIds.push_back(getLocation(sample.stack[i]));
+  }
+  for (size_t i = nativeEnd; i < sample.stack.size(); ++i) {
+    locationIds.push_back(getLocation(sample.stack[i]));
+  }
+
+  ProtoWriter entry;
+  entry.writePacked(kSampleLocationId, locationIds);
+  entry.writePacked(kSampleValue, {1, periodNanos});
+  ProtoWriter threadLabel;
+  threadLabel.writeVarint(kLabelKey, intern("thread"));
+  threadLabel.writeVarint(kLabelStr, intern(threadName));
+  entry.writeMessage(kSampleLabel, threadLabel);
+  ProtoWriter stateLabel;
+  stateLabel.writeVarint(kLabelKey, intern("vm_state"));
+  stateLabel.writeVarint(kLabelStr, intern(vmState));
+  entry.writeMessage(kSampleLabel, stateLabel);
+  samples_.writeMessage(kProfileSample, entry);
+}
+
+void ProfileBuilder::write(ProtoWriter &profile) const {
+  profile.append(samples_);
+  profile.append(locations_);
+  profile.append(functions_);
+  for (const std::string &str : stringTable_) {
+    profile.writeBytes(kProfileStringTable, str);
+  }
+}
+
+} // namespace
+
+void PprofSerializer::serialize(llvm::raw_ostream &OS) const {
+  ProfileBuilder builder;
+  uint64_t periodNanos =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(samplingInterval_)
+          .count();
+  for (const SamplingProfiler::StackTrace &sample : sampledStacks_) {
+    auto it = threadNames_.find(sample.tid);
+    builder.addSample(
+        sample,
+        it != threadNames_.end() ? it->second : oscompat::to_string(sample.tid),
+        periodNanos);
+  }
+
+  ProtoWriter profile;
+  auto writeValueType = [&](uint32_t fieldNumber,
+                            llvm::StringRef type,
+                            llvm::StringRef unit) {
+    ProtoWriter valueType;
+    valueType.writeVarint(kValueTypeType, builder.intern(type));
+    valueType.writeVarint(kValueTypeUnit, builder.intern(unit));
+    profile.writeMessage(fieldNumber, valueType);
+  };
+  writeValueType(kProfileSampleType, "samples", "count");
+  writeValueType(kProfileSampleType, "wall", "nanoseconds");
+  writeValueType(kProfilePeriodType, "wall", "nanoseconds");
+  profile.writeVarint(kProfilePeriod, periodNanos);
+  if (!sampledStacks_.empty()) {
+    // Samples are timed with the steady clock, pprof wants the wall clock.
+    auto first = sampledStacks_.front().timeStamp;
+    auto last = sampledStacks_.back().timeStamp;
+    auto start = std::chrono::system_clock::now() -
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                     std::chrono::steady_clock::now() - first);
+    profile.writeVarint(
+        kProfileTimeNanos,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            start.time_since_epoch())
+            .count());
+    profile.writeVarint(
+        kProfileDurationNanos,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(last - first)
+            .count());
+  }
+  // The tables go last: protobuf doesn't care about the order of fields, and
+  // the string table is only complete once everything else is written.
+  builder.write(profile);
+  OS << profile.str();
+}
+
+} // namespace vm
+} // namespace hermes
+
+#endif // not _WINDOWS
@@ -8,49 +8,248 @@
 
 #include "hermes/VM/Profiler/SamplingProfiler.h"
 
+#include "hermes/BCGen/HBC/BytecodeDataProvider.h"
+#include "hermes/Support/JSONEmitter.h"
 #include "hermes/Support/ThreadLocal.h"
 #include "hermes/VM/Callable.h"
 #include "hermes/VM/Profiler/ChromeTraceSerializerPosix.h"
+#include "hermes/VM/Profiler/PprofSerializerPosix.h"
 #include "hermes/VM/RuntimeModule-inline.h"
 #include "hermes/VM/StackFrame-inline.h"
 
 #include <assert.h>
+#include <errno.h>
 #include <fcntl.h>
 #include <pthread.h>
 #include <signal.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
 namespace hermes {
 namespace vm {
 
-/// Name of the semaphore.
-const char *const kSamplingDoneSemaphoreName = "/samplingDoneSem";
-
 volatile std::atomic<SamplingProfiler *> SamplingProfiler::sProfilerInstance_{
     nullptr};
 
+constexpr std::chrono::microseconds SamplingProfiler::kDefaultSamplingInterval;
+constexpr uint32_t SamplingProfiler::SampleRing::kSampleCapacity;
+constexpr uint32_t SamplingProfiler::SampleRing::kFrameCapacity;
+constexpr unsigned SamplingProfiler::kNumCounters;
+
+/// \return the highest address of the stack of the current thread, or 0 if
+/// it is unknown.
+static uintptr_t currentThreadStackHigh() {
+#if defined(__linux__)
+  pthread_attr_t attr;
+  if (pthread_getattr_np(pthread_self(), &attr) != 0) {
+    return 0;
+  }
+  void *low = nullptr;
+  size_t size = 0;
+  int res = pthread_attr_getstack(&attr, &low, &size);
+  pthread_attr_destroy(&attr);
+  return res == 0 ? reinterpret_cast<uintptr_t>(low) + size : 0;
+#else
+  return 0;
+#endif
+}
+
+/// Read the pc, frame pointer and stack pointer of the code interrupted by a
+/// signal from its \p ucontext.
+/// \return false if this platform is not supported.
+static bool getInterruptedRegisters(
+    void *ucontext,
+    uintptr_t &pc,
+    uintptr_t &fp,
+    uintptr_t &sp) {
+#if defined(__linux__) && defined(__x86_64__)
+  const auto &mcontext = static_cast<ucontext_t *>(ucontext)->uc_mcontext;
+  pc = mcontext.gregs[REG_RIP];
+  fp = mcontext.gregs[REG_RBP];
+  sp = mcontext.gregs[REG_RSP];
+  return true;
+#elif defined(__linux__) && defined(__aarch64__)
+  const auto &mcontext = static_cast<ucontext_t *>(ucontext)->uc_mcontext;
+  pc = mcontext.pc;
+  fp = mcontext.regs[29];
+  sp = mcontext.sp;
+  return true;
+#else
+  (void)ucontext;
+  (void)pc;
+  (void)fp;
+  (void)sp;
+  return false;
+#endif
+}
+
+/// Walk the chain of frame pointers of the code interrupted by a signal, and
+/// store the pc and up to \p capacity - 1 return addresses as NativeCode
+/// frames. Code built without frame pointers ends the walk early or skips
+/// frames; every frame pointer is checked to point further up the stack,
+/// below \p stackHigh, before it is read.
+/// Called from the signal handler.
+/// \return the number of frames stored.
+static uint32_t walkNativeStack(
+    void *ucontext,
+    uintptr_t stackHigh,
+    SamplingProfiler::StackFrame *frames,
+    uint32_t capacity) {
+  uintptr_t pc, fp, sp;
+  if (!stackHigh || !capacity ||
+      !getInterruptedRegisters(ucontext, pc, fp, sp)) {
+    return 0;
+  }
+  uint32_t count = 0;
+  frames[count].kind = SamplingProfiler::StackFrame::FrameKind::NativeCode;
+  frames[count++].nativeFrame = pc;
+  // Each frame starts with the saved frame pointer of its caller, followed by
+  // the return address into the caller.
+  constexpr uintptr_t kFrameRecordSize = 2 * sizeof(uintptr_t);
+  while (count < capacity && fp >= sp && fp % sizeof(uintptr_t) == 0 &&
+         fp + kFrameRecordSize <= stackHigh) {
+    const uintptr_t *record = reinterpret_cast<const uintptr_t *>(fp);
+    if (!record[1]) {
+      break;
+    }
+    frames[count].kind = SamplingProfiler::StackFrame::FrameKind::NativeCode;
+    frames[count++].nativeFrame = record[1];
+    sp = fp + kFrameRecordSize;
+    fp = record[0];
+  }
+  return count;
+}
+
+void SamplingProfiler::SampleRing::push(
+    uint32_t depth,
+    ThreadId tid,
+    TimeStampType timeStamp) {
+  uint32_t sampleIdx = sampleHead.load(std::memory_order_relaxed);
+  uint32_t frameIdx = frameHead.load(std::memory_order_relaxed);
+  if (sampleIdx - sampleTail.load(std::memory_order_acquire) ==
+          kSampleCapacity ||
+      kFrameCapacity - (frameIdx - frameTail.load(std::memory_order_acquire)) <
+          depth) {
+    dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  for (uint32_t i = 0; i < depth; ++i) {
+    frames[(frameIdx + i) & (kFrameCapacity - 1)] = scratch[i];
+  }
+  SampleHeader &sample = samples[sampleIdx & (kSampleCapacity - 1)];
+  sample.tid = tid;
+  sample.timeStamp = timeStamp;
+  sample.frameStart = frameIdx;
+  sample.depth = depth;
+  uint64_t counts[kNumCounters];
+  if (perfCountersOpen.load(std::memory_order_acquire) &&
+      perfCounters.read(counts)) {
+    for (unsigned i = 0; i < kNumCounters; ++i) {
+      sample.counters[i] = counts[i] - lastCounts[i];
+      lastCounts[i] = counts[i];
+    }
+  } else {
+    std::fill(sample.counters, sample.counters + kNumCounters, 0);
+  }
+  frameHead.store(frameIdx + depth, std::memory_order_release);
+  sampleHead.store(sampleIdx + 1, std::memory_order_release);
+}
+
+void SamplingProfiler::SampleRing::drain(std::vector<StackTrace> &out) {
+  uint32_t head = sampleHead.load(std::memory_order_acquire);
+  for (uint32_t idx = sampleTail.load(std::memory_order_relaxed); idx != head;
+       ++idx) {
+    const SampleHeader &sample = samples[idx & (kSampleCapacity - 1)];
+    out.emplace_back(sample.tid, sample.timeStamp);
+    std::copy(
+        sample.counters, sample.counters + kNumCounters, out.back().counters);
+    std::vector<StackFrame> &stack = out.back().stack;
+    stack.reserve(sample.depth);
+    for (uint32_t i = 0; i < sample.depth; ++i) {
+      stack.push_back(frames[(sample.frameStart + i) & (kFrameCapacity - 1)]);
+    }
+    frameTail.store(
+        sample.frameStart + sample.depth, std::memory_order_release);
+    sampleTail.store(idx + 1, std::memory_order_release);
+  }
+}
+
+void SamplingProfiler::SampleRing::openPerfCounters() {
+  closePerfCounters();
+  if (perfCounters.open(tid)) {
+    std::fill(lastCounts, lastCounts + kNumCounters, 0);
+    perfCountersOpen.store(true, std::memory_order_release);
+  }
+}
+
+void SamplingProfiler::SampleRing::closePerfCounters() {
+  // A signal handler that already saw them open may still read them, which
+  // fails once they are closed.
+  perfCountersOpen.store(false, std::memory_order_release);
+  perfCounters.close();
+}
+
 void SamplingProfiler::registerRuntime(Runtime *runtime) {
   std::lock_guard<std::mutex> lockGuard(profilerLock_);
 
   // TODO: should we only register runtime when profiler is enabled?
   activeRuntimeThreads_[runtime] = pthread_self();
+  suspendedRuntimes_.erase(runtime);
+  std::unique_ptr<SampleRing> &ring = sampleRings_[runtime];
+  if (!ring) {
+    ring = llvm::make_unique<SampleRing>();
+  }
+  ring->nativeStackHigh = currentThreadStackHigh();
+  ThreadId tid = oscompat::thread_id();
+  // The counters follow the runtime to the thread that runs it.
+  if (hardwareCountersEnabled_ &&
+      (ring->tid != tid || !ring->perfCountersOpen.load())) {
+    ring->tid = tid;
+    ring->openPerfCounters();
+  }
+  ring->tid = tid;
   threadLocalRuntime_.set(runtime);
-  threadNames_[oscompat::thread_id()] = oscompat::thread_name();
+  threadLocalRing_.set(ring.get());
+  threadNames_[tid] = oscompat::thread_name();
 }
 
 void SamplingProfiler::unregisterRuntime(Runtime *runtime) {
   std::lock_guard<std::mutex> lockGuard(profilerLock_);
-  bool succeed = activeRuntimeThreads_.erase(runtime);
+  bool succeed = activeRuntimeThreads_.erase(runtime) ||
+      suspendedRuntimes_.erase(runtime);
   // TODO: should we allow recursive style
   // register/register -> unregister/unregister call?
   assert(succeed && "How can runtime not registered yet?");
   (void)succeed;
 
+  // The signal handler must not see the ring once it is freed.
   threadLocalRuntime_.set(nullptr);
+  threadLocalRing_.set(nullptr);
+  collectSamples();
+  auto it = sampleRings_.find(runtime);
+  if (it != sampleRings_.end()) {
+    droppedSamples_ += it->second->dropped.load(std::memory_order_relaxed);
+    sampleRings_.erase(it);
+  }
+}
+
+void SamplingProfiler::suspendRuntime(Runtime *runtime) {
+  std::lock_guard<std::mutex> lockGuard(profilerLock_);
+  bool succeed = activeRuntimeThreads_.erase(runtime);
+  assert(succeed && "Only a registered runtime can be suspended");
+  (void)succeed;
+  suspendedRuntimes_.insert(runtime);
+
+  // The thread may go on to run another runtime. The ring is kept, and its
+  // samples are collected by the timer thread as usual.
+  if (threadLocalRuntime_.get() == runtime) {
+    threadLocalRuntime_.set(nullptr);
+    threadLocalRing_.set(nullptr);
+  }
 }
 
 void SamplingProfiler::increaseDomainCount() {
@@ -72,7 +271,10 @@ void SamplingProfiler::decreaseDomainCount() {
   domains_.pop_back();
 }
 
-void SamplingProfiler::registerDomain(Domain *domain) {
+bool SamplingProfiler::registerDomain(Domain *domain) {
+  if (registeringDomain_.test_and_set(std::memory_order_acquire)) {
+    return false;
+  }
   // If domain is already registered do nothing, otherwise
   // store domain in the first unused/empty slot.
   // Invariant: domains_ are always filled from the front and the whole content
@@ -81,14 +283,16 @@ void SamplingProfiler::registerDomain(Domain *domain) {
   for (size_t i = 0, e = domains_.size(); i < e; ++i) {
     if (domains_[i] == domain) {
       // Already registered.
-      return;
+      break;
     } else if (domains_[i] == nullptr) {
       // Not registered before, fill in the first reserved empty slot.
       domains_[i] = domain;
-      return;
+      break;
     }
+    assert(i + 1 < e && "Cannot find a reserved null domain slot.");
   }
-  llvm_unreachable("Cannot find a reserved null domain slot.");
+  registeringDomain_.clear(std::memory_order_release);
+  return true;
 }
 
 int SamplingProfiler::invokeSignalAction(void (*handler)(int)) {
@@ -100,6 +304,18 @@ int SamplingProfiler::invokeSignalAction(void (*handler)(int)) {
   return sigaction(SIGPROF, &actions, nullptr);
 }
 
+int SamplingProfiler::invokeSignalAction(
+    void (*handler)(int, siginfo_t *, void *)) {
+  struct sigaction actions;
+  memset(&actions, 0, sizeof(actions));
+  sigemptyset(&actions.sa_mask);
+  // Restart the system calls interrupted by a sample rather than fail them
+  // with EINTR in the runtime thread.
+  actions.sa_flags = SA_SIGINFO | SA_RESTART;
+  actions.sa_sigaction = handler;
+  return sigaction(SIGPROF, &actions, nullptr);
+}
+
 bool SamplingProfiler::registerSignalHandlers() {
   if (isSigHandlerRegistered_) {
     return true;
@@ -125,83 +341,79 @@ bool SamplingProfiler::unregisterSignalHandler() {
   return true;
 }
 
-void SamplingProfiler::profilingSignalHandler(int signo) {
+void SamplingProfiler::profilingSignalHandler(
+    int signo,
+    siginfo_t *,
+    void *ucontext) {
+  // Don't clobber the errno of the interrupted code.
+  int savedErrno = errno;
   // Fetch runtime used by this sampling thread.
   auto profilerInstance = sProfilerInstance_.load();
+  assert(
+      profilerInstance != nullptr &&
+      "Why is sProfilerInstance_ not initialized yet?");
   Runtime *curThreadRuntime = profilerInstance->threadLocalRuntime_.get();
-  if (curThreadRuntime == nullptr) {
-    // Runtime may have unregistered itself before signal.
-    return;
-  }
-  // Sampling stack will touch GC objects(like closure) so
-  // only do so if heap is valid.
-  if (!curThreadRuntime->getHeap().inGC()) {
-    assert(
-        profilerInstance != nullptr &&
-        "Why is sProfilerInstance_ not initialized yet?");
-    profilerInstance->sampledStackDepth_ = profilerInstance->walkRuntimeStack(
-        curThreadRuntime, profilerInstance->sampleStorage_);
-  } else {
-    // TODO: log "GC in process" meta event.
-    profilerInstance->sampledStackDepth_ = 0;
-  }
-  if (!profilerInstance->samplingDoneSem_.notifyOne()) {
-    abort(); // Something is wrong.
+  SampleRing *ring = profilerInstance->threadLocalRing_.get();
+  // Runtime may have unregistered itself before signal.
+  if (curThreadRuntime && ring) {
+    uint32_t nativeDepth = walkNativeStack(
+        ucontext, ring->nativeStackHigh, ring->scratch, kMaxNativeStackDepth);
+    uint32_t runtimeDepth;
+    if (curThreadRuntime->getHeap().inGC()) {
+      // Sampling stack will touch GC objects(like closure) so only record
+      // that the heap was being collected.
+      ring->scratch[nativeDepth].kind = StackFrame::FrameKind::GC;
+      runtimeDepth = 1;
+    } else {
+      runtimeDepth = profilerInstance->walkRuntimeStack(
+          curThreadRuntime,
+          ring->scratch + nativeDepth,
+          kMaxStackDepth - nativeDepth);
+    }
+    if (runtimeDepth > 0) {
+      ring->push(
+          nativeDepth + runtimeDepth,
+          oscompat::thread_id(),
+          std::chrono::steady_clock::now());
+    }
   }
+  errno = savedErrno;
 }
 
-bool SamplingProfiler::sampleStack() {
+bool SamplingProfiler::sampleStacks(std::chrono::microseconds &interval) {
   std::lock_guard<std::mutex> lockGuard(profilerLock_);
   // Check profiling stopping request.
   if (!enabled_) {
     return false;
   }
 
+  // Signal every runtime thread to sample its stack. Each one writes to its
+  // own ring, so there is no need to wait for the handlers to finish. A signal
+  // sent while the previous one is still pending is coalesced with it, which
+  // only loses a sample.
   for (const auto &entry : activeRuntimeThreads_) {
-    auto targetThreadId = entry.second;
-    // Signal target runtime thread to sample stack.
-    pthread_kill(targetThreadId, SIGPROF);
-
-    // Threading: samplingDoneSem_ will synchronize with signal handler to
-    // to make sure there will NOT be two SIGPROF signals sent to the same
-    // runtime thread at the same time which prevents signal coalescing.
-    if (!samplingDoneSem_.wait()) {
-      return false;
-    }
-
-    if (sampledStackDepth_ > 0) {
-      assert(
-          sampledStackDepth_ <= sampleStorage_.stack.size() &&
-          "How can we sample more frames than storage?");
-      sampledStacks_.emplace_back(
-          sampleStorage_.tid,
-          sampleStorage_.timeStamp,
-          sampleStorage_.stack.begin(),
-          sampleStorage_.stack.begin() + sampledStackDepth_);
-    }
-
-    // Only sample the first thread for now.
-    // TODO: support sampling more than all active threads.
-    break;
+    pthread_kill(entry.second, SIGPROF);
   }
+
+  // Collect the samples taken so far. The ones being taken in response to
+  // the signals above will be collected on the next round.
+  collectSamples();
+  interval = samplingInterval_;
   return true;
 }
 
 void SamplingProfiler::timerLoop() {
-  while (true) {
-    if (!sampleStack()) {
-      return;
-    }
-
-    // TODO: make sampling rate configurable.
+  std::chrono::microseconds interval;
+  while (sampleStacks(interval)) {
     // TODO: add random fluctuation to interval value.
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::this_thread::sleep_for(interval);
   }
 }
 
 uint32_t SamplingProfiler::walkRuntimeStack(
     const Runtime *runtime,
-    StackTrace &sampleStorage) {
+    StackFrame *frames,
+    uint32_t capacity) {
   unsigned count = 0;
 
   // TODO: capture leaf frame IP.
@@ -210,7 +422,7 @@ uint32_t SamplingProfiler::walkRuntimeStack(
   bool capturedFrame = true;
   for (ConstStackFramePtr frame : runtime->getStackFrames()) {
     capturedFrame = true;
-    auto &frameStorage = sampleStorage.stack[count];
+    auto &frameStorage = frames[count];
     // Check if it is pure JS frame.
     auto *calleeCodeBlock = frame.getCalleeCodeBlock();
     if (calleeCodeBlock != nullptr) {
@@ -221,7 +433,10 @@ uint32_t SamplingProfiler::walkRuntimeStack(
       auto *module = calleeCodeBlock->getRuntimeModule();
       assert(module != nullptr && "Cannot fetch runtimeModule for code block");
       frameStorage.jsFrame.module = module;
-      registerDomain(module->getDomainUnsafe());
+      if (!registerDomain(module->getDomainUnsafe())) {
+        // The module could be freed before the sample is symbolicated.
+        return 0;
+      }
     } else {
       if (auto *nativeFunction =
               dyn_vmcast_or_null<NativeFunction>(frame.getCalleeClosure())) {
@@ -237,13 +452,11 @@ uint32_t SamplingProfiler::walkRuntimeStack(
     ip = frame.getSavedIP();
     if (capturedFrame) {
       ++count;
-      if (count >= sampleStorage.stack.size()) {
+      if (count >= capacity) {
         break;
       }
     }
   }
-  sampleStorage.tid = oscompat::thread_id();
-  sampleStorage.timeStamp = std::chrono::steady_clock::now();
   return count;
 }
 
@@ -275,7 +488,9 @@ uint32_t SamplingProfiler::walkRuntimeStack(
         profilerInstance != nullptr &&
         "Why is sProfilerInstance_ not initialized yet?");
     sampledStackDepth = profilerInstance->walkRuntimeStack(
-        curThreadRuntime, profilerInstance->sampleStorage_);
+        curThreadRuntime,
+        profilerInstance->sampleStorage_.stack.data(),
+        profilerInstance->sampleStorage_.stack.size());
   } else {
     // TODO: log "GC in process" meta event.
     sampledStackDepth = 0;
@@ -317,7 +532,7 @@ uint32_t SamplingProfiler::walkRuntimeStack(
 }
 #endif
 
-SamplingProfiler::SamplingProfiler() : sampleStorage_(kMaxStackDepth) {
+SamplingProfiler::SamplingProfiler() {
 #if defined(__ANDROID__) && defined(HERMES_FACEBOOK_BUILD)
   profilo_api()->register_external_tracer_callback(
       TRACER_TYPE_JAVASCRIPT, collectStackForLoom);
@@ -329,8 +544,18 @@ void SamplingProfiler::dumpSampledStack(llvm::raw_ostream &OS) {
   // TODO: serialize to visualizable trace format.
   std::lock_guard<std::mutex> lockGuard(profilerLock_);
 
+  // Include the samples which haven't been collected by the timer thread yet.
+  collectSamples();
+
   OS << "dumpSamples called from runtime\n";
   OS << "Total " << sampledStacks_.size() << " samples\n";
+  uint64_t dropped = droppedSamples_;
+  for (const auto &entry : sampleRings_) {
+    dropped += entry.second->dropped.load(std::memory_order_relaxed);
+  }
+  if (dropped) {
+    OS << dropped << " samples dropped\n";
+  }
   for (unsigned i = 0; i < sampledStacks_.size(); ++i) {
     auto &sample = sampledStacks_[i];
     uint64_t timeStamp = sample.timeStamp.time_since_epoch().count();
@@ -345,6 +570,10 @@ void SamplingProfiler::dumpSampledStack(llvm::raw_ostream &OS) {
         OS << "[JS]" << frame.jsFrame.functionId << ":" << frame.jsFrame.offset;
       } else if (frame.kind == StackFrame::FrameKind::NativeFunction) {
         OS << "[Native]" << frame.nativeFrame;
+      } else if (frame.kind == StackFrame::FrameKind::GC) {
+        OS << "[GC]";
+      } else if (frame.kind == StackFrame::FrameKind::NativeCode) {
+        OS << "[NativeCode]" << frame.nativeFrame;
       } else {
         llvm_unreachable("Unknown frame kind");
       }
@@ -356,6 +585,7 @@ void SamplingProfiler::dumpSampledStack(llvm::raw_ostream &OS) {
 
 void SamplingProfiler::dumpChromeTrace(llvm::raw_ostream &OS) {
   std::lock_guard<std::mutex> lockGuard(profilerLock_);
+  collectSamples();
   auto pid = getpid();
   ChromeTraceSerializer serializer(
       ChromeTraceFormat::create(pid, threadNames_, sampledStacks_));
@@ -363,14 +593,19 @@ void SamplingProfiler::dumpChromeTrace(llvm::raw_ostream &OS) {
   clear();
 }
 
+void SamplingProfiler::dumpPprof(llvm::raw_ostream &OS) {
+  std::lock_guard<std::mutex> lockGuard(profilerLock_);
+  collectSamples();
+  PprofSerializer(threadNames_, sampledStacks_, samplingInterval_)
+      .serialize(OS);
+  clear();
+}
+
 bool SamplingProfiler::enable() {
   std::lock_guard<std::mutex> lockGuard(profilerLock_);
   if (enabled_) {
     return true;
   }
-  if (!samplingDoneSem_.open(kSamplingDoneSemaphoreName)) {
-    return false;
-  }
   if (!registerSignalHandlers()) {
     return false;
   }
@@ -386,9 +621,6 @@ bool SamplingProfiler::disable() {
     // Already disabled.
     return true;
   }
-  if (!samplingDoneSem_.close()) {
-    return false;
-  }
   // Unregister handlers before shutdown.
   if (!unregisterSignalHandler()) {
     return false;
@@ -398,8 +630,157 @@ bool SamplingProfiler::disable() {
   return true;
 }
 
+bool SamplingProfiler::holdsSamples() {
+  std::lock_guard<std::mutex> lockGuard(profilerLock_);
+  if (enabled_) {
+    return true;
+  }
+  collectSamples();
+  return !sampledStacks_.empty() || !leafCounters_.empty();
+}
+
+void SamplingProfiler::setSamplingInterval(
+    std::chrono::microseconds interval) {
+  std::lock_guard<std::mutex> lockGuard(profilerLock_);
+  samplingInterval_ = interval;
+}
+
+void SamplingProfiler::collectSamples() {
+  size_t first = sampledStacks_.size();
+  for (const auto &entry : sampleRings_) {
+    entry.second->drain(sampledStacks_);
+  }
+  for (size_t i = first, e = sampledStacks_.size(); i < e; ++i) {
+    const StackTrace &sample = sampledStacks_[i];
+    if (std::all_of(
+            sample.counters,
+            sample.counters + kNumCounters,
+            [](uint64_t count) { return count == 0; })) {
+      continue;
+    }
+    // The leaf is the first frame of the runtime, after the native code.
+    auto it = std::find_if(
+        sample.stack.begin(), sample.stack.end(), [](const StackFrame &frame) {
+          return frame.kind != StackFrame::FrameKind::NativeCode;
+        });
+    if (it == sample.stack.end()) {
+      continue;
+    }
+    StackFrame leaf = *it;
+    std::pair<const void *, uintptr_t> key{nullptr, 0};
+    if (leaf.kind == StackFrame::FrameKind::JSFunction) {
+      leaf.jsFrame.offset = 0;
+      key = {leaf.jsFrame.module, leaf.jsFrame.functionId};
+    } else if (leaf.kind == StackFrame::FrameKind::NativeFunction) {
+      key.second = leaf.nativeFrame;
+    }
+    LeafCounters &counters = leafCounters_[key];
+    counters.leaf = leaf;
+    ++counters.samples;
+    for (unsigned c = 0; c < kNumCounters; ++c) {
+      counters.counters[c] += sample.counters[c];
+    }
+  }
+}
+
+bool SamplingProfiler::enableHardwareCounters() {
+  std::lock_guard<std::mutex> lockGuard(profilerLock_);
+  hardwareCountersEnabled_ = true;
+  bool opened = true;
+  for (const auto &entry : activeRuntimeThreads_) {
+    SampleRing &ring = *sampleRings_[entry.first];
+    if (!ring.perfCountersOpen.load()) {
+      ring.openPerfCounters();
+      opened &= ring.perfCountersOpen.load();
+    }
+  }
+  return opened;
+}
+
+void SamplingProfiler::disableHardwareCounters() {
+  std::lock_guard<std::mutex> lockGuard(profilerLock_);
+  hardwareCountersEnabled_ = false;
+  for (const auto &entry : sampleRings_) {
+    entry.second->closePerfCounters();
+  }
+}
+
+void SamplingProfiler::dumpHardwareCounters(llvm::raw_ostream &OS) {
+  std::lock_guard<std::mutex> lockGuard(profilerLock_);
+  collectSamples();
+
+  std::vector<const LeafCounters *> leaves;
+  for (const auto &entry : leafCounters_) {
+    leaves.push_back(&entry.second);
+  }
+  using Counter = instrumentation::ThreadPerfCounters::Counter;
+  std::sort(
+      leaves.begin(),
+      leaves.end(),
+      [](const LeafCounters *a, const LeafCounters *b) {
+        return a->counters[Counter::Cycles] > b->counters[Counter::Cycles];
+      });
+
+  JSONEmitter json(OS);
+  json.openArray();
+  for (const LeafCounters *counters : leaves) {
+    const StackFrame &leaf = counters->leaf;
+    json.openDict();
+    if (leaf.kind == StackFrame::FrameKind::JSFunction) {
+      hbc::BCProvider *bcProvider = leaf.jsFrame.module->getBytecode();
+      json.emitKeyValue(
+          "functionName",
+          bcProvider->getStringRefFromID(
+              bcProvider->getFunctionHeader(leaf.jsFrame.functionId)
+                  .functionName()));
+      json.emitKeyValue("functionId", leaf.jsFrame.functionId);
+      const hbc::DebugOffsets *debugOffsets =
+          bcProvider->getDebugOffsets(leaf.jsFrame.functionId);
+      if (debugOffsets &&
+          debugOffsets->sourceLocations != hbc::DebugOffsets::NO_OFFSET) {
+        const hbc::DebugInfo *debugInfo = bcProvider->getDebugInfo();
+        if (auto loc = debugInfo->getLocationForAddress(
+                debugOffsets->sourceLocations, 0)) {
+          json.emitKeyValue(
+              "url", debugInfo->getFilenameByID(loc->filenameId));
+          json.emitKeyValue("line", loc->line);
+          json.emitKeyValue("column", loc->column);
+        }
+      }
+    } else if (leaf.kind == StackFrame::FrameKind::NativeFunction) {
+      json.emitKeyValue(
+          "functionName",
+          "[Native]" + oscompat::to_string(leaf.nativeFrame));
+    } else {
+      json.emitKeyValue("functionName", "[GC]");
+    }
+    uint64_t cycles = counters->counters[Counter::Cycles];
+    uint64_t instructions = counters->counters[Counter::Instructions];
+    uint64_t cacheMisses = counters->counters[Counter::CacheMisses];
+    json.emitKeyValue("samples", counters->samples);
+    json.emitKeyValue("cycles", cycles);
+    json.emitKeyValue("instructions", instructions);
+    json.emitKeyValue("cacheMisses", cacheMisses);
+    json.emitKeyValue(
+        "instructionsPerCycle",
+        cycles ? static_cast<double>(instructions) / cycles : 0.0);
+    json.emitKeyValue(
+        "cacheMissesPerKiloInstruction",
+        instructions ? cacheMisses * 1000.0 / instructions : 0.0);
+    json.closeDict();
+  }
+  json.closeArray();
+  OS.flush();
+}
+
 void SamplingProfiler::clear() {
   sampledStacks_.clear();
+  // The modules of the JS functions may be freed with the domains below.
+  leafCounters_.clear();
+  droppedSamples_ = 0;
+  for (const auto &entry : sampleRings_) {
+    entry.second->dropped.store(0, std::memory_order_relaxed);
+  }
   // Release all strong roots to domains.
   // Note: we can't clear domains_ because we have to maintain the storage size.
   for (Domain *&domain : domains_) {
@@ -419,8 +800,11 @@ bool operator==(
     return left.jsFrame.functionId == right.jsFrame.functionId &&
         left.jsFrame.offset == right.jsFrame.offset;
   } else if (
-      left.kind == SamplingProfiler::StackFrame::FrameKind::NativeFunction) {
+      left.kind == SamplingProfiler::StackFrame::FrameKind::NativeFunction ||
+      left.kind == SamplingProfiler::StackFrame::FrameKind::NativeCode) {
     return left.nativeFrame == right.nativeFrame;
+  } else if (left.kind == SamplingProfiler::StackFrame::FrameKind::GC) {
+    return true;
   } else {
     llvm_unreachable("Unknown frame kind");
   }
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/RegExpCache.h"
+
+#include <cassert>
+
+namespace hermes {
+namespace vm {
+
+std::u16string RegExpCache::makeKey(
+    llvm::ArrayRef<char16_t> pattern,
+    uint8_t flags) {
+  std::u16string key;
+  key.reserve(pattern.size() + 1);
+  key.push_back(flags);
+  key.append(pattern.begin(), pattern.end());
+  return key;
+}
+
+OptValue<llvm::ArrayRef<uint8_t>> RegExpCache::lookup(
+    llvm::ArrayRef<char16_t> pattern,
+    uint8_t flags) {
+  auto it = index_.find(makeKey(pattern, flags));
+  if (it == index_.end()) {
+    ++misses_;
+    return llvm::None;
+  }
+  ++hits_;
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return llvm::makeArrayRef(it->second->bytecode);
+}
+
+void RegExpCache::insert(
+    llvm::ArrayRef<char16_t> pattern,
+    uint8_t flags,
+    std::vector<uint8_t> bytecode) {
+  if (capacity_ == 0)
+    return;
+  std::u16string key = makeKey(pattern, flags);
+  assert(!index_.count(key) && "pattern is already cached");
+  if (entries_.size() == capacity_) {
+    index_.erase(entries_.back().key);
+    entries_.pop_back();
+  }
+  entries_.push_front(Entry{key, std::move(bytecode)});
+  index_.emplace(std::move(key), entries_.begin());
+}
+
+size_t RegExpCache::clear() {
+  size_t freed = 0;
+  // Each key is held by its entry and by the index.
+  for (const Entry &entry : entries_)
+    freed += 2 * entry.key.capacity() * sizeof(char16_t) +
+        entry.bytecode.capacity();
+  index_.clear();
+  entries_.clear();
+  return freed;
+}
+
+} // namespace vm
+} // namespace hermes
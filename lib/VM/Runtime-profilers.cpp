@@ -17,6 +17,13 @@
 #include "hermes/Inst/InstDecode.h"
 #endif
 
+#ifdef HERMESVM_PROFILER_JSFUNCTION
+#include "hermes/Support/JSONEmitter.h"
+#include "hermes/Support/UTF8.h"
+
+#include <map>
+#endif
+
 namespace hermes {
 namespace vm {
 
@@ -66,6 +73,53 @@ void Runtime::dumpOpcodeStats(llvm::raw_ostream &os) const {
            << inst::getOpCodeString(static_cast<inst::OpCode>(op)).data()
            << std::setw(22) << t[op] << std::setw(11) << f[op] << "\n";
   }
+
+  // Report the most frequent sequences of opcodes, which are the candidates
+  // for superinstructions. Each sequence is packed one opcode per byte, the
+  // first opcode in the highest byte.
+  constexpr size_t kMaxSequences = 50;
+  auto dumpSequences = [&stream](
+                           const char *title,
+                           unsigned length,
+                           std::vector<std::pair<uint32_t, uint32_t>> &seqs) {
+    std::sort(
+        seqs.begin(),
+        seqs.end(),
+        [](const std::pair<uint32_t, uint32_t> &a,
+           const std::pair<uint32_t, uint32_t> &b) {
+          return a.second > b.second;
+        });
+    stream << "\n" << title << ":\n"
+           << std::left << std::setfill(' ') << std::setw(60)
+           << "==Opcodes==" << std::setw(11) << "==Frequency=="
+           << "\n";
+    for (size_t i = 0; i < seqs.size() && i < kMaxSequences; ++i) {
+      std::string names;
+      for (unsigned j = length; j-- > 0;) {
+        auto op = static_cast<inst::OpCode>((seqs[i].first >> (j * 8)) & 0xff);
+        names += inst::getOpCodeString(op).str();
+        if (j)
+          names += " ";
+      }
+      stream << std::left << std::setfill(' ') << std::setw(60) << names
+             << std::setw(11) << seqs[i].second << "\n";
+    }
+  };
+
+  std::vector<std::pair<uint32_t, uint32_t>> pairs;
+  const auto numOpcodes = static_cast<uint32_t>(inst::OpCode::_last);
+  for (uint32_t i = 0; i < numOpcodes; ++i) {
+    for (uint32_t j = 0; j < numOpcodes; ++j) {
+      if (opcodePairFrequency[i][j])
+        pairs.emplace_back((i << 8) | j, opcodePairFrequency[i][j]);
+    }
+  }
+  dumpSequences("Most frequent opcode pairs", 2, pairs);
+
+  std::vector<std::pair<uint32_t, uint32_t>> triples(
+      opcodeTripleFrequency.begin(), opcodeTripleFrequency.end());
+  dumpSequences("Most frequent opcode triples", 3, triples);
+
   os << stream.str();
 }
 #endif
@@ -193,6 +247,46 @@ void Runtime::dumpJSFunctionStats(ProfileType type) {
     llvm::outs() << " " << kv.second << "\n";
   }
 }
+
+/// Functions are identified by name, because that is how the compiler finds
+/// them in its IR. The calls of functions with the same name are added up,
+/// and anonymous functions are left out.
+void Runtime::dumpJSFunctionCallCounts(llvm::raw_ostream &OS) {
+  llvm::DenseMap<ProfilerID, uint64_t> calls;
+  for (const auto &event : functionEvents) {
+    if (event.isEnter)
+      ++calls[event.functionID];
+  }
+
+  std::map<std::string, uint64_t> callCounts;
+  GCScope gcScope{this};
+  SmallU16String<16> str;
+  std::string name;
+  for (const auto &kv : calls) {
+    gcScope.clearAllHandles();
+    const auto *info = getProfilerInfo(kv.first);
+    assert(info);
+    str.clear();
+    name.clear();
+    convertUTF16ToUTF8WithReplacements(
+        name,
+        getIdentifierTable()
+            .getStringView(this, info->functionName)
+            .getUTF16Ref(str));
+    if (!name.empty())
+      callCounts[name] += kv.second;
+  }
+
+  JSONEmitter json(OS);
+  json.openDict();
+  json.emitKey("call_counts");
+  json.openDict();
+  for (const auto &kv : callCounts)
+    json.emitKeyValue(kv.first, kv.second);
+  json.closeDict();
+  json.closeDict();
+  OS << "\n";
+}
 #endif
 
 #ifdef HERMESVM_PROFILER_NATIVECALL
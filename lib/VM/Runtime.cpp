@@ -18,7 +18,6 @@
 #include "hermes/Parser/JSParser.h"
 #include "hermes/Platform/Logging.h"
 #include "hermes/Runtime/Libhermes.h"
-#include "hermes/Support/CheckedMalloc.h"
 #include "hermes/Support/OSCompat.h"
 #include "hermes/Support/PerfSection.h"
 #include "hermes/VM/AlignedStorage.h"
@@ -32,7 +31,10 @@
 #include "hermes/VM/JSLib.h"
 #include "hermes/VM/JSLib/RuntimeCommonStorage.h"
 #include "hermes/VM/Operations.h"
+#include "hermes/VM/PlacedStorageProvider.h"
 #include "hermes/VM/PointerBase.h"
+#include "hermes/VM/Profiler/AllocationProfiler.h"
+#include "hermes/VM/Profiler/ExecutionTracer.h"
 #include "hermes/VM/Profiler/SamplingProfiler.h"
 #include "hermes/VM/RuntimeModule-inline.h"
 #include "hermes/VM/StackFrame-inline.h"
@@ -42,8 +44,11 @@
 #include "hermes/Support/MemoryBuffer.h"
 #endif
 
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/raw_ostream.h"
 
 namespace hermes {
@@ -68,6 +73,18 @@ static const Predefined::Str fixedPropCacheNames[(size_t)PropCacheID::_COUNT] =
 
 } // namespace
 
+/// Wrap \p provider in a PlacedStorageProvider if \p gcConfig asks for huge
+/// pages or NUMA-local storage.
+static std::unique_ptr<StorageProvider> placeStorage(
+    std::unique_ptr<StorageProvider> provider,
+    const GCConfig &gcConfig) {
+  if (!gcConfig.getHugePages() && !gcConfig.getNUMALocalHeap()) {
+    return provider;
+  }
+  return llvm::make_unique<PlacedStorageProvider>(
+      std::move(provider), gcConfig.getHugePages(), gcConfig.getNUMALocalHeap());
+}
+
 /* static */
 std::shared_ptr<Runtime> Runtime::create(const RuntimeConfig &runtimeConfig) {
   const GCConfig &gcConfig = runtimeConfig.getGCConfig();
@@ -86,7 +103,8 @@ std::shared_ptr<Runtime> Runtime::create(const RuntimeConfig &runtimeConfig) {
                   ", requested size: " + llvm::Twine(sz.storageFootprint()))
                      .str());
   }
-  std::shared_ptr<StorageProvider> provider{std::move(storageResult.get())};
+  std::shared_ptr<StorageProvider> provider{
+      placeStorage(std::move(storageResult.get()), gcConfig)};
   // Place Runtime in the first allocated storage.
   static_assert(
       sizeof(Runtime) <= AlignedStorage::size(),
@@ -109,7 +127,10 @@ std::shared_ptr<Runtime> Runtime::create(const RuntimeConfig &runtimeConfig) {
 #else
   // TODO(T31421960): This can become a unique_ptr with C++14 lambda
   // initializers.
-  std::shared_ptr<StorageProvider> provider{StorageProvider::mmapProvider()};
+  std::shared_ptr<StorageProvider> provider{placeStorage(
+      gcConfig.getProcessStoragePool() ? StorageProvider::pooledMmapProvider()
+                                       : StorageProvider::mmapProvider(),
+      gcConfig)};
   // When not using the flat address space, allocate runtime normally.
   Runtime *rt = new Runtime(provider.get(), runtimeConfig);
   // Return a shared pointer with a custom deleter to delete the underlying
@@ -185,6 +206,9 @@ Runtime::Runtime(StorageProvider *provider, const RuntimeConfig &runtimeConfig)
     // The initial heap size can't be larger than the max.
     : enableEval(runtimeConfig.getEnableEval()),
       verifyEvalIR(runtimeConfig.getVerifyEvalIR()),
+      quickeningThreshold(runtimeConfig.getQuickeningThreshold()),
+      evictColdLazyFunctions(runtimeConfig.getEvictColdLazyFunctions()),
+      releaseSharedPropertyMaps(runtimeConfig.getReleaseSharedPropertyMaps()),
       heap_(
           getMetadataTable(),
           this,
@@ -192,7 +216,11 @@ Runtime::Runtime(StorageProvider *provider, const RuntimeConfig &runtimeConfig)
           runtimeConfig.getGCConfig(),
           runtimeConfig.getCrashMgr(),
           provider),
-      jitContext_(runtimeConfig.getEnableJIT(), (1 << 20) * 8, (1 << 20) * 32),
+      jitContext_(
+          runtimeConfig.getEnableJIT(),
+          (1 << 20) * 8,
+          (1 << 20) * 32,
+          runtimeConfig.getJITThreshold()),
       hasES6Symbol_(runtimeConfig.getES6Symbol()),
       shouldRandomizeMemoryLayout_(runtimeConfig.getRandomizeMemoryLayout()),
       bytecodeWarmupPercent_(runtimeConfig.getBytecodeWarmupPercent()),
@@ -211,20 +239,37 @@ Runtime::Runtime(StorageProvider *provider, const RuntimeConfig &runtimeConfig)
   if (LLVM_UNLIKELY(maxNumRegisters > kMaxSupportedNumRegisters)) {
     hermes_fatal("RuntimeConfig maxNumRegisters too big");
   }
+  if (runtimeConfig.getPerfInterpreterTrampolines()) {
+    jitContext_.enableInterpreterTrampolines(runtimeConfig.getPerfJITDump());
+  } else if (runtimeConfig.getPerfMap() || runtimeConfig.getPerfJITDump()) {
+    jitContext_.enablePerfMap(runtimeConfig.getPerfJITDump());
+  }
+
   registerStack_ = runtimeConfig.getRegisterStack();
   if (!registerStack_) {
-    // registerStack_ should be allocated with malloc instead of new so that the
-    // default constructors don't run for the whole stack space.
-    const auto numBytesForRegisters =
-        sizeof(PinnedHermesValue) * maxNumRegisters;
-    registerStack_ =
-        static_cast<PinnedHermesValue *>(checkedMalloc(numBytesForRegisters));
+    // The register stack is mapped rather than allocated with new, so that
+    // the default constructors don't run for the whole stack space, and
+    // only the pages that are used are committed. The page below it is a
+    // guard page, so that running out of stack without checking for it
+    // faults instead of corrupting memory.
+    const size_t pageSize = oscompat::page_size();
+    const size_t numBytesForRegisters = llvm::alignTo(
+        sizeof(PinnedHermesValue) * maxNumRegisters, pageSize);
+    registerStackAllocSize_ = pageSize + numBytesForRegisters;
+    auto result = oscompat::vm_allocate(registerStackAllocSize_);
+    if (!result) {
+      hermes_fatal("Failed to allocate the register stack");
+    }
+    oscompat::vm_protect(*result, pageSize, oscompat::ProtectMode::None);
+    registerStack_ = reinterpret_cast<PinnedHermesValue *>(
+        static_cast<char *>(*result) + pageSize);
     crashMgr_->registerMemory(registerStack_, numBytesForRegisters);
   } else {
     freeRegisterStack_ = false;
   }
 
   registerStackEnd_ = registerStack_ + maxNumRegisters;
+  registerStackLimit_ = registerStack_ + STACK_RESERVE;
   if (shouldRandomizeMemoryLayout_) {
     const unsigned bytesOff = std::random_device()() % oscompat::page_size();
     registerStackEnd_ -= bytesOff / sizeof(PinnedHermesValue);
@@ -308,7 +353,9 @@ Runtime::~Runtime() {
   crashMgr_->unregisterCallback(crashCallbackKey_);
   if (freeRegisterStack_) {
     crashMgr_->unregisterMemory(registerStack_);
-    ::free(registerStack_);
+    oscompat::vm_free(
+        reinterpret_cast<char *>(registerStack_) - oscompat::page_size(),
+        registerStackAllocSize_);
   }
   // Remove inter-module dependencies so we can delete them in any order.
   for (auto &module : runtimeModuleList_) {
@@ -374,6 +421,9 @@ void Runtime::markRoots(
     acceptor.acceptPtr(rootClazzRawPtr_, "@rootClass");
     acceptor.accept(stringCycleCheckVisited_, "@stringCycleCheckVisited");
     acceptor.accept(global_, "@global");
+    acceptor.accept(globalTemplate_, "@globalTemplate");
+    for (auto &job : jobQueue_)
+      acceptor.accept(job, "@job");
 #ifdef HERMES_ENABLE_DEBUGGER
     acceptor.accept(debuggerInternalObject_, "@debuggerInternal");
 #endif // HERMES_ENABLE_DEBUGGER
@@ -394,6 +444,8 @@ void Runtime::markRoots(
     if (markLongLived) {
       for (auto &hv : charStrings_)
         acceptor.accept(hv);
+      for (auto &hv : intStrings_)
+        acceptor.accept(hv);
     }
   }
 
@@ -401,6 +453,8 @@ void Runtime::markRoots(
     MarkRootsPhaseTimer timer(this, MarkRootsPhase::Builtins);
     for (NativeFunction *&nf : builtins_)
       acceptor.accept((void *&)nf);
+    for (auto &entry : lazyConstructors_)
+      acceptor.accept(entry.constructor, "@lazyConstructor");
   }
 
 #ifdef MARK
@@ -439,9 +493,15 @@ void Runtime::markRoots(
     MARK(throwTypeErrorAccessor);
     MARK(arrayClass);
     acceptor.acceptPtr(arrayClassRawPtr, "@arrayClass");
+    for (PinnedHermesValue &clazz : lazyFunctionClasses)
+      acceptor.accept(clazz, "@lazyFunctionClass");
     MARK(iteratorPrototype);
     MARK(arrayIteratorPrototype);
+    MARK(arrayIteratorPrototypeNext);
     MARK(arrayPrototypeValues);
+    MARK(arrayPrototypeToString);
+    MARK(functionPrototypeApply);
+    MARK(functionPrototypeCall);
     MARK(stringIteratorPrototype);
     MARK(generatorFunctionPrototype);
     MARK(generatorPrototype);
@@ -491,6 +551,20 @@ void Runtime::markRoots(
     }
   }
 
+  {
+    MarkRootsPhaseTimer timer(this, MarkRootsPhase::AllocationProfiler);
+    if (allocationProfiler_) {
+      allocationProfiler_->markRoots(acceptor);
+    }
+  }
+
+  {
+    MarkRootsPhaseTimer timer(this, MarkRootsPhase::ExecutionTracer);
+    if (executionTracer_) {
+      executionTracer_->markRoots(acceptor);
+    }
+  }
+
   {
     MarkRootsPhaseTimer timer(this, MarkRootsPhase::Custom);
     for (auto &fn : customMarkRootFuncs_)
@@ -531,6 +605,83 @@ void Runtime::printRuntimeGCStats(llvm::raw_ostream &os) const {
   os << "\n\t}";
 }
 
+MemoryPressureReport Runtime::handleMemoryPressure(MemoryPressureLevel level) {
+  MemoryPressureReport report{};
+  report.regExpCache = regExpCache_.clear();
+  report.evalCache = evalCache_.clear();
+
+  if (level >= MemoryPressureLevel::Moderate) {
+    // The tables only refer to their classes and storage weakly, so dropping
+    // them does not change what the collection frees.
+    for (auto &rm : runtimeModuleList_)
+      report.literalCaches += rm.clearLiteralCaches();
+    report.propertyMaps = releasePropertyMaps();
+  }
+  if (level >= MemoryPressureLevel::Critical)
+    report.jitCode = jitContext_.evictInactive(this);
+
+  if (level >= MemoryPressureLevel::Moderate) {
+    GCBase::HeapInfo before;
+    heap_.getHeapInfo(before);
+    heap_.collect();
+    GCBase::HeapInfo after;
+    heap_.getHeapInfo(after);
+    if (before.allocatedBytes > after.allocatedBytes)
+      report.collected = before.allocatedBytes - after.allocatedBytes;
+  }
+  report.heapReleased =
+      heap_.releaseUnusedMemory(level >= MemoryPressureLevel::Critical);
+  return report;
+}
+
+size_t Runtime::releasePropertyMaps() {
+  propertyMapReleasePending_ = false;
+  size_t released = 0;
+  heap_.forAllObjs([this, &released](GCCell *cell) {
+    if (auto *hiddenClass = dyn_vmcast<HiddenClass>(cell))
+      released += hiddenClass->releaseSharedPropertyMap(this);
+  });
+  return released;
+}
+
+size_t Runtime::evictColdFunctions(const CodeBlock *running) {
+  coldFunctionEvictionPending_ = false;
+#ifndef HERMESVM_LEAN
+  // The profilers and the debugger record bytecode offsets, which could only
+  // be resolved with the bytecode they were recorded in.
+  if (allocationProfiler_ || executionTracer_ ||
+      samplingProfiler_->holdsSamples()) {
+    return 0;
+  }
+#ifdef HERMES_ENABLE_DEBUGGER
+  if (debugger_.getIsDebuggerAttached() || debugger_.isDebugging()) {
+    return 0;
+  }
+#endif
+
+  llvm::DenseSet<const CodeBlock *> active{running};
+  for (StackFramePtr frame : getStackFrames()) {
+    active.insert(frame.getCalleeCodeBlock());
+    active.insert(frame.getSavedCodeBlock());
+  }
+
+  size_t freed = 0;
+  for (RuntimeModule &rm : runtimeModuleList_) {
+    CodeBlock *codeBlock = rm.getEvictableCodeBlock();
+    // Functions whose bytecode was patched or compiled to native code keep
+    // it, since it may be running or be referred to by the debugger.
+    if (!codeBlock || codeBlock->takeCalledSinceEviction() ||
+        active.count(codeBlock) || codeBlock->hasPrivateBytecode() ||
+        codeBlock->getJITCompiled())
+      continue;
+    freed += rm.evictLazyCompiled();
+  }
+  return freed;
+#else
+  return 0;
+#endif
+}
+
 void Runtime::printHeapStats(llvm::raw_ostream &os) {
   getHeap().printAllCollectedStats(os);
   for (auto &module : getRuntimeModules()) {
@@ -548,6 +699,9 @@ unsigned Runtime::getSymbolsEnd() const {
 
 void Runtime::freeSymbols(const std::vector<bool> &markedSymbols) {
   identifierTable_.freeUnmarkedSymbols(markedSymbols);
+  // This is the end of a full collection.
+  coldFunctionEvictionPending_ = evictColdLazyFunctions;
+  propertyMapReleasePending_ = releaseSharedPropertyMaps;
 }
 
 size_t Runtime::mallocSize() const {
@@ -828,6 +982,85 @@ Handle<JSObject> Runtime::getGlobal() {
   return Handle<JSObject>::vmcast(&global_);
 }
 
+void Runtime::enqueueJob(Handle<Callable> job) {
+  jobQueue_.emplace_back(job.getHermesValue());
+}
+
+CallResult<bool> Runtime::drainJobs(
+    std::chrono::steady_clock::time_point deadline) {
+  GCScope gcScope(this);
+  MutableHandle<Callable> job{this};
+  auto marker = gcScope.createMarker();
+  while (!jobQueue_.empty()) {
+    gcScope.flushToMarker(marker);
+    job = vmcast<Callable>(jobQueue_.front());
+    jobQueue_.pop_front();
+    if (LLVM_UNLIKELY(
+            Callable::executeCall0(job, this, getUndefinedValue()) ==
+            ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    if (deadline != std::chrono::steady_clock::time_point::max() &&
+        std::chrono::steady_clock::now() >= deadline) {
+      break;
+    }
+  }
+  return jobQueue_.empty();
+}
+
+/// Copy the own named properties of the global object \p src, with their
+/// flags, into a new object with the same prototype. Properties referring to
+/// \p src itself, like a "global" property defined by the host, refer to the
+/// copy instead.
+static CallResult<HermesValue> copyGlobalObject(
+    Runtime *runtime,
+    Handle<JSObject> src) {
+  auto dst = toHandle(
+      runtime,
+      JSObject::create(runtime, runtime->makeHandle(src->getParent(runtime))));
+
+  // Collect the properties first, since defining them may allocate.
+  std::vector<std::pair<SymbolID, NamedPropertyDescriptor>> props;
+  HiddenClass::forEachProperty(
+      runtime->makeHandle(src->getClass(runtime)),
+      runtime,
+      [&props](SymbolID id, NamedPropertyDescriptor desc) {
+        props.emplace_back(id, desc);
+      });
+
+  MutableHandle<> value{runtime};
+  for (const auto &prop : props) {
+    GCScopeMarkerRAII marker{runtime};
+    value = JSObject::getNamedSlotValue(*src, runtime, prop.second);
+    if (value->getRaw() == src.getHermesValue().getRaw())
+      value = dst.getHermesValue();
+    if (LLVM_UNLIKELY(
+            JSObject::defineNewOwnProperty(
+                dst, runtime, prop.first, prop.second.flags, value) ==
+            ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+  return dst.getHermesValue();
+}
+
+void Runtime::saveGlobalObjectTemplate() {
+  GCScope gcScope(this);
+  globalTemplate_ = ignoreAllocationFailure(copyGlobalObject(this, getGlobal()));
+}
+
+ExecutionStatus Runtime::resetGlobalObject() {
+  assert(
+      globalTemplate_.isObject() && "saveGlobalObjectTemplate() not called");
+  GCScope gcScope(this);
+  auto res =
+      copyGlobalObject(this, Handle<JSObject>::vmcast(&globalTemplate_));
+  if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  global_ = *res;
+  return ExecutionStatus::RETURNED;
+}
+
 std::vector<llvm::ArrayRef<uint8_t>> Runtime::getEpilogues() {
   std::vector<llvm::ArrayRef<uint8_t>> result;
   for (const auto &m : runtimeModuleList_) {
@@ -1330,6 +1563,26 @@ void Runtime::freezeBuiltins() {
   builtinsFrozen_ = true;
 }
 
+void Runtime::registerLazyConstructor(
+    Handle<NativeConstructor> cons,
+    LazyConstructorInitializer init) {
+  assert(cons->isLazy() && "registered constructor must be lazy");
+  lazyConstructors_.push_back({cons.getHermesValue(), init});
+}
+
+void Runtime::initializeLazyConstructor(Handle<NativeConstructor> cons) {
+  auto it = llvm::find_if(
+      lazyConstructors_, [&cons](const LazyConstructor &entry) {
+        return entry.constructor.getObject() == cons.get();
+      });
+  assert(it != lazyConstructors_.end() && "lazy constructor not registered");
+  LazyConstructorInitializer init = it->init;
+  lazyConstructors_.erase(it);
+
+  GCScope gcScope{this, "initializeLazyConstructor"};
+  init(this, cons);
+}
+
 uint64_t Runtime::gcStableHashHermesValue(Handle<HermesValue> value) {
   switch (value->getTag()) {
     case ObjectTag: {
@@ -1394,6 +1647,74 @@ void Runtime::dumpCallFrames() {
   dumpCallFrames(llvm::errs());
 }
 
+/// Functions are identified by their ID in the bytecode, so the feedback only
+/// applies to bytecode compiled from the same sources with the same options.
+/// A quickened instruction only ever saw number operands since it was last
+/// rewritten, which makes it a site to speculate on.
+void Runtime::dumpTypeFeedback(llvm::raw_ostream &OS) {
+  JSONEmitter json(OS);
+  json.openDict();
+  json.emitKey("functions");
+  json.openArray();
+  std::vector<uint32_t> offsets;
+  for (auto &runtimeModule : getRuntimeModules()) {
+    for (CodeBlock *codeBlock : runtimeModule.getFunctionMap()) {
+      if (!codeBlock)
+        continue;
+      offsets.clear();
+      codeBlock->getQuickenedOffsets(offsets);
+      if (offsets.empty())
+        continue;
+      json.openDict();
+      json.emitKeyValue("function_id", codeBlock->getFunctionID());
+      json.emitKey("number_sites");
+      json.openArray();
+      json.emitValues(llvm::makeArrayRef(offsets));
+      json.closeArray();
+      json.closeDict();
+    }
+  }
+  json.closeArray();
+  json.closeDict();
+  OS << "\n";
+}
+
+void Runtime::startAllocationProfiler(uint32_t samplingInterval) {
+  allocationProfiler_ =
+      llvm::make_unique<AllocationProfiler>(this, samplingInterval);
+  bytesUntilAllocationSample_ = allocationProfiler_->nextSampleDistance();
+}
+
+void Runtime::stopAllocationProfiler() {
+  bytesUntilAllocationSample_ = INT64_MAX;
+}
+
+void Runtime::dumpAllocationProfile(llvm::raw_ostream &OS) {
+  if (allocationProfiler_) {
+    allocationProfiler_->serialize(OS);
+  }
+}
+
+void Runtime::startExecutionTrace() {
+  executionTracer_ = llvm::make_unique<ExecutionTracer>(this);
+  activeExecutionTracer_ = executionTracer_.get();
+}
+
+void Runtime::stopExecutionTrace() {
+  activeExecutionTracer_ = nullptr;
+}
+
+void Runtime::dumpExecutionTrace(llvm::raw_ostream &OS) {
+  if (executionTracer_) {
+    executionTracer_->serialize(OS);
+  }
+}
+
+void Runtime::sampleAllocation(void *cell, uint32_t size) {
+  assert(allocationProfiler_ && "sampling without an allocation profiler");
+  bytesUntilAllocationSample_ = allocationProfiler_->sample(cell, size);
+}
+
 StackRuntime::StackRuntime(
     StorageProvider *provider,
     const RuntimeConfig &config)
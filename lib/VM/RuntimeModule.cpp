@@ -19,6 +19,8 @@
 namespace hermes {
 namespace vm {
 
+constexpr uint32_t RuntimeModule::kStringPageSize;
+
 RuntimeModule::RuntimeModule(
     Runtime *runtime,
     Handle<Domain> domain,
@@ -60,10 +62,15 @@ SymbolID RuntimeModule::createSymbolFromStringIDMayAllocate(
 RuntimeModule::~RuntimeModule() {
   runtime_->removeRuntimeModule(this);
 
+  // The samples of the GC may point into the allocation sites of the
+  // CodeBlocks deleted below.
+  runtime_->getHeap().clearAllocationSiteSamples();
+
   // We may reference other CodeBlocks through lazy compilation, but we only
   // own the ones that reference us.
   for (auto *block : functionMap_) {
     if (block != nullptr && block->getRuntimeModule() == this) {
+      runtime_->getJITContext().freeCode(block);
       delete block;
     }
   }
@@ -86,6 +93,9 @@ CallResult<RuntimeModule *> RuntimeModule::create(
     llvm::StringRef sourceURL) {
   auto *result = new RuntimeModule(runtime, domain, flags, sourceURL);
   if (bytecode) {
+    auto &stats = runtime->getRuntimeStats();
+    const instrumentation::RAIITimer timer{
+        "RuntimeModule Init", stats, stats.runtimeModuleInit};
     if (result->initializeMayAllocate(std::move(bytecode)) ==
         ExecutionStatus::EXCEPTION) {
       return ExecutionStatus::EXCEPTION;
@@ -157,6 +167,10 @@ RuntimeModule *RuntimeModule::createLazyModule(
   RM->stringIDMap_.push_back(parent->getSymbolIDFromStringIDMayAllocate(
       bcFunction->getHeader().functionName));
 
+  RM->lazyFunction_ = bcFunction;
+  RM->lazyFunctionID_ = functionID;
+  RM->lazyName_ = RM->stringIDMap_[0];
+
   return RM;
 }
 
@@ -207,6 +221,47 @@ void RuntimeModule::initializeLazyMayAllocate(
   functionMap_[bcProvider_->getGlobalFunctionIndex()] = functionMap_[0];
   functionMap_[0] = nullptr;
 }
+
+CodeBlock *RuntimeModule::getEvictableCodeBlock() const {
+  if (!lazyFunction_ || !isInitialized() || !templateObjects_.empty()) {
+    return nullptr;
+  }
+  const uint32_t entry = bcProvider_->getGlobalFunctionIndex();
+  for (uint32_t i = 0, e = functionMap_.size(); i < e; ++i) {
+    if (i != entry && functionMap_[i]) {
+      return nullptr;
+    }
+  }
+  return functionMap_[entry];
+}
+
+size_t RuntimeModule::evictLazyCompiled() {
+  CodeBlock *codeBlock = getEvictableCodeBlock();
+  assert(codeBlock && "module cannot be made lazy again");
+
+  const hbc::BCProvider &bc = *bcProvider_;
+  size_t freed = bc.getStringStorage().size() + bc.getArrayBuffer().size() +
+      bc.getObjectKeyBuffer().size() + bc.getObjectValueBuffer().size() +
+      bc.getRegExpStorage().size() +
+      stringIDMap_.capacity() * sizeof(SymbolID) +
+      stringPages_.capacity() * sizeof(StringPage) +
+      functionMap_.capacity() * sizeof(CodeBlock *) + clearLiteralCaches();
+  for (uint32_t i = 0, e = bc.getFunctionCount(); i < e; ++i) {
+    freed += bc.getFunctionHeader(i).bytecodeSizeInBytes();
+  }
+
+  // Undo initializeLazyMayAllocate(). The name is still registered, since the
+  // parent module maps it too.
+  bcProvider_ = hbc::BCProviderLazy::createBCProviderLazy(lazyFunction_);
+  functionMap_ = {codeBlock};
+  stringIDMap_ = {lazyName_};
+  stringPages_ = {};
+  // The samples of the GC point into the allocation sites being dropped.
+  runtime_->getHeap().clearAllocationSiteSamples();
+  codeBlock->resetToLazy(
+      bcProvider_->getFunctionHeader(lazyFunctionID_), lazyFunctionID_);
+  return freed;
+}
 #endif
 
 void RuntimeModule::importStringIDMapMayAllocate() {
@@ -221,9 +276,17 @@ void RuntimeModule::importStringIDMapMayAllocate() {
   // Populate the string ID map with empty identifiers.
   stringIDMap_.resize(strTableSize, SymbolID::empty());
 
-  // Preallocate enough space to store all identifiers to prevent
-  // unnecessary allocations.
-  runtime_->getIdentifierTable().reserve(strTableSize);
+  // The identifiers of a persistent module are registered lazily, page by
+  // page, when they are first needed: large bundles contain many identifiers
+  // that are never used. Other modules cannot do that without allocating, so
+  // they register all of them up front.
+  bool lazyIdentifiers = flags_.persistent;
+
+  if (!lazyIdentifiers) {
+    // Preallocate enough space to store all identifiers to prevent
+    // unnecessary allocations.
+    runtime_->getIdentifierTable().reserve(strTableSize);
+  }
 
   if (runtime_->getVMExperimentFlags() &
       experiments::MAdviseStringsSequential) {
@@ -235,36 +298,34 @@ void RuntimeModule::importStringIDMapMayAllocate() {
   }
 
   // Get the array of pre-computed translations from identifiers in the bytecode
-  // to their runtime representation as SymbolIDs.
+  // to their runtime representation as SymbolIDs, and record where each page
+  // of the string table starts in it.
   auto kinds = bcProvider_->getStringKinds();
   auto translations = bcProvider_->getIdentifierTranslations();
   assert(
       translations.size() <= strTableSize &&
       "Should not have more strings than identifiers");
+  stringPages_.clear();
+  stringPages_.reserve((strTableSize + kStringPageSize - 1) / kStringPageSize);
   {
     StringID strID = 0;
     uint32_t trnID = 0;
 
-    for (auto entry : kinds) {
-      switch (entry.kind()) {
-        case StringKind::String:
-          strID += entry.count();
-          break;
-
-        case StringKind::Identifier:
-          for (uint32_t i = 0; i < entry.count(); ++i, ++strID, ++trnID) {
-            createSymbolFromStringIDMayAllocate(
-                strID,
-                bcProvider_->getStringTableEntry(strID),
-                translations[trnID]);
-          }
-          break;
-
-        case StringKind::Predefined:
-          for (uint32_t i = 0; i < entry.count(); ++i, ++strID, ++trnID) {
-            mapPredefined(strID, translations[trnID]);
-          }
-          break;
+    for (uint32_t kindIndex = 0, e = kinds.size(); kindIndex < e; ++kindIndex) {
+      auto entry = kinds[kindIndex];
+      for (uint32_t i = 0; i < entry.count();) {
+        uint32_t pageOffset = strID % kStringPageSize;
+        if (pageOffset == 0) {
+          stringPages_.push_back({kindIndex, i, trnID, false});
+        }
+        // Skip to the end of the entry or of the page, whichever comes first.
+        uint32_t count =
+            std::min(entry.count() - i, kStringPageSize - pageOffset);
+        i += count;
+        strID += count;
+        if (entry.kind() != StringKind::String) {
+          trnID += count;
+        }
       }
     }
 
@@ -272,6 +333,12 @@ void RuntimeModule::importStringIDMapMayAllocate() {
     assert(trnID == translations.size() && "Should translate all identifiers.");
   }
 
+  if (!lazyIdentifiers) {
+    for (uint32_t i = 0, e = stringPages_.size(); i < e; ++i) {
+      materializeStringPageAt(i);
+    }
+  }
+
   if (runtime_->getVMExperimentFlags() & experiments::MAdviseStringsRandom) {
     bcProvider_->adviseStringTableRandom();
   }
@@ -292,6 +359,58 @@ void RuntimeModule::importStringIDMapMayAllocate() {
   }
 }
 
+SymbolID RuntimeModule::materializeStringPage(StringID stringID) {
+  uint32_t pageIndex = stringID / kStringPageSize;
+  if (pageIndex < stringPages_.size()) {
+    materializeStringPageAt(pageIndex);
+  }
+  return stringIDMap_[stringID];
+}
+
+void RuntimeModule::materializeStringPageAt(uint32_t pageIndex) {
+  StringPage &page = stringPages_[pageIndex];
+  if (page.materialized) {
+    return;
+  }
+  page.materialized = true;
+
+  auto kinds = bcProvider_->getStringKinds();
+  auto translations = bcProvider_->getIdentifierTranslations();
+  StringID strID = pageIndex * kStringPageSize;
+  StringID end = std::min<StringID>(
+      strID + kStringPageSize, bcProvider_->getStringCount());
+  uint32_t kindIndex = page.kindIndex;
+  uint32_t kindOffset = page.kindOffset;
+  uint32_t trnID = page.translationIndex;
+
+  while (strID < end) {
+    auto entry = kinds[kindIndex];
+    uint32_t count = std::min(entry.count() - kindOffset, end - strID);
+    switch (entry.kind()) {
+      case StringKind::String:
+        strID += count;
+        break;
+
+      case StringKind::Identifier:
+        for (uint32_t i = 0; i < count; ++i, ++strID, ++trnID) {
+          createSymbolFromStringIDMayAllocate(
+              strID,
+              bcProvider_->getStringTableEntry(strID),
+              translations[trnID]);
+        }
+        break;
+
+      case StringKind::Predefined:
+        for (uint32_t i = 0; i < count; ++i, ++strID, ++trnID) {
+          mapPredefined(strID, translations[trnID]);
+        }
+        break;
+    }
+    ++kindIndex;
+    kindOffset = 0;
+  }
+}
+
 void RuntimeModule::initializeFunctionMap() {
   assert(bcProvider_ && "Uninitialized RuntimeModule");
   assert(
@@ -368,8 +487,9 @@ SymbolID RuntimeModule::mapPredefined(StringID stringID, uint32_t rawSymbolID) {
 }
 
 void RuntimeModule::markRoots(SlotAcceptor &acceptor, bool markLongLived) {
-  for (auto &it : templateMap_) {
-    acceptor.acceptPtr(it.second);
+  for (JSObject *&templateObj : templateObjects_) {
+    if (templateObj)
+      acceptor.acceptPtr(templateObj);
   }
 
   if (markLongLived) {
@@ -394,6 +514,11 @@ void RuntimeModule::markWeakRoots(SlotAcceptor &acceptor) {
       acceptor.accept(reinterpret_cast<void *&>(entry.second));
     }
   }
+  for (auto &entry : arrayLiteralStorages_) {
+    if (entry.second.first) {
+      acceptor.accept(reinterpret_cast<void *&>(entry.second.first));
+    }
+  }
 }
 
 void RuntimeModule::markDomainRef(GC *gc) {
@@ -427,11 +552,34 @@ void RuntimeModule::tryCacheLiteralHiddenClass(
   }
 }
 
+SegmentedArray *RuntimeModule::findCachedLiteralArrayStorage(
+    unsigned bufferIndex,
+    unsigned numLiterals,
+    bool &allNumbers) const {
+  auto it = arrayLiteralStorages_.find(
+      getLiteralArrayStorageCacheKey(bufferIndex, numLiterals));
+  if (it == arrayLiteralStorages_.end())
+    return nullptr;
+  allNumbers = it->second.second;
+  return it->second.first;
+}
+
+size_t RuntimeModule::clearLiteralCaches() {
+  const size_t freed = objectLiteralHiddenClasses_.getMemorySize() +
+      arrayLiteralStorages_.getMemorySize();
+  // Assigning empty maps releases their buckets, which clear() keeps.
+  objectLiteralHiddenClasses_ = {};
+  arrayLiteralStorages_ = {};
+  return freed;
+}
+
 size_t RuntimeModule::additionalMemorySize() const {
   size_t total = stringIDMap_.capacity() * sizeof(SymbolID) +
+      stringPages_.capacity() * sizeof(StringPage) +
       functionMap_.capacity() * sizeof(CodeBlock *) +
       objectLiteralHiddenClasses_.getMemorySize() +
-      templateMap_.getMemorySize();
+      arrayLiteralStorages_.getMemorySize() +
+      templateObjects_.capacity() * sizeof(JSObject *);
   // Add the size of each CodeBlock
   for (const CodeBlock *cb : functionMap_) {
     // Skip the null code blocks, they are lazily inserted the first time
@@ -9,9 +9,93 @@
 #include "hermes/VM/GCPointer-inline.h"
 #include "hermes/VM/HermesValue-inline.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define HERMES_SEGMENTEDARRAY_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define HERMES_SEGMENTEDARRAY_NEON
+#endif
+
 namespace hermes {
 namespace vm {
 
+namespace {
+
+#if defined(HERMES_SEGMENTEDARRAY_SSE2)
+using RawNeedle = __m128i;
+
+RawNeedle makeRawNeedle(uint64_t raw) {
+  return _mm_set1_epi64x((long long)raw);
+}
+
+/// \return true if one of the 4 elements at \p elems is encoded as
+/// \p needle.
+bool anyRawMatch4(const GCHermesValue *elems, RawNeedle needle) {
+  __m128i lo = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)elems), needle);
+  __m128i hi =
+      _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(elems + 2)), needle);
+  // SSE2 only compares 32-bit lanes: an element matches if both of its halves
+  // do.
+  unsigned mask = _mm_movemask_ps(_mm_castsi128_ps(lo)) |
+      (_mm_movemask_ps(_mm_castsi128_ps(hi)) << 4);
+  return mask & (mask >> 1) & 0x55;
+}
+#elif defined(HERMES_SEGMENTEDARRAY_NEON)
+using RawNeedle = uint64x2_t;
+
+RawNeedle makeRawNeedle(uint64_t raw) {
+  return vdupq_n_u64(raw);
+}
+
+/// \return true if one of the 4 elements at \p elems is encoded as
+/// \p needle.
+bool anyRawMatch4(const GCHermesValue *elems, RawNeedle needle) {
+  uint64x2_t lo = vceqq_u64(vld1q_u64((const uint64_t *)elems), needle);
+  uint64x2_t hi = vceqq_u64(vld1q_u64((const uint64_t *)(elems + 2)), needle);
+  return vmaxvq_u32(vreinterpretq_u32_u64(vorrq_u64(lo, hi))) != 0;
+}
+#endif
+
+/// \return the index of the first of the \p n elements at \p elems that is
+/// encoded as \p raw, or \p n if there is none.
+size_t findRawForward(const GCHermesValue *elems, size_t n, uint64_t raw) {
+  size_t i = 0;
+#if defined(HERMES_SEGMENTEDARRAY_SSE2) || defined(HERMES_SEGMENTEDARRAY_NEON)
+  const RawNeedle needle = makeRawNeedle(raw);
+  for (; n - i >= 4; i += 4) {
+    if (anyRawMatch4(elems + i, needle))
+      break;
+  }
+#endif
+  // Find the exact match within the last, partial or matching, chunk.
+  for (; i != n; ++i) {
+    if (elems[i].getRaw() == raw)
+      return i;
+  }
+  return n;
+}
+
+/// \return the index of the last of the \p n elements at \p elems that is
+/// encoded as \p raw, or \p n if there is none.
+size_t findRawBackward(const GCHermesValue *elems, size_t n, uint64_t raw) {
+  size_t i = n;
+#if defined(HERMES_SEGMENTEDARRAY_SSE2) || defined(HERMES_SEGMENTEDARRAY_NEON)
+  const RawNeedle needle = makeRawNeedle(raw);
+  for (; i >= 4; i -= 4) {
+    if (anyRawMatch4(elems + i - 4, needle))
+      break;
+  }
+#endif
+  while (i != 0) {
+    if (elems[--i].getRaw() == raw)
+      return i;
+  }
+  return n;
+}
+
+} // namespace
+
 VTable SegmentedArray::Segment::vt(
     CellKind::SegmentKind,
     sizeof(SegmentedArray::Segment));
@@ -271,6 +355,74 @@ void SegmentedArray::growLeftWithinCapacity(
       self->begin(), self->begin() + amount, HermesValue::encodeEmptyValue());
 }
 
+void SegmentedArray::copyRange(
+    Runtime *runtime,
+    SegmentedArray *src,
+    size_type srcIndex,
+    SegmentedArray *dst,
+    size_type dstIndex,
+    size_type count) {
+  assert(
+      srcIndex <= src->size() && count <= src->size() - srcIndex &&
+      dstIndex <= dst->size() && count <= dst->size() - dstIndex &&
+      "copying elements out of range");
+  GC *gc = &runtime->getHeap();
+  if (src != dst || dstIndex <= srcIndex) {
+    // Copy the runs front to back, so that an element of an overlapping range
+    // is read before it is overwritten.
+    while (count) {
+      size_type n = std::min(
+          count,
+          std::min(contiguousAfter(srcIndex), contiguousAfter(dstIndex)));
+      GCHermesValue *from = &src->at(srcIndex);
+      GCHermesValue::copy(from, from + n, &dst->at(dstIndex), gc);
+      srcIndex += n;
+      dstIndex += n;
+      count -= n;
+    }
+  } else {
+    // The destination overlaps the end of the source, copy the runs back to
+    // front.
+    while (count) {
+      size_type n = std::min(
+          count,
+          std::min(
+              contiguousBefore(srcIndex + count),
+              contiguousBefore(dstIndex + count)));
+      count -= n;
+      GCHermesValue *from = &src->at(srcIndex + count);
+      GCHermesValue::copy(from, from + n, &dst->at(dstIndex + count), gc);
+    }
+  }
+}
+
+SegmentedArray::size_type SegmentedArray::findRaw(
+    HermesValue value,
+    size_type begin,
+    size_type end,
+    bool reverse) {
+  assert(begin <= end && end <= size() && "searching out of range");
+  const uint64_t raw = value.getRaw();
+  if (!reverse) {
+    for (size_type i = begin; i != end;) {
+      size_type n = std::min(end - i, contiguousAfter(i));
+      size_t found = findRawForward(&at(i), n, raw);
+      if (found != n)
+        return i + found;
+      i += n;
+    }
+  } else {
+    for (size_type i = end; i != begin;) {
+      size_type n = std::min(i - begin, contiguousBefore(i));
+      size_t found = findRawBackward(&at(i - n), n, raw);
+      if (found != n)
+        return i - n + found;
+      i -= n;
+    }
+  }
+  return end;
+}
+
 void SegmentedArray::shrinkRight(size_type amount) {
   decreaseSize(amount);
 }
@@ -305,6 +457,21 @@ PseudoHandle<SegmentedArray> SegmentedArray::increaseSize(
     return self;
   }
 
+  // Growing within the last allocated segment, as arrays that are filled one
+  // element at a time do most of the time, needs neither allocations nor a
+  // handle.
+  if (currSize > kValueToSegmentThreshold &&
+      toSegment(currSize - 1) == toSegment(finalSize - 1)) {
+    Segment *last = self->segmentAt(toSegment(currSize - 1));
+    const uint32_t newLength = toInterior(finalSize - 1) + 1;
+    if (Fill) {
+      last->setLength(newLength);
+    } else {
+      last->setLengthWithoutFilling(newLength);
+    }
+    return self;
+  }
+
   // currSize might be in inline storage, but finalSize is definitely in
   // segments.
   // Allocate missing segments after filling inline storage.
@@ -10,7 +10,7 @@ namespace hermes {
 namespace vm {
 
 void SnapshotEdgeAcceptor::accept(void *&ptr, const char *name) {
-  if (ptr) {
+  if (ptr && index_++ % stride_ == 0) {
     snap.addEdge(V8HeapSnapshot::Edge{
         V8HeapSnapshot::Edge::Named{},
         V8HeapSnapshot::Edge ::Type::Internal,
@@ -17,7 +17,9 @@
 
 #include <cassert>
 #include <limits>
+#include <mutex>
 #include <stack>
+#include <vector>
 
 namespace hermes {
 namespace vm {
@@ -39,6 +41,92 @@ class VMAllocateStorageProvider final : public StorageProvider {
   void deleteStorage(void *storage) override;
 };
 
+/// Storages deleted by pooled providers, which any pooled provider in the
+/// process may reuse.  Storages in the pool have been marked unused, so they
+/// do not count towards the resident memory of the process.
+class StoragePool {
+ public:
+  /// The pool is never destroyed, so that threads that exit while the process
+  /// is shutting down can still give their storages to it.
+  static StoragePool &get() {
+    static StoragePool *const pool = new StoragePool();
+    return *pool;
+  }
+
+  /// \return a storage from the pool, or nullptr if it is empty.
+  void *take() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (storages_.empty())
+      return nullptr;
+    void *storage = storages_.back();
+    storages_.pop_back();
+    return storage;
+  }
+
+  /// Add \p storage to the pool, or return it to the OS if the pool is full.
+  void give(void *storage) {
+    oscompat::vm_unused(storage, AlignedStorage::size());
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (storages_.size() < kMaxStorages) {
+        storages_.push_back(storage);
+        return;
+      }
+    }
+    oscompat::vm_free_aligned(storage, AlignedStorage::size());
+  }
+
+ private:
+  /// The most storages kept by the pool, for all threads.
+  static constexpr size_t kMaxStorages = 64;
+
+  std::mutex mutex_;
+  std::vector<void *> storages_;
+};
+
+/// The storages deleted on a thread by pooled providers, which are reused by
+/// the next pooled providers to create storage on the same thread.  They are
+/// given to the StoragePool when there are too many, or when the thread
+/// exits.
+class ThreadStorageCache {
+ public:
+  ~ThreadStorageCache() {
+    while (size_) {
+      StoragePool::get().give(storages_[--size_]);
+    }
+  }
+
+  /// \return a storage from the cache, or nullptr if it is empty.
+  void *take() {
+    return size_ ? storages_[--size_] : nullptr;
+  }
+
+  /// Add \p storage to the cache, or give it to the StoragePool if the cache
+  /// is full.
+  void give(void *storage) {
+    if (size_ < kCapacity) {
+      storages_[size_++] = storage;
+    } else {
+      StoragePool::get().give(storage);
+    }
+  }
+
+ private:
+  /// The most storages kept by one thread.
+  static constexpr size_t kCapacity = 4;
+
+  void *storages_[kCapacity];
+  size_t size_{0};
+};
+
+thread_local ThreadStorageCache threadStorageCache;
+
+class PooledStorageProvider final : public StorageProvider {
+ public:
+  llvm::ErrorOr<void *> newStorage(const char *name) override;
+  void deleteStorage(void *storage) override;
+};
+
 class MallocStorageProvider final : public StorageProvider {
  public:
   llvm::ErrorOr<void *> newStorage(const char *name) override;
@@ -103,6 +191,27 @@ void VMAllocateStorageProvider::deleteStorage(void *storage) {
   oscompat::vm_free_aligned(storage, AlignedStorage::size());
 }
 
+llvm::ErrorOr<void *> PooledStorageProvider::newStorage(const char *name) {
+  void *storage = threadStorageCache.take();
+  if (!storage) {
+    storage = StoragePool::get().take();
+  }
+  if (!storage) {
+    // Nothing to recycle, allocate from the OS like the mmap provider does.
+    return VMAllocateStorageProvider().newStorage(name);
+  }
+  oscompat::vm_name(storage, AlignedStorage::size(), name);
+  return storage;
+}
+
+void PooledStorageProvider::deleteStorage(void *storage) {
+  if (!storage) {
+    return;
+  }
+  oscompat::vm_name(storage, AlignedStorage::size(), "hermes-freelist");
+  threadStorageCache.give(storage);
+}
+
 llvm::ErrorOr<void *> MallocStorageProvider::newStorage(const char *name) {
   // name is unused, can't name malloc memory.
   (void)name;
@@ -211,6 +320,11 @@ std::unique_ptr<StorageProvider> StorageProvider::mmapProvider() {
   return std::unique_ptr<StorageProvider>(new VMAllocateStorageProvider);
 }
 
+/* static */
+std::unique_ptr<StorageProvider> StorageProvider::pooledMmapProvider() {
+  return std::unique_ptr<StorageProvider>(new PooledStorageProvider);
+}
+
 /* static */
 std::unique_ptr<StorageProvider> StorageProvider::mallocProvider() {
   return std::unique_ptr<StorageProvider>(new MallocStorageProvider);
@@ -56,6 +56,63 @@ void ExternalUTF16StringPrimitiveBuildMeta(
   symbolStringPrimitiveBuildMeta(cell, mb);
 }
 
+/// Shared by both kinds of ropes, like symbolStringPrimitiveBuildMeta.
+void ropeStringPrimitiveBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
+  const auto *self = static_cast<const RopeStringPrimitive *>(cell);
+  mb.addField("left", &self->left_);
+  mb.addField("right", &self->right_);
+}
+
+void RopeASCIIStringPrimitiveBuildMeta(
+    const GCCell *cell,
+    Metadata::Builder &mb) {
+  ropeStringPrimitiveBuildMeta(cell, mb);
+}
+
+void RopeUTF16StringPrimitiveBuildMeta(
+    const GCCell *cell,
+    Metadata::Builder &mb) {
+  ropeStringPrimitiveBuildMeta(cell, mb);
+}
+
+void slicedStringPrimitiveBuildMeta(
+    const GCCell *cell,
+    Metadata::Builder &mb) {
+  const auto *self = static_cast<const SlicedStringPrimitive *>(cell);
+  mb.addField("owner", &self->owner_);
+}
+
+void SlicedASCIIStringPrimitiveBuildMeta(
+    const GCCell *cell,
+    Metadata::Builder &mb) {
+  slicedStringPrimitiveBuildMeta(cell, mb);
+}
+
+void SlicedUTF16StringPrimitiveBuildMeta(
+    const GCCell *cell,
+    Metadata::Builder &mb) {
+  slicedStringPrimitiveBuildMeta(cell, mb);
+}
+
+void BorrowedASCIIStringPrimitiveBuildMeta(
+    const GCCell *cell,
+    Metadata::Builder &mb) {}
+void BorrowedUTF16StringPrimitiveBuildMeta(
+    const GCCell *cell,
+    Metadata::Builder &mb) {}
+
+namespace {
+
+/// Copy the ASCII characters of \p str to \p dst.
+void copyToASCII(ASCIIRef str, char *dst) {
+  std::copy(str.begin(), str.end(), dst);
+}
+void copyToASCII(UTF16Ref str, char *dst) {
+  narrowASCII(str.data(), str.size(), dst);
+}
+
+} // namespace
+
 template <typename T>
 CallResult<HermesValue> StringPrimitive::createEfficientImpl(
     Runtime *runtime,
@@ -94,7 +151,7 @@ CallResult<HermesValue> StringPrimitive::createEfficientImpl(
     }
     auto output = runtime->makeHandle<StringPrimitive>(*result);
     // Copy directly into the StringPrimitive storage.
-    std::copy(str.begin(), str.end(), output->castToASCIIPointerForWrite());
+    copyToASCII(str, output->castToASCIIPointerForWrite());
     return output.getHermesValue();
   }
 
@@ -192,6 +249,14 @@ CallResult<HermesValue> StringPrimitive::concat(
   SafeUInt32 xyLen(xLen);
   xyLen.add(yLen);
 
+  // Long results only link the two strings, so that building a string by
+  // repeated concatenation does not copy it every time. Results that are too
+  // long go through StringBuilder, which reports the error.
+  if (!xyLen.isOverflowed() && *xyLen >= RopeStringPrimitive::kMinRopeLength &&
+      *xyLen <= MAX_STRING_LENGTH) {
+    return RopeStringPrimitive::create(runtime, xHandle, yHandle);
+  }
+
   auto builder = StringBuilder::createStringBuilder(
       runtime, xyLen, xHandle->isASCII() && yHandle->isASCII());
   if (builder == ExecutionStatus::EXCEPTION) {
@@ -211,6 +276,13 @@ CallResult<HermesValue> StringPrimitive::slice(
   assert(
       start + length <= str->getStringLength() && "Invalid length for slice");
 
+  if (length == str->getStringLength())
+    return str.getHermesValue();
+  if (SlicedStringPrimitive::shouldShare(
+          SlicedStringPrimitive::getOwner(*str)->getStringLength(), length)) {
+    return SlicedStringPrimitive::create(runtime, str, start, length);
+  }
+
   SafeUInt32 safeLen(length);
 
   auto builder =
@@ -248,8 +320,7 @@ void StringPrimitive::copyUTF16String(
 
 void StringPrimitive::copyUTF16String(char16_t *ptr) const {
   if (isASCII()) {
-    const char *src = castToASCIIPointer();
-    std::copy(src, src + getStringLength(), ptr);
+    widenASCII(castToASCIIPointer(), getStringLength(), ptr);
   } else {
     const char16_t *src = castToUTF16Pointer();
     std::copy(src, src + getStringLength(), ptr);
@@ -392,5 +463,163 @@ size_t ExternalStringPrimitive<T>::_mallocSizeImpl(GCCell *cell) {
 template class ExternalStringPrimitive<char16_t>;
 template class ExternalStringPrimitive<char>;
 
+//===----------------------------------------------------------------------===//
+// class BorrowedStringPrimitive
+
+template <typename T>
+CallResult<HermesValue> BorrowedStringPrimitive<T>::create(
+    Runtime *runtime,
+    Ref str,
+    std::unique_ptr<BorrowedStringBuffer> owner) {
+  assert(
+      (!std::is_same<T, char>::value || isAllASCII(str.begin(), str.end())) &&
+      "8 bit strings must be ASCII");
+  if (LLVM_UNLIKELY(str.size() > MAX_STRING_LENGTH))
+    return runtime->raiseRangeError("String length exceeds limit");
+  void *mem = runtime->alloc</*fixedSize*/ true, HasFinalizer::Yes>(
+      sizeof(BorrowedStringPrimitive<T>));
+  auto res = HermesValue::encodeStringValue(
+      new (mem) BorrowedStringPrimitive<T>(runtime, str, std::move(owner)));
+  runtime->getHeap().creditExternalMemory(
+      res.getString(), str.size() * sizeof(T));
+  return res;
+}
+
+template <typename T>
+void BorrowedStringPrimitive<T>::_finalizeImpl(GCCell *cell, GC *gc) {
+  BorrowedStringPrimitive<T> *self = vmcast<BorrowedStringPrimitive<T>>(cell);
+  gc->debitExternalMemory(self, self->getStringByteSize());
+  delete self->owner_;
+  self->~BorrowedStringPrimitive<T>();
+}
+
+template <typename T>
+size_t BorrowedStringPrimitive<T>::_mallocSizeImpl(GCCell *cell) {
+  return vmcast<BorrowedStringPrimitive<T>>(cell)->getStringByteSize();
+}
+
+template class BorrowedStringPrimitive<char16_t>;
+template class BorrowedStringPrimitive<char>;
+
+//===----------------------------------------------------------------------===//
+// class RopeStringPrimitive
+
+CallResult<HermesValue> RopeStringPrimitive::create(
+    Runtime *runtime,
+    Handle<StringPrimitive> left,
+    Handle<StringPrimitive> right) {
+  assert(
+      left->getStringLength() && right->getStringLength() &&
+      "ropes can't have empty pieces");
+  // Strings that keep being extended are flattened every kMaxRopeDepth steps,
+  // which keeps the trees shallow and releases their pieces to the GC.
+  if (getDepth(*left) >= kMaxRopeDepth)
+    vmcast<RopeStringPrimitive>(*left)->flatten();
+  if (getDepth(*right) >= kMaxRopeDepth)
+    vmcast<RopeStringPrimitive>(*right)->flatten();
+  uint32_t depth = std::max(getDepth(*left), getDepth(*right)) + 1;
+
+  if (left->isASCII() && right->isASCII())
+    return RopeASCIIStringPrimitive::create(runtime, left, right, depth);
+  return RopeUTF16StringPrimitive::create(runtime, left, right, depth);
+}
+
+void RopeStringPrimitive::flatten() const {
+  assert(!isFlattened() && "rope is already flat");
+  if (isASCII())
+    vmcast<RopeASCIIStringPrimitive>(this)->flattenImpl();
+  else
+    vmcast<RopeUTF16StringPrimitive>(this)->flattenImpl();
+}
+
+template <typename T>
+CallResult<HermesValue> RopeStringPrimitiveImpl<T>::create(
+    Runtime *runtime,
+    Handle<StringPrimitive> left,
+    Handle<StringPrimitive> right,
+    uint32_t depth) {
+  void *mem = runtime->alloc</*fixedSize*/ true, HasFinalizer::Yes>(
+      sizeof(RopeStringPrimitiveImpl<T>));
+  return HermesValue::encodeStringValue(
+      new (mem) RopeStringPrimitiveImpl<T>(runtime, *left, *right, depth));
+}
+
+template <typename T>
+void RopeStringPrimitiveImpl<T>::flattenImpl() const {
+  std::unique_ptr<T[]> contents{new T[getStringLength()]};
+  T *out = contents.get();
+
+  // Visit the pieces in order with an explicit stack, since a rope can be
+  // deep. Nothing here allocates in the JS heap, so the pieces can't move.
+  llvm::SmallVector<const StringPrimitive *, 16> pending;
+  pending.push_back(this);
+  while (!pending.empty()) {
+    const StringPrimitive *str = pending.pop_back_val();
+    if (const auto *rope = dyn_vmcast<RopeStringPrimitive>(str)) {
+      if (!rope->isFlattened()) {
+        pending.push_back(rope->getRight());
+        pending.push_back(rope->getLeft());
+        continue;
+      }
+    }
+    if (str->isASCII()) {
+      ASCIIRef ref = str->castToASCIIRef();
+      out = std::copy(ref.begin(), ref.end(), out);
+    } else {
+      assert(
+          (std::is_same<T, char16_t>::value) &&
+          "ASCII rope with a UTF-16 piece");
+      UTF16Ref ref = str->castToUTF16Ref();
+      out = std::copy(ref.begin(), ref.end(), out);
+    }
+  }
+  assert(
+      out == contents.get() + getStringLength() &&
+      "pieces don't add up to the length of the rope");
+
+  contents_ = std::move(contents);
+  releasePieces();
+}
+
+template <typename T>
+void RopeStringPrimitiveImpl<T>::_finalizeImpl(GCCell *cell, GC *) {
+  vmcast<RopeStringPrimitiveImpl<T>>(cell)->~RopeStringPrimitiveImpl<T>();
+}
+
+template <typename T>
+size_t RopeStringPrimitiveImpl<T>::_mallocSizeImpl(GCCell *cell) {
+  auto *self = vmcast<RopeStringPrimitiveImpl<T>>(cell);
+  return self->isFlattened() ? self->getStringLength() * sizeof(T) : 0;
+}
+
+template class RopeStringPrimitiveImpl<char16_t>;
+template class RopeStringPrimitiveImpl<char>;
+
+//===----------------------------------------------------------------------===//
+// class SlicedStringPrimitive
+
+CallResult<HermesValue> SlicedStringPrimitive::create(
+    Runtime *runtime,
+    Handle<StringPrimitive> str,
+    uint32_t start,
+    uint32_t length) {
+  assert(
+      start + length <= str->getStringLength() && "Invalid length for slice");
+  if (const auto *sliced = dyn_vmcast<SlicedStringPrimitive>(*str))
+    start += sliced->getOffset();
+  auto owner = StringPrimitive::ensureFlat(
+      runtime,
+      runtime->makeHandle(
+          const_cast<StringPrimitive *>(getOwner(str.get()))));
+
+  void *mem = runtime->alloc</*fixedSize*/ true>(sizeof(SlicedStringPrimitive));
+  if (owner->isASCII()) {
+    return HermesValue::encodeStringValue(new (mem) SlicedASCIIStringPrimitive(
+        runtime, *owner, start, length));
+  }
+  return HermesValue::encodeStringValue(
+      new (mem) SlicedUTF16StringPrimitive(runtime, *owner, start, length));
+}
+
 } // namespace vm
 } // namespace hermes
@@ -0,0 +1,1010 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/StructuredClone.h"
+
+#include "hermes/VM/ArrayStorage.h"
+#include "hermes/VM/Callable.h"
+#include "hermes/VM/JSDate.h"
+#include "hermes/VM/JSMapImpl.h"
+#include "hermes/VM/JSTypedArray.h"
+#include "hermes/VM/Operations.h"
+#include "hermes/VM/StringPrimitive.h"
+#include "hermes/VM/StringView.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
+
+namespace hermes {
+namespace vm {
+
+namespace {
+
+/// The version of the encoding, written as its first byte.
+constexpr uint8_t kFormatVersion = 1;
+
+/// Every value in the encoding starts with one of these tags. Objects are
+/// numbered in the order their tag appears, which BackRef refers to.
+enum class Tag : uint8_t {
+  Undefined,
+  Null,
+  False,
+  True,
+  /// Followed by an int32_t.
+  Int32,
+  /// Followed by a double.
+  Number,
+  /// Followed by the length and the characters.
+  ASCIIString,
+  UTF16String,
+  /// A missing array element.
+  Hole,
+  /// Ends the entries of a Map or Set.
+  End,
+  /// Followed by the number of an object seen before.
+  BackRef,
+  /// Followed by the number of properties, their names and their values. The
+  /// names define the next shape.
+  ObjectNewShape,
+  /// Followed by the number of a shape and the values of its properties.
+  Object,
+  /// Followed by the length and the elements.
+  Array,
+  /// Followed by the time value.
+  Date,
+  /// Followed by the keys and values, then End.
+  Map,
+  /// Followed by the keys, then End.
+  Set,
+  /// Followed by the size and the bytes.
+  ArrayBuffer,
+  /// Followed by the index of the buffer in the transfer list.
+  TransferredArrayBuffer,
+  /// Followed by the CellKind, the byte offset, the length and the buffer.
+  TypedArray,
+};
+
+class Serializer {
+ public:
+  Serializer(Runtime *runtime, std::vector<uint8_t> &bytes)
+      : runtime_(runtime), bytes_(bytes) {}
+
+  /// Serialize \p buffer as a reference to entry \p index of the transfer
+  /// list instead of copying its contents.
+  /// \return false if the buffer was already in the transfer list.
+  bool addTransfer(JSArrayBuffer *buffer, uint32_t index) {
+    return transfers_
+        .insert({JSObject::getObjectID(buffer, runtime_), index})
+        .second;
+  }
+
+  void writeHeader() {
+    bytes_.push_back(kFormatVersion);
+  }
+
+  ExecutionStatus write(Handle<> value);
+
+ private:
+  Runtime *const runtime_;
+  std::vector<uint8_t> &bytes_;
+
+  /// The number of each object written so far, by ObjectID.
+  llvm::DenseMap<ObjectID, uint32_t> objects_{};
+  /// The index in the transfer list of each transferred ArrayBuffer, by
+  /// ObjectID.
+  llvm::DenseMap<ObjectID, uint32_t> transfers_{};
+  /// The number of each shape written so far, by the raw SymbolIDs of its
+  /// property names.
+  std::map<std::vector<SymbolID::RawType>, uint32_t> shapes_{};
+
+  void writeTag(Tag tag) {
+    bytes_.push_back(static_cast<uint8_t>(tag));
+  }
+
+  /// Write \p value as an unsigned LEB128.
+  void writeVarUInt(uint64_t value) {
+    do {
+      uint8_t byte = value & 0x7f;
+      value >>= 7;
+      bytes_.push_back(value ? byte | 0x80 : byte);
+    } while (value);
+  }
+
+  void writeBytes(const void *data, size_t size) {
+    auto *begin = static_cast<const uint8_t *>(data);
+    bytes_.insert(bytes_.end(), begin, begin + size);
+  }
+
+  void writeNumber(double d);
+
+  /// Write the tag, the length and the characters of \p str.
+  void writeString(StringView str);
+
+  ExecutionStatus writeObject(Handle<JSObject> obj);
+  ExecutionStatus writePlainObject(Handle<JSObject> obj);
+  ExecutionStatus writeArray(Handle<JSArray> arr);
+  template <CellKind C>
+  ExecutionStatus writeMapOrSet(Handle<JSMapImpl<C>> mapOrSet);
+  ExecutionStatus writeArrayBuffer(Handle<JSArrayBuffer> buffer);
+  ExecutionStatus writeTypedArray(Handle<JSTypedArrayBase> arr);
+};
+
+ExecutionStatus Serializer::write(Handle<> value) {
+  switch (value->getTag()) {
+    case UndefinedTag:
+      writeTag(Tag::Undefined);
+      return ExecutionStatus::RETURNED;
+    case NullTag:
+      writeTag(Tag::Null);
+      return ExecutionStatus::RETURNED;
+    case BoolTag:
+      writeTag(value->getBool() ? Tag::True : Tag::False);
+      return ExecutionStatus::RETURNED;
+    case StrTag:
+      writeString(StringPrimitive::createStringView(
+          runtime_, Handle<StringPrimitive>::vmcast(value)));
+      return ExecutionStatus::RETURNED;
+    case SymbolTag:
+      return runtime_->raiseTypeError("Symbol values cannot be cloned");
+    case ObjectTag:
+      return writeObject(Handle<JSObject>::vmcast(value));
+    default:
+      assert(value->isNumber() && "unexpected value tag");
+      writeNumber(value->getNumber());
+      return ExecutionStatus::RETURNED;
+  }
+}
+
+void Serializer::writeNumber(double d) {
+  // Most numbers are small integers, which fit in half the space.
+  if (d >= std::numeric_limits<int32_t>::min() &&
+      d <= std::numeric_limits<int32_t>::max() &&
+      static_cast<int32_t>(d) == d && !(d == 0 && std::signbit(d))) {
+    int32_t i = static_cast<int32_t>(d);
+    writeTag(Tag::Int32);
+    writeBytes(&i, sizeof(i));
+    return;
+  }
+  writeTag(Tag::Number);
+  writeBytes(&d, sizeof(d));
+}
+
+void Serializer::writeString(StringView str) {
+  if (str.isASCII()) {
+    writeTag(Tag::ASCIIString);
+    writeVarUInt(str.length());
+    writeBytes(str.castToCharPtr(), str.length());
+  } else {
+    writeTag(Tag::UTF16String);
+    writeVarUInt(str.length());
+    writeBytes(str.castToChar16Ptr(), str.length() * sizeof(char16_t));
+  }
+}
+
+ExecutionStatus Serializer::writeObject(Handle<JSObject> obj) {
+  ObjectID id = JSObject::getObjectID(*obj, runtime_);
+  auto it = objects_.find(id);
+  if (it != objects_.end()) {
+    writeTag(Tag::BackRef);
+    writeVarUInt(it->second);
+    return ExecutionStatus::RETURNED;
+  }
+  // Number the object before its contents, which may refer back to it.
+  uint32_t number = objects_.size();
+  objects_[id] = number;
+
+  auto transferIt = transfers_.find(id);
+  if (transferIt != transfers_.end()) {
+    writeTag(Tag::TransferredArrayBuffer);
+    writeVarUInt(transferIt->second);
+    return ExecutionStatus::RETURNED;
+  }
+
+  ScopedNativeDepthTracker depthTracker{runtime_};
+  if (LLVM_UNLIKELY(depthTracker.overflowed())) {
+    return runtime_->raiseStackOverflow(
+        Runtime::StackOverflowKind::NativeStack);
+  }
+
+  switch (obj->getKind()) {
+    case CellKind::ObjectKind:
+      return writePlainObject(obj);
+    case CellKind::ArrayKind:
+      return writeArray(Handle<JSArray>::vmcast(obj));
+    case CellKind::DateKind: {
+      writeTag(Tag::Date);
+      double t = JSDate::getPrimitiveValue(*obj, runtime_).getNumber();
+      writeBytes(&t, sizeof(t));
+      return ExecutionStatus::RETURNED;
+    }
+    case CellKind::MapKind:
+      return writeMapOrSet(Handle<JSMap>::vmcast(obj));
+    case CellKind::SetKind:
+      return writeMapOrSet(Handle<JSSet>::vmcast(obj));
+    case CellKind::ArrayBufferKind:
+      return writeArrayBuffer(Handle<JSArrayBuffer>::vmcast(obj));
+#define TYPED_ARRAY(name, type) case CellKind::name##ArrayKind:
+#include "hermes/VM/TypedArrays.def"
+      return writeTypedArray(Handle<JSTypedArrayBase>::vmcast(obj));
+    default:
+      if (vmisa<Callable>(*obj)) {
+        return runtime_->raiseTypeError("Functions cannot be cloned");
+      }
+      if (obj->isHostObject()) {
+        return runtime_->raiseTypeError("Host objects cannot be cloned");
+      }
+      return runtime_->raiseTypeError("Object cannot be cloned");
+  }
+}
+
+ExecutionStatus Serializer::writePlainObject(Handle<JSObject> obj) {
+  GCScopeMarkerRAII marker{runtime_};
+  auto clazz = runtime_->makeHandle(obj->getClass(runtime_));
+
+  // The class lists the own properties in insertion order.
+  llvm::SmallVector<std::pair<SymbolID, NamedPropertyDescriptor>, 8> props;
+  HiddenClass::forEachProperty(
+      clazz, runtime_, [&props](SymbolID id, NamedPropertyDescriptor desc) {
+        if (isPropertyNamePrimitive(id) && desc.flags.enumerable)
+          props.push_back({id, desc});
+      });
+
+  std::vector<SymbolID::RawType> shapeKey;
+  shapeKey.reserve(props.size());
+  for (const auto &prop : props)
+    shapeKey.push_back(prop.first.unsafeGetRaw());
+  auto shapeIt = shapes_.find(shapeKey);
+  if (shapeIt != shapes_.end()) {
+    writeTag(Tag::Object);
+    writeVarUInt(shapeIt->second);
+  } else {
+    writeTag(Tag::ObjectNewShape);
+    writeVarUInt(props.size());
+    for (const auto &prop : props) {
+      writeString(
+          runtime_->getIdentifierTable().getStringView(runtime_, prop.first));
+    }
+    uint32_t shapeNumber = shapes_.size();
+    shapes_.emplace(std::move(shapeKey), shapeNumber);
+  }
+
+  MutableHandle<> value{runtime_};
+  for (const auto &prop : props) {
+    marker.flush();
+    // Read the slot directly, unless a getter changed the class of the object
+    // since its properties were listed.
+    if (obj->getClass(runtime_) == *clazz && !prop.second.flags.accessor) {
+      value = JSObject::getNamedSlotValue(obj.get(), runtime_, prop.second);
+    } else {
+      auto propRes = JSObject::getNamed_RJS(obj, runtime_, prop.first);
+      if (LLVM_UNLIKELY(propRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      value = *propRes;
+    }
+    if (LLVM_UNLIKELY(write(value) == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+  return ExecutionStatus::RETURNED;
+}
+
+ExecutionStatus Serializer::writeArray(Handle<JSArray> arr) {
+  GCScopeMarkerRAII marker{runtime_};
+  uint32_t length = JSArray::getLength(*arr);
+  writeTag(Tag::Array);
+  writeVarUInt(length);
+
+  MutableHandle<> value{runtime_};
+  MutableHandle<> index{runtime_};
+  for (uint32_t i = 0; i < length; ++i) {
+    marker.flush();
+    value = arr->tryGetFastIndexed(runtime_, i);
+    if (value->isEmpty()) {
+      // Either a hole or an element that needs a full lookup.
+      index = HermesValue::encodeNumberValue(i);
+      ComputedPropertyDescriptor desc;
+      auto hasRes =
+          JSObject::getOwnComputedDescriptor(arr, runtime_, index, desc);
+      if (LLVM_UNLIKELY(hasRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      if (!*hasRes) {
+        writeTag(Tag::Hole);
+        continue;
+      }
+      auto propRes = JSObject::getComputed_RJS(arr, runtime_, index);
+      if (LLVM_UNLIKELY(propRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      value = *propRes;
+    }
+    if (LLVM_UNLIKELY(write(value) == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+  return ExecutionStatus::RETURNED;
+}
+
+template <CellKind C>
+ExecutionStatus Serializer::writeMapOrSet(Handle<JSMapImpl<C>> mapOrSet) {
+  GCScopeMarkerRAII marker{runtime_};
+  constexpr bool isMap = C == CellKind::MapKind;
+  writeTag(isMap ? Tag::Map : Tag::Set);
+  if (!mapOrSet->isInitialized()) {
+    writeTag(Tag::End);
+    return ExecutionStatus::RETURNED;
+  }
+
+  // Iterate like JSMapImpl::forEach(), which tolerates the entries changing
+  // while the keys and values are written.
+  MutableHandle<SegmentedArray> table{runtime_};
+  MutableHandle<> key{runtime_};
+  MutableHandle<> value{runtime_};
+  uint32_t index = 0;
+  while (true) {
+    marker.flush();
+    OrderedHashMap *storage = mapOrSet->getStorage(runtime_);
+    SegmentedArray *tablePtr = table.get();
+    index = storage->iteratorNext(runtime_, tablePtr, index);
+    if (index == OrderedHashMap::kIterationEnd)
+      break;
+    table = tablePtr;
+    key = storage->getKeyAt(runtime_, index);
+    value = storage->getValueAt(runtime_, index);
+    ++index;
+    if (LLVM_UNLIKELY(write(key) == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    if (isMap && LLVM_UNLIKELY(write(value) == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+  writeTag(Tag::End);
+  return ExecutionStatus::RETURNED;
+}
+
+ExecutionStatus Serializer::writeArrayBuffer(Handle<JSArrayBuffer> buffer) {
+  if (!buffer->attached()) {
+    return runtime_->raiseTypeError("Cannot clone a detached ArrayBuffer");
+  }
+  writeTag(Tag::ArrayBuffer);
+  writeVarUInt(buffer->size());
+  if (buffer->size())
+    writeBytes(buffer->getDataBlock(), buffer->size());
+  return ExecutionStatus::RETURNED;
+}
+
+ExecutionStatus Serializer::writeTypedArray(Handle<JSTypedArrayBase> arr) {
+  if (!arr->attached(runtime_)) {
+    return runtime_->raiseTypeError("Cannot clone a detached TypedArray");
+  }
+  writeTag(Tag::TypedArray);
+  bytes_.push_back(static_cast<uint8_t>(arr->getKind()));
+  writeVarUInt(arr->getByteOffset(runtime_));
+  writeVarUInt(arr->getLength());
+  // The buffer may be shared with other views, or transferred.
+  return writeObject(runtime_->makeHandle(arr->getBuffer(runtime_)));
+}
+
+class Deserializer {
+ public:
+  Deserializer(Runtime *runtime, StructuredCloneData &data)
+      : runtime_(runtime),
+        data_(data),
+        cur_(data.bytes.data()),
+        end_(data.bytes.data() + data.bytes.size()),
+        objects_(runtime),
+        shapeNames_(runtime),
+        shapeClasses_(runtime) {}
+
+  /// Allocate the tables and check the header.
+  ExecutionStatus init();
+
+  CallResult<HermesValue> read();
+
+  /// \return ExecutionStatus::EXCEPTION if not all the data was read.
+  ExecutionStatus finish() {
+    return cur_ == end_ ? ExecutionStatus::RETURNED : raiseInvalid();
+  }
+
+ private:
+  Runtime *const runtime_;
+  StructuredCloneData &data_;
+  const uint8_t *cur_;
+  const uint8_t *const end_;
+
+  /// The objects read so far, by number.
+  MutableHandle<ArrayStorage> objects_;
+  /// The property names of each shape, as an ArrayStorage of strings.
+  MutableHandle<ArrayStorage> shapeNames_;
+  /// The HiddenClass shared by the objects of each shape, or undefined if
+  /// they can't share one.
+  MutableHandle<ArrayStorage> shapeClasses_;
+  /// The slots of the properties of each shape which has a HiddenClass, in
+  /// the order of the names.
+  std::vector<std::vector<SlotIndex>> shapeSlots_{};
+
+  ExecutionStatus raiseInvalid() {
+    return runtime_->raiseTypeError("Invalid structured clone data");
+  }
+
+  bool readBytes(void *dst, size_t size) {
+    if (LLVM_UNLIKELY((size_t)(end_ - cur_) < size))
+      return false;
+    memcpy(dst, cur_, size);
+    cur_ += size;
+    return true;
+  }
+
+  bool readVarUInt(uint64_t &value) {
+    value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+      if (LLVM_UNLIKELY(cur_ == end_))
+        return false;
+      uint8_t byte = *cur_++;
+      value |= uint64_t(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+        return true;
+    }
+    return false;
+  }
+
+  /// Append \p value to \p storage, as the entry numbered \p storage->size().
+  ExecutionStatus
+  push(MutableHandle<ArrayStorage> &storage, HermesValue value) {
+    return ArrayStorage::push_back(
+        storage, runtime_, runtime_->makeHandle(value));
+  }
+
+  CallResult<HermesValue> readString(Tag tag);
+  CallResult<HermesValue> readObjectNewShape();
+  CallResult<HermesValue> readObject();
+  CallResult<HermesValue> readArray();
+  CallResult<HermesValue> readDate();
+  template <CellKind C>
+  CallResult<HermesValue> readMapOrSet();
+  CallResult<HermesValue> readArrayBuffer();
+  CallResult<HermesValue> readTransferredArrayBuffer();
+  CallResult<HermesValue> readTypedArray();
+};
+
+ExecutionStatus Deserializer::init() {
+  for (auto *storage : {&objects_, &shapeNames_, &shapeClasses_}) {
+    auto arrRes = ArrayStorage::create(runtime_, 4);
+    if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    *storage = vmcast<ArrayStorage>(*arrRes);
+  }
+  uint8_t version;
+  if (!readBytes(&version, sizeof(version)) || version != kFormatVersion) {
+    return raiseInvalid();
+  }
+  return ExecutionStatus::RETURNED;
+}
+
+CallResult<HermesValue> Deserializer::read() {
+  uint8_t tagByte;
+  if (LLVM_UNLIKELY(!readBytes(&tagByte, sizeof(tagByte)))) {
+    return raiseInvalid();
+  }
+  ScopedNativeDepthTracker depthTracker{runtime_};
+  if (LLVM_UNLIKELY(depthTracker.overflowed())) {
+    return runtime_->raiseStackOverflow(
+        Runtime::StackOverflowKind::NativeStack);
+  }
+  Tag tag = static_cast<Tag>(tagByte);
+  switch (tag) {
+    case Tag::Undefined:
+      return HermesValue::encodeUndefinedValue();
+    case Tag::Null:
+      return HermesValue::encodeNullValue();
+    case Tag::False:
+      return HermesValue::encodeBoolValue(false);
+    case Tag::True:
+      return HermesValue::encodeBoolValue(true);
+    case Tag::Int32: {
+      int32_t i;
+      if (LLVM_UNLIKELY(!readBytes(&i, sizeof(i)))) {
+        return raiseInvalid();
+      }
+      return HermesValue::encodeNumberValue(i);
+    }
+    case Tag::Number: {
+      double d;
+      if (LLVM_UNLIKELY(!readBytes(&d, sizeof(d)))) {
+        return raiseInvalid();
+      }
+      return HermesValue::encodeNumberValue(d);
+    }
+    case Tag::ASCIIString:
+    case Tag::UTF16String:
+      return readString(tag);
+    case Tag::BackRef: {
+      uint64_t number;
+      if (LLVM_UNLIKELY(
+              !readVarUInt(number) || number >= objects_->size())) {
+        return raiseInvalid();
+      }
+      return objects_->at(number);
+    }
+    case Tag::ObjectNewShape:
+      return readObjectNewShape();
+    case Tag::Object:
+      return readObject();
+    case Tag::Array:
+      return readArray();
+    case Tag::Date:
+      return readDate();
+    case Tag::Map:
+      return readMapOrSet<CellKind::MapKind>();
+    case Tag::Set:
+      return readMapOrSet<CellKind::SetKind>();
+    case Tag::ArrayBuffer:
+      return readArrayBuffer();
+    case Tag::TransferredArrayBuffer:
+      return readTransferredArrayBuffer();
+    case Tag::TypedArray:
+      return readTypedArray();
+    default:
+      // Hole and End are only valid where the callers expect them.
+      return raiseInvalid();
+  }
+}
+
+CallResult<HermesValue> Deserializer::readString(Tag tag) {
+  uint64_t length;
+  if (LLVM_UNLIKELY(!readVarUInt(length))) {
+    return raiseInvalid();
+  }
+  if (tag == Tag::ASCIIString) {
+    if (LLVM_UNLIKELY(length > (size_t)(end_ - cur_))) {
+      return raiseInvalid();
+    }
+    ASCIIRef str{reinterpret_cast<const char *>(cur_), (size_t)length};
+    cur_ += length;
+    return StringPrimitive::createEfficient(runtime_, str);
+  }
+  if (LLVM_UNLIKELY(length > (size_t)(end_ - cur_) / sizeof(char16_t))) {
+    return raiseInvalid();
+  }
+  // The characters in the buffer may not be aligned.
+  llvm::SmallVector<char16_t, 32> chars(length);
+  readBytes(chars.data(), length * sizeof(char16_t));
+  return StringPrimitive::createEfficient(runtime_, UTF16Ref(chars));
+}
+
+CallResult<HermesValue> Deserializer::readObjectNewShape() {
+  GCScopeMarkerRAII marker{runtime_};
+  uint64_t count;
+  if (LLVM_UNLIKELY(!readVarUInt(count) || count > (size_t)(end_ - cur_))) {
+    return raiseInvalid();
+  }
+
+  // Read and keep the names, which later objects of the shape need if they
+  // can't share its class.
+  auto namesRes = ArrayStorage::create(runtime_, count);
+  if (LLVM_UNLIKELY(namesRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  MutableHandle<ArrayStorage> names{runtime_, vmcast<ArrayStorage>(*namesRes)};
+  uint32_t shapeNumber = shapeNames_->size();
+  if (LLVM_UNLIKELY(
+          push(shapeNames_, names.getHermesValue()) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  for (uint64_t i = 0; i < count; ++i) {
+    marker.flush();
+    auto nameRes = read();
+    if (LLVM_UNLIKELY(nameRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    if (LLVM_UNLIKELY(!nameRes->isString())) {
+      return raiseInvalid();
+    }
+    if (LLVM_UNLIKELY(push(names, *nameRes) == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+  // Reserve the class of the shape before reading any nested object.
+  if (LLVM_UNLIKELY(
+          push(shapeClasses_, HermesValue::encodeUndefinedValue()) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  shapeSlots_.emplace_back();
+
+  auto obj = toHandle(runtime_, JSObject::create(runtime_, count));
+  if (LLVM_UNLIKELY(
+          push(objects_, obj.getHermesValue()) == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+
+  MutableHandle<> value{runtime_};
+  for (uint64_t i = 0; i < count; ++i) {
+    marker.flush();
+    auto valueRes = read();
+    if (LLVM_UNLIKELY(valueRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    value = *valueRes;
+    auto symRes = valueToSymbolID(
+        runtime_, runtime_->makeHandle(names->at(i)));
+    if (LLVM_UNLIKELY(symRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    if (LLVM_UNLIKELY(
+            JSObject::defineNewOwnProperty(
+                obj,
+                runtime_,
+                **symRes,
+                PropertyFlags::defaultNewNamedPropertyFlags(),
+                value) == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+
+  // Later objects of this shape can start out with the class built for this
+  // one, unless it is a dictionary, which belongs to a single object.
+  HiddenClass *clazz = obj->getClass(runtime_);
+  if (!clazz->isDictionary()) {
+    auto &slots = shapeSlots_[shapeNumber];
+    slots.reserve(count);
+    HiddenClass::forEachProperty(
+        runtime_->makeHandle(clazz),
+        runtime_,
+        [&slots](SymbolID, NamedPropertyDescriptor desc) {
+          slots.push_back(desc.slot);
+        });
+    shapeClasses_->at(shapeNumber)
+        .set(
+            HermesValue::encodeObjectValue(obj->getClass(runtime_)),
+            &runtime_->getHeap());
+  }
+  return obj.getHermesValue();
+}
+
+CallResult<HermesValue> Deserializer::readObject() {
+  GCScopeMarkerRAII marker{runtime_};
+  uint64_t shapeNumber;
+  if (LLVM_UNLIKELY(
+          !readVarUInt(shapeNumber) || shapeNumber >= shapeNames_->size())) {
+    return raiseInvalid();
+  }
+  auto names = runtime_->makeHandle<ArrayStorage>(
+      shapeNames_->at(shapeNumber));
+  uint32_t count = names->size();
+  HermesValue clazz = shapeClasses_->at(shapeNumber);
+
+  MutableHandle<JSObject> obj{runtime_};
+  if (clazz.isObject()) {
+    obj = JSObject::create(
+              runtime_, runtime_->makeHandle(vmcast<HiddenClass>(clazz)))
+              .get();
+  } else {
+    obj = JSObject::create(runtime_, count).get();
+  }
+  if (LLVM_UNLIKELY(
+          push(objects_, obj.getHermesValue()) == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+
+  MutableHandle<> value{runtime_};
+  for (uint32_t i = 0; i < count; ++i) {
+    marker.flush();
+    auto valueRes = read();
+    if (LLVM_UNLIKELY(valueRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    if (clazz.isObject()) {
+      // The properties already exist, only their slots need to be filled.
+      JSObject::setNamedSlotValue(
+          obj.get(), runtime_, shapeSlots_[shapeNumber][i], *valueRes);
+      continue;
+    }
+    value = *valueRes;
+    auto symRes = valueToSymbolID(
+        runtime_, runtime_->makeHandle(names->at(i)));
+    if (LLVM_UNLIKELY(symRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    if (LLVM_UNLIKELY(
+            JSObject::defineNewOwnProperty(
+                obj,
+                runtime_,
+                **symRes,
+                PropertyFlags::defaultNewNamedPropertyFlags(),
+                value) == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+  return obj.getHermesValue();
+}
+
+CallResult<HermesValue> Deserializer::readArray() {
+  GCScopeMarkerRAII marker{runtime_};
+  uint64_t length;
+  if (LLVM_UNLIKELY(
+          !readVarUInt(length) ||
+          length > std::numeric_limits<uint32_t>::max())) {
+    return raiseInvalid();
+  }
+  // Every element takes at least a byte, which bounds the capacity of arrays
+  // with a bogus length.
+  auto arrRes = JSArray::create(
+      runtime_,
+      std::min<uint64_t>(length, (size_t)(end_ - cur_)),
+      length);
+  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto arr = toHandle(runtime_, std::move(*arrRes));
+  if (LLVM_UNLIKELY(
+          push(objects_, arr.getHermesValue()) == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+
+  for (uint32_t i = 0; i < length; ++i) {
+    marker.flush();
+    if (cur_ != end_ && *cur_ == static_cast<uint8_t>(Tag::Hole)) {
+      ++cur_;
+      continue;
+    }
+    auto valueRes = read();
+    if (LLVM_UNLIKELY(valueRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    JSArray::setElementAt(arr, runtime_, i, runtime_->makeHandle(*valueRes));
+  }
+  return arr.getHermesValue();
+}
+
+CallResult<HermesValue> Deserializer::readDate() {
+  double t;
+  if (LLVM_UNLIKELY(!readBytes(&t, sizeof(t)))) {
+    return raiseInvalid();
+  }
+  auto dateRes = JSDate::create(
+      runtime_, t, Handle<JSObject>::vmcast(&runtime_->datePrototype));
+  if (LLVM_UNLIKELY(dateRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  if (LLVM_UNLIKELY(push(objects_, *dateRes) == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return *dateRes;
+}
+
+template <CellKind C>
+CallResult<HermesValue> Deserializer::readMapOrSet() {
+  GCScopeMarkerRAII marker{runtime_};
+  constexpr bool isMap = C == CellKind::MapKind;
+  auto mapRes = JSMapImpl<C>::create(
+      runtime_,
+      Handle<JSObject>::vmcast(
+          isMap ? &runtime_->mapPrototype : &runtime_->setPrototype));
+  if (LLVM_UNLIKELY(mapRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto mapOrSet = runtime_->makeHandle<JSMapImpl<C>>(*mapRes);
+  if (LLVM_UNLIKELY(
+          JSMapImpl<C>::initializeStorage(mapOrSet, runtime_) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  if (LLVM_UNLIKELY(
+          push(objects_, mapOrSet.getHermesValue()) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+
+  MutableHandle<> key{runtime_};
+  MutableHandle<> value{runtime_};
+  while (true) {
+    marker.flush();
+    if (cur_ != end_ && *cur_ == static_cast<uint8_t>(Tag::End)) {
+      ++cur_;
+      break;
+    }
+    auto keyRes = read();
+    if (LLVM_UNLIKELY(keyRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    key = *keyRes;
+    if (isMap) {
+      auto valueRes = read();
+      if (LLVM_UNLIKELY(valueRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      value = *valueRes;
+    } else {
+      // Sets store their keys as the values too.
+      value = *keyRes;
+    }
+    if (LLVM_UNLIKELY(
+            JSMapImpl<C>::addValue(mapOrSet, runtime_, key, value) ==
+            ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+  return mapOrSet.getHermesValue();
+}
+
+CallResult<HermesValue> Deserializer::readArrayBuffer() {
+  uint64_t size;
+  if (LLVM_UNLIKELY(!readVarUInt(size) || size > (size_t)(end_ - cur_))) {
+    return raiseInvalid();
+  }
+  auto bufferRes = JSArrayBuffer::create(
+      runtime_, Handle<JSObject>::vmcast(&runtime_->arrayBufferPrototype));
+  if (LLVM_UNLIKELY(bufferRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto buffer = runtime_->makeHandle<JSArrayBuffer>(*bufferRes);
+  if (LLVM_UNLIKELY(
+          buffer->createDataBlock(runtime_, size, false) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  if (size)
+    readBytes(buffer->getDataBlock(), size);
+  if (LLVM_UNLIKELY(
+          push(objects_, buffer.getHermesValue()) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return buffer.getHermesValue();
+}
+
+CallResult<HermesValue> Deserializer::readTransferredArrayBuffer() {
+  uint64_t index;
+  if (LLVM_UNLIKELY(
+          !readVarUInt(index) || index >= data_.transferred.size())) {
+    return raiseInvalid();
+  }
+  auto &block = data_.transferred[index];
+  if (LLVM_UNLIKELY(block.data && !block.owner)) {
+    return runtime_->raiseTypeError(
+        "Transferred ArrayBuffer was already deserialized");
+  }
+  auto bufferRes = JSArrayBuffer::create(
+      runtime_, Handle<JSObject>::vmcast(&runtime_->arrayBufferPrototype));
+  if (LLVM_UNLIKELY(bufferRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto buffer = runtime_->makeHandle<JSArrayBuffer>(*bufferRes);
+  ExecutionStatus status = block.owner
+      ? buffer->setExternalDataBlock(
+            runtime_, block.data, block.size, std::move(block.owner))
+      : buffer->createDataBlock(runtime_, 0);
+  if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  if (LLVM_UNLIKELY(
+          push(objects_, buffer.getHermesValue()) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return buffer.getHermesValue();
+}
+
+CallResult<HermesValue> Deserializer::readTypedArray() {
+  uint8_t kind;
+  uint64_t byteOffset;
+  uint64_t length;
+  if (LLVM_UNLIKELY(
+          !readBytes(&kind, sizeof(kind)) || !readVarUInt(byteOffset) ||
+          !readVarUInt(length))) {
+    return raiseInvalid();
+  }
+  CallResult<HermesValue> arrRes{ExecutionStatus::EXCEPTION};
+  uint8_t byteWidth = 0;
+  switch (static_cast<CellKind>(kind)) {
+#define TYPED_ARRAY(name, type)                                \
+  case CellKind::name##ArrayKind:                              \
+    arrRes = name##Array::create(                              \
+        runtime_, name##Array::getPrototype(runtime_));        \
+    byteWidth = sizeof(type);                                  \
+    break;
+#include "hermes/VM/TypedArrays.def"
+    default:
+      return raiseInvalid();
+  }
+  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto arr = runtime_->makeHandle<JSTypedArrayBase>(*arrRes);
+  if (LLVM_UNLIKELY(
+          push(objects_, arr.getHermesValue()) == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+
+  auto bufferRes = read();
+  if (LLVM_UNLIKELY(bufferRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto *buffer = dyn_vmcast<JSArrayBuffer>(*bufferRes);
+  if (LLVM_UNLIKELY(
+          !buffer || byteOffset % byteWidth ||
+          byteOffset > buffer->size() ||
+          length > (buffer->size() - byteOffset) / byteWidth)) {
+    return raiseInvalid();
+  }
+  JSTypedArrayBase::setBuffer(
+      runtime_, *arr, buffer, byteOffset, length * byteWidth, byteWidth);
+  return arr.getHermesValue();
+}
+
+} // namespace
+
+ExecutionStatus structuredSerialize(
+    Runtime *runtime,
+    Handle<> value,
+    Handle<JSArray> transferList,
+    StructuredCloneData &out) {
+  GCScope gcScope{runtime};
+  out.bytes.clear();
+  out.transferred.clear();
+  Serializer serializer{runtime, out.bytes};
+
+  uint32_t transferCount = transferList ? JSArray::getLength(*transferList) : 0;
+  for (uint32_t i = 0; i < transferCount; ++i) {
+    auto *buffer = dyn_vmcast<JSArrayBuffer>(transferList->at(runtime, i));
+    if (!buffer || !buffer->attached()) {
+      return runtime->raiseTypeError(
+          "Transfer list must only contain attached ArrayBuffers");
+    }
+    if (!serializer.addTransfer(buffer, i)) {
+      return runtime->raiseTypeError(
+          "Transfer list contains the same ArrayBuffer twice");
+    }
+  }
+
+  serializer.writeHeader();
+  if (LLVM_UNLIKELY(serializer.write(value) == ExecutionStatus::EXCEPTION)) {
+    out.bytes.clear();
+    return ExecutionStatus::EXCEPTION;
+  }
+
+  // Only detach the transferred buffers once nothing can fail anymore.
+  out.transferred.reserve(transferCount);
+  for (uint32_t i = 0; i < transferCount; ++i) {
+    auto *buffer = vmcast<JSArrayBuffer>(transferList->at(runtime, i));
+    StructuredCloneData::TransferredBlock block;
+    block.owner =
+        buffer->releaseDataBlock(&runtime->getHeap(), &block.data, &block.size);
+    out.transferred.push_back(std::move(block));
+  }
+  return ExecutionStatus::RETURNED;
+}
+
+CallResult<HermesValue> structuredDeserialize(
+    Runtime *runtime,
+    StructuredCloneData &data) {
+  GCScope gcScope{runtime};
+  Deserializer deserializer{runtime, data};
+  if (LLVM_UNLIKELY(deserializer.init() == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto res = deserializer.read();
+  if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  if (LLVM_UNLIKELY(deserializer.finish() == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return res;
+}
+
+} // namespace vm
+} // namespace hermes
@@ -13,6 +13,7 @@
 #include "hermes/VM/CompleteMarkState-inline.h"
 #include "hermes/VM/CompleteMarkState.h"
 #include "hermes/VM/DeadRegion.h"
+#include "hermes/VM/FillerCell.h"
 #include "hermes/VM/GC.h"
 #include "hermes/VM/GCBase-inline.h"
 #include "hermes/VM/GCBase.h"
@@ -88,6 +89,31 @@ void AlignedHeapSegment::resetLevel() {
 template void AlignedHeapSegment::resetLevel<AdviseUnused::Yes>();
 template void AlignedHeapSegment::resetLevel<AdviseUnused::No>();
 
+size_t AlignedHeapSegment::adviseUnused() {
+  return adviseUnusedFrom(level_);
+}
+
+size_t AlignedHeapSegment::adviseUnreached() {
+  char *peak = std::max(peakLevel_, level_);
+  peakLevel_ = level_;
+  return adviseUnusedFrom(peak);
+}
+
+size_t AlignedHeapSegment::adviseUnusedFrom(char *from) {
+#ifndef NDEBUG
+  (void)from;
+  return 0;
+#else
+  const size_t PS = oscompat::page_size();
+  from = reinterpret_cast<char *>(
+      llvm::alignTo(reinterpret_cast<uintptr_t>(from), PS));
+  if (from >= hiLim())
+    return 0;
+  storage_.markUnused(from, hiLim());
+  return hiLim() - from;
+#endif
+}
+
 void AlignedHeapSegment::setEffectiveEnd(char *effectiveEnd) {
   assert(
       start() <= effectiveEnd && effectiveEnd <= end() &&
@@ -199,9 +225,35 @@ void AlignedHeapSegment::completeMarking(GC *gc, CompleteMarkState *markState) {
   assert(markState->varSizeMarkStack_.empty());
 }
 
+bool AlignedHeapSegment::canSweepInPlace(unsigned livePercent) const {
+  if (used() == 0) {
+    return false;
+  }
+
+  MarkBitArrayNC &markBits = markBitArray();
+  size_t indexLimit = markBits.addressToIndex(level() - 1) + 1;
+  char *adjacentPtr = start();
+  size_t liveBytes = 0;
+  for (size_t ind = markBits.findNextMarkedBitFrom(
+           markBits.addressToIndex(start()));
+       ind < indexLimit;
+       ind = markBits.findNextMarkedBitFrom(ind + 1)) {
+    char *ptr = markBits.indexToAddress(ind);
+    if (ptr != adjacentPtr &&
+        static_cast<size_t>(ptr - adjacentPtr) < sizeof(FillerCell)) {
+      return false;
+    }
+    auto cellSize = reinterpret_cast<GCCell *>(ptr)->getAllocatedSize();
+    liveBytes += cellSize;
+    adjacentPtr = ptr + cellSize;
+  }
+  return liveBytes * 100 >= used() * livePercent;
+}
+
 void AlignedHeapSegment::sweepAndInstallForwardingPointers(
     GC *gc,
-    SweepResult *sweepResult) {
+    SweepResult *sweepResult,
+    unsigned inPlaceLivePercent) {
   MarkBitArrayNC &markBits = markBitArray();
 
   char *ptr = start();
@@ -214,8 +266,16 @@ void AlignedHeapSegment::sweepAndInstallForwardingPointers(
   // beginning of a dead region.
   char *adjacentPtr = ptr;
 
+  sweepResult->segments.emplace_back(sweepResult->displacedVtablePtrs.size());
+  char *firstDest = nullptr;
+  char *lastDest = nullptr;
+
   auto &compactionResult = sweepResult->compactionResult;
   auto *chunk = compactionResult.activeChunk();
+  // Every live object in a segment that is swept in place is compacted to its
+  // current address, as the gaps before it are filled first.
+  const bool inPlace = inPlaceLivePercent && chunk->isEmptyChunkOf(this) &&
+      canSweepInPlace(inPlaceLivePercent);
   do {
     auto allocator = chunk->allocator();
 
@@ -225,6 +285,28 @@ void AlignedHeapSegment::sweepAndInstallForwardingPointers(
       ptr = markBits.indexToAddress(ind);
       GCCell *cell = reinterpret_cast<GCCell *>(ptr);
       auto cellSize = cell->getAllocatedSize();
+
+      if (inPlace && ptr != adjacentPtr) {
+        // Allocate and fill the gap first, so that the cell is allocated at
+        // its current address.  Marking the filler makes the later phases
+        // treat it like any other live cell.
+        auto gapSize = ptr - adjacentPtr;
+        auto gapRes = allocator.alloc(gapSize);
+        (void)gapRes;
+        assert(
+            gapRes.success &&
+            reinterpret_cast<char *>(gapRes.ptr) == adjacentPtr &&
+            "Gaps in a segment swept in place must stay where they are");
+        auto *filler = new (adjacentPtr) FillerCell(gc, gapSize);
+        markBits.mark(markBits.addressToIndex(adjacentPtr));
+        sweepResult->displacedVtablePtrs.push_back(filler->getVT());
+        filler->setForwardingPointer(filler);
+        if (!firstDest) {
+          firstDest = adjacentPtr;
+        }
+        adjacentPtr = ptr;
+      }
+
       // TODO(T43077289): if we rehabilitate ArrayStorage trimming, reenable
       // this code.
 #if 0
@@ -255,6 +337,10 @@ void AlignedHeapSegment::sweepAndInstallForwardingPointers(
 
       sweepResult->displacedVtablePtrs.push_back(cell->getVT());
       cell->setForwardingPointer(reinterpret_cast<GCCell *>(res.ptr));
+      if (!firstDest) {
+        firstDest = reinterpret_cast<char *>(res.ptr);
+      }
+      lastDest = reinterpret_cast<char *>(res.ptr);
       adjacentPtr = ptr += cellSize;
     }
 
@@ -266,6 +352,8 @@ void AlignedHeapSegment::sweepAndInstallForwardingPointers(
     }
   } while ((chunk = compactionResult.nextChunk()));
   assert(ind >= indexLimit && "We didn't have enough space to compact into");
+  sweepResult->segments.back().firstDest = firstDest;
+  sweepResult->segments.back().lastDest = lastDest;
 
   if (adjacentPtr < level_) {
     new (adjacentPtr) DeadRegion(level_ - adjacentPtr);
@@ -20,6 +20,53 @@ void CardTable::dirtyCardsForAddressRange(const void *low, const void *high) {
   dirtyRange(addressToIndex(low), addressToIndex(high));
 }
 
+OptValue<size_t> CardTable::findNextDirtyCard(
+    size_t fromIndex,
+    size_t endIndex) const {
+  if (fromIndex >= endIndex)
+    return OptValue<size_t>();
+  const size_t summaryEnd = ((endIndex - 1) >> kLogCardsPerSummary) + 1;
+  size_t index = fromIndex;
+  while (index < endIndex) {
+    // Skip the summary entries whose cards are all clean.
+    const size_t summaryIndex = index >> kLogCardsPerSummary;
+    const void *entry = memchr(
+        summary_ + summaryIndex,
+        static_cast<char>(CardStatus::Dirty),
+        summaryEnd - summaryIndex);
+    if (entry == nullptr)
+      return OptValue<size_t>();
+    const size_t dirtySummary =
+        reinterpret_cast<const CardStatus *>(entry) - summary_;
+
+    index = std::max(index, dirtySummary << kLogCardsPerSummary);
+    const size_t blockEnd =
+        std::min(endIndex, (dirtySummary + 1) << kLogCardsPerSummary);
+    if (auto dirty =
+            findNextCardWithStatus(CardStatus::Dirty, index, blockEnd)) {
+      return dirty;
+    }
+    index = blockEnd;
+  }
+  return OptValue<size_t>();
+}
+
+size_t CardTable::numCardsInCleanSummaries(size_t fromIndex, size_t endIndex)
+    const {
+  size_t count = 0;
+  size_t index = fromIndex;
+  while (index < endIndex) {
+    const size_t summaryIndex = index >> kLogCardsPerSummary;
+    const size_t blockEnd =
+        std::min(endIndex, (summaryIndex + 1) << kLogCardsPerSummary);
+    if (summary_[summaryIndex] == CardStatus::Clean) {
+      count += blockEnd - index;
+    }
+    index = blockEnd;
+  }
+  return count;
+}
+
 OptValue<size_t> CardTable::findNextCardWithStatus(
     CardStatus status,
     size_t fromIndex,
@@ -71,6 +118,18 @@ void CardTable::cleanOrDirtyRange(
   for (size_t index = from; index <= to; index++) {
     cards_[index] = cleanOrDirty;
   }
+
+  // Keep the summary conservative: any entry with a dirty card is dirty, but
+  // only entries whose cards were all cleaned can be cleaned.
+  const bool dirty = cleanOrDirty == CardStatus::Dirty;
+  const size_t summaryFrom = dirty
+      ? from >> kLogCardsPerSummary
+      : (from + kCardsPerSummary - 1) >> kLogCardsPerSummary;
+  const size_t summaryEnd = dirty ? (to >> kLogCardsPerSummary) + 1
+                                  : (to + 1) >> kLogCardsPerSummary;
+  for (size_t index = summaryFrom; index < summaryEnd; index++) {
+    summary_[index] = cleanOrDirty;
+  }
 }
 
 void CardTable::updateBoundaries(
@@ -275,6 +275,12 @@ void GenGC::collect() {
     // Also record as a full collection.
     recordGCStats(
         wallElapsedSecs, cpuElapsedSecs, size(), &fullCollectionCumStats_);
+    recordGCTelemetry(
+        GCTelemetry::Kind::Full,
+        wallElapsedSecs,
+        /* promotedBytes */ 0,
+        size());
+    flushFinalizedMemory();
     size_t usedAfter = used();
     cumPostBytes_ += usedAfter;
     fullGCSystraceRegion.addArg("fullGCUsedAfter", usedAfter);
@@ -999,7 +1005,9 @@ void GenGC::updateTotalAllocStats() {
   totalAllocatedBytes_ += bytesAllocatedSinceLastGC();
 }
 
-void GenGC::createSnapshot(llvm::raw_ostream &os, bool compact) {
+void GenGC::createSnapshot(
+    llvm::raw_ostream &os,
+    const HeapSnapshotOptions &options) {
   // We'll say we're in GC even though we're not, to avoid assertion failures.
   GCCycle cycle{this};
 #ifdef HERMES_SLOW_DEBUG
@@ -1007,7 +1015,7 @@ void GenGC::createSnapshot(llvm::raw_ostream &os, bool compact) {
 #endif
   HeapInfo info;
   getHeapInfo(info);
-  FacebookHeapSnapshot snap(os, compact, info.allocatedBytes);
+  FacebookHeapSnapshot snap(os, options.compact, info.allocatedBytes);
   auto ptrToOffset = [this](const void *ptr) -> uint64_t {
     // This encodes all pointers as offsets from the start of the young
     // generation. This relies on the assumption that the young gen always
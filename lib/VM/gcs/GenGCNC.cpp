@@ -23,6 +23,8 @@
 #include "hermes/VM/GCPointer-inline.h"
 #include "hermes/VM/HeapSnapshot.h"
 #include "hermes/VM/HermesValue-inline.h"
+#include "hermes/VM/ParallelCompactor.h"
+#include "hermes/VM/ParallelMarker.h"
 #include "hermes/VM/SnapshotAcceptor.h"
 #include "hermes/VM/SnapshotEdgeAcceptor.h"
 #include "hermes/VM/SnapshotNodeAcceptor.h"
@@ -98,11 +100,25 @@ GenGC::GenGC(
       oldGen_(
           this,
           generationSizes_.oldGenSize(),
-          gcConfig.getShouldReleaseUnused()),
+          gcConfig.getShouldReleaseUnused() &&
+              gcConfig.getReleaseUnusedDecayMs() == 0),
       allocContextFromYG_(gcConfig.getAllocInYoung()),
       revertToYGAtTTI_(gcConfig.getRevertToYGAtTTI()),
       oomThreshold_(gcConfig.getEffectiveOOMThreshold()),
-      weightedUsed_(static_cast<double>(gcConfig.getInitHeapSize())) {
+      weightedUsed_(static_cast<double>(gcConfig.getInitHeapSize())),
+      releaseDecay_(
+          gcConfig.getShouldReleaseUnused()
+              ? gcConfig.getReleaseUnusedDecayMs()
+              : 0),
+      lastDecayedRelease_(steady_clock::now()),
+      numMarkingThreads_(std::max(1u, gcConfig.getNumMarkingThreads())),
+      numCompactionThreads_(
+          std::max(1u, gcConfig.getNumCompactionThreads())),
+      inPlaceLivePercent_(std::min(100u, gcConfig.getInPlaceLivePercent())),
+      costSizing_(gcConfig.getTargetGCCostRatio()) {
+#ifndef HERMESVM_GC_GENERATIONAL_MARKSWEEPCOMPACT
+  allocSiteFeedback_ = gcConfig.getAllocSitePretenuring();
+#endif
   growTo(gcConfig.getInitHeapSize());
   claimAllocContext();
 }
@@ -309,6 +325,14 @@ void GenGC::collect(bool canEffectiveOOM) {
 
     markPhase();
 
+    // Credit the sampled allocation sites before finalizers run, since they
+    // may free the CodeBlocks that own the sites.
+    processAllocationSiteSamples([this](GCCell *cell) -> OptValue<bool> {
+      if (!youngGen_.contains(cell))
+        return llvm::None;
+      return AlignedHeapSegment::getCellMarkBit(cell);
+    });
+
     finalizeUnreachableObjects();
 
     auto ygExtMem = youngGen_.externalMemory();
@@ -358,6 +382,13 @@ void GenGC::collect(bool canEffectiveOOM) {
         recordStatsNC(sweepResult.compactionResult);
 
     fullCollection.recordGCStats(sizeDirect(), &fullCollectionCumStats_);
+    recordGCTelemetry(
+        GCTelemetry::Kind::Full,
+        fullCollection.wallElapsedSecs(),
+        /* promotedBytes */ 0,
+        sizeDirect());
+    recordGCCost(fullCollection.wallElapsedSecs());
+    flushFinalizedMemory();
 
     fullCollection.addArg("fullGCUsedAfter", usedAfter);
     fullCollection.addArg("fullGCSizeAfter", sizeAfter);
@@ -547,6 +578,14 @@ void GenGC::clearMarkBits() {
 }
 
 void GenGC::completeMarking() {
+  if (numMarkingThreads_ > 1) {
+    std::vector<AlignedHeapSegment *> segments(
+        segmentIndex_.begin(), segmentIndex_.end());
+    ParallelMarker marker(this, numMarkingThreads_);
+    marker.completeMarking(segments);
+    return;
+  }
+
   // completeMarking returns a boolean that is true if and only if the mark
   // stack overflowed whilst trying to complete marking.  When this happens, we
   // must restart marking from the beginning (in increasing order of virtual
@@ -572,7 +611,8 @@ void GenGC::sweepAndInstallForwardingPointers(SweepResult *sweepResult) {
   // generation.
   auto sweepStart = steady_clock::now();
 
-  oldGen_.sweepAndInstallForwardingPointers(this, sweepResult);
+  oldGen_.sweepAndInstallForwardingPointers(
+      this, sweepResult, inPlaceLivePercent_);
   youngGen_.sweepAndInstallForwardingPointers(this, sweepResult);
 
   sweepSecs_ += GCBase::clockDiffSeconds(sweepStart, steady_clock::now());
@@ -591,15 +631,23 @@ void GenGC::updateReferences(const SweepResult &sweepResult) {
   DroppingAcceptor<SlotAcceptor> nameWeakAcceptor{weakAcceptor};
   markWeakRoots(nameWeakAcceptor);
 
-  SweepResult::VTablesRemaining vTables(
-      sweepResult.displacedVtablePtrs.begin(),
-      sweepResult.displacedVtablePtrs.end());
-
-  // We swept the old gen into itself before sweeping the young gen.  We must
-  // preserve this order here, to match up cells with their displaced VTable
-  // pointers.
-  oldGen_.updateReferences(this, vTables);
-  youngGen_.updateReferences(this, vTables);
+  if (numCompactionThreads_ > 1) {
+    ParallelCompactor compactor(
+        this, numCompactionThreads_, sweepResult, sweptSegments());
+    compactor.updateReferences();
+    oldGen_.updateFinalizableCellListReferences();
+    youngGen_.updateFinalizableCellListReferences();
+  } else {
+    SweepResult::VTablesRemaining vTables(
+        sweepResult.displacedVtablePtrs.begin(),
+        sweepResult.displacedVtablePtrs.end());
+
+    // We swept the old gen into itself before sweeping the young gen.  We
+    // must preserve this order here, to match up cells with their displaced
+    // VTable pointers.
+    oldGen_.updateReferences(this, vTables);
+    youngGen_.updateReferences(this, vTables);
+  }
 
   updateWeakReferences(/*fullGC*/ true);
   updateReferencesSecs_ +=
@@ -612,29 +660,37 @@ void GenGC::compact(const SweepResult &sweepResult) {
 
   auto &compactionResult = sweepResult.compactionResult;
 
-  SweepResult::VTablesRemaining vTables(
-      sweepResult.displacedVtablePtrs.begin(),
-      sweepResult.displacedVtablePtrs.end());
-
   CompactionResult::ChunksRemaining chunks(
       compactionResult.usedChunks().begin(),
       compactionResult.usedChunks().end());
 
-  // We swept the old gen into itself before sweeping the young gen.  We must
-  // preserve this order here, so that we re-associate the correct VTable
-  // pointers, and match up the chunks we used with the segments they were
-  // created from.
-  auto doCompaction = [&vTables](AlignedHeapSegment &segment) {
-    segment.compact(vTables);
-  };
+  if (numCompactionThreads_ > 1) {
+    ParallelCompactor compactor(
+        this, numCompactionThreads_, sweepResult, sweptSegments());
+    compactor.compact();
+  } else {
+    SweepResult::VTablesRemaining vTables(
+        sweepResult.displacedVtablePtrs.begin(),
+        sweepResult.displacedVtablePtrs.end());
+
+    // We swept the old gen into itself before sweeping the young gen.  We
+    // must preserve this order here, so that we re-associate the correct
+    // VTable pointers.
+    auto doCompaction = [&vTables](AlignedHeapSegment &segment) {
+      segment.compact(vTables);
+    };
 
-  oldGen_.forUsedSegments(doCompaction);
-  youngGen_.forUsedSegments(doCompaction);
+    oldGen_.forUsedSegments(doCompaction);
+    youngGen_.forUsedSegments(doCompaction);
 
+    assert(!vTables.hasNext() && "Not all vtable pointers replaced.");
+  }
+
+  // Match up the chunks we used with the segments they were created from, in
+  // the order they were swept.
   oldGen_.recordLevelAfterCompaction(chunks);
   youngGen_.recordLevelAfterCompaction(chunks);
 
-  assert(!vTables.hasNext() && "Not all vtable pointers replaced.");
   assert(!chunks.hasNext() && "Not all chunks written back to their segments.");
 
   youngGen_.compactFinalizableObjectList();
@@ -652,6 +708,16 @@ void GenGC::compact(const SweepResult &sweepResult) {
   compactSecs_ += GCBase::clockDiffSeconds(compactStart, steady_clock::now());
 }
 
+std::vector<AlignedHeapSegment *> GenGC::sweptSegments() {
+  std::vector<AlignedHeapSegment *> segments;
+  auto addSegment = [&segments](AlignedHeapSegment &segment) {
+    segments.push_back(&segment);
+  };
+  oldGen_.forUsedSegments(addSegment);
+  youngGen_.forUsedSegments(addSegment);
+  return segments;
+}
+
 void GenGC::markSymbol(SymbolID symbolID) {
   if (LLVM_UNLIKELY(symbolID.isInvalid()))
     return;
@@ -897,8 +963,10 @@ void GenGC::updateHeapSize() {
     // Otherwise, we may wish to shrink the heap.  If we do this, it may shrink
     // the the YG size.  To prevent shrinking past the current level_, we only
     // do this if the YG is empty -- which should be the common case at the end
-    // of a full GC.
-  } else if (LLVM_LIKELY(youngGen_.usedDirect() == 0)) {
+    // of a full GC.  When costSizing_ is enabled, it decides when to shrink
+    // instead, see recordGCCost.
+  } else if (
+      LLVM_LIKELY(youngGen_.usedDirect() == 0) && !costSizing_.enabled()) {
     // Note that the Generations' adjustSize methods set a non-zero lower limit
     // on the generation sizes, so the heap size will not fall to zero, even if
     // the live data is zero.  Note that shrinkTo is a no-op if targetSize >=
@@ -907,6 +975,78 @@ void GenGC::updateHeapSize() {
   }
 }
 
+void GenGC::recordGCCost(double pauseSecs) {
+  if (!costSizing_.enabled())
+    return;
+  costSizing_.recordCollection(pauseSecs, steady_clock::now());
+  const double factor = costSizing_.takeSizeFactor();
+  const double sizeHint = sizeDirect() * factor;
+  if (factor > 1.0) {
+    growTo(static_cast<size_t>(sizeHint));
+  } else if (factor < 1.0 && youngGen_.usedDirect() == 0) {
+    // Do not shrink past the size the occupancy target asks for, which the
+    // next full collection would just grow back to.
+    shrinkTo(std::max(
+        static_cast<size_t>(sizeHint),
+        static_cast<size_t>(usedToDesiredSize(usedDirect()))));
+  }
+}
+
+bool GenGC::collectDuringIdle(TimePoint deadline) {
+  AllocContextYieldThenClaim yielder(this);
+
+  // A full collection also evacuates the young generation, so consider it
+  // first.
+  if (oldGen_.available() < youngGen_.sizeDirect() &&
+      expectedToEndBefore(fullCollectionCumStats_, deadline)) {
+    collect();
+    return true;
+  }
+  if (youngGen_.usedDirect() >=
+          youngGen_.sizeDirect() * kIdleYoungGenOccupancy &&
+      expectedToEndBefore(youngGenCollectionCumStats_, deadline) &&
+      oldGen_.ensureFits(youngGen_.usedDirect())) {
+    youngGen_.collect();
+    return true;
+  }
+  releaseDecayedMemory();
+  return false;
+}
+
+size_t GenGC::releaseUnusedMemory(bool minimize) {
+  AllocContextYieldThenClaim yielder(this);
+  if (youngGen_.usedDirect() == 0)
+    shrinkTo(minimize ? 0 : usedToDesiredSize(usedDirect()));
+  size_t released = oldGen_.releaseUnusedMemory();
+  youngGen_.forUsedSegments([&released](AlignedHeapSegment &segment) {
+    released += segment.adviseUnused();
+  });
+  return released;
+}
+
+size_t GenGC::releaseDecayedMemory() {
+  if (releaseDecay_.count() == 0)
+    return 0;
+  const TimePoint now = steady_clock::now();
+  if (now - lastDecayedRelease_ < releaseDecay_)
+    return 0;
+  lastDecayedRelease_ = now;
+  size_t released = oldGen_.releaseDecayedMemory();
+  youngGen_.forUsedSegments([&released](AlignedHeapSegment &segment) {
+    released += segment.adviseUnreached();
+  });
+  return released;
+}
+
+/* static */ bool GenGC::expectedToEndBefore(
+    const CumulativeHeapStats &stats,
+    TimePoint deadline) {
+  if (stats.numCollections == 0)
+    return false;
+  return clockDiffSeconds(steady_clock::now(), deadline) >=
+      stats.gcWallTime.average();
+}
+
 void GenGC::forAllObjs(const std::function<void(GCCell *)> &callback) {
   youngGen_.forAllObjs(callback);
   oldGen_.forAllObjs(callback);
@@ -1145,7 +1285,9 @@ void GenGC::claimAllocContext() {
   targetGen->setTrueAllocContext(&allocContext_);
 }
 
-void GenGC::createSnapshot(llvm::raw_ostream &os, bool compact) {
+void GenGC::createSnapshot(
+    llvm::raw_ostream &os,
+    const HeapSnapshotOptions &options) {
   // We need to yield/claim at outer scope, to cover the calls to
   // forUsedSegments below.
   AllocContextYieldThenClaim yielder(this);
@@ -1168,7 +1310,7 @@ void GenGC::createSnapshot(llvm::raw_ostream &os, bool compact) {
   }
   HeapInfo info;
   getHeapInfo(info);
-  JSONEmitter json(os, !compact);
+  JSONEmitter json(os, !options.compact);
   V8HeapSnapshot snap(json);
   auto ptrToOffset = [&segmentAddressToIndex](const void *ptr) -> uintptr_t {
     // Turn a pointer into the combo of its segment number, and its offset
@@ -1189,20 +1331,31 @@ void GenGC::createSnapshot(llvm::raw_ostream &os, bool compact) {
   };
   SnapshotNodeAcceptor snapshotNodeAcceptor(*this);
   SlotVisitorWithNames<SnapshotNodeAcceptor> nodeVisitor(snapshotNodeAcceptor);
+  // The stride at which the edges of a node are sampled.
+  auto edgeStride = [&options](unsigned edgeCount) {
+    return V8HeapSnapshot::edgeSamplingStride(
+        edgeCount, options.maxEdgesPerNode);
+  };
+  // Count the edges of a cell, before it is written.
+  auto countEdges = [&nodeVisitor, &snapshotNodeAcceptor, this](
+                        const GCCell *cell) {
+    GCBase::markCellWithNames(
+        nodeVisitor, const_cast<GCCell *>(cell), cell->getVT(), this);
+    return snapshotNodeAcceptor.resetEdgeCount();
+  };
 
   auto writeNodesToSnapshot = [&snap,
-                               &nodeVisitor,
-                               &snapshotNodeAcceptor,
+                               &countEdges,
+                               &edgeStride,
                                &ptrToOffset,
                                &stringToID,
-                               this](const GCCell *cell) {
-    GCBase::markCellWithNames(
-        nodeVisitor, const_cast<GCCell *>(cell), cell->getVT(), this);
+                               &options](const GCCell *cell) {
+    unsigned edgeCount = countEdges(cell);
     V8HeapSnapshot::StringID strID;
     // If the cell is a string, add a value to be printed.
     // TODO: add other special types here.
     if (const StringPrimitive *str = dyn_vmcast<StringPrimitive>(cell)) {
-      strID = stringToID(converter(str));
+      strID = stringToID(converter(str, options.maxStringLength));
     } else {
       strID = stringToID("");
     }
@@ -1211,17 +1364,18 @@ void GenGC::createSnapshot(llvm::raw_ostream &os, bool compact) {
         strID,
         static_cast<V8HeapSnapshot::Node::ID>(ptrToOffset(cell)),
         cell->getAllocatedSize(),
-        snapshotNodeAcceptor.resetEdgeCount()});
+        V8HeapSnapshot::sampledEdgeCount(edgeCount, edgeStride(edgeCount))});
   };
   snap.beginNodes();
   markRoots(snapshotNodeAcceptor, true);
-  snap.addNode(V8HeapSnapshot::Node{CellKind::UninitializedKind,
-                                    stringToID("(GC Roots)"),
-                                    0,
-                                    0,
-                                    snapshotNodeAcceptor.resetEdgeCount()
-
-  });
+  unsigned rootEdgeCount = snapshotNodeAcceptor.resetEdgeCount();
+  snap.addNode(V8HeapSnapshot::Node{
+      CellKind::UninitializedKind,
+      stringToID("(GC Roots)"),
+      0,
+      0,
+      V8HeapSnapshot::sampledEdgeCount(
+          rootEdgeCount, edgeStride(rootEdgeCount))});
   youngGen_.forAllObjs(writeNodesToSnapshot);
   oldGen_.forAllObjs(writeNodesToSnapshot);
   snap.endNodes();
@@ -1230,12 +1384,22 @@ void GenGC::createSnapshot(llvm::raw_ostream &os, bool compact) {
       *this, snap, ptrToOffset, stringToID);
   SlotVisitorWithNames<SnapshotEdgeAcceptor> edgeVisitor(snapshotEdgeAcceptor);
 
-  auto writeEdgesToSnapshot = [&edgeVisitor, this](const GCCell *cell) {
+  auto writeEdgesToSnapshot = [&edgeVisitor,
+                               &snapshotEdgeAcceptor,
+                               &countEdges,
+                               &edgeStride,
+                               &options,
+                               this](const GCCell *cell) {
+    // The edges are only counted again if they may be sampled, rather than
+    // remembered for every node.
+    snapshotEdgeAcceptor.beginNode(
+        options.maxEdgesPerNode ? edgeStride(countEdges(cell)) : 1);
     GCBase::markCellWithNames(
         edgeVisitor, const_cast<GCCell *>(cell), cell->getVT(), this);
   };
 
   snap.beginEdges();
+  snapshotEdgeAcceptor.beginNode(edgeStride(rootEdgeCount));
   markRoots(snapshotEdgeAcceptor, true);
   youngGen_.forAllObjs(writeEdgesToSnapshot);
   oldGen_.forAllObjs(writeEdgesToSnapshot);
@@ -1354,11 +1518,20 @@ GenGC::CollectionSection::CollectionSection(GenGC *gc, const char *name)
 #endif
 
   gc_->updateTotalAllocStats();
+
+  // The segments are at their peak levels since the previous collection.
+  if (gc_->releaseDecay_.count() != 0) {
+    gc_->youngGen_.forUsedSegments(
+        [](AlignedHeapSegment &segment) { segment.notePeakLevel(); });
+    gc_->oldGen_.forUsedSegments(
+        [](AlignedHeapSegment &segment) { segment.notePeakLevel(); });
+  }
 }
 
 GenGC::CollectionSection::~CollectionSection() {
   gc_->youngGen_.didFinishGC();
   gc_->oldGen_.didFinishGC();
+  gc_->releaseDecayedMemory();
 
 #ifdef HERMES_SLOW_DEBUG
   gc_->checkWellFormedHeap();
@@ -326,6 +326,12 @@ void MallocGC::collect() {
   double wallElapsedSecs = GCBase::clockDiffSeconds(wallStart, wallEnd);
   double cpuElapsedSecs = GCBase::clockDiffSeconds(cpuStart, cpuEnd);
   recordGCStats(wallElapsedSecs, cpuElapsedSecs, allocatedBytes_);
+  recordGCTelemetry(
+      GCTelemetry::Kind::Full,
+      wallElapsedSecs,
+      /* promotedBytes */ 0,
+      allocatedBytes_);
+  flushFinalizedMemory();
   checkTripwire(allocatedBytes_, wallEnd);
 }
 
@@ -472,7 +478,9 @@ bool MallocGC::isMostRecentFinalizableObj(const GCCell *cell) const {
 }
 #endif
 
-void MallocGC::createSnapshot(llvm::raw_ostream &os, bool compact) {
+void MallocGC::createSnapshot(
+    llvm::raw_ostream &os,
+    const HeapSnapshotOptions &options) {
   llvm_unreachable("No snapshots allowed with MallocGC");
 }
 
@@ -294,10 +294,12 @@ void OldGen::updateEffectiveEndForExternalMemory() {
   trueActiveSegment().setEffectiveEnd(clampedEnd.ptr);
 }
 
-void OldGen::markYoungGenPointers(OldGen::Location originalLevel) {
+OldGen::CardScanCounts OldGen::markYoungGenPointers(
+    OldGen::Location originalLevel) {
+  CardScanCounts counts;
   if (used() == 0) {
     // Nothing to do if the old gen is empty.
-    return;
+    return counts;
   }
 
 #ifdef HERMES_SLOW_DEBUG
@@ -398,6 +400,8 @@ void OldGen::markYoungGenPointers(OldGen::Location originalLevel) {
 
     size_t from = cardTable.addressToIndex(seg->start());
     size_t to = cardTable.addressToIndex(origSegLevel - 1) + 1;
+    counts.numCards += to - from;
+    counts.numSkipped += cardTable.numCardsInCleanSummaries(from, to);
 
     while (const auto oiBegin = cardTable.findNextDirtyCard(from, to)) {
       const auto iBegin = *oiBegin;
@@ -442,6 +446,7 @@ void OldGen::markYoungGenPointers(OldGen::Location originalLevel) {
     cardTable.clear();
     i++;
   }
+  return counts;
 }
 
 void OldGen::youngGenTransitiveClosure(
@@ -513,10 +518,13 @@ void OldGen::verifyCardTableBoundaries() const {
 
 void OldGen::sweepAndInstallForwardingPointers(
     GC *gc,
-    SweepResult *sweepResult) {
-  forUsedSegments([gc, sweepResult](AlignedHeapSegment &segment) {
-    segment.sweepAndInstallForwardingPointers(gc, sweepResult);
-  });
+    SweepResult *sweepResult,
+    unsigned inPlaceLivePercent) {
+  forUsedSegments(
+      [gc, sweepResult, inPlaceLivePercent](AlignedHeapSegment &segment) {
+        segment.sweepAndInstallForwardingPointers(
+            gc, sweepResult, inPlaceLivePercent);
+      });
 }
 
 void OldGen::updateReferences(GC *gc, SweepResult::VTablesRemaining &vTables) {
@@ -607,6 +615,28 @@ void OldGen::recreateCardTableBoundaries() {
 #endif
 }
 
+size_t OldGen::releaseUnusedMemory() {
+  size_t released = segmentCache_.size() * AlignedStorage::size();
+  segmentCache_.clear();
+  segmentCacheLowWater_ = 0;
+  forUsedSegments([&released](AlignedHeapSegment &segment) {
+    released += segment.adviseUnused();
+  });
+  return released;
+}
+
+size_t OldGen::releaseDecayedMemory() {
+  assert(segmentCacheLowWater_ <= segmentCache_.size());
+  size_t released = segmentCacheLowWater_ * AlignedStorage::size();
+  segmentCache_.erase(
+      segmentCache_.begin(), segmentCache_.begin() + segmentCacheLowWater_);
+  segmentCacheLowWater_ = segmentCache_.size();
+  forUsedSegments([&released](AlignedHeapSegment &segment) {
+    released += segment.adviseUnreached();
+  });
+  return released;
+}
+
 bool OldGen::seedSegmentCacheForSize(size_t size) {
   auto committedSegs = [this]() {
     return filledSegments_.size() + segmentCache_.size() + 1;
@@ -654,6 +684,8 @@ bool OldGen::materializeNextSegment() {
   if (!segmentCache_.empty()) {
     exchangeActiveSegment(std::move(segmentCache_.back()), filledSegSlot);
     segmentCache_.pop_back();
+    segmentCacheLowWater_ =
+        std::min(segmentCacheLowWater_, segmentCache_.size());
   } else {
     auto result = AlignedStorage::create(&gc_->storageProvider_, kSegmentName);
     if (!result) {
@@ -685,8 +717,10 @@ void OldGen::releaseSegments(size_t from) {
   // TODO (T30523258) Experiment with different schemes for deciding
   // how many segments we keep in the cache, trading off the VA cost,
   // against the cost of allocating a fresh segment.
-  if (releaseUnused_)
+  if (releaseUnused_) {
     segmentCache_.clear();
+    segmentCacheLowWater_ = 0;
+  }
 
   const auto nSegs = filledSegments_.size() + 1;
   if (from >= nSegs) {
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/ParallelCompactor.h"
+
+#include "hermes/VM/AlignedHeapSegment.h"
+#include "hermes/VM/CompleteMarkState-inline.h"
+#include "hermes/VM/GC.h"
+#include "hermes/VM/GCBase-inline.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace hermes {
+namespace vm {
+
+ParallelCompactor::ParallelCompactor(
+    GC *gc,
+    unsigned numThreads,
+    const SweepResult &sweepResult,
+    std::vector<AlignedHeapSegment *> segments)
+    : gc_(gc),
+      numThreads_(numThreads),
+      sweepResult_(sweepResult),
+      segments_(std::move(segments)) {
+  assert(numThreads >= 1 && "at least one thread is needed to compact");
+  assert(
+      segments_.size() == sweepResult_.segments.size() &&
+      "Every segment must have been swept");
+}
+
+void ParallelCompactor::updateReferences() {
+  std::atomic<size_t> next{0};
+  runOnThreads([this, &next]() {
+    std::unique_ptr<FullMSCUpdateAcceptor> acceptor =
+        getFullMSCUpdateAcceptor(*gc_);
+    for (size_t i; (i = next.fetch_add(1)) < segments_.size();) {
+      SweepResult::VTablesRemaining vTables = vTablesOf(i);
+      segments_[i]->updateReferences(gc_, acceptor.get(), vTables);
+    }
+  });
+}
+
+void ParallelCompactor::compact() {
+  const size_t numSegments = segments_.size();
+
+  // The cells of a segment are moved to a contiguous run of destination
+  // segments, from the one containing the first cell's forwarding address to
+  // the one containing the last's.  Every destination other than the segment
+  // itself comes earlier in sweep order, and must be finished before any cell
+  // is moved into it.  Destinations that were not swept (because they were
+  // empty) hold no cells and need no waiting.  waitFrom[i] and waitTo[i] are
+  // the bounds of that range, and it is empty if waitFrom[i] >= waitTo[i].
+  std::vector<size_t> waitFrom(numSegments, 0);
+  std::vector<size_t> waitTo(numSegments, 0);
+  for (size_t i = 0; i < numSegments; ++i) {
+    const SweepResult::SegmentSummary &summary = sweepResult_.segments[i];
+    if (!summary.firstDest)
+      continue;
+    size_t from = indexOf(summary.firstDest);
+    size_t to = indexOf(summary.lastDest);
+    // A destination that was not swept lies between the old and the young
+    // generation in sweep order.  A run that starts there contains no swept
+    // segment before this one, and a run that ends there conservatively waits
+    // for every swept segment before this one.
+    waitFrom[i] = from < numSegments ? from : i;
+    waitTo[i] = to < i ? to + 1 : i;
+  }
+
+  std::unique_ptr<std::atomic<bool>[]> done{
+      new std::atomic<bool>[numSegments]};
+  for (size_t i = 0; i < numSegments; ++i) {
+    done[i].store(false, std::memory_order_relaxed);
+  }
+
+  std::atomic<size_t> next{0};
+  runOnThreads([&]() {
+    for (size_t i; (i = next.fetch_add(1)) < numSegments;) {
+      for (size_t j = waitFrom[i]; j < waitTo[i]; ++j) {
+        while (!done[j].load(std::memory_order_acquire)) {
+          std::this_thread::yield();
+        }
+      }
+      SweepResult::VTablesRemaining vTables = vTablesOf(i);
+      segments_[i]->compact(vTables);
+      done[i].store(true, std::memory_order_release);
+    }
+  });
+}
+
+SweepResult::VTablesRemaining ParallelCompactor::vTablesOf(size_t index) const {
+  const auto &vTables = sweepResult_.displacedVtablePtrs;
+  size_t end = index + 1 < sweepResult_.segments.size()
+      ? sweepResult_.segments[index + 1].firstVtable
+      : vTables.size();
+  return SweepResult::VTablesRemaining(
+      vTables.begin() + sweepResult_.segments[index].firstVtable,
+      vTables.begin() + end);
+}
+
+size_t ParallelCompactor::indexOf(const char *ptr) const {
+  const void *storage = AlignedStorage::start(ptr);
+  for (size_t i = 0, e = segments_.size(); i < e; ++i) {
+    if (segments_[i]->lowLim() == storage)
+      return i;
+  }
+  return segments_.size();
+}
+
+template <typename F>
+void ParallelCompactor::runOnThreads(F work) {
+  std::vector<std::thread> threads;
+  for (unsigned i = 1; i < numThreads_; ++i) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+}
+
+} // namespace vm
+} // namespace hermes
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/ParallelMarker.h"
+
+#include "hermes/VM/AlignedHeapSegment.h"
+#include "hermes/VM/GC.h"
+#include "hermes/VM/GCBase-inline.h"
+#include "hermes/VM/HermesValue-inline.h"
+#include "hermes/VM/SlotAcceptorDefault.h"
+
+#include <thread>
+
+namespace hermes {
+namespace vm {
+
+/// The state owned by one marking thread.
+struct ParallelMarker::Worker {
+  /// Gray cells that only this worker can see.
+  std::vector<GCCell *> stack;
+
+  /// Guards \c shared.
+  std::mutex sharedMutex;
+
+  /// Gray cells published by this worker, which any worker may take.
+  std::deque<GCCell *> shared;
+
+  /// The size of \c shared, readable without taking the lock.
+  std::atomic<size_t> sharedSize{0};
+
+  /// Cells with weak references that were scanned by this worker.
+  std::vector<GCCell *> weakCells;
+
+  /// Indices of the symbols marked by this worker.
+  std::vector<bool> markedSymbols;
+};
+
+/// Marks the referents of the fields it is given, pushing the cells it was the
+/// first to mark onto the private stack of its worker.
+struct ParallelMarker::MarkAcceptor final : public SlotAcceptorDefault {
+  /// Weak references are marked on the calling thread after the closure is
+  /// complete, see ParallelMarker::mergeResults.
+  static constexpr bool shouldMarkWeak = false;
+
+  Worker &worker;
+
+  MarkAcceptor(GC &gc, Worker &worker)
+      : SlotAcceptorDefault(gc), worker(worker) {}
+
+  using SlotAcceptorDefault::accept;
+
+  void accept(void *&ptr) override {
+    if (ptr) {
+      assert(gc.dbgContains(ptr));
+      MarkBitArrayNC *markBits = AlignedHeapSegment::markBitArrayCovering(ptr);
+      if (markBits->markAtomic(markBits->addressToIndex(ptr))) {
+        worker.stack.push_back(reinterpret_cast<GCCell *>(ptr));
+      }
+    }
+  }
+
+  void accept(HermesValue &hv) override {
+    if (hv.isPointer()) {
+      void *cell = hv.getPointer();
+      accept(cell);
+    } else if (hv.isSymbol()) {
+      accept(hv.getSymbol());
+    }
+  }
+
+  void accept(SymbolID sym) override {
+    if (sym.isInvalid())
+      return;
+    uint32_t index = sym.unsafeGetIndex();
+    if (index >= worker.markedSymbols.size())
+      worker.markedSymbols.resize(index + 1, false);
+    worker.markedSymbols[index] = true;
+  }
+};
+
+ParallelMarker::ParallelMarker(GC *gc, unsigned numThreads) : gc_(gc) {
+  assert(numThreads >= 1 && "at least one thread is needed to mark");
+  for (unsigned i = 0; i < numThreads; ++i) {
+    workers_.emplace_back(new Worker());
+  }
+}
+
+ParallelMarker::~ParallelMarker() = default;
+
+void ParallelMarker::completeMarking(
+    const std::vector<AlignedHeapSegment *> &segments) {
+  // Every cell marked so far is gray. Deal them out to the workers so that all
+  // of them can start right away.
+  size_t next = 0;
+  for (AlignedHeapSegment *segment : segments) {
+    if (segment->used() == 0)
+      continue;
+    MarkBitArrayNC &markBits = segment->markBitArray();
+    size_t indexLimit = markBits.addressToIndex(segment->level() - 1) + 1;
+    for (size_t ind = markBits.findNextMarkedBitFrom(
+             markBits.addressToIndex(segment->start()));
+         ind < indexLimit;
+         ind = markBits.findNextMarkedBitFrom(ind + 1)) {
+      workers_[next]->stack.push_back(
+          reinterpret_cast<GCCell *>(markBits.indexToAddress(ind)));
+      next = (next + 1) % workers_.size();
+    }
+  }
+
+  numIdle_ = 0;
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    Worker *worker = workers_[i].get();
+    threads.emplace_back([this, worker]() { run(*worker); });
+  }
+  run(*workers_[0]);
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  mergeResults();
+}
+
+void ParallelMarker::run(Worker &worker) {
+  MarkAcceptor acceptor(*gc_, worker);
+  while (true) {
+    while (!worker.stack.empty()) {
+      GCCell *cell = worker.stack.back();
+      worker.stack.pop_back();
+      const VTable *vt = cell->getVT();
+      GCBase::markCell(cell, vt, gc_, acceptor);
+      if (vt->hasMarkWeak()) {
+        worker.weakCells.push_back(cell);
+      }
+      shareWork(worker);
+    }
+
+    if (acquireWork(worker))
+      continue;
+
+    // There is nothing to do right now. Wait until another worker publishes
+    // some work, or until every worker is idle. Only workers that are not idle
+    // publish work, and they only go idle once their own queue is empty, so
+    // when all workers are idle there is no work left anywhere.
+    numIdle_.fetch_add(1);
+    while (true) {
+      if (numIdle_.load() == workers_.size())
+        return;
+      if (workAvailable()) {
+        numIdle_.fetch_sub(1);
+        break;
+      }
+      std::this_thread::yield();
+    }
+  }
+}
+
+void ParallelMarker::shareWork(Worker &worker) {
+  if (worker.stack.size() < kShareThreshold ||
+      worker.sharedSize.load(std::memory_order_relaxed) != 0)
+    return;
+
+  // Publish the bottom half of the stack: those cells were pushed first and
+  // tend to lead to larger parts of the graph.
+  size_t half = worker.stack.size() / 2;
+  std::lock_guard<std::mutex> lock(worker.sharedMutex);
+  worker.shared.insert(
+      worker.shared.end(), worker.stack.begin(), worker.stack.begin() + half);
+  worker.stack.erase(worker.stack.begin(), worker.stack.begin() + half);
+  worker.sharedSize = worker.shared.size();
+}
+
+bool ParallelMarker::acquireWork(Worker &worker) {
+  {
+    std::lock_guard<std::mutex> lock(worker.sharedMutex);
+    if (!worker.shared.empty()) {
+      worker.stack.insert(
+          worker.stack.end(), worker.shared.begin(), worker.shared.end());
+      worker.shared.clear();
+      worker.sharedSize = 0;
+      return true;
+    }
+  }
+
+  for (auto &victimPtr : workers_) {
+    Worker &victim = *victimPtr;
+    if (&victim == &worker || victim.sharedSize.load() == 0)
+      continue;
+    std::lock_guard<std::mutex> lock(victim.sharedMutex);
+    if (victim.shared.empty())
+      continue;
+    // Take half of the published cells, leaving the rest to other thieves.
+    size_t count = (victim.shared.size() + 1) / 2;
+    worker.stack.insert(
+        worker.stack.end(),
+        victim.shared.begin(),
+        victim.shared.begin() + count);
+    victim.shared.erase(victim.shared.begin(), victim.shared.begin() + count);
+    victim.sharedSize = victim.shared.size();
+    return true;
+  }
+  return false;
+}
+
+bool ParallelMarker::workAvailable() const {
+  for (const auto &worker : workers_) {
+    if (worker->sharedSize.load() != 0)
+      return true;
+  }
+  return false;
+}
+
+void ParallelMarker::mergeResults() {
+  for (auto &worker : workers_) {
+    for (GCCell *cell : worker->weakCells) {
+      cell->getVT()->markWeakIfExists(cell, gc_);
+    }
+    worker->weakCells.clear();
+
+    for (uint32_t i = 0, e = worker->markedSymbols.size(); i < e; ++i) {
+      if (worker->markedSymbols[i]) {
+        gc_->markSymbol(SymbolID::unsafeCreate(i));
+      }
+    }
+    worker->markedSymbols.clear();
+  }
+}
+
+} // namespace vm
+} // namespace hermes
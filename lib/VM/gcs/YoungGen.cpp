@@ -312,6 +312,12 @@ void YoungGen::collect() {
     size_t promotedBytes = (nextGen_->used() - oldGenUsedBefore);
     cumPromotedBytes_ += promotedBytes;
     ygSystraceSection.addArg("ygPromoted", promotedBytes);
+    gc_->recordGCTelemetry(
+        GCTelemetry::Kind::YoungGen,
+        wallElapsedSecs,
+        promotedBytes,
+        gc_->size());
+    gc_->flushFinalizedMemory();
 
     LLVM_DEBUG(
         dbgs() << "End (young-gen) garbage collection. numCollected="
@@ -173,8 +173,15 @@ void YoungGen::printStats(llvm::raw_ostream &os, bool trailingComma) const {
     youngGenSurvivalPct = 100.0 * static_cast<double>(cumPromotedBytes_) /
         static_cast<double>(cumPreBytes_);
   }
+  double cardSkipPct = 0.0;
+  if (cumCardsScanned_ > 0) {
+    cardSkipPct = 100.0 * static_cast<double>(cumCardsSkipped_) /
+        static_cast<double>(cumCardsScanned_);
+  }
 
   os << "\t\t\t\"ygMarkOldToYoungTime\": " << markOldToYoungSecs_ << ",\n"
+     << "\t\t\t\"ygCardsScanned\": " << cumCardsScanned_ << ",\n"
+     << "\t\t\t\"ygCardSkipPct\": " << cardSkipPct << ",\n"
      << "\t\t\t\"ygMarkRootsTime\": " << markRootsSecs_ << ",\n"
      << "\t\t\t\"ygScanTransitiveTime\": " << scanTransitiveSecs_ << ",\n"
      << "\t\t\t\"ygUpdateWeakRefsTime\": " << updateWeakRefsSecs_ << ",\n"
@@ -303,7 +310,10 @@ void YoungGen::collect() {
   auto markOldToYoungStart = steady_clock::now();
   {
     PerfSection ygMarkOldToYoungSystraceRegion("ygMarkOldToYoung");
-    nextGen_->markYoungGenPointers(toScan);
+    const OldGen::CardScanCounts cardCounts =
+        nextGen_->markYoungGenPointers(toScan);
+    cumCardsScanned_ += cardCounts.numCards;
+    cumCardsSkipped_ += cardCounts.numSkipped;
   }
 
   auto markRootsStart = steady_clock::now();
@@ -328,6 +338,14 @@ void YoungGen::collect() {
     gc_->updateWeakReferences(/*fullGC*/ false);
   }
 
+  // Credit the sampled allocation sites before finalizers run, since they may
+  // free the CodeBlocks that own the sites.
+  gc_->processAllocationSiteSamples([this](GCCell *cell) -> OptValue<bool> {
+    if (!contains(cell))
+      return llvm::None;
+    return cell->hasMarkedForwardingPointer();
+  });
+
   // Call the finalizers of unreachable objects. Assumes all cells that survived
   // the young gen collection are moved to the old gen collection.
   auto finalizersStart = steady_clock::now();
@@ -387,6 +405,13 @@ void YoungGen::collect() {
   size_t promotedBytes = (nextGen_->used() - oldGenUsedBefore);
   cumPromotedBytes_ += promotedBytes;
   ygCollection.addArg("ygPromoted", promotedBytes);
+  gc_->recordGCTelemetry(
+      GCTelemetry::Kind::YoungGen,
+      ygCollection.wallElapsedSecs(),
+      promotedBytes,
+      gc_->sizeDirect());
+  gc_->recordGCCost(ygCollection.wallElapsedSecs());
+  gc_->flushFinalizedMemory();
   ygCollection.addArg("ogUsedAfter", nextGen_->used());
   ygCollection.addArg(
       "ygGCNum", gc_->youngGenCollectionCumStats_.numCollections);
@@ -88,6 +88,13 @@ _HERMES_CTORCONFIG_STRUCT(GCSanitizeConfig, GC_HANDLESAN_FIELDS, {});
   /* Whether to return unused memory to the OS. */                         \
   F(bool, ShouldReleaseUnused, true)                                       \
                                                                            \
+  /* If nonzero, unused memory is not returned to the OS by the            \
+     collection that freed it, but once it has stayed unused for this      \
+     many milliseconds, as checked at the end of collections and when      \
+     idle. Longer intervals fault fewer pages in again, shorter ones       \
+     keep the resident set lower. */                                       \
+  F(unsigned, ReleaseUnusedDecayMs, 0)                                     \
+                                                                           \
   /* Name for this heap in logs. */                                        \
   F(std::string, Name, "HermesRuntime")                                    \
                                                                            \
@@ -101,8 +108,47 @@ _HERMES_CTORCONFIG_STRUCT(GCSanitizeConfig, GC_HANDLESAN_FIELDS, {});
   /* Whether to revert, if necessary, to young-gen allocation at TTI. */   \
   F(bool, RevertToYGAtTTI, false)                                          \
                                                                            \
+  /* Whether to track the survival of objects allocated by literals, */    \
+  /* and allocate in the old gen at sites whose objects keep surviving. */ \
+  F(bool, AllocSitePretenuring, false)                                     \
+                                                                           \
   /* Pointer to the memory profiler (Memory Event Tracker). */             \
   F(std::shared_ptr<MemoryEventTracker>, MemEventTracker, nullptr)         \
+                                                                           \
+  /* Number of threads (including the mutator) used to complete marking */ \
+  /* in full collections. 1 marks on the mutator thread only. */           \
+  F(unsigned, NumMarkingThreads, 1)                                        \
+                                                                           \
+  /* Number of threads (including the mutator) used to update pointers */  \
+  /* and move objects in full collections. */                              \
+  F(unsigned, NumCompactionThreads, 1)                                     \
+                                                                           \
+  /* Full collections do not move the objects of an old generation */      \
+  /* segment if at least this percent of it is live and no segment */      \
+  /* before it was compacted; its gaps are filled instead. 0 compacts */   \
+  /* every segment. */                                                     \
+  F(unsigned, InPlaceLivePercent, 0)                                       \
+                                                                           \
+  /* Whether to ask the OS to back the heap with transparent huge pages. */\
+  F(bool, HugePages, false)                                                \
+                                                                           \
+  /* Whether to ask the OS to allocate the heap on the NUMA node of the */ \
+  /* thread that first touches it. */                                      \
+  F(bool, NUMALocalHeap, false)                                            \
+                                                                           \
+  /* Whether to recycle heap storage through a pool shared by every */     \
+  /* runtime in the process that sets this, instead of returning it */     \
+  /* to the OS. Ignored with compressed pointers. */                       \
+  F(bool, ProcessStoragePool, false)                                       \
+                                                                           \
+  /* If in (0, 1), the heap is also resized to keep the fraction of */     \
+  /* wall time spent in collections near this target: it grows when */     \
+  /* collections cost more, and shrinks when they cost much less. */       \
+  F(double, TargetGCCostRatio, 0.0)                                        \
+                                                                           \
+  /* Whether finalizers free large native buffers (such as the data */     \
+  /* of ArrayBuffers) on a background thread, outside the pause. */        \
+  F(bool, BackgroundFreeing, false)                                        \
   /* GC_FIELDS END */
 
 _HERMES_CTORCONFIG_STRUCT(GCConfig, GC_FIELDS, {
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_PUBLIC_GCTELEMETRY_H
+#define HERMES_PUBLIC_GCTELEMETRY_H
+
+#include <cstdint>
+
+namespace hermes {
+namespace vm {
+
+/// Pause times of the collections of one kind. Times are in milliseconds, and
+/// are zero if there were no collections.
+struct GCPauseSummary {
+  /// Number of collections.
+  unsigned numCollections{0};
+  /// Percentiles of the pause times.
+  double p50{0};
+  double p90{0};
+  double p99{0};
+  /// Longest pause.
+  double max{0};
+  /// Bytes moved from the young generation to the old generation.  Only
+  /// young generation collections count them.
+  uint64_t promotedBytes{0};
+};
+
+/// Summary of the garbage collections that ended within a recent window of
+/// time, as returned by HermesRuntime::getGCTelemetry.
+struct GCTelemetrySummary {
+  /// Young generation collections (zeroes if the GC is not generational).
+  GCPauseSummary youngGen;
+  /// Full collections.
+  GCPauseSummary full;
+  /// Bytes allocated per second between the first and the last collection in
+  /// the window, or zero if there were fewer than two.
+  double allocationRate{0};
+  /// Size of the heap after the most recent collection, whether or not it is
+  /// in the window.
+  uint64_t heapSize{0};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_PUBLIC_GCTELEMETRY_H
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef HERMES_PUBLIC_MEMORYPRESSURE_H
+#define HERMES_PUBLIC_MEMORYPRESSURE_H
+
+#include <cstdint>
+
+namespace hermes {
+namespace vm {
+
+/// How much memory the process is asked to give up, from the least to the
+/// most. Each level does everything the previous ones do.
+enum class MemoryPressureLevel {
+  /// Drop the caches of compiled code that can be rebuilt from their source,
+  /// and return the unused parts of the heap to the OS. Running code is not
+  /// slowed down much.
+  Low,
+  /// Also drop the caches of hidden classes and storage of literals, and
+  /// collect and compact the whole heap, shrinking it to the size its live
+  /// data needs.
+  Moderate,
+  /// Also free the native code of the functions that are not running, and
+  /// shrink the heap as much as possible. Functions are compiled again once
+  /// they become hot again.
+  Critical,
+};
+
+/// The number of bytes freed by each step of
+/// HermesRuntime::handleMemoryPressure. Steps that were not taken at the
+/// requested level report zero.
+struct MemoryPressureReport {
+  /// Bytecode of regexps compiled at runtime.
+  uint64_t regExpCache{0};
+  /// Sources of the code compiled by eval() and the Function constructor. The
+  /// compiled modules are freed too once nothing runs them, but their size is
+  /// not known.
+  uint64_t evalCache{0};
+  /// Tables of the hidden classes and element storage shared by the literals
+  /// of each module.
+  uint64_t literalCaches{0};
+  /// Property maps kept by hidden classes for their children to share. They
+  /// are rebuilt from the chain of classes when needed again.
+  uint64_t propertyMaps{0};
+  /// Native code of the functions compiled by the JIT.
+  uint64_t jitCode{0};
+  /// JS heap data found to be garbage by a full collection.
+  uint64_t collected{0};
+  /// Unused heap memory returned to the OS. Pages that were never touched are
+  /// counted too, so this is an upper bound of the decrease of the resident
+  /// set.
+  uint64_t heapReleased{0};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_PUBLIC_MEMORYPRESSURE_H
@@ -12,6 +12,7 @@
 #include "hermes/Public/GCConfig.h"
 
 #include <memory>
+#include <string>
 
 namespace hermes {
 namespace vm {
@@ -32,6 +33,35 @@ class PinnedHermesValue;
   /* Whether or not the JIT is enabled */                              \
   F(bool, EnableJIT, false)                                            \
                                                                        \
+  /* Number of invocations plus loop iterations a function must */     \
+  /* reach before it is JIT compiled. Zero compiles every function. */ \
+  F(uint32_t, JITThreshold, 0)                                         \
+                                                                       \
+  /* Describe JIT compiled code to Linux perf in /tmp/perf-<pid>.map */ \
+  F(bool, PerfMap, false)                                              \
+                                                                       \
+  /* Also describe it, with its source lines, in a jitdump file. */    \
+  F(bool, PerfJITDump, false)                                          \
+                                                                       \
+  /* Interpret every JS function through a native trampoline of its */ \
+  /* own, described to perf, so that samples are attributed to it. */  \
+  F(bool, PerfInterpreterTrampolines, false)                           \
+                                                                       \
+  /* Number of invocations after which a function is quickened, */     \
+  /* i.e. its instructions are specialized in place for the operand */ \
+  /* types they observe. Zero disables quickening. */                  \
+  F(uint32_t, QuickeningThreshold, 0)                                  \
+                                                                       \
+  /* Drop the bytecode of the lazily compiled functions which */       \
+  /* were not called between two full collections. They are */         \
+  /* compiled again from their source by their next call. */           \
+  F(bool, EvictColdLazyFunctions, false)                               \
+                                                                       \
+  /* Drop the property maps that hidden classes keep for their */      \
+  /* children to share after each full collection. They are */         \
+  /* rebuilt from the chain of classes when needed again. */           \
+  F(bool, ReleaseSharedPropertyMaps, false)                            \
+                                                                       \
   /* Whether to allow eval and Function ctor */                        \
   F(bool, EnableEval, true)                                            \
                                                                        \
@@ -57,6 +87,11 @@ class PinnedHermesValue;
   /* all bytecode buffers > 64 kB passed to Hermes must be mmap:ed. */ \
   F(bool, TrackIO, false)                                              \
                                                                        \
+  /* Directory caching the bytecode compiled from source passed to */  \
+  /* prepareJavaScript, so that it is only compiled once. Empty */     \
+  /* disables the cache. */                                            \
+  F(std::string, BytecodeCacheDir, "")                                 \
+                                                                       \
   /* An interface for managing crashes. */                             \
   F(std::shared_ptr<CrashManager>, CrashMgr, new NopCrashManager)      \
                                                                        \
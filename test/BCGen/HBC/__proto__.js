@@ -26,13 +26,11 @@ function dynamicProto(func, getProto) {
 }
 //CHECK-LABEL:Function<dynamicProto>(3 params, 12 registers, 0 symbols):
 //CHECK-NEXT:Offset in debug table: {{.*}}
-//CHECK-NEXT:    NewObject         r0
+//CHECK-NEXT:    NewObjectWithBuffer r0, 2, 2, 0, 0
 //CHECK-NEXT:    LoadParam         r1, 1
 //CHECK-NEXT:    LoadConstUndefined r2
 //CHECK-NEXT:    Call1             r1, r1, r2
-//CHECK-NEXT:    PutNewOwnByIdShort r0, r1, "a"
-//CHECK-NEXT:    LoadConstUInt8    r1, 10
-//CHECK-NEXT:    PutNewOwnByIdShort r0, r1, "b"
+//CHECK-NEXT:    PutOwnBySlotIdx   r0, r1, 0
 //CHECK-NEXT:    LoadParam         r1, 2
 //CHECK-NEXT:    Call1             r3, r1, r2
 //CHECK-NEXT:    Mov               r4, r0
@@ -92,3 +92,11 @@ function buffalobuffalo() {
 function check_phi_handling(x) {
   return x ? [1] : arguments;
 }
+
+//CHECK-LABEL:function forward(f)
+//CHECK-NOT:  {{.*}}HBCReifyArgumentsInst
+//CHECK:  {{.*}} = HBCApplyArgumentsInst {{.*}}, %0
+//CHECK:function_end
+function forward(f) {
+  return f.apply(this, arguments);
+}
@@ -0,0 +1,33 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -target=HBC -dump-bytecode -pretty-disassemble=false -O %s | %FileCheck --match-full-lines %s
+
+// A loop counter starting at zero is proven to be an array index.
+function sum(a) {
+  var s = 0;
+  for (var i = 0; i < a.length; i++)
+    s += a[i];
+  return s;
+}
+//CHECK-LABEL:Function<sum>{{.*}}:
+//CHECK:[@ {{.*}}] GetByValIndex {{[0-9]+}}<Reg8>, {{[0-9]+}}<Reg8>, {{[0-9]+}}<Reg8>
+
+function fill(a, v) {
+  for (var i = 0; i < a.length; i++)
+    a[i] = v;
+}
+//CHECK-LABEL:Function<fill>{{.*}}:
+//CHECK:[@ {{.*}}] PutByValIndex {{[0-9]+}}<Reg8>, {{[0-9]+}}<Reg8>, {{[0-9]+}}<Reg8>
+
+// A counter which can become negative is not.
+function backwards(a) {
+  var s = 0;
+  for (var i = a.length; i >= -1; i--)
+    s += a[i];
+  return s;
+}
+//CHECK-LABEL:Function<backwards>{{.*}}:
+//CHECK:[@ {{.*}}] GetByVal {{[0-9]+}}<Reg8>, {{[0-9]+}}<Reg8>, {{[0-9]+}}<Reg8>
@@ -0,0 +1,51 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O -emit-binary -out=%t.hbc -compress-cold-functions %s && %hermes -b %t.hbc | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -emit-binary -out=%t.hbc -compress-cold-functions -layout-trace=%S/Inputs/layout-trace-functions.json %s && %hermes -b %t.hbc | %FileCheck --match-full-lines %s
+
+// Cold function bodies are compressed and decompressed when they are first
+// run, which must not change the behavior of the program.
+function add(a, b) {
+  return a + b;
+}
+
+function greet(name) {
+  return 'hello ' + name;
+}
+
+function fib(n) {
+  return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+
+function lookup(key) {
+  switch (key) {
+    case 'a': return 1;
+    case 'b': return 2;
+    case 'c': return 3;
+    case 'd': return 4;
+    case 'e': return 5;
+    default: return 0;
+  }
+}
+
+function safe(f) {
+  try {
+    return f();
+  } catch (e) {
+    return 'caught ' + e.message;
+  }
+}
+
+print(add(1, 2));
+// CHECK: 3
+print(greet('world'));
+// CHECK-NEXT: hello world
+print(fib(10));
+// CHECK-NEXT: 55
+print(lookup('c'), lookup('z'));
+// CHECK-NEXT: 3 0
+print(safe(function() { throw new Error('oops'); }));
+// CHECK-NEXT: caught oops
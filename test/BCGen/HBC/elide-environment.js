@@ -0,0 +1,32 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O -dump-bytecode %s | %FileCheck --match-full-lines %s
+
+// middle() has no variables of its own, so it doesn't create an environment,
+// and inner() finds x in the environment of its closure.
+function outer() {
+  var x = 1;
+  function middle() {
+    return function inner() {
+      return x++;
+    };
+  }
+  return middle;
+}
+
+// CHECK-LABEL: Function<outer>{{.*}}:
+// CHECK-NEXT: Offset in debug table: {{.*}}
+// CHECK-NEXT:     CreateEnvironment r0
+
+// CHECK-LABEL: Function<middle>{{.*}}:
+// CHECK-NEXT: Offset in debug table: {{.*}}
+// CHECK-NEXT:     GetEnvironment    r0, 0
+// CHECK-NEXT:     CreateClosure     r0, r0, 3
+// CHECK-NEXT:     Ret               r0
+
+// CHECK-LABEL: Function<inner>{{.*}}:
+// CHECK-NEXT: Offset in debug table: {{.*}}
+// CHECK-NEXT:     GetEnvironment    {{r[0-9]+}}, 0
@@ -0,0 +1,31 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -dump-bytecode -g %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -dump-bytecode -g %s | %FileCheck --match-full-lines %s
+
+// The body of outer() is erased after its bytecode is emitted, before
+// inner() is generated. inner() must still find its lexical parent and the
+// environment holding x.
+function outer() {
+  let x = 1;
+  function inner() {
+    return x++;
+  }
+  return inner;
+}
+
+// CHECK-LABEL: Function<outer>{{.*}}:
+// CHECK:     CreateEnvironment {{r[0-9]+}}
+
+// CHECK-LABEL: Function<inner>{{.*}}:
+// CHECK:     GetEnvironment    [[ENV:r[0-9]+]], 0
+// CHECK:     LoadFromEnvironment {{r[0-9]+}}, [[ENV]], {{[0-9]+}}
+
+// CHECK-LABEL: Debug variables table:
+// CHECK-NEXT:   Offset: {{.*}}, lexical parent: none
+// CHECK:   Offset: {{.*}}, lexical parent: 0
+// CHECK:     {{.*}}: "x"
+// CHECK:   Offset: {{.*}}, lexical parent: 1
@@ -47,7 +47,7 @@ function *loop(x) {
 // CHECK-NEXT:     AddN              r11, r10, r4
 // CHECK-NEXT:     StoreToEnvironment r0, 0, r11
 // CHECK-NEXT:     GetByVal          r12, r7, r10
-// CHECK-NEXT:     SaveGenerator     L3
+// CHECK-NEXT:     SaveGenerator     L3, 7
 // CHECK-NEXT:     Ret               r12
 // CHECK-NEXT: L3:
 // CHECK-NEXT:     ResumeGenerator   r7, r13
@@ -0,0 +1,22 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O -emit-binary -target=HBC -out=%t %s && %hbcdump %t -c "registers 1;quit" | %FileCheck --match-full-lines %s
+
+function foo(a, b) {
+  for (var i = 0; i < a; ++i) {
+    var t = a;
+    a = b;
+    b = t;
+  }
+  return a - b;
+}
+
+//CHECK: FunctionID: 1
+//CHECK-NEXT: Name: foo
+//CHECK-NEXT: FrameSize: {{[0-9]+}}
+//CHECK-NEXT: Instructions: {{[0-9]+}}
+//CHECK-NEXT: Movs: {{[0-9]+}}
+//CHECK-NEXT: LongMovs: 0
@@ -0,0 +1,29 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -target=HBC -dump-bytecode --pretty-disassemble -O %s | %FileCheck %s
+// RUN: %hermes -target=HBC -dump-bytecode --pretty-disassemble -O -g %s | %FileCheck %s --check-prefix=CHKDBG
+
+// A jump to a block which only returns is replaced by the return.
+function choose(x, y) {
+  var r;
+  if (x) {
+    r = y + 1;
+  } else {
+    r = y - 1;
+  }
+  return r;
+}
+
+//CHECK-LABEL:Function<choose>{{.*}}
+//CHECK-NOT:    Jmp {{.*}}
+//CHECK:    Ret {{.*}}
+//CHECK-NOT:    Jmp {{.*}}
+//CHECK:    Ret {{.*}}
+//CHECK-NOT:    Jmp {{.*}}
+
+// The jump is kept when debugging.
+//CHKDBG-LABEL:Function<choose>{{.*}}
+//CHKDBG:    Jmp {{.*}}
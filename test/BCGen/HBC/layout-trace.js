@@ -0,0 +1,49 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O -emit-binary -out=%t.hbc -layout-trace=%S/Inputs/layout-trace-functions.json %s && %hermes -b %t.hbc | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -emit-binary -out=%t.base.hbc %s && %hermes -O -emit-binary -out=%t.hbc -layout-trace=%S/Inputs/layout-trace-pages.json -layout-trace-bytecode=%t.base.hbc %s && %hermes -b %t.hbc | %FileCheck --match-full-lines %s
+// RUN: %hermes -dump-bytecode -layout-trace=%S/Inputs/layout-trace-functions.json %s | %FileCheck --match-full-lines %s --check-prefix=DUMP
+// RUN: not %hermes -O -emit-binary -out=%t.hbc -layout-trace=%S/Inputs/layout-trace-pages.json %s 2>&1 | %FileCheck --match-full-lines %s --check-prefix=NOBYTECODE
+
+// Functions are renumbered and laid out according to a startup trace, which
+// must not change the behavior of the program.
+
+function add(a, b) {
+  return a + b;
+}
+
+function fib(n) {
+  return n < 2 ? n : add(fib(n - 1), fib(n - 2));
+}
+
+function greet(name) {
+  try {
+    throw new Error('hello ' + name);
+  } catch (e) {
+    return e.message;
+  }
+}
+
+function same1() {
+  return 1;
+}
+
+function same2() {
+  return 1;
+}
+
+print(fib(10), greet('world'), same1() + same2());
+// CHECK: 55 hello world 2
+
+// NOBYTECODE: A page trace requires -layout-trace-bytecode.
+
+// The traced functions come first, then the others in their usual order.
+// DUMP-LABEL: Function<greet>{{.*}}:
+// DUMP-LABEL: Function<add>{{.*}}:
+// DUMP-LABEL: Function<global>{{.*}}:
+// DUMP-LABEL: Function<fib>{{.*}}:
+// DUMP-LABEL: Function<same1>{{.*}}:
+// DUMP-LABEL: Function<same2>{{.*}}:
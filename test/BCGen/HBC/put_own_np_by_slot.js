@@ -0,0 +1,19 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermesc -O -dump-bytecode %s | %FileCheck --match-full-lines %s
+
+// Values that are known not to be pointers are stored without a write
+// barrier.
+function literal(x, f) {
+  return {num: -x, bool: !x, str: 'a' + x, obj: f(), undef: void f()};
+}
+//CHECK-LABEL:Function<literal>(3 params, {{.*}} registers, {{.*}} symbols):
+//CHECK:        PutOwnNPBySlotIdx {{.*}}, 0
+//CHECK:        PutOwnNPBySlotIdx {{.*}}, 1
+//CHECK:        PutOwnBySlotIdx {{.*}}, 2
+//CHECK:        PutOwnBySlotIdx {{.*}}, 3
+//CHECK:        PutOwnNPBySlotIdx {{.*}}, 4
+//CHECK:        Ret
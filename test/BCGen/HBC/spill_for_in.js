@@ -64,13 +64,17 @@ function foo() {
 //CHECK-NEXT: {{.*}} MovLong {{.*}}
 //CHECK-NEXT: {{.*}} MovLong {{.*}}
   var count=0;
+  var sum=0;
   for(var arg in count) {
     count++;
-  }
 
-  // Make sure registers are still in use
-  return x001 + x002 + x003 + x004 + x005 + x006 + x007 + x008 + x009 + x010 +
-    x011 + x012 + x013 + x014 + x015 + x016 + x017 + x018 + x019 + x020 + x021
+    // Make sure registers are still in use, and used in a deeper loop than
+    // the registers of the for-in loop, so that those don't get the low
+    // registers.
+    for (var i = 0; i < 1; i++) {
+      sum = x001 + x002 + x003 + x004 + x005 + x006 + x007 + x008 + x009 +
+    x010 + x011 + x012 + x013 + x014 + x015 + x016 + x017 + x018 + x019 + x020
+    + x021
     + x022 + x023 + x024 + x025 + x026 + x027 + x028 + x029 + x030 + x031 +
     x032 + x033 + x034 + x035 + x036 + x037 + x038 + x039 + x040 + x041 + x042
     + x043 + x044 + x045 + x046 + x047 + x048 + x049 + x050 + x051 + x052 +
@@ -94,4 +98,7 @@ function foo() {
     + x232 + x233 + x234 + x235 + x236 + x237 + x238 + x239 + x240 + x241 +
     x242 + x243 + x244 + x245 + x246 + x247 + x248 + x249 + x250 + x251 + x252
     + x253 + x254 + x255 + x256;
+    }
+  }
+  return sum;
 }
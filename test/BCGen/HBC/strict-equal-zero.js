@@ -0,0 +1,26 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -target=HBC -dump-bytecode -pretty-disassemble=false -O %s | %FileCheck --match-full-lines %s
+
+// A comparison against zero is emitted as a single superinstruction and the
+// load of the constant is dropped.
+function isZero(a) {
+  if (a === 0)
+    return a;
+  return 1;
+}
+//CHECK-LABEL:Function<isZero>{{.*}}:
+//CHECK-NOT:{{.*}}LoadConstZero{{.*}}
+//CHECK:[@ {{.*}}] JStrict{{(Not)?}}EqualZero {{[0-9]+}}<Addr8>, {{[0-9]+}}<Reg8>
+//CHECK-LABEL:Function<isNotZero>{{.*}}:
+
+function isNotZero(a) {
+  if (0 !== a)
+    return a;
+  return 1;
+}
+//CHECK-NOT:{{.*}}LoadConstZero{{.*}}
+//CHECK:[@ {{.*}}] JStrict{{(Not)?}}EqualZero {{[0-9]+}}<Addr8>, {{[0-9]+}}<Reg8>
@@ -0,0 +1,58 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermesc -O -dump-bytecode %s | %FileCheck --match-full-lines --check-prefix=CHKBC %s
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// A chain of string additions becomes a single builtin call.
+function chain(a, b) {
+  return "<" + a + ", " + b + ">";
+}
+//CHKBC-LABEL:Function<chain>({{.*}}):
+//CHKBC-NOT:    Add {{.*}}
+//CHKBC:    CallBuiltin       r{{[0-9]+}}, "HermesInternal.concatStrings", 6
+//CHKBC-NOT:    Add {{.*}}
+//CHKBC:    Ret               r{{[0-9]+}}
+
+// A single addition is left alone.
+function single(a) {
+  return "x" + a;
+}
+//CHKBC-LABEL:Function<single>({{.*}}):
+//CHKBC-NOT:    CallBuiltin {{.*}}
+//CHKBC:    Add               r{{[0-9]+}}, r{{[0-9]+}}, r{{[0-9]+}}
+//CHKBC:    Ret               r{{[0-9]+}}
+
+print(chain(1, "two"));
+//CHECK: <1, two>
+print(chain(undefined, null));
+//CHECK-NEXT: <undefined, null>
+
+// Objects are still converted with the default hint, in order.
+var log = [];
+function obj(name) {
+  return {
+    valueOf: function() { log.push(name + ".valueOf"); return name; },
+    toString: function() { log.push(name + ".toString"); return "bad"; },
+  };
+}
+print(chain(obj("a"), obj("b")));
+//CHECK-NEXT: <a, b>
+print(log.join());
+//CHECK-NEXT: a.valueOf,b.valueOf
+
+// The conversions are interleaved with the other operands.
+log = [];
+function side(s) {
+  log.push("side " + s);
+  return s;
+}
+print("" + obj("c") + side("d") + obj("e"));
+//CHECK-NEXT: cde
+print(log.join());
+//CHECK-NEXT: c.valueOf,side d,e.valueOf
+
+print(`${1}-${obj("f")}-${[2, 3]}`);
+//CHECK-NEXT: 1-bad-2,3
@@ -0,0 +1,32 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: echo '{"functions": [{"function_id": 1, "number_sites": [6]}, {"function_id": 2, "number_sites": [7]}, {"function_id": 99, "number_sites": [0]}]}' > %t.json
+// RUN: %hermesc -O -dump-bytecode -type-feedback=%t.json %s | %FileCheck --match-full-lines %s
+
+// The Add of add() is at offset 6, after two 3-byte LoadParam, and gets
+// quickened. Offset 7 is in the middle of the Sub of sub(), and function 99
+// doesn't exist, so both are ignored.
+function add(a, b) {
+  return a + b;
+}
+
+function sub(a, b) {
+  return a - b;
+}
+
+// CHECK-LABEL: Function<add>(3 params, {{[0-9]+}} registers, 0 symbols):
+// CHECK-NEXT: Offset in debug table: {{.*}}
+// CHECK-NEXT:     LoadParam         {{r[0-9]+}}, 1
+// CHECK-NEXT:     LoadParam         {{r[0-9]+}}, 2
+// CHECK-NEXT:     AddQuick          {{r[0-9]+}}, {{r[0-9]+}}, {{r[0-9]+}}
+// CHECK-NEXT:     Ret               {{r[0-9]+}}
+
+// CHECK-LABEL: Function<sub>(3 params, {{[0-9]+}} registers, 0 symbols):
+// CHECK-NEXT: Offset in debug table: {{.*}}
+// CHECK-NEXT:     LoadParam         {{r[0-9]+}}, 1
+// CHECK-NEXT:     LoadParam         {{r[0-9]+}}, 2
+// CHECK-NEXT:     Sub               {{r[0-9]+}}, {{r[0-9]+}}, {{r[0-9]+}}
+// CHECK-NEXT:     Ret               {{r[0-9]+}}
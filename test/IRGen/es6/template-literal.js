@@ -14,8 +14,8 @@ function f1() {
 //CHKIR-NEXT:frame = []
 //CHKIR-NEXT:%BB0:
 //CHKIR-NEXT:  %0 = TryLoadGlobalPropertyInst globalObject : object, "HermesInternal" : string
-//CHKIR-NEXT:  %1 = LoadPropertyInst %0, "concat" : string
-//CHKIR-NEXT:  %2 = CallInst %1, "hello" : string, 2 : number, "world" : string
+//CHKIR-NEXT:  %1 = LoadPropertyInst %0, "concatStrings" : string
+//CHKIR-NEXT:  %2 = CallInst %1, undefined : undefined, "hello" : string, 2 : number, "world" : string
 //CHKIR-NEXT:  %3 = ReturnInst %2
 //CHKIR-NEXT:function_end
 
@@ -44,7 +44,7 @@ function f4() {
 //CHKIR-NEXT:frame = []
 //CHKIR-NEXT:%BB0:
 //CHKIR-NEXT:  %0 = TryLoadGlobalPropertyInst globalObject : object, "HermesInternal" : string
-//CHKIR-NEXT:  %1 = LoadPropertyInst %0, "concat" : string
-//CHKIR-NEXT:  %2 = CallInst %1, "" : string, 666 : number
+//CHKIR-NEXT:  %1 = LoadPropertyInst %0, "concatStrings" : string
+//CHKIR-NEXT:  %2 = CallInst %1, undefined : undefined, 666 : number
 //CHKIR-NEXT:  %3 = ReturnInst %2
 //CHKIR-NEXT:function_end
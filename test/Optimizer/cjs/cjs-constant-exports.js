@@ -0,0 +1,29 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermesc -commonjs -fstatic-require -O -dump-ir %s %S/flags.js | %FileCheck --match-full-lines %s
+
+// The constant exports of flags.js are propagated and the branches they
+// disable are removed.
+
+var flags = require('./flags.js');
+if (flags.ENABLED) {
+  print('enabled');
+} else {
+  print('disabled');
+}
+if (flags.LEVEL > 2) {
+  print('verbose');
+}
+print(flags.NAME, flags.counter);
+
+//CHECK-LABEL:function cjs_module(exports, require, module)
+//CHECK-NOT:{{.*}}"disabled"{{.*}}
+//CHECK-NOT:{{.*}}"verbose"{{.*}}
+//CHECK:{{.*}}"enabled"{{.*}}
+//CHECK-NOT:{{.*}}"disabled"{{.*}}
+//CHECK-NOT:{{.*}}"verbose"{{.*}}
+//CHECK:{{.*}}"counter"{{.*}}
+//CHECK-LABEL:function cjs_module{{.*}}(exports, require, module)
@@ -0,0 +1,12 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: true
+
+exports.ENABLED = true;
+exports.LEVEL = 1;
+exports.NAME = 'flags';
+exports.counter = 0;
+exports.counter = 1;
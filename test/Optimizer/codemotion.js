@@ -258,3 +258,30 @@ function code_sinking_in_loop(x, y) {
     obj[x] = y;
   }
 }
+
+//CHECK-LABEL:function hoist_frame_load(n){{.*}}
+//CHECK:%BB0:
+//CHECK:  {{.*}} = HBCLoadFromEnvironmentInst %{{[0-9]+}}, [k]{{.*}}
+//CHECK:%BB1:
+//CHECK-NOT:{{.*}}HBCLoadFromEnvironmentInst{{.*}}
+//CHECK:function_end
+function hoist_frame_load(n) {
+  var k = n;
+  k = k * 2;
+  for (var i = 0; i < n; i++) {
+    print(k);
+  }
+  return function() { return k; };
+}
+
+//CHECK-LABEL:function no_hoist_stored_frame_load(n, f){{.*}}
+//CHECK:%BB1:
+//CHECK:  {{.*}} = HBCLoadFromEnvironmentInst %{{[0-9]+}}, [k]{{.*}}
+//CHECK:function_end
+function no_hoist_stored_frame_load(n, f) {
+  var k = n;
+  var inc = function() { k++; };
+  for (var i = 0; i < n; i++) {
+    f(k, inc);
+  }
+}
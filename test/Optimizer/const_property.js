@@ -3,7 +3,7 @@
 // This source code is licensed under the MIT license found in the LICENSE
 // file in the root directory of this source tree.
 //
-// RUN: %hermes -enable-cla -enable-cpo -dump-ir %s -O -fno-inline | %FileCheck %s --match-full-lines
+// RUN: %hermes -enable-cla -enable-cpo -dump-ir %s -O -fno-scalar-replacement -fno-inline | %FileCheck %s --match-full-lines
 
 "use strict";
 
@@ -0,0 +1,33 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -target=HBC -O -dump-ir -inlining-profile=%S/Inputs/inline-profile.json %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -target=HBC -O -dump-ir %s | %FileCheck --match-full-lines --check-prefix=NOPROF %s
+
+// A hot function is inlined into all of its call sites.
+function callsHot(a, b) {
+    var hot = function(x) {
+        return x + 1;
+    }
+    return hot(a) * hot(b);
+}
+//CHECK-LABEL:function callsHot(a, b){{.*}}
+//CHECK-NOT:{{.*}}CallInst{{.*}}
+//CHECK:function_end
+
+//NOPROF-LABEL:function callsHot(a, b){{.*}}
+//NOPROF:{{.*}}CallInst{{.*}}
+//NOPROF:function_end
+
+// A cold function called from several sites is not duplicated.
+function callsCold(a, b) {
+    var cold = function(x) {
+        return x + 1;
+    }
+    return cold(a) * cold(b);
+}
+//CHECK-LABEL:function callsCold(a, b){{.*}}
+//CHECK:{{.*}}CallInst{{.*}}
+//CHECK:function_end
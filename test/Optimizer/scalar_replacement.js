@@ -0,0 +1,37 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -hermes-parser -dump-ir %s -O | %FileCheck %s --match-full-lines
+
+// The object does not escape, so its properties are replaced by their values.
+//CHECK-LABEL:function local_bag(a, b)
+//CHECK-NOT:{{.*}}AllocObjectInst{{.*}}
+//CHECK-NOT:{{.*}}PropertyInst{{.*}}
+//CHECK:function_end
+function local_bag(a, b) {
+  var o = {x: a, y: b};
+  o.x = o.y;
+  return o.x + o.y;
+}
+
+// The object is passed to a call, so it is kept.
+//CHECK-LABEL:function escaping_bag(a, b)
+//CHECK:{{.*}}AllocObjectInst{{.*}}
+//CHECK:function_end
+function escaping_bag(a, b) {
+  var o = {x: a, y: b};
+  print(o);
+  return o.x;
+}
+
+// A property which is not defined by the literal could come from the
+// prototype, so the object is kept.
+//CHECK-LABEL:function undefined_property(a)
+//CHECK:{{.*}}AllocObjectInst{{.*}}
+//CHECK:function_end
+function undefined_property(a) {
+  var o = {x: a};
+  return o.toString;
+}
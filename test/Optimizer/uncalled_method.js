@@ -3,7 +3,7 @@
 // This source code is licensed under the MIT license found in the LICENSE
 // file in the root directory of this source tree.
 //
-// RUN: %hermes -enable-cla -enable-umo -dump-ir %s -O -strict | %FileCheck %s --match-full-lines
+// RUN: %hermes -enable-cla -enable-umo -dump-ir %s -O -fno-scalar-replacement -strict | %FileCheck %s --match-full-lines
 
 //CHECK-LABEL:function unused() : undefined
 //CHECK-NEXT:frame = []
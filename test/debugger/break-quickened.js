@@ -0,0 +1,47 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hdb --quickening-threshold 1 --type-feedback-file %t.json %s < %s.debug | %FileCheck --match-full-lines %s
+// RUN: cat %t.json | %FileCheck --match-full-lines --check-prefix=FEEDBACK %s
+// REQUIRES: debugger
+
+print('break-quickened');
+// CHECK-LABEL: break-quickened
+
+// The literal is loaded on entry, so the column of the binary expression
+// resolves to the arithmetic instruction itself.
+function add(b) {
+  return 10 + b;
+}
+
+function sub(b) {
+  return 10 - b;
+}
+
+function bar() {
+  debugger;
+  print(add(1));
+}
+
+// Quicken the Add and the Sub.
+for (var i = 0; i < 5; ++i) {
+  add(i);
+  sub(i);
+}
+bar();
+// CHECK-NEXT: Break on 'debugger' statement in bar: {{.*}}:24:3
+// CHECK-NEXT: Set breakpoint 1 at {{.+}}:16:10
+// CHECK-NEXT: Set breakpoint 2 at {{.+}}:20:10
+// CHECK-NEXT: Deleted breakpoint 2
+// CHECK-NEXT: Continuing execution
+// The breakpoint is patched in the quickened copy that add() executes.
+// CHECK-NEXT: Break on breakpoint 1 in add: {{.*}}:16:10
+// CHECK-NEXT: Deleted breakpoint 1
+// CHECK-NEXT: Continuing execution
+// CHECK-NEXT: 11
+
+// sub() doesn't run after its breakpoint is cleared, so its Sub is only still
+// quickened at exit if clearing the breakpoint restored the quickened opcode.
+// FEEDBACK: {"functions":[{{.*}}{"function_id":1,"number_sites":[{{[0-9]+}}]},{"function_id":2,"number_sites":[{{[0-9]+}}]}{{.*}}]}
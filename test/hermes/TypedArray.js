@@ -823,6 +823,29 @@ cons.forEach(function(TypedArray) {
   assert.equal(arr.indexOf(50), 0);
   assert.equal(arr.lastIndexOf(50), 1);
 });
+
+// Only values that the element type represents exactly are found, NaN is only
+// found by includes, and both zeros match each other.
+cons.forEach(function(TypedArray) {
+  var arr = new TypedArray([0, 1, 255, 3]);
+  assert.equal(arr.indexOf(1.5), -1);
+  assert.equal(arr.indexOf(arr[2] + 256), -1);
+  assert.equal(arr.lastIndexOf(-0), 0);
+  assert.ok(arr.includes(-0));
+  assert.ok(!arr.includes(NaN));
+  assert.ok(!arr.includes('1'));
+});
+[Float32Array, Float64Array].forEach(function(TypedArray) {
+  var arr = new TypedArray([1, NaN, -0, 0.1]);
+  assert.equal(arr.indexOf(NaN), -1);
+  assert.equal(arr.lastIndexOf(NaN), -1);
+  assert.ok(arr.includes(NaN));
+  assert.ok(!arr.includes(NaN, 2));
+  assert.equal(arr.indexOf(0), 2);
+  assert.equal(arr.indexOf(1e300), -1);
+});
+assert.equal(new Float32Array([0.1]).indexOf(0.1), -1);
+assert.equal(new Float64Array([0.1]).indexOf(0.1), 0);
 /// @}
 
 /// @name TypedArray.prototype.join && .toString (since toString calls join)
@@ -934,6 +957,40 @@ cons.forEach(function(ta) {
     });
   }, TypeError);
 });
+
+// Without a comparefn, elements are sorted by a radix sort. Check enough
+// elements to use it, with duplicates and the extremes of each type.
+cons.forEach(function(ta) {
+  var x = new ta(1000);
+  for (var i = 0; i < x.length; i++) {
+    x[i] = (i * 7919) % 301 - 100;
+  }
+  x[0] = -Infinity;
+  x[1] = Infinity;
+  x.sort();
+  for (var i = 1; i < x.length; i++) {
+    assert.ok(x[i - 1] <= x[i]);
+  }
+});
+
+// NaN goes last and -0 before +0.
+[Float32Array, Float64Array].forEach(function(ta) {
+  var x = new ta([NaN, 0, 1, -0, -1, NaN, -Infinity, 0, -0]);
+  x.sort();
+  assert.arrayEqual(Array.prototype.slice.call(x), [
+    -Infinity,
+    -1,
+    -0,
+    -0,
+    0,
+    0,
+    1,
+    NaN,
+    NaN,
+  ]);
+  assert.equal(1 / x[3], -Infinity);
+  assert.equal(1 / x[4], Infinity);
+});
 /// @}
 
 /// @name TypedArray.prototype.set
@@ -1009,8 +1066,15 @@ cons.forEach(function(ta) {
       dst.set(new ta([1, 2, 3]));
     }, RangeError);
   });
+  // Setting from a typed array of another type converts each element.
+  var dst = new Int8Array(3);
+  dst.set(new Float64Array([1.7, -129, NaN]));
+  assert.arrayEqual(dst, [1, 127, 0]);
+  dst = new Uint8ClampedArray(3);
+  dst.set(new Float32Array([1.5, -3, 300]));
+  assert.arrayEqual(dst, [2, 0, 255]);
   // Moving from one typed array view to another of the same data.
-  var dst = new Int8Array([0, 1, 2, 3, 4, 5, 6, 7]);
+  dst = new Int8Array([0, 1, 2, 3, 4, 5, 6, 7]);
   var src = new Int32Array(dst.buffer);
   dst.set(src);
   assert.equal(dst[0], 0);
@@ -0,0 +1,119 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Exercise the property cache for accessors and make sure that changes to the
+// accessors or to the prototype chain are observed.
+
+function getX(obj) {
+  return obj.x;
+}
+function setX(obj, v) {
+  obj.x = v;
+}
+
+function Point(x) {
+  this._x = x;
+}
+Object.defineProperty(Point.prototype, "x", {
+  get: function() {
+    return "get " + this._x;
+  },
+  set: function(v) {
+    this._x = v * 2;
+  },
+  configurable: true,
+});
+
+var p = new Point(1);
+var q = new Point(2);
+print(getX(p), getX(q), getX(p));
+// CHECK: get 1 get 2 get 1
+setX(p, 3);
+setX(p, 4);
+setX(q, 5);
+print(getX(p), getX(q));
+// CHECK-NEXT: get 8 get 10
+
+// Replace the getter and setter without changing the attributes.
+Object.defineProperty(Point.prototype, "x", {
+  get: function() {
+    return "new get " + this._x;
+  },
+  set: function(v) {
+    this._x = -v;
+  },
+});
+setX(p, 6);
+print(getX(p));
+// CHECK-NEXT: new get -6
+
+// Remove the setter.
+Object.defineProperty(Point.prototype, "x", {set: undefined});
+setX(p, 7);
+print(getX(p));
+// CHECK-NEXT: new get -6
+(function() {
+  "use strict";
+  try {
+    p.x = 8;
+  } catch (e) {
+    print(e.name);
+  }
+})();
+// CHECK-NEXT: TypeError
+
+// Shadow the accessor with an own data property.
+Object.defineProperty(q, "x", {value: "own", writable: true});
+print(getX(q), getX(p));
+// CHECK-NEXT: own new get -6
+setX(q, "own2");
+print(getX(q));
+// CHECK-NEXT: own2
+
+// Own accessors.
+var o = {
+  _v: 0,
+  get v() {
+    return this._v;
+  },
+  set v(x) {
+    this._v = x + 1;
+  },
+};
+function incV(obj) {
+  obj.v = obj.v;
+}
+for (var i = 0; i < 3; ++i)
+  incV(o);
+print(o.v);
+// CHECK-NEXT: 3
+
+// Exceptions thrown by cached accessors.
+var thrower = {
+  get t() {
+    throw new Error("get");
+  },
+  set t(v) {
+    throw new Error("set");
+  },
+};
+function getT(obj) {
+  try {
+    return obj.t;
+  } catch (e) {
+    return e.message;
+  }
+}
+function setT(obj) {
+  try {
+    obj.t = 1;
+  } catch (e) {
+    return e.message;
+  }
+}
+print(getT(thrower), getT(thrower), setT(thrower), setT(thrower));
+// CHECK-NEXT: get get set set
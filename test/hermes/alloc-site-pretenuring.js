@@ -0,0 +1,27 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O -gc-alloc-site-pretenuring -gc-max-heap=16M %s | %FileCheck --match-full-lines %s
+
+// Literals that are kept alive become pretenured, while literals that die
+// right away keep being allocated in the young generation. Both must keep
+// their contents across collections.
+print('pretenuring');
+// CHECK-LABEL: pretenuring
+
+var kept = [];
+var sum = 0;
+for (var i = 0; i < 20000; ++i) {
+  kept.push({a: 1, b: 2, c: 3});
+  var tmp = [1, 2, 3, 4];
+  sum += tmp[3];
+  if (kept.length > 5000) kept = [];
+}
+print(sum);
+// CHECK-NEXT: 80000
+var total = 0;
+for (var j = 0; j < kept.length; ++j) total += kept[j].a + kept[j].b + kept[j].c;
+print(total);
+// CHECK-NEXT: 29982
@@ -0,0 +1,68 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O0 %s | %FileCheck --match-full-lines %s
+
+// f.apply(thisArg, arguments) forwards the arguments without reifying them,
+// unless apply is not Function.prototype.apply.
+
+function show() {
+  return this.name + ':' + Array.prototype.join.call(arguments, ',');
+}
+
+function forward(f) {
+  return f.apply({name: 'forward'}, arguments);
+}
+print(forward(show, 1, 2));
+//CHECK: forward:{{.*}},1,2
+print(forward(show));
+//CHECK-NEXT: forward:{{.*}}
+
+function forwardEmpty() {
+  return show.apply({name: 'empty'}, arguments);
+}
+print(forwardEmpty());
+//CHECK-NEXT: empty:
+
+// The arguments object is reified before the call when it is modified.
+function modified(a) {
+  arguments[0] = 'changed';
+  return show.apply({name: 'modified'}, arguments);
+}
+print(modified('a', 'b'));
+//CHECK-NEXT: modified:changed,b
+
+// A user defined apply is called with a real arguments object.
+var fake = {
+  apply: function(thisArg, args) {
+    return 'fake:' + thisArg + ':' + Object.prototype.toString.call(args) +
+        ':' + args.length;
+  },
+};
+function forwardFake() {
+  return fake.apply('t', arguments);
+}
+print(forwardFake(1, 2, 3));
+//CHECK-NEXT: fake:t:[object Arguments]:3
+
+// Applying a non-callable throws.
+function forwardNonCallable(x) {
+  return x.apply(null, arguments);
+}
+try {
+  forwardNonCallable({apply: Function.prototype.apply});
+} catch (e) {
+  print(e.constructor.name);
+}
+//CHECK-NEXT: TypeError
+
+// apply itself can be undefined.
+try {
+  forwardNonCallable({});
+} catch (e) {
+  print(e.constructor.name);
+}
+//CHECK-NEXT: TypeError
@@ -0,0 +1,30 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O -gc-background-freeing -gc-max-heap=16M %s | %FileCheck --match-full-lines %s
+
+// ArrayBuffers that die keep having their data freed while new ones are
+// created and used, and the live ones keep their contents.
+print('background freeing');
+// CHECK-LABEL: background freeing
+
+var kept = [];
+var sum = 0;
+for (var i = 0; i < 2000; ++i) {
+  var buf = new ArrayBuffer(64 * 1024);
+  var view = new Uint8Array(buf);
+  view[0] = i & 0xff;
+  view[view.length - 1] = 1;
+  sum += view[view.length - 1];
+  if (i % 100 === 0) kept.push(view);
+}
+print(sum);
+// CHECK-NEXT: 2000
+var ok = true;
+for (var j = 0; j < kept.length; ++j) {
+  if (kept[j][0] !== ((j * 100) & 0xff)) ok = false;
+}
+print(kept.length, ok);
+// CHECK-NEXT: 20 true
@@ -0,0 +1,31 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O -gc-max-heap=64M %s | %FileCheck --match-full-lines %s
+
+// Large ArrayBuffers are mapped from the OS. They must read as zeros, keep
+// their contents, and be freed when they die.
+print('large array buffers');
+// CHECK-LABEL: large array buffers
+
+var size = 8 * 1024 * 1024 + 3;
+var view = new Uint8Array(new ArrayBuffer(size));
+print(view.length, view[0], view[size >> 1], view[size - 1]);
+// CHECK-NEXT: 8388611 0 0 0
+view[0] = 1;
+view[size - 1] = 2;
+var copy = new Uint8Array(view.buffer.slice(size - 2));
+print(view[0], view[size - 1], copy.length, copy[0], copy[1]);
+// CHECK-NEXT: 1 2 2 0 2
+
+// Dead buffers are unmapped, so their memory can be reused.
+var sum = 0;
+for (var i = 0; i < 64; ++i) {
+  var v = new Float64Array(2 * 1024 * 1024 / 8);
+  v[i] = i;
+  sum += v[i] + v[v.length - 1];
+}
+print(sum);
+// CHECK-NEXT: 2016
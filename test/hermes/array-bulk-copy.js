@@ -0,0 +1,98 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// concat(), slice(), splice() and copyWithin() copy the elements of packed
+// arrays in bulk, including across the segments of large arrays.
+
+print('bulk-copy');
+//CHECK-LABEL: bulk-copy
+
+function range(n) {
+  var a = [];
+  for (var i = 0; i < n; ++i)
+    a.push(i % 3 ? i : 'v' + i);
+  return a;
+}
+
+// Reference implementations that copy one element at a time.
+function refSlice(a, from, to) {
+  var r = [];
+  for (var i = from; i < to; ++i)
+    r.push(a[i]);
+  return r;
+}
+function refCopyWithin(a, to, from, end) {
+  var tmp = refSlice(a, from, end);
+  for (var i = 0; i < tmp.length && to + i < a.length; ++i)
+    a[to + i] = tmp[i];
+  return a;
+}
+function same(a, b) {
+  if (a.length !== b.length)
+    return false;
+  for (var i = 0; i < a.length; ++i) {
+    if (a[i] !== b[i] || !(i in a))
+      return false;
+  }
+  return true;
+}
+
+var N = 10000;
+var big = range(N);
+
+print(same(big.slice(100, 9000), refSlice(big, 100, 9000)));
+//CHECK-NEXT: true
+print(same(big.slice(-5), refSlice(big, N - 5, N)), big.slice(3, 3).length);
+//CHECK-NEXT: true 0
+
+var c = big.concat([1, 2], big, 'x');
+print(c.length, c[N], c[N + 1], c[N + 2], c[2 * N + 2]);
+//CHECK-NEXT: 20003 1 2 v0 x
+print(same(c.slice(N + 2, 2 * N + 2), big));
+//CHECK-NEXT: true
+
+// Overlapping moves in both directions.
+print(same(range(N).copyWithin(1000, 10, 6000),
+           refCopyWithin(range(N), 1000, 10, 6000)));
+//CHECK-NEXT: true
+print(same(range(N).copyWithin(10, 1000, 9500),
+           refCopyWithin(range(N), 10, 1000, 9500)));
+//CHECK-NEXT: true
+print([1, 2, 3, 4, 5].copyWithin(1, 0, 3).join());
+//CHECK-NEXT: 1,1,2,3,5
+
+// Removing and inserting in the middle of a large array.
+var s = range(N);
+var removed = s.splice(4000, 3000, 'a', 'b');
+print(removed.length, s.length, s[3999], s[4000], s[4001], s[4002]);
+//CHECK-NEXT: 3000 7002 v3999 a b 7000
+print(same(removed, refSlice(big, 4000, 7000)));
+//CHECK-NEXT: true
+var items = [5000, 0];
+for (var i = 0; i < 100; ++i)
+  items.push(i);
+removed = s.splice.apply(s, items);
+print(removed.length, s.length, s[4999], s[5000], s[5099], s[5100]);
+//CHECK-NEXT: 0 7102 7997 0 99 v7998
+print(s.splice(1).length, s.join());
+//CHECK-NEXT: 7101 v0
+
+// The original array literal is not affected by changes to a copy.
+function lit() {
+  return [1, 2, 3, 4];
+}
+var l = lit();
+l.copyWithin(0, 2);
+print(l.join(), lit().join(), lit().slice(1).join());
+//CHECK-NEXT: 3,4,3,4 1,2,3,4 2,3,4
+
+// Holes are preserved, and read through the prototype.
+var h = [1, , 3];
+Array.prototype[1] = 'p';
+print(h.slice(0).join(), h.concat([]).hasOwnProperty(1));
+//CHECK-NEXT: 1,p,3 true
+delete Array.prototype[1];
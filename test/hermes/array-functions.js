@@ -254,6 +254,27 @@ print('empty', Array().join('::::'));
 // CHECK-NEXT: empty
 print(Array(null,2,undefined,3,null).join('-'));
 // CHECK-NEXT: -2--3-
+print([1.5, -0, NaN, -Infinity, 1e21, 'x', 123456789].join());
+// CHECK-NEXT: 1.5,0,NaN,-Infinity,1e+21,x,123456789
+var joined = [1, 'ā', 2].join('');
+print(joined.length, joined.charCodeAt(1), joined.charAt(2));
+// CHECK-NEXT: 3 257 2
+print([1, 2].join('ā').charCodeAt(1));
+// CHECK-NEXT: 257
+// Holes are looked up on the prototype chain.
+Array.prototype[1] = 'proto';
+print([0, , 2].join());
+// CHECK-NEXT: 0,proto,2
+delete Array.prototype[1];
+// Elements converted earlier are not affected by later toString calls.
+var mutated = [1, {}, 3];
+mutated[1].toString = function() {
+  mutated[0] = 9;
+  mutated[2] = 8;
+  return 'o';
+};
+print(mutated.join());
+// CHECK-NEXT: 1,o,8
 
 print('pop');
 // CHECK-LABEL: pop
@@ -0,0 +1,51 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes %s | %FileCheck --match-full-lines %s
+
+function sum(a, n) {
+  var s = "";
+  for (var i = 0; i < n; i++)
+    s += a[i] + ",";
+  return s;
+}
+
+function fill(a, n) {
+  for (var i = 0; i < n; i++)
+    a[i] = i * 2;
+  return a;
+}
+
+print('array-index-loop');
+// CHECK-LABEL: array-index-loop
+print(sum([1, 2, 3], 4));
+// CHECK-NEXT: 1,2,3,undefined,
+print(sum([1, , 3], 3));
+// CHECK-NEXT: 1,undefined,3,
+var proto = [10, 20, 30];
+var holey = [, , ];
+Object.setPrototypeOf(holey, proto);
+print(sum(holey, 3));
+// CHECK-NEXT: 10,20,30,
+print(sum({0: 'a', 1: 'b'}, 2));
+// CHECK-NEXT: a,b,
+print(sum('xyz', 3));
+// CHECK-NEXT: x,y,z,
+print(sum(new Int8Array([4, 5]), 2));
+// CHECK-NEXT: 4,5,
+print(fill([], 3));
+// CHECK-NEXT: 0,2,4
+print(fill([7, 7, 7, 7], 2));
+// CHECK-NEXT: 0,2,7,7
+var frozen = Object.freeze([1, 2]);
+print(fill(frozen, 2));
+// CHECK-NEXT: 1,2
+var withSetter = [1, 2];
+Object.defineProperty(withSetter, 1, {set: function(v) { print('set', v); }});
+fill(withSetter, 2);
+// CHECK-NEXT: set 2
+print(fill(new Uint8Array(2), 2).join());
+// CHECK-NEXT: 0,2
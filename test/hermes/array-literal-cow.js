@@ -0,0 +1,57 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Arrays created from the same literal share their elements until they are
+// modified. Check that modifying one of them never affects the others.
+print('array literal cow');
+// CHECK-LABEL: array literal cow
+
+function nums() {
+    return [1, 2, 3, 4];
+}
+function strs() {
+    return ['a', 'b', 'c'];
+}
+
+var a = nums();
+var b = nums();
+a[0] = 10;
+print(a, b, nums());
+// CHECK-NEXT: 10,2,3,4 1,2,3,4 1,2,3,4
+b.push(5);
+print(b, nums());
+// CHECK-NEXT: 1,2,3,4,5 1,2,3,4
+var c = nums();
+print(c.pop(), c, nums());
+// CHECK-NEXT: 4 1,2,3 1,2,3,4
+var d = nums();
+delete d[1];
+print(d, 1 in d, nums());
+// CHECK-NEXT: 1,,3,4 false 1,2,3,4
+var e = nums();
+e.reverse();
+print(e, nums().sort(function(x, y) { return y - x; }), nums());
+// CHECK-NEXT: 4,3,2,1 4,3,2,1 1,2,3,4
+var f = nums();
+f.length = 1;
+print(f, nums().length);
+// CHECK-NEXT: 1 4
+var g = nums();
+g.shift();
+g.unshift(0);
+print(g, nums());
+// CHECK-NEXT: 0,2,3,4 1,2,3,4
+
+var s = strs();
+s[1] = 'x';
+Object.freeze(strs());
+print(s, strs(), strs().indexOf('b'));
+// CHECK-NEXT: a,x,c a,b,c 1
+var frozen = Object.freeze(strs());
+frozen[0] = 'y';
+print(frozen, strs());
+// CHECK-NEXT: a,b,c a,b,c
@@ -0,0 +1,74 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// indexOf, lastIndexOf and includes read packed arrays straight from their
+// storage. Check that they agree with the generic algorithm.
+print('packed search');
+// CHECK-LABEL: packed search
+
+var nums = [1, 2, NaN, -0, 2, 3];
+print(nums.indexOf(2), nums.lastIndexOf(2), nums.indexOf(2, 2));
+// CHECK-NEXT: 1 4 4
+print(nums.indexOf(NaN), nums.includes(NaN));
+// CHECK-NEXT: -1 true
+print(nums.indexOf(0), nums.includes(+0));
+// CHECK-NEXT: 3 true
+print(nums.indexOf(3, -1), nums.lastIndexOf(1, -6), nums.lastIndexOf(1, -7));
+// CHECK-NEXT: 5 0 -1
+print(nums.indexOf(2, Infinity), nums.lastIndexOf(3, -Infinity), [].indexOf(1));
+// CHECK-NEXT: -1 -1 -1
+
+var mixed = ['a', 1, null, undefined, {}, 'b'];
+print(mixed.indexOf('b'), mixed.indexOf(undefined), mixed.includes(null));
+// CHECK-NEXT: 5 3 true
+print(mixed.lastIndexOf('a'), mixed.indexOf('1'), mixed.includes({}));
+// CHECK-NEXT: 0 -1 false
+
+// Values assigned after the literal prefix, and elements removed by pop().
+var x = 7;
+var a = [1, 2, x];
+a.push(x + 1);
+a.pop();
+print(a.indexOf(7), a.indexOf(8), a.length);
+// CHECK-NEXT: 2 -1 3
+
+// Holes are looked up on the prototype chain.
+var holey = [1, , 3];
+Array.prototype[1] = 'proto';
+print(holey.indexOf('proto'), holey.includes('proto'));
+// CHECK-NEXT: 1 true
+delete Array.prototype[1];
+print(holey.indexOf(undefined), holey.includes(undefined));
+// CHECK-NEXT: -1 true
+
+// The start index is converted before the search, and may change the array.
+var b = [1, 2, 3];
+print(b.indexOf(4, {valueOf: function() { b.push(4); return 0; }}));
+// CHECK-NEXT: -1
+var c = [1, 2, 3];
+print(c.includes(undefined, {valueOf: function() { c.length = 1; return 0; }}));
+// CHECK-NEXT: true
+
+// Large arrays are compared several elements at a time, across the segments
+// of their storage.
+var o = {};
+var big = [];
+for (var i = 0; i < 10000; ++i)
+  big.push(i % 7 ? i : 'v');
+big[9001] = o;
+big[9003] = o;
+big[5] = true;
+print(big.indexOf(o), big.lastIndexOf(o), big.indexOf(o, 9002));
+// CHECK-NEXT: 9001 9003 9003
+print(big.indexOf(o, 9004), big.lastIndexOf(o, 9002), big.lastIndexOf(o, 9000));
+// CHECK-NEXT: -1 9001 -1
+print(big.indexOf(true), big.includes(false));
+// CHECK-NEXT: 5 false
+print(big.indexOf(4097), big.lastIndexOf(8191));
+// CHECK-NEXT: 4097 8191
+print(big.indexOf(9999), big.lastIndexOf(1), big.indexOf(2.5), big.indexOf('v'));
+// CHECK-NEXT: 9999 1 -1 0
@@ -0,0 +1,107 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Array.prototype.shift() and unshift() move the elements of packed arrays
+// within their storage, which must behave like the generic algorithm.
+
+print('shift-unshift');
+//CHECK-LABEL: shift-unshift
+
+// A queue that is filled and drained many times.
+var q = [];
+var sum = 0;
+for (var i = 0; i < 10000; ++i) {
+  q.push(i);
+  q.push(i);
+  sum += q.shift();
+}
+print(q.length, sum, q[0], q[q.length - 1]);
+//CHECK-NEXT: 10000 24995000 5000 9999
+while (q.length > 1)
+  q.shift();
+print(q.length, q[0], q[1]);
+//CHECK-NEXT: 1 9999 undefined
+print(q.shift(), q.length, q.shift(), q.length);
+//CHECK-NEXT: 9999 0 undefined 0
+q.push('a', 'b');
+print(q.length, q.join());
+//CHECK-NEXT: 2 a,b
+
+// Unshifting repeatedly.
+var u = [];
+for (var i = 0; i < 1000; ++i)
+  u.unshift(i);
+print(u.length, u[0], u[999], u.indexOf(500));
+//CHECK-NEXT: 1000 999 0 499
+print(u.unshift('x', 'y'), u.slice(0, 4).join());
+//CHECK-NEXT: 1002 x,y,999,998
+
+// Mixing all the operations that touch the ends.
+var m = [1, 2, 3];
+m.shift();
+m.unshift(0);
+m.push(4);
+m.shift();
+m.unshift(-1, -2);
+m.pop();
+print(m.length, m.join());
+//CHECK-NEXT: 4 -1,-2,2,3
+m[6] = 6;
+print(m.length, m.join());
+//CHECK-NEXT: 7 -1,-2,2,3,,,6
+print(m.shift(), m.length, m.join());
+//CHECK-NEXT: -1 6 -2,2,3,,,6
+m.length = 2;
+m.unshift('a');
+print(m.length, m.join());
+//CHECK-NEXT: 3 a,-2,2
+
+// Array literals may share their storage, which must not be changed.
+function lit() {
+  return [1, 2, 3];
+}
+var l = lit();
+print(l.shift(), l.unshift(0, 0), l.join(), lit().join());
+//CHECK-NEXT: 1 4 0,0,2,3 1,2,3
+
+// Arrays whose elements can't be moved in place.
+var f = Object.freeze([1, 2]);
+try {
+  f.shift();
+} catch (e) {
+  print(e.constructor.name);
+}
+//CHECK-NEXT: TypeError
+print(f.join());
+//CHECK-NEXT: 1,2
+var n = [1, 2, 3];
+Object.defineProperty(n, 'length', {writable: false});
+try {
+  n.unshift(0);
+} catch (e) {
+  print(e.constructor.name);
+}
+//CHECK-NEXT: TypeError
+print(n.length);
+//CHECK-NEXT: 3
+
+// A setter on the prototype sees the stores past the end.
+Object.defineProperty(Array.prototype, 2, {
+  set: function(v) {
+    print('set', v);
+  },
+  get: function() {
+    return 'proto';
+  },
+  configurable: true,
+});
+var p = [1, 2];
+p.unshift(0);
+//CHECK-NEXT: set 2
+print(p.length, p[2]);
+//CHECK-NEXT: 3 proto
+delete Array.prototype[2];
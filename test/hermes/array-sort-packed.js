@@ -0,0 +1,86 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// sort() copies the elements of packed arrays out and sorts them with a
+// stable merge sort. Check that it agrees with the generic algorithm.
+print('packed sort');
+// CHECK-LABEL: packed sort
+
+// Numbers are compared by their string conversions.
+print([10, 9, 1, -1, -0, 0.5, NaN, Infinity, 1e21].sort().join(' '));
+// CHECK-NEXT: -1 0 0.5 1 10 1e+21 9 Infinity NaN
+print([3, 2, 1].sort(function(a, b) { return a - b; }));
+// CHECK-NEXT: 1,2,3
+
+// Strings, with undefined going last.
+var strs = ['b', undefined, 'a', 'ab', undefined, 'B'].sort();
+print(strs.slice(0, 4).join(' '), strs.length, strs[4], strs[5]);
+// CHECK-NEXT: B a ab b 6 undefined undefined
+
+// Mixed values go through the generic algorithm.
+print([2, 'b', true, 1, 'a'].sort().join(' '));
+// CHECK-NEXT: 1 2 a b true
+
+// The sort is stable.
+var recs = [];
+for (var i = 0; i < 100; ++i)
+  recs.push({key: i % 3, id: i});
+recs.sort(function(a, b) { return a.key - b.key; });
+var stable = true;
+for (var i = 1; i < recs.length; ++i) {
+  if (recs[i - 1].key === recs[i].key && recs[i - 1].id > recs[i].id)
+    stable = false;
+}
+print(stable, recs[0].id, recs[33].id, recs[34].id, recs[99].id);
+// CHECK-NEXT: true 0 99 1 98
+
+// Long runs, in order and reversed.
+var asc = [];
+var desc = [];
+for (var i = 0; i < 1000; ++i) {
+  asc.push(i);
+  desc.push(1000 - i);
+}
+var calls = 0;
+asc.sort(function(a, b) { ++calls; return a - b; });
+print(calls, asc[0], asc[999]);
+// CHECK-NEXT: 999 0 999
+desc.sort(function(a, b) { return a - b; });
+print(desc[0], desc[500], desc[999]);
+// CHECK-NEXT: 1 501 1000
+
+// Undefined elements are not passed to the comparison function.
+print([3, undefined, 1].sort(function(a, b) {
+  if (a === undefined || b === undefined)
+    throw new Error('compared undefined');
+  return a - b;
+}));
+// CHECK-NEXT: 1,3,
+
+// Exceptions thrown by the comparison function propagate.
+try {
+  [1, 2, 3].sort(function() { throw new Error('from comparator'); });
+} catch (e) {
+  print(e.message);
+}
+// CHECK-NEXT: from comparator
+
+// The comparison function may modify the array.
+var arr = [5, 4, 3, 2, 1];
+arr.sort(function(a, b) { arr.length = 0; return a - b; });
+print(arr);
+// CHECK-NEXT: 1,2,3,4,5
+
+// A frozen array that is already sorted is left alone.
+print(Object.freeze([1, 2, 3]).sort());
+// CHECK-NEXT: 1,2,3
+try {
+  Object.freeze([2, 1]).sort();
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
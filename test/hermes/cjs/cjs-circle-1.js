@@ -7,6 +7,7 @@
 // RUN: %hermes -O -commonjs %S/cjs-circle-1.js %S/cjs-circle-2.js %S/cjs-circle-3.js | %FileCheck --match-full-lines %s
 // RUN: %hermes -O -fstatic-builtins -fstatic-require -commonjs %S/cjs-circle-1.js %S/cjs-circle-2.js %S/cjs-circle-3.js | %FileCheck --match-full-lines %s
 // RUN: %hermes -O -fstatic-builtins -fstatic-require -commonjs %S/cjs-circle-1.js %S/cjs-circle-2.js %S/cjs-circle-3.js -emit-binary -out %t.hbc && %hermes %t.hbc | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -fstatic-builtins -fstatic-require -commonjs %S/cjs-circle-1.js %S/cjs-circle-2.js %S/cjs-circle-3.js -dump-bytecode | %FileCheck --match-full-lines %s --check-prefix=DEPS
 
 print('1: init');
 // CHECK-LABEL: 1: init
@@ -24,3 +25,8 @@ print('1: mod2.y =', mod2.y);
 // CHECK-NEXT: 1: mod2.y = 2
 print('1: mod2.z =', mod2.z);
 // CHECK-NEXT: 1: mod2.z = 42
+
+// DEPS: CommonJS Module Dependencies:
+// DEPS-NEXT:   Module index 0 -> module IDs 1
+// DEPS-NEXT:   Module index 1 -> module IDs 2
+// DEPS-NEXT:   Module index 2 -> module IDs 1
@@ -0,0 +1,19 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -Werror -commonjs %S/cjs-constant-exports-1.js %S/cjs-constant-exports-2.js | %FileCheck --match-full-lines %s
+// RUN: %hermes -Werror -O -fstatic-require -fstatic-builtins -commonjs %S/cjs-constant-exports-1.js %S/cjs-constant-exports-2.js | %FileCheck --match-full-lines %s
+
+// Exports stored before the module runs any code are constant. The others are
+// seen by circular requires before they are stored, or changed by the modules
+// using them.
+exports.A = 1;
+exports.C = 'c';
+var mod2 = require('./cjs-constant-exports-2.js');
+exports.B = 2;
+
+print('1:', exports.A, exports.B, exports.C, mod2.done);
+// CHECK: 2: 1 undefined c
+// CHECK-NEXT: 1: 1 2 changed true
@@ -0,0 +1,11 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: true
+
+var mod1 = require('./cjs-constant-exports-1.js');
+print('2:', mod1.A, mod1.B, mod1.C);
+mod1.C = 'changed';
+exports.done = true;
@@ -0,0 +1,9 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: true
+
+var name = './cjs-dynamic-' + (2 + (Math.random() * 0)) + '.js';
+module.exports = require(name) + 1;
@@ -0,0 +1,36 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Once a constructor's instances have been observed, later instances get
+// their property storage up front. Objects must still only expose the
+// properties that were actually added, including when an instance ends up
+// with more properties than the observed ones.
+print('slack tracking');
+// CHECK-LABEL: slack tracking
+
+function Point(i, extra) {
+  this.a = i; this.b = i; this.c = i; this.d = i; this.e = i;
+  this.f = i; this.g = i; this.h = i; this.i = i; this.j = i;
+  if (extra) {
+    this.k = i; this.l = i; this.m = i; this.n = i;
+  }
+}
+
+var points = [];
+for (var i = 0; i < 100; ++i) {
+  points.push(new Point(i, i === 50));
+}
+print(Object.keys(points[0]).length, Object.keys(points[99]).length);
+// CHECK-NEXT: 10 10
+print(Object.keys(points[50]).join());
+// CHECK-NEXT: a,b,c,d,e,f,g,h,i,j,k,l,m,n
+var sum = 0;
+for (var i = 0; i < points.length; ++i) {
+  sum += points[i].a + points[i].j;
+}
+print(sum, points[50].n, points[99].k);
+// CHECK-NEXT: 9900 50 undefined
@@ -191,6 +191,10 @@ print(Date.parse('2016T12:30:00.000-07:00'));
 // CHECK-NEXT: 1451676600000
 print(Date.parse('2016T12:30:47.123-07:00'));
 // CHECK-NEXT: 1451676647123
+print(Date.parse('2016-02-15T18:03:57.263Z'));
+// CHECK-NEXT: 1455559437263
+print(Date.parse('2016-02-15T18:03:57.26aZ'));
+// CHECK-NEXT: NaN
 
 // Quick check that getters work; internal functions are unit tested instead.
 print('getters');
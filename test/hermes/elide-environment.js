@@ -0,0 +1,57 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -lazy %s | %FileCheck --match-full-lines %s
+
+print('elide environment');
+// CHECK-LABEL: elide environment
+
+// Functions without variables of their own share the environment of their
+// parent with the closures they create.
+
+function outer(a) {
+  var count = a;
+  function middle() {
+    return function inner() {
+      return function innermost() {
+        count += 10;
+        return count;
+      };
+    };
+  }
+  return middle;
+}
+var f = outer(1)()();
+print(f(), f());
+// CHECK: 11 21
+
+function mixed(a) {
+  return function (b) {
+    return function () {
+      return function () {
+        return a + b;
+      };
+    };
+  };
+}
+print(mixed(1)(2)()());
+// CHECK-NEXT: 3
+
+function* gen(n) {
+  var total = n;
+  function add() {
+    return function () {
+      total += 1;
+    };
+  }
+  add()();
+  yield total;
+  add()();
+  yield total;
+}
+var it = gen(5);
+print(it.next().value, it.next().value);
+// CHECK-NEXT: 6 7
@@ -0,0 +1,27 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+print('enqueueJob');
+// CHECK-LABEL: enqueueJob
+
+try {
+  HermesInternal.enqueueJob(1);
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+
+HermesInternal.enqueueJob(function() {
+  print('job 1');
+  HermesInternal.enqueueJob(function() { print('job 3'); });
+});
+HermesInternal.enqueueJob(function() { print('job 2'); });
+print('script done');
+// CHECK-NEXT: script done
+// CHECK-NEXT: job 1
+// CHECK-NEXT: job 2
+// CHECK-NEXT: job 3
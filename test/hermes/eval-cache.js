@@ -0,0 +1,35 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// REQUIRES: !debugger
+
+// Code compiled by indirect eval and the Function constructor from the same
+// source reuses its bytecode.
+
+print('eval-cache');
+// CHECK-LABEL: eval-cache
+function stats() {
+  var s = HermesInternal.getInstrumentedStats();
+  return [s.js_evalCacheHits, s.js_evalCacheMisses];
+}
+var before = stats();
+var body = 'return a + ' + '1;';
+var f1 = new Function('a', body);
+var f2 = new Function('a', body);
+var f3 = new Function('a', 'return a + 2;');
+var after = stats();
+print(after[0] - before[0], after[1] - before[1]);
+// CHECK-NEXT: 1 2
+print(f1(1), f2(10), f3(1), f1 === f2);
+// CHECK-NEXT: 2 11 3 false
+
+// Each evaluation runs the code again, in its own module.
+var geval = eval;
+var count = 0;
+for (var i = 0; i < 3; ++i)
+  geval('count++; var fromEval = ' + '{n: count};');
+print(count, fromEval.n);
+// CHECK-NEXT: 3 3
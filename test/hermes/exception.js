@@ -70,3 +70,33 @@ finally{
 }
 //CHECK: ex1
 
+
+// Each throw is caught by the innermost try block around it.
+function nested(which) {
+  try {
+    if (which === 0) throw "outer before";
+    try {
+      if (which === 1) throw "inner";
+      try {
+        if (which === 2) throw "innermost";
+      } finally {
+        if (which === 3) throw "finally";
+      }
+    } catch (e) {
+      return "inner catch: " + e;
+    }
+    if (which === 4) throw "outer after";
+  } catch (e) {
+    return "outer catch: " + e;
+  }
+  return "no throw";
+}
+for (var i = 0; i < 6; ++i) {
+  print(nested(i));
+}
+//CHECK: outer catch: outer before
+//CHECK-NEXT: inner catch: inner
+//CHECK-NEXT: inner catch: innermost
+//CHECK-NEXT: inner catch: finally
+//CHECK-NEXT: outer catch: outer after
+//CHECK-NEXT: no throw
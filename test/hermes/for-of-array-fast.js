@@ -0,0 +1,140 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O0 %s | %FileCheck --match-full-lines %s
+
+// for-of loops over arrays with the original iterator walk the elements by
+// index, and use the iteration protocol for everything else.
+
+print('for-of-array-fast');
+//CHECK-LABEL: for-of-array-fast
+
+function collect(iterable) {
+  var out = '';
+  for (var v of iterable)
+    out += (out ? ',' : '') + v;
+  return out;
+}
+
+print(collect([1, 2, 3]), collect([]), collect(['a', , 'c']));
+//CHECK-NEXT: 1,2,3  a,undefined,c
+
+// Holes read through the prototype chain.
+Object.defineProperty(Array.prototype, 1, {
+  get: function() {
+    return 'proto';
+  },
+  configurable: true,
+});
+print(collect([0, , 2]));
+//CHECK-NEXT: 0,proto,2
+delete Array.prototype[1];
+
+// The length is read at every step.
+var grow = [1, 2];
+var seen = [];
+for (var v of grow) {
+  seen.push(v);
+  if (grow.length < 5)
+    grow.push(v * 10);
+}
+print(seen.join());
+//CHECK-NEXT: 1,2,10,20,100
+var shrink = [1, 2, 3, 4];
+seen = [];
+for (var v of shrink) {
+  seen.push(v);
+  shrink.length = 2;
+}
+print(seen.join());
+//CHECK-NEXT: 1,2
+
+// Strings and other iterables.
+print(collect('héllo'), collect(new Set([3, 4])), collect(new Map([[5, 6]])));
+//CHECK-NEXT: h,é,l,l,o 3,4 5,6
+print(collect(new Uint8Array([7, 8])), collect([9, 10].keys()));
+//CHECK-NEXT: 7,8 0,1
+
+// A replaced next method of array iterators is called.
+var ArrayIteratorPrototype = Object.getPrototypeOf([][Symbol.iterator]());
+var originalNext = ArrayIteratorPrototype.next;
+ArrayIteratorPrototype.next = function() {
+  var r = originalNext.call(this);
+  if (!r.done)
+    r.value = r.value + '!';
+  return r;
+};
+print(collect([1, 2]));
+//CHECK-NEXT: 1!,2!
+ArrayIteratorPrototype.next = originalNext;
+print(collect([1, 2]));
+//CHECK-NEXT: 1,2
+
+// So is a replaced iterator method, on the array or its prototype.
+var own = [1, 2];
+own[Symbol.iterator] = function() {
+  return ['own'][Symbol.iterator]();
+};
+print(collect(own));
+//CHECK-NEXT: own
+var originalValues = Array.prototype[Symbol.iterator];
+Array.prototype[Symbol.iterator] = function() {
+  return originalValues.call(['replaced']);
+};
+print(collect([1, 2]));
+//CHECK-NEXT: replaced
+Array.prototype[Symbol.iterator] = originalValues;
+
+// Custom iterators are closed by break and by exceptions.
+function counter(n) {
+  var i = 0;
+  var it = {
+    next: function() {
+      return i < n ? {value: i++, done: false} : {value: undefined, done: true};
+    },
+    return: function() {
+      print('closed at', i);
+      return {};
+    },
+  };
+  var iterable = {};
+  iterable[Symbol.iterator] = function() {
+    return it;
+  };
+  return iterable;
+}
+for (var v of counter(5)) {
+  if (v === 2)
+    break;
+}
+//CHECK-NEXT: closed at 3
+try {
+  for (var v of counter(5)) {
+    if (v === 1)
+      throw new Error('thrown');
+  }
+} catch (e) {
+  print(e.message);
+}
+//CHECK-NEXT: closed at 2
+//CHECK-NEXT: thrown
+print(collect(counter(3)));
+//CHECK-NEXT: 0,1,2
+
+// Errors in the protocol.
+function tryCollect(iterable) {
+  try {
+    return collect(iterable);
+  } catch (e) {
+    return e.constructor.name;
+  }
+}
+var badNext = {};
+badNext[Symbol.iterator] = function() {
+  return {next: 1};
+};
+print(tryCollect(undefined), tryCollect({}), tryCollect(badNext));
+//CHECK-NEXT: TypeError TypeError TypeError
@@ -122,3 +122,29 @@ for (var p in a) {
 }
 print(t);
 //CHECK: 1000000
+
+// Deleting properties during a cached enumeration skips them, whether they
+// are own or inherited.
+function enumerateDeleting(o, victim, from) {
+  var seen = [];
+  for (var p in o) {
+    seen.push(p);
+    if (p === 'u0') delete from[victim];
+  }
+  print(seen.join(','));
+}
+var proto = {u2: 2, u3: 3};
+for (var i = 0; i < 3; ++i) {
+  var o = Object.create(proto);
+  o.u0 = 0;
+  o.u1 = 1;
+  enumerateDeleting(o, 'u1', o);
+}
+//CHECK: u0,u2,u3
+//CHECK-NEXT: u0,u2,u3
+//CHECK-NEXT: u0,u2,u3
+o = Object.create(proto);
+o.u0 = 0;
+o.u1 = 1;
+enumerateDeleting(o, 'u3', proto);
+//CHECK-NEXT: u0,u1,u2
@@ -0,0 +1,67 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O0 %s | %FileCheck --match-full-lines %s
+
+// f.call(thisArg, ...) calls f in the frame of the call, which must be
+// restored afterwards.
+
+"use strict";
+
+function show() {
+  return this + ':' + Array.prototype.join.call(arguments, ',');
+}
+
+print(show.call('a', 1, 2, 3));
+//CHECK: a:1,2,3
+print(show.call('b'));
+//CHECK-NEXT: b:
+print(show.call());
+//CHECK-NEXT: undefined:
+
+// The callee and 'this' of the call are still usable after it.
+var obj = {f: show, name: 'obj'};
+var r1 = obj.f.call('c', 1);
+var r2 = obj.f.call('d', 2);
+print(r1, r2);
+//CHECK-NEXT: c:1 d:2
+
+// Native and bound targets, and Function.prototype.call itself.
+print(Math.max.call(null, 3, 9, 4));
+//CHECK-NEXT: 9
+print(show.bind('e', 1).call('ignored', 2));
+//CHECK-NEXT: e:1,2
+print(show.call.call(show, 'f', 3));
+//CHECK-NEXT: f:3
+
+// Calling a non-callable.
+try {
+  Function.prototype.call.call({}, 1);
+} catch (e) {
+  print(e.name);
+}
+//CHECK-NEXT: TypeError
+
+// Exceptions thrown by the target propagate and leave the frame intact.
+function thrower(x) {
+  throw new Error('thrown ' + x);
+}
+for (var i = 0; i < 2; ++i) {
+  try {
+    thrower.call(null, i);
+  } catch (e) {
+    print(e.message);
+  }
+}
+//CHECK-NEXT: thrown 0
+//CHECK-NEXT: thrown 1
+
+// Nested and recursive calls.
+function sum(n) {
+  return n === 0 ? 0 : n + sum.call(this, n - 1);
+}
+print(sum.call(null, 100));
+//CHECK-NEXT: 5050
@@ -0,0 +1,71 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Closures of the same kind share the class of their lazily defined
+// properties, and arrow functions have no prototype.
+
+print('function-lazy-class');
+// CHECK-LABEL: function-lazy-class
+
+function make() {
+  return function named(a, b) {};
+}
+var f1 = make();
+var f2 = make();
+print(f1.name, f1.length, Object.getOwnPropertyNames(f1).join());
+// CHECK-NEXT: named 2 name,length,prototype
+print(f2.name, f2.length, Object.getOwnPropertyNames(f2).join());
+// CHECK-NEXT: named 2 name,length,prototype
+print(f1.prototype !== f2.prototype, f2.prototype.constructor === f2);
+// CHECK-NEXT: true true
+var desc = Object.getOwnPropertyDescriptor(f2, 'name');
+print(desc.writable, desc.enumerable, desc.configurable);
+// CHECK-NEXT: false false true
+desc = Object.getOwnPropertyDescriptor(f2, 'prototype');
+print(desc.writable, desc.enumerable, desc.configurable);
+// CHECK-NEXT: true false false
+
+f2.extra = 1;
+print(Object.getOwnPropertyNames(f2).join());
+// CHECK-NEXT: name,length,prototype,extra
+print(f1.hasOwnProperty('extra'), make().hasOwnProperty('extra'));
+// CHECK-NEXT: false false
+
+function makeStrict() {
+  'use strict';
+  return function strict(a) {};
+}
+var s1 = makeStrict();
+var s2 = makeStrict();
+print(s1.length, Object.getOwnPropertyNames(s1).join());
+// CHECK-NEXT: 1 name,length,caller,arguments,prototype
+print(s2.name, Object.getOwnPropertyNames(s2).join());
+// CHECK-NEXT: strict name,length,caller,arguments,prototype
+try {
+  s2.caller;
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+
+function makeArrow() {
+  return (a, b, c) => a;
+}
+var a1 = makeArrow();
+var a2 = makeArrow();
+print(a1.length, a1.hasOwnProperty('prototype'), a1.prototype);
+// CHECK-NEXT: 3 false undefined
+print(Object.getOwnPropertyNames(a2).join());
+// CHECK-NEXT: name,length
+a2.extra = 2;
+print(a2.extra, a1.extra);
+// CHECK-NEXT: 2 undefined
+
+function* gen() {}
+var g = gen;
+print(g.hasOwnProperty('prototype'), g.prototype.hasOwnProperty('constructor'));
+// CHECK-NEXT: true false
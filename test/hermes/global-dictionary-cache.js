@@ -0,0 +1,53 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O -non-strict %s | %FileCheck --match-full-lines %s
+
+// Push the global object into dictionary mode and check that cached global
+// accesses observe deletions and flag changes.
+
+var global = this;
+for (var i = 0; i < 100; ++i)
+  global["filler" + i] = i;
+
+var g = "first";
+function readG() {
+  return g;
+}
+function writeG(v) {
+  g = v;
+}
+
+print(readG(), readG());
+// CHECK: first first
+writeG("second");
+print(readG());
+// CHECK-NEXT: second
+
+// Make the property read-only; cached writes must no longer succeed.
+Object.defineProperty(global, "g", {writable: false});
+writeG("third");
+print(readG());
+// CHECK-NEXT: second
+
+// Delete another property and reuse its slot for a new one.
+global.h = "h";
+function readH() {
+  return h;
+}
+print(readH());
+// CHECK-NEXT: h
+delete global.filler5;
+delete global.h;
+global.filler200 = "new";
+try {
+  readH();
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: ReferenceError
+global.h = "h2";
+print(readH());
+// CHECK-NEXT: h2
@@ -115,6 +115,9 @@ print(parseInt("-123"));
 print(parseInt("abc"))
 // CHECK-NEXT: NaN
 
+print(parseInt("123456789012345x"), 1 / parseInt("-0"));
+// CHECK-NEXT: 123456789012345 -Infinity
+
 print('parseFloat');
 // CHECK-LABEL: parseFloat
 
@@ -160,6 +163,12 @@ print(parseFloat("-55e.5"));
 print(parseFloat('+'));
 // CHECK-NEXT: NaN
 
+print(parseFloat("0.1"), parseFloat(" 123456789.0625px"), 1 / parseFloat("-0"));
+// CHECK-NEXT: 0.1 123456789.0625 -Infinity
+
+print(parseFloat("1e23"), parseFloat(".5e-3"), parseFloat("0x10"));
+// CHECK-NEXT: 1e+23 0.0005 0
+
 try {
   new isNaN();
 } catch (e) {
@@ -0,0 +1,61 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -Xrelease-shared-property-maps -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -Xrelease-shared-property-maps -O0 %s | %FileCheck --match-full-lines %s
+
+// Property maps shared by the children of a hidden class are dropped after a
+// full collection, and rebuilt when needed again.
+
+function make(last, v) {
+  var o = {a: 1, b: 2};
+  o[last] = v;
+  return o;
+}
+
+// {a, b} has three children, so it keeps a map for them.
+var x = make("x", 10);
+var y = make("y", 20);
+var z = make("z", 30);
+
+function show(o) {
+  var keys = Object.keys(o);
+  var parts = [];
+  for (var i = 0; i < keys.length; ++i)
+    parts.push(keys[i] + "=" + o[keys[i]]);
+  return parts.join(",");
+}
+
+gc();
+
+// CHECK-LABEL: after gc
+print("after gc");
+// CHECK-NEXT: a=1,b=2,x=10
+// CHECK-NEXT: a=1,b=2,y=20
+// CHECK-NEXT: a=1,b=2,z=30
+print(show(x));
+print(show(y));
+print(show(z));
+
+// A new child of {a, b} starts from the rebuilt map.
+var w = make("w", 40);
+// CHECK-NEXT: a=1,b=2,w=40
+print(show(w));
+// CHECK-NEXT: true false
+print("w" in w, "x" in w);
+
+gc();
+
+// Updating the flags of an inherited property goes through the map too.
+Object.defineProperty(y, "a", {enumerable: false});
+// CHECK-NEXT: b=2,y=20 1
+print(show(y), y.a);
+Object.freeze(z);
+z.b = 100;
+// CHECK-NEXT: a=1,b=2,z=30 true
+print(show(z), Object.isFrozen(z));
+delete x.a;
+// CHECK-NEXT: b=2,x=10
+print(show(x));
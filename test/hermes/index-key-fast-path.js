@@ -0,0 +1,52 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -emit-binary -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+
+print('index-key-fast-path');
+// CHECK-LABEL: index-key-fast-path
+
+// String keys that are array indices read the indexed storage.
+var arr = [10, 20, 30];
+var keys = ['0', '1', '2', '3', '01', '1.0', '4294967295'];
+for (var i = 0; i < keys.length; ++i) {
+  print(keys[i], arr[keys[i]]);
+}
+// CHECK-NEXT: 0 10
+// CHECK-NEXT: 1 20
+// CHECK-NEXT: 2 30
+// CHECK-NEXT: 3 undefined
+// CHECK-NEXT: 01 undefined
+// CHECK-NEXT: 1.0 undefined
+// CHECK-NEXT: 4294967295 undefined
+
+// Keys built at runtime, including concatenated strings.
+print(arr['1'], arr['' + 2], arr[String(1 + 1)]);
+// CHECK-NEXT: 20 30 30
+
+// Holes fall back to the prototype chain.
+var holey = [1, , 3];
+Array.prototype[1] = 'proto';
+print(holey['1'], holey[1]);
+// CHECK-NEXT: proto proto
+delete Array.prototype[1];
+
+// Numeric keys of plain objects name the same properties as their strings.
+var map = {};
+for (var i = 0; i < 5; ++i) {
+  map[i * 100] = i;
+}
+print(map['0'], map['400'], map[400], map[4294967294], map[-0]);
+// CHECK-NEXT: 0 4 4 undefined 0
+map[4294967294] = 'big';
+print(map['4294967294'], Object.keys(map).join());
+// CHECK-NEXT: big 0,100,200,300,400,4294967294
+
+// Getters on index-like properties are still called.
+var obj = {};
+Object.defineProperty(obj, '7', {get: function() { return 'getter'; }});
+print(obj[7], obj['7']);
+// CHECK-NEXT: getter getter
@@ -0,0 +1,31 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O -fstatic-builtins %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// The builtins computed by the interpreter without a call behave like the
+// native functions, also for the arguments which take the slow path.
+
+print('inline builtins');
+// CHECK-LABEL: inline builtins
+
+print(Math.floor(2.5), Math.floor(-2.5), Math.floor('3.7'), Math.floor());
+// CHECK-NEXT: 2 -3 3 NaN
+print(Math.abs(-3), Math.abs(1 / -0), Math.abs({valueOf: () => -4}));
+// CHECK-NEXT: 3 Infinity 4
+print(Math.max(), Math.min(), Math.max(1, 3, 2), Math.min(1, 3, 2));
+// CHECK-NEXT: -Infinity Infinity 3 1
+print(1 / Math.max(-0, 0), 1 / Math.min(0, -0));
+// CHECK-NEXT: Infinity -Infinity
+print(Math.max(1, NaN, 3), Math.min(NaN, 1), Math.max(1, '5'));
+// CHECK-NEXT: NaN NaN 5
+print(Array.isArray([]), Array.isArray({}), Array.isArray());
+// CHECK-NEXT: true false false
+
+var calls = 0;
+Math.max(NaN, {valueOf: function() { ++calls; return 1; }});
+print(calls);
+// CHECK-NEXT: 1
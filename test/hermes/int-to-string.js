@@ -0,0 +1,22 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// The strings of small integers are cached, and must survive collections.
+
+var keys = [];
+for (var i = 1000; i < 1050; ++i) {
+  keys.push(String(i));
+}
+gc();
+var same = 0;
+for (var i = 1000; i < 1050; ++i) {
+  same += String(i) === keys[i - 1000] ? 1 : 0;
+}
+print(same);
+//CHECK: 50
+print(String(1), String(1023), String(1024), '' + 7, (511).toString());
+//CHECK-NEXT: 1 1023 1024 7 511
@@ -0,0 +1,51 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+print('parseJSONFromArrayBuffer');
+// CHECK-LABEL: parseJSONFromArrayBuffer
+
+function utf8(bytes) {
+  return new Uint8Array(bytes).buffer;
+}
+
+// {"a":[1,"é"]}
+var text = utf8([0x7b, 0x22, 0x61, 0x22, 0x3a, 0x5b, 0x31, 0x2c, 0x22, 0xc3,
+                 0xa9, 0x22, 0x5d, 0x7d]);
+var parsed = HermesInternal.parseJSONFromArrayBuffer(text);
+print(parsed.a[0], parsed.a[1].charCodeAt(0), parsed.a[1].length);
+// CHECK-NEXT: 1 233 1
+
+// The reviver is called as with JSON.parse().
+print(HermesInternal.parseJSONFromArrayBuffer(utf8([0x5b, 0x31, 0x5d]),
+  function(key, value) { return typeof value === 'number' ? value * 2 : value; }));
+// CHECK-NEXT: 2
+
+// Invalid UTF-8 is decoded as U+FFFD.
+print(HermesInternal.parseJSONFromArrayBuffer(utf8([0x22, 0xff, 0x22]))
+  .charCodeAt(0));
+// CHECK-NEXT: 65533
+
+try {
+  HermesInternal.parseJSONFromArrayBuffer(utf8([0x7b]));
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: SyntaxError
+try {
+  HermesInternal.parseJSONFromArrayBuffer('[]');
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+var detached = utf8([0x31]);
+HermesInternal.detachArrayBuffer(detached);
+try {
+  HermesInternal.parseJSONFromArrayBuffer(detached);
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
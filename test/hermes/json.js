@@ -451,3 +451,50 @@ print(JSON.parse("1.2e2"));
 // CHECK-NEXT: 120
 print(JSON.parse("2.3E3"));
 // CHECK-NEXT: 2300
+
+// Integers are parsed without strtod.
+print(1 / JSON.parse("-0"), JSON.parse("123456789012345"),
+      JSON.parse("-1234567890123456789"), JSON.parse("[0, -7, 42]"));
+// CHECK-NEXT: -Infinity 123456789012345 -1234567890123456800 0,-7,42
+
+// Strings with and without escapes, as values and keys.
+var o = JSON.parse('{"plain": "abc", "esc\\u0061ped": "x\\ny\\"z", "": "\u00e9"}');
+print(Object.keys(o), JSON.stringify(o.escaped), o[""].charCodeAt(0));
+// CHECK-NEXT: plain,escaped, "x\ny\"z" 233
+
+// Objects with the same keys share their layout, and duplicate or index-like
+// keys are still handled.
+var arr = JSON.parse('[{"x": 1, "y": 2}, {"x": 3, "y": 4}, {"x": 5, "x": 6}]');
+print(arr.length, arr[1].x, arr[1].y, arr[2].x, Object.keys(arr[2]));
+// CHECK-NEXT: 3 3 4 6 x
+var o = JSON.parse('{"b": 1, "1": 2, "a": 3, "0": 4}');
+print(Object.keys(o), o[0], o[1]);
+// CHECK-NEXT: 0,1,b,a 4 2
+
+// Objects of the same shape share their quoted keys.
+var points = [];
+for (var i = 0; i < 3; ++i)
+  points.push({x: i, "a\"b": {y: -i, z: [i / 2]}});
+print(JSON.stringify(points));
+// CHECK-NEXT: [{"x":0,"a\"b":{"y":0,"z":[0]}},{"x":1,"a\"b":{"y":-1,"z":[0.5]}},{"x":2,"a\"b":{"y":-2,"z":[1]}}]
+print(JSON.stringify([{a: 1, b: 2}, {a: 3, b: 4}], null, 1));
+// CHECK-NEXT: [
+// CHECK-NEXT:  {
+// CHECK-NEXT:   "a": 1,
+// CHECK-NEXT:   "b": 2
+// CHECK-NEXT:  },
+// CHECK-NEXT:  {
+// CHECK-NEXT:   "a": 3,
+// CHECK-NEXT:   "b": 4
+// CHECK-NEXT:  }
+// CHECK-NEXT: ]
+
+// Keys are listed before the values are read, which may change the object.
+var changing = [{a: 1, b: 2, c: 3}, {a: 1, b: 2, c: 3}];
+changing[1].toJSON = undefined;
+Object.defineProperty(changing[0], 'a', {
+  enumerable: true,
+  get: function() { delete this.b; this.c = 'changed'; return 'got'; },
+});
+print(JSON.stringify(changing));
+// CHECK-NEXT: [{"a":"got","c":"changed"},{"a":1,"b":2,"c":3}]
@@ -0,0 +1,60 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes %s | %FileCheck --match-full-lines %s
+
+print('jump peephole');
+// CHECK-LABEL: jump peephole
+
+function choose(x, y) {
+  var r;
+  if (x) {
+    r = y + 1;
+  } else {
+    r = y - 1;
+  }
+  return r;
+}
+print(choose(true, 10), choose(false, 10));
+// CHECK-NEXT: 11 9
+
+function loops(n) {
+  var sum = 0;
+  outer: for (var i = 0; i < n; ++i) {
+    for (var j = 0; j < n; ++j) {
+      if (j > i)
+        continue outer;
+      if ((i + j) % 3 === 0)
+        continue;
+      sum += i * j;
+    }
+  }
+  return sum;
+}
+print(loops(10));
+// CHECK-NEXT: 750
+
+function* gen(n) {
+  for (var i = 0; i < n; ++i) {
+    if (i % 2)
+      continue;
+    yield i;
+  }
+  return 'done';
+}
+var g = gen(5);
+print(g.next().value, g.next().value, g.next().value, g.next().value);
+// CHECK-NEXT: 0 2 4 done
+
+function early(a) {
+  for (var i = 0; i < a.length; ++i) {
+    if (a[i] < 0)
+      return i;
+  }
+  return -1;
+}
+print(early([1, 2, -3]), early([1, 2]));
+// CHECK-NEXT: 2 -1
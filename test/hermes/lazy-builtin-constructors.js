@@ -0,0 +1,49 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Map, Set, WeakMap, WeakSet, DataView and the typed arrays are populated on
+// first use. Check that they look the same however they are reached first.
+print('lazy builtin constructors');
+// CHECK-LABEL: lazy builtin constructors
+
+// The global properties exist before the constructors are populated.
+var desc = Object.getOwnPropertyDescriptor(this, 'Map');
+print(typeof desc.value, desc.writable, desc.enumerable, desc.configurable);
+// CHECK-NEXT: function true false true
+
+// Reaching the prototype through the constructor.
+print(Object.getOwnPropertyNames(Set.prototype).indexOf('add') >= 0);
+// CHECK-NEXT: true
+print(Set.name, Set.length, Set.prototype.constructor === Set);
+// CHECK-NEXT: Set 0 true
+
+// Constructing an instance before touching any property.
+var m = new Map([[1, 'a']]);
+print(m.get(1), m.size, Object.getPrototypeOf(m) === Map.prototype);
+// CHECK-NEXT: a 1 true
+print(new WeakMap() instanceof WeakMap, new WeakSet() instanceof WeakSet);
+// CHECK-NEXT: true true
+print(new DataView(new ArrayBuffer(4)).byteLength);
+// CHECK-NEXT: 4
+
+// %TypedArray% keeps the original Array.prototype.toString, even if it is
+// replaced before the first typed array is created.
+var arrayToString = Array.prototype.toString;
+Array.prototype.toString = function() { return 'replaced'; };
+var u8 = new Uint8Array([1, 2, 3]);
+print(u8.toString(), Uint8Array.prototype.toString === arrayToString);
+// CHECK-NEXT: 1,2,3 true
+Array.prototype.toString = arrayToString;
+
+// The typed arrays share %TypedArray%, however it is reached.
+var TypedArray = Object.getPrototypeOf(Int16Array);
+print(TypedArray.name, Object.getPrototypeOf(Float64Array) === TypedArray);
+// CHECK-NEXT: TypedArray true
+print(Object.getOwnPropertyNames(Int32Array).sort().join(','));
+// CHECK-NEXT: BYTES_PER_ELEMENT,length,name,prototype
+print(Float32Array.BYTES_PER_ELEMENT, Float32Array.from([1.5])[0]);
+// CHECK-NEXT: 4 1.5
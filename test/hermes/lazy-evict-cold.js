@@ -0,0 +1,95 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -lazy -Xevict-cold-lazy-functions -debug-only=codeblock -non-strict -target=HBC %s 2>&1 | %FileCheck --match-full-lines %s
+// REQUIRES: debug_options
+
+// Lazily compiled functions which are not called between two full
+// collections are compiled again by their next call.
+
+function cold(x) {
+  var o = {a: x, b: [1, 2, 3]};
+  return o.a + o.b.length;
+  /* Some text to pad out the function so that it won't be eagerly compiled
+   * for being too short. Lorem ipsum dolor sit amet, consectetur adipiscing
+   * elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.
+   */
+}
+
+function hot() {
+  print("hot");
+  /* Some text to pad out the function so that it won't be eagerly compiled
+   * for being too short. Lorem ipsum dolor sit amet, consectetur adipiscing
+   * elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.
+   */
+}
+
+function thrower() {
+  throw new Error("thrown");
+  /* Some text to pad out the function so that it won't be eagerly compiled
+   * for being too short. Lorem ipsum dolor sit amet, consectetur adipiscing
+   * elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.
+   */
+}
+
+function outer() {
+  function inner() {
+    return "inner";
+    /* Some text to pad out the function so that it won't be eagerly compiled
+     * for being too short. Lorem ipsum dolor sit amet, consectetur adipiscing
+     * elit, sed do eiusmod tempor incididunt ut labore et dolore magna
+     * aliqua.
+     */
+  }
+  return inner;
+}
+
+// CHECK-LABEL: main
+print("main");
+
+// CHECK-NEXT: Compiling lazy function cold
+// CHECK-NEXT: 4
+print(cold(1));
+
+var err;
+try {
+  thrower();
+} catch (e) {
+  err = e;
+}
+// CHECK-NEXT: Compiling lazy function thrower
+
+// A closure of a nested function keeps the bytecode of its parent alive,
+// but not its own.
+// CHECK-NEXT: Compiling lazy function outer
+// CHECK-NEXT: Compiling lazy function inner
+// CHECK-NEXT: inner
+var inner = outer();
+print(inner());
+
+// The functions called before the first collection are kept by the first
+// eviction.
+gc();
+// CHECK-NEXT: Compiling lazy function hot
+// CHECK-NEXT: hot
+hot();
+
+// Only hot() was called since the first eviction.
+gc();
+// CHECK-NEXT: hot
+hot();
+// CHECK-NEXT: Compiling lazy function cold
+// CHECK-NEXT: 5
+print(cold(2));
+// CHECK-NEXT: Compiling lazy function inner
+// CHECK-NEXT: inner
+print(inner());
+
+// The stack trace is resolved against the bytecode compiled again.
+// CHECK-NEXT: Compiling lazy function thrower
+// CHECK-NEXT: Error: thrown
+// CHECK-NEXT:     at thrower ({{.*}}lazy-evict-cold.js:30:{{[0-9]+}})
+// CHECK-NEXT:     at global ({{.*}}lazy-evict-cold.js:58:{{[0-9]+}})
+print(err.stack);
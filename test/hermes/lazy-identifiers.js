@@ -0,0 +1,52 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -emit-binary -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+
+// Identifiers are registered in pages when they are first used. Use enough of
+// them to span several pages, and reach them in an order unrelated to their
+// position in the string table.
+
+print('lazy-identifiers');
+// CHECK-LABEL: lazy-identifiers
+
+var o = {};
+o.p00 = 0; o.p01 = 1; o.p02 = 2; o.p03 = 3; o.p04 = 4; o.p05 = 5;
+o.p06 = 6; o.p07 = 7; o.p08 = 8; o.p09 = 9; o.p10 = 10; o.p11 = 11;
+o.p12 = 12; o.p13 = 13; o.p14 = 14; o.p15 = 15; o.p16 = 16; o.p17 = 17;
+o.p18 = 18; o.p19 = 19; o.p20 = 20; o.p21 = 21; o.p22 = 22; o.p23 = 23;
+o.p24 = 24; o.p25 = 25; o.p26 = 26; o.p27 = 27; o.p28 = 28; o.p29 = 29;
+o.p30 = 30; o.p31 = 31; o.p32 = 32; o.p33 = 33; o.p34 = 34; o.p35 = 35;
+o.p36 = 36; o.p37 = 37; o.p38 = 38; o.p39 = 39; o.p40 = 40; o.p41 = 41;
+o.p42 = 42; o.p43 = 43; o.p44 = 44; o.p45 = 45; o.p46 = 46; o.p47 = 47;
+o.p48 = 48; o.p49 = 49; o.p50 = 50; o.p51 = 51; o.p52 = 52; o.p53 = 53;
+o.p54 = 54; o.p55 = 55; o.p56 = 56; o.p57 = 57; o.p58 = 58; o.p59 = 59;
+o.p60 = 60; o.p61 = 61; o.p62 = 62; o.p63 = 63; o.p64 = 64; o.p65 = 65;
+o.p66 = 66; o.p67 = 67; o.p68 = 68; o.p69 = 69; o.p70 = 70; o.p71 = 71;
+o.p72 = 72; o.p73 = 73; o.p74 = 74; o.p75 = 75; o.p76 = 76; o.p77 = 77;
+o.p78 = 78; o.p79 = 79; o.p80 = 80; o.p81 = 81; o.p82 = 82; o.p83 = 83;
+o.p84 = 84; o.p85 = 85; o.p86 = 86; o.p87 = 87; o.p88 = 88; o.p89 = 89;
+o.p90 = 90; o.p91 = 91; o.p92 = 92; o.p93 = 93; o.p94 = 94; o.p95 = 95;
+o.p96 = 96; o.p97 = 97; o.p98 = 98; o.p99 = 99;
+
+var keys = Object.keys(o);
+print(keys.length, keys[0], keys[99]);
+// CHECK-NEXT: 100 p00 p99
+
+// Computed keys built at run time find the same properties.
+var sum = 0;
+for (var i = 99; i >= 0; --i) {
+    sum += o['p' + (i < 10 ? '0' + i : i)];
+}
+print(sum);
+// CHECK-NEXT: 4950
+
+print(o.p77, 'p77' in o, o.hasOwnProperty('p03'));
+// CHECK-NEXT: 77 true true
+
+var s = 'p4' + '2';
+print(o[s] === o.p42);
+// CHECK-NEXT: true
@@ -0,0 +1,87 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -emit-binary -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+
+// Iterators must keep their position while the table of the collection is
+// grown, compacted and cleared under them.
+
+print('map-iteration-rehash');
+// CHECK-LABEL: map-iteration-rehash
+
+// Grow the table while iterating.
+var m = new Map([[0, 'a'], [1, 'b']]);
+var it = m.entries();
+print(it.next().value);
+// CHECK-NEXT: 0,a
+for (var i = 2; i < 100; ++i) {
+  m.set(i, i);
+}
+print(it.next().value, it.next().value);
+// CHECK-NEXT: 1,b 2,2
+
+// Delete most elements, forcing a smaller table, while iterating.
+for (var i = 0; i < 95; ++i) {
+  m.delete(i);
+}
+print(m.size, it.next().value);
+// CHECK-NEXT: 5 95,95
+
+// Delete and reinsert at the end, which fills the table with holes.
+var s = new Set();
+for (var i = 0; i < 8; ++i) {
+  s.add(i);
+}
+var sit = s.values();
+print(sit.next().value, sit.next().value);
+// CHECK-NEXT: 0 1
+for (var i = 0; i < 50; ++i) {
+  s.delete(i % 8);
+  s.add(i % 8);
+}
+var rest = [];
+for (var v of sit) {
+  rest.push(v);
+}
+print(rest.join());
+// CHECK-NEXT: 2,3,4,5,6,7,0,1
+
+// Clearing moves iterators to the start of the new contents.
+var c = new Set([1, 2, 3]);
+var cit = c.values();
+print(cit.next().value);
+// CHECK-NEXT: 1
+c.clear();
+c.add(10);
+c.add(20);
+print(cit.next().value, cit.next().value, cit.next().done);
+// CHECK-NEXT: 10 20 true
+
+// forEach sees elements added by the callback, and not deleted ones.
+var f = new Map([['x', 1], ['y', 2], ['z', 3]]);
+var seen = [];
+f.forEach(function(v, k) {
+  seen.push(k);
+  if (k === 'x') {
+    f.delete('y');
+    for (var i = 0; i < 20; ++i) {
+      f.set('n' + i, i);
+    }
+  }
+  if (k === 'n19') {
+    f.clear();
+    f.set('last', 0);
+  }
+});
+print(seen.join());
+// CHECK-NEXT: x,z,n0,n1,n2,n3,n4,n5,n6,n7,n8,n9,n10,n11,n12,n13,n14,n15,n16,n17,n18,n19,last
+
+// Keys that are the same value zero find the same entry.
+var z = new Map();
+z.set(-0, 'zero');
+z.set(NaN, 'nan');
+print(z.get(0), z.get(NaN), z.size);
+// CHECK-NEXT: zero nan 2
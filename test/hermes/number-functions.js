@@ -19,6 +19,10 @@ print(Number("123"))
 // CHECK-NEXT: 123
 print(Number("123asdf"))
 // CHECK-NEXT: NaN
+print(Number(" 12345678.5\n"), Number("-.25e2"), Number("1e"), Number("0x1f"))
+// CHECK-NEXT: 12345678.5 -25 NaN 31
+print(Number("9007199254740993"), Number("1.5.2"), 1 / Number("-0"))
+// CHECK-NEXT: 9007199254740992 NaN -Infinity
 var n = new Number(123);
 print(n, n.__proto__ === Number.prototype);
 // CHECK-NEXT: 123 true
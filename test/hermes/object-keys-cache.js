@@ -0,0 +1,54 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Object.keys() shares the names cached on the hidden class, and
+// Object.values()/entries() read plain data properties from their slots.
+
+print('object-keys-cache');
+// CHECK-LABEL: object-keys-cache
+function make(x, y) {
+  return {x: x, y: y};
+}
+var a = make(1, 2);
+var b = make(3, 4);
+var ka = Object.keys(a);
+ka.push('z');
+ka[0] = 'w';
+print(ka, Object.keys(b), Object.keys(a));
+// CHECK-NEXT: w,y,z x,y x,y
+b.extra = 5;
+print(Object.keys(b), Object.values(b));
+// CHECK-NEXT: x,y,extra 3,4,5
+print(JSON.stringify(Object.entries(a)));
+// CHECK-NEXT: [["x",1],["y",2]]
+
+var indexed = {b: 1, 2: 2, a: 3};
+print(Object.keys(indexed), Object.values(indexed));
+// CHECK-NEXT: 2,b,a 2,1,3
+
+var hidden = make(6, 7);
+Object.defineProperty(hidden, 'h', {value: 8, enumerable: false});
+hidden[Symbol('s')] = 9;
+print(Object.keys(hidden), Object.values(hidden));
+// CHECK-NEXT: x,y 6,7
+
+var withGetter = {
+  get g() {
+    delete this.h;
+    return 5;
+  },
+  h: 1,
+};
+print(Object.keys(withGetter), Object.values(withGetter));
+// CHECK-NEXT: g,h 5
+
+function f() {}
+f.p = 1;
+print(Object.keys(f), Object.keys(f), Object.values(f));
+// CHECK-NEXT: p p 1
+print(Object.keys({}).length, Object.values({}).length);
+// CHECK-NEXT: 0 0
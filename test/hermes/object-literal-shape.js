@@ -0,0 +1,93 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Object literals with computed values are created with their final class,
+// and the values are stored in their slots afterwards.
+
+print('literal-shape');
+//CHECK-LABEL: literal-shape
+
+function show(o) {
+  var parts = [];
+  for (var k in o)
+    parts.push(k + ':' + o[k]);
+  return parts.join(',');
+}
+
+function make(x, y) {
+  return {a: x, b: 1, c: y, d: 'd'};
+}
+// The first execution creates the class, the next ones reuse it.
+print(show(make(1, 2)), show(make('x', undefined)));
+//CHECK-NEXT: a:1,b:1,c:2,d:d a:x,b:1,c:undefined,d:d
+var m1 = make(1, 2);
+var m2 = make(3, 4);
+m1.e = 5;
+print(show(m1), show(m2));
+//CHECK-NEXT: a:1,b:1,c:2,d:d,e:5 a:3,b:1,c:4,d:d
+
+// More properties than fit in the object itself.
+function big(v) {
+  return {p0: v, p1: 1, p2: v, p3: 3, p4: v, p5: 5, p6: v, p7: 7, p8: v};
+}
+big(0);
+print(show(big('v')));
+//CHECK-NEXT: p0:v,p1:1,p2:v,p3:3,p4:v,p5:5,p6:v,p7:7,p8:v
+
+// Numeric keys.
+function numeric(v) {
+  return {1: v, z: v, 0: 'zero'};
+}
+var n = numeric('n');
+print(show(n), n[1], Object.keys(n).join());
+//CHECK-NEXT: 0:zero,1:n,z:n n 0,1,z
+
+// A value that throws leaves no partially initialized object behind.
+function thrower(f) {
+  return {a: 1, b: f(), c: 3};
+}
+try {
+  thrower(function() {
+    throw new Error('thrown');
+  });
+} catch (e) {
+  print(e.message);
+}
+//CHECK-NEXT: thrown
+print(show(thrower(function() {
+  return 2;
+})));
+//CHECK-NEXT: a:1,b:2,c:3
+
+// Duplicate keys, accessors and references to the object itself.
+var self = {a: 1, b: 2, a: 3, get g() {
+  return this.b;
+}};
+print(show(self));
+//CHECK-NEXT: a:3,b:2,g:2
+function nested(v) {
+  var o = {x: v, y: 2};
+  o.self = o;
+  return o;
+}
+var ne = nested(7);
+print(ne.self === ne, ne.x, ne.y);
+//CHECK-NEXT: true 7 2
+
+// A setter on the prototype is not called by a literal.
+Object.defineProperty(Object.prototype, 'intercepted', {
+  set: function(v) {
+    print('set', v);
+  },
+  configurable: true,
+});
+function withSetter(v) {
+  return {intercepted: v, other: 2};
+}
+print(withSetter(1).intercepted, withSetter(2).other);
+//CHECK-NEXT: 1 2
+delete Object.prototype.intercepted;
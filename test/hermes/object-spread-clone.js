@@ -0,0 +1,97 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Object spread and Object.assign() into a new object share the class of a
+// plain source object, which must behave like copying the properties one at
+// a time.
+
+print('spread-clone');
+//CHECK-LABEL: spread-clone
+
+function show(o) {
+  var parts = [];
+  for (var k in o)
+    parts.push(k + ':' + o[k]);
+  return parts.join(',');
+}
+
+var small = {a: 1, b: 'x', c: null};
+var s = {...small};
+print(show(s), s !== small);
+//CHECK-NEXT: a:1,b:x,c:null true
+
+// Changes to the copy or the source don't affect the other.
+s.a = 2;
+s.d = 4;
+small.e = 5;
+print(show(s), show(small));
+//CHECK-NEXT: a:2,b:x,c:null,d:4 a:1,b:x,c:null,e:5
+
+// More properties than fit in the object itself.
+var big = {};
+for (var i = 0; i < 20; ++i)
+  big['p' + i] = i;
+var b = {...big};
+print(Object.keys(b).length, b.p0, b.p5, b.p6, b.p19);
+//CHECK-NEXT: 20 0 5 6 19
+b.p19 = 'changed';
+print(big.p19, Object.assign({}, big).p13);
+//CHECK-NEXT: 19 13
+
+// The usual immutable update.
+var state = {count: 1, name: 'n'};
+var next = {...state, count: state.count + 1};
+print(show(state), show(next));
+//CHECK-NEXT: count:1,name:n count:2,name:n
+
+// Index-like names and symbols are copied too.
+var sym = Symbol('s');
+var withIndex = {1: 'one', z: 'z'};
+withIndex[sym] = 'sym';
+var wi = {...withIndex};
+print(wi[1], wi.z, wi[sym], Object.keys(wi).join());
+//CHECK-NEXT: one z sym 1,z
+
+// Non-enumerable properties and accessors are not copied as such.
+var special = {v: 1};
+Object.defineProperty(special, 'hidden', {value: 2, enumerable: false});
+Object.defineProperty(special, 'g', {get: function() {
+  return 'got';
+}, enumerable: true});
+var sp = {...special};
+print(show(sp), sp.hidden, Object.getOwnPropertyDescriptor(sp, 'g').value);
+//CHECK-NEXT: v:1,g:got undefined got
+
+// A frozen source gives an unfrozen copy.
+var frozen = Object.freeze({f: 1});
+var fr = {...frozen};
+fr.f = 2;
+print(fr.f, Object.isFrozen(fr));
+//CHECK-NEXT: 2 false
+
+// Object.assign() goes through the setters of the prototype chain.
+Object.defineProperty(Object.prototype, 'intercepted', {
+  set: function(v) {
+    print('set', v);
+  },
+  configurable: true,
+});
+var target = Object.assign({}, {intercepted: 1, other: 2});
+//CHECK-NEXT: set 1
+print(target.hasOwnProperty('intercepted'), target.other);
+//CHECK-NEXT: false 2
+var copy = {...{intercepted: 3}};
+print(Object.getOwnPropertyDescriptor(copy, 'intercepted').value);
+//CHECK-NEXT: 3
+delete Object.prototype.intercepted;
+var protoSrc = JSON.parse('{"__proto__": 5}');
+print(Object.getPrototypeOf(Object.assign({}, protoSrc)) === Object.prototype);
+//CHECK-NEXT: true
+
+// Copying into an object that already has properties.
+print(show(Object.assign({x: 0}, small)), show({x: 0, ...small}));
+//CHECK-NEXT: x:0,a:1,b:x,c:null,e:5 x:0,a:1,b:x,c:null,e:5
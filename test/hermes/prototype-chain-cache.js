@@ -0,0 +1,72 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Exercise the prototype chain property cache and make sure that every kind of
+// change to the chain invalidates it.
+
+function getM(obj) {
+  return obj.m;
+}
+
+function Base() {}
+Base.prototype.m = "base";
+function Derived() {}
+Derived.prototype = Object.create(Base.prototype);
+
+var d = new Derived();
+print(getM(d), getM(d));
+// CHECK: base base
+
+// Shadow the property in an intermediate prototype.
+Derived.prototype.m = "derived";
+print(getM(d));
+// CHECK-NEXT: derived
+delete Derived.prototype.m;
+print(getM(d));
+// CHECK-NEXT: base
+
+// Change the value in the holder.
+Base.prototype.m = "base2";
+print(getM(d));
+// CHECK-NEXT: base2
+
+// Turn the property into an accessor.
+Object.defineProperty(Base.prototype, "m", {
+  get: function() {
+    return "getter";
+  },
+  configurable: true,
+});
+print(getM(d));
+// CHECK-NEXT: getter
+Object.defineProperty(Base.prototype, "m", {value: "base3"});
+print(getM(d), getM(d));
+// CHECK-NEXT: base3 base3
+
+// Swap the prototype of an object without changing its class.
+var other = Object.create(Derived.prototype);
+var p1 = {m: "p1"};
+var p2 = {m: "p2"};
+var o = Object.create(p1);
+print(getM(o), getM(other));
+// CHECK-NEXT: p1 base3
+Object.setPrototypeOf(o, p2);
+print(getM(o));
+// CHECK-NEXT: p2
+
+// Shadow the property on the receiver itself.
+o.m = "own";
+print(getM(o));
+// CHECK-NEXT: own
+
+// Remove the property entirely.
+var q = Object.create({m: "q"});
+print(getM(q));
+// CHECK-NEXT: q
+delete Object.getPrototypeOf(q).m;
+print(getM(q));
+// CHECK-NEXT: undefined
@@ -0,0 +1,72 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O -Xquickening-threshold=2 %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -Xquickening-threshold=1 %s | %FileCheck --match-full-lines %s
+
+print('quickening');
+// CHECK-LABEL: quickening
+
+function arith(a, b) {
+  return [a + b, a - b, a * b, a / b];
+}
+
+function less(a, b) {
+  return a < b ? "lt" : "ge";
+}
+
+function greaterEqual(a, b) {
+  return a >= b ? "ge" : "lt";
+}
+
+// Warm up with numbers, then switch to other types.
+for (var i = 0; i < 10; ++i) {
+  arith(i, 2);
+  less(i, 5);
+  greaterEqual(i, 5);
+}
+print(arith(6, 2));
+// CHECK-NEXT: 8,4,12,3
+print(arith("6", 2));
+// CHECK-NEXT: 62,4,12,3
+print(arith(6, "2"));
+// CHECK-NEXT: 62,4,12,3
+print(arith({valueOf: function() { return 6; }}, 2));
+// CHECK-NEXT: 8,4,12,3
+print(arith(6, 2));
+// CHECK-NEXT: 8,4,12,3
+print(less(1, 2), less(2, 1), less(NaN, 1), less("a", "b"), less("b", "a"));
+// CHECK-NEXT: lt ge ge lt ge
+print(greaterEqual(1, 2), greaterEqual(2, 2), greaterEqual(NaN, 1));
+// CHECK-NEXT: lt ge lt
+print(greaterEqual("b", "a"), greaterEqual(3, 2));
+// CHECK-NEXT: ge ge
+
+// A function that is quickened while it is on the stack keeps running in the
+// original bytecode, and exceptions thrown there are still caught.
+function recurse(n) {
+  try {
+    if (n > 0)
+      return recurse(n - 1) + n;
+    throw new Error("bottom");
+  } catch (e) {
+    if (n > 0)
+      throw e;
+    return 0;
+  }
+}
+print(recurse(5));
+// CHECK-NEXT: 15
+function recurseThrow(n) {
+  if (n > 0)
+    return recurseThrow(n - 1) + n;
+  throw new Error("bottom");
+}
+try {
+  recurseThrow(5);
+} catch (e) {
+  print(e.message);
+}
+// CHECK-NEXT: bottom
@@ -0,0 +1,31 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// RegExps created from the same dynamic pattern reuse its compiled bytecode.
+
+print('regexp-cache');
+// CHECK-LABEL: regexp-cache
+function stats() {
+  var s = HermesInternal.getInstrumentedStats();
+  return [s.js_regExpCacheHits, s.js_regExpCacheMisses];
+}
+var before = stats();
+var pattern = 'item-' + '(\\d+)';
+var re1 = new RegExp(pattern, 'g');
+var re2 = new RegExp(pattern, 'g');
+var re3 = new RegExp(pattern, 'i');
+var after = stats();
+print(after[0] - before[0], after[1] - before[1]);
+// CHECK-NEXT: 1 2
+print(re2.exec('x item-42')[1], re3.test('ITEM-7'), re1.global);
+// CHECK-NEXT: 42 true true
+try {
+  new RegExp('(');
+} catch (e) {
+  print(e.message);
+}
+// CHECK-NEXT: Invalid RegExp pattern: Parenthesized expression not closed
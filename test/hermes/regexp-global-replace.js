@@ -0,0 +1,61 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Global replace and match with the builtin exec run without match arrays.
+
+print('regexp-global-replace');
+// CHECK-LABEL: regexp-global-replace
+print('a1b22c333'.replace(/(\d)(\d)?/g, '[$1|$2|$&]'));
+// CHECK-NEXT: a[1||1]b[2|2|22]c[3|3|33][3||3]
+print('abc'.replace(/x*/g, '-'));
+// CHECK-NEXT: -a-b-c-
+print('x-y-z'.replace(/-/g, '$$'), 'abc'.replace(/b/g, "[$`$']"));
+// CHECK-NEXT: x$y$z a[ac]c
+print('héllo wörld'.replace(/ö|é/g, '$&$&') ===
+      'hééllo wöörld');
+// CHECK-NEXT: true
+
+print('k1=v1;k2=v2'.replace(/(\w+)=(\w+)/g, function(m, k, v, pos, s) {
+  return v + '=' + k + '@' + pos + '/' + s.length;
+}));
+// CHECK-NEXT: v1=k1@0/11;v2=k2@6/11
+print('ab'.replace(/(a)|(b)/g, function(m, p1, p2) {
+  return String(p1) + String(p2);
+}));
+// CHECK-NEXT: aundefinedundefinedb
+try {
+  'aa'.replace(/a/g, function() {
+    throw new Error('boom');
+  });
+} catch (e) {
+  print(e.message);
+}
+// CHECK-NEXT: boom
+
+var re = /a/g;
+re.lastIndex = 3;
+print('aaa'.replace(re, 'b'), re.lastIndex);
+// CHECK-NEXT: bbb 0
+print('aa'.replace(re, function() {
+  re.lastIndex = 7;
+  return 'x';
+}), re.lastIndex);
+// CHECK-NEXT: xx 7
+
+var execCount = 0;
+var re2 = /o/g;
+re2.exec = function(s) {
+  execCount++;
+  return RegExp.prototype.exec.call(this, s);
+};
+print('foo'.replace(re2, '0'), execCount);
+// CHECK-NEXT: f00 3
+
+print('a1b22'.match(/\d/g).join(), 'xyz'.match(/\d/g));
+// CHECK-NEXT: 1,2,2 null
+print('abc'.match(/x*/g).length);
+// CHECK-NEXT: 4
@@ -0,0 +1,56 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -emit-binary -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+
+// Regexes with loops over more than a single character, but without
+// backreferences or lookaheads, are matched without backtracking. Check that
+// they still find the matches the backtracker would, and that inputs which
+// make the backtracker go exponential stay fast.
+
+print('pathological');
+// CHECK-LABEL: pathological
+var s = 'a'.repeat(40) + '!';
+print(/(a|a)*b/.test(s));
+// CHECK-NEXT: false
+print(/(a+)+b/.test(s));
+// CHECK-NEXT: false
+print(/^(?:a|aa)+$/.test(s));
+// CHECK-NEXT: false
+print(/(?:a+)*b/.exec(s + 'b'));
+// CHECK-NEXT: b
+
+print('captures');
+// CHECK-LABEL: captures
+print(/(a|ab)(c|bcd)(d*)/.exec('abcd'));
+// CHECK-NEXT: abcd,a,bcd,
+print(JSON.stringify(/(?:(a)|(b))+/.exec('ab')));
+// CHECK-NEXT: ["ab",null,"b"]
+print(JSON.stringify(/(z)((a+)?(b+)?(c))*/.exec('zaacbbbcac')));
+// CHECK-NEXT: ["zaacbbbcac","z","ac","a",null,"c"]
+print(/(\w+?)(\d*)x/.exec('--ab12x'));
+// CHECK-NEXT: ab12x,ab,12
+
+print('loops');
+// CHECK-LABEL: loops
+print(/a{2,3}?b/.exec('aaaab'));
+// CHECK-NEXT: aaab
+print(/x(?:ab)*?y/.exec('xababy'));
+// CHECK-NEXT: xababy
+print(/\d{2}-\d{2}/.exec('1-234-56'));
+// CHECK-NEXT: 34-56
+print(/(?:ab)?c+/.exec('abacc'));
+// CHECK-NEXT: cc
+
+print('assertions');
+// CHECK-LABEL: assertions
+print(/^\w+$/m.exec('a b\ncd\nef g'));
+// CHECK-NEXT: cd
+print(/\b\w+\b/.exec('  hello world'));
+// CHECK-NEXT: hello
+var re = /o+/g;
+print(re.exec('foo boo'), re.lastIndex, re.exec('foo boo'), re.lastIndex);
+// CHECK-NEXT: oo 3 oo 7
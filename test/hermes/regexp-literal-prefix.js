@@ -0,0 +1,50 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -emit-binary -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+
+// Searches for regexps that start with a literal only try to match where the
+// literal occurs.
+
+print('regexp-literal-prefix');
+// CHECK-LABEL: regexp-literal-prefix
+
+print(/foo\d+/.exec('fo foo foo123 foo4'));
+// CHECK-NEXT: foo123
+print(JSON.stringify(/error: (.*)/.exec('ok\nerror: disk full\nerror: again')));
+// CHECK-NEXT: ["error: disk full","disk full"]
+
+// Overlapping candidates.
+print(/aab/.exec('aaab').index, /abab/.exec('abababab').index);
+// CHECK-NEXT: 1 0
+
+// The prefix continues through capture groups, but not past a quantifier.
+print(JSON.stringify(/(ab)(c)d?x/.exec('abcabcxabcd')));
+// CHECK-NEXT: ["abcx","ab","c"]
+print(/ab*c/.exec('xxacabbbc'));
+// CHECK-NEXT: ac
+
+// Patterns without a literal prefix are unaffected.
+print(/foo|bar/.exec('xbar'), /a*b/.exec('caab'), /FOO/i.exec('xfoo'));
+// CHECK-NEXT: bar aab foo
+
+// Prefixes longer than the part kept in the bytecode.
+print(/abcdefghijkl/.exec('abcdefghijk abcdefghijkl').index);
+// CHECK-NEXT: 12
+
+// Prefixes that are not ASCII, in ASCII and UTF-16 inputs.
+print(/été/.exec('ete'), /été/.exec('l’été').index);
+// CHECK-NEXT: null 2
+
+// No match, a match at the very end, and global searches.
+print(/xyz/.exec('xyxyxy'), /xyz/.exec('aaxyz').index);
+// CHECK-NEXT: null 2
+print('a1 b2 a3 a44'.match(/a\d+/g).join());
+// CHECK-NEXT: a1,a3,a44
+var global = /ab/g;
+global.lastIndex = 1;
+print(global.exec('abxab').index, global.exec('abxab'));
+// CHECK-NEXT: 3 null
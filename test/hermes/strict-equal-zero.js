@@ -0,0 +1,32 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes %s | %FileCheck --match-full-lines %s
+
+function isZero(a) {
+  if (a === 0)
+    return "yes";
+  return "no";
+}
+
+function isNotZero(a) {
+  if (0 !== a)
+    return "yes";
+  return "no";
+}
+
+print('strict-equal-zero');
+// CHECK-LABEL: strict-equal-zero
+print(isZero(0), isZero(-0), isZero(1), isZero(NaN));
+// CHECK-NEXT: yes yes no no
+print(isZero("0"), isZero(false), isZero(null), isZero(undefined));
+// CHECK-NEXT: no no no no
+print(isZero(new Number(0)), isZero(Number.MIN_VALUE));
+// CHECK-NEXT: no no
+print(isNotZero(0), isNotZero(-0), isNotZero(1), isNotZero(NaN));
+// CHECK-NEXT: no no yes yes
+print(isNotZero("0"), isNotZero(false), isNotZero(null), isNotZero({}));
+// CHECK-NEXT: yes yes yes yes
@@ -287,6 +287,13 @@ print('A\u180e\u03a3\u180e'.toLowerCase() === 'a\u180e\u03c2\u180e');
 // CHECK-NEXT: true
 print('A\u180e\u03a3\u180eB'.toLowerCase() === 'a\u180e\u03c3\u180eb');
 // CHECK-NEXT: true
+var s = 'The Quick Brown Fox @[Jumps]` Over The Lazy Dog';
+print(s.toLowerCase());
+// CHECK-NEXT: the quick brown fox @[jumps]` over the lazy dog
+print(s.toLowerCase().toLowerCase() === s.toLowerCase());
+// CHECK-NEXT: true
+print(('\u0100' + s).substring(1).toLowerCase());
+// CHECK-NEXT: the quick brown fox @[jumps]` over the lazy dog
 
 print('toLocaleLowerCase');
 // CHECK-LABEL: toLocaleLowerCase
@@ -328,6 +335,11 @@ print(result.length);
 // CHECK-NEXT: 200
 print(Array.prototype.every.call(result, function(c) {return c === 'S';}));
 // CHECK-NEXT: true
+var s = 'The Quick Brown Fox @[Jumps]` {Over} The Lazy Dog';
+print(s.toUpperCase());
+// CHECK-NEXT: THE QUICK BROWN FOX @[JUMPS]` {OVER} THE LAZY DOG
+print(('\u0100' + s).substring(1).toUpperCase());
+// CHECK-NEXT: THE QUICK BROWN FOX @[JUMPS]` {OVER} THE LAZY DOG
 
 print('toLocaleUpperCase');
 // CHECK-LABEL: toLocaleUpperCase
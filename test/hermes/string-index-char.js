@@ -0,0 +1,36 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Indexing strings and charAt() return single-character strings, which come
+// from a table for Latin-1 characters.
+
+var s = "a\xe9Āz";
+function at(str, i) {
+  return str[i];
+}
+print(at(s, 0), at(s, 1), at(s, 3), at(s, 4), at(s, -1), at(s, 1.5));
+// CHECK: a é z undefined undefined undefined
+print(at(s, 2) === "Ā", at(s, 0) === "a", at(s, "3"));
+// CHECK-NEXT: true true z
+
+var out = [];
+for (var i = 0; i < s.length; ++i)
+  out.push(s[i].charCodeAt(0));
+print(out.join());
+// CHECK-NEXT: 97,233,256,122
+
+print(s.charAt(0), s.charAt(1.9), s.charAt(3), s.charAt(2) === "Ā");
+// CHECK-NEXT: a é z true
+print(
+  JSON.stringify(s.charAt(4)),
+  JSON.stringify(s.charAt(-0.5)),
+  s.charAt(NaN),
+  s.charAt(),
+  s.charAt("1"));
+// CHECK-NEXT: "" "a" a a é
+print(String.prototype.charAt.call(12345, 2));
+// CHECK-NEXT: 3
@@ -0,0 +1,38 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Long strings built by concatenation are ropes, which are flattened when
+// their characters are first needed. Check that they behave like any string.
+print('string rope');
+// CHECK-LABEL: string rope
+
+var s = '';
+for (var i = 0; i < 5000; ++i) {
+    s += i % 10;
+}
+print(s.length, s.charAt(4321), s.indexOf('789012'), s.slice(-3));
+// CHECK-NEXT: 5000 1 7 789
+
+var t = '';
+for (var i = 0; i < 5000; ++i) {
+    t = t.concat(String(i % 10));
+}
+print(s === t, s < t + 'a', s.substring(0, 12));
+// CHECK-NEXT: true true 012345678901
+
+var u = '';
+for (var i = 0; i < 200; ++i) {
+    u = (i % 2 ? 'é' : 'e') + u;
+}
+print(u.length, u.charCodeAt(0), u.charCodeAt(199), u.lastIndexOf('ee'));
+// CHECK-NEXT: 200 233 101 -1
+
+var obj = {};
+var key = s.slice(0, 100) + s.slice(100, 300);
+obj[key] = 'found';
+print(obj[s.substring(0, 300)], JSON.stringify(key).length);
+// CHECK-NEXT: found 302
@@ -0,0 +1,84 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Substring searches scan for the first character of the needle. Check them
+// on every combination of ASCII and UTF-16 strings.
+print('indexOf');
+// CHECK-LABEL: indexOf
+var ascii = 'abcabcabd';
+var utf16 = 'abcābcabdā';
+print(ascii.indexOf('abd'), ascii.indexOf('abc', 1), ascii.indexOf('abe'));
+// CHECK-NEXT: 6 3 -1
+print(ascii.indexOf('ā'), ascii.indexOf('dā'), ascii.indexOf(''));
+// CHECK-NEXT: -1 -1 0
+print(utf16.indexOf('bc'), utf16.indexOf('ābc'), utf16.indexOf('dā'));
+// CHECK-NEXT: 1 3 8
+print(utf16.indexOf('abd', 7), utf16.indexOf('', 100), ascii.indexOf('d', 8));
+// CHECK-NEXT: -1 10 8
+print(ascii.indexOf('abcabcabdx'), ascii.indexOf('abcabcabd'));
+// CHECK-NEXT: -1 0
+
+print('lastIndexOf');
+// CHECK-LABEL: lastIndexOf
+print(ascii.lastIndexOf('abc'), ascii.lastIndexOf('abc', 5));
+// CHECK-NEXT: 3 3
+print(ascii.lastIndexOf('abc', 2), ascii.lastIndexOf('abc', -5));
+// CHECK-NEXT: 0 0
+print(ascii.lastIndexOf('b', 0), ascii.lastIndexOf(''));
+// CHECK-NEXT: -1 9
+print(ascii.lastIndexOf('', 4), ascii.lastIndexOf('', 100));
+// CHECK-NEXT: 4 9
+print(utf16.lastIndexOf('ā'), utf16.lastIndexOf('ā', 8));
+// CHECK-NEXT: 9 3
+print(utf16.lastIndexOf('ab'), ascii.lastIndexOf('ā'));
+// CHECK-NEXT: 6 -1
+
+print('includes');
+// CHECK-LABEL: includes
+print(ascii.includes('cab'), ascii.includes('cab', 6), ascii.includes(''));
+// CHECK-NEXT: true false true
+print(utf16.includes('āb'), utf16.includes('dā', 9));
+// CHECK-NEXT: true false
+print(ascii.includes('abd', 6), ascii.includes('abd', 7));
+// CHECK-NEXT: true false
+
+print('split');
+// CHECK-LABEL: split
+print(JSON.stringify('a,b,,c,'.split(',')));
+// CHECK-NEXT: ["a","b","","c",""]
+print(JSON.stringify(',a,b'.split(',', 2)));
+// CHECK-NEXT: ["","a"]
+print(JSON.stringify('a--b--c'.split('--')));
+// CHECK-NEXT: ["a","b","c"]
+print(JSON.stringify('a---b'.split('--')));
+// CHECK-NEXT: ["a","-b"]
+print(JSON.stringify('abc'.split('abc')), JSON.stringify('abc'.split('x')));
+// CHECK-NEXT: ["",""] ["abc"]
+print(JSON.stringify('a,b,c'.split(',', 0)), JSON.stringify('abc'.split('')));
+// CHECK-NEXT: [] ["a","b","c"]
+var parts = 'xāyāz'.split('ā');
+print(parts.length, parts[0], parts[1], parts[2]);
+// CHECK-NEXT: 3 x y z
+print('aāb'.split('b').length, 'aāb'.split('b')[1] === '');
+// CHECK-NEXT: 2 true
+
+print('replace');
+// CHECK-LABEL: replace
+print('aXbXc'.replace('X', '-'), 'abc'.replace('x', '-'));
+// CHECK-NEXT: a-bXc abc
+print('abc'.replace('', '-'), ''.replace('', '-'), ''.replace('a', '-') === '');
+// CHECK-NEXT: -abc - true
+print('abc'.replace('b', '[$&$`$\']'), 'abc'.replace('b', '$$'));
+// CHECK-NEXT: a[bac]c a$c
+print('abc'.replace('b', function(m, pos, s) { return m + pos + s; }));
+// CHECK-NEXT: ab1abcc
+var replaced = 'abāc'.replace('b', '');
+print(replaced.length, replaced.charCodeAt(1));
+// CHECK-NEXT: 3 257
+replaced = 'abc'.replace('b', 'āā');
+print(replaced.length, replaced.charCodeAt(2), replaced.charAt(3));
+// CHECK-NEXT: 4 257 c
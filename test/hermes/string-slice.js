@@ -0,0 +1,38 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Substrings and regexp captures may share the characters of their parent.
+// Check that they behave like any string.
+print('string slice');
+// CHECK-LABEL: string slice
+
+var src = '';
+for (var i = 0; i < 10; ++i) {
+    src += 'token' + i + ' = "value number ' + i + '";\n';
+}
+var line = src.slice(src.indexOf('token3'), src.indexOf('token4') - 1);
+print(line);
+// CHECK-NEXT: token3 = "value number 3";
+print(line.substring(10, 24), line.substr(-15).length, line.slice(-2, -1));
+// CHECK-NEXT: value number 3 15 "
+
+var m = /"(value number \d+)"/.exec(line);
+print(m[1], m[1].length, m[1] === 'value number 3');
+// CHECK-NEXT: value number 3 14 true
+
+var parts = src.split('\n');
+print(parts.length, parts[9].toUpperCase());
+// CHECK-NEXT: 11 TOKEN9 = "VALUE NUMBER 9";
+
+var obj = {};
+obj[line.slice(0, 19)] = 1;
+print(Object.keys(obj)[0], 'token3 = "value num' in obj);
+// CHECK-NEXT: token3 = "value num true
+
+var wide = 'ключ-значение, ключ-значение, ключ-значение';
+print(wide.slice(15, 28), wide.slice(15, 28).charCodeAt(0));
+// CHECK-NEXT: ключ-значение 1082
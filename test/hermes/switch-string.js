@@ -0,0 +1,102 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O0 %s | %FileCheck --match-full-lines %s
+
+// Switches on enough string cases look up interned strings in a hash table,
+// and compare other strings with each case.
+
+print('switch-string');
+//CHECK-LABEL: switch-string
+
+function reducer(action) {
+  var r;
+  switch (action) {
+    case 'add':
+      r = 1;
+      break;
+    case 'remove':
+      r = 2;
+      break;
+    case 'update':
+      r = 3;
+      break;
+    case 'reset':
+    case 'clear':
+      r = 4;
+      break;
+    case 'café':
+      r = 5;
+      break;
+    case '':
+      r = 6;
+      break;
+    default:
+      r = 0;
+  }
+  return r;
+}
+
+// Literals are interned.
+print(reducer('add'), reducer('remove'), reducer('update'), reducer('reset'),
+      reducer('clear'), reducer('café'), reducer(''), reducer('other'));
+//CHECK-NEXT: 1 2 3 4 4 5 6 0
+
+// Strings built at runtime are not.
+var parts = ['ad', 'rem', 'upd', 'caf', 'oth'];
+var tails = ['d', 'ove', 'ate', 'é', 'er'];
+var built = [];
+for (var i = 0; i < parts.length; ++i)
+  built.push(reducer(parts[i] + tails[i]));
+print(built.join());
+//CHECK-NEXT: 1,2,3,5,0
+print(reducer(String.fromCharCode(99, 108, 101, 97, 114)),
+      reducer('xupdatex'.slice(1, 7)));
+//CHECK-NEXT: 4 3
+
+// Property names are interned too.
+var names = Object.keys({add: 0, update: 0, missing: 0});
+print(names.map(reducer).join());
+//CHECK-NEXT: 1,3,0
+
+// Values that are not strings never match.
+print(reducer(undefined), reducer(null), reducer(1), reducer(new String('add')),
+      reducer({toString: function() {
+        return 'add';
+      }}));
+//CHECK-NEXT: 0 0 0 0 0
+
+// Many cases, with fallthrough.
+function many(s) {
+  var out = '';
+  switch (s) {
+    case 'k0': out += '0';
+    case 'k1': out += '1';
+    case 'k2': out += '2';
+      break;
+    case 'k3': out += '3';
+    case 'k4': out += '4';
+    case 'k5': out += '5';
+    case 'k6': out += '6';
+    case 'k7': out += '7';
+    case 'k8': out += '8';
+    case 'k9': out += '9';
+      break;
+    case 'k10': out += 'a';
+    case 'k11': out += 'b';
+    default: out += 'd';
+    case 'k12': out += 'c';
+  }
+  return out;
+}
+var res = [];
+for (var i = 0; i <= 13; ++i) {
+  res.push(many('k' + i));
+  res.push(many(['k0', 'k1', 'k2', 'k3', 'k4', 'k5', 'k6', 'k7', 'k8', 'k9',
+                 'k10', 'k11', 'k12', 'k13'][i]));
+}
+print(res.join());
+//CHECK-NEXT: 012,012,12,12,2,2,3456789,3456789,456789,456789,56789,56789,6789,6789,789,789,89,89,9,9,abdc,abdc,bdc,bdc,c,c,dc,dc
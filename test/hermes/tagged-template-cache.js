@@ -0,0 +1,45 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O0 %s | %FileCheck --match-full-lines %s
+// RUN: %hermesc -O -dump-bytecode %s | %FileCheck --match-full-lines --check-prefix=CHKBC %s
+
+function tag(strings) {
+  return strings;
+}
+
+function f(x) {
+  return tag`a${x}b\n`;
+}
+//CHKBC-LABEL:Function<f>({{.*}}):
+//CHKBC-NOT:    CallBuiltin {{.*}}
+//CHKBC:    GetTemplateObject r{{[0-9]+}}, {{[0-9]+}}, 5, {{[0-9]+}}
+//CHKBC:    Ret               r{{[0-9]+}}
+
+print('tagged template cache');
+//CHECK-LABEL: tagged template cache
+
+var t1 = f(1);
+var t2 = f(2);
+print(t1 === t2, Object.isFrozen(t1), Object.isFrozen(t1.raw));
+//CHECK-NEXT: true true true
+print(t1.length, JSON.stringify(t1), JSON.stringify(t1.raw));
+//CHECK-NEXT: 2 ["a","b\n"] ["a","b\\n"]
+
+// Templates with the same raw strings share the template object.
+function g() {
+  return tag`a${0}b\n`;
+}
+print(g() === t1);
+//CHECK-NEXT: true
+
+// Cooked strings which are the same as the raw strings.
+function h() {
+  return tag`x${0}y${1}`;
+}
+var t3 = h();
+print(t3 === h(), t3.length, t3.raw.length, t3.join(), t3.raw.join());
+//CHECK-NEXT: true 3 3 x,y, x,y,
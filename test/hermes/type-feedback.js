@@ -0,0 +1,38 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O -Xquickening-threshold=1 -type-feedback-file=%t.json %s | %FileCheck --match-full-lines %s
+// RUN: cat %t.json | %FileCheck --match-full-lines --check-prefix=FEEDBACK %s
+// RUN: %hermesc -O -dump-bytecode -type-feedback=%t.json %s | %FileCheck --match-full-lines --check-prefix=BC %s
+
+// The VM writes the instructions which are still quickened at exit: the Add
+// of add() only saw numbers, while the Sub of sub() saw a string and was
+// restored. Compiling with that feedback emits the quickened Add directly.
+
+print('type-feedback');
+// CHECK-LABEL: type-feedback
+
+function add(a, b) {
+  return a + b;
+}
+
+function sub(a, b) {
+  return a - b;
+}
+
+for (var i = 0; i < 5; ++i) {
+  add(i, 1);
+  sub(i, 1);
+}
+print(add(1, 2), sub("5", 1));
+// CHECK-NEXT: 3 4
+
+// The Add is at offset 6 of add(), function 1, after two 3-byte LoadParam.
+// FEEDBACK: {"functions":[{{.*}}{"function_id":1,"number_sites":[6]}{{.*}}]}
+
+// BC-LABEL: Function<add>(3 params, {{[0-9]+}} registers, 0 symbols):
+// BC:     AddQuick          {{r[0-9]+}}, {{r[0-9]+}}, {{r[0-9]+}}
+// BC-LABEL: Function<sub>(3 params, {{[0-9]+}} registers, 0 symbols):
+// BC:     Sub               {{r[0-9]+}}, {{r[0-9]+}}, {{r[0-9]+}}
@@ -0,0 +1,107 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Comparisons of typeof with a literal are tested without creating the type
+// string, and instanceof caches the "prototype" property of functions.
+
+print('typeof-instanceof');
+//CHECK-LABEL: typeof-instanceof
+
+var values = [undefined, null, {}, [], 'str', Symbol('s'), true, 1.5, 3,
+              function() {}, Object, Math.max, new Proxy(function() {}, {})];
+
+function types(v) {
+  return [typeof v === 'undefined', typeof v === 'object',
+          typeof v === 'string', typeof v === 'symbol',
+          typeof v === 'boolean', typeof v === 'number',
+          typeof v === 'function'].map(Number).join('');
+}
+print(values.map(types).join());
+//CHECK-NEXT: 1000000,0100000,0100000,0100000,0010000,0001000,0000100,0000010,0000010,0000001,0000001,0000001,0000001
+
+// Loose and negated comparisons, with the literal on either side.
+function loose(v) {
+  return [typeof v == 'object', 'number' == typeof v, typeof v !== 'string',
+          'function' != typeof v].join();
+}
+print(loose(null), loose(2), loose('s'), loose(print));
+//CHECK-NEXT: true,false,true,true false,true,true,true false,false,false,true false,false,true,false
+
+// Comparisons used as branch conditions.
+function branch(v) {
+  if (typeof v !== 'number')
+    return 'not number';
+  if ('string' != typeof v)
+    return 'number';
+  return 'unreachable';
+}
+print(branch(1), branch('1'), branch(undefined));
+//CHECK-NEXT: number not number not number
+
+// Strings that typeof never returns, and the typeof result used elsewhere.
+function other(v) {
+  var t = typeof v;
+  return [t === 'foo', typeof v === 'Object', t === 'object', t].join();
+}
+print(other({}), other(undefined));
+//CHECK-NEXT: false,false,true,object false,false,false,undefined
+print(typeof undeclaredVariable === 'undefined');
+//CHECK-NEXT: true
+
+function A() {}
+function B() {}
+B.prototype = Object.create(A.prototype);
+var a = new A();
+var b = new B();
+
+function isA(v) {
+  return v instanceof A;
+}
+var results = [];
+for (var i = 0; i < 3; ++i)
+  results.push(isA(a), isA(b), isA({}), isA(1), isA(null));
+print(results.join());
+//CHECK-NEXT: true,true,false,false,false,true,true,false,false,false,true,true,false,false,false
+
+// Replacing the prototype is seen by later checks.
+A.prototype = {};
+print(isA(a), isA(b), isA(Object.create(A.prototype)));
+//CHECK-NEXT: false false true
+
+// Other constructors at the same site.
+function check(v, C) {
+  return v instanceof C;
+}
+print(check([], Array), check([], Object), check(b, B), check(a, B),
+      check(print, Function), check(b, B.bind(null)));
+//CHECK-NEXT: true true true false true true
+
+// Symbol.hasInstance is honored.
+function Anything() {}
+Object.defineProperty(Anything, Symbol.hasInstance, {value: function() {
+  return true;
+}});
+print(check(1, Anything), check(a, B));
+//CHECK-NEXT: true false
+
+// A prototype that is not an object throws.
+function Bad() {}
+Bad.prototype = 5;
+try {
+  check({}, Bad);
+} catch (e) {
+  print(e.constructor.name);
+}
+//CHECK-NEXT: TypeError
+print(check(5, Bad));
+//CHECK-NEXT: false
+try {
+  check({}, {});
+} catch (e) {
+  print(e.constructor.name);
+}
+//CHECK-NEXT: TypeError
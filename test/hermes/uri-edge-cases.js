@@ -0,0 +1,152 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O -target=HBC %s | %FileCheck --match-full-lines %s
+"use strict";
+
+// Longer than a block of letters and digits, so that runs are skipped in
+// blocks before and after the interesting characters.
+var A = 'abcdefghijklmnopqrstuvwxyz0123456789';
+
+function tryPrint(f, s) {
+  try {
+    print(f(s));
+  } catch (e) {
+    print(e.name);
+  }
+}
+
+function codes(s) {
+  var res = [];
+  for (var i = 0; i < s.length; ++i) {
+    res.push(s.charCodeAt(i));
+  }
+  return res.join(' ');
+}
+
+print('empty');
+// CHECK-LABEL: empty
+print(JSON.stringify([
+  encodeURI(''),
+  encodeURIComponent(''),
+  decodeURI(''),
+  decodeURIComponent(''),
+  escape(''),
+  unescape(''),
+]));
+// CHECK-NEXT: ["","","","","",""]
+
+print('runs');
+// CHECK-LABEL: runs
+print(encodeURI(A) === A, decodeURI(A) === A);
+// CHECK-NEXT: true true
+print(encodeURIComponent(A + ' ' + A) === A + '%20' + A);
+// CHECK-NEXT: true
+print(decodeURIComponent(A + '%20' + A) === A + ' ' + A);
+// CHECK-NEXT: true
+print(encodeURIComponent("-_.!~*'()"));
+// CHECK-NEXT: -_.!~*'()
+
+print('surrogate pairs');
+// CHECK-LABEL: surrogate pairs
+print(encodeURI('\ud800\udc00'));
+// CHECK-NEXT: %F0%90%80%80
+print(encodeURIComponent('\udbff\udfff'));
+// CHECK-NEXT: %F4%8F%BF%BF
+// The pair straddles two blocks of UTF-16 characters.
+print(encodeURI('abcdefg\ud83d\ude00h'));
+// CHECK-NEXT: abcdefg%F0%9F%98%80h
+print(encodeURIComponent(A + '\ud83d\ude00' + A) === A + '%F0%9F%98%80' + A);
+// CHECK-NEXT: true
+print(codes(decodeURI('%F0%90%80%80')));
+// CHECK-NEXT: 55296 56320
+print(codes(decodeURIComponent('%F4%8F%BF%BF')));
+// CHECK-NEXT: 56319 57343
+print(decodeURIComponent(A + '%F0%9F%98%80' + A) === A + '\ud83d\ude00' + A);
+// CHECK-NEXT: true
+
+print('lone surrogates');
+// CHECK-LABEL: lone surrogates
+tryPrint(encodeURI, '\ud800');
+// CHECK-NEXT: URIError
+tryPrint(encodeURI, A + '\ud800');
+// CHECK-NEXT: URIError
+tryPrint(encodeURIComponent, A + '\ud800a');
+// CHECK-NEXT: URIError
+tryPrint(encodeURIComponent, A + '\udfff' + A);
+// CHECK-NEXT: URIError
+tryPrint(encodeURI, '\udc00\ud800');
+// CHECK-NEXT: URIError
+tryPrint(encodeURI, '\ud800\ud800\udc00');
+// CHECK-NEXT: URIError
+
+print('invalid escapes');
+// CHECK-LABEL: invalid escapes
+tryPrint(decodeURI, '%');
+// CHECK-NEXT: URIError
+tryPrint(decodeURI, A + '%');
+// CHECK-NEXT: URIError
+tryPrint(decodeURIComponent, A + '%4');
+// CHECK-NEXT: URIError
+tryPrint(decodeURIComponent, '%4g');
+// CHECK-NEXT: URIError
+tryPrint(decodeURIComponent, '%80');
+// CHECK-NEXT: URIError
+tryPrint(decodeURIComponent, '%E2%82');
+// CHECK-NEXT: URIError
+tryPrint(decodeURIComponent, '%E2%82%2C');
+// CHECK-NEXT: URIError
+tryPrint(decodeURIComponent, '%E2%82AC');
+// CHECK-NEXT: URIError
+tryPrint(decodeURIComponent, '%F8%88%80%80%80');
+// CHECK-NEXT: URIError
+tryPrint(decodeURIComponent, '%FF');
+// CHECK-NEXT: URIError
+print(codes(decodeURIComponent('%E2%82%AC')));
+// CHECK-NEXT: 8364
+print(codes(decodeURIComponent('%c3%a9')));
+// CHECK-NEXT: 233
+
+print('overlong and out of range');
+// CHECK-LABEL: overlong and out of range
+tryPrint(decodeURIComponent, '%C0%AF');
+// CHECK-NEXT: URIError
+tryPrint(decodeURIComponent, '%C1%BF');
+// CHECK-NEXT: URIError
+tryPrint(decodeURIComponent, '%E0%80%AF');
+// CHECK-NEXT: URIError
+tryPrint(decodeURIComponent, '%F0%80%80%AF');
+// CHECK-NEXT: URIError
+// An encoded surrogate.
+tryPrint(decodeURI, '%ED%A0%80');
+// CHECK-NEXT: URIError
+// Past U+10FFFF.
+tryPrint(decodeURI, '%F4%90%80%80');
+// CHECK-NEXT: URIError
+// The same, in UTF-16 strings.
+tryPrint(decodeURIComponent, '\u00e9%C0%AF');
+// CHECK-NEXT: URIError
+print(codes(decodeURIComponent('\u00e9%C3%A9')));
+// CHECK-NEXT: 233 233
+
+print('reserved');
+// CHECK-LABEL: reserved
+print(encodeURI(';/?:@&=+$,#'));
+// CHECK-NEXT: ;/?:@&=+$,#
+print(encodeURIComponent(';/?:@&=+$,#'));
+// CHECK-NEXT: %3B%2F%3F%3A%40%26%3D%2B%24%2C%23
+print(decodeURI('%3B%2F%3F%3A%40%26%3D%2B%24%2C%23'));
+// CHECK-NEXT: %3B%2F%3F%3A%40%26%3D%2B%24%2C%23
+print(decodeURIComponent('%3B%2F%3F%3A%40%26%3D%2B%24%2C%23'));
+// CHECK-NEXT: ;/?:@&=+$,#
+// The escapes are kept as written.
+print(decodeURI('%3b%2f'));
+// CHECK-NEXT: %3b%2f
+print(decodeURI('a%3Bb%20c%23d'));
+// CHECK-NEXT: a%3Bb c%23d
+print(decodeURI(A + '%2F' + A) === A + '%2F' + A);
+// CHECK-NEXT: true
+print(codes(decodeURI('\u00e9%3B%20')));
+// CHECK-NEXT: 233 37 51 66 32
@@ -128,3 +128,28 @@ print(m.get(a));
 // Ensure some reuse occurred.
 print(HermesInternal.getWeakSize(m) < 10000);
 // CHECK-NEXT: true
+
+print('shrink');
+// CHECK-LABEL: shrink
+// The map is rebuilt once most of its keys have died, keeping the live ones.
+var live = [];
+var m = new WeakMap();
+for (var i = 0; i < 10; ++i) {
+  live.push({i: i});
+  m.set(live[i], i);
+}
+(function() {
+  for (var i = 0; i < 10000; ++i) {
+    m.set({}, i);
+  }
+})();
+gc();
+m.set({}, 0);
+gc();
+m.set({}, 0);
+var sum = 0;
+for (var i = 0; i < 10; ++i) {
+  sum += m.get(live[i]);
+}
+print(sum, HermesInternal.getWeakSize(m) < 100);
+// CHECK-NEXT: 45 true
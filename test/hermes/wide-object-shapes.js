@@ -0,0 +1,53 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+"use strict";
+
+print('wide object shapes');
+// CHECK-LABEL: wide object shapes
+
+// Records wider than the large class threshold, built the same way several
+// times.
+function makeRecord(base) {
+    var rec = {};
+    for (var i = 0; i < 80; ++i)
+        rec['f' + i] = base + i;
+    return rec;
+}
+
+var sum = 0;
+for (var n = 0; n < 5; ++n) {
+    var rec = makeRecord(n * 100);
+    sum += rec.f0 + rec.f40 + rec.f79;
+}
+print(sum);
+// CHECK-NEXT: 3595
+print(Object.keys(makeRecord(0)).length, makeRecord(0).f79);
+// CHECK-NEXT: 80 79
+
+// A prototype that went to dictionary mode while it was set up, and is then
+// used to construct objects.
+function Point(x, y) {
+    this.x = x;
+    this.y = y;
+}
+Point.prototype.tmp = 1;
+Point.prototype.norm1 = function() {
+    return Math.abs(this.x) + Math.abs(this.y);
+};
+delete Point.prototype.tmp;
+Point.prototype.scale = function(k) {
+    return new Point(this.x * k, this.y * k);
+};
+
+var p = new Point(1, -2);
+print(p.norm1(), p.scale(3).norm1(), 'tmp' in p);
+// CHECK-NEXT: 3 9 false
+print(Object.keys(Point.prototype).join());
+// CHECK-NEXT: norm1,scale
+Point.prototype.extra = 5;
+print(new Point(0, 0).extra);
+// CHECK-NEXT: 5
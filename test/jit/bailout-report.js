@@ -0,0 +1,20 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+/*
+RUN: %hermes -O -jit -jit-report-bailouts %s 2>&1 \
+RUN:     | %FileCheck --match-full-lines %s
+REQUIRES: jit
+*/
+
+function remove(o) {
+  delete o.x;
+  return o;
+}
+
+print(remove({x: 1}).x);
+
+// CHECK: JIT bailout in FunctionID {{[0-9]+}} (remove): unsupported opcode {{[0-9]+}} DelById
+// CHECK: undefined
@@ -0,0 +1,37 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+/*
+RUN: %hermes -O -jit %s | %FileCheck --match-full-lines %s
+REQUIRES: jit
+*/
+
+// Bitwise operations and shifts of int32 numbers are done inline, and every
+// other operand goes through the slow path.
+function ops(a, b) {
+  return [a & b, a | b, a ^ b, a << b, a >> b, a >>> b, ~a].join();
+}
+
+function hash(s) {
+  var h = 5381;
+  for (var i = 0; i < s.length; ++i)
+    h = ((h << 5) + h) ^ s.charCodeAt(i);
+  return h >>> 0;
+}
+
+print(ops(12, 10));
+// CHECK: 8,14,6,12288,0,0,-13
+print(ops(-1, 31));
+// CHECK-NEXT: 31,-1,-32,-2147483648,-1,1,0
+print(ops(-8, 33));
+// CHECK-NEXT: 32,-7,-39,-16,-4,2147483644,7
+print(ops(2147483648, 1));
+// CHECK-NEXT: 0,-2147483647,-2147483647,0,-1073741824,1073741824,2147483647
+print(ops(NaN, 1.5));
+// CHECK-NEXT: 0,1,1,0,0,0,-1
+print(ops("6", true));
+// CHECK-NEXT: 0,7,7,12,3,3,-7
+print(hash("hello world"));
+// CHECK-NEXT: 4173747013
@@ -0,0 +1,69 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+/*
+RUN: %hermes -O -jit %s | %FileCheck --match-full-lines %s
+REQUIRES: jit
+*/
+
+// Array elements, environment slots and direct calls, which JIT compiled
+// code handles without going through the generic runtime paths.
+function sumArray(a) {
+  var s = 0;
+  for (var i = 0; i < a.length; ++i)
+    s += a[i];
+  return s;
+}
+
+function fillArray(a, v) {
+  for (var i = 0; i < a.length; ++i)
+    a[i] = v;
+  return a;
+}
+
+print(sumArray([1, 2, 3, 4]));
+// CHECK: 10
+print(fillArray([0, 0, 0], 7).join());
+// CHECK-NEXT: 7,7,7
+print(fillArray([0, 0], "s").join());
+// CHECK-NEXT: s,s
+
+// Holes and frozen arrays take the slow path.
+var holes = [1, , 3];
+print(sumArray(holes));
+// CHECK-NEXT: NaN
+var frozen = Object.freeze([1, 2]);
+fillArray(frozen, 5);
+print(frozen.join());
+// CHECK-NEXT: 1,2
+
+function counter() {
+  var n = 0;
+  var obj = null;
+  return function(o) {
+    ++n;
+    if (o)
+      obj = o;
+    return obj ? obj.name + n : n;
+  };
+}
+
+var c = counter();
+print(c(), c(), c({name: "x"}), c());
+// CHECK-NEXT: 1 2 x3 x4
+
+function add(a, b) {
+  return a + b;
+}
+
+function callAdd(n) {
+  var s = 0;
+  for (var i = 0; i < n; ++i)
+    s = add(s, i);
+  return s;
+}
+
+print(callAdd(100));
+// CHECK-NEXT: 4950
@@ -82,7 +82,6 @@ logger(power(2, 10));
 //JIT-NEXT: movq {{.*}}
 //JIT-NEXT: movq {{.*}}
 //JIT-NEXT: movq {{.*}}
-//JIT-NEXT: movsd{{.*}}
 //JIT-NEXT: ucomisd{{.*}}
 //JIT-NEXT: jb{{.*}}
 //JIT-NEXT: BB1:
@@ -98,7 +97,6 @@ logger(power(2, 10));
 //JIT-NEXT: movsd{{.*}}
 //JIT-NEXT: movq {{.*}}
 //JIT-NEXT: movq {{.*}}
-//JIT-NEXT: movsd{{.*}}
 //JIT-NEXT: ucomisd{{.*}}
 //JIT-NEXT: jae{{.*}}
 //JIT-NEXT: BB2:
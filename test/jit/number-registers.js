@@ -0,0 +1,44 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+/*
+RUN: %hermes -O -jit %s | %FileCheck --match-full-lines %s
+REQUIRES: jit
+*/
+
+// Chains of arithmetic on numbers, whose intermediate results JIT compiled
+// code keeps in XMM registers within a basic block. The operands alias the
+// results in every way, and more values are live than there are registers.
+function chain(x, y) {
+  x = +x;
+  y = +y;
+  var a = x + y;
+  var b = a * x;
+  var c = b - a;
+  var d = c / y;
+  a = a - b;
+  b = x - b;
+  c = c * c;
+  var e = a + b + c + d;
+  var f = e - a - b;
+  var g = f * 2 - e;
+  var h = g / 4 + f;
+  return [a, b, c, d, e, f, g, h].join();
+}
+
+function poly(x) {
+  x = +x;
+  var r = 0;
+  for (var i = 0; i < 5; ++i)
+    r = r * x + i;
+  return r;
+}
+
+print(chain(3, 2));
+// CHECK: -10,-12,100,5,83,105,127,136.75
+print(chain(0.5, -4));
+// CHECK-NEXT: -1.75,2.25,3.0625,-0.4375,3.125,2.625,2.125,3.15625
+print(poly(2), poly(-1.5));
+// CHECK-NEXT: 26 0.625
@@ -0,0 +1,49 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+/*
+RUN: %hermes -O -jit-threshold=50 %s | %FileCheck --match-full-lines %s
+REQUIRES: jit
+*/
+
+// A function that is called only once becomes hot in its loop, and finishes
+// executing in native code.
+function sum(n) {
+  var s = 0;
+  for (var i = 0; i < n; ++i)
+    s += i;
+  return s;
+}
+
+function nested(n) {
+  var s = 0;
+  for (var i = 0; i < n; ++i)
+    for (var j = 0; j < i; ++j)
+      s += j;
+  return s;
+}
+
+function thrower(n) {
+  var s = 0;
+  for (var i = 0; i < n; ++i) {
+    s += i;
+    if (i === 1000)
+      throw s;
+  }
+  return s;
+}
+
+print(sum(1000));
+// CHECK: 499500
+print(nested(100));
+// CHECK-NEXT: 161700
+try {
+  thrower(2000);
+} catch (e) {
+  print("caught", e);
+}
+// CHECK-NEXT: caught 500500
+print(sum(10));
+// CHECK-NEXT: 45
@@ -0,0 +1,59 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+/*
+RUN: %hermes -O -jit %s | %FileCheck --match-full-lines %s
+REQUIRES: jit
+*/
+
+// Property accesses in JIT code check the property cache inline, and must
+// fall back to the full lookup on a miss.
+function getX(o) {
+  return o.x;
+}
+
+function setX(o, v) {
+  o.x = v;
+}
+
+function getH(o) {
+  return o.h;
+}
+
+function setH(o, v) {
+  o.h = v;
+}
+
+var a = {x: 1};
+var b = {y: 2, x: 3};
+var c = {a: 0, b: 0, c: 0, d: 0, e: 0, f: 0, g: 0, h: 4};
+
+var sum = 0;
+for (var i = 0; i < 100; ++i)
+  sum += getX(a) + getX(b);
+print(sum);
+// CHECK: 400
+
+for (var i = 0; i < 100; ++i) {
+  setX(a, i);
+  setX(b, "s" + i);
+}
+print(a.x, b.x);
+// CHECK-NEXT: 99 s99
+
+// Slots outside of the object are not accessed inline.
+for (var i = 0; i < 10; ++i)
+  setH(c, getH(c) + 1);
+print(c.h);
+// CHECK-NEXT: 14
+
+// Objects stored in a property remain reachable.
+setX(a, {x: "inner"});
+print(getX(getX(a)));
+// CHECK-NEXT: inner
+
+// Non-objects take the slow path.
+print(getX(1), getX("str"));
+// CHECK-NEXT: undefined undefined
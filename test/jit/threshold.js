@@ -0,0 +1,32 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+/*
+RUN: %hermes -O -dump-jitcode -jit-threshold=10 %s \
+RUN:     | %FileCheck --match-full-lines %s
+REQUIRES: jit, jit_dis
+*/
+
+// Only functions whose invocations plus loop iterations reach the threshold
+// are compiled.
+function cold() {
+  return 1;
+}
+
+function hot(n) {
+  var s = 0;
+  for (var i = 0; i < n; ++i)
+    s += i;
+  return s;
+}
+
+print(cold());
+print(hot(100));
+print(cold());
+print(hot(10));
+
+// CHECK-NOT: Compiled Code of FunctionID: {{.*}}
+// CHECK: Compiled Code of FunctionID: 2
+// CHECK-NOT: Compiled Code of FunctionID: {{.*}}
@@ -404,6 +404,22 @@ class UsageCounter : public BytecodeVisitor {
       functionEnd_ = newEnd;
   }
 
+  void visitSwitchStr(const inst::Inst *inst) {
+    assert(inst->opCode == inst::OpCode::SwitchStr);
+
+    const auto *table = reinterpret_cast<const uint32_t *>(llvm::alignAddr(
+        (const uint8_t *)inst + inst->iSwitchStr.op2, sizeof(uint32_t)));
+    unsigned count = inst->iSwitchStr.op5;
+    for (unsigned i = 0; i < count; ++i) {
+      if (table[2 * i] != hbc::SWITCH_STR_EMPTY_ENTRY)
+        countStringLiteral(table[2 * i]);
+    }
+
+    uintptr_t newEnd = (uintptr_t)&table[2 * count];
+    if (newEnd > functionEnd_)
+      functionEnd_ = newEnd;
+  }
+
   void preVisitInstruction(inst::OpCode opcode, const uint8_t *ip, int length)
       override {
     auto inst = (inst::Inst const *)ip;
@@ -420,6 +436,9 @@ class UsageCounter : public BytecodeVisitor {
       case OpCode::SwitchImm:
         visitSwitchImm(inst);
         break;
+      case OpCode::SwitchStr:
+        visitSwitchStr(inst);
+        break;
       case OpCode::NewObjectWithBuffer:
         countSerializedLiterals(
             bcProvider_->getObjectKeyBuffer(),
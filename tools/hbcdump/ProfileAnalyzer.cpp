@@ -10,6 +10,7 @@
 #include "hermes/BCGen/HBC/HBC.h"
 #include "hermes/Parser/JSONParser.h"
 
+#include <algorithm>
 #include <set>
 #include <vector>
 
@@ -647,10 +648,17 @@ void ProfileAnalyzer::dumpIO() {
   os_ << executionInfo.size() << " functions accessed out of total "
       << funcCount << " functions\n";
 
-  uint32_t funcRegionStartOffset = bcProvider->getFunctionHeader(0).offset();
-  uint32_t funcRegionEndOffset =
-      bcProvider->getFunctionHeader(funcCount - 1).offset() +
-      bcProvider->getFunctionHeader(funcCount - 1).bytecodeSizeInBytes() - 1;
+  // The function bodies are not necessarily in the order of their IDs, since
+  // identical bodies are shared.
+  uint32_t funcRegionStartOffset = UINT32_MAX;
+  uint32_t funcRegionEndOffset = 0;
+  for (uint32_t i = 0; i < funcCount; ++i) {
+    hbc::RuntimeFunctionHeader header = bcProvider->getFunctionHeader(i);
+    funcRegionStartOffset = std::min(funcRegionStartOffset, header.offset());
+    funcRegionEndOffset = std::max(
+        funcRegionEndOffset,
+        header.offset() + header.bytecodeSizeInBytes() - 1);
+  }
 
   uint32_t funcRegionStartPage = getPageIndexFromOffset(funcRegionStartOffset);
   uint32_t funcRegionEndPage = getPageIndexFromOffset(funcRegionEndOffset);
@@ -852,6 +860,53 @@ void ProfileAnalyzer::dumpFunctionOffsets(
   printer.closeDict();
 }
 
+/// Visitor to count the instructions and the register copies of a function.
+class RegisterUsageVisitor : public hermes::hbc::BytecodeVisitor {
+ public:
+  uint32_t instructionCount{0};
+  // Number of Mov and MovLong instructions.
+  uint32_t movCount{0};
+  // Number of MovLong instructions, which copy from or to a register that
+  // doesn't fit in a Reg8.
+  uint32_t longMovCount{0};
+
+ protected:
+  void preVisitInstruction(inst::OpCode opcode, const uint8_t *ip, int length) {
+    ++instructionCount;
+    if (opcode == OpCode::Mov || opcode == OpCode::MovLong)
+      ++movCount;
+    if (opcode == OpCode::MovLong)
+      ++longMovCount;
+  }
+
+ public:
+  RegisterUsageVisitor(std::shared_ptr<hbc::BCProvider> bcProvider)
+      : BytecodeVisitor(bcProvider) {}
+};
+
+void ProfileAnalyzer::dumpFunctionRegisters(
+    uint32_t funcId,
+    StructuredPrinter &printer) {
+  auto bcProvider = hbcParser_.getBCProvider();
+  if (funcId >= bcProvider->getFunctionCount()) {
+    os_ << "FunctionID " << funcId << " is invalid.\n";
+    return;
+  }
+
+  RegisterUsageVisitor visitor(bcProvider);
+  visitor.visitInstructionsInFunction(funcId);
+
+  printer.openDict();
+  printer.emitKeyValue("FunctionID", funcId);
+  printer.emitKeyValue("Name", getFunctionName(bcProvider, funcId));
+  printer.emitKeyValue(
+      "FrameSize", bcProvider->getFunctionHeader(funcId).frameSize());
+  printer.emitKeyValue("Instructions", visitor.instructionCount);
+  printer.emitKeyValue("Movs", visitor.movCount);
+  printer.emitKeyValue("LongMovs", visitor.longMovCount);
+  printer.closeDict();
+}
+
 llvm::Optional<uint32_t> ProfileAnalyzer::getFunctionFromVirtualOffset(
     uint32_t virtualOffset) {
   auto bcProvider = hbcParser_.getBCProvider();
@@ -159,6 +159,18 @@ class ProfileAnalyzer {
     }
     printer.closeArray();
   }
+  // Print the frame size and register copies of a function.
+  void dumpFunctionRegisters(uint32_t funcId, StructuredPrinter &printer);
+  // Print the frame size and register copies of all functions in bundle.
+  void dumpAllFunctionRegisters(StructuredPrinter &printer) {
+    printer.openArray();
+    for (uint32_t i = 0, e = hbcParser_.getBCProvider()->getFunctionCount();
+         i < e;
+         i++) {
+      dumpFunctionRegisters(i, printer);
+    }
+    printer.closeArray();
+  }
   // Return the ID of the function, if any, found at a given virtual offset.
   llvm::Optional<uint32_t> getFunctionFromVirtualOffset(uint32_t virtualOffset);
 };
@@ -134,6 +134,13 @@ static void printHelp(llvm::Optional<llvm::StringRef> command = llvm::None) {
       {"block",
        "Display top hot basic blocks in sorted order.\n\n"
        "USAGE: block\n"},
+      {"registers",
+       "'registers': Display the frame size, instruction count and register "
+       "copies (Mov and MovLong) of each function.\n"
+       "'registers <FUNC_ID>': Display them for function with id <FUNC_ID>.\n"
+       "Add the '-json' flag to print them as JSON.\n\n"
+       "USAGE: registers <FUNC_ID> [-json]\n"
+       "       regs <FUNC_ID> [-json]\n"},
       {"at-virtual",
        "Display information about the function at a given virtual offset.\n\n"
        "USAGE: at-virtual <OFFSET> [-json]\n"},
@@ -319,6 +326,23 @@ static bool executeCommand(
     } else {
       os << "Usage: offsets [funcId]\n";
     }
+  } else if (command == "registers" || command == "regs") {
+    bool json = findAndRemoveOne(commandTokens, "-json");
+    std::unique_ptr<StructuredPrinter> printer =
+        StructuredPrinter::create(os, json);
+    if (commandTokens.size() == 1) {
+      analyzer.dumpAllFunctionRegisters(*printer);
+    } else if (commandTokens.size() == 2) {
+      uint32_t funcId;
+      if (commandTokens[1].getAsInteger(0, funcId)) {
+        os << "Error: cannot parse func_id as integer.\n";
+        return false;
+      }
+      analyzer.dumpFunctionRegisters(funcId, *printer);
+    } else {
+      printHelp(command);
+      return false;
+    }
   } else if (command == "io") {
     analyzer.dumpIO();
   } else if (command == "summary" || command == "sum") {
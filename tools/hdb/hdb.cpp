@@ -28,6 +28,7 @@ int main(void) {
 #include <iostream>
 #include <iterator>
 #include <map>
+#include <system_error>
 #include <thread>
 
 // hdb is a sample of using Hermes. Therefore, it should avoid introducing
@@ -131,7 +132,9 @@ std::string chompToken(std::string *str, const char *separators = " \t") {
 
 void printUsageAndExit() {
   std::cerr
-      << "USAGE: hdb [--break-at-start] [--break-after <secs>] [--lazy] <input JS file>\n";
+      << "USAGE: hdb [--break-at-start] [--break-after <secs>] [--lazy] "
+         "[--quickening-threshold <n>] [--type-feedback-file <file>] "
+         "<input JS file>\n";
   exit(EXIT_FAILURE);
 }
 
@@ -140,6 +143,8 @@ struct Options {
   bool breakAtStart{false};
   bool lazy{false};
   double breakAfterDelay{-1.}; // -1 disables breakAfterDelay
+  uint32_t quickeningThreshold{0}; // 0 disables quickening
+  std::string typeFeedbackFile{}; // written at exit if not empty
 };
 
 Options getCommandLineOptions(int argc, char **argv) {
@@ -175,6 +180,17 @@ Options getCommandLineOptions(int argc, char **argv) {
         exit(EXIT_FAILURE);
       }
       result.breakAfterDelay = breakAfterDelay;
+    } else if (strcmp(arg, "--quickening-threshold") == 0) {
+      char *endptr = nullptr;
+      char *strValue = nextArg();
+      unsigned long threshold = std::strtoul(strValue, &endptr, 10);
+      if (*endptr != '\0' || threshold > UINT32_MAX) {
+        std::cerr << "Invalid quickening threshold: " << strValue << std::endl;
+        exit(EXIT_FAILURE);
+      }
+      result.quickeningThreshold = threshold;
+    } else if (strcmp(arg, "--type-feedback-file") == 0) {
+      result.typeFeedbackFile = nextArg();
     } else {
       printUsageAndExit();
     }
@@ -738,7 +754,10 @@ int main(int argc, char **argv) {
       (std::istreambuf_iterator<char>(fileStream)),
       std::istreambuf_iterator<char>());
 
-  std::unique_ptr<HermesRuntime> runtime = makeHermesRuntime();
+  std::unique_ptr<HermesRuntime> runtime = makeHermesRuntime(
+      ::hermes::vm::RuntimeConfig::Builder()
+          .withQuickeningThreshold(options.quickeningThreshold)
+          .build());
   HDBDebugger debugger(*runtime);
   runtime->getDebugger().setEventObserver(&debugger);
   runtime->getDebugger().setShouldPauseOnScriptLoad(options.breakAtStart);
@@ -755,6 +774,16 @@ int main(int argc, char **argv) {
     gDebugger = nullptr;
     return EXIT_FAILURE;
   }
+  if (!options.typeFeedbackFile.empty()) {
+    try {
+      runtime->dumpTypeFeedbackToFile(options.typeFeedbackFile);
+    } catch (const std::system_error &e) {
+      std::cerr << "Could not write to " << options.typeFeedbackFile << ": "
+                << e.what() << std::endl;
+      gDebugger = nullptr;
+      return EXIT_FAILURE;
+    }
+  }
   gDebugger = nullptr;
   return 0;
 }
@@ -31,6 +31,12 @@ static opt<bool> EnableJIT(
     llvm::cl::desc("enable JIT compilation"),
     llvm::cl::init(false));
 
+static opt<unsigned> JITThreshold(
+    "jit-threshold",
+    llvm::cl::desc("number of invocations plus loop iterations a function "
+                   "must reach before it is JIT compiled"),
+    llvm::cl::init(0));
+
 static opt<bool> DumpJITCode(
     "dump-jitcode",
     llvm::cl::desc("dump JIT'ed code"),
@@ -41,6 +47,28 @@ static opt<bool> JITCrashOnError(
     llvm::cl::desc("crash on any JIT compilation error"),
     llvm::cl::init(false));
 
+static opt<bool> JITReportBailouts(
+    "jit-report-bailouts",
+    llvm::cl::desc("report why functions could not be JIT compiled"),
+    llvm::cl::init(false));
+
+static opt<bool> PerfMap(
+    "perf-map",
+    llvm::cl::desc("describe JIT compiled code to perf in /tmp/perf-<pid>.map"),
+    llvm::cl::init(false));
+
+static opt<bool> PerfJITDump(
+    "perf-jitdump",
+    llvm::cl::desc("describe JIT compiled code and its source lines to perf "
+                   "in jit-<pid>.dump, for perf inject --jit"),
+    llvm::cl::init(false));
+
+static opt<bool> PerfInterpreterTrampolines(
+    "perf-interpreter-trampolines",
+    llvm::cl::desc("interpret every JS function through a trampoline of its "
+                   "own, so that perf can attribute samples to it"),
+    llvm::cl::init(false));
+
 static opt<unsigned> Repeat(
     "Xrepeat",
     llvm::cl::desc("Repeat execution N number of times"),
@@ -66,6 +94,38 @@ static opt<bool> GCRevertToYGAtTTI(
     cat(GCCategory),
     init(false));
 
+static opt<bool> GCAllocSitePretenuring(
+    "gc-alloc-site-pretenuring",
+    desc("Allocate object and array literals directly in the old generation "
+         "at sites whose objects keep surviving young-gen collections"),
+    cat(GCCategory),
+    init(false));
+
+static opt<bool> GCHugePages(
+    "gc-huge-pages",
+    desc("Ask the OS to back the heap with transparent huge pages"),
+    cat(GCCategory),
+    init(false));
+
+static opt<bool> GCNUMALocalHeap(
+    "gc-numa-local-heap",
+    desc("Ask the OS to allocate the heap on the local NUMA node"),
+    cat(GCCategory),
+    init(false));
+
+static opt<double> GCTargetCostRatio(
+    "gc-target-cost-ratio",
+    desc("Resize the heap to keep the fraction of time spent in GC near this "
+         "value (0 disables)"),
+    cat(GCCategory),
+    init(0.0));
+
+static opt<bool> GCBackgroundFreeing(
+    "gc-background-freeing",
+    desc("Free the native buffers of finalized objects on a background thread"),
+    cat(GCCategory),
+    init(false));
+
 static opt<bool> GCPrintStats(
     "gc-print-stats",
     desc("Output summary garbage collection statistics at exit"),
@@ -97,11 +157,23 @@ static int executeHBCBytecodeFromCL(
                   .withShouldReleaseUnused(false)
                   .withAllocInYoung(cl::GCAllocYoung)
                   .withRevertToYGAtTTI(cl::GCRevertToYGAtTTI)
+                  .withAllocSitePretenuring(cl::GCAllocSitePretenuring)
+                  .withHugePages(cl::GCHugePages)
+                  .withNUMALocalHeap(cl::GCNUMALocalHeap)
+                  .withTargetGCCostRatio(cl::GCTargetCostRatio)
+                  .withBackgroundFreeing(cl::GCBackgroundFreeing)
                   .build())
           .withEnableJIT(cl::DumpJITCode || cl::EnableJIT)
+          .withJITThreshold(cl::JITThreshold)
+          .withPerfMap(cl::PerfMap)
+          .withPerfJITDump(cl::PerfJITDump)
+          .withPerfInterpreterTrampolines(cl::PerfInterpreterTrampolines)
           .withEnableEval(cl::EnableEval)
           .withVerifyEvalIR(cl::VerifyIR)
           .withVMExperimentFlags(cl::VMExperimentFlags)
+          .withQuickeningThreshold(cl::QuickeningThreshold)
+          .withEvictColdLazyFunctions(cl::EvictColdLazyFunctions)
+          .withReleaseSharedPropertyMaps(cl::ReleaseSharedPropertyMaps)
           .withES6Symbol(cl::ES6Symbol)
           .withEnableSampleProfiling(cl::SampleProfiling)
           .withRandomizeMemoryLayout(cl::RandomizeMemoryLayout)
@@ -115,8 +187,13 @@ static int executeHBCBytecodeFromCL(
   options.patchProfilerSymbols = cl::PatchProfilerSymbols;
   options.profilerSymbolsFile = cl::ProfilerSymbolsFile;
 #endif
+#ifdef HERMESVM_PROFILER_JSFUNCTION
+  options.inliningProfileFile = cl::InliningProfileFile;
+#endif
+  options.typeFeedbackFile = cl::TypeFeedbackFile;
   options.dumpJITCode = cl::DumpJITCode;
   options.jitCrashOnError = cl::JITCrashOnError;
+  options.jitReportBailouts = cl::JITReportBailouts;
   options.stopAfterInit = cl::StopAfterInit;
 
   bool success;
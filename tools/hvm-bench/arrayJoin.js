@@ -0,0 +1,24 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// Join arrays of numbers and strings, and build strings from template
+// literals.
+function run(numTimes) {
+    var nums = [];
+    var strs = [];
+    for (var i = 0; i < 1000; i++) {
+        nums.push(i * 1.5);
+        strs.push('item' + i);
+    }
+    var sum = 0;
+    for (var i = 0; i < numTimes; i++) {
+        sum += nums.join().length;
+        sum += strs.join(', ').length;
+        sum += `${i} of ${numTimes}: ${strs[i % 1000]}`.length;
+    }
+    return sum;
+}
+
+print(run(2000));
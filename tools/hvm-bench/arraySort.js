@@ -0,0 +1,35 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// Sort numbers with the default comparison and with a comparator, and
+// records by one of their keys.
+function run(numTimes) {
+    var seed = 1;
+    function random() {
+        seed = (seed * 16807) % 2147483647;
+        return seed;
+    }
+    var numbers = [];
+    var records = [];
+    for (var i = 0; i < 1000; i++) {
+        numbers.push(random() % 100000);
+        records.push({name: 'name' + random() % 1000, age: random() % 100});
+    }
+    var sum = 0;
+    for (var i = 0; i < numTimes; i++) {
+        var a = numbers.slice();
+        a.sort();
+        sum += a[0];
+        a = numbers.slice();
+        a.sort(function(x, y) { return x - y; });
+        sum += a[999];
+        var r = records.slice();
+        r.sort(function(x, y) { return x.age - y.age; });
+        sum += r[0].age;
+    }
+    return sum;
+}
+
+print(run(200));
@@ -0,0 +1,32 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// Create closures over locals of their enclosing function, and call them
+// through variables, arrays and object properties.
+function run(numTimes) {
+    function makeCounter(start) {
+        var count = start;
+        return {
+            inc: function() { return ++count; },
+            get: function() { return count; },
+        };
+    }
+    function adder(x) {
+        return function(y) { return x + y; };
+    }
+    var sum = 0;
+    for (var i = 0; i < numTimes; i++) {
+        var counter = makeCounter(i);
+        var fns = [adder(1), adder(2), adder(3)];
+        for (var j = 0; j < 10; j++) {
+            counter.inc();
+            sum += fns[j % 3](j);
+        }
+        sum += counter.get();
+    }
+    return sum;
+}
+
+print(run(300000));
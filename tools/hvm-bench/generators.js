@@ -0,0 +1,33 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// Iterate generators, both with for-of and by calling next(), and delegate
+// between them with yield*.
+function* range(n) {
+    for (var i = 0; i < n; i++) {
+        yield i;
+    }
+}
+
+function* twice(n) {
+    yield* range(n);
+    yield* range(n);
+}
+
+function run(numTimes) {
+    var sum = 0;
+    for (var i = 0; i < numTimes; i++) {
+        for (var x of range(100)) {
+            sum += x;
+        }
+        var it = twice(50);
+        for (var r = it.next(); !r.done; r = it.next()) {
+            sum += r.value;
+        }
+    }
+    return sum;
+}
+
+print(run(5000));
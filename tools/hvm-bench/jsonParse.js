@@ -0,0 +1,28 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// Parse a response-like JSON document: an array of records with the same
+// keys, holding strings, integers, floats and nested objects.
+function run(numTimes) {
+    var items = [];
+    for (var i = 0; i < 1000; i++) {
+        items.push({
+            id: i,
+            name: "item number " + i,
+            price: i * 0.25,
+            tags: ["a", "b", "c"],
+            owner: {login: "user" + (i % 10), verified: i % 2 === 0},
+        });
+    }
+    var text = JSON.stringify({total: items.length, items: items});
+    var sum = 0;
+    for (var i = 0; i < numTimes; i++) {
+        var res = JSON.parse(text);
+        sum += res.total + res.items[i % 1000].id;
+    }
+    return sum;
+}
+
+print(run(200));
@@ -0,0 +1,26 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// Serialize a batch of telemetry-like events, which all have the same keys
+// and a nested object of the same shape.
+function run(numTimes) {
+    var events = [];
+    for (var i = 0; i < 1000; i++) {
+        events.push({
+            name: "event" + (i % 16),
+            timestamp: 1500000000000 + i,
+            duration: i * 0.125,
+            success: i % 3 !== 0,
+            context: {screen: "home", session: i >> 4, retries: i % 4},
+        });
+    }
+    var len = 0;
+    for (var i = 0; i < numTimes; i++) {
+        len += JSON.stringify({batch: i, events: events}).length;
+    }
+    return len;
+}
+
+print(run(200));
@@ -0,0 +1,40 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// Insert, look up and delete integer, string and object keys in Map and Set.
+function run(numTimes) {
+    var keys = [];
+    for (var i = 0; i < 1000; i++) {
+        keys.push('key' + i);
+    }
+    var objs = [];
+    for (var i = 0; i < 1000; i++) {
+        objs.push({i: i});
+    }
+    var sum = 0;
+    for (var i = 0; i < numTimes; i++) {
+        var map = new Map();
+        var set = new Set();
+        for (var j = 0; j < 1000; j++) {
+            map.set(keys[j], j);
+            map.set(j, keys[j]);
+            set.add(objs[j]);
+        }
+        for (var j = 0; j < 1000; j++) {
+            sum += map.get(keys[j]);
+            if (set.has(objs[(j * 7) % 1000])) {
+                sum++;
+            }
+        }
+        for (var j = 0; j < 1000; j += 2) {
+            map.delete(j);
+            set.delete(objs[j]);
+        }
+        sum += map.size + set.size;
+    }
+    return sum;
+}
+
+print(run(500));
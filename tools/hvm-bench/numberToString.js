@@ -0,0 +1,19 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// Convert integers and fractions to strings, directly and through string
+// concatenation.
+function run(numTimes) {
+    var sum = 0;
+    for (var i = 0; i < numTimes; i++) {
+        var x = i / 7;
+        sum += String(x).length;
+        sum += ('' + (x * 1e-10)).length;
+        sum += (i * 1024).toString().length;
+    }
+    return sum;
+}
+
+print(run(1000000));
@@ -0,0 +1,34 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// Match log-like lines with a global regexp with captures, and test them
+// against a few anchored patterns.
+function run(numTimes) {
+    var lines = [];
+    for (var i = 0; i < 100; i++) {
+        lines.push('2019-07-' + (10 + i % 20) + ' level=' +
+            (i % 3 ? 'info' : 'warn') + ' id=' + i + ' msg="request ' + i +
+            ' done"');
+    }
+    var text = lines.join('\n');
+    var re = /(\w+)=("[^"]*"|\S+)/g;
+    var sum = 0;
+    for (var i = 0; i < numTimes; i++) {
+        var m;
+        re.lastIndex = 0;
+        while ((m = re.exec(text)) !== null) {
+            sum += m[1].length;
+        }
+        if (/^\d{4}-\d{2}-\d{2}/.test(lines[i % 100])) {
+            sum++;
+        }
+        if (/level=warn/.test(lines[i % 100])) {
+            sum++;
+        }
+    }
+    return sum;
+}
+
+print(run(2000));
@@ -0,0 +1,248 @@
+#!/usr/bin/python
+# Copyright (c) Facebook, Inc. and its affiliates.
+#
+# This source code is licensed under the MIT license found in the LICENSE
+# file in the root directory of this source tree.
+
+"""
+Run the benchmarks of this directory, and optionally the startup of real
+bundles, repeatedly with a hermes binary. Print the mean, standard deviation
+and coefficient of variation of each, write them as JSON, and compare them
+against a baseline written by an earlier run.
+
+    run-bench.py --hermes build/bin/hermes --out results.json
+    run-bench.py --hermes build/bin/hermes --baseline results.json
+
+The exit status is 1 if a benchmark failed or regressed against the baseline.
+"""
+
+from __future__ import absolute_import, division, print_function, unicode_literals
+
+import argparse
+import glob
+import json
+import math
+import os
+import platform
+import subprocess
+import sys
+import tempfile
+import time
+
+
+BENCH_DIR = os.path.dirname(os.path.abspath(__file__))
+
+# Benchmarks in this directory that are not meant to be run by the runner:
+# interp-dispatch.js is the input of interp-dispatch-bench.
+EXCLUDED = set(["interp-dispatch.js"])
+
+
+def mean(values):
+    return sum(values) / len(values)
+
+
+def stddev(values):
+    """Sample standard deviation of values, 0 for a single one."""
+    if len(values) < 2:
+        return 0.0
+    m = mean(values)
+    return math.sqrt(sum((v - m) ** 2 for v in values) / (len(values) - 1))
+
+
+def summarize(values):
+    m = mean(values)
+    sd = stddev(values)
+    return {
+        "runs": values,
+        "mean": m,
+        "stddev": sd,
+        "cv": sd / m if m else 0.0,
+        "min": min(values),
+        "max": max(values),
+    }
+
+
+def timeRun(cmd):
+    """
+    Run cmd, and return a tuple of (wall seconds, cpu seconds, output). Raise
+    an exception if it fails.
+    """
+    before = os.times()
+    start = time.time()
+    proc = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    output = proc.communicate()[0]
+    wall = time.time() - start
+    after = os.times()
+    if proc.returncode != 0:
+        raise RuntimeError(
+            "%s exited with %d:\n%s"
+            % (" ".join(cmd), proc.returncode, output.decode("utf-8", "replace"))
+        )
+    # Fields 2 and 3 are the user and system time of the waited for children.
+    cpu = (after[2] - before[2]) + (after[3] - before[3])
+    return wall, cpu, output
+
+
+def runBenchmark(name, cmd, args):
+    """Run cmd args.runs times after args.warmup runs, and summarize them."""
+    wall = []
+    cpu = []
+    output = None
+    for i in range(args.warmup + args.runs):
+        w, c, out = timeRun(cmd)
+        # All the runs must compute the same thing.
+        if output is not None and out != output:
+            raise RuntimeError("%s printed different outputs across runs" % name)
+        output = out
+        if i >= args.warmup:
+            wall.append(w)
+            cpu.append(c)
+    return {"wall": summarize(wall), "cpu": summarize(cpu)}
+
+
+def compileBundle(args, bundle, outDir):
+    """
+    Compile the JS bundle to bytecode in outDir, so that its startup is
+    measured without the compiler. Bytecode bundles are returned as is.
+    """
+    if not bundle.endswith(".js"):
+        return bundle
+    out = os.path.join(outDir, os.path.basename(bundle)[:-3] + ".hbc")
+    cmd = [args.hermes, "-O", "-emit-binary", "-out", out, bundle]
+    subprocess.check_call(cmd)
+    return out
+
+
+def compare(results, baseline, threshold):
+    """
+    Print how each benchmark compares to the baseline, and return the names
+    of those that regressed: their mean is more than threshold slower, by
+    more than the noise of both runs.
+    """
+    regressions = []
+    print()
+    print("%-28s %10s %10s %8s" % ("benchmark", "baseline", "current", "change"))
+    for name in sorted(results):
+        if name not in baseline:
+            print("%-28s %10s %10.3f" % (name, "-", results[name]["wall"]["mean"]))
+            continue
+        cur = results[name]["wall"]
+        base = baseline[name]["wall"]
+        change = (cur["mean"] - base["mean"]) / base["mean"]
+        # The standard error of the difference of the means.
+        noise = math.sqrt(
+            cur["stddev"] ** 2 / len(cur["runs"])
+            + base["stddev"] ** 2 / len(base["runs"])
+        )
+        regressed = change > threshold and cur["mean"] - base["mean"] > 2 * noise
+        print(
+            "%-28s %10.3f %10.3f %+7.1f%%%s"
+            % (
+                name,
+                base["mean"],
+                cur["mean"],
+                change * 100,
+                "  REGRESSION" if regressed else "",
+            )
+        )
+        if regressed:
+            regressions.append(name)
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--hermes", required=True, help="the hermes binary")
+    parser.add_argument(
+        "--runs", type=int, default=5, help="measured runs of each benchmark"
+    )
+    parser.add_argument(
+        "--warmup", type=int, default=1, help="unmeasured runs of each benchmark"
+    )
+    parser.add_argument(
+        "--filter", default="", help="only run the benchmarks containing this"
+    )
+    parser.add_argument(
+        "--bundle",
+        action="append",
+        default=[],
+        help="also measure the startup of this JS or bytecode bundle",
+    )
+    parser.add_argument(
+        "--hermes-arg",
+        action="append",
+        default=[],
+        help="pass this argument to hermes when running the benchmarks",
+    )
+    parser.add_argument("--out", help="write the results as JSON to this file")
+    parser.add_argument("--baseline", help="compare against the JSON of a run")
+    parser.add_argument(
+        "--threshold",
+        type=float,
+        default=0.05,
+        help="the slowdown from the baseline that is a regression",
+    )
+    args = parser.parse_args()
+
+    benchmarks = []
+    for path in sorted(glob.glob(os.path.join(BENCH_DIR, "*.js"))):
+        name = os.path.basename(path)
+        if name not in EXCLUDED:
+            benchmarks.append((name[:-3], path))
+
+    tmpDir = tempfile.mkdtemp()
+    for bundle in args.bundle:
+        name = "startup:" + os.path.splitext(os.path.basename(bundle))[0]
+        benchmarks.append((name, compileBundle(args, bundle, tmpDir)))
+
+    results = {}
+    failed = []
+    print("%-28s %10s %10s %8s" % ("benchmark", "mean (s)", "stddev", "cv"))
+    for name, path in benchmarks:
+        if args.filter not in name:
+            continue
+        cmd = [args.hermes, "-O"] + args.hermes_arg + [path]
+        try:
+            res = runBenchmark(name, cmd, args)
+        except RuntimeError as e:
+            print("%-28s FAILED\n%s" % (name, e))
+            failed.append(name)
+            continue
+        results[name] = res
+        wall = res["wall"]
+        print(
+            "%-28s %10.3f %10.3f %7.1f%%"
+            % (name, wall["mean"], wall["stddev"], wall["cv"] * 100)
+        )
+        sys.stdout.flush()
+
+    if args.out:
+        with open(args.out, "w") as f:
+            json.dump(
+                {
+                    "hermes": args.hermes,
+                    "args": args.hermes_arg,
+                    "machine": platform.node(),
+                    "time": time.time(),
+                    "results": results,
+                },
+                f,
+                indent=2,
+                sort_keys=True,
+            )
+
+    regressions = []
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)["results"]
+        regressions = compare(results, baseline, args.threshold)
+
+    if failed:
+        print("\nFailed: " + ", ".join(failed))
+    if regressions:
+        print("\nRegressed: " + ", ".join(regressions))
+    return 1 if failed or regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
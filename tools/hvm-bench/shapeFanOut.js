@@ -0,0 +1,40 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// Objects that share a prefix of properties and then diverge, so that one
+// hidden class has many children. Reading a property in each shape needs the
+// property map of its class.
+var names = [];
+for (var i = 0; i < 200; i++) {
+    names.push('p' + i);
+}
+
+function makeShapes() {
+    var objs = [];
+    for (var i = 0; i < names.length; i++) {
+        var o = {x: 1, y: 2, z: 3};
+        o[names[i]] = i;
+        objs.push(o);
+    }
+    return objs;
+}
+
+function readShapes(objs) {
+    var sum = 0;
+    for (var i = 0; i < objs.length; i++) {
+        sum += objs[i].x + objs[i][names[i]];
+    }
+    return sum;
+}
+
+function runNTimes(n) {
+    var sum = 0;
+    for (var i = 0; i < n; i++) {
+        sum += readShapes(makeShapes());
+    }
+    return sum;
+}
+
+print(runNTimes(2000));
@@ -0,0 +1,24 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// Build strings by concatenation and template-like joins, then read them
+// back by character and substring.
+function run(numTimes) {
+    var sum = 0;
+    for (var i = 0; i < numTimes; i++) {
+        var s = '';
+        for (var j = 0; j < 100; j++) {
+            s += 'x' + j + ';';
+        }
+        var t = 'prefix-' + s + '-suffix';
+        for (var j = 0; j < t.length; j += 16) {
+            sum += t.charCodeAt(j);
+        }
+        sum += t.substring(10, 50).length + t.slice(-20).toUpperCase().length;
+    }
+    return sum;
+}
+
+print(run(10000));
@@ -0,0 +1,24 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// Search a long string for substrings near its end, some of which only
+// partially match many times on the way.
+function run(numTimes) {
+    var str = '';
+    for (var i = 0; i < 1000; i++) {
+        str += 'abcdefghij';
+    }
+    str += 'needle';
+    var sum = 0;
+    for (var i = 0; i < numTimes; i++) {
+        sum += str.indexOf('needle');
+        sum += str.indexOf('abcdefghik');
+        sum += str.lastIndexOf('abc', 5000);
+        sum += str.includes('jab') ? 1 : 0;
+    }
+    return sum;
+}
+
+print(run(2000));
@@ -0,0 +1,22 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// Replace the first occurrence of a string in short and long strings.
+function run(numTimes) {
+    var long = '';
+    for (var i = 0; i < 1000; i++) {
+        long += 'abcdefghij';
+    }
+    long += 'needle';
+    var sum = 0;
+    for (var i = 0; i < numTimes; i++) {
+        sum += 'hello world'.replace('world', 'there').length;
+        sum += long.replace('needle', 'pin').length;
+        sum += long.replace('needle', '[$&]').length;
+    }
+    return sum;
+}
+
+print(run(5000));
@@ -0,0 +1,20 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// Split comma separated lines into their fields.
+function run(numTimes) {
+    var line = '';
+    for (var i = 0; i < 100; i++) {
+        line += 'field' + i + ',';
+    }
+    var sum = 0;
+    for (var i = 0; i < numTimes; i++) {
+        sum += line.split(',').length;
+        sum += line.split('d1').length;
+    }
+    return sum;
+}
+
+print(run(20000));
@@ -0,0 +1,28 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// Run arithmetic over typed arrays of several element types, as image and
+// audio processing code does.
+function run(numTimes) {
+    var n = 4096;
+    var bytes = new Uint8Array(n);
+    var floats = new Float64Array(n);
+    var ints = new Int32Array(n);
+    for (var i = 0; i < n; i++) {
+        bytes[i] = i & 0xff;
+        floats[i] = i / 7;
+    }
+    var sum = 0;
+    for (var i = 0; i < numTimes; i++) {
+        for (var j = 0; j < n; j++) {
+            ints[j] = bytes[j] * 3 + (ints[j] >> 1);
+            floats[j] = floats[j] * 0.5 + bytes[j];
+        }
+        sum += ints[i % n] + floats[i % n];
+    }
+    return sum;
+}
+
+print(run(500));
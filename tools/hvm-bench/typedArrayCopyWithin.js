@@ -0,0 +1,26 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// Shift the elements of large typed arrays with overlapping copies in both
+// directions.
+function run(numTimes) {
+    var bytes = new Uint8Array(100000);
+    var doubles = new Float64Array(100000);
+    for (var i = 0; i < bytes.length; i++) {
+        bytes[i] = i;
+        doubles[i] = i;
+    }
+    var sum = 0;
+    for (var i = 0; i < numTimes; i++) {
+        bytes.copyWithin(1, 0);
+        bytes.copyWithin(0, 1);
+        doubles.copyWithin(10, 0, 90000);
+        doubles.copyWithin(0, 10, 90010);
+        sum += bytes[500] + doubles[500];
+    }
+    return sum;
+}
+
+print(run(2000));
@@ -0,0 +1,26 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// Fill large typed arrays of each width, whole and in part.
+function run(numTimes) {
+    var arrays = [
+        new Uint8Array(100000),
+        new Int16Array(100000),
+        new Float32Array(100000),
+        new Float64Array(100000),
+    ];
+    var sum = 0;
+    for (var i = 0; i < numTimes; i++) {
+        for (var j = 0; j < arrays.length; j++) {
+            var arr = arrays[j];
+            arr.fill(i & 0x7f);
+            arr.fill(1, 1000, 50000);
+            sum += arr[0] + arr[1000];
+        }
+    }
+    return sum;
+}
+
+print(run(2000));
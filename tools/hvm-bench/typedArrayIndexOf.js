@@ -0,0 +1,26 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// Search large typed arrays for elements near the end, and for values that
+// can't be stored in them.
+function run(numTimes) {
+    var ints = new Int32Array(100000);
+    var floats = new Float64Array(100000);
+    for (var i = 0; i < ints.length; i++) {
+        ints[i] = i;
+        floats[i] = i / 2;
+    }
+    var sum = 0;
+    for (var i = 0; i < numTimes; i++) {
+        sum += ints.indexOf(99990);
+        sum += ints.lastIndexOf(10);
+        sum += ints.includes(0.5) ? 1 : 0;
+        sum += floats.indexOf(49995);
+        sum += floats.includes(NaN) ? 1 : 0;
+    }
+    return sum;
+}
+
+print(run(2000));
@@ -0,0 +1,29 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// Reverse large typed arrays of each width.
+function run(numTimes) {
+    var arrays = [
+        new Int8Array(100000),
+        new Uint16Array(100000),
+        new Int32Array(100000),
+        new Float64Array(100000),
+    ];
+    for (var j = 0; j < arrays.length; j++) {
+        for (var i = 0; i < arrays[j].length; i++) {
+            arrays[j][i] = i;
+        }
+    }
+    var sum = 0;
+    for (var i = 0; i < numTimes; i++) {
+        for (var j = 0; j < arrays.length; j++) {
+            arrays[j].reverse();
+            sum += arrays[j][0];
+        }
+    }
+    return sum;
+}
+
+print(run(2000));
@@ -0,0 +1,26 @@
+// Copyright (c) Facebook, Inc. and its affiliates.
+//
+// This source code is licensed under the MIT license found in the LICENSE
+// file in the root directory of this source tree.
+//
+// Copy typed arrays into typed arrays of a different element type, which
+// converts every element, and of the same type.
+function run(numTimes) {
+    var src = new Float64Array(100000);
+    for (var i = 0; i < src.length; i++) {
+        src[i] = i * 1.5;
+    }
+    var ints = new Int32Array(src.length);
+    var bytes = new Uint8ClampedArray(src.length);
+    var copy = new Float64Array(src.length);
+    var sum = 0;
+    for (var i = 0; i < numTimes; i++) {
+        ints.set(src);
+        bytes.set(ints);
+        copy.set(src);
+        sum += ints[1] + bytes[1000] + copy[3];
+    }
+    return sum;
+}
+
+print(run(1000));
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "hermes/BCGen/HBC/BytecodeDataProvider.h"
+#include "hermes/ConsoleHost/ConsoleHost.h"
+#include "hermes/ConsoleHost/RuntimeFlags.h"
+#include "hermes/Support/JSONEmitter.h"
+#include "hermes/Support/MemoryBuffer.h"
+#include "hermes/VM/Callable.h"
+#include "hermes/VM/Runtime.h"
+#include "hermes/VM/instrumentation/ProcessStats.h"
+#include "hermes/VM/instrumentation/RuntimeStats.h"
+
+#define DEBUG_TYPE "hvm-startup"
+
+using namespace hermes;
+using vm::instrumentation::RAIITimer;
+using vm::instrumentation::RuntimeStats;
+
+static llvm::cl::opt<std::string> InputFilename(
+    llvm::cl::desc("input file"),
+    llvm::cl::Positional,
+    llvm::cl::Required);
+
+static llvm::cl::opt<bool> PrintJSON(
+    "json",
+    llvm::cl::desc("Print the phases as JSON"),
+    llvm::cl::init(false));
+
+namespace {
+
+/// A phase of the startup, from the mapping of the bytecode file to the end
+/// of its global code.
+struct Phase {
+  const char *name;
+  RuntimeStats::Statistic stat;
+};
+
+/// \return the difference of \p a and \p b, which must include it.
+RuntimeStats::Statistic subtract(
+    const RuntimeStats::Statistic &a,
+    const RuntimeStats::Statistic &b) {
+  RuntimeStats::Statistic result = a;
+  result.wallDuration -= b.wallDuration;
+  result.cpuDuration -= b.cpuDuration;
+  result.sampled.threadMinorFaults -= b.sampled.threadMinorFaults;
+  result.sampled.threadMajorFaults -= b.sampled.threadMajorFaults;
+  result.sampled.volCtxSwitches -= b.sampled.volCtxSwitches;
+  result.sampled.involCtxSwitches -= b.sampled.involCtxSwitches;
+  return result;
+}
+
+void printTable(
+    llvm::ArrayRef<Phase> phases,
+    const vm::ProcessStats::Info &process) {
+  auto &OS = llvm::outs();
+  OS << "phase                     wall (ms)   cpu (ms)"
+     << "  minor flt  major flt\n";
+  for (const Phase &phase : phases) {
+    OS << llvm::format(
+        "%-24s %10.3f %10.3f %10lld %10lld\n",
+        phase.name,
+        phase.stat.wallDuration * 1000,
+        phase.stat.cpuDuration * 1000,
+        static_cast<long long>(phase.stat.sampled.threadMinorFaults),
+        static_cast<long long>(phase.stat.sampled.threadMajorFaults));
+  }
+  OS << "Integral of RSS growth: " << process.RSSkB << " kBms\n";
+}
+
+void printJSON(
+    llvm::ArrayRef<Phase> phases,
+    const vm::ProcessStats::Info &process) {
+  JSONEmitter json(llvm::outs(), /* pretty */ true);
+  json.openDict();
+  json.emitKey("phases");
+  json.openArray();
+  for (const Phase &phase : phases) {
+    json.openDict();
+    json.emitKeyValue("name", phase.name);
+    json.emitKeyValue("wallMs", phase.stat.wallDuration * 1000);
+    json.emitKeyValue("cpuMs", phase.stat.cpuDuration * 1000);
+    json.emitKeyValue(
+        "minorFaults",
+        static_cast<long long>(phase.stat.sampled.threadMinorFaults));
+    json.emitKeyValue(
+        "majorFaults",
+        static_cast<long long>(phase.stat.sampled.threadMajorFaults));
+    json.emitKeyValue("volCtxSwitches", phase.stat.sampled.volCtxSwitches);
+    json.emitKeyValue("involCtxSwitches", phase.stat.sampled.involCtxSwitches);
+    json.closeDict();
+  }
+  json.closeArray();
+  json.emitKeyValue("integralRSSkBms", static_cast<long long>(process.RSSkB));
+  json.emitKeyValue("integralVAkBms", static_cast<long long>(process.VAkB));
+  json.closeDict();
+  llvm::outs() << "\n";
+}
+
+} // namespace
+
+// Runs a bytecode file once, and reports the time and page faults of each
+// phase of its startup. The bytecode should not be in the page cache for a
+// cold start measurement.
+int main(int argc, char **argv) {
+  llvm::InitLLVM initLLVM(argc, argv);
+  llvm::sys::PrintStackTraceOnErrorSignal("hvm-startup");
+  llvm::PrettyStackTraceProgram X(argc, argv);
+  llvm::llvm_shutdown_obj Y;
+  llvm::cl::ParseCommandLineOptions(
+      argc, argv, "Hermes VM startup benchmark\n");
+
+  vm::ProcessStats processStats;
+  auto sampleProcess = [&processStats]() {
+    processStats.sample(vm::ProcessStats::Clock::now());
+  };
+  // Times the phases that happen before there is a runtime, and those that
+  // the runtime doesn't time itself.
+  RuntimeStats stats(/* shouldSample */ true);
+
+  Phase map{"map bytecode", {}};
+  std::unique_ptr<llvm::MemoryBuffer> fileBuf;
+  {
+    const RAIITimer timer{"Map Bytecode", stats, map.stat};
+    auto fileBufOrErr = llvm::MemoryBuffer::getFile(
+        InputFilename, -1, /* RequiresNullTerminator */ false);
+    if (!fileBufOrErr) {
+      llvm::errs() << "Error! Failed to open file: " << InputFilename << "\n";
+      return 1;
+    }
+    fileBuf = std::move(fileBufOrErr.get());
+  }
+  sampleProcess();
+
+  Phase validate{"validate bytecode", {}};
+  std::unique_ptr<hbc::BCProvider> bytecode;
+  {
+    const RAIITimer timer{"Validate Bytecode", stats, validate.stat};
+    auto ret = hbc::BCProviderFromBuffer::createBCProviderFromBuffer(
+        llvm::make_unique<MemoryBuffer>(fileBuf.get()));
+    if (!ret.first) {
+      llvm::errs() << ret.second;
+      return 1;
+    }
+    bytecode = std::move(ret.first);
+  }
+  sampleProcess();
+
+  Phase init{"runtime and JSLib init", {}};
+  std::shared_ptr<vm::Runtime> runtime;
+  {
+    const RAIITimer timer{"Runtime Init", stats, init.stat};
+    runtime = vm::Runtime::create(
+        vm::RuntimeConfig::Builder()
+            .withGCConfig(vm::GCConfig::Builder()
+                              .withInitHeapSize(cl::InitHeapSize.bytes)
+                              .withMaxHeapSize(cl::MaxHeapSize.bytes)
+                              .withName("hvm-startup")
+                              .build())
+            .withES6Symbol(cl::ES6Symbol)
+            .withEnableSampledStats(true)
+            .build());
+    installConsoleBindings(runtime.get(), nullptr, &InputFilename.getValue());
+  }
+  sampleProcess();
+
+  // The RuntimeModule is created by runBytecode, and timed by the runtime.
+  RuntimeStats::Statistic run;
+  bool threwException;
+  {
+    vm::GCScope scope(runtime.get());
+    vm::RuntimeModuleFlags flags;
+    flags.persistent = true;
+    const RAIITimer timer{"Run Bytecode", stats, run};
+    threwException =
+        runtime->runBytecode(
+            std::move(bytecode),
+            flags,
+            "",
+            runtime->makeNullHandle<vm::Environment>()) ==
+            vm::ExecutionStatus::EXCEPTION ||
+        runtime->drainJobs() == vm::ExecutionStatus::EXCEPTION;
+  }
+  sampleProcess();
+  if (threwException) {
+    llvm::outs().flush();
+    runtime->printException(
+        llvm::errs(), runtime->makeHandle(runtime->getThrownValue()));
+  }
+
+  const RuntimeStats::Statistic &moduleInit =
+      runtime->getRuntimeStats().runtimeModuleInit;
+  Phase phases[] = {
+      map,
+      validate,
+      init,
+      {"RuntimeModule init", moduleInit},
+      {"global code", subtract(run, moduleInit)},
+  };
+
+  if (PrintJSON) {
+    printJSON(phases, processStats.getIntegratedInfo());
+  } else {
+    printTable(phases, processStats.getIntegratedInfo());
+  }
+  return threwException ? 1 : 0;
+}
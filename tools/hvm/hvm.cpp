@@ -119,6 +119,7 @@ int main(int argc, char **argv) {
                   .withName("hvm")
                   .build())
           .withES6Symbol(cl::ES6Symbol)
+          .withQuickeningThreshold(cl::QuickeningThreshold)
           .withTrackIO(cl::TrackBytecodeIO)
           .build();
 
@@ -127,6 +128,10 @@ int main(int argc, char **argv) {
   options.patchProfilerSymbols = cl::PatchProfilerSymbols;
   options.profilerSymbolsFile = cl::ProfilerSymbolsFile;
 #endif
+#ifdef HERMESVM_PROFILER_JSFUNCTION
+  options.inliningProfileFile = cl::InliningProfileFile;
+#endif
+  options.typeFeedbackFile = cl::TypeFeedbackFile;
 
   bool success;
   if (Repeat <= 1) {
@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+# Copyright (c) Facebook, Inc. and its affiliates.
+#
+# This source code is licensed under the MIT license found in the LICENSE
+# file in the root directory of this source tree.
+
+"""compare_timings compares the record timings of two replays of a trace.
+
+Each input is the file written by `synth -record-timings=<file>`, typically by
+two builds of Hermes replaying the same trace and bytecode. For the reps and
+each record type, it prints the p50 and p99 time of both runs, and how much
+the second one changed relative to the first.
+"""
+import argparse
+import json
+import sys
+from typing import Dict, Optional
+
+
+def change(base: float, new: float) -> str:
+    if base == 0:
+        return "n/a"
+    return "{:+.1f}%".format((new - base) / base * 100)
+
+
+def printRow(name: str, base: Optional[Dict], new: Optional[Dict]) -> None:
+    def get(summary: Optional[Dict], key: str) -> float:
+        return summary[key] if summary else 0.0
+
+    cells = [name]
+    for key in ("p50Us", "p99Us"):
+        b = get(base, key)
+        n = get(new, key)
+        cells += ["{:.2f}".format(b), "{:.2f}".format(n), change(b, n)]
+    count = int(get(new, "count") or get(base, "count"))
+    print("{:<26}{:>12}{:>12}{:>9}{:>12}{:>12}{:>9}{:>10}".format(*cells, count))
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(
+        description="Compare the record timings of two trace replays."
+    )
+    parser.add_argument("base", type=argparse.FileType("r"))
+    parser.add_argument("new", type=argparse.FileType("r"))
+    args = parser.parse_args()
+    base = json.load(args.base)
+    new = json.load(args.new)
+
+    print(
+        "{:<26}{:>12}{:>12}{:>9}{:>12}{:>12}{:>9}{:>10}".format(
+            "", "p50 base", "p50 new", "", "p99 base", "p99 new", "", "count"
+        )
+    )
+    printRow("(rep)", base["reps"], new["reps"])
+    types = sorted(set(base["records"]) | set(new["records"]))
+    for t in types:
+        printRow(t, base["records"].get(t), new["records"].get(t))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
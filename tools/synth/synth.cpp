@@ -14,6 +14,8 @@
 
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
 
 #include <iostream>
 #include <tuple>
@@ -29,8 +31,10 @@ using llvm::cl::Required;
 /// @name Synth benchmark specific flags
 /// @{
 
-static opt<std::string>
-    TraceFile(desc("input trace file"), Positional, Required);
+static opt<std::string> TraceFile(
+    desc("input trace file, JSON or streamed binary"),
+    Positional,
+    Required);
 
 static opt<std::string>
     BytecodeFile(desc("input bytecode file"), Positional, Required);
@@ -57,6 +61,19 @@ static opt<int> Reps(
         "rep with the median \"totalTime\"."),
     init(1));
 
+static opt<int> WarmupReps(
+    "warmup-reps",
+    desc("Number of initial executions whose stats and timings are "
+         "discarded."),
+    init(0));
+
+static opt<std::string> RecordTimingsFile(
+    "record-timings",
+    desc("Time the replay of each record, and write the count, total, p50 "
+         "and p99 time of each record type and of the reps to this file as "
+         "JSON. Compare two of these files with compare_timings.py."),
+    init(""));
+
 /// @}
 
 /// @name Common flags from Hermes VM
@@ -92,6 +109,7 @@ int main(int argc, char **argv) {
   try {
     TraceInterpreter::ExecuteOptions options;
     options.marker = cl::Marker;
+    options.warmupReps = cl::WarmupReps;
     options.reps = cl::Reps;
     options.minHeapSize = cl::MinHeapSize.bytes;
     options.maxHeapSize = cl::MaxHeapSize.bytes;
@@ -102,6 +120,10 @@ int main(int argc, char **argv) {
     options.bytecodeWarmupPercent = cl::BytecodeWarmupPercent;
     options.sanitizeRate = cl::GCSanitizeRate;
     options.sanitizeRandomSeed = cl::GCSanitizeRandomSeed;
+    TraceInterpreter::RecordTimings timings;
+    if (!cl::RecordTimingsFile.empty()) {
+      options.timings = &timings;
+    }
 #if !defined(NDEBUG) || defined(LLVM_ENABLE_STATS)
     if (cl::PrintStats)
       llvm::EnableStatistics();
@@ -118,6 +140,17 @@ int main(int argc, char **argv) {
                         cl::TraceFile, cl::BytecodeFile, options)
                  << "\n";
 #endif
+    if (options.timings) {
+      std::error_code ec;
+      llvm::raw_fd_ostream os{
+          cl::RecordTimingsFile, ec, llvm::sys::fs::F_Text};
+      if (ec) {
+        throw std::system_error(ec);
+      }
+      ::hermes::JSONEmitter json{os, /* pretty */ true};
+      timings.toJSON(json);
+      os << "\n";
+    }
 #if !defined(NDEBUG) || defined(LLVM_ENABLE_STATS)
     if (cl::PrintStats)
       llvm::PrintStatistics(llvm::outs());
@@ -8,6 +8,13 @@
 #include <hermes/CompileJS.h>
 #include <hermes/hermes.h>
 
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <cmath>
+#include <thread>
+
 using namespace facebook::jsi;
 using namespace facebook::hermes;
 
@@ -99,6 +106,153 @@ TEST_F(HermesRuntimeTest, BytecodeTest) {
   EXPECT_EQ(rt->global().getProperty(*rt, "x").getNumber(), 1);
 }
 
+TEST_F(HermesRuntimeTest, MappedBytecodeTest) {
+  std::string bytecode;
+  ASSERT_TRUE(hermes::compileJS("var mapped = 6 * 7", bytecode));
+  llvm::SmallString<64> path;
+  int fd;
+  ASSERT_FALSE(llvm::sys::fs::createTemporaryFile("mapped", "hbc", fd, path));
+  {
+    llvm::raw_fd_ostream os(fd, /* shouldClose */ true);
+    os << bytecode;
+  }
+  rt->evaluateMappedBytecode(path.str());
+  EXPECT_EQ(rt->global().getProperty(*rt, "mapped").getNumber(), 42);
+
+  // Source files and missing files are rejected.
+  {
+    std::error_code ec;
+    llvm::raw_fd_ostream os(path, ec, llvm::sys::fs::F_None);
+    ASSERT_FALSE(ec);
+    os << "var mapped = 0";
+  }
+  EXPECT_THROW(rt->evaluateMappedBytecode(path.str()), JSINativeException);
+  llvm::sys::fs::remove(path);
+  EXPECT_THROW(rt->evaluateMappedBytecode(path.str()), JSINativeException);
+  EXPECT_EQ(rt->global().getProperty(*rt, "mapped").getNumber(), 42);
+}
+
+TEST_F(HermesRuntimeTest, ExecutionTraceTest) {
+  rt->startExecutionTrace();
+  rt->evaluateJavaScript(
+      std::make_unique<StringBuffer>(R"(
+        function inner() { return 1; }
+        function outer() { return inner() + 1; }
+        function thrower() { throw new Error('x'); }
+        function catcher() { try { thrower(); } catch (e) {} }
+        outer();
+        catcher();
+      )"),
+      "trace.js");
+  rt->stopExecutionTrace();
+  // Nothing is recorded once the trace is stopped.
+  rt->global().getPropertyAsFunction(*rt, "outer").call(*rt);
+
+  llvm::SmallString<64> path;
+  int fd;
+  ASSERT_FALSE(llvm::sys::fs::createTemporaryFile("trace", "json", fd, path));
+  { llvm::raw_fd_ostream os(fd, /* shouldClose */ true); }
+  rt->dumpExecutionTraceToFile(path.str());
+  auto bufOrErr = llvm::MemoryBuffer::getFile(path);
+  llvm::sys::fs::remove(path);
+  ASSERT_TRUE(!!bufOrErr);
+  Object trace =
+      rt->parseJSONFromUtf8(StringBuffer((*bufOrErr)->getBuffer().str()))
+          .asObject(*rt);
+  EXPECT_EQ(trace.getProperty(*rt, "dropped").getNumber(), 0);
+
+  std::vector<std::string> calls;
+  Array events = trace.getPropertyAsObject(*rt, "events").asArray(*rt);
+  for (size_t i = 0, e = events.size(*rt); i < e; ++i) {
+    Object event = events.getValueAtIndex(*rt, i).asObject(*rt);
+    std::string kind = event.getProperty(*rt, "kind").asString(*rt).utf8(*rt);
+    if (kind != "functionEnter" && kind != "functionExit")
+      continue;
+    EXPECT_EQ(
+        event.getProperty(*rt, "url").asString(*rt).utf8(*rt), "trace.js");
+    if (kind == "functionEnter") {
+      EXPECT_EQ(event.getProperty(*rt, "offset").getNumber(), 0);
+    }
+    calls.push_back(
+        kind + " " +
+        event.getProperty(*rt, "function").asString(*rt).utf8(*rt));
+  }
+  // thrower() is left by unwinding the exception to catcher().
+  EXPECT_EQ(
+      calls,
+      (std::vector<std::string>{"functionEnter global",
+                                "functionEnter outer",
+                                "functionEnter inner",
+                                "functionExit inner",
+                                "functionExit outer",
+                                "functionEnter catcher",
+                                "functionEnter thrower",
+                                "functionExit thrower",
+                                "functionExit catcher",
+                                "functionExit global"}));
+}
+
+TEST(HermesRuntimeCacheTest, BytecodeCacheTest) {
+  llvm::SmallString<64> dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("bccache", dir));
+  auto config = ::hermes::vm::RuntimeConfig::Builder()
+                    .withBytecodeCacheDir(dir.str())
+                    .build();
+  const std::string src = "var cached = [1, 2, 3].map(x => x * 2).join()";
+  auto cachedFiles = [&dir]() {
+    std::vector<std::string> files;
+    std::error_code ec;
+    for (llvm::sys::fs::directory_iterator it(dir, ec), end; !ec && it != end;
+         it.increment(ec)) {
+      files.push_back(it->path());
+    }
+    return files;
+  };
+
+  // The first runtime compiles the source and caches the bytecode, which the
+  // second one loads.
+  for (int i = 0; i < 2; ++i) {
+    auto rt = makeHermesRuntime(config);
+    rt->evaluateJavaScript(std::make_unique<StringBuffer>(src), "cached.js");
+    EXPECT_EQ(
+        rt->global().getProperty(*rt, "cached").getString(*rt).utf8(*rt),
+        "2,4,6");
+    auto files = cachedFiles();
+    ASSERT_EQ(files.size(), 1u);
+    EXPECT_TRUE(llvm::StringRef(files[0]).endswith(".hbc"));
+  }
+
+  // An unusable cached file is replaced.
+  {
+    std::error_code ec;
+    llvm::raw_fd_ostream os(cachedFiles()[0], ec, llvm::sys::fs::F_None);
+    ASSERT_FALSE(ec);
+    os << "garbage";
+  }
+  auto rt = makeHermesRuntime(config);
+  rt->evaluateJavaScript(std::make_unique<StringBuffer>(src), "cached.js");
+  EXPECT_EQ(
+      rt->global().getProperty(*rt, "cached").getString(*rt).utf8(*rt),
+      "2,4,6");
+  auto cachedOrErr = llvm::MemoryBuffer::getFile(cachedFiles()[0]);
+  ASSERT_TRUE(!!cachedOrErr);
+  EXPECT_TRUE(HermesRuntime::isHermesBytecode(
+      reinterpret_cast<const uint8_t *>((*cachedOrErr)->getBufferStart()),
+      (*cachedOrErr)->getBufferSize()));
+
+  // A different source is cached separately, and errors aren't cached.
+  rt->evaluateJavaScript(std::make_unique<StringBuffer>("cached = 0"), "");
+  EXPECT_EQ(cachedFiles().size(), 2u);
+  EXPECT_THROW(
+      rt->evaluateJavaScript(std::make_unique<StringBuffer>("cached ="), ""),
+      JSIException);
+  EXPECT_EQ(cachedFiles().size(), 2u);
+
+  for (const auto &file : cachedFiles())
+    llvm::sys::fs::remove(file);
+  llvm::sys::fs::remove(dir);
+}
+
 TEST_F(HermesRuntimeTest, PreparedJavaScriptBytecodeTest) {
   eval("var q = 0;");
   std::string bytecode;
@@ -112,6 +266,33 @@ TEST_F(HermesRuntimeTest, PreparedJavaScriptBytecodeTest) {
   EXPECT_EQ(rt->global().getProperty(*rt, "q").getNumber(), 2);
 }
 
+TEST_F(HermesRuntimeTest, PreparedJavaScriptSharedBetweenRuntimes) {
+  std::string bytecode;
+  ASSERT_TRUE(hermes::compileJS(
+      "var o = {abc: 1}; function f() { throw new Error(o.abc); }", bytecode));
+  auto prep =
+      rt->prepareJavaScript(std::make_unique<StringBuffer>(bytecode), "");
+
+  // Each runtime has its own globals, but they share the bytecode.
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 2; ++i) {
+    threads.emplace_back([prep, i]() {
+      auto other = makeHermesRuntime();
+      other->evaluatePreparedJavaScript(prep);
+      other->global().getPropertyAsObject(*other, "o").setProperty(
+          *other, "abc", i);
+      try {
+        other->global().getPropertyAsFunction(*other, "f").call(*other);
+        FAIL() << "f() should have thrown";
+      } catch (const JSError &err) {
+        EXPECT_EQ(std::to_string(i), err.getMessage());
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+}
+
 TEST_F(HermesRuntimeTest, PreparedJavaScriptInvalidSourceThrows) {
   const char *badSource = "this is definitely not valid javascript";
   bool caught = false;
@@ -372,6 +553,337 @@ TEST_F(HermesRuntimeTest, HostObjectAsParentTest) {
       eval("var subClass = {__proto__: ho}; subClass.prop1 == 10;").getBool());
 }
 
+TEST_F(HermesRuntimeTest, HostObjectExternalMemory) {
+  class NativeBackedHostObject : public HostObject {};
+
+  {
+    Object ho = Object::createFromHostObject(
+        *rt, std::make_shared<NativeBackedHostObject>());
+    EXPECT_TRUE(rt->setExternalMemorySize(ho, 1 << 20));
+    // The charge can be updated, and dropped again.
+    EXPECT_TRUE(rt->setExternalMemorySize(ho, 1 << 10));
+    EXPECT_TRUE(rt->setExternalMemorySize(ho, 0));
+    EXPECT_TRUE(rt->setExternalMemorySize(ho, 1 << 20));
+    rt->global().setProperty(*rt, "ho", ho);
+  }
+  // The charge moves with the object when it is promoted, and is removed when
+  // it is collected.
+  eval("gc()");
+  eval("ho = undefined; gc()");
+
+  // Only host objects can be charged.
+  Object plain(*rt);
+  EXPECT_FALSE(rt->setExternalMemorySize(plain, 1 << 20));
+}
+
+TEST_F(HermesRuntimeTest, HostObjectStableProperty) {
+  class CountingHostObject : public HostObject {
+   public:
+    int gets = 0;
+    Value get(Runtime &runtime, const PropNameID &name) override {
+      ++gets;
+      if (PropNameID::compare(
+              runtime, name, PropNameID::forAscii(runtime, "version")))
+        return 3;
+      return Value();
+    }
+  };
+
+  auto host = std::make_shared<CountingHostObject>();
+  Object ho = Object::createFromHostObject(*rt, host);
+  rt->global().setProperty(*rt, "ho", ho);
+  EXPECT_TRUE(
+      rt->setHostObjectPropertyStable(ho, PropNameID::forAscii(*rt, "version")));
+  EXPECT_EQ(host->gets, 1);
+  EXPECT_EQ(
+      eval("var sum = 0; for (var i = 0; i < 10; ++i) sum += ho.version; sum")
+          .getNumber(),
+      30);
+  EXPECT_EQ(ho.getProperty(*rt, "version").getNumber(), 3);
+  EXPECT_EQ(host->gets, 1);
+  // Other properties still go to the host object.
+  EXPECT_TRUE(ho.getProperty(*rt, "other").isUndefined());
+  EXPECT_EQ(host->gets, 2);
+
+  Object plain(*rt);
+  EXPECT_FALSE(
+      rt->setHostObjectPropertyStable(plain, PropNameID::forAscii(*rt, "a")));
+}
+
+TEST_F(HermesRuntimeTest, ArrayBufferFromExternal) {
+  class VectorBuffer : public MutableBuffer {
+   public:
+    VectorBuffer(size_t size, bool *released)
+        : data_(size), released_(released) {}
+    ~VectorBuffer() override {
+      *released_ = true;
+    }
+    size_t size() const override {
+      return data_.size();
+    }
+    uint8_t *data() override {
+      return data_.data();
+    }
+
+   private:
+    std::vector<uint8_t> data_;
+    bool *released_;
+  };
+
+  bool released = false;
+  {
+    auto buffer = std::make_shared<VectorBuffer>(16, &released);
+    buffer->data()[3] = 42;
+    ArrayBuffer ab = rt->createArrayBufferFromExternal(buffer);
+    // The memory is shared, not copied.
+    EXPECT_EQ(ab.data(*rt), buffer->data());
+    EXPECT_EQ(ab.size(*rt), 16u);
+    rt->global().setProperty(*rt, "ab", ab);
+    EXPECT_EQ(eval("new Uint8Array(ab)[3]").getNumber(), 42);
+    eval("new Uint8Array(ab)[4] = 7");
+    EXPECT_EQ(buffer->data()[4], 7);
+  }
+  EXPECT_FALSE(released);
+  eval("ab = undefined; gc()");
+  EXPECT_TRUE(released);
+}
+
+TEST_F(HermesRuntimeTest, NumberFunction) {
+  Function hypot = rt->createNumberFunction(
+      PropNameID::forAscii(*rt, "hypot"),
+      2,
+      [](const double *args, size_t count) {
+        EXPECT_EQ(count, 2u);
+        return std::sqrt(args[0] * args[0] + args[1] * args[1]);
+      });
+  rt->global().setProperty(*rt, "hypot", hypot);
+  EXPECT_EQ(eval("hypot(3, 4)").getNumber(), 5);
+  // Arguments are converted to numbers, and missing ones are NaN.
+  EXPECT_EQ(
+      eval("hypot('6', {valueOf() { return 8; }}, 'extra')").getNumber(), 10);
+  EXPECT_TRUE(std::isnan(eval("hypot(1)").getNumber()));
+  // It can still be called through JSI.
+  EXPECT_EQ(hypot.call(*rt, 5, 12).getNumber(), 13);
+  EXPECT_TRUE(hypot.isHostFunction(*rt));
+  Value args[] = {8, 15};
+  EXPECT_EQ(
+      hypot.getHostFunction(*rt)(*rt, Value(), args, 2).getNumber(), 17);
+
+  Function thrower = rt->createNumberFunction(
+      PropNameID::forAscii(*rt, "thrower"),
+      0,
+      [](const double *, size_t) -> double {
+        throw std::runtime_error("oops");
+      });
+  rt->global().setProperty(*rt, "thrower", thrower);
+  EXPECT_TRUE(
+      eval("try { thrower(); false } catch (e) { /oops/.test(e.message) }")
+          .getBool());
+}
+
+TEST_F(HermesRuntimeTest, MigrateBetweenThreads) {
+  eval("var counter = 0; function bump() { return ++counter; }");
+  for (int i = 0; i < 3; ++i) {
+    rt->detachFromThread();
+    std::thread([this] {
+      rt->attachToCurrentThread();
+      rt->global().getPropertyAsFunction(*rt, "bump").call(*rt);
+      eval("gc()");
+      rt->detachFromThread();
+    }).join();
+    rt->attachToCurrentThread();
+  }
+  EXPECT_EQ(eval("bump()").getNumber(), 4);
+}
+
+TEST(HermesRuntimePoolTest, ResetToCleanState) {
+  HermesRuntimePool pool(
+      ::hermes::vm::RuntimeConfig(), 1, [](HermesRuntime &rt) {
+        rt.global().setProperty(rt, "fromInit", 1);
+        rt.global().setProperty(rt, "self", rt.global());
+      });
+  auto rt = pool.acquire();
+  HermesRuntime *first = rt.get();
+  rt->evaluateJavaScript(
+      std::make_unique<StringBuffer>(
+          "var userVar = 1; function userFunc() {} fromInit = 2;"
+          "this.parseInt = null; this.global = this;"),
+      "");
+  pool.release(std::move(rt));
+
+  rt = pool.acquire();
+  EXPECT_EQ(rt.get(), first) << "The released runtime should be reused";
+  auto eval = [&rt](const char *code) {
+    return rt->evaluateJavaScript(std::make_unique<StringBuffer>(code), "");
+  };
+  EXPECT_TRUE(eval("typeof userVar === 'undefined' && "
+                   "typeof userFunc === 'undefined' && fromInit === 1 && "
+                   "parseInt('12') === 12 && typeof global === 'undefined' && self === this")
+                  .getBool());
+}
+
+TEST_F(HermesRuntimeTest, DrainMicrotasks) {
+  eval(
+      "var log = [];"
+      "HermesInternal.enqueueJob(function() {"
+      "  log.push(1);"
+      "  HermesInternal.enqueueJob(function() { log.push(3); });"
+      "});"
+      "HermesInternal.enqueueJob(function() { log.push(2); });");
+  EXPECT_TRUE(rt->drainMicrotasks());
+  EXPECT_EQ(eval("log.join()").getString(*rt).utf8(*rt), "1,2,3");
+
+  // A throwing job leaves the following ones queued.
+  eval(
+      "HermesInternal.enqueueJob(function() { throw new Error('job'); });"
+      "HermesInternal.enqueueJob(function() { log.push(4); });");
+  EXPECT_THROW(rt->drainMicrotasks(), JSError);
+  EXPECT_TRUE(rt->drainMicrotasks());
+  EXPECT_EQ(eval("log.join()").getString(*rt).utf8(*rt), "1,2,3,4");
+}
+
+TEST_F(HermesRuntimeTest, HandleMemoryPressure) {
+  using ::hermes::vm::MemoryPressureLevel;
+  const char *code =
+      "var garbage = [];"
+      "for (var i = 0; i < 1000; ++i) garbage.push({i: i});"
+      "garbage = null;"
+      "function f(s) { return new RegExp(s + '+').test('aaa'); }"
+      "f('a')";
+  EXPECT_TRUE(eval(code).getBool());
+
+  auto low = rt->handleMemoryPressure(MemoryPressureLevel::Low);
+  EXPECT_GT(low.regExpCache, 0u);
+  EXPECT_GT(low.evalCache, 0u);
+  EXPECT_EQ(low.collected, 0u);
+
+  // Everything that was dropped is rebuilt.
+  EXPECT_TRUE(eval(code).getBool());
+  auto critical = rt->handleMemoryPressure(MemoryPressureLevel::Critical);
+  EXPECT_GT(critical.regExpCache, 0u);
+  EXPECT_GT(critical.collected, 0u);
+
+  // The caches are empty now.
+  auto again = rt->handleMemoryPressure(MemoryPressureLevel::Critical);
+  EXPECT_EQ(again.regExpCache, 0u);
+  EXPECT_EQ(again.evalCache, 0u);
+  EXPECT_EQ(again.jitCode, 0u);
+  EXPECT_TRUE(eval(code).getBool());
+}
+
+TEST_F(HermesRuntimeTest, StructuredClone) {
+  auto other = makeHermesRuntime();
+  auto data = rt->serialize(eval(
+      "var buf = new ArrayBuffer(8);"
+      "var o = {a: 1, b: 'caf\\u00e9', c: [1, , 2.5], d: new Date(5),"
+      "         m: new Map([[1, 'x']]), s: new Set(['y']),"
+      "         u8: new Uint8Array(buf), i16: new Int16Array(buf, 2, 2),"
+      "         list: [{x: 1, y: 2}, {x: 3, y: 4}]};"
+      "o.self = o;"
+      "o.i16[0] = -2;"
+      "o"));
+  other->global().setProperty(*other, "o", other->deserialize(data));
+  EXPECT_TRUE(other
+                  ->evaluateJavaScript(
+                      std::make_unique<StringBuffer>(
+                          "o.a === 1 && o.b === 'caf\\u00e9' &&"
+                          "o.c.length === 3 && !(1 in o.c) && o.c[2] === 2.5 &&"
+                          "o.d.getTime() === 5 && o.m.get(1) === 'x' &&"
+                          "o.s.has('y') && o.self === o &&"
+                          "o.u8.buffer === o.i16.buffer && o.i16[0] === -2 &&"
+                          "o.list[1].y === 4"),
+                      "")
+                  .getBool());
+
+  // Functions can't be cloned.
+  EXPECT_THROW(rt->serialize(eval("({f: function() {}})")), JSError);
+}
+
+TEST_F(HermesRuntimeTest, StructuredCloneTransfer) {
+  auto other = makeHermesRuntime();
+  Object buffer =
+      eval("var buf = new ArrayBuffer(4); new Uint8Array(buf)[3] = 7; buf")
+          .getObject(*rt);
+  std::vector<Object> transfer;
+  transfer.push_back(eval("buf").getObject(*rt));
+  auto data = rt->serialize(Value(*rt, buffer), transfer);
+  // The buffer is detached once its data has been moved.
+  EXPECT_EQ(eval("buf.byteLength").getNumber(), 0);
+
+  other->global().setProperty(*other, "buf", other->deserialize(data));
+  EXPECT_EQ(
+      other
+          ->evaluateJavaScript(
+              std::make_unique<StringBuffer>("new Uint8Array(buf)[3]"), "")
+          .getNumber(),
+      7);
+  // The data was moved into the first copy.
+  EXPECT_THROW(other->deserialize(data), JSError);
+}
+
+TEST_F(HermesRuntimeTest, ParseJSONFromUtf8) {
+  Value parsed = rt->parseJSONFromUtf8(
+      StringBuffer("{\"name\": \"caf\xc3\xa9\", \"n\": [1, 2.5]}"));
+  rt->global().setProperty(*rt, "parsed", parsed);
+  EXPECT_TRUE(eval("parsed.name === 'caf\\u00e9' && parsed.n[1] === 2.5")
+                  .getBool());
+
+  // Invalid UTF-8 is decoded as U+FFFD.
+  Value replaced = rt->parseJSONFromUtf8(StringBuffer("\"a\xff" "b\""));
+  EXPECT_EQ(replaced.getString(*rt).utf8(*rt), "a\xef\xbf\xbd" "b");
+
+  bool caught = false;
+  try {
+    rt->parseJSONFromUtf8(StringBuffer("{\"a\": 1,}"));
+  } catch (const facebook::jsi::JSError &) {
+    caught = true;
+  }
+  EXPECT_TRUE(caught) << "Invalid JSON should throw a SyntaxError";
+}
+
+TEST_F(HermesRuntimeTest, BatchedPropertyAccess) {
+  Object obj = eval("({a: 1, b: 'two', get c() { return this.a + 2; }})")
+                   .getObject(*rt);
+  PropNameID names[] = {PropNameID::forAscii(*rt, "a"),
+                        PropNameID::forAscii(*rt, "b"),
+                        PropNameID::forAscii(*rt, "c"),
+                        PropNameID::forAscii(*rt, "missing")};
+  auto values = rt->getProperties(obj, names, 4);
+  ASSERT_EQ(values.size(), 4u);
+  EXPECT_EQ(values[0].getNumber(), 1);
+  EXPECT_EQ(values[1].getString(*rt).utf8(*rt), "two");
+  EXPECT_EQ(values[2].getNumber(), 3);
+  EXPECT_TRUE(values[3].isUndefined());
+
+  Value newValues[] = {Value(10), Value(true)};
+  rt->setProperties(obj, names, newValues, 2);
+  EXPECT_EQ(obj.getProperty(*rt, "a").getNumber(), 10);
+  EXPECT_TRUE(obj.getProperty(*rt, "b").getBool());
+  EXPECT_EQ(obj.getProperty(*rt, "c").getNumber(), 12);
+
+  // Holes and getters are looked up like any other element.
+  Array arr = eval(
+                  "var arr = [0, 1, , 3, 4];"
+                  "Object.defineProperty(arr, 3, {get: () => 'got'});"
+                  "arr")
+                  .getObject(*rt)
+                  .getArray(*rt);
+  auto elements = rt->getValuesAtIndices(arr, 1, 3);
+  ASSERT_EQ(elements.size(), 3u);
+  EXPECT_EQ(elements[0].getNumber(), 1);
+  EXPECT_TRUE(elements[1].isUndefined());
+  EXPECT_EQ(elements[2].getString(*rt).utf8(*rt), "got");
+  EXPECT_EQ(rt->getValuesAtIndices(arr, 5, 0).size(), 0u);
+
+  Value newElements[] = {Value(5), Value(6)};
+  rt->setValuesAtIndices(arr, 0, newElements, 2);
+  EXPECT_TRUE(eval("arr[0] === 5 && arr[1] === 6 && arr.length === 5")
+                  .getBool());
+
+  EXPECT_THROW(rt->getValuesAtIndices(arr, 4, 2), JSError);
+  EXPECT_THROW(rt->setValuesAtIndices(arr, 6, newElements, 0), JSError);
+}
+
 TEST_F(HermesRuntimeTest, GlobalObjectTest) {
   rt->global().setProperty(*rt, "a", 5);
   eval("f = function(b) { return a + b; }");
@@ -448,6 +448,46 @@ TEST_F(SynthTraceTest, HostObjectThrowsExceptionFails) {
 }
 #endif
 
+TEST_F(SynthTraceTest, StreamedTraceRoundTrips) {
+  std::string out;
+  SynthTrace::ObjectID objID;
+  SynthTrace::ObjectID globalObjID;
+  {
+    ::hermes::vm::RuntimeConfig conf;
+    auto srt = makeStreamingTracingHermesRuntime(
+        makeHermesRuntime(conf),
+        conf,
+        std::make_unique<llvm::raw_string_ostream>(out));
+    globalObjID = srt->trace().globalObjID();
+    auto obj = jsi::Object(*srt);
+    objID = srt->getUniqueID(obj);
+    obj.setProperty(*srt, "a", jsi::String::createFromAscii(*srt, "foo"));
+    obj.setProperty(*srt, "b", 1.5);
+    obj.getProperty(*srt, "a");
+    // The records are only in the stream.
+    EXPECT_EQ(0, srt->trace().records().size());
+  }
+  auto result = SynthTrace::parse(llvm::MemoryBuffer::getMemBufferCopy(out));
+  SynthTrace &trace = std::get<0>(result);
+  EXPECT_EQ(globalObjID, trace.globalObjID());
+  const auto &records = trace.records();
+  ASSERT_EQ(4, records.size());
+  EXPECT_EQ_RECORD(
+      SynthTrace::CreateObjectRecord(dummyTime, objID), *records.at(0));
+  EXPECT_EQ_RECORD(
+      SynthTrace::SetPropertyRecord(
+          dummyTime, objID, "a", trace.encodeString("foo")),
+      *records.at(1));
+  EXPECT_EQ_RECORD(
+      SynthTrace::SetPropertyRecord(
+          dummyTime, objID, "b", SynthTrace::encodeNumber(1.5)),
+      *records.at(2));
+  EXPECT_EQ_RECORD(
+      SynthTrace::GetPropertyRecord(
+          dummyTime, objID, "a", trace.encodeString("foo")),
+      *records.at(3));
+}
+
 /// @}
 
 /// @name Serialization tests
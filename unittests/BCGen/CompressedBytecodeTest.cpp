@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/BCGen/HBC/CompressedBytecode.h"
+#include "hermes/BCGen/HBC/BytecodeDataProvider.h"
+
+#include "TestHelpers.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+using namespace hermes;
+using namespace hermes::hbc;
+
+namespace {
+
+class VectorBuffer : public Buffer {
+ public:
+  VectorBuffer(std::vector<uint8_t> buffer) : vec_(std::move(buffer)) {
+    data_ = vec_.data();
+    size_ = vec_.size();
+  }
+
+ private:
+  std::vector<uint8_t> vec_;
+};
+
+/// \return a container of \p bytecode whose region [\p coldStart, \p coldEnd)
+/// is compressed, followed by \p epilogue.
+std::vector<uint8_t> compress(
+    const std::vector<uint8_t> &bytecode,
+    uint32_t coldStart,
+    uint32_t coldEnd,
+    llvm::ArrayRef<uint32_t> bodyStarts,
+    llvm::StringRef epilogue = "") {
+  std::string str;
+  llvm::raw_string_ostream OS(str);
+  writeCompressedBytecode(OS, bytecode, coldStart, coldEnd, bodyStarts);
+  OS << epilogue;
+  OS.flush();
+  return std::vector<uint8_t>(str.begin(), str.end());
+}
+
+TEST(CompressedBytecodeTest, RoundTrip) {
+  // Compressible data, with "function bodies" every 1000 bytes.
+  std::vector<uint8_t> file(100000);
+  for (size_t i = 0; i < file.size(); ++i)
+    file[i] = (i * 7) % 13;
+  std::vector<uint32_t> bodyStarts;
+  for (uint32_t start = 500; start < file.size(); start += 1000)
+    bodyStarts.push_back(start);
+
+  auto container = compress(file, 2500, 90500, bodyStarts, "epilogue");
+  EXPECT_TRUE(isCompressedBytecodeStream(container));
+  EXPECT_TRUE(BCProviderFromBuffer::isBytecodeStream(container));
+  EXPECT_LT(container.size(), file.size() / 2);
+  EXPECT_EQ(
+      "epilogue",
+      std::string(
+          BCProviderFromBuffer::getEpilogueFromBytecode(container).begin(),
+          BCProviderFromBuffer::getEpilogueFromBytecode(container).end()));
+
+  auto ret = DecompressedBytecodeBuffer::create(
+      llvm::make_unique<VectorBuffer>(std::move(container)));
+  ASSERT_TRUE(ret.first) << ret.second;
+  const DecompressedBytecodeBuffer &buf = *ret.first;
+  ASSERT_EQ(file.size() + 8, buf.size());
+  EXPECT_EQ(
+      "epilogue",
+      std::string(buf.data() + file.size(), buf.data() + buf.size()));
+
+  // The parts outside of the compressed region are available right away.
+  EXPECT_TRUE(std::equal(file.begin(), file.begin() + 2500, buf.data()));
+  EXPECT_TRUE(
+      std::equal(file.begin() + 90500, file.end(), buf.data() + 90500));
+
+  // Decompress the chunks, some of them repeatedly.
+  for (uint32_t offset : {50000u, 2500u, 90499u, 50001u, 2500u}) {
+    buf.ensureDecompressed(offset);
+  }
+  for (uint32_t offset = 2500; offset < 90500; offset += 1000) {
+    buf.ensureDecompressed(offset);
+  }
+  EXPECT_TRUE(std::equal(file.begin(), file.end(), buf.data()));
+}
+
+TEST(CompressedBytecodeTest, Malformed) {
+  std::vector<uint8_t> file(10000, 42);
+  auto container = compress(file, 100, 9000, {100, 5000});
+
+  // Cut off the compressed data.
+  std::vector<uint8_t> truncated(container.begin(), container.end() - 10);
+  auto ret = DecompressedBytecodeBuffer::create(
+      llvm::make_unique<VectorBuffer>(std::move(truncated)));
+  EXPECT_FALSE(ret.first);
+  EXPECT_EQ("Malformed compressed bytecode", ret.second);
+
+  // A chunk table which doesn't start at the compressed region.
+  std::vector<uint8_t> moved = container;
+  uint32_t start = 200;
+  std::memcpy(
+      moved.data() + sizeof(CompressedBytecodeHeader) + 100 + 1000,
+      &start,
+      sizeof(start));
+  ret = DecompressedBytecodeBuffer::create(
+      llvm::make_unique<VectorBuffer>(std::move(moved)));
+  EXPECT_FALSE(ret.first);
+
+  // Regular bytecode is not a compressed container.
+  EXPECT_FALSE(isCompressedBytecodeStream(file));
+}
+
+TEST(CompressedBytecodeTest, Provider) {
+  const char *source = R"(
+    function f(x) { try { return x.y; } catch (e) { return 'caught'; } }
+    function g(a, b) { return a * b + f(a); }
+    function h(s) { return s + s.length; }
+    print(f(null), g(2, 3), h('abc'));
+  )";
+  TestCompileFlags flags;
+  auto bytecode = bytecodeForSource(source);
+  flags.compressColdFunctions = true;
+  auto container = bytecodeForSource(source, flags);
+  ASSERT_TRUE(isCompressedBytecodeStream(container));
+
+  auto expected = BCProviderFromBuffer::createBCProviderFromBuffer(
+                      llvm::make_unique<VectorBuffer>(bytecode))
+                      .first;
+  ASSERT_TRUE(expected);
+  EXPECT_EQ(
+      BCProviderFromBuffer::getSourceHashFromBytecode(bytecode),
+      BCProviderFromBuffer::getSourceHashFromBytecode(container));
+
+  auto ret = BCProviderFromBuffer::createBCProviderFromBuffer(
+      llvm::make_unique<VectorBuffer>(std::move(container)));
+  ASSERT_TRUE(ret.first) << ret.second;
+  auto &actual = ret.first;
+  ASSERT_EQ(expected->getFunctionCount(), actual->getFunctionCount());
+  EXPECT_EQ(expected->getRawBuffer().size(), actual->getRawBuffer().size());
+  for (uint32_t id = 0; id < expected->getFunctionCount(); ++id) {
+    uint32_t size = expected->getFunctionHeader(id).bytecodeSizeInBytes();
+    ASSERT_EQ(size, actual->getFunctionHeader(id).bytecodeSizeInBytes());
+    EXPECT_TRUE(std::equal(
+        expected->getBytecode(id),
+        expected->getBytecode(id) + size,
+        actual->getBytecode(id)))
+        << "function " << id;
+    EXPECT_EQ(
+        expected->getExceptionTable(id).size(),
+        actual->getExceptionTable(id).size());
+  }
+}
+
+} // namespace
@@ -99,6 +99,26 @@ TEST(DebugInfo, TestMultipleFiles) {
   checkAddress(&info, offset, 6, 2222, 1, 2, 1);
 }
 
+TEST(DebugInfo, TestEncodedLocations) {
+  auto dbg = makeGenerator();
+
+  // Encode before another function is appended, so that the file regions
+  // must be relocated.
+  auto encoded = DebugInfoGenerator::encodeSourceLocations(
+      Loc{0, 1111, 1, 1, 0}, {Loc{2, 2222, 1, 1, 1}, Loc{4, 1111, 1, 2, 1}});
+  auto offset1 = dbg.appendSourceLocations(
+      Loc{0, 2222, 7, 1, 0}, 0, {Loc{2, 2222, 8, 1, 1}});
+  auto offset2 = dbg.appendSourceLocations(encoded, 1);
+  EXPECT_TRUE(DebugInfoGenerator::encodeSourceLocations(Loc{}, {}).empty());
+
+  DebugInfo info = dbg.serializeWithMove();
+
+  checkAddress(&info, offset1, 2, 2222, 8, 1, 1);
+  checkAddress(&info, offset2, 0, 1111, 1, 1, 0);
+  checkAddress(&info, offset2, 2, 2222, 1, 1, 1);
+  checkAddress(&info, offset2, 4, 1111, 1, 2, 1);
+}
+
 TEST(DebugInfo, TestLargeDeltas) {
   for (uint32_t i = 0; i < INT32_MAX; i += 123457) {
     auto dbg = makeGenerator();
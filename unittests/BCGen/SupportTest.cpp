@@ -578,6 +578,18 @@ TEST(StringStorageTest, Optimizing) {
       "lierendrafty");
 }
 
+TEST(StringStorageTest, OptimizingManyOverlaps) {
+  // Short strings contained in most of the others, and long runs of strings
+  // sharing suffixes, which all compete to be laid out before each other.
+  std::vector<std::string> owned{"e", "Value", "get"};
+  for (unsigned i = 0; i < 2000; ++i) {
+    owned.push_back("get" + to_string(i) + "Value");
+    owned.push_back("Value" + to_string(i) + "get");
+  }
+  std::vector<llvm::StringRef> strings(owned.begin(), owned.end());
+  test1OptimizingStringStorage(strings, __LINE__);
+}
+
 // Ensure we don't hang on very long strings.
 TEST(StringStorageTest, NoHang) {
   std::string s1(16 * 1024 * 1024, 'a');
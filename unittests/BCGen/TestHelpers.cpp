@@ -49,17 +49,23 @@ std::vector<uint8_t> hermes::bytecodeForSource(
   /* Generate bytecode module */
   auto bytecodeGenOpts = BytecodeGenerationOptions::defaults();
   bytecodeGenOpts.staticBuiltinsEnabled = flags.staticBuiltins;
+  auto sourceHash = llvm::SHA1::hash(llvm::ArrayRef<uint8_t>{
+      reinterpret_cast<const uint8_t *>(source), strlen(source)});
+  llvm::SmallVector<char, 0> bytecodeVector;
+  llvm::raw_svector_ostream OS(bytecodeVector);
+  if (flags.compressColdFunctions) {
+    /* Generate and serialize it into a compressed container */
+    bytecodeGenOpts.format = EmitBundle;
+    bytecodeGenOpts.compressColdFunctions = true;
+    generateBytecode(&M, OS, bytecodeGenOpts, sourceHash);
+    return std::vector<uint8_t>{bytecodeVector.begin(), bytecodeVector.end()};
+  }
   auto BM =
       generateBytecodeModule(&M, M.getTopLevelFunction(), bytecodeGenOpts);
   assert(BM != nullptr && "Failed to generate bytecode module");
 
   /* Serialize it */
-  llvm::SmallVector<char, 0> bytecodeVector;
-  llvm::raw_svector_ostream OS(bytecodeVector);
   BytecodeSerializer BS{OS, bytecodeGenOpts};
-  BS.serialize(
-      *BM,
-      llvm::SHA1::hash(llvm::ArrayRef<uint8_t>{
-          reinterpret_cast<const uint8_t *>(source), strlen(source)}));
+  BS.serialize(*BM, sourceHash);
   return std::vector<uint8_t>{bytecodeVector.begin(), bytecodeVector.end()};
 }
@@ -14,6 +14,7 @@ namespace hermes {
 
 struct TestCompileFlags {
   bool staticBuiltins{false};
+  bool compressColdFunctions{false};
 };
 
 /// Compile source code \p source into Hermes bytecode, asserting that it can be
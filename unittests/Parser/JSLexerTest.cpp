@@ -411,6 +411,50 @@ TEST(JSLexerTest, StringTest2) {
   ASSERT_EQ(TokenKind::eof, lex.advance()->getKind());
 }
 
+TEST(JSLexerTest, LongRunsTest) {
+  JSLexer::Allocator alloc;
+  SourceErrorManager sm;
+  DiagContext diag(sm);
+
+  // Long plain runs are skipped 8 bytes at a time. Check that the characters
+  // ending them are still found.
+  JSLexer lex(
+      "'abcdefghijklmnopqrstuvwxyz\\n0123456789\xc3\xa9"
+      "abcdefgh'\n"
+      "\"abcdefghijklmnop'qrstuvwxyz\" // abcdefghijklmnopqrstuvwxyz\n"
+      "/* abcdefghijklmnop * qrstuvwxyz\n abcdefghijklmnop **/ x "
+      "'abcdefghijklmnopqrstuvwxyz",
+      sm,
+      alloc);
+
+  ASSERT_EQ(TokenKind::string_literal, lex.advance()->getKind());
+  ASSERT_EQ(0, diag.getErrCountClear());
+  EXPECT_STREQ(
+      "abcdefghijklmnopqrstuvwxyz\n0123456789\xc3\xa9"
+      "abcdefgh",
+      lex.getCurToken()->getStringLiteral()->c_str());
+
+  ASSERT_EQ(TokenKind::string_literal, lex.advance()->getKind());
+  ASSERT_EQ(0, diag.getErrCountClear());
+  EXPECT_STREQ(
+      "abcdefghijklmnop'qrstuvwxyz",
+      lex.getCurToken()->getStringLiteral()->c_str());
+  ASSERT_TRUE(lex.isNewLineBeforeCurrentToken());
+
+  ASSERT_EQ(TokenKind::identifier, lex.advance()->getKind());
+  ASSERT_EQ(0, diag.getErrCountClear());
+  EXPECT_STREQ("x", lex.getCurToken()->getIdentifier()->c_str());
+  ASSERT_TRUE(lex.isNewLineBeforeCurrentToken());
+
+  ASSERT_EQ(TokenKind::string_literal, lex.advance()->getKind());
+  ASSERT_EQ(1, diag.getErrCountClear());
+  EXPECT_STREQ(
+      "abcdefghijklmnopqrstuvwxyz",
+      lex.getCurToken()->getStringLiteral()->c_str());
+
+  ASSERT_EQ(TokenKind::eof, lex.advance()->getKind());
+}
+
 TEST(JSLexerTest, StringOctalTest) {
   JSLexer::Allocator alloc;
   SourceErrorManager sm;
@@ -406,6 +406,81 @@ TEST(SourceMap, EmptyLines) {
       *sourceMap, generatedLine, sources, loc(28, sourceIndex, 2, 10));
 }
 
+/// Lines are decoded when they are first looked up, in any order, and the
+/// delta encoding state carries over the lines that were skipped.
+TEST(SourceMap, LinesDecodedOutOfOrder) {
+  std::unique_ptr<SourceMap> sourceMap =
+      SourceMapParser::parse(TestMapEmptyLines);
+  ASSERT_EQ(sourceMap->getNumLines(), 4u);
+
+  std::vector<std::string> sources = {"one.js", "two.js"};
+  verifySegment(*sourceMap, 4, sources, loc(21, 1, 2, 3));
+  verifySegment(*sourceMap, 3, sources, loc(28, 0, 2, 10));
+  verifySegment(*sourceMap, 4, sources, loc(1, 1, 1, 1));
+  EXPECT_FALSE(sourceMap->getLocationForAddress(1, 1).hasValue());
+  EXPECT_FALSE(sourceMap->getLocationForAddress(5, 1).hasValue());
+}
+
+/// A ";" at the end of the mappings doesn't add a line, and segments must
+/// refer to existing sources.
+TEST(SourceMap, MappingsValidation) {
+  std::unique_ptr<SourceMap> sourceMap = SourceMapParser::parse(R"#({
+        "version": 3,
+        "sources": ["a.js"],
+        "mappings": "AAAA;AACA;"
+      })#");
+  ASSERT_TRUE(sourceMap != nullptr);
+  EXPECT_EQ(sourceMap->getNumLines(), 2u);
+
+  EXPECT_TRUE(
+      SourceMapParser::parse(R"#({
+        "version": 3,
+        "sources": ["a.js"],
+        "mappings": "ACAA"
+      })#") == nullptr);
+}
+
+/// The binary index maps every address like the source map it was written
+/// from.
+TEST(SourceMap, BinaryIndex) {
+  std::unique_ptr<SourceMap> sourceMap =
+      SourceMapParser::parse(TestMapEmptyLines);
+  // Decode one line before writing the index, so that the segments are not
+  // stored in line order.
+  verifySegment(*sourceMap, 4, {"one.js", "two.js"}, loc(1, 1, 1, 1));
+
+  std::string storage;
+  llvm::raw_string_ostream OS(storage);
+  sourceMap->writeIndex(OS);
+  std::unique_ptr<SourceMap> index =
+      SourceMapParser::parseIndex(llvm::MemoryBuffer::getMemBufferCopy(
+          OS.str(), "index"));
+  ASSERT_TRUE(index != nullptr);
+  EXPECT_EQ(index->getNumLines(), sourceMap->getNumLines());
+  EXPECT_EQ(index->getAllFullPathSources(), sourceMap->getAllFullPathSources());
+
+  for (uint32_t line = 1; line <= 5; ++line) {
+    for (uint32_t column = 1; column <= 40; ++column) {
+      auto expected = sourceMap->getLocationForAddress(line, column);
+      auto actual = index->getLocationForAddress(line, column);
+      ASSERT_EQ(expected.hasValue(), actual.hasValue());
+      if (expected.hasValue()) {
+        EXPECT_EQ(expected->fileName, actual->fileName);
+        EXPECT_EQ(expected->line, actual->line);
+        EXPECT_EQ(expected->column, actual->column);
+      }
+    }
+  }
+
+  // Truncated indices are rejected.
+  EXPECT_TRUE(
+      SourceMapParser::parseIndex(llvm::MemoryBuffer::getMemBufferCopy(
+          llvm::StringRef(storage).drop_back(4), "index")) == nullptr);
+  EXPECT_TRUE(
+      SourceMapParser::parseIndex(llvm::MemoryBuffer::getMemBufferCopy(
+          llvm::StringRef(storage).take_front(8), "index")) == nullptr);
+}
+
 TEST(SourceMap, VLQRandos) {
   // clang-format off
   const std::vector<int32_t> inputs = {0, 1, -1, 2, -2, 5298, -23498,
@@ -5,8 +5,13 @@
  * file in the root directory of this source tree.
  */
 #include "hermes/Support/Conversions.h"
+#include "hermes/Support/FastDtoa.h"
+#include "hermes/dtoa/dtoa.h"
 
+#include <cmath>
+#include <cstring>
 #include <limits>
+#include <string>
 
 #include "gtest/gtest.h"
 
@@ -162,6 +167,128 @@ TEST(ConversionsTest, numberToStringTest) {
   DoubleToStringTest("0", 0);
   DoubleToStringTest("12384", 12384);
   DoubleToStringTest("-12384", -12384);
+
+  DoubleToStringTest("0.1", 0.1);
+  DoubleToStringTest("0.30000000000000004", 0.1 + 0.2);
+  DoubleToStringTest("0.000001", 1e-6);
+  DoubleToStringTest("-1e-7", -1e-7);
+  DoubleToStringTest("9007199254740991", 9007199254740991.0);
+  DoubleToStringTest("9007199254740992", 9007199254740992.0);
+  DoubleToStringTest("123456789012345680000", 123456789012345678901.0);
+  DoubleToStringTest(
+      "1.7976931348623157e+308", std::numeric_limits<double>::max());
+  DoubleToStringTest("5e-324", std::numeric_limits<double>::denorm_min());
+}
+
+/// Check that fastShortestDtoa() gives the same digits as dtoa whenever it
+/// succeeds.
+static void expectSameAsDtoa(double v) {
+  char digits[FAST_DTOA_BUF_SIZE];
+  int length;
+  int decimalPoint;
+  if (!fastShortestDtoa(v, digits, &length, &decimalPoint))
+    return;
+  int n;
+  int sign;
+  char *sEnd;
+  char *s = ::g_dtoa(v, 0, 0, &n, &sign, &sEnd);
+  EXPECT_EQ(std::string(s, sEnd), std::string(digits, length)) << v;
+  EXPECT_EQ(n, decimalPoint) << v;
+  ::g_freedtoa(s);
+}
+
+TEST(ConversionsTest, fastShortestDtoaTest) {
+  // Powers of two and their neighbours, including the denormals, where the
+  // boundaries are asymmetric.
+  for (int e = -1074; e < 1024; ++e) {
+    double pow2 = std::ldexp(1.0, e);
+    expectSameAsDtoa(pow2);
+    if (e > -1074)
+      expectSameAsDtoa(std::nextafter(pow2, 0.0));
+    if (e < 1023)
+      expectSameAsDtoa(std::nextafter(pow2, 2 * pow2));
+  }
+
+  // Arbitrary bit patterns.
+  uint64_t bits = 0x123456789abcdefull;
+  for (int i = 0; i < 100000; ++i) {
+    bits = bits * 6364136223846793005ull + 1442695040888963407ull;
+    double v = std::fabs(safeTypeCast<uint64_t, double>(bits));
+    if (std::isfinite(v) && v != 0)
+      expectSameAsDtoa(v);
+  }
+
+  // Short decimal fractions.
+  for (int i = 1; i < 100000; ++i)
+    expectSameAsDtoa(i / 1000.0);
+
+  char digits[FAST_DTOA_BUF_SIZE];
+  int length;
+  int decimalPoint;
+  ASSERT_TRUE(fastShortestDtoa(0.1, digits, &length, &decimalPoint));
+  EXPECT_EQ("1", std::string(digits, length));
+  EXPECT_EQ(0, decimalPoint);
+}
+
+TEST(ConversionsTest, parseDecimalFastTest) {
+  auto bits = [](double d) { return safeTypeCast<double, uint64_t>(d); };
+  auto expectSameAsStrtod = [&bits](const char *str) {
+    const char *end = str + strlen(str);
+    const char *parsedEnd;
+    auto res = parseDecimalFast(str, end, &parsedEnd);
+    ASSERT_TRUE(res.hasValue()) << str;
+    char *strtodEnd;
+    double expected = ::g_strtod(str, &strtodEnd);
+    EXPECT_EQ(bits(expected), bits(*res)) << str;
+    EXPECT_EQ(strtodEnd, parsedEnd) << str;
+
+    std::u16string str16(str, end);
+    const char16_t *parsedEnd16;
+    auto res16 = parseDecimalFast(
+        str16.data(), str16.data() + str16.size(), &parsedEnd16);
+    ASSERT_TRUE(res16.hasValue()) << str;
+    EXPECT_EQ(bits(*res), bits(*res16)) << str;
+    EXPECT_EQ(parsedEnd - str, parsedEnd16 - str16.data()) << str;
+  };
+  auto expectSlowPath = [](const char *str) {
+    const char *parsedEnd;
+    EXPECT_FALSE(parseDecimalFast(str, str + strlen(str), &parsedEnd)
+                     .hasValue())
+        << str;
+  };
+
+  expectSameAsStrtod("0");
+  expectSameAsStrtod("-0");
+  expectSameAsStrtod("+42");
+  expectSameAsStrtod("1.5");
+  expectSameAsStrtod(".5");
+  expectSameAsStrtod("5.");
+  expectSameAsStrtod("0.1");
+  expectSameAsStrtod("0.000001");
+  expectSameAsStrtod("123.456e-7");
+  expectSameAsStrtod("1E22");
+  expectSameAsStrtod("1e23");
+  expectSameAsStrtod("3e30");
+  expectSameAsStrtod("0000000000000000000000012");
+  expectSameAsStrtod("12345678.87654321");
+  expectSameAsStrtod("9007199254740992");
+  expectSameAsStrtod("0e999999999");
+
+  // Only the longest valid prefix is parsed.
+  expectSameAsStrtod("1e");
+  expectSameAsStrtod("1e+");
+  expectSameAsStrtod("1.2.3");
+  expectSameAsStrtod("12345678x");
+
+  expectSlowPath("");
+  expectSlowPath(".");
+  expectSlowPath("-");
+  expectSlowPath("e5");
+  expectSlowPath("9007199254740993");
+  expectSlowPath("12345678901234567890");
+  expectSlowPath("1e38");
+  expectSlowPath("1.7976931348623157e308");
+  expectSlowPath("4.9e-324");
 }
 
 } // end anonymous namespace
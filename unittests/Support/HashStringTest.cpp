@@ -6,6 +6,7 @@
  */
 #include "hermes/Support/HashString.h"
 
+#include <cstring>
 #include <limits>
 
 #include "gtest/gtest.h"
@@ -25,4 +26,31 @@ TEST(HashStringTest, Constexpr) {
       hashString(makeArrayRef("1234567")), constexprHashString("1234567"));
 }
 
+TEST(HashStringTest, ASCIIMatchesUTF16) {
+  // Cover every length of the partial last block.
+  const char *ascii = "abcdefghijklmnopq";
+  const char16_t *utf16 = u"abcdefghijklmnopq";
+  for (size_t len = 0; len <= strlen(ascii); ++len) {
+    EXPECT_EQ(
+        hashString(llvm::ArrayRef<char>(ascii, len)),
+        hashString(llvm::ArrayRef<char16_t>(utf16, len)))
+        << "length " << len;
+  }
+}
+
+TEST(HashStringTest, Distinct) {
+  // Trailing NUL characters and characters above ASCII change the hash.
+  const char16_t str[] = {u'a', 0, 0, 0, 0, u'\u00e9', u'\u4e2d'};
+  EXPECT_NE(
+      hashString(llvm::ArrayRef<char16_t>(str, 1)),
+      hashString(llvm::ArrayRef<char16_t>(str, 2)));
+  EXPECT_NE(
+      hashString(llvm::ArrayRef<char16_t>(str, 4)),
+      hashString(llvm::ArrayRef<char16_t>(str, 5)));
+  EXPECT_NE(
+      hashString(llvm::ArrayRef<char16_t>(str + 5, 1)),
+      hashString(llvm::ArrayRef<char16_t>(str + 6, 1)));
+  EXPECT_NE(hashString(makeArrayRef("ab")), hashString(makeArrayRef("ba")));
+}
+
 } // end anonymous namespace
@@ -1043,4 +1043,27 @@ TEST(Regex, NonASCII) {
       constants::matchInputAllAscii));
 }
 
+TEST(Regex, LongBracketLoops) {
+  // Long runs are matched with a bitmap of the ASCII characters in the
+  // bracket; the other characters must still be tested one by one.
+  std::u16string text(200, u'a');
+  text[150] = u'\xE9';
+  text += u"!";
+  MatchResults<const char16_t *> m;
+  EXPECT_TRUE(search(text, m, cregex(u"[a-z\xE0-\xFF]+")));
+  EXPECT_EQ(200u, m[0].length());
+  EXPECT_TRUE(search(text, m, cregex(u"[a-z]+")));
+  EXPECT_EQ(150u, m[0].length());
+  EXPECT_TRUE(search(text, m, cregex(u"[^!]*")));
+  EXPECT_EQ(200u, m[0].length());
+  EXPECT_TRUE(search(text, m, cregex(u"[A-Z\xC9]+", constants::icase)));
+  EXPECT_EQ(200u, m[0].length());
+
+  std::u16string spaces(100, u' ');
+  spaces[80] = u'\u3000';
+  spaces += u"x";
+  EXPECT_TRUE(search(spaces, m, cregex(u"\\s*x")));
+  EXPECT_EQ(101u, m[0].length());
+}
+
 } // end anonymous namespace
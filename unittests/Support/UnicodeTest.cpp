@@ -8,7 +8,9 @@
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <deque>
+#include <string>
 #include <vector>
 
 using namespace hermes;
@@ -115,4 +117,52 @@ TEST(StringTest, IsAllASCIITest) {
   }
 }
 
+TEST(StringTest, FindFirstNonASCII) {
+  // Lengths on both sides of every chunk size, with the non-ASCII character at
+  // every position.
+  for (size_t len = 0; len <= 40; ++len) {
+    std::vector<uint8_t> bytes(len, 'a');
+    std::vector<char16_t> chars(len, u'a');
+    EXPECT_EQ(
+        bytes.data() + len, findFirstNonASCII(bytes.data(), bytes.data() + len));
+    EXPECT_EQ(
+        chars.data() + len, findFirstNonASCII(chars.data(), chars.data() + len));
+    for (size_t pos = 0; pos < len; ++pos) {
+      bytes[pos] = 0x80;
+      chars[pos] = pos % 2 ? 0x80 : 0x2603;
+      EXPECT_EQ(
+          bytes.data() + pos,
+          findFirstNonASCII(bytes.data(), bytes.data() + len));
+      EXPECT_EQ(
+          chars.data() + pos,
+          findFirstNonASCII(chars.data(), chars.data() + len));
+      bytes[pos] = 0x7F;
+      chars[pos] = 0x7F;
+    }
+  }
+}
+
+TEST(StringTest, WidenNarrowASCII) {
+  for (size_t len = 0; len <= 40; ++len) {
+    std::string ascii;
+    for (size_t i = 0; i < len; ++i) {
+      ascii.push_back(static_cast<char>(i * 7 % 128));
+    }
+    std::vector<char16_t> wide(len);
+    widenASCII(ascii.data(), len, wide.data());
+    EXPECT_TRUE(std::equal(ascii.begin(), ascii.end(), wide.begin()));
+
+    std::string narrow(len, '\0');
+    narrowASCII(wide.data(), len, &narrow[0]);
+    EXPECT_EQ(ascii, narrow);
+
+    // Both conversions to UTF-8 copy ASCII unchanged.
+    std::string out;
+    convertUTF16ToUTF8WithReplacements(out, wide);
+    EXPECT_EQ(ascii, out);
+    convertUTF16ToUTF8WithSingleSurrogates(out, wide);
+    EXPECT_EQ(ascii, out);
+  }
+}
+
 } // end anonymous namespace
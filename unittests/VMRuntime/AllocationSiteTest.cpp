@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/AllocationSite.h"
+
+#include "gtest/gtest.h"
+
+using namespace hermes::vm;
+
+namespace {
+
+TEST(AllocationSiteTest, PretenureAfterEnoughSurvivors) {
+  AllocationSiteInfo site;
+  for (uint32_t i = 0; i + 1 < AllocationSiteInfo::kMinSamples; ++i) {
+    site.recordOutcome(true);
+    EXPECT_FALSE(site.pretenure);
+  }
+  site.recordOutcome(true);
+  EXPECT_TRUE(site.pretenure);
+}
+
+TEST(AllocationSiteTest, ShortLivedSiteStartsNewWindow) {
+  AllocationSiteInfo site;
+  for (uint32_t i = 0; i < AllocationSiteInfo::kMinSamples; ++i) {
+    site.recordOutcome(i % 2 == 0);
+  }
+  EXPECT_FALSE(site.pretenure);
+  EXPECT_EQ(0u, site.numSampled);
+  EXPECT_EQ(0u, site.numSurvived);
+
+  // Objects that start surviving later are still noticed.
+  for (uint32_t i = 0; i < AllocationSiteInfo::kMinSamples; ++i) {
+    site.recordOutcome(true);
+  }
+  EXPECT_TRUE(site.pretenure);
+}
+
+TEST(AllocationSiteTest, ConstructorSlackUsesLargestInstance) {
+  ConstructorSlackInfo slack;
+  for (uint32_t i = 0; i + 1 < ConstructorSlackInfo::kNumSamples; ++i) {
+    slack.recordInstance(i % 2 ? 9 : 12);
+    EXPECT_TRUE(slack.isTracking());
+    EXPECT_EQ(0u, slack.expectedProperties());
+  }
+  slack.recordInstance(3);
+  EXPECT_FALSE(slack.isTracking());
+  EXPECT_EQ(12u, slack.expectedProperties());
+}
+
+} // namespace
@@ -153,4 +153,75 @@ TEST_F(ArrayTest, TestLength) {
   EXPECT_CALLRESULT_DOUBLE(
       5.0, JSObject::getNamed_RJS(array, runtime, lengthID));
 }
+
+TEST_F(ArrayTest, ElementsKind) {
+  using ElementsKind = ArrayImpl::ElementsKind;
+  auto arrayRes = JSArray::create(runtime, 4, 0);
+  ASSERT_EQ(arrayRes.getStatus(), ExecutionStatus::RETURNED);
+  auto array = toHandle(runtime, std::move(*arrayRes));
+  ASSERT_EQ(ElementsKind::PackedNumber, array->getElementsKind());
+
+  // Appending numbers keeps the array packed.
+  JSArray::setElementAt(array, runtime, 0, runtime->makeHandle(1.0_hd));
+  JSArray::setElementAt(array, runtime, 1, runtime->makeHandle(2.0_hd));
+  ASSERT_EQ(ElementsKind::PackedNumber, array->getElementsKind());
+  ASSERT_TRUE(array->hasFastPackedElements());
+
+  // So does any other value.
+  JSArray::setElementAt(
+      array,
+      runtime,
+      2,
+      runtime->makeHandle(HermesValue::encodeUndefinedValue()));
+  ASSERT_EQ(ElementsKind::PackedAny, array->getElementsKind());
+
+  // Deleting the last element only shortens the storage.
+  ASSERT_TRUE(JSArray::deleteElementAt(array, runtime, 2));
+  ASSERT_EQ(2u, array->getEndIndex());
+  ASSERT_EQ(ElementsKind::PackedAny, array->getElementsKind());
+
+  // Writing past the end leaves a hole.
+  JSArray::setElementAt(array, runtime, 3, runtime->makeHandle(4.0_hd));
+  ASSERT_EQ(ElementsKind::Holey, array->getElementsKind());
+  ASSERT_FALSE(array->hasFastPackedElements());
+
+  // So does deleting an element in the middle.
+  auto otherRes = JSArray::create(runtime, 4, 0);
+  ASSERT_EQ(otherRes.getStatus(), ExecutionStatus::RETURNED);
+  auto other = toHandle(runtime, std::move(*otherRes));
+  for (unsigned i = 0; i < 3; ++i)
+    JSArray::setElementAt(other, runtime, i, runtime->makeHandle(1.0_hd));
+  ASSERT_TRUE(JSArray::deleteElementAt(other, runtime, 1));
+  ASSERT_EQ(ElementsKind::Holey, other->getElementsKind());
+}
+
+TEST_F(ArrayTest, CopyOnWriteStorage) {
+  auto arrayRes = JSArray::create(runtime, 3, 3);
+  ASSERT_EQ(arrayRes.getStatus(), ExecutionStatus::RETURNED);
+  auto array = toHandle(runtime, std::move(*arrayRes));
+  for (unsigned i = 0; i < 3; ++i)
+    JSArray::unsafeSetExistingElementAt(
+        *array, runtime, i, HermesValue::encodeNumberValue(i));
+  auto storage =
+      runtime->makeHandle(JSArray::unsafeShareStorage(*array, runtime));
+
+  auto copyRes = JSArray::createWithSharedStorage(runtime, storage, true);
+  ASSERT_EQ(copyRes.getStatus(), ExecutionStatus::RETURNED);
+  auto copy = toHandle(runtime, std::move(*copyRes));
+  ASSERT_EQ(3u, JSArray::getLength(*copy));
+  ASSERT_EQ(ArrayImpl::ElementsKind::PackedNumber, copy->getElementsKind());
+  EXPECT_EQ(HermesValue::encodeNumberValue(2), copy->at(runtime, 2));
+
+  // Writing to either array leaves the other one unchanged.
+  JSArray::setElementAt(copy, runtime, 0, runtime->makeHandle(10.0_hd));
+  EXPECT_EQ(HermesValue::encodeNumberValue(10), copy->at(runtime, 0));
+  EXPECT_EQ(HermesValue::encodeNumberValue(0), array->at(runtime, 0));
+  ASSERT_TRUE(JSArray::deleteElementAt(array, runtime, 1));
+  EXPECT_TRUE(array->at(runtime, 1).isEmpty());
+  EXPECT_EQ(HermesValue::encodeNumberValue(1), copy->at(runtime, 1));
+
+  // The storage itself is never modified.
+  EXPECT_EQ(HermesValue::encodeNumberValue(0), storage->at(0));
+  EXPECT_EQ(HermesValue::encodeNumberValue(1), storage->at(1));
+}
 } // namespace
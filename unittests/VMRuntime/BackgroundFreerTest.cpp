@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/BackgroundFreer.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+
+using namespace hermes::vm;
+
+namespace {
+
+TEST(BackgroundFreerTest, FreesFlushedMemory) {
+  BackgroundFreer freer;
+  for (int round = 0; round < 10; ++round) {
+    for (int i = 0; i < 100; ++i) {
+      freer.enqueue(malloc(1024));
+    }
+    freer.flush();
+  }
+  // Flushing with nothing enqueued is a no-op.
+  freer.flush();
+}
+
+TEST(BackgroundFreerTest, FreesUnflushedMemoryOnDestruction) {
+  BackgroundFreer freer;
+  freer.enqueue(malloc(1024));
+  freer.flush();
+  // Never passed to the thread.
+  freer.enqueue(malloc(1024));
+}
+
+TEST(BackgroundFreerTest, NoThreadWithoutFlush) {
+  BackgroundFreer freer;
+  freer.enqueue(malloc(1024));
+}
+
+} // namespace
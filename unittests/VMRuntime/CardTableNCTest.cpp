@@ -224,6 +224,36 @@ TEST_F(CardTableNCTest, NextDirtyCard) {
   }
 }
 
+TEST_F(CardTableNCTest, Summary) {
+  constexpr size_t kAll = CardTable::kValidIndices;
+  constexpr size_t kPerSummary = CardTable::kCardsPerSummary;
+  EXPECT_EQ(kAll, table->numCardsInCleanSummaries(0, kAll));
+
+  // A single dirty card makes its whole summary entry dirty.
+  table->dirtyCardForAddress(table->indexToAddress(kPerSummary + 5));
+  EXPECT_EQ(kAll - kPerSummary, table->numCardsInCleanSummaries(0, kAll));
+  EXPECT_EQ(0, table->numCardsInCleanSummaries(kPerSummary, kPerSummary + 1));
+
+  // The search skips the clean entries before and after it.
+  auto dirty = table->findNextDirtyCard(0, kAll);
+  ASSERT_TRUE(dirty);
+  EXPECT_EQ(kPerSummary + 5, *dirty);
+  EXPECT_FALSE(table->findNextDirtyCard(kPerSummary + 6, kAll));
+
+  // A range dirties every entry it touches.
+  table->dirtyCardsForAddressRange(
+      table->indexToAddress(3 * kPerSummary - 1),
+      table->indexToAddress(3 * kPerSummary));
+  EXPECT_EQ(kAll - 3 * kPerSummary, table->numCardsInCleanSummaries(0, kAll));
+  dirty = table->findNextDirtyCard(kPerSummary + 6, kAll);
+  ASSERT_TRUE(dirty);
+  EXPECT_EQ(3 * kPerSummary - 1, *dirty);
+
+  table->clear();
+  EXPECT_EQ(kAll, table->numCardsInCleanSummaries(0, kAll));
+  EXPECT_FALSE(table->findNextDirtyCard(0, kAll));
+}
+
 } // namespace
 
 #endif // HERMESVM_GC_NONCONTIG_GENERATIONAL
@@ -267,6 +267,44 @@ TEST(DateUtilTest, LocalTimeTest) {
   hermes::oscompat::unset_env("TZ");
 }
 
+TEST(DateUtilTest, LocalTimeOffsetCacheTest) {
+  LocalTimeOffsetCache cache;
+
+#ifdef _WINDOWS
+  hermes::oscompat::set_env("TZ", "PST8PDT");
+#else
+  hermes::oscompat::set_env("TZ", "America/Los_Angeles");
+#endif
+  // Walk over 2017 in steps of about 5 hours, forwards and backwards, which
+  // crosses both DST transitions and extends the cached interval.
+  double step = 5 * MS_PER_HOUR + 12345;
+  for (double t = 1483228800000; t < 1514764800000; t += step) {
+    EXPECT_EQ(daylightSavingTA(t), cache.getDaylightSavingTA(t)) << t;
+  }
+  for (double t = 1514764800000; t > 1483228800000; t -= step) {
+    EXPECT_EQ(daylightSavingTA(t), cache.getDaylightSavingTA(t)) << t;
+  }
+  // Jumps far away from the cached interval.
+  EXPECT_EQ(MS_PER_HOUR, cache.getDaylightSavingTA(1489530532000));
+  EXPECT_EQ(0, cache.getDaylightSavingTA(1017700130000));
+  EXPECT_EQ(MS_PER_HOUR, cache.getDaylightSavingTA(1019514530000));
+  EXPECT_EQ(-2.88e+7, cache.getLocalTZA());
+  EXPECT_EQ(1530435600000, localTime(1530460800000, cache));
+  EXPECT_EQ(1530460800000, utcTime(1530435600000, cache));
+
+  // Changing TZ drops the cached values.
+#ifdef _WINDOWS
+  hermes::oscompat::set_env("TZ", "JST-9");
+#else
+  hermes::oscompat::set_env("TZ", "Asia/Tokyo");
+#endif
+  EXPECT_EQ(3.24e+7, cache.getLocalTZA());
+  EXPECT_EQ(0, cache.getDaylightSavingTA(1489530532000));
+  EXPECT_EQ(1530493200000, localTime(1530460800000, cache));
+
+  hermes::oscompat::unset_env("TZ");
+}
+
 TEST(DateUtilTest, HoursMinutesSecondsMsTest) {
   // Uses the formulae from spec, perform sanity check.
   double t = 0;
@@ -130,6 +130,59 @@ TEST_F(DictPropertyMapTest, SmokeTest) {
   }
 }
 
+TEST_F(DictPropertyMapTest, ManyPropertiesTest) {
+  // Enough properties to need several probe groups, with erased entries in
+  // between that lookups must skip and insertions may reuse.
+  const unsigned kNumProps = 300;
+  NamedPropertyDescriptor desc1{};
+
+  auto res = DictPropertyMap::create(runtime);
+  ASSERT_RETURNED(res);
+  MutableHandle<DictPropertyMap> map{runtime, res->get()};
+
+  for (unsigned i = 1; i <= kNumProps; ++i) {
+    ASSERT_RETURNED(DictPropertyMap::add(
+        map, runtime, SymbolID::unsafeCreate(i), desc1));
+  }
+  ASSERT_EQ(kNumProps, map->size());
+
+  // Erase every other property.
+  for (unsigned i = 1; i <= kNumProps; i += 2) {
+    auto found = DictPropertyMap::find(*map, SymbolID::unsafeCreate(i));
+    ASSERT_TRUE(found);
+    DictPropertyMap::erase(*map, *found);
+  }
+  ASSERT_EQ(kNumProps / 2, map->size());
+
+  for (unsigned i = 1; i <= kNumProps; ++i) {
+    auto sym = SymbolID::unsafeCreate(i);
+    auto found = DictPropertyMap::find(*map, sym);
+    if (i % 2) {
+      ASSERT_FALSE(found);
+    } else {
+      ASSERT_TRUE(found);
+      ASSERT_EQ(sym, DictPropertyMap::getDescriptorPair(*map, *found)->first);
+    }
+  }
+
+  // Symbols that were never added must not be found either.
+  for (unsigned i = kNumProps + 1; i <= 2 * kNumProps; ++i)
+    ASSERT_FALSE(DictPropertyMap::find(*map, SymbolID::unsafeCreate(i)));
+
+  // Add the erased properties back.
+  for (unsigned i = 1; i <= kNumProps; i += 2) {
+    ASSERT_RETURNED(DictPropertyMap::add(
+        map, runtime, SymbolID::unsafeCreate(i), desc1));
+  }
+  ASSERT_EQ(kNumProps, map->size());
+  for (unsigned i = 1; i <= kNumProps; ++i) {
+    auto sym = SymbolID::unsafeCreate(i);
+    auto found = DictPropertyMap::find(*map, sym);
+    ASSERT_TRUE(found);
+    ASSERT_EQ(sym, DictPropertyMap::getDescriptorPair(*map, *found)->first);
+  }
+}
+
 TEST_F(DictPropertyMapTest, CreateOverCapacityTest) {
   (void)DictPropertyMap::create(runtime);
   ASSERT_EQ(
@@ -385,6 +385,121 @@ TEST_F(GCBasicsTest, ExtraBytes) {
   }
 }
 
+#if defined(HERMESVM_GC_NONCONTIG_GENERATIONAL) && !defined(NDEBUG)
+/// Build chains of arrays interleaved with garbage in a runtime configured by
+/// \p config, collect, and check that exactly the chains survived with their
+/// references intact.
+static void checkReachableGraphSurvives(const GCConfig &config) {
+  static constexpr unsigned kNumChains = 256;
+  static constexpr unsigned kChainLength = 8;
+  auto runtime = DummyRuntime::create(getMetadataTable(), config);
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  Array *root = Array::create(rt, kNumChains);
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&root));
+  Array *chain = nullptr;
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&chain));
+  for (unsigned i = 0; i < kNumChains; ++i) {
+    chain = Array::create(rt, 1);
+    for (unsigned j = 1; j < kChainLength; ++j) {
+      // Garbage interleaved with the live objects.
+      Dummy::create(rt);
+      Array *link = Array::create(rt, 1);
+      link->values()[0].set(HermesValue::encodeObjectValue(chain), &gc);
+      chain = link;
+    }
+    root->values()[i].set(HermesValue::encodeObjectValue(chain), &gc);
+  }
+  chain = nullptr;
+
+  gc.collect();
+  GCBase::DebugHeapInfo debugInfo;
+  gc.getDebugHeapInfo(debugInfo);
+  EXPECT_EQ(1u + kNumChains * kChainLength, debugInfo.numReachableObjects);
+
+  for (unsigned i = 0; i < kNumChains; ++i) {
+    unsigned length = 0;
+    const GCHermesValue *hv = &root->values()[i];
+    while (hv->isPointer()) {
+      ++length;
+      hv = &reinterpret_cast<Array *>(hv->getPointer())->values()[0];
+    }
+    EXPECT_EQ(kChainLength, length);
+  }
+}
+
+/// Test that completing marking on several threads keeps exactly the reachable
+/// objects alive, with their references intact.
+TEST(GCParallelMarkingTest, ReachableGraphSurvives) {
+  checkReachableGraphSurvives(GCConfig::Builder(kTestGCConfigBuilder)
+                                  .withInitHeapSize(kInitHeapSize)
+                                  .withMaxHeapSize(kMaxHeapSize)
+                                  .withNumMarkingThreads(4)
+                                  .build());
+}
+
+/// Test that updating references and moving objects on several threads
+/// leaves the reachable objects intact.
+TEST(GCParallelCompactionTest, ReachableGraphSurvives) {
+  checkReachableGraphSurvives(GCConfig::Builder(kTestGCConfigBuilder)
+                                  .withInitHeapSize(kInitHeapSize)
+                                  .withMaxHeapSize(kMaxHeapSize)
+                                  .withNumCompactionThreads(4)
+                                  .build());
+}
+
+/// Test that the objects of a segment that is live enough are not moved by a
+/// full collection, and that the gaps left by dead objects are filled.
+TEST(GCInPlaceSweepTest, DenseSegmentIsNotCompacted) {
+  static constexpr unsigned kNumElements = 64;
+  auto runtime = DummyRuntime::create(
+      getMetadataTable(),
+      GCConfig::Builder(kTestGCConfigBuilder)
+          .withInitHeapSize(kInitHeapSize)
+          .withMaxHeapSize(kMaxHeapSize)
+          .withInPlaceLivePercent(50)
+          .build());
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+
+  Array *root = Array::create(rt, kNumElements);
+  rt.pointerRoots.push_back(reinterpret_cast<GCCell **>(&root));
+  for (unsigned i = 0; i < kNumElements; ++i) {
+    Array *element = Array::create(rt, 1);
+    root->values()[i].set(HermesValue::encodeObjectValue(element), &gc);
+  }
+  // Move everything into the old generation.
+  gc.collect();
+
+  // Drop every fourth element, leaving the segment mostly live.
+  std::vector<void *> before;
+  for (unsigned i = 0; i < kNumElements; ++i) {
+    if (i % 4 == 0) {
+      root->values()[i].setNonPtr(HermesValue::encodeUndefinedValue());
+    }
+    before.push_back(root->values()[i].isPointer()
+                         ? root->values()[i].getPointer()
+                         : nullptr);
+  }
+  Array *rootBefore = root;
+
+  gc.collect();
+  GCBase::DebugHeapInfo debugInfo;
+  gc.getDebugHeapInfo(debugInfo);
+  EXPECT_EQ(1u + kNumElements * 3 / 4, debugInfo.numReachableObjects);
+
+  EXPECT_EQ(rootBefore, root);
+  for (unsigned i = 0; i < kNumElements; ++i) {
+    if (before[i]) {
+      EXPECT_EQ(before[i], root->values()[i].getPointer());
+    } else {
+      EXPECT_FALSE(root->values()[i].isPointer());
+    }
+  }
+}
+#endif
+
 #ifdef HERMESVM_GCCELL_ID
 /// Test that the id is set to a unique number for each allocated object.
 TEST_F(GCBasicsTest, TestIDExists) {
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/GCCostSizingPolicy.h"
+
+#include "gtest/gtest.h"
+
+using namespace hermes::vm;
+
+namespace {
+
+using Clock = GCCostSizingPolicy::Clock;
+
+/// Record \p count collections that each pause for \p pauseMs after running
+/// the mutator for \p intervalMs, starting at \p now.  \return the end of the
+/// last collection.
+Clock::time_point recordCollections(
+    GCCostSizingPolicy &policy,
+    unsigned count,
+    unsigned pauseMs,
+    unsigned intervalMs,
+    Clock::time_point now) {
+  for (unsigned i = 0; i < count; ++i) {
+    now += std::chrono::milliseconds(intervalMs);
+    policy.recordCollection(pauseMs / 1000.0, now);
+  }
+  return now;
+}
+
+TEST(GCCostSizingPolicyTest, DisabledWithoutTarget) {
+  GCCostSizingPolicy policy(0.0);
+  EXPECT_FALSE(policy.enabled());
+  recordCollections(policy, 10, 50, 100, Clock::now());
+  EXPECT_EQ(1.0, policy.takeSizeFactor());
+  EXPECT_FALSE(GCCostSizingPolicy(1.5).enabled());
+}
+
+TEST(GCCostSizingPolicyTest, GrowsWhenCostIsHigh) {
+  GCCostSizingPolicy policy(0.1);
+  // Every collection takes 20% of the time.
+  auto now = recordCollections(policy, 2, 20, 100, Clock::now());
+  // Not enough samples yet.
+  EXPECT_EQ(1.0, policy.takeSizeFactor());
+  recordCollections(policy, 3, 20, 100, now);
+  EXPECT_NEAR(0.2, policy.costRatio(), 1e-9);
+  EXPECT_NEAR(2.0, policy.takeSizeFactor(), 1e-9);
+  // Sampling starts over after a resize.
+  EXPECT_EQ(1.0, policy.takeSizeFactor());
+}
+
+TEST(GCCostSizingPolicyTest, ShrinksWhenCostIsLow) {
+  GCCostSizingPolicy policy(0.1);
+  // Every collection takes 1% of the time.
+  recordCollections(policy, 5, 1, 100, Clock::now());
+  EXPECT_LT(policy.takeSizeFactor(), 1.0);
+}
+
+TEST(GCCostSizingPolicyTest, KeepsSizeNearTarget) {
+  GCCostSizingPolicy policy(0.1);
+  recordCollections(policy, 10, 8, 100, Clock::now());
+  EXPECT_EQ(1.0, policy.takeSizeFactor());
+}
+
+} // namespace
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifdef HERMESVM_GC_NONCONTIG_GENERATIONAL
+#ifndef NDEBUG
+
+#include "gtest/gtest.h"
+
+#include "EmptyCell.h"
+#include "TestHelpers.h"
+#include "hermes/VM/AlignedHeapSegment.h"
+#include "hermes/VM/GC.h"
+
+#include <chrono>
+
+using namespace hermes;
+using namespace hermes::vm;
+
+namespace {
+
+const MetadataTableForTests getMetadataTable() {
+  static const Metadata storage[] = {
+      Metadata() // Uninitialized
+  };
+  return MetadataTableForTests(storage);
+}
+
+constexpr size_t kHeapSizeHint =
+    AlignedHeapSegment::maxSize() * GC::kYoungGenFractionDenom;
+
+const GCConfig kGCConfig = TestGCConfigFixedSize(kHeapSizeHint);
+
+/// An eighth of the young generation.
+using EighthCell = EmptyCell<AlignedHeapSegment::maxSize() / 8>;
+
+using steady_clock = std::chrono::steady_clock;
+
+steady_clock::time_point inAnHour() {
+  return steady_clock::now() + std::chrono::hours(1);
+}
+
+TEST(GCIdleCollectionNCTest, YoungGenCollectedWhenMostlyFull) {
+  auto runtime = DummyRuntime::create(getMetadataTable(), kGCConfig);
+  DummyRuntime &rt = *runtime;
+  GC &gc = rt.gc;
+
+  // Without an earlier collection, there is no way to tell how long one takes.
+  for (size_t i = 0; i < 5; ++i) {
+    EighthCell::create(rt);
+  }
+  EXPECT_FALSE(gc.collectDuringIdle(inAnHour()));
+
+  gc.youngGenCollect();
+  ASSERT_EQ(1u, gc.numYoungGCs());
+
+  // The young generation is almost empty.
+  EighthCell::create(rt);
+  EXPECT_FALSE(gc.collectDuringIdle(inAnHour()));
+
+  for (size_t i = 0; i < 4; ++i) {
+    EighthCell::create(rt);
+  }
+  // The deadline has already passed.
+  EXPECT_FALSE(gc.collectDuringIdle(steady_clock::now()));
+  EXPECT_EQ(1u, gc.numYoungGCs());
+
+  EXPECT_TRUE(gc.collectDuringIdle(inAnHour()));
+  EXPECT_EQ(2u, gc.numYoungGCs());
+  EXPECT_EQ(0u, gc.numFullGCs());
+}
+
+} // namespace
+
+#endif // !NDEBUG
+#endif // HERMESVM_GC_NONCONTIG_GENERATIONAL
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/GCTelemetry.h"
+
+#include "gtest/gtest.h"
+
+using namespace hermes::vm;
+
+namespace {
+
+TEST(GCTelemetryTest, EmptySummary) {
+  GCTelemetry telemetry;
+  GCTelemetrySummary summary = telemetry.summarize(std::chrono::seconds(1));
+  EXPECT_EQ(0u, summary.youngGen.numCollections);
+  EXPECT_EQ(0u, summary.full.numCollections);
+  EXPECT_EQ(0.0, summary.youngGen.max);
+  EXPECT_EQ(0.0, summary.allocationRate);
+}
+
+TEST(GCTelemetryTest, PausePercentiles) {
+  GCTelemetry telemetry;
+  // Young collections pausing for 1ms, 2ms, ..., 100ms.
+  for (unsigned i = 100; i >= 1; --i) {
+    telemetry.recordCollection(
+        GCTelemetry::Kind::YoungGen, i / 1000.0, 10, 0, 1000);
+  }
+  telemetry.recordCollection(GCTelemetry::Kind::Full, 0.5, 0, 0, 2000);
+
+  GCTelemetrySummary summary = telemetry.summarize(std::chrono::hours(1));
+  EXPECT_EQ(100u, summary.youngGen.numCollections);
+  EXPECT_DOUBLE_EQ(50.0, summary.youngGen.p50);
+  EXPECT_DOUBLE_EQ(90.0, summary.youngGen.p90);
+  EXPECT_DOUBLE_EQ(99.0, summary.youngGen.p99);
+  EXPECT_DOUBLE_EQ(100.0, summary.youngGen.max);
+  EXPECT_EQ(1000u, summary.youngGen.promotedBytes);
+
+  EXPECT_EQ(1u, summary.full.numCollections);
+  EXPECT_DOUBLE_EQ(500.0, summary.full.p50);
+  EXPECT_DOUBLE_EQ(500.0, summary.full.max);
+  EXPECT_EQ(2000u, summary.heapSize);
+}
+
+TEST(GCTelemetryTest, OnlyRecentCollectionsAreKept) {
+  GCTelemetry telemetry;
+  for (size_t i = 0; i < GCTelemetry::kCapacity; ++i) {
+    telemetry.recordCollection(GCTelemetry::Kind::YoungGen, 1.0, 0, 0, 0);
+  }
+  for (size_t i = 0; i < 10; ++i) {
+    telemetry.recordCollection(GCTelemetry::Kind::YoungGen, 0.001, 0, 0, 0);
+  }
+  GCTelemetrySummary summary = telemetry.summarize(std::chrono::hours(1));
+  EXPECT_EQ(GCTelemetry::kCapacity, summary.youngGen.numCollections);
+  // The oldest 10 long pauses were overwritten by the short ones.
+  EXPECT_DOUBLE_EQ(1000.0, summary.youngGen.max);
+  EXPECT_DOUBLE_EQ(1000.0, summary.youngGen.p50);
+}
+
+} // namespace
@@ -7,14 +7,20 @@
 #include "hermes/VM/HeapSnapshot.h"
 #include "TestHelpers.h"
 #include "gtest/gtest.h"
+#include "hermes/Parser/JSONParser.h"
+#include "hermes/VM/ArrayStorage.h"
 #include "hermes/VM/CellKind.h"
 #include "hermes/VM/GC.h"
 #include "hermes/VM/GCPointer-inline.h"
 #include "hermes/VM/HermesValue.h"
 #include "hermes/VM/SymbolID.h"
 
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <algorithm>
+
 using namespace hermes::vm;
 
 // Only the main NCGen needs to support snapshots
@@ -172,6 +178,204 @@ TEST(HeapSnapshotTest, SnapshotTest) {
   ASSERT_EQ(expected, result);
 }
 
+/// The number of fields of each node and edge in a snapshot.
+static constexpr size_t kNodeFieldCount = 6;
+static constexpr size_t kEdgeFieldCount = 3;
+/// The index of the edge_count field of a node.
+static constexpr size_t kNodeEdgeCountField = 4;
+/// The index of the id field of a node.
+static constexpr size_t kNodeIdField = 2;
+/// The index of the to_node field of an edge.
+static constexpr size_t kEdgeToNodeField = 2;
+
+/// The flat arrays of a snapshot.
+struct ParsedSnapshot {
+  std::vector<uint64_t> nodes;
+  std::vector<uint64_t> edges;
+  std::vector<std::string> strings;
+};
+
+/// Parse the snapshot \p json into \p snap, checking that it is valid JSON
+/// and consistent: the nodes and edges arrays hold whole records, the edge
+/// counts of the nodes add up to the number of edges, and every edge points
+/// to the start of a node.
+static void parseSnapshot(const std::string &json, ParsedSnapshot &snap) {
+  parser::JSLexer::Allocator alloc;
+  parser::JSONFactory factory(alloc);
+  SourceErrorManager sm;
+  parser::JSONParser jsonParser(factory, json, sm);
+  auto parsed = jsonParser.parse();
+  ASSERT_TRUE(parsed.hasValue());
+  auto *root = llvm::dyn_cast<parser::JSONObject>(*parsed);
+  ASSERT_NE(nullptr, root);
+
+  auto readNumbers = [root](const char *name, std::vector<uint64_t> &out) {
+    auto *array = llvm::dyn_cast_or_null<parser::JSONArray>(root->get(name));
+    ASSERT_NE(nullptr, array) << name;
+    for (const parser::JSONValue *value : *array) {
+      auto *num = llvm::dyn_cast<parser::JSONNumber>(value);
+      ASSERT_NE(nullptr, num) << name;
+      out.push_back(static_cast<uint64_t>(num->getValue()));
+    }
+  };
+  readNumbers("nodes", snap.nodes);
+  readNumbers("edges", snap.edges);
+  auto *strings =
+      llvm::dyn_cast_or_null<parser::JSONArray>(root->get("strings"));
+  ASSERT_NE(nullptr, strings);
+  for (const parser::JSONValue *value : *strings) {
+    auto *str = llvm::dyn_cast<parser::JSONString>(value);
+    ASSERT_NE(nullptr, str);
+    snap.strings.push_back(str->str().str());
+  }
+
+  ASSERT_EQ(0u, snap.nodes.size() % kNodeFieldCount);
+  ASSERT_EQ(0u, snap.edges.size() % kEdgeFieldCount);
+  uint64_t edgeCount = 0;
+  for (size_t i = 0; i < snap.nodes.size(); i += kNodeFieldCount) {
+    edgeCount += snap.nodes[i + kNodeEdgeCountField];
+  }
+  EXPECT_EQ(edgeCount * kEdgeFieldCount, snap.edges.size());
+  for (size_t i = 0; i < snap.edges.size(); i += kEdgeFieldCount) {
+    uint64_t toNode = snap.edges[i + kEdgeToNodeField];
+    EXPECT_LT(toNode, snap.nodes.size());
+    EXPECT_EQ(0u, toNode % kNodeFieldCount);
+  }
+}
+
+/// \return the edge count of the node with \p id in \p snap, or -1 if there
+/// is no such node.
+static int64_t edgeCountOfNode(const ParsedSnapshot &snap, uint64_t id) {
+  for (size_t i = 0; i < snap.nodes.size(); i += kNodeFieldCount) {
+    if (snap.nodes[i + kNodeIdField] == id) {
+      return snap.nodes[i + kNodeEdgeCountField];
+    }
+  }
+  return -1;
+}
+
+TEST(HeapSnapshotTest, SnapshotToFDTest) {
+  auto runtime = DummyRuntime::create(
+      getMetadataTable(),
+      GCConfig::Builder()
+          .withInitHeapSize(1 << 20)
+          .withMaxHeapSize(1 << 20)
+          .build());
+  DummyRuntime &rt = *runtime;
+  auto &gc = rt.gc;
+  GCScope gcScope(&rt);
+
+  // A list long enough for the snapshot to take more than one chunk.
+  auto head = rt.makeMutableHandle(DummyObject::create(rt));
+  auto newHead = rt.makeMutableHandle<DummyObject>(nullptr);
+  for (int i = 0; i < 4000; ++i) {
+    newHead = DummyObject::create(rt);
+    newHead->setPointer(rt, *head);
+    head = *newHead;
+  }
+
+  std::string expected;
+  llvm::raw_string_ostream str(expected);
+  gc.createSnapshot(str, true);
+  str.flush();
+  ASSERT_GT(expected.size(), GCBase::kSnapshotChunkSize);
+
+  llvm::SmallString<64> path;
+  int fd;
+  ASSERT_FALSE(
+      llvm::sys::fs::createTemporaryFile("heapsnapshot", "json", fd, path));
+  gc.createSnapshotToFD(fd, HeapSnapshotOptions());
+  // The file descriptor is left open for the caller.
+  {
+    llvm::raw_fd_ostream os(fd, /* shouldClose */ true);
+    os << "\n";
+  }
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  llvm::sys::fs::remove(path);
+  ASSERT_TRUE(bool(buffer));
+  EXPECT_EQ(expected + "\n", (*buffer)->getBuffer().str());
+
+  ParsedSnapshot snap;
+  ASSERT_NO_FATAL_FAILURE(parseSnapshot(expected, snap));
+  // The roots, and the list.
+  EXPECT_EQ(4002u * kNodeFieldCount, snap.nodes.size());
+}
+
+using HeapSnapshotRuntimeTest = RuntimeTestFixture;
+
+TEST_F(HeapSnapshotRuntimeTest, SampledEdgesTest) {
+  const size_t kElements = 1000;
+  const uint32_t kMaxEdges = 10;
+  auto str = StringPrimitive::createNoThrow(runtime, "element");
+  MutableHandle<ArrayStorage> array(runtime);
+  array = vmcast<ArrayStorage>(*ArrayStorage::create(runtime, kElements));
+  for (size_t i = 0; i < kElements; ++i) {
+    ASSERT_RETURNED(ArrayStorage::push_back(array, runtime, str));
+  }
+
+  auto &gc = runtime->getHeap();
+  std::string fullJSON;
+  llvm::raw_string_ostream fullStream(fullJSON);
+  gc.createSnapshot(fullStream, true);
+  fullStream.flush();
+  ParsedSnapshot full;
+  ASSERT_NO_FATAL_FAILURE(parseSnapshot(fullJSON, full));
+
+  HeapSnapshotOptions options;
+  options.maxEdgesPerNode = kMaxEdges;
+  std::string sampledJSON;
+  llvm::raw_string_ostream sampledStream(sampledJSON);
+  gc.createSnapshot(sampledStream, options);
+  sampledStream.flush();
+  ParsedSnapshot sampled;
+  ASSERT_NO_FATAL_FAILURE(parseSnapshot(sampledJSON, sampled));
+
+  // The same nodes are in both snapshots, but none has more than kMaxEdges
+  // edges once they are sampled.
+  ASSERT_EQ(full.nodes.size(), sampled.nodes.size());
+  int64_t arrayId = -1;
+  for (size_t i = 0; i < full.nodes.size(); i += kNodeFieldCount) {
+    EXPECT_EQ(full.nodes[i + kNodeIdField], sampled.nodes[i + kNodeIdField]);
+    EXPECT_LE(sampled.nodes[i + kNodeEdgeCountField], kMaxEdges);
+    if (full.nodes[i + kNodeEdgeCountField] == kElements) {
+      arrayId = full.nodes[i + kNodeIdField];
+    }
+  }
+  ASSERT_NE(-1, arrayId);
+  EXPECT_EQ(int64_t(kMaxEdges), edgeCountOfNode(sampled, arrayId));
+  EXPECT_LT(sampled.edges.size(), full.edges.size());
+}
+
+TEST_F(HeapSnapshotRuntimeTest, TruncatedStringsTest) {
+  const uint32_t kMaxLength = 16;
+  std::string longStr = "heapsnapshottest";
+  longStr.append(10000, 'x');
+  auto str = runtime->makeHandle<StringPrimitive>(*StringPrimitive::create(
+      runtime, ASCIIRef(longStr.data(), longStr.size())));
+
+  auto &gc = runtime->getHeap();
+  HeapSnapshotOptions options;
+  options.maxStringLength = kMaxLength;
+  std::string json;
+  llvm::raw_string_ostream stream(json);
+  gc.createSnapshot(stream, options);
+  stream.flush();
+
+  ParsedSnapshot snap;
+  ASSERT_NO_FATAL_FAILURE(parseSnapshot(json, snap));
+  // Only the start of the string is kept.
+  EXPECT_NE(
+      snap.strings.end(),
+      std::find(
+          snap.strings.begin(),
+          snap.strings.end(),
+          longStr.substr(0, kMaxLength)));
+  for (const std::string &s : snap.strings) {
+    EXPECT_EQ(std::string::npos, s.find(longStr.substr(0, kMaxLength + 1)));
+  }
+  EXPECT_EQ(longStr.size(), str->getStringLength());
+}
+
 } // namespace heapsnapshottest
 } // namespace unittest
 } // namespace hermes
@@ -400,4 +400,100 @@ TEST_F(HiddenClassTest, UpdatePropertyFlagsWithoutTransitionsTest) {
   ASSERT_NE(*addRes->first, *partlyFrozenSingleton);
   ASSERT_EQ(addRes->first->getNumProperties(), 4);
 }
+
+TEST_F(HiddenClassTest, WideFanOut) {
+  GCScope gcScope{runtime, "HiddenClassTest.WideFanOut", 64};
+
+  auto aHnd = *runtime->getIdentifierTable().getSymbolHandle(
+      runtime, createUTF16Ref(u"a"));
+  auto bHnd = *runtime->getIdentifierTable().getSymbolHandle(
+      runtime, createUTF16Ref(u"b"));
+  auto cHnd = *runtime->getIdentifierTable().getSymbolHandle(
+      runtime, createUTF16Ref(u"c"));
+  auto dHnd = *runtime->getIdentifierTable().getSymbolHandle(
+      runtime, createUTF16Ref(u"d"));
+  // The handles above keep these alive.
+  SymbolID names[] = {*bHnd, *cHnd, *dHnd};
+  const auto flags = PropertyFlags::defaultNewNamedPropertyFlags();
+
+  auto rootHnd = runtime->makeHandle<HiddenClass>(
+      runtime->ignoreAllocationFailure(HiddenClass::createRoot(runtime)));
+  auto addRes = HiddenClass::addProperty(rootHnd, runtime, *aHnd, flags);
+  ASSERT_RETURNED(addRes);
+  auto base = addRes->first;
+
+  // Several children of the same class, each adding a different property.
+  MutableHandle<HiddenClass> children[3] = {
+      MutableHandle<HiddenClass>{runtime},
+      MutableHandle<HiddenClass>{runtime},
+      MutableHandle<HiddenClass>{runtime}};
+  for (unsigned i = 0; i < 3; ++i) {
+    auto childRes = HiddenClass::addProperty(base, runtime, names[i], flags);
+    ASSERT_RETURNED(childRes);
+    ASSERT_EQ(1u, childRes->second);
+    children[i] = *childRes->first;
+  }
+  ASSERT_FALSE(base->isKnownLeaf());
+
+  // Each child sees its parent's property and its own, but none of its
+  // siblings'.
+  NamedPropertyDescriptor desc;
+  for (unsigned i = 0; i < 3; ++i) {
+    ASSERT_TRUE(HiddenClass::findProperty(
+        children[i], runtime, *aHnd, PropertyFlags::invalid(), desc));
+    ASSERT_EQ(0u, desc.slot);
+    for (unsigned j = 0; j < 3; ++j) {
+      auto found = HiddenClass::findProperty(
+          children[i], runtime, names[j], PropertyFlags::invalid(), desc);
+      ASSERT_EQ(i == j, found.hasValue());
+    }
+  }
+
+  // Existing transitions are still found, and the parent is unaffected.
+  for (unsigned i = 0; i < 3; ++i) {
+    auto childRes = HiddenClass::addProperty(base, runtime, names[i], flags);
+    ASSERT_RETURNED(childRes);
+    ASSERT_EQ(*children[i], *childRes->first);
+    ASSERT_FALSE(HiddenClass::findProperty(
+        base, runtime, names[i], PropertyFlags::invalid(), desc));
+  }
+  ASSERT_TRUE(HiddenClass::findProperty(
+      base, runtime, *aHnd, PropertyFlags::invalid(), desc));
+}
+
+TEST_F(HiddenClassTest, LargeClassSharedBySecondObject) {
+  const unsigned kNumProps = HiddenClass::kLargeClassThreshold + 6;
+  std::vector<Handle<SymbolID>> names;
+  for (unsigned i = 0; i < kNumProps; ++i) {
+    std::string name = "p" + std::to_string(i);
+    names.push_back(*runtime->getIdentifierTable().getSymbolHandle(
+        runtime, ASCIIRef(name.data(), name.size())));
+  }
+  const auto flags = PropertyFlags::defaultNewNamedPropertyFlags();
+
+  auto rootHnd = runtime->makeHandle<HiddenClass>(
+      runtime->ignoreAllocationFailure(HiddenClass::createRoot(runtime)));
+  // Add all the properties to an object with the root class, and return the
+  // resulting class.
+  auto addAll = [&]() {
+    MutableHandle<HiddenClass> clazz{runtime, *rootHnd};
+    for (unsigned i = 0; i < kNumProps; ++i) {
+      auto addRes = HiddenClass::addProperty(clazz, runtime, *names[i], flags);
+      EXPECT_EQ(i, addRes->second);
+      clazz = *addRes->first;
+    }
+    EXPECT_EQ(kNumProps, clazz->getNumProperties());
+    return runtime->makeHandle(*clazz);
+  };
+
+  // The first object goes to dictionary mode past the threshold.
+  auto first = addAll();
+  ASSERT_TRUE(first->isDictionary());
+
+  // The next ones share a normal class.
+  auto second = addAll();
+  ASSERT_FALSE(second->isDictionary());
+  auto third = addAll();
+  ASSERT_EQ(*second, *third);
+}
 } // namespace
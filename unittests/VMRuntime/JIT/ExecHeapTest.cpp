@@ -8,6 +8,8 @@
 
 #include "gtest/gtest.h"
 
+#include <cstring>
+
 using namespace hermes::vm;
 
 namespace {
@@ -44,6 +46,8 @@ TEST(ExecHeapTest, SmokeTest) {
 
   auto r1 = eh.alloc({10, 20});
   EXPECT_TRUE(r1);
+  EXPECT_EQ(16u + 32u, eh.getAllocatedSize());
+  EXPECT_EQ(1024u * 4, eh.getMappedSize());
 
   assertDump(
       eh,
@@ -65,7 +69,9 @@ TEST(ExecHeapTest, SmokeTest) {
   // Free the just allocated blocks.
   eh.free(*r1);
 
-  // It should be empty again.
+  // It should be empty again, and the empty pool unmapped.
+  EXPECT_EQ(0u, eh.getAllocatedSize());
+  EXPECT_EQ(0u, eh.getMappedSize());
   assertDump(
       eh,
       "== ExecHeap 3072+1024\n"
@@ -123,4 +129,36 @@ TEST(ExecHeapTest, SmokeTest) {
   eh.dump(llvm::errs(), true);
 }
 
+TEST(ExecHeapTest, WriteXorExecuteTest) {
+  ExecHeap eh{4096, 4096, 4096 * 4, true};
+  EXPECT_TRUE(eh.isWriteXorExecute());
+  ASSERT_TRUE(eh.addPool());
+  auto r1 = eh.alloc({16, 16});
+  ASSERT_TRUE(r1);
+
+  {
+    ExecHeap::WriteAccess access{eh};
+    memset(r1->first, 0xAB, 16);
+    {
+      // Nested accesses keep the memory writable.
+      ExecHeap::WriteAccess nested{eh};
+      memset(r1->second, 0xCD, 16);
+    }
+    r1->first[15] = 0xEF;
+
+    // Pools added while writing are writable too.
+    auto r2 = eh.alloc({4096, 4096});
+    EXPECT_FALSE(r2);
+    ASSERT_TRUE(eh.addPool());
+    r2 = eh.alloc({4096, 4096});
+    ASSERT_TRUE(r2);
+    r2->first[0] = 1;
+  }
+
+  // The memory stays readable once it is executable again.
+  EXPECT_EQ(0xAB, r1->first[0]);
+  EXPECT_EQ(0xEF, r1->first[15]);
+  EXPECT_EQ(0xCD, r1->second[15]);
+}
+
 } // namespace
@@ -110,4 +110,24 @@ TEST(PoolHeapTest, SmokeTest) {
       "  Used at        0 size 64");
 }
 
+TEST(PoolHeapTest, AllocatedSizeTest) {
+  alignas(PoolHeap::kAlignment) char buf[64];
+  PoolHeap pool(buf, sizeof(buf));
+  EXPECT_EQ(0u, pool.getAllocatedSize());
+
+  void *b0 = pool.alloc(10);
+  void *b1 = pool.alloc(40);
+  EXPECT_EQ(64u, pool.getAllocatedSize());
+
+  pool.freeRemaining(b1, 20);
+  EXPECT_EQ(48u, pool.getAllocatedSize());
+
+  // Freed blocks are coalesced, so the whole buffer can be allocated again.
+  pool.free(b0);
+  pool.free(b1);
+  EXPECT_EQ(0u, pool.getAllocatedSize());
+  EXPECT_EQ(buf, pool.alloc(64));
+  EXPECT_EQ(64u, pool.getAllocatedSize());
+}
+
 } // namespace
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/JIT/x86-64/RegExpJIT.h"
+
+#include "hermes/Regex/Compiler.h"
+#include "hermes/Regex/RegexTraits.h"
+#include "hermes/VM/JIT/x86-64/JIT.h"
+
+#include "gtest/gtest.h"
+
+using namespace hermes::regex;
+using namespace hermes::vm;
+using namespace hermes::vm::x86_64;
+
+namespace {
+
+std::vector<uint8_t> compileRegex(
+    const std::u16string &pattern,
+    constants::SyntaxFlags flags = {}) {
+  Regex<U16RegexTraits> re(
+      pattern.data(), pattern.data() + pattern.size(), flags);
+  EXPECT_TRUE(re.valid());
+  return re.compile();
+}
+
+/// \return the ranges of \p m relative to \p base, or "none" if \p result is
+/// not a match.
+template <typename CharT>
+std::string describe(
+    MatchRuntimeResult result,
+    const MatchResults<const CharT *> &m,
+    const CharT *base) {
+  if (result != MatchRuntimeResult::Match)
+    return "none";
+  std::string str;
+  for (const auto &sub : m) {
+    if (!sub.matched) {
+      str += "unmatched ";
+      continue;
+    }
+    str += std::to_string(sub.first - base) + "-" +
+        std::to_string(sub.second - base) + " ";
+  }
+  return str;
+}
+
+/// Check that searching \p input from every offset with the native code of
+/// \p pattern gives the same result as interpreting its bytecode.
+void expectSameAsInterpreter(
+    JITContext &context,
+    const std::u16string &pattern,
+    const std::u16string &input,
+    constants::SyntaxFlags flags = {}) {
+  auto bytecode = compileRegex(pattern, flags);
+  auto jit = JITCompiledRegExp::compile(context, bytecode);
+  ASSERT_TRUE(jit) << "pattern was not compiled";
+  bool ascii = std::all_of(
+      input.begin(), input.end(), [](char16_t c) { return c < 128; });
+  std::string input8(input.begin(), input.end());
+  for (size_t offset = 0; offset <= input.size(); ++offset) {
+    auto matchFlags = offset ? constants::matchPreviousCharAvailable
+                             : constants::matchDefault;
+    MatchResults<const char16_t *> expected, actual;
+    auto expectedResult = searchWithBytecode(
+        bytecode,
+        input.data() + offset,
+        input.data() + input.size(),
+        expected,
+        matchFlags);
+    auto actualResult = jit->search(
+        input.data() + offset,
+        input.data() + input.size(),
+        actual,
+        matchFlags);
+    EXPECT_EQ(
+        describe(expectedResult, expected, input.data()),
+        describe(actualResult, actual, input.data()))
+        << "offset " << offset;
+
+    if (!ascii)
+      continue;
+    auto matchFlags8 =
+        (constants::MatchFlagType)(matchFlags | constants::matchInputAllAscii);
+    MatchResults<const char *> expected8, actual8;
+    expectedResult = searchWithBytecode(
+        bytecode,
+        input8.data() + offset,
+        input8.data() + input8.size(),
+        expected8,
+        matchFlags8);
+    actualResult = jit->search(
+        input8.data() + offset,
+        input8.data() + input8.size(),
+        actual8,
+        matchFlags8);
+    EXPECT_EQ(
+        describe(expectedResult, expected8, input8.data()),
+        describe(actualResult, actual8, input8.data()))
+        << "ASCII, offset " << offset;
+  }
+}
+
+TEST(RegExpJITTest, MatchesLikeInterpreter) {
+  JITContext context{true, 1 << 20, 1 << 22};
+  expectSameAsInterpreter(context, u"abc", u"xxabcabc");
+  expectSameAsInterpreter(context, u"^\\d{3}-\\d{4}$", u"555-1234");
+  expectSameAsInterpreter(context, u"^\\d{3}-\\d{4}$", u"555-12345");
+  expectSameAsInterpreter(
+      context, u"(\\w+)@(\\w+)\\.com", u"mail bob@example.com!");
+  expectSameAsInterpreter(context, u"a.*b", u"xaxxbxxbx");
+  expectSameAsInterpreter(context, u"a.*?b", u"xaxxbxxbx");
+  expectSameAsInterpreter(context, u"(a+)(a+)(a*)$", u"baaaa");
+  expectSameAsInterpreter(context, u"(a+?)(a{2,3})", u"aaaaaa");
+  expectSameAsInterpreter(context, u"x{2,}y", u"xyxxxxy");
+  expectSameAsInterpreter(context, u"[^\\s,]+", u"  one, two　three");
+  expectSameAsInterpreter(context, u"[\\D\\s]+", u"12 ab  34");
+  expectSameAsInterpreter(context, u"\\s+$", u"trailing \t\n");
+  expectSameAsInterpreter(context, u".+", u"line\nnext last");
+  expectSameAsInterpreter(context, u"ā+b", u"aāāb");
+  expectSameAsInterpreter(
+      context, u"HELLO world", u"say Hello World", constants::icase);
+  expectSameAsInterpreter(context, u"", u"abc");
+  expectSameAsInterpreter(context, u"$", u"abc");
+}
+
+TEST(RegExpJITTest, UnsupportedPrograms) {
+  JITContext context{true, 1 << 20, 1 << 22};
+  for (const char16_t *pattern :
+       {u"a|b", u"(a)\\1", u"a(?=b)", u"\\bword", u"(ab)+", u"(?:a*b)*"}) {
+    EXPECT_FALSE(JITCompiledRegExp::compile(context, compileRegex(pattern)))
+        << "pattern should not be compiled";
+  }
+  // Brackets and anchors depend on the case and line semantics.
+  EXPECT_FALSE(JITCompiledRegExp::compile(
+      context, compileRegex(u"[a-z]", constants::icase)));
+  EXPECT_FALSE(JITCompiledRegExp::compile(
+      context, compileRegex(u"^a", constants::multiline)));
+}
+
+} // namespace
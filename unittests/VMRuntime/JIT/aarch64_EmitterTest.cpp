@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/JIT/aarch64/Emitter.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace hermes::vm::aarch64;
+
+namespace {
+
+/// The encodings are compared as words rather than disassembled, so that the
+/// test runs on hosts whose LLVM lacks the AArch64 disassembler.
+TEST(aarch64_EmitterTest, Test) {
+  uint8_t buf[64];
+  Emitter emitter{buf};
+
+  auto words = [&]() {
+    std::vector<uint32_t> result{};
+    for (const uint8_t *p = buf; p != emitter.current(); p += 4) {
+      uint32_t word;
+      memcpy(&word, p, sizeof(word));
+      result.push_back(word);
+    }
+    return result;
+  };
+
+#define CHECK(...)                                             \
+  EXPECT_EQ((std::vector<uint32_t>{__VA_ARGS__}), words()); \
+  emitter = Emitter{buf}
+
+  emitter.movRegToReg(Reg::x0, Reg::x19);
+  CHECK(0xAA0003F3u); // mov x19, x0
+
+  emitter.movRegToReg(Reg::sp, Reg::x29);
+  CHECK(0x910003FDu); // mov x29, sp
+
+  emitter.movImmToReg(10, Reg::x0);
+  CHECK(0xD2800140u); // mov x0, #10
+
+  emitter.movImmToReg(0xfff9000000000000ull, Reg::x21);
+  CHECK(0xD2FFFF35u); // mov x21, #-1970324836974592
+
+  emitter.movImmToReg(0xfff8000000000000ull | 0x12345, Reg::x16);
+  // mov x16, #9029; movk x16, #1, lsl #16; movk x16, #65528, lsl #48
+  CHECK(0xD28468B0u, 0xF2A00030u, 0xF2FFFF10u);
+
+  emitter.movImmToReg((uint64_t)-2, Reg::x1);
+  CHECK(0x92800021u); // mov x1, #-2
+
+  emitter.addImm(Reg::x20, 16, Reg::x1);
+  CHECK(0x91004281u); // add x1, x20, #16
+
+  emitter.subImm(Reg::x20, 4095, Reg::x1);
+  CHECK(0xD13FFE81u); // sub x1, x20, #4095
+
+  emitter.addOffset(Reg::x20, -24, Reg::x1);
+  CHECK(0xD1006281u); // sub x1, x20, #24
+
+  emitter.cmpRegToReg(Reg::x16, Reg::x21);
+  CHECK(0xEB15021Fu); // cmp x16, x21
+
+  emitter.cmpWRegToWReg(Reg::x1, Reg::x2);
+  CHECK(0x6B02003Fu); // cmp w1, w2
+
+  emitter.testLowByte(Reg::x0);
+  CHECK(0x72001C1Fu); // tst w0, #0xff
+
+  emitter.ldrRMToReg(Reg::x20, -8, Reg::x0);
+  CHECK(0xF85F8280u); // ldur x0, [x20, #-8]
+
+  emitter.ldrRMToReg(Reg::x19, 64, Reg::x0);
+  CHECK(0xF9402260u); // ldr x0, [x19, #64]
+
+  emitter.ldrRMToReg(Reg::x20, -4096, Reg::x0);
+  CHECK(0x9281FFF1u, 0xF8716A80u); // mov x17, #-4096; ldr x0, [x20, x17]
+
+  emitter.ldrRMToReg(Reg::x20, -100000, Reg::x0);
+  // mov x17, #-34464; movk x17, #65534, lsl #16; ldr x0, [x20, x17]
+  CHECK(0x9290D3F1u, 0xF2BFFFD1u, 0xF8716A80u);
+
+  emitter.strRegToRM(Reg::xzr, Reg::x20, -16);
+  CHECK(0xF81F029Fu); // stur xzr, [x20, #-16]
+
+  emitter.ldrRMToWReg(Reg::x20, 8, Reg::x1);
+  CHECK(0xB9400A81u); // ldr w1, [x20, #8]
+
+  emitter.ldrRMToFReg(Reg::x20, -32, FReg::d0);
+  CHECK(0xFC5E0280u); // ldur d0, [x20, #-32]
+
+  emitter.strFRegToRM(FReg::d0, Reg::x20, 40000);
+  CHECK(0xD2938811u, 0xFC316A80u); // mov x17, #40000; str d0, [x20, x17]
+
+  emitter.strRegToRMPreIndex(Reg::x16, Reg::x0, -8);
+  CHECK(0xF81F8C10u); // str x16, [x0, #-8]!
+
+  emitter.stpPreIndex(Reg::x29, Reg::x30, -48);
+  CHECK(0xA9BD7BFDu); // stp x29, x30, [sp, #-48]!
+
+  emitter.stp(Reg::x19, Reg::x20, 16);
+  CHECK(0xA90153F3u); // stp x19, x20, [sp, #16]
+
+  emitter.ldp(Reg::x21, Reg::x22, 32);
+  CHECK(0xA9425BF5u); // ldp x21, x22, [sp, #32]
+
+  emitter.ldpPostIndex(Reg::x29, Reg::x30, 48);
+  CHECK(0xA8C37BFDu); // ldp x29, x30, [sp], #48
+
+  emitter.faddRegs(FReg::d0, FReg::d1, FReg::d0);
+  CHECK(0x1E612800u); // fadd d0, d0, d1
+
+  emitter.fdivRegs(FReg::d0, FReg::d1, FReg::d2);
+  CHECK(0x1E611802u); // fdiv d2, d0, d1
+
+  emitter.fcmpRegs(FReg::d0, FReg::d1);
+  CHECK(0x1E612000u); // fcmp d0, d1
+
+  emitter.b(emitter.current() + 8);
+  CHECK(0x14000002u); // b #8
+
+  emitter.bcond(CCode::NE, emitter.current() - 8);
+  CHECK(0x54FFFFC1u); // b.ne #-8
+
+  emitter.bcondFar(CCode::HS, emitter.current() + (4 << 20));
+  CHECK(0x54000043u, 0x140FFFFFu); // b.lo #8; b #4194300
+
+  emitter.blr(Reg::x16);
+  CHECK(0xD63F0200u); // blr x16
+
+  emitter.br(Reg::x1);
+  CHECK(0xD61F0020u); // br x1
+
+  emitter.ret();
+  CHECK(0xD65F03C0u); // ret
+
+#undef CHECK
+}
+
+TEST(aarch64_EmitterTest, PatchBranchTest) {
+  uint8_t buf[16];
+  Emitter emitter{buf};
+  emitter.b(buf);
+  emitter.bcond(CCode::EQ, buf);
+
+  Emitter::patchBranch(buf, buf + 12, 26);
+  Emitter::patchBranch(buf + 4, buf, 19);
+  uint32_t word;
+  memcpy(&word, buf, sizeof(word));
+  EXPECT_EQ(0x14000003u, word); // b #12
+  memcpy(&word, buf + 4, sizeof(word));
+  EXPECT_EQ(0x54FFFFE0u, word); // b.eq #-4
+
+  EXPECT_TRUE(Emitter::canBranch19(buf, buf + (1 << 20) - 4));
+  EXPECT_FALSE(Emitter::canBranch19(buf, buf + (1 << 20)));
+  EXPECT_TRUE(Emitter::canBranch26(buf, buf + (1 << 20)));
+}
+
+} // namespace
@@ -103,6 +103,16 @@ TEST(x86_64_EmitterTest, Test) {
       x86_64::Reg::rbx, x86_64::Reg::NoIndex, 0, x86_64::Reg::r8);
   CHECK("4c 8b 03                      movq (%rbx), %r8");
 
+  emitter.movzxRMToReg<S::B>(
+      x86_64::Reg::rax, x86_64::Reg::NoIndex, 0, x86_64::Reg::r9);
+  CHECK("44 0f b6 08                   movzbl (%rax), %r9d");
+  emitter.movzxRMToReg<S::W>(
+      x86_64::Reg::rbx, x86_64::Reg::NoIndex, 100, x86_64::Reg::ecx);
+  CHECK("0f b7 4b 64                   movzwl 100(%rbx), %ecx");
+  emitter.movzxRMToReg<S::W, 2>(
+      x86_64::Reg::rax, x86_64::Reg::rbx, 32, x86_64::Reg::edx);
+  CHECK("0f b7 54 58 20                movzwl 32(%rax,%rbx,2), %edx");
+
   emitter.movRegToRM<S::L, 0>(
       x86_64::Reg::ebx, x86_64::Reg::rcx, x86_64::Reg::NoIndex, 108);
   CHECK("89 59 6c                      movl %ebx, 108(%rcx)");
@@ -290,6 +300,13 @@ TEST(x86_64_EmitterTest, Test) {
   emitter.cmpImmToRM<S::SLQ, ScaleRegAccess>(300, Reg::rax, Reg::NoIndex, 0);
   CHECK("48 3d 2c 01 00 00             cmpq $300, %rax");
 
+  emitter.cmpRegToReg<S::Q>(Reg::rsi, Reg::rax);
+  CHECK("48 39 f0                      cmpq %rsi, %rax");
+  emitter.cmpRegToReg<S::L>(Reg::r11, Reg::ecx);
+  CHECK("44 39 d9                      cmpl %r11d, %ecx");
+  emitter.cmpRegToRM<S::Q>(Reg::rbx, Reg::r12, Reg::NoIndex, 8);
+  CHECK("49 39 5c 24 08                cmpq %rbx, 8(%r12)");
+
   emitter.testImmToRM<S::B, ScaleRegAccess>(-1, Reg::al, Reg::NoIndex, 0);
   CHECK("a8 ff                         testb $-1, %al");
   emitter.testImmToRM<S::W, ScaleRegAccess>(300, Reg::ax, Reg::NoIndex, 0);
@@ -91,6 +91,23 @@ TEST_F(MarkBitArrayNCTest, MarkGet) {
   }
 }
 
+TEST_F(MarkBitArrayNCTest, MarkAtomic) {
+  for (char *addr : addrs) {
+    size_t ind = mba->addressToIndex(addr);
+
+    EXPECT_TRUE(mba->markAtomic(ind)) << "first mark " << ind;
+    EXPECT_TRUE(mba->at(ind)) << "first mark " << ind;
+    EXPECT_FALSE(mba->markAtomic(ind)) << "second mark " << ind;
+    EXPECT_TRUE(mba->at(ind)) << "second mark " << ind;
+  }
+
+  mba->clear();
+  for (char *addr : addrs) {
+    size_t ind = mba->addressToIndex(addr);
+    EXPECT_FALSE(mba->at(ind));
+  }
+}
+
 TEST_F(MarkBitArrayNCTest, Initial) {
   for (char *addr : addrs) {
     size_t ind = mba->addressToIndex(addr);
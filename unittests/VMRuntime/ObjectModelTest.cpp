@@ -523,6 +523,57 @@ TEST_F(ObjectModelTest, SimpleDeleteTest) {
   ASSERT_EQ(1u, desc.slot);
 }
 
+TEST_F(ObjectModelTest, LeaveDictionaryModeTest) {
+  NamedPropertyDescriptor desc;
+
+  auto aID = *runtime->getIdentifierTable().getSymbolHandle(
+      runtime, createUTF16Ref(u"a"));
+  auto bID = *runtime->getIdentifierTable().getSymbolHandle(
+      runtime, createUTF16Ref(u"b"));
+  auto cID = *runtime->getIdentifierTable().getSymbolHandle(
+      runtime, createUTF16Ref(u"c"));
+  auto dID = *runtime->getIdentifierTable().getSymbolHandle(
+      runtime, createUTF16Ref(u"d"));
+
+  auto put = [&](Handle<JSObject> obj, Handle<SymbolID> id, double value) {
+    ASSERT_TRUE(*JSObject::putNamed_RJS(
+        obj,
+        runtime,
+        *id,
+        runtime->makeHandle(HermesValue::encodeDoubleValue(value))));
+  };
+
+  Handle<JSObject> nullObj(runtime, nullptr);
+
+  // obj1 = {a: 1, c: 3, d: 4}, by way of deleting b, so d reuses its slot.
+  auto obj1 = toHandle(runtime, JSObject::create(runtime, nullObj));
+  put(obj1, aID, 1.0);
+  put(obj1, bID, 2.0);
+  put(obj1, cID, 3.0);
+  ASSERT_TRUE(*JSObject::deleteNamed(obj1, runtime, *bID));
+  put(obj1, dID, 4.0);
+  ASSERT_TRUE(obj1->getClass(runtime)->isDictionary());
+  ASSERT_TRUE(JSObject::getOwnNamedDescriptor(obj1, runtime, *dID, desc));
+  ASSERT_EQ(1u, desc.slot);
+
+  // obj2 = {a: 1, c: 3, d: 4}, built directly.
+  auto obj2 = toHandle(runtime, JSObject::create(runtime, nullObj));
+  put(obj2, aID, 1.0);
+  put(obj2, cID, 3.0);
+  put(obj2, dID, 4.0);
+
+  ASSERT_RETURNED(JSObject::leaveDictionaryMode(obj1, runtime));
+  ASSERT_FALSE(obj1->getClass(runtime)->isDictionary());
+  ASSERT_EQ(obj2->getClass(runtime), obj1->getClass(runtime));
+
+  EXPECT_CALLRESULT_DOUBLE(1.0, JSObject::getNamed_RJS(obj1, runtime, *aID));
+  EXPECT_CALLRESULT_UNDEFINED(JSObject::getNamed_RJS(obj1, runtime, *bID));
+  EXPECT_CALLRESULT_DOUBLE(3.0, JSObject::getNamed_RJS(obj1, runtime, *cID));
+  EXPECT_CALLRESULT_DOUBLE(4.0, JSObject::getNamed_RJS(obj1, runtime, *dID));
+  ASSERT_TRUE(JSObject::getOwnNamedDescriptor(obj1, runtime, *dID, desc));
+  ASSERT_EQ(2u, desc.slot);
+}
+
 TEST_F(ObjectModelTest, EnvironmentSmokeTest) {
   auto nullParent = runtime->makeHandle<Environment>(nullptr);
   auto parentEnv = runtime->makeHandle<Environment>(
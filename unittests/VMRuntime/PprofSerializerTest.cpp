@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#ifndef _WINDOWS
+#include "hermes/VM/Profiler/PprofSerializerPosix.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace hermes::vm;
+
+namespace {
+
+using StackFrame = SamplingProfiler::StackFrame;
+using FrameKind = StackFrame::FrameKind;
+
+/// The fields of a decoded protobuf message, by field number. Varints are
+/// stored in ints, length-delimited fields in bytes.
+struct Message {
+  std::map<uint32_t, std::vector<uint64_t>> ints;
+  std::map<uint32_t, std::vector<std::string>> bytes;
+};
+
+/// Read a varint at \p pos of \p buf, advancing \p pos.
+uint64_t readVarint(const std::string &buf, size_t &pos) {
+  uint64_t value = 0;
+  for (unsigned shift = 0; pos < buf.size(); shift += 7) {
+    uint8_t byte = buf[pos++];
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return value;
+    }
+  }
+  ADD_FAILURE() << "Truncated varint";
+  return value;
+}
+
+/// Decode \p buf, which may only contain varint and length-delimited fields.
+Message decode(const std::string &buf) {
+  Message msg;
+  size_t pos = 0;
+  while (pos < buf.size()) {
+    uint64_t key = readVarint(buf, pos);
+    uint32_t field = key >> 3;
+    switch (key & 7) {
+      case 0:
+        msg.ints[field].push_back(readVarint(buf, pos));
+        break;
+      case 2: {
+        uint64_t size = readVarint(buf, pos);
+        EXPECT_LE(pos + size, buf.size());
+        msg.bytes[field].push_back(buf.substr(pos, size));
+        pos += size;
+        break;
+      }
+      default:
+        ADD_FAILURE() << "Unexpected wire type " << (key & 7);
+        return msg;
+    }
+  }
+  return msg;
+}
+
+/// Decode the packed varints \p buf.
+std::vector<uint64_t> decodePacked(const std::string &buf) {
+  std::vector<uint64_t> values;
+  size_t pos = 0;
+  while (pos < buf.size()) {
+    values.push_back(readVarint(buf, pos));
+  }
+  return values;
+}
+
+std::string serialize(
+    const SamplingProfiler::ThreadNamesMap &threadNames,
+    const std::vector<SamplingProfiler::StackTrace> &stacks) {
+  std::string out;
+  llvm::raw_string_ostream OS(out);
+  PprofSerializer(threadNames, stacks, std::chrono::microseconds(500))
+      .serialize(OS);
+  return OS.str();
+}
+
+StackFrame gcFrame() {
+  StackFrame frame;
+  frame.nativeFrame = 0;
+  frame.kind = FrameKind::GC;
+  return frame;
+}
+
+StackFrame nativeFunctionFrame(uintptr_t address) {
+  StackFrame frame;
+  frame.nativeFrame = address;
+  frame.kind = FrameKind::NativeFunction;
+  return frame;
+}
+
+TEST(PprofSerializerTest, EmptyProfileBytes) {
+  SamplingProfiler::ThreadNamesMap threadNames;
+  std::vector<SamplingProfiler::StackTrace> stacks;
+  const char expected[] =
+      // sample_type {type: 1, unit: 2}, sample_type {type: 3, unit: 4}
+      "\x0a\x04\x08\x01\x10\x02"
+      "\x0a\x04\x08\x03\x10\x04"
+      // period_type {type: 3, unit: 4}, period: 500000
+      "\x5a\x04\x08\x03\x10\x04"
+      "\x60\xa0\xc2\x1e"
+      // string_table
+      "\x32\x00"
+      "\x32\x07samples"
+      "\x32\x05"
+      "count"
+      "\x32\x04wall"
+      "\x32\x0bnanoseconds";
+  EXPECT_EQ(
+      std::string(expected, sizeof(expected) - 1),
+      serialize(threadNames, stacks));
+}
+
+TEST(PprofSerializerTest, SamplesLocationsAndStrings) {
+  SamplingProfiler::ThreadNamesMap threadNames;
+  threadNames[1] = "JS";
+  uintptr_t nativeAddress = reinterpret_cast<uintptr_t>(&std::abort);
+
+  std::vector<SamplingProfiler::StackTrace> stacks;
+  auto now = std::chrono::steady_clock::now();
+  stacks.emplace_back(1, now);
+  stacks.back().stack.push_back(gcFrame());
+  // Thread 2 has no name, so it is labeled with its id.
+  stacks.emplace_back(2, now + std::chrono::milliseconds(1));
+  stacks.back().stack.push_back(nativeFunctionFrame(nativeAddress));
+  stacks.emplace_back(1, now + std::chrono::milliseconds(2));
+  stacks.back().stack.push_back(gcFrame());
+
+  Message profile = decode(serialize(threadNames, stacks));
+
+  const std::vector<std::string> &strings = profile.bytes[6];
+  ASSERT_FALSE(strings.empty());
+  EXPECT_EQ("", strings[0]);
+  auto str = [&strings](uint64_t index) -> std::string {
+    EXPECT_LT(index, strings.size());
+    return index < strings.size() ? strings[index] : "";
+  };
+
+  // sample_type and period.
+  ASSERT_EQ(2u, profile.bytes[1].size());
+  Message samplesType = decode(profile.bytes[1][0]);
+  EXPECT_EQ("samples", str(samplesType.ints[1].at(0)));
+  EXPECT_EQ("count", str(samplesType.ints[2].at(0)));
+  Message wallType = decode(profile.bytes[1][1]);
+  EXPECT_EQ("wall", str(wallType.ints[1].at(0)));
+  EXPECT_EQ("nanoseconds", str(wallType.ints[2].at(0)));
+  ASSERT_EQ(1u, profile.ints[12].size());
+  EXPECT_EQ(500000u, profile.ints[12][0]);
+  ASSERT_EQ(1u, profile.ints[10].size());
+  EXPECT_EQ(2000000u, profile.ints[10][0]);
+
+  // Functions, by id.
+  std::map<uint64_t, std::string> functionNames;
+  for (const std::string &buf : profile.bytes[5]) {
+    Message function = decode(buf);
+    functionNames[function.ints[1].at(0)] = str(function.ints[2].at(0));
+  }
+  EXPECT_EQ(2u, functionNames.size());
+
+  // Locations, by id: the two GC frames share one.
+  std::map<uint64_t, Message> locations;
+  for (const std::string &buf : profile.bytes[4]) {
+    Message location = decode(buf);
+    locations[location.ints[1].at(0)] = location;
+  }
+  ASSERT_EQ(2u, locations.size());
+
+  ASSERT_EQ(3u, profile.bytes[2].size());
+  std::vector<uint64_t> sampleLocations;
+  std::vector<std::map<std::string, std::string>> sampleLabels;
+  for (const std::string &buf : profile.bytes[2]) {
+    Message sample = decode(buf);
+    ASSERT_EQ(1u, sample.bytes[1].size());
+    std::vector<uint64_t> locationIds = decodePacked(sample.bytes[1][0]);
+    ASSERT_EQ(1u, locationIds.size());
+    sampleLocations.push_back(locationIds[0]);
+    ASSERT_EQ(1u, sample.bytes[2].size());
+    EXPECT_EQ(
+        (std::vector<uint64_t>{1, 500000}), decodePacked(sample.bytes[2][0]));
+    std::map<std::string, std::string> labels;
+    for (const std::string &labelBuf : sample.bytes[3]) {
+      Message label = decode(labelBuf);
+      labels[str(label.ints[1].at(0))] = str(label.ints[2].at(0));
+    }
+    sampleLabels.push_back(labels);
+  }
+
+  EXPECT_EQ(sampleLocations[0], sampleLocations[2]);
+  EXPECT_NE(sampleLocations[0], sampleLocations[1]);
+  EXPECT_EQ("JS", sampleLabels[0]["thread"]);
+  EXPECT_EQ("gc", sampleLabels[0]["vm_state"]);
+  EXPECT_EQ("2", sampleLabels[1]["thread"]);
+  EXPECT_EQ("native", sampleLabels[1]["vm_state"]);
+  EXPECT_EQ("JS", sampleLabels[2]["thread"]);
+
+  // The GC location has no address and a single line naming [GC].
+  Message &gcLocation = locations[sampleLocations[0]];
+  EXPECT_EQ(0u, gcLocation.ints.count(3));
+  ASSERT_EQ(1u, gcLocation.bytes[4].size());
+  Message gcLine = decode(gcLocation.bytes[4][0]);
+  EXPECT_EQ("[GC]", functionNames[gcLine.ints[1].at(0)]);
+
+  // The native location keeps the address for symbolication.
+  Message &nativeLocation = locations[sampleLocations[1]];
+  ASSERT_EQ(1u, nativeLocation.ints[3].size());
+  EXPECT_EQ(nativeAddress, nativeLocation.ints[3][0]);
+  ASSERT_EQ(1u, nativeLocation.bytes[4].size());
+  Message nativeLine = decode(nativeLocation.bytes[4][0]);
+  EXPECT_FALSE(functionNames[nativeLine.ints[1].at(0)].empty());
+}
+
+} // namespace
+
+#endif // not _WINDOWS
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/PropertyCache.h"
+
+#include "gtest/gtest.h"
+
+using namespace hermes::vm;
+
+namespace {
+
+/// The cache never dereferences the classes it holds, so distinct fake
+/// addresses are enough to exercise it.
+HiddenClass *fakeClass(uintptr_t n) {
+  return reinterpret_cast<HiddenClass *>(n * 16);
+}
+
+TEST(PropertyCacheTest, MonomorphicTest) {
+  PropertyCacheEntry entry;
+  EXPECT_EQ(PropertyCacheState::Uninitialized, entry.state);
+  EXPECT_TRUE(entry.update(fakeClass(1), 3));
+  EXPECT_EQ(PropertyCacheState::Monomorphic, entry.state);
+  EXPECT_EQ(fakeClass(1), entry.clazz);
+  EXPECT_EQ(3u, entry.slot);
+
+  // Re-recording the same class only updates the slot.
+  EXPECT_FALSE(entry.update(fakeClass(1), 4));
+  EXPECT_EQ(PropertyCacheState::Monomorphic, entry.state);
+  EXPECT_EQ(4u, entry.slot);
+  // A monomorphic entry allocates nothing out of line.
+  EXPECT_EQ(nullptr, entry.getExtension());
+}
+
+TEST(PropertyCacheTest, PolymorphicTest) {
+  PropertyCacheEntry entry;
+  entry.update(fakeClass(1), 1);
+  EXPECT_TRUE(entry.update(fakeClass(2), 2));
+  EXPECT_EQ(PropertyCacheState::Polymorphic, entry.state);
+  EXPECT_FALSE(entry.update(fakeClass(3), 3));
+  EXPECT_EQ(PropertyCacheState::Polymorphic, entry.state);
+
+  // All classes moved out of line, and the monomorphic check never matches.
+  PropertyCacheExtension *ext = entry.getExtension();
+  ASSERT_NE(nullptr, ext);
+  EXPECT_EQ(3u, ext->numClasses);
+  EXPECT_NE(fakeClass(1), entry.clazz);
+  EXPECT_NE(fakeClass(3), entry.clazz);
+  SlotIndex slot;
+  ASSERT_TRUE(ext->find(fakeClass(1), slot));
+  EXPECT_EQ(1u, slot);
+  ASSERT_TRUE(entry.find(fakeClass(2), slot));
+  EXPECT_EQ(2u, slot);
+  ASSERT_TRUE(entry.find(fakeClass(3), slot));
+  EXPECT_EQ(3u, slot);
+  EXPECT_FALSE(entry.find(fakeClass(4), slot));
+  entry.clear();
+}
+
+TEST(PropertyCacheTest, MegamorphicTest) {
+  PropertyCacheEntry entry;
+  for (unsigned i = 1; i <= PropertyCacheEntry::kMaxPolymorphism; ++i)
+    entry.update(fakeClass(i), i);
+  EXPECT_EQ(PropertyCacheState::Polymorphic, entry.state);
+
+  // One class too many turns the entry megamorphic without evicting anything.
+  EXPECT_TRUE(entry.update(
+      fakeClass(PropertyCacheEntry::kMaxPolymorphism + 1), 100));
+  EXPECT_EQ(PropertyCacheState::Megamorphic, entry.state);
+  SlotIndex slot;
+  for (unsigned i = 1; i <= PropertyCacheEntry::kMaxPolymorphism; ++i) {
+    ASSERT_TRUE(entry.find(fakeClass(i), slot));
+    EXPECT_EQ(i, slot);
+  }
+  EXPECT_FALSE(
+      entry.find(fakeClass(PropertyCacheEntry::kMaxPolymorphism + 1), slot));
+
+  // A megamorphic entry is never rewritten.
+  EXPECT_FALSE(entry.update(fakeClass(1), 42));
+  ASSERT_TRUE(entry.find(fakeClass(1), slot));
+  EXPECT_EQ(1u, slot);
+  entry.clear();
+}
+
+TEST(PropertyCacheTest, ClearedClassReuseTest) {
+  PropertyCacheEntry entry;
+  entry.update(fakeClass(1), 1);
+  entry.update(fakeClass(2), 2);
+  // Simulate the GC clearing a dead class.
+  entry.getExtension()->clazz[0] = nullptr;
+  EXPECT_FALSE(entry.update(fakeClass(3), 3));
+  EXPECT_EQ(2u, entry.getExtension()->numClasses);
+  SlotIndex slot;
+  ASSERT_TRUE(entry.find(fakeClass(2), slot));
+  EXPECT_EQ(2u, slot);
+  ASSERT_TRUE(entry.find(fakeClass(3), slot));
+  EXPECT_EQ(3u, slot);
+  EXPECT_FALSE(entry.find(fakeClass(1), slot));
+  entry.clear();
+}
+
+TEST(PropertyCacheTest, ExtensionKeepsClassTest) {
+  // Recording a dictionary class or prototype chain keeps the cached class.
+  PropertyCacheEntry entry;
+  entry.update(fakeClass(1), 5);
+  entry.getOrCreateExtension().dictClazz = fakeClass(2);
+  EXPECT_EQ(PropertyCacheState::Monomorphic, entry.state);
+  SlotIndex slot;
+  ASSERT_TRUE(entry.find(fakeClass(1), slot));
+  EXPECT_EQ(5u, slot);
+
+  // An entry extended before it saw any class becomes monomorphic first.
+  PropertyCacheEntry protoEntry;
+  protoEntry.getOrCreateExtension().proto.receiverClazz = fakeClass(3);
+  EXPECT_TRUE(protoEntry.update(fakeClass(4), 6));
+  EXPECT_EQ(PropertyCacheState::Monomorphic, protoEntry.state);
+  ASSERT_TRUE(protoEntry.find(fakeClass(4), slot));
+  EXPECT_EQ(6u, slot);
+
+  entry.clear();
+  protoEntry.clear();
+  EXPECT_EQ(nullptr, entry.getExtension());
+  EXPECT_EQ(PropertyCacheState::Uninitialized, entry.state);
+}
+
+} // namespace
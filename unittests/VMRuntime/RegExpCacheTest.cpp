@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/RegExpCache.h"
+
+#include "gtest/gtest.h"
+
+using namespace hermes::vm;
+
+namespace {
+
+llvm::ArrayRef<char16_t> toRef(const std::u16string &str) {
+  return llvm::makeArrayRef(str.data(), str.size());
+}
+
+TEST(RegExpCacheTest, LookupByPatternAndFlags) {
+  RegExpCache cache;
+  std::u16string pattern = u"a+b";
+  EXPECT_FALSE(cache.lookup(toRef(pattern), 0).hasValue());
+  cache.insert(toRef(pattern), 0, {1, 2, 3});
+
+  auto hit = cache.lookup(toRef(pattern), 0);
+  ASSERT_TRUE(hit.hasValue());
+  EXPECT_EQ(3u, hit->size());
+  EXPECT_EQ(2u, (*hit)[1]);
+
+  // The same pattern with other flags is a different regexp.
+  EXPECT_FALSE(cache.lookup(toRef(pattern), 1).hasValue());
+  EXPECT_EQ(1u, cache.getHits());
+  EXPECT_EQ(2u, cache.getMisses());
+}
+
+TEST(RegExpCacheTest, EvictLeastRecentlyUsed) {
+  RegExpCache cache(2);
+  std::u16string a = u"a", b = u"b", c = u"c";
+  cache.insert(toRef(a), 0, {1});
+  cache.insert(toRef(b), 0, {2});
+
+  // Using a makes b the least recently used entry.
+  EXPECT_TRUE(cache.lookup(toRef(a), 0).hasValue());
+  cache.insert(toRef(c), 0, {3});
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_TRUE(cache.lookup(toRef(a), 0).hasValue());
+  EXPECT_FALSE(cache.lookup(toRef(b), 0).hasValue());
+  EXPECT_TRUE(cache.lookup(toRef(c), 0).hasValue());
+}
+
+} // namespace
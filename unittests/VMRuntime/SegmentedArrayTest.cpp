@@ -56,4 +56,30 @@ TEST_F(SegmentedArrayTest, AllocLargeArrayThrowsRangeError) {
       << "Exception thrown was not a RangeError";
 }
 
+TEST_F(SegmentedArrayTest, GrowOneElementAtATime) {
+  // Cross the inline storage threshold and several segment boundaries, one
+  // element at a time, as an array being filled in order does.
+  constexpr uint32_t kSize = SegmentedArray::kValueToSegmentThreshold + 3000;
+  auto res = SegmentedArray::create(runtime, 4);
+  ASSERT_EQ(res, ExecutionStatus::RETURNED);
+  MutableHandle<SegmentedArray> array{runtime, vmcast<SegmentedArray>(*res)};
+  for (uint32_t i = 0; i < kSize; ++i) {
+    GCScopeMarkerRAII marker{runtime};
+    auto value = runtime->makeHandle(HermesValue::encodeDoubleValue(i));
+    ASSERT_EQ(
+        SegmentedArray::push_back(array, runtime, value),
+        ExecutionStatus::RETURNED);
+  }
+  ASSERT_EQ(kSize, array->size());
+  ASSERT_GT(array->capacity(), kSize);
+  for (uint32_t i = 0; i < kSize; ++i) {
+    EXPECT_EQ(i, array->at(i).getNumber());
+  }
+
+  // Growing within capacity fills the new elements with empty values.
+  SegmentedArray::resizeWithinCapacity(
+      createPseudoHandle(array.get()), runtime, kSize + 1);
+  EXPECT_TRUE(array->at(kSize).isEmpty());
+}
+
 } // namespace
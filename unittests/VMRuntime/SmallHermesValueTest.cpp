@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the LICENSE
+ * file in the root directory of this source tree.
+ */
+#include "hermes/VM/SmallHermesValue.h"
+
+#include "TestHelpers.h"
+#include "hermes/VM/JSObject.h"
+#include "hermes/VM/StringPrimitive.h"
+#include "hermes/VM/StringRefUtils.h"
+
+#include <cmath>
+#include <limits>
+
+#include "gtest/gtest.h"
+
+using namespace hermes::vm;
+
+namespace {
+
+using SmallHermesValueTest = RuntimeTestFixture;
+
+/// Encode \p hv and check that it decodes to the same value.
+void expectRoundTrip(Runtime *runtime, HermesValue hv) {
+  ASSERT_TRUE(SmallHermesValue::canEncode(hv));
+  SmallHermesValue shv = SmallHermesValue::encode(hv, runtime);
+  EXPECT_EQ(hv.getRaw(), shv.decode(runtime).getRaw());
+}
+
+TEST_F(SmallHermesValueTest, Specials) {
+  expectRoundTrip(runtime, HermesValue::encodeUndefinedValue());
+  expectRoundTrip(runtime, HermesValue::encodeNullValue());
+  expectRoundTrip(runtime, HermesValue::encodeEmptyValue());
+  expectRoundTrip(runtime, HermesValue::encodeBoolValue(true));
+  expectRoundTrip(runtime, HermesValue::encodeBoolValue(false));
+  EXPECT_TRUE(SmallHermesValue().isUndefined());
+  EXPECT_TRUE(SmallHermesValue::encode(
+                  HermesValue::encodeUndefinedValue(), runtime)
+                  .isUndefined());
+  EXPECT_NE(
+      SmallHermesValue::encode(HermesValue::encodeBoolValue(true), runtime),
+      SmallHermesValue::encode(HermesValue::encodeBoolValue(false), runtime));
+}
+
+TEST_F(SmallHermesValueTest, Numbers) {
+  for (double num : {0.0,
+                     1.0,
+                     -1.0,
+                     12345.0,
+                     (double)SmallHermesValue::kMaxSmallInt,
+                     (double)SmallHermesValue::kMinSmallInt}) {
+    expectRoundTrip(runtime, HermesValue::encodeNumberValue(num));
+    EXPECT_EQ(
+        num,
+        SmallHermesValue::encode(HermesValue::encodeNumberValue(num), runtime)
+            .getSmallInt());
+  }
+
+  // Values that need the full width of a double.
+  for (double num : {-0.0,
+                     0.5,
+                     (double)SmallHermesValue::kMaxSmallInt + 1,
+                     (double)SmallHermesValue::kMinSmallInt - 1,
+                     std::nan(""),
+                     std::numeric_limits<double>::infinity()}) {
+    EXPECT_FALSE(
+        SmallHermesValue::canEncode(HermesValue::encodeNumberValue(num)));
+  }
+  EXPECT_FALSE(
+      SmallHermesValue::canEncode(HermesValue::encodeNativeUInt32(1)));
+}
+
+TEST_F(SmallHermesValueTest, Symbols) {
+  expectRoundTrip(
+      runtime, HermesValue::encodeSymbolValue(SymbolID::unsafeCreate(17)));
+  expectRoundTrip(
+      runtime,
+      HermesValue::encodeSymbolValue(SymbolID::unsafeCreateNotUniqued(17)));
+  expectRoundTrip(
+      runtime,
+      HermesValue::encodeSymbolValue(
+          SymbolID::unsafeCreate(SmallHermesValue::kMaxSymbolIndex)));
+  EXPECT_FALSE(SmallHermesValue::canEncode(HermesValue::encodeSymbolValue(
+      SymbolID::unsafeCreate(SmallHermesValue::kMaxSymbolIndex + 1))));
+}
+
+TEST_F(SmallHermesValueTest, Pointers) {
+  auto str = StringPrimitive::createNoThrow(runtime, createUTF16Ref(u"hello"));
+  auto obj = toHandle(runtime, JSObject::create(runtime));
+  HermesValue strHV = HermesValue::encodeStringValue(str.get());
+  HermesValue objHV = obj.getHermesValue();
+
+  if (!SmallHermesValue::kCanEncodePointers) {
+    EXPECT_FALSE(SmallHermesValue::canEncode(strHV));
+    EXPECT_FALSE(SmallHermesValue::canEncode(objHV));
+    return;
+  }
+
+  expectRoundTrip(runtime, strHV);
+  expectRoundTrip(runtime, objHV);
+  SmallHermesValue shv = SmallHermesValue::encode(objHV, runtime);
+  EXPECT_TRUE(shv.isPointer());
+  EXPECT_TRUE(shv.isObject());
+  EXPECT_FALSE(shv.isString());
+  shv = SmallHermesValue::encode(strHV, runtime);
+  EXPECT_TRUE(shv.isPointer());
+  EXPECT_TRUE(shv.isString());
+}
+
+} // namespace
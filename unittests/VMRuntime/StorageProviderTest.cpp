@@ -12,9 +12,14 @@
 #include "hermes/VM/AlignedStorage.h"
 #include "hermes/VM/LimitedStorageProvider.h"
 #include "hermes/VM/LogFailStorageProvider.h"
+#include "hermes/VM/PlacedStorageProvider.h"
 
 #include "llvm/ADT/STLExtras.h"
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 using namespace hermes;
 using namespace hermes::vm;
 
@@ -174,6 +179,80 @@ TEST(StorageProviderTest, LogFailStorageProvider) {
   }
 }
 
+TEST(StorageProviderTest, PlacedStorageProvider) {
+  // The placement requests are only hints, so whether or not the OS honours
+  // them, the storage must be usable.
+  PlacedStorageProvider provider{StorageProvider::mmapProvider(),
+                                 /* hugePages */ true,
+                                 /* numaLocal */ true};
+  auto result = provider.newStorage("Placed");
+  ASSERT_TRUE(result);
+  char *s = static_cast<char *>(result.get());
+  s[0] = 1;
+  s[AlignedStorage::size() - 1] = 2;
+  EXPECT_EQ(1, s[0]);
+  EXPECT_EQ(2, s[AlignedStorage::size() - 1]);
+  provider.deleteStorage(s);
+}
+
+TEST(StorageProviderTest, PooledProvidersShareStorage) {
+  auto first = StorageProvider::pooledMmapProvider();
+  auto second = StorageProvider::pooledMmapProvider();
+  auto result = first->newStorage("Pooled");
+  ASSERT_TRUE(result);
+  void *storage = result.get();
+  first->deleteStorage(storage);
+
+  // The most recently deleted storage on this thread is reused, whichever
+  // provider deleted it.
+  result = second->newStorage("Pooled");
+  ASSERT_TRUE(result);
+  EXPECT_EQ(storage, result.get());
+  char *s = static_cast<char *>(result.get());
+  s[0] = 1;
+  s[AlignedStorage::size() - 1] = 2;
+  EXPECT_EQ(1, s[0]);
+  EXPECT_EQ(2, s[AlignedStorage::size() - 1]);
+  second->deleteStorage(s);
+}
+
+TEST(StorageProviderTest, PooledStorageOutlivesThread) {
+  auto provider = StorageProvider::pooledMmapProvider();
+  std::vector<void *> storages(8);
+  // Storage deleted on a thread goes to the shared pool when it exits.
+  std::thread([&provider, &storages]() {
+    for (void *&storage : storages) {
+      auto result = provider->newStorage("Pooled");
+      ASSERT_TRUE(result);
+      storage = result.get();
+    }
+    for (void *storage : storages) {
+      provider->deleteStorage(storage);
+    }
+  }).join();
+
+  std::vector<void *> reused;
+  for (size_t i = 0; i < storages.size(); ++i) {
+    auto result = provider->newStorage("Pooled");
+    ASSERT_TRUE(result);
+    reused.push_back(result.get());
+  }
+  size_t numReused = 0;
+  for (void *storage : reused) {
+    numReused +=
+        std::find(storages.begin(), storages.end(), storage) != storages.end();
+    provider->deleteStorage(storage);
+  }
+  EXPECT_GT(numReused, 0u);
+}
+
+TEST(StorageProviderTest, PlacedStorageProviderFail) {
+  PlacedStorageProvider provider{NullStorageProvider::create(),
+                                 /* hugePages */ true,
+                                 /* numaLocal */ true};
+  EXPECT_FALSE(provider.newStorage("Placed"));
+}
+
 /// StorageGuard will free storage on scope exit.
 class StorageGuard final {
  public:
@@ -142,6 +142,138 @@ TEST_F(StringPrimTest, ConcatTest) {
   }
 }
 
+TEST_F(StringPrimTest, RopeTest) {
+  std::string left(RopeStringPrimitive::kMinRopeLength, 'a');
+  auto a = StringPrimitive::createNoThrow(runtime, left);
+  auto b = StringPrimitive::createNoThrow(runtime, createUTF16Ref(u"\u0444"));
+  auto strRes = StringPrimitive::concat(runtime, a, b);
+  ASSERT_NE(ExecutionStatus::EXCEPTION, strRes.getStatus());
+  auto rope = runtime->makeHandle<StringPrimitive>(*strRes);
+  ASSERT_TRUE(vmisa<RopeStringPrimitive>(*rope));
+  EXPECT_FALSE(rope->isASCII());
+  EXPECT_FALSE(rope->isFlat());
+  EXPECT_EQ(left.size() + 1, rope->getStringLength());
+
+  // The pieces must survive collections until the rope is flattened.
+  runtime->collect();
+  EXPECT_EQ(u'\u0444', rope->at(left.size()));
+  EXPECT_TRUE(rope->isFlat());
+  EXPECT_EQ(u'a', StringPrimitive::createStringView(runtime, rope)[0]);
+
+  // Extending a string again and again keeps the rope shallow.
+  MutableHandle<StringPrimitive> str{runtime, a.get()};
+  auto x = StringPrimitive::createNoThrow(runtime, "x");
+  GCScopeMarkerRAII marker{runtime};
+  for (uint32_t i = 0; i < 3 * RopeStringPrimitive::kMaxRopeDepth; ++i) {
+    auto res = StringPrimitive::concat(runtime, str, x);
+    ASSERT_NE(ExecutionStatus::EXCEPTION, res.getStatus());
+    str = vmcast<StringPrimitive>(*res);
+    ASSERT_LE(
+        RopeStringPrimitive::getDepth(*str),
+        RopeStringPrimitive::kMaxRopeDepth);
+    marker.flush();
+  }
+  ASSERT_TRUE(str->isASCII());
+  EXPECT_EQ(
+      left.size() + 3 * RopeStringPrimitive::kMaxRopeDepth,
+      str->getStringLength());
+  EXPECT_EQ(u'a', str->at(left.size() - 1));
+  EXPECT_EQ(u'x', str->at(left.size()));
+}
+
+TEST_F(StringPrimTest, SliceTest) {
+  std::string chars;
+  for (unsigned i = 0; i < 200; ++i)
+    chars.push_back('a' + i % 26);
+  auto str = StringPrimitive::createNoThrow(runtime, chars);
+
+  auto res = StringPrimitive::slice(runtime, str, 10, 50);
+  ASSERT_NE(ExecutionStatus::EXCEPTION, res.getStatus());
+  auto slice = runtime->makeHandle<StringPrimitive>(*res);
+  ASSERT_TRUE(vmisa<SlicedStringPrimitive>(*slice));
+  EXPECT_TRUE(slice->isASCII());
+
+  // Slices of slices point into the owner of the characters.
+  res = StringPrimitive::slice(runtime, slice, 5, 20);
+  ASSERT_NE(ExecutionStatus::EXCEPTION, res.getStatus());
+  auto inner = runtime->makeHandle<StringPrimitive>(*res);
+  ASSERT_TRUE(vmisa<SlicedStringPrimitive>(*inner));
+  EXPECT_EQ(*str, vmcast<SlicedStringPrimitive>(*inner)->getOwner());
+  EXPECT_EQ(15u, vmcast<SlicedStringPrimitive>(*inner)->getOffset());
+
+  // The owner may move, but the slices still see its characters.
+  runtime->collect();
+  EXPECT_TRUE(StringPrimitive::createStringView(runtime, slice)
+                  .equals(createASCIIRef(chars.substr(10, 50).c_str())));
+  EXPECT_TRUE(StringPrimitive::createStringView(runtime, inner)
+                  .equals(createASCIIRef(chars.substr(15, 20).c_str())));
+
+  // Short slices are copied.
+  res = StringPrimitive::slice(runtime, str, 0, 3);
+  ASSERT_NE(ExecutionStatus::EXCEPTION, res.getStatus());
+  EXPECT_FALSE(vmisa<SlicedStringPrimitive>(*res));
+
+  // So are small slices of large strings, which would keep them alive.
+  auto large = StringPrimitive::createNoThrow(
+      runtime, std::string(StringPrimitive::EXTERNAL_STRING_THRESHOLD, 'z'));
+  res = StringPrimitive::slice(runtime, large, 100, 100);
+  ASSERT_NE(ExecutionStatus::EXCEPTION, res.getStatus());
+  EXPECT_FALSE(vmisa<SlicedStringPrimitive>(*res));
+}
+
+TEST_F(StringPrimTest, BorrowedTest) {
+  /// Owns a std::string and records when it has been released.
+  class StringOwner final : public BorrowedStringBuffer {
+   public:
+    StringOwner(std::string str, bool &released)
+        : str(std::move(str)), released_(released) {}
+    ~StringOwner() override {
+      released_ = true;
+    }
+    const std::string str;
+
+   private:
+    bool &released_;
+  };
+
+  bool released = false;
+  auto owner = std::unique_ptr<StringOwner>(
+      new StringOwner(std::string(300, 'x') + "borrowed", released));
+  ASCIIRef chars{owner->str.data(), owner->str.size()};
+  {
+    GCScope scope{runtime};
+    auto res =
+        BorrowedASCIIStringPrimitive::create(runtime, chars, std::move(owner));
+    ASSERT_NE(ExecutionStatus::EXCEPTION, res.getStatus());
+    auto str = runtime->makeHandle<StringPrimitive>(*res);
+    EXPECT_TRUE(str->isASCII());
+    EXPECT_EQ(
+        chars.data(),
+        StringPrimitive::createStringView(runtime, str).castToCharPtr());
+    EXPECT_EQ(chars.size(), StringPrimitive::externalMemorySize(*str));
+
+    // The characters are not copied when the string moves.
+    runtime->collect();
+    EXPECT_FALSE(released);
+    EXPECT_EQ(
+        chars.data(),
+        StringPrimitive::createStringView(runtime, str).castToCharPtr());
+    EXPECT_TRUE(
+        StringPrimitive::createStringView(runtime, str).equals(chars));
+
+    // Slices share the borrowed characters.
+    auto sliceRes = StringPrimitive::slice(runtime, str, 290, 18);
+    ASSERT_NE(ExecutionStatus::EXCEPTION, sliceRes.getStatus());
+    EXPECT_TRUE(StringPrimitive::createStringView(
+                    runtime, runtime->makeHandle<StringPrimitive>(*sliceRes))
+                    .equals(createASCIIRef("xxxxxxxxxxborrowed")));
+  }
+
+  // The owner is released with the string.
+  runtime->collect();
+  EXPECT_TRUE(released);
+}
+
 // This attempts to test that strings above a sufficient length may be freely
 // memcpy'd around. This would not be true if the small-string optimization used
 // an interior pointer, or if someone else maintained a pointer to the string.